@@ -0,0 +1,286 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+// Benchmarks the garbled-circuit ReLU and bounded ReLU circuits of the ABY
+// path, between a server and a client connected over loopback, for the Yao
+// and GMW protocols. Each benchmark takes the arguments
+//   values: number of values evaluated per circuit execution
+//   bit_length: bit-length of the circuit values, whose modulus q has
+//     bit_length - 1 bits, as ABYExecutor::circuit_bitlen selects
+//   parties: number of party pairs, each evaluating a share of the values
+//     on its own port, as the num_parties of the backend
+//   masked: whether the server's input and output shares are random masks,
+//     as with mask_gc_inputs and mask_gc_outputs, or zero
+// and reports as counters, averaged over the iterations and summed over the
+// parties:
+//   gates, depth: gates of the server circuits, and the largest depth
+//   offline_ms, online_ms: the input-independent setup phase, i.e. OT
+//     extension and, for Yao, garbling, and the online phase
+//   offline_bytes, online_bytes: bytes sent and received by the server in
+//     each phase
+// The base OTs run once per benchmark, before the iterations. Run with
+// --benchmark_out=<file> --benchmark_out_format=json to store the results
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ENCRYPTO_utils/crypto/crypto.h"
+#include "aby/aby_util.hpp"
+#include "aby/kernel/relu_aby.hpp"
+#include "abycore/aby/abyparty.h"
+#include "abycore/circuit/booleancircuits.h"
+#include "abycore/sharing/sharing.h"
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::aby {
+namespace {
+
+/// \brief Port of the first party pair
+constexpr uint16_t s_party_port = 35300;
+/// \brief Bit-length of the arithmetic sharing of the parties
+constexpr uint32_t s_party_bitlen = 64;
+/// \brief Gates reserved by each party
+constexpr uint32_t s_reserve_num_gates = 100000;
+
+struct CircuitBenchmark {
+  std::string name;
+  /// \brief Whether or not the ReLU is bounded, by q / 4
+  bool bounded;
+};
+
+struct ProtocolBenchmark {
+  std::string name;
+  e_sharing sharing;
+};
+
+/// \brief Server and client parties of one port, with the circuits of the
+/// benchmarked sharing
+struct PartyPair {
+  std::unique_ptr<ABYParty> server;
+  std::unique_ptr<ABYParty> client;
+  BooleanCircuit* server_circuit{nullptr};
+  BooleanCircuit* client_circuit{nullptr};
+};
+
+/// \brief Statistics of a server party's circuit execution
+struct PartyStats {
+  double gates{0};
+  double depth{0};
+  double offline_ms{0};
+  double online_ms{0};
+  double offline_bytes{0};
+  double online_bytes{0};
+};
+
+/// \brief Returns the statistics of the last execution of a server party.
+/// Must be called before the party is reset
+PartyStats server_stats(ABYParty& server) {
+  PartyStats stats;
+  stats.gates = server.GetTotalGates();
+  stats.depth = server.GetTotalDepth();
+  stats.offline_ms = server.GetTiming(P_SETUP);
+  stats.online_ms = server.GetTiming(P_ONLINE);
+  stats.offline_bytes = static_cast<double>(server.GetSentData(P_SETUP) +
+                                            server.GetReceivedData(P_SETUP));
+  stats.online_bytes = static_cast<double>(server.GetSentData(P_ONLINE) +
+                                           server.GetReceivedData(P_ONLINE));
+  return stats;
+}
+
+BooleanCircuit* boolean_circuit(ABYParty& party, e_sharing sharing) {
+  auto* circuit = dynamic_cast<BooleanCircuit*>(
+      party.GetSharings()[sharing]->GetCircuitBuildRoutine());
+  NGRAPH_CHECK(circuit != nullptr, "Party has no boolean circuit");
+  return circuit;
+}
+
+/// \brief Connects the party pairs and performs their base OTs
+std::vector<PartyPair> connect_parties(size_t num_parties, e_sharing sharing) {
+  std::vector<PartyPair> parties(num_parties);
+  std::vector<std::thread> threads;
+  for (size_t party_idx = 0; party_idx < num_parties; ++party_idx) {
+    auto port = static_cast<uint16_t>(s_party_port + party_idx);
+    auto& pair = parties[party_idx];
+    pair.server = std::make_unique<ABYParty>(
+        SERVER, "0.0.0.0", port, get_sec_lvl(128), s_party_bitlen, 1, MT_OT,
+        s_reserve_num_gates);
+    pair.client = std::make_unique<ABYParty>(
+        CLIENT, "localhost", port, get_sec_lvl(128), s_party_bitlen, 1, MT_OT,
+        s_reserve_num_gates);
+    pair.server_circuit = boolean_circuit(*pair.server, sharing);
+    pair.client_circuit = boolean_circuit(*pair.client, sharing);
+    threads.emplace_back(
+        [&pair]() { NGRAPH_CHECK(pair.server->ConnectAndBaseOTs()); });
+    threads.emplace_back(
+        [&pair]() { NGRAPH_CHECK(pair.client->ConnectAndBaseOTs()); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return parties;
+}
+
+void run_relu_benchmark(benchmark::State& state,
+                        const CircuitBenchmark& circuit,
+                        const ProtocolBenchmark& protocol) {
+  auto num_values = static_cast<size_t>(state.range(0));
+  auto bit_length = static_cast<uint32_t>(state.range(1));
+  auto num_parties = static_cast<size_t>(state.range(2));
+  bool masked = state.range(3) != 0;
+
+  uint64_t q = (uint64_t{1} << (bit_length - 1)) - 1;
+  std::optional<uint64_t> bound;
+  if (circuit.bounded) {
+    bound = q / 4;
+  }
+  CircuitVariant variant = default_circuit_variant(protocol.sharing);
+  auto splits = split_vector(num_values, num_parties);
+
+  // Summed over the parties and iterations
+  double gates = 0;
+  double depth = 0;
+  double offline_ms = 0;
+  double online_ms = 0;
+  double offline_bytes = 0;
+  double online_bytes = 0;
+
+  try {
+    auto parties = connect_parties(num_parties, protocol.sharing);
+    std::mt19937_64 gen(0);
+    std::uniform_int_distribution<uint64_t> dis(0, q - 1);
+
+    for (auto _ : state) {
+      std::vector<std::thread> threads;
+      std::vector<PartyStats> party_stats(num_parties);
+      for (size_t party_idx = 0; party_idx < num_parties; ++party_idx) {
+        const auto& [start_idx, end_idx] = splits[party_idx];
+        size_t party_values = end_idx - start_idx;
+        if (party_values == 0) {
+          continue;
+        }
+        // The client holds the values, masked by the server's input share
+        std::vector<uint64_t> zeros(party_values, 0);
+        std::vector<uint64_t> server_input(party_values, 0);
+        std::vector<uint64_t> server_mask(party_values, 0);
+        std::vector<uint64_t> client_input(party_values);
+        for (size_t i = 0; i < party_values; ++i) {
+          uint64_t value = dis(gen);
+          if (masked) {
+            server_input[i] = dis(gen);
+            server_mask[i] = dis(gen);
+          }
+          client_input[i] = (value + q - server_input[i]) % q;
+        }
+
+        auto& pair = parties[party_idx];
+        threads.emplace_back([&, party_idx, server_input, server_mask,
+                              zeros]() mutable {
+          bounded_relu_aby(*pair.server_circuit, zeros.size(), server_input,
+                           zeros, server_mask, bit_length, q, bound, 0,
+                           variant);
+          pair.server->ExecCircuit();
+          party_stats[party_idx] = server_stats(*pair.server);
+          pair.server->Reset();
+        });
+        threads.emplace_back([&, client_input, zeros]() mutable {
+          bounded_relu_aby(*pair.client_circuit, zeros.size(), zeros,
+                           client_input, zeros, bit_length, q, bound, 0,
+                           variant);
+          pair.client->ExecCircuit();
+          pair.client->Reset();
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      for (const auto& stats : party_stats) {
+        gates += stats.gates;
+        depth = std::max(depth, stats.depth);
+        offline_ms += stats.offline_ms;
+        online_ms += stats.online_ms;
+        offline_bytes += stats.offline_bytes;
+        online_bytes += stats.online_bytes;
+      }
+    }
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+
+  auto average = [](double value) {
+    return benchmark::Counter(value, benchmark::Counter::kAvgIterations);
+  };
+  state.counters["gates"] = average(gates);
+  state.counters["depth"] = depth;
+  state.counters["offline_ms"] = average(offline_ms);
+  state.counters["online_ms"] = average(online_ms);
+  state.counters["offline_bytes"] = average(offline_bytes);
+  state.counters["online_bytes"] = average(online_bytes);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(num_values));
+}
+
+/// \brief Registers the arguments of the benchmarks: values, bit_length,
+/// parties and masked. Bit-lengths are those of 23, 31 and 54-bit moduli,
+/// plus the carry bit
+void relu_benchmark_args(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t num_values : {1 << 8, 1 << 11, 1 << 14}) {
+    for (int64_t bit_length : {24, 32, 55}) {
+      for (int64_t num_parties : {1, 4}) {
+        for (int64_t masked : {0, 1}) {
+          benchmark->Args({num_values, bit_length, num_parties, masked});
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace ngraph::runtime::aby
+
+int main(int argc, char** argv) {
+  using namespace ngraph::runtime::aby;
+  benchmark::Initialize(&argc, argv);
+
+  std::vector<CircuitBenchmark> circuits{{"Relu", false},
+                                         {"BoundedRelu", true}};
+  std::vector<ProtocolBenchmark> protocols{{"yao", S_YAO}, {"gmw", S_BOOL}};
+  for (const auto& circuit : circuits) {
+    for (const auto& protocol : protocols) {
+      std::string name = circuit.name + "/" + protocol.name;
+      benchmark::RegisterBenchmark(
+          name.c_str(),
+          [circuit, protocol](benchmark::State& state) {
+            run_relu_benchmark(state, circuit, protocol);
+          })
+          ->ArgNames({"values", "bit_length", "parties", "masked"})
+          ->Apply(relu_benchmark_args)
+          ->Unit(benchmark::kMillisecond);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,473 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+// Benchmarks each SEAL kernel through a single-op function, for every
+// parameter set in configs/, with and without plaintext packing, and
+// increasing numbers of threads. Each iteration calls the compiled function,
+// which encrypts its input, so the Parameter benchmark measures the overhead
+// shared by all kernels. The Primitive benchmarks time single SEAL
+// primitives on ciphertexts at the top level of each parameter set, and
+// report their cost per ciphertext coefficient as the coeff_us counter,
+// which the cost_calibration backend option loads. Primitive benchmarks are
+// labeled "hexl" if SEAL runs its NTTs with Intel HEXL, see
+// NGRAPH_HE_HEXL_ENABLE, and "native" otherwise, so results of builds with
+// and without HEXL can be compared. Run with --benchmark_out=<file>
+// --benchmark_out_format=json to store the results
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "ngraph/ngraph.hpp"
+#include "op/bounded_relu.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+
+/// \brief Batch size of packed benchmarks
+constexpr size_t s_packed_batch_size = 64;
+
+struct KernelBenchmark {
+  std::string name;
+  /// \brief Builds a function of the given batch size. The first parameter
+  /// is encrypted, and the remaining parameters are plaintexts
+  std::function<std::shared_ptr<Function>(size_t)> make_function;
+  /// \brief Backend options of the benchmark
+  std::map<std::string, std::string> config{};
+};
+
+std::shared_ptr<op::Constant> constant(const Shape& shape, float value) {
+  return op::Constant::create(element::f32, shape,
+                              std::vector<float>(shape_size(shape), value));
+}
+
+std::shared_ptr<Function> unary_function(
+    size_t batch_size,
+    const std::function<std::shared_ptr<Node>(std::shared_ptr<Node>)>&
+        make_op) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{batch_size, 64});
+  return std::make_shared<Function>(make_op(a), ParameterVector{a});
+}
+
+std::shared_ptr<Function> image_function(
+    size_t batch_size,
+    const std::function<std::shared_ptr<Node>(std::shared_ptr<Node>)>&
+        make_op) {
+  auto a = std::make_shared<op::Parameter>(element::f32,
+                                           Shape{batch_size, 2, 8, 8});
+  return std::make_shared<Function>(make_op(a), ParameterVector{a});
+}
+
+std::vector<KernelBenchmark> kernel_benchmarks() {
+  using NodePtr = std::shared_ptr<Node>;
+  std::vector<KernelBenchmark> benchmarks{
+      {"Parameter",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) { return a; });
+       }},
+      {"AddCipherCipher",
+       [](size_t b) {
+         auto a = std::make_shared<op::Parameter>(element::f32, Shape{b, 64});
+         auto c = std::make_shared<op::Parameter>(element::f32, Shape{b, 64});
+         return std::make_shared<Function>(std::make_shared<op::Add>(a, c),
+                                           ParameterVector{a, c});
+       }},
+      {"AddCipherPlain",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Add>(a, constant(a->get_shape(), 0.5));
+         });
+       }},
+      {"Subtract",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Subtract>(a,
+                                                 constant(a->get_shape(), 0.5));
+         });
+       }},
+      {"MultiplyCipherCipher",
+       [](size_t b) {
+         auto a = std::make_shared<op::Parameter>(element::f32, Shape{b, 64});
+         auto c = std::make_shared<op::Parameter>(element::f32, Shape{b, 64});
+         return std::make_shared<Function>(
+             std::make_shared<op::Multiply>(a, c), ParameterVector{a, c});
+       }},
+      {"MultiplyCipherPlain",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Multiply>(a,
+                                                 constant(a->get_shape(), 0.5));
+         });
+       }},
+      {"Negate",
+       [](size_t b) {
+         return unary_function(
+             b, [](NodePtr a) { return std::make_shared<op::Negate>(a); });
+       }},
+      {"Divide",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Divide>(a, constant(a->get_shape(), 2));
+         });
+       }},
+      {"Minimum",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Minimum>(a,
+                                                constant(a->get_shape(), 0.5));
+         });
+       }},
+      {"Power",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Power>(a, constant(a->get_shape(), 2));
+         });
+       }},
+      {"Exp",
+       [](size_t b) {
+         return unary_function(
+             b, [](NodePtr a) { return std::make_shared<op::Exp>(a); });
+       }},
+      {"Relu",
+       [](size_t b) {
+         return unary_function(
+             b, [](NodePtr a) { return std::make_shared<op::Relu>(a); });
+       }},
+      {"ReluPolynomial",
+       [](size_t b) {
+         return unary_function(
+             b, [](NodePtr a) { return std::make_shared<op::Relu>(a); });
+       },
+       {{"polynomial_activation", "square"}}},
+      {"BoundedRelu",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::BoundedRelu>(a, 6.0f);
+         });
+       }},
+      {"Dot",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Dot>(a, constant(Shape{64, 16}, 0.5));
+         });
+       }},
+      {"Convolution",
+       [](size_t b) {
+         return image_function(b, [](NodePtr a) {
+           return std::make_shared<op::Convolution>(
+               a, constant(Shape{4, 2, 3, 3}, 0.5), Strides{1, 1},
+               Strides{1, 1});
+         });
+       }},
+      {"AvgPool",
+       [](size_t b) {
+         return image_function(b, [](NodePtr a) {
+           return std::make_shared<op::AvgPool>(a, Shape{2, 2});
+         });
+       }},
+      {"MaxPool",
+       [](size_t b) {
+         return image_function(b, [](NodePtr a) {
+           return std::make_shared<op::MaxPool>(a, Shape{2, 2});
+         });
+       }},
+      {"BatchNormInference",
+       [](size_t b) {
+         return image_function(b, [](NodePtr a) {
+           return std::make_shared<op::BatchNormInference>(
+               a, constant(Shape{2}, 1), constant(Shape{2}, 0.5),
+               constant(Shape{2}, 0.25), constant(Shape{2}, 2), 0.001);
+         });
+       }},
+      {"Broadcast",
+       [](size_t b) {
+         return unary_function(b, [b](NodePtr a) {
+           return std::make_shared<op::Broadcast>(a, Shape{b, 4, 64},
+                                                  AxisSet{1});
+         });
+       }},
+      {"Concat",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Concat>(NodeVector{a, a}, 1);
+         });
+       }},
+      {"Pad",
+       [](size_t b) {
+         return image_function(b, [](NodePtr a) {
+           return std::make_shared<op::Pad>(a, constant(Shape{}, 0),
+                                            CoordinateDiff{0, 0, 1, 1},
+                                            CoordinateDiff{0, 0, 1, 1});
+         });
+       }},
+      {"Reshape",
+       [](size_t b) {
+         return unary_function(b, [b](NodePtr a) {
+           return std::make_shared<op::Reshape>(a, AxisVector{0, 1},
+                                                Shape{b, 8, 8});
+         });
+       }},
+      {"Reverse",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Reverse>(a, AxisSet{1});
+         });
+       }},
+      {"Slice",
+       [](size_t b) {
+         return unary_function(b, [b](NodePtr a) {
+           return std::make_shared<op::Slice>(a, Coordinate{0, 0},
+                                              Coordinate{b, 32});
+         });
+       }},
+      {"Sum",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Sum>(a, AxisSet{1});
+         });
+       }},
+      {"Max",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Max>(a, AxisSet{1});
+         });
+       }},
+      {"Softmax",
+       [](size_t b) {
+         return unary_function(b, [](NodePtr a) {
+           return std::make_shared<op::Softmax>(a, AxisSet{1});
+         });
+       }}};
+  return benchmarks;
+}
+
+/// \brief Returns the parameter sets in configs/, except debug parameters
+std::vector<std::string> config_files() {
+  std::vector<std::string> files;
+  for (const auto& entry : std::filesystem::directory_iterator(
+           std::string(PROJECT_ROOT_DIR) + "/configs")) {
+    std::string file = entry.path().string();
+    if (entry.path().extension() == ".json" &&
+        file.find("_debug") == std::string::npos) {
+      files.emplace_back(file);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+void run_kernel_benchmark(benchmark::State& state,
+                          const KernelBenchmark& kernel,
+                          const std::string& config_file, bool packed) {
+#ifdef _OPENMP
+  omp_set_num_threads(static_cast<int>(state.range(0)));
+#endif
+  try {
+    auto backend = runtime::Backend::create("HE_SEAL");
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+    size_t batch_size = packed ? s_packed_batch_size : 1;
+    auto function = kernel.make_function(batch_size);
+
+    std::map<std::string, std::string> config{
+        {"enable_client", "false"}, {"encryption_parameters", config_file}};
+    config.insert(kernel.config.begin(), kernel.config.end());
+    const auto& parameters = function->get_parameters();
+    for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+      std::string tensor_config = param_idx == 0 ? "encrypt" : "";
+      if (packed) {
+        tensor_config += param_idx == 0 ? ",packed" : "packed";
+      }
+      config[parameters[param_idx]->get_name()] = tensor_config;
+    }
+    std::string error_str;
+    NGRAPH_CHECK(he_backend->set_config(config, error_str), error_str);
+
+    auto handle = backend->compile(function);
+
+    std::vector<std::shared_ptr<runtime::Tensor>> inputs;
+    for (const auto& parameter : parameters) {
+      auto input = he_backend->create_plain_tensor(
+          element::f32, parameter->get_shape(), packed);
+      std::vector<float> values(shape_size(parameter->get_shape()), 0.5);
+      input->write(values.data(), values.size() * sizeof(float));
+      inputs.emplace_back(input);
+    }
+    std::vector<std::shared_ptr<runtime::Tensor>> outputs;
+    for (const auto& result : function->get_results()) {
+      outputs.emplace_back(he_backend->create_plain_tensor(
+          element::f32, result->get_shape(), packed));
+    }
+
+    for (auto _ : state) {
+      handle->call(outputs, inputs);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(batch_size));
+    state.counters["batch_size"] = static_cast<double>(batch_size);
+  } catch (const std::exception& e) {
+    // Not every kernel supports every parameter set, e.g. with too few
+    // coefficient moduli
+    state.SkipWithError(e.what());
+  }
+}
+
+void run_primitive_benchmark(benchmark::State& state, HEPrimitive primitive,
+                             const std::string& config_file) {
+  try {
+    auto backend = runtime::Backend::create("HE_SEAL");
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+    std::string error_str;
+    NGRAPH_CHECK(he_backend->set_config(
+                     {{"encryption_parameters", config_file}}, error_str),
+                 error_str);
+
+    auto context = he_backend->get_context();
+    auto& encoder = *he_backend->get_ckks_encoder();
+    auto& encryptor = *he_backend->get_encryptor();
+    auto& evaluator = *he_backend->get_evaluator();
+    auto parms_id = context->first_parms_id();
+    double scale = he_backend->get_scale();
+
+    std::vector<double> values(encoder.slot_count(), 0.5);
+    seal::Plaintext plain;
+    encoder.encode(values, parms_id, scale, plain);
+    seal::Ciphertext cipher;
+    encryptor.encrypt(plain, cipher);
+    seal::Ciphertext product;
+    evaluator.multiply(cipher, cipher, product);
+    std::shared_ptr<seal::GaloisKeys> galois_keys;
+    if (primitive == HEPrimitive::rotate) {
+      galois_keys = he_backend->get_galois_keys({1});
+    }
+
+#ifdef SEAL_USE_INTEL_HEXL
+    state.SetLabel("hexl");
+#else
+    state.SetLabel("native");
+#endif
+
+    seal::Ciphertext result;
+    auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+      switch (primitive) {
+        case HEPrimitive::encode:
+          encoder.encode(values, parms_id, scale, plain);
+          break;
+        case HEPrimitive::encrypt:
+          encryptor.encrypt(plain, result);
+          break;
+        case HEPrimitive::multiply_plain:
+          evaluator.multiply_plain(cipher, plain, result);
+          break;
+        case HEPrimitive::multiply:
+          evaluator.multiply(cipher, cipher, result);
+          break;
+        case HEPrimitive::relinearize:
+          evaluator.relinearize(product, *he_backend->get_relin_keys(),
+                                result);
+          break;
+        case HEPrimitive::rescale:
+          evaluator.rescale_to_next(cipher, result);
+          break;
+        case HEPrimitive::rotate:
+          evaluator.rotate_vector(cipher, 1, *galois_keys, result);
+          break;
+      }
+      benchmark::DoNotOptimize(result);
+    }
+    std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    size_t num_moduli =
+        context->get_context_data(parms_id)->parms().coeff_modulus().size();
+    double coeffs =
+        static_cast<double>(encoder.slot_count() * 2 * num_moduli) *
+        (HECostCalibration::is_key_switching(primitive)
+             ? static_cast<double>(num_moduli)
+             : 1.0);
+    state.counters["coeff_us"] =
+        elapsed.count() / static_cast<double>(state.iterations()) / coeffs;
+  } catch (const std::exception& e) {
+    // E.g. parameter sets with a single coefficient modulus cannot rescale
+    state.SkipWithError(e.what());
+  }
+}
+
+}  // namespace
+}  // namespace ngraph::runtime::he
+
+int main(int argc, char** argv) {
+  using namespace ngraph::runtime::he;
+  benchmark::Initialize(&argc, argv);
+
+  auto max_threads =
+      static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency()));
+  for (const auto& config_file : config_files()) {
+    std::string config_name = std::filesystem::path(config_file).stem();
+    for (bool packed : {false, true}) {
+      for (const auto& kernel : kernel_benchmarks()) {
+        std::string name = kernel.name + "/" + config_name +
+                           (packed ? "/packed" : "/unpacked");
+        benchmark::RegisterBenchmark(
+            name.c_str(),
+            [kernel, config_file, packed](benchmark::State& state) {
+              run_kernel_benchmark(state, kernel, config_file, packed);
+            })
+            ->ArgName("threads")
+            ->RangeMultiplier(2)
+            ->Range(1, max_threads)
+            ->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+      }
+    }
+  }
+
+  for (const auto& config_file : config_files()) {
+    std::string config_name = std::filesystem::path(config_file).stem();
+    for (size_t i = 0; i < s_num_he_primitives; ++i) {
+      auto primitive = static_cast<HEPrimitive>(i);
+      std::string name =
+          "Primitive/" + he_primitive_name(primitive) + "/" + config_name;
+      benchmark::RegisterBenchmark(
+          name.c_str(),
+          [primitive, config_file](benchmark::State& state) {
+            run_primitive_benchmark(state, primitive, config_file);
+          })
+          ->ArgName("threads")
+          ->Arg(1)
+          ->Unit(benchmark::kMicrosecond)
+          ->UseRealTime();
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,354 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+// Benchmarks the operations of an HESealClient without a server, for every
+// parameter set in configs/:
+//   Keygen: construction of an offline client, i.e. the SEAL context, the
+//     secret, public and relinearization keys, and their serialization.
+//     Contexts are cached after the first iteration
+//   KeySerialize: the keys message sent to the server, packed for the wire
+//   InputEncrypt: encryption and serialization of the input requested by an
+//     inference request, in the chunks uploaded to the server
+//   Relu: handling of a relu request, i.e. loading, decrypting, computing
+//     the ReLU, re-encrypting and saving the values, packed for the wire
+//   ResultDecode: loading, decryption and decoding of a result
+// The tensor benchmarks take the number of ciphertexts, one value each, and
+// the number of OpenMP threads, and report the ciphertexts per second. Relu
+// also reports its phases, see HESealClientStats, as the load_ms, relu_ms
+// and write_ms counters. The client is often the slower party, so these set
+// the minimum hardware of clients. Run with --benchmark_out=<file>
+// --benchmark_out_format=json to store the results
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "he_tensor.hpp"
+#include "ngraph/check.hpp"
+#include "nlohmann/json.hpp"
+#include "protos/message.pb.h"
+#include "seal/he_seal_client.hpp"
+#include "seal/he_seal_encryption_parameters.hpp"
+#include "tcp/tcp_message.hpp"
+#include "tcp/transport.hpp"
+
+using json = nlohmann::json;
+
+namespace ngraph::runtime::he {
+namespace {
+
+/// \brief Name of the client's input tensor
+const std::string s_input_name{"x"};
+
+/// \brief Transport keeping the messages written by an offline client
+class MessageSink : public ClientTransport {
+ public:
+  void write_message(TCPMessage&& message) override {
+    m_messages.emplace_back(std::move(message));
+  }
+
+  void close() override {}
+
+  std::vector<TCPMessage>& messages() { return m_messages; }
+
+ private:
+  std::vector<TCPMessage> m_messages;
+};
+
+/// \brief Client which is not connected to a server, and its input
+struct OfflineClient {
+  OfflineClient(const std::string& config_file, size_t num_ciphers)
+      : values(num_ciphers, 0.5) {
+    auto transport = std::make_unique<MessageSink>();
+    sink = transport.get();
+    HEInputViewMap inputs{
+        {s_input_name,
+         HEInputView{"encrypt", element::f64, values.data(), values.size()}}};
+    client = std::make_unique<HESealClient>(
+        HESealEncryptionParameters::parse_config_or_use_default(
+            config_file.c_str()),
+        1, inputs, std::move(transport));
+  }
+
+  std::vector<double> values;
+  MessageSink* sink{nullptr};
+  std::unique_ptr<HESealClient> client;
+};
+
+/// \brief Returns the parameter sets in configs/, except debug parameters
+std::vector<std::string> config_files() {
+  std::vector<std::string> files;
+  for (const auto& entry : std::filesystem::directory_iterator(
+           std::string(PROJECT_ROOT_DIR) + "/configs")) {
+    std::string file = entry.path().string();
+    if (entry.path().extension() == ".json" &&
+        file.find("_debug") == std::string::npos) {
+      files.emplace_back(file);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+void set_num_threads(const benchmark::State& state) {
+#ifdef _OPENMP
+  omp_set_num_threads(static_cast<int>(state.range(1)));
+#endif
+}
+
+/// \brief Returns a message storing a tensor of ciphertexts encrypted with
+/// the client's keys, as received from the server
+/// \param[in] pb_message Message to add the tensor to
+/// \param[in] client Client whose keys encrypt the tensor
+/// \param[in] num_ciphers Number of ciphertexts of the tensor
+TCPMessage received_tensor_message(pb::TCPMessage&& pb_message,
+                                   const HESealClient& client,
+                                   size_t num_ciphers) {
+  HETensor tensor(element::f64, Shape{1, num_ciphers}, false,
+                  client.complex_packing(), true, *client.get_ckks_encoder(),
+                  client.get_context(), *client.get_encryptor(),
+                  *client.get_decryptor(), client.encryption_paramters(),
+                  s_input_name);
+  std::vector<double> values(num_ciphers, -0.5);
+  tensor.write(values.data(), values.size() * sizeof(double));
+
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors = tensor.write_to_pb_tensors(&segments);
+  NGRAPH_CHECK(pb_tensors.size() == 1, "Tensor stored in ", pb_tensors.size(),
+               " protobuf tensors");
+  *pb_message.add_he_tensors() = std::move(pb_tensors[0]);
+  TCPMessage message(std::move(pb_message), std::move(segments[0]));
+
+  TCPMessage::data_buffer buffer;
+  NGRAPH_CHECK(message.pack(buffer), "Error packing message");
+  auto payload = std::make_shared<TCPMessage::data_buffer>();
+  for (const auto& segment : message.segments()) {
+    const auto* data = static_cast<const char*>(segment.data);
+    payload->insert(payload->end(), data, data + segment.size);
+  }
+  TCPMessage received;
+  NGRAPH_CHECK(received.unpack(buffer), "Error unpacking message");
+  received.set_payload(std::move(payload));
+  return received;
+}
+
+void set_ciphers_processed(benchmark::State& state, size_t num_ciphers) {
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(num_ciphers));
+}
+
+void run_keygen_benchmark(benchmark::State& state,
+                          const std::string& config_file) {
+  try {
+    for (auto _ : state) {
+      OfflineClient offline(config_file, 1);
+      benchmark::DoNotOptimize(offline.client);
+    }
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void run_key_serialize_benchmark(benchmark::State& state,
+                                 const std::string& config_file) {
+  try {
+    OfflineClient offline(config_file, 1);
+    auto& messages = offline.sink->messages();
+    TCPMessage::data_buffer buffer;
+    for (auto _ : state) {
+      offline.client->send_public_and_relin_keys();
+      NGRAPH_CHECK(messages.back().pack(buffer), "Error packing message");
+      messages.clear();
+    }
+    state.counters["bytes"] =
+        static_cast<double>(offline.client->stats().bytes_sent()) /
+        static_cast<double>(state.iterations());
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void run_input_encrypt_benchmark(benchmark::State& state,
+                                 const std::string& config_file) {
+  set_num_threads(state);
+  try {
+    auto num_ciphers = static_cast<size_t>(state.range(0));
+    OfflineClient offline(config_file, num_ciphers);
+
+    pb::TCPMessage request;
+    request.set_type(pb::TCPMessage_Type_REQUEST);
+    json js = {{"function", "Parameter"}};
+    request.mutable_function()->set_function(js.dump());
+    pb::HETensor* pb_tensor = request.add_he_tensors();
+    pb_tensor->set_name(s_input_name);
+    pb_tensor->add_shape(1);
+    pb_tensor->add_shape(num_ciphers);
+
+    for (auto _ : state) {
+      offline.client->handle_inference_request(request);
+      state.PauseTiming();
+      offline.sink->messages().clear();
+      state.ResumeTiming();
+    }
+    set_ciphers_processed(state, num_ciphers);
+    state.counters["bytes"] =
+        static_cast<double>(offline.client->stats().bytes_sent()) /
+        static_cast<double>(state.iterations());
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void run_relu_benchmark(benchmark::State& state,
+                        const std::string& config_file) {
+  set_num_threads(state);
+  try {
+    auto num_ciphers = static_cast<size_t>(state.range(0));
+    OfflineClient offline(config_file, 1);
+    HESealClient& client = *offline.client;
+
+    // Re-encrypts the values at the level of the request
+    pb::TCPMessage pb_request;
+    pb_request.set_type(pb::TCPMessage_Type_REQUEST);
+    pb_request.mutable_op_request()->set_op(pb::OpRequest_Op_RELU);
+    pb_request.mutable_op_request()->set_chain_index(
+        client.get_context()->first_context_data()->chain_index());
+    TCPMessage request =
+        received_tensor_message(std::move(pb_request), client, num_ciphers);
+
+    TCPMessage::data_buffer buffer;
+    for (auto _ : state) {
+      // The handler reuses the protobuf message of its request
+      state.PauseTiming();
+      TCPMessage detached = request.detach();
+      state.ResumeTiming();
+      TCPMessage response = client.handle_relu_request(detached);
+      NGRAPH_CHECK(response.pack(buffer), "Error packing message");
+    }
+    set_ciphers_processed(state, num_ciphers);
+
+    auto phases = client.stats().phases();
+    const std::vector<std::pair<std::string, std::string>> phase_counters{
+        {"relu_load", "load_ms"},
+        {"relu", "relu_ms"},
+        {"relu_write", "write_ms"}};
+    for (const auto& [phase, counter] : phase_counters) {
+      const HEClientPhaseStats& phase_stats = phases[phase];
+      state.counters[counter] =
+          phase_stats.calls == 0
+              ? 0
+              : 1e3 * phase_stats.seconds /
+                    static_cast<double>(phase_stats.calls);
+    }
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void run_result_decode_benchmark(benchmark::State& state,
+                                 const std::string& config_file) {
+  set_num_threads(state);
+  try {
+    auto num_ciphers = static_cast<size_t>(state.range(0));
+    OfflineClient offline(config_file, 1);
+    HESealClient& client = *offline.client;
+
+    pb::TCPMessage pb_result;
+    pb_result.set_type(pb::TCPMessage_Type_RESPONSE);
+    TCPMessage result =
+        received_tensor_message(std::move(pb_result), client, num_ciphers);
+
+    for (auto _ : state) {
+      client.handle_result(result);
+      state.PauseTiming();
+      client.clear_results();
+      state.ResumeTiming();
+    }
+    set_ciphers_processed(state, num_ciphers);
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+}  // namespace
+}  // namespace ngraph::runtime::he
+
+int main(int argc, char** argv) {
+  using namespace ngraph::runtime::he;
+  benchmark::Initialize(&argc, argv);
+
+  auto max_threads =
+      static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency()));
+  std::vector<int64_t> thread_counts;
+  for (int64_t num_threads = 1; num_threads < max_threads; num_threads *= 2) {
+    thread_counts.emplace_back(num_threads);
+  }
+  thread_counts.emplace_back(max_threads);
+
+  auto register_tensor = [&thread_counts](const std::string& name,
+                                          auto&& func) {
+    auto* registered = benchmark::RegisterBenchmark(name.c_str(), func);
+    registered->ArgNames({"ciphers", "threads"});
+    for (int64_t num_ciphers : {16, 256}) {
+      for (int64_t num_threads : thread_counts) {
+        registered->Args({num_ciphers, num_threads});
+      }
+    }
+    registered->Unit(benchmark::kMillisecond)->UseRealTime();
+  };
+
+  for (const auto& config_file : config_files()) {
+    std::string config_name = std::filesystem::path(config_file).stem();
+    benchmark::RegisterBenchmark(("Keygen/" + config_name).c_str(),
+                                 [config_file](benchmark::State& state) {
+                                   run_keygen_benchmark(state, config_file);
+                                 })
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+    benchmark::RegisterBenchmark(
+        ("KeySerialize/" + config_name).c_str(),
+        [config_file](benchmark::State& state) {
+          run_key_serialize_benchmark(state, config_file);
+        })
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+    register_tensor("InputEncrypt/" + config_name,
+                    [config_file](benchmark::State& state) {
+                      run_input_encrypt_benchmark(state, config_file);
+                    });
+    register_tensor("Relu/" + config_name,
+                    [config_file](benchmark::State& state) {
+                      run_relu_benchmark(state, config_file);
+                    });
+    register_tensor("ResultDecode/" + config_name,
+                    [config_file](benchmark::State& state) {
+                      run_result_decode_benchmark(state, config_file);
+                    });
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
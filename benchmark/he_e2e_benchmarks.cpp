@@ -0,0 +1,278 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+// Benchmarks complete client-server inferences of the example networks
+// through an emulated network. Each iteration compiles the network, runs a
+// new client connected to the server through a NetworkEmulator, and reports
+// the latency of each protocol phase as counters:
+//   key_setup_ms: client start until the server received the client keys
+//   upload_ms: server request for inputs until the inputs were delivered,
+//     including client encryption
+//   compute_ms: server computation, excluding activation round-trips
+//   nonlinear_ms: time spent awaiting client activations
+//   download_ms: first result message until the client decrypted the result
+//   <op>_ms: server computation per op type
+// The link latency and bandwidth are set with --latency_ms=<float> and
+// --bandwidth_mbit=<float>, otherwise loopback, LAN and WAN links are
+// benchmarked. Only the connection between the HESealClient and the
+// HESealExecutable is emulated, not garbled circuit connections
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "network_emulator.hpp"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_client.hpp"
+#include "seal/he_seal_executable.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+
+/// \brief Port the server listens at
+constexpr size_t s_server_port = 35000;
+/// \brief Port the emulated link listens at
+constexpr size_t s_link_port = 35100;
+
+struct NetworkBenchmark {
+  std::string name;
+  /// \brief Builds the network for the given batch size. The single
+  /// parameter is the client input
+  std::function<std::shared_ptr<Function>(size_t)> make_function;
+};
+
+struct LinkProfile {
+  std::string name;
+  NetworkLink link;
+};
+
+std::shared_ptr<op::Constant> weights(const Shape& shape) {
+  return op::Constant::create(element::f32, shape,
+                              std::vector<float>(shape_size(shape), 0.01f));
+}
+
+std::shared_ptr<Node> square(const std::shared_ptr<Node>& x) {
+  return std::make_shared<op::Multiply>(x, x);
+}
+
+std::shared_ptr<Node> relu(const std::shared_ptr<Node>& x) {
+  return std::make_shared<op::Relu>(x);
+}
+
+/// \brief Convolution, activation and two dense layers, as in the CryptoNets
+/// MNIST example
+std::shared_ptr<Function> cryptonets(
+    size_t batch_size,
+    const std::function<std::shared_ptr<Node>(std::shared_ptr<Node>)>&
+        activation) {
+  auto x = std::make_shared<op::Parameter>(element::f32,
+                                           Shape{batch_size, 1, 28, 28});
+  std::shared_ptr<Node> t = std::make_shared<op::Convolution>(
+      x, weights(Shape{5, 1, 5, 5}), Strides{2, 2}, Strides{1, 1});
+  t = activation(t);
+  t = std::make_shared<op::Reshape>(t, AxisVector{0, 1, 2, 3},
+                                    Shape{batch_size, 5 * 12 * 12});
+  t = std::make_shared<op::Dot>(t, weights(Shape{5 * 12 * 12, 100}));
+  t = activation(t);
+  t = std::make_shared<op::Dot>(t, weights(Shape{100, 10}));
+  return std::make_shared<Function>(t, ParameterVector{x});
+}
+
+/// \brief Two dense layers with a relu activation, as in the MLP MNIST
+/// example
+std::shared_ptr<Function> mlp(size_t batch_size) {
+  auto x =
+      std::make_shared<op::Parameter>(element::f32, Shape{batch_size, 784});
+  std::shared_ptr<Node> t =
+      std::make_shared<op::Dot>(x, weights(Shape{784, 128}));
+  t = relu(t);
+  t = std::make_shared<op::Dot>(t, weights(Shape{128, 10}));
+  return std::make_shared<Function>(t, ParameterVector{x});
+}
+
+std::vector<NetworkBenchmark> network_benchmarks() {
+  return {{"Cryptonets", [](size_t b) { return cryptonets(b, square); }},
+          {"Cryptonets-Relu", [](size_t b) { return cryptonets(b, relu); }},
+          {"MLP", mlp}};
+}
+
+/// \brief Removes --latency_ms and --bandwidth_mbit from the arguments
+/// \returns The custom link, if either flag was given
+std::vector<LinkProfile> parse_link_profiles(int* argc, char** argv) {
+  NetworkLink link;
+  bool custom = false;
+  int num_args = 1;
+  for (int i = 1; i < *argc; ++i) {
+    std::string arg{argv[i]};
+    if (arg.rfind("--latency_ms=", 0) == 0) {
+      link.latency_ms = std::stod(arg.substr(std::strlen("--latency_ms=")));
+      custom = true;
+    } else if (arg.rfind("--bandwidth_mbit=", 0) == 0) {
+      link.bandwidth_mbit =
+          std::stod(arg.substr(std::strlen("--bandwidth_mbit=")));
+      custom = true;
+    } else {
+      argv[num_args++] = argv[i];
+    }
+  }
+  *argc = num_args;
+
+  if (custom) {
+    return {{"custom", link}};
+  }
+  return {{"loopback", NetworkLink{0, 0}},
+          {"lan", NetworkLink{0.5, 1000}},
+          {"wan", NetworkLink{40, 100}}};
+}
+
+double elapsed_ms(NetworkEmulator::Clock::time_point start,
+                  NetworkEmulator::Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void run_network_benchmark(benchmark::State& state,
+                           const NetworkBenchmark& network,
+                           const NetworkLink& link) {
+  auto batch_size = static_cast<size_t>(state.range(0));
+  std::map<std::string, double> phase_ms;
+  double upload_bytes = 0;
+  double download_bytes = 0;
+  double round_trips = 0;
+
+  try {
+    for (auto _ : state) {
+      auto backend = runtime::Backend::create("HE_SEAL");
+      auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+      auto function = network.make_function(batch_size);
+      const auto& param = function->get_parameters()[0];
+      std::string error_str;
+      NGRAPH_CHECK(
+          he_backend->set_config(
+              {{"enable_client", "true"},
+               {"port", std::to_string(s_server_port)},
+               {"encryption_parameters",
+                std::string(PROJECT_ROOT_DIR) +
+                    "/configs/he_seal_ckks_config_N13_L7.json"},
+               {param->get_name(), "client_input,encrypt,packed"}},
+              error_str),
+          error_str);
+      auto handle = std::static_pointer_cast<HESealExecutable>(
+          backend->compile(function));
+
+      // Server inputs which are not used
+      auto t_dummy = he_backend->create_plain_tensor(
+          element::f32, param->get_shape(), true);
+      auto t_result = he_backend->create_cipher_tensor(
+          element::f32, function->get_results()[0]->get_shape(), true);
+
+      NetworkEmulator emulator(s_link_port, s_server_port, link);
+      NetworkEmulator::Clock::time_point client_start;
+      NetworkEmulator::Clock::time_point client_done;
+      std::thread client_thread([&]() {
+        std::vector<float> inputs(shape_size(param->get_shape()), 0.5f);
+        client_start = NetworkEmulator::Clock::now();
+        HESealClient client(
+            "localhost", s_link_port, batch_size,
+            HETensorConfigMap<float>{
+                {param->get_name(), std::make_pair("encrypt", inputs)}});
+        client.get_results();
+        client_done = NetworkEmulator::Clock::now();
+      });
+      handle->call(std::vector<std::shared_ptr<runtime::Tensor>>{t_result},
+                   std::vector<std::shared_ptr<runtime::Tensor>>{t_dummy});
+      client_thread.join();
+
+      auto keys = emulator.stats(MessageKind::KeySetup);
+      auto shape = emulator.stats(MessageKind::InferenceShape);
+      auto upload = emulator.stats(MessageKind::Upload);
+      auto download = emulator.stats(MessageKind::Download);
+      auto requests = emulator.stats(MessageKind::NonlinearRequest);
+      double nonlinear_ms = emulator.nonlinear_busy_ms();
+
+      state.SetIterationTime(elapsed_ms(client_start, client_done) / 1000);
+      phase_ms["key_setup_ms"] += elapsed_ms(client_start, keys.last_delivery);
+      phase_ms["upload_ms"] +=
+          elapsed_ms(shape.last_delivery, upload.last_delivery);
+      phase_ms["compute_ms"] +=
+          elapsed_ms(upload.last_delivery, download.first_arrival) -
+          nonlinear_ms;
+      phase_ms["nonlinear_ms"] += nonlinear_ms;
+      phase_ms["download_ms"] +=
+          elapsed_ms(download.first_arrival, client_done);
+      for (const auto& counter : handle->get_performance_data()) {
+        phase_ms[counter.get_node()->description() + "_ms"] +=
+            static_cast<double>(counter.total_microseconds()) / 1000;
+      }
+      upload_bytes += static_cast<double>(upload.num_bytes);
+      download_bytes += static_cast<double>(download.num_bytes);
+      round_trips += static_cast<double>(requests.num_messages);
+    }
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+    return;
+  }
+
+  for (const auto& [name, ms] : phase_ms) {
+    state.counters[name] =
+        benchmark::Counter(ms, benchmark::Counter::kAvgIterations);
+  }
+  state.counters["upload_bytes"] =
+      benchmark::Counter(upload_bytes, benchmark::Counter::kAvgIterations);
+  state.counters["download_bytes"] =
+      benchmark::Counter(download_bytes, benchmark::Counter::kAvgIterations);
+  state.counters["nonlinear_round_trips"] =
+      benchmark::Counter(round_trips, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() *
+                          static_cast<int64_t>(batch_size));
+}
+
+}  // namespace
+}  // namespace ngraph::runtime::he
+
+int main(int argc, char** argv) {
+  using namespace ngraph::runtime::he;
+  auto link_profiles = parse_link_profiles(&argc, argv);
+  benchmark::Initialize(&argc, argv);
+
+  for (const auto& profile : link_profiles) {
+    for (const auto& network : network_benchmarks()) {
+      std::string name = network.name + "/" + profile.name;
+      NetworkLink link = profile.link;
+      benchmark::RegisterBenchmark(
+          name.c_str(),
+          [network, link](benchmark::State& state) {
+            run_network_benchmark(state, network, link);
+          })
+          ->ArgName("batch_size")
+          ->RangeMultiplier(8)
+          ->Range(1, 4096)
+          ->Unit(benchmark::kMillisecond)
+          ->UseManualTime();
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
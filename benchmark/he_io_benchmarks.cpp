@@ -0,0 +1,387 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+// Benchmarks the serialization and transport layer for every parameter set
+// in configs/:
+//   CiphertextSave, CiphertextLoad: SealCiphertextWrapper::save and load, per
+//     compression mode
+//   TensorWrite, TensorLoad: HETensor::write_to_pb_tensors and
+//     load_from_pb_tensors, with ciphertext data as zero-copy payload
+//     segments ("segments") or copied into the protobuf ("inline"), and per
+//     compression mode
+//   MessagePack, MessageUnpack: TCPMessage::pack and unpack of a tensor
+//   SessionThroughput: messages written by a TCPClient to a TCPSession over
+//     loopback, each awaited until received
+// Each benchmark reports the serialized bytes per second, and tensors are
+// benchmarked with increasing numbers of ciphertexts. Run with
+// --benchmark_out=<file> --benchmark_out_format=json to store the results
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "he_tensor.hpp"
+#include "ngraph/ngraph.hpp"
+#include "protos/message.pb.h"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "tcp/tcp_client.hpp"
+#include "tcp/tcp_message.hpp"
+#include "tcp/tcp_session.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+
+/// \brief Port the loopback session listens at
+constexpr size_t s_session_port = 35200;
+
+/// \brief Compression modes to benchmark. Modes which SEAL was built
+/// without are skipped
+const std::vector<std::string> s_compr_modes{"none", "zlib", "zstd"};
+
+/// \brief Returns the parameter sets in configs/, except debug parameters
+std::vector<std::string> config_files() {
+  std::vector<std::string> files;
+  for (const auto& entry : std::filesystem::directory_iterator(
+           std::string(PROJECT_ROOT_DIR) + "/configs")) {
+    std::string file = entry.path().string();
+    if (entry.path().extension() == ".json" &&
+        file.find("_debug") == std::string::npos) {
+      files.emplace_back(file);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  return files;
+}
+
+/// \brief Returns a backend with the given parameter set
+std::shared_ptr<runtime::Backend> create_backend(
+    const std::string& config_file) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  std::string error_str;
+  NGRAPH_CHECK(static_cast<HESealBackend*>(backend.get())
+                   ->set_config({{"encryption_parameters", config_file}},
+                                error_str),
+               error_str);
+  return backend;
+}
+
+/// \brief Returns a tensor of the given number of ciphertexts
+std::shared_ptr<HETensor> cipher_tensor(HESealBackend& he_backend,
+                                        size_t num_ciphers) {
+  auto tensor = std::static_pointer_cast<HETensor>(
+      he_backend.create_cipher_tensor(element::f32, Shape{num_ciphers}));
+  std::vector<float> values(num_ciphers, 0.5);
+  tensor->write(values.data(), values.size() * sizeof(float));
+  return tensor;
+}
+
+/// \brief Copies the payload segments of a message into one buffer, as
+/// received
+std::vector<char> gather_payload(const TCPMessage::Segments& segments) {
+  std::vector<char> payload;
+  for (const auto& segment : segments) {
+    const auto* data = static_cast<const char*>(segment.data);
+    payload.insert(payload.end(), data, data + segment.size);
+  }
+  return payload;
+}
+
+/// \brief Returns the serialized size of proto tensors and their payload
+size_t serialized_bytes(const std::vector<pb::HETensor>& pb_tensors,
+                        const std::vector<TCPMessage::Segments>& segments) {
+  size_t bytes = 0;
+  for (const auto& pb_tensor : pb_tensors) {
+    bytes += pb_tensor.ByteSizeLong();
+  }
+  for (const auto& tensor_segments : segments) {
+    for (const auto& segment : tensor_segments) {
+      bytes += segment.size;
+    }
+  }
+  return bytes;
+}
+
+void set_bytes_processed(benchmark::State& state, size_t bytes) {
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+  state.counters["bytes"] = static_cast<double>(bytes);
+}
+
+void run_ciphertext_benchmark(benchmark::State& state,
+                              const std::string& config_file,
+                              const std::string& compr_name, bool load) {
+  try {
+    auto compr_mode = compr_mode_from_string(compr_name);
+    auto backend = create_backend(config_file);
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+    auto tensor = cipher_tensor(*he_backend, 1);
+    const auto& cipher = *tensor->data()[0].get_ciphertext();
+
+    pb::HEType pb_he_type;
+    cipher.save(pb_he_type, compr_mode);
+    SealCiphertextWrapper loaded;
+    for (auto _ : state) {
+      if (load) {
+        SealCiphertextWrapper::load(loaded, pb_he_type,
+                                    he_backend->get_context());
+        benchmark::DoNotOptimize(loaded);
+      } else {
+        cipher.save(pb_he_type, compr_mode);
+        benchmark::DoNotOptimize(pb_he_type);
+      }
+    }
+    set_bytes_processed(state, pb_he_type.ByteSizeLong());
+  } catch (const std::exception& e) {
+    // E.g. compression modes SEAL was built without
+    state.SkipWithError(e.what());
+  }
+}
+
+void run_tensor_benchmark(benchmark::State& state,
+                          const std::string& config_file,
+                          const std::string& compr_name, bool with_segments,
+                          bool load) {
+  try {
+    auto compr_mode = compr_mode_from_string(compr_name);
+    auto backend = create_backend(config_file);
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+    auto tensor =
+        cipher_tensor(*he_backend, static_cast<size_t>(state.range(0)));
+
+    std::vector<TCPMessage::Segments> segments;
+    auto* segments_ptr = with_segments ? &segments : nullptr;
+    auto pb_tensors = tensor->write_to_pb_tensors(segments_ptr, compr_mode);
+    NGRAPH_CHECK(pb_tensors.size() == 1, "Tensor does not fit one message");
+    std::vector<char> payload =
+        segments.empty() ? std::vector<char>() : gather_payload(segments[0]);
+
+    for (auto _ : state) {
+      if (load) {
+        auto loaded = HETensor::load_from_pb_tensors(
+            pb_tensors, *he_backend->get_ckks_encoder(),
+            he_backend->get_context(), *he_backend->get_encryptor(),
+            *he_backend->get_decryptor(),
+            he_backend->get_encryption_parameters(), payload.data(),
+            payload.size());
+        benchmark::DoNotOptimize(loaded);
+      } else {
+        segments.clear();
+        pb_tensors = tensor->write_to_pb_tensors(segments_ptr, compr_mode);
+        benchmark::DoNotOptimize(pb_tensors);
+      }
+    }
+    set_bytes_processed(state, serialized_bytes(pb_tensors, segments));
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+/// \brief Returns a message storing a tensor, with its ciphertext data as
+/// payload segments
+TCPMessage tensor_message(const HETensor& tensor) {
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors = tensor.write_to_pb_tensors(&segments);
+  NGRAPH_CHECK(pb_tensors.size() == 1, "Tensor does not fit one message");
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+  *pb_message.add_he_tensors() = std::move(pb_tensors[0]);
+  return TCPMessage(std::move(pb_message), std::move(segments[0]));
+}
+
+void run_message_benchmark(benchmark::State& state,
+                           const std::string& config_file, bool unpack) {
+  try {
+    auto backend = create_backend(config_file);
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+    auto tensor =
+        cipher_tensor(*he_backend, static_cast<size_t>(state.range(0)));
+    TCPMessage message = tensor_message(*tensor);
+
+    TCPMessage::data_buffer buffer;
+    NGRAPH_CHECK(message.pack(buffer), "Error packing message");
+    TCPMessage unpacked;
+    for (auto _ : state) {
+      if (unpack) {
+        NGRAPH_CHECK(unpacked.unpack(buffer), "Error unpacking message");
+        benchmark::DoNotOptimize(unpacked);
+      } else {
+        NGRAPH_CHECK(message.pack(buffer), "Error packing message");
+        benchmark::DoNotOptimize(buffer);
+      }
+    }
+    set_bytes_processed(state, buffer.size() + message.segments_size());
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+/// \brief Accepts a single loopback TCPSession, and counts the messages it
+/// receives
+class LoopbackServer {
+ public:
+  explicit LoopbackServer(size_t port)
+      : m_acceptor(m_io_context,
+                   boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(),
+                                                  port)) {
+    m_acceptor.async_accept([this](boost::system::error_code ec,
+                                   boost::asio::ip::tcp::socket socket) {
+      NGRAPH_CHECK(!ec, "Error accepting connection ", ec.message());
+      m_session = std::make_shared<TCPSession>(
+          std::move(socket), [this](const TCPMessage& /*message*/) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            ++m_received;
+            m_cond.notify_all();
+          });
+      m_session->start();
+    });
+    m_thread = std::thread([this]() { m_io_context.run(); });
+  }
+
+  ~LoopbackServer() {
+    m_io_context.stop();
+    m_thread.join();
+  }
+
+  /// \brief Waits until the session received the given number of messages
+  void wait_for_messages(size_t count) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [&]() { return m_received >= count; });
+  }
+
+ private:
+  boost::asio::io_context m_io_context;
+  boost::asio::ip::tcp::acceptor m_acceptor;
+  std::shared_ptr<TCPSession> m_session;
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  size_t m_received{0};
+};
+
+void run_session_benchmark(benchmark::State& state,
+                           const std::string& config_file) {
+  try {
+    auto backend = create_backend(config_file);
+    auto he_backend = static_cast<HESealBackend*>(backend.get());
+    auto tensor =
+        cipher_tensor(*he_backend, static_cast<size_t>(state.range(0)));
+    size_t message_bytes = 0;
+    {
+      TCPMessage message = tensor_message(*tensor);
+      TCPMessage::data_buffer buffer;
+      NGRAPH_CHECK(message.pack(buffer), "Error packing message");
+      message_bytes = buffer.size() + message.segments_size();
+    }
+
+    LoopbackServer server(s_session_port);
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::resolver resolver(io_context);
+    auto endpoints =
+        resolver.resolve("localhost", std::to_string(s_session_port));
+    TCPClient client(io_context, endpoints, [](const TCPMessage&) {});
+    auto work = boost::asio::make_work_guard(io_context);
+    std::thread client_thread([&]() { io_context.run(); });
+
+    size_t sent = 0;
+    for (auto _ : state) {
+      TCPMessage message = tensor_message(*tensor);
+      boost::asio::post(io_context, [&client, message]() mutable {
+        client.write_message(std::move(message));
+      });
+      server.wait_for_messages(++sent);
+    }
+    boost::asio::post(io_context, [&client]() { client.close(); });
+    work.reset();
+    client_thread.join();
+    set_bytes_processed(state, message_bytes);
+  } catch (const std::exception& e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+}  // namespace
+}  // namespace ngraph::runtime::he
+
+int main(int argc, char** argv) {
+  using namespace ngraph::runtime::he;
+  benchmark::Initialize(&argc, argv);
+
+  auto register_sized = [](const std::string& name, auto&& func) {
+    benchmark::RegisterBenchmark(name.c_str(), func)
+        ->ArgName("ciphers")
+        ->RangeMultiplier(16)
+        ->Range(1, 256)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+  };
+
+  for (const auto& config_file : config_files()) {
+    std::string config_name = std::filesystem::path(config_file).stem();
+    for (const auto& compr_name : s_compr_modes) {
+      for (bool load : {false, true}) {
+        std::string name =
+            std::string(load ? "CiphertextLoad/" : "CiphertextSave/") +
+            config_name + "/" + compr_name;
+        benchmark::RegisterBenchmark(
+            name.c_str(),
+            [config_file, compr_name, load](benchmark::State& state) {
+              run_ciphertext_benchmark(state, config_file, compr_name, load);
+            })
+            ->Unit(benchmark::kMicrosecond)
+            ->UseRealTime();
+
+        for (bool with_segments : {true, false}) {
+          // Compressed ciphertexts are always copied into the protobuf
+          if (with_segments && compr_name != "none") {
+            continue;
+          }
+          std::string tensor_name =
+              std::string(load ? "TensorLoad/" : "TensorWrite/") +
+              config_name + "/" + compr_name +
+              (with_segments ? "/segments" : "/inline");
+          register_sized(tensor_name, [config_file, compr_name, with_segments,
+                                       load](benchmark::State& state) {
+            run_tensor_benchmark(state, config_file, compr_name, with_segments,
+                                 load);
+          });
+        }
+      }
+    }
+    for (bool unpack : {false, true}) {
+      std::string name =
+          std::string(unpack ? "MessageUnpack/" : "MessagePack/") + config_name;
+      register_sized(name, [config_file, unpack](benchmark::State& state) {
+        run_message_benchmark(state, config_file, unpack);
+      });
+    }
+    register_sized("SessionThroughput/" + config_name,
+                   [config_file](benchmark::State& state) {
+                     run_session_benchmark(state, config_file);
+                   });
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,266 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "network_emulator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "nlohmann/json.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+
+NetworkEmulator::NetworkEmulator(size_t listen_port, size_t server_port,
+                                 NetworkLink link)
+    : m_link(link),
+      m_acceptor(m_io_context),
+      m_client_socket(m_io_context),
+      m_server_socket(m_io_context) {
+  boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(),
+                                          listen_port);
+  m_acceptor.open(endpoint.protocol());
+  m_acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+  m_acceptor.bind(endpoint);
+  m_acceptor.listen();
+
+  m_upstream.from = &m_client_socket;
+  m_upstream.to = &m_server_socket;
+  m_upstream.from_client = true;
+  m_downstream.from = &m_server_socket;
+  m_downstream.to = &m_client_socket;
+
+  m_thread = std::thread([this, server_port]() { run(server_port); });
+}
+
+NetworkEmulator::~NetworkEmulator() {
+  m_stop = true;
+  boost::system::error_code ec;
+  m_acceptor.close(ec);
+  m_client_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+  m_server_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+  for (Pipe* pipe : {&m_upstream, &m_downstream}) {
+    {
+      std::lock_guard<std::mutex> guard(pipe->mutex);
+      pipe->closed = true;
+    }
+    pipe->cond.notify_all();
+  }
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  for (Pipe* pipe : {&m_upstream, &m_downstream}) {
+    if (pipe->reader.joinable()) {
+      pipe->reader.join();
+    }
+    if (pipe->writer.joinable()) {
+      pipe->writer.join();
+    }
+  }
+}
+
+void NetworkEmulator::run(size_t server_port) {
+  boost::system::error_code ec;
+  m_acceptor.accept(m_client_socket, ec);
+  if (ec || m_stop) {
+    return;
+  }
+  NGRAPH_HE_LOG(3) << "Network emulator accepted client";
+
+  boost::asio::ip::tcp::endpoint server_endpoint(
+      boost::asio::ip::address_v4::loopback(), server_port);
+  while (!m_stop) {
+    m_server_socket.connect(server_endpoint, ec);
+    if (!ec) {
+      break;
+    }
+    m_server_socket.close(ec);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  if (m_stop) {
+    return;
+  }
+  NGRAPH_HE_LOG(3) << "Network emulator connected to server";
+
+  for (Pipe* pipe : {&m_upstream, &m_downstream}) {
+    pipe->reader = std::thread([this, pipe]() { read_messages(*pipe); });
+    pipe->writer = std::thread([this, pipe]() { write_messages(*pipe); });
+  }
+}
+
+void NetworkEmulator::read_messages(Pipe& pipe) {
+  while (!m_stop) {
+    auto data = std::make_shared<std::vector<char>>(TCPMessage::header_length);
+    boost::system::error_code ec;
+    boost::asio::read(*pipe.from, boost::asio::buffer(*data), ec);
+    if (ec) {
+      break;
+    }
+    size_t body_size = TCPMessage::decode_header(*data);
+    size_t payload_size = TCPMessage::decode_payload_size(*data);
+    data->resize(TCPMessage::header_length + body_size + payload_size);
+    boost::asio::read(
+        *pipe.from,
+        boost::asio::buffer(data->data() + TCPMessage::header_length,
+                            body_size + payload_size),
+        ec);
+    if (ec) {
+      break;
+    }
+    auto arrival = Clock::now();
+
+    pb::TCPMessage pb_message;
+    MessageKind kind = MessageKind::Other;
+    if (pb_message.ParseFromArray(data->data() + TCPMessage::header_length,
+                                  static_cast<int>(body_size))) {
+      kind = classify(pb_message, pipe.from_client);
+    }
+    record_arrival(kind, data->size(), arrival);
+
+    // Messages queue behind each other on the link, then incur its latency
+    auto transmission = std::chrono::duration<double>(0);
+    if (m_link.bandwidth_mbit > 0) {
+      transmission = std::chrono::duration<double>(
+          static_cast<double>(data->size()) * 8 /
+          (m_link.bandwidth_mbit * 1e6));
+    }
+    auto latency = std::chrono::duration<double, std::milli>(m_link.latency_ms);
+    {
+      std::lock_guard<std::mutex> guard(pipe.mutex);
+      pipe.link_free =
+          std::max(pipe.link_free, arrival) +
+          std::chrono::duration_cast<Clock::duration>(transmission);
+      Clock::time_point deliver_at =
+          pipe.link_free + std::chrono::duration_cast<Clock::duration>(latency);
+      pipe.queue.push_back(Message{data, kind, deliver_at});
+    }
+    pipe.cond.notify_all();
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(pipe.mutex);
+    pipe.closed = true;
+  }
+  pipe.cond.notify_all();
+}
+
+void NetworkEmulator::write_messages(Pipe& pipe) {
+  std::unique_lock<std::mutex> lock(pipe.mutex);
+  while (true) {
+    pipe.cond.wait(lock,
+                   [&pipe]() { return pipe.closed || !pipe.queue.empty(); });
+    if (pipe.queue.empty()) {
+      break;
+    }
+    Message message = std::move(pipe.queue.front());
+    pipe.queue.pop_front();
+    lock.unlock();
+
+    std::this_thread::sleep_until(message.deliver_at);
+    boost::system::error_code ec;
+    boost::asio::write(*pipe.to, boost::asio::buffer(*message.data), ec);
+    if (ec) {
+      return;
+    }
+    record_delivery(message.kind, Clock::now());
+    lock.lock();
+  }
+
+  // Forward the end of the stream
+  boost::system::error_code ec;
+  pipe.to->shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+}
+
+MessageKind NetworkEmulator::classify(const pb::TCPMessage& message,
+                                      bool from_client) {
+  if (message.has_encryption_parameters() || message.has_public_key() ||
+      message.has_eval_key()) {
+    return MessageKind::KeySetup;
+  }
+  if (message.has_op_request()) {
+    return from_client ? MessageKind::NonlinearResponse
+                       : MessageKind::NonlinearRequest;
+  }
+  if (message.he_tensors_size() > 0 && !message.has_function()) {
+    return from_client ? MessageKind::Upload : MessageKind::Download;
+  }
+  if (!message.has_function()) {
+    return MessageKind::Other;
+  }
+  auto js = nlohmann::json::parse(message.function().function(), nullptr,
+                                  false);
+  if (js.is_discarded() || !js.contains("function")) {
+    return MessageKind::Other;
+  }
+  std::string name = js.at("function");
+  if (name == "Keys") {
+    return MessageKind::KeySetup;
+  }
+  if (name == "Parameter") {
+    return MessageKind::InferenceShape;
+  }
+  return from_client ? MessageKind::NonlinearResponse
+                     : MessageKind::NonlinearRequest;
+}
+
+void NetworkEmulator::record_arrival(MessageKind kind, size_t num_bytes,
+                                     Clock::time_point time) {
+  std::lock_guard<std::mutex> guard(m_stats_mutex);
+  KindStats& stats = m_stats[kind];
+  if (stats.num_messages == 0) {
+    stats.first_arrival = time;
+  }
+  stats.num_messages++;
+  stats.num_bytes += num_bytes;
+  if (kind == MessageKind::NonlinearRequest) {
+    if (m_outstanding_nonlinear == 0) {
+      m_nonlinear_start = time;
+    }
+    m_outstanding_nonlinear++;
+  }
+}
+
+void NetworkEmulator::record_delivery(MessageKind kind,
+                                      Clock::time_point time) {
+  std::lock_guard<std::mutex> guard(m_stats_mutex);
+  m_stats[kind].last_delivery = time;
+  if (kind == MessageKind::NonlinearResponse && m_outstanding_nonlinear > 0) {
+    m_outstanding_nonlinear--;
+    if (m_outstanding_nonlinear == 0) {
+      m_nonlinear_busy += time - m_nonlinear_start;
+    }
+  }
+}
+
+NetworkEmulator::KindStats NetworkEmulator::stats(MessageKind kind) const {
+  std::lock_guard<std::mutex> guard(m_stats_mutex);
+  auto it = m_stats.find(kind);
+  return it == m_stats.end() ? KindStats{} : it->second;
+}
+
+double NetworkEmulator::nonlinear_busy_ms() const {
+  std::lock_guard<std::mutex> guard(m_stats_mutex);
+  return std::chrono::duration<double, std::milli>(m_nonlinear_busy).count();
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,155 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "protos/message.pb.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Properties of the emulated link, applied to each direction
+struct NetworkLink {
+  /// \brief One-way latency in milliseconds
+  double latency_ms{0};
+  /// \brief Bandwidth in megabits per second, or 0 for unlimited bandwidth
+  double bandwidth_mbit{0};
+};
+
+/// \brief Protocol phase a message between client and server belongs to
+enum class MessageKind {
+  KeySetup,           // Encryption parameters and client keys
+  InferenceShape,     // Server request for the client inputs
+  Upload,             // Client inputs
+  NonlinearRequest,   // Server request to compute an activation
+  NonlinearResponse,  // Client result of an activation
+  Download,           // Inference result
+  Other
+};
+
+/// \brief Forwards a single client connection to the server through an
+/// emulated link. Each message is read in full, then delivered after its
+/// transmission time at the link bandwidth plus the link latency, so
+/// messages sent back to back queue behind each other. The protobuf body of
+/// each message is parsed to attribute its traffic to a protocol phase
+class NetworkEmulator {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// \brief Traffic of one message kind
+  struct KindStats {
+    size_t num_messages{0};
+    size_t num_bytes{0};
+    /// \brief Time the first message of this kind was read in full
+    Clock::time_point first_arrival{};
+    /// \brief Time the last message of this kind was delivered
+    Clock::time_point last_delivery{};
+  };
+
+  /// \brief Listens for the client and starts forwarding once it connects
+  /// \param[in] listen_port Port the client connects to
+  /// \param[in] server_port Port of the server on localhost. The server
+  /// need not listen yet; connecting is retried until it does
+  /// \param[in] link Emulated link
+  NetworkEmulator(size_t listen_port, size_t server_port, NetworkLink link);
+
+  /// \brief Stops forwarding and closes both connections
+  ~NetworkEmulator();
+
+  NetworkEmulator(const NetworkEmulator&) = delete;
+  NetworkEmulator& operator=(const NetworkEmulator&) = delete;
+
+  /// \brief Returns the traffic of a message kind so far
+  KindStats stats(MessageKind kind) const;
+
+  /// \brief Returns the total time during which at least one activation
+  /// request was awaiting its response, in milliseconds
+  double nonlinear_busy_ms() const;
+
+ private:
+  struct Message {
+    std::shared_ptr<std::vector<char>> data;
+    MessageKind kind{MessageKind::Other};
+    Clock::time_point deliver_at{};
+  };
+
+  /// \brief One direction of the connection
+  struct Pipe {
+    boost::asio::ip::tcp::socket* from{nullptr};
+    boost::asio::ip::tcp::socket* to{nullptr};
+    bool from_client{false};
+    Clock::time_point link_free{};
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Message> queue;
+    bool closed{false};
+    std::thread reader;
+    std::thread writer;
+  };
+
+  /// \brief Accepts the client, connects to the server and starts the pipes
+  void run(size_t server_port);
+
+  /// \brief Reads messages and queues them for delivery
+  void read_messages(Pipe& pipe);
+
+  /// \brief Writes queued messages once their delivery time is reached
+  void write_messages(Pipe& pipe);
+
+  /// \brief Returns the phase of a message
+  /// \param[in] message Parsed body of the message
+  /// \param[in] from_client Whether or not the client sent the message
+  static MessageKind classify(const pb::TCPMessage& message,
+                              bool from_client);
+
+  /// \brief Records a message which was read in full
+  void record_arrival(MessageKind kind, size_t num_bytes,
+                      Clock::time_point time);
+
+  /// \brief Records a message which was delivered
+  void record_delivery(MessageKind kind, Clock::time_point time);
+
+  NetworkLink m_link;
+  std::atomic<bool> m_stop{false};
+
+  boost::asio::io_context m_io_context;
+  boost::asio::ip::tcp::acceptor m_acceptor;
+  boost::asio::ip::tcp::socket m_client_socket;
+  boost::asio::ip::tcp::socket m_server_socket;
+
+  Pipe m_upstream;
+  Pipe m_downstream;
+  std::thread m_thread;
+
+  mutable std::mutex m_stats_mutex;
+  std::map<MessageKind, KindStats> m_stats;
+  size_t m_outstanding_nonlinear{0};
+  Clock::time_point m_nonlinear_start{};
+  Clock::duration m_nonlinear_busy{0};
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,61 @@
+# ******************************************************************************
+# Copyright 2018-2020 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ******************************************************************************
+
+# Enable ExternalProject CMake module
+include(ExternalProject)
+
+# ------------------------------------------------------------------------------
+# Download and install Google Benchmark ...
+# ------------------------------------------------------------------------------
+
+set(BENCHMARK_GIT_REPO_URL https://github.com/google/benchmark.git)
+set(BENCHMARK_GIT_LABEL v1.5.2)
+set(BENCHMARK_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fPIC")
+
+ExternalProject_Add(
+  ext_benchmark
+  PREFIX benchmark
+  GIT_REPOSITORY ${BENCHMARK_GIT_REPO_URL}
+  GIT_TAG ${BENCHMARK_GIT_LABEL}
+  INSTALL_COMMAND ""
+  UPDATE_COMMAND ""
+  CMAKE_ARGS
+        ${NGRAPH_HE_FORWARD_CMAKE_ARGS}
+        -DCMAKE_CXX_FLAGS=${BENCHMARK_CXX_FLAGS}
+        -DCMAKE_BUILD_TYPE=Release
+        -DBENCHMARK_ENABLE_TESTING=OFF
+        -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+  TMP_DIR "${EXTERNAL_PROJECTS_ROOT}/benchmark/tmp"
+  STAMP_DIR "${EXTERNAL_PROJECTS_ROOT}/benchmark/stamp"
+  DOWNLOAD_DIR "${EXTERNAL_PROJECTS_ROOT}/benchmark/download"
+  SOURCE_DIR "${EXTERNAL_PROJECTS_ROOT}/benchmark/src"
+  BINARY_DIR "${EXTERNAL_PROJECTS_ROOT}/benchmark/build"
+  INSTALL_DIR "${EXTERNAL_PROJECTS_ROOT}/benchmark"
+  BUILD_BYPRODUCTS
+    "${EXTERNAL_PROJECTS_ROOT}/benchmark/build/src/libbenchmark.a"
+  EXCLUDE_FROM_ALL TRUE)
+
+# ------------------------------------------------------------------------------
+
+ExternalProject_Get_Property(ext_benchmark SOURCE_DIR BINARY_DIR)
+
+add_library(libbenchmark INTERFACE)
+add_dependencies(libbenchmark ext_benchmark)
+
+target_include_directories(libbenchmark SYSTEM
+                           INTERFACE ${SOURCE_DIR}/include)
+target_link_libraries(libbenchmark
+                      INTERFACE ${BINARY_DIR}/src/libbenchmark.a pthread)
@@ -89,7 +89,7 @@ ExternalProject_Add(
                     -DSEAL_USE_CXX17=ON
                     -DCMAKE_INSTALL_LIBDIR=${EXTERNAL_INSTALL_LIB_DIR}
                     -DCMAKE_INSTALL_INCLUDEDIR=${EXTERNAL_INSTALL_INCLUDE_DIR}
-                    -DSEAL_USE_INTEL_HEXL=ON
+                    -DSEAL_USE_INTEL_HEXL=${NGRAPH_HE_HEXL_ENABLE}
   PATCH_COMMAND git apply ${SEAL_PATCH}
   # Skip updates
   UPDATE_COMMAND ""
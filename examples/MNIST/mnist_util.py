@@ -151,7 +151,8 @@ def client_argument_parser():
         "--encrypt_data_str",
         type=str,
         default="encrypt",
-        help='"encrypt" to encrypt client data, "plain" to not encrypt',
+        help='"encrypt" to encrypt client data, "encrypt_seeded" to encrypt '
+        'client data with smaller secret-key ciphertexts, "plain" to not encrypt',
     )
     parser.add_argument(
         "--tensor_name",
@@ -160,6 +161,11 @@ def client_argument_parser():
         help="Input tensor name")
     parser.add_argument(
         "--start_batch", type=int, default=0, help="Test data start index")
+    parser.add_argument(
+        "--print_stats",
+        type=str2bool,
+        default=False,
+        help="Print the client's traffic and timing statistics")
 
     return parser
 
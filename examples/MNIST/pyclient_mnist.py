@@ -16,6 +16,7 @@
 
 import time
 import argparse
+import json
 import numpy as np
 import sys
 import os
@@ -50,6 +51,9 @@ def test_network(FLAGS):
     print("correct", correct)
     print("Accuracy (batch size", FLAGS.batch_size, ") =", acc * 100.0, "%")
 
+    if FLAGS.print_stats:
+        print("Client stats", json.dumps(client.get_stats()))
+
 
 if __name__ == "__main__":
     FLAGS, unparsed = client_argument_parser().parse_known_args()
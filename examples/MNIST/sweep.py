@@ -0,0 +1,273 @@
+# ==============================================================================
+#  Copyright 2018-2020 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+"""An MNIST classifier using convolutional layers and relu activations. """
+"""Sweeps encryption parameters, packing and activation modes of a model.
+
+Runs test.py, and pyclient_mnist.py for client-server activation modes, once
+per candidate setting on a validation subset. Reports accuracy, latency,
+bytes sent between client and server, and peak memory of each run, and the
+Pareto-optimal settings, i.e. those no other setting matches or beats in every
+metric.
+"""
+
+import argparse
+import glob
+import itertools
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+from mnist_util import str2bool
+
+# Server flags of each activation mode
+ACTIVATION_MODES = {
+    "local": ["--enable_client=false", "--encrypt_server_data=true"],
+    "client": ["--enable_client=true"],
+    "gc": [
+        "--enable_client=true", "--enable_gc=true", "--mask_gc_inputs=true",
+        "--mask_gc_outputs=true"
+    ],
+}
+
+# Metrics to minimize when comparing runs; accuracy is maximized
+COST_METRICS = ["latency_s", "bytes", "peak_memory_mb"]
+
+
+def sweep_argument_parser():
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--model_file",
+        type=str,
+        required=True,
+        help="Filename of saved protobuf model")
+    parser.add_argument(
+        "--configs",
+        type=str,
+        nargs="+",
+        default=None,
+        help="Encryption parameter files to sweep. Defaults to every "
+        "parameter set in configs/, except debug parameters",
+    )
+    parser.add_argument(
+        "--pack_data",
+        type=str2bool,
+        nargs="+",
+        default=[True, False],
+        help="Packing modes to sweep")
+    parser.add_argument(
+        "--activation_modes",
+        type=str,
+        nargs="+",
+        default=["local", "client"],
+        choices=sorted(ACTIVATION_MODES),
+        help="Activation modes to sweep. local computes activations on the "
+        "server for debugging, client sends them to the client, gc uses "
+        "garbled circuits",
+    )
+    parser.add_argument(
+        "--batch_size", type=int, default=100, help="Validation subset size")
+    parser.add_argument(
+        "--start_batch", type=int, default=0, help="Validation start index")
+    parser.add_argument(
+        "--port", type=int, default=35000, help="First server port to use")
+    parser.add_argument(
+        "--timeout_s",
+        type=float,
+        default=3600,
+        help="Seconds after which a run is aborted")
+    parser.add_argument(
+        "--output_file",
+        type=str,
+        default="sweep_results.json",
+        help="File to write the results of every run to")
+    return parser
+
+
+def default_configs():
+    config_dir = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "..", "..", "configs")
+    configs = glob.glob(os.path.join(config_dir, "he_seal_ckks_config_*.json"))
+    return sorted(c for c in configs if "_debug" not in c)
+
+
+def start_process(args, log_file):
+    return subprocess.Popen(
+        [sys.executable] + args,
+        stdout=log_file,
+        stderr=subprocess.STDOUT,
+        cwd=os.path.dirname(os.path.abspath(__file__)))
+
+
+def peak_memory_mb(pid):
+    """Returns the peak RSS in MB of a running process, or 0 if unknown"""
+    try:
+        with open("/proc/{}/status".format(pid)) as status:
+            for line in status:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1]) / 1024.0
+    except (IOError, ValueError):
+        pass
+    return 0
+
+
+def wait_processes(processes, timeout_s):
+    """Waits for processes to exit, killing them after timeout_s. Returns
+    whether every process succeeded, and their summed peak RSS in MB"""
+    peaks = [0.0] * len(processes)
+    deadline = time.time() + timeout_s
+    while any(p.poll() is None for p in processes):
+        if time.time() > deadline:
+            for p in processes:
+                p.kill()
+            break
+        # The peak RSS is only readable until the process is reaped
+        for idx, p in enumerate(processes):
+            peaks[idx] = max(peaks[idx], peak_memory_mb(p.pid))
+        time.sleep(0.1)
+    succeeded = all(p.wait() == 0 for p in processes)
+    return succeeded, sum(peaks)
+
+
+def parse_float(pattern, text):
+    match = re.search(pattern, text)
+    return float(match.group(1)) if match else None
+
+
+def run_setting(FLAGS, config, pack_data, activation_mode, port):
+    server_args = [
+        "test.py",
+        "--backend=HE_SEAL",
+        "--model_file=" + FLAGS.model_file,
+        "--encryption_parameters=" + config,
+        "--pack_data=" + str(pack_data),
+        "--batch_size=" + str(FLAGS.batch_size),
+        "--start_batch=" + str(FLAGS.start_batch),
+        "--port=" + str(port),
+    ] + ACTIVATION_MODES[activation_mode]
+    with_client = activation_mode != "local"
+    client_args = [
+        "pyclient_mnist.py",
+        "--batch_size=" + str(FLAGS.batch_size),
+        "--start_batch=" + str(FLAGS.start_batch),
+        "--port=" + str(port),
+        "--encrypt_data_str=encrypt",
+        "--print_stats=true",
+    ]
+
+    with tempfile.TemporaryFile("w+") as server_log, \
+            tempfile.TemporaryFile("w+") as client_log:
+        processes = [start_process(server_args, server_log)]
+        if with_client:
+            processes.append(start_process(client_args, client_log))
+        succeeded, memory_mb = wait_processes(processes, FLAGS.timeout_s)
+        server_log.seek(0)
+        client_log.seek(0)
+        server_output = server_log.read()
+        client_output = client_log.read()
+
+    result = {
+        "config": os.path.basename(config),
+        "pack_data": pack_data,
+        "activation_mode": activation_mode,
+        "ok": succeeded,
+        "latency_s": parse_float(r"total time\(s\) ([0-9.eE+-]+)",
+                                 server_output),
+        "peak_memory_mb": memory_mb,
+        "bytes": 0,
+    }
+    if with_client:
+        accuracy = parse_float(r"Accuracy \(batch size \d+ \) = ([0-9.]+) %",
+                               client_output)
+        result["accuracy"] = None if accuracy is None else accuracy / 100.0
+        stats = re.search(r"Client stats (\{.*\})", client_output)
+        if stats:
+            stats = json.loads(stats.group(1))
+            result["bytes"] = stats["bytes_sent"] + stats["bytes_received"]
+    else:
+        result["accuracy"] = parse_float(r"Accuracy: ([0-9.eE+-]+)",
+                                         server_output)
+    if result["latency_s"] is None or result["accuracy"] is None:
+        result["ok"] = False
+    if not result["ok"]:
+        result["log"] = (server_output + client_output)[-4000:]
+    return result
+
+
+def dominates(a, b):
+    """Returns whether run a is at least as good as run b in every metric,
+    and better in one"""
+    no_worse = a["accuracy"] >= b["accuracy"] and all(
+        a[m] <= b[m] for m in COST_METRICS)
+    better = a["accuracy"] > b["accuracy"] or any(
+        a[m] < b[m] for m in COST_METRICS)
+    return no_worse and better
+
+
+def pareto_front(results):
+    ok_results = [r for r in results if r["ok"]]
+    return [
+        r for r in ok_results
+        if not any(dominates(other, r) for other in ok_results)
+    ]
+
+
+def print_results(title, results):
+    print(title)
+    print("{:<40} {:<6} {:<8} {:>9} {:>10} {:>14} {:>10}".format(
+        "config", "packed", "mode", "accuracy", "latency(s)", "bytes",
+        "memory(MB)"))
+    for r in sorted(results, key=lambda r: r["latency_s"]):
+        print("{:<40} {:<6} {:<8} {:>9.4f} {:>10.3f} {:>14} {:>10.1f}".format(
+            r["config"], str(r["pack_data"]), r["activation_mode"],
+            r["accuracy"], r["latency_s"], r["bytes"], r["peak_memory_mb"]))
+
+
+def main(FLAGS):
+    configs = FLAGS.configs if FLAGS.configs else default_configs()
+    results = []
+    settings = itertools.product(configs, FLAGS.pack_data,
+                                 FLAGS.activation_modes)
+    for run_idx, (config, pack_data, mode) in enumerate(settings):
+        # Uses a new port per run, since the previous port may still be in
+        # the TIME_WAIT state
+        result = run_setting(FLAGS, config, pack_data, mode,
+                             FLAGS.port + run_idx)
+        print(
+            "config", result["config"], "pack_data", pack_data, "mode", mode,
+            "ok" if result["ok"] else "failed")
+        results.append(result)
+
+    with open(FLAGS.output_file, "w") as output_file:
+        json.dump(results, output_file, indent=2)
+
+    front = pareto_front(results)
+    print_results("All successful runs", [r for r in results if r["ok"]])
+    print_results("Pareto-optimal settings", front)
+    with open(os.path.splitext(FLAGS.output_file)[0] + "_pareto.json",
+              "w") as pareto_file:
+        json.dump(front, pareto_file, indent=2)
+
+
+if __name__ == "__main__":
+    FLAGS, unparsed = sweep_argument_parser().parse_known_args()
+    if unparsed:
+        print("Unparsed flags:", unparsed)
+        exit(1)
+    main(FLAGS)
@@ -0,0 +1,63 @@
+# ==============================================================================
+#  Copyright 2018-2020 Intel Corporation
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+# ==============================================================================
+
+import pyhe_client
+import argparse
+import asyncio
+import numpy as np
+
+
+async def infer(FLAGS, session):
+    data = np.array((2, 4, 6, 8), dtype=np.float32) + session
+    batch_size = 1
+
+    # Each session runs on its own thread without holding the GIL
+    future = pyhe_client.HESealClient.run_async(
+        FLAGS.hostname, FLAGS.port, batch_size,
+        {"client_parameter_name": ("encrypt", data)})
+    results = await asyncio.wrap_future(future)
+    print("session", session, "results", results)
+
+
+async def main(FLAGS):
+    await asyncio.gather(
+        *(infer(FLAGS, session) for session in range(FLAGS.num_sessions)))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--hostname",
+        type=str,
+        default="localhost",
+        help="Hostname of server")
+    parser.add_argument(
+        "--port",
+        type=int,
+        default=34000,
+        help="Port number of server",
+    )
+    parser.add_argument(
+        "--num_sessions",
+        type=int,
+        default=1,
+        help="Number of concurrent inference sessions",
+    )
+
+    FLAGS, unparsed = parser.parse_known_args()
+
+    print(FLAGS)
+    asyncio.run(main(FLAGS))
@@ -16,31 +16,208 @@
 
 #include "pyhe_client/he_seal_client.hpp"
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "seal/he_seal_client.hpp"
 
 namespace py = pybind11;
 
+namespace {
+
+/// \brief Views client inputs given as {name: (config, data)}. NumPy arrays
+/// of float32, float64 or int64 are viewed in place, including numpy.memmap
+/// arrays of files, which are encrypted from the mapping; other data is
+/// converted to a float64 array first
+/// \param[in] inputs Client inputs
+/// \param[out] arrays Arrays backing the views, which must outlive them
+ngraph::runtime::he::HEInputViewMap input_views(
+    const py::dict& inputs, std::vector<py::array>& arrays) {
+  ngraph::runtime::he::HEInputViewMap views;
+  for (const auto& [name, value] : inputs) {
+    auto [config, data] = value.cast<std::pair<std::string, py::object>>();
+
+    ngraph::runtime::he::HEInputView view{config};
+    py::array array;
+    if (py::isinstance<py::array_t<float, py::array::c_style>>(data)) {
+      view.element_type = ngraph::element::f32;
+      array = py::reinterpret_borrow<py::array>(data);
+    } else if (py::isinstance<py::array_t<int64_t, py::array::c_style>>(
+                   data)) {
+      view.element_type = ngraph::element::i64;
+      array = py::reinterpret_borrow<py::array>(data);
+    } else {
+      view.element_type = ngraph::element::f64;
+      array = py::array_t<double, py::array::c_style |
+                                      py::array::forcecast>::ensure(data);
+    }
+    if (!array) {
+      throw py::error_already_set();
+    }
+    view.data = array.data();
+    view.num_elements = static_cast<size_t>(array.size());
+    views[name.cast<std::string>()] = view;
+    arrays.emplace_back(std::move(array));
+  }
+  return views;
+}
+
+/// \brief Returns a float64 NumPy array viewing the results of a client
+/// \param[in] results Results of the client
+/// \param[in] base Object keeping the client alive while the array is
+py::array_t<double> results_array(const std::vector<double>& results,
+                                  py::handle base) {
+  return py::array_t<double>({results.size()}, {sizeof(double)},
+                             results.data(), base);
+}
+
+/// \brief Runs a client on its own thread
+/// \returns A concurrent.futures.Future of the results, which asyncio code
+/// awaits with asyncio.wrap_future
+py::object run_async(const std::string& hostname, const std::size_t port,
+                     const std::size_t batch_size, const py::dict& inputs) {
+  using ngraph::runtime::he::HESealClient;
+
+  // Python objects used by the client thread, which are only released
+  // while it holds the GIL
+  struct Session {
+    py::object future;
+    std::vector<py::array> arrays;
+    ngraph::runtime::he::HEInputViewMap views;
+  };
+  auto session = std::make_unique<Session>();
+  session->views = input_views(inputs, session->arrays);
+  session->future = py::module::import("concurrent.futures").attr("Future")();
+  session->future.attr("set_running_or_notify_cancel")();
+  py::object future = session->future;
+
+  std::thread([hostname, port, batch_size,
+               session = std::move(session)]() mutable {
+    std::shared_ptr<HESealClient> client;
+    std::string error;
+    try {
+      client = std::make_shared<HESealClient>(hostname, port, batch_size,
+                                              session->views);
+      client->get_results_ref();
+    } catch (const std::exception& e) {
+      error = e.what();
+    }
+
+    py::gil_scoped_acquire acquire;
+    try {
+      if (client != nullptr) {
+        py::capsule owner(new std::shared_ptr<HESealClient>(client),
+                          [](void* ptr) {
+                            delete static_cast<std::shared_ptr<HESealClient>*>(
+                                ptr);
+                          });
+        session->future.attr("set_result")(
+            results_array(client->get_results_ref(), owner));
+      } else {
+        session->future.attr("set_exception")(
+            py::module::import("builtins").attr("RuntimeError")(error));
+      }
+    } catch (py::error_already_set& e) {
+      e.discard_as_unraisable(__func__);
+    }
+    session.reset();
+  }).detach();
+
+  return future;
+}
+
+/// \brief Returns the client's stats as {"phases": {name: {"seconds": s,
+/// "calls": n}}, "bytes_sent": n, "bytes_received": n, "messages_sent": n,
+/// "messages_received": n}
+/// \param[in] client Client whose stats to return
+py::dict stats_dict(const ngraph::runtime::he::HESealClient& client) {
+  const auto& stats = client.stats();
+  py::dict phases;
+  for (const auto& [name, phase] : stats.phases()) {
+    py::dict phase_dict;
+    phase_dict["seconds"] = phase.seconds;
+    phase_dict["calls"] = phase.calls;
+    phases[py::str(name)] = phase_dict;
+  }
+  py::dict result;
+  result["phases"] = phases;
+  result["bytes_sent"] = stats.bytes_sent();
+  result["bytes_received"] = stats.bytes_received();
+  result["messages_sent"] = stats.messages_sent();
+  result["messages_received"] = stats.messages_received();
+  return result;
+}
+
+}  // namespace
+
 void regclass_pyhe_client(py::module m) {
   py::class_<ngraph::runtime::he::HESealClient> he_seal_client(m,
                                                                "HESealClient");
   he_seal_client.doc() = "he_seal_client wraps ngraph::he::HESealClient";
 
+  // Inputs are given as {name: (config, data)}, see input_views. The
+  // constructor runs the inference with the GIL released
   he_seal_client.def(
-      py::init<const std::string&, const std::size_t, const std::size_t,
-               const ngraph::runtime::he::HETensorConfigMap<float>&>());
+      py::init([](const std::string& hostname, const std::size_t port,
+                  const std::size_t batch_size, const py::dict& inputs) {
+        std::vector<py::array> arrays;
+        auto views = input_views(inputs, arrays);
+
+        py::gil_scoped_release release;
+        return std::make_unique<ngraph::runtime::he::HESealClient>(
+            hostname, port, batch_size, views);
+      }),
+      py::arg("hostname"), py::arg("port"), py::arg("batch_size"),
+      py::arg("inputs"));
+
+  // Runs the inference on a background thread, without holding the GIL,
+  // and returns a concurrent.futures.Future of the results. Many sessions
+  // may run at once, e.g.
+  //   results = await asyncio.wrap_future(HESealClient.run_async(...))
+  he_seal_client.def_static("run_async", &run_async, py::arg("hostname"),
+                            py::arg("port"), py::arg("batch_size"),
+                            py::arg("inputs"));
 
   he_seal_client.def("set_seal_context",
                      &ngraph::runtime::he::HESealClient::set_seal_context);
   he_seal_client.def("is_done", &ngraph::runtime::he::HESealClient::is_done);
-  he_seal_client.def("get_results",
-                     &ngraph::runtime::he::HESealClient::get_results);
+  // Returns the results as a float64 NumPy array viewing the client's
+  // buffer, which keeps the client alive
+  he_seal_client.def("get_results", [](py::object self) {
+    auto& client = self.cast<ngraph::runtime::he::HESealClient&>();
+    const std::vector<double>* results = nullptr;
+    {
+      py::gil_scoped_release release;
+      results = &client.get_results_ref();
+    }
+    return results_array(*results, self);
+  });
+  // Runs another inference over a persistent session, i.e. with
+  // NGRAPH_HE_CLIENT_PERSISTENT=1, and returns a copy of its results, since
+  // later inferences reuse the client's buffer
+  he_seal_client.def(
+      "infer",
+      [](ngraph::runtime::he::HESealClient& client, const py::dict& inputs) {
+        std::vector<py::array> arrays;
+        auto views = input_views(inputs, arrays);
+        std::vector<double> results;
+        {
+          py::gil_scoped_release release;
+          results = client.infer(views);
+        }
+        return py::array_t<double>(results.size(), results.data());
+      },
+      py::arg("inputs"));
+  he_seal_client.def("get_stats", &stats_dict);
   he_seal_client.def("close_connection",
-                     &ngraph::runtime::he::HESealClient::close_connection);
+                     &ngraph::runtime::he::HESealClient::close_connection,
+                     py::call_guard<py::gil_scoped_release>());
 }
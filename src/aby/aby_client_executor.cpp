@@ -19,7 +19,10 @@
 #include <chrono>
 #include <vector>
 
+#include "aby/kernel/dot_relu_aby.hpp"
+#include "aby/kernel/max_pool_aby.hpp"
 #include "aby/kernel/relu_aby.hpp"
+#include "he_util.hpp"
 #include "nlohmann/json.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal_util.hpp"
@@ -37,10 +40,9 @@ ABYClientExecutor::ABYClientExecutor(
                   bit_length, num_threads, num_parties, mg_algo_str,
                   reserve_num_gates),
       m_he_seal_client(he_seal_client) {
-  m_lowest_coeff_modulus = m_he_seal_client.encryption_paramters()
+  set_lowest_coeff_modulus(m_he_seal_client.encryption_paramters()
                                .seal_encryption_parameters()
-                               .coeff_modulus()[0]
-                               .value();
+                               .coeff_modulus()[0]);
 
   NGRAPH_HE_LOG(1) << "Started ABYClientExecutor";
 }
@@ -48,6 +50,7 @@ ABYClientExecutor::ABYClientExecutor(
 void ABYClientExecutor::run_aby_circuit(const std::string& function,
                                         std::shared_ptr<he::HETensor>& tensor) {
   NGRAPH_HE_LOG(3) << "client run_aby_circuit with function " << function;
+  wait_for_offline_phase();
   json js = json::parse(function);
   auto name = js.at("function");
 
@@ -59,32 +62,28 @@ void ABYClientExecutor::run_aby_circuit(const std::string& function,
   }
 }
 
-void ABYClientExecutor::run_aby_relu_circuit(
-    const std::string& function, std::shared_ptr<he::HETensor>& tensor) {
-  NGRAPH_HE_LOG(3) << "run_aby_relu_circuit";
-  auto name = json::parse(function).at("function");
-  NGRAPH_CHECK(name == "Relu", "Function name ", name, " is not Relu");
-
-  auto& tensor_data = tensor->data();
+std::vector<uint64_t> ABYClientExecutor::client_gc_values(
+    he::HETensor& tensor) const {
+  auto& tensor_data = tensor.data();
   size_t batch_size = tensor_data[0].batch_size();
 
   auto tensor_size = static_cast<uint64_t>(tensor_data.size() * batch_size);
   NGRAPH_HE_LOG(3) << "Batch size " << batch_size;
   NGRAPH_HE_LOG(3) << "tensor_data.size() " << tensor_data.size();
   NGRAPH_HE_LOG(3) << "tensor_size " << tensor_size;
-  NGRAPH_HE_LOG(3) << "tensor_type " << tensor->get_element_type();
+  NGRAPH_HE_LOG(3) << "tensor_type " << tensor.get_element_type();
 
   std::vector<double> relu_vals(tensor_size);
-  size_t num_bytes = tensor_size * tensor->get_element_type().size();
+  size_t num_bytes = tensor_size * tensor.get_element_type().size();
 
-  if (tensor->get_element_type() == element::f32) {
+  if (tensor.get_element_type() == element::f32) {
     std::vector<float> relu_float_vals(tensor_size);
-    tensor->read(relu_float_vals.data(), num_bytes);
+    tensor.read(relu_float_vals.data(), num_bytes);
     relu_vals =
         std::vector<double>{relu_float_vals.begin(), relu_float_vals.end()};
 
-  } else if (tensor->get_element_type() == element::f64) {
-    tensor->read(relu_vals.data(), num_bytes);
+  } else if (tensor.get_element_type() == element::f64) {
+    tensor.read(relu_vals.data(), num_bytes);
   } else {
     throw ngraph_error("Invalid element type");
   }
@@ -111,15 +110,46 @@ void ABYClientExecutor::run_aby_relu_circuit(
     }
     client_gc_vals[i] = relu_int_val;
   }
+  return client_gc_vals;
+}
+
+void ABYClientExecutor::write_gc_results(
+    he::HETensor& tensor, const std::vector<double>& values) const {
+  size_t num_bytes = values.size() * tensor.get_element_type().size();
+  if (tensor.get_element_type() == element::f32) {
+    std::vector<float> float_values{values.begin(), values.end()};
+    tensor.write(float_values.data(), num_bytes);
+  } else if (tensor.get_element_type() == element::f64) {
+    tensor.write(values.data(), num_bytes);
+  } else {
+    throw ngraph_error("Invalid element type");
+  }
+}
+
+void ABYClientExecutor::run_aby_relu_circuit(
+    const std::string& function, std::shared_ptr<he::HETensor>& tensor) {
+  NGRAPH_HE_LOG(3) << "run_aby_relu_circuit";
+  json js = json::parse(function);
+  auto name = js.at("function");
+  NGRAPH_CHECK(name == "Relu", "Function name ", name, " is not Relu");
+  // With truncation, the circuit output is at the client's encoding scale
+  size_t truncate_bits =
+      js.find("truncate_bits") != js.end()
+          ? he::flag_to_int(std::string(js.at("truncate_bits")))
+          : 0;
+
+  std::vector<uint64_t> client_gc_vals = client_gc_values(*tensor);
+  size_t tensor_size = client_gc_vals.size();
 
   NGRAPH_HE_LOG(3) << "Client creating relu circuit";
 
-  auto party_data_start_end_idx = split_vector(tensor_size, m_num_parties);
+  auto party_data_start_end_idx = split_between_parties(tensor_size);
   double scale = m_he_seal_client.scale();
 
   std::vector<uint64_t> relu_result(tensor_size, 0);
   std::vector<double> relu_double_result(tensor_size, 0);
-#pragma omp parallel for num_threads(m_num_parties)
+  he::HEThreadBudget::Reservation party_threads(m_num_parties);
+#pragma omp parallel for num_threads(party_threads.num_threads())
   for (size_t party_idx = 0; party_idx < m_num_parties; ++party_idx) {
     const auto& [start_idx, end_idx] = party_data_start_end_idx[party_idx];
     size_t party_data_size = end_idx - start_idx;
@@ -138,13 +168,14 @@ void ABYClientExecutor::run_aby_relu_circuit(
 
     auto* relu_out =
         relu_aby(*circ, party_data_size, zeros, client_party_gc_vals, zeros,
-                 m_aby_bitlen, m_lowest_coeff_modulus);
+                 circuit_bitlen(), m_lowest_coeff_modulus, truncate_bits,
+                 circuit_variant());
 
     NGRAPH_HE_LOG(3) << "Client party " << party_idx
                      << " executing relu circuit with start idx " << start_idx;
 
     auto t1 = std::chrono::high_resolution_clock::now();
-    m_ABYParties[party_idx]->ExecCircuit();
+    exec_circuit(party_idx, "Relu");
     auto t2 = std::chrono::high_resolution_clock::now();
     NGRAPH_HE_LOG(3) << "Client executing circuit took "
                      << std::chrono::duration_cast<std::chrono::microseconds>(
@@ -172,15 +203,149 @@ void ABYClientExecutor::run_aby_relu_circuit(
     reset_party(party_idx);
   }
 
-  if (tensor->get_element_type() == element::f32) {
-    std::vector<float> relu_float_result{relu_double_result.begin(),
-                                         relu_double_result.end()};
-    tensor->write(relu_float_result.data(), num_bytes);
-  } else if (tensor->get_element_type() == element::f64) {
-    tensor->write(relu_double_result.data(), num_bytes);
-  } else {
-    throw ngraph_error("Invalid element type");
+  write_gc_results(*tensor, relu_double_result);
+}
+
+void ABYClientExecutor::run_aby_max_pool_circuit(
+    const std::string& function, const std::shared_ptr<he::HETensor>& tensor,
+    he::HETensor& output) {
+  NGRAPH_HE_LOG(3) << "run_aby_max_pool_circuit";
+  json js = json::parse(function);
+  auto name = js.at("function");
+  NGRAPH_CHECK(name == "MaxPool", "Function name ", name, " is not MaxPool");
+  size_t window_size = he::flag_to_int(std::string(js.at("window_size")));
+  size_t num_outputs = he::flag_to_int(std::string(js.at("num_outputs")));
+  bool relu = he::string_to_bool(std::string(js.at("relu")));
+
+  NGRAPH_CHECK(tensor->data().size() == window_size * num_outputs, "Got ",
+               tensor->data().size(), " ciphertexts, expected ",
+               window_size * num_outputs);
+  NGRAPH_CHECK(output.data().size() == num_outputs, "Output has ",
+               output.data().size(), " elements, expected ", num_outputs);
+
+  std::vector<uint64_t> client_gc_vals = client_gc_values(*tensor);
+  size_t num_aby_outputs = num_outputs * tensor->data()[0].batch_size();
+  auto party_output_start_end_idx = split_between_parties(num_aby_outputs);
+  double scale = m_he_seal_client.scale();
+
+  std::vector<double> max_result(num_aby_outputs, 0);
+  he::HEThreadBudget::Reservation party_threads(m_num_parties);
+#pragma omp parallel for num_threads(party_threads.num_threads())
+  for (size_t party_idx = 0; party_idx < m_num_parties; ++party_idx) {
+    const auto& [start_idx, end_idx] = party_output_start_end_idx[party_idx];
+    size_t party_output_size = end_idx - start_idx;
+    if (party_output_size == 0) {
+      continue;
+    }
+
+    std::vector<uint64_t> client_party_gc_vals(window_size *
+                                               party_output_size);
+    for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+      for (size_t idx = start_idx; idx < end_idx; ++idx) {
+        client_party_gc_vals[window_idx * party_output_size + idx -
+                             start_idx] =
+            client_gc_vals[max_pool_aby_input_index(window_idx, idx,
+                                                    num_outputs, window_size)];
+      }
+    }
+    std::vector<uint64_t> zeros(client_party_gc_vals.size(), 0);
+    std::vector<uint64_t> output_zeros(party_output_size, 0);
+
+    auto* max_out = max_pool_aby(*get_circuit(party_idx), party_output_size,
+                                 window_size, zeros, client_party_gc_vals,
+                                 output_zeros, circuit_bitlen(),
+                                 m_lowest_coeff_modulus, relu,
+                                 circuit_variant());
+    exec_circuit(party_idx, "MaxPool");
+
+    uint32_t out_bitlen;
+    uint32_t result_count;
+    uint64_t* out_vals;
+    max_out->get_clear_value_vec(&out_vals, &out_bitlen, &result_count);
+    NGRAPH_CHECK(result_count == party_output_size,
+                 "Wrong number of ABY result values, result_count=",
+                 result_count, ", expected ", party_output_size);
+    for (size_t result_idx = 0; result_idx < party_output_size;
+         ++result_idx) {
+      max_result[start_idx + result_idx] = uint64_to_double(
+          out_vals[result_idx], m_lowest_coeff_modulus, scale);
+    }
+    reset_party(party_idx);
   }
+
+  write_gc_results(output, max_result);
+}
+
+void ABYClientExecutor::run_aby_dot_relu_circuit(
+    const std::string& function, const std::shared_ptr<he::HETensor>& tensor,
+    he::HETensor& output) {
+  NGRAPH_HE_LOG(3) << "run_aby_dot_relu_circuit";
+  wait_for_offline_phase();
+  json js = json::parse(function);
+  auto name = js.at("function");
+  NGRAPH_CHECK(name == "DotRelu", "Function name ", name, " is not DotRelu");
+  size_t output_size = he::flag_to_int(std::string(js.at("output_size")));
+  size_t weight_bits = he::flag_to_int(std::string(js.at("weight_bits")));
+  size_t truncate_bits = he::flag_to_int(std::string(js.at("truncate_bits")));
+
+  size_t input_size = tensor->data().size();
+  size_t batch_size = tensor->data()[0].batch_size();
+  NGRAPH_CHECK(output.data().size() == output_size, "Output has ",
+               output.data().size(), " elements, expected ", output_size);
+
+  std::vector<uint64_t> client_gc_vals = client_gc_values(*tensor);
+  std::vector<uint64_t> xc(input_size * batch_size);
+  for (size_t batch_idx = 0; batch_idx < batch_size; ++batch_idx) {
+    for (size_t input_idx = 0; input_idx < input_size; ++input_idx) {
+      xc[input_idx * batch_size + batch_idx] =
+          client_gc_vals[batch_idx * input_size + input_idx];
+    }
+  }
+  std::vector<uint64_t> zeros(xc.size(), 0);
+
+  auto party_output_start_end_idx =
+      split_outputs_between_parties(output_size, batch_size);
+  double scale = m_he_seal_client.scale();
+
+  std::vector<double> dot_relu_result(output_size * batch_size, 0);
+  he::HEThreadBudget::Reservation party_threads(m_num_parties);
+#pragma omp parallel for num_threads(party_threads.num_threads())
+  for (size_t party_idx = 0; party_idx < m_num_parties; ++party_idx) {
+    const auto& [start_idx, end_idx] = party_output_start_end_idx[party_idx];
+    size_t party_output_size = end_idx - start_idx;
+    if (party_output_size == 0) {
+      continue;
+    }
+
+    std::vector<uint64_t> party_xc(xc);
+    std::vector<uint64_t> party_zeros(zeros);
+    std::vector<uint64_t> weight_zeros(input_size * party_output_size, 0);
+    std::vector<uint64_t> output_zeros(party_output_size * batch_size, 0);
+
+    auto outs = build_dot_relu_circuit(
+        party_idx, batch_size, input_size, party_output_size, party_zeros,
+        party_xc, weight_zeros, output_zeros, weight_bits, truncate_bits);
+    exec_circuit(party_idx, "DotRelu");
+
+    for (size_t out_idx = 0; out_idx < party_output_size; ++out_idx) {
+      uint32_t out_bitlen;
+      uint32_t result_count;
+      uint64_t* out_vals;
+      outs[out_idx]->get_clear_value_vec(&out_vals, &out_bitlen,
+                                         &result_count);
+      NGRAPH_CHECK(result_count == batch_size,
+                   "Wrong number of ABY result values, result_count=",
+                   result_count, ", expected ", batch_size);
+      for (size_t batch_idx = 0; batch_idx < batch_size; ++batch_idx) {
+        dot_relu_result[batch_idx * output_size + start_idx + out_idx] =
+            uint64_to_double(out_vals[batch_idx], m_lowest_coeff_modulus,
+                             scale);
+      }
+    }
+    reset_party(party_idx);
+  }
+
+  write_gc_results(output, dot_relu_result);
 }
 
 }  // namespace ngraph::runtime::aby
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "aby/aby_executor.hpp"
 #include "he_tensor.hpp"
@@ -42,7 +43,7 @@ class ABYClientExecutor : public ABYExecutor {
                     uint32_t bit_length = 64, uint32_t num_threads = 1,
                     uint32_t num_parties = 1,
                     std::string mg_algo_str = std::string("MT_OT"),
-                    uint32_t reserve_num_gates = 100);
+                    uint32_t reserve_num_gates = 65536);
 
   ~ABYClientExecutor() = default;
 
@@ -53,7 +54,40 @@ class ABYClientExecutor : public ABYExecutor {
   void run_aby_relu_circuit(const std::string& function,
                             std::shared_ptr<he::HETensor>& tensor);
 
+  // MaxPool circuits
+  /// \brief Runs the MaxPool circuit on masked ciphertexts
+  /// \param[in] function JSON description of the MaxPool, with the window
+  /// size, number of outputs and whether to apply ReLU
+  /// \param[in] tensor Masked ciphertexts, where ciphertext j of output i is
+  /// at index j * num_outputs + i
+  /// \param[out] output Encrypted, masked maximum of each window
+  void run_aby_max_pool_circuit(const std::string& function,
+                                const std::shared_ptr<he::HETensor>& tensor,
+                                he::HETensor& output);
+
+  // Hybrid Dot and Relu circuits
+  /// \brief Runs the Dot and Relu circuit on masked ciphertexts. The server
+  /// inputs the weights
+  /// \param[in] function JSON description of the layer, with the number of
+  /// outputs, the weight fractional bits and the truncation bits
+  /// \param[in] tensor Masked ciphertexts, one per input
+  /// \param[out] output Encrypted, masked ReLU of each output
+  void run_aby_dot_relu_circuit(const std::string& function,
+                                const std::shared_ptr<he::HETensor>& tensor,
+                                he::HETensor& output);
+
  private:
+  /// \brief Decrypts a tensor of masked values to the client's share of the
+  /// circuit inputs, in (0, q)
+  /// \param[in] tensor Tensor to decrypt
+  std::vector<uint64_t> client_gc_values(he::HETensor& tensor) const;
+
+  /// \brief Encrypts circuit outputs to a tensor
+  /// \param[out] tensor Tensor to write to
+  /// \param[in] values Values to write
+  void write_gc_results(he::HETensor& tensor,
+                        const std::vector<double>& values) const;
+
   const he::HESealClient& m_he_seal_client;
 };
 
@@ -0,0 +1,150 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace ngraph::runtime::aby {
+
+/// \brief Estimated costs, in microseconds, of a Dot whose output is the
+/// argument of a garbled circuit Relu. The Relu circuit is evaluated in both
+/// cases, so its cost is omitted
+struct DotReluCost {
+  /// \brief Cost of the Dot in HE, on ciphertexts
+  double he;
+  /// \brief Cost of the Dot in ABY arithmetic sharing, including the
+  /// conversions to and from the garbled circuit
+  double aby;
+};
+
+/// \brief Cost of a multiply-add of one ciphertext coefficient
+constexpr double s_he_coeff_op_us = 2e-3;
+/// \brief Cost of a 64-bit arithmetic multiplication, including generating
+/// its multiplication triple with OTs
+constexpr double s_arith_mul_us = 1.0;
+/// \brief Cost of converting a 64-bit value between Yao and arithmetic
+/// sharing
+constexpr double s_conversion_us = 2.0;
+/// \brief Cost of transferring one byte
+constexpr double s_byte_us = 8e-3;
+
+/// \brief Estimates the cost of a Dot followed by a garbled circuit Relu
+/// \param[in] input_size Number of inputs of the Dot
+/// \param[in] output_size Number of outputs of the Dot
+/// \param[in] batch_size Number of values per ciphertext
+/// \param[in] poly_modulus_degree Degree of the ciphertext polynomials
+/// \param[in] num_coeff_moduli Number of coefficient moduli of the Dot input
+inline DotReluCost dot_relu_cost(size_t input_size, size_t output_size,
+                                 size_t batch_size,
+                                 size_t poly_modulus_degree,
+                                 size_t num_coeff_moduli) {
+  auto inputs = static_cast<double>(input_size);
+  auto outputs = static_cast<double>(output_size);
+  auto batch = static_cast<double>(batch_size);
+  auto coeffs = static_cast<double>(poly_modulus_degree);
+
+  // Each scalar product multiplies and accumulates a ciphertext of two
+  // polynomials at every coefficient modulus
+  double he = inputs * outputs * 2 * coeffs *
+              static_cast<double>(num_coeff_moduli) * s_he_coeff_op_us;
+
+  // The client receives the inputs rather than the outputs of the Dot, as
+  // two polynomials at the lowest coefficient modulus
+  double cipher_bytes = 2 * coeffs * sizeof(uint64_t);
+  double aby = inputs * outputs * batch * s_arith_mul_us +
+               (inputs + outputs) * batch * s_conversion_us +
+               (inputs - outputs) * cipher_bytes * s_byte_us;
+  return DotReluCost{he, aby};
+}
+
+/// \brief Returns whether or not a Dot followed by a garbled circuit Relu is
+/// estimated to be cheaper in ABY arithmetic sharing than in HE
+inline bool prefer_aby_dot_relu(size_t input_size, size_t output_size,
+                                size_t batch_size, size_t poly_modulus_degree,
+                                size_t num_coeff_moduli) {
+  DotReluCost cost = dot_relu_cost(input_size, output_size, batch_size,
+                                   poly_modulus_degree, num_coeff_moduli);
+  return cost.aby < cost.he;
+}
+
+/// \brief Measured link between the server and a client
+struct NetworkProfile {
+  /// \brief Round-trip time, in microseconds
+  double rtt_us;
+  /// \brief Bandwidth, in bytes per microsecond
+  double bytes_per_us;
+};
+
+/// \brief Bytes of the garbled table of an AND gate, with half-gates and
+/// 128-bit labels
+constexpr double s_yao_and_bytes = 32;
+/// \brief Cost of garbling or evaluating an AND gate
+constexpr double s_yao_and_us = 5e-2;
+/// \brief Bytes of an AND gate in GMW: the OT extension generating its
+/// multiplication triple, and the few bits opened online
+constexpr double s_gmw_and_bytes = 16;
+
+/// \brief Estimates the online cost, in microseconds, of garbled circuit
+/// Relus under a sharing protocol. Yao's garbled circuits take a constant
+/// number of rounds and send a garbled table per AND gate of the
+/// size-optimized circuit. GMW takes a round per AND layer of the
+/// depth-optimized circuit, i.e. about log2(bitlen) per adder or comparator,
+/// and sends less per AND gate, of which the depth-optimized circuit has
+/// about log2(bitlen) times more
+/// \param[in] gmw Whether to estimate GMW rather than Yao
+/// \param[in] network Link between the server and the client
+/// \param[in] num_values Number of Relu values evaluated
+/// \param[in] bitlen Bit-width of the circuit values
+inline double relu_circuit_cost(bool gmw, const NetworkProfile& network,
+                                size_t num_values, size_t bitlen) {
+  // Each Relu has five adders or comparators and three MUXes, see relu_aby
+  constexpr double adders_per_relu = 5;
+  constexpr double muxes_per_relu = 3;
+  auto bits = static_cast<double>(bitlen);
+  auto values = static_cast<double>(num_values);
+  double log_bits = std::log2(std::max(bits, 2.0));
+  double bandwidth = std::max(network.bytes_per_us, 1e-9);
+
+  if (gmw) {
+    double ands = values * bits * (adders_per_relu * log_bits + muxes_per_relu);
+    double rounds = adders_per_relu * (log_bits + 1) + 1;
+    return rounds * network.rtt_us + ands * s_gmw_and_bytes / bandwidth;
+  }
+  double ands = values * bits * (adders_per_relu + muxes_per_relu);
+  return 2 * network.rtt_us +
+         ands * (s_yao_and_bytes / bandwidth + s_yao_and_us);
+}
+
+/// \brief Returns the sharing protocol, "yao" or "gmw", with the lower
+/// estimated online cost of evaluating the garbled circuit Relus of an
+/// inference, see relu_circuit_cost. GMW wins on low-latency links, Yao on
+/// high-latency ones
+/// \param[in] network Link between the server and the client
+/// \param[in] num_values Number of Relu values evaluated per inference
+/// \param[in] bitlen Bit-width of the circuit values
+inline const char* choose_mpc_protocol(const NetworkProfile& network,
+                                       size_t num_values, size_t bitlen) {
+  return relu_circuit_cost(true, network, num_values, bitlen) <
+                 relu_circuit_cost(false, network, num_values, bitlen)
+             ? "gmw"
+             : "yao";
+}
+
+}  // namespace ngraph::runtime::aby
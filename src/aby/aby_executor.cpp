@@ -16,7 +16,9 @@
 
 #include "aby/aby_executor.hpp"
 
+#include <future>
 #include <map>
+#include <vector>
 
 #include "seal/kernel/subtract_seal.hpp"
 #include "seal/seal_util.hpp"
@@ -56,21 +58,83 @@ ABYExecutor::ABYExecutor(const std::string& role,
                security_level);
   m_security_level = security_level;
 
+  // The parties stay connected for the lifetime of the executor, and are
+  // reset after each circuit execution
   m_ABYParties.resize(num_parties);
+  m_sharings.resize(num_parties);
+  m_circuits.resize(num_parties);
   for (size_t idx = 0; idx < num_parties; ++idx) {
-    m_ABYParties[idx] = new ABYParty(
+    m_ABYParties[idx] = std::make_unique<ABYParty>(
         m_role, hostname, port + idx, get_sec_lvl(m_security_level), bit_length,
         m_num_threads, m_mt_gen_alg, reserve_num_gates);
+    m_sharings[idx] = m_ABYParties[idx]->GetSharings();
+    m_circuits[idx] = dynamic_cast<BooleanCircuit*>(
+        m_sharings[idx][m_aby_gc_protocol]->GetCircuitBuildRoutine());
+    NGRAPH_CHECK(m_circuits[idx] != nullptr, "Party ", idx,
+                 " has no boolean circuit");
   }
-  m_sharings.resize(num_parties);
 
-  // TODO(fboemer): connect and base OTs?
-  //  m_ABYParty_server->ConnectAndBaseOTs();
   NGRAPH_HE_LOG(1) << "Started ABYParty with role " << role << ", "
                    << num_parties << " parties";
 }
 
-// TODO(fboemer): delete ABYParty
-ABYExecutor::~ABYExecutor() = default;
+ABYExecutor::~ABYExecutor() {
+  if (m_offline_phase.valid()) {
+    m_offline_phase.wait();
+  }
+}
+
+void ABYExecutor::start_offline_phase(size_t num_expected_values) {
+  NGRAPH_CHECK(!m_offline_phase.valid(), "Offline phase already started");
+  NGRAPH_HE_LOG(3) << "Starting ABY offline phase for " << num_expected_values
+                   << " values";
+  m_offline_phase = std::async(std::launch::async, [this,
+                                                    num_expected_values]() {
+    run_offline_phase(num_expected_values);
+  });
+}
+
+void ABYExecutor::wait_for_offline_phase() {
+  if (m_offline_phase.valid()) {
+    m_offline_phase.get();
+    NGRAPH_HE_LOG(3) << "ABY offline phase done";
+  }
+}
+
+void ABYExecutor::run_offline_phase(size_t /* num_expected_values */) {
+  // Each party connects on its own port, so the parties set up in parallel
+  std::vector<std::future<BOOL>> connections;
+  for (auto& party : m_ABYParties) {
+    connections.emplace_back(
+        std::async(std::launch::async,
+                   [&party]() { return party->ConnectAndBaseOTs(); }));
+  }
+  for (size_t party_idx = 0; party_idx < connections.size(); ++party_idx) {
+    NGRAPH_CHECK(connections[party_idx].get(), "ABY party ", party_idx,
+                 " failed to connect and perform base OTs");
+  }
+}
+
+std::vector<share*> ABYExecutor::build_dot_relu_circuit(
+    size_t party_idx, size_t batch_size, size_t input_size,
+    size_t output_size, std::vector<uint64_t>& xs, std::vector<uint64_t>& xc,
+    std::vector<uint64_t>& weights, std::vector<uint64_t>& r,
+    size_t weight_bits, size_t truncate_bits) {
+  NGRAPH_CHECK(party_idx < m_sharings.size(), "Party idx ", party_idx,
+               "too large");
+  // Y2A conversions go through the GMW circuit
+  NGRAPH_CHECK(m_aby_gc_protocol == S_YAO,
+               "Arithmetic sharing requires the yao protocol");
+  auto* bool_circ = dynamic_cast<BooleanCircuit*>(
+      m_sharings[party_idx][S_BOOL]->GetCircuitBuildRoutine());
+  auto* arith_circ = dynamic_cast<ArithmeticCircuit*>(
+      m_sharings[party_idx][S_ARITH]->GetCircuitBuildRoutine());
+  NGRAPH_CHECK(bool_circ != nullptr && arith_circ != nullptr, "Party ",
+               party_idx, " has no arithmetic sharing");
+  return dot_relu_aby(*get_circuit(party_idx), *bool_circ, *arith_circ,
+                      batch_size, input_size, output_size, xs, xc, weights, r,
+                      m_aby_bitlen, m_lowest_coeff_modulus, weight_bits,
+                      truncate_bits);
+}
 
 }  // namespace ngraph::runtime::aby
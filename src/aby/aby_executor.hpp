@@ -16,20 +16,28 @@
 
 #pragma once
 
+#include <algorithm>
+#include <future>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "aby/aby_util.hpp"
+#include "aby/kernel/dot_relu_aby.hpp"
 #include "aby/kernel/relu_aby.hpp"
 #include "abycore/aby/abyparty.h"
+#include "abycore/circuit/arithmeticcircuits.h"
 #include "abycore/circuit/booleancircuits.h"
 #include "abycore/circuit/share.h"
 #include "abycore/sharing/sharing.h"
 #include "he_tensor.hpp"
 #include "he_type.hpp"
 #include "logging/ngraph_he_log.hpp"
+#include "logging/ngraph_he_trace.hpp"
 #include "ngraph/except.hpp"
 #include "ngraph/util.hpp"
+#include "seal/he_seal_thread_budget.hpp"
 
 namespace ngraph::runtime::aby {
 
@@ -43,14 +51,50 @@ class ABYExecutor {
 
   virtual ~ABYExecutor();
 
+  /// \brief Returns the circuit of a party. The circuit is owned by the
+  /// party and reused across executions, after reset_party
+  /// \param[in] party_idx Index of the party
   BooleanCircuit* get_circuit(size_t party_idx) {
-    NGRAPH_CHECK(party_idx < m_ABYParties.size(), "Party idx ", party_idx,
+    NGRAPH_CHECK(party_idx < m_circuits.size(), "Party idx ", party_idx,
                  "too large");
+    return m_circuits[party_idx];
+  }
+
+  /// \brief Returns the construction of the adders and comparators of the
+  /// Relu and MaxPool circuits: size-optimized for Yao, whose bandwidth
+  /// grows with the number of AND gates, and depth-optimized for GMW, whose
+  /// rounds grow with the AND depth
+  CircuitVariant circuit_variant() const {
+    return default_circuit_variant(m_aby_gc_protocol);
+  }
 
-    m_sharings[party_idx] = m_ABYParties[party_idx]->GetSharings();
-    auto circ = dynamic_cast<BooleanCircuit*>(
-        m_sharings[party_idx][m_aby_gc_protocol]->GetCircuitBuildRoutine());
-    return circ;
+  /// \brief Returns the bit-length of the values of the Relu and MaxPool
+  /// circuits: the width of the lowest coefficient modulus q, plus a carry
+  /// bit, so sums in [0, 2q) do not overflow. Since the garbled tables and
+  /// OTs grow with the bit-length, this is about half of the party's
+  /// bit-length for 22 to 30-bit moduli. The party's bit-length remains the
+  /// ring of the arithmetic sharing, e.g. of the Dot and Relu circuit
+  uint32_t circuit_bitlen() const { return m_circuit_bitlen; }
+
+  /// \brief Splits values between the parties. Each party executes a
+  /// separate circuit, so small batches use fewer parties
+  /// \param[in] num_values Number of values to evaluate
+  /// \returns [start_idx, end_idx) of the values for each party
+  std::vector<std::pair<size_t, size_t>> split_between_parties(
+      size_t num_values) const {
+    return split_vector(num_values, m_num_parties, s_min_values_per_party);
+  }
+
+  /// \brief Splits outputs between the parties, where each output holds
+  /// batch_size values
+  /// \param[in] num_outputs Number of outputs to evaluate
+  /// \param[in] batch_size Number of values per output
+  /// \returns [start_idx, end_idx) of the outputs for each party
+  std::vector<std::pair<size_t, size_t>> split_outputs_between_parties(
+      size_t num_outputs, size_t batch_size) const {
+    size_t min_outputs =
+        std::max(1UL, s_min_values_per_party / std::max(1UL, batch_size));
+    return split_vector(num_outputs, m_num_parties, min_outputs);
   }
 
   void mask_input_unknown_relu_ciphers_batch(
@@ -69,6 +113,17 @@ class ABYExecutor {
   virtual void run_aby_circuit(const std::string& function,
                                std::shared_ptr<he::HETensor>& tensor) = 0;
 
+  /// \brief Starts the input-independent offline phase in the background,
+  /// which connects each party and performs the base OTs
+  /// \param[in] num_expected_values Number of values expected to be
+  /// evaluated in the online phase, used to precompute masks
+  void start_offline_phase(size_t num_expected_values = 0);
+
+  /// \brief Blocks until the offline phase, if started, has finished
+  /// \throws ngraph_error if the offline phase failed
+  void wait_for_offline_phase();
+
+  /// \brief Clears the circuit of a party, keeping the party connected
   void reset_party(size_t party_idx) {
     if (party_idx < m_ABYParties.size()) {
       m_ABYParties[party_idx]->Reset();
@@ -76,20 +131,61 @@ class ABYExecutor {
   }
 
  protected:
+  /// \brief Executes the circuit of a party, traced as a span
+  /// \param[in] party_idx Index of the party
+  /// \param[in] circuit Name of the circuit, e.g. "Relu"
+  void exec_circuit(size_t party_idx, const std::string& circuit) {
+    he::logging::TraceSpan trace_span("aby", circuit + " circuit");
+    trace_span.add_arg("party", std::to_string(party_idx));
+    m_ABYParties[party_idx]->ExecCircuit();
+  }
+
+  /// \brief Builds the Dot and Relu circuit of a party, which converts its
+  /// inputs from the garbled circuit to arithmetic sharing and back
+  /// \param[in] party_idx Index of the party
+  /// \returns One output share per output, see dot_relu_aby
+  std::vector<share*> build_dot_relu_circuit(
+      size_t party_idx, size_t batch_size, size_t input_size,
+      size_t output_size, std::vector<uint64_t>& xs,
+      std::vector<uint64_t>& xc, std::vector<uint64_t>& weights,
+      std::vector<uint64_t>& r, size_t weight_bits, size_t truncate_bits);
+
+  /// \brief Runs the offline phase. Called from start_offline_phase
+  /// \param[in] num_expected_values Number of values expected to be
+  /// evaluated in the online phase
+  virtual void run_offline_phase(size_t num_expected_values);
+
   size_t m_num_threads;
   size_t m_num_parties;
 
+  /// \brief Minimum number of values evaluated by each party
+  static constexpr size_t s_min_values_per_party = 256;
+
   // m_sharings[i] are the sharings for party i
   std::vector<std::vector<Sharing*>> m_sharings;
+  // m_circuits[i] is the garbled circuit of party i
+  std::vector<BooleanCircuit*> m_circuits;
 
   e_role m_role;
   e_sharing m_aby_gc_protocol;
   e_mt_gen_alg m_mt_gen_alg;
   uint32_t m_aby_bitlen;
   uint64_t m_security_level;
-  std::vector<ABYParty*> m_ABYParties;
+  std::vector<std::unique_ptr<ABYParty>> m_ABYParties;
+
+  /// \brief Sets the modulus the circuits compute modulo, along with
+  /// circuit_bitlen
+  /// \param[in] modulus Lowest coefficient modulus of the HE parameters
+  void set_lowest_coeff_modulus(const seal::Modulus& modulus) {
+    m_lowest_coeff_modulus = modulus.value();
+    m_circuit_bitlen = std::min(
+        m_aby_bitlen, static_cast<uint32_t>(modulus.bit_count()) + 1);
+  }
 
   size_t m_lowest_coeff_modulus{0};
+  uint32_t m_circuit_bitlen{0};
+
+  std::future<void> m_offline_phase;
 };
 
 }  // namespace ngraph::runtime::aby
@@ -17,8 +17,12 @@
 #include "aby/aby_server_executor.hpp"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
+#include "aby/kernel/max_pool_aby.hpp"
 #include "aby/kernel/relu_aby.hpp"
+#include "he_util.hpp"
 #include "nlohmann/json.hpp"
 #include "seal/kernel/subtract_seal.hpp"
 #include "seal/seal_util.hpp"
@@ -36,23 +40,92 @@ ABYServerExecutor::ABYServerExecutor(
                   bit_length, num_threads, num_parties, mg_algo_str,
                   reserve_num_gates),
       m_he_seal_executable{he_seal_executable} {
-  m_lowest_coeff_modulus = m_he_seal_executable.he_seal_backend()
+  set_lowest_coeff_modulus(m_he_seal_executable.he_seal_backend()
                                .get_encryption_parameters()
                                .seal_encryption_parameters()
-                               .coeff_modulus()[0]
-                               .value();
-  m_rand_max = static_cast<int64_t>(m_lowest_coeff_modulus - 1);
-  m_random_distribution = std::uniform_int_distribution<int64_t>{0, m_rand_max};
+                               .coeff_modulus()[0]);
+  m_mask_prg = std::make_unique<crypto>(m_security_level);
+}
+
+ABYServerExecutor::~ABYServerExecutor() {
+  // The offline phase writes to members of this class
+  if (m_offline_phase.valid()) {
+    m_offline_phase.wait();
+  }
+}
+
+void ABYServerExecutor::run_offline_phase(size_t num_expected_values) {
+  ABYExecutor::run_offline_phase(num_expected_values);
+
+  const auto& backend = m_he_seal_executable.he_seal_backend();
+  for (const auto& [name, enabled] :
+       {std::make_pair("gc_input_mask", backend.mask_gc_inputs()),
+        std::make_pair("gc_output_mask", backend.mask_gc_outputs())}) {
+    if (enabled) {
+      std::vector<uint64_t>& values = m_precomputed_masks[name];
+      values.resize(num_expected_values);
+      fill_random_mask_values(values);
+    }
+  }
+  NGRAPH_HE_LOG(3) << "Precomputed " << num_expected_values
+                   << " garbled circuit mask values";
+}
+
+std::vector<uint64_t> ABYServerExecutor::draw_random_mask_values(
+    const std::string& name, size_t count) {
+  std::vector<uint64_t> values(count);
+  auto precomputed = m_precomputed_masks.find(name);
+  if (precomputed != m_precomputed_masks.end() &&
+      precomputed->second.size() >= count) {
+    // Masks are single-use, so consumed values are dropped from the end
+    auto& pool = precomputed->second;
+    std::copy(pool.end() - count, pool.end(), values.begin());
+    pool.resize(pool.size() - count);
+    return values;
+  }
+  fill_random_mask_values(values);
+  return values;
+}
+
+void ABYServerExecutor::fill_random_mask_values(std::vector<uint64_t>& values) {
+  // Rejection sampling of values with the bit length of q keeps the masks
+  // uniform, and accepts more than half of the draws
+  uint64_t q = m_lowest_coeff_modulus;
+  uint64_t bit_mask = q - 1;
+  for (size_t shift = 1; shift < 64; shift <<= 1U) {
+    bit_mask |= bit_mask >> shift;
+  }
+
+  std::vector<uint64_t> draws(std::min(values.size(), s_mask_chunk_size));
+  size_t filled = 0;
+  while (filled < values.size()) {
+    size_t num_draws = std::min(values.size() - filled, draws.size());
+    m_mask_prg->gen_rnd(reinterpret_cast<BYTE*>(draws.data()),
+                        static_cast<uint32_t>(num_draws * sizeof(uint64_t)));
+    for (size_t draw_idx = 0; draw_idx < num_draws; ++draw_idx) {
+      uint64_t value = draws[draw_idx] & bit_mask;
+      if (value < q) {
+        values[filled++] = value;
+      }
+    }
+  }
 }
 
 void ABYServerExecutor::prepare_aby_circuit(
     const std::string& function, std::shared_ptr<he::HETensor>& tensor) {
   NGRAPH_HE_LOG(4) << "server prepare_aby_circuit with function " << function;
+  wait_for_offline_phase();
   json js = json::parse(function);
   auto name = js.at("function");
 
   if (name == "Relu") {
     prepare_aby_relu_circuit(tensor->data());
+  } else if (name == "MaxPool") {
+    mask_aby_inputs(tensor->data(),
+                    he::flag_to_int(std::string(js.at("num_outputs"))));
+  } else if (name == "DotRelu") {
+    mask_aby_inputs(tensor->data(),
+                    he::flag_to_int(std::string(js.at("output_size"))));
   } else {
     NGRAPH_ERR << "Unknown function name " << name;
     throw ngraph_error("Unknown function name");
@@ -62,11 +135,21 @@ void ABYServerExecutor::prepare_aby_circuit(
 void ABYServerExecutor::run_aby_circuit(const std::string& function,
                                         std::shared_ptr<he::HETensor>& tensor) {
   NGRAPH_HE_LOG(4) << "server run_aby_circuit with funciton " << function;
+  wait_for_offline_phase();
 
   json js = json::parse(function);
   auto name = js.at("function");
   if (name == "Relu") {
-    run_aby_relu_circuit(tensor->data());
+    size_t truncate_bits =
+        js.find("truncate_bits") != js.end()
+            ? he::flag_to_int(std::string(js.at("truncate_bits")))
+            : 0;
+    run_aby_relu_circuit(tensor->data(), truncate_bits);
+  } else if (name == "MaxPool") {
+    run_aby_max_pool_circuit(
+        tensor->data(), he::flag_to_int(std::string(js.at("window_size"))),
+        he::flag_to_int(std::string(js.at("num_outputs"))),
+        he::string_to_bool(std::string(js.at("relu"))));
   } else {
     NGRAPH_ERR << "Unknown function name " << name;
     throw ngraph_error("Unknown function name");
@@ -80,7 +163,8 @@ void ABYServerExecutor::post_process_aby_circuit(
 
   json js = json::parse(function);
   auto name = js.at("function");
-  if (name == "Relu") {
+  if (name == "Relu" || name == "MaxPool" || name == "DotRelu") {
+    // All circuits mask their outputs in the same way
     post_process_aby_relu_circuit(tensor);
   } else {
     NGRAPH_ERR << "Unknown function name " << name;
@@ -95,14 +179,12 @@ std::shared_ptr<he::HETensor> ABYServerExecutor::generate_gc_mask(
       element::i64, shape, plaintext_packing, complex_packing, false,
       m_he_seal_executable.he_seal_backend(), name);
 
-  std::vector<uint64_t> rand_vals(tensor->get_element_count());
+  std::vector<uint64_t> rand_vals;
   if (random) {
-    auto random_gen = [this]() {
-      return m_random_distribution(m_random_generator);
-    };
-    std::generate(rand_vals.begin(), rand_vals.end(), random_gen);
+    rand_vals = draw_random_mask_values(name, tensor->get_element_count());
   } else {
-    rand_vals = std::vector<uint64_t>(rand_vals.size(), default_value);
+    rand_vals =
+        std::vector<uint64_t>(tensor->get_element_count(), default_value);
   }
   NGRAPH_HE_LOG(4) << "Random mask vals:";
   for (size_t i = 0; i < std::min(rand_vals.size(), 10UL); ++i) {
@@ -133,7 +215,12 @@ std::shared_ptr<he::HETensor> ABYServerExecutor::generate_gc_output_mask(
 void ABYServerExecutor::prepare_aby_relu_circuit(
     std::vector<he::HEType>& cipher_batch) {
   NGRAPH_HE_LOG(4) << "prepare_aby_relu_circuit ";
+  mask_aby_inputs(cipher_batch, cipher_batch.size());
+}
 
+void ABYServerExecutor::mask_aby_inputs(std::vector<he::HEType>& cipher_batch,
+                                        size_t num_outputs) {
+  NGRAPH_CHECK(!cipher_batch.empty(), "No ciphertexts to mask");
   bool plaintext_packing = cipher_batch[0].plaintext_packing();
   bool complex_packing = cipher_batch[0].complex_packing();
   size_t batch_size = cipher_batch[0].batch_size();
@@ -148,15 +235,20 @@ void ABYServerExecutor::prepare_aby_relu_circuit(
   NGRAPH_HE_LOG(4) << "Generating gc output mask";
 
   m_gc_output_mask = generate_gc_output_mask(
-      Shape{batch_size, cipher_batch.size()}, plaintext_packing,
-      complex_packing, m_lowest_coeff_modulus / 2);
+      Shape{batch_size, num_outputs}, plaintext_packing, complex_packing,
+      m_lowest_coeff_modulus / 2);
 
   std::vector<double> scales(cipher_batch.size());
 
+  for (const auto& he_type : cipher_batch) {
+    NGRAPH_CHECK(he_type.is_ciphertext(), "HEType is not ciphertext");
+  }
+
+  // Each ciphertext is masked independently
+#pragma omp parallel for
   for (size_t i = 0; i < cipher_batch.size(); ++i) {
     auto& he_type = cipher_batch[i];
     auto& gc_input_mask = m_gc_input_mask->data(i);
-    NGRAPH_CHECK(he_type.is_ciphertext(), "HEType is not ciphertext");
 
     auto cipher = he_type.get_ciphertext();
 
@@ -187,12 +279,12 @@ void ABYServerExecutor::prepare_aby_relu_circuit(
 }
 
 void ABYServerExecutor::run_aby_relu_circuit(
-    std::vector<he::HEType>& cipher_batch) {
+    std::vector<he::HEType>& cipher_batch, size_t truncate_bits) {
   NGRAPH_HE_LOG(4) << "run_aby_relu_circuit ";
 
   uint32_t num_aby_vals = cipher_batch.size() * cipher_batch[0].batch_size();
 
-  auto party_data_start_end_idx = split_vector(num_aby_vals, m_num_parties);
+  auto party_data_start_end_idx = split_between_parties(num_aby_vals);
 
   std::vector<uint64_t> gc_input_mask_vals(num_aby_vals);
   std::vector<uint64_t> gc_output_mask_vals(num_aby_vals);
@@ -202,7 +294,8 @@ void ABYServerExecutor::run_aby_relu_circuit(
   m_gc_output_mask->read(gc_output_mask_vals.data(),
                          num_aby_vals * sizeof(uint64_t));
 
-#pragma omp parallel for num_threads(m_num_parties)
+  he::HEThreadBudget::Reservation party_threads(m_num_parties);
+#pragma omp parallel for num_threads(party_threads.num_threads())
   for (size_t party_idx = 0; party_idx < m_num_parties; ++party_idx) {
     const auto& [start_idx, end_idx] = party_data_start_end_idx[party_idx];
     size_t party_data_size = end_idx - start_idx;
@@ -228,10 +321,11 @@ void ABYServerExecutor::run_aby_relu_circuit(
 
     ngraph::runtime::aby::relu_aby(
         *circ, party_data_size, gc_input_party_mask_vals, zeros,
-        gc_output_party_mask_vals, m_aby_bitlen, m_lowest_coeff_modulus);
+        gc_output_party_mask_vals, circuit_bitlen(), m_lowest_coeff_modulus,
+        truncate_bits, circuit_variant());
 
     NGRAPH_HE_LOG(3) << "server executing relu circuit";
-    m_ABYParties[party_idx]->ExecCircuit();
+    exec_circuit(party_idx, "Relu");
     NGRAPH_HE_LOG(3) << "server done executing relu circuit";
 
     reset_party(party_idx);
@@ -239,6 +333,133 @@ void ABYServerExecutor::run_aby_relu_circuit(
   }
 }
 
+void ABYServerExecutor::run_aby_max_pool_circuit(
+    std::vector<he::HEType>& cipher_batch, size_t window_size,
+    size_t num_outputs, bool relu) {
+  NGRAPH_HE_LOG(4) << "run_aby_max_pool_circuit ";
+  NGRAPH_CHECK(cipher_batch.size() == window_size * num_outputs, "Got ",
+               cipher_batch.size(), " ciphertexts, expected ",
+               window_size * num_outputs);
+
+  size_t batch_size = cipher_batch[0].batch_size();
+  size_t num_aby_vals = cipher_batch.size() * batch_size;
+  size_t num_aby_outputs = num_outputs * batch_size;
+
+  std::vector<uint64_t> gc_input_mask_vals(num_aby_vals);
+  std::vector<uint64_t> gc_output_mask_vals(num_aby_outputs);
+  m_gc_input_mask->read(gc_input_mask_vals.data(),
+                        num_aby_vals * sizeof(uint64_t));
+  m_gc_output_mask->read(gc_output_mask_vals.data(),
+                         num_aby_outputs * sizeof(uint64_t));
+
+  auto party_output_start_end_idx = split_between_parties(num_aby_outputs);
+
+  he::HEThreadBudget::Reservation party_threads(m_num_parties);
+#pragma omp parallel for num_threads(party_threads.num_threads())
+  for (size_t party_idx = 0; party_idx < m_num_parties; ++party_idx) {
+    const auto& [start_idx, end_idx] = party_output_start_end_idx[party_idx];
+    size_t party_output_size = end_idx - start_idx;
+    if (party_output_size == 0) {
+      continue;
+    }
+
+    std::vector<uint64_t> gc_input_party_mask_vals(window_size *
+                                                   party_output_size);
+    for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+      for (size_t idx = start_idx; idx < end_idx; ++idx) {
+        gc_input_party_mask_vals[window_idx * party_output_size + idx -
+                                 start_idx] =
+            gc_input_mask_vals[max_pool_aby_input_index(
+                window_idx, idx, num_outputs, window_size)];
+      }
+    }
+    std::vector<uint64_t> gc_output_party_mask_vals(
+        gc_output_mask_vals.begin() + start_idx,
+        gc_output_mask_vals.begin() + end_idx);
+    std::vector<uint64_t> zeros(gc_input_party_mask_vals.size(), 0);
+
+    NGRAPH_HE_LOG(3) << "Server creating max pool circuit for party "
+                     << party_idx;
+    max_pool_aby(*get_circuit(party_idx), party_output_size, window_size,
+                 gc_input_party_mask_vals, zeros, gc_output_party_mask_vals,
+                 circuit_bitlen(), m_lowest_coeff_modulus, relu,
+                 circuit_variant());
+
+    exec_circuit(party_idx, "MaxPool");
+    reset_party(party_idx);
+  }
+}
+
+void ABYServerExecutor::run_aby_dot_relu_circuit(
+    std::vector<he::HEType>& cipher_batch, std::vector<uint64_t>& weights,
+    size_t output_size, size_t weight_bits, size_t truncate_bits) {
+  NGRAPH_HE_LOG(4) << "run_aby_dot_relu_circuit ";
+  wait_for_offline_phase();
+  size_t input_size = cipher_batch.size();
+  NGRAPH_CHECK(weights.size() == input_size * output_size, "Got ",
+               weights.size(), " weights, expected ",
+               input_size * output_size);
+
+  size_t batch_size = cipher_batch[0].batch_size();
+  std::vector<uint64_t> gc_input_mask_vals(input_size * batch_size);
+  std::vector<uint64_t> gc_output_mask_vals(output_size * batch_size);
+  m_gc_input_mask->read(gc_input_mask_vals.data(),
+                        gc_input_mask_vals.size() * sizeof(uint64_t));
+  m_gc_output_mask->read(gc_output_mask_vals.data(),
+                         gc_output_mask_vals.size() * sizeof(uint64_t));
+
+  // Each party evaluates all inputs, for a subset of the outputs
+  std::vector<uint64_t> xs(input_size * batch_size);
+  for (size_t batch_idx = 0; batch_idx < batch_size; ++batch_idx) {
+    for (size_t input_idx = 0; input_idx < input_size; ++input_idx) {
+      xs[input_idx * batch_size + batch_idx] =
+          gc_input_mask_vals[batch_idx * input_size + input_idx];
+    }
+  }
+  std::vector<uint64_t> zeros(xs.size(), 0);
+
+  auto party_output_start_end_idx =
+      split_outputs_between_parties(output_size, batch_size);
+
+  he::HEThreadBudget::Reservation party_threads(m_num_parties);
+#pragma omp parallel for num_threads(party_threads.num_threads())
+  for (size_t party_idx = 0; party_idx < m_num_parties; ++party_idx) {
+    const auto& [start_idx, end_idx] = party_output_start_end_idx[party_idx];
+    size_t party_output_size = end_idx - start_idx;
+    if (party_output_size == 0) {
+      continue;
+    }
+
+    std::vector<uint64_t> party_weights(input_size * party_output_size);
+    for (size_t input_idx = 0; input_idx < input_size; ++input_idx) {
+      std::copy(weights.begin() + input_idx * output_size + start_idx,
+                weights.begin() + input_idx * output_size + end_idx,
+                party_weights.begin() + input_idx * party_output_size);
+    }
+    std::vector<uint64_t> gc_output_party_mask_vals(party_output_size *
+                                                    batch_size);
+    for (size_t out_idx = start_idx; out_idx < end_idx; ++out_idx) {
+      for (size_t batch_idx = 0; batch_idx < batch_size; ++batch_idx) {
+        gc_output_party_mask_vals[(out_idx - start_idx) * batch_size +
+                                  batch_idx] =
+            gc_output_mask_vals[batch_idx * output_size + out_idx];
+      }
+    }
+    std::vector<uint64_t> party_xs(xs);
+    std::vector<uint64_t> party_zeros(zeros);
+
+    NGRAPH_HE_LOG(3) << "Server creating dot relu circuit for party "
+                     << party_idx;
+    build_dot_relu_circuit(party_idx, batch_size, input_size,
+                           party_output_size, party_xs, party_zeros,
+                           party_weights, gc_output_party_mask_vals,
+                           weight_bits, truncate_bits);
+
+    exec_circuit(party_idx, "DotRelu");
+    reset_party(party_idx);
+  }
+}
+
 void ABYServerExecutor::post_process_aby_relu_circuit(
     std::shared_ptr<he::HETensor>& tensor) {
   if (m_he_seal_executable.he_seal_backend().mask_gc_outputs()) {
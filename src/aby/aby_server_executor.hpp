@@ -18,8 +18,10 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "ENCRYPTO_utils/crypto/crypto.h"
 #include "aby/aby_executor.hpp"
 #include "he_tensor.hpp"
 #include "he_type.hpp"
@@ -42,9 +44,9 @@ class ABYServerExecutor : public ABYExecutor {
                     uint32_t bit_length = 64, uint32_t num_threads = 1,
                     uint32_t num_parties = 1,
                     std::string mg_algo_str = std::string("MT_OT"),
-                    uint32_t reserve_num_gates = 100);
+                    uint32_t reserve_num_gates = 65536);
 
-  ~ABYServerExecutor() = default;
+  ~ABYServerExecutor() override;
 
   std::shared_ptr<he::HETensor> generate_gc_mask(
       const Shape& shape, bool plaintext_packing, bool complex_packing,
@@ -67,19 +69,74 @@ class ABYServerExecutor : public ABYExecutor {
   void post_process_aby_circuit(const std::string& function,
                                 std::shared_ptr<he::HETensor>& tensor);
 
+  /// \brief Masks ciphertexts with the garbled circuit input mask, and
+  /// generates the output mask
+  /// \param[in,out] cipher_batch Ciphertexts to mask. Modified in place
+  /// \param[in] num_outputs Number of circuit outputs per batch entry
+  void mask_aby_inputs(std::vector<he::HEType>& cipher_batch,
+                       size_t num_outputs);
+
   // Relu functions
   void prepare_aby_relu_circuit(std::vector<he::HEType>& cipher_batch);
-  void run_aby_relu_circuit(std::vector<he::HEType>& cipher_batch);
+  void run_aby_relu_circuit(std::vector<he::HEType>& cipher_batch,
+                            size_t truncate_bits = 0);
   void post_process_aby_relu_circuit(std::shared_ptr<he::HETensor>& tensor);
 
+  // MaxPool functions
+  /// \brief Runs the MaxPool circuit on masked ciphertexts
+  /// \param[in] cipher_batch Masked ciphertexts, where ciphertext j of
+  /// output i is at index j * num_outputs + i
+  /// \param[in] window_size Number of ciphertexts per output
+  /// \param[in] num_outputs Number of outputs
+  /// \param[in] relu Whether to apply ReLU to each maximum
+  void run_aby_max_pool_circuit(std::vector<he::HEType>& cipher_batch,
+                                size_t window_size, size_t num_outputs,
+                                bool relu);
+
+  // Hybrid Dot and Relu functions
+  /// \brief Runs the Dot and Relu circuit on masked ciphertexts
+  /// \param[in] cipher_batch Masked ciphertexts, one per input
+  /// \param[in] weights Weights encoded by encode_aby_weight, where the
+  /// weight of input i to output o is at index i * output_size + o
+  /// \param[in] output_size Number of outputs
+  /// \param[in] weight_bits Number of fractional bits of the weights
+  /// \param[in] truncate_bits Number of bits by which the ReLU is divided
+  void run_aby_dot_relu_circuit(std::vector<he::HEType>& cipher_batch,
+                                std::vector<uint64_t>& weights,
+                                size_t output_size, size_t weight_bits,
+                                size_t truncate_bits = 0);
+
+ protected:
+  /// \brief Connects the parties and precomputes the random garbled circuit
+  /// masks for the expected number of values
+  /// \param[in] num_expected_values Number of values expected to be
+  /// evaluated in the online phase
+  void run_offline_phase(size_t num_expected_values) override;
+
  private:
+  /// \brief Returns random mask values, taken from the values precomputed
+  /// for the mask name where possible
+  /// \param[in] name Name of the mask tensor
+  /// \param[in] count Number of values to return
+  std::vector<uint64_t> draw_random_mask_values(const std::string& name,
+                                                size_t count);
+
+  /// \brief Fills values with random masks, uniform in [0, q) for q the
+  /// lowest coefficient modulus, drawn in bulk from an AES-CTR PRG
+  /// \param[out] values Values to fill
+  void fill_random_mask_values(std::vector<uint64_t>& values);
+
   he::HESealExecutable& m_he_seal_executable;
   std::shared_ptr<he::HETensor> m_gc_input_mask;
   std::shared_ptr<he::HETensor> m_gc_output_mask;
 
-  std::default_random_engine m_random_generator;
-  int64_t m_rand_max;
-  std::uniform_int_distribution<int64_t> m_random_distribution;
+  // Generates the garbled circuit masks
+  std::unique_ptr<crypto> m_mask_prg;
+  // Number of mask values drawn per call to the PRG
+  inline static const size_t s_mask_chunk_size{1UL << 16U};
+
+  // Random mask values computed in the offline phase, by mask name
+  std::unordered_map<std::string, std::vector<uint64_t>> m_precomputed_masks;
 };
 
 }  // namespace ngraph::runtime::aby
@@ -35,8 +35,17 @@
 #include "seal/he_seal_backend.hpp"
 
 namespace ngraph::runtime::aby {
+// The argument checks and dumps below scan every circuit input. They are
+// compiled out unless NGRAPH_HE_ABY_CHECK_ENABLE is defined
+
+// Logs the first values of a circuit argument at log level 5
 template <typename T>
-void print_argument(const std::vector<T>& values, const std::string& name) {
+void print_argument([[maybe_unused]] const std::vector<T>& values,
+                    [[maybe_unused]] const std::string& name) {
+#ifdef NGRAPH_HE_ABY_CHECK_ENABLE
+  if (!NGRAPH_HE_VLOG_IS_ON(5)) {
+    return;
+  }
   size_t print_size = std::min(values.size(), 200UL);
 
   if (values.size() > 1) {
@@ -48,17 +57,22 @@ void print_argument(const std::vector<T>& values, const std::string& name) {
   for (size_t i = 0; i < print_size; ++i) {
     NGRAPH_HE_LOG(5) << "\t" << name << "[" << i << "] = " << values[i];
   }
+#endif
 }
 
+// Checks each value of a circuit argument is in [min_val, max_val]
 template <typename T>
-void check_argument_range(const std::vector<T>& values, const T min_val,
-                          const T max_val) {
+void check_argument_range([[maybe_unused]] const std::vector<T>& values,
+                          [[maybe_unused]] const T min_val,
+                          [[maybe_unused]] const T max_val) {
+#ifdef NGRAPH_HE_ABY_CHECK_ENABLE
   for (size_t i = 0; i < values.size(); ++i) {
     NGRAPH_CHECK(values[i] >= min_val, "Values[", i, "] (", values[i],
                  ") too small (minimum ", min_val, ")");
     NGRAPH_CHECK(values[i] <= max_val, "Values[", i, "] (", values[i],
                  ") too large (maximum ", max_val, ")");
   }
+#endif
 }
 
 // Maps numbers from (0, q) to (-q/(2 * scale), q/(2*scale))
@@ -103,24 +117,97 @@ inline share* reduce_mod(BooleanCircuit& circ, share* x, share* mod) {
   return x;
 }
 
+// Constructions of the adders and comparators of the circuits. Size-optimized
+// ripple circuits use the fewest AND gates, which sets the bandwidth of Yao's
+// garbled circuits. Depth-optimized circuits use more AND gates in
+// logarithmic depth, which sets the number of rounds of GMW
+enum class CircuitVariant { size, depth };
+
+// Returns the variant suited to the sharing of a circuit
+inline CircuitVariant default_circuit_variant(e_sharing sharing) {
+  return sharing == S_BOOL ? CircuitVariant::depth : CircuitVariant::size;
+}
+
+// Returns a + b, of the bit-length of a and b
+inline share* put_add(BooleanCircuit& circ, share* a, share* b,
+                      CircuitVariant variant) {
+  std::vector<uint32_t> sum =
+      (variant == CircuitVariant::size)
+          ? circ.PutSizeOptimizedAddGate(a->get_wires(), b->get_wires())
+          : circ.PutDepthOptimizedAddGate(a->get_wires(), b->get_wires());
+  sum.resize(a->get_bitlength());
+  return create_new_share(sum, &circ);
+}
+
+// Returns the wire of a > b
+inline uint32_t put_gt(BooleanCircuit& circ, share* a, share* b,
+                       CircuitVariant variant) {
+  return (variant == CircuitVariant::size)
+             ? circ.PutSizeOptimizedGTGate(a->get_wires(), b->get_wires())
+             : circ.PutDepthOptimizedGTGate(a->get_wires(), b->get_wires());
+}
+
+// Returns s ? a : b for a select wire s
+inline share* put_mux(BooleanCircuit& circ, share* a, share* b, uint32_t s) {
+  return create_new_share(circ.PutMUXGate(a->get_wires(), b->get_wires(), s),
+                          &circ);
+}
+
+// Reduces x in [0, 2q) to [0, q). The subtraction of q doubles as the
+// comparison with q: x - q is computed as x + (2^bitlen - q), whose top wire
+// is set iff x < q, so the reduction takes one adder and a MUX, rather than
+// a comparator, a subtractor and a MUX. Falls back to the latter if q does
+// not fit in bitlen - 1 bits
+inline share* reduce_mod(BooleanCircuit& circ, share* x, uint64_t q,
+                         size_t num_vals, CircuitVariant variant) {
+  size_t bitlen = x->get_bitlength();
+  if (bitlen == 0 || bitlen > 64 || q >= (uint64_t{1} << (bitlen - 1))) {
+    return reduce_mod(circ, x, circ.PutSIMDCONSGate(num_vals, q, bitlen));
+  }
+  uint64_t mask = (bitlen == 64) ? ~uint64_t{0} : (uint64_t{1} << bitlen) - 1;
+  share* minus_q = circ.PutSIMDCONSGate(num_vals, (~q + 1) & mask, bitlen);
+  share* diff = put_add(circ, x, minus_q, variant);
+  return put_mux(circ, x, diff, diff->get_wires().back());
+}
+
+// Divides non-negative x by 2^bits. Dropping the lowest wires of x shifts it
+// without any gates
+inline share* truncate_non_negative(BooleanCircuit& circ, share* x,
+                                    size_t bits, size_t num_vals) {
+  if (bits == 0) {
+    return x;
+  }
+  std::vector<uint32_t> wires = x->get_wires();
+  NGRAPH_CHECK(bits < wires.size(), "Cannot truncate ", bits, " bits of ",
+               wires.size(), "-bit values");
+  std::vector<uint32_t> shifted_wires(wires.begin() + bits, wires.end());
+  shifted_wires.resize(wires.size(), circ.PutConstantGate(0, num_vals));
+  return create_new_share(shifted_wires, &circ);
+}
+
 // Splits a vector into num_splits nearly-equal-sized subvectors
 // Returns vector of [start_idx, end_idx) for each split
-inline std::vector<std::pair<size_t, size_t>> split_vector(size_t vector_size,
-                                                           size_t num_splits) {
-  std::vector<std::pair<size_t, size_t>> splits{num_splits};
-
-  size_t split_size = std::floor(vector_size / num_splits);
-  size_t splits_extra = vector_size - num_splits * split_size;
-  std::vector<std::pair<size_t, size_t>> party_data_start_end_idx{
-      num_splits, std::make_pair(0, 0)};
-  for (size_t split_idx = 0; split_idx < num_splits; ++split_idx) {
+// Only as many splits as have at least min_split_size elements are
+// non-empty, the remaining splits are empty
+inline std::vector<std::pair<size_t, size_t>> split_vector(
+    size_t vector_size, size_t num_splits, size_t min_split_size = 1) {
+  NGRAPH_CHECK(num_splits > 0, "Number of splits must be positive");
+  NGRAPH_CHECK(min_split_size > 0, "Minimum split size must be positive");
+  std::vector<std::pair<size_t, size_t>> splits{
+      num_splits, std::make_pair(vector_size, vector_size)};
+
+  size_t num_used_splits =
+      std::clamp(vector_size / min_split_size, 1UL, num_splits);
+  size_t split_size = vector_size / num_used_splits;
+  size_t splits_extra = vector_size - num_used_splits * split_size;
+  for (size_t split_idx = 0; split_idx < num_used_splits; ++split_idx) {
     size_t start_idx = (split_idx > 0) ? splits[split_idx - 1].second : 0;
     size_t end_idx = start_idx + split_size;
     if (split_idx < splits_extra) {
       end_idx++;
     }
 
-    if (split_idx == num_splits - 1) {
+    if (split_idx == num_used_splits - 1) {
       end_idx = vector_size;
     }
 
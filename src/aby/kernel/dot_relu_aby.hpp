@@ -0,0 +1,136 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "aby/aby_util.hpp"
+#include "abycore/aby/abyparty.h"
+#include "abycore/circuit/arithmeticcircuits.h"
+#include "abycore/circuit/booleancircuits.h"
+#include "abycore/circuit/share.h"
+#include "abycore/sharing/sharing.h"
+#include "logging/ngraph_he_log.hpp"
+
+namespace ngraph::runtime::aby {
+// Encodes a weight in fixed point with weight_bits fractional bits, as a
+// two's complement 64-bit integer
+inline uint64_t encode_aby_weight(double weight, size_t weight_bits) {
+  return static_cast<uint64_t>(
+      static_cast<int64_t>(std::round(std::ldexp(weight, weight_bits))));
+}
+
+// @param xs: server share of X, values in [0,q]. Value k of input i is at
+// index i * batch_size + k
+// @param xc: client share of X, values in [0,q], stored as xs
+// @param weights: server weights W, encoded by encode_aby_weight. The weight
+// of input i to output o is at index i * output_size + o
+// @param r: server share of output random mask, values in [0,q]. Value k of
+// output o is at index o * batch_size + k
+// @param coeff_modulus: q
+// @param weight_bits: w, number of fractional bits of the weights
+// @param truncate_bits: t, number of bits by which the ReLU is divided
+// @brief Let x = (xs+xc)mod q, with x >= q/2 representing negative values.
+// Each x is converted to arithmetic sharing, where y = W^T x is computed in
+// two's complement. Then, the circuit returns
+// (max(y, 0) / 2^(w + t) + r) mod q, one share per output
+inline std::vector<share*> dot_relu_aby(
+    BooleanCircuit& yao_circ, BooleanCircuit& bool_circ,
+    ArithmeticCircuit& arith_circ, size_t batch_size, size_t input_size,
+    size_t output_size, std::vector<uint64_t>& xs, std::vector<uint64_t>& xc,
+    std::vector<uint64_t>& weights, std::vector<uint64_t>& r, size_t bitlen,
+    size_t coeff_modulus, size_t weight_bits, size_t truncate_bits = 0) {
+  size_t num_inputs = input_size * batch_size;
+  size_t num_outputs = output_size * batch_size;
+  NGRAPH_CHECK(xs.size() == num_inputs, "Wrong number of xs (got ", xs.size(),
+               ", expected ", num_inputs, ")");
+  NGRAPH_CHECK(xc.size() == num_inputs, "Wrong number of xc (got ", xc.size(),
+               ", expected ", num_inputs, ")");
+  NGRAPH_CHECK(weights.size() == input_size * output_size,
+               "Wrong number of weights (got ", weights.size(), ", expected ",
+               input_size * output_size, ")");
+  NGRAPH_CHECK(r.size() == num_outputs, "Wrong number of r (got ", r.size(),
+               ", expected ", num_outputs, ")");
+
+  size_t q = coeff_modulus;
+  size_t q_half = coeff_modulus / 2;
+  NGRAPH_HE_LOG(3) << "Creating new dot relu aby circuit with q = " << q
+                   << ", " << input_size << " inputs, " << output_size
+                   << " outputs, batch size " << batch_size
+                   << ", bitlen= " << bitlen;
+  check_argument_range(xs, 0UL, coeff_modulus);
+  check_argument_range(xc, 0UL, coeff_modulus);
+  check_argument_range(r, 0UL, coeff_modulus);
+
+  share* Q = yao_circ.PutSIMDCONSGate(batch_size, q, bitlen);
+  share* half_Q = yao_circ.PutSIMDCONSGate(batch_size, q_half, bitlen);
+
+  // x >= q/2 represents x - q, which wraps around to the two's complement
+  // of q - x
+  std::vector<share*> x_arith(input_size);
+  for (size_t input_idx = 0; input_idx < input_size; ++input_idx) {
+    size_t offset = input_idx * batch_size;
+    share* xs_in = yao_circ.PutSIMDINGate(batch_size, xs.data() + offset,
+                                          bitlen, SERVER);
+    share* xc_in = yao_circ.PutSIMDINGate(batch_size, xc.data() + offset,
+                                          bitlen, CLIENT);
+    share* x = reduce_mod(yao_circ, yao_circ.PutADDGate(xs_in, xc_in), q,
+                          batch_size, CircuitVariant::size);
+    share* x_negative = yao_circ.PutGTGate(x, half_Q);
+    x = yao_circ.PutMUXGate(yao_circ.PutSUBGate(x, Q), x, x_negative);
+    x_arith[input_idx] = arith_circ.PutY2AGate(x, &bool_circ);
+  }
+
+  share* zero =
+      yao_circ.PutSIMDCONSGate(batch_size, static_cast<size_t>(0), bitlen);
+  share* max_positive = yao_circ.PutSIMDCONSGate(
+      batch_size, (uint64_t{1} << (bitlen - 1)) - 1, bitlen);
+
+  std::vector<share*> out(output_size);
+  std::vector<uint64_t> weight_vals(batch_size);
+  for (size_t output_idx = 0; output_idx < output_size; ++output_idx) {
+    share* y_arith = nullptr;
+    for (size_t input_idx = 0; input_idx < input_size; ++input_idx) {
+      std::fill(weight_vals.begin(), weight_vals.end(),
+                weights[input_idx * output_size + output_idx]);
+      share* w_in = arith_circ.PutSIMDINGate(batch_size, weight_vals.data(),
+                                             bitlen, SERVER);
+      share* product = arith_circ.PutMULGate(x_arith[input_idx], w_in);
+      y_arith = (y_arith == nullptr)
+                    ? product
+                    : arith_circ.PutADDGate(y_arith, product);
+    }
+
+    share* y = yao_circ.PutA2YGate(y_arith);
+    share* y_negative = yao_circ.PutGTGate(y, max_positive);
+    y = yao_circ.PutMUXGate(zero, y, y_negative);
+    y = truncate_non_negative(yao_circ, y, weight_bits + truncate_bits,
+                              batch_size);
+
+    // Additively mask output
+    share* r_in = yao_circ.PutSIMDINGate(
+        batch_size, r.data() + output_idx * batch_size, bitlen, SERVER);
+    y = reduce_mod(yao_circ, yao_circ.PutADDGate(y, r_in), q, batch_size,
+                   CircuitVariant::size);
+    out[output_idx] = yao_circ.PutOUTGate(y, CLIENT);
+  }
+  return out;
+}
+
+}  // namespace ngraph::runtime::aby
@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "aby/aby_util.hpp"
+#include "abycore/aby/abyparty.h"
+#include "abycore/circuit/booleancircuits.h"
+#include "abycore/circuit/share.h"
+#include "abycore/sharing/sharing.h"
+#include "logging/ngraph_he_log.hpp"
+
+namespace ngraph::runtime::aby {
+// Returns the index of value window_idx of output output_idx in a
+// {batch_size, window_size * num_outputs} tensor read in row-major order,
+// where output_idx = batch_idx * num_outputs + out_idx, and value window_idx
+// of output out_idx is stored at window_idx * num_outputs + out_idx
+inline size_t max_pool_aby_input_index(size_t window_idx, size_t output_idx,
+                                       size_t num_outputs,
+                                       size_t window_size) {
+  size_t batch_idx = output_idx / num_outputs;
+  size_t out_idx = output_idx % num_outputs;
+  return (batch_idx * window_size + window_idx) * num_outputs + out_idx;
+}
+
+// @param xs: server share of X, values in [0,q]. Value j of output i is at
+// index j * num_outputs + i
+// @param xc: client share of X, values in [0,q], stored as xs
+// @param r: server share of output random mask, values in [0,q]
+// @param coeff_modulus: q
+// @param relu: whether to apply ReLU to each maximum
+// @param variant: construction of the adders and comparators, see
+// CircuitVariant
+// @brief Let x = (xs+xc)mod q, with x >= q/2 representing negative values.
+// Then, the circuit returns (m + r) mod q for m the maximum of each window
+// of x, or max(m, 0) if relu is set
+inline share* max_pool_aby(BooleanCircuit& circ, size_t num_outputs,
+                           size_t window_size, std::vector<uint64_t>& xs,
+                           std::vector<uint64_t>& xc, std::vector<uint64_t>& r,
+                           size_t bitlen, size_t coeff_modulus,
+                           bool relu = false,
+                           CircuitVariant variant = CircuitVariant::size) {
+  size_t num_vals = num_outputs * window_size;
+  NGRAPH_CHECK(window_size > 0, "MaxPool window is empty");
+  NGRAPH_CHECK(xs.size() == num_vals, "Wrong number of xs (got ", xs.size(),
+               ", expected ", num_vals, ")");
+  NGRAPH_CHECK(xc.size() == num_vals, "Wrong number of xc (got ", xc.size(),
+               ", expected ", num_vals, ")");
+  NGRAPH_CHECK(r.size() == num_outputs, "Wrong number of r (got ", r.size(),
+               ", expected ", num_outputs, ")");
+
+  size_t q = coeff_modulus;
+  size_t q_half = coeff_modulus / 2;
+  NGRAPH_HE_LOG(3) << "Creating new max pool aby circuit with q = " << q
+                   << ", " << num_outputs << " outputs of window size "
+                   << window_size << ", bitlen= " << bitlen;
+  check_argument_range(xs, 0UL, coeff_modulus);
+  check_argument_range(xc, 0UL, coeff_modulus);
+  check_argument_range(r, 0UL, coeff_modulus);
+
+  share* half_Q = circ.PutSIMDCONSGate(num_outputs, q_half, bitlen);
+  share* r_in = circ.PutSIMDINGate(num_outputs, r.data(), bitlen, SERVER);
+
+  // Shifting by q/2 maps (-q/2, q/2) to (0, q) preserving the order, so the
+  // shifted values are compared as unsigned integers
+  share* max_y = nullptr;
+  for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+    size_t offset = window_idx * num_outputs;
+    share* xs_in =
+        circ.PutSIMDINGate(num_outputs, xs.data() + offset, bitlen, SERVER);
+    share* xc_in =
+        circ.PutSIMDINGate(num_outputs, xc.data() + offset, bitlen, CLIENT);
+
+    share* x = reduce_mod(circ, put_add(circ, xs_in, xc_in, variant), q,
+                          num_outputs, variant);
+    share* y = reduce_mod(circ, put_add(circ, x, half_Q, variant), q,
+                          num_outputs, variant);
+    if (max_y == nullptr) {
+      max_y = y;
+    } else {
+      max_y = put_mux(circ, y, max_y, put_gt(circ, y, max_y, variant));
+    }
+  }
+
+  // Undo the shift
+  share* unshift = circ.PutSIMDCONSGate(num_outputs, q - q_half, bitlen);
+  share* x = reduce_mod(circ, put_add(circ, max_y, unshift, variant), q,
+                        num_outputs, variant);
+
+  if (relu) {
+    share* zero =
+        circ.PutSIMDCONSGate(num_outputs, static_cast<size_t>(0), bitlen);
+    x = put_mux(circ, zero, x, put_gt(circ, x, half_Q, variant));
+  }
+
+  // Additively mask output
+  x = put_add(circ, x, r_in, variant);
+  x = reduce_mod(circ, x, q, num_outputs, variant);
+
+  return circ.PutOUTGate(x, CLIENT);
+}
+
+}  // namespace ngraph::runtime::aby
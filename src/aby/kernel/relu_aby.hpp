@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "ENCRYPTO_utils/crypto/crypto.h"
@@ -35,13 +36,21 @@ namespace ngraph::runtime::aby {
 // @param xc: client share of X, values in [0,q]
 // @param rs: server share of output random mask, values in [0,q]
 // @param coeff_modulus: q
+// @param bound: b, bound of the ReLU in [0, q/2], or none
+// @param truncate_bits: t, number of bits by which the ReLU is divided
+// @param variant: construction of the adders and comparators, see
+// CircuitVariant
 // @brief Let x = (xs+xc)mod q; Then, the circuit returns
-//    rs              if x < q/2
-//   (x + rs) mod q   if x >= q/2
-inline share* relu_aby(BooleanCircuit& circ, size_t num_vals,
-                       std::vector<uint64_t>& xs, std::vector<uint64_t>& xc,
-                       std::vector<uint64_t>& r, size_t bitlen,
-                       size_t coeff_modulus) {
+//    rs                            if x < q/2
+//   (min(x, b) / 2^t + rs) mod q   if x >= q/2
+inline share* bounded_relu_aby(BooleanCircuit& circ, size_t num_vals,
+                               std::vector<uint64_t>& xs,
+                               std::vector<uint64_t>& xc,
+                               std::vector<uint64_t>& r, size_t bitlen,
+                               size_t coeff_modulus,
+                               std::optional<uint64_t> bound,
+                               size_t truncate_bits = 0,
+                               CircuitVariant variant = CircuitVariant::size) {
   NGRAPH_CHECK(xs.size() == num_vals, "Wrong number of xs (got ", xs.size(),
                ", expected ", num_vals, ")");
   NGRAPH_CHECK(xc.size() == num_vals, "Wrong number of xc (got ", xc.size(),
@@ -51,9 +60,12 @@ inline share* relu_aby(BooleanCircuit& circ, size_t num_vals,
 
   size_t q = coeff_modulus;
   size_t q_half = coeff_modulus / 2;
-  NGRAPH_HE_LOG(3) << "Creating new relu aby circuit with q = " << q
+  NGRAPH_HE_LOG(3) << "Creating new "
+                   << (bound.has_value() ? "bounded relu" : "relu")
+                   << " aby circuit with q = " << q
                    << ", q/2 = " << q_half << " and " << num_vals
-                   << " num vals, bitlen= " << bitlen;
+                   << " num vals, bitlen= " << bitlen
+                   << ", truncate_bits= " << truncate_bits;
   print_argument(xs, "xs");
   print_argument(xc, "xc");
   print_argument(r, "r");
@@ -66,26 +78,46 @@ inline share* relu_aby(BooleanCircuit& circ, size_t num_vals,
   share* xc_in = circ.PutSIMDINGate(num_vals, xc.data(), bitlen, CLIENT);
   share* r_in = circ.PutSIMDINGate(num_vals, r.data(), bitlen, SERVER);
 
-  share* Q = circ.PutSIMDCONSGate(num_vals, q, bitlen);
   share* zero = circ.PutSIMDCONSGate(num_vals, static_cast<size_t>(0), bitlen);
   share* half_Q = circ.PutSIMDCONSGate(num_vals, q_half, bitlen);
 
   // Reconstruct input x = (xs + xc) mod q
-  share* x = circ.PutADDGate(xs_in, xc_in);
-  x = reduce_mod(circ, x, Q);
+  share* x = put_add(circ, xs_in, xc_in, variant);
+  x = reduce_mod(circ, x, q, num_vals, variant);
 
   // Compute relu; note, x > q/2 means values are negative.
   // if x > q/2, x := 0
   // else: x := x
-  share* x_negative = circ.PutGTGate(x, half_Q);
-  x = circ.PutMUXGate(zero, x, x_negative);
+  x = put_mux(circ, zero, x, put_gt(circ, x, half_Q, variant));
+
+  // if x > b, x := b
+  if (bound.has_value()) {
+    NGRAPH_CHECK(*bound <= q_half, "Bound ", *bound, " exceeds q/2 = ",
+                 q_half);
+    share* bound_in = circ.PutSIMDCONSGate(num_vals, *bound, bitlen);
+    x = put_mux(circ, bound_in, x, put_gt(circ, x, bound_in, variant));
+  }
+
+  x = truncate_non_negative(circ, x, truncate_bits, num_vals);
 
   // Additively mask output
-  x = circ.PutADDGate(x, r_in);
-  x = reduce_mod(circ, x, Q);
+  x = put_add(circ, x, r_in, variant);
+  x = reduce_mod(circ, x, q, num_vals, variant);
 
   out = circ.PutOUTGate(x, CLIENT);
   return out;
 }
 
+// @brief Returns the circuit of bounded_relu_aby without a bound, i.e.
+//    rs                    if x < q/2
+//   (x / 2^t + rs) mod q   if x >= q/2
+inline share* relu_aby(BooleanCircuit& circ, size_t num_vals,
+                       std::vector<uint64_t>& xs, std::vector<uint64_t>& xc,
+                       std::vector<uint64_t>& r, size_t bitlen,
+                       size_t coeff_modulus, size_t truncate_bits = 0,
+                       CircuitVariant variant = CircuitVariant::size) {
+  return bounded_relu_aby(circ, num_vals, xs, xc, r, bitlen, coeff_modulus,
+                          std::nullopt, truncate_bits, variant);
+}
+
 }  // namespace ngraph::runtime::aby
@@ -16,11 +16,13 @@
 
 #include "he_plaintext.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "he_util.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
 #include "ngraph/except.hpp"
@@ -29,56 +31,18 @@ namespace ngraph::runtime::he {
 
 void HEPlaintext::write(void* target, const element::Type& element_type) {
   NGRAPH_CHECK(!empty(), "Input has no values");
-  size_t count = this->size();
-  size_t type_byte_size = element_type.size();
+  doubles_to_strided(data(), size(), target, element_type.size(),
+                     element_type);
+}
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wswitch-enum"
-  switch (element_type.get_type_enum()) {
-    case element::Type_t::f32: {
-      std::vector<float> float_values{begin(), end()};
-      auto type_values_src = static_cast<const void*>(float_values.data());
-      std::memcpy(target, type_values_src, type_byte_size * count);
-      break;
-    }
-    case element::Type_t::f64: {
-      auto type_values_src = static_cast<const void*>(this->data());
-      std::memcpy(target, type_values_src, type_byte_size * count);
-      break;
-    }
-    case element::Type_t::i32: {
-      std::vector<int32_t> int32_values(count);
-      for (size_t i = 0; i < count; ++i) {
-        int32_values[i] = std::round((*this)[i]);
-      }
-      auto type_values_src = static_cast<const void*>(int32_values.data());
-      std::memcpy(target, type_values_src, type_byte_size * count);
-      break;
-    }
-    case element::Type_t::i64: {
-      std::vector<int64_t> int64_values(count);
-      for (size_t i = 0; i < count; ++i) {
-        int64_values[i] = std::round((*this)[i]);
-      }
-      auto type_values_src = static_cast<const void*>(int64_values.data());
-      std::memcpy(target, type_values_src, type_byte_size * count);
-      break;
-    }
-    case element::Type_t::i8:
-    case element::Type_t::i16:
-    case element::Type_t::u1:
-    case element::Type_t::u8:
-    case element::Type_t::u16:
-    case element::Type_t::u32:
-    case element::Type_t::u64:
-    case element::Type_t::dynamic:
-    case element::Type_t::undefined:
-    case element::Type_t::bf16:
-    case element::Type_t::f16:
-    case element::Type_t::boolean:
-      NGRAPH_CHECK(false, "Unsupported element type ", element_type);
+void HEPlaintext::compact() {
+  if (size() <= 1 ||
+      !std::all_of(begin() + 1, end(),
+                   [this](double value) { return value == front(); })) {
+    return;
   }
-#pragma clang diagnostic pop
+  resize(1);
+  shrink_to_fit();
 }
 
 std::ostream& operator<<(std::ostream& os, const HEPlaintext& plain) {
@@ -23,7 +23,8 @@
 #include "ngraph/type/element_type.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Class representing a plaintext value
+/// \brief Class representing a plaintext value. A plaintext storing a single
+/// value is uniform, i.e. the value is broadcast across the batch
 
 class HEPlaintext : public absl::InlinedVector<double, 1> {
  public:
@@ -43,6 +44,23 @@ class HEPlaintext : public absl::InlinedVector<double, 1> {
     return std::vector<double>(begin(), end());
   }
 
+  /// \brief Returns whether or not the plaintext stores a single value,
+  /// which is broadcast across the batch
+  bool is_uniform() const { return size() == 1; }
+
+  /// \brief Returns the value at a batch index. Missing values are zero
+  /// \param[in] batch_idx Index in the batch
+  double batch_value(size_t batch_idx) const {
+    if (is_uniform()) {
+      return (*this)[0];
+    }
+    return batch_idx < size() ? (*this)[batch_idx] : 0;
+  }
+
+  /// \brief Stores the plaintext as a single, uniform value if all its
+  /// values are equal, releasing the heap storage of the other values
+  void compact();
+
   HEPlaintext& operator=(const HEPlaintext& v) = default;
 
   HEPlaintext& operator=(HEPlaintext&& v) = default;
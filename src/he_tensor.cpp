@@ -16,24 +16,35 @@
 
 #include "he_tensor.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "he_util.hpp"
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/descriptor/tensor.hpp"
 #include "ngraph/util.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/seal_huge_pages.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
+namespace {
+// Elements packed or unpacked together, see HETensor::pack
+constexpr size_t s_pack_block_size = 64;
+}  // namespace
+
 HETensor::HETensor(const element::Type& element_type, const Shape& shape,
                    bool plaintext_packing, bool complex_packing, bool encrypted,
                    seal::CKKSEncoder& ckks_encoder,
                    std::shared_ptr<seal::SEALContext> context,
                    const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
                    const HESealEncryptionParameters& encryption_params,
-                   const std::string& name)
+                   const std::string& name, bool initialize)
     : runtime::Tensor(
           std::make_shared<descriptor::Tensor>(element_type, shape, name)),
       m_packed(plaintext_packing),
@@ -56,26 +67,59 @@ HETensor::HETensor(const element::Type& element_type, const Shape& shape,
           ? m_descriptor->get_tensor_layout()->get_size() / get_batch_size()
           : 0;
 
-  if (encrypted) {
+  if (!initialize) {
+    // Empty plaintexts are stored inline, so only ciphertexts are allocated
+    m_data.resize(num_elements, HEType(HEPlaintext(), complex_packing));
+    if (encrypted) {
+      allocate_ciphertexts(complex_packing);
+    }
+  } else if (encrypted) {
     for (size_t i = 0; i < num_elements; ++i) {
       m_data.emplace_back(HESealBackend::create_empty_ciphertext(),
                           complex_packing, get_batch_size());
     }
   } else {
-    m_data.resize(num_elements,
-                  HEType(HEPlaintext(get_batch_size()), complex_packing));
+    // Zeros are stored as uniform plaintexts, see HEPlaintext::is_uniform
+    m_data.resize(num_elements, HEType(HEPlaintext(1), complex_packing));
   }
 }
 
 HETensor::HETensor(const element::Type& element_type, const Shape& shape,
                    bool plaintext_packing, bool complex_packing, bool encrypted,
                    const HESealBackend& he_seal_backend,
-                   const std::string& name)
+                   const std::string& name, bool initialize)
     : HETensor(element_type, shape, plaintext_packing, complex_packing,
                encrypted, *he_seal_backend.get_ckks_encoder(),
                he_seal_backend.get_context(), *he_seal_backend.get_encryptor(),
                *he_seal_backend.get_decryptor(),
-               he_seal_backend.get_encryption_parameters(), name) {}
+               he_seal_backend.get_encryption_parameters(), name, initialize) {}
+
+void HETensor::allocate_ciphertexts(bool complex_packing) {
+  size_t batch_size = get_batch_size();
+  parallel_for_seal(m_data.size(), 1, [&](size_t i) {
+    m_data[i] =
+        HEType(HESealBackend::create_empty_ciphertext(), complex_packing,
+               batch_size);
+  });
+}
+
+std::shared_ptr<HETensor> HETensor::deep_copy() const {
+  bool complex_packing = !m_data.empty() && m_data[0].complex_packing();
+  auto copy = std::make_shared<HETensor>(
+      get_element_type(), get_shape(), m_packed, complex_packing, false,
+      m_ckks_encoder, m_context, m_encryptor, m_decryptor,
+      m_encryption_params, get_name(), false);
+  copy->m_data = m_data;
+  parallel_for_seal(m_data.size(), 1, [&](size_t i) {
+    if (m_data[i].is_ciphertext()) {
+      copy->m_data[i].replace_ciphertext(
+          std::make_shared<SealCiphertextWrapper>(
+              *m_data[i].get_ciphertext()));
+    }
+  });
+  copy->m_write_count = m_write_count;
+  return copy;
+}
 
 Shape HETensor::pack_shape(const Shape& shape, size_t pack_axis) {
   if (pack_axis != 0) {
@@ -109,25 +153,38 @@ void HETensor::pack(size_t pack_axis) {
   NGRAPH_CHECK(!any_encrypted_data(),
                "Packing only supported for plaintext tensors");
 
-  m_packed = true;
-  std::vector<HEType> new_data(m_data.size() / get_batch_size(),
-                               HEType(HEPlaintext(), false));
-  std::vector<HEPlaintext> new_plaintexts(new_data.size());
-
-  for (size_t idx = 0; idx < m_data.size(); ++idx) {
-    auto& plain = m_data[idx].get_plaintext();
-    if (!plain.empty()) {
-      size_t new_idx = idx % new_data.size();
-      new_plaintexts[new_idx].emplace_back(plain[0]);
-      new_data[new_idx].complex_packing() = m_data[idx].complex_packing();
+  size_t batch_size = HETensor::batch_size(get_shape(), true);
+  size_t packed_count = batch_size == 0 ? 0 : m_data.size() / batch_size;
+
+  // Element j of the packed tensor gathers element j of each batch. The
+  // elements of the first batch are packed in place, and the others are
+  // read a block at a time, batch by batch, so each batch is read
+  // sequentially while the block's packed values stay in cache
+  size_t num_blocks = ceil_div(packed_count, s_pack_block_size);
+  size_t grain_size = std::max<size_t>(
+      1, s_min_parallel_work / std::max<size_t>(
+                                   s_pack_block_size * batch_size, 1));
+  parallel_for_seal(num_blocks, grain_size, [&](size_t block_idx) {
+    size_t begin = block_idx * s_pack_block_size;
+    size_t end = std::min(begin + s_pack_block_size, packed_count);
+    for (size_t idx = begin; idx < end; ++idx) {
+      m_data[idx].get_plaintext().resize(batch_size);
     }
-  }
-
-  for (size_t idx = 0; idx < new_data.size(); ++idx) {
-    new_data[idx].set_plaintext(new_plaintexts[idx]);
-  }
+    for (size_t batch_idx = 1; batch_idx < batch_size; ++batch_idx) {
+      const HEType* batch = &m_data[batch_idx * packed_count];
+      for (size_t idx = begin; idx < end; ++idx) {
+        const auto& plain = batch[idx].get_plaintext();
+        m_data[idx].get_plaintext()[batch_idx] = plain.empty() ? 0 : plain[0];
+      }
+    }
+    for (size_t idx = begin; idx < end; ++idx) {
+      HEPlaintext plain = std::move(m_data[idx].get_plaintext());
+      plain.compact();
+      m_data[idx].set_plaintext(std::move(plain));
+    }
+  });
 
-  m_data = std::move(new_data);
+  m_data.resize(packed_count, HEType(HEPlaintext(), false));
   m_packed = true;
   m_packed_shape = HETensor::pack_shape(get_shape());
 }
@@ -140,15 +197,28 @@ void HETensor::unpack() {
                "Unpacking only supported for plaintext tensors");
 
   size_t old_batch_size = get_batch_size();
+  size_t packed_count = m_data.size();
   m_packed = false;
-  std::vector<HEType> new_data;
-  for (size_t batch_idx = 0; batch_idx < old_batch_size; ++batch_idx) {
-    for (auto& data : m_data) {
-      auto& plain = data.get_plaintext();
-      new_data.emplace_back(
-          HEPlaintext({static_cast<double>(plain[batch_idx])}), false);
+
+  // Unpacked plaintexts store their single value inline, so filling the
+  // presized data allocates nothing per element
+  std::vector<HEType> new_data(old_batch_size * packed_count,
+                               HEType(HEPlaintext(1), false));
+  size_t num_blocks = ceil_div(packed_count, s_pack_block_size);
+  size_t grain_size = std::max<size_t>(
+      1, s_min_parallel_work / std::max<size_t>(
+                                   s_pack_block_size * old_batch_size, 1));
+  parallel_for_seal(num_blocks, grain_size, [&](size_t block_idx) {
+    size_t begin = block_idx * s_pack_block_size;
+    size_t end = std::min(begin + s_pack_block_size, packed_count);
+    for (size_t batch_idx = 0; batch_idx < old_batch_size; ++batch_idx) {
+      HEType* batch = &new_data[batch_idx * packed_count];
+      for (size_t idx = begin; idx < end; ++idx) {
+        batch[idx].get_plaintext()[0] =
+            m_data[idx].get_plaintext().batch_value(batch_idx);
+      }
     }
-  }
+  });
   m_data = std::move(new_data);
   m_packed_shape = get_shape();
 }
@@ -175,7 +245,44 @@ bool HETensor::any_encrypted_data() const {
   });
 }
 
+bool HETensor::all_encrypted_data() const {
+  return std::all_of(m_data.begin(), m_data.end(), [](const HEType& he_type) {
+    return he_type.is_ciphertext();
+  });
+}
+
+size_t HETensor::ciphertext_byte_count() const {
+  size_t byte_count = 0;
+  for (const auto& he_type : m_data) {
+    if (he_type.is_ciphertext() && he_type.get_ciphertext() != nullptr) {
+      const auto& cipher = he_type.get_ciphertext()->ciphertext();
+      byte_count += cipher.size() * cipher.poly_modulus_degree() *
+                    cipher.coeff_modulus_size() * sizeof(uint64_t);
+    }
+  }
+  return byte_count;
+}
+
+void HETensor::advise_huge_pages() const {
+  std::vector<std::pair<uintptr_t, size_t>> ranges;
+  ranges.reserve(m_data.size());
+  for (const auto& he_type : m_data) {
+    if (he_type.is_ciphertext() && he_type.get_ciphertext() != nullptr) {
+      const auto& cipher = he_type.get_ciphertext()->ciphertext();
+      ranges.emplace_back(reinterpret_cast<uintptr_t>(cipher.data()),
+                          cipher.size() * cipher.poly_modulus_degree() *
+                              cipher.coeff_modulus_size() * sizeof(uint64_t));
+    }
+  }
+  he::advise_huge_pages(ranges);
+}
+
 void HETensor::check_io_bounds(size_t n) const {
+  check_io_bounds(n, get_tensor_layout()->get_element_type());
+}
+
+void HETensor::check_io_bounds(size_t n,
+                               const element::Type& element_type) const {
   size_t bytes_per_element = n;
   if (get_batch_size() == 0) {
     NGRAPH_CHECK(n == 0, "I/O access past end of tensor");
@@ -183,7 +290,6 @@ void HETensor::check_io_bounds(size_t n) const {
     bytes_per_element /= get_batch_size();
   }
 
-  const element::Type& element_type = get_tensor_layout()->get_element_type();
   size_t type_byte_size = element_type.size();
 
   // Memory must be byte-aligned to type_byte_size
@@ -197,111 +303,225 @@ void HETensor::check_io_bounds(size_t n) const {
 }
 
 void HETensor::write(const void* p, size_t n) {
-  check_io_bounds(n);
+  write_elements(p, n, 0, num_io_elements(n));
+}
 
-  const element::Type& element_type = get_tensor_layout()->get_element_type();
-  size_t type_byte_size = element_type.size();
+void HETensor::write_seeded(const void* p, size_t n,
+                            const seal::Encryptor& secret_key_encryptor,
+                            seal::compr_mode_type compr_mode) {
+  write_elements(p, n, 0, num_io_elements(n), &secret_key_encryptor,
+                 compr_mode);
+}
 
-  size_t num_elements_to_write = n / element_type.size();
+size_t HETensor::num_io_elements(size_t n) const {
+  size_t num_elements = n / get_element_type().size();
   if (get_batch_size() != 0) {
-    num_elements_to_write /= get_batch_size();
+    num_elements /= get_batch_size();
   }
+  return num_elements;
+}
 
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t i = 0; i < num_elements_to_write; ++i) {
-    HEPlaintext plain(get_batch_size());
-    for (size_t j = 0; j < get_batch_size(); ++j) {
-      const auto* src = static_cast<const void*>(
-          static_cast<const char*>(p) +
-          type_byte_size * (i + j * num_elements_to_write));
-      plain[j] = type_to_double(src, element_type);
-    }
+void HETensor::write_elements(const void* p, size_t n, size_t begin,
+                              size_t end,
+                              const seal::Encryptor* seeded_encryptor,
+                              seal::compr_mode_type compr_mode) {
+  check_io_bounds(n);
+
+  const element::Type& element_type = get_tensor_layout()->get_element_type();
+  size_t type_byte_size = element_type.size();
 
-    if (m_data[i].is_plaintext()) {
-      m_data[i].set_plaintext(plain);
-    } else {
-      NGRAPH_CHECK(m_data[i].is_ciphertext(),
-                   "Cannot write into tensor of unspecified type");
-      auto cipher = HESealBackend::create_empty_ciphertext();
-
-      encrypt(cipher, plain, m_context->first_parms_id(), element_type,
-              m_encryption_params.scale(), m_ckks_encoder, m_encryptor,
-              m_data[i].complex_packing());
-      m_data[i].set_ciphertext(cipher);
+  size_t num_elements_to_write = num_io_elements(n);
+  NGRAPH_CHECK(begin <= end && end <= num_elements_to_write,
+               "Invalid range [", begin, ", ", end, ") of ",
+               num_elements_to_write, " elements");
+
+  // The batch values of element i are num_elements_to_write elements apart
+  size_t batch_stride = type_byte_size * num_elements_to_write;
+
+#pragma omp parallel
+  {
+    // Encrypts directly from p into the existing ciphertexts, with
+    // plaintext buffers reused across the elements of each thread
+    HECodecScratch scratch;
+
+#pragma omp for
+    // NOLINTNEXTLINE
+    for (size_t i = begin; i < end; ++i) {
+      const auto* src = static_cast<const void*>(static_cast<const char*>(p) +
+                                                 type_byte_size * i);
+      if (m_data[i].is_ciphertext() && seeded_encryptor == nullptr) {
+        auto& cipher = m_data[i].get_ciphertext();
+        // Ciphertexts shared with other tensors are not overwritten
+        if (cipher == nullptr || cipher.use_count() != 1 ||
+            cipher->is_seeded()) {
+          cipher = HESealBackend::create_empty_ciphertext();
+        }
+        encrypt_strided(cipher->ciphertext(), src, batch_stride,
+                        get_batch_size(), element_type,
+                        m_context->first_parms_id(),
+                        m_encryption_params.scale(), m_ckks_encoder,
+                        m_encryptor, m_data[i].complex_packing(), scratch);
+        continue;
+      }
+
+      HEPlaintext plain(get_batch_size());
+      strided_to_doubles(src, batch_stride, get_batch_size(), element_type,
+                         plain.data());
+
+      if (m_data[i].is_plaintext()) {
+        plain.compact();
+        m_data[i].set_plaintext(std::move(plain));
+      } else {
+        NGRAPH_CHECK(m_data[i].is_ciphertext(),
+                     "Cannot write into tensor of unspecified type");
+        auto cipher = HESealBackend::create_empty_ciphertext();
+        encrypt_seeded(cipher, plain, m_context->first_parms_id(),
+                       element_type, m_encryption_params.scale(),
+                       m_ckks_encoder, *seeded_encryptor,
+                       m_data[i].complex_packing(), compr_mode);
+        m_data[i].set_ciphertext(cipher);
+      }
     }
   }
-  m_write_count += num_elements_to_write;
+  m_write_count += end - begin;
 }
 
 void HETensor::read(void* p, size_t n) const {
-  check_io_bounds(n);
-  const element::Type& element_type = get_tensor_layout()->get_element_type();
+  read(p, n, get_tensor_layout()->get_element_type());
+}
+
+void HETensor::read(void* p, size_t n,
+                    const element::Type& element_type) const {
+  check_io_bounds(n, element_type);
   size_t type_byte_size = element_type.size();
   size_t num_elements_to_read = n / (type_byte_size * get_batch_size());
 
-  auto copy_batch_values_to_src = [&](size_t element_idx, void* copy_target,
-                                      const void* type_values_src) {
-    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
-    auto* src = static_cast<char*>(const_cast<void*>(type_values_src));
-    for (size_t j = 0; j < get_batch_size(); ++j) {
-      auto* dst_with_offset = static_cast<void*>(
-          static_cast<char*>(copy_target) +
-          type_byte_size * (element_idx + j * num_elements_to_read));
-      std::memcpy(dst_with_offset, src, type_byte_size);
-      src += type_byte_size;
-    }
-  };
-
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t i = 0; i < num_elements_to_read; ++i) {
-    HEPlaintext plain;
-    if (m_data[i].is_ciphertext()) {
-      decrypt(plain, *m_data[i].get_ciphertext(), m_data[i].complex_packing(),
-              m_decryptor, m_ckks_encoder, m_context, m_data[i].batch_size());
-    } else {
-      plain = m_data[i].get_plaintext();
+  // The batch values of element i are num_elements_to_read elements apart
+  size_t batch_stride = type_byte_size * num_elements_to_read;
+
+#pragma omp parallel
+  {
+    // Decrypts directly into p, with plaintext buffers reused across the
+    // elements of each thread
+    HECodecScratch scratch;
+
+#pragma omp for
+    // NOLINTNEXTLINE
+    for (size_t i = 0; i < num_elements_to_read; ++i) {
+      auto* dst = static_cast<char*>(p) + type_byte_size * i;
+      if (m_data[i].is_ciphertext()) {
+        decrypt_strided(dst, batch_stride, get_batch_size(), element_type,
+                        *m_data[i].get_ciphertext(),
+                        m_data[i].complex_packing(), m_decryptor,
+                        m_ckks_encoder, m_context, scratch,
+                        m_data[i].pending_factor());
+      } else {
+        const HEPlaintext& plain = m_data[i].get_plaintext();
+        const double* values = plain.data();
+        if (plain.size() < get_batch_size()) {
+          scratch.values.resize(get_batch_size());
+          for (size_t j = 0; j < get_batch_size(); ++j) {
+            scratch.values[j] = plain.batch_value(j);
+          }
+          values = scratch.values.data();
+        }
+        doubles_to_strided(values, get_batch_size(), dst, batch_stride,
+                           element_type);
+      }
     }
+  }
+}
 
-    void* dst = ngraph_malloc(type_byte_size * get_batch_size());
-    plain.resize(get_batch_size());
-    plain.write(dst, element_type);
-
-    copy_batch_values_to_src(i, p, dst);
+size_t HETensor::serialized_element_size(
+    size_t index, bool with_segment, seal::compr_mode_type compr_mode) const {
+  const HEType& he_type = m_data[index];
+  pb::HEType tmp_type;
+  TCPMessage::Segment tmp_segment;
+  he_type.save(tmp_type, with_segment ? &tmp_segment : nullptr, compr_mode);
+
+  size_t he_type_size = tmp_type.ByteSize() + tmp_segment.size;
+  if (compr_mode != seal::compr_mode_type::none && he_type.is_ciphertext() &&
+      !he_type.get_ciphertext()->is_seeded()) {
+    // Compressed sizes vary between ciphertexts, so use the upper bound
+    he_type_size +=
+        ciphertext_size(he_type.get_ciphertext()->ciphertext(), compr_mode) -
+        tmp_type.ciphertext().size();
+  }
+  return he_type_size;
+}
 
-    ngraph_free(dst);
+void HETensor::write_to_pb_tensor_frames(
+    size_t max_frame_bytes,
+    const std::function<void(pb::HETensor&&, TCPMessage::Segments&&)>&
+        write_frame,
+    seal::compr_mode_type compr_mode) const {
+  size_t num_elements = m_data.size();
+  size_t frame_size = 1;
+  if (num_elements > 0) {
+    frame_size = std::max<size_t>(
+        1, max_frame_bytes / serialized_element_size(0, true, compr_mode));
   }
+  NGRAPH_HE_LOG(5) << "Writing tensor in frames of " << frame_size
+                   << " elements";
+
+  size_t begin = 0;
+  // An empty tensor is still written as a single, empty frame
+  do {
+    size_t end = std::min(begin + frame_size, num_elements);
+    std::vector<TCPMessage::Segments> segments;
+    auto pb_tensors =
+        write_elements_to_pb_tensors(begin, end, &segments, compr_mode);
+    for (size_t tensor_idx = 0; tensor_idx < pb_tensors.size();
+         ++tensor_idx) {
+      write_frame(std::move(pb_tensors[tensor_idx]),
+                  std::move(segments[tensor_idx]));
+    }
+    begin = end;
+  } while (begin < num_elements);
 }
 
-std::vector<pb::HETensor> HETensor::write_to_pb_tensors() const {
+std::vector<pb::HETensor> HETensor::write_elements_to_pb_tensors(
+    size_t begin, size_t end, std::vector<TCPMessage::Segments>* segments,
+    seal::compr_mode_type compr_mode) const {
+  NGRAPH_CHECK(begin <= end && end <= m_data.size(), "Invalid range [", begin,
+               ", ", end, ") of ", m_data.size(), " elements");
+  size_t count = end - begin;
   std::vector<pb::HETensor> pb_tensors(1);
+  if (segments != nullptr) {
+    segments->assign(1, {});
+  }
   // Populate attributes of tensor to estimate byte size
   pb_tensors[0].set_name(get_name());
   std::vector<uint64_t> int_shape{get_shape()};
   *pb_tensors[0].mutable_shape() = {int_shape.begin(), int_shape.end()};
   pb_tensors[0].set_type(type_to_pb_type(get_element_type()));
   pb_tensors[0].set_packed(m_packed);
-  pb_tensors[0].set_offset(0);
+  pb_tensors[0].set_offset(begin);
 
   NGRAPH_HE_LOG(5) << "Writing tensor shape " << get_shape();
 
-  if (!m_data.empty()) {
-    pb::HEType tmp_type;
-    m_data[0].save(tmp_type);
-
-    size_t he_type_size = tmp_type.ByteSize();
+  if (count > 0) {
+    // Payload segments are not subject to the protobuf size limit, but are
+    // included to bound the size of each message
+    size_t he_type_size =
+        serialized_element_size(begin, segments != nullptr, compr_mode);
     size_t max_num_data_per_tensor =
         std::floor(std::numeric_limits<int32_t>::max() /
                    static_cast<float>(he_type_size)) -
         2;
 
-    size_t num_tensors = m_data.size() / max_num_data_per_tensor;
-    if (m_data.size() % max_num_data_per_tensor != 0) {
+    size_t num_tensors = count / max_num_data_per_tensor;
+    if (count % max_num_data_per_tensor != 0) {
       num_tensors++;
     }
     pb_tensors.resize(num_tensors);
+    std::vector<TCPMessage::Segment> data_segments;
+    if (segments != nullptr) {
+      segments->resize(num_tensors);
+      data_segments.resize(count);
+    }
 
+    // Offset of the current proto tensor's first object within the range
     size_t offset = 0;
 
     for (size_t tensor_idx = 0; tensor_idx < num_tensors; ++tensor_idx) {
@@ -310,13 +530,12 @@ std::vector<pb::HETensor> HETensor::write_to_pb_tensors() const {
                                                  int_shape.end()};
       pb_tensors[tensor_idx].set_type(type_to_pb_type(get_element_type()));
       pb_tensors[tensor_idx].set_packed(m_packed);
-      pb_tensors[tensor_idx].set_offset(offset);
+      pb_tensors[tensor_idx].set_offset(begin + offset);
 
       auto* mutable_data = pb_tensors[tensor_idx].mutable_data();
       size_t num_data_in_tensor = max_num_data_per_tensor;
       if (tensor_idx == num_tensors - 1) {
-        num_data_in_tensor =
-            m_data.size() - tensor_idx * max_num_data_per_tensor;
+        num_data_in_tensor = count - tensor_idx * max_num_data_per_tensor;
       }
       for (size_t data_idx = 0; data_idx < num_data_in_tensor; ++data_idx) {
         mutable_data->Add();
@@ -326,7 +545,27 @@ std::vector<pb::HETensor> HETensor::write_to_pb_tensors() const {
       // NOLINTNEXTLINE
       for (size_t data_idx = 0; data_idx < num_data_in_tensor; ++data_idx) {
         size_t data_offset = offset + data_idx;
-        m_data[data_offset].save(*mutable_data->Mutable(data_idx));
+        m_data[begin + data_offset].save(
+            *mutable_data->Mutable(data_idx),
+            segments != nullptr ? &data_segments[data_offset] : nullptr,
+            compr_mode);
+      }
+
+      if (segments != nullptr) {
+        // Ciphertext data is laid out in the payload in data order
+        auto& tensor_segments = (*segments)[tensor_idx];
+        size_t payload_offset = 0;
+        for (size_t data_idx = 0; data_idx < num_data_in_tensor; ++data_idx) {
+          auto& segment = data_segments[offset + data_idx];
+          if (segment.data == nullptr) {
+            continue;
+          }
+          mutable_data->Mutable(data_idx)
+              ->mutable_ciphertext_header()
+              ->set_payload_offset(payload_offset);
+          payload_offset += segment.size;
+          tensor_segments.emplace_back(std::move(segment));
+        }
       }
       offset += num_data_in_tensor;
     }
@@ -339,7 +578,8 @@ std::shared_ptr<HETensor> HETensor::load_from_pb_tensors(
     seal::CKKSEncoder& ckks_encoder,
     const std::shared_ptr<seal::SEALContext>& context,
     const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-    const HESealEncryptionParameters& encryption_params) {
+    const HESealEncryptionParameters& encryption_params, const char* payload,
+    size_t payload_size, bool trusted) {
   NGRAPH_CHECK(pb_tensors.size() == 1,
                "load_from_pb_tensors only supports 1 proto");
 
@@ -356,12 +596,13 @@ std::shared_ptr<HETensor> HETensor::load_from_pb_tensors(
       false, ckks_encoder, context, encryptor, decryptor, encryption_params,
       pb_name);
 
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    const auto& loaded = HEType::load(pb_tensor.data(result_idx), context);
-    he_tensor->data(result_idx) = loaded;
-  }
+  // Statically partitioned like the kernels, so with NUMA-aware
+  // parallelism each ciphertext is first touched on the socket using it
+  parallel_for_seal(result_count, 1, [&](size_t result_idx) {
+    he_tensor->data(pb_tensor.offset() + result_idx) =
+        HEType::load(pb_tensor.data(result_idx), context, payload,
+                     payload_size, trusted);
+  });
   he_tensor->m_write_count += result_count;
 
   return he_tensor;
@@ -369,7 +610,8 @@ std::shared_ptr<HETensor> HETensor::load_from_pb_tensors(
 
 void HETensor::load_from_pb_tensor(
     std::shared_ptr<HETensor>& he_tensor, const pb::HETensor& pb_tensor,
-    const std::shared_ptr<seal::SEALContext>& context) {
+    const std::shared_ptr<seal::SEALContext>& context, const char* payload,
+    size_t payload_size, bool trusted) {
   const auto& pb_name = pb_tensor.name();
   const auto& pb_packed = pb_tensor.packed();
   const auto& pb_shape = pb_tensor.shape();
@@ -386,12 +628,13 @@ void HETensor::load_from_pb_tensor(
                "HETensor has wrong packing ", he_tensor->is_packed(),
                ", expected ", pb_packed);
 
-#pragma omp parallel for
-  // NOLINTNEXTLINE
-  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    const auto& loaded = HEType::load(pb_tensor.data(result_idx), context);
-    he_tensor->data(pb_offset + result_idx) = loaded;
-  }
+  // Statically partitioned like the kernels, so with NUMA-aware
+  // parallelism each ciphertext is first touched on the socket using it
+  parallel_for_seal(result_count, 1, [&](size_t result_idx) {
+    he_tensor->data(pb_offset + result_idx) =
+        HEType::load(pb_tensor.data(result_idx), context, payload,
+                     payload_size, trusted);
+  });
   he_tensor->m_write_count += result_count;
 }
 
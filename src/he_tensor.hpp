@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -27,6 +28,7 @@
 #include "protos/message.pb.h"
 #include "seal/he_seal_encryption_parameters.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "tcp/tcp_message.hpp"
 
 namespace ngraph::runtime::he {
 class HESealBackend;
@@ -49,13 +51,17 @@ class HETensor : public runtime::Tensor {
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
   /// \param[in] name Name of the tensor
+  /// \param[in] initialize Whether or not plaintexts are initialized to
+  /// zero. Otherwise, plaintexts are empty and only ciphertexts are
+  /// allocated, for tensors whose every value is overwritten, e.g. kernel
+  /// outputs
   HETensor(const element::Type& element_type, const Shape& shape,
            bool plaintext_packing, bool complex_packing, bool encrypted,
            seal::CKKSEncoder& ckks_encoder,
            std::shared_ptr<seal::SEALContext> context,
            const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
            const HESealEncryptionParameters& encryption_params,
-           const std::string& name = "external");
+           const std::string& name = "external", bool initialize = true);
 
   /// \brief Constructs a generic HETensor
   /// \param[in] element_type Datatype of data stored in the tensor
@@ -67,21 +73,58 @@ class HETensor : public runtime::Tensor {
   /// \param[in] encrypted Whether or not tensor is initialized with ciphertexts
   /// \param[in] he_seal_backend Backend used for encryption and decryption
   /// \param[in] name Name of the tensor
+  /// \param[in] initialize Whether or not plaintexts are initialized to
+  /// zero, see above
   HETensor(const element::Type& element_type, const Shape& shape,
            bool plaintext_packing, bool complex_packing, bool encrypted,
            const HESealBackend& he_seal_backend,
-           const std::string& name = "external");
+           const std::string& name = "external", bool initialize = true);
 
   /// \brief Write bytes directly into the tensor
   /// \param[in] p Pointer to source of data
   /// \param[in] n Number of bytes to write, must be integral number of elements
   void write(const void* p, size_t n) override;
 
+  /// \brief Write bytes into the tensor, encrypting ciphertexts using
+  /// secret-key encryption in seeded form. Seeded ciphertexts can only be
+  /// serialized, e.g. by write_to_pb_tensors, and not computed on
+  /// \param[in] p Pointer to source of data
+  /// \param[in] n Number of bytes to write, must be integral number of elements
+  /// \param[in] secret_key_encryptor Encryptor with a secret key set
+  /// \param[in] compr_mode Compression mode to serialize ciphertexts with
+  void write_seeded(
+      const void* p, size_t n, const seal::Encryptor& secret_key_encryptor,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none);
+
+  /// \brief Writes a range of the tensor's ciphertext / plaintext objects
+  /// from bytes storing the entire tensor, so a tensor can be encrypted and
+  /// serialized in chunks
+  /// \param[in] p Pointer to source of data
+  /// \param[in] n Number of bytes of the entire tensor
+  /// \param[in] begin Index of the first object to write
+  /// \param[in] end Index past the last object to write
+  /// \param[in] seeded_encryptor If not nullptr, ciphertexts are encrypted
+  /// in seeded form using this secret-key encryptor, as in write_seeded
+  /// \param[in] compr_mode Compression mode to serialize seeded ciphertexts
+  /// with
+  void write_elements(
+      const void* p, size_t n, size_t begin, size_t end,
+      const seal::Encryptor* seeded_encryptor = nullptr,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none);
+
   /// \brief Read bytes directly from the tensor
   /// \param[out] p Pointer to destination for data
   /// \param[in] n Number of bytes to read, must be integral number of elements.
   void read(void* p, size_t n) const override;
 
+  /// \brief Read values directly from the tensor, converted to the given
+  /// element type. Ciphertexts are decrypted straight into the destination
+  /// \param[out] p Pointer to destination for data
+  /// \param[in] n Number of bytes to read, must be integral number of elements
+  /// of element_type
+  /// \param[in] element_type Datatype to write the destination as
+  void read(void* p, size_t n, const element::Type& element_type) const;
+
   /// \brief Reduces shape along pack axis
   /// \param[in] shape Input shape to pack
   /// \param[in] pack_axis Axis along which to pack
@@ -111,6 +154,16 @@ class HETensor : public runtime::Tensor {
 
   bool any_encrypted_data() const;
 
+  /// \brief Returns whether every element of the tensor is encrypted
+  bool all_encrypted_data() const;
+
+  /// \brief Returns the number of bytes of the tensor's ciphertext data
+  size_t ciphertext_byte_count() const;
+
+  /// \brief Advises the kernel to back the tensor's ciphertext data by
+  /// transparent huge pages, see advise_huge_pages
+  void advise_huge_pages() const;
+
   /// \brief Returns the batch size of a given shape
   /// \param[in] shape Shape of the tensor
   /// \param[in] packed Whether or not batch-axis packing is used
@@ -131,8 +184,47 @@ class HETensor : public runtime::Tensor {
   /// \brief Writes the tensor to a vector of proto tensors.
   /// Due to the 2GB limit on protobufs, large ciphertext tensors may not be
   /// able to store the entire tensor in one SealCipherTensor message.
+  /// \param[out] segments If not nullptr, ciphertext data is not copied into
+  /// the proto tensors. Instead, segments[i] stores the payload segments to
+  /// send alongside the i'th proto tensor
+  /// \param[in] compr_mode Compression mode to serialize ciphertexts with.
+  /// Compressed ciphertexts are stored in the proto tensors, leaving the
+  /// segments empty
   /// returns vector of pb_tensors
-  std::vector<pb::HETensor> write_to_pb_tensors() const;
+  std::vector<pb::HETensor> write_to_pb_tensors(
+      std::vector<TCPMessage::Segments>* segments = nullptr,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none) const {
+    return write_elements_to_pb_tensors(0, m_data.size(), segments,
+                                        compr_mode);
+  }
+
+  /// \brief Serializes the tensor as a sequence of proto tensors of bounded
+  /// size. Each frame is generated only once the previous frame has been
+  /// passed to write_frame, so the full serialized tensor is never held in
+  /// memory if write_frame applies backpressure
+  /// \param[in] max_frame_bytes Approximate maximum number of bytes of each
+  /// frame, including its payload segments. Each frame stores at least one
+  /// object
+  /// \param[in] write_frame Consumes a proto tensor and its payload segments
+  /// \param[in] compr_mode Compression mode to serialize ciphertexts with
+  void write_to_pb_tensor_frames(
+      size_t max_frame_bytes,
+      const std::function<void(pb::HETensor&&, TCPMessage::Segments&&)>&
+          write_frame,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none) const;
+
+  /// \brief Writes a range of the tensor's ciphertext / plaintext objects to
+  /// a vector of proto tensors, whose offsets locate the objects in the
+  /// tensor, as write_to_pb_tensors
+  /// \param[in] begin Index of the first object to write
+  /// \param[in] end Index past the last object to write
+  /// \param[out] segments If not nullptr, stores the payload segments of
+  /// each proto tensor, as in write_to_pb_tensors
+  /// \param[in] compr_mode Compression mode to serialize ciphertexts with
+  std::vector<pb::HETensor> write_elements_to_pb_tensors(
+      size_t begin, size_t end,
+      std::vector<TCPMessage::Segments>* segments = nullptr,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none) const;
 
   /// \brief Loads a tensor from protobuf tensors
   /// \param[in] pb_tensors vector of protobuf tensors to load from
@@ -142,13 +234,19 @@ class HETensor : public runtime::Tensor {
   /// \param[in] decryptor SEAL decryptor to associate with loaded tensor
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
+  /// \param[in] payload Payload of the message storing pb_tensors
+  /// \param[in] payload_size Size in bytes of the payload
+  /// \param[in] trusted Whether or not ciphertexts are loaded without
+  /// validating their data, see SealCiphertextWrapper::load
   /// \returns Pointer to loaded tensor
   static std::shared_ptr<HETensor> load_from_pb_tensors(
       const std::vector<pb::HETensor>& pb_tensors,
       seal::CKKSEncoder& ckks_encoder,
       const std::shared_ptr<seal::SEALContext>& context,
       const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-      const HESealEncryptionParameters& encryption_params);
+      const HESealEncryptionParameters& encryption_params,
+      const char* payload = nullptr, size_t payload_size = 0,
+      bool trusted = false);
 
   /// \brief Loads a tensor from protobuf tensor
   /// \param[in] pb_tensor protobuf tensor to load from
@@ -158,27 +256,54 @@ class HETensor : public runtime::Tensor {
   /// \param[in] decryptor SEAL decryptor to associate with loaded tensor
   /// \param[in] encryption_params Encryption parameters to associate with
   /// loaded tensor
+  /// \param[in] payload Payload of the message storing pb_tensor
+  /// \param[in] payload_size Size in bytes of the payload
+  /// \param[in] trusted Whether or not ciphertexts are loaded without
+  /// validating their data, see SealCiphertextWrapper::load
   /// \returns Pointer to loaded tensor
   static std::shared_ptr<HETensor> load_from_pb_tensor(
       const pb::HETensor& pb_tensor, seal::CKKSEncoder& ckks_encoder,
       const std::shared_ptr<seal::SEALContext>& context,
       const seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-      const HESealEncryptionParameters& encryption_params) {
+      const HESealEncryptionParameters& encryption_params,
+      const char* payload = nullptr, size_t payload_size = 0,
+      bool trusted = false) {
     return load_from_pb_tensors({pb_tensor}, ckks_encoder, context, encryptor,
-                                decryptor, encryption_params);
+                                decryptor, encryption_params, payload,
+                                payload_size, trusted);
   }
 
   /// \brief Loads a tensor from protobuf tensor to an he_tensor
   /// \param[in] he_tensor Tensor to load to
   /// \param[in] pb_tensor protobuf tensor to load from
   /// \param[in] context SEAL context to associate with loaded tensor
+  /// \param[in] payload Payload of the message storing pb_tensor
+  /// \param[in] payload_size Size in bytes of the payload
+  /// \param[in] trusted Whether or not ciphertexts are loaded without
+  /// validating their data, see SealCiphertextWrapper::load
   static void load_from_pb_tensor(
       std::shared_ptr<HETensor>& he_tensor, const pb::HETensor& pb_tensor,
-      const std::shared_ptr<seal::SEALContext>& context);
+      const std::shared_ptr<seal::SEALContext>& context,
+      const char* payload = nullptr, size_t payload_size = 0,
+      bool trusted = false);
 
   bool done_loading() const { return m_write_count == m_data.size(); }
 
+  /// \brief Returns the number of elements written to the tensor by write
+  /// or loading, which increases with every write. Changes of the values
+  /// through data() are not counted
+  size_t write_count() const { return m_write_count; }
+
+  /// \brief Returns a copy of the tensor whose ciphertexts are copies as
+  /// well, so kernels modifying the copy in place leave this tensor unchanged
+  std::shared_ptr<HETensor> deep_copy() const;
+
  private:
+  /// \brief Replaces every value by an empty ciphertext, in parallel
+  /// \param[in] complex_packing Whether or not the ciphertexts use complex
+  /// packing
+  void allocate_ciphertexts(bool complex_packing);
+
   bool m_packed;
   Shape m_packed_shape;
   std::vector<HEType> m_data;
@@ -192,6 +317,22 @@ class HETensor : public runtime::Tensor {
   const HESealEncryptionParameters& m_encryption_params;
 
   void check_io_bounds(size_t n) const;
+
+  /// \brief Checks an I/O of n bytes of elements of the given type
+  void check_io_bounds(size_t n, const element::Type& element_type) const;
+
+  /// \brief Returns the number of ciphertext / plaintext objects accessed by
+  /// an I/O of n bytes
+  size_t num_io_elements(size_t n) const;
+
+  /// \brief Returns an upper bound on the serialized size in bytes of an
+  /// object in the tensor, including its payload segment
+  /// \param[in] index Index of the object
+  /// \param[in] with_segment Whether or not the object is serialized with a
+  /// payload segment
+  /// \param[in] compr_mode Compression mode to serialize ciphertexts with
+  size_t serialized_element_size(size_t index, bool with_segment,
+                                 seal::compr_mode_type compr_mode) const;
 };
 
 }  // namespace ngraph::runtime::he
@@ -41,7 +41,9 @@ HEType::HEType(const std::shared_ptr<SealCiphertextWrapper>& cipher,
 }
 
 HEType HEType::load(const pb::HEType& pb_he_type,
-                    std::shared_ptr<seal::SEALContext> context) {
+                    std::shared_ptr<seal::SEALContext> context,
+                    const char* payload, size_t payload_size,
+                    bool trusted) {
   if (pb_he_type.is_plaintext()) {
     // TODO(fboemer): HEPlaintext::load function
     HEPlaintext vals;
@@ -52,29 +54,45 @@ HEType HEType::load(const pb::HEType& pb_he_type,
   }
 
   auto cipher = HESealBackend::create_empty_ciphertext();
-  SealCiphertextWrapper::load(*cipher, pb_he_type, std::move(context));
-  return HEType(cipher, pb_he_type.complex_packing(), pb_he_type.batch_size());
+  SealCiphertextWrapper::load(*cipher, pb_he_type, std::move(context), payload,
+                              payload_size, trusted);
+  HEType he_type(cipher, pb_he_type.complex_packing(),
+                 pb_he_type.batch_size());
+  if (pb_he_type.pending_factor() != 0) {
+    he_type.pending_factor() = pb_he_type.pending_factor();
+  }
+  return he_type;
 }
 
-void HEType::save(pb::HEType& pb_he_type) const {
+void HEType::save(pb::HEType& pb_he_type, TCPMessage::Segment* segment,
+                  seal::compr_mode_type compr_mode) const {
   pb_he_type.set_is_plaintext(is_plaintext());
   pb_he_type.set_plaintext_packing(plaintext_packing());
   pb_he_type.set_complex_packing(complex_packing());
   pb_he_type.set_batch_size(batch_size());
+  if (pending_factor() != 1) {
+    pb_he_type.set_pending_factor(pending_factor());
+  }
 
   if (is_plaintext()) {
     // TODO(fboemer): more efficient
     for (auto& elem : get_plaintext()) {
       pb_he_type.add_plain(static_cast<float>(elem));
     }
+  } else if (segment != nullptr &&
+             compr_mode == seal::compr_mode_type::none &&
+             !get_ciphertext()->is_seeded()) {
+    get_ciphertext()->save(pb_he_type, *segment);
+    segment->owner = get_ciphertext();
   } else {
-    get_ciphertext()->save(pb_he_type);
+    get_ciphertext()->save(pb_he_type, compr_mode);
   }
 }
 
 void HEType::set_plaintext(HEPlaintext plain) {
   m_plain = std::move(plain);
   m_is_plain = true;
+  m_pending_factor = 1;
   if (m_cipher != nullptr) {
     m_cipher->ciphertext().release();
   }
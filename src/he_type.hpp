@@ -19,9 +19,11 @@
 #include <memory>
 
 #include "he_plaintext.hpp"
+#include "ngraph/check.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "tcp/tcp_message.hpp"
 
 namespace ngraph::runtime::he {
 class HESealBackend;
@@ -36,10 +38,27 @@ class HEType {
   HEType(const std::shared_ptr<SealCiphertextWrapper>& cipher,
          bool complex_packing, size_t batch_size);
 
-  void save(pb::HEType& pb_he_type) const;
-
+  /// \brief Writes the HEType to a protobuf object
+  /// \param[out] pb_he_type Protobuf object to write to
+  /// \param[out] segment If not nullptr, ciphertext data is described by
+  /// segment rather than copied into pb_he_type. Ignored if compression is
+  /// used, or the ciphertext is seeded
+  /// \param[in] compr_mode Compression mode to serialize ciphertexts with
+  void save(
+      pb::HEType& pb_he_type, TCPMessage::Segment* segment = nullptr,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none) const;
+
+  /// \brief Loads an HEType from a protobuf object
+  /// \param[in] pb_he_type Protobuf object to load from
+  /// \param[in] context SEAL context to validate ciphertexts against
+  /// \param[in] payload Payload of the message storing pb_he_type
+  /// \param[in] payload_size Size in bytes of the payload
+  /// \param[in] trusted Whether or not ciphertexts are loaded without
+  /// validating their data, see SealCiphertextWrapper::load
   static HEType load(const pb::HEType& pb_he_type,
-                     std::shared_ptr<seal::SEALContext> context);
+                     std::shared_ptr<seal::SEALContext> context,
+                     const char* payload = nullptr, size_t payload_size = 0,
+                     bool trusted = false);
 
   bool is_plaintext() const { return m_is_plain; }
   bool is_ciphertext() const { return !is_plaintext(); }
@@ -51,6 +70,14 @@ class HEType {
 
   size_t batch_size() const { return m_batch_size; }
 
+  /// \brief Returns the factor by which the value of a ciphertext differs
+  /// from its decryption, i.e. the value is pending_factor() times the
+  /// decrypted ciphertext. Multiplying by a scalar, e.g. negating, may
+  /// update the factor instead of the ciphertext, see
+  /// HESealBackend::lazy_scalar_factors. Always 1 for plaintexts
+  double pending_factor() const { return m_pending_factor; }
+  double& pending_factor() { return m_pending_factor; }
+
   const HEPlaintext& get_plaintext() const { return m_plain; }
   HEPlaintext& get_plaintext() { return m_plain; }
 
@@ -65,6 +92,17 @@ class HEType {
     m_cipher = cipher;
     m_is_plain = false;
     m_plain.clear();
+    m_pending_factor = 1;
+  }
+
+  /// \brief Replaces the ciphertext by another encryption of the same value,
+  /// e.g. a copy or a mod-switched ciphertext. Unlike set_ciphertext, the
+  /// pending factor is kept
+  /// \param[in] cipher Ciphertext replacing the current ciphertext
+  void replace_ciphertext(
+      const std::shared_ptr<SealCiphertextWrapper>& cipher) {
+    NGRAPH_CHECK(is_ciphertext(), "Cannot replace ciphertext of plaintext");
+    m_cipher = cipher;
   }
 
  private:
@@ -76,8 +114,22 @@ class HEType {
   bool m_is_plain;
   bool m_complex_packing;
   size_t m_batch_size;
+  double m_pending_factor{1};
   HEPlaintext m_plain;
   std::shared_ptr<SealCiphertextWrapper> m_cipher;
 };
 
+/// \brief Returns whether or not the output of a binary operation is its
+/// plaintext argument, while the other argument is a ciphertext. Storing the
+/// ciphertext result in the output would then clear the plaintext argument
+/// before it is used, so such kernels compute into a temporary instead
+/// \param[in] arg0 First argument of the operation
+/// \param[in] arg1 Second argument of the operation
+/// \param[in] out Output of the operation
+inline bool aliases_plaintext_arg(const HEType& arg0, const HEType& arg1,
+                                  const HEType& out) {
+  return (&out == &arg0 && arg0.is_plaintext() && arg1.is_ciphertext()) ||
+         (&out == &arg1 && arg1.is_plaintext() && arg0.is_ciphertext());
+}
+
 }  // namespace ngraph::runtime::he
@@ -16,9 +16,12 @@
 
 #include "he_util.hpp"
 
+#include <cmath>
 #include <complex>
+#include <cstring>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -107,6 +110,132 @@ double type_to_double(const void* src, const element::Type& element_type) {
 #pragma clang diagnostic pop
 }
 
+void double_to_type(double value, void* dst,
+                    const element::Type& element_type) {
+#pragma clang diagnostic push
+#pragma clang diagnostic error "-Wswitch"
+#pragma clang diagnostic error "-Wswitch-enum"
+  switch (element_type.get_type_enum()) {
+    case element::Type_t::f32: {
+      *static_cast<float*>(dst) = static_cast<float>(value);
+      break;
+    }
+    case element::Type_t::f64: {
+      *static_cast<double*>(dst) = value;
+      break;
+    }
+    case element::Type_t::i32: {
+      *static_cast<int32_t*>(dst) = static_cast<int32_t>(std::round(value));
+      break;
+    }
+    case element::Type_t::i64: {
+      *static_cast<int64_t*>(dst) = static_cast<int64_t>(std::round(value));
+      break;
+    }
+    case element::Type_t::i8:
+    case element::Type_t::i16:
+    case element::Type_t::u1:
+    case element::Type_t::u8:
+    case element::Type_t::u16:
+    case element::Type_t::u32:
+    case element::Type_t::u64:
+    case element::Type_t::dynamic:
+    case element::Type_t::undefined:
+    case element::Type_t::bf16:
+    case element::Type_t::f16:
+    case element::Type_t::boolean:
+      NGRAPH_CHECK(false, "Unsupported element type ", element_type);
+  }
+#pragma clang diagnostic pop
+}
+
+namespace {
+/// \brief Calls func with a null pointer to the C++ type of a supported
+/// element type
+template <typename Func>
+void dispatch_element_type(const element::Type& element_type, Func&& func) {
+#pragma clang diagnostic push
+#pragma clang diagnostic error "-Wswitch"
+#pragma clang diagnostic error "-Wswitch-enum"
+  switch (element_type.get_type_enum()) {
+    case element::Type_t::f32:
+      func(static_cast<float*>(nullptr));
+      break;
+    case element::Type_t::f64:
+      func(static_cast<double*>(nullptr));
+      break;
+    case element::Type_t::i32:
+      func(static_cast<int32_t*>(nullptr));
+      break;
+    case element::Type_t::i64:
+      func(static_cast<int64_t*>(nullptr));
+      break;
+    case element::Type_t::i8:
+    case element::Type_t::i16:
+    case element::Type_t::u1:
+    case element::Type_t::u8:
+    case element::Type_t::u16:
+    case element::Type_t::u32:
+    case element::Type_t::u64:
+    case element::Type_t::dynamic:
+    case element::Type_t::undefined:
+    case element::Type_t::bf16:
+    case element::Type_t::f16:
+    case element::Type_t::boolean:
+      NGRAPH_CHECK(false, "Unsupported element type ", element_type);
+  }
+#pragma clang diagnostic pop
+}
+}  // namespace
+
+void strided_to_doubles(const void* src, size_t stride, size_t count,
+                        const element::Type& element_type, double* dst) {
+  dispatch_element_type(element_type, [&](auto* type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    const auto* bytes = static_cast<const char*>(src);
+    if (stride == sizeof(T)) {
+      const auto* values = reinterpret_cast<const T*>(bytes);
+#pragma omp simd
+      for (size_t i = 0; i < count; ++i) {
+        dst[i] = static_cast<double>(values[i]);
+      }
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      T value;
+      std::memcpy(&value, bytes + i * stride, sizeof(T));
+      dst[i] = static_cast<double>(value);
+    }
+  });
+}
+
+void doubles_to_strided(const double* src, size_t count, void* dst,
+                        size_t stride, const element::Type& element_type) {
+  dispatch_element_type(element_type, [&](auto* type_ptr) {
+    using T = std::remove_pointer_t<decltype(type_ptr)>;
+    auto convert = [](double value) {
+      if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(std::round(value));
+      } else {
+        return static_cast<T>(value);
+      }
+    };
+    auto* bytes = static_cast<char*>(dst);
+    if (stride == sizeof(T)) {
+      auto* values = reinterpret_cast<T*>(bytes);
+#pragma omp simd
+      for (size_t i = 0; i < count; ++i) {
+        values[i] = convert(src[i]);
+      }
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      T value = convert(src[i]);
+      std::memcpy(bytes + i * stride, &value, sizeof(T));
+    }
+  });
+}
+
 bool param_originates_from_name(const op::Parameter& param,
                                 const std::string& name) {
   if (param.get_name() == name) {
@@ -239,6 +368,14 @@ pb::Function node_to_pb_function(
   auto type_id = get_typeid(node.get_type_info());
 
   nlohmann::json js = {{"function", node.description()}};
+  if (type_id == OP_TYPEID::ConvolutionBiasRelu) {
+    // The client only computes the ReLU
+    js["function"] = "Relu";
+  }
+  if (type_id == OP_TYPEID::Max) {
+    // The client maximizes over the windows of the reduction
+    js["function"] = "MaxPool";
+  }
   if (type_id == OP_TYPEID::BoundedRelu) {
     const op::BoundedRelu* bounded_relu =
         static_cast<const op::BoundedRelu*>(&node);
@@ -255,6 +392,55 @@ pb::Function node_to_pb_function(
   return f;
 }
 
+ElementwiseFunction client_elementwise_function(const std::string& op_name) {
+  static const std::unordered_map<std::string, ElementwiseFunction>
+      functions{
+          {"Abs", [](double x) { return std::abs(x); }},
+          {"Acos", [](double x) { return std::acos(x); }},
+          {"Asin", [](double x) { return std::asin(x); }},
+          {"Atan", [](double x) { return std::atan(x); }},
+          {"Ceiling", [](double x) { return std::ceil(x); }},
+          {"Cos", [](double x) { return std::cos(x); }},
+          {"Cosh", [](double x) { return std::cosh(x); }},
+          {"Erf", [](double x) { return std::erf(x); }},
+          {"Exp", [](double x) { return std::exp(x); }},
+          {"Floor", [](double x) { return std::floor(x); }},
+          {"Log", [](double x) { return std::log(x); }},
+          {"Sigmoid", [](double x) { return 1 / (1 + std::exp(-x)); }},
+          {"Sign", [](double x) { return x > 0 ? 1. : (x < 0 ? -1. : 0.); }},
+          {"Sin", [](double x) { return std::sin(x); }},
+          {"Sinh", [](double x) { return std::sinh(x); }},
+          {"Sqrt", [](double x) { return std::sqrt(x); }},
+          {"Tan", [](double x) { return std::tan(x); }},
+          {"Tanh", [](double x) { return std::tanh(x); }}};
+  auto it = functions.find(op_name);
+  return it == functions.end() ? nullptr : it->second;
+}
+
+pb::OpRequest node_to_pb_op_request(const Node& node) {
+  auto type_id = get_typeid(node.get_type_info());
+  pb::OpRequest op_request;
+  if (type_id == OP_TYPEID::Relu ||
+      type_id == OP_TYPEID::ConvolutionBiasRelu) {
+    // The client only computes the ReLU
+    op_request.set_op(pb::OpRequest_Op_RELU);
+  } else if (type_id == OP_TYPEID::BoundedRelu) {
+    op_request.set_op(pb::OpRequest_Op_BOUNDED_RELU);
+    op_request.set_bound(
+        static_cast<const op::BoundedRelu*>(&node)->get_alpha());
+  } else if (type_id == OP_TYPEID::MaxPool || type_id == OP_TYPEID::Max) {
+    op_request.set_op(pb::OpRequest_Op_MAX_POOL);
+  } else if (type_id == OP_TYPEID::Refresh) {
+    op_request.set_op(pb::OpRequest_Op_REFRESH);
+  } else if (client_elementwise_function(node.description()) != nullptr) {
+    op_request.set_op(pb::OpRequest_Op_ELEMENTWISE);
+    op_request.set_function(node.description());
+  } else {
+    NGRAPH_CHECK(false, "Client does not compute ", node.description());
+  }
+  return op_request;
+}
+
 OP_TYPEID get_typeid(const NodeTypeInfo& type_info) {
   // This expands the op list in op_tbl.hpp into a list of enumerations that
   // look like this: {Abs::type_info, OP_TYPEID::Abs}, {Acos::type_info,
@@ -29,6 +29,9 @@
 #include "ngraph/util.hpp"
 #include "nlohmann/json.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/convolution_bias_relu.hpp"
+#include "op/refresh.hpp"
+#include "op/sum_pool.hpp"
 #include "protos/message.pb.h"
 
 namespace ngraph::runtime::he {
@@ -118,6 +121,23 @@ inline int flag_to_int(const std::string& flag, int default_value = 0) {
   return flag_to_int(flag.c_str(), default_value);
 }
 
+/// \brief Returns ceil(numerator / denominator)
+/// \param[in] numerator Numerator
+/// \param[in] denominator Denominator. Must be non-zero
+inline size_t ceil_div(size_t numerator, size_t denominator) {
+  return (numerator + denominator - 1) / denominator;
+}
+
+/// \brief Returns an exponential moving average updated with a sample. The
+/// first sample, i.e. when average is non-positive, initializes the average
+/// \param[in] average Current average
+/// \param[in] sample New sample
+/// \param[in] weight Weight of the new sample
+inline double update_moving_average(double average, double sample,
+                                    double weight = 0.25) {
+  return average <= 0 ? sample : (1 - weight) * average + weight * sample;
+}
+
 /// \brief Converts a type to a double using static_cast
 /// Note, this means a reduction of range in int64 and uint64 values.
 /// \param[in] src Source from which to read
@@ -125,6 +145,34 @@ inline int flag_to_int(const std::string& flag, int default_value = 0) {
 /// \returns double value
 double type_to_double(const void* src, const element::Type& element_type);
 
+/// \brief Converts a double to a type using static_cast, rounding to the
+/// nearest integer for integral types
+/// \param[in] value Value to convert
+/// \param[out] dst Destination to write to
+/// \param[in] element_type Datatype to write destination as
+void double_to_type(double value, void* dst,
+                    const element::Type& element_type);
+
+/// \brief Converts strided values of a type to doubles, as type_to_double
+/// of each value. The element type is dispatched once per call
+/// \param[in] src First value to read
+/// \param[in] stride Number of bytes between consecutive values
+/// \param[in] count Number of values
+/// \param[in] element_type Datatype to interpret the values as
+/// \param[out] dst Stores the count converted values
+void strided_to_doubles(const void* src, size_t stride, size_t count,
+                        const element::Type& element_type, double* dst);
+
+/// \brief Converts doubles to strided values of a type, as double_to_type
+/// of each value. The element type is dispatched once per call
+/// \param[in] src Values to convert
+/// \param[in] count Number of values
+/// \param[out] dst First value to write
+/// \param[in] stride Number of bytes between consecutive values
+/// \param[in] element_type Datatype to write the values as
+void doubles_to_strided(const double* src, size_t count, void* dst,
+                        size_t stride, const element::Type& element_type);
+
 bool param_originates_from_name(const op::Parameter& param,
                                 const std::string& name);
 
@@ -136,6 +184,23 @@ pb::Function node_to_pb_function(
     const Node& node,
     std::unordered_map<std::string, std::string> extra_configs = {});
 
+/// \brief Function which the client applies to each decrypted value of an
+/// elementwise op
+using ElementwiseFunction = double (*)(double);
+
+/// \brief Returns the function of a unary elementwise op which the client
+/// computes on decrypted values, e.g. Sigmoid or Tanh, or nullptr if the
+/// client does not compute the op elementwise
+/// \param[in] op_name Description of the op, see Node::description
+ElementwiseFunction client_elementwise_function(const std::string& op_name);
+
+/// \brief Returns the op request of a node computed by the client without
+/// garbled circuits, i.e. a Relu, BoundedRelu, ConvolutionBiasRelu, MaxPool,
+/// Refresh or an op of client_elementwise_function
+/// \param[in] node Node computed by the client
+/// \throws ngraph_error if the client does not compute the node
+pb::OpRequest node_to_pb_op_request(const Node& node);
+
 OP_TYPEID get_typeid(const NodeTypeInfo& type_info);
 
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,201 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "logging/ngraph_he_trace.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/except.hpp"
+#include "nlohmann/json.hpp"
+
+#if defined(__has_include)
+#if __has_include(<omp-tools.h>)
+#include <omp-tools.h>
+#define NGRAPH_HE_TRACE_OMPT
+#endif
+#endif
+
+namespace ngraph::runtime::he::logging {
+
+Tracer& Tracer::instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+Tracer::Tracer() : m_start(Clock::now()) {
+  const char* filename = std::getenv("NGRAPH_HE_TRACE_FILE");
+  if (filename != nullptr && filename[0] != '\0') {
+    m_filename = filename;
+    m_enabled = true;
+  }
+}
+
+Tracer::~Tracer() {
+  if (m_filename.empty()) {
+    return;
+  }
+  try {
+    write(m_filename);
+  } catch (const std::exception& e) {
+    NGRAPH_HE_LOG(0) << "Failed to write trace: " << e.what();
+  }
+}
+
+Tracer::ThreadEvents& Tracer::thread_events() {
+  // The tracer outlives the threads, so each thread only keeps a reference
+  // to its events, which the tracer owns
+  thread_local std::shared_ptr<ThreadEvents> events;
+  if (events == nullptr) {
+    events = std::make_shared<ThreadEvents>();
+    std::lock_guard<std::mutex> guard(m_threads_mutex);
+    events->thread_id = m_threads.size() + 1;
+    m_threads.emplace_back(events);
+  }
+  return *events;
+}
+
+void Tracer::record(const char* category, std::string name,
+                    Clock::time_point begin, Clock::time_point end,
+                    std::vector<std::pair<std::string, std::string>> args) {
+  if (!m_enabled) {
+    return;
+  }
+  ThreadEvents& thread = thread_events();
+  std::lock_guard<std::mutex> guard(thread.mutex);
+  thread.events.emplace_back(
+      Event{category, std::move(name), begin, end, std::move(args)});
+}
+
+std::string Tracer::to_json() const {
+  auto to_us = [this](Clock::time_point time) {
+    return std::chrono::duration<double, std::micro>(time - m_start).count();
+  };
+
+  nlohmann::json events = nlohmann::json::array();
+  std::lock_guard<std::mutex> threads_guard(m_threads_mutex);
+  for (const auto& thread : m_threads) {
+    std::string thread_name = "thread " + std::to_string(thread->thread_id);
+    events.push_back({{"name", "thread_name"},
+                      {"ph", "M"},
+                      {"pid", 1},
+                      {"tid", thread->thread_id},
+                      {"args", {{"name", thread_name}}}});
+
+    std::lock_guard<std::mutex> guard(thread->mutex);
+    for (const auto& event : thread->events) {
+      nlohmann::json args = nlohmann::json::object();
+      for (const auto& [key, value] : event.args) {
+        args[key] = value;
+      }
+      events.push_back({{"name", event.name},
+                        {"cat", event.category},
+                        {"ph", "X"},
+                        {"ts", to_us(event.begin)},
+                        {"dur", to_us(event.end) - to_us(event.begin)},
+                        {"pid", 1},
+                        {"tid", thread->thread_id},
+                        {"args", args}});
+    }
+  }
+  nlohmann::json trace = {{"traceEvents", events},
+                          {"displayTimeUnit", "ms"}};
+  return trace.dump();
+}
+
+void Tracer::write(const std::string& filename) const {
+  std::ofstream file(filename);
+  if (!file) {
+    throw ngraph_error("Unable to open trace file " + filename);
+  }
+  file << to_json();
+  if (!file) {
+    throw ngraph_error("Unable to write trace file " + filename);
+  }
+}
+
+void Tracer::clear() {
+  std::lock_guard<std::mutex> threads_guard(m_threads_mutex);
+  for (const auto& thread : m_threads) {
+    std::lock_guard<std::mutex> guard(thread->mutex);
+    thread->events.clear();
+  }
+}
+
+}  // namespace ngraph::runtime::he::logging
+
+#ifdef NGRAPH_HE_TRACE_OMPT
+namespace {
+
+using ngraph::runtime::he::logging::Tracer;
+
+/// \brief Start times of the implicit tasks of the calling thread, one per
+/// nesting level of parallel regions
+thread_local std::vector<Tracer::Clock::time_point> s_task_begin;
+
+void on_implicit_task(ompt_scope_endpoint_t endpoint,
+                      ompt_data_t* /* parallel_data */,
+                      ompt_data_t* /* task_data */,
+                      unsigned int /* actual_parallelism */,
+                      unsigned int /* index */, int flags) {
+  if ((flags & ompt_task_initial) != 0) {
+    return;
+  }
+  if (endpoint == ompt_scope_begin) {
+    s_task_begin.emplace_back(Tracer::Clock::now());
+  } else if (!s_task_begin.empty()) {
+    Tracer::instance().record("omp", "omp parallel", s_task_begin.back(),
+                              Tracer::Clock::now());
+    s_task_begin.pop_back();
+  }
+}
+
+int ompt_initialize(ompt_function_lookup_t lookup, int /* initial_device */,
+                    ompt_data_t* /* tool_data */) {
+  auto set_callback =
+      reinterpret_cast<ompt_set_callback_t>(lookup("ompt_set_callback"));
+  if (set_callback != nullptr) {
+    set_callback(ompt_callback_implicit_task,
+                 reinterpret_cast<ompt_callback_t>(&on_implicit_task));
+  }
+  return 1;
+}
+
+void ompt_finalize(ompt_data_t* /* tool_data */) {}
+
+}  // namespace
+
+/// \brief Called by OpenMP runtimes implementing OMPT when they start. Only
+/// registers the tool if tracing is enabled, so parallel regions otherwise
+/// incur no callbacks
+extern "C" ompt_start_tool_result_t* ompt_start_tool(
+    unsigned int /* omp_version */, const char* /* runtime_version */) {
+  if (!Tracer::instance().enabled()) {
+    return nullptr;
+  }
+  static ompt_start_tool_result_t result{&ompt_initialize, &ompt_finalize,
+                                         ompt_data_none};
+  return &result;
+}
+#endif
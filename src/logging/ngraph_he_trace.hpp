@@ -0,0 +1,148 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ngraph::runtime::he::logging {
+
+/// \brief Records spans of ops, OpenMP parallel regions, TCP messages and
+/// garbled circuit executions, and exports them in the Chrome trace event
+/// format, which chrome://tracing and Perfetto display as a timeline per
+/// thread. Tracing is enabled by setting the NGRAPH_HE_TRACE_FILE
+/// environment variable to the output file, which is written at exit.
+/// Otherwise, recording a span only checks enabled(). All methods are
+/// thread-safe
+class Tracer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// \brief Returns the process-wide tracer
+  static Tracer& instance();
+
+  /// \brief Writes the trace file, if tracing is enabled
+  ~Tracer();
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  /// \brief Returns whether or not spans are recorded
+  bool enabled() const { return m_enabled; }
+
+  /// \brief Enables or disables recording, e.g. to trace a single call
+  /// \param[in] enabled Whether or not to record spans
+  void set_enabled(bool enabled) { m_enabled = enabled; }
+
+  /// \brief Records a span on the calling thread
+  /// \param[in] category Category of the span, e.g. "op" or "tcp"
+  /// \param[in] name Name of the span
+  /// \param[in] begin Start time of the span
+  /// \param[in] end End time of the span
+  /// \param[in] args Additional key-value pairs shown with the span
+  void record(const char* category, std::string name, Clock::time_point begin,
+              Clock::time_point end,
+              std::vector<std::pair<std::string, std::string>> args = {});
+
+  /// \brief Returns the recorded spans in the Chrome trace event format
+  std::string to_json() const;
+
+  /// \brief Writes the recorded spans to a file
+  /// \param[in] filename File to write
+  /// \throws ngraph_error if the file cannot be written
+  void write(const std::string& filename) const;
+
+  /// \brief Discards the recorded spans
+  void clear();
+
+ private:
+  Tracer();
+
+  struct Event {
+    const char* category;
+    std::string name;
+    Clock::time_point begin;
+    Clock::time_point end;
+    std::vector<std::pair<std::string, std::string>> args;
+  };
+
+  /// \brief Spans of one thread. Only that thread appends, so the mutex is
+  /// uncontended except while exporting
+  struct ThreadEvents {
+    uint64_t thread_id{0};
+    mutable std::mutex mutex;
+    std::vector<Event> events;
+  };
+
+  /// \brief Returns the spans of the calling thread
+  ThreadEvents& thread_events();
+
+  bool m_enabled{false};
+  std::string m_filename;
+  Clock::time_point m_start;
+
+  mutable std::mutex m_threads_mutex;
+  std::vector<std::shared_ptr<ThreadEvents>> m_threads;
+};
+
+/// \brief Records a span from its construction to its destruction
+class TraceSpan {
+ public:
+  /// \brief Starts a span, if tracing is enabled
+  /// \param[in] category Category of the span, with static storage
+  /// \param[in] name Name of the span
+  TraceSpan(const char* category, const std::string& name)
+      : m_category(category) {
+    if (Tracer::instance().enabled()) {
+      m_name = name;
+      m_begin = Tracer::Clock::now();
+      m_active = true;
+    }
+  }
+
+  /// \brief Ends the span
+  ~TraceSpan() {
+    if (m_active) {
+      Tracer::instance().record(m_category, std::move(m_name), m_begin,
+                                Tracer::Clock::now(), std::move(m_args));
+    }
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+  /// \brief Adds a key-value pair shown with the span
+  void add_arg(const std::string& key, const std::string& value) {
+    if (m_active) {
+      m_args.emplace_back(key, value);
+    }
+  }
+
+ private:
+  const char* m_category;
+  std::string m_name;
+  Tracer::Clock::time_point m_begin;
+  std::vector<std::pair<std::string, std::string>> m_args;
+  bool m_active{false};
+};
+
+}  // namespace ngraph::runtime::he::logging
@@ -0,0 +1,75 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "op/convolution_bias_relu.hpp"
+
+#include <memory>
+
+#include "ngraph/util.hpp"
+#include "ngraph/validation_util.hpp"
+
+namespace ngraph {
+
+constexpr NodeTypeInfo op::ConvolutionBiasRelu::type_info;
+
+op::ConvolutionBiasRelu::ConvolutionBiasRelu(
+    const Output<Node>& data, const Output<Node>& filters,
+    const Output<Node>& bias, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides)
+    : Op({data, filters, bias}),
+      m_window_movement_strides(window_movement_strides),
+      m_window_dilation_strides(window_dilation_strides),
+      m_padding_below(padding_below),
+      m_padding_above(padding_above),
+      m_data_dilation_strides(data_dilation_strides) {
+  constructor_validate_and_infer_types();
+}
+
+void op::ConvolutionBiasRelu::validate_and_infer_types() {
+  element::Type result_et;
+  NODE_VALIDATION_CHECK(
+      this,
+      element::Type::merge(result_et, get_input_element_type(0),
+                           get_input_element_type(1)) &&
+          element::Type::merge(result_et, result_et,
+                               get_input_element_type(2)),
+      "Element types of data, filters and bias do not match");
+
+  PartialShape result_shape = infer_convolution_forward(
+      this, get_input_partial_shape(0), m_data_dilation_strides,
+      m_padding_below, m_padding_above, get_input_partial_shape(1),
+      m_window_movement_strides, m_window_dilation_strides);
+  NODE_VALIDATION_CHECK(
+      this, get_input_partial_shape(2).compatible(result_shape),
+      "Bias shape ", get_input_partial_shape(2),
+      " does not match convolution output shape ", result_shape);
+
+  set_output_type(0, result_et, result_shape);
+}
+
+std::shared_ptr<Node> op::ConvolutionBiasRelu::copy_with_new_args(
+    const NodeVector& new_args) const {
+  if (new_args.size() != 3) {
+    throw ngraph_error("Incorrect number of new arguments");
+  }
+  return std::make_shared<ConvolutionBiasRelu>(
+      new_args.at(0), new_args.at(1), new_args.at(2),
+      m_window_movement_strides, m_window_dilation_strides, m_padding_below,
+      m_padding_above, m_data_dilation_strides);
+}
+
+}  // namespace ngraph
@@ -0,0 +1,77 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "ngraph/coordinate_diff.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/op/op.hpp"
+#include "ngraph/strides.hpp"
+
+namespace ngraph::op {
+/// \brief Relu(Convolution(data, filters) + bias) operation. With the client
+/// enabled, output channels are sent to the client for ReLU as soon as they
+/// are computed, rather than after the whole convolution output exists
+class ConvolutionBiasRelu : public Op {
+ public:
+  static constexpr NodeTypeInfo type_info{"ConvolutionBiasRelu", 0};
+  const NodeTypeInfo& get_type_info() const override { return type_info; }
+  /// \brief Constructs a ConvolutionBiasRelu operation.
+  ///
+  /// \param data Data batch of shape (N, C_in, d_1, ..., d_n)
+  /// \param filters Filters of shape (C_out, C_in, f_1, ..., f_n)
+  /// \param bias Bias added to the convolution, with the convolution's
+  /// output shape
+  /// \param window_movement_strides Convolution window movement strides
+  /// \param window_dilation_strides Convolution window dilation strides
+  /// \param padding_below Padding below the data batch
+  /// \param padding_above Padding above the data batch
+  /// \param data_dilation_strides Data batch dilation strides
+  ConvolutionBiasRelu(const Output<Node>& data, const Output<Node>& filters,
+                      const Output<Node>& bias,
+                      const Strides& window_movement_strides,
+                      const Strides& window_dilation_strides,
+                      const CoordinateDiff& padding_below,
+                      const CoordinateDiff& padding_above,
+                      const Strides& data_dilation_strides);
+
+  void validate_and_infer_types() override;
+
+  std::shared_ptr<Node> copy_with_new_args(
+      const NodeVector& new_args) const override;
+
+  const Strides& get_window_movement_strides() const {
+    return m_window_movement_strides;
+  }
+  const Strides& get_window_dilation_strides() const {
+    return m_window_dilation_strides;
+  }
+  const CoordinateDiff& get_padding_below() const { return m_padding_below; }
+  const CoordinateDiff& get_padding_above() const { return m_padding_above; }
+  const Strides& get_data_dilation_strides() const {
+    return m_data_dilation_strides;
+  }
+
+ private:
+  Strides m_window_movement_strides;
+  Strides m_window_dilation_strides;
+  CoordinateDiff m_padding_below;
+  CoordinateDiff m_padding_above;
+  Strides m_data_dilation_strides;
+};
+}  // namespace ngraph::op
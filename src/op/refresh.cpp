@@ -0,0 +1,38 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "op/refresh.hpp"
+
+#include "ngraph/util.hpp"
+
+namespace ngraph {
+
+constexpr NodeTypeInfo op::Refresh::type_info;
+
+op::Refresh::Refresh(const Output<Node>& arg)
+    : UnaryElementwiseArithmetic(arg) {
+  constructor_validate_and_infer_types();
+}
+
+std::shared_ptr<Node> op::Refresh::copy_with_new_args(
+    const NodeVector& new_args) const {
+  if (new_args.size() != 1) {
+    throw ngraph_error("Incorrect number of new arguments");
+  }
+  return std::make_shared<Refresh>(new_args.at(0));
+}
+
+}  // namespace ngraph
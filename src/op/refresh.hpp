@@ -0,0 +1,40 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "ngraph/node.hpp"
+#include "ngraph/op/op.hpp"
+#include "ngraph/op/util/unary_elementwise_arithmetic.hpp"
+
+namespace ngraph::op {
+/// \brief Elementwise identity operation, which re-encrypts encrypted inputs
+/// at a higher level, so following ops have levels left to consume.
+///
+class Refresh : public util::UnaryElementwiseArithmetic {
+ public:
+  static constexpr NodeTypeInfo type_info{"Refresh", 0};
+  const NodeTypeInfo& get_type_info() const override { return type_info; }
+  /// \brief Constructs a Refresh operation.
+  ///
+  /// \param arg Node input to refresh.
+  explicit Refresh(const Output<ngraph::Node>& arg);
+  std::shared_ptr<Node> copy_with_new_args(
+      const NodeVector& new_args) const override;
+};
+}  // namespace ngraph::op
@@ -0,0 +1,43 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "op/sum_pool.hpp"
+
+#include <memory>
+
+#include "ngraph/util.hpp"
+
+namespace ngraph {
+
+constexpr NodeTypeInfo op::SumPool::type_info;
+
+op::SumPool::SumPool(const Output<Node>& arg, const Shape& window_shape,
+                     const Strides& window_movement_strides,
+                     const Shape& padding_below, const Shape& padding_above)
+    : AvgPool(arg, window_shape, window_movement_strides, padding_below,
+              padding_above, true) {}
+
+std::shared_ptr<Node> op::SumPool::copy_with_new_args(
+    const NodeVector& new_args) const {
+  if (new_args.size() != 1) {
+    throw ngraph_error("Incorrect number of new arguments");
+  }
+  return std::make_shared<SumPool>(
+      new_args.at(0), get_window_shape(), get_window_movement_strides(),
+      get_padding_below(), get_padding_above());
+}
+
+}  // namespace ngraph
@@ -0,0 +1,48 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "ngraph/node.hpp"
+#include "ngraph/op/avg_pool.hpp"
+
+namespace ngraph::op {
+/// \brief Sums each AvgPool window without dividing by the window size.
+/// Padding contributes zeros. HEFusion replaces an AvgPool whose windows all
+/// have the same size by a SumPool when the division can be folded into the
+/// weights of the following Convolution or Dot, which saves a multiplicative
+/// level
+class SumPool : public AvgPool {
+ public:
+  static constexpr NodeTypeInfo type_info{"SumPool", 0};
+  const NodeTypeInfo& get_type_info() const override { return type_info; }
+  /// \brief Constructs a SumPool operation.
+  ///
+  /// \param arg Data batch of shape (N, C, d_1, ..., d_n)
+  /// \param window_shape Window shape
+  /// \param window_movement_strides Window movement strides
+  /// \param padding_below Padding below the data batch
+  /// \param padding_above Padding above the data batch
+  SumPool(const Output<Node>& arg, const Shape& window_shape,
+          const Strides& window_movement_strides, const Shape& padding_below,
+          const Shape& padding_above);
+
+  std::shared_ptr<Node> copy_with_new_args(
+      const NodeVector& new_args) const override;
+};
+}  // namespace ngraph::op
@@ -0,0 +1,365 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/elide_redundant_relus.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/ops.hpp"
+#include "ngraph/shape_util.hpp"
+#include "op/bounded_relu.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+using Range = pass::ElideRedundantRelus::Range;
+
+constexpr double s_inf = std::numeric_limits<double>::infinity();
+const Range s_unbounded{-s_inf, s_inf};
+
+/// \brief Returns the range, or the unbounded range if either bound is NaN,
+/// e.g. from multiplying an unbounded range by zero
+Range checked(Range range) {
+  if (std::isnan(range.first) || std::isnan(range.second)) {
+    return s_unbounded;
+  }
+  return range;
+}
+
+Range hull(const Range& a, const Range& b) {
+  return {std::min(a.first, b.first), std::max(a.second, b.second)};
+}
+
+Range multiply(const Range& a, const Range& b) {
+  std::vector<double> products{a.first * b.first, a.first * b.second,
+                               a.second * b.first, a.second * b.second};
+  return checked(
+      {*std::min_element(products.begin(), products.end()),
+       *std::max_element(products.begin(), products.end())});
+}
+
+/// \brief Returns the values of a f32 Constant, or an empty vector for other
+/// nodes
+std::vector<float> constant_values(const Output<Node>& output) {
+  auto constant =
+      std::dynamic_pointer_cast<op::Constant>(output.get_node_shared_ptr());
+  if (constant == nullptr || constant->get_element_type() != element::f32) {
+    return {};
+  }
+  return constant->get_vector<float>();
+}
+
+/// \brief Returns the range of sum_i x_i w_i over the first num_terms
+/// weights starting at offset, for x_i within range. If some terms may be
+/// missing, e.g. due to padding, each term's range includes zero
+Range weighted_sum(const Range& range, const std::vector<float>& weights,
+                   size_t offset, size_t num_terms, bool partial) {
+  Range sum{0, 0};
+  for (size_t i = offset; i < offset + num_terms; ++i) {
+    Range term = multiply(range, {weights[i], weights[i]});
+    if (partial) {
+      term = hull(term, {0, 0});
+    }
+    sum = checked({sum.first + term.first, sum.second + term.second});
+  }
+  return sum;
+}
+
+class RangeAnalysis {
+ public:
+  explicit RangeAnalysis(
+      const pass::ElideRedundantRelus::InputRange& input_range)
+      : m_input_range(input_range) {}
+
+  const Range& range(const Output<Node>& output) const {
+    auto it = m_ranges.find(output.get_node());
+    if (it == m_ranges.end() || output.get_index() != 0) {
+      return s_unbounded;
+    }
+    return it->second;
+  }
+
+  void set_range(const Node* node, const Range& range) {
+    m_ranges[node] = range;
+  }
+
+  /// \brief Returns the range of the first output of a node, given the
+  /// ranges of its inputs
+  Range compute(const std::shared_ptr<Node>& node) const;
+
+ private:
+  Range arg(const std::shared_ptr<Node>& node, size_t idx) const {
+    return range(node->input_value(idx));
+  }
+
+  const pass::ElideRedundantRelus::InputRange& m_input_range;
+  std::unordered_map<const Node*, Range> m_ranges;
+};
+
+Range RangeAnalysis::compute(const std::shared_ptr<Node>& node) const {
+  if (auto param = std::dynamic_pointer_cast<op::Parameter>(node)) {
+    auto declared = m_input_range ? m_input_range(*param) : std::nullopt;
+    return declared.value_or(s_unbounded);
+  }
+  if (std::dynamic_pointer_cast<op::Constant>(node) != nullptr) {
+    std::vector<float> values = constant_values(node->output(0));
+    if (values.empty()) {
+      return s_unbounded;
+    }
+    auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
+    return {*min_it, *max_it};
+  }
+  if (std::dynamic_pointer_cast<op::Reshape>(node) != nullptr ||
+      std::dynamic_pointer_cast<op::Broadcast>(node) != nullptr ||
+      std::dynamic_pointer_cast<op::Slice>(node) != nullptr ||
+      std::dynamic_pointer_cast<op::Reverse>(node) != nullptr ||
+      std::dynamic_pointer_cast<op::MaxPool>(node) != nullptr ||
+      std::dynamic_pointer_cast<op::Result>(node) != nullptr) {
+    return arg(node, 0);
+  }
+  if (std::dynamic_pointer_cast<op::Concat>(node) != nullptr ||
+      std::dynamic_pointer_cast<op::Pad>(node) != nullptr) {
+    Range result = arg(node, 0);
+    for (size_t idx = 1; idx < node->get_input_size(); ++idx) {
+      result = hull(result, arg(node, idx));
+    }
+    return result;
+  }
+  if (std::dynamic_pointer_cast<op::Add>(node) != nullptr) {
+    Range a = arg(node, 0);
+    Range b = arg(node, 1);
+    return checked({a.first + b.first, a.second + b.second});
+  }
+  if (std::dynamic_pointer_cast<op::Subtract>(node) != nullptr) {
+    Range a = arg(node, 0);
+    Range b = arg(node, 1);
+    return checked({a.first - b.second, a.second - b.first});
+  }
+  if (std::dynamic_pointer_cast<op::Negate>(node) != nullptr) {
+    Range a = arg(node, 0);
+    return {-a.second, -a.first};
+  }
+  if (std::dynamic_pointer_cast<op::Multiply>(node) != nullptr) {
+    return multiply(arg(node, 0), arg(node, 1));
+  }
+  if (std::dynamic_pointer_cast<op::Minimum>(node) != nullptr) {
+    Range a = arg(node, 0);
+    Range b = arg(node, 1);
+    return {std::min(a.first, b.first), std::min(a.second, b.second)};
+  }
+  if (std::dynamic_pointer_cast<op::Maximum>(node) != nullptr) {
+    Range a = arg(node, 0);
+    Range b = arg(node, 1);
+    return {std::max(a.first, b.first), std::max(a.second, b.second)};
+  }
+  if (std::dynamic_pointer_cast<op::Relu>(node) != nullptr) {
+    Range a = arg(node, 0);
+    return {std::max(a.first, 0.0), std::max(a.second, 0.0)};
+  }
+  if (auto bounded_relu = std::dynamic_pointer_cast<op::BoundedRelu>(node)) {
+    Range a = arg(node, 0);
+    double alpha = bounded_relu->get_alpha();
+    return {std::clamp(a.first, 0.0, alpha), std::clamp(a.second, 0.0, alpha)};
+  }
+  if (std::dynamic_pointer_cast<op::Sum>(node) != nullptr) {
+    size_t num_terms = shape_size(node->get_input_shape(0)) /
+                       std::max<size_t>(1, shape_size(node->get_shape()));
+    Range a = arg(node, 0);
+    auto scale = static_cast<double>(num_terms);
+    return multiply(a, {scale, scale});
+  }
+  if (auto avg_pool = std::dynamic_pointer_cast<op::AvgPool>(node)) {
+    // An average of values within the range lies within it. Padding
+    // included in the average adds zeros
+    const Shape& padding_below = avg_pool->get_padding_below();
+    const Shape& padding_above = avg_pool->get_padding_above();
+    bool padded = std::any_of(padding_below.begin(), padding_below.end(),
+                              [](size_t pad) { return pad > 0; }) ||
+                  std::any_of(padding_above.begin(), padding_above.end(),
+                              [](size_t pad) { return pad > 0; });
+    Range a = arg(node, 0);
+    return padded ? hull(a, {0, 0}) : a;
+  }
+  if (auto dot = std::dynamic_pointer_cast<op::Dot>(node)) {
+    std::vector<float> weights = constant_values(node->input_value(1));
+    const Shape& weight_shape = node->get_input_shape(1);
+    if (weights.empty() || dot->get_reduction_axes_count() != 1 ||
+        weight_shape.empty() || weight_shape[0] == 0) {
+      return s_unbounded;
+    }
+    // Column j of the weights, i.e. elements j, j + num_columns, ...,
+    // produces output column j
+    size_t num_rows = weight_shape[0];
+    size_t num_columns = weights.size() / num_rows;
+    Range a = arg(node, 0);
+    std::optional<Range> result;
+    for (size_t column = 0; column < num_columns; ++column) {
+      std::vector<float> column_weights(num_rows);
+      for (size_t row = 0; row < num_rows; ++row) {
+        column_weights[row] = weights[row * num_columns + column];
+      }
+      Range sum = weighted_sum(a, column_weights, 0, num_rows, false);
+      result = result.has_value() ? hull(*result, sum) : sum;
+    }
+    return result.value_or(Range{0, 0});
+  }
+  if (std::dynamic_pointer_cast<op::Convolution>(node) != nullptr) {
+    std::vector<float> filters = constant_values(node->input_value(1));
+    const Shape& filter_shape = node->get_input_shape(1);
+    if (filters.empty() || filter_shape.empty() || filter_shape[0] == 0) {
+      return s_unbounded;
+    }
+    // Windows overlapping the padding or dilated input holes sum a subset of
+    // the filter's terms
+    size_t num_channels = filter_shape[0];
+    size_t filter_size = filters.size() / num_channels;
+    Range a = arg(node, 0);
+    std::optional<Range> result;
+    for (size_t channel = 0; channel < num_channels; ++channel) {
+      Range sum =
+          weighted_sum(a, filters, channel * filter_size, filter_size, true);
+      result = result.has_value() ? hull(*result, sum) : sum;
+    }
+    return result.value_or(Range{0, 0});
+  }
+  if (auto batch_norm =
+          std::dynamic_pointer_cast<op::BatchNormInference>(node)) {
+    std::vector<float> gamma = constant_values(node->input_value(0));
+    std::vector<float> beta = constant_values(node->input_value(1));
+    std::vector<float> mean = constant_values(node->input_value(3));
+    std::vector<float> variance = constant_values(node->input_value(4));
+    size_t num_channels = gamma.size();
+    if (num_channels == 0 || beta.size() != num_channels ||
+        mean.size() != num_channels || variance.size() != num_channels) {
+      return s_unbounded;
+    }
+    Range a = arg(node, 2);
+    std::optional<Range> result;
+    for (size_t channel = 0; channel < num_channels; ++channel) {
+      double scale = gamma[channel] / std::sqrt(variance[channel] +
+                                                batch_norm->get_eps_value());
+      Range centered{a.first - mean[channel], a.second - mean[channel]};
+      Range scaled = multiply(centered, {scale, scale});
+      Range channel_range = checked(
+          {scaled.first + beta[channel], scaled.second + beta[channel]});
+      result = result.has_value() ? hull(*result, channel_range)
+                                  : channel_range;
+    }
+    return *result;
+  }
+  return s_unbounded;
+}
+
+/// \brief Replaces the uses of a node's output by another output
+void forward(const std::shared_ptr<Node>& node, const Output<Node>& output) {
+  for (auto& input : node->output(0).get_target_inputs()) {
+    input.replace_source_output(output);
+  }
+}
+
+std::shared_ptr<Node> make_filled(const std::shared_ptr<Node>& node,
+                                  float value) {
+  return op::Constant::create(node->get_element_type(), node->get_shape(),
+                              std::vector<float>{value});
+}
+
+/// \brief Replaces an activation node whose result is determined by the
+/// range of its input
+/// \returns The replacement of the node, or nullptr if the node is kept
+std::shared_ptr<Node> elide(const std::shared_ptr<Node>& node,
+                            const RangeAnalysis& analysis) {
+  auto arg = [&](size_t idx) { return analysis.range(node->input_value(idx)); };
+  if (std::dynamic_pointer_cast<op::Relu>(node) != nullptr) {
+    Range a = arg(0);
+    if (a.first >= 0) {
+      forward(node, node->input_value(0));
+      return node->input_value(0).get_node_shared_ptr();
+    }
+    if (a.second <= 0) {
+      auto zeros = make_filled(node, 0);
+      forward(node, zeros);
+      return zeros;
+    }
+    return nullptr;
+  }
+  if (auto bounded_relu = std::dynamic_pointer_cast<op::BoundedRelu>(node)) {
+    Range a = arg(0);
+    double alpha = bounded_relu->get_alpha();
+    if (a.first >= 0 && a.second <= alpha) {
+      forward(node, node->input_value(0));
+      return node->input_value(0).get_node_shared_ptr();
+    }
+    if (a.second <= 0 || a.first >= alpha) {
+      auto filled = make_filled(node, a.second <= 0 ? 0 : alpha);
+      forward(node, filled);
+      return filled;
+    }
+    if (a.second <= alpha) {
+      auto relu = std::make_shared<op::Relu>(node->input_value(0));
+      forward(node, relu);
+      return relu;
+    }
+    return nullptr;
+  }
+  bool is_minimum = std::dynamic_pointer_cast<op::Minimum>(node) != nullptr;
+  bool is_maximum = std::dynamic_pointer_cast<op::Maximum>(node) != nullptr;
+  if (is_minimum || is_maximum) {
+    Range a = arg(0);
+    Range b = arg(1);
+    std::optional<size_t> dominant;
+    if (is_minimum ? a.second <= b.first : a.first >= b.second) {
+      dominant = 0;
+    } else if (is_minimum ? b.second <= a.first : b.first >= a.second) {
+      dominant = 1;
+    }
+    if (dominant.has_value() &&
+        node->get_input_shape(*dominant) == node->get_shape()) {
+      forward(node, node->input_value(*dominant));
+      return node->input_value(*dominant).get_node_shared_ptr();
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+bool pass::ElideRedundantRelus::run_on_function(
+    std::shared_ptr<Function> function) {
+  RangeAnalysis analysis(m_input_range);
+  size_t num_elided = 0;
+  for (const auto& node : function->get_ordered_ops()) {
+    auto replacement = elide(node, analysis);
+    if (replacement != nullptr) {
+      NGRAPH_HE_LOG(4) << "Eliding " << node->get_name() << ", since its "
+                       << "input range determines its result";
+      num_elided++;
+      analysis.set_range(replacement.get(), analysis.compute(replacement));
+    }
+    analysis.set_range(node.get(), analysis.compute(node));
+  }
+  NGRAPH_HE_LOG(3) << "Elided " << num_elided << " activations";
+  return num_elided > 0;
+}
+
+}  // namespace ngraph::runtime::he
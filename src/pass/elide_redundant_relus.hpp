@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "ngraph/op/parameter.hpp"
+#include "ngraph/pass/graph_rewrite.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Propagates intervals bounding the values of each node from
+/// declared input ranges and Constants through the linear ops, and removes
+/// activations whose result the intervals determine, each of which saves a
+/// client round-trip:
+///   - Relus of non-negative values are removed, and Relus of non-positive
+///     values become zeros
+///   - BoundedRelus whose bound is never reached become Relus, or are
+///     removed if their input is also non-negative
+///   - Minimum and Maximum ops of which one argument always dominates are
+///     replaced by that argument
+/// Nodes without a declared or derivable interval are unbounded
+class ElideRedundantRelus : public ngraph::pass::FunctionPass {
+ public:
+  /// \brief Closed interval of values
+  using Range = std::pair<double, double>;
+
+  /// \brief Returns the declared range of a parameter's values, if any
+  using InputRange =
+      std::function<std::optional<Range>(const op::Parameter& param)>;
+
+  /// \param[in] input_range Declared ranges of the parameters
+  explicit ElideRedundantRelus(InputRange input_range)
+      : m_input_range(std::move(input_range)) {}
+
+  /// \brief Returns whether or not an activation was removed
+  /// \param[in,out] function Function which to run pass on
+  bool run_on_function(std::shared_ptr<Function> function) override;
+
+ private:
+  InputRange m_input_range;
+};
+}  // namespace ngraph::runtime::he::pass
@@ -0,0 +1,135 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/fold_constant_subgraphs.hpp"
+
+#include <exception>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/graph_util.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/op/constant.hpp"
+#include "ngraph/runtime/backend.hpp"
+
+namespace ngraph::runtime::he {
+
+bool pass::FoldConstantSubgraphs::run_on_function(
+    std::shared_ptr<Function> function) {
+  std::shared_ptr<runtime::Backend> backend;
+  try {
+    backend = runtime::Backend::create(m_backend_name);
+  } catch (const std::exception& e) {
+    NGRAPH_HE_LOG(3) << "Not folding constant subgraphs, backend "
+                     << m_backend_name << " is unavailable: " << e.what();
+    return false;
+  }
+
+  // A node is foldable if it computes a single output from Constants or
+  // other foldable nodes
+  std::unordered_set<const Node*> foldable;
+  auto from_constants = [&foldable](const Node& node) {
+    for (const auto& input : node.inputs()) {
+      const Node* source = input.get_source_output().get_node();
+      if (!source->is_constant() && foldable.count(source) == 0) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  std::list<std::shared_ptr<Node>> nodes = function->get_ordered_ops();
+  for (const auto& node : nodes) {
+    if (node->is_constant() || node->is_parameter() || node->is_output() ||
+        node->get_input_size() == 0 || node->get_output_size() != 1 ||
+        node->get_output_element_type(0).is_dynamic() ||
+        !from_constants(*node) || !backend->is_supported(*node)) {
+      continue;
+    }
+    foldable.insert(node.get());
+  }
+
+  // Only the roots of the foldable subgraphs, i.e. foldable nodes with a
+  // non-foldable user, are evaluated and replaced
+  NodeVector roots;
+  for (const auto& node : nodes) {
+    if (foldable.count(node.get()) == 0) {
+      continue;
+    }
+    for (const auto& user : node->get_users()) {
+      if (foldable.count(user.get()) == 0) {
+        roots.emplace_back(node);
+        break;
+      }
+    }
+  }
+  if (roots.empty()) {
+    return false;
+  }
+
+  // Evaluate copies of the subgraphs, so the function is not modified if
+  // evaluation fails
+  std::unordered_map<const Node*, std::shared_ptr<Node>> copies;
+  for (const auto& node : nodes) {
+    if (!node->is_constant() && foldable.count(node.get()) == 0) {
+      continue;
+    }
+    NodeVector new_args;
+    for (const auto& input : node->inputs()) {
+      new_args.emplace_back(copies.at(input.get_source_output().get_node()));
+    }
+    copies[node.get()] = node->copy_with_new_args(new_args);
+  }
+
+  NodeVector copied_roots;
+  std::vector<std::shared_ptr<runtime::Tensor>> outputs;
+  for (const auto& root : roots) {
+    copied_roots.emplace_back(copies.at(root.get()));
+    outputs.emplace_back(backend->create_tensor(
+        root->get_output_element_type(0), root->get_output_shape(0)));
+  }
+  try {
+    auto subgraphs =
+        std::make_shared<Function>(copied_roots, ParameterVector{});
+    auto handle = backend->compile(subgraphs);
+    handle->call(outputs, {});
+  } catch (const std::exception& e) {
+    NGRAPH_HE_LOG(3) << "Not folding constant subgraphs: " << e.what();
+    return false;
+  }
+
+  for (size_t i = 0; i < roots.size(); ++i) {
+    const auto& root = roots[i];
+    std::vector<char> values(outputs[i]->get_size_in_bytes());
+    outputs[i]->read(values.data(), values.size());
+    auto constant = std::make_shared<op::Constant>(
+        root->get_output_element_type(0), root->get_output_shape(0),
+        values.data());
+    NGRAPH_HE_LOG(5) << "Folding " << root->get_name() << " into "
+                     << constant->get_name();
+    replace_node(root, constant);
+  }
+  NGRAPH_HE_LOG(3) << "Folded " << foldable.size() << " nodes into "
+                   << roots.size() << " constants";
+  return true;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,46 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "ngraph/pass/graph_rewrite.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Replaces subgraphs whose inputs are all Constants by Constants,
+/// which are computed once at compile time on a plaintext backend. This
+/// covers ops ngraph's ConstantFolding does not fold, for instance Dot,
+/// Convolution or BatchNormInference on weights, so only ops touching
+/// function parameters remain at runtime
+class FoldConstantSubgraphs : public ngraph::pass::FunctionPass {
+ public:
+  /// \param[in] backend_name Name of the backend evaluating the subgraphs
+  explicit FoldConstantSubgraphs(std::string backend_name = "INTERPRETER")
+      : m_backend_name(std::move(backend_name)) {}
+
+  /// \brief Returns whether or not any subgraph was folded. If the backend
+  /// is unavailable or does not support an op, the affected subgraphs are
+  /// left unchanged
+  /// \param[in,out] function Function which to run pass on
+  bool run_on_function(std::shared_ptr<Function> function) override;
+
+ private:
+  std::string m_backend_name;
+};
+}  // namespace ngraph::runtime::he::pass
@@ -0,0 +1,215 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/fold_layout_ops.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/coordinate_transform.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/graph_util.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/ops.hpp"
+#include "ngraph/shape_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+bool is_identity_order(const AxisVector& order) {
+  for (size_t axis = 0; axis < order.size(); ++axis) {
+    if (order[axis] != axis) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// \brief Replaces Transpose(x, Constant) by Reshape(x)
+bool fold_transpose(const std::shared_ptr<Node>& node) {
+  auto transpose = std::dynamic_pointer_cast<op::Transpose>(node);
+  if (transpose == nullptr) {
+    return false;
+  }
+  auto order_constant = std::dynamic_pointer_cast<op::Constant>(
+      transpose->input_value(1).get_node_shared_ptr());
+  if (order_constant == nullptr) {
+    return false;
+  }
+  AxisVector order = order_constant->get_axis_vector_val();
+  const Shape& in_shape = transpose->get_input_shape(0);
+  Shape out_shape(order.size());
+  for (size_t axis = 0; axis < order.size(); ++axis) {
+    out_shape[axis] = in_shape[order[axis]];
+  }
+  auto reshape = std::make_shared<op::Reshape>(transpose->input_value(0),
+                                               order, out_shape);
+  NGRAPH_HE_LOG(4) << "Replacing " << transpose->get_name() << " by "
+                   << reshape->get_name();
+  replace_node(transpose, reshape);
+  return true;
+}
+
+/// \brief Replaces Reshape(Reshape(x)) by Reshape(x) if the outer Reshape
+/// does not permute its input, and removes Reshapes which do not change
+/// their input
+bool fold_reshape(const std::shared_ptr<Node>& node) {
+  auto reshape = std::dynamic_pointer_cast<op::Reshape>(node);
+  if (reshape == nullptr || !is_identity_order(reshape->get_input_order())) {
+    return false;
+  }
+  if (reshape->get_input_shape(0) == reshape->get_output_shape(0)) {
+    NGRAPH_HE_LOG(4) << "Removing " << reshape->get_name();
+    for (auto& input : reshape->output(0).get_target_inputs()) {
+      input.replace_source_output(reshape->input_value(0));
+    }
+    return true;
+  }
+  auto inner = std::dynamic_pointer_cast<op::Reshape>(
+      reshape->input_value(0).get_node_shared_ptr());
+  if (inner == nullptr) {
+    return false;
+  }
+  auto folded = std::make_shared<op::Reshape>(inner->input_value(0),
+                                              inner->get_input_order(),
+                                              reshape->get_output_shape(0));
+  NGRAPH_HE_LOG(4) << "Folding " << inner->get_name() << " into "
+                   << reshape->get_name();
+  replace_node(reshape, folded);
+  return true;
+}
+
+/// \brief Replaces Broadcast(Broadcast(x)) by Broadcast(x)
+bool fold_broadcast(const std::shared_ptr<Node>& node) {
+  if (node->get_type_info() != op::Broadcast::type_info) {
+    return false;
+  }
+  auto broadcast = std::static_pointer_cast<op::Broadcast>(node);
+  auto inner_node = broadcast->input_value(0).get_node_shared_ptr();
+  if (inner_node->get_type_info() != op::Broadcast::type_info) {
+    return false;
+  }
+  auto inner = std::static_pointer_cast<op::Broadcast>(inner_node);
+
+  // Axis i of the inner output is the i-th axis of the outer output which
+  // is not broadcast by the outer Broadcast
+  const AxisSet& outer_axes = broadcast->get_broadcast_axes();
+  const Shape& out_shape = broadcast->get_broadcast_shape();
+  std::vector<size_t> inner_positions;
+  for (size_t axis = 0; axis < out_shape.size(); ++axis) {
+    if (outer_axes.find(axis) == outer_axes.end()) {
+      inner_positions.emplace_back(axis);
+    }
+  }
+  AxisSet axes{outer_axes};
+  for (size_t axis : inner->get_broadcast_axes()) {
+    axes.insert(inner_positions[axis]);
+  }
+  auto folded =
+      std::make_shared<op::Broadcast>(inner->input_value(0), out_shape, axes);
+  NGRAPH_HE_LOG(4) << "Folding " << inner->get_name() << " into "
+                   << broadcast->get_name();
+  replace_node(broadcast, folded);
+  return true;
+}
+
+/// \brief Replaces Dot(Reshape(x), w) for a Constant w by Dot(Reshape'(x),
+/// w') for a Reshape' which does not permute x, if the Reshape permutes the
+/// axes of each batch entry into a row of the matrix. Row j of w' is the
+/// row of w the Reshape moves element j of each batch entry to
+bool fold_dot_reshape(const std::shared_ptr<Node>& node) {
+  auto dot = std::dynamic_pointer_cast<op::Dot>(node);
+  if (dot == nullptr || dot->get_reduction_axes_count() != 1) {
+    return false;
+  }
+  auto reshape = std::dynamic_pointer_cast<op::Reshape>(
+      dot->input_value(0).get_node_shared_ptr());
+  auto weights = std::dynamic_pointer_cast<op::Constant>(
+      dot->input_value(1).get_node_shared_ptr());
+  if (reshape == nullptr || weights == nullptr ||
+      weights->get_element_type() != element::f32) {
+    return false;
+  }
+  const AxisVector& order = reshape->get_input_order();
+  const Shape& in_shape = reshape->get_input_shape(0);
+  const Shape& out_shape = reshape->get_output_shape(0);
+  const Shape& weight_shape = weights->get_shape();
+  if (is_identity_order(order) || order[0] != 0 || out_shape.size() != 2 ||
+      out_shape[0] != in_shape[0] || weight_shape.size() != 2) {
+    return false;
+  }
+
+  // Element k of each row is element row_source[k] of the batch entry
+  Shape entry_shape{in_shape.begin() + 1, in_shape.end()};
+  AxisVector entry_order(order.size() - 1);
+  for (size_t axis = 1; axis < order.size(); ++axis) {
+    entry_order[axis - 1] = order[axis] - 1;
+  }
+  CoordinateTransform entry_transform(
+      entry_shape, Coordinate(entry_shape.size(), 0), entry_shape,
+      Strides(entry_shape.size(), 1), entry_order);
+  std::vector<size_t> row_source;
+  row_source.reserve(shape_size(entry_shape));
+  for (const Coordinate& coord : entry_transform) {
+    row_source.emplace_back(entry_transform.index(coord));
+  }
+
+  size_t columns = weight_shape[1];
+  std::vector<float> weight_values = weights->get_vector<float>();
+  std::vector<float> permuted_values(weight_values.size());
+  for (size_t row = 0; row < row_source.size(); ++row) {
+    std::copy_n(weight_values.begin() + row * columns, columns,
+                permuted_values.begin() + row_source[row] * columns);
+  }
+  auto permuted_weights =
+      op::Constant::create(element::f32, weight_shape, permuted_values);
+
+  AxisVector identity_order(order.size());
+  std::iota(identity_order.begin(), identity_order.end(), 0);
+  auto rows = std::make_shared<op::Reshape>(reshape->input_value(0),
+                                            identity_order, out_shape);
+  auto folded = std::make_shared<op::Dot>(rows, permuted_weights, 1);
+  NGRAPH_HE_LOG(3) << "Folding the permutation of " << reshape->get_name()
+                   << " into the weights of " << dot->get_name();
+  replace_node(dot, folded);
+  return true;
+}
+}  // namespace
+
+bool pass::FoldLayoutOps::run_on_function(std::shared_ptr<Function> function) {
+  bool modified = false;
+  // Each rewrite may enable others, e.g. a Transpose becomes a Reshape
+  // which folds into the next Reshape, so the ops are revisited until no
+  // rule applies
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const auto& node : function->get_ordered_ops()) {
+      if (fold_transpose(node) || fold_reshape(node) || fold_broadcast(node) ||
+          fold_dot_reshape(node)) {
+        changed = true;
+        modified = true;
+        break;
+      }
+    }
+  }
+  return modified;
+}
+
+}  // namespace ngraph::runtime::he
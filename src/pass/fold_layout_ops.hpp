@@ -0,0 +1,41 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "ngraph/pass/graph_rewrite.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Simplifies chains of layout ops, so fewer ciphertexts are copied
+/// at runtime:
+///   - Transposes with a Constant input order become Reshapes
+///   - Reshape(Reshape(x)) becomes one Reshape if the outer Reshape does not
+///     permute its input
+///   - Broadcast(Broadcast(x)) becomes one Broadcast
+///   - Reshapes which neither permute nor change the shape are removed
+///   - Dot(Reshape(x), Constant) with a Reshape which permutes the axes of
+///     each batch entry into the rows of a matrix is replaced by a Dot of
+///     the unpermuted rows with permuted weights. Reshapes without
+///     permutation forward their input at runtime
+class FoldLayoutOps : public ngraph::pass::FunctionPass {
+ public:
+  /// \brief Returns whether or not the function was modified
+  /// \param[in,out] function Function which to run pass on
+  bool run_on_function(std::shared_ptr<Function> function) override;
+};
+}  // namespace ngraph::runtime::he::pass
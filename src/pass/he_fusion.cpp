@@ -16,18 +16,339 @@
 
 #include "pass/he_fusion.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/builder/make_constant.hpp"
+#include "ngraph/op/add.hpp"
+#include "ngraph/op/avg_pool.hpp"
+#include "ngraph/op/batch_norm.hpp"
+#include "ngraph/op/broadcast.hpp"
+#include "ngraph/op/constant.hpp"
+#include "ngraph/op/convolution.hpp"
+#include "ngraph/op/dot.hpp"
 #include "ngraph/op/minimum.hpp"
+#include "ngraph/op/pad.hpp"
 #include "ngraph/op/relu.hpp"
+#include "ngraph/op/reshape.hpp"
 #include "ngraph/pattern/matcher.hpp"
 #include "ngraph/pattern/op/label.hpp"
 #include "ngraph/runtime/cpu/op/bounded_relu.hpp"
+#include "op/convolution_bias_relu.hpp"
+#include "op/sum_pool.hpp"
 
 namespace ngraph::runtime::he::pass {
 
+namespace {
+/// \brief Per-channel affine transform y = scale * x + shift computed by a
+/// BatchNormInference op
+struct BatchNormAffine {
+  std::vector<float> scale;
+  std::vector<float> shift;
+};
+
+/// \brief Returns the affine transform of a BatchNormInference op, or
+/// std::nullopt if its parameters are not f32 Constants
+std::optional<BatchNormAffine> batch_norm_affine(
+    const op::BatchNormInference& bn) {
+  // Arguments are gamma, beta, input, mean, variance
+  std::vector<std::vector<float>> parameters;
+  for (size_t arg_idx : {0, 1, 3, 4}) {
+    auto constant = std::dynamic_pointer_cast<op::Constant>(
+        bn.input_value(arg_idx).get_node_shared_ptr());
+    if (constant == nullptr ||
+        constant->get_element_type() != element::f32) {
+      return std::nullopt;
+    }
+    parameters.emplace_back(constant->get_vector<float>());
+  }
+  const auto& gamma = parameters[0];
+  const auto& beta = parameters[1];
+  const auto& mean = parameters[2];
+  const auto& variance = parameters[3];
+
+  auto eps = static_cast<float>(bn.get_eps_value());
+  BatchNormAffine affine;
+  for (size_t i = 0; i < gamma.size(); ++i) {
+    float scale = gamma[i] / std::sqrt(variance[i] + eps);
+    affine.scale.emplace_back(scale);
+    affine.shift.emplace_back(beta[i] - mean[i] * scale);
+  }
+  return affine;
+}
+
+/// \brief Replaces BatchNormInference(op(x, weights)) by
+/// Add(op(x, scaled_weights), Broadcast(shift))
+/// \param[in] bn BatchNormInference node
+/// \param[in] linear_op Convolution or Dot node computing the input of bn
+/// \param[in] channel_axis Axis of the weights indexing output channels
+/// \returns Whether or not the graph was modified
+bool fold_batch_norm(const std::shared_ptr<Node>& bn,
+                     const std::shared_ptr<Node>& linear_op,
+                     size_t channel_axis) {
+  if (bn->get_element_type() != element::f32 ||
+      linear_op->get_users().size() != 1) {
+    NGRAPH_HE_LOG(5) << "Not folding " << bn->get_name()
+                     << ": input is not f32 or has other users";
+    return false;
+  }
+  auto weights = std::dynamic_pointer_cast<op::Constant>(
+      linear_op->input_value(1).get_node_shared_ptr());
+  if (weights == nullptr || weights->get_element_type() != element::f32) {
+    NGRAPH_HE_LOG(5) << "Not folding " << bn->get_name()
+                     << ": weights are not f32 Constant";
+    return false;
+  }
+  auto affine =
+      batch_norm_affine(*std::static_pointer_cast<op::BatchNormInference>(bn));
+  if (!affine.has_value()) {
+    NGRAPH_HE_LOG(5) << "Not folding " << bn->get_name()
+                     << ": batch norm parameters are not f32 Constant";
+    return false;
+  }
+
+  const Shape& weights_shape = weights->get_shape();
+  const Shape& out_shape = bn->get_shape();
+  size_t num_channels = affine->scale.size();
+  if (weights_shape.size() <= channel_axis ||
+      weights_shape[channel_axis] != num_channels || out_shape.size() < 2 ||
+      out_shape[1] != num_channels) {
+    NGRAPH_HE_LOG(5) << "Not folding " << bn->get_name()
+                     << ": channel counts do not match";
+    return false;
+  }
+
+  // Weights are stored in row-major order
+  size_t channel_stride = 1;
+  for (size_t axis = channel_axis + 1; axis < weights_shape.size(); ++axis) {
+    channel_stride *= weights_shape[axis];
+  }
+  std::vector<float> weight_values = weights->get_vector<float>();
+  for (size_t i = 0; i < weight_values.size(); ++i) {
+    weight_values[i] *= affine->scale[(i / channel_stride) % num_channels];
+  }
+  auto scaled_weights =
+      op::Constant::create(element::f32, weights_shape, weight_values);
+  auto scaled_op = linear_op->copy_with_new_inputs(
+      OutputVector{linear_op->input_value(0), scaled_weights});
+
+  auto shift = op::Constant::create(element::f32, Shape{num_channels},
+                                    affine->shift);
+  AxisSet broadcast_axes;
+  for (size_t axis = 0; axis < out_shape.size(); ++axis) {
+    if (axis != 1) {
+      broadcast_axes.insert(axis);
+    }
+  }
+  auto bias = std::make_shared<op::Broadcast>(shift, out_shape, broadcast_axes);
+  auto add = std::make_shared<op::Add>(scaled_op, bias);
+
+  NGRAPH_HE_LOG(3) << "Folding " << bn->get_name() << " into "
+                   << linear_op->get_name();
+  replace_node(bn, add);
+  return true;
+}
+
+/// \brief Returns the AvgPool computing the input of a Convolution or Dot,
+/// possibly through a Reshape, or nullptr
+std::shared_ptr<op::AvgPool> avg_pool_input(const std::shared_ptr<Node>& n) {
+  std::shared_ptr<Node> input = n;
+  if (std::dynamic_pointer_cast<op::Reshape>(input) != nullptr) {
+    input = input->input_value(0).get_node_shared_ptr();
+  }
+  if (input->get_type_info() != op::AvgPool::type_info) {
+    return nullptr;
+  }
+  return std::static_pointer_cast<op::AvgPool>(input);
+}
+
+/// \brief Replaces op(AvgPool(x), weights) by op(SumPool(x), weights / n),
+/// with an optional Reshape between the pooling and op
+/// \param[in] linear_op Convolution or Dot node
+/// \returns Whether or not the graph was modified
+bool fold_avg_pool(const std::shared_ptr<Node>& linear_op) {
+  auto input = linear_op->input_value(0).get_node_shared_ptr();
+  auto avg_pool = avg_pool_input(input);
+  if (avg_pool == nullptr || avg_pool->get_element_type() != element::f32) {
+    return false;
+  }
+  if (input->get_users().size() != 1 || avg_pool->get_users().size() != 1) {
+    NGRAPH_HE_LOG(5) << "Not folding " << avg_pool->get_name()
+                     << ": output has other users";
+    return false;
+  }
+  auto weights = std::dynamic_pointer_cast<op::Constant>(
+      linear_op->input_value(1).get_node_shared_ptr());
+  if (weights == nullptr || weights->get_element_type() != element::f32) {
+    NGRAPH_HE_LOG(5) << "Not folding " << avg_pool->get_name()
+                     << ": weights are not f32 Constant";
+    return false;
+  }
+
+  // Without padding, every window lies within the input
+  auto is_zero = [](size_t x) { return x == 0; };
+  const Shape& padding_below = avg_pool->get_padding_below();
+  const Shape& padding_above = avg_pool->get_padding_above();
+  bool uniform_windows =
+      avg_pool->get_include_padding_in_avg_computation() ||
+      (std::all_of(padding_below.begin(), padding_below.end(), is_zero) &&
+       std::all_of(padding_above.begin(), padding_above.end(), is_zero));
+  if (!uniform_windows) {
+    NGRAPH_HE_LOG(5) << "Not folding " << avg_pool->get_name()
+                     << ": window sizes differ";
+    return false;
+  }
+
+  auto window_size =
+      static_cast<float>(shape_size(avg_pool->get_window_shape()));
+  std::vector<float> weight_values = weights->get_vector<float>();
+  for (auto& weight : weight_values) {
+    weight /= window_size;
+  }
+  auto scaled_weights = op::Constant::create(
+      element::f32, weights->get_shape(), weight_values);
+
+  std::shared_ptr<Node> sum_pool = std::make_shared<op::SumPool>(
+      avg_pool->input_value(0), avg_pool->get_window_shape(),
+      avg_pool->get_window_movement_strides(), avg_pool->get_padding_below(),
+      avg_pool->get_padding_above());
+  if (input != avg_pool) {
+    sum_pool = input->copy_with_new_inputs(OutputVector{sum_pool});
+  }
+  auto scaled_op = linear_op->copy_with_new_inputs(
+      OutputVector{sum_pool, scaled_weights});
+
+  NGRAPH_HE_LOG(3) << "Folding " << avg_pool->get_name() << " into "
+                   << linear_op->get_name();
+  replace_node(linear_op, scaled_op);
+  return true;
+}
+/// \brief Returns a Pad of zeros feeding a node, which pads only the spatial
+/// axes, i.e. not the batch and channel axes, by a non-negative amount, or
+/// nullptr
+std::shared_ptr<op::Pad> zero_spatial_pad(const std::shared_ptr<Node>& node) {
+  auto pad = std::dynamic_pointer_cast<op::Pad>(node);
+  if (pad == nullptr || pad->get_pad_mode() != op::PadMode::CONSTANT ||
+      pad->get_element_type() != element::f32) {
+    return nullptr;
+  }
+  auto pad_value = std::dynamic_pointer_cast<op::Constant>(
+      pad->input_value(1).get_node_shared_ptr());
+  if (pad_value == nullptr || pad_value->get_vector<float>() !=
+                                  std::vector<float>{0}) {
+    return nullptr;
+  }
+  for (const auto& padding :
+       {pad->get_padding_below(), pad->get_padding_above()}) {
+    if (padding.size() < 3 || padding[0] != 0 || padding[1] != 0 ||
+        std::any_of(padding.begin(), padding.end(),
+                    [](std::ptrdiff_t x) { return x < 0; })) {
+      return nullptr;
+    }
+  }
+  return pad;
+}
+
+/// \brief Returns padding with the spatial padding of a Pad added
+/// \param[in] padding Padding of the spatial axes
+/// \param[in] pad_padding Padding of the Pad, including the batch and
+/// channel axes
+template <typename T>
+T add_spatial_padding(const T& padding, const CoordinateDiff& pad_padding) {
+  T sum{padding};
+  for (size_t axis = 0; axis < sum.size(); ++axis) {
+    sum[axis] += static_cast<typename T::value_type>(pad_padding[axis + 2]);
+  }
+  return sum;
+}
+}  // namespace
+
+void HEFusion::construct_pad_conv() {
+  auto input = std::make_shared<pattern::op::Label>(
+      element::f32, Shape{1, 2, 2, 2}, [](const std::shared_ptr<Node>& n) {
+        return zero_spatial_pad(n) != nullptr;
+      });
+  auto filters =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2, 1, 1});
+  auto conv = std::make_shared<op::Convolution>(input, filters, Strides{1, 1},
+                                                Strides{1, 1});
+
+  auto callback = [](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_pad_conv against "
+                     << m.get_match_root()->get_name();
+    auto matched_conv =
+        std::static_pointer_cast<op::Convolution>(m.get_match_root());
+    auto pad = zero_spatial_pad(matched_conv->get_argument(0));
+    const Strides& data_dilation = matched_conv->get_data_dilation_strides();
+    if (std::any_of(data_dilation.begin(), data_dilation.end(),
+                    [](size_t x) { return x != 1; })) {
+      NGRAPH_HE_LOG(5) << "Convolution has data dilation";
+      return false;
+    }
+
+    auto folded = std::make_shared<op::Convolution>(
+        pad->input_value(0), matched_conv->input_value(1),
+        matched_conv->get_window_movement_strides(),
+        matched_conv->get_window_dilation_strides(),
+        add_spatial_padding(matched_conv->get_padding_below(),
+                            pad->get_padding_below()),
+        add_spatial_padding(matched_conv->get_padding_above(),
+                            pad->get_padding_above()),
+        data_dilation);
+    NGRAPH_HE_LOG(3) << "Folding " << pad->get_name() << " into "
+                     << matched_conv->get_name();
+    replace_node(matched_conv, folded);
+    return true;
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(conv, "PadConv");
+  this->add_matcher(m, callback);
+}
+
+void HEFusion::construct_pad_avg_pool() {
+  auto input = std::make_shared<pattern::op::Label>(
+      element::f32, Shape{1, 2, 2, 2}, [](const std::shared_ptr<Node>& n) {
+        return zero_spatial_pad(n) != nullptr;
+      });
+  auto avg_pool = std::make_shared<op::AvgPool>(input, Shape{1, 1});
+
+  auto callback = [](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_pad_avg_pool against "
+                     << m.get_match_root()->get_name();
+    auto matched_avg_pool =
+        std::static_pointer_cast<op::AvgPool>(m.get_match_root());
+    auto pad = zero_spatial_pad(matched_avg_pool->get_argument(0));
+    auto is_zero = [](size_t x) { return x == 0; };
+    const Shape& padding_below = matched_avg_pool->get_padding_below();
+    const Shape& padding_above = matched_avg_pool->get_padding_above();
+    // The padded zeros count towards the size of each window
+    if (!matched_avg_pool->get_include_padding_in_avg_computation() &&
+        !(std::all_of(padding_below.begin(), padding_below.end(), is_zero) &&
+          std::all_of(padding_above.begin(), padding_above.end(), is_zero))) {
+      NGRAPH_HE_LOG(5) << "AvgPool excludes its padding";
+      return false;
+    }
+
+    auto folded = std::make_shared<op::AvgPool>(
+        pad->input_value(0), matched_avg_pool->get_window_shape(),
+        matched_avg_pool->get_window_movement_strides(),
+        add_spatial_padding(padding_below, pad->get_padding_below()),
+        add_spatial_padding(padding_above, pad->get_padding_above()), true);
+    NGRAPH_HE_LOG(3) << "Folding " << pad->get_name() << " into "
+                     << matched_avg_pool->get_name();
+    replace_node(matched_avg_pool, folded);
+    return true;
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(avg_pool, "PadAvgPool");
+  this->add_matcher(m, callback);
+}
+
 void HEFusion::construct_bounded_relu() {
   auto relu_input = std::make_shared<pattern::op::Label>(element::f32, Shape{});
   auto relu = std::make_shared<op::Relu>(relu_input);
@@ -86,4 +407,173 @@ void HEFusion::construct_bounded_relu() {
   this->add_matcher(m, callback);
 }
 
+void HEFusion::construct_conv_batch_norm() {
+  auto input =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{1, 2, 2, 2});
+  auto filters =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2, 1, 1});
+  auto conv = std::make_shared<op::Convolution>(input, filters, Strides{1, 1},
+                                                Strides{1, 1});
+  auto conv_label = std::make_shared<pattern::op::Label>(
+      conv, nullptr, NodeVector{conv});
+
+  Shape channel_shape{2};
+  auto gamma =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto beta =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto mean =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto variance =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto bn = std::make_shared<op::BatchNormInference>(conv_label, gamma, beta,
+                                                     mean, variance, 0.001);
+
+  auto callback = [conv_label](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_conv_batch_norm against "
+                     << m.get_match_root()->get_name();
+    auto pattern_map = m.get_pattern_map();
+    // Filters are laid out as (C_out, C_in, ...)
+    return fold_batch_norm(m.get_match_root(), pattern_map[conv_label], 0);
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(bn, "ConvBatchNorm");
+  this->add_matcher(m, callback);
+}
+
+void HEFusion::construct_dot_batch_norm() {
+  auto input = std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2});
+  auto weights =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2});
+  auto dot = std::make_shared<op::Dot>(input, weights);
+  auto dot_label =
+      std::make_shared<pattern::op::Label>(dot, nullptr, NodeVector{dot});
+
+  Shape channel_shape{2};
+  auto gamma =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto beta =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto mean =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto variance =
+      std::make_shared<pattern::op::Label>(element::f32, channel_shape);
+  auto bn = std::make_shared<op::BatchNormInference>(dot_label, gamma, beta,
+                                                     mean, variance, 0.001);
+
+  auto callback = [dot_label](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_dot_batch_norm against "
+                     << m.get_match_root()->get_name();
+    auto pattern_map = m.get_pattern_map();
+    auto matched_dot =
+        std::static_pointer_cast<op::Dot>(pattern_map[dot_label]);
+    // Only (N, K) x (K, C) products have output channels along axis 1
+    if (matched_dot->get_reduction_axes_count() != 1 ||
+        matched_dot->get_input_shape(0).size() != 2 ||
+        matched_dot->get_input_shape(1).size() != 2) {
+      NGRAPH_HE_LOG(5) << "Dot is not a matrix product";
+      return false;
+    }
+    // Weights are laid out as (K, C)
+    return fold_batch_norm(m.get_match_root(), matched_dot, 1);
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(bn, "DotBatchNorm");
+  this->add_matcher(m, callback);
+}
+
+void HEFusion::construct_conv_bias_relu() {
+  auto input =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{1, 2, 2, 2});
+  auto filters =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2, 1, 1});
+  auto conv = std::make_shared<op::Convolution>(input, filters, Strides{1, 1},
+                                                Strides{1, 1});
+  auto conv_label =
+      std::make_shared<pattern::op::Label>(conv, nullptr, NodeVector{conv});
+
+  auto is_constant_bias = [](const std::shared_ptr<Node>& n) {
+    if (std::dynamic_pointer_cast<op::Broadcast>(n) != nullptr) {
+      return n->input_value(0).get_node()->is_constant();
+    }
+    return n->is_constant();
+  };
+  auto bias = std::make_shared<pattern::op::Label>(
+      element::f32, Shape{1, 2, 2, 2}, is_constant_bias);
+  auto add = std::make_shared<op::Add>(conv_label, bias);
+  auto relu = std::make_shared<op::Relu>(add);
+
+  auto callback = [conv_label, bias](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_conv_bias_relu against "
+                     << m.get_match_root()->get_name();
+    auto pattern_map = m.get_pattern_map();
+    auto matched_conv =
+        std::static_pointer_cast<op::Convolution>(pattern_map[conv_label]);
+    auto matched_add = m.get_match_root()->input_value(0).get_node_shared_ptr();
+    if (matched_conv->get_users().size() != 1 ||
+        matched_add->get_users().size() != 1) {
+      NGRAPH_HE_LOG(5) << "Convolution or bias has other users";
+      return false;
+    }
+    if (pattern_map[bias]->get_shape() != matched_conv->get_shape()) {
+      NGRAPH_HE_LOG(5) << "Bias shape does not match convolution";
+      return false;
+    }
+
+    auto fused = std::make_shared<op::ConvolutionBiasRelu>(
+        matched_conv->input_value(0), matched_conv->input_value(1),
+        pattern_map[bias], matched_conv->get_window_movement_strides(),
+        matched_conv->get_window_dilation_strides(),
+        matched_conv->get_padding_below(), matched_conv->get_padding_above(),
+        matched_conv->get_data_dilation_strides());
+    NGRAPH_HE_LOG(3) << "Fusing " << matched_conv->get_name() << " into "
+                     << fused->get_name();
+    replace_node(m.get_match_root(), fused);
+    return true;
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(relu, "ConvBiasRelu");
+  this->add_matcher(m, callback);
+}
+
+void HEFusion::construct_conv_avg_pool() {
+  auto input = std::make_shared<pattern::op::Label>(
+      element::f32, Shape{1, 2, 2, 2},
+      [](const std::shared_ptr<Node>& n) {
+        return avg_pool_input(n) != nullptr;
+      });
+  auto filters =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2, 1, 1});
+  auto conv = std::make_shared<op::Convolution>(input, filters, Strides{1, 1},
+                                                Strides{1, 1});
+
+  auto callback = [](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_conv_avg_pool against "
+                     << m.get_match_root()->get_name();
+    return fold_avg_pool(m.get_match_root());
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(conv, "ConvAvgPool");
+  this->add_matcher(m, callback);
+}
+
+void HEFusion::construct_dot_avg_pool() {
+  auto input = std::make_shared<pattern::op::Label>(
+      element::f32, Shape{2, 2}, [](const std::shared_ptr<Node>& n) {
+        return avg_pool_input(n) != nullptr;
+      });
+  auto weights =
+      std::make_shared<pattern::op::Label>(element::f32, Shape{2, 2});
+  auto dot = std::make_shared<op::Dot>(input, weights);
+
+  auto callback = [](pattern::Matcher& m) {
+    NGRAPH_HE_LOG(5) << "In a callback for construct_dot_avg_pool against "
+                     << m.get_match_root()->get_name();
+    return fold_avg_pool(m.get_match_root());
+  };
+
+  auto m = std::make_shared<pattern::Matcher>(dot, "DotAvgPool");
+  this->add_matcher(m, callback);
+}
+
 }  // namespace ngraph::runtime::he::pass
@@ -23,9 +23,54 @@ namespace ngraph::runtime::he::pass {
 /// \brief performs HE-friendly fusion operations
 class HEFusion : public ngraph::pass::GraphRewrite {
  public:
-  HEFusion() : GraphRewrite() { construct_bounded_relu(); }
+  HEFusion() : GraphRewrite() {
+    construct_pad_conv();
+    construct_pad_avg_pool();
+    construct_bounded_relu();
+    construct_conv_batch_norm();
+    construct_dot_batch_norm();
+    construct_conv_bias_relu();
+    construct_conv_avg_pool();
+    construct_dot_avg_pool();
+  }
+
+  /// \brief Folds Convolution(Pad(x, 0), w), padding only the spatial axes
+  /// by a non-negative amount, into the padding of Convolution(x, w), so the
+  /// padded input is never materialized. Convolutions with data dilation
+  /// are not folded
+  void construct_pad_conv();
+
+  /// \brief Folds AvgPool(Pad(x, 0)) into the padding of AvgPool(x), which
+  /// then includes the padding in the average, as construct_pad_conv. Only
+  /// AvgPools which include their padding, or have none, are folded
+  void construct_pad_avg_pool();
 
   /// \brief Fuses Min(Relu, Constant) op into BoundedRelu(Constant) op
   void construct_bounded_relu();
+
+  /// \brief Folds BatchNormInference(Convolution(x, Constant)) with Constant
+  /// batch norm parameters into Add(Convolution(x, Constant), bias), scaling
+  /// each output channel of the filters, which saves a multiplicative level
+  void construct_conv_batch_norm();
+
+  /// \brief Folds BatchNormInference(Dot(x, Constant)) with Constant batch
+  /// norm parameters into Add(Dot(x, Constant), bias), scaling each column of
+  /// the weights, which saves a multiplicative level
+  void construct_dot_batch_norm();
+
+  /// \brief Fuses Relu(Add(Convolution(x, w), bias)) with a Constant or
+  /// broadcast Constant bias into ConvolutionBiasRelu(x, w, bias), so the
+  /// client computes the ReLU of each output channel as soon as it is ready
+  void construct_conv_bias_relu();
+
+  /// \brief Folds the division of AvgPool into Convolution(AvgPool(x),
+  /// Constant), replacing AvgPool by SumPool and dividing the filters by the
+  /// window size, which saves a multiplicative level. Only AvgPools whose
+  /// windows all have the same size are folded
+  void construct_conv_avg_pool();
+
+  /// \brief Folds the division of AvgPool into Dot(AvgPool(x), Constant) or
+  /// Dot(Reshape(AvgPool(x)), Constant), as construct_conv_avg_pool
+  void construct_dot_avg_pool();
 };
 }  // namespace ngraph::runtime::he::pass
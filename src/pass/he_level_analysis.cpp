@@ -0,0 +1,168 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/he_level_analysis.hpp"
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "he_op_annotations.hpp"
+#include "he_util.hpp"
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/op/add.hpp"
+#include "ngraph/op/avg_pool.hpp"
+#include "ngraph/op/convolution.hpp"
+#include "ngraph/op/dot.hpp"
+#include "ngraph/op/fused/group_conv.hpp"
+#include "ngraph/op/max_pool.hpp"
+#include "ngraph/op/multiply.hpp"
+#include "ngraph/op/relu.hpp"
+#include "ngraph/op/subtract.hpp"
+#include "op/bounded_relu.hpp"
+#include "op/convolution_bias_relu.hpp"
+#include "op/refresh.hpp"
+#include "op/sum_pool.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+bool is_encrypted(const Node& node) {
+  return HEOpAnnotations::has_he_annotation(node) &&
+         HEOpAnnotations::he_op_annotation(node)->encrypted();
+}
+
+/// \brief Returns whether or not the executable rescales the op's output
+bool rescales_output(const Node& node) {
+  // SumPool derives from AvgPool, but does not divide
+  if (dynamic_cast<const op::SumPool*>(&node) != nullptr) {
+    return false;
+  }
+  return dynamic_cast<const op::AvgPool*>(&node) != nullptr ||
+         dynamic_cast<const op::Convolution*>(&node) != nullptr ||
+         dynamic_cast<const op::Dot*>(&node) != nullptr ||
+         dynamic_cast<const op::GroupConvolution*>(&node) != nullptr ||
+         dynamic_cast<const op::Multiply*>(&node) != nullptr;
+}
+
+/// \brief Returns whether or not the op's arithmetic requires all its
+/// encrypted inputs to be at the same level
+bool matches_input_levels(const Node& node) {
+  return dynamic_cast<const op::Add*>(&node) != nullptr ||
+         dynamic_cast<const op::Convolution*>(&node) != nullptr ||
+         dynamic_cast<const op::ConvolutionBiasRelu*>(&node) != nullptr ||
+         dynamic_cast<const op::Dot*>(&node) != nullptr ||
+         dynamic_cast<const op::GroupConvolution*>(&node) != nullptr ||
+         dynamic_cast<const op::Multiply*>(&node) != nullptr ||
+         dynamic_cast<const op::Subtract*>(&node) != nullptr;
+}
+}  // namespace
+
+bool pass::HELevelAnalysis::run_on_function(
+    std::shared_ptr<Function> function) {
+  m_depths.clear();
+  m_mod_switch_inputs.clear();
+
+  std::list<std::shared_ptr<Node>> nodes = function->get_ordered_ops();
+  for (const auto& node : nodes) {
+    if (!is_encrypted(*node)) {
+      continue;
+    }
+
+    std::optional<size_t> polynomial_depth;
+    if (m_polynomial_depth) {
+      polynomial_depth = m_polynomial_depth(*node);
+    }
+
+    // Re-encrypted outputs start at the first level
+    bool reencrypted =
+        dynamic_cast<const op::Refresh*>(node.get()) != nullptr ||
+        (!polynomial_depth.has_value() &&
+         (dynamic_cast<const op::Relu*>(node.get()) != nullptr ||
+          dynamic_cast<const op::BoundedRelu*>(node.get()) != nullptr ||
+          (m_enable_client &&
+           (dynamic_cast<const op::MaxPool*>(node.get()) != nullptr ||
+            dynamic_cast<const op::ConvolutionBiasRelu*>(node.get()) !=
+                nullptr ||
+            client_elementwise_function(node->description()) != nullptr))));
+
+    std::vector<std::optional<size_t>> input_depths;
+    std::optional<size_t> max_depth;
+    for (const auto& input : node->inputs()) {
+      input_depths.emplace_back(depth(*input.get_source_output().get_node()));
+      if (input_depths.back().has_value()) {
+        max_depth = std::max(max_depth.value_or(0), *input_depths.back());
+      }
+    }
+
+    if (matches_input_levels(*node) && max_depth.has_value()) {
+      std::vector<size_t> inputs;
+      for (size_t i = 0; i < input_depths.size(); ++i) {
+        if (input_depths[i].has_value() && *input_depths[i] < *max_depth) {
+          inputs.emplace_back(i);
+        }
+      }
+      if (!inputs.empty()) {
+        NGRAPH_HE_LOG(5) << "Mod-switching " << inputs.size()
+                         << " inputs of " << node->get_name()
+                         << " to depth " << *max_depth;
+        m_mod_switch_inputs[node.get()] = std::move(inputs);
+      }
+    }
+
+    size_t node_depth = reencrypted ? 0 : max_depth.value_or(0);
+    // Without the client, the fused convolution is rescaled before its ReLU
+    bool fused_rescale =
+        (!m_enable_client || polynomial_depth.has_value()) &&
+        dynamic_cast<const op::ConvolutionBiasRelu*>(node.get()) != nullptr;
+    bool skips_rescale = m_skips_rescale && m_skips_rescale(*node);
+    if ((rescales_output(*node) && !skips_rescale) || fused_rescale) {
+      ++node_depth;
+    }
+    node_depth += polynomial_depth.value_or(0);
+    m_depths[node.get()] = node_depth;
+  }
+  return false;
+}
+
+std::optional<size_t> pass::HELevelAnalysis::depth(const Node& node) const {
+  auto it = m_depths.find(&node);
+  if (it == m_depths.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+size_t pass::HELevelAnalysis::max_depth() const {
+  size_t max_depth = 0;
+  for (const auto& node_depth : m_depths) {
+    max_depth = std::max(max_depth, node_depth.second);
+  }
+  return max_depth;
+}
+
+const std::vector<size_t>& pass::HELevelAnalysis::mod_switch_inputs(
+    const Node& node) const {
+  static const std::vector<size_t> no_inputs;
+  auto it = m_mod_switch_inputs.find(&node);
+  return it == m_mod_switch_inputs.end() ? no_inputs : it->second;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,87 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ngraph/node.hpp"
+#include "ngraph/pass/graph_rewrite.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Tracks the number of rescales applied to each encrypted tensor, as
+/// determined by the HE op annotations, and selects where to modulus-switch.
+/// For ops combining encrypted inputs of different depths, the shallower
+/// inputs are modulus-switched to the deepest input's level just before the
+/// op, i.e. as late as possible, so other consumers keep the higher level.
+/// Must run after PropagateHEAnnotations
+class HELevelAnalysis : public ngraph::pass::FunctionPass {
+ public:
+  /// \brief Returns the number of rescales consumed by computing a node on
+  /// the server with a polynomial, e.g. an approximated activation, or
+  /// std::nullopt if the node is not computed by a polynomial
+  using PolynomialDepth = std::function<std::optional<size_t>(const Node&)>;
+
+  /// \brief Returns whether or not a node which is usually rescaled leaves
+  /// its output at the level of its inputs, e.g. a Dot with quantized weights
+  using SkipsRescale = std::function<bool(const Node&)>;
+
+  /// \param[in] enable_client Whether or not ReLU and MaxPool are computed by
+  /// the client, which returns fresh ciphertexts
+  /// \param[in] polynomial_depth Depth of activations approximated by
+  /// polynomials, which are not re-encrypted. If nullptr, no activation is
+  /// approximated
+  /// \param[in] skips_rescale Nodes which are not rescaled. If nullptr, all
+  /// such nodes are rescaled
+  explicit HELevelAnalysis(bool enable_client,
+                           PolynomialDepth polynomial_depth = nullptr,
+                           SkipsRescale skips_rescale = nullptr)
+      : m_enable_client(enable_client),
+        m_polynomial_depth(std::move(polynomial_depth)),
+        m_skips_rescale(std::move(skips_rescale)) {}
+
+  /// \brief Returns false, indicating the function has not been modified
+  /// \param[in] function Function which to run pass on
+  bool run_on_function(std::shared_ptr<Function> function) override;
+
+  /// \brief Returns the number of rescales applied to the output of a node
+  /// since its inputs were encrypted, or std::nullopt if the output is not
+  /// encrypted
+  /// \param[in] node Node of the analyzed function
+  std::optional<size_t> depth(const Node& node) const;
+
+  /// \brief Returns the largest depth of any encrypted node, i.e. the number
+  /// of rescales the coefficient modulus chain must support
+  size_t max_depth() const;
+
+  /// \brief Returns the inputs of a node to modulus-switch to the level of
+  /// the node's deepest encrypted input before computing the node
+  /// \param[in] node Node of the analyzed function
+  const std::vector<size_t>& mod_switch_inputs(const Node& node) const;
+
+ private:
+  bool m_enable_client;
+  PolynomialDepth m_polynomial_depth;
+  SkipsRescale m_skips_rescale;
+  std::unordered_map<const Node*, size_t> m_depths;
+  std::unordered_map<const Node*, std::vector<size_t>> m_mod_switch_inputs;
+};
+}  // namespace ngraph::runtime::he::pass
@@ -19,7 +19,9 @@
 #include <exception>
 #include <list>
 #include <sstream>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "ngraph/descriptor/input.hpp"
 #include "ngraph/descriptor/output.hpp"
@@ -34,71 +36,88 @@
 
 namespace ngraph::runtime::he {
 bool pass::HELiveness::run_on_function(std::shared_ptr<Function> function) {
-  std::list<std::shared_ptr<Node>> ops = function->get_ordered_ops();
+  run_on_ordered_ops(*function, function->get_ordered_ops());
+  return false;
+}
 
-  std::unordered_set<descriptor::Tensor*> persistent_tensors;
-  std::unordered_set<descriptor::Tensor*> output_tensors;
+void pass::HELiveness::run_on_ordered_ops(
+    const Function& function, const std::list<std::shared_ptr<Node>>& ops) {
+  // Tensors are numbered once, so the liveness of each tensor is a flag
+  // rather than a lookup in a hash set per node
+  std::unordered_map<descriptor::Tensor*, size_t> tensor_ids;
+  std::vector<descriptor::Tensor*> tensors;
+  auto tensor_id = [&](descriptor::Tensor& tensor) {
+    auto [it, inserted] = tensor_ids.emplace(&tensor, tensors.size());
+    if (inserted) {
+      tensors.emplace_back(&tensor);
+    }
+    return it->second;
+  };
+  for (const auto& node : ops) {
+    for (auto& output : node->outputs()) {
+      tensor_id(output.get_tensor());
+    }
+  }
 
-  // Only result nodes are persistent
-  for (const std::shared_ptr<op::Result>& node : function->get_results()) {
+  // Only result nodes are persistent, and never freed
+  std::vector<bool> persistent(tensors.size(), false);
+  for (const std::shared_ptr<op::Result>& node : function.get_results()) {
     for (auto& output : node->outputs()) {
-      descriptor::Tensor& tensor = output.get_tensor();
-      persistent_tensors.insert(&tensor);
-      output_tensors.insert(&tensor);
+      size_t id = tensor_id(output.get_tensor());
+      persistent.resize(tensors.size(), false);
+      persistent[id] = true;
     }
   }
 
-  std::unordered_set<descriptor::Tensor*> currently_live;
-  for (auto it = ops.rbegin(); it != ops.rend(); it++) {
+  std::vector<bool> currently_live(tensors.size(), false);
+  // Node index + 1 at which a tensor was last visited, so tensors read by
+  // several inputs of a node are visited once
+  std::vector<size_t> visited(tensors.size(), 0);
+  // Non-persistent tensors of the current node, outputs first
+  std::vector<size_t> node_tensors;
+  size_t node_idx = 0;
+  for (auto it = ops.rbegin(); it != ops.rend(); it++, node_idx++) {
     const std::shared_ptr<Node>& node = *it;
     node->liveness_new_list.clear();
     node->liveness_free_list.clear();
-    std::unordered_set<descriptor::Tensor*> input_tensor_decls;
-    for (auto& input : node->inputs()) {
-      descriptor::Tensor& tensor = input.get_tensor();
-      if (persistent_tensors.find(&tensor) == persistent_tensors.end()) {
-        input_tensor_decls.insert(&tensor);
-      }
-    }
 
-    std::unordered_set<descriptor::Tensor*> output_tensor_decls;
-    for (auto& output : node->outputs()) {
-      descriptor::Tensor& tensor = output.get_tensor();
-      if (persistent_tensors.find(&tensor) == persistent_tensors.end()) {
-        output_tensor_decls.insert(&tensor);
+    node_tensors.clear();
+    auto visit = [&](descriptor::Tensor& tensor) {
+      size_t id = tensor_id(tensor);
+      if (id >= persistent.size()) {
+        persistent.resize(tensors.size(), false);
+        currently_live.resize(tensors.size(), false);
+        visited.resize(tensors.size(), 0);
+      }
+      if (!persistent[id] && visited[id] != node_idx + 1) {
+        visited[id] = node_idx + 1;
+        node_tensors.emplace_back(id);
       }
+    };
+    for (auto& output : node->outputs()) {
+      visit(output.get_tensor());
+    }
+    size_t num_outputs = node_tensors.size();
+    for (auto& input : node->inputs()) {
+      visit(input.get_tensor());
     }
 
-    std::unordered_set<descriptor::Tensor*> free_tensor_decls;
-    std::unordered_set<descriptor::Tensor*> new_tensor_decls;
-    std::unordered_set<descriptor::Tensor*> all_tensor_decls =
-        input_tensor_decls;
-    all_tensor_decls.insert(output_tensor_decls.begin(),
-                            output_tensor_decls.end());
-
-    for (descriptor::Tensor* tensor_decl : all_tensor_decls) {
-      if (currently_live.find(tensor_decl) == currently_live.end()) {
-        // this is the last node that value is seen in
-        // delete it at the end of the op
-        currently_live.insert(tensor_decl);
-        if (output_tensors.find(tensor_decl) == output_tensors.end()) {
-          // Don't free output tensors
-          free_tensor_decls.insert(tensor_decl);
-        }
+    // The last node a tensor is seen in frees it at the end of the op
+    for (size_t id : node_tensors) {
+      if (!currently_live[id]) {
+        currently_live[id] = true;
+        node->liveness_free_list.insert(tensors[id]);
       }
     }
-
-    for (descriptor::Tensor* output_decl : output_tensor_decls) {
-      auto currently_live_it = currently_live.find(output_decl);
-      if (currently_live_it != currently_live.end()) {
-        new_tensor_decls.insert(output_decl);
-        currently_live.erase(currently_live_it);
+    // The node writing a tensor creates it
+    for (size_t output_idx = 0; output_idx < num_outputs; ++output_idx) {
+      size_t id = node_tensors[output_idx];
+      if (currently_live[id]) {
+        node->liveness_new_list.insert(tensors[id]);
+        currently_live[id] = false;
       }
     }
-    node->liveness_free_list = free_tensor_decls;
-    node->liveness_new_list = new_tensor_decls;
   }
-  return false;
 }
 
 }  // namespace ngraph::runtime::he
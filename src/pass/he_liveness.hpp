@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 
 #include "ngraph/pass/graph_rewrite.hpp"
@@ -30,5 +31,12 @@ class HELiveness : public ngraph::pass::FunctionPass {
   /// \param[in,out] function Function to perform pass on
   /// \returns false, indicating the function has not been modified
   bool run_on_function(std::shared_ptr<Function> function) override;
+
+  /// \brief Performs HELiveness pass on given function, whose ops execute in
+  /// the given order rather than that of Function::get_ordered_ops
+  /// \param[in] function Function to perform pass on
+  /// \param[in] ops Topologically ordered ops of the function
+  static void run_on_ordered_ops(const Function& function,
+                                 const std::list<std::shared_ptr<Node>>& ops);
 };
 }  // namespace ngraph::runtime::he::pass
@@ -0,0 +1,222 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/he_memory_order.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/descriptor/tensor.hpp"
+
+namespace ngraph::runtime::he::pass {
+
+namespace {
+
+/// \brief Tensors produced and read by each op, indexed by position in a
+/// topological order
+class OpTensors {
+ public:
+  OpTensors(const std::list<std::shared_ptr<Node>>& ops,
+            const TensorBytes& tensor_bytes) {
+    std::unordered_map<const Node*, size_t> op_indices;
+    std::unordered_map<const descriptor::Tensor*, size_t> tensor_indices;
+    for (const auto& op : ops) {
+      size_t op_idx = m_ops.size();
+      op_indices[op.get()] = op_idx;
+      m_ops.emplace_back(op);
+      m_outputs.emplace_back();
+      m_inputs.emplace_back();
+      m_predecessors.emplace_back();
+      for (size_t i = 0; i < op->get_output_size(); ++i) {
+        tensor_indices[&op->output(i).get_tensor()] = m_tensor_bytes.size();
+        m_outputs[op_idx].emplace_back(m_tensor_bytes.size());
+        m_tensor_bytes.emplace_back(tensor_bytes(*op, i));
+        m_tensor_readers.emplace_back(0);
+      }
+    }
+
+    for (size_t op_idx = 0; op_idx < m_ops.size(); ++op_idx) {
+      Node& op = *m_ops[op_idx];
+      std::set<size_t> inputs;
+      for (const auto& input : op.inputs()) {
+        auto it = tensor_indices.find(&input.get_tensor());
+        NGRAPH_CHECK(it != tensor_indices.end(), "Input of ", op.get_name(),
+                     " is not produced by an ordered op");
+        inputs.insert(it->second);
+      }
+      m_inputs[op_idx].assign(inputs.begin(), inputs.end());
+      for (size_t tensor_idx : inputs) {
+        m_tensor_readers[tensor_idx]++;
+      }
+
+      std::set<size_t> predecessors;
+      for (const auto& arg : op.get_arguments()) {
+        predecessors.insert(op_indices.at(arg.get()));
+      }
+      for (const auto& dependency : op.get_control_dependencies()) {
+        auto it = op_indices.find(dependency.get());
+        if (it != op_indices.end()) {
+          predecessors.insert(it->second);
+        }
+      }
+      m_predecessors[op_idx].assign(predecessors.begin(), predecessors.end());
+    }
+  }
+
+  size_t size() const { return m_ops.size(); }
+
+  const std::shared_ptr<Node>& op(size_t op_idx) const {
+    return m_ops[op_idx];
+  }
+
+  const std::vector<size_t>& predecessors(size_t op_idx) const {
+    return m_predecessors[op_idx];
+  }
+
+  /// \brief Returns the bytes which executing an op adds to the live bytes
+  /// while it executes, and removes from them once it completes
+  /// \param[in] op_idx Index of the op
+  /// \param[in] remaining_readers Readers of each tensor yet to execute
+  std::pair<size_t, size_t> live_bytes_delta(
+      size_t op_idx, const std::vector<size_t>& remaining_readers) const {
+    size_t allocated = 0;
+    size_t freed = 0;
+    for (size_t tensor_idx : m_outputs[op_idx]) {
+      allocated += m_tensor_bytes[tensor_idx];
+      if (m_tensor_readers[tensor_idx] == 0) {
+        freed += m_tensor_bytes[tensor_idx];
+      }
+    }
+    for (size_t tensor_idx : m_inputs[op_idx]) {
+      if (remaining_readers[tensor_idx] == 1) {
+        freed += m_tensor_bytes[tensor_idx];
+      }
+    }
+    return {allocated, freed};
+  }
+
+  /// \brief Executes an op, updating the readers of its inputs
+  void execute(size_t op_idx, std::vector<size_t>& remaining_readers) const {
+    for (size_t tensor_idx : m_inputs[op_idx]) {
+      remaining_readers[tensor_idx]--;
+    }
+  }
+
+  std::vector<size_t> tensor_readers() const { return m_tensor_readers; }
+
+ private:
+  std::vector<std::shared_ptr<Node>> m_ops;
+  std::vector<std::vector<size_t>> m_outputs;
+  std::vector<std::vector<size_t>> m_inputs;
+  std::vector<std::vector<size_t>> m_predecessors;
+  std::vector<size_t> m_tensor_bytes;
+  std::vector<size_t> m_tensor_readers;
+};
+
+}  // namespace
+
+size_t peak_live_bytes(const std::list<std::shared_ptr<Node>>& ops,
+                       const TensorBytes& tensor_bytes) {
+  OpTensors op_tensors(ops, tensor_bytes);
+  std::vector<size_t> remaining_readers = op_tensors.tensor_readers();
+  size_t live_bytes = 0;
+  size_t peak = 0;
+  for (size_t op_idx = 0; op_idx < op_tensors.size(); ++op_idx) {
+    auto [allocated, freed] =
+        op_tensors.live_bytes_delta(op_idx, remaining_readers);
+    live_bytes += allocated;
+    peak = std::max(peak, live_bytes);
+    live_bytes -= freed;
+    op_tensors.execute(op_idx, remaining_readers);
+  }
+  return peak;
+}
+
+std::list<std::shared_ptr<Node>> memory_minimizing_order(
+    const std::list<std::shared_ptr<Node>>& ops,
+    const TensorBytes& tensor_bytes) {
+  OpTensors op_tensors(ops, tensor_bytes);
+  const size_t num_ops = op_tensors.size();
+  std::vector<size_t> remaining_readers = op_tensors.tensor_readers();
+  std::vector<size_t> remaining_predecessors(num_ops);
+  std::vector<std::vector<size_t>> successors(num_ops);
+  // Ordered by position in the given order, which breaks ties
+  std::set<size_t> ready;
+  for (size_t op_idx = 0; op_idx < num_ops; ++op_idx) {
+    remaining_predecessors[op_idx] = op_tensors.predecessors(op_idx).size();
+    for (size_t predecessor : op_tensors.predecessors(op_idx)) {
+      successors[predecessor].emplace_back(op_idx);
+    }
+    if (remaining_predecessors[op_idx] == 0) {
+      ready.insert(op_idx);
+    }
+  }
+
+  std::list<std::shared_ptr<Node>> order;
+  size_t live_bytes = 0;
+  size_t peak = 0;
+  while (!ready.empty()) {
+    // Ops are ranked by the net bytes they add, then by the bytes they add
+    // while executing
+    size_t best_idx = *ready.begin();
+    auto best_rank = std::make_pair(std::numeric_limits<int64_t>::max(),
+                                    std::numeric_limits<size_t>::max());
+    for (size_t op_idx : ready) {
+      auto [allocated, freed] =
+          op_tensors.live_bytes_delta(op_idx, remaining_readers);
+      auto rank = std::make_pair(
+          static_cast<int64_t>(allocated) - static_cast<int64_t>(freed),
+          allocated);
+      if (rank < best_rank) {
+        best_idx = op_idx;
+        best_rank = rank;
+      }
+    }
+
+    auto [allocated, freed] =
+        op_tensors.live_bytes_delta(best_idx, remaining_readers);
+    live_bytes += allocated;
+    peak = std::max(peak, live_bytes);
+    live_bytes -= freed;
+    op_tensors.execute(best_idx, remaining_readers);
+    ready.erase(best_idx);
+    order.emplace_back(op_tensors.op(best_idx));
+    for (size_t successor : successors[best_idx]) {
+      if (--remaining_predecessors[successor] == 0) {
+        ready.insert(successor);
+      }
+    }
+  }
+  NGRAPH_CHECK(order.size() == num_ops, "Ops are not topologically ordered");
+
+  size_t ordered_peak = peak_live_bytes(ops, tensor_bytes);
+  if (peak >= ordered_peak) {
+    NGRAPH_HE_LOG(3) << "Keeping topological order with peak " << ordered_peak
+                     << " live bytes";
+    return ops;
+  }
+  NGRAPH_HE_LOG(3) << "Reordered ops to lower peak live bytes from "
+                   << ordered_peak << " to " << peak;
+  return order;
+}
+
+}  // namespace ngraph::runtime::he::pass
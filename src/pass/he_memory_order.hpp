@@ -0,0 +1,51 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+
+#include "ngraph/node.hpp"
+
+namespace ngraph::runtime::he::pass {
+
+/// \brief Returns the bytes of output output_idx of a node
+using TensorBytes = std::function<size_t(const Node& node, size_t output_idx)>;
+
+/// \brief Returns the peak bytes of live tensors when ops execute in the given
+/// order. A tensor is live from the op producing it until its last reader
+/// completes; tensors without readers are freed after their producer
+/// \param[in] ops Topologically ordered ops
+/// \param[in] tensor_bytes Bytes of each output tensor
+size_t peak_live_bytes(const std::list<std::shared_ptr<Node>>& ops,
+                       const TensorBytes& tensor_bytes);
+
+/// \brief Returns a topological order of ops which greedily minimizes the peak
+/// bytes of live tensors, see peak_live_bytes. Of the ops whose arguments and
+/// control dependencies have executed, each step executes the op adding the
+/// fewest live bytes, i.e. with the fewest output bytes less the bytes of the
+/// inputs it reads last, preferring earlier ops of the given order on ties.
+/// If the greedy order does not lower the peak, the given order is returned
+/// \param[in] ops Topologically ordered ops, e.g. of Function::get_ordered_ops
+/// \param[in] tensor_bytes Bytes of each output tensor
+std::list<std::shared_ptr<Node>> memory_minimizing_order(
+    const std::list<std::shared_ptr<Node>>& ops,
+    const TensorBytes& tensor_bytes);
+
+}  // namespace ngraph::runtime::he::pass
@@ -0,0 +1,92 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/insert_refresh.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "he_op_annotations.hpp"
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "op/refresh.hpp"
+
+namespace ngraph::runtime::he {
+
+bool pass::InsertRefresh::run_on_function(std::shared_ptr<Function> function) {
+  // Refreshes inserted for earlier consumers of each output
+  std::map<std::pair<Node*, size_t>, std::shared_ptr<op::Refresh>> refreshes;
+  bool modified = false;
+  while (true) {
+    HELevelAnalysis level_analysis(true, m_polynomial_depth, m_skips_rescale);
+    level_analysis.run_on_function(function);
+
+    // The first node too deep consumes its inputs' levels plus its own
+    std::shared_ptr<Node> deep_node;
+    for (const auto& node : function->get_ordered_ops()) {
+      auto depth = level_analysis.depth(*node);
+      if (depth.has_value() && *depth > m_max_depth) {
+        deep_node = node;
+        break;
+      }
+    }
+    if (deep_node == nullptr) {
+      return modified;
+    }
+    size_t max_input_depth = 0;
+    for (const auto& input : deep_node->inputs()) {
+      max_input_depth = std::max(
+          max_input_depth,
+          level_analysis.depth(*input.get_source_output().get_node())
+              .value_or(0));
+    }
+    size_t node_depth = *level_analysis.depth(*deep_node) - max_input_depth;
+
+    bool refreshed = false;
+    for (auto& input : deep_node->inputs()) {
+      auto source = input.get_source_output();
+      auto input_depth = level_analysis.depth(*source.get_node());
+      if (!input_depth.has_value() || *input_depth == 0 ||
+          *input_depth + node_depth <= m_max_depth) {
+        continue;
+      }
+      auto& refresh = refreshes[{source.get_node(), source.get_index()}];
+      if (refresh == nullptr) {
+        refresh = std::make_shared<op::Refresh>(source);
+        auto annotation = std::make_shared<HEOpAnnotations>(
+            *HEOpAnnotations::he_op_annotation(*source.get_node()));
+        annotation->set_from_client(false);
+        refresh->set_op_annotations(annotation);
+        NGRAPH_HE_LOG(3) << "Refreshing " << source.get_node()->get_name()
+                         << " at depth " << *input_depth;
+      }
+      input.replace_source_output(refresh->output(0));
+      refreshed = true;
+    }
+    NGRAPH_CHECK(refreshed, "Node ", deep_node->get_name(), " consumes ",
+                 node_depth,
+                 " levels, but the coefficient modulus chain supports depth ",
+                 m_max_depth);
+    modified = true;
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,60 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "ngraph/pass/graph_rewrite.hpp"
+#include "pass/he_level_analysis.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Inserts a Refresh op before each node whose encrypted output would
+/// be deeper than the coefficient modulus chain supports. The client
+/// re-encrypts refreshed values at a higher level, so deep linear stacks
+/// without nearby activations run on shorter chains. Each refresh is placed
+/// as late as possible, just before the node running out of levels, and
+/// shared by all consumers of the refreshed output. Must run after
+/// PropagateHEAnnotations
+class InsertRefresh : public ngraph::pass::FunctionPass {
+ public:
+  /// \param[in] max_depth Number of rescales the coefficient modulus chain
+  /// supports
+  /// \param[in] polynomial_depth Depth of activations approximated by
+  /// polynomials, see HELevelAnalysis
+  /// \param[in] skips_rescale Nodes which are not rescaled, see
+  /// HELevelAnalysis
+  explicit InsertRefresh(
+      size_t max_depth,
+      HELevelAnalysis::PolynomialDepth polynomial_depth = nullptr,
+      HELevelAnalysis::SkipsRescale skips_rescale = nullptr)
+      : m_max_depth(max_depth),
+        m_polynomial_depth(std::move(polynomial_depth)),
+        m_skips_rescale(std::move(skips_rescale)) {}
+
+  /// \brief Returns whether or not a Refresh op was inserted
+  /// \param[in,out] function Function which to run pass on
+  /// \throws ngraph_error if a node is deeper than max_depth even with
+  /// refreshed inputs
+  bool run_on_function(std::shared_ptr<Function> function) override;
+
+ private:
+  size_t m_max_depth;
+  HELevelAnalysis::PolynomialDepth m_polynomial_depth;
+  HELevelAnalysis::SkipsRescale m_skips_rescale;
+};
+}  // namespace ngraph::runtime::he::pass
@@ -0,0 +1,49 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/max_pool_to_avg_pool.hpp"
+
+#include <memory>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/function.hpp"
+#include "ngraph/graph_util.hpp"
+#include "ngraph/ops.hpp"
+
+namespace ngraph::runtime::he {
+
+bool pass::MaxPoolToAvgPool::run_on_function(
+    std::shared_ptr<Function> function) {
+  bool replaced = false;
+  for (const auto& node : function->get_ordered_ops()) {
+    auto max_pool = std::dynamic_pointer_cast<op::MaxPool>(node);
+    if (max_pool == nullptr || !m_replace_node(*max_pool)) {
+      continue;
+    }
+    // MaxPool pads with -inf, i.e. padding never contributes to a window
+    auto avg_pool = std::make_shared<op::AvgPool>(
+        max_pool->input_value(0), max_pool->get_window_shape(),
+        max_pool->get_window_movement_strides(),
+        max_pool->get_padding_below(), max_pool->get_padding_above(), false);
+    NGRAPH_HE_LOG(3) << "Replacing " << max_pool->get_name() << " by "
+                     << avg_pool->get_name();
+    replace_node(max_pool, avg_pool);
+    replaced = true;
+  }
+  return replaced;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,48 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "ngraph/node.hpp"
+#include "ngraph/pass/graph_rewrite.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Replaces selected MaxPools by AvgPools of the same windows, which
+/// the server computes without a client round-trip or garbled circuit. Only
+/// models trained or fine-tuned with average pooling remain accurate. The
+/// windows exclude their padding, and the 1/n factor of unpadded AvgPools is
+/// folded into a following Convolution or Dot by HEFusion
+class MaxPoolToAvgPool : public ngraph::pass::FunctionPass {
+ public:
+  /// \brief Returns whether or not to replace a MaxPool node
+  using ReplaceNode = std::function<bool(const Node& node)>;
+
+  /// \param[in] replace_node Whether or not to replace each MaxPool
+  explicit MaxPoolToAvgPool(ReplaceNode replace_node)
+      : m_replace_node(std::move(replace_node)) {}
+
+  /// \brief Returns whether or not a MaxPool was replaced
+  /// \param[in,out] function Function which to run pass on
+  bool run_on_function(std::shared_ptr<Function> function) override;
+
+ private:
+  ReplaceNode m_replace_node;
+};
+}  // namespace ngraph::runtime::he::pass
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "pass/merge_functions.hpp"
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/graph_util.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/serializer.hpp"
+#include "nlohmann/json.hpp"
+#include "seal/seal_util.hpp"
+
+using json = nlohmann::json;
+
+namespace ngraph::runtime::he::pass {
+
+namespace {
+/// \brief Returns the fingerprint of each node of a function, which is equal
+/// for nodes computing the same values from the same parameter indices
+std::unordered_map<const Node*, std::string> node_fingerprints(
+    const std::shared_ptr<Function>& function) {
+  // The serialization stores the attributes and Constant values of each op
+  std::unordered_map<std::string, json> op_attributes;
+  for (auto& serialized_function : json::parse(serialize(function))) {
+    for (auto& op : serialized_function.at("ops")) {
+      std::string name = op.at("name");
+      for (const char* key : {"name", "friendly_name", "inputs", "outputs",
+                              "control_deps", "provenance_tags"}) {
+        op.erase(key);
+      }
+      op_attributes.emplace(name, std::move(op));
+    }
+  }
+
+  std::unordered_map<const Node*, size_t> param_indices;
+  const ParameterVector& parameters = function->get_parameters();
+  for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+    param_indices.emplace(parameters[param_idx].get(), param_idx);
+  }
+
+  std::unordered_map<const Node*, std::string> fingerprints;
+  for (const auto& node : function->get_ordered_ops()) {
+    std::stringstream stream;
+    if (node->is_parameter()) {
+      auto it = param_indices.find(node.get());
+      NGRAPH_CHECK(it != param_indices.end(), "Parameter ", node->get_name(),
+                   " not in function");
+      stream << "Parameter " << it->second;
+    } else {
+      auto it = op_attributes.find(node->get_name());
+      NGRAPH_CHECK(it != op_attributes.end(), "Node ", node->get_name(),
+                   " not serialized");
+      stream << it->second.dump();
+      for (const auto& input : node->inputs()) {
+        const auto& source = input.get_source_output();
+        stream << "|" << fingerprints.at(source.get_node()) << ":"
+               << source.get_index();
+      }
+    }
+    for (const auto& output : node->outputs()) {
+      stream << "|" << output.get_element_type() << output.get_shape();
+    }
+    fingerprints.emplace(node.get(), key_fingerprint(stream.str()));
+  }
+  return fingerprints;
+}
+}  // namespace
+
+std::shared_ptr<Function> merge_functions(
+    const std::vector<std::shared_ptr<Function>>& functions) {
+  NGRAPH_CHECK(!functions.empty(), "No functions to merge");
+  const ParameterVector& parameters = functions[0]->get_parameters();
+  for (const auto& function : functions) {
+    const ParameterVector& function_parameters = function->get_parameters();
+    NGRAPH_CHECK(function_parameters.size() == parameters.size(),
+                 "Merged functions must have the same number of parameters");
+    for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+      NGRAPH_CHECK(function_parameters[param_idx]->get_element_type() ==
+                           parameters[param_idx]->get_element_type() &&
+                       function_parameters[param_idx]->get_shape() ==
+                           parameters[param_idx]->get_shape(),
+                   "Parameter ", param_idx,
+                   " differs between the merged functions");
+    }
+  }
+
+  // Fingerprints are computed before rewiring, which changes no structure
+  std::vector<std::unordered_map<const Node*, std::string>> fingerprints;
+  for (const auto& function : functions) {
+    fingerprints.emplace_back(node_fingerprints(function));
+  }
+
+  std::unordered_map<std::string, std::shared_ptr<Node>> merged_nodes;
+  ResultVector results;
+  size_t num_shared = 0;
+  for (size_t function_idx = 0; function_idx < functions.size();
+       ++function_idx) {
+    const auto& function = functions[function_idx];
+    for (const auto& node : function->get_ordered_ops()) {
+      if (node->is_output()) {
+        continue;
+      }
+      const std::string& fingerprint =
+          fingerprints[function_idx].at(node.get());
+      auto [it, inserted] = merged_nodes.emplace(fingerprint, node);
+      if (!inserted && it->second != node) {
+        NGRAPH_HE_LOG(4) << "Replacing " << node->get_name() << " by shared "
+                         << it->second->get_name();
+        for (size_t output_idx = 0; output_idx < node->get_output_size();
+             ++output_idx) {
+          for (auto& input : node->output(output_idx).get_target_inputs()) {
+            input.replace_source_output(it->second->output(output_idx));
+          }
+        }
+        ++num_shared;
+      }
+    }
+    const ResultVector& function_results = function->get_results();
+    results.insert(results.end(), function_results.begin(),
+                   function_results.end());
+  }
+  NGRAPH_HE_LOG(3) << "Merged " << functions.size() << " functions sharing "
+                   << num_shared << " nodes";
+  return std::make_shared<Function>(results, parameters);
+}
+
+}  // namespace ngraph::runtime::he::pass
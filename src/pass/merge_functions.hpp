@@ -0,0 +1,36 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ngraph/function.hpp"
+
+namespace ngraph::runtime::he::pass {
+/// \brief Merges functions on the same inputs into one function computing
+/// the results of each function in order. Nodes which are structurally
+/// identical across the functions, i.e. the same op with the same
+/// attributes, Constant values and inputs, are computed once, so a shared
+/// backbone with several heads is evaluated once per input. Parameter i of
+/// every function is merged into parameter i of the first function
+/// \param[in,out] functions Functions to merge, whose nodes are rewired to
+/// the merged nodes
+/// \returns The merged function, with the parameters of the first function
+std::shared_ptr<Function> merge_functions(
+    const std::vector<std::shared_ptr<Function>>& functions);
+}  // namespace ngraph::runtime::he::pass
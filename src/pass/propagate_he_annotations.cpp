@@ -19,6 +19,7 @@
 #include <exception>
 #include <list>
 #include <sstream>
+#include <string>
 #include <unordered_set>
 
 #include "he_op_annotations.hpp"
@@ -35,6 +36,24 @@
 
 namespace ngraph::runtime::he {
 
+bool pass::PropagateHEAnnotations::is_encryptable_constant(
+    const Node& constant) {
+  if (!constant.is_constant()) {
+    return false;
+  }
+  for (const auto& output : constant.outputs()) {
+    for (const auto& target_input : output.get_target_inputs()) {
+      const std::string& description =
+          target_input.get_node()->description();
+      if (target_input.get_index() == 1 &&
+          (description == "Power" || description == "Divide")) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool pass::PropagateHEAnnotations::run_on_function(
     std::shared_ptr<Function> function) {
   std::list<std::shared_ptr<Node>> nodes = function->get_ordered_ops();
@@ -42,7 +61,7 @@ bool pass::PropagateHEAnnotations::run_on_function(
   NGRAPH_HE_LOG(3) << "Running Propagate HE Annotations pass";
 
   // First, set all ops without annotations to have plaintext unpacked
-  // annotation
+  // annotation, and encrypt constants if enabled
   for (const auto& node : nodes) {
     if (node->is_op()) {
       auto op = std::dynamic_pointer_cast<op::Op>(node);
@@ -57,6 +76,10 @@ bool pass::PropagateHEAnnotations::run_on_function(
         NGRAPH_HE_LOG(5) << "Op " << op->get_name()
                          << " has annotation: " << *he_op_annotations;
       }
+      if (m_encrypt_constants && is_encryptable_constant(*op)) {
+        NGRAPH_HE_LOG(5) << "Encrypting constant " << op->get_name();
+        HEOpAnnotations::he_op_annotation(*op)->set_encrypted(true);
+      }
     } else {
       NGRAPH_HE_LOG(5) << "Node " << node->get_name() << " is not an op";
     }
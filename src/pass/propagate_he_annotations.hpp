@@ -27,9 +27,25 @@ namespace ngraph::runtime::he::pass {
 /// function
 class PropagateHEAnnotations : public ngraph::pass::FunctionPass {
  public:
+  /// \brief Constructs the pass
+  /// \param[in] encrypt_constants Whether or not Constant nodes holding model
+  /// weights are annotated as encrypted. Constants used as the exponent of a
+  /// Power or the divisor of a Divide stay plaintext, since encrypted
+  /// exponents and divisors are not computed homomorphically
+  explicit PropagateHEAnnotations(bool encrypt_constants = false)
+      : m_encrypt_constants(encrypt_constants) {}
+
+  /// \brief Returns whether or not a Constant node is encrypted when
+  /// constants are encrypted
+  /// \param[in] constant Constant node
+  static bool is_encryptable_constant(const Node& constant);
+
   /// \brief Runs pass on function
   /// \param[in,out] function Function which to run pass on
   /// \returns whether or not the function has been modified
   bool run_on_function(std::shared_ptr<Function> function) override;
+
+ private:
+  bool m_encrypt_constants;
 };
 }  // namespace ngraph::runtime::he::pass
@@ -27,13 +27,16 @@
 namespace ngraph::runtime::he {
 
 bool pass::SupportedOps::run_on_function(std::shared_ptr<Function> function) {
-  std::list<std::shared_ptr<Node>> ops = function->get_ordered_ops();
+  run_on_ordered_ops(function->get_ordered_ops());
+  return true;
+}
 
+void pass::SupportedOps::run_on_ordered_ops(
+    const std::list<std::shared_ptr<Node>>& ops) const {
   for (const auto& op : ops) {
     NGRAPH_CHECK(is_supported(*op), "Unsupported op ", op->description(),
                  " with type ", op->get_element_type());
   }
-  return true;
 }
 
 }  // namespace ngraph::runtime::he
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <functional>
+#include <list>
 #include <memory>
 
 #include "ngraph/pass/graph_rewrite.hpp"
@@ -35,6 +36,12 @@ class SupportedOps : public ngraph::pass::FunctionPass {
   /// \param[in,out] function Function which to run pass on
   bool run_on_function(std::shared_ptr<Function> function) override;
 
+  /// \brief Checks the given ops, e.g. the ordered ops of a function shared
+  /// with other passes
+  /// \throws ngraph_error if an op is not supported
+  /// \param[in] ops Ops to check
+  void run_on_ordered_ops(const std::list<std::shared_ptr<Node>>& ops) const;
+
   /// \brief returns whether or not given node is supported
   /// \param[in] node Node which to check supported status
   /// \return true if node is supported, false otherwise
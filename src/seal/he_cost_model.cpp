@@ -0,0 +1,114 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_cost_model.hpp"
+
+#include <fstream>
+#include <string>
+
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+#include "nlohmann/json.hpp"
+
+namespace ngraph::runtime::he {
+
+double HECostCalibration::primitive_cost_us(HEPrimitive primitive,
+                                            size_t poly_modulus_degree,
+                                            size_t num_coeff_moduli) const {
+  double coeffs = static_cast<double>(poly_modulus_degree) *
+                  static_cast<double>(num_coeff_moduli);
+  if (is_key_switching(primitive)) {
+    coeffs *= static_cast<double>(num_coeff_moduli);
+  }
+  return primitive_us[static_cast<size_t>(primitive)] * coeffs;
+}
+
+HECostCalibration HECostCalibration::load(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file) {
+    throw ngraph_error("Unable to open cost calibration " + filename);
+  }
+  auto js = nlohmann::json::parse(file, nullptr, false);
+  if (js.is_discarded() || !js.contains("benchmarks")) {
+    throw ngraph_error("Invalid benchmark output " + filename);
+  }
+
+  // Benchmarks are named Primitive/<primitive>/<parameters>/threads:<n>, and
+  // report the cost per coefficient as the coeff_us counter. Costs are
+  // averaged over the parameter sets
+  HECostCalibration calibration;
+  std::array<double, s_num_he_primitives> sums{};
+  std::array<size_t, s_num_he_primitives> counts{};
+  for (const auto& benchmark : js.at("benchmarks")) {
+    if (!benchmark.contains("name") || !benchmark.contains("coeff_us") ||
+        benchmark.value("error_occurred", false)) {
+      continue;
+    }
+    std::string name = benchmark.at("name");
+    if (name.rfind("Primitive/", 0) != 0 ||
+        name.find("/threads:1") == std::string::npos) {
+      continue;
+    }
+    for (size_t i = 0; i < s_num_he_primitives; ++i) {
+      std::string prefix =
+          "Primitive/" + he_primitive_name(static_cast<HEPrimitive>(i)) + "/";
+      if (name.rfind(prefix, 0) == 0) {
+        sums[i] += benchmark.at("coeff_us").get<double>();
+        counts[i]++;
+      }
+    }
+  }
+  for (size_t i = 0; i < s_num_he_primitives; ++i) {
+    if (counts[i] > 0) {
+      calibration.primitive_us[i] = sums[i] / static_cast<double>(counts[i]);
+    }
+  }
+  return calibration;
+}
+
+std::string HECostReport::to_json() const {
+  nlohmann::json js_nodes = nlohmann::json::array();
+  for (const auto& cost : nodes) {
+    nlohmann::json primitives;
+    for (size_t i = 0; i < s_num_he_primitives; ++i) {
+      primitives[he_primitive_name(static_cast<HEPrimitive>(i))] =
+          cost.primitives[i];
+    }
+    js_nodes.push_back({{"name", cost.node->get_name()},
+                        {"op", cost.node->description()},
+                        {"primitives", primitives},
+                        {"ciphertexts", cost.ciphertexts},
+                        {"levels", cost.levels},
+                        {"depth", cost.depth},
+                        {"bytes_sent", cost.bytes_sent},
+                        {"bytes_received", cost.bytes_received},
+                        {"round_trips", cost.round_trips},
+                        {"live_bytes", cost.live_bytes},
+                        {"latency_us", cost.latency_us}});
+  }
+  nlohmann::json js = {{"nodes", js_nodes},
+                       {"max_depth", max_depth},
+                       {"max_supported_depth", max_supported_depth},
+                       {"depth_supported", depth_supported()},
+                       {"peak_live_bytes", peak_live_bytes},
+                       {"latency_us", latency_us}};
+  if (peak_node != nullptr) {
+    js["peak_node"] = peak_node->get_name();
+  }
+  return js.dump(2);
+}
+
+}  // namespace ngraph::runtime::he
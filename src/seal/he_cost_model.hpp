@@ -0,0 +1,114 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ngraph/node.hpp"
+#include "seal/he_primitive_counter.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Costs with which the latency of a function is estimated without
+/// running it
+struct HECostCalibration {
+  /// \brief Cost of each HE primitive per coefficient of each coefficient
+  /// modulus of its ciphertext, in microseconds, indexed by HEPrimitive. The
+  /// cost of the key-switching primitives, relinearize and rotate, is
+  /// additionally proportional to the number of coefficient moduli
+  std::array<double, s_num_he_primitives> primitive_us{
+      3e-2, 6e-2, 3e-3, 6e-3, 1.5e-2, 1.5e-2, 1.5e-2};
+  /// \brief Cost of transferring one byte between the server and client
+  double byte_us{8e-3};
+  /// \brief Latency of a round-trip to the client
+  double round_trip_us{1000};
+
+  /// \brief Returns the cost of a primitive call, in microseconds
+  /// \param[in] primitive Called primitive
+  /// \param[in] poly_modulus_degree Degree of the ciphertext polynomials
+  /// \param[in] num_coeff_moduli Number of coefficient moduli of the
+  /// ciphertext
+  double primitive_cost_us(HEPrimitive primitive, size_t poly_modulus_degree,
+                           size_t num_coeff_moduli) const;
+
+  /// \brief Returns whether or not a primitive switches keys, so its cost
+  /// is quadratic in the number of coefficient moduli
+  static bool is_key_switching(HEPrimitive primitive) {
+    return primitive == HEPrimitive::relinearize ||
+           primitive == HEPrimitive::rotate;
+  }
+
+  /// \brief Loads primitive costs measured by the Primitive benchmarks of
+  /// he_benchmarks, from the output written with --benchmark_out_format=json.
+  /// Costs of primitives without single-threaded measurements keep their
+  /// defaults
+  /// \param[in] filename Benchmark output
+  /// \throws ngraph_error if the file cannot be parsed
+  static HECostCalibration load(const std::string& filename);
+};
+
+/// \brief Estimated cost of a node
+struct HENodeCost {
+  std::shared_ptr<const Node> node;
+  /// \brief Estimated calls of each HE primitive
+  HEPrimitiveCounts primitives{};
+  /// \brief Number of ciphertexts in the outputs
+  size_t ciphertexts{0};
+  /// \brief Rescales consumed by the node
+  size_t levels{0};
+  /// \brief Rescales consumed since encryption, after the node
+  size_t depth{0};
+  /// \brief Bytes sent to the client
+  size_t bytes_sent{0};
+  /// \brief Bytes received from the client
+  size_t bytes_received{0};
+  /// \brief Round-trips to the client
+  size_t round_trips{0};
+  /// \brief Estimated live ciphertext bytes after the node
+  size_t live_bytes{0};
+  /// \brief Estimated latency, in microseconds
+  double latency_us{0};
+};
+
+/// \brief Estimated cost of a function
+struct HECostReport {
+  /// \brief Costs of the nodes, in execution order
+  std::vector<HENodeCost> nodes;
+  /// \brief Largest depth of any node
+  size_t max_depth{0};
+  /// \brief Number of rescales the encryption parameters support
+  size_t max_supported_depth{0};
+  /// \brief Largest live ciphertext bytes after any node
+  size_t peak_live_bytes{0};
+  /// \brief Node after which the peak is reached
+  std::shared_ptr<const Node> peak_node;
+  /// \brief Estimated latency of a call, in microseconds
+  double latency_us{0};
+
+  /// \brief Returns whether or not the encryption parameters support the
+  /// depth of the function
+  bool depth_supported() const { return max_depth <= max_supported_depth; }
+
+  /// \brief Returns the report as a JSON object
+  std::string to_json() const;
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include "ngraph/node.hpp"
+#include "ngraph/runtime/performance_counter.hpp"
+#include "seal/he_primitive_counter.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Counters of a node besides its execution time
+struct HEOpStats {
+  /// \brief Calls of each HE primitive
+  HEPrimitiveCounts primitives{};
+  /// \brief Number of ciphertexts in the outputs
+  size_t ciphertexts{0};
+  /// \brief Bytes sent to the client
+  size_t bytes_sent{0};
+  /// \brief Bytes received from the client
+  size_t bytes_received{0};
+  /// \brief Time spent awaiting client responses, in microseconds
+  size_t client_wait_us{0};
+  /// \brief Bytes of the ciphertexts in the outputs
+  size_t ciphertext_bytes{0};
+  /// \brief Bytes allocated by the backend's memory pools
+  size_t pool_bytes{0};
+  /// \brief Largest number of bytes of live ciphertexts after the node
+  size_t peak_live_bytes{0};
+
+  HEOpStats& operator+=(const HEOpStats& other) {
+    for (size_t i = 0; i < s_num_he_primitives; ++i) {
+      primitives[i] += other.primitives[i];
+    }
+    ciphertexts += other.ciphertexts;
+    bytes_sent += other.bytes_sent;
+    bytes_received += other.bytes_received;
+    client_wait_us += other.client_wait_us;
+    ciphertext_bytes += other.ciphertext_bytes;
+    pool_bytes += other.pool_bytes;
+    peak_live_bytes = std::max(peak_live_bytes, other.peak_live_bytes);
+    return *this;
+  }
+};
+
+/// \brief Performance counter of a node, extended with its HE primitive
+/// calls, ciphertext count, memory usage and client communication
+class HEPerformanceCounter : public runtime::PerformanceCounter {
+ public:
+  /// \brief Constructs a performance counter
+  /// \param[in] node Node the counters belong to
+  /// \param[in] us Total execution time in microseconds
+  /// \param[in] calls Number of executions
+  /// \param[in] stats Counters accumulated over all executions
+  HEPerformanceCounter(const std::shared_ptr<const Node>& node, size_t us,
+                       size_t calls, const HEOpStats& stats)
+      : runtime::PerformanceCounter(node, us, calls), m_stats(stats) {}
+
+  /// \brief Returns the number of calls of an HE primitive
+  size_t primitive_count(HEPrimitive primitive) const {
+    return m_stats.primitives[static_cast<size_t>(primitive)];
+  }
+
+  /// \brief Returns the number of ciphertexts produced
+  size_t ciphertext_count() const { return m_stats.ciphertexts; }
+
+  /// \brief Returns the number of bytes sent to the client
+  size_t bytes_sent() const { return m_stats.bytes_sent; }
+
+  /// \brief Returns the number of bytes received from the client
+  size_t bytes_received() const { return m_stats.bytes_received; }
+
+  /// \brief Returns the time spent awaiting client responses
+  size_t client_wait_microseconds() const { return m_stats.client_wait_us; }
+
+  /// \brief Returns the number of bytes of ciphertexts produced
+  size_t ciphertext_bytes() const { return m_stats.ciphertext_bytes; }
+
+  /// \brief Returns the number of bytes the backend's memory pools allocated
+  /// while the node executed
+  size_t pool_bytes_allocated() const { return m_stats.pool_bytes; }
+
+  /// \brief Returns the largest number of bytes of live ciphertexts after
+  /// the node executed
+  size_t peak_live_ciphertext_bytes() const { return m_stats.peak_live_bytes; }
+
+  /// \brief Returns all counters besides the execution time
+  const HEOpStats& stats() const { return m_stats; }
+
+ private:
+  HEOpStats m_stats;
+};
+
+}  // namespace ngraph::runtime::he
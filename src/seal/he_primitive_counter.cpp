@@ -0,0 +1,55 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_primitive_counter.hpp"
+
+#include <atomic>
+#include <string>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+std::string he_primitive_name(HEPrimitive primitive) {
+  switch (primitive) {
+    case HEPrimitive::encode:
+      return "encode";
+    case HEPrimitive::encrypt:
+      return "encrypt";
+    case HEPrimitive::multiply_plain:
+      return "multiply_plain";
+    case HEPrimitive::multiply:
+      return "multiply";
+    case HEPrimitive::relinearize:
+      return "relinearize";
+    case HEPrimitive::rescale:
+      return "rescale";
+    case HEPrimitive::rotate:
+      return "rotate";
+  }
+  NGRAPH_CHECK(false, "Unknown HE primitive");
+  return "";
+}
+
+HEPrimitiveCounts HEPrimitiveCounter::counts() {
+  HEPrimitiveCounts counts{};
+  for (size_t i = 0; i < s_num_he_primitives; ++i) {
+    counts[i] = s_counts[i].value.load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+}  // namespace ngraph::runtime::he
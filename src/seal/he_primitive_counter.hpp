@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace ngraph::runtime::he {
+
+/// \brief HE primitives whose calls are counted. Scalar encodings, which
+/// do not require an NTT, are included in multiply_plain
+enum class HEPrimitive : size_t {
+  encode,
+  encrypt,
+  multiply_plain,
+  multiply,
+  relinearize,
+  rescale,
+  rotate
+};
+
+/// \brief Number of HEPrimitive values
+constexpr size_t s_num_he_primitives = 7;
+
+/// \brief Number of calls of each HEPrimitive, indexed by its value
+using HEPrimitiveCounts = std::array<size_t, s_num_he_primitives>;
+
+/// \brief Returns the name of an HE primitive, e.g. "multiply_plain"
+/// \param[in] primitive Primitive to name
+std::string he_primitive_name(HEPrimitive primitive);
+
+/// \brief Process-wide counts of HE primitive calls. Counts are updated
+/// with relaxed atomic increments, which are negligible next to the cost of
+/// the primitives. All methods are thread-safe
+class HEPrimitiveCounter {
+ public:
+  /// \brief Records calls of a primitive
+  /// \param[in] primitive Called primitive
+  /// \param[in] count Number of calls
+  static void increment(HEPrimitive primitive, size_t count = 1) {
+    s_counts[static_cast<size_t>(primitive)].value.fetch_add(
+        count, std::memory_order_relaxed);
+  }
+
+  /// \brief Returns the number of calls of each primitive so far
+  static HEPrimitiveCounts counts();
+
+ private:
+  // Each count is on its own cache line, since kernels increment them from
+  // every thread
+  struct alignas(64) Count {
+    std::atomic<size_t> value{0};
+  };
+  inline static std::array<Count, s_num_he_primitives> s_counts{};
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_accelerator.hpp"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "ngraph/check.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::mutex s_registry_mutex;
+
+std::unordered_map<std::string, HESealAcceleratorFactory>& registry() {
+  static std::unordered_map<std::string, HESealAcceleratorFactory> s_registry{
+      {"cpu", []() { return std::make_shared<HESealAccelerator>(); }}};
+  return s_registry;
+}
+}  // namespace
+
+void HESealAccelerator::rescale_to_next_inplace(
+    std::vector<HEType>& arg, HESealBackend& he_seal_backend) {
+  parallel_for_seal(arg.size(), {&arg}, [&](size_t i) {
+    if (arg[i].is_ciphertext()) {
+      HEPrimitiveCounter::increment(HEPrimitive::rescale);
+      rescale_inplace(arg[i].get_ciphertext()->ciphertext(),
+                      *he_seal_backend.get_evaluator(),
+                      he_seal_backend.rescale_primes(), he_seal_backend.pool());
+    }
+  });
+}
+
+void HESealAccelerator::relinearize(std::vector<HEType>& arg,
+                                    HESealBackend& he_seal_backend) {
+  parallel_for_seal(arg.size(), {&arg}, [&](size_t i) {
+    auto& he_type = arg[i];
+    if (!he_type.is_ciphertext() ||
+        he_type.get_ciphertext()->is_relinearized()) {
+      return;
+    }
+    auto relinearized = HESealBackend::create_empty_ciphertext();
+    HEPrimitiveCounter::increment(HEPrimitive::relinearize);
+    he_seal_backend.get_evaluator()->relinearize(
+        he_type.get_ciphertext()->ciphertext(),
+        *he_seal_backend.get_relin_keys(), relinearized->ciphertext(),
+        he_seal_backend.pool());
+    he_type.replace_ciphertext(relinearized);
+  });
+}
+
+void register_accelerator(const std::string& name,
+                          HESealAcceleratorFactory factory) {
+  std::lock_guard<std::mutex> guard(s_registry_mutex);
+  registry()[name] = std::move(factory);
+}
+
+std::shared_ptr<HESealAccelerator> create_accelerator(
+    const std::string& name) {
+  std::lock_guard<std::mutex> guard(s_registry_mutex);
+  auto it = registry().find(name);
+  NGRAPH_CHECK(it != registry().end(), "Unknown accelerator ", name);
+  return it->second();
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "he_type.hpp"
+
+namespace ngraph::runtime::he {
+class HESealBackend;
+
+/// \brief Executes batched SEAL primitives on the ciphertexts of a tensor.
+/// The default implementation uses the SEAL evaluator on the CPU. Device
+/// implementations, e.g. performing the NTT and RNS arithmetic on a GPU,
+/// derive from it and register a factory with register_accelerator. Since
+/// each primitive receives all elements of a tensor at once, a device
+/// implementation may keep the ciphertexts resident between primitives
+class HESealAccelerator {
+ public:
+  virtual ~HESealAccelerator() = default;
+
+  /// \brief Returns the name of the accelerator, see set_config
+  virtual std::string name() const { return "cpu"; }
+
+  /// \brief Rescales each ciphertext to the next modulus in the chain
+  /// \param[in,out] arg Elements to rescale. Plaintexts are skipped
+  /// \param[in] he_seal_backend Backend whose evaluator and memory pool are
+  /// used
+  virtual void rescale_to_next_inplace(std::vector<HEType>& arg,
+                                       HESealBackend& he_seal_backend);
+
+  /// \brief Relinearizes each ciphertext which is not yet relinearized.
+  /// Since ciphertexts may be shared between tensors, each relinearized
+  /// ciphertext replaces the element's ciphertext
+  /// \param[in,out] arg Elements to relinearize. Plaintexts are skipped
+  /// \param[in] he_seal_backend Backend whose evaluator and relinearization
+  /// keys are used
+  virtual void relinearize(std::vector<HEType>& arg,
+                           HESealBackend& he_seal_backend);
+};
+
+using HESealAcceleratorFactory =
+    std::function<std::shared_ptr<HESealAccelerator>()>;
+
+/// \brief Registers an accelerator so set_config can select it by name
+/// \param[in] name Name of the accelerator
+/// \param[in] factory Creates the accelerator
+void register_accelerator(const std::string& name,
+                          HESealAcceleratorFactory factory);
+
+/// \brief Creates a registered accelerator
+/// \param[in] name Name of the accelerator. "cpu" is always registered
+/// \throws ngraph_error if no accelerator of the given name is registered
+std::shared_ptr<HESealAccelerator> create_accelerator(const std::string& name);
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,254 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_autotuner.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "he_tensor.hpp"
+#include "he_util.hpp"
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/except.hpp"
+#include "ngraph/ngraph.hpp"
+#include "nlohmann/json.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_executable.hpp"
+
+using json = nlohmann::json;
+
+namespace ngraph::runtime::he {
+
+namespace {
+constexpr size_t s_tuning_inputs = 64;
+constexpr size_t s_tuning_outputs = 16;
+constexpr size_t s_timed_calls = 3;
+// Fraction of the fastest call time within which fewer threads are chosen
+constexpr double s_thread_tolerance = 0.05;
+
+std::vector<int> coeff_modulus_bits(const HESealEncryptionParameters& parms) {
+  std::vector<int> bits;
+  for (const auto& modulus :
+       parms.seal_encryption_parameters().coeff_modulus()) {
+    bits.emplace_back(modulus.bit_count());
+  }
+  return bits;
+}
+
+/// \brief Returns a Dot by Constant weights, followed by a ciphertext square
+/// if the encryption parameters support its depth
+std::shared_ptr<Function> tuning_function(
+    const std::shared_ptr<op::Parameter>& param, size_t max_depth) {
+  std::vector<float> weights(s_tuning_inputs * s_tuning_outputs);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = static_cast<float>(static_cast<int>(i % 7) - 3) / 4;
+  }
+  auto w = op::Constant::create(
+      element::f32, Shape{s_tuning_inputs, s_tuning_outputs}, weights);
+  std::shared_ptr<Node> result = std::make_shared<op::Dot>(param, w);
+  if (max_depth >= 2) {
+    result = std::make_shared<op::Multiply>(result, result);
+  }
+  return std::make_shared<Function>(result, ParameterVector{param});
+}
+
+/// \brief Returns the median time of a few calls, in microseconds, after a
+/// call which grows the memory pools
+double time_calls(runtime::Executable& executable,
+                  const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+                  const std::vector<std::shared_ptr<runtime::Tensor>>& inputs) {
+  executable.call(outputs, inputs);
+  std::vector<double> times;
+  for (size_t call_idx = 0; call_idx < s_timed_calls; ++call_idx) {
+    auto start = std::chrono::steady_clock::now();
+    executable.call(outputs, inputs);
+    times.emplace_back(std::chrono::duration<double, std::micro>(
+                           std::chrono::steady_clock::now() - start)
+                           .count());
+  }
+  std::nth_element(times.begin(), times.begin() + times.size() / 2,
+                   times.end());
+  return times[times.size() / 2];
+}
+
+/// \brief Returns the bytes serialized per microsecond
+double serialization_rate(const seal::Ciphertext& cipher) {
+  constexpr size_t num_saves = 8;
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < num_saves; ++i) {
+    std::stringstream stream;
+    bytes += static_cast<size_t>(
+        cipher.save(stream, seal::compr_mode_type::none));
+  }
+  double us = std::chrono::duration<double, std::micro>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+  return static_cast<double>(bytes) / std::max(us, 1.0);
+}
+}  // namespace
+
+size_t hardware_threads() {
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+bool HETuningProfile::matches(const HESealEncryptionParameters& parms) const {
+  return hardware_threads == he::hardware_threads() &&
+         poly_modulus_degree == parms.poly_modulus_degree() &&
+         coeff_modulus_bits == he::coeff_modulus_bits(parms);
+}
+
+void HETuningProfile::save(const std::string& filename) const {
+  json js = {{"hardware_threads", hardware_threads},
+             {"poly_modulus_degree", poly_modulus_degree},
+             {"coeff_modulus_bits", coeff_modulus_bits},
+             {"config", config}};
+  std::ofstream file(filename, std::ios::trunc);
+  file << js.dump(2) << "\n";
+  if (!file) {
+    throw ngraph_error("Failed to write tuning profile " + filename);
+  }
+}
+
+HETuningProfile HETuningProfile::load(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file) {
+    throw ngraph_error("Unable to open tuning profile " + filename);
+  }
+  auto js = json::parse(file, nullptr, false);
+  if (js.is_discarded() || !js.is_object() || !js.contains("config")) {
+    throw ngraph_error("Invalid tuning profile " + filename);
+  }
+  HETuningProfile profile;
+  try {
+    profile.config =
+        js.at("config").get<std::map<std::string, std::string>>();
+    profile.hardware_threads = js.value("hardware_threads", 0UL);
+    profile.poly_modulus_degree = js.value("poly_modulus_degree", 0UL);
+    profile.coeff_modulus_bits =
+        js.value("coeff_modulus_bits", std::vector<int>{});
+  } catch (const json::exception& e) {
+    throw ngraph_error("Invalid tuning profile " + filename + ": " +
+                       e.what());
+  }
+  return profile;
+}
+
+HETuningProfile autotune(const HESealEncryptionParameters& parms,
+                         double round_trip_us, size_t num_gc_party_threads) {
+  HETuningProfile profile;
+  profile.hardware_threads = hardware_threads();
+  profile.poly_modulus_degree = parms.poly_modulus_degree();
+  profile.coeff_modulus_bits = coeff_modulus_bits(parms);
+
+  // A separate backend keeps the calibration from the caller's config,
+  // e.g. an enabled client
+  HESealBackend backend(parms);
+  auto param =
+      std::make_shared<op::Parameter>(element::f32, Shape{s_tuning_inputs});
+  std::string error_str;
+  backend.set_config(
+      {{"enable_client", "false"}, {param->get_name(), "encrypt"}},
+      error_str);
+  // Excludes the special prime and the last prime, which cannot be dropped
+  size_t num_moduli = profile.coeff_modulus_bits.size();
+  size_t max_depth = num_moduli > 2 ? num_moduli - 2 : 0;
+  auto function = tuning_function(param, max_depth);
+
+  auto input = backend.create_plain_tensor(element::f32,
+                                           Shape{s_tuning_inputs});
+  std::vector<float> values(s_tuning_inputs);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i % 5) / 4;
+  }
+  input->write(values.data(), values.size() * sizeof(float));
+  auto output = backend.create_cipher_tensor(
+      element::f32, function->get_results()[0]->get_shape());
+
+  // Lazy modular reduction changes which ops are compiled as exclusive, so
+  // each setting compiles its own executable
+  double best_us = 0;
+  std::shared_ptr<runtime::Executable> best_executable;
+  for (bool lazy_mod : {false, true}) {
+    backend.lazy_mod() = lazy_mod;
+    auto executable = backend.compile(function);
+    double call_us = time_calls(*executable, {output}, {input});
+    NGRAPH_HE_LOG(1) << "Tuning call with lazy_mod " << lazy_mod << " took "
+                     << call_us << "us";
+    if (best_executable == nullptr || call_us < best_us) {
+      best_us = call_us;
+      best_executable = executable;
+      profile.config["lazy_mod"] = bool_to_string(lazy_mod);
+    }
+  }
+  backend.lazy_mod() = profile.config["lazy_mod"] == bool_to_string(true);
+
+  auto& he_executable = static_cast<HESealExecutable&>(*best_executable);
+  std::vector<size_t> candidates;
+  for (size_t num_threads = 1; num_threads < profile.hardware_threads;
+       num_threads *= 2) {
+    candidates.emplace_back(num_threads);
+  }
+  candidates.emplace_back(profile.hardware_threads);
+  std::vector<double> thread_times;
+  for (size_t num_threads : candidates) {
+    he_executable.set_num_intra_op_threads(num_threads);
+    thread_times.emplace_back(time_calls(he_executable, {output}, {input}));
+    NGRAPH_HE_LOG(1) << "Tuning call with " << num_threads
+                     << " intra-op threads took " << thread_times.back()
+                     << "us";
+  }
+  double fastest_us =
+      *std::min_element(thread_times.begin(), thread_times.end());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (thread_times[i] <= fastest_us * (1 + s_thread_tolerance)) {
+      profile.config["num_intra_op_threads"] = std::to_string(candidates[i]);
+      break;
+    }
+  }
+
+  const auto& cipher = std::static_pointer_cast<HETensor>(output)
+                           ->data(0)
+                           .get_ciphertext()
+                           ->ciphertext();
+  double bytes_per_us = serialization_rate(cipher);
+  auto cipher_bytes =
+      static_cast<size_t>(cipher.save_size(seal::compr_mode_type::none));
+  auto chunk_bytes = static_cast<size_t>(bytes_per_us * round_trip_us / 4);
+  chunk_bytes = std::clamp(chunk_bytes, cipher_bytes, size_t{1} << 26);
+  profile.config["relu_chunk_bytes"] = std::to_string(chunk_bytes);
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+  profile.config["num_gc_threads"] = std::to_string(std::max(
+      size_t{1}, profile.hardware_threads / std::max(size_t{1},
+                                                     num_gc_party_threads)));
+#else
+  (void)num_gc_party_threads;
+#endif
+
+  for (const auto& [option, setting] : profile.config) {
+    NGRAPH_HE_LOG(1) << "Tuned " << option << " = " << setting;
+  }
+  return profile;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,73 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "seal/he_seal_encryption_parameters.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Settings chosen by autotune() for a host and encryption parameters
+struct HETuningProfile {
+  /// \brief Chosen settings, as HESealBackend::set_config entries
+  std::map<std::string, std::string> config;
+  /// \brief Hardware threads of the host tuned on
+  size_t hardware_threads{0};
+  /// \brief Polynomial degree of the encryption parameters tuned with
+  size_t poly_modulus_degree{0};
+  /// \brief Bit widths of the coefficient moduli tuned with
+  std::vector<int> coeff_modulus_bits;
+
+  /// \brief Returns whether or not the profile was tuned on a host with the
+  /// same number of hardware threads, with the given encryption parameters
+  /// \param[in] parms Encryption parameters
+  bool matches(const HESealEncryptionParameters& parms) const;
+
+  /// \brief Writes the profile as JSON
+  /// \param[in] filename File to write
+  /// \throws ngraph_error if the file cannot be written
+  void save(const std::string& filename) const;
+
+  /// \brief Reads a profile written by save()
+  /// \param[in] filename File to read
+  /// \throws ngraph_error if the file cannot be opened or parsed
+  static HETuningProfile load(const std::string& filename);
+};
+
+/// \brief Returns the number of hardware threads of the host
+size_t hardware_threads();
+
+/// \brief Times short calibrations on the host with the given encryption
+/// parameters, and returns the fastest settings. Compiles a small function
+/// mixing a Dot by Constant weights with a ciphertext product on a separate
+/// backend, and times its calls with and without lazy modular reduction and
+/// for powers of two intra-op threads. The fewest threads within 5% of the
+/// fastest call are chosen, which leaves cores to the I/O and inter-op
+/// threads. ReLU chunks are sized so serializing one takes a quarter of the
+/// round-trip latency, and garbled circuits use the hardware threads left
+/// by their parties' threads
+/// \param[in] parms Encryption parameters to tune with
+/// \param[in] round_trip_us Latency of a round-trip to the client
+/// \param[in] num_gc_party_threads Threads of each garbled circuit party
+HETuningProfile autotune(const HESealEncryptionParameters& parms,
+                         double round_trip_us, size_t num_gc_party_threads);
+
+}  // namespace ngraph::runtime::he
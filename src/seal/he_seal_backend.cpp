@@ -16,18 +16,40 @@
 
 #include "seal/he_seal_backend.hpp"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <iterator>
 #include <limits>
+#include <list>
 #include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "logging/ngraph_he_log.hpp"
+#include "ngraph/file_util.hpp"
 #include "ngraph/runtime/backend_manager.hpp"
+#include "ngraph/serializer.hpp"
 #include "ngraph/util.hpp"
 #include "nlohmann/json.hpp"
+#include "pass/merge_functions.hpp"
+#include "seal/he_seal_autotuner.hpp"
 #include "seal/he_seal_executable.hpp"
+#include "seal/he_seal_thread_budget.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 #include "seal/seal.h"
+#include "seal/seal_context_cache.hpp"
+#include "seal/seal_huge_pages.hpp"
 #include "seal/seal_util.hpp"
 
 using json = nlohmann::json;
@@ -51,33 +73,51 @@ HESealBackend::HESealBackend(HESealEncryptionParameters parms)
 }
 
 void HESealBackend::generate_context() {
-  seal::sec_level_type sec_level =
-      seal_security_level(m_encryption_params.security_level());
-
-  //seal::SEALContext m_context(m_encryption_params.seal_encryption_parameters(), true, sec_level);
-  m_context = std::make_shared<seal::SEALContext>(m_encryption_params.seal_encryption_parameters(), true, sec_level);
-  //seal::SEALContext t_context(m_encryption_params.seal_encryption_parameters(), true, sec_level);
-  //m_context = std::make_shared<seal::SEALContext>(t_context);
+  m_context = SealContextCache::get_context(m_encryption_params);
 
   auto context_data = m_context->key_context_data();
 
   m_keygen = std::make_shared<seal::KeyGenerator>(*m_context);
-  if (m_context->using_keyswitching()) {
-    seal::RelinKeys m_relin_keys_temp;
-    m_keygen->create_relin_keys(m_relin_keys_temp);
-    m_relin_keys = std::make_shared<seal::RelinKeys>(m_relin_keys_temp);
-    // Delay creation of m_galois_keys until needed
-    // m_galois_keys =
-    // std::make_shared<seal::GaloisKeys>(m_keygen->galois_keys());
-  }
-  seal::PublicKey m_public_key_temp;
-  m_keygen->create_public_key(m_public_key_temp);
-  m_public_key = std::make_shared<seal::PublicKey>(m_public_key_temp);
   m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
-  m_encryptor = std::make_shared<seal::Encryptor>(*m_context, *m_public_key);
+  // Delay creation of the public, relinearization and Galois keys until
+  // needed
+  m_public_key = nullptr;
+  m_relin_keys = nullptr;
+  m_encryptor = nullptr;
+  m_keys_generated = std::make_unique<std::once_flag>();
+  reset_zero_pool();
   m_decryptor = std::make_shared<seal::Decryptor>(*m_context, *m_secret_key);
-  m_evaluator = std::make_shared<seal::Evaluator>(*m_context);
-  m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(*m_context);
+  m_evaluator = SealContextCache::get_evaluator(m_encryption_params);
+  if (m_encryption_params.integer_scheme()) {
+    m_ckks_encoder = nullptr;
+    m_batch_encoder = std::make_shared<seal::BatchEncoder>(*m_context);
+  } else {
+    m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(*m_context);
+    m_batch_encoder = nullptr;
+  }
+  reset_sparse_encoder();
+
+  {
+    std::lock_guard<std::mutex> guard(m_galois_keys_mutex);
+    // The pending keys hold a reference to the previous key generator
+    if (m_pending_galois_keys.valid()) {
+      m_pending_galois_keys.wait();
+    }
+    m_pending_galois_keys = {};
+    m_galois_keys = nullptr;
+    m_galois_steps.clear();
+  }
+
+  // Cached executables are tied to the previous context
+  {
+    std::lock_guard<std::mutex> guard(m_executable_cache_mutex);
+    m_executable_cache.clear();
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_client_keys_mutex);
+    m_client_keys.clear();
+    m_client_key_ids.clear();
+  }
 
   auto coeff_moduli = context_data->parms().coeff_modulus();
 
@@ -88,6 +128,7 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
                                std::string& error) {
   (void)error;  // Avoid unused parameter warning
   NGRAPH_HE_LOG(3) << "Setting config";
+  bool autotune_settings = false;
   for (const auto& [option, setting] : config) {
     NGRAPH_HE_LOG(3) << "option name: <" << option << ">";
     // Check whether client is enabled
@@ -110,6 +151,30 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
       m_num_garbled_circuit_threads = flag_to_int(setting.c_str(), 1);
       NGRAPH_HE_LOG(3) << "Setting " << m_num_garbled_circuit_threads
                        << " garbled circuits threads from config";
+    } else if (option == "mpc_protocol") {
+      m_mpc_protocol = to_lower(setting);
+      NGRAPH_CHECK(m_mpc_protocol == "yao" || m_mpc_protocol == "gmw" ||
+                       m_mpc_protocol == "auto",
+                   "Unknown mpc_protocol ", setting);
+      NGRAPH_HE_LOG(3) << "Setting mpc protocol " << m_mpc_protocol
+                       << " from config";
+    } else if (option == "num_gc_party_threads") {
+      m_num_garbled_circuit_party_threads =
+          std::max(1, flag_to_int(setting.c_str(), 2));
+      NGRAPH_HE_LOG(3) << "Setting " << m_num_garbled_circuit_party_threads
+                       << " threads per garbled circuit party from config";
+    } else if (option == "num_inter_op_threads") {
+      m_num_inter_op_threads = std::max(1, flag_to_int(setting.c_str(), 1));
+      NGRAPH_HE_LOG(3) << "Setting " << m_num_inter_op_threads
+                       << " inter-op threads from config";
+    } else if (option == "num_intra_op_threads") {
+      m_num_intra_op_threads = std::max(0, flag_to_int(setting.c_str(), 0));
+      NGRAPH_HE_LOG(3) << "Setting " << m_num_intra_op_threads
+                       << " intra-op threads from config";
+    } else if (option == "num_io_threads") {
+      m_num_io_threads = std::max(1, flag_to_int(setting.c_str(), 1));
+      NGRAPH_HE_LOG(3) << "Setting " << m_num_io_threads
+                       << " I/O threads from config";
     } else if (option == "mask_gc_inputs") {
       m_mask_gc_inputs = string_to_bool(setting, false);
       if (m_mask_gc_inputs) {
@@ -124,6 +189,297 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
       } else {
         NGRAPH_HE_LOG(3) << "Not masking garbled circuits outputs from config";
       }
+    } else if (option == "relu_chunk_bytes") {
+      m_relu_chunk_bytes = std::max(1, flag_to_int(setting.c_str(), 1 << 22));
+      NGRAPH_HE_LOG(3) << "Setting " << m_relu_chunk_bytes
+                       << " relu chunk bytes from config";
+    } else if (option == "conv_tile_rows") {
+      m_conv_tile_rows = std::max(0, flag_to_int(setting.c_str(), 0));
+      NGRAPH_HE_LOG(3) << "Setting " << m_conv_tile_rows
+                       << " convolution tile rows from config";
+    } else if (option == "relu_window") {
+      m_relu_window = std::max(0, flag_to_int(setting.c_str(), 0));
+      NGRAPH_HE_LOG(3) << "Setting relu window " << m_relu_window
+                       << " from config";
+    } else if (option == "max_clients") {
+      m_max_clients = std::max(1, flag_to_int(setting.c_str(), 1));
+      NGRAPH_HE_LOG(3) << "Setting maximum of " << m_max_clients
+                       << " clients from config";
+    } else if (option == "thread_local_pools") {
+      m_thread_local_pools = string_to_bool(setting, false);
+      if (m_thread_local_pools) {
+        NGRAPH_HE_LOG(3) << "Enabling thread-local memory pools from config";
+      }
+    } else if (option == "numa_aware") {
+      m_numa_aware = string_to_bool(setting, false);
+      set_numa_aware_parallelism(m_numa_aware);
+      if (m_numa_aware) {
+        m_thread_local_pools = true;
+#ifdef _OPENMP
+        NGRAPH_HE_LOG(3) << "Enabling NUMA-aware parallelism over "
+                         << omp_get_num_places() << " OpenMP places from "
+                         << "config";
+        if (omp_get_num_places() <= 1) {
+          NGRAPH_WARN << "NUMA-aware parallelism without OpenMP places; set "
+                         "OMP_PLACES=sockets to bind threads";
+        }
+#endif
+      }
+    } else if (option == "model_parallel_stages" ||
+               option == "data_parallel_workers") {
+      auto& workers = option == "model_parallel_stages"
+                          ? m_model_parallel_stages
+                          : m_data_parallel_workers;
+      workers.clear();
+      for (const auto& address : split(setting, ',', true)) {
+        size_t colon = address.rfind(':');
+        NGRAPH_CHECK(colon != std::string::npos && colon > 0,
+                     "Invalid worker address ", address);
+        workers.emplace_back(address.substr(0, colon),
+                             std::stoul(address.substr(colon + 1)));
+      }
+      NGRAPH_CHECK(
+          m_model_parallel_stages.empty() || m_data_parallel_workers.empty(),
+          "model_parallel_stages and data_parallel_workers are exclusive");
+      NGRAPH_HE_LOG(3) << "Setting " << workers.size() << " " << option
+                       << " from config";
+    } else if (option == "zero_pool_size") {
+      m_zero_pool_size = std::max(0, flag_to_int(setting.c_str(), 0));
+      reset_zero_pool();
+      NGRAPH_HE_LOG(3) << "Setting zero pool size " << m_zero_pool_size
+                       << " from config";
+    } else if (option == "trusted_ciphertexts") {
+      m_trusted_ciphertexts = string_to_bool(setting, false);
+      if (m_trusted_ciphertexts) {
+        NGRAPH_HE_LOG(3) << "Trusting server ciphertexts from config";
+      }
+    } else if (option == "sparse_encoding") {
+      m_sparse_encoding = string_to_bool(setting, false);
+      reset_sparse_encoder();
+      if (m_sparse_encoding) {
+        NGRAPH_HE_LOG(3) << "Enabling sparse encoding from config";
+      }
+    } else if (option == "warmup") {
+      m_warmup_on_compile = string_to_bool(setting, false);
+      if (m_warmup_on_compile) {
+        NGRAPH_HE_LOG(3) << "Enabling warmup on compile from config";
+      }
+    } else if (option == "shm_transport") {
+      m_shm_transport = string_to_bool(setting, false);
+      if (m_shm_transport) {
+        NGRAPH_HE_LOG(3) << "Serving clients over shared memory from config";
+      }
+    } else if (option == "coalesce_client_ops") {
+      m_coalesce_client_ops = string_to_bool(setting, true);
+      NGRAPH_HE_LOG(3) << (m_coalesce_client_ops ? "Enabling" : "Disabling")
+                       << " coalesced client ops from config";
+    } else if (option == "client_epilogue") {
+      m_client_epilogue = string_to_bool(setting, false);
+      if (m_client_epilogue) {
+        NGRAPH_HE_LOG(3) << "Enabling client epilogue from config";
+      }
+    } else if (option == "packing_layout") {
+      std::string layout = to_lower(setting);
+      NGRAPH_CHECK(layout == "batch" || layout == "auto",
+                   "Unknown packing layout ", setting);
+      m_auto_packing_layout = layout == "auto";
+      NGRAPH_HE_LOG(3) << "Setting packing layout " << layout
+                       << " from config";
+    } else if (option == "executable_cache") {
+      m_executable_cache_enabled = string_to_bool(setting, false);
+      if (m_executable_cache_enabled) {
+        NGRAPH_HE_LOG(3) << "Enabling executable cache from config";
+      }
+    } else if (option == "refresh_mask_bound") {
+      m_refresh_mask_bound = std::stod(setting);
+      NGRAPH_CHECK(m_refresh_mask_bound >= 0, "Refresh mask bound ", setting,
+                   " must not be negative");
+      NGRAPH_HE_LOG(3) << "Setting refresh mask bound "
+                       << m_refresh_mask_bound << " from config";
+    } else if (option == "accelerator") {
+      m_accelerator = create_accelerator(setting);
+      NGRAPH_HE_LOG(3) << "Setting accelerator " << m_accelerator->name()
+                       << " from config";
+    } else if (option == "auto_encryption_parameters") {
+      m_auto_encryption_parameters = string_to_bool(setting, false);
+      if (m_auto_encryption_parameters) {
+        NGRAPH_HE_LOG(3)
+            << "Enabling automatic encryption parameter selection from config";
+      }
+    } else if (option == "polynomial_activation") {
+      m_polynomial_activation = polynomial_activation_from_string(setting);
+      NGRAPH_HE_LOG(3) << "Setting polynomial activation "
+                       << polynomial_activation_to_string(
+                              m_polynomial_activation)
+                       << " from config";
+    } else if (option == "polynomial_activation_bound") {
+      m_polynomial_activation_bound = std::stod(setting);
+      NGRAPH_CHECK(m_polynomial_activation_bound > 0,
+                   "Polynomial activation bound ", setting,
+                   " must be positive");
+      NGRAPH_HE_LOG(3) << "Setting polynomial activation bound "
+                       << m_polynomial_activation_bound << " from config";
+    } else if (option == "polynomial_degree") {
+      m_polynomial_degree = std::max(0, flag_to_int(setting.c_str(), 0));
+      NGRAPH_HE_LOG(3) << "Setting polynomial degree " << m_polynomial_degree
+                       << " from config";
+    } else if (option == "polynomial_divisor_range") {
+      std::vector<std::string> bounds = split(setting, ',');
+      NGRAPH_CHECK(bounds.size() == 2, "Invalid polynomial divisor range ",
+                   setting);
+      m_polynomial_divisor_range = {std::stod(bounds[0]),
+                                    std::stod(bounds[1])};
+      NGRAPH_CHECK(m_polynomial_divisor_range.first > 0 &&
+                       m_polynomial_divisor_range.first <
+                           m_polynomial_divisor_range.second,
+                   "Invalid polynomial divisor range ", setting);
+      NGRAPH_HE_LOG(3) << "Setting polynomial divisor range " << setting
+                       << " from config";
+    } else if (option == "lazy_relinearization") {
+      m_lazy_relinearization = string_to_bool(setting, false);
+      if (m_lazy_relinearization) {
+        NGRAPH_HE_LOG(3) << "Enabling lazy relinearization from config";
+      }
+    } else if (option == "encrypt_constants") {
+      m_encrypt_constants = string_to_bool(setting, false);
+      if (m_encrypt_constants) {
+        NGRAPH_HE_LOG(3) << "Enabling constant encryption from config";
+      }
+    } else if (option == "stream_client_inputs") {
+      m_stream_client_inputs = string_to_bool(setting, false);
+      if (m_stream_client_inputs) {
+        NGRAPH_HE_LOG(3) << "Enabling client input streaming from config";
+      }
+    } else if (option == "gc_relu_rescale") {
+      m_gc_relu_rescale = string_to_bool(setting, false);
+      if (m_gc_relu_rescale) {
+        NGRAPH_HE_LOG(3) << "Enabling garbled circuit rescaling from config";
+      }
+    } else if (option == "hybrid_linear_layers") {
+      m_hybrid_linear_layers = string_to_bool(setting, false);
+      if (m_hybrid_linear_layers) {
+        NGRAPH_HE_LOG(3) << "Enabling hybrid linear layers from config";
+      }
+    } else if (option == "noise_telemetry") {
+      m_noise_telemetry = string_to_bool(setting, false);
+      if (m_noise_telemetry) {
+        NGRAPH_HE_LOG(3) << "Enabling noise telemetry from config";
+      }
+    } else if (option == "dry_run") {
+      m_dry_run = string_to_bool(setting, false);
+      if (m_dry_run) {
+        NGRAPH_HE_LOG(3) << "Enabling dry run from config";
+      }
+    } else if (option == "cost_calibration") {
+      m_cost_calibration = HECostCalibration::load(setting);
+      NGRAPH_HE_LOG(3) << "Loaded cost calibration " << setting
+                       << " from config";
+    } else if (option == "latency_slo_ms") {
+      m_latency_slo_ms = std::stod(setting);
+      NGRAPH_CHECK(m_latency_slo_ms >= 0, "Latency SLO ", setting,
+                   " must not be negative");
+      NGRAPH_HE_LOG(3) << "Setting latency SLO " << m_latency_slo_ms
+                       << "ms from config";
+    } else if (option == "spill_directory") {
+      m_spill_directory = setting;
+      NGRAPH_HE_LOG(3) << "Setting spill directory " << setting
+                       << " from config";
+    } else if (option == "spill_threshold_mb") {
+      m_spill_threshold_mb = std::max(0, flag_to_int(setting.c_str(), 1024));
+      NGRAPH_HE_LOG(3) << "Setting spill threshold " << m_spill_threshold_mb
+                       << "MB from config";
+    } else if (option == "winograd_convolutions") {
+      m_winograd_convolutions = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting Winograd convolutions "
+                       << m_winograd_convolutions << " from config";
+    } else if (option == "avg_pool_max_pools") {
+      m_avg_pool_max_pools = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting AvgPool replacement of MaxPools "
+                       << m_avg_pool_max_pools << " from config";
+    } else if (option == "lazy_scalar_factors") {
+      m_lazy_scalar_factors = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting lazy scalar factors "
+                       << m_lazy_scalar_factors << " from config";
+    } else if (option == "input_cache_mb") {
+      m_input_cache_mb = std::max(0, flag_to_int(setting.c_str(), 0));
+      NGRAPH_HE_LOG(3) << "Setting input cache " << m_input_cache_mb
+                       << "MB from config";
+    } else if (option == "relu_compaction") {
+      m_relu_compaction = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting relu compaction "
+                       << bool_to_string(m_relu_compaction) << " from config";
+    } else if (option == "result_compaction") {
+      m_result_compaction = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting result compaction "
+                       << bool_to_string(m_result_compaction) << " from config";
+    } else if (option == "enable_plaintext_cache") {
+      m_plaintext_cache = string_to_bool(setting, true);
+      NGRAPH_HE_LOG(3) << "Setting plaintext cache "
+                       << bool_to_string(m_plaintext_cache) << " from config";
+    } else if (option == "plaintext_cache_mb") {
+      m_plaintext_cache_mb = std::max(0, flag_to_int(setting.c_str(), 0));
+      NGRAPH_HE_LOG(3) << "Setting plaintext cache " << m_plaintext_cache_mb
+                       << "MB from config";
+    } else if (option == "huge_pages") {
+      m_huge_pages = string_to_bool(setting, false);
+      if (m_huge_pages && !transparent_huge_pages_available()) {
+        NGRAPH_WARN << "Transparent huge pages are disabled; ciphertexts use "
+                       "regular pages";
+        m_huge_pages = false;
+      }
+      NGRAPH_HE_LOG(3) << "Setting huge pages " << bool_to_string(m_huge_pages)
+                       << " from config";
+    } else if (option == "memory_node_order") {
+      m_memory_node_order = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting memory node order "
+                       << bool_to_string(m_memory_node_order) << " from config";
+    } else if (option == "thread_budget") {
+      HEThreadBudget::configure(setting);
+      NGRAPH_HE_LOG(3) << "Setting thread budget of "
+                       << HEThreadBudget::num_threads()
+                       << " threads from config";
+    } else if (option == "quantized_weight_step") {
+      m_quantized_weight_step = std::stod(setting);
+      NGRAPH_CHECK(m_quantized_weight_step >= 0, "Quantized weight step ",
+                   setting, " must not be negative");
+      NGRAPH_HE_LOG(3) << "Setting quantized weight step "
+                       << m_quantized_weight_step << " from config";
+    } else if (option == "weight_scale_bits") {
+      m_weight_scale_bits = flag_to_int(setting.c_str(), 0);
+      NGRAPH_CHECK(m_weight_scale_bits >= 0 && m_weight_scale_bits <= 60,
+                   "Invalid weight scale bits ", setting);
+      NGRAPH_HE_LOG(3) << "Setting " << m_weight_scale_bits
+                       << " weight scale bits from config";
+    } else if (option == "metrics_port") {
+      int metrics_port = flag_to_int(setting.c_str(), 0);
+      NGRAPH_CHECK(metrics_port >= 0 && metrics_port <= 65535,
+                   "Invalid metrics port ", setting);
+      m_metrics_port = static_cast<size_t>(metrics_port);
+      NGRAPH_HE_LOG(3) << "Setting metrics port " << m_metrics_port
+                       << " from config";
+    } else if (option == "metrics_address") {
+      m_metrics_address = setting;
+      NGRAPH_HE_LOG(3) << "Setting metrics address " << m_metrics_address
+                       << " from config";
+    } else if (option == "lazy_mod") {
+      m_lazy_mod = string_to_bool(setting, false);
+      NGRAPH_HE_LOG(3) << "Setting lazy mod " << bool_to_string(m_lazy_mod)
+                       << " from config";
+    } else if (option == "tuning_profile") {
+      m_tuning_profile = setting;
+      NGRAPH_HE_LOG(3) << "Setting tuning profile " << m_tuning_profile
+                       << " from config";
+    } else if (option == "autotune") {
+      autotune_settings = string_to_bool(setting, false);
+    } else if (option == "client_mod_switch") {
+      m_client_mod_switch = string_to_bool(setting, false);
+      if (m_client_mod_switch) {
+        NGRAPH_HE_LOG(3) << "Enabling client modulus switching from config";
+      }
+    } else if (option == "compression") {
+      m_compr_mode = compr_mode_from_string(setting);
+      NGRAPH_HE_LOG(3) << "Setting compression mode "
+                       << compr_mode_to_string(m_compr_mode) << " from config";
     } else if (option == "port") {
       m_port = flag_to_int(setting.c_str(), 34000);
       NGRAPH_HE_LOG(3) << "Setting " << m_port << " port number";
@@ -132,6 +488,80 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
       std::vector<std::string> lower_settings = split(to_lower(setting), ',');
       // Strip attributes, i.e. "tensor_name:0 => tensor_name"
       std::string tensor_name = option.substr(0, option.find(':', 0));
+
+      // Node settings, i.e. {node_name : "polynomial_square"}
+      static const std::string polynomial_prefix = "polynomial_";
+      auto is_polynomial_setting = [](const std::string& lower_setting) {
+        return lower_setting.rfind(polynomial_prefix, 0) == 0;
+      };
+      for (const auto& lower_setting : lower_settings) {
+        if (is_polynomial_setting(lower_setting)) {
+          auto activation = polynomial_activation_from_string(
+              lower_setting.substr(polynomial_prefix.size()));
+          m_node_polynomial_activations.insert_or_assign(option, activation);
+          NGRAPH_HE_LOG(3) << "Setting polynomial activation "
+                           << polynomial_activation_to_string(activation)
+                           << " for node " << option;
+        }
+      }
+      // Node kernels, i.e. {node_name : "kernel_winograd"}
+      static const std::string kernel_prefix = "kernel_";
+      auto is_kernel_setting = [](const std::string& lower_setting) {
+        return lower_setting.rfind(kernel_prefix, 0) == 0;
+      };
+      for (const auto& lower_setting : lower_settings) {
+        if (is_kernel_setting(lower_setting)) {
+          std::string kernel = lower_setting.substr(kernel_prefix.size());
+          m_node_kernels.insert_or_assign(option, kernel);
+          NGRAPH_HE_LOG(3) << "Setting kernel " << kernel << " for node "
+                           << option;
+        }
+      }
+      // Node pooling, i.e. {node_name : "avg_pool"}
+      auto is_pooling_setting = [](const std::string& lower_setting) {
+        return lower_setting == "avg_pool" || lower_setting == "max_pool";
+      };
+      for (const auto& lower_setting : lower_settings) {
+        if (is_pooling_setting(lower_setting)) {
+          m_node_avg_pools.insert_or_assign(option,
+                                            lower_setting == "avg_pool");
+          NGRAPH_HE_LOG(3) << "Setting " << lower_setting << " for node "
+                           << option;
+        }
+      }
+      // Tensor ranges, i.e. {tensor_name : "range:0:1"}
+      static const std::string range_prefix = "range:";
+      auto is_range_setting = [](const std::string& lower_setting) {
+        return lower_setting.rfind(range_prefix, 0) == 0;
+      };
+      for (const auto& lower_setting : lower_settings) {
+        if (is_range_setting(lower_setting)) {
+          std::vector<std::string> bounds =
+              split(lower_setting.substr(range_prefix.size()), ':');
+          NGRAPH_CHECK(bounds.size() == 2, "Invalid range ", lower_setting,
+                       " for option ", option);
+          std::pair<double, double> range{std::stod(bounds[0]),
+                                          std::stod(bounds[1])};
+          NGRAPH_CHECK(range.first <= range.second, "Invalid range ",
+                       lower_setting, " for option ", option);
+          m_input_ranges.insert_or_assign(tensor_name, range);
+          NGRAPH_HE_LOG(3) << "Setting range [" << range.first << ", "
+                           << range.second << "] for tensor " << tensor_name;
+        }
+      }
+      lower_settings.erase(
+          std::remove_if(lower_settings.begin(), lower_settings.end(),
+                         [&](const std::string& lower_setting) {
+                           return is_polynomial_setting(lower_setting) ||
+                                  is_kernel_setting(lower_setting) ||
+                                  is_pooling_setting(lower_setting) ||
+                                  is_range_setting(lower_setting);
+                         }),
+          lower_settings.end());
+      if (lower_settings.empty()) {
+        continue;
+      }
+
       m_config_tensors.insert_or_assign(
           tensor_name,
           *HEOpAnnotations::server_plaintext_unpacked_annotation());
@@ -156,6 +586,42 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
     }
   }
 
+  if (autotune_settings || config.count("tuning_profile") != 0) {
+    HETuningProfile profile;
+    bool have_profile = false;
+    if (!m_tuning_profile.empty() && file_util::exists(m_tuning_profile)) {
+      profile = HETuningProfile::load(m_tuning_profile);
+      have_profile = profile.matches(m_encryption_params);
+      if (!have_profile && !autotune_settings) {
+        NGRAPH_WARN << "Tuning profile " << m_tuning_profile
+                    << " was tuned on another host or with other encryption "
+                       "parameters; applying it anyway";
+        have_profile = true;
+      }
+    }
+    if (!have_profile && autotune_settings) {
+      NGRAPH_HE_LOG(1) << "Autotuning settings";
+      profile = autotune(m_encryption_params, m_cost_calibration.round_trip_us,
+                         m_num_garbled_circuit_party_threads);
+      if (!m_tuning_profile.empty()) {
+        profile.save(m_tuning_profile);
+      }
+      have_profile = true;
+    }
+    NGRAPH_CHECK(have_profile, "Tuning profile ", m_tuning_profile,
+                 " does not exist");
+
+    std::map<std::string, std::string> profile_config;
+    for (const auto& [option, setting] : profile.config) {
+      if (config.find(option) == config.end()) {
+        profile_config[option] = setting;
+      }
+    }
+    if (!profile_config.empty() && !set_config(profile_config, error)) {
+      return false;
+    }
+  }
+
   if (m_enable_garbled_circuit && !m_enable_client) {
     NGRAPH_WARN << "Garbled circuit enabled without enabling client; setting "
                    "Garbled circuit enabled to off";
@@ -175,9 +641,42 @@ bool HESealBackend::set_config(const std::map<std::string, std::string>& config,
   for (const auto& [name, config] : m_config_tensors) {
     NGRAPH_HE_LOG(3) << "Tensor name: " << name << " with config " << config;
   }
+
+  // Cached executables were compiled with the previous configuration
+  std::lock_guard<std::mutex> guard(m_executable_cache_mutex);
+  m_executable_cache.clear();
   return true;
 }
 
+PolynomialActivation HESealBackend::polynomial_activation(
+    const Node& node) const {
+  auto it = m_node_polynomial_activations.find(node.get_name());
+  if (it != m_node_polynomial_activations.end()) {
+    return it->second;
+  }
+  return m_polynomial_activation;
+}
+
+std::string HESealBackend::node_kernel(const Node& node) const {
+  auto it = m_node_kernels.find(node.get_name());
+  return it == m_node_kernels.end() ? std::string() : it->second;
+}
+
+bool HESealBackend::avg_pool_max_pool(const Node& node) const {
+  auto it = m_node_avg_pools.find(node.get_name());
+  return it == m_node_avg_pools.end() ? m_avg_pool_max_pools : it->second;
+}
+
+std::optional<std::pair<double, double>> HESealBackend::input_range(
+    const op::Parameter& param) const {
+  for (const auto& [tensor_name, range] : m_input_ranges) {
+    if (param_originates_from_name(param, tensor_name)) {
+      return range;
+    }
+  }
+  return std::nullopt;
+}
+
 void HESealBackend::update_encryption_parameters(
     const HESealEncryptionParameters& new_parms) {
   if (HESealEncryptionParameters::same_context(m_encryption_params,
@@ -196,17 +695,21 @@ std::shared_ptr<runtime::Tensor> HESealBackend::create_tensor(
 
 std::shared_ptr<runtime::Tensor> HESealBackend::create_plain_tensor(
     const element::Type& type, const Shape& shape, const bool plaintext_packing,
-    const std::string& name) const {
-  auto tensor = std::make_shared<HETensor>(
-      type, shape, plaintext_packing, complex_packing(), false, *this, name);
+    const std::string& name, bool initialize) const {
+  auto tensor =
+      std::make_shared<HETensor>(type, shape, plaintext_packing,
+                                 complex_packing(), false, *this, name,
+                                 initialize);
   return std::static_pointer_cast<runtime::Tensor>(tensor);
 }
 
 std::shared_ptr<runtime::Tensor> HESealBackend::create_cipher_tensor(
     const element::Type& type, const Shape& shape, const bool plaintext_packing,
-    const std::string& name) const {
-  auto tensor = std::make_shared<HETensor>(
-      type, shape, plaintext_packing, complex_packing(), true, *this, name);
+    const std::string& name, bool initialize) const {
+  auto tensor =
+      std::make_shared<HETensor>(type, shape, plaintext_packing,
+                                 complex_packing(), true, *this, name,
+                                 initialize);
   return std::static_pointer_cast<runtime::Tensor>(tensor);
 }
 
@@ -225,8 +728,52 @@ std::shared_ptr<runtime::Tensor> HESealBackend::create_packed_plain_tensor(
 }
 
 // NOLINTNEXTLINE
+namespace {
+/// \brief Returns a fingerprint of the structure of a function, i.e. its
+/// serialization with node and tensor names replaced by their order of
+/// appearance, and of the annotations of its parameters
+std::string function_fingerprint(const std::shared_ptr<Function>& function) {
+  json js = json::parse(serialize(function));
+  std::unordered_map<std::string, size_t> name_indices;
+  for (auto& serialized_function : js) {
+    serialized_function.erase("name");
+    for (const auto& op : serialized_function.at("ops")) {
+      name_indices.emplace(op.at("name").get<std::string>(),
+                           name_indices.size());
+      if (op.find("outputs") != op.end()) {
+        for (const auto& output : op.at("outputs")) {
+          name_indices.emplace(output.get<std::string>(), name_indices.size());
+        }
+      }
+    }
+  }
+  std::function<void(json&)> rename = [&](json& value) {
+    if (value.is_string()) {
+      auto it = name_indices.find(value.get<std::string>());
+      if (it != name_indices.end()) {
+        value = "#" + std::to_string(it->second);
+      }
+    } else if (value.is_structured()) {
+      for (auto& element : value) {
+        rename(element);
+      }
+    }
+  };
+  rename(js);
+
+  std::stringstream stream;
+  stream << js.dump();
+  for (const auto& param : function->get_parameters()) {
+    stream << *HEOpAnnotations::he_op_annotation(*param);
+  }
+  return key_fingerprint(stream.str());
+}
+}  // namespace
+
 std::shared_ptr<runtime::Executable> HESealBackend::compile(
     std::shared_ptr<Function> function, bool enable_performance_data) {
+  NGRAPH_CHECK(!integer_scheme(),
+               "Compiling functions requires CKKS encryption parameters");
   NGRAPH_HE_LOG(1) << "Compiling function with "
                    << function->get_parameters().size() << " parameters";
 
@@ -255,14 +802,298 @@ std::shared_ptr<runtime::Executable> HESealBackend::compile(
     }
   }
 
-  return std::dynamic_pointer_cast<runtime::Executable>(
-      std::make_shared<HESealExecutable>(function, enable_performance_data,
-                                         *this));
+  if (!m_executable_cache_enabled) {
+    return std::make_shared<HESealExecutable>(function,
+                                              enable_performance_data, *this);
+  }
+
+  // Compiling may select new encryption parameters, so executables are
+  // cached under the parameters they were compiled with
+  std::string fingerprint = function_fingerprint(function);
+  auto cache_key = [&]() {
+    std::stringstream stream;
+    m_encryption_params.save(stream);
+    return fingerprint + key_fingerprint(stream.str());
+  };
+  {
+    std::lock_guard<std::mutex> guard(m_executable_cache_mutex);
+    // The passes rewrite compiled functions, so they no longer match their
+    // fingerprint
+    for (const auto& [key, cached] : m_executable_cache) {
+      if (cached.function.lock() == function) {
+        NGRAPH_HE_LOG(1) << "Reusing executable of compiled function";
+        return cached.executable;
+      }
+    }
+    auto it = m_executable_cache.find(cache_key());
+    if (it != m_executable_cache.end()) {
+      NGRAPH_HE_LOG(1) << "Reusing executable of function " << fingerprint;
+      return it->second.executable;
+    }
+  }
+  // Compiled without the lock, since new encryption parameters clear the
+  // cache
+  auto executable = std::make_shared<HESealExecutable>(
+      function, enable_performance_data, *this);
+  std::lock_guard<std::mutex> guard(m_executable_cache_mutex);
+  m_executable_cache.insert_or_assign(cache_key(),
+                                      CachedExecutable{function, executable});
+  return executable;
+}
+
+std::shared_ptr<runtime::Executable> HESealBackend::compile_shared(
+    const std::vector<std::shared_ptr<Function>>& functions,
+    bool enable_performance_data) {
+  NGRAPH_HE_LOG(1) << "Compiling " << functions.size()
+                   << " functions with shared nodes";
+  return compile(pass::merge_functions(functions), enable_performance_data);
+}
+
+seal::MemoryPoolHandle HESealBackend::pool() const {
+  if (!m_thread_local_pools) {
+    return seal::MemoryManager::GetPool();
+  }
+  thread_local size_t t_owner_id{std::numeric_limits<size_t>::max()};
+  thread_local seal::MemoryPoolHandle t_pool;
+  if (t_owner_id != m_instance_id) {
+    t_pool = seal::MemoryPoolHandle::New();
+    t_owner_id = m_instance_id;
+    std::lock_guard<std::mutex> guard(m_thread_pools_mutex);
+    m_thread_pools.emplace_back(t_pool);
+  }
+  return t_pool;
+}
+
+HESealBackend::PoolStatistics HESealBackend::pool_statistics() const {
+  PoolStatistics stats;
+  stats.global_bytes = seal::MemoryManager::GetPool().alloc_byte_count();
+  std::lock_guard<std::mutex> guard(m_thread_pools_mutex);
+  stats.thread_local_pools = m_thread_pools.size();
+  for (const auto& thread_pool : m_thread_pools) {
+    stats.thread_local_bytes += thread_pool.alloc_byte_count();
+  }
+  return stats;
+}
+
+namespace {
+std::shared_ptr<seal::GaloisKeys> create_galois_keys(
+    seal::KeyGenerator& keygen, const std::set<int>& steps) {
+  NGRAPH_HE_LOG(3) << "Generating Galois keys for " << steps.size()
+                   << " steps";
+  auto galois_keys = std::make_shared<seal::GaloisKeys>();
+  keygen.create_galois_keys(std::vector<int>(steps.begin(), steps.end()),
+                            *galois_keys);
+  return galois_keys;
+}
+}  // namespace
+
+void HESealBackend::prepare_galois_keys(const std::set<int>& steps) {
+  std::lock_guard<std::mutex> guard(m_galois_keys_mutex);
+  if (std::includes(m_galois_steps.begin(), m_galois_steps.end(),
+                    steps.begin(), steps.end())) {
+    return;
+  }
+  // Generations are not run concurrently on the same key generator
+  if (m_pending_galois_keys.valid()) {
+    m_galois_keys = m_pending_galois_keys.get();
+  }
+  m_galois_steps.insert(steps.begin(), steps.end());
+  m_pending_galois_keys =
+      std::async(std::launch::async,
+                 [keygen = m_keygen, all_steps = m_galois_steps]() {
+                   return create_galois_keys(*keygen, all_steps);
+                 })
+          .share();
+}
+
+std::shared_ptr<seal::GaloisKeys> HESealBackend::get_galois_keys(
+    const std::set<int>& steps) {
+  std::lock_guard<std::mutex> guard(m_galois_keys_mutex);
+  if (m_pending_galois_keys.valid()) {
+    m_galois_keys = m_pending_galois_keys.get();
+    m_pending_galois_keys = {};
+  }
+  if (m_galois_keys == nullptr ||
+      !std::includes(m_galois_steps.begin(), m_galois_steps.end(),
+                     steps.begin(), steps.end())) {
+    m_galois_steps.insert(steps.begin(), steps.end());
+    m_galois_keys = create_galois_keys(*m_keygen, m_galois_steps);
+  }
+  return m_galois_keys;
+}
+
+void HESealBackend::rotate_hoisted(
+    const seal::Ciphertext& encrypted, const std::vector<int>& steps,
+    std::vector<seal::Ciphertext>& destinations) {
+  std::set<int> key_steps;
+  for (int step : steps) {
+    if (step != 0) {
+      key_steps.insert(step);
+    }
+  }
+  // Products left at size 3 by lazy relinearization are relinearized first
+  const seal::Ciphertext* source = &encrypted;
+  seal::Ciphertext relinearized;
+  if (encrypted.size() > 2) {
+    m_evaluator->relinearize(encrypted, *get_relin_keys(), relinearized);
+    source = &relinearized;
+  }
+  destinations.resize(steps.size());
+  if (key_steps.empty()) {
+    std::fill(destinations.begin(), destinations.end(), *source);
+    return;
+  }
+  const auto galois_keys = get_galois_keys(key_steps);
+  HoistedRotator rotator(*source, m_context);
+#pragma omp parallel for
+  for (size_t i = 0; i < steps.size(); ++i) {
+    rotator.rotate(steps[i], *galois_keys, destinations[i]);
+  }
+}
+
+void HESealBackend::cache_client_keys(const std::string& key_id) {
+  std::lock_guard<std::mutex> guard(m_client_keys_mutex);
+  if (m_client_keys.find(key_id) == m_client_keys.end()) {
+    if (m_client_key_ids.size() >= s_max_cached_client_keys) {
+      m_client_keys.erase(m_client_key_ids.front());
+      m_client_key_ids.pop_front();
+    }
+    m_client_key_ids.emplace_back(key_id);
+  }
+  m_client_keys.insert_or_assign(
+      key_id, ClientKeys{m_public_key, m_relin_keys, m_encryptor});
+  NGRAPH_HE_LOG(3) << "Cached keys of client " << key_id;
+}
+
+bool HESealBackend::load_cached_client_keys(const std::string& key_id) {
+  std::lock_guard<std::mutex> guard(m_client_keys_mutex);
+  auto it = m_client_keys.find(key_id);
+  if (it == m_client_keys.end()) {
+    NGRAPH_HE_LOG(3) << "No cached keys for client " << key_id;
+    return false;
+  }
+  m_public_key = it->second.public_key;
+  m_relin_keys = it->second.relin_keys;
+  m_encryptor = it->second.encryptor;
+  reset_zero_pool();
+  NGRAPH_HE_LOG(3) << "Using cached keys of client " << key_id;
+  return true;
+}
+
+void HESealBackend::cache_client_input(const std::string& key_scope,
+                                       const std::string& handle,
+                                       std::shared_ptr<HETensor> tensor) {
+  size_t bytes = tensor->ciphertext_byte_count();
+  if (bytes > input_cache_bytes()) {
+    NGRAPH_HE_LOG(3) << "Client input " << handle << " of " << bytes
+                     << " bytes exceeds the input cache";
+    return;
+  }
+  std::string key = key_scope + "/" + handle;
+  std::lock_guard<std::mutex> guard(m_input_cache_mutex);
+  if (auto it = m_input_cache_index.find(key);
+      it != m_input_cache_index.end()) {
+    m_input_cache_used_bytes -= it->second->bytes;
+    m_input_cache.erase(it->second);
+    m_input_cache_index.erase(it);
+  }
+  while (m_input_cache_used_bytes + bytes > input_cache_bytes()) {
+    const auto& evicted = m_input_cache.front();
+    NGRAPH_HE_LOG(3) << "Evicting cached client input " << evicted.key;
+    m_input_cache_used_bytes -= evicted.bytes;
+    m_input_cache_index.erase(evicted.key);
+    m_input_cache.pop_front();
+  }
+  m_input_cache.push_back({key, std::move(tensor), bytes});
+  m_input_cache_index[key] = std::prev(m_input_cache.end());
+  m_input_cache_used_bytes += bytes;
+  NGRAPH_HE_LOG(3) << "Cached client input " << handle << " of " << bytes
+                   << " bytes";
+}
+
+std::shared_ptr<HETensor> HESealBackend::cached_client_input(
+    const std::string& key_scope, const std::string& handle) {
+  std::lock_guard<std::mutex> guard(m_input_cache_mutex);
+  auto it = m_input_cache_index.find(key_scope + "/" + handle);
+  if (it == m_input_cache_index.end()) {
+    return nullptr;
+  }
+  m_input_cache.splice(m_input_cache.end(), m_input_cache, it->second);
+  return it->second->tensor;
+}
+
+void HESealBackend::generate_keys() const {
+  std::call_once(*m_keys_generated, [this]() {
+    if (m_public_key == nullptr) {
+      seal::PublicKey public_key;
+      m_keygen->create_public_key(public_key);
+      m_public_key = std::make_shared<seal::PublicKey>(std::move(public_key));
+      m_encryptor =
+          std::make_shared<seal::Encryptor>(*m_context, *m_public_key);
+      reset_zero_pool();
+      NGRAPH_HE_LOG(3) << "Generated server public key";
+    }
+    if (m_relin_keys == nullptr && m_context->using_keyswitching()) {
+      seal::RelinKeys relin_keys;
+      m_keygen->create_relin_keys(relin_keys);
+      m_relin_keys = std::make_shared<seal::RelinKeys>(std::move(relin_keys));
+      NGRAPH_HE_LOG(3) << "Generated server relinearization keys";
+    }
+  });
+}
+
+void HESealBackend::reset_zero_pool() const {
+  // The previous pool stops before the new pool registers, since cached
+  // client keys may restore the same encryptor
+  m_zero_pool = nullptr;
+  if (m_zero_pool_size > 0 && m_encryptor != nullptr) {
+    m_zero_pool = std::make_unique<SealZeroPool>(m_context, m_encryptor,
+                                                 m_zero_pool_size);
+  }
+}
+
+void HESealBackend::reset_sparse_encoder() {
+  // The previous encoder unregisters before the new encoder registers, since
+  // both may replace the same CKKS encoder
+  m_sparse_encoder = nullptr;
+  if (m_sparse_encoding && m_ckks_encoder != nullptr) {
+    m_sparse_encoder =
+        std::make_unique<SealSparseEncoder>(m_context, m_ckks_encoder);
+  }
+}
+
+seal::parms_id_type HESealBackend::lowest_decryptable_parms_id(
+    double scale) const {
+  double min_bits = std::log2(scale) + s_decryption_headroom_bits;
+  auto context_data = m_context->last_context_data();
+  while (context_data->parms_id() != m_context->first_parms_id() &&
+         context_data->total_coeff_modulus_bit_count() < min_bits) {
+    context_data = context_data->prev_context_data();
+  }
+  return context_data->parms_id();
+}
+
+double HESealBackend::multiplicand_scale(const seal::parms_id_type& parms_id,
+                                        double scale) const {
+  if (m_weight_scale_bits == 0) {
+    return scale;
+  }
+  auto context_data = m_context->get_context_data(parms_id);
+  if (context_data == nullptr ||
+      context_data->chain_index() < rescale_primes()) {
+    return scale;
+  }
+  return rescale_divisor(*context_data, rescale_primes());
 }
 
 bool HESealBackend::is_supported(const Node& node) const {
-  return m_unsupported_op_name_list.find(node.description()) ==
-             m_unsupported_op_name_list.end() &&
+  // The client computes unary elementwise ops on its decrypted values
+  bool client_elementwise =
+      m_enable_client &&
+      client_elementwise_function(node.description()) != nullptr;
+  return (client_elementwise ||
+          m_unsupported_op_name_list.find(node.description()) ==
+              m_unsupported_op_name_list.end()) &&
          is_supported_type(node.get_element_type());
 }
 
@@ -270,8 +1101,18 @@ void HESealBackend::encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
                             const HEPlaintext& input, const element::Type& type,
                             bool complex_packing) const {
   NGRAPH_CHECK(!input.empty(), "Input has no values in encrypt");
+  if (integer_scheme()) {
+    seal::Plaintext plaintext;
+    encode_integers(plaintext, input, *m_batch_encoder,
+                    m_encryption_params.plain_modulus());
+    if (output == nullptr) {
+      output = create_empty_ciphertext();
+    }
+    get_encryptor()->encrypt(plaintext, output->ciphertext());
+    return;
+  }
   ngraph::runtime::he::encrypt(output, input, m_context->first_parms_id(), type,
-                               get_scale(), *m_ckks_encoder, *m_encryptor,
+                               get_scale(), *m_ckks_encoder, *get_encryptor(),
                                complex_packing);
 }
 
@@ -279,6 +1120,12 @@ void HESealBackend::decrypt(HEPlaintext& output,
                             const SealCiphertextWrapper& input,
                             size_t batch_size,
                             const bool complex_packing) const {
+  if (integer_scheme()) {
+    seal::Plaintext plaintext;
+    m_decryptor->decrypt(input.ciphertext(), plaintext);
+    decode_integers(output, plaintext, *m_batch_encoder, batch_size);
+    return;
+  }
   ngraph::runtime::he::decrypt(output, input, complex_packing, *m_decryptor,
                                *m_ckks_encoder, m_context, batch_size);
 }
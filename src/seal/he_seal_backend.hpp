@@ -16,12 +16,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <functional>
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "he_op_annotations.hpp"
@@ -29,6 +37,7 @@
 #include "he_tensor.hpp"
 #include "he_type.hpp"
 #include "he_util.hpp"
+#include "ngraph/check.hpp"
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/descriptor/layout/tensor_layout.hpp"
 #include "ngraph/function.hpp"
@@ -44,10 +53,15 @@
 #include "ngraph/runtime/tensor.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "ngraph/util.hpp"
+#include "seal/he_cost_model.hpp"
+#include "seal/he_seal_accelerator.hpp"
 #include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/polynomial_activation.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
+#include "seal/seal_sparse_encoder.hpp"
+#include "seal/seal_zero_pool.hpp"
 
 extern "C" void ngraph_register_he_seal_backend();
 
@@ -82,7 +96,9 @@ class HESealBackend : public runtime::Backend {
     throw ngraph_error("create_tensor unimplemented");
   }
 
-  /// \brief Compiles a function
+  /// \brief Compiles a function. With executable_cache set, returns the
+  /// executable compiled earlier for the same function, or for a function
+  /// of the same structure and parameter configuration
   /// \brief param[in] function Function to compile
   /// \brief param[in] enable_performance_data TODO(fboemer): unused
   /// \returns An executable object
@@ -90,6 +106,18 @@ class HESealBackend : public runtime::Backend {
       std::shared_ptr<Function> function,
       bool enable_performance_data = false) override;
 
+  /// \brief Compiles functions on the same inputs, such as task heads on a
+  /// shared backbone, into one executable. Nodes the functions have in
+  /// common are computed once per call, see pass::merge_functions
+  /// \param[in] functions Functions to compile, whose nodes are rewired to
+  /// the shared nodes
+  /// \param[in] enable_performance_data TODO(fboemer): unused
+  /// \returns An executable taking the parameters of the first function, and
+  /// computing the results of each function in order
+  std::shared_ptr<ngraph::runtime::Executable> compile_shared(
+      const std::vector<std::shared_ptr<Function>>& functions,
+      bool enable_performance_data = false);
+
   /// \brief Returns whether or not a given node is supported
   /// \param[in] node Node
   bool is_supported(const Node& node) const override;
@@ -114,6 +142,331 @@ class HESealBackend : public runtime::Backend {
   ///     6) {"enable_gc": "True"/"False"}, which indicates whether or not the
   ///     client should use garbled circuits for secure function evaluation.
   ///     Should only be enabled if the client is enabled.
+  ///     7) {"client_mod_switch": "True"/"False"}, which indicates whether
+  ///     or not ciphertexts sent to the client for ReLU and MaxPool are
+  ///     switched to the lowest modulus at which they are decrypted
+  ///     correctly. Ignored with garbled circuits. Defaults to false.
+  ///     8) {"max_clients": "N"}, which sets the maximum number of client
+  ///     connections held open by the server at once. Each call serves the
+  ///     longest-waiting client; with N > 1, each client is served by a
+  ///     single call. Sessions are serialized: the executable holds the
+  ///     state of one session, so the other clients wait, connected, until
+  ///     the calls ahead of them return, and clients are not computed on
+  ///     concurrently. Defaults to 1.
+  ///     9) {"thread_local_pools": "True"/"False"}, which indicates whether
+  ///     or not each thread uses its own memory pool for temporary
+  ///     allocations in kernels, rather than the global SEAL memory pool.
+  ///     Defaults to false.
+  ///     10) {"auto_encryption_parameters": "True"/"False"}, which indicates
+  ///     whether or not compile() replaces the encryption parameters by the
+  ///     smallest parameters supporting the compiled function's
+  ///     multiplicative depth, at the configured security level and scale.
+  ///     Regenerates the keys, so tensors created before compiling are
+  ///     invalidated. Defaults to false.
+  ///     11) {"polynomial_activation": "none"/"square"/"minimax"/"sign"},
+  ///     which sets the polynomial approximation with which the server
+  ///     computes Relu, BoundedRelu, MaxPool and ConvolutionBiasRelu ops, see
+  ///     PolynomialActivation. Approximated ops are computed without the
+  ///     client, even if the client is enabled. Defaults to "none".
+  ///     12) {"polynomial_activation_bound": "B"}, which sets the bound on the
+  ///     absolute value of activation inputs within which the polynomial
+  ///     approximations are accurate. Defaults to 1.
+  ///     13) {node_name : "polynomial_none"/"polynomial_square"/
+  ///     "polynomial_minimax"/"polynomial_sign"}, which overrides the
+  ///     polynomial approximation of the specified activation node.
+  ///     14) {"polynomial_degree": "d"}, which sets the degree of the
+  ///     Chebyshev approximations with which the server computes Exp and
+  ///     Softmax of ciphertexts, and Divide by ciphertexts. Exp is
+  ///     approximated on [-B, B], for B the polynomial activation bound.
+  ///     Defaults to 0, which decrypts the ciphertexts instead.
+  ///     15) {"polynomial_divisor_range": "lower,upper"}, which sets the
+  ///     range of ciphertext divisors on which reciprocals are approximated.
+  ///     Defaults to "1,16".
+  ///     16) {"lazy_relinearization": "True"/"False"}, which indicates
+  ///     whether or not ciphertext-ciphertext products are left at size 3,
+  ///     and relinearized only once an operation requires size 2, such that
+  ///     sums of products are relinearized once. Defaults to false.
+  ///     17) {"encrypt_constants": "True"/"False"}, which indicates whether
+  ///     or not Constant weights are encrypted, for models whose weights are
+  ///     private while the inputs are plaintext. The weights are encrypted
+  ///     once at compile time and reused by every call. Weights which are
+  ///     Parameters are encrypted using entries of form 3). Defaults to
+  ///     false.
+  ///     18) {"stream_client_inputs": "True"/"False"}, which indicates
+  ///     whether or not the server starts computing on client inputs before
+  ///     they have fully arrived. Dot ops whose first argument is a client
+  ///     input accumulate partial sums over the received prefix of the
+  ///     input, while other ops wait for their client inputs to complete.
+  ///     Defaults to false.
+  ///     19) {"num_io_threads": "n"}, which sets the number of threads
+  ///     running the server's network I/O. Messages of a session are still
+  ///     handled in order of receipt, but are parsed and loaded while the
+  ///     next message is read. Defaults to 1.
+  ///     20) {"gc_relu_rescale": "True"/"False"}, which indicates whether or
+  ///     not the rescale preceding a garbled circuit Relu is performed inside
+  ///     the circuit. The op producing the Relu argument leaves its result
+  ///     unrescaled, and the circuit divides the ReLU output by the power of
+  ///     two relating its scale to the encoding scale. This saves a
+  ///     coefficient modulus, but requires the lowest coefficient modulus to
+  ///     hold the unrescaled values. Defaults to false.
+  ///     21) {"hybrid_linear_layers": "True"/"False"}, which indicates
+  ///     whether or not a Dot followed by a garbled circuit Relu may be
+  ///     computed in ABY arithmetic sharing instead of HE. A cost model
+  ///     chooses the cheaper protocol for each such layer. Requires garbled
+  ///     circuits, and the Dot weights to be Constants. Defaults to false.
+  ///     22) {"num_gc_party_threads": "n"}, which sets the number of threads
+  ///     each garbled circuit party uses for its OT extension. Each party
+  ///     set with "num_gc_threads" holds its own connection, so a single
+  ///     party uses several cores without opening further ports. The client
+  ///     uses the same number of threads. Defaults to 2.
+  ///     23) {"noise_telemetry": "True"/"False"}, which indicates whether or
+  ///     not the server decrypts samples of each op's output ciphertexts to
+  ///     record their chain index, scale, headroom and precision, see
+  ///     HESealExecutable::get_noise_report. Requires the server to hold the
+  ///     secret key, so is ignored if the client is enabled. Defaults to
+  ///     false.
+  ///     24) {"dry_run": "True"/"False"}, which indicates whether or not
+  ///     compile() only plans the function: it logs the estimated cost of
+  ///     each node, see HESealExecutable::estimate_cost, but neither
+  ///     encrypts constants nor generates Galois keys, and the executable
+  ///     cannot be called. Defaults to false.
+  ///     25) {"cost_calibration": "filename"}, which sets the primitive
+  ///     costs of cost estimates to those measured by he_benchmarks, see
+  ///     HECostCalibration::load. Defaults to built-in estimates.
+  ///     26) {"latency_slo_ms": "t"}, which makes compile() throw if the
+  ///     estimated latency of a call exceeds t milliseconds, or the
+  ///     encryption parameters do not support the function's depth.
+  ///     Defaults to 0, which disables the check.
+  ///     27) {"quantized_weight_step": "s"}, which multiplies ciphertexts by
+  ///     Constant Dot and Convolution weights which are all integer
+  ///     multiples of s as integers, see quantize_weight. The scale of the
+  ///     output is divided by s instead of rescaling, so such layers consume
+  ///     no coefficient modulus. Defaults to 0, which disables quantized
+  ///     weights.
+  ///     28) {"num_intra_op_threads": "n"}, which sets the number of OpenMP
+  ///     threads each call of an executable uses within ops, see
+  ///     HESealExecutable::set_num_intra_op_threads. Elementwise ops on few
+  ///     or cheap elements use fewer threads, see parallel_for_seal.
+  ///     Defaults to 0, which keeps the OpenMP default.
+  ///     29) {"numa_aware": "True"/"False"}, which indicates whether or not
+  ///     threads of parallel ops are bound to OpenMP places spread across
+  ///     the machine and statically partition each tensor, see
+  ///     set_numa_aware_parallelism. Client ciphertexts are loaded with the
+  ///     same partition, so their memory is first touched on the socket
+  ///     computing on them. Implies thread_local_pools. Use with
+  ///     OMP_PLACES=sockets or OMP_PLACES=cores. Defaults to false.
+  ///     30) {"model_parallel_stages": "host:port,host:port"}, which splits
+  ///     the nodes of compiled functions into contiguous stages of similar
+  ///     estimated latency. The first stage is executed locally and each
+  ///     further stage by a stage worker at the given address, i.e. a server
+  ///     compiling the same function with the same configuration and
+  ///     calling HESealExecutable::serve_stages. Parameters, Results and
+  ///     nodes computed with the client remain local, so the client only
+  ///     connects to this server. Requires enable_client. Defaults to no
+  ///     stage workers.
+  ///     31) {"data_parallel_workers": "host:port,host:port"}, which shards
+  ///     runs of elementwise nodes, e.g. Add or Multiply, by element index
+  ///     across the workers at the given addresses, which serve as the stage
+  ///     workers of 30). Each worker computes a contiguous range of the
+  ///     elements, which are gathered into the coordinator's tensors. Other
+  ///     nodes are executed locally. Exclusive with 30). Defaults to no
+  ///     workers.
+  ///     32) {"accelerator": "name"}, which selects the registered
+  ///     HESealAccelerator executing batched rescaling and relinearization,
+  ///     see register_accelerator. Defaults to "cpu", i.e. the SEAL
+  ///     evaluator.
+  ///     33) {"zero_pool_size": "n"}, which keeps n fresh encryptions of
+  ///     zero at each level the server encrypts at, filled by a background
+  ///     thread, so encrypting a value takes an encoding and an addition,
+  ///     see SealZeroPool. Defaults to 0, i.e. no pool.
+  ///     34) {"refresh_mask_bound": "B"}, which sets the bound on the
+  ///     absolute value of the uniformly random masks the server adds to
+  ///     values refreshed by the client, see pass::InsertRefresh. Larger
+  ///     bounds hide the values better at the cost of precision. 0 disables
+  ///     masking. Defaults to 1.
+  ///     35) {"trusted_ciphertexts": "True"/"False"}, which indicates whether
+  ///     or not ciphertexts exchanged between model-parallel servers, see
+  ///     30) and 31), are loaded without validating their data. Kernels
+  ///     validate the metadata of every ciphertext, and ciphertexts of the
+  ///     client are always validated when loaded. Defaults to false.
+  ///     36) {"sparse_encoding": "True"/"False"}, which indicates whether or
+  ///     not the server encodes batches of up to the square root of the
+  ///     slot count values into the subring of n slots, for n the next
+  ///     power of two, so the values are replicated every n slots, see
+  ///     SealSparseEncoder. Encodings of the client are unaffected.
+  ///     Defaults to false.
+  ///     37) {"executable_cache": "True"/"False"}, which indicates whether or
+  ///     not compile() reuses executables, along with their encoded
+  ///     weights, for functions of the same structure, Constant values and
+  ///     tensor configuration. Executables keep their session state, so
+  ///     reused executables must not be called concurrently. The cache is
+  ///     cleared by set_config and by new encryption parameters. Defaults
+  ///     to false.
+  ///     38) {"warmup": "True"/"False"}, which indicates whether or not
+  ///     compile() runs HESealExecutable::warmup on the compiled function,
+  ///     so the first call does not grow memory pools or encode weights at
+  ///     lower levels. Skipped if the client is enabled. Defaults to false.
+  ///     39) {"shm_transport": "True"/"False"}, which indicates whether or
+  ///     not clients connect through the shared-memory segment named by
+  ///     shm_transport_name(port) rather than over TCP, which avoids socket
+  ///     copies for a client on the same host. Clients attach to it if the
+  ///     NGRAPH_HE_CLIENT_TRANSPORT environment variable is "shm". Defaults
+  ///     to false.
+  ///     40) {"coalesce_client_ops": "True"/"False"}, which indicates whether
+  ///     or not client ReLUs of parallel branches which are ready together
+  ///     and send the same request, e.g. the ReLUs of an inception block,
+  ///     are streamed to the client as one ReLU, so they share round-trips.
+  ///     Garbled-circuit ReLUs are not coalesced. Defaults to true.
+  ///     41) {"client_epilogue": "True"/"False"}, which indicates whether or
+  ///     not the trailing Softmax, Exp, Negative, Relu and BoundedRelu ops
+  ///     feeding the result are computed by the client in plaintext after
+  ///     decryption, see split_epilogue. Requires enable_client. Defaults to
+  ///     false.
+  ///     42) {"packing_layout": "batch"/"auto"}, which sets how tensors are
+  ///     packed into ciphertexts. "batch" packs along the batch axis. "auto"
+  ///     additionally computes Convolutions and Dots of calls with batch size
+  ///     1 on their input packed into the slots of one ciphertext, with
+  ///     rotation-based layout conversions around them, where the cost
+  ///     estimate of the slot-packed layout is lower and the encryption
+  ///     parameters leave a spare coefficient modulus for the conversion,
+  ///     see HESealExecutable::select_packing_layouts. Requires the server
+  ///     to generate the Galois keys, so is ignored if the client is
+  ///     enabled. Defaults to "batch".
+  ///     43) {"weight_scale_bits": "b"}, which encodes plaintext
+  ///     multiplicands of a ciphertext at the value of the coefficient
+  ///     modulus its next rescale drops rather than at the ciphertext's
+  ///     scale, so rescaling restores the ciphertext's scale whatever the
+  ///     bit-width of the modulus. With auto_encryption_parameters, the
+  ///     moduli dropped only by rescales of products with Constant weights
+  ///     then have b bits plus the integer bits of the largest weight,
+  ///     rather than the bits of the scale, see
+  ///     HESealEncryptionParameters::select_for_prime_bits. Defaults to 0,
+  ///     which encodes multiplicands at the ciphertext's scale.
+  ///     44) {"metrics_port": "p"}, which serves the operational metrics of
+  ///     a serving executable, e.g. request latencies, per-phase times,
+  ///     client traffic, sessions, ReLU round-trips, memory pool bytes and
+  ///     queue depths, in the Prometheus text format at
+  ///     http://<host>:p/metrics, see HESealExecutable::metrics. Requires
+  ///     enable_client. Defaults to 0, which serves no metrics. The address
+  ///     the metrics are served on is set by 66).
+  ///     45) {"lazy_mod": "True"/"False"}, which defers modular reductions
+  ///     of ciphertext products to the end of Dot and Convolution sums.
+  ///     Defaults to the LAZY_MOD environment variable.
+  ///     46) {"tuning_profile": "path"}, which applies the settings of the
+  ///     HETuningProfile at path. Settings given explicitly in the same
+  ///     config take precedence over the profile's.
+  ///     47) {"autotune": "True"/"False"}, which applies the settings of the
+  ///     tuning_profile if it was tuned on this host with the encryption
+  ///     parameters, and otherwise times calibrations with autotune() and
+  ///     applies their settings, writing them to the tuning_profile if
+  ///     given. Defaults to false.
+  ///     48) {"mpc_protocol": "yao"/"gmw"/"auto"}, which selects the sharing
+  ///     of the garbled circuits: Yao's garbled circuits, or Boolean GMW,
+  ///     which trades more rounds for less online traffic. With "auto", the
+  ///     round-trip time and bandwidth to the first client are measured
+  ///     after its keys are received, and the cheaper protocol under
+  ///     aby::choose_mpc_protocol is negotiated. Defaults to "yao".
+  ///     49) {"conv_tile_rows": "r"}, which computes chains of Convolutions,
+  ///     each read only by the next, in tiles of r rows of the last
+  ///     Convolution's output. Each tile computes the rows of the earlier
+  ///     Convolutions it needs, and rows no later tile needs are released,
+  ///     so peak memory scales with the tile rather than with the full
+  ///     intermediate tensors. Only applies with a single inter-op thread.
+  ///     Defaults to 0, which computes each Convolution in full.
+  ///     50) {"spill_directory": "path"}, which writes the ciphertexts of
+  ///     intermediate tensors read again latest to files in the directory,
+  ///     e.g. on a local NVMe drive, while the live ciphertext bytes exceed
+  ///     spill_threshold_mb. Spilled tensors are read back before the node
+  ///     consuming them runs, and prefetched while the node before it runs.
+  ///     Only applies with a single inter-op thread. Defaults to "", which
+  ///     keeps all tensors in memory.
+  ///     51) {"spill_threshold_mb": "n"}, the live ciphertext megabytes
+  ///     above which tensors are spilled. Defaults to 1024.
+  ///     52) {"winograd_convolutions": "true"}, which computes encrypted 3x3
+  ///     Convolutions with unit strides and Constant filters by the Winograd
+  ///     transform F(2x2, 3x3), using 16 rather than 36 products per 2x2
+  ///     output tile and channel pair, at the cost of a few bits of noise.
+  ///     Does not apply with lazy modular reduction. Defaults to false.
+  ///     53) {"lazy_scalar_factors": "true"}, which records Negative, Divide
+  ///     by plaintext scalars, the AvgPool division and the BatchNormInference
+  ///     scale as a pending factor of each ciphertext rather than computing
+  ///     them. Pending factors are folded into the plaintext of a following
+  ///     Multiply, or into the decryption of the results, and are only
+  ///     multiplied into the ciphertexts before other ops and before results
+  ///     are sent to the client, which would learn the factors otherwise.
+  ///     Defaults to false.
+  ///     54) {"input_cache_mb": "n"}, the megabytes of encrypted client inputs
+  ///     kept for later inference requests of clients with the same keys,
+  ///     which then refer to an input by its handle instead of uploading it
+  ///     again. The least recently used inputs are evicted first. Defaults
+  ///     to 0, which caches no inputs.
+  ///     55) {"thread_budget": "n"} or {"thread_budget": "n,gc:g,io:i"}, the
+  ///     number of threads shared by the process's ops, garbled circuit
+  ///     parties and network I/O. At most g garbled circuit party threads
+  ///     run at once, defaulting to n / 2, and i threads run the network
+  ///     I/O, defaulting to 1. Ops use the remaining threads, so they run
+  ///     on fewer threads while garbled circuits overlap with them. Applies
+  ///     to the whole process. Defaults to 0, which bounds no subsystem.
+  ///     56) {tensor_name : "range:lower:upper"}, which declares that the
+  ///     values of the specified tensor lie within [lower, upper], e.g.
+  ///     "range:0:1" for pixels. The bounds propagate through ops with
+  ///     Constant weights, and Relus and BoundedRelus whose result they
+  ///     determine are elided, each saving a client round-trip. May be
+  ///     combined with entries of form 1), e.g. "client_input,range:0:1".
+  ///     57) {"relu_compaction": "True"/"False"}, which indicates whether
+  ///     or not the server packs the batch slots of several ReLU input
+  ///     ciphertexts into each ciphertext sent to the client, when the
+  ///     batch size is at most half the slot count. The client answers with
+  ///     packed results, which the server unpacks. Clients upload Galois
+  ///     keys of the rotations by the batch size times each power of two,
+  ///     and packing consumes one level. Ignored with garbled circuits or
+  ///     complex packing. Defaults to False.
+  ///     58) {"huge_pages": "True"/"False"}, which indicates whether or not
+  ///     the server advises the kernel to back the ciphertext data of op
+  ///     outputs by transparent huge pages, which reduces TLB misses of
+  ///     kernels accessing many ciphertexts. Falls back to regular pages if
+  ///     transparent huge pages are disabled. Defaults to False.
+  ///     59) {"memory_node_order": "True"/"False"}, which indicates whether
+  ///     or not nodes execute in a topological order greedily minimizing
+  ///     the estimated peak live ciphertext bytes, rather than the order of
+  ///     Function::get_ordered_ops. With several inter-op threads, ready
+  ///     nodes are then started in this order, rather than client nodes
+  ///     first, trading parallelism for memory. Defaults to False.
+  ///     60) {node_name : "kernel_<name>"}, which selects the kernel
+  ///     computing the specified node, e.g. "kernel_winograd" for a
+  ///     Convolution, rather than the applicable kernel of lowest
+  ///     estimated cost. The Convolution kernels are "slot_packed",
+  ///     "winograd", "pointwise" and "direct". The Dot kernels are
+  ///     "slot_packed" and "direct".
+  ///     61) {"avg_pool_max_pools": "True"/"False"}, which indicates whether
+  ///     or not compiling a function replaces each MaxPool by an AvgPool of
+  ///     the same windows, which the server computes without a client
+  ///     round-trip. Only suits models trained or fine-tuned with average
+  ///     pooling. Defaults to False.
+  ///     62) {node_name : "avg_pool"} or {node_name : "max_pool"}, which
+  ///     indicates whether or not the specified MaxPool node is replaced by
+  ///     an AvgPool, overriding avg_pool_max_pools.
+  ///     63) {"result_compaction": "True"/"False"}, which indicates whether
+  ///     or not the server packs the batch slots of several result
+  ///     ciphertexts into each ciphertext sent to the client, as with
+  ///     relu_compaction, e.g. for the few values of final logits. The
+  ///     client splits the slots of the decrypted ciphertexts. Results at
+  ///     the lowest decryptable level are sent unpacked. Ignored with
+  ///     complex packing. Defaults to False.
+  ///     64) {"enable_plaintext_cache": "True"/"False"}, which indicates
+  ///     whether or not executables keep the encoded diagonals of the
+  ///     slot-packed Dot weights, see 42), across calls. The diagonals are
+  ///     encoded at the level and scale of the first call's input, and again
+  ///     only if these change. Defaults to True.
+  ///     65) {"plaintext_cache_mb": "n"}, the megabytes of encoded weights
+  ///     kept by the plaintext cache of 64). Over the budget, the weights of
+  ///     a Dot are evicted once it is computed, and encoded again on a
+  ///     background thread while the preceding slot-packed Dot computes, so
+  ///     the budget may be exceeded by one Dot. Defaults to 0, which keeps
+  ///     every encoding.
+  ///     66) {"metrics_address": "address"}, the IP address on which the
+  ///     metrics of 44) are served, e.g. "0.0.0.0" for every interface.
+  ///     Defaults to "127.0.0.1", so only local scrapers are served.
   ///
   ///     Note, entries with the same tensor key should be comma-separated,
   ///     for instance: {tensor_name : "client_input,encrypt,packed"}
@@ -152,22 +505,26 @@ class HESealBackend : public runtime::Backend {
   /// \param[in] shape Shape of the tensor
   /// \param[in] plaintext_packing Whether or not to use plaintext packing
   /// \param[in] name Name of the created tensor
+  /// \param[in] initialize Whether or not the values are initialized to
+  /// zero, rather than left empty for a kernel to overwrite. See HETensor
   /// \returns Pointer to created tensor
   std::shared_ptr<runtime::Tensor> create_plain_tensor(
       const element::Type& type, const Shape& shape,
       const bool plaintext_packing = false,
-      const std::string& name = "external") const;
+      const std::string& name = "external", bool initialize = true) const;
 
   /// \brief Creates a ciphertext tensor
   /// \param[in] type Datatype stored in the tensor
   /// \param[in] shape Shape of the tensor
   /// \param[in] plaintext_packing Whether or not to use plaintext packing
   /// \param[in] name Name of the created tensor
+  /// \param[in] initialize Whether or not the values are initialized, see
+  /// create_plain_tensor
   /// \returns Pointer to created tensor
   std::shared_ptr<runtime::Tensor> create_cipher_tensor(
       const element::Type& type, const Shape& shape,
       const bool plaintext_packing = false,
-      const std::string& name = "external") const;
+      const std::string& name = "external", bool initialize = true) const;
 
   /// \brief Creates empty ciphertext
   /// \returns Pointer to created ciphertext
@@ -175,6 +532,14 @@ class HESealBackend : public runtime::Backend {
     return std::make_shared<SealCiphertextWrapper>();
   }
 
+  /// \brief Creates empty ciphertext whose data is allocated from a pool
+  /// \param[in] pool Memory pool storing the ciphertext data
+  /// \returns Pointer to created ciphertext
+  static std::shared_ptr<SealCiphertextWrapper> create_empty_ciphertext(
+      const seal::MemoryPoolHandle& pool) {
+    return std::make_shared<SealCiphertextWrapper>(pool);
+  }
+
   /// \brief TODO(fboemer)
   void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
                const HEPlaintext& input, const element::Type& type,
@@ -190,25 +555,48 @@ class HESealBackend : public runtime::Backend {
     return m_context;
   }
 
-  /// \brief Returns pointer to relinearization keys
-  ///Why all pionters?
+  /// \brief Returns pointer to the public key, i.e. the client's public key
+  /// once a client has sent it. Generates the server's keys if neither is
+  /// set, see generate_keys
+  const std::shared_ptr<seal::PublicKey> get_public_key() const {
+    generate_keys();
+    return m_public_key;
+  }
+
+  /// \brief Returns pointer to relinearization keys. Generates the server's
+  /// keys if neither the server's nor the client's are set
   const std::shared_ptr<seal::RelinKeys> get_relin_keys() const {
+    generate_keys();
     return m_relin_keys;
   }
 
-  /// \brief Returns pointer to Galois keys
-  const std::shared_ptr<seal::GaloisKeys> get_galois_keys() {
-    // TODO(fboemer): make thread-safe
-    if (m_galois_keys == nullptr) {
-      seal::GaloisKeys m_galois_keys_temp;
-      m_keygen->create_galois_keys(m_galois_keys_temp);
-      m_galois_keys = std::make_shared<seal::GaloisKeys>(m_galois_keys_temp);
-    }
-    return m_galois_keys;
-  }
+  /// \brief Starts generating Galois keys for the given rotation steps on a
+  /// background thread, in addition to the steps already generated
+  /// \param[in] steps Rotation steps. Step 0 denotes complex conjugation
+  void prepare_galois_keys(const std::set<int>& steps);
+
+  /// \brief Returns Galois keys including the given rotation steps. Waits
+  /// for keys started by prepare_galois_keys, and generates keys for missing
+  /// steps. Thread-safe
+  /// \param[in] steps Rotation steps. Step 0 denotes complex conjugation
+  std::shared_ptr<seal::GaloisKeys> get_galois_keys(
+      const std::set<int>& steps);
+
+  /// \brief Rotates a ciphertext by each of the given steps with a
+  /// HoistedRotator, which decomposes the ciphertext once for all rotations.
+  /// Generates missing Galois keys as get_galois_keys
+  /// \param[in] encrypted Ciphertext to rotate. Relinearized first if it has
+  /// size 3
+  /// \param[in] steps Rotation steps. Step 0 copies the ciphertext
+  /// \param[out] destinations Stores the rotation by each step
+  void rotate_hoisted(const seal::Ciphertext& encrypted,
+                      const std::vector<int>& steps,
+                      std::vector<seal::Ciphertext>& destinations);
 
-  /// \brief Returns pointer to encryptor
+  /// \brief Returns pointer to encryptor. Generates the server's keys if no
+  /// public key is set
   const std::shared_ptr<seal::Encryptor> get_encryptor() const {
+    generate_keys();
     return m_encryptor;
   }
 
@@ -234,10 +622,25 @@ class HESealBackend : public runtime::Backend {
       const HESealEncryptionParameters& new_parms);
 
   /// \brief Returns the CKKS encoder
+  /// \throws ngraph_error if the encryption parameters use BFV
   const std::shared_ptr<seal::CKKSEncoder> get_ckks_encoder() const {
+    NGRAPH_CHECK(m_ckks_encoder != nullptr,
+                 "No CKKS encoder for BFV encryption parameters");
     return m_ckks_encoder;
   }
 
+  /// \brief Returns the BFV batch encoder, or nullptr if the encryption
+  /// parameters use CKKS
+  const std::shared_ptr<seal::BatchEncoder> get_batch_encoder() const {
+    return m_batch_encoder;
+  }
+
+  /// \brief Returns whether or not the encryption parameters use the integer
+  /// BFV scheme. Tensors and compiled functions require CKKS; BFV
+  /// ciphertexts are encrypted and decrypted through encrypt and decrypt, and
+  /// computed on by the kernels of seal/kernel/integer_seal.hpp
+  bool integer_scheme() const { return m_encryption_params.integer_scheme(); }
+
   /// \brief Sets the relinearization keys. Note, they may not be compatible
   /// with the other SEAL keys
   /// \param[in] keys relinearization keys
@@ -251,11 +654,27 @@ class HESealBackend : public runtime::Backend {
   void set_public_key(const seal::PublicKey& key) {
     m_public_key = std::make_shared<seal::PublicKey>(key);
     m_encryptor = std::make_shared<seal::Encryptor>(*m_context, *m_public_key);
+    reset_zero_pool();
   }
 
+  /// \brief Stores the current public and relinearization keys, so a client
+  /// reconnecting with the same keys need not upload them again. The oldest
+  /// entry is evicted once s_max_cached_client_keys entries are stored
+  /// \param[in] key_id Fingerprint of the serialized public key
+  void cache_client_keys(const std::string& key_id);
+
+  /// \brief Sets the public and relinearization keys to keys stored by
+  /// cache_client_keys
+  /// \param[in] key_id Fingerprint of the serialized public key
+  /// \returns True if the keys were found, false otherwise
+  bool load_cached_client_keys(const std::string& key_id);
+
   /// \brief Returns the top-level scale used for encoding
   double get_scale() const { return m_encryption_params.scale(); }
 
+  /// \brief Returns the number of primes dropped by each rescale
+  size_t rescale_primes() const { return m_encryption_params.rescale_primes(); }
+
   /// \brief Returns whether or not complex packing is used
   bool complex_packing() const { return m_encryption_params.complex_packing(); }
 
@@ -271,6 +690,308 @@ class HESealBackend : public runtime::Backend {
     return m_num_garbled_circuit_threads;
   }
 
+  /// \brief Returns the configured sharing of the garbled circuits, "yao",
+  /// "gmw" or "auto", see set_config
+  const std::string& mpc_protocol() const { return m_mpc_protocol; }
+
+  /// \brief Returns the number of threads used by each garbled circuit party
+  size_t num_garbled_circuit_party_threads() const {
+    return m_num_garbled_circuit_party_threads;
+  }
+
+  /// \brief Returns the number of operations executed concurrently
+  size_t num_inter_op_threads() const { return m_num_inter_op_threads; }
+
+  /// \brief Returns the number of OpenMP threads used within ops by default,
+  /// or 0 for the OpenMP default
+  size_t num_intra_op_threads() const { return m_num_intra_op_threads; }
+
+  /// \brief Returns the number of threads running the server's network I/O
+  size_t num_io_threads() const { return m_num_io_threads; }
+
+  /// \brief Returns the target serialized size in bytes of a single ReLU
+  /// request message
+  size_t relu_chunk_bytes() const { return m_relu_chunk_bytes; }
+
+  /// \brief Returns the number of output rows per tile of Convolution
+  /// chains, or 0 if chains are not tiled, see set_config
+  size_t conv_tile_rows() const { return m_conv_tile_rows; }
+
+  /// \brief Returns the maximum number of ReLU request messages awaiting a
+  /// client response. 0 indicates the window is tuned from the measured
+  /// round-trip time
+  size_t relu_window() const { return m_relu_window; }
+
+  /// \brief Memory usage of the pools returned by pool()
+  struct PoolStatistics {
+    /// \brief Number of thread-local pools created
+    size_t thread_local_pools{0};
+    /// \brief Bytes allocated by the thread-local pools
+    size_t thread_local_bytes{0};
+    /// \brief Bytes allocated by the global SEAL memory pool
+    size_t global_bytes{0};
+  };
+
+  /// \brief Returns the memory pool kernels use for temporary allocations.
+  /// If thread-local pools are enabled, each calling thread gets its own
+  /// pool, which avoids contention on the global pool's lock. Pools are
+  /// kept alive by the backend, so memory allocated by a thread remains
+  /// valid after the thread exits
+  seal::MemoryPoolHandle pool() const;
+
+  /// \brief Returns the memory usage of the global and thread-local pools
+  PoolStatistics pool_statistics() const;
+
+  /// \brief Returns whether or not kernels use thread-local memory pools
+  bool thread_local_pools() const { return m_thread_local_pools; }
+
+  /// \brief Returns whether or not parallel ops are NUMA-aware, see
+  /// set_config
+  bool numa_aware() const { return m_numa_aware; }
+
+  /// \brief Returns the (hostname, port) of each model-parallel stage
+  /// worker, see set_config
+  const std::vector<std::pair<std::string, size_t>>& model_parallel_stages()
+      const {
+    return m_model_parallel_stages;
+  }
+
+  /// \brief Returns the (hostname, port) of each data-parallel worker, see
+  /// set_config
+  const std::vector<std::pair<std::string, size_t>>& data_parallel_workers()
+      const {
+    return m_data_parallel_workers;
+  }
+
+  /// \brief Returns the number of encryptions of zero pooled at each level,
+  /// see set_config
+  size_t zero_pool_size() const { return m_zero_pool_size; }
+
+  /// \brief Returns whether or not ciphertexts produced by the server's
+  /// own workers are loaded without validation, see set_config
+  bool trusted_ciphertexts() const { return m_trusted_ciphertexts; }
+
+  /// \brief Returns whether or not the server encodes small batches into
+  /// a subring, see set_config
+  bool sparse_encoding() const { return m_sparse_encoding; }
+
+  /// \brief Returns whether or not compile() warms up executables, see
+  /// set_config
+  bool warmup_on_compile() const { return m_warmup_on_compile; }
+
+  /// \brief Returns whether or not clients connect over shared memory, see
+  /// set_config
+  bool shm_transport() const { return m_shm_transport; }
+
+  /// \brief Returns whether or not ready client ReLUs share request
+  /// streams, see set_config
+  bool coalesce_client_ops() const { return m_coalesce_client_ops; }
+
+  /// \brief Returns whether or not the client computes the epilogue of
+  /// functions, see set_config
+  bool client_epilogue() const { return m_client_epilogue; }
+
+  /// \brief Returns whether or not executables choose the packing layout of
+  /// Convolutions and Dots per call, see set_config
+  bool auto_packing_layout() const { return m_auto_packing_layout; }
+
+  /// \brief Returns the number of executables cached by compile(), see
+  /// set_config
+  size_t num_cached_executables() const {
+    std::lock_guard<std::mutex> guard(m_executable_cache_mutex);
+    return m_executable_cache.size();
+  }
+
+  /// \brief Returns the bound on the masks of values refreshed by the
+  /// client, see set_config
+  double refresh_mask_bound() const { return m_refresh_mask_bound; }
+
+  /// \brief Returns the accelerator executing batched primitives, see
+  /// set_config
+  HESealAccelerator& accelerator() const { return *m_accelerator; }
+
+  /// \brief Returns whether or not compiling a function selects encryption
+  /// parameters from the function's multiplicative depth
+  bool auto_encryption_parameters() const {
+    return m_auto_encryption_parameters;
+  }
+
+  /// \brief Returns the polynomial approximation with which the server
+  /// computes an activation node, i.e. the node's configured approximation,
+  /// or the default approximation if the node has none
+  /// \param[in] node Relu, BoundedRelu, MaxPool or ConvolutionBiasRelu node
+  PolynomialActivation polynomial_activation(const Node& node) const;
+
+  /// \brief Returns the name of the kernel configured to compute a node, or
+  /// an empty string if the node has none, see HEKernelRegistry
+  /// \param[in] node Node computed by the kernel
+  std::string node_kernel(const Node& node) const;
+
+  /// \brief Returns whether or not a MaxPool node is replaced by an AvgPool,
+  /// i.e. the node's configured replacement, or avg_pool_max_pools if the
+  /// node has none
+  /// \param[in] node MaxPool node
+  bool avg_pool_max_pool(const Node& node) const;
+
+  /// \brief Returns the declared range of a parameter's values, if any, see
+  /// set_config
+  /// \param[in] param Parameter of a compiled function
+  std::optional<std::pair<double, double>> input_range(
+      const op::Parameter& param) const;
+
+  /// \brief Returns the bound on the absolute value of activation inputs
+  /// within which the polynomial approximations are accurate
+  double polynomial_activation_bound() const {
+    return m_polynomial_activation_bound;
+  }
+
+  /// \brief Returns the degree of the Chebyshev approximations of Exp,
+  /// Divide and Softmax on ciphertexts, or 0 if these are computed by
+  /// decryption
+  size_t polynomial_degree() const { return m_polynomial_degree; }
+
+  /// \brief Returns the range of ciphertext divisors on which reciprocals
+  /// are approximated
+  const std::pair<double, double>& polynomial_divisor_range() const {
+    return m_polynomial_divisor_range;
+  }
+
+  /// \brief Returns whether or not ciphertext-ciphertext products are
+  /// relinearized only once an operation requires ciphertexts of size 2
+  bool lazy_relinearization() const { return m_lazy_relinearization; }
+
+  /// \brief Returns whether or not compiled functions encrypt their Constant
+  /// weights
+  bool encrypt_constants() const { return m_encrypt_constants; }
+
+  /// \brief Returns whether or not the server computes on partially received
+  /// client inputs
+  bool stream_client_inputs() const { return m_stream_client_inputs; }
+
+  /// \brief Returns whether or not garbled circuit Relus rescale their
+  /// arguments inside the circuit
+  bool gc_relu_rescale() const { return m_gc_relu_rescale; }
+
+  /// \brief Returns whether or not Dot layers followed by a garbled circuit
+  /// Relu may be computed in ABY arithmetic sharing
+  bool hybrid_linear_layers() const { return m_hybrid_linear_layers; }
+
+  /// \brief Returns whether or not op outputs are sampled for noise
+  /// telemetry
+  bool noise_telemetry() const { return m_noise_telemetry; }
+
+  /// \brief Returns whether or not compile() only plans functions
+  bool dry_run() const { return m_dry_run; }
+
+  /// \brief Returns the costs with which function latencies are estimated
+  const HECostCalibration& cost_calibration() const {
+    return m_cost_calibration;
+  }
+
+  /// \brief Returns the latency a call must be estimated to meet for the
+  /// function to compile, in milliseconds, or 0 if unchecked
+  double latency_slo_ms() const { return m_latency_slo_ms; }
+
+  /// \brief Returns the directory intermediate ciphertexts are spilled to,
+  /// or an empty string if tensors are not spilled, see set_config
+  const std::string& spill_directory() const { return m_spill_directory; }
+
+  /// \brief Returns the live ciphertext bytes above which intermediate
+  /// tensors are spilled
+  size_t spill_threshold_bytes() const { return m_spill_threshold_mb << 20U; }
+
+  /// \brief Returns whether or not 3x3 Convolutions are computed by the
+  /// Winograd transform, see set_config
+  bool winograd_convolutions() const { return m_winograd_convolutions; }
+
+  /// \brief Returns whether or not scalar factors of ciphertexts are
+  /// deferred, see set_config and HEType::pending_factor
+  bool lazy_scalar_factors() const { return m_lazy_scalar_factors; }
+
+  /// \brief Returns the maximum bytes of cached client inputs, or 0 if client
+  /// inputs are not cached
+  size_t input_cache_bytes() const { return m_input_cache_mb << 20U; }
+
+  /// \brief Returns whether or not ReLU requests pack the slots of several
+  /// ciphertexts into each ciphertext, see set_config
+  bool relu_compaction() const { return m_relu_compaction; }
+
+  /// \brief Returns whether or not results sent to the client pack the slots
+  /// of several ciphertexts into each ciphertext, see set_config
+  bool result_compaction() const { return m_result_compaction; }
+
+  /// \brief Returns whether or not executables keep the encoded weights of
+  /// slot-packed Dot ops across calls, see set_config
+  bool plaintext_cache() const { return m_plaintext_cache; }
+
+  /// \brief Returns the maximum bytes of encoded weights kept by the
+  /// plaintext cache, or 0 if the cache is unbounded, see set_config
+  size_t plaintext_cache_bytes() const { return m_plaintext_cache_mb << 20U; }
+
+  /// \brief Returns whether or not op outputs are advised to use transparent
+  /// huge pages, see set_config
+  bool huge_pages() const { return m_huge_pages; }
+
+  /// \brief Returns whether or not nodes execute in an order minimizing the
+  /// peak live ciphertext bytes, see set_config
+  bool memory_node_order() const { return m_memory_node_order; }
+
+  /// \brief Stores a client input for later inference requests of clients
+  /// with the same keys. The least recently used inputs are evicted once the
+  /// cached inputs exceed input_cache_bytes()
+  /// \param[in] key_scope Fingerprint of the client's public key
+  /// \param[in] handle Handle of the input chosen by the client
+  /// \param[in] tensor Input to store
+  void cache_client_input(const std::string& key_scope,
+                          const std::string& handle,
+                          std::shared_ptr<HETensor> tensor);
+
+  /// \brief Returns an input stored by cache_client_input, or nullptr if it
+  /// is not cached
+  /// \param[in] key_scope Fingerprint of the client's public key
+  /// \param[in] handle Handle of the input chosen by the client
+  std::shared_ptr<HETensor> cached_client_input(const std::string& key_scope,
+                                                const std::string& handle);
+
+  /// \brief Returns the step of quantized Constant weights, or 0 if
+  /// weights are not quantized
+  double quantized_weight_step() const { return m_quantized_weight_step; }
+
+  /// \brief Returns the bits of precision of Constant weights of layers
+  /// whose coefficient modulus is chosen per layer, or 0 if multiplicands
+  /// are encoded at the scale of the ciphertexts, see set_config
+  int weight_scale_bits() const { return m_weight_scale_bits; }
+
+  /// \brief Returns the port serving the metrics of serving executables, or
+  /// 0 if metrics are not served
+  size_t metrics_port() const { return m_metrics_port; }
+
+  /// \brief Returns the IP address serving the metrics of serving
+  /// executables, see set_config
+  const std::string& metrics_address() const { return m_metrics_address; }
+
+  /// \brief Returns the path of the tuning profile, or an empty string if
+  /// none was configured, see set_config
+  const std::string& tuning_profile() const { return m_tuning_profile; }
+
+  /// \brief Returns the scale at which plaintext multiplicands of a
+  /// ciphertext are encoded. With weight scale bits, this is the coefficient
+  /// modulus the next rescale of the ciphertext drops, so the rescaled
+  /// product has the scale of the ciphertext. Otherwise, and at the last
+  /// level, this is the scale of the ciphertext
+  /// \param[in] parms_id Parameter id of the ciphertext
+  /// \param[in] scale Scale of the ciphertext
+  double multiplicand_scale(const seal::parms_id_type& parms_id,
+                            double scale) const;
+
+  /// \brief Returns the maximum number of client connections held open at
+  /// once, including the client being served. Only one client is served at
+  /// a time, see set_config
+  size_t max_clients() const { return m_max_clients; }
+
+  /// \brief Returns the ciphertext compression mode proposed to the client
+  seal::compr_mode_type compr_mode() const { return m_compr_mode; }
+
   /// \brief Returns the port number used for the server
   size_t port() const {
     return m_port;
@@ -328,29 +1049,159 @@ class HESealBackend : public runtime::Backend {
     }
   }
 
+  /// \brief Returns the parameter id of the lowest level at which a
+  /// ciphertext of the given scale decrypts correctly, i.e. whose coefficient
+  /// modulus exceeds the scale by at least s_decryption_headroom_bits
+  /// \param[in] scale Scale of the ciphertext
+  seal::parms_id_type lowest_decryptable_parms_id(double scale) const;
+
+  /// \brief Returns whether or not ciphertexts sent to the client are
+  /// modulus switched to the lowest level at which they decrypt correctly
+  bool client_mod_switch() const { return m_client_mod_switch; }
+
   bool& lazy_mod() { return m_lazy_mod; }
 
+
  private:
+  /// \brief Replaces the pool of encryptions of zero with one for the
+  /// current encryptor, if zero_pool_size is set
+  void reset_zero_pool() const;
+
+  /// \brief Generates the server's public and relinearization keys on
+  /// first use, unless a client has set them. Clients set their keys before
+  /// the server encrypts, so servers with enable_client never generate them.
+  /// The secret key is generated with the context, since key generation
+  /// derives from it and the decryptor is needed to load tensors.
+  /// Thread-safe
+  void generate_keys() const;
+
+  /// \brief Replaces the sparse encoder with one for the current CKKS
+  /// encoder, if sparse_encoding is set
+  void reset_sparse_encoder();
+
   bool m_enable_client{false};
   bool m_enable_garbled_circuit{false};
   bool m_mask_gc_inputs{false};
   bool m_mask_gc_outputs{false};
+  bool m_client_mod_switch{false};
+  // Bits of the coefficient modulus above the scale, which bound the
+  // magnitude of values decrypted after modulus switching
+  static constexpr int s_decryption_headroom_bits = 20;
   size_t m_num_garbled_circuit_threads{1};
+  size_t m_num_garbled_circuit_party_threads{2};
+  std::string m_mpc_protocol{"yao"};
+  size_t m_num_inter_op_threads{1};
+  size_t m_num_intra_op_threads{0};
+  size_t m_num_io_threads{1};
+  size_t m_relu_chunk_bytes{1UL << 22U};
+  size_t m_conv_tile_rows{0};
+  size_t m_relu_window{0};
+  size_t m_max_clients{1};
+  bool m_thread_local_pools{false};
+  bool m_numa_aware{false};
+  std::vector<std::pair<std::string, size_t>> m_model_parallel_stages;
+  std::vector<std::pair<std::string, size_t>> m_data_parallel_workers;
+  std::shared_ptr<HESealAccelerator> m_accelerator{
+      create_accelerator("cpu")};
+  bool m_auto_encryption_parameters{false};
+  PolynomialActivation m_polynomial_activation{PolynomialActivation::none};
+  double m_polynomial_activation_bound{1.0};
+  double m_refresh_mask_bound{1.0};
+  bool m_trusted_ciphertexts{false};
+  std::unordered_map<std::string, PolynomialActivation>
+      m_node_polynomial_activations;
+  std::unordered_map<std::string, std::string> m_node_kernels;
+  bool m_avg_pool_max_pools{false};
+  std::unordered_map<std::string, bool> m_node_avg_pools;
+  std::unordered_map<std::string, std::pair<double, double>> m_input_ranges;
+  size_t m_polynomial_degree{0};
+  std::pair<double, double> m_polynomial_divisor_range{1.0, 16.0};
+  bool m_lazy_relinearization{false};
+  bool m_encrypt_constants{false};
+  bool m_stream_client_inputs{false};
+  bool m_gc_relu_rescale{false};
+  bool m_hybrid_linear_layers{false};
+  bool m_noise_telemetry{false};
+  bool m_dry_run{false};
+  HECostCalibration m_cost_calibration;
+  double m_latency_slo_ms{0};
+  std::string m_spill_directory;
+  size_t m_spill_threshold_mb{1024};
+  bool m_winograd_convolutions{false};
+  bool m_lazy_scalar_factors{false};
+  size_t m_input_cache_mb{0};
+  bool m_relu_compaction{false};
+  bool m_result_compaction{false};
+  bool m_plaintext_cache{true};
+  size_t m_plaintext_cache_mb{0};
+  bool m_huge_pages{false};
+  bool m_memory_node_order{false};
+  double m_quantized_weight_step{0};
+  int m_weight_scale_bits{0};
+  size_t m_metrics_port{0};
+  std::string m_metrics_address{"127.0.0.1"};
+  std::string m_tuning_profile;
+  // Identifies the backend owning a thread's cached pool in pool()
+  inline static std::atomic<size_t> s_next_instance_id{0};
+  size_t m_instance_id{s_next_instance_id++};
+  mutable std::mutex m_thread_pools_mutex;
+  mutable std::vector<seal::MemoryPoolHandle> m_thread_pools;
+  seal::compr_mode_type m_compr_mode{seal::compr_mode_type::none};
   size_t m_port{34000};
 
   bool m_lazy_mod{string_to_bool(std::getenv("LAZY_MOD"), false)};
 
+  /// \brief Client keys stored by cache_client_keys
+  struct ClientKeys {
+    std::shared_ptr<seal::PublicKey> public_key;
+    std::shared_ptr<seal::RelinKeys> relin_keys;
+    std::shared_ptr<seal::Encryptor> encryptor;
+  };
+  static constexpr size_t s_max_cached_client_keys = 64;
+  std::mutex m_client_keys_mutex;
+  std::unordered_map<std::string, ClientKeys> m_client_keys;
+  // Key ids in order of insertion, for eviction
+  std::deque<std::string> m_client_key_ids;
+
+  /// \brief Client input stored by cache_client_input
+  struct CachedClientInput {
+    std::string key;
+    std::shared_ptr<HETensor> tensor;
+    size_t bytes{0};
+  };
+  std::mutex m_input_cache_mutex;
+  // Least recently used inputs first
+  std::list<CachedClientInput> m_input_cache;
+  std::unordered_map<std::string, std::list<CachedClientInput>::iterator>
+      m_input_cache_index;
+  size_t m_input_cache_used_bytes{0};
+
   std::shared_ptr<seal::SecretKey> m_secret_key;
-  std::shared_ptr<seal::PublicKey> m_public_key;
-  std::shared_ptr<seal::RelinKeys> m_relin_keys;
-  std::shared_ptr<seal::Encryptor> m_encryptor;
+  // Set by the client or generated by generate_keys
+  mutable std::shared_ptr<seal::PublicKey> m_public_key;
+  mutable std::shared_ptr<seal::RelinKeys> m_relin_keys;
+  mutable std::shared_ptr<seal::Encryptor> m_encryptor;
+  // Reset with the context, so new keys are generated on first use
+  std::unique_ptr<std::once_flag> m_keys_generated;
+  // Encryptions of zero under m_encryptor, or nullptr
+  mutable std::unique_ptr<SealZeroPool> m_zero_pool;
+  size_t m_zero_pool_size{0};
   std::shared_ptr<seal::Decryptor> m_decryptor;
   std::shared_ptr<seal::SEALContext> m_context;
   std::shared_ptr<seal::Evaluator> m_evaluator;
+  // Sparse encoder of m_ckks_encoder, or nullptr
+  std::unique_ptr<SealSparseEncoder> m_sparse_encoder;
+  bool m_sparse_encoding{false};
   std::shared_ptr<seal::KeyGenerator> m_keygen;
+  std::mutex m_galois_keys_mutex;
   std::shared_ptr<seal::GaloisKeys> m_galois_keys;
+  // Steps of m_galois_keys, or of m_pending_galois_keys if valid
+  std::set<int> m_galois_steps;
+  std::shared_future<std::shared_ptr<seal::GaloisKeys>> m_pending_galois_keys;
   HESealEncryptionParameters m_encryption_params;
+  // Exactly one of m_ckks_encoder and m_batch_encoder is set, by the scheme
   std::shared_ptr<seal::CKKSEncoder> m_ckks_encoder;
+  std::shared_ptr<seal::BatchEncoder> m_batch_encoder;
 
   std::unordered_set<size_t> m_supported_types{
       element::f32.hash(), element::i32.hash(), element::i64.hash(),
@@ -358,6 +1209,21 @@ class HESealBackend : public runtime::Backend {
 
   std::unordered_map<std::string, HEOpAnnotations> m_config_tensors;
 
+  struct CachedExecutable {
+    // Compiled function, which the passes have rewritten
+    std::weak_ptr<Function> function;
+    std::shared_ptr<runtime::Executable> executable;
+  };
+  bool m_executable_cache_enabled{false};
+  bool m_warmup_on_compile{false};
+  bool m_shm_transport{false};
+  bool m_coalesce_client_ops{true};
+  bool m_client_epilogue{false};
+  bool m_auto_packing_layout{false};
+  mutable std::mutex m_executable_cache_mutex;
+  // By fingerprint of the function, see compile
+  std::unordered_map<std::string, CachedExecutable> m_executable_cache;
+
   std::unordered_set<std::string> m_unsupported_op_name_list{
       "Abs",
       "Acos",
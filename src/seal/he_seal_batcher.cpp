@@ -0,0 +1,370 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_batcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "he_op_annotations.hpp"
+#include "he_util.hpp"
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_executable.hpp"
+
+namespace ngraph::runtime::he {
+
+void HEAdmissionController::acquire(size_t bytes) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cond.wait(lock, [&]() {
+    if (m_executing_calls == 0) {
+      return true;
+    }
+    bool calls_fit = m_max_concurrent_calls == 0 ||
+                     m_executing_calls < m_max_concurrent_calls;
+    bool bytes_fit = m_max_memory_bytes == 0 ||
+                     m_reserved_bytes + bytes <= m_max_memory_bytes;
+    return calls_fit && bytes_fit;
+  });
+  m_executing_calls++;
+  m_reserved_bytes += bytes;
+}
+
+void HEAdmissionController::release(size_t bytes) {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    NGRAPH_CHECK(m_executing_calls > 0 && m_reserved_bytes >= bytes,
+                 "Releasing a call which was not admitted");
+    m_executing_calls--;
+    m_reserved_bytes -= bytes;
+  }
+  m_cond.notify_all();
+}
+
+size_t HEAdmissionController::executing_calls() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_executing_calls;
+}
+
+size_t HEAdmissionController::reserved_bytes() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_reserved_bytes;
+}
+
+HESealBatcher::HESealBatcher(HESealBackend& he_seal_backend,
+                             std::shared_ptr<HESealExecutable> executable,
+                             std::chrono::microseconds window,
+                             size_t max_queued_requests,
+                             std::shared_ptr<HEAdmissionController> admission)
+    : m_executable(std::move(executable)),
+      m_window(window),
+      m_max_queued_requests(max_queued_requests),
+      m_admission(std::move(admission)) {
+  NGRAPH_CHECK(m_executable != nullptr, "Executable is nullptr");
+  NGRAPH_CHECK(!he_seal_backend.enable_client(),
+               "HESealBatcher requires the client to be disabled");
+
+  auto create_batch_tensor = [&](const Node& node, const Shape& shape) {
+    NGRAPH_CHECK(!shape.empty(), "Node ", node.get_name(),
+                 " has no batch axis");
+    if (m_max_batch_size == 0) {
+      m_max_batch_size = shape[0];
+    }
+    NGRAPH_CHECK(shape[0] == m_max_batch_size, "Node ", node.get_name(),
+                 " has batch size ", shape[0], ", expected ",
+                 m_max_batch_size);
+    bool packed = HEOpAnnotations::has_he_annotation(node) &&
+                  HEOpAnnotations::he_op_annotation(node)->packed();
+    return he_seal_backend.create_plain_tensor(node.get_element_type(), shape,
+                                               packed);
+  };
+
+  for (const auto& param : m_executable->get_parameters()) {
+    m_batch_inputs.emplace_back(
+        create_batch_tensor(*param, param->get_shape()));
+  }
+  for (const auto& result : m_executable->get_results()) {
+    m_batch_outputs.emplace_back(
+        create_batch_tensor(*result, result->get_shape()));
+  }
+  NGRAPH_CHECK(m_max_batch_size > 0, "Function has no batch axis");
+  NGRAPH_HE_LOG(3) << "Batching up to " << m_max_batch_size
+                   << " requests per call";
+
+  // The cost model estimates the first call, and measured calls refine it
+  HECostReport cost_report = m_executable->estimate_cost();
+  m_call_latency_us = cost_report.latency_us;
+  m_call_bytes = cost_report.peak_live_bytes;
+  NGRAPH_HE_LOG(3) << "Estimated call latency " << m_call_latency_us
+                   << "us, peak live bytes " << m_call_bytes;
+
+  m_thread = std::thread([this]() { run(); });
+}
+
+HESealBatcher::~HESealBatcher() {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+size_t HESealBatcher::num_calls() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_num_calls;
+}
+
+size_t HESealBatcher::num_rejected() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_num_rejected;
+}
+
+std::chrono::microseconds HESealBatcher::estimated_call_latency() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return std::chrono::microseconds(static_cast<int64_t>(m_call_latency_us));
+}
+
+bool HESealBatcher::batched_before(const Request& request,
+                                   const Request& other) {
+  if (request.options.priority != other.options.priority) {
+    return request.options.priority > other.options.priority;
+  }
+  // Earliest deadline first, and requests without deadline last
+  if (request.options.deadline.has_value() !=
+      other.options.deadline.has_value()) {
+    return request.options.deadline.has_value();
+  }
+  return request.options.deadline.has_value() &&
+         *request.options.deadline < *other.options.deadline;
+}
+
+std::chrono::steady_clock::time_point HESealBatcher::predicted_completion(
+    size_t requests_ahead) const {
+  auto now = std::chrono::steady_clock::now();
+  auto call_latency =
+      std::chrono::microseconds(static_cast<int64_t>(m_call_latency_us));
+  // Calls of the batches ahead, the request's call, and the remainder of
+  // the executing call
+  auto num_calls = static_cast<int64_t>(requests_ahead / m_max_batch_size + 1);
+  auto completion = now + call_latency * num_calls;
+  if (m_call_start.has_value()) {
+    completion += std::max(std::chrono::steady_clock::duration::zero(),
+                           *m_call_start + call_latency - now);
+  }
+  return completion;
+}
+
+void HESealBatcher::reject(Request& request, const std::string& reason) {
+  NGRAPH_HE_LOG(3) << "Rejecting request: " << reason;
+  m_num_rejected++;
+  request.done.set_exception(
+      std::make_exception_ptr(HERequestRejected(reason)));
+}
+
+void HESealBatcher::reject_expired_requests() {
+  auto completion = predicted_completion(0);
+  auto expired = [&](const Request& request) {
+    return request.options.deadline.has_value() &&
+           *request.options.deadline < completion;
+  };
+  for (auto& request : m_requests) {
+    if (expired(request)) {
+      reject(request, "deadline would be missed");
+    }
+  }
+  m_requests.erase(
+      std::remove_if(m_requests.begin(), m_requests.end(), expired),
+      m_requests.end());
+}
+
+void HESealBatcher::check_request_shape(const runtime::Tensor& tensor,
+                                        const Shape& batched_shape) {
+  Shape expected_shape{batched_shape};
+  expected_shape[0] = 1;
+  NGRAPH_CHECK(tensor.get_shape() == expected_shape, "Request tensor shape ",
+               tensor.get_shape(), " does not match expected shape ",
+               expected_shape);
+}
+
+std::future<void> HESealBatcher::submit(
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& inputs,
+    const RequestOptions& options) {
+  NGRAPH_CHECK(inputs.size() == m_batch_inputs.size(), "Expected ",
+               m_batch_inputs.size(), " inputs, got ", inputs.size());
+  NGRAPH_CHECK(outputs.size() == m_batch_outputs.size(), "Expected ",
+               m_batch_outputs.size(), " outputs, got ", outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    check_request_shape(*inputs[i], m_batch_inputs[i]->get_shape());
+  }
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    check_request_shape(*outputs[i], m_batch_outputs[i]->get_shape());
+  }
+
+  Request request{outputs, inputs, std::promise<void>{}, options,
+                  std::chrono::steady_clock::now()};
+  std::future<void> future = request.done.get_future();
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    NGRAPH_CHECK(!m_stop, "HESealBatcher is stopped");
+    if (m_max_queued_requests != 0 &&
+        m_requests.size() >= m_max_queued_requests) {
+      reject(request, "queue is full");
+      return future;
+    }
+    auto position = std::upper_bound(
+        m_requests.begin(), m_requests.end(), request,
+        [](const Request& lhs, const Request& rhs) {
+          return batched_before(lhs, rhs);
+        });
+    size_t requests_ahead = position - m_requests.begin();
+    if (options.deadline.has_value() &&
+        *options.deadline < predicted_completion(requests_ahead)) {
+      reject(request, "deadline would be missed");
+      return future;
+    }
+    m_requests.insert(position, std::move(request));
+  }
+  m_cond.notify_all();
+  return future;
+}
+
+std::chrono::steady_clock::time_point HESealBatcher::batch_window_end()
+    const {
+  auto call_latency =
+      std::chrono::microseconds(static_cast<int64_t>(m_call_latency_us));
+  auto window_end = std::chrono::steady_clock::time_point::max();
+  for (const auto& request : m_requests) {
+    window_end = std::min(window_end, request.enqueued + m_window);
+    if (request.options.deadline.has_value()) {
+      window_end =
+          std::min(window_end, *request.options.deadline - call_latency);
+    }
+  }
+  return window_end;
+}
+
+void HESealBatcher::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cond.wait(lock, [this]() { return m_stop || !m_requests.empty(); });
+    if (m_requests.empty()) {
+      return;
+    }
+
+    // Wait for further requests until the batch is full, the window of the
+    // oldest request elapses, waiting would miss a queued deadline, or the
+    // batcher is stopped. Requests arriving meanwhile may end the wait
+    // earlier
+    while (!m_stop && m_requests.size() < m_max_batch_size) {
+      if (m_cond.wait_until(lock, batch_window_end()) ==
+          std::cv_status::timeout) {
+        break;
+      }
+    }
+    lock.unlock();
+
+    // Batches of other batchers may need to finish first
+    if (m_admission != nullptr) {
+      m_admission->acquire(m_call_bytes);
+    }
+    lock.lock();
+    reject_expired_requests();
+    std::vector<Request> batch;
+    while (!m_requests.empty() && batch.size() < m_max_batch_size) {
+      batch.emplace_back(std::move(m_requests.front()));
+      m_requests.pop_front();
+    }
+    if (batch.empty()) {
+      lock.unlock();
+      if (m_admission != nullptr) {
+        m_admission->release(m_call_bytes);
+      }
+      lock.lock();
+      continue;
+    }
+    m_num_calls++;
+    auto call_start = std::chrono::steady_clock::now();
+    m_call_start = call_start;
+
+    lock.unlock();
+    execute_batch(batch);
+    if (m_admission != nullptr) {
+      m_admission->release(m_call_bytes);
+    }
+    lock.lock();
+    m_call_start.reset();
+    double call_us = std::chrono::duration<double, std::micro>(
+                         std::chrono::steady_clock::now() - call_start)
+                         .count();
+    m_call_latency_us = update_moving_average(m_call_latency_us, call_us);
+  }
+}
+
+void HESealBatcher::execute_batch(std::vector<Request>& batch) {
+  NGRAPH_HE_LOG(3) << "Executing batch of " << batch.size() << " requests";
+  try {
+    // Batch i is stored at offset i * row_size in row-major order
+    for (size_t input_idx = 0; input_idx < m_batch_inputs.size();
+         ++input_idx) {
+      auto& batch_input = m_batch_inputs[input_idx];
+      size_t row_size = batch_input->get_size_in_bytes() / m_max_batch_size;
+      std::vector<char> values(batch_input->get_size_in_bytes(), 0);
+      for (size_t request_idx = 0; request_idx < batch.size();
+           ++request_idx) {
+        batch[request_idx].inputs[input_idx]->read(
+            &values[request_idx * row_size], row_size);
+      }
+      batch_input->write(values.data(), values.size());
+    }
+
+    m_executable->call(m_batch_outputs, m_batch_inputs);
+
+    for (size_t output_idx = 0; output_idx < m_batch_outputs.size();
+         ++output_idx) {
+      auto& batch_output = m_batch_outputs[output_idx];
+      size_t row_size = batch_output->get_size_in_bytes() / m_max_batch_size;
+      std::vector<char> values(batch_output->get_size_in_bytes());
+      batch_output->read(values.data(), values.size());
+      for (size_t request_idx = 0; request_idx < batch.size();
+           ++request_idx) {
+        batch[request_idx].outputs[output_idx]->write(
+            &values[request_idx * row_size], row_size);
+      }
+    }
+  } catch (...) {
+    for (auto& request : batch) {
+      request.done.set_exception(std::current_exception());
+    }
+    return;
+  }
+  for (auto& request : batch) {
+    request.done.set_value();
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,226 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ngraph/except.hpp"
+#include "ngraph/runtime/tensor.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_executable.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Raised by the future of a request which the batcher rejected
+/// rather than executing late, e.g. since its queue is full or its deadline
+/// would be missed
+class HERequestRejected : public ngraph_error {
+ public:
+  explicit HERequestRejected(const std::string& what) : ngraph_error(what) {}
+};
+
+/// \brief Bounds the calls executing at once across the batchers sharing
+/// it, by number and by the peak live ciphertext bytes estimated by the cost
+/// model of their executables, so concurrent models do not thrash threads
+/// and memory. All methods are thread-safe
+class HEAdmissionController {
+ public:
+  /// \brief Constructs an admission controller
+  /// \param[in] max_concurrent_calls Maximum number of calls executing at
+  /// once, or 0 for no bound
+  /// \param[in] max_memory_bytes Maximum sum of the estimated bytes of the
+  /// executing calls, or 0 for no bound. A call estimated above the bound
+  /// executes alone
+  HEAdmissionController(size_t max_concurrent_calls, size_t max_memory_bytes)
+      : m_max_concurrent_calls(max_concurrent_calls),
+        m_max_memory_bytes(max_memory_bytes) {}
+
+  /// \brief Blocks until a call may start, then reserves its bytes
+  /// \param[in] bytes Estimated peak bytes of the call
+  void acquire(size_t bytes);
+
+  /// \brief Releases the reservation of a finished call
+  /// \param[in] bytes Bytes passed to acquire
+  void release(size_t bytes);
+
+  /// \brief Returns the number of calls executing
+  size_t executing_calls() const;
+
+  /// \brief Returns the bytes reserved by the executing calls
+  size_t reserved_bytes() const;
+
+ private:
+  size_t m_max_concurrent_calls;
+  size_t m_max_memory_bytes;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cond;
+  size_t m_executing_calls{0};
+  size_t m_reserved_bytes{0};
+};
+
+/// \brief Coalesces inference requests of batch size 1 into a single call of
+/// a function compiled for a larger batch size. Each parameter and result of
+/// the function must be batched along its first axis, whose size is the
+/// maximum number of requests per call. Requests arriving within a latency
+/// window of the first queued request are stacked along the batch axis,
+/// which packs them into the same ciphertext slots, and unused batch
+/// entries are zero. Only applies when the server holds all inputs, i.e.
+/// with the client disabled, since each function call uses a single set of
+/// keys.
+///
+/// Queued requests are batched in order of priority, then deadline, then
+/// arrival. The call latency is estimated by the cost model of the function,
+/// then by the measured calls, so requests predicted to miss their deadline
+/// are rejected on submission or once their turn comes, rather than
+/// delaying the requests behind them
+class HESealBatcher {
+ public:
+  /// \brief Scheduling options of a request
+  struct RequestOptions {
+    /// \brief Requests of higher priority are batched first
+    int priority{0};
+    /// \brief Time by which the request should complete, if any
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+  };
+
+  /// \brief Constructs a batcher and starts the thread executing batches
+  /// \param[in] he_seal_backend Backend used to create the batched tensors
+  /// \param[in] executable Compiled function to call on each batch
+  /// \param[in] window Maximum time a request waits for further requests
+  /// \param[in] max_queued_requests Number of queued requests above which
+  /// requests are rejected, or 0 for no bound
+  /// \param[in] admission Controller bounding the calls executing at once,
+  /// which may be shared with other batchers, or nullptr for no bound
+  /// \throws ngraph_error if the client is enabled or the function
+  /// parameters and results do not share a batch axis
+  HESealBatcher(HESealBackend& he_seal_backend,
+                std::shared_ptr<HESealExecutable> executable,
+                std::chrono::microseconds window,
+                size_t max_queued_requests = 0,
+                std::shared_ptr<HEAdmissionController> admission = nullptr);
+
+  /// \brief Executes the queued requests, then stops the batching thread
+  ~HESealBatcher();
+
+  HESealBatcher(const HESealBatcher&) = delete;
+  HESealBatcher& operator=(const HESealBatcher&) = delete;
+
+  /// \brief Queues a request
+  /// \param[out] outputs Tensors storing the results of the request, with
+  /// the shapes of the function results using batch size 1
+  /// \param[in] inputs Input tensors of the request, with the shapes of the
+  /// function parameters using batch size 1
+  /// \param[in] options Priority and deadline of the request
+  /// \returns Future which is ready once the outputs have been written, or
+  /// which raises HERequestRejected if the request was rejected
+  /// \throws ngraph_error if a tensor shape does not match the function
+  std::future<void> submit(
+      const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+      const std::vector<std::shared_ptr<runtime::Tensor>>& inputs,
+      const RequestOptions& options = {});
+
+  /// \brief Returns the maximum number of requests executed per call
+  size_t max_batch_size() const { return m_max_batch_size; }
+
+  /// \brief Returns the number of function calls started so far
+  size_t num_calls() const;
+
+  /// \brief Returns the number of requests rejected so far
+  size_t num_rejected() const;
+
+  /// \brief Returns the estimated latency of a call
+  std::chrono::microseconds estimated_call_latency() const;
+
+ private:
+  struct Request {
+    std::vector<std::shared_ptr<runtime::Tensor>> outputs;
+    std::vector<std::shared_ptr<runtime::Tensor>> inputs;
+    std::promise<void> done;
+    RequestOptions options;
+    // Starts the batching window of the request
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  /// \brief Returns whether a request is batched before another
+  static bool batched_before(const Request& request, const Request& other);
+
+  /// \brief Returns the time by which a request is predicted to complete if
+  /// requests_ahead requests are batched before it. Must hold m_mutex
+  std::chrono::steady_clock::time_point predicted_completion(
+      size_t requests_ahead) const;
+
+  /// \brief Rejects a request
+  void reject(Request& request, const std::string& reason);
+
+  /// \brief Rejects the queued requests which would miss their deadline
+  /// even if batched next. Must hold m_mutex
+  void reject_expired_requests();
+
+  /// \brief Returns the time until which the next batch waits for further
+  /// requests, i.e. the end of the window of the oldest queued request, or
+  /// earlier if waiting would miss a queued deadline. Must hold m_mutex
+  std::chrono::steady_clock::time_point batch_window_end() const;
+
+  /// \brief Waits for requests and executes them in batches until stopped
+  void run();
+
+  /// \brief Executes a batch of at most max_batch_size() requests
+  /// \param[in,out] batch Requests to execute. The promise of each request is
+  /// satisfied
+  void execute_batch(std::vector<Request>& batch);
+
+  /// \brief Checks a tensor matches a batched node shape at batch size 1
+  /// \param[in] tensor Tensor to check
+  /// \param[in] batched_shape Shape of the function parameter or result
+  static void check_request_shape(const runtime::Tensor& tensor,
+                                  const Shape& batched_shape);
+
+  std::shared_ptr<HESealExecutable> m_executable;
+  std::chrono::microseconds m_window;
+  size_t m_max_batch_size{0};
+  size_t m_max_queued_requests;
+  std::shared_ptr<HEAdmissionController> m_admission;
+  // Bytes reserved with the admission controller for each call
+  size_t m_call_bytes{0};
+
+  std::vector<std::shared_ptr<runtime::Tensor>> m_batch_inputs;
+  std::vector<std::shared_ptr<runtime::Tensor>> m_batch_outputs;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cond;
+  // Sorted by batched_before
+  std::deque<Request> m_requests;
+  size_t m_num_calls{0};
+  size_t m_num_rejected{0};
+  // Moving average of the call latency, in microseconds
+  double m_call_latency_us{0};
+  // Start of the executing call, if any
+  std::optional<std::chrono::steady_clock::time_point> m_call_start;
+  bool m_stop{false};
+  std::thread m_thread;
+};
+
+}  // namespace ngraph::runtime::he
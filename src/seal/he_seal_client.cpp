@@ -16,9 +16,20 @@
 
 #include "seal/he_seal_client.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <functional>
+#include <memory>
 #include <numeric>
+#include <sstream>
+#include <string>
 #include <unordered_set>
 
 #include "boost/asio.hpp"
@@ -26,12 +37,17 @@
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/log.hpp"
 #include "nlohmann/json.hpp"
+#include "seal/he_seal_epilogue.hpp"
 #include "seal/kernel/bounded_relu_seal.hpp"
-#include "seal/kernel/max_pool_seal.hpp"
+#include "seal/kernel/elementwise_seal.hpp"
+#include "seal/kernel/max_seal.hpp"
+#include "seal/kernel/refresh_seal.hpp"
 #include "seal/kernel/relu_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_context_cache.hpp"
 #include "seal/seal_util.hpp"
+#include "tcp/shm_transport.hpp"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
 
@@ -39,27 +55,45 @@ using json = nlohmann::json;
 
 namespace ngraph::runtime::he {
 
+namespace {
+/// \brief Returns the parms_id at which to re-encrypt the outputs of an op
+/// request, i.e. at the chain index requested by the server
+seal::parms_id_type reencryption_parms_id(
+    const pb::OpRequest& op_request,
+    const std::shared_ptr<seal::SEALContext>& context) {
+  return parms_id_at_chain_index(context, op_request.chain_index());
+}
+
+/// \brief Returns the serialization of a SEAL object, compressed with the
+/// default compression mode
+template <typename T>
+std::string save_to_string(const T& object) {
+  std::stringstream stream;
+  object.save(stream, seal::Serialization::compr_mode_default);
+  return stream.str();
+}
+
+/// \brief Loads a SEAL key from its serialization, expanding seeded keys
+template <typename T>
+std::shared_ptr<T> load_from_string(const seal::SEALContext& context,
+                                    const std::string& serialized) {
+  auto object = std::make_shared<T>();
+  std::stringstream stream(serialized);
+  object->load(context, stream);
+  return object;
+}
+}  // namespace
+
 HESealClient::HESealClient(const std::string& hostname, const size_t port,
                            const size_t batch_size,
                            const HETensorConfigMap<double>& inputs)
     : m_hostname{hostname}, m_batch_size{batch_size}, m_input_config{inputs} {
   NGRAPH_HE_LOG(5) << "Creating HESealClient from config";
-  NGRAPH_CHECK(m_input_config.size() == 1,
-               "Client supports only one input parameter");
-
-  for (const auto& elem : inputs) {
-    NGRAPH_HE_LOG(1) << "Client input tensor: " << elem.first;
+  for (const auto& [name, input] : m_input_config) {
+    m_inputs[name] = HEInputView{input.first, element::f64,
+                                 input.second.data(), input.second.size()};
   }
-
-  boost::asio::io_context io_context;
-  boost::asio::ip::tcp::resolver resolver(io_context);
-  auto endpoints = resolver.resolve(hostname, std::to_string(port));
-  auto client_callback = [this](const TCPMessage& message) {
-    return handle_message(message);
-  };
-  m_tcp_client =
-      std::make_unique<TCPClient>(io_context, endpoints, client_callback);
-  io_context.run();
+  connect(hostname, port);
 }
 
 HESealClient::HESealClient(const std::string& hostname, const size_t port,
@@ -74,55 +108,517 @@ HESealClient::HESealClient(const std::string& hostname, const size_t port,
     : HESealClient(hostname, port, batch_size,
                    map_to_double_map<int64_t>(inputs)) {}
 
+HESealClient::HESealClient(const std::string& hostname, const size_t port,
+                           const size_t batch_size,
+                           const HEInputViewMap& inputs)
+    : m_hostname{hostname}, m_batch_size{batch_size}, m_inputs{inputs} {
+  NGRAPH_HE_LOG(5) << "Creating HESealClient from input views";
+  connect(hostname, port);
+}
+
+HESealClient::HESealClient(const HESealEncryptionParameters& encryption_params,
+                           const size_t batch_size,
+                           const HEInputViewMap& inputs,
+                           std::unique_ptr<ClientTransport> transport)
+    : m_tcp_client{std::move(transport)},
+      m_encryption_params{encryption_params},
+      m_batch_size{batch_size},
+      m_offline{true},
+      m_inputs{inputs} {
+  NGRAPH_HE_LOG(5) << "Creating offline HESealClient";
+  NGRAPH_CHECK(m_tcp_client != nullptr, "Offline client has no transport");
+  set_seal_context();
+  generate_eval_keys();
+}
+
+void HESealClient::connect(const std::string& hostname, size_t port) {
+  if (const char* key_file = std::getenv("NGRAPH_HE_CLIENT_KEY_FILE");
+      key_file != nullptr) {
+    m_key_file = key_file;
+  }
+  if (const char* model_name = std::getenv("NGRAPH_HE_CLIENT_MODEL");
+      model_name != nullptr) {
+    m_model_name = model_name;
+  }
+  if (const char* session_file = std::getenv("NGRAPH_HE_CLIENT_SESSION_FILE");
+      session_file != nullptr) {
+    m_session_file = session_file;
+    load_session();
+  }
+  if (const char* persistent = std::getenv("NGRAPH_HE_CLIENT_PERSISTENT");
+      persistent != nullptr) {
+    m_persistent = string_to_bool(persistent);
+  }
+  if (const char* capture_file = std::getenv("NGRAPH_HE_CLIENT_CAPTURE_FILE");
+      capture_file != nullptr) {
+    NGRAPH_HE_LOG(1) << "Client capturing session to " << capture_file;
+    m_capture = std::make_unique<TCPCaptureWriter>(capture_file);
+  }
+  NGRAPH_CHECK(m_inputs.size() == 1,
+               "Client supports only one input parameter");
+
+  for (const auto& elem : m_inputs) {
+    NGRAPH_HE_LOG(1) << "Client input tensor: " << elem.first;
+  }
+
+  size_t num_request_workers = 1;
+  if (const char* workers = std::getenv("NGRAPH_HE_CLIENT_WORKERS");
+      workers != nullptr) {
+    num_request_workers = std::max(1, flag_to_int(workers, 1));
+  }
+  NGRAPH_HE_LOG(3) << "Client using " << num_request_workers
+                   << " request workers";
+  for (size_t i = 0; i < num_request_workers; ++i) {
+    m_request_workers.emplace_back([this]() { run_request_worker(); });
+  }
+
+  auto client_callback = [this](const TCPMessage& message) {
+    return handle_message(message);
+  };
+  // A server on the same host may serve clients over shared memory, see
+  // HESealBackend::shm_transport
+  const char* transport = std::getenv("NGRAPH_HE_CLIENT_TRANSPORT");
+  bool shm_transport = transport != nullptr && std::string(transport) == "shm";
+  // The TCP client retries connecting to the endpoints until io_context.run()
+  // returns
+  boost::asio::ip::tcp::resolver::results_type endpoints;
+  try {
+    if (shm_transport) {
+      m_tcp_client = std::make_unique<ShmClient>(
+          m_io_context, shm_transport_name(port), client_callback);
+    } else {
+      boost::asio::ip::tcp::resolver resolver(m_io_context);
+      endpoints = resolver.resolve(hostname, std::to_string(port));
+      m_tcp_client =
+          std::make_unique<TCPClient>(m_io_context, endpoints, client_callback);
+    }
+    if (!m_persistent) {
+      m_io_context.run();
+    }
+  } catch (...) {
+    if (m_input_upload.valid()) {
+      m_input_upload.wait();
+    }
+    stop_request_workers();
+    throw;
+  }
+  if (!m_persistent) {
+    if (m_input_upload.valid()) {
+      m_input_upload.wait();
+    }
+    stop_request_workers();
+    return;
+  }
+
+  // The connection outlives the first inference, so the I/O thread runs
+  // until the connection is closed
+  m_io_thread = std::thread([this]() {
+    try {
+      m_io_context.run();
+    } catch (std::exception& e) {
+      NGRAPH_ERR << "Client error handling thread: " << e.what();
+    }
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    m_closed = true;
+    m_is_done = true;
+    m_is_done_cond.notify_all();
+  });
+  std::unique_lock<std::mutex> lock(m_is_done_mutex);
+  m_is_done_cond.wait(lock, [this]() { return m_is_done; });
+}
+
+HESealClient::~HESealClient() {
+  if (m_io_thread.joinable()) {
+    close_connection();
+    m_io_thread.join();
+  }
+  if (m_input_upload.valid()) {
+    m_input_upload.wait();
+  }
+  stop_request_workers();
+}
+
+void HESealClient::stop_request_workers() {
+  {
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    m_stop_request_workers = true;
+  }
+  m_request_cond.notify_all();
+  for (auto& worker : m_request_workers) {
+    worker.join();
+  }
+  m_request_workers.clear();
+}
+
+const std::vector<double>& HESealClient::infer(const HEInputViewMap& inputs) {
+  NGRAPH_CHECK(m_persistent, "Client session is not persistent");
+  {
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    NGRAPH_CHECK(!m_closed, "Client connection is closed");
+  }
+  clear_results();
+  boost::asio::post(m_io_context, [this, inputs]() {
+    NGRAPH_CHECK(m_session_persistent,
+                 "Server does not keep the session open");
+    m_inputs = inputs;
+    m_next_inputs_set = true;
+    upload_next_inputs();
+  });
+  return get_results_ref();
+}
+
+void HESealClient::send_persistent_session() {
+  NGRAPH_HE_LOG(3) << "Client requesting a persistent session";
+  pb::TCPMessage message;
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  json js = {{"function", "Session"}, {"persistent", true}};
+  message.mutable_function()->set_function(js.dump());
+  write_message(TCPMessage(std::move(message)));
+  m_session_persistent = true;
+}
+
+void HESealClient::upload_next_inputs() {
+  if (!m_next_inputs_set || m_next_request == nullptr) {
+    return;
+  }
+  auto request = std::move(m_next_request);
+  m_next_inputs_set = false;
+  handle_inference_request(*request);
+}
+
+void HESealClient::dispatch_request(const TCPMessage& message,
+                                    RequestHandler handler) {
+  uint64_t stream_id = message.pb_message()->stream_id();
+  if (!message.pb_message()->has_op_request()) {
+    TCPMessage response = (this->*handler)(message);
+    response.pb_message()->set_stream_id(stream_id);
+    write_message(std::move(response));
+    return;
+  }
+  std::lock_guard<std::mutex> guard(m_request_mutex);
+  // Responses to requests with a stream id are matched by the server
+  // without their order, so only requests without one are sequenced
+  size_t sequence = stream_id == 0 ? m_num_requests++ : 0;
+  m_requests.push_back({sequence, m_message_index, message.detach(), handler});
+  m_request_cond.notify_one();
+}
+
+void HESealClient::run_request_worker() {
+  while (true) {
+    QueuedRequest request;
+    {
+      std::unique_lock<std::mutex> lock(m_request_mutex);
+      m_request_cond.wait(lock, [this]() {
+        return m_stop_request_workers || !m_requests.empty();
+      });
+      if (m_stop_request_workers) {
+        return;
+      }
+      request = std::move(m_requests.front());
+      m_requests.pop_front();
+    }
+
+    TCPMessage response;
+    try {
+      response = (this->*request.handler)(request.message);
+    } catch (std::exception& e) {
+      NGRAPH_ERR << "Client error handling request: " << e.what();
+      boost::asio::post(m_io_context, [this]() { close_connection(); });
+      return;
+    }
+
+    // The TCP client is not thread-safe, so responses are written from the
+    // I/O thread
+    uint64_t stream_id = request.message.pb_message()->stream_id();
+    if (stream_id != 0) {
+      response.pb_message()->set_stream_id(stream_id);
+      boost::asio::post(m_io_context, [this, trigger = request.message_index,
+                                       response = std::move(
+                                           response)]() mutable {
+        write_message(std::move(response), trigger);
+      });
+      continue;
+    }
+    std::lock_guard<std::mutex> guard(m_request_mutex);
+    m_responses.emplace(request.sequence,
+                        std::make_pair(request.message_index,
+                                       std::move(response)));
+    for (auto it = m_responses.begin();
+         it != m_responses.end() && it->first == m_num_responses;
+         it = m_responses.erase(it), ++m_num_responses) {
+      boost::asio::post(m_io_context, [this, trigger = it->second.first,
+                                       response = std::move(
+                                           it->second.second)]() mutable {
+        write_message(std::move(response), trigger);
+      });
+    }
+  }
+}
+
 void HESealClient::set_seal_context() {
   NGRAPH_HE_LOG(5) << "Client setting seal context";
-  auto seal_sec_level =
-      seal_security_level(m_encryption_params.security_level());
-
-  //seal::SEALContext m_context(m_encryption_params.seal_encryption_parameters(), true, sec_level);
-  //m_context = std::shared_ptr<seal::SEALContext>m_context;
-  //seal::SEALContext t_context(m_encryption_params.seal_encryption_parameters(), true, seal_sec_level);
-  m_context = std::make_shared<seal::SEALContext>(m_encryption_params.seal_encryption_parameters(), true, seal_sec_level);
+  m_context = SealContextCache::get_context(m_encryption_params);
 
   print_encryption_parameters(m_encryption_params, *m_context);
 
-  m_keygen = std::make_shared<seal::KeyGenerator>(*m_context);
-  if (m_context->using_keyswitching()) {
-    seal::RelinKeys m_relin_keys_temp;
-    m_keygen->create_relin_keys(m_relin_keys_temp);
-    m_relin_keys = std::make_shared<seal::RelinKeys>(m_relin_keys_temp);
-  }
-  seal::PublicKey m_public_key_temp;
-  m_keygen->create_public_key(m_public_key_temp);
-  m_public_key = std::make_shared<seal::PublicKey>(m_public_key_temp);
-  m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
+  m_keys_from_file = load_keys();
+  m_seeded_public_key.clear();
+  m_seeded_relin_keys.clear();
+  if (!m_keys_from_file) {
+    HESealClientStats::ScopedTimer timer(m_stats, "keygen");
+    // Seeded keys replace half of their polynomials by the seed generating
+    // them, which roughly halves their upload. The keys used locally are
+    // the expansions of the uploaded keys
+    m_keygen = std::make_shared<seal::KeyGenerator>(*m_context);
+    m_seeded_public_key = save_to_string(m_keygen->create_public_key());
+    m_public_key =
+        load_from_string<seal::PublicKey>(*m_context, m_seeded_public_key);
+    m_secret_key = std::make_shared<seal::SecretKey>(m_keygen->secret_key());
+  }
+  if (!m_key_file.empty()) {
+    std::stringstream pk_stream;
+    m_public_key->save(pk_stream);
+    m_key_id = key_fingerprint(pk_stream.str());
+  }
   m_encryptor = std::make_shared<seal::Encryptor>(*m_context, *m_public_key);
+  m_zero_pool = nullptr;
+  if (const char* pool_size = std::getenv("NGRAPH_HE_CLIENT_ZERO_POOL_SIZE");
+      pool_size != nullptr && flag_to_int(pool_size, 0) > 0) {
+    m_zero_pool = std::make_unique<SealZeroPool>(
+        m_context, m_encryptor, flag_to_int(pool_size, 0));
+  }
+  m_secret_key_encryptor =
+      std::make_shared<seal::Encryptor>(*m_context, *m_secret_key);
   m_decryptor = std::make_shared<seal::Decryptor>(*m_context, *m_secret_key);
-  m_evaluator = std::make_shared<seal::Evaluator>(*m_context);
+  m_evaluator = SealContextCache::get_evaluator(m_encryption_params);
   m_ckks_encoder = std::make_shared<seal::CKKSEncoder>(*m_context);
 }
 
+void HESealClient::generate_eval_keys() {
+  m_seeded_galois_keys.clear();
+  if (!m_galois_steps.empty() && m_context->using_keyswitching()) {
+    HESealClientStats::ScopedTimer timer(m_stats, "keygen");
+    if (m_keygen == nullptr) {
+      m_keygen =
+          std::make_shared<seal::KeyGenerator>(*m_context, *m_secret_key);
+    }
+    m_seeded_galois_keys =
+        save_to_string(m_keygen->create_galois_keys(m_galois_steps));
+  }
+  if (m_keys_from_file) {
+    return;
+  }
+  if (m_context->using_keyswitching()) {
+    HESealClientStats::ScopedTimer timer(m_stats, "keygen");
+    m_seeded_relin_keys = save_to_string(m_keygen->create_relin_keys());
+    m_relin_keys =
+        load_from_string<seal::RelinKeys>(*m_context, m_seeded_relin_keys);
+  }
+  save_keys();
+}
+
+bool HESealClient::load_keys() {
+  if (m_key_file.empty()) {
+    return false;
+  }
+  std::ifstream key_stream(m_key_file, std::ios::binary);
+  if (!key_stream.is_open()) {
+    NGRAPH_HE_LOG(3) << "Client key file " << m_key_file << " not found";
+    return false;
+  }
+  try {
+    auto secret_key = std::make_shared<seal::SecretKey>();
+    auto public_key = std::make_shared<seal::PublicKey>();
+    secret_key->load(*m_context, key_stream);
+    public_key->load(*m_context, key_stream);
+    if (m_context->using_keyswitching()) {
+      auto relin_keys = std::make_shared<seal::RelinKeys>();
+      relin_keys->load(*m_context, key_stream);
+      m_relin_keys = relin_keys;
+    }
+    m_secret_key = secret_key;
+    m_public_key = public_key;
+  } catch (const std::exception& e) {
+    // E.g. keys for different encryption parameters
+    NGRAPH_WARN << "Could not load client keys from " << m_key_file << ": "
+                << e.what();
+    return false;
+  }
+  NGRAPH_HE_LOG(3) << "Client loaded keys from " << m_key_file;
+  return true;
+}
+
+void HESealClient::save_keys() const {
+  if (m_key_file.empty()) {
+    return;
+  }
+  std::stringstream key_stream;
+  m_secret_key->save(key_stream);
+  m_public_key->save(key_stream);
+  if (m_context->using_keyswitching()) {
+    m_relin_keys->save(key_stream);
+  }
+  const std::string keys = key_stream.str();
+
+  // The file stores the secret key, so it is written to a new file readable
+  // by its owner alone, which then replaces the key file
+  std::string tmp_file = m_key_file + ".tmp" + std::to_string(::getpid());
+  auto create_tmp_file = [&tmp_file]() {
+    return ::open(tmp_file.c_str(),
+                  O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+  };
+  int fd = create_tmp_file();
+  if (fd < 0 && errno == EEXIST) {
+    // Left by an earlier process with the same pid
+    std::remove(tmp_file.c_str());
+    fd = create_tmp_file();
+  }
+  if (fd < 0) {
+    NGRAPH_WARN << "Could not create client key file " << tmp_file << ": "
+                << std::strerror(errno);
+    return;
+  }
+  const char* data = keys.data();
+  size_t remaining = keys.size();
+  bool written = true;
+  while (remaining > 0) {
+    ssize_t count = ::write(fd, data, remaining);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count < 0) {
+      written = false;
+      break;
+    }
+    data += count;
+    remaining -= static_cast<size_t>(count);
+  }
+  if (::close(fd) != 0) {
+    written = false;
+  }
+  if (!written || std::rename(tmp_file.c_str(), m_key_file.c_str()) != 0) {
+    NGRAPH_WARN << "Could not write client key file " << m_key_file;
+    std::remove(tmp_file.c_str());
+    return;
+  }
+  NGRAPH_HE_LOG(3) << "Client saved keys to " << m_key_file;
+}
+
+void HESealClient::send_key_id() {
+  NGRAPH_HE_LOG(3) << "Client sending key id " << m_key_id;
+  pb::TCPMessage message;
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  message.mutable_public_key()->set_key_id(m_key_id);
+  if (!m_seeded_galois_keys.empty()) {
+    message.mutable_eval_key()->set_galois_keys(m_seeded_galois_keys);
+  }
+
+  // Accept the compression mode
+  message.mutable_encryption_parameters()->set_compression_mode(
+      compr_mode_to_pb(m_compr_mode));
+  message.mutable_encryption_parameters()->set_inference_request_id(
+      std::move(m_pipelined_request_id));
+  m_pipelined_request_id.clear();
+
+  write_message(TCPMessage(std::move(message)));
+}
+
 void HESealClient::send_public_and_relin_keys() {
   NGRAPH_HE_LOG(3) << "Client sending public and relin keys";
+  HESealClientStats::ScopedTimer timer(m_stats, "key_upload");
   pb::TCPMessage message;
   message.set_type(pb::TCPMessage_Type_RESPONSE);
 
   // Set public key
-  std::stringstream pk_stream;
-  m_public_key->save(pk_stream);
   pb::PublicKey public_key;
-  public_key.set_public_key(pk_stream.str());
+  public_key.set_public_key(m_seeded_public_key.empty()
+                                ? save_to_string(*m_public_key)
+                                : m_seeded_public_key);
+  public_key.set_key_id(m_key_id);
   *message.mutable_public_key() = public_key;
 
   // Set relinearization keys
   if (m_context->using_keyswitching()) {
-    std::stringstream evk_stream;
-    m_relin_keys->save(evk_stream);
     pb::EvaluationKey eval_key;
-    eval_key.set_eval_key(evk_stream.str());
+    eval_key.set_eval_key(m_seeded_relin_keys.empty()
+                              ? save_to_string(*m_relin_keys)
+                              : m_seeded_relin_keys);
     *message.mutable_eval_key() = eval_key;
   }
+  if (!m_seeded_galois_keys.empty()) {
+    message.mutable_eval_key()->set_galois_keys(m_seeded_galois_keys);
+  }
+  NGRAPH_HE_LOG(3) << "Client key upload of "
+                   << message.public_key().public_key().size() +
+                          message.eval_key().eval_key().size() +
+                          message.eval_key().galois_keys().size()
+                   << " bytes";
+
+  // Accept the compression mode
+  message.mutable_encryption_parameters()->set_compression_mode(
+      compr_mode_to_pb(m_compr_mode));
+  message.mutable_encryption_parameters()->set_inference_request_id(
+      std::move(m_pipelined_request_id));
+  m_pipelined_request_id.clear();
+
+  write_message(TCPMessage(std::move(message)));
+}
 
+std::string HESealClient::inference_request_id(pb::TCPMessage message) {
+  message.clear_encryption_parameters();
+  return key_fingerprint(message.SerializeAsString());
+}
+
+void HESealClient::load_session() {
+  std::ifstream session_stream(m_session_file, std::ios::binary);
+  if (!session_stream.is_open()) {
+    NGRAPH_HE_LOG(3) << "Client session file " << m_session_file
+                     << " not found";
+    return;
+  }
+  auto request = std::make_shared<pb::TCPMessage>();
+  if (!request->ParseFromIstream(&session_stream) ||
+      !request->has_encryption_parameters() || !request->has_function()) {
+    NGRAPH_WARN << "Could not load client session from " << m_session_file;
+    return;
+  }
+  NGRAPH_HE_LOG(3) << "Client loaded session from " << m_session_file;
+  m_cached_request = std::move(request);
+}
+
+void HESealClient::save_session(const pb::TCPMessage& message) {
+  if (m_session_file.empty()) {
+    return;
+  }
+  auto request = std::make_shared<pb::TCPMessage>(message);
+  request->mutable_encryption_parameters()->set_encryption_parameters(
+      m_server_parameters);
+  std::ofstream session_stream(m_session_file,
+                               std::ios::binary | std::ios::trunc);
+  if (!session_stream.is_open() ||
+      !request->SerializeToOstream(&session_stream)) {
+    NGRAPH_WARN << "Could not save client session to " << m_session_file;
+    return;
+  }
+  NGRAPH_HE_LOG(3) << "Client saved session to " << m_session_file;
+  m_cached_request = std::move(request);
+}
+
+void HESealClient::send_pipeline_reset() {
+  NGRAPH_HE_LOG(3) << "Client uploading inputs again";
+  pb::TCPMessage message;
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  json js = {{"function", "PipelineReset"}};
+  message.mutable_function()->set_function(js.dump());
+  write_message(TCPMessage(std::move(message)));
+}
+
+void HESealClient::send_model_name() {
+  NGRAPH_HE_LOG(3) << "Client requesting model " << m_model_name;
+  pb::TCPMessage message;
+  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  json js = {{"function", "Model"}, {"model", m_model_name}};
+  message.mutable_function()->set_function(js.dump());
   write_message(TCPMessage(std::move(message)));
 }
 
@@ -140,8 +636,66 @@ void HESealClient::handle_encryption_parameters_response(
   NGRAPH_HE_LOG(3) << "Client loading encryption parameters from stream size "
                    << enc_parms_str.size();
   m_encryption_params = HESealEncryptionParameters::load(param_stream);
+  m_server_parameters = enc_parms_str;
+
+  // Accept the proposed compression mode only if SEAL supports it
+  m_compr_mode =
+      compr_mode_from_pb(message.encryption_parameters().compression_mode());
+  NGRAPH_HE_LOG(3) << "Client using compression mode "
+                   << compr_mode_to_string(m_compr_mode);
+  // Servers compacting ReLU requests rotate the ciphertexts
+  const auto& galois_steps = message.encryption_parameters().galois_steps();
+  m_galois_steps.assign(galois_steps.begin(), galois_steps.end());
 
   set_seal_context();
+
+  // With the parameters of the cached session, the inputs are uploaded right
+  // after the keys, saving the round-trip of the inference request. The
+  // server validates the request fingerprint, and sends the request if it
+  // does not accept the inputs. Garbled circuits are set up by the request
+  bool pipelined = false;
+  if (m_cached_request != nullptr &&
+      m_cached_request->encryption_parameters().encryption_parameters() ==
+          enc_parms_str) {
+    json js = json::parse(m_cached_request->function().function());
+    pipelined = js.find("enable_gc") == js.end() ||
+                !string_to_bool(std::string(js.at("enable_gc")));
+  }
+  if (pipelined) {
+    NGRAPH_HE_LOG(3) << "Client uploading inputs of the cached session";
+    m_pipelined_request_id = inference_request_id(*m_cached_request);
+  }
+
+  // The server may still hold keys loaded from the key file
+  if (m_keys_from_file) {
+    generate_eval_keys();
+    send_key_id();
+    if (pipelined) {
+      m_pipelined_inputs = true;
+      handle_inference_request(*m_cached_request);
+    }
+    return;
+  }
+  if (!pipelined) {
+    generate_eval_keys();
+    send_public_and_relin_keys();
+    return;
+  }
+
+  // Inputs need only the public key, so they are encrypted on another thread
+  // while this thread generates the relinearization keys, and uploads them
+  // once this handler returns. The messages of the other thread are written
+  // from this thread after the keys, see write_message
+  m_pipelined_inputs = true;
+  m_input_upload = std::async(std::launch::async, [this]() {
+    try {
+      handle_inference_request(*m_cached_request);
+    } catch (std::exception& e) {
+      NGRAPH_ERR << "Client error uploading inputs: " << e.what();
+      boost::asio::post(m_io_context, [this]() { close_connection(); });
+    }
+  });
+  generate_eval_keys();
   send_public_and_relin_keys();
 }
 
@@ -155,8 +709,20 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   NGRAPH_CHECK(message.he_tensors_size() == 1,
                "Only support 1 encrypted parameter from client");
 
-  NGRAPH_CHECK(m_input_config.size() == 1,
-               "Client supports only input parameter");
+  NGRAPH_CHECK(m_inputs.size() == 1, "Client supports only input parameter");
+
+  json js = json::parse(message.function().function());
+  if (js.find("epilogue") != js.end()) {
+    m_epilogue = js.at("epilogue");
+    NGRAPH_HE_LOG(3) << "Client computes epilogue " << m_epilogue.dump();
+  }
+  // Garbled circuits are set up for a single inference
+  bool enable_gc = js.find("enable_gc") != js.end() &&
+                   string_to_bool(std::string(js.at("enable_gc")));
+  if (m_persistent && !m_session_persistent && !enable_gc) {
+    send_persistent_session();
+  }
+  m_num_inferences++;
 
   const auto& pb_tensor = message.he_tensors(0);
   auto& pb_name = pb_tensor.name();
@@ -166,28 +732,45 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   NGRAPH_HE_LOG(5) << "Inference request tensor has name " << pb_name;
 
   bool encrypt_tensor = true;
-  auto input_pb = m_input_config.find(pb_name);
-  NGRAPH_CHECK(input_pb != m_input_config.end(), "Tensor name ", pb_name,
+  bool seeded = false;
+  auto input_pb = m_inputs.find(pb_name);
+  NGRAPH_CHECK(input_pb != m_inputs.end(), "Tensor name ", pb_name,
                " not found");
 
-  auto& [input_config, input_data] = input_pb->second;
-  static std::unordered_set<std::string> known_configs{"encrypt", "plain"};
+  const HEInputView& input = input_pb->second;
+  std::string input_config = input.config;
+  bool cache_input = false;
+  if (size_t comma = input_config.find(','); comma != std::string::npos) {
+    NGRAPH_CHECK(input_config.substr(comma + 1) == "cached",
+                 "Unknown configuration ", input.config);
+    cache_input = true;
+    input_config.resize(comma);
+  }
+  static std::unordered_set<std::string> known_configs{
+      "encrypt", "encrypt_seeded", "plain"};
 
   NGRAPH_CHECK(known_configs.find(input_config) != known_configs.end(),
                "Unknown configuration ", input_config);
 
   if (input_config == "encrypt") {
     encrypt_tensor = true;
+  } else if (input_config == "encrypt_seeded") {
+    // Secret-key encryption sends a seed in place of the second ciphertext
+    // polynomial, which nearly halves the upload size
+    encrypt_tensor = true;
+    seeded = true;
   } else if (input_config == "plain") {
     encrypt_tensor = false;
   }
+  NGRAPH_CHECK(!cache_input || encrypt_tensor,
+               "Only encrypted inputs can be cached");
 
   NGRAPH_HE_LOG(5) << "Client received inference request with name " << pb_name
                    << ", " << shape << ", to be "
                    << (encrypt_tensor ? "encrypted" : "plaintext");
 
   NGRAPH_HE_LOG(5) << "Client batch size " << m_batch_size;
-  NGRAPH_HE_LOG(5) << "m_input_config.size() " << m_input_config.size();
+  NGRAPH_HE_LOG(5) << "m_inputs.size() " << m_inputs.size();
   if (complex_packing()) {
     NGRAPH_HE_LOG(5) << "Client complex packing";
   }
@@ -195,101 +778,322 @@ void HESealClient::handle_inference_request(const pb::TCPMessage& message) {
   size_t parameter_size = shape_size(HETensor::pack_shape(shape));
   NGRAPH_HE_LOG(5) << "Client parameter_size " << parameter_size;
 
-  NGRAPH_CHECK(input_data.size() == parameter_size * m_batch_size,
-               "incorrect input_data.size() ", input_data.size(),
+  NGRAPH_CHECK(input.num_elements == parameter_size * m_batch_size,
+               "incorrect input size ", input.num_elements,
                ", expected  ", parameter_size * m_batch_size,
                " (parameter_size=", parameter_size,
                "), (batch_size=", m_batch_size, ")");
 
   shape = HETensor::unpack_shape(shape, m_batch_size);
-  auto element_type = element::f64;
+  // The tensor has the element type of the input, so it is read in place
+  const element::Type& element_type = input.element_type;
 
-  auto he_tensor = HETensor(
+  auto he_tensor = std::make_shared<HETensor>(
       element_type, shape, pb_tensor.packed(),
       m_encryption_params.complex_packing(), encrypt_tensor, *m_ckks_encoder,
       m_context, *m_encryptor, *m_decryptor, m_encryption_params, pb_name);
 
-  size_t num_bytes = parameter_size * sizeof(double) * m_batch_size;
-  NGRAPH_HE_LOG(3) << "Writing to tensor";
-  he_tensor.write(input_data.data(), num_bytes);
+#ifdef NGRAPH_HE_ABY_ENABLE
+  if (js.find("mpc_protocol") != js.end()) {
+    m_mpc_protocol = js.at("mpc_protocol");
+  }
+  // Connect to the garbled circuit parties while the inputs are encrypted
+  if (js.find("enable_gc") != js.end() &&
+      string_to_bool(std::string(js.at("enable_gc")))) {
+    NGRAPH_CHECK(js.find("num_aby_parties") != js.end(),
+                 "Number of ABY parties not specified");
+    size_t num_party_threads =
+        js.find("num_aby_party_threads") != js.end()
+            ? flag_to_int(std::string(js.at("num_aby_party_threads")))
+            : s_default_aby_party_threads;
+    init_aby_executor(flag_to_int(std::string(js.at("num_aby_parties"))),
+                      num_party_threads);
+    m_aby_executor->start_offline_phase();
+  }
+#endif
+
+  size_t num_bytes = parameter_size * element_type.size() * m_batch_size;
+  const seal::Encryptor* seeded_encryptor =
+      seeded ? m_secret_key_encryptor.get() : nullptr;
+
+  // The handle identifies the input values, so inference requests of other
+  // models refer to the same cached input
+  std::string cache_handle;
+  if (cache_input) {
+    std::stringstream handle_stream;
+    handle_stream << element_type << shape << pb_tensor.packed()
+                  << m_batch_size << complex_packing();
+    handle_stream.write(static_cast<const char*>(input.data),
+                        static_cast<std::streamsize>(num_bytes));
+    cache_handle = key_fingerprint(handle_stream.str());
+  }
+  // Pipelined inputs are uploaded before the server has the keys scoping
+  // its cache, so they are always uploaded
+  if (cache_input && !m_pipelined_inputs) {
+    NGRAPH_HE_LOG(3) << "Client referring to cached input " << cache_handle;
+    m_cached_input_upload = [this, he_tensor, &input, num_bytes,
+                             seeded_encryptor, cache_handle]() {
+      upload_input(*he_tensor, input, num_bytes, seeded_encryptor,
+                   cache_handle);
+    };
+    pb::TCPMessage pb_message;
+    pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+    json cached_js = {{"function", "CachedInput"},
+                      {"name", pb_name},
+                      {"handle", cache_handle}};
+    pb_message.mutable_function()->set_function(cached_js.dump());
+    write_message(TCPMessage(std::move(pb_message)));
+    return;
+  }
+  upload_input(*he_tensor, input, num_bytes, seeded_encryptor, cache_handle);
+}
+
+void HESealClient::upload_input(HETensor& he_tensor, const HEInputView& input,
+                                size_t num_bytes,
+                                const seal::Encryptor* seeded_encryptor,
+                                const std::string& cache_handle) {
+  HESealClientStats::ScopedTimer timer(m_stats, "input_encrypt");
+
+  // Encrypt and send the tensor in chunks, so the server loads earlier
+  // chunks while later chunks are encrypted. The first chunk holds a single
+  // element, whose serialized size sets the size of the remaining chunks
+  size_t num_elements = he_tensor.data().size();
+  size_t chunk_size = 1;
+  size_t begin = 0;
+  // An empty tensor is still sent as a single, empty chunk
+  do {
+    size_t end = std::min(begin + chunk_size, num_elements);
+    NGRAPH_HE_LOG(3) << "Writing elements [" << begin << ", " << end
+                     << ") to tensor";
+    he_tensor.write_elements(input.data, num_bytes, begin, end,
+                             seeded_encryptor, m_compr_mode);
+
+    std::vector<TCPMessage::Segments> segments;
+    auto saved_pb_tensors = he_tensor.write_elements_to_pb_tensors(
+        begin, end, &segments, m_compr_mode);
+    size_t chunk_bytes = 0;
+    for (size_t tensor_idx = 0; tensor_idx < saved_pb_tensors.size();
+         ++tensor_idx) {
+      if (!cache_handle.empty()) {
+        saved_pb_tensors[tensor_idx].set_cache_handle(cache_handle);
+      }
+      pb::TCPMessage inputs_msg;
+      inputs_msg.set_type(pb::TCPMessage_Type_REQUEST);
+      *inputs_msg.add_he_tensors() = std::move(saved_pb_tensors[tensor_idx]);
+      chunk_bytes += inputs_msg.ByteSize();
+      for (const auto& segment : segments[tensor_idx]) {
+        chunk_bytes += segment.size;
+      }
+
+      auto param_shape = inputs_msg.he_tensors(0).shape();
+      NGRAPH_HE_LOG(3) << "Client sending encrypted input with shape "
+                       << Shape{param_shape.begin(), param_shape.end()};
+      write_message(
+          TCPMessage(std::move(inputs_msg), std::move(segments[tensor_idx])));
+    }
 
-  NGRAPH_HE_LOG(3) << "Writing to pb tensors";
-  const auto& saved_pb_tensors = he_tensor.write_to_pb_tensors();
-  for (const auto& saved_pb_tensor : saved_pb_tensors) {
-    pb::TCPMessage inputs_msg;
-    inputs_msg.set_type(pb::TCPMessage_Type_REQUEST);
-    *inputs_msg.add_he_tensors() = saved_pb_tensor;
+    if (begin == 0) {
+      chunk_size = std::max<size_t>(1, s_upload_chunk_bytes / chunk_bytes);
+    }
+    begin = end;
+  } while (begin < num_elements);
+}
 
-    auto param_shape = inputs_msg.he_tensors(0).shape();
-    NGRAPH_HE_LOG(3) << "Client sending encrypted input with shape "
-                     << Shape{param_shape.begin(), param_shape.end()};
-    write_message(TCPMessage(std::move(inputs_msg)));
+void HESealClient::finish_input_upload() {
+  if (m_input_upload.valid()) {
+    m_input_upload.get();
   }
+  flush_pending_writes();
 }
 
-void HESealClient::handle_result(const pb::TCPMessage& message) {
+void HESealClient::flush_pending_writes() {
+  std::vector<std::pair<TCPMessage, size_t>> pending_writes;
+  {
+    std::lock_guard<std::mutex> guard(m_pending_writes_mutex);
+    pending_writes.swap(m_pending_writes);
+  }
+  for (auto& [message, trigger] : pending_writes) {
+    m_stats.add_sent(message);
+    if (m_capture != nullptr) {
+      m_capture->record_sent(message, trigger);
+    }
+    m_tcp_client->write_message(std::move(message));
+  }
+}
+
+void HESealClient::write_message(TCPMessage&& message, size_t trigger) {
+  if (m_offline) {
+    m_stats.add_sent(message);
+    m_tcp_client->write_message(std::move(message));
+    return;
+  }
+  if (!m_io_context.get_executor().running_in_this_thread()) {
+    {
+      std::lock_guard<std::mutex> guard(m_pending_writes_mutex);
+      m_pending_writes.emplace_back(std::move(message), trigger);
+    }
+    boost::asio::post(m_io_context, [this]() { flush_pending_writes(); });
+    return;
+  }
+  // Queued messages were written before this one
+  flush_pending_writes();
+  m_stats.add_sent(message);
+  if (m_capture != nullptr) {
+    m_capture->record_sent(message, trigger);
+  }
+  m_tcp_client->write_message(std::move(message));
+}
+
+std::vector<double> HESealClient::expand_compacted_result(
+    const std::vector<HEType>& packed, size_t compaction, size_t batch_size,
+    size_t element_count) {
+  NGRAPH_CHECK(packed.size() == ceil_div(element_count, compaction),
+               "Compacted result has ", packed.size(),
+               " ciphertexts, expected ", ceil_div(element_count, compaction));
+  for (const auto& he_type : packed) {
+    NGRAPH_CHECK(he_type.is_ciphertext(),
+                 "Compacted result is not a ciphertext");
+  }
+  // Batch j of element i follows the layout of HETensor::read
+  std::vector<double> results(element_count * batch_size);
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t packed_idx = 0; packed_idx < packed.size(); ++packed_idx) {
+    const HEType& he_type = packed[packed_idx];
+    HEPlaintext plain;
+    decrypt(plain, *he_type.get_ciphertext(), he_type.complex_packing(),
+            *m_decryptor, *m_ckks_encoder, m_context,
+            batch_size * compaction);
+    size_t first_element = packed_idx * compaction;
+    size_t count = std::min(compaction, element_count - first_element);
+    for (size_t offset = 0; offset < count; ++offset) {
+      for (size_t j = 0; j < batch_size; ++j) {
+        results[j * element_count + first_element + offset] =
+            plain[offset * batch_size + j];
+      }
+    }
+  }
+  return results;
+}
+
+void HESealClient::handle_result(const TCPMessage& message) {
   NGRAPH_HE_LOG(3) << "Client handling result";
+  HESealClientStats::ScopedTimer timer(m_stats, "result_decrypt");
+  const pb::TCPMessage& pb_message = *message.pb_message();
 
-  NGRAPH_CHECK(message.he_tensors_size() > 0,
+  NGRAPH_CHECK(pb_message.he_tensors_size() > 0,
                "Client received result with no tensors");
-  NGRAPH_CHECK(message.he_tensors_size() == 1,
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
                "Client supports only results with one tensor");
 
-  const auto& pb_tensor = message.he_tensors(0);
+  // Servers which stream several results index them
+  size_t result_idx = 0;
+  size_t result_count = 1;
+  json js = json::object();
+  if (pb_message.has_function()) {
+    js = json::parse(pb_message.function().function());
+    result_idx = js.value("index", 0UL);
+    result_count = js.value("count", 1UL);
+  }
+  NGRAPH_CHECK(result_idx < result_count, "Invalid result index ",
+               result_idx, " of ", result_count);
+
+  const auto& pb_tensor = pb_message.he_tensors(0);
+  std::shared_ptr<HETensor> result_tensor;
+  {
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    if (m_result_tensors.size() != result_count) {
+      m_result_tensors.resize(result_count);
+      m_output_results.resize(result_count);
+      m_results_done.resize(result_count, false);
+    }
+    result_tensor = m_result_tensors[result_idx];
+  }
 
-  if (m_result_tensor == nullptr) {
-    m_result_tensor = HETensor::load_from_pb_tensor(
+  if (result_tensor == nullptr) {
+    result_tensor = HETensor::load_from_pb_tensor(
         pb_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-        m_encryption_params);
+        m_encryption_params, message.payload(), message.payload_size());
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    m_result_tensors[result_idx] = result_tensor;
   } else {
-    HETensor::load_from_pb_tensor(m_result_tensor, pb_tensor, m_context);
+    HETensor::load_from_pb_tensor(result_tensor, pb_tensor, m_context,
+                                  message.payload(), message.payload_size());
   }
 
-  if (m_result_tensor->done_loading()) {
+  if (!result_tensor->done_loading()) {
+    return;
+  }
+  std::vector<double> results;
+  Shape result_shape = result_tensor->get_shape();
+  if (js.contains("compaction")) {
+    // The server packed several result ciphertexts into each ciphertext
+    result_shape = js.at("shape").get<std::vector<size_t>>();
+    results = expand_compacted_result(
+        result_tensor->data(), js.at("compaction"), js.at("batch_size"),
+        js.at("element_count"));
+  } else {
     size_t data_size =
-        m_result_tensor->data().size() * m_result_tensor->get_batch_size();
-    m_results.resize(data_size);
-    const auto& type = m_result_tensor->get_element_type();
-    size_t num_bytes = data_size * type.size();
-    auto bytes = ngraph_malloc(num_bytes);
-
-    m_result_tensor->read(bytes, num_bytes);
-
-    for (size_t i = 0; i < data_size; ++i) {
-      void* addr =
-          static_cast<void*>(static_cast<char*>(bytes) + i * type.size());
-      m_results[i] = type_to_double(addr, type);
-    }
+        result_tensor->data().size() * result_tensor->get_batch_size();
+    results.resize(data_size);
+    result_tensor->read(results.data(), data_size * sizeof(double),
+                        element::f64);
+  }
+  // The epilogue follows the function's only result
+  if (!m_epilogue.empty()) {
+    apply_epilogue(m_epilogue, results, result_shape);
+  }
 
-    ngraph_free(bytes);
+  timer.stop();
+
+  bool all_done = false;
+  {
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    m_output_results[result_idx] = std::move(results);
+    m_results_done[result_idx] = true;
+    all_done = std::all_of(m_results_done.begin(), m_results_done.end(),
+                           [](bool done) { return done; });
+    m_is_done_cond.notify_all();
+  }
+  NGRAPH_HE_LOG(3) << "Client decrypted result " << result_idx << " of "
+                   << result_count;
+  if (all_done && !m_session_persistent) {
     close_connection();
+  } else if (all_done) {
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    m_is_done = true;
+    m_is_done_cond.notify_all();
   }
 }
 
-void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
+TCPMessage HESealClient::handle_relu_request(const TCPMessage& message) {
   NGRAPH_HE_LOG(3) << "Client handling relu request";
+  pb::TCPMessage& pb_message = *message.pb_message();
 
-  NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function");
-  NGRAPH_CHECK(message.he_tensors_size() > 0,
+  // Requests with garbled circuits carry a function instead of an op request
+  bool enable_gc = !pb_message.has_op_request();
+  NGRAPH_CHECK(!enable_gc || pb_message.has_function(),
+               "Proto message doesn't have function");
+  NGRAPH_CHECK(pb_message.he_tensors_size() > 0,
                "Client received result with no tensors");
-  NGRAPH_CHECK(message.he_tensors_size() == 1,
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
                "Client supports only relu requests with one tensor");
 
-  message.set_type(pb::TCPMessage_Type_RESPONSE);
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
 
-  pb::HETensor* pb_tensor = message.mutable_he_tensors(0);
+  pb::HETensor* pb_tensor = pb_message.mutable_he_tensors(0);
+  HESealClientStats::ScopedTimer load_timer(m_stats, "relu_load");
   auto he_tensor = HETensor::load_from_pb_tensor(
       *pb_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-      m_encryption_params);
-
-  const std::string& function = message.function().function();
-  const json& js = json::parse(function);
-
-  bool enable_gc = string_to_bool(std::string(js.at("enable_gc")));
+      m_encryption_params, message.payload(), message.payload_size());
+  load_timer.stop();
 
+  HESealClientStats::ScopedTimer compute_timer(m_stats, "relu");
   if (enable_gc) {
 #ifdef NGRAPH_HE_ABY_ENABLE
     NGRAPH_HE_LOG(3) << "Client relu with GC";
+    const std::string& function = pb_message.function().function();
+    const json& js = json::parse(function);
     NGRAPH_CHECK(js.find("num_aby_parties") != js.end(),
                  "Number of ABY parties not specified");
     size_t num_aby_parties = flag_to_int(std::string(js["num_aby_parties"]));
@@ -299,48 +1103,148 @@ void HESealClient::handle_relu_request(pb::TCPMessage&& message) {
 #endif
   } else {
     size_t result_count = pb_tensor->data_size();
-#pragma omp parallel for
+    auto parms_id = reencryption_parms_id(pb_message.op_request(), m_context);
+#pragma omp parallel
+    {
+      HECodecScratch scratch;
+#pragma omp for
+      for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+        scalar_relu_seal(he_tensor->data(result_idx),
+                         he_tensor->data(result_idx), parms_id, scale(),
+                         *m_ckks_encoder, *m_encryptor, *m_decryptor,
+                         m_context, scratch);
+      }
+    }
+  }
+
+  compute_timer.stop();
+  HESealClientStats::ScopedTimer write_timer(m_stats, "relu_write");
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_output_tensors =
+      he_tensor->write_to_pb_tensors(&segments, m_compr_mode);
+
+  NGRAPH_CHECK(pb_output_tensors.size() == 1,
+               "Only support single-output tensors");
+  *pb_tensor = std::move(pb_output_tensors[0]);
+
+  return TCPMessage(std::move(pb_message), std::move(segments[0]));
+}
+
+TCPMessage HESealClient::handle_refresh_request(const TCPMessage& message) {
+  NGRAPH_HE_LOG(3) << "Client handling refresh request";
+  pb::TCPMessage& pb_message = *message.pb_message();
+
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+               "Client supports only refresh requests with one tensor");
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+
+  pb::HETensor* pb_tensor = pb_message.mutable_he_tensors(0);
+  HESealClientStats::ScopedTimer load_timer(m_stats, "refresh_load");
+  auto he_tensor = HETensor::load_from_pb_tensor(
+      *pb_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
+      m_encryption_params, message.payload(), message.payload_size());
+  load_timer.stop();
+
+  HESealClientStats::ScopedTimer compute_timer(m_stats, "refresh");
+  size_t result_count = pb_tensor->data_size();
+  auto parms_id = reencryption_parms_id(pb_message.op_request(), m_context);
+#pragma omp parallel
+  {
+    HECodecScratch scratch;
+#pragma omp for
     for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-      scalar_relu_seal(he_tensor->data(result_idx), he_tensor->data(result_idx),
-                       m_context->first_parms_id(), scale(), *m_ckks_encoder,
-                       *m_encryptor, *m_decryptor, m_context);
+      scalar_refresh_seal(he_tensor->data(result_idx),
+                          he_tensor->data(result_idx), parms_id, scale(),
+                          *m_ckks_encoder, *m_encryptor, *m_decryptor,
+                          m_context, scratch);
     }
   }
 
-  const auto pb_output_tensors = he_tensor->write_to_pb_tensors();
+  compute_timer.stop();
+  HESealClientStats::ScopedTimer write_timer(m_stats, "refresh_write");
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_output_tensors =
+      he_tensor->write_to_pb_tensors(&segments, m_compr_mode);
+  NGRAPH_CHECK(pb_output_tensors.size() == 1,
+               "Only support single-output tensors");
+  *pb_tensor = std::move(pb_output_tensors[0]);
+
+  return TCPMessage(std::move(pb_message), std::move(segments[0]));
+}
 
+TCPMessage HESealClient::handle_elementwise_request(
+    const TCPMessage& message) {
+  pb::TCPMessage& pb_message = *message.pb_message();
+  const std::string& function_name = pb_message.op_request().function();
+  NGRAPH_HE_LOG(3) << "Client handling " << function_name << " request";
+  ElementwiseFunction function = client_elementwise_function(function_name);
+  NGRAPH_CHECK(function != nullptr, "Client does not compute ", function_name);
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+               "Client supports only elementwise requests with one tensor");
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+
+  pb::HETensor* pb_tensor = pb_message.mutable_he_tensors(0);
+  HESealClientStats::ScopedTimer load_timer(m_stats, "elementwise_load");
+  auto he_tensor = HETensor::load_from_pb_tensor(
+      *pb_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
+      m_encryption_params, message.payload(), message.payload_size());
+  load_timer.stop();
+
+  HESealClientStats::ScopedTimer compute_timer(m_stats, "elementwise");
+  size_t result_count = pb_tensor->data_size();
+  auto parms_id = reencryption_parms_id(pb_message.op_request(), m_context);
+#pragma omp parallel
+  {
+    HECodecScratch scratch;
+#pragma omp for
+    for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+      scalar_elementwise_seal(he_tensor->data(result_idx),
+                              he_tensor->data(result_idx), function, parms_id,
+                              scale(), *m_ckks_encoder, *m_encryptor,
+                              *m_decryptor, m_context, scratch);
+    }
+  }
+
+  compute_timer.stop();
+  HESealClientStats::ScopedTimer write_timer(m_stats, "elementwise_write");
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_output_tensors =
+      he_tensor->write_to_pb_tensors(&segments, m_compr_mode);
   NGRAPH_CHECK(pb_output_tensors.size() == 1,
                "Only support single-output tensors");
-  *pb_tensor = pb_output_tensors[0];
+  *pb_tensor = std::move(pb_output_tensors[0]);
 
-  write_message(TCPMessage(std::move(message)));
+  return TCPMessage(std::move(pb_message), std::move(segments[0]));
 }
 
-void HESealClient::handle_bounded_relu_request(pb::TCPMessage&& message) {
+TCPMessage HESealClient::handle_bounded_relu_request(
+    const TCPMessage& message) {
   NGRAPH_HE_LOG(3) << "Client handling bounded relu request";
+  pb::TCPMessage& pb_message = *message.pb_message();
 
-  NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function");
-  NGRAPH_CHECK(message.he_tensors_size() > 0,
+  bool enable_gc = !pb_message.has_op_request();
+  NGRAPH_CHECK(!enable_gc || pb_message.has_function(),
+               "Proto message doesn't have function");
+  NGRAPH_CHECK(pb_message.he_tensors_size() > 0,
                "Client received result with no tensors");
-  NGRAPH_CHECK(message.he_tensors_size() == 1,
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
                "Client supports only relu requests with one tensor");
 
-  const std::string& function = message.function().function();
-  json js = json::parse(function);
-  double bound = js.at("bound");
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
 
-  message.set_type(pb::TCPMessage_Type_RESPONSE);
-
-  pb::HETensor* pb_tensor = message.mutable_he_tensors(0);
+  pb::HETensor* pb_tensor = pb_message.mutable_he_tensors(0);
+  HESealClientStats::ScopedTimer load_timer(m_stats, "bounded_relu_load");
   auto he_tensor = HETensor::load_from_pb_tensor(
       *pb_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-      m_encryption_params);
-
-  bool enable_gc = string_to_bool(std::string(js.at("enable_gc")));
+      m_encryption_params, message.payload(), message.payload_size());
+  load_timer.stop();
 
+  HESealClientStats::ScopedTimer compute_timer(m_stats, "bounded_relu");
   if (enable_gc) {
 #ifdef NGRAPH_HE_ABY_ENABLE
     NGRAPH_HE_LOG(3) << "Client bounded relu with GC";
+    const std::string& function = pb_message.function().function();
+    json js = json::parse(function);
     NGRAPH_CHECK(js.find("num_aby_parties") != js.end(),
                  "Number of ABY parties not specified");
     size_t num_aby_parties = flag_to_int(std::string(js["num_aby_parties"]));
@@ -350,32 +1254,41 @@ void HESealClient::handle_bounded_relu_request(pb::TCPMessage&& message) {
 #endif
   } else {
     size_t result_count = pb_tensor->data_size();
+    double bound = pb_message.op_request().bound();
+    auto parms_id = reencryption_parms_id(pb_message.op_request(), m_context);
 #pragma omp parallel for
     for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-      scalar_bounded_relu_seal(
-          he_tensor->data(result_idx), he_tensor->data(result_idx), bound,
-          m_context->first_parms_id(), scale(), *m_ckks_encoder, *m_encryptor,
-          *m_decryptor, m_context);
+      scalar_bounded_relu_seal(he_tensor->data(result_idx),
+                               he_tensor->data(result_idx), bound, parms_id,
+                               scale(), *m_ckks_encoder, *m_encryptor,
+                               *m_decryptor, m_context);
     }
   }
-  const auto& pb_output_tensors = he_tensor->write_to_pb_tensors();
+  compute_timer.stop();
+  HESealClientStats::ScopedTimer write_timer(m_stats, "bounded_relu_write");
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_output_tensors =
+      he_tensor->write_to_pb_tensors(&segments, m_compr_mode);
   NGRAPH_CHECK(pb_output_tensors.size() == 1,
                "Only support single-output tensors");
-  *pb_tensor = pb_output_tensors[0];
+  *pb_tensor = std::move(pb_output_tensors[0]);
 
-  write_message(TCPMessage(std::move(message)));
+  return TCPMessage(std::move(pb_message), std::move(segments[0]));
 }
 
-void HESealClient::handle_max_pool_request(pb::TCPMessage&& message) {
+TCPMessage HESealClient::handle_max_pool_request(const TCPMessage& message) {
   NGRAPH_HE_LOG(3) << "Client handling maxpool request";
+  pb::TCPMessage& pb_message = *message.pb_message();
 
-  NGRAPH_CHECK(message.has_function(), "Proto message doesn't have function ");
-  NGRAPH_CHECK(message.he_tensors_size() > 0,
+  bool enable_gc = !pb_message.has_op_request();
+  NGRAPH_CHECK(!enable_gc || pb_message.has_function(),
+               "Proto message doesn't have function ");
+  NGRAPH_CHECK(pb_message.he_tensors_size() > 0,
                " Client received result with no tensors ");
-  NGRAPH_CHECK(message.he_tensors_size() == 1,
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
                "Client supports only max pool requests with one tensor");
 
-  pb::HETensor* pb_tensor = message.mutable_he_tensors(0);
+  pb::HETensor* pb_tensor = pb_message.mutable_he_tensors(0);
   size_t cipher_count = pb_tensor->data_size();
 
   std::vector<HEType> max_pool_ciphers(
@@ -383,35 +1296,119 @@ void HESealClient::handle_max_pool_request(pb::TCPMessage&& message) {
   std::vector<HEType> post_max_pool_ciphers(
       {HEType(HEPlaintext(m_batch_size), false)});
 
+  HESealClientStats::ScopedTimer load_timer(m_stats, "max_pool_load");
   auto he_tensor = HETensor::load_from_pb_tensor(
       *pb_tensor, *m_ckks_encoder, m_context, *m_encryptor, *m_decryptor,
-      m_encryption_params);
+      m_encryption_params, message.payload(), message.payload_size());
+  load_timer.stop();
+
+  const std::string& function = pb_message.function().function();
+  json js = enable_gc ? json::parse(function) : json();
+
+  size_t num_outputs =
+      enable_gc ? flag_to_int(std::string(js.at("num_outputs")))
+                : std::max<size_t>(pb_message.op_request().num_outputs(), 1);
+  NGRAPH_CHECK(cipher_count % num_outputs == 0, "Max pool request with ",
+               cipher_count, " ciphertexts has no ", num_outputs,
+               " windows of equal size");
+  auto post_max_he_tensor = HETensor(
+      he_tensor->get_element_type(), Shape{m_batch_size, num_outputs},
+      he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
+      m_context, *m_encryptor, *m_decryptor, m_encryption_params);
+
+  HESealClientStats::ScopedTimer compute_timer(m_stats, "max_pool");
+  if (enable_gc) {
+#ifdef NGRAPH_HE_ABY_ENABLE
+    NGRAPH_HE_LOG(3) << "Client max pool with GC";
+    NGRAPH_CHECK(js.find("num_aby_parties") != js.end(),
+                 "Number of ABY parties not specified");
+    init_aby_executor(flag_to_int(std::string(js.at("num_aby_parties"))));
+    m_aby_executor->run_aby_max_pool_circuit(function, he_tensor,
+                                             post_max_he_tensor);
+#endif
+  } else {
+    // Ciphertext j of window i is at index j * num_outputs + i
+    max_seal(he_tensor->data(), post_max_he_tensor.data(),
+             Shape{cipher_count / num_outputs, num_outputs},
+             Shape{num_outputs}, AxisSet{0}, m_batch_size,
+             reencryption_parms_id(pb_message.op_request(), m_context),
+             scale(), *m_ckks_encoder, *m_encryptor, *m_decryptor, m_context,
+             pb_message.op_request().relu());
+  }
 
-  // We currently just support max_pool with single output
-  auto post_max_he_tensor =
-      HETensor(he_tensor->get_element_type(), Shape{m_batch_size, 1},
-               he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
-               m_context, *m_encryptor, *m_decryptor, m_encryption_params);
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+  pb_message.clear_he_tensors();
 
-  max_pool_seal(he_tensor->data(), post_max_he_tensor.data(),
-                Shape{1, 1, cipher_count}, Shape{1, 1, 1}, Shape{cipher_count},
-                Strides{1}, Shape{0}, Shape{0}, m_context->first_parms_id(),
-                scale(), *m_ckks_encoder, *m_encryptor, *m_decryptor,
-                m_context);
+  compute_timer.stop();
+  HESealClientStats::ScopedTimer write_timer(m_stats, "max_pool_write");
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_output_tensors =
+      post_max_he_tensor.write_to_pb_tensors(&segments, m_compr_mode);
+  NGRAPH_CHECK(pb_output_tensors.size() == 1,
+               "Only support single-output tensors");
 
-  message.set_type(pb::TCPMessage_Type_RESPONSE);
-  message.clear_he_tensors();
+  *pb_message.add_he_tensors() = std::move(pb_output_tensors[0]);
+  return TCPMessage(std::move(pb_message), std::move(segments[0]));
+}
+
+void HESealClient::handle_dot_relu_request(const TCPMessage& message) {
+  NGRAPH_HE_LOG(3) << "Client handling dot relu request";
+  pb::TCPMessage& pb_message = *message.pb_message();
+
+  NGRAPH_CHECK(pb_message.has_function(),
+               "Proto message doesn't have function ");
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+               "Client supports only dot relu requests with one tensor");
+
+  HESealClientStats::ScopedTimer load_timer(m_stats, "dot_relu_load");
+  auto he_tensor = HETensor::load_from_pb_tensor(
+      pb_message.he_tensors(0), *m_ckks_encoder, m_context, *m_encryptor,
+      *m_decryptor, m_encryption_params, message.payload(),
+      message.payload_size());
+  load_timer.stop();
+
+  const std::string& function = pb_message.function().function();
+  const json& js = json::parse(function);
+  size_t output_size = flag_to_int(std::string(js.at("output_size")));
+  auto output_tensor = HETensor(
+      he_tensor->get_element_type(), Shape{m_batch_size, output_size},
+      he_tensor->is_packed(), complex_packing(), true, *m_ckks_encoder,
+      m_context, *m_encryptor, *m_decryptor, m_encryption_params);
+
+  HESealClientStats::ScopedTimer compute_timer(m_stats, "dot_relu");
+#ifdef NGRAPH_HE_ABY_ENABLE
+  NGRAPH_CHECK(js.find("num_aby_parties") != js.end(),
+               "Number of ABY parties not specified");
+  init_aby_executor(flag_to_int(std::string(js.at("num_aby_parties"))));
+  m_aby_executor->run_aby_dot_relu_circuit(function, he_tensor,
+                                           output_tensor);
+#else
+  NGRAPH_CHECK(false, "Dot relu requests require ABY");
+#endif
+
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+  pb_message.clear_he_tensors();
 
-  const auto& pb_output_tensors = post_max_he_tensor.write_to_pb_tensors();
+  compute_timer.stop();
+  HESealClientStats::ScopedTimer write_timer(m_stats, "dot_relu_write");
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_output_tensors =
+      output_tensor.write_to_pb_tensors(&segments, m_compr_mode);
   NGRAPH_CHECK(pb_output_tensors.size() == 1,
                "Only support single-output tensors");
 
-  *message.add_he_tensors() = pb_output_tensors[0];
-  write_message(TCPMessage(std::move(message)));
+  *pb_message.add_he_tensors() = std::move(pb_output_tensors[0]);
+  write_message(TCPMessage(std::move(pb_message), std::move(segments[0])));
 }
 
 void HESealClient::handle_message(const TCPMessage& message) {
   NGRAPH_HE_LOG(3) << "Client handling message";
+  // Messages of the server are answered after the pipelined inputs
+  finish_input_upload();
+  m_stats.add_received(message);
+  if (m_capture != nullptr) {
+    m_message_index = m_capture->record_received(message);
+  }
 
   std::shared_ptr<pb::TCPMessage> pb_msg = message.pb_message();
 
@@ -422,13 +1419,38 @@ void HESealClient::handle_message(const TCPMessage& message) {
       if (pb_msg->has_encryption_parameters()) {
         handle_encryption_parameters_response(*pb_msg);
       } else if (pb_msg->he_tensors_size() > 0) {
-        handle_result(*pb_msg);
+        handle_result(message);
       } else {
         NGRAPH_CHECK(false, "Unknown RESPONSE type");
       }
       break;
     }
     case pb::TCPMessage_Type_REQUEST: {
+      if (pb_msg->has_op_request()) {
+        switch (pb_msg->op_request().op()) {
+          case pb::OpRequest_Op_RELU:
+            dispatch_request(message, &HESealClient::handle_relu_request);
+            break;
+          case pb::OpRequest_Op_BOUNDED_RELU:
+            dispatch_request(message,
+                             &HESealClient::handle_bounded_relu_request);
+            break;
+          case pb::OpRequest_Op_MAX_POOL:
+            dispatch_request(message, &HESealClient::handle_max_pool_request);
+            break;
+          case pb::OpRequest_Op_REFRESH:
+            dispatch_request(message, &HESealClient::handle_refresh_request);
+            break;
+          case pb::OpRequest_Op_ELEMENTWISE:
+            dispatch_request(message,
+                             &HESealClient::handle_elementwise_request);
+            break;
+          default:
+            NGRAPH_CHECK(false, "Unknown op request ",
+                         pb_msg->op_request().op());
+        }
+        break;
+      }
       NGRAPH_CHECK(pb_msg->has_function(), "Unknown request type");
 
       const std::string& function = pb_msg->function().function();
@@ -437,19 +1459,48 @@ void HESealClient::handle_message(const TCPMessage& message) {
 
       // TODO(fboemer): Move to any_of in message.proto
       static std::unordered_set<std::string> s_known_names{
-          "Parameter", "Relu", "BoundedRelu", "MaxPool"};
+          "Parameter", "Relu", "BoundedRelu", "MaxPool", "DotRelu", "Keys",
+          "Model", "Ping", "CachedInputMiss"};
 
       NGRAPH_CHECK(s_known_names.find(name) != s_known_names.end(),
                    "Unknown name ", name);
 
-      if (name == "Parameter") {
+      if (name == "Parameter" && m_session_persistent &&
+          m_num_inferences > 0) {
+        // Requests the inputs of the next inference, see infer
+        m_next_request = std::make_shared<pb::TCPMessage>(*pb_msg);
+        upload_next_inputs();
+      } else if (name == "Parameter") {
+        if (m_pipelined_inputs) {
+          send_pipeline_reset();
+          m_pipelined_inputs = false;
+        }
+        save_session(*pb_msg);
         handle_inference_request(*pb_msg);
       } else if (name == "Relu") {
-        handle_relu_request(std::move(*pb_msg));
+        dispatch_request(message, &HESealClient::handle_relu_request);
       } else if (name == "BoundedRelu") {
-        handle_bounded_relu_request(std::move(*pb_msg));
+        dispatch_request(message, &HESealClient::handle_bounded_relu_request);
       } else if (name == "MaxPool") {
-        handle_max_pool_request(std::move(*pb_msg));
+        dispatch_request(message, &HESealClient::handle_max_pool_request);
+      } else if (name == "DotRelu") {
+        handle_dot_relu_request(message);
+      } else if (name == "Keys") {
+        send_public_and_relin_keys();
+      } else if (name == "Model") {
+        send_model_name();
+      } else if (name == "CachedInputMiss") {
+        NGRAPH_CHECK(m_cached_input_upload != nullptr,
+                     "Server requested an input which is not cached");
+        auto upload = std::move(m_cached_input_upload);
+        m_cached_input_upload = nullptr;
+        upload();
+      } else if (name == "Ping") {
+        // The server times the echo to choose the mpc protocol
+        pb::TCPMessage pong;
+        pong.set_type(pb::TCPMessage_Type_RESPONSE);
+        pong.mutable_function()->set_function(function);
+        write_message(TCPMessage(std::move(pong)));
       }
       break;
     }
@@ -460,17 +1511,67 @@ void HESealClient::handle_message(const TCPMessage& message) {
 #pragma clang diagnostic pop
 }
 
-std::vector<double> HESealClient::get_results() {
+void HESealClient::clear_results() {
+  std::lock_guard<std::mutex> guard(m_is_done_mutex);
+  m_result_tensors.clear();
+  m_output_results.clear();
+  m_results_done.clear();
+  m_is_done = false;
+}
+
+std::vector<double> HESealClient::get_results() { return get_results_ref(); }
+
+const std::vector<double>& HESealClient::get_results_ref() {
   NGRAPH_INFO << "Client waiting for results";
 
   std::unique_lock<std::mutex> mlock(m_is_done_mutex);
   m_is_done_cond.wait(mlock, [this]() { return this->is_done(); });
-  return m_results;
+  // A server which closed the connection early sent no values
+  if (m_output_results.empty()) {
+    m_output_results.resize(1);
+  }
+  return m_output_results[0];
+}
+
+const std::vector<double>& HESealClient::get_results_ref(size_t result_idx) {
+  NGRAPH_HE_LOG(3) << "Client waiting for result " << result_idx;
+
+  std::unique_lock<std::mutex> mlock(m_is_done_mutex);
+  m_is_done_cond.wait(mlock, [this, result_idx]() {
+    return (result_idx < m_results_done.size() &&
+            m_results_done[result_idx]) ||
+           this->is_done();
+  });
+  NGRAPH_CHECK(result_idx < m_output_results.size(), "Server sent no result ",
+               result_idx);
+  return m_output_results[result_idx];
 }
 
 void HESealClient::close_connection() {
+  {
+    std::lock_guard<std::mutex> guard(m_is_done_mutex);
+    if (m_closed) {
+      return;
+    }
+    m_closed = true;
+  }
   NGRAPH_HE_LOG(5) << "Closing connection";
-  m_tcp_client->close();
+  if (m_persistent) {
+    // Written from the I/O thread, before the transport closes
+    boost::asio::post(m_io_context, [this]() {
+      finish_input_upload();
+      if (m_session_persistent) {
+        pb::TCPMessage message;
+        message.set_type(pb::TCPMessage_Type_RESPONSE);
+        json js = {{"function", "EndSession"}};
+        message.mutable_function()->set_function(js.dump());
+        write_message(TCPMessage(std::move(message)));
+      }
+      m_tcp_client->close();
+    });
+  } else {
+    m_tcp_client->close();
+  }
 
   std::lock_guard<std::mutex> guard(m_is_done_mutex);
   m_is_done = true;
@@ -16,10 +16,15 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -30,10 +35,15 @@
 #include "boost/asio.hpp"
 #include "he_tensor.hpp"
 #include "he_util.hpp"
+#include "nlohmann/json.hpp"
+#include "seal/he_seal_client_stats.hpp"
 #include "seal/he_seal_encryption_parameters.hpp"
 #include "seal/seal.h"
+#include "seal/seal_zero_pool.hpp"
+#include "tcp/tcp_capture.hpp"
 #include "tcp/tcp_client.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/transport.hpp"
 
 namespace ngraph::runtime::aby {
 class ABYClientExecutor;
@@ -45,6 +55,25 @@ template <class T>
 using HETensorConfigMap =
     std::unordered_map<std::string, std::pair<std::string, std::vector<T>>>;
 
+/// \brief Input tensor data which the client reads in place, without
+/// copying it. See HESealMappedInput for inputs read from files
+struct HEInputView {
+  /// \brief 'encrypt', 'encrypt_seeded', or 'plain'. Encrypted inputs with a
+  /// ',cached' suffix, e.g. 'encrypt,cached', are cached by servers with the
+  /// input_cache_mb option, and only uploaded if the server has not cached
+  /// them for the client's keys
+  std::string config;
+  /// \brief Type of the elements at data
+  element::Type element_type{element::f64};
+  /// \brief Elements in row-major order, including the batch axis
+  const void* data{nullptr};
+  /// \brief Number of elements at data
+  size_t num_elements{0};
+};
+
+/// (tensor_name : input view)
+using HEInputViewMap = std::unordered_map<std::string, HEInputView>;
+
 /// \brief Class representing a data owner. The client provides encrypted values
 /// to a server and receives the encrypted result. The client may also aid in
 /// the computation, for example by computing activation functions the sever
@@ -56,7 +85,9 @@ class HESealClient {
   /// \param[in] port Port of the server
   /// \param[in] batch_size Batch size of the inference to perform
   /// \param[in] inputs Input data as a map from tensor name to pair of
-  /// ('encrypt', inputs) or ('plain', inputs)
+  /// ('encrypt', inputs), ('encrypt_seeded', inputs), or ('plain', inputs).
+  /// 'encrypt_seeded' uses secret-key encryption, which roughly halves the
+  /// size of the uploaded ciphertexts
   HESealClient(const std::string& hostname, const size_t port,
                const size_t batch_size,
                const HETensorConfigMap<double>& inputs);
@@ -78,9 +109,70 @@ class HESealClient {
                const size_t batch_size,
                const HETensorConfigMap<int64_t>& inputs);
 
-  /// \brief Creates SEAL context
+  /// \brief Constructs a client object and connects to a server. The inputs
+  /// are encrypted directly from the given buffers
+  /// \param[in] hostname Hostname of the server
+  /// \param[in] port Port of the server
+  /// \param[in] batch_size Batch size of the inference to perform
+  /// \param[in] inputs Input data as a map from tensor name to view. The
+  /// viewed data must remain valid until the constructor returns, which is
+  /// once the server sent the result
+  HESealClient(const std::string& hostname, const size_t port,
+               const size_t batch_size, const HEInputViewMap& inputs);
+
+  /// \brief Constructs a client which is not connected to a server, e.g. to
+  /// benchmark the client. Creates the SEAL context and keys of the
+  /// encryption parameters. Messages of the server are handled by calling
+  /// the handlers, e.g. handle_relu_request, and the client's messages are
+  /// written to the transport from the calling thread
+  /// \param[in] encryption_params Encryption parameters of the keys
+  /// \param[in] batch_size Batch size of the inference to perform
+  /// \param[in] inputs Input data as a map from tensor name to view, see
+  /// handle_inference_request. The viewed data must remain valid for the
+  /// lifetime of the client
+  /// \param[in] transport Transport the client writes its messages to
+  HESealClient(const HESealEncryptionParameters& encryption_params,
+               const size_t batch_size, const HEInputViewMap& inputs,
+               std::unique_ptr<ClientTransport> transport);
+
+  /// \brief Ends the session and closes the connection, if still open
+  ~HESealClient();
+
+  /// \brief Runs another inference in a persistent session, with the keys
+  /// of the first inference. Sessions are persistent if the
+  /// NGRAPH_HE_CLIENT_PERSISTENT environment variable is set when the client
+  /// is constructed, in which case the constructor returns once the first
+  /// results are decrypted, and the connection stays open until
+  /// close_connection
+  /// \param[in] inputs Input data, with the shapes of the first inference.
+  /// The viewed data must remain valid until the results are returned
+  /// \returns The decrypted values of the first result, valid until the next
+  /// inference
+  /// \throws ngraph_error if the session is not persistent, or the
+  /// connection was closed
+  const std::vector<double>& infer(const HEInputViewMap& inputs);
+
+  /// \brief Creates SEAL context and the client keys but the
+  /// evaluation keys, see generate_eval_keys. If the
+  /// NGRAPH_HE_CLIENT_KEY_FILE environment variable is set, keys are loaded
+  /// from that file, or generated and saved to it if it cannot be loaded.
+  /// \warning The file stores the secret key
   void set_seal_context();
 
+  /// \brief Generates the relinearization keys, unless loaded from the key
+  /// file, and saves the keys to the key file, if any. Also generates the
+  /// Galois keys requested by the server, which are not saved. Inputs are
+  /// encrypted with the public key alone, so they may be encrypted meanwhile
+  void generate_eval_keys();
+
+  /// \brief Loads the keys from the key file
+  /// \returns True if keys valid for the current context were loaded
+  bool load_keys();
+
+  /// \brief Saves the keys to the key file, if any. The file is replaced by
+  /// a file created with owner-only permissions
+  void save_keys() const;
+
   /// \brief Processes a message from the server
   /// \param[in] message Message to process
   void handle_message(const ngraph::runtime::he::TCPMessage& message);
@@ -91,41 +183,157 @@ class HESealClient {
 
   /// \brief Processes a request to perform ReLU function
   /// \param[in] message Message to process
-  void handle_relu_request(pb::TCPMessage&& message);
+  /// \returns Response to the request
+  TCPMessage handle_relu_request(const TCPMessage& message);
 
   /// \brief Processes a request to perform MaxPool function
   /// \param[in] message Message to process
-  void handle_max_pool_request(pb::TCPMessage&& message);
+  /// \returns Response to the request
+  TCPMessage handle_max_pool_request(const TCPMessage& message);
+
+  /// \brief Processes a request to perform a Dot followed by ReLU in ABY
+  /// arithmetic sharing
+  /// \param[in] message Message to process
+  void handle_dot_relu_request(const TCPMessage& message);
 
   /// \brief Processes a request to perform BoundedReLU function
   /// \param[in] message Message to process
-  void handle_bounded_relu_request(pb::TCPMessage&& message);
+  /// \returns Response to the request
+  TCPMessage handle_bounded_relu_request(const TCPMessage& message);
+
+  /// \brief Processes a request to re-encrypt masked values at the requested
+  /// level
+  /// \param[in] message Message to process
+  /// \returns Response to the request
+  TCPMessage handle_refresh_request(const TCPMessage& message);
+
+  /// \brief Processes a request to apply an elementwise function, e.g.
+  /// Sigmoid, to each value, see client_elementwise_function
+  /// \param[in] message Message to process
+  /// \returns Response to the request
+  TCPMessage handle_elementwise_request(const TCPMessage& message);
+
+  /// \brief Decrypts a result whose ciphertexts each pack the batch slots
+  /// of compaction result ciphertexts, see compact_slots_seal
+  /// \param[in] packed Packed ciphertexts
+  /// \param[in] compaction Number of result values per packed ciphertext
+  /// \param[in] batch_size Batch size of each result value
+  /// \param[in] element_count Number of values of the result
+  /// \returns Result values in the layout of HETensor::read
+  std::vector<double> expand_compacted_result(
+      const std::vector<HEType>& packed, size_t compaction, size_t batch_size,
+      size_t element_count);
 
   /// \brief Processes a message containing the result from the server
   /// \param[in] message Message to process
-  void handle_result(const pb::TCPMessage& message);
+  void handle_result(const TCPMessage& message);
 
   /// \brief Processes a message containing the inference shape
   /// \param[in] message Message to process
   void handle_inference_request(const pb::TCPMessage& message);
 
+  /// \brief Encrypts an input and sends it to the server in chunks
+  /// \param[in,out] he_tensor Tensor to encrypt the input into
+  /// \param[in] input Input to encrypt
+  /// \param[in] num_bytes Number of bytes of the input
+  /// \param[in] seeded_encryptor Secret-key encryptor for seeded ciphertexts,
+  /// or nullptr
+  /// \param[in] cache_handle Handle under which the server caches the input,
+  /// or empty to not cache it
+  void upload_input(HETensor& he_tensor, const HEInputView& input,
+                    size_t num_bytes, const seal::Encryptor* seeded_encryptor,
+                    const std::string& cache_handle);
+
+  /// \brief Waits for the inputs uploaded by another thread, see
+  /// handle_encryption_parameters_response, and writes their pending
+  /// messages. Called from the I/O thread
+  void finish_input_upload();
+
+  /// \brief Writes the messages queued by other threads than the I/O
+  /// thread, in their order
+  void flush_pending_writes();
+
   /// \brief Sends the public key and relinearization keys to the server
   void send_public_and_relin_keys();
 
+  /// \brief Sends only the fingerprint of the public key, so the server may
+  /// use keys cached from a previous connection
+  void send_key_id();
+
+  /// \brief Returns the fingerprint of an inference request, as sent by the
+  /// server, see send_inference_shape
+  /// \param[in] message Inference request, possibly with the encryption
+  /// parameters of its session, which are not fingerprinted
+  static std::string inference_request_id(pb::TCPMessage message);
+
+  /// \brief Loads the setup of the last session from the session file, if
+  /// any. The file is set by the NGRAPH_HE_CLIENT_SESSION_FILE environment
+  /// variable
+  void load_session();
+
+  /// \brief Saves the encryption parameters and an inference request to the
+  /// session file, if any
+  /// \param[in] message Inference request received from the server
+  void save_session(const pb::TCPMessage& message);
+
+  /// \brief Tells the server to discard the inputs uploaded from the cached
+  /// inference request, which the server did not accept
+  void send_pipeline_reset();
+
+  /// \brief Sends the name of the model to run to a server hosting several
+  /// models, see HESealModelRegistry. The name is set by the
+  /// NGRAPH_HE_CLIENT_MODEL environment variable
+  void send_model_name();
+
   /// \brief Writes a mesage to the server
   /// \param[in] message Message to write
   void write_message(ngraph::runtime::he::TCPMessage&& message) {
-    m_tcp_client->write_message(std::move(message));
+    write_message(std::move(message), m_message_index);
   }
 
+  /// \brief Writes a mesage to the server
+  /// \param[in] message Message to write
+  /// \param[in] trigger Index of the received message the message answers,
+  /// recorded in the capture file, if any. Messages of other threads are
+  /// queued and written from the I/O thread, since the TCP client is not
+  /// thread-safe
+  void write_message(ngraph::runtime::he::TCPMessage&& message,
+                     size_t trigger);
+
+  /// \brief Returns the per-phase timers and byte counters of the client.
+  /// Phases are keygen, key_upload, input_encrypt, result_decrypt and, per
+  /// activation request, <op>_load, <op> and <op>_write, where <op> is
+  /// relu, bounded_relu, max_pool, refresh or dot_relu. The <op> phase
+  /// decrypts, computes and re-encrypts the values
+  const HESealClientStats& stats() const { return m_stats; }
+
   /// \brief Returns whether or not the function is done evaluating
   bool is_done() { return m_is_done; }
 
-  /// \brief Returns decrypted results
+  /// \brief Discards the results of the last inference, so the next
+  /// results are loaded into new tensors
+  void clear_results();
+
+  /// \brief Returns the decrypted values of the first result
   /// \warning Will lock until results are ready
   std::vector<double> get_results();
 
-  /// \brief Closes conection with the server
+  /// \brief Returns the decrypted values of the first result without copying
+  /// them. The reference is valid for the lifetime of the client
+  /// \warning Will lock until results are ready
+  const std::vector<double>& get_results_ref();
+
+  /// \brief Returns the decrypted values of one result of the function,
+  /// without waiting for the other results. The reference is valid for the
+  /// lifetime of the client
+  /// \param[in] result_idx Index of the function's result
+  /// \warning Will lock until the result is ready
+  /// \throws ngraph_error if the server closed the connection without
+  /// sending the result
+  const std::vector<double>& get_results_ref(size_t result_idx);
+
+  /// \brief Closes conection with the server. A persistent session is ended
+  /// first, so the server serves its next client
   void close_connection();
 
   /// \brief Returns whether or not the encryption parameters use complex
@@ -133,11 +341,17 @@ class HESealClient {
   bool complex_packing() const { return m_encryption_params.complex_packing(); }
 
 #ifdef NGRAPH_HE_ABY_ENABLE
-  inline void init_aby_executor(size_t num_parties) {
+  /// \brief Creates the ABY executor, unless already created, with the mpc
+  /// protocol negotiated by the server
+  /// \param[in] num_parties Number of parties, each with its own connection
+  /// \param[in] num_party_threads Number of threads used by each party
+  inline void init_aby_executor(
+      size_t num_parties,
+      size_t num_party_threads = s_default_aby_party_threads) {
     if (m_aby_executor == nullptr) {
       m_aby_executor = std::make_unique<aby::ABYClientExecutor>(
-          std::string("yao"), *this, m_hostname, 34001, 128, 64, 2,
-          num_parties);
+          m_mpc_protocol, *this, m_hostname, 34001, 128, 64,
+          num_party_threads, num_parties);
     }
   }
 #endif
@@ -159,40 +373,186 @@ class HESealClient {
     return m_encryptor;
   }
 
+  /// \brief Returns pointer to decryptor
+  const std::shared_ptr<seal::Decryptor> get_decryptor() const {
+    return m_decryptor;
+  }
+
   /// \brief Returns pointer to SEAL context
   const std::shared_ptr<seal::SEALContext> get_context() const {
     return m_context;
   }
 
  private:
+  /// \brief Approximate number of bytes of encrypted inputs per message, so
+  /// input encryption overlaps with the upload and server-side loading
+  static constexpr size_t s_upload_chunk_bytes = 1UL << 22U;
+
+  /// \brief Connects to the server and runs the inference
+  void connect(const std::string& hostname, size_t port);
+
+  /// \brief Stops and joins the request workers
+  void stop_request_workers();
+
+  /// \brief Asks the server to keep the session open after the inference,
+  /// so further inferences reuse the keys, see infer
+  void send_persistent_session();
+
+  /// \brief Uploads the inputs of the next inference of a persistent
+  /// session, once both infer was called and the server requested them
+  void upload_next_inputs();
+
+  using RequestHandler = TCPMessage (HESealClient::*)(const TCPMessage&);
+
+  /// \brief Handles an activation request. Requests without garbled
+  /// circuits are queued for the request workers, so the I/O thread keeps
+  /// reading while earlier requests are processed. Requests with garbled
+  /// circuits share the ABY executor, and are handled on the I/O thread
+  /// \param[in] message Request to handle
+  /// \param[in] handler Handler computing the response
+  void dispatch_request(const TCPMessage& message, RequestHandler handler);
+
+  /// \brief Handles queued requests until the workers are stopped. Responses
+  /// echo the stream id of their request, and are written once computed.
+  /// Responses to requests without a stream id are written in the order of
+  /// the requests, which the server then relies on
+  void run_request_worker();
+
   std::string m_hostname;  // Hostname of server to connect to
 
-  std::unique_ptr<TCPClient> m_tcp_client;
+  boost::asio::io_context m_io_context;
+  std::unique_ptr<ClientTransport> m_tcp_client;
+  HESealClientStats m_stats;
+  // Records the session for HESealReplayClient. Set by the
+  // NGRAPH_HE_CLIENT_CAPTURE_FILE environment variable, and nullptr by
+  // default
+  std::unique_ptr<TCPCaptureWriter> m_capture;
+  // Index among the received messages of the message handled by the I/O
+  // thread. Only maintained when capturing
+  size_t m_message_index{0};
+
+  struct QueuedRequest {
+    // Index among the requests without a stream id
+    size_t sequence{0};
+    // Index of the request among the received messages
+    size_t message_index{0};
+    TCPMessage message;
+    RequestHandler handler{nullptr};
+  };
+  // Threads handling queued requests. Set by the NGRAPH_HE_CLIENT_WORKERS
+  // environment variable, and defaults to 1
+  std::vector<std::thread> m_request_workers;
+  // Guards the members below
+  std::mutex m_request_mutex;
+  std::condition_variable m_request_cond;
+  bool m_stop_request_workers{false};
+  std::deque<QueuedRequest> m_requests;
+  size_t m_num_requests{0};
+  // Computed responses awaiting the responses to earlier requests, with the
+  // message indices of their requests
+  std::map<size_t, std::pair<size_t, TCPMessage>> m_responses;
+  size_t m_num_responses{0};
 
 #ifdef NGRAPH_HE_ABY_ENABLE
   std::unique_ptr<aby::ABYClientExecutor> m_aby_executor;
+  // Threads per party for servers which do not send their thread count
+  inline static const size_t s_default_aby_party_threads{2};
 #endif
   HESealEncryptionParameters m_encryption_params;
   std::shared_ptr<seal::PublicKey> m_public_key;
   std::shared_ptr<seal::SecretKey> m_secret_key;
   std::shared_ptr<seal::SEALContext> m_context;
   std::shared_ptr<seal::Encryptor> m_encryptor;
+  // Encryptions of zero under m_encryptor, used to re-encrypt activations.
+  // Sized by the NGRAPH_HE_CLIENT_ZERO_POOL_SIZE environment variable, and
+  // nullptr by default
+  std::unique_ptr<SealZeroPool> m_zero_pool;
+  std::shared_ptr<seal::Encryptor> m_secret_key_encryptor;
   std::shared_ptr<seal::CKKSEncoder> m_ckks_encoder;
   std::shared_ptr<seal::Decryptor> m_decryptor;
   std::shared_ptr<seal::Evaluator> m_evaluator;
   std::shared_ptr<seal::KeyGenerator> m_keygen;
   std::shared_ptr<seal::RelinKeys> m_relin_keys;
+  // Seeded serializations of the generated public and relinearization keys,
+  // sent to the server in place of the keys. Empty if the keys were loaded
+  // from the key file, whose keys are stored expanded
+  std::string m_seeded_public_key;
+  std::string m_seeded_relin_keys;
+  // Rotation steps whose Galois keys the server requested, and the seeded
+  // serialization of the keys, sent with the relinearization keys
+  std::vector<int> m_galois_steps;
+  std::string m_seeded_galois_keys;
   size_t m_batch_size;
+  // Ciphertext compression mode negotiated with the server
+  seal::compr_mode_type m_compr_mode{seal::compr_mode_type::none};
+  // File storing the keys across connections, or empty
+  std::string m_key_file;
+  // Fingerprint of the public key, set when using a key file
+  std::string m_key_id;
+  // Model requested from a server hosting several models, or empty
+  std::string m_model_name;
+  // Sharing of the garbled circuits, as sent by the server with the
+  // inference shape
+  std::string m_mpc_protocol{"yao"};
+  bool m_keys_from_file{false};
+  // File storing the encryption parameters and inference request of the
+  // last session, or empty. A client whose cached parameters match the
+  // server's uploads its inputs right after its keys
+  std::string m_session_file;
+  // Serialized encryption parameters sent by the server
+  std::string m_server_parameters;
+  // Inference request of the last session, with its encryption parameters,
+  // or nullptr
+  std::shared_ptr<pb::TCPMessage> m_cached_request;
+  // Fingerprint of m_cached_request sent with the next keys message, or
+  // empty
+  std::string m_pipelined_request_id;
+  // Whether or not inputs were uploaded from m_cached_request. An inference
+  // request from the server means it discards those inputs
+  bool m_pipelined_inputs{false};
+  // Uploads the input last referred to by its cache handle, once the server
+  // reports it is not cached
+  std::function<void()> m_cached_input_upload;
+  // Encrypts and uploads the inputs of m_cached_request while the I/O
+  // thread generates and uploads the relinearization keys
+  std::future<void> m_input_upload;
+  // Messages written by other threads than the I/O thread, with their
+  // triggers, guarded by m_pending_writes_mutex
+  std::vector<std::pair<TCPMessage, size_t>> m_pending_writes;
+  std::mutex m_pending_writes_mutex;
+  // Whether or not the session serves several inferences, see infer. Set by
+  // the NGRAPH_HE_CLIENT_PERSISTENT environment variable
+  bool m_persistent{false};
+  // Whether or not the client is not connected to a server, in which case
+  // messages are written to m_tcp_client from the calling thread
+  bool m_offline{false};
+  // Whether or not the server was asked to keep the session open
+  bool m_session_persistent{false};
+  // Runs m_io_context in persistent sessions, which outlive the constructor
+  std::thread m_io_thread;
+  // Inference request of the next inference of a persistent session, and
+  // whether or not its inputs were given, accessed from the I/O thread
+  std::shared_ptr<pb::TCPMessage> m_next_request;
+  bool m_next_inputs_set{false};
+  size_t m_num_inferences{0};
 
   bool m_is_done{false};
+  // Whether or not the connection was closed, guarded by m_is_done_mutex
+  bool m_closed{false};
   std::condition_variable m_is_done_cond;
   std::mutex m_is_done_mutex;
 
   std::shared_ptr<HETensor> m_loaded_function_tensor;
 
-  // Function inputs and configuration
+  // Function inputs and configuration. m_inputs views either the caller's
+  // buffers or the data owned by m_input_config
   HETensorConfigMap<double> m_input_config;
-  std::shared_ptr<HETensor> m_result_tensor;
-  std::vector<double> m_results;  // Function outputs
+  HEInputViewMap m_inputs;
+  // Results of the function, by index, guarded by m_is_done_mutex
+  std::vector<std::shared_ptr<HETensor>> m_result_tensors;
+  std::vector<std::vector<double>> m_output_results;
+  std::vector<bool> m_results_done;
+  // Ops computed on the decrypted result, see split_epilogue
+  nlohmann::json m_epilogue = nlohmann::json::array();
 };
 }  // namespace ngraph::runtime::he
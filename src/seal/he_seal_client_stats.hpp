@@ -0,0 +1,144 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Time spent in a phase of the client's inference
+struct HEClientPhaseStats {
+  /// \brief Total time in seconds
+  double seconds{0};
+  /// \brief Number of times the phase ran, e.g. one per activation request
+  size_t calls{0};
+};
+
+/// \brief Per-phase timers and byte counters of a client. All methods are
+/// thread-safe, since activation requests are handled by several workers
+class HESealClientStats {
+ public:
+  /// \brief Times a phase from construction to destruction, or to stop()
+  class ScopedTimer {
+   public:
+    ScopedTimer(HESealClientStats& stats, std::string phase)
+        : m_stats(stats),
+          m_phase(std::move(phase)),
+          m_start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() { stop(); }
+
+    /// \brief Records the phase, unless already recorded
+    void stop() {
+      if (m_stopped) {
+        return;
+      }
+      m_stopped = true;
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - m_start;
+      m_stats.record(m_phase, elapsed.count());
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+   private:
+    HESealClientStats& m_stats;
+    std::string m_phase;
+    std::chrono::steady_clock::time_point m_start;
+    bool m_stopped{false};
+  };
+
+  /// \brief Adds one run of a phase
+  /// \param[in] phase Name of the phase
+  /// \param[in] seconds Duration of the run
+  void record(const std::string& phase, double seconds) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    HEClientPhaseStats& stats = m_phases[phase];
+    stats.seconds += seconds;
+    ++stats.calls;
+  }
+
+  /// \brief Counts a message written to the server
+  void add_sent(const TCPMessage& message) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_bytes_sent += wire_bytes(message);
+    ++m_messages_sent;
+  }
+
+  /// \brief Counts a message read from the server
+  void add_received(const TCPMessage& message) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_bytes_received += wire_bytes(message);
+    ++m_messages_received;
+  }
+
+  /// \brief Returns the phases by name
+  std::map<std::string, HEClientPhaseStats> phases() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_phases;
+  }
+
+  /// \brief Returns the number of bytes written to the server
+  size_t bytes_sent() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_bytes_sent;
+  }
+
+  /// \brief Returns the number of bytes read from the server
+  size_t bytes_received() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_bytes_received;
+  }
+
+  /// \brief Returns the number of messages written to the server
+  size_t messages_sent() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_messages_sent;
+  }
+
+  /// \brief Returns the number of messages read from the server
+  size_t messages_received() const {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_messages_received;
+  }
+
+ private:
+  /// \brief Returns the size of a message on the wire, including its header
+  static size_t wire_bytes(const TCPMessage& message) {
+    size_t bytes = TCPMessage::header_length + message.segments_size() +
+                   message.payload_size();
+    if (message.pb_message() != nullptr) {
+      bytes += message.pb_message()->ByteSizeLong();
+    }
+    return bytes;
+  }
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, HEClientPhaseStats> m_phases;
+  size_t m_bytes_sent{0};
+  size_t m_bytes_received{0};
+  size_t m_messages_sent{0};
+  size_t m_messages_received{0};
+};
+
+}  // namespace ngraph::runtime::he
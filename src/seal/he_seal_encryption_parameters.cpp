@@ -16,15 +16,19 @@
 
 #include "seal/he_seal_encryption_parameters.hpp"
 
+#include <algorithm>
 #include <exception>
+#include <numeric>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
 #include "ngraph/except.hpp"
 #include "ngraph/file_util.hpp"
 #include "nlohmann/json.hpp"
+#include "seal/seal_context_cache.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
@@ -37,6 +41,7 @@ HESealEncryptionParameters::HESealEncryptionParameters() {
   m_security_level = default_parms.security_level();
   m_scale = default_parms.scale();
   m_complex_packing = default_parms.complex_packing();
+  m_rescale_primes = default_parms.rescale_primes();
 }
 
 HESealEncryptionParameters::HESealEncryptionParameters(
@@ -84,6 +89,26 @@ HESealEncryptionParameters::HESealEncryptionParameters(
   validate_parameters();
 }
 
+HESealEncryptionParameters HESealEncryptionParameters::integer_parms(
+    std::uint64_t poly_modulus_degree, std::vector<int> coeff_modulus_bits,
+    int plain_modulus_bits, std::uint64_t security_level) {
+  seal::EncryptionParameters parms(seal::scheme_type::bfv);
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(seal::CoeffModulus::Create(
+      poly_modulus_degree, std::move(coeff_modulus_bits)));
+  try {
+    parms.set_plain_modulus(seal::PlainModulus::Batching(
+        static_cast<std::size_t>(poly_modulus_degree), plain_modulus_bits));
+  } catch (const std::exception& e) {
+    throw ngraph_error("No batching plain modulus of " +
+                       std::to_string(plain_modulus_bits) + " bits: " +
+                       e.what());
+  }
+  // Integers are encoded exactly, i.e. at scale 1
+  return HESealEncryptionParameters("HE_SEAL", parms, security_level, 1.0,
+                                    false);
+}
+
 void HESealEncryptionParameters::validate_parameters() const {
   NGRAPH_CHECK(m_scheme_name == "HE_SEAL", "Invalid scheme name ",
                m_scheme_name);
@@ -99,19 +124,34 @@ void HESealEncryptionParameters::validate_parameters() const {
   NGRAPH_CHECK(valid_security_level.count(security_level()) != 0,
                "security_level must be 0, 128, 192, 256");
 
-  auto seal_sec_level = seal_security_level(security_level());
+  // The context is cached, so the backend or client using the parameters
+  // does not create it again
+  auto context = SealContextCache::get_context(*this);
+  NGRAPH_CHECK(context->parameters_set(), "Invalid parameters");
+
+  if (integer_scheme()) {
+    NGRAPH_CHECK(!m_complex_packing, "BFV does not support complex packing");
+    NGRAPH_CHECK(context->first_context_data()->qualifiers().using_batching,
+                 "BFV plain modulus ", plain_modulus(),
+                 " does not support batching");
+  }
 
-  seal::SEALContext context(m_seal_encryption_parameters, true, seal_sec_level);
-  //std::shared_ptr<seal::SEALContext>& context = &temp_context;
-  //context = std::make_shared<seal::SEALContext>(m_seal_encryption_parameters, true, seal_sec_level);
-  
-  NGRAPH_CHECK(context.parameters_set(), "Invalid parameters");
+  NGRAPH_CHECK(m_rescale_primes == 1 || m_rescale_primes == 2,
+               "rescale_primes must be 1 or 2");
+  NGRAPH_CHECK(m_rescale_primes == 1 || !integer_scheme(),
+               "BFV parameters are not rescaled");
 
   // TODO(fboemer): validate scale is reasonable
 }
 
 double HESealEncryptionParameters::choose_scale(
-    const std::vector<seal::Modulus>& coeff_moduli) {
+    const std::vector<seal::Modulus>& coeff_moduli,
+    std::size_t rescale_primes) {
+  // The special prime is last, and the prime pair dropped first precedes it
+  if (rescale_primes == 2 && coeff_moduli.size() > 3) {
+    return static_cast<double>(coeff_moduli[coeff_moduli.size() - 2].value()) *
+           static_cast<double>(coeff_moduli[coeff_moduli.size() - 3].value());
+  }
   if (coeff_moduli.size() > 2) {
     return static_cast<double>(coeff_moduli[coeff_moduli.size() - 2].value());
   }
@@ -122,6 +162,66 @@ double HESealEncryptionParameters::choose_scale(
   return sqrt(static_cast<double>(coeff_moduli.back().value() / 256.0));
 }
 
+HESealEncryptionParameters HESealEncryptionParameters::select_for_depth(
+    std::size_t depth, std::size_t min_slots, std::uint64_t security_level,
+    int scale_bits, bool complex_packing) {
+  return select_for_prime_bits(std::vector<int>(depth, scale_bits), min_slots,
+                               security_level, scale_bits, complex_packing);
+}
+
+HESealEncryptionParameters HESealEncryptionParameters::select_for_prime_bits(
+    const std::vector<int>& level_bits, std::size_t min_slots,
+    std::uint64_t security_level, int scale_bits, bool complex_packing) {
+  // Matches the margin of the configs in configs/, e.g. 30 bits for a 24-bit
+  // scale
+  constexpr int integer_bits = 6;
+  constexpr int max_prime_bits = 60;
+  NGRAPH_CHECK(scale_bits > 0 && scale_bits <= max_prime_bits,
+               "Invalid scale bit-width ", scale_bits);
+  int outer_bits = std::min(max_prime_bits, scale_bits + integer_bits);
+
+  // Rescales drop the last prime before the special prime first
+  std::vector<int> coeff_modulus_bits{outer_bits};
+  for (auto it = level_bits.rbegin(); it != level_bits.rend(); ++it) {
+    NGRAPH_CHECK(*it > 0 && *it <= max_prime_bits, "Invalid prime bit-width ",
+                 *it);
+    coeff_modulus_bits.emplace_back(*it);
+  }
+  coeff_modulus_bits.emplace_back(outer_bits);
+  int total_bits = std::accumulate(coeff_modulus_bits.begin(),
+                                   coeff_modulus_bits.end(), 0);
+
+  auto seal_sec_level = seal_security_level(security_level);
+  for (std::uint64_t poly_modulus_degree = 1024; poly_modulus_degree <= 32768;
+       poly_modulus_degree *= 2) {
+    std::size_t slots =
+        complex_packing ? poly_modulus_degree : poly_modulus_degree / 2;
+    if (slots < min_slots) {
+      continue;
+    }
+    if (seal_sec_level != seal::sec_level_type::none &&
+        total_bits > seal::CoeffModulus::MaxBitCount(
+                         static_cast<std::size_t>(poly_modulus_degree),
+                         seal_sec_level)) {
+      continue;
+    }
+    try {
+      return HESealEncryptionParameters(
+          "HE_SEAL", poly_modulus_degree, coeff_modulus_bits, security_level,
+          static_cast<double>(std::uint64_t{1} << scale_bits),
+          complex_packing);
+    } catch (const std::exception& e) {
+      // Too few primes of the requested bit-width for this degree
+      NGRAPH_HE_LOG(5) << "Skipping poly_modulus_degree "
+                       << poly_modulus_degree << ": " << e.what();
+    }
+  }
+  throw ngraph_error("No supported encryption parameters with depth " +
+                     std::to_string(level_bits.size()) + ", " +
+                     std::to_string(min_slots) + " slots and security level " +
+                     std::to_string(security_level));
+}
+
 bool HESealEncryptionParameters::operator==(
     const HESealEncryptionParameters& other) const {
 #pragma clang diagnostic push
@@ -130,7 +230,8 @@ bool HESealEncryptionParameters::operator==(
          (other.m_seal_encryption_parameters == m_seal_encryption_parameters) &&
          (other.m_security_level == m_security_level) &&
          (other.m_scale == m_scale) &&
-         (other.m_complex_packing == m_complex_packing);
+         (other.m_complex_packing == m_complex_packing) &&
+         (other.m_rescale_primes == m_rescale_primes);
 #pragma clang diagnostic pop
 }
 
@@ -152,6 +253,9 @@ void HESealEncryptionParameters::save(std::ostream& stream) const {
                sizeof(m_complex_packing));
   stream.write(reinterpret_cast<const char*>(&m_security_level),
                sizeof(m_security_level));
+  auto rescale_primes = static_cast<std::uint64_t>(m_rescale_primes);
+  stream.write(reinterpret_cast<const char*>(&rescale_primes),
+               sizeof(rescale_primes));
 
   m_seal_encryption_parameters.save(stream);
 }
@@ -168,11 +272,16 @@ HESealEncryptionParameters HESealEncryptionParameters::load(
   uint64_t security_level;
   stream.read(reinterpret_cast<char*>(&security_level), sizeof(security_level));
 
+  uint64_t rescale_primes;
+  stream.read(reinterpret_cast<char*>(&rescale_primes), sizeof(rescale_primes));
+
   seal::EncryptionParameters seal_encryption_parameters;
   seal_encryption_parameters.load(stream);
 
-  return HESealEncryptionParameters("HE_SEAL", seal_encryption_parameters,
-                                    security_level, scale, complex_packing);
+  HESealEncryptionParameters parms("HE_SEAL", seal_encryption_parameters,
+                                   security_level, scale, complex_packing);
+  parms.set_rescale_primes(static_cast<std::size_t>(rescale_primes));
+  return parms;
 }
 
 HESealEncryptionParameters
@@ -199,10 +308,29 @@ HESealEncryptionParameters::parse_config_or_use_default(const char* config) {
 
     std::vector<int> coeff_mod_bits = js["coeff_modulus"];
 
+    std::string scheme = "CKKS";
+    if (js.find("scheme") != js.end()) {
+      scheme = js["scheme"];
+    }
+    NGRAPH_CHECK(scheme == "CKKS" || scheme == "BFV", "Parsed scheme ", scheme,
+                 " is not CKKS or BFV");
+    if (scheme == "BFV") {
+      NGRAPH_CHECK(js.find("plain_modulus_bits") != js.end(),
+                   "BFV parameters require plain_modulus_bits");
+      return integer_parms(poly_modulus_degree, coeff_mod_bits,
+                           js["plain_modulus_bits"], security_level);
+    }
+
+    std::size_t rescale_primes = 1;
+    if (js.find("rescale_primes") != js.end()) {
+      rescale_primes = js["rescale_primes"];
+    }
+
     double scale = 0;  // Use default scale
     if (js.find("scale") == js.end()) {
       scale = choose_scale(
-          seal::CoeffModulus::Create(poly_modulus_degree, coeff_mod_bits));
+          seal::CoeffModulus::Create(poly_modulus_degree, coeff_mod_bits),
+          rescale_primes);
     } else {
       scale = js["scale"];
     }
@@ -215,6 +343,7 @@ HESealEncryptionParameters::parse_config_or_use_default(const char* config) {
     auto params = HESealEncryptionParameters(scheme_name, poly_modulus_degree,
                                              coeff_mod_bits, security_level,
                                              scale, complex_packing);
+    params.set_rescale_primes(rescale_primes);
 
     return params;
   } catch (const std::exception& e) {
@@ -233,7 +362,8 @@ void print_encryption_parameters(const HESealEncryptionParameters& params,
 
   param_ss << "\n/\n"
            << "| Encryption parameters :\n"
-           << "|   scheme: ckks\n"
+           << "|   scheme: " << (params.integer_scheme() ? "bfv" : "ckks")
+           << "\n"
            << "|   poly_modulus_degree: " << params.poly_modulus_degree()
            << "\n"
            << "|   coeff_modulus size: "
@@ -244,7 +374,11 @@ void print_encryption_parameters(const HESealEncryptionParameters& params,
     param_ss << coeff_modulus[i].bit_count() << " + ";
   }
   param_ss << coeff_modulus.back().bit_count() << ") bits\n";
-  param_ss << "|   scale : " << params.scale() << "\n";
+  if (params.integer_scheme()) {
+    param_ss << "|   plain_modulus: " << params.plain_modulus() << "\n";
+  } else {
+    param_ss << "|   scale : " << params.scale() << "\n";
+  }
 
   if (params.complex_packing()) {
     param_ss << "|   complex_packing: True\n";
@@ -252,6 +386,10 @@ void print_encryption_parameters(const HESealEncryptionParameters& params,
     param_ss << "|   complex_packing: False\n";
   }
 
+  if (params.rescale_primes() > 1) {
+    param_ss << "|   rescale_primes: " << params.rescale_primes() << "\n";
+  }
+
   param_ss << "|   security_level: " << params.security_level() << "\n"
            << "\\";
 
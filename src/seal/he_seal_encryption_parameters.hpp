@@ -24,7 +24,7 @@
 #include "seal/seal.h"
 
 namespace ngraph::runtime::he {
-/// \brief Class representing CKKS encryption parameters
+/// \brief Class representing CKKS or BFV encryption parameters
 class HESealEncryptionParameters {
  public:
   /// \brief Constructs encryption parameteters from SEAL parameters
@@ -70,6 +70,21 @@ class HESealEncryptionParameters {
                              std::uint64_t security_level, double scale,
                              bool complex_packing);
 
+  /// \brief Returns BFV encryption parameters, which encode integers exactly
+  /// using batching
+  /// \param[in] poly_modulus_degree Degree of the RLWE polynomial. Should be a
+  /// power of 2
+  /// \param[in] coeff_modulus_bits Vector of bit-widths of the cofficient
+  /// moduli
+  /// \param[in] plain_modulus_bits Bit-width of the plaintext modulus, which
+  /// bounds the magnitude of the integers computed on
+  /// \param[in] security_level Bits of security. 0 indicates no security
+  /// \throws ngraph_error if no batching prime of plain_modulus_bits bits
+  /// exists
+  static HESealEncryptionParameters integer_parms(
+      std::uint64_t poly_modulus_degree, std::vector<int> coeff_modulus_bits,
+      int plain_modulus_bits, std::uint64_t security_level);
+
   /// \brief Returns encryption parameters at given path if possible, or use
   /// default parameters
   /// \param[in] config filename where configuration is stored, or contents of
@@ -95,13 +110,50 @@ class HESealEncryptionParameters {
   /// \throws ngraph_error if poly_modulus_degree is not a supported power of 2
   /// \throws ngraph_error if security level is not valid security
   /// level
+  /// \throws ngraph_error if BFV parameters use complex packing or do not
+  /// support batching
+  /// \throws ngraph_error if rescale_primes is not 1 or 2, or BFV parameters
+  /// rescale by prime pairs
   void validate_parameters() const;
 
   /// \brief Chooses a default scale for the given list of coefficient moduli
   /// \param[in] coeff_moduli List of coefficient moduli
+  /// \param[in] rescale_primes Number of primes dropped by each rescale. With
+  /// 2, the scale is the product of the two last primes before the special
+  /// prime
   /// \returns Chosen scale
-  static double choose_scale(
-      const std::vector<seal::Modulus>& coeff_moduli);
+  static double choose_scale(const std::vector<seal::Modulus>& coeff_moduli,
+                             std::size_t rescale_primes = 1);
+
+  /// \brief Returns the smallest encryption parameters supporting a given
+  /// number of rescales at the given security level. The coefficient modulus
+  /// chain consists of one prime of scale_bits bits per rescale, between a
+  /// first and a special prime with extra bits for the integer part of the
+  /// values. The poly_modulus_degree is the smallest supported degree whose
+  /// maximum coefficient modulus bit count holds the chain
+  /// \param[in] depth Number of rescales the chain must support
+  /// \param[in] min_slots Minimum number of slots per ciphertext
+  /// \param[in] security_level Bits of security. 0 indicates no security
+  /// \param[in] scale_bits Bit-width of the scale, i.e. the precision
+  /// \param[in] complex_packing Whether or not to use complex packing
+  /// \throws ngraph_error if no supported poly_modulus_degree holds the chain
+  static HESealEncryptionParameters select_for_depth(
+      std::size_t depth, std::size_t min_slots, std::uint64_t security_level,
+      int scale_bits, bool complex_packing);
+
+  /// \brief Returns the smallest encryption parameters whose coefficient
+  /// modulus chain drops a prime of the given bit-width at each rescale, as
+  /// select_for_depth does for primes of scale_bits bits
+  /// \param[in] level_bits Bit-width of the prime dropped by the i'th
+  /// rescale, for each i
+  /// \param[in] min_slots Minimum number of slots per ciphertext
+  /// \param[in] security_level Bits of security. 0 indicates no security
+  /// \param[in] scale_bits Bit-width of the scale, i.e. the precision
+  /// \param[in] complex_packing Whether or not to use complex packing
+  /// \throws ngraph_error if no supported poly_modulus_degree holds the chain
+  static HESealEncryptionParameters select_for_prime_bits(
+      const std::vector<int>& level_bits, std::size_t min_slots,
+      std::uint64_t security_level, int scale_bits, bool complex_packing);
 
   /// \brief Saves encryption parameters to a stream
   void save(std::ostream& stream) const;
@@ -117,6 +169,21 @@ class HESealEncryptionParameters {
   /// \brief Returns the scheme name
   const std::string& scheme_name() const { return m_scheme_name; }
 
+  /// \brief Returns the SEAL scheme, ckks or bfv
+  seal::scheme_type scheme() const {
+    return m_seal_encryption_parameters.scheme();
+  }
+
+  /// \brief Returns whether or not the parameters use the integer BFV scheme
+  bool integer_scheme() const { return scheme() == seal::scheme_type::bfv; }
+
+  /// \brief Returns the plaintext modulus of BFV parameters, or 0 for CKKS
+  std::uint64_t plain_modulus() const {
+    return integer_scheme()
+               ? m_seal_encryption_parameters.plain_modulus().value()
+               : 0;
+  }
+
   /// \brief Returns the polynomial modulus degree
   std::uint64_t poly_modulus_degree() const {
     return m_seal_encryption_parameters.poly_modulus_degree();
@@ -141,6 +208,18 @@ class HESealEncryptionParameters {
   /// \brief Return whether or not complex packing is enabled
   bool& complex_packing() { return m_complex_packing; }
 
+  /// \brief Returns the number of primes dropped by each rescale, 1 or 2.
+  /// Rescaling by a pair of small primes divides by one logical scale of
+  /// twice their precision
+  std::size_t rescale_primes() const { return m_rescale_primes; }
+
+  /// \brief Sets the number of primes dropped by each rescale
+  /// \throws ngraph_error if rescale_primes is not valid for the parameters
+  void set_rescale_primes(std::size_t rescale_primes) {
+    m_rescale_primes = rescale_primes;
+    validate_parameters();
+  }
+
  private:
   std::string m_scheme_name;
   seal::EncryptionParameters m_seal_encryption_parameters{
@@ -148,6 +227,7 @@ class HESealEncryptionParameters {
   std::uint64_t m_security_level;
   double m_scale;
   bool m_complex_packing;
+  std::size_t m_rescale_primes{1};
 };
 
 /// \brief Prints the given encryption parameters
@@ -0,0 +1,147 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_epilogue.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "he_util.hpp"
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/coordinate_transform.hpp"
+#include "ngraph/ops.hpp"
+#include "ngraph/shape_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+void softmax(std::vector<double>& values, const Shape& shape,
+             const AxisSet& axes) {
+  Shape reduced_shape = reduce(shape, axes);
+  CoordinateTransform transform(shape);
+  CoordinateTransform reduced_transform(reduced_shape);
+  std::vector<double> max_values(shape_size(reduced_shape),
+                                 -std::numeric_limits<double>::infinity());
+  std::vector<double> sums(shape_size(reduced_shape), 0);
+
+  // Subtract the maximum to avoid overflow of the exponentials
+  for (const Coordinate& coord : transform) {
+    size_t idx = reduced_transform.index(reduce(coord, axes));
+    max_values[idx] = std::max(max_values[idx], values[transform.index(coord)]);
+  }
+  for (const Coordinate& coord : transform) {
+    size_t idx = reduced_transform.index(reduce(coord, axes));
+    double& value = values[transform.index(coord)];
+    value = std::exp(value - max_values[idx]);
+    sums[idx] += value;
+  }
+  for (const Coordinate& coord : transform) {
+    size_t idx = reduced_transform.index(reduce(coord, axes));
+    values[transform.index(coord)] /= sums[idx];
+  }
+}
+}  // namespace
+
+bool is_epilogue_op(const Node& node) {
+  switch (get_typeid(node.get_type_info())) {
+    case OP_TYPEID::BoundedRelu:
+    case OP_TYPEID::Exp:
+    case OP_TYPEID::Negative:
+    case OP_TYPEID::Relu:
+    case OP_TYPEID::Softmax:
+      return true;
+    default:
+      return false;
+  }
+}
+
+nlohmann::json epilogue_op_to_json(const Node& node) {
+  NGRAPH_CHECK(is_epilogue_op(node), "Client cannot compute ",
+               node.description(), " in an epilogue");
+  nlohmann::json js = {{"op", node.description()}};
+  auto type_id = get_typeid(node.get_type_info());
+  if (type_id == OP_TYPEID::BoundedRelu) {
+    js["bound"] = static_cast<const op::BoundedRelu&>(node).get_alpha();
+  } else if (type_id == OP_TYPEID::Softmax) {
+    const AxisSet& axes = static_cast<const op::Softmax&>(node).get_axes();
+    js["axes"] = std::vector<size_t>{axes.begin(), axes.end()};
+  }
+  return js;
+}
+
+std::vector<std::shared_ptr<Node>> split_epilogue(
+    const std::shared_ptr<Function>& function) {
+  const auto& results = function->get_results();
+  if (results.size() != 1) {
+    return {};
+  }
+  const auto& result = results[0];
+
+  std::vector<std::shared_ptr<Node>> epilogue;
+  auto node = result->get_input_node_shared_ptr(0);
+  while (is_epilogue_op(*node) && node->get_output_size() == 1 &&
+         node->output(0).get_target_inputs().size() == 1 &&
+         !node->get_input_node_ptr(0)->is_parameter()) {
+    epilogue.emplace_back(node);
+    node = node->get_input_node_shared_ptr(0);
+  }
+  if (epilogue.empty()) {
+    return {};
+  }
+  std::reverse(epilogue.begin(), epilogue.end());
+
+  NGRAPH_HE_LOG(3) << "Client computes epilogue of " << epilogue.size()
+                   << " ops after " << node->get_name();
+  result->input(0).replace_source_output(epilogue.front()->input_value(0));
+  return epilogue;
+}
+
+void apply_epilogue(const nlohmann::json& ops, std::vector<double>& values,
+                    const Shape& shape) {
+  NGRAPH_CHECK(values.size() == shape_size(shape), "Epilogue shape ", shape,
+               " does not match ", values.size(), " values");
+  for (const auto& js : ops) {
+    std::string op = js.at("op");
+    if (op == "BoundedRelu") {
+      double bound = js.at("bound");
+      for (auto& value : values) {
+        value = std::min(std::max(value, 0.0), bound);
+      }
+    } else if (op == "Exp") {
+      for (auto& value : values) {
+        value = std::exp(value);
+      }
+    } else if (op == "Negative") {
+      for (auto& value : values) {
+        value = -value;
+      }
+    } else if (op == "Relu") {
+      for (auto& value : values) {
+        value = std::max(value, 0.0);
+      }
+    } else if (op == "Softmax") {
+      std::vector<size_t> axes = js.at("axes");
+      softmax(values, shape, AxisSet{axes});
+    } else {
+      NGRAPH_CHECK(false, "Unknown epilogue op ", op);
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ngraph/function.hpp"
+#include "ngraph/node.hpp"
+#include "ngraph/shape.hpp"
+#include "nlohmann/json.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Returns whether or not the client can compute a node on the
+/// decrypted result, i.e. the node is a shape-preserving unary op which uses
+/// no server weights: Softmax, Exp, Negative, Relu or BoundedRelu
+/// \param[in] node Node to check
+bool is_epilogue_op(const Node& node);
+
+/// \brief Serializes an epilogue op for the client
+/// \param[in] node Node satisfying is_epilogue_op
+/// \returns JSON object storing the op name and attributes
+nlohmann::json epilogue_op_to_json(const Node& node);
+
+/// \brief Removes the epilogue of a function, i.e. the longest chain of
+/// epilogue ops feeding its single Result, each used only by the next op of
+/// the chain. The Result then reads the input of the chain, so the server
+/// returns the value the epilogue is computed on. The first op of the chain
+/// must not read a Parameter, so the server computes at least one op
+/// \param[in,out] function Function to split
+/// \returns Ops of the epilogue, in execution order, or an empty vector if
+/// the function has no epilogue
+std::vector<std::shared_ptr<Node>> split_epilogue(
+    const std::shared_ptr<Function>& function);
+
+/// \brief Computes an epilogue on plaintext values in place
+/// \param[in] ops JSON array of ops, each serialized by epilogue_op_to_json
+/// \param[in,out] values Row-major values of the tensor
+/// \param[in] shape Shape of the tensor, including the batch axis
+/// \throws ngraph_error if an op is unknown
+void apply_epilogue(const nlohmann::json& ops, std::vector<double>& values,
+                    const Shape& shape);
+
+}  // namespace ngraph::runtime::he
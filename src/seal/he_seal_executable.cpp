@@ -16,18 +16,37 @@
 
 #include "seal/he_seal_executable.hpp"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <deque>
 #include <functional>
+#include <future>
+#include <iterator>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
+#include <random>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+#include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 
 #include "he_op_annotations.hpp"
 #include "he_tensor.hpp"
+#include "he_util.hpp"
+#include "logging/ngraph_he_trace.hpp"
 #include "ngraph/descriptor/layout/dense_tensor_layout.hpp"
 #include "ngraph/ops.hpp"
 #include "ngraph/pass/assign_layout.hpp"
@@ -43,22 +62,42 @@
 #include "ngraph/util.hpp"
 #include "nlohmann/json.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/convolution_bias_relu.hpp"
+#include "op/refresh.hpp"
+#include "op/sum_pool.hpp"
+#include "pass/elide_redundant_relus.hpp"
+#include "pass/fold_constant_subgraphs.hpp"
+#include "pass/fold_layout_ops.hpp"
 #include "pass/he_fusion.hpp"
+#include "pass/he_level_analysis.hpp"
 #include "pass/he_liveness.hpp"
+#include "pass/he_memory_order.hpp"
+#include "pass/insert_refresh.hpp"
+#include "pass/max_pool_to_avg_pool.hpp"
 #include "pass/propagate_he_annotations.hpp"
 #include "pass/supported_ops.hpp"
 #include "protos/message.pb.h"
+#include "seal/he_performance_counter.hpp"
+#include "seal/he_primitive_counter.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_epilogue.hpp"
+#include "seal/he_seal_thread_budget.hpp"
+#include "seal/he_seal_worker_pool.hpp"
 #include "seal/kernel/add_seal.hpp"
 #include "seal/kernel/avg_pool_seal.hpp"
 #include "seal/kernel/batch_norm_inference_seal.hpp"
 #include "seal/kernel/bounded_relu_seal.hpp"
+#include "seal/kernel/compact_slots_seal.hpp"
 #include "seal/kernel/broadcast_seal.hpp"
 #include "seal/kernel/concat_seal.hpp"
 #include "seal/kernel/constant_seal.hpp"
 #include "seal/kernel/convolution_seal.hpp"
+#include "seal/kernel/convolution_slot_packed_seal.hpp"
+#include "seal/kernel/convolution_winograd_seal.hpp"
 #include "seal/kernel/divide_seal.hpp"
+#include "seal/kernel/dot_diagonal_seal.hpp"
 #include "seal/kernel/dot_seal.hpp"
+#include "seal/kernel/elementwise_seal.hpp"
 #include "seal/kernel/exp_seal.hpp"
 #include "seal/kernel/max_pool_seal.hpp"
 #include "seal/kernel/max_seal.hpp"
@@ -67,13 +106,19 @@
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/kernel/negate_seal.hpp"
 #include "seal/kernel/pad_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/polynomial_activation_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
 #include "seal/kernel/power_seal.hpp"
+#include "seal/kernel/refresh_seal.hpp"
 #include "seal/kernel/relu_seal.hpp"
 #include "seal/kernel/rescale_seal.hpp"
 #include "seal/kernel/reshape_seal.hpp"
 #include "seal/kernel/result_seal.hpp"
 #include "seal/kernel/reverse_seal.hpp"
+#include "seal/kernel/scalar_factor_seal.hpp"
 #include "seal/kernel/slice_seal.hpp"
+#include "seal/kernel/slot_layout_seal.hpp"
 #include "seal/kernel/softmax_seal.hpp"
 #include "seal/kernel/subtract_seal.hpp"
 #include "seal/kernel/sum_seal.hpp"
@@ -85,6 +130,18 @@ using ngraph::descriptor::layout::DenseTensorLayout;
 
 namespace ngraph::runtime::he {
 
+namespace {
+/// \brief Runs a single pass on a function through a pass manager
+template <typename T, typename... Args>
+void run_pass(const std::shared_ptr<Function>& function, Args&&... args) {
+  ngraph::pass::Manager pass_manager;
+  pass_manager.set_pass_visualization(false);
+  pass_manager.set_pass_serialization(false);
+  pass_manager.register_pass<T>(std::forward<Args>(args)...);
+  pass_manager.run_passes(function);
+}
+}  // namespace
+
 HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
                                    bool enable_performance_collection,
                                    HESealBackend& he_seal_backend)
@@ -94,7 +151,10 @@ HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
 
   m_context = he_seal_backend.get_context();
   m_port = he_seal_backend.port();
+  m_num_intra_op_threads = he_seal_backend.num_intra_op_threads();
   m_function = function;
+  register_convolution_kernels();
+  register_dot_kernels();
 
   if (!m_context->using_keyswitching()) {
     m_client_eval_key_set = true;
@@ -132,800 +192,4663 @@ HESealExecutable::HESealExecutable(const std::shared_ptr<Function>& function,
   }
 
   NGRAPH_HE_LOG(3) << "Running optimization passes";
-  ngraph::pass::Manager pass_manager;
-  pass_manager.set_pass_visualization(false);
-  pass_manager.set_pass_serialization(false);
-
-  pass_manager.register_pass<ngraph::pass::LikeReplacement>();
-  pass_manager.register_pass<ngraph::pass::AssignLayout<DenseTensorLayout>>();
-  pass_manager.register_pass<ngraph::pass::CoreFusion>();
-  pass_manager.register_pass<ngraph::pass::ConstantFolding>();
-
-  NGRAPH_HE_LOG(4) << "Running passes";
-  pass_manager.run_passes(m_function);
+  // Each pass runs through its own pass manager, so it is timed alone
+  run_compile_pass("LikeReplacement", [this]() {
+    run_pass<ngraph::pass::LikeReplacement>(m_function);
+  });
+  run_compile_pass("AssignLayout", [this]() {
+    run_pass<ngraph::pass::AssignLayout<DenseTensorLayout>>(m_function);
+  });
+  run_compile_pass("CoreFusion", [this]() {
+    run_pass<ngraph::pass::CoreFusion>(m_function);
+  });
+  run_compile_pass("ConstantFolding", [this]() {
+    run_pass<ngraph::pass::ConstantFolding>(m_function);
+  });
+  run_compile_pass("FoldConstantSubgraphs", [this]() {
+    run_pass<pass::FoldConstantSubgraphs>(m_function);
+  });
+  run_compile_pass("FoldLayoutOps", [this]() {
+    run_pass<pass::FoldLayoutOps>(m_function);
+  });
+  run_compile_pass("MaxPoolToAvgPool", [this]() {
+    run_pass<pass::MaxPoolToAvgPool>(m_function, [this](const Node& node) {
+      return m_he_seal_backend.avg_pool_max_pool(node);
+    });
+  });
+  run_compile_pass("ElideRedundantRelus", [this]() {
+    run_pass<pass::ElideRedundantRelus>(
+        m_function, [this](const op::Parameter& param) {
+          return m_he_seal_backend.input_range(param);
+        });
+  });
 
-  ngraph::pass::Manager pass_manager_he;
-  pass_manager_he.set_pass_visualization(false);
-  pass_manager_he.set_pass_serialization(false);
-  pass_manager_he.register_pass<pass::HEFusion>();
-  pass_manager_he.register_pass<pass::HELiveness>();
-  pass_manager_he.register_pass<pass::SupportedOps>(
-      [this](const Node& op) { return m_he_seal_backend.is_supported(op); });
+  if (enable_client() && m_he_seal_backend.client_epilogue()) {
+    for (const auto& node : split_epilogue(m_function)) {
+      m_epilogue.emplace_back(epilogue_op_to_json(*node));
+    }
+  }
+  for (size_t result_idx = 0; result_idx < m_function->get_results().size();
+       ++result_idx) {
+    m_result_indices[m_function->get_results()[result_idx].get()] =
+        result_idx;
+  }
 
   NGRAPH_HE_LOG(4) << "Running HE passes";
-  pass_manager_he.run_passes(m_function);
+  run_compile_pass("HEFusion",
+                   [this]() { run_pass<pass::HEFusion>(m_function); });
+  // The passes after fusion share one topological sort of the function
+  std::list<std::shared_ptr<Node>> fused_ops = m_function->get_ordered_ops();
+  run_compile_pass("SupportedOps", [this, &fused_ops]() {
+    pass::SupportedOps([this](const Node& op) {
+      return m_he_seal_backend.is_supported(op);
+    }).run_on_ordered_ops(fused_ops);
+  });
+  run_compile_pass("HELiveness", [this, &fused_ops]() {
+    pass::HELiveness::run_on_ordered_ops(*m_function, fused_ops);
+  });
 
   update_he_op_annotations();
+  if (m_he_seal_backend.auto_encryption_parameters()) {
+    run_compile_pass("PlanEncryptionParameters",
+                     [this]() { plan_encryption_parameters(); });
+  }
+  m_dry_run = m_he_seal_backend.dry_run();
+  if (m_dry_run || m_he_seal_backend.latency_slo_ms() > 0) {
+    check_cost_estimate();
+  }
+  run_compile_pass("SelectPackingLayouts",
+                   [this]() { select_packing_layouts(); });
+  if (m_dry_run) {
+    return;
+  }
+  encrypt_constants();
+  materialize_constants();
+  prepare_galois_keys();
+  if (m_he_seal_backend.warmup_on_compile()) {
+    if (enable_client()) {
+      NGRAPH_HE_LOG(1) << "Skipping warmup, since the client is enabled";
+    } else {
+      warmup();
+    }
+  }
 }
 
 HESealExecutable::~HESealExecutable() noexcept {
   NGRAPH_HE_LOG(3) << "~HESealExecutable()";
   if (m_server_setup) {
-    if (m_message_handling_thread.joinable()) {
-      NGRAPH_HE_LOG(5) << "Waiting for m_message_handling_thread to join";
-      try {
-        m_message_handling_thread.join();
-      } catch (std::exception& e) {
-        NGRAPH_ERR << "Exception closing executable thread " << e.what();
+    // A metrics server accepts scrapes until closed
+    if (m_metrics_server != nullptr) {
+      boost::asio::post(m_io_context, [this]() { m_metrics_server->close(); });
+    }
+    // Further connections may be accepted, or may still await service, so
+    // the io context would not run out of work
+    if (m_he_seal_backend.max_clients() > 1) {
+      m_io_context.stop();
+    }
+    NGRAPH_HE_LOG(5) << "Waiting for m_message_handling_threads to join";
+    for (auto& thread : m_message_handling_threads) {
+      if (thread.joinable()) {
+        try {
+          thread.join();
+        } catch (std::exception& e) {
+          NGRAPH_ERR << "Exception closing executable thread " << e.what();
+        }
       }
-      NGRAPH_HE_LOG(5) << "m_message_handling_thread joined";
     }
+    NGRAPH_HE_LOG(5) << "m_message_handling_threads joined";
 
     // m_acceptor and m_io_context both free the socket? Avoid double-free
-    try {
-      m_acceptor->close();
-    } catch (std::exception& e) {
-      NGRAPH_ERR << "Exception closing m_acceptor " << e.what();
+    if (m_acceptor != nullptr) {
+      try {
+        m_acceptor->close();
+      } catch (std::exception& e) {
+        NGRAPH_ERR << "Exception closing m_acceptor " << e.what();
+      }
     }
     m_acceptor = nullptr;
+    m_shm_accept_timer = nullptr;
+    m_shm_channel = nullptr;
     m_session = nullptr;
+    m_pending_sessions.clear();
   }
 }
 
 void HESealExecutable::update_he_op_annotations() {
   NGRAPH_HE_LOG(3) << "Upadting HE op annotations";
-  ngraph::pass::Manager pass_manager_he;
-  pass_manager_he.register_pass<pass::PropagateHEAnnotations>();
-  pass_manager_he.run_passes(m_function);
+  run_compile_pass("PropagateHEAnnotations", [this]() {
+    run_pass<pass::PropagateHEAnnotations>(
+        m_function, m_he_seal_backend.encrypt_constants());
+  });
+  if (enable_client() && !m_he_seal_backend.auto_encryption_parameters()) {
+    // The client refreshes values which would run out of levels. Selected
+    // encryption parameters support the function's depth instead
+    run_compile_pass("InsertRefresh", [this]() {
+      pass::InsertRefresh insert_refresh(
+          m_context->first_context_data()->chain_index() /
+              m_he_seal_backend.rescale_primes(),
+          [this](const Node& node) { return polynomial_op_depth(node); },
+          [this](const Node& node) { return quantized_weights(node); });
+      if (insert_refresh.run_on_function(m_function)) {
+        pass::HELiveness().run_on_function(m_function);
+      }
+    });
+  }
+  pass::HELevelAnalysis level_analysis(
+      enable_client(),
+      [this](const Node& node) { return polynomial_op_depth(node); },
+      [this](const Node& node) { return quantized_weights(node); });
+  run_compile_pass("HELevelAnalysis", [this, &level_analysis]() {
+    level_analysis.run_on_function(m_function);
+  });
   m_is_compiled = true;
 
   m_nodes.clear();
-  for (auto node : m_function->get_ordered_ops()) {
+  std::list<std::shared_ptr<Node>> ordered_ops = m_function->get_ordered_ops();
+  if (m_he_seal_backend.memory_node_order()) {
+    run_compile_pass("HEMemoryOrder", [&]() {
+      ordered_ops = pass::memory_minimizing_order(
+          ordered_ops, [&](const Node& node, size_t output_idx) {
+            return estimated_ciphertext_bytes(node, output_idx,
+                                              level_analysis);
+          });
+      // Tensors are freed after their last reader in the new order
+      pass::HELiveness::run_on_ordered_ops(*m_function, ordered_ops);
+    });
+  }
+  for (auto node : ordered_ops) {
     m_nodes.push_back(node);
   }
   set_parameters_and_results(*m_function);
+  run_compile_pass("ExecutionPlan",
+                   [&]() { build_execution_plan(level_analysis); });
 }
 
-size_t HESealExecutable::batch_size() const { return m_batch_size; }
+void HESealExecutable::run_compile_pass(const std::string& name,
+                                        const std::function<void()>& pass) {
+  auto start = std::chrono::steady_clock::now();
+  pass();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  NGRAPH_HE_LOG(1) << "Compilation pass " << name << " took "
+                   << elapsed.count() * 1e3 << " ms";
+  // Passes rerun when the annotations are updated for a call keep their
+  // last duration
+  auto it = std::find_if(
+      m_compile_pass_times.begin(), m_compile_pass_times.end(),
+      [&name](const auto& pass_time) { return pass_time.first == name; });
+  if (it == m_compile_pass_times.end()) {
+    m_compile_pass_times.emplace_back(name, elapsed.count() * 1e3);
+  } else {
+    it->second = elapsed.count() * 1e3;
+  }
+  if (record_metrics()) {
+    m_metrics.set_gauge("he_compile_pass_seconds",
+                        "Duration of the last run of each compilation pass",
+                        elapsed.count(), {{"pass", name}});
+  }
+}
 
-void HESealExecutable::set_batch_size(size_t batch_size) {
-  size_t max_batch_size = m_he_seal_backend.get_ckks_encoder()->slot_count();
-  if (complex_packing()) {
-    max_batch_size *= 2;
+size_t HESealExecutable::estimated_ciphertext_bytes(
+    const Node& node, size_t output_idx,
+    const pass::HELevelAnalysis& level_analysis) const {
+  auto depth = level_analysis.depth(node);
+  if (!depth.has_value()) {
+    return 0;
   }
-  NGRAPH_CHECK(batch_size <= max_batch_size, "Batch size ", batch_size,
-               " too large (maximum ", max_batch_size, ")");
-  m_batch_size = batch_size;
+  const auto& parms = m_he_seal_backend.get_encryption_parameters()
+                          .seal_encryption_parameters();
+  size_t data_moduli = parms.coeff_modulus().size() -
+                       (m_context->using_keyswitching() ? 1 : 0);
+  size_t num_moduli = data_moduli - std::min(*depth, data_moduli - 1);
+
+  const Shape& shape = node.get_output_shape(output_idx);
+  size_t ciphertexts = shape_size(shape);
+  bool packed = HEOpAnnotations::has_he_annotation(node) &&
+                HEOpAnnotations::he_op_annotation(node)->packed();
+  if (packed && ciphertexts > 0) {
+    ciphertexts /= HETensor::batch_size(shape, true);
+  }
+  return ciphertexts * 2 * parms.poly_modulus_degree() * num_moduli *
+         sizeof(uint64_t);
+}
 
-  NGRAPH_HE_LOG(5) << "Server set batch size to " << m_batch_size;
+std::optional<size_t> HESealExecutable::polynomial_activation_depth(
+    const Node& node) const {
+  auto type_id = get_typeid(node.get_type_info());
+  if (type_id != OP_TYPEID::Relu && type_id != OP_TYPEID::BoundedRelu &&
+      type_id != OP_TYPEID::ConvolutionBiasRelu &&
+      type_id != OP_TYPEID::MaxPool) {
+    return std::nullopt;
+  }
+  auto activation = m_he_seal_backend.polynomial_activation(node);
+  if (activation == PolynomialActivation::none) {
+    return std::nullopt;
+  }
+  if (type_id == OP_TYPEID::MaxPool) {
+    const auto* max_pool = static_cast<const op::MaxPool*>(&node);
+    return polynomial_max_pool_depth(max_pool->get_window_shape(), activation);
+  }
+  return polynomial_relu_depth(activation);
 }
 
-void HESealExecutable::set_verbose_all_ops(bool value) {
-  m_verbose_all_ops = value;
+std::optional<size_t> HESealExecutable::polynomial_op_depth(
+    const Node& node) const {
+  if (auto activation_depth = polynomial_activation_depth(node)) {
+    return activation_depth;
+  }
+  size_t degree = m_he_seal_backend.polynomial_degree();
+  const auto& range = m_he_seal_backend.polynomial_divisor_range();
+  auto reciprocal_depth = [&](double lower, double upper) {
+    return polynomial_depth(reciprocal_polynomial(lower, upper, degree));
+  };
+  auto type_id = get_typeid(node.get_type_info());
+  if (degree > 0 && type_id == OP_TYPEID::Exp) {
+    return polynomial_depth(exp_polynomial(m_he_seal_backend));
+  }
+  if (degree > 0 && type_id == OP_TYPEID::Softmax) {
+    // The range of the reciprocal does not affect its depth
+    return polynomial_depth(exp_polynomial(m_he_seal_backend)) +
+           reciprocal_depth(range.first, range.second) + 1;
+  }
+  if (degree > 0 && type_id == OP_TYPEID::Divide) {
+    const auto& divisor = *node.get_argument(1);
+    if (HEOpAnnotations::has_he_annotation(divisor) &&
+        HEOpAnnotations::he_op_annotation(divisor)->encrypted()) {
+      return reciprocal_depth(range.first, range.second) + 1;
+    }
+  }
+  if (type_id == OP_TYPEID::Power) {
+    auto exponent =
+        std::dynamic_pointer_cast<op::Constant>(node.get_argument(1));
+    if (exponent != nullptr) {
+      std::vector<double> values = exponent->cast_vector<double>();
+      HEPlaintext exponent_values(values.size());
+      std::copy(values.begin(), values.end(), exponent_values.begin());
+      if (auto n = integer_exponent(exponent_values)) {
+        std::vector<double> monomial(*n + 1, 0);
+        monomial.back() = 1;
+        return polynomial_depth(monomial);
+      }
+    }
+  }
+  return std::nullopt;
 }
 
-OP_TYPEID HESealExecutable::get_typeid(const NodeTypeInfo& type_info) {
-  {
-    // This expands the op list in op_tbl.hpp into a list of enumerations that
-    // look like this: {Abs::type_info, OP_TYPEID::Abs}, {Acos::type_info,
-    // OP_TYPEID::Acos},
-    // ...
-    static const std::map<NodeTypeInfo, OP_TYPEID> type_info_map{
-#define NGRAPH_OP(NAME, NAMESPACE) \
-  {NAMESPACE::NAME::type_info, OP_TYPEID::ID_SUFFIX(NAME)},
-#include "opset_he_seal_tbl.hpp"
-#undef NGRAPH_OP
-    };
-    OP_TYPEID rc = OP_TYPEID::UnknownOp;
+bool HESealExecutable::quantized_weights(const Node& node) const {
+  double step = m_he_seal_backend.quantized_weight_step();
+  auto type_id = get_typeid(node.get_type_info());
+  if (step == 0 ||
+      (type_id != OP_TYPEID::Dot && type_id != OP_TYPEID::Convolution &&
+       type_id != OP_TYPEID::GroupConvolution)) {
+    return false;
+  }
+  // Streamed Dot ops do not group their products by weight
+  if (type_id == OP_TYPEID::Dot && m_he_seal_backend.stream_client_inputs()) {
+    return false;
+  }
+  auto weights = std::dynamic_pointer_cast<op::Constant>(node.get_argument(1));
+  if (weights == nullptr || (HEOpAnnotations::has_he_annotation(*weights) &&
+                             HEOpAnnotations::he_op_annotation(*weights)
+                                 ->encrypted())) {
+    return false;
+  }
+  for (double value : weights->cast_vector<double>()) {
+    if (std::abs(value) >= 1e-5 && !quantize_weight(value, step)) {
+      return false;
+    }
+  }
+  return true;
+}
 
-    auto it = type_info_map.find(type_info);
-    if (it != type_info_map.end()) {
-      rc = it->second;
+std::optional<int> HESealExecutable::weight_prime_bits(
+    const Node& node) const {
+  auto type_id = get_typeid(node.get_type_info());
+  auto is_plain_constant = [](const std::shared_ptr<Node>& arg) {
+    return arg->is_constant() &&
+           !(HEOpAnnotations::has_he_annotation(*arg) &&
+             HEOpAnnotations::he_op_annotation(*arg)->encrypted());
+  };
+  std::shared_ptr<Node> weights;
+  switch (type_id) {
+    case OP_TYPEID::AvgPool:
+      // Window sums are multiplied by the inverse window size
+      return m_he_seal_backend.weight_scale_bits();
+    case OP_TYPEID::Convolution:
+    case OP_TYPEID::ConvolutionBiasRelu:
+    case OP_TYPEID::Dot:
+    case OP_TYPEID::GroupConvolution:
+      weights = node.get_argument(1);
+      break;
+    case OP_TYPEID::Multiply:
+      for (const auto& arg : node.get_arguments()) {
+        if (is_plain_constant(arg)) {
+          weights = arg;
+        }
+      }
+      break;
+    default:
+      break;
+  }
+  if (weights == nullptr || !is_plain_constant(weights)) {
+    return std::nullopt;
+  }
+  double max_weight = 0;
+  for (double value :
+       std::static_pointer_cast<op::Constant>(weights)->cast_vector<double>()) {
+    max_weight = std::max(max_weight, std::abs(value));
+  }
+  int integer_bits =
+      max_weight > 1 ? static_cast<int>(std::ceil(std::log2(max_weight))) : 0;
+  return m_he_seal_backend.weight_scale_bits() + integer_bits;
+}
+
+std::vector<int> HESealExecutable::level_prime_bits(
+    const pass::HELevelAnalysis& level_analysis, int scale_bits) const {
+  // SEAL finds too few primes congruent to 1 modulo 2N of fewer bits
+  constexpr int min_prime_bits = 20;
+  std::vector<int> level_bits(level_analysis.max_depth(), 0);
+  for (const auto& node : m_function->get_ordered_ops()) {
+    auto depth = level_analysis.depth(*node);
+    if (!depth.has_value()) {
+      continue;
+    }
+    size_t input_depth = 0;
+    for (const auto& arg : node->get_arguments()) {
+      input_depth =
+          std::max(input_depth, level_analysis.depth(*arg).value_or(0));
+    }
+    if (*depth <= input_depth) {
+      continue;
+    }
+    // A product with Constant weights is rescaled by a prime of the weights'
+    // precision. Other rescales, e.g. of ciphertext products, divide by the
+    // scale, so the prime matches it
+    std::optional<int> bits;
+    if (*depth == input_depth + 1) {
+      bits = weight_prime_bits(*node);
+    }
+    for (size_t level = input_depth; level < *depth; ++level) {
+      level_bits[level] =
+          std::max(level_bits[level], bits.value_or(scale_bits));
     }
-    return rc;
   }
+  for (size_t level = 0; level < level_bits.size(); ++level) {
+    int bits = level_bits[level] == 0 ? scale_bits : level_bits[level];
+    level_bits[level] = std::clamp(bits, min_prime_bits, scale_bits);
+    NGRAPH_HE_LOG(3) << "Rescale " << level << " drops a prime of "
+                     << level_bits[level] << " bits";
+  }
+  return level_bits;
 }
 
-void HESealExecutable::check_client_supports_function() {
-  // Check if single parameter is from client
-  size_t from_client_count = 0;
+void HESealExecutable::plan_encryption_parameters() {
+  pass::HELevelAnalysis level_analysis(
+      enable_client(),
+      [this](const Node& node) { return polynomial_op_depth(node); },
+      [this](const Node& node) { return quantized_weights(node); });
+  level_analysis.run_on_function(m_function);
+  size_t depth = level_analysis.max_depth();
+
+  const auto& current_parms = m_he_seal_backend.get_encryption_parameters();
+  bool complex_packing = current_parms.complex_packing();
+  size_t min_slots = 1;
   for (const auto& param : get_parameters()) {
-    if (HEOpAnnotations::from_client(*param)) {
-      from_client_count++;
-      NGRAPH_HE_LOG(5) << "Parameter " << param->get_name() << " from client";
+    if (HEOpAnnotations::has_he_annotation(*param) &&
+        HEOpAnnotations::he_op_annotation(*param)->packed()) {
+      min_slots = std::max<size_t>(
+          min_slots, HETensor::batch_size(param->get_shape(), true));
     }
   }
-  NGRAPH_CHECK(get_results().size() == 1,
-               "HESealExecutable only supports output size 1 (got ",
-               get_results().size(), ")");
-  NGRAPH_CHECK(from_client_count > 0, "Expected > 0 parameters from client");
-}
+  auto scale_bits =
+      static_cast<int>(std::lround(std::log2(current_parms.scale())));
+  std::vector<int> level_bits(depth, scale_bits);
+  if (m_he_seal_backend.weight_scale_bits() > 0) {
+    level_bits = level_prime_bits(level_analysis, scale_bits);
+  }
+  auto parms = HESealEncryptionParameters::select_for_prime_bits(
+      level_bits, min_slots, current_parms.security_level(), scale_bits,
+      complex_packing);
+  NGRAPH_HE_LOG(1) << "Selected poly_modulus_degree "
+                   << parms.poly_modulus_degree() << " with "
+                   << parms.seal_encryption_parameters().coeff_modulus().size()
+                   << " coefficient moduli for multiplicative depth " << depth;
+
+  m_he_seal_backend.update_encryption_parameters(parms);
+  m_context = m_he_seal_backend.get_context();
+  if (!m_context->using_keyswitching()) {
+    m_client_eval_key_set = true;
+  }
 
-bool HESealExecutable::server_setup() {
-  if (!m_server_setup) {
-    NGRAPH_HE_LOG(1) << "Enable client";
+  // Each ciphertext op costs roughly one pass over the coefficients of each
+  // remaining prime, i.e. poly_modulus_degree times the number of primes at
+  // the op's level
+  size_t data_primes =
+      parms.seal_encryption_parameters().coeff_modulus().size() - 1;
+  size_t slots = complex_packing ? parms.poly_modulus_degree()
+                                 : parms.poly_modulus_degree() / 2;
+  double total_cost = 0;
+  for (const auto& node : m_function->get_ordered_ops()) {
+    auto node_depth = level_analysis.depth(*node);
+    if (!node_depth.has_value() || node->is_parameter() ||
+        node->get_output_size() == 0) {
+      continue;
+    }
+    const Shape& shape = node->get_output_shape(0);
+    bool packed = HEOpAnnotations::has_he_annotation(*node) &&
+                  HEOpAnnotations::he_op_annotation(*node)->packed();
+    size_t num_ciphertexts = shape_size(shape);
+    if (packed && shape_size(shape) > 0) {
+      num_ciphertexts /= HETensor::batch_size(shape, true);
+    }
+    size_t ciphertext_primes =
+        data_primes - std::min(*node_depth, data_primes - 1);
+    double cost = static_cast<double>(num_ciphertexts) *
+                  static_cast<double>(ciphertext_primes) *
+                  static_cast<double>(parms.poly_modulus_degree());
+    total_cost += cost;
+    NGRAPH_HE_LOG(1) << "Estimated cost of " << node->get_name() << ": "
+                     << num_ciphertexts << " ciphertexts at depth "
+                     << *node_depth << ", " << cost
+                     << " coefficient operations";
+  }
+  NGRAPH_HE_LOG(1) << "Estimated total cost: " << total_cost
+                   << " coefficient operations, " << slots
+                   << " slots per ciphertext";
+}
 
-    check_client_supports_function();
+HECostReport HESealExecutable::estimate_cost() const {
+  pass::HELevelAnalysis level_analysis(
+      enable_client(),
+      [this](const Node& node) { return polynomial_op_depth(node); },
+      [this](const Node& node) { return quantized_weights(node); });
+  level_analysis.run_on_function(m_function);
+
+  const auto& parms = m_he_seal_backend.get_encryption_parameters()
+                           .seal_encryption_parameters();
+  size_t degree = parms.poly_modulus_degree();
+  size_t data_moduli = parms.coeff_modulus().size() -
+                       (m_context->using_keyswitching() ? 1 : 0);
+  NGRAPH_CHECK(data_moduli > 0, "No coefficient moduli to estimate cost");
+  auto num_moduli = [&](size_t depth) {
+    return data_moduli - std::min(depth, data_moduli - 1);
+  };
+  auto cipher_bytes = [&](size_t depth) {
+    return 2 * degree * num_moduli(depth) * sizeof(uint64_t);
+  };
+  const HECostCalibration& calibration = m_he_seal_backend.cost_calibration();
+  size_t client_depth = m_he_seal_backend.client_mod_switch()
+                            ? data_moduli - 1
+                            : std::numeric_limits<size_t>::max();
+
+  HECostReport report;
+  report.max_depth = level_analysis.max_depth();
+  report.max_supported_depth = data_moduli - 1;
+  std::vector<size_t> slot_bytes(m_num_tensor_slots, 0);
+  size_t live_bytes = 0;
+
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    const auto& node = m_nodes[node_idx];
+    const NodeSlots& node_slots = m_node_slots[node_idx];
+    HENodeCost cost;
+    cost.node = node;
+
+    size_t input_depth = 0;
+    size_t encrypted_inputs = 0;
+    for (const auto& arg : node->get_arguments()) {
+      if (auto arg_depth = level_analysis.depth(*arg)) {
+        input_depth = std::max(input_depth, *arg_depth);
+        encrypted_inputs++;
+      }
+    }
+    auto depth = level_analysis.depth(*node);
+    if (depth.has_value()) {
+      cost.depth = *depth;
+      cost.levels = *depth > input_depth ? *depth - input_depth : 0;
+    }
 
-    NGRAPH_HE_LOG(1) << "Starting server";
-    start_server();
+    // Ciphertexts of each output, as packed along the batch axis
+    bool packed = HEOpAnnotations::has_he_annotation(*node) &&
+                  HEOpAnnotations::he_op_annotation(*node)->packed();
+    for (size_t i = 0; i < node->get_output_size(); ++i) {
+      if (!depth.has_value()) {
+        break;
+      }
+      const Shape& shape = node->get_output_shape(i);
+      size_t output_ciphertexts = shape_size(shape);
+      if (packed && output_ciphertexts > 0) {
+        output_ciphertexts /= HETensor::batch_size(shape, true);
+      }
+      cost.ciphertexts += output_ciphertexts;
+      size_t bytes = output_ciphertexts * cipher_bytes(*depth);
+      live_bytes -= slot_bytes[node_slots.outputs[i]];
+      live_bytes += bytes;
+      slot_bytes[node_slots.outputs[i]] = bytes;
+    }
 
-#ifdef NGRAPH_HE_ABY_ENABLE
-    if (enable_garbled_circuits()) {
-      m_aby_executor = std::make_unique<aby::ABYServerExecutor>(
-          *this, std::string("yao"), std::string("0.0.0.0"), 34001, 128, 64, 2,
-          m_he_seal_backend.num_garbled_circuit_threads());
+    size_t ciphertexts = cost.ciphertexts;
+    auto count = [&cost](HEPrimitive primitive, size_t calls) {
+      cost.primitives[static_cast<size_t>(primitive)] += calls;
+    };
+    auto type_id = get_typeid(node->get_type_info());
+    // Refreshes are streamed to the client like activations
+    bool client_activation =
+        enable_client() && !polynomial_activation_depth(*node).has_value() &&
+        (type_id == OP_TYPEID::Relu || type_id == OP_TYPEID::BoundedRelu ||
+         type_id == OP_TYPEID::MaxPool || type_id == OP_TYPEID::Max ||
+         type_id == OP_TYPEID::ConvolutionBiasRelu ||
+         type_id == OP_TYPEID::Refresh) &&
+        !client_fused_relu(*node);
+    client_activation = client_activation || client_elementwise_op(*node);
+    size_t sent_depth = std::min(input_depth, client_depth);
+
+    if (!depth.has_value()) {
+      // Plaintext nodes are computed without HE primitives
+    } else if (node->is_parameter()) {
+      if (HEOpAnnotations::from_client(*node)) {
+        cost.bytes_received = ciphertexts * cipher_bytes(0);
+      } else {
+        count(HEPrimitive::encode, ciphertexts);
+        count(HEPrimitive::encrypt, ciphertexts);
+      }
+    } else if (node->is_output()) {
+      if (enable_client()) {
+        cost.bytes_sent = ciphertexts * cipher_bytes(*depth);
+        cost.round_trips = 1;
+      }
+    } else if (client_activation && (type_id == OP_TYPEID::MaxPool ||
+                                     type_id == OP_TYPEID::Max)) {
+      // Each output is the maximum of one window, and all windows are sent
+      // in one request
+      size_t window = 0;
+      if (type_id == OP_TYPEID::MaxPool) {
+        const auto* max_pool = static_cast<const op::MaxPool*>(node.get());
+        window = shape_size(max_pool->get_window_shape());
+      } else {
+        window = shape_size(node->get_input_shape(0)) /
+                 shape_size(node->get_output_shape(0));
+      }
+      cost.bytes_sent = ciphertexts * window * cipher_bytes(sent_depth);
+      cost.bytes_received = ciphertexts * cipher_bytes(0);
+      cost.round_trips = 1;
+      count(HEPrimitive::encode, ciphertexts);
+      count(HEPrimitive::encrypt, ciphertexts);
+    } else {
+      size_t products = 0;
+      switch (type_id) {
+        case OP_TYPEID::Dot: {
+          const auto* dot = static_cast<const op::Dot*>(node.get());
+          const Shape& arg_shape = node->get_input_shape(0);
+          size_t reduction = 1;
+          for (size_t i = arg_shape.size() - dot->get_reduction_axes_count();
+               i < arg_shape.size(); ++i) {
+            reduction *= arg_shape[i];
+          }
+          products = ciphertexts * reduction;
+          break;
+        }
+        case OP_TYPEID::Convolution:
+        case OP_TYPEID::ConvolutionBiasRelu:
+        case OP_TYPEID::GroupConvolution: {
+          // Each output reads the filter weights of its output channel
+          const Shape& filter_shape = node->get_input_shape(1);
+          products = ciphertexts * shape_size(filter_shape) /
+                     std::max<size_t>(node->get_output_shape(0)[1], 1);
+          break;
+        }
+        case OP_TYPEID::AvgPool:
+        case OP_TYPEID::BatchNormInference:
+          products = ciphertexts;
+          break;
+        case OP_TYPEID::Multiply:
+          if (encrypted_inputs < 2) {
+            products = ciphertexts;
+            count(HEPrimitive::encode, ciphertexts);
+          }
+          break;
+        default:
+          break;
+      }
+      count(HEPrimitive::multiply_plain, products);
+
+      // Cipher-cipher products, including those of polynomials
+      size_t multiplies = 0;
+      auto approximation_depth =
+          client_activation ? std::nullopt : polynomial_op_depth(*node);
+      if (type_id == OP_TYPEID::Multiply && encrypted_inputs == 2) {
+        multiplies = ciphertexts;
+      } else if (approximation_depth.has_value()) {
+        multiplies = ciphertexts * *approximation_depth;
+      } else if (type_id == OP_TYPEID::Power) {
+        multiplies = ciphertexts * std::max<size_t>(cost.levels, 1);
+      }
+      count(HEPrimitive::multiply, multiplies);
+      if (!m_he_seal_backend.lazy_relinearization()) {
+        count(HEPrimitive::relinearize, multiplies);
+      }
+      count(HEPrimitive::rescale, ciphertexts * cost.levels);
+
+      if (client_activation) {
+        // Values are streamed in chunks, of which relu_window await a
+        // response at once
+        cost.bytes_sent = ciphertexts * cipher_bytes(sent_depth);
+        cost.bytes_received = ciphertexts * cipher_bytes(0);
+        size_t window = m_he_seal_backend.relu_window() != 0
+                            ? m_he_seal_backend.relu_window()
+                            : s_default_relu_window;
+        size_t chunks =
+            ceil_div(cost.bytes_sent, m_he_seal_backend.relu_chunk_bytes());
+        cost.round_trips = ceil_div(chunks, window);
+        count(HEPrimitive::encode, ciphertexts);
+        count(HEPrimitive::encrypt, ciphertexts);
+      }
     }
-#endif
 
-    std::stringstream param_stream;
-    m_he_seal_backend.get_encryption_parameters().save(param_stream);
+    size_t moduli = num_moduli(input_depth);
+    for (size_t i = 0; i < s_num_he_primitives; ++i) {
+      cost.latency_us +=
+          static_cast<double>(cost.primitives[i]) *
+          calibration.primitive_cost_us(static_cast<HEPrimitive>(i), degree,
+                                        moduli);
+    }
+    cost.latency_us +=
+        static_cast<double>(cost.bytes_sent + cost.bytes_received) *
+            calibration.byte_us +
+        static_cast<double>(cost.round_trips) * calibration.round_trip_us;
+
+    cost.live_bytes = live_bytes;
+    if (live_bytes > report.peak_live_bytes || report.peak_node == nullptr) {
+      report.peak_live_bytes = live_bytes;
+      report.peak_node = node;
+    }
+    for (size_t slot : node_slots.free) {
+      live_bytes -= slot_bytes[slot];
+      slot_bytes[slot] = 0;
+    }
+    report.latency_us += cost.latency_us;
+    report.nodes.emplace_back(std::move(cost));
+  }
+  return report;
+}
 
-    pb::EncryptionParameters pb_params;
-    *pb_params.mutable_encryption_parameters() = param_stream.str();
+void HESealExecutable::check_cost_estimate() const {
+  HECostReport report = estimate_cost();
+  for (const auto& cost : report.nodes) {
+    NGRAPH_HE_LOG(1) << "Estimated " << cost.node->get_name() << ": "
+                     << cost.ciphertexts << " ciphertexts at depth "
+                     << cost.depth << ", " << cost.bytes_sent
+                     << " bytes sent, " << cost.bytes_received
+                     << " bytes received, " << cost.latency_us / 1000
+                     << "ms";
+  }
+  double latency_ms = report.latency_us / 1000;
+  NGRAPH_HE_LOG(1) << "Estimated latency " << latency_ms
+                   << "ms, depth " << report.max_depth << " of "
+                   << report.max_supported_depth << " supported, peak "
+                   << report.peak_live_bytes << " ciphertext bytes";
+
+  double latency_slo_ms = m_he_seal_backend.latency_slo_ms();
+  if (latency_slo_ms > 0) {
+    NGRAPH_CHECK(report.depth_supported(), "Function depth ",
+                 report.max_depth, " exceeds the supported depth ",
+                 report.max_supported_depth);
+    NGRAPH_CHECK(latency_ms <= latency_slo_ms, "Estimated latency ",
+                 latency_ms, "ms exceeds the latency SLO of ", latency_slo_ms,
+                 "ms");
+  }
+}
 
-    pb::TCPMessage pb_message;
-    *pb_message.mutable_encryption_parameters() = pb_params;
-    pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+void HESealExecutable::select_packing_layouts() {
+  m_slot_packed_convolutions.clear();
+  {
+    // Waits for the prefetches, which read the matrices
+    std::lock_guard<std::mutex> guard(m_encoded_dot_weights_mutex);
+    m_dot_weight_prefetches.clear();
+    m_encoded_dot_weights.clear();
+    m_encoded_dot_weight_bytes = 0;
+    m_dot_inputs.clear();
+  }
+  m_slot_packed_dots.clear();
+  if (!m_he_seal_backend.auto_packing_layout()) {
+    return;
+  }
+  if (enable_client() || complex_packing() ||
+      m_he_seal_backend.sparse_encoding() ||
+      m_he_seal_backend.encrypt_constants()) {
+    NGRAPH_HE_LOG(1) << "Keeping the batch packing layout, since slot "
+                        "packing is unsupported by the configuration";
+    return;
+  }
+  HECostReport report = estimate_cost();
+  if (!report.depth_supported()) {
+    return;
+  }
+  // Packing the input of a slot-packed Convolution consumes a coefficient
+  // modulus the batch layout does not
+  size_t spare_levels = report.max_supported_depth - report.max_depth;
+  const size_t slot_count = m_he_seal_backend.get_ckks_encoder()->slot_count();
+
+  // Slots other than slot 0 of unpacked ciphertexts store garbage, so
+  // nodes depending on a slot-packed Convolution cannot be packed again
+  std::unordered_set<const Node*> unpacked;
+  for (const auto& cost : report.nodes) {
+    const Node& node = *cost.node;
+    bool depends_on_unpacked = false;
+    for (const auto& arg : node.get_arguments()) {
+      if (unpacked.find(arg.get()) != unpacked.end()) {
+        depends_on_unpacked = true;
+      }
+    }
+    if (depends_on_unpacked) {
+      unpacked.insert(&node);
+      continue;
+    }
+    if (spare_levels == 0 || cost.levels != 1 || quantized_weights(node)) {
+      continue;
+    }
+    if (get_typeid(node.get_type_info()) == OP_TYPEID::Dot) {
+      std::vector<double> matrix = slot_packed_dot_matrix(node);
+      if (matrix.empty()) {
+        continue;
+      }
+      size_t input_depth = cost.depth - 1;
+      double batch_us = direct_dot_us(node, input_depth);
+      double slot_us = slot_packed_dot_us(node, input_depth);
+      NGRAPH_HE_LOG(3) << "Estimated cost of " << node.get_name()
+                       << " for batch size 1: " << batch_us
+                       << "us in the batch layout, " << slot_us
+                       << "us in the slot-packed layout";
+      if (slot_us < batch_us) {
+        NGRAPH_HE_LOG(1) << "Computing " << node.get_name()
+                         << " in the slot-packed layout for batch size 1";
+        m_slot_packed_dots[&node] = std::move(matrix);
+        unpacked.insert(&node);
+        spare_levels--;
+      }
+      continue;
+    }
+    if (get_typeid(node.get_type_info()) != OP_TYPEID::Convolution) {
+      continue;
+    }
+    const auto* conv = static_cast<const op::Convolution*>(&node);
+    const Shape& data_shape = node.get_input_shape(0);
+    const Shape& filter_shape = node.get_input_shape(1);
+    auto filter = std::dynamic_pointer_cast<op::Constant>(node.get_argument(1));
+    auto is_zero = [](std::ptrdiff_t pad) { return pad == 0; };
+    auto is_one = [](size_t dilation) { return dilation == 1; };
+    if (data_shape.size() != 4 || data_shape[0] != 1 || filter == nullptr ||
+        shape_size(data_shape) > slot_count ||
+        !std::all_of(conv->get_padding_below().begin(),
+                     conv->get_padding_below().end(), is_zero) ||
+        !std::all_of(conv->get_padding_above().begin(),
+                     conv->get_padding_above().end(), is_zero) ||
+        !std::all_of(conv->get_data_dilation_strides().begin(),
+                     conv->get_data_dilation_strides().end(), is_one)) {
+      continue;
+    }
+    std::vector<double> filter_values = filter->cast_vector<double>();
+    const size_t out_channels = filter_shape[0];
+    const size_t taps = shape_size(filter_shape) / out_channels;
+    bool channels_used = true;
+    for (size_t oc = 0; oc < out_channels; ++oc) {
+      auto begin = filter_values.begin() + oc * taps;
+      channels_used = channels_used &&
+                      std::any_of(begin, begin + taps,
+                                  [](double value) { return value != 0.; });
+    }
+    if (!channels_used) {
+      continue;
+    }
 
-    TCPMessage parms_message(std::move(pb_message));
-    NGRAPH_HE_LOG(3) << "Server waiting until session started";
-    std::unique_lock<std::mutex> mlock(m_session_mutex);
-    m_session_cond.wait(mlock, [this]() { return this->session_started(); });
+    // Costs of the layouts for one image
+    size_t input_depth = cost.depth - 1;
+    double batch_us = direct_convolution_us(
+        node, shape_size(node.get_output_shape(0)), input_depth);
+    double slot_us = slot_packed_convolution_us(node, input_depth);
+    NGRAPH_HE_LOG(3) << "Estimated cost of " << node.get_name()
+                     << " for batch size 1: " << batch_us
+                     << "us in the batch layout, " << slot_us
+                     << "us in the slot-packed layout";
+    if (slot_us < batch_us) {
+      NGRAPH_HE_LOG(1) << "Computing " << node.get_name()
+                       << " in the slot-packed layout for batch size 1";
+      m_slot_packed_convolutions[&node] = std::move(filter_values);
+      unpacked.insert(&node);
+      spare_levels--;
+    }
+  }
+}
 
-    NGRAPH_HE_LOG(3) << "Server writing parameters message";
-    m_session->write_message(std::move(parms_message));
-    m_server_setup = true;
+std::vector<double> HESealExecutable::slot_packed_dot_matrix(
+    const Node& node) const {
+  const auto* dot = static_cast<const op::Dot*>(&node);
+  const Shape& data_shape = node.get_input_shape(0);
+  const Shape& weight_shape = node.get_input_shape(1);
+  auto weights = std::dynamic_pointer_cast<op::Constant>(node.get_argument(1));
+  const size_t slot_count = m_he_seal_backend.get_ckks_encoder()->slot_count();
+  if (dot->get_reduction_axes_count() != 1 || data_shape.size() != 2 ||
+      data_shape[0] != 1 || weight_shape.size() != 2 || weights == nullptr ||
+      diagonal_dot_period(weight_shape[1], weight_shape[0]) > slot_count) {
+    return {};
+  }
 
-    // Set client inputs to dummy values
-    if (m_is_compiled) {
-      m_client_inputs.clear();
-      m_client_inputs.resize(get_parameters().size());
+  // Row j of the matrix computes output j, so it stores column j of the
+  // weights
+  const size_t rows = weight_shape[1];
+  const size_t cols = weight_shape[0];
+  std::vector<double> weight_values = weights->cast_vector<double>();
+  std::vector<double> matrix(rows * cols);
+  for (size_t row = 0; row < rows; ++row) {
+    for (size_t col = 0; col < cols; ++col) {
+      matrix[row * cols + col] = weight_values[col * rows + row];
     }
-  } else {
-    NGRAPH_HE_LOG(1) << "Client already setup";
   }
-  return true;
+  if (std::all_of(matrix.begin(), matrix.end(),
+                  [](double value) { return value == 0.; })) {
+    return {};
+  }
+  return matrix;
 }
 
-void HESealExecutable::accept_connection() {
-  NGRAPH_HE_LOG(1) << "Server accepting connections";
-  auto server_callback =
-      std::bind(&HESealExecutable::handle_message, this, std::placeholders::_1);
+void HESealExecutable::register_convolution_kernels() {
+  using Kernel = HEKernelRegistry<ConvolutionKernelArgs>::Kernel;
+  auto input_depth = [this](const ConvolutionKernelArgs& kernel_args) {
+    const HEType& input = kernel_args.args[0]->data(0);
+    if (!input.is_ciphertext()) {
+      return size_t{0};
+    }
+    const auto& parms_id = input.get_ciphertext()->ciphertext().parms_id();
+    return (m_context->first_context_data()->chain_index() -
+            m_context->get_context_data(parms_id)->chain_index()) /
+           m_he_seal_backend.rescale_primes();
+  };
+  auto out_size = [](const ConvolutionKernelArgs& kernel_args) {
+    return shape_size(kernel_args.out->get_packed_shape());
+  };
+  // Each output computed in the batch layout is reduced and rescaled, unless
+  // the product is quantized
+  auto finish = [this](const ConvolutionKernelArgs& kernel_args,
+                       const WeightedSums* sums) {
+    if (m_he_seal_backend.lazy_mod()) {
+      mod_reduce_seal(kernel_args.out->data(), m_he_seal_backend,
+                      kernel_args.verbose);
+    }
+    if (sums == nullptr || sums->quantization_step == 0) {
+      rescale_output(kernel_args.node, kernel_args.out->data(),
+                     kernel_args.verbose);
+    }
+  };
 
-  m_acceptor->async_accept(
-      [this, server_callback](boost::system::error_code ec,
-                              boost::asio::ip::tcp::socket socket) {
-        if (!ec) {
-          NGRAPH_HE_LOG(1) << "Connection accepted";
-          m_session =
-              std::make_shared<TCPSession>(std::move(socket), server_callback);
-          m_session->start();
-          NGRAPH_HE_LOG(1) << "Session started";
-
-          std::lock_guard<std::mutex> guard(m_session_mutex);
-          m_session_started = true;
-          m_session_cond.notify_one();
+  // Planned by select_packing_layouts if its estimated cost is below the
+  // batch layout's, which the nodes after it then assume, so it is selected
+  // whenever applicable
+  m_convolution_kernels.add(Kernel{
+      "slot_packed",
+      [this](const ConvolutionKernelArgs& kernel_args) {
+        return m_slot_packed_convolutions.find(&kernel_args.node) !=
+                   m_slot_packed_convolutions.end() &&
+               kernel_args.args[0]->get_packed_shape()[0] == 1 &&
+               kernel_args.args[0]->all_encrypted_data();
+      },
+      [](const ConvolutionKernelArgs&) { return 0.0; },
+      [this](const ConvolutionKernelArgs& kernel_args) {
+        handle_server_slot_packed_conv_op(
+            kernel_args.args[0], kernel_args.out, kernel_args.node,
+            m_slot_packed_convolutions.at(&kernel_args.node));
+      }});
+
+  // F(2x2, 3x3) multiplies each input channel of a 2x2 output tile by 16
+  // weights, rather than 36
+  m_convolution_kernels.add(Kernel{
+      "winograd",
+      [this](const ConvolutionKernelArgs& kernel_args) {
+        return winograd_filters(kernel_args.node, *kernel_args.args[1]) !=
+                   nullptr &&
+               winograd_convolution_data(kernel_args.args[0]->data());
+      },
+      [this, input_depth, out_size](const ConvolutionKernelArgs& kernel_args) {
+        size_t depth = input_depth(kernel_args);
+        double products_us = direct_convolution_us(
+            kernel_args.node, out_size(kernel_args), depth);
+        return products_us * 4 / 9;
+      },
+      [this, finish](const ConvolutionKernelArgs& kernel_args) {
+        const auto& conv =
+            static_cast<const op::Convolution&>(kernel_args.node);
+        convolution_winograd_seal(
+            kernel_args.args[0]->data(),
+            *winograd_filters(kernel_args.node, *kernel_args.args[1]),
+            kernel_args.out->data(), kernel_args.args[0]->get_packed_shape(),
+            kernel_args.out->get_packed_shape(), conv.get_padding_below(),
+            batch_size(), m_he_seal_backend);
+        finish(kernel_args, nullptr);
+      }});
+
+  // Computed as a product of the filters with the channels at each
+  // position, without an index table
+  m_convolution_kernels.add(Kernel{
+      "pointwise",
+      [](const ConvolutionKernelArgs& kernel_args) {
+        return pointwise_convolution_node(kernel_args.node);
+      },
+      [this, input_depth, out_size](const ConvolutionKernelArgs& kernel_args) {
+        return direct_convolution_us(kernel_args.node, out_size(kernel_args),
+                                     input_depth(kernel_args));
+      },
+      [this, out_size, finish](const ConvolutionKernelArgs& kernel_args) {
+        const auto& args = kernel_args.args;
+        const Shape& in_shape0 = args[0]->get_packed_shape();
+        auto sums = weighted_sums(kernel_args.node, *args[1], nullptr);
+        if (sums != nullptr) {
+          pointwise_convolution_seal(args[0]->data(), args[1]->data(),
+                                     kernel_args.out->data(), *sums, in_shape0,
+                                     batch_size(), m_he_seal_backend, 0,
+                                     out_size(kernel_args));
         } else {
-          NGRAPH_ERR << "error accepting connection " << ec.message();
-          accept_connection();
+          pointwise_convolution_seal(
+              args[0]->data(), args[1]->data(), kernel_args.out->data(),
+              in_shape0, kernel_args.out->get_packed_shape()[1],
+              kernel_args.type, batch_size(), m_he_seal_backend, 0,
+              out_size(kernel_args));
         }
-      });
+        finish(kernel_args, sums.get());
+      }});
+
+  // Multiplies each output by each tap of its window, read from an index
+  // table, and computes any convolution
+  m_convolution_kernels.add(Kernel{
+      "direct", [](const ConvolutionKernelArgs&) { return true; },
+      [this, input_depth, out_size](const ConvolutionKernelArgs& kernel_args) {
+        return direct_convolution_us(kernel_args.node, out_size(kernel_args),
+                                     input_depth(kernel_args));
+      },
+      [this, out_size, finish](const ConvolutionKernelArgs& kernel_args) {
+        const auto& args = kernel_args.args;
+        auto table = convolution_index_table(
+            kernel_args.node, args[0]->get_packed_shape(),
+            args[1]->get_packed_shape(), kernel_args.out->get_packed_shape());
+        auto sums = weighted_sums(kernel_args.node, *args[1], table);
+        if (sums != nullptr) {
+          convolution_seal_range(args[0]->data(), args[1]->data(),
+                                 kernel_args.out->data(), *sums, batch_size(),
+                                 m_he_seal_backend, 0, out_size(kernel_args));
+        } else {
+          convolution_seal_range(args[0]->data(), args[1]->data(),
+                                 kernel_args.out->data(), *table,
+                                 kernel_args.type, batch_size(),
+                                 m_he_seal_backend, 0, out_size(kernel_args),
+                                 kernel_args.verbose);
+        }
+        finish(kernel_args, sums.get());
+      }});
 }
 
-void HESealExecutable::start_server() {
-  boost::asio::ip::tcp::resolver resolver(m_io_context);
-  boost::asio::ip::tcp::endpoint server_endpoints(boost::asio::ip::tcp::v4(),
-                                                  m_port);
-  m_acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(
-      m_io_context, server_endpoints);
-  boost::asio::socket_base::reuse_address option(true);
-  m_acceptor->set_option(option);
+void HESealExecutable::register_dot_kernels() {
+  using Kernel = HEKernelRegistry<DotKernelArgs>::Kernel;
+
+  // Planned by select_packing_layouts, like the slot-packed Convolution
+  m_dot_kernels.add(Kernel{
+      "slot_packed",
+      [this](const DotKernelArgs& kernel_args) {
+        return m_slot_packed_dots.find(&kernel_args.node) !=
+                   m_slot_packed_dots.end() &&
+               kernel_args.args[0]->get_packed_shape()[0] == 1 &&
+               kernel_args.args[0]->all_encrypted_data();
+      },
+      [](const DotKernelArgs&) { return 0.0; },
+      [this](const DotKernelArgs& kernel_args) {
+        handle_server_slot_packed_dot_op(
+            kernel_args.args[0], kernel_args.out, kernel_args.node,
+            m_slot_packed_dots.at(&kernel_args.node));
+      }});
+
+  // Multiplies each output by each reduced element, in the batch layout
+  m_dot_kernels.add(Kernel{
+      "direct", [](const DotKernelArgs&) { return true; },
+      // Streamed client inputs may still be loading, so the input depth is
+      // not read
+      [this](const DotKernelArgs& kernel_args) {
+        return direct_dot_us(kernel_args.node, 0);
+      },
+      [this](const DotKernelArgs& kernel_args) {
+        const Node& node = kernel_args.node;
+        const auto& args = kernel_args.args;
+        const auto& out = kernel_args.out;
+        const auto* dot = static_cast<const op::Dot*>(&node);
+        Shape in_shape0 = args[0]->get_packed_shape();
+        Shape in_shape1 = args[1]->get_packed_shape();
+        std::shared_ptr<const WeightedSums> sums;
+        if (enable_client() && m_he_seal_backend.stream_client_inputs() &&
+            wait_for_client_input(*args[0], 0) <
+                args[0]->get_batched_element_count()) {
+          NGRAPH_HE_LOG(3)
+              << "Streaming Dot over partially loaded client input";
+          dot_seal_streamed(args[0]->data(), args[1]->data(), out->data(),
+                            in_shape0, in_shape1,
+                            dot->get_reduction_axes_count(), kernel_args.type,
+                            batch_size(), m_he_seal_backend,
+                            [&](size_t count) {
+                              return wait_for_client_input(*args[0], count);
+                            });
+        } else if ((sums = weighted_sums(node, *args[1], nullptr)) !=
+                   nullptr) {
+          size_t dot_size = shape_size(
+              Shape(in_shape1.begin(),
+                    in_shape1.begin() + dot->get_reduction_axes_count()));
+          dot_seal(args[0]->data(), args[1]->data(), out->data(), *sums,
+                   dot_size, batch_size(), m_he_seal_backend);
+        } else {
+          dot_seal(args[0]->data(), args[1]->data(), out->data(), in_shape0,
+                   in_shape1, out->get_packed_shape(),
+                   dot->get_reduction_axes_count(), kernel_args.type,
+                   batch_size(), m_he_seal_backend);
+        }
 
-  accept_connection();
-  m_message_handling_thread = std::thread([this]() {
-    try {
-      m_io_context.run();
-    } catch (std::exception& e) {
-      NGRAPH_CHECK(false, "Server error handling thread: ", e.what());
-    }
-  });
+        if (m_he_seal_backend.lazy_mod()) {
+          mod_reduce_seal(out->data(), m_he_seal_backend, kernel_args.verbose);
+        }
+        if (sums == nullptr || sums->quantization_step == 0) {
+          rescale_output(node, out->data(), kernel_args.verbose);
+        }
+      }});
 }
 
-void HESealExecutable::load_public_key(const pb::TCPMessage& pb_message) {
-  NGRAPH_HE_LOG(5) << "Server loading evaluation key";
-  NGRAPH_CHECK(pb_message.has_public_key(),
-               "pb_message doesn't have public key");
+double HESealExecutable::primitive_cost_us(HEPrimitive primitive,
+                                           size_t depth) const {
+  const auto& parms = m_he_seal_backend.get_encryption_parameters()
+                          .seal_encryption_parameters();
+  size_t data_moduli = parms.coeff_modulus().size() -
+                       (m_context->using_keyswitching() ? 1 : 0);
+  return m_he_seal_backend.cost_calibration().primitive_cost_us(
+      primitive, parms.poly_modulus_degree(),
+      data_moduli - std::min(depth, data_moduli - 1));
+}
 
-  seal::PublicKey key;
-  const std::string& pk_str = pb_message.public_key().public_key();
-  std::stringstream key_stream(pk_str);
-  key.load(*m_context, key_stream);
-  m_he_seal_backend.set_public_key(key);
-  m_client_public_key_set = true;
+double HESealExecutable::direct_convolution_us(const Node& node,
+                                               size_t outputs,
+                                               size_t input_depth) const {
+  // Each output multiplies each tap of its window
+  const Shape& filter_shape = node.get_input_shape(1);
+  size_t taps = shape_size(filter_shape) / std::max<size_t>(filter_shape[0], 1);
+  return static_cast<double>(outputs * taps) *
+             primitive_cost_us(HEPrimitive::multiply_plain, input_depth) +
+         static_cast<double>(outputs) *
+             primitive_cost_us(HEPrimitive::rescale, input_depth);
 }
 
-void HESealExecutable::load_eval_key(const pb::TCPMessage& pb_message) {
-  NGRAPH_HE_LOG(5) << "Server loading evaluation key";
-  NGRAPH_CHECK(pb_message.has_eval_key(), "pb_message doesn't have eval key");
-
-  seal::RelinKeys keys;
-  const std::string& evk_str = pb_message.eval_key().eval_key();
-  std::stringstream key_stream(evk_str);
-  keys.load(*m_context, key_stream);
-  m_he_seal_backend.set_relin_keys(keys);
-  m_client_eval_key_set = true;
+double HESealExecutable::slot_packed_convolution_us(const Node& node,
+                                                    size_t input_depth) const {
+  // The input is packed, rotated once per tap, and the outputs unpacked
+  const Shape& filter_shape = node.get_input_shape(1);
+  size_t out_channels = std::max<size_t>(filter_shape[0], 1);
+  size_t taps = shape_size(filter_shape) / out_channels;
+  size_t inputs = shape_size(node.get_input_shape(0));
+  size_t outputs = shape_size(node.get_output_shape(0));
+  return static_cast<double>(inputs) *
+             (primitive_cost_us(HEPrimitive::encode, input_depth) +
+              primitive_cost_us(HEPrimitive::multiply_plain, input_depth)) +
+         primitive_cost_us(HEPrimitive::rescale, input_depth) +
+         static_cast<double>(taps + outputs) *
+             primitive_cost_us(HEPrimitive::rotate, input_depth + 1) +
+         static_cast<double>(out_channels * taps) *
+             primitive_cost_us(HEPrimitive::multiply_plain, input_depth + 1) +
+         static_cast<double>(out_channels) *
+             primitive_cost_us(HEPrimitive::rescale, input_depth + 1);
 }
 
-void HESealExecutable::send_inference_shape() {
-  m_sent_inference_shape = true;
-
-  const ParameterVector& input_parameters = get_parameters();
-
-  pb::TCPMessage pb_message;
-  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
-
-  for (const auto& input_param : input_parameters) {
-    if (HEOpAnnotations::from_client(*input_param)) {
-      pb::HETensor* pb_tensor = pb_message.add_he_tensors();
-
-      std::vector<uint64_t> shape{input_param->get_shape()};
-      *pb_tensor->mutable_shape() = {shape.begin(), shape.end()};
-
-      std::string name = input_param->get_provenance_tags().empty()
-                             ? input_param->get_name()
-                             : *input_param->get_provenance_tags().begin();
-
-      NGRAPH_HE_LOG(1) << "Server setting inference tensor name " << name
-                       << " (corresponding to Parameter "
-                       << input_param->get_name() << "), with "
-                       << input_param->get_shape();
-
-      pb_tensor->set_name(name);
-
-      if (HEOpAnnotations::plaintext_packed(*input_param)) {
-        NGRAPH_HE_LOG(1) << "Setting parameter " << input_param->get_name()
-                         << " to packed";
-        pb_tensor->set_packed(true);
-      }
-    }
+double HESealExecutable::direct_dot_us(const Node& node,
+                                       size_t input_depth) const {
+  // Each output multiplies each reduced element
+  const auto* dot = static_cast<const op::Dot*>(&node);
+  const Shape& arg_shape = node.get_input_shape(0);
+  size_t reduction = 1;
+  for (size_t i = arg_shape.size() - dot->get_reduction_axes_count();
+       i < arg_shape.size(); ++i) {
+    reduction *= arg_shape[i];
   }
-
-  NGRAPH_HE_LOG(1) << "Server sending inference of "
-                   << pb_message.he_tensors_size() << " parameters";
-
-  json js = {{"function", "Parameter"}};
-  pb::Function f;
-  f.set_function(js.dump());
-  NGRAPH_HE_LOG(3) << "js " << js.dump();
-  *pb_message.mutable_function() = f;
-  m_session->write_message(TCPMessage(std::move(pb_message)));
+  size_t outputs = shape_size(node.get_output_shape(0));
+  return static_cast<double>(outputs * reduction) *
+             primitive_cost_us(HEPrimitive::multiply_plain, input_depth) +
+         static_cast<double>(outputs) *
+             primitive_cost_us(HEPrimitive::rescale, input_depth);
 }
 
-void HESealExecutable::handle_relu_result(const pb::TCPMessage& pb_message) {
-  NGRAPH_HE_LOG(3) << "Server handling relu result";
-  std::lock_guard<std::mutex> guard(m_relu_mutex);
-
-  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
-               "Can only handle one tensor at a time, got ",
-               pb_message.he_tensors_size());
-
-  const auto& pb_tensor = pb_message.he_tensors(0);
-  auto he_tensor = HETensor::load_from_pb_tensor(
-      pb_tensor, *m_he_seal_backend.get_ckks_encoder(),
-      m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-      *m_he_seal_backend.get_decryptor(),
-      m_he_seal_backend.get_encryption_parameters());
-
-  size_t result_count = pb_tensor.data_size();
-  for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
-    m_relu_data[m_unknown_relu_idx[result_idx + m_relu_done_count]] =
-        he_tensor->data(result_idx);
-  }
-
-#ifdef NGRAPH_HE_ABY_ENABLE
-  if (enable_garbled_circuits()) {
-    m_aby_executor->post_process_aby_circuit(pb_message.function().function(),
-                                             he_tensor);
+double HESealExecutable::slot_packed_dot_us(const Node& node,
+                                            size_t input_depth) const {
+  // The input is packed and replicated, multiplied by each diagonal with
+  // baby-step giant-step rotations, and the outputs unpacked
+  size_t inputs = shape_size(node.get_input_shape(0));
+  size_t outputs = shape_size(node.get_output_shape(0));
+  size_t period = diagonal_dot_period(outputs, inputs);
+  size_t slot_count = m_he_seal_backend.get_ckks_encoder()->slot_count();
+  size_t replications = 0;
+  for (size_t step = period; step < slot_count; step *= 2) {
+    replications++;
   }
-#endif
-
-  m_relu_done_count += result_count;
-  m_relu_cond.notify_all();
+  auto baby_steps =
+      static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(period))));
+  size_t giant_steps = (period + baby_steps - 1) / baby_steps;
+  return static_cast<double>(inputs) *
+             (primitive_cost_us(HEPrimitive::encode, input_depth) +
+              primitive_cost_us(HEPrimitive::multiply_plain, input_depth)) +
+         primitive_cost_us(HEPrimitive::rescale, input_depth) +
+         static_cast<double>(replications + baby_steps + giant_steps +
+                             outputs) *
+             primitive_cost_us(HEPrimitive::rotate, input_depth + 1) +
+         static_cast<double>(period) *
+             (primitive_cost_us(HEPrimitive::encode, input_depth + 1) +
+              primitive_cost_us(HEPrimitive::multiply_plain,
+                                input_depth + 1)) +
+         primitive_cost_us(HEPrimitive::rescale, input_depth + 1);
 }
 
-void HESealExecutable::handle_bounded_relu_result(
-    const pb::TCPMessage& pb_message) {
-  handle_relu_result(pb_message);
-}
-
-void HESealExecutable::handle_max_pool_result(
-    const pb::TCPMessage& pb_message) {
-  std::lock_guard<std::mutex> guard(m_max_pool_mutex);
-
-  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
-               "Can only handle one tensor at a time, got ",
-               pb_message.he_tensors_size());
-
-  const auto& pb_tensor = pb_message.he_tensors(0);
-  size_t result_count = pb_tensor.data_size();
-
-  NGRAPH_CHECK(result_count == 1, "Maxpool only supports result_count 1, got ",
-               result_count);
-
-  auto he_tensor = HETensor::load_from_pb_tensor(
-      pb_tensor, *m_he_seal_backend.get_ckks_encoder(),
-      m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-      *m_he_seal_backend.get_decryptor(),
-      m_he_seal_backend.get_encryption_parameters());
-
-  m_max_pool_data.emplace_back(he_tensor->data(0));
-  m_max_pool_done = true;
-  m_max_pool_cond.notify_all();
-}
+void HESealExecutable::build_execution_plan(
+    const pass::HELevelAnalysis& level_analysis) {
+  std::unordered_map<const descriptor::Tensor*, size_t> tensor_slots;
+  auto get_slot = [&tensor_slots](const descriptor::Tensor* tensor) {
+    return tensor_slots.emplace(tensor, tensor_slots.size()).first->second;
+  };
 
-void HESealExecutable::handle_message(const TCPMessage& message) {
-  NGRAPH_HE_LOG(3) << "Server handling message";
-  std::shared_ptr<pb::TCPMessage> pb_message = message.pb_message();
+  m_parameter_slots.clear();
+  for (const auto& param : get_parameters()) {
+    for (size_t i = 0; i < param->get_output_size(); ++i) {
+      m_parameter_slots.emplace_back(
+          get_slot(param->get_output_tensor_ptr(i).get()));
+    }
+  }
+  m_result_slots.clear();
+  for (const auto& result : get_results()) {
+    m_result_slots.emplace_back(
+        get_slot(result->get_output_tensor_ptr(0).get()));
+  }
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wswitch-enum"
-  switch (pb_message->type()) {
-    case pb::TCPMessage_Type_RESPONSE: {
-      if (pb_message->has_public_key()) {
-        load_public_key(*pb_message);
+  // Buffers are assigned greedily in execution order. A buffer is released
+  // when the liveness pass frees its tensor, and handed to the next output
+  // with the same layout
+  std::vector<TensorLayout> buffer_layouts;
+  std::vector<size_t> free_buffers;
+  std::unordered_map<size_t, size_t> slot_buffers;
+  auto assign_buffer = [&](const TensorLayout& layout) {
+    for (auto it = free_buffers.begin(); it != free_buffers.end(); ++it) {
+      if (buffer_layouts[*it] == layout) {
+        size_t buffer_idx = *it;
+        free_buffers.erase(it);
+        return buffer_idx;
       }
-      if (pb_message->has_eval_key()) {
-        load_eval_key(*pb_message);
+    }
+    buffer_layouts.emplace_back(layout);
+    return buffer_layouts.size() - 1;
+  };
+
+  // Dependencies for concurrent execution. A node depends on the producers
+  // of its inputs and, when it reuses a buffer, on every node which
+  // produced or read the buffer's previous tensor
+  std::unordered_map<size_t, size_t> slot_producers;
+  std::unordered_map<size_t, std::vector<size_t>> slot_readers;
+  std::vector<std::vector<size_t>> buffer_users;
+
+  m_node_slots.clear();
+  m_node_slots.reserve(m_nodes.size());
+  size_t num_intermediates = 0;
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    const auto& node = m_nodes[node_idx];
+    NodeSlots node_slots;
+    node_slots.mod_switch_inputs = level_analysis.mod_switch_inputs(*node);
+    std::set<size_t> dependencies;
+    for (auto input : node->inputs()) {
+      size_t slot = get_slot(&input.get_tensor());
+      node_slots.inputs.emplace_back(slot);
+      slot_readers[slot].emplace_back(node_idx);
+      auto producer = slot_producers.find(slot);
+      if (producer != slot_producers.end()) {
+        dependencies.insert(producer->second);
       }
-      if (!m_sent_inference_shape && m_client_public_key_set &&
-          m_client_eval_key_set) {
-        send_inference_shape();
+    }
+    for (size_t i = 0; i < node->get_output_size(); ++i) {
+      bool external = tensor_slots.find(&node->output(i).get_tensor()) !=
+                      tensor_slots.end();
+      size_t slot = get_slot(&node->output(i).get_tensor());
+      node_slots.outputs.emplace_back(slot);
+      slot_producers[slot] = node_idx;
+      if (external || node->is_parameter()) {
+        node_slots.output_layouts.emplace_back();
+        node_slots.output_buffers.emplace_back(no_buffer);
+        continue;
       }
 
-      if (pb_message->has_function()) {
-        const std::string& function = pb_message->function().function();
-        json js = json::parse(function);
-
-        auto name = js.at("function");
-
-        static std::unordered_set<std::string> known_function_names{
-            "Relu", "BoundedRelu", "MaxPool"};
-        NGRAPH_CHECK(
-            known_function_names.find(name) != known_function_names.end(),
-            "Unknown function name ", name);
-
-        if (name == "Relu") {
-          handle_relu_result(*pb_message);
-        } else if (name == "BoundedRelu") {
-          handle_bounded_relu_result(*pb_message);
-        } else if (name == "MaxPool") {
-          handle_max_pool_result(*pb_message);
-        }
+      auto he_op_annotation =
+          HEOpAnnotations::he_op_annotation(*static_cast<op::Op*>(node.get()));
+      TensorLayout layout{node->get_output_element_type(i),
+                          node->get_output_shape(i), he_op_annotation->packed(),
+                          he_op_annotation->encrypted()};
+      if (layout.packed) {
+        layout.shape = HETensor::unpack_shape(layout.shape, batch_size());
       }
-      break;
+      size_t buffer_idx = assign_buffer(layout);
+      slot_buffers[slot] = buffer_idx;
+      if (buffer_idx < buffer_users.size()) {
+        dependencies.insert(buffer_users[buffer_idx].begin(),
+                            buffer_users[buffer_idx].end());
+      }
+      node_slots.output_layouts.emplace_back(std::move(layout));
+      node_slots.output_buffers.emplace_back(buffer_idx);
+      ++num_intermediates;
     }
-    case pb::TCPMessage_Type_REQUEST: {
-      if (pb_message->he_tensors_size() > 0) {
-        handle_client_ciphers(*pb_message);
+    for (const descriptor::Tensor* tensor : node->liveness_free_list) {
+      auto it = tensor_slots.find(tensor);
+      if (it == tensor_slots.end()) {
+        NGRAPH_HE_LOG(5) << "Tensor " << tensor->get_name()
+                         << " freed before use";
+        continue;
+      }
+      node_slots.free.emplace_back(it->second);
+      auto buffer_it = slot_buffers.find(it->second);
+      if (buffer_it != slot_buffers.end()) {
+        size_t buffer_idx = buffer_it->second;
+        free_buffers.emplace_back(buffer_idx);
+        slot_buffers.erase(buffer_it);
+
+        if (buffer_idx >= buffer_users.size()) {
+          buffer_users.resize(buffer_idx + 1);
+        }
+        auto& users = buffer_users[buffer_idx];
+        users = slot_readers[it->second];
+        users.emplace_back(slot_producers.at(it->second));
       }
-      break;
     }
-    case pb::TCPMessage_Type_UNKNOWN:
-    default:
-      NGRAPH_CHECK(false, "Unknonwn TCPMessage type");
-  }
-#pragma clang diagnostic pop
-}
-
-void HESealExecutable::handle_client_ciphers(const pb::TCPMessage& pb_message) {
-  NGRAPH_HE_LOG(3) << "Handling client tensors";
-
-  NGRAPH_CHECK(pb_message.he_tensors_size() > 0,
-               "Client received empty tensor message");
-  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
-               "Client only supports 1 client tensor");
-  // TODO(fboemer): check for uniqueness of batch size if > 1 input tensor
-
-  const ParameterVector& input_parameters = get_parameters();
 
-  /// Looks for a parameter which matches a given tensor name
-  /// tensor_name Tensor name to match against
-  /// \returns parameter_idx if a matching parameter shape has been found,
-  /// std::nullopt otherwise
-  auto find_matching_parameter_index =
-      [&](const std::string& tensor_name) -> std::optional<size_t> {
-    NGRAPH_HE_LOG(5) << "Calling find_matching_parameter_index(" << tensor_name
-                     << ")";
-    for (size_t param_idx = 0; param_idx < input_parameters.size();
-         ++param_idx) {
-      const auto& parameter = input_parameters[param_idx];
+    dependencies.erase(node_idx);
+    node_slots.num_dependencies = dependencies.size();
+    for (size_t dependency : dependencies) {
+      m_node_slots[dependency].dependents.emplace_back(node_idx);
+    }
 
-      for (const auto& tag : parameter->get_provenance_tags()) {
-        NGRAPH_HE_LOG(5) << "Tag " << tag;
+    auto type_id = get_typeid(node->get_type_info());
+    // Activations approximated by polynomials are computed by the server
+    bool activation_op = type_id == OP_TYPEID::Relu ||
+                         type_id == OP_TYPEID::BoundedRelu ||
+                         type_id == OP_TYPEID::ConvolutionBiasRelu ||
+                         type_id == OP_TYPEID::MaxPool;
+    // Relus fused into the following MaxPool are computed by its request
+    bool client_op =
+        (activation_op && !polynomial_activation_depth(*node).has_value() &&
+         !client_fused_relu(*node)) ||
+        type_id == OP_TYPEID::Max || type_id == OP_TYPEID::Refresh ||
+        client_elementwise_op(*node) || node->is_output();
+    bool lazy_mod_op =
+        type_id == OP_TYPEID::Add || type_id == OP_TYPEID::Multiply;
+    node_slots.client = enable_client() && client_op;
+    node_slots.exclusive = m_he_seal_backend.lazy_mod() && lazy_mod_op;
+    node_slots.type_id = type_id;
+    node_slots.base_type =
+        node->get_inputs().empty()
+            ? node->get_element_type()
+            : node->get_inputs().at(0).get_tensor().get_element_type();
+    // Created here, so call() only follows pointers to them. References to
+    // elements of an unordered_map stay valid as elements are added
+    node_slots.timer = &m_timer_map[node];
+    node_slots.stats = &m_op_stats[node];
+    m_node_slots.emplace_back(std::move(node_slots));
+  }
+  m_num_tensor_slots = tensor_slots.size();
+  m_tensor_buffers.resize(buffer_layouts.size());
+
+  m_slot_reader_counts.assign(m_num_tensor_slots, 0);
+  m_intermediate_slots.assign(m_num_tensor_slots, 0);
+  m_slot_read_nodes.assign(m_num_tensor_slots, {});
+  for (const auto& [slot, readers] : slot_readers) {
+    m_slot_reader_counts[slot] = readers.size();
+    m_slot_read_nodes[slot] = readers;
+    std::sort(m_slot_read_nodes[slot].begin(), m_slot_read_nodes[slot].end());
+  }
+  for (const auto& node_slots : m_node_slots) {
+    for (size_t i = 0; i < node_slots.outputs.size(); ++i) {
+      if (node_slots.output_buffers[i] != no_buffer) {
+        m_intermediate_slots[node_slots.outputs[i]] = 1;
       }
-
-      if (param_originates_from_name(*parameter, tensor_name)) {
-        NGRAPH_HE_LOG(5) << "Param " << tensor_name << " matches at index "
-                         << param_idx;
-        return std::optional<size_t>{param_idx};
+    }
+  }
+  for (auto& node_slots : m_node_slots) {
+    node_slots.sole_reader.clear();
+    for (size_t slot : node_slots.inputs) {
+      node_slots.sole_reader.emplace_back(m_intermediate_slots[slot] &&
+                                          m_slot_reader_counts[slot] == 1);
+    }
+  }
+  // The depth remaining after each node is the largest number of rescales
+  // its consumers apply before the next client node, which re-encrypts
+  std::unordered_map<const Node*, size_t> node_indices;
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    node_indices[m_nodes[node_idx].get()] = node_idx;
+  }
+  std::vector<size_t> remaining_depths(m_nodes.size(), 0);
+  m_client_output_depths.clear();
+  for (size_t node_idx = m_nodes.size(); node_idx-- > 0;) {
+    const Node& node = *m_nodes[node_idx];
+    size_t node_depth = level_analysis.depth(node).value_or(0);
+    for (const auto& output : node.outputs()) {
+      for (const auto& target : output.get_target_inputs()) {
+        auto consumer = node_indices.find(target.get_node());
+        if (consumer == node_indices.end()) {
+          continue;
+        }
+        size_t consumer_idx = consumer->second;
+        size_t consumer_depth =
+            level_analysis.depth(*m_nodes[consumer_idx]).value_or(0);
+        size_t remaining =
+            m_node_slots[consumer_idx].client
+                ? 0
+                : std::max(consumer_depth, node_depth) - node_depth +
+                      remaining_depths[consumer_idx];
+        remaining_depths[node_idx] =
+            std::max(remaining_depths[node_idx], remaining);
       }
     }
-    NGRAPH_HE_LOG(5) << "Could not find tensor " << tensor_name;
-    return std::nullopt;
-  };
+    if (m_node_slots[node_idx].client && !node.is_output()) {
+      m_client_output_depths[&node] = remaining_depths[node_idx];
+    }
+  }
 
-  auto& pb_tensor = pb_message.he_tensors(0);
-  ngraph::Shape shape{pb_tensor.shape().begin(), pb_tensor.shape().end()};
+  // ReLUs sent to the client with the same request may share a stream. The
+  // garbled-circuit ReLUs are configured per node
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    const Node& node = *m_nodes[node_idx];
+    auto& node_slots = m_node_slots[node_idx];
+    node_slots.coalesce_key.clear();
+    auto type_id = get_typeid(node.get_type_info());
+    if (!node_slots.client || !m_he_seal_backend.coalesce_client_ops() ||
+        enable_garbled_circuits() ||
+        (type_id != OP_TYPEID::Relu && type_id != OP_TYPEID::BoundedRelu &&
+         !client_elementwise_op(node))) {
+      continue;
+    }
+    std::stringstream key;
+    key << node.description() << "," << node.get_output_element_type(0)
+        << "," << HEOpAnnotations::he_op_annotation(node)->packed() << ","
+        << client_output_chain_index(node);
+    if (type_id == OP_TYPEID::BoundedRelu) {
+      key << "," << static_cast<const op::BoundedRelu&>(node).get_alpha();
+    }
+    node_slots.coalesce_key = key.str();
+  }
+  plan_tiled_chains();
 
-  NGRAPH_HE_LOG(5) << "pb_tensor.packed() " << pb_tensor.packed();
-  set_batch_size(HETensor::batch_size(shape, pb_tensor.packed()));
-  NGRAPH_HE_LOG(5) << "Offset " << pb_tensor.offset();
+  NGRAPH_HE_LOG(3) << "Execution plan uses " << m_num_tensor_slots
+                   << " tensor slots and " << buffer_layouts.size()
+                   << " buffers for " << num_intermediates
+                   << " intermediate tensors";
+}
 
-  std::optional<size_t> param_idx =
-      find_matching_parameter_index(pb_tensor.name());
-  NGRAPH_CHECK(param_idx, "Could not find matching parameter name ",
-               pb_tensor.name());
+size_t HESealExecutable::client_output_chain_index(const Node& node) const {
+  const auto& context = m_he_seal_backend.get_context();
+  size_t first_chain_index = context->first_context_data()->chain_index();
+  auto it = m_client_output_depths.find(&node);
+  if (it == m_client_output_depths.end()) {
+    return first_chain_index;
+  }
+  // Rescaling to chain index 0 is skipped, so one more level is kept. Each
+  // level spans rescale_primes chain indices. The outputs must further
+  // remain decryptable at their scale
+  size_t decryptable_chain_index =
+      context
+          ->get_context_data(m_he_seal_backend.lowest_decryptable_parms_id(
+              m_he_seal_backend.get_scale()))
+          ->chain_index();
+  size_t level_chain_index =
+      (it->second + 1) * m_he_seal_backend.rescale_primes();
+  return std::min(first_chain_index,
+                  std::max(level_chain_index, decryptable_chain_index));
+}
 
-  if (m_client_inputs[param_idx.value()] == nullptr) {
-    auto he_tensor = HETensor::load_from_pb_tensor(
-        pb_tensor, *m_he_seal_backend.get_ckks_encoder(),
-        m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
-        *m_he_seal_backend.get_decryptor(),
-        m_he_seal_backend.get_encryption_parameters());
-    m_client_inputs[param_idx.value()] = he_tensor;
-  } else {
-    HETensor::load_from_pb_tensor(m_client_inputs[param_idx.value()], pb_tensor,
-                                  m_he_seal_backend.get_context());
+bool HESealExecutable::reuse_encrypted_server_input(
+    size_t input_idx, const std::shared_ptr<HETensor>& tensor) {
+  std::lock_guard<std::mutex> guard(m_encrypted_server_inputs_mutex);
+  if (input_idx >= m_encrypted_server_inputs.size()) {
+    return false;
   }
+  const auto& encrypted_input = m_encrypted_server_inputs[input_idx];
+  return encrypted_input.tensor.lock() == tensor &&
+         encrypted_input.write_count == tensor->write_count();
+}
 
-  auto done_loading = [&]() {
-    for (size_t parm_idx = 0; parm_idx < input_parameters.size(); ++parm_idx) {
-      const auto& param = input_parameters[parm_idx];
-      if (HEOpAnnotations::from_client(*param)) {
-        NGRAPH_HE_LOG(5) << "From client param shape " << param->get_shape();
-        NGRAPH_HE_LOG(5) << "m_batch_size " << m_batch_size;
+void HESealExecutable::record_encrypted_server_input(
+    size_t input_idx, const std::shared_ptr<HETensor>& tensor) {
+  std::lock_guard<std::mutex> guard(m_encrypted_server_inputs_mutex);
+  if (input_idx >= m_encrypted_server_inputs.size()) {
+    m_encrypted_server_inputs.resize(input_idx + 1);
+  }
+  m_encrypted_server_inputs[input_idx] = {tensor, tensor->write_count()};
+}
 
-        if (m_client_inputs[parm_idx] == nullptr ||
-            !m_client_inputs[parm_idx]->done_loading()) {
-          return false;
-        }
-      }
+std::shared_ptr<HETensor> HESealExecutable::acquire_output_tensor(
+    const TensorLayout& layout, size_t buffer_idx, const std::string& name) {
+  // Kernels overwrite every output value, as with reused buffers, so the
+  // plaintexts are not initialized
+  auto create_tensor = [&]() {
+    NGRAPH_HE_LOG(5) << "Creating output tensor with shape " << layout.shape;
+    if (layout.encrypted) {
+      return std::static_pointer_cast<HETensor>(
+          m_he_seal_backend.create_cipher_tensor(
+              layout.element_type, layout.shape, layout.packed, name, false));
     }
-    return true;
+    return std::static_pointer_cast<HETensor>(
+        m_he_seal_backend.create_plain_tensor(
+            layout.element_type, layout.shape, layout.packed, name, false));
   };
+  if (buffer_idx == no_buffer) {
+    return create_tensor();
+  }
 
-  if (done_loading()) {
-    NGRAPH_HE_LOG(3) << "Done loading client ciphertexts";
+  auto& [buffer_layout, buffer] = m_tensor_buffers[buffer_idx];
+  // A buffer still referenced elsewhere, e.g. by m_client_outputs, cannot be
+  // overwritten
+  if (buffer == nullptr || buffer.use_count() > 1 ||
+      !(buffer_layout == layout)) {
+    buffer_layout = layout;
+    buffer = create_tensor();
+    return buffer;
+  }
 
-    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
-    m_client_inputs_received = true;
-    NGRAPH_HE_LOG(5) << "Notifying done loading client ciphertexts";
-    m_client_inputs_cond.notify_all();
-  } else {
-    NGRAPH_HE_LOG(3) << "Not yet done loading client ciphertexts";
+  // Kernels such as Reshape and Broadcast copy HETypes, so ciphertexts may be
+  // shared with live tensors. Those must not be overwritten in place
+  auto& data = buffer->data();
+#pragma omp parallel for
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (data[i].is_ciphertext() && data[i].get_ciphertext().use_count() > 1) {
+      data[i].set_ciphertext(HESealBackend::create_empty_ciphertext());
+    }
   }
+  return buffer;
 }
 
-std::vector<runtime::PerformanceCounter>
-HESealExecutable::get_performance_data() const {
-  std::vector<runtime::PerformanceCounter> rc;
-  for (const auto& [node, stop_watch] : m_timer_map) {
-    rc.emplace_back(node, stop_watch.get_total_microseconds(),
-                    stop_watch.get_call_count());
+void HESealExecutable::prepare_galois_keys() {
+  // With complex packing, ciphertext-ciphertext products use complex
+  // conjugation. Rotation-based kernels request their steps on first use
+  static const std::unordered_set<std::string> s_conjugating_ops{
+      "AvgPool", "BatchNormInference", "Convolution", "ConvolutionBiasRelu",
+      "Divide",  "Dot",                "Multiply",    "Power"};
+  if (!complex_packing()) {
+    return;
+  }
+  for (const auto& node : m_function->get_ordered_ops()) {
+    if (s_conjugating_ops.find(node->description()) !=
+        s_conjugating_ops.end()) {
+      NGRAPH_HE_LOG(3) << "Preparing complex conjugation key for "
+                       << node->get_name();
+      m_he_seal_backend.prepare_galois_keys({0});
+      return;
+    }
   }
-  return rc;
 }
 
-bool HESealExecutable::call(
-    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
-    const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs) {
-  NGRAPH_HE_LOG(3) << "HESealExecutable::call";
-  validate(outputs, server_inputs);
-  NGRAPH_HE_LOG(3) << "HESealExecutable::call validated inputs";
+void HESealExecutable::encrypt_constants() {
+  m_encrypted_constants.clear();
+  if (!m_he_seal_backend.encrypt_constants()) {
+    return;
+  }
+  // Each call uses the keys of its client, which are not known yet
+  NGRAPH_CHECK(!enable_client(),
+               "Encrypting constants requires the client to be disabled");
+
+  bool complex_packing = m_he_seal_backend.complex_packing();
+  for (const auto& node : m_function->get_ordered_ops()) {
+    if (!node->is_constant() || !HEOpAnnotations::has_he_annotation(*node) ||
+        !HEOpAnnotations::he_op_annotation(*node)->encrypted()) {
+      continue;
+    }
+    const auto* constant = static_cast<const op::Constant*>(node.get());
+    const element::Type& type = constant->get_element_type();
+    NGRAPH_CHECK(m_he_seal_backend.is_supported_type(type),
+                 "Unsupported type ", type);
+    const auto* data = static_cast<const char*>(constant->get_data_ptr());
+    size_t count = shape_size(constant->get_shape());
+
+    std::vector<HEType> ciphers(count,
+                                HEType(HEPlaintext(), complex_packing));
+#pragma omp parallel for
+    for (size_t i = 0; i < count; ++i) {
+      auto plaintext = HEPlaintext(std::initializer_list<double>{
+          type_to_double(data + i * type.size(), type)});
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      m_he_seal_backend.encrypt(cipher, plaintext, type, complex_packing);
+      ciphers[i] = HEType(cipher, complex_packing, 1);
+    }
+    NGRAPH_HE_LOG(3) << "Encrypted " << count << " values of constant "
+                     << node->get_name();
+    m_encrypted_constants.emplace(node.get(), std::move(ciphers));
+  }
+}
 
-  if (enable_client()) {
-    if (!server_setup()) {
-      return false;
+void HESealExecutable::materialize_constants() {
+  m_plaintext_constants.clear();
+  for (const auto& node : m_function->get_ordered_ops()) {
+    if (!node->is_constant() ||
+        m_encrypted_constants.find(node.get()) != m_encrypted_constants.end()) {
+      continue;
     }
+    const auto* constant = static_cast<const op::Constant*>(node.get());
+    const element::Type& type = constant->get_element_type();
+    if (!m_he_seal_backend.is_supported_type(type)) {
+      continue;
+    }
+    const auto* data = static_cast<const char*>(constant->get_data_ptr());
+    size_t count = shape_size(constant->get_shape());
+    std::vector<HEPlaintext> plaintexts(count);
+    parallel_for_seal(count, s_min_parallel_work, [&](size_t i) {
+      plaintexts[i] = HEPlaintext(std::initializer_list<double>{
+          type_to_double(data + i * type.size(), type)});
+    });
+    m_plaintext_constants.emplace(node.get(), std::move(plaintexts));
   }
+}
+
+size_t HESealExecutable::batch_size() const { return m_batch_size; }
 
+void HESealExecutable::set_batch_size(size_t batch_size) {
+  size_t max_batch_size = m_he_seal_backend.get_ckks_encoder()->slot_count();
   if (complex_packing()) {
-    NGRAPH_HE_LOG(1) << "Complex packing";
+    max_batch_size *= 2;
   }
+  NGRAPH_CHECK(batch_size <= max_batch_size, "Batch size ", batch_size,
+               " too large (maximum ", max_batch_size, ")");
+  m_batch_size = batch_size;
 
-  if (enable_client()) {
-    NGRAPH_HE_LOG(1) << "Waiting for m_client_inputs";
+  NGRAPH_HE_LOG(5) << "Server set batch size to " << m_batch_size;
+}
 
-    std::unique_lock<std::mutex> mlock(m_client_inputs_mutex);
-    m_client_inputs_cond.wait(
-        mlock, std::bind(&HESealExecutable::client_inputs_received, this));
-    NGRAPH_HE_LOG(1) << "Client inputs_received";
+void HESealExecutable::validate(
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& inputs) {
+  const ParameterVector& parameters = get_parameters();
+  const ResultVector& results = get_results();
+  NGRAPH_CHECK(inputs.size() == parameters.size(), "Expected ",
+               parameters.size(), " inputs, got ", inputs.size());
+  NGRAPH_CHECK(outputs.size() == results.size(), "Expected ", results.size(),
+               " outputs, got ", outputs.size());
+
+  // Batch sizes of the function and of the call
+  std::optional<size_t> function_batch_size;
+  std::optional<size_t> call_batch_size;
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    const auto& param = parameters[i];
+    const auto& input = inputs[i];
+    NGRAPH_CHECK(input->get_element_type() == param->get_element_type(),
+                 "Input ", i, " has element type ", input->get_element_type(),
+                 ", expected ", param->get_element_type());
+    const Shape& shape = input->get_shape();
+    const Shape& param_shape = param->get_shape();
+    if (!HEOpAnnotations::plaintext_packed(*param) || param_shape.empty() ||
+        param_shape[0] == 0) {
+      NGRAPH_CHECK(shape == param_shape, "Input ", i, " has shape ", shape,
+                   ", expected ", param_shape);
+      continue;
+    }
+    NGRAPH_CHECK(!shape.empty() && shape[0] > 0 &&
+                     shape == HETensor::unpack_shape(param_shape, shape[0]),
+                 "Input ", i, " has shape ", shape, ", expected ",
+                 param_shape, " with any batch size");
+    NGRAPH_CHECK(!call_batch_size.has_value() || *call_batch_size == shape[0],
+                 "Input ", i, " has batch size ", shape[0],
+                 ", expected batch size ", call_batch_size.value_or(0),
+                 " of the other packed inputs");
+    function_batch_size = param_shape[0];
+    call_batch_size = shape[0];
   }
 
-  // convert inputs to HETensor
-  NGRAPH_HE_LOG(3) << "Converting inputs to HETensor";
-  const auto& parameters = get_parameters();
-  std::vector<std::shared_ptr<HETensor>> he_inputs;
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& result = results[i];
+    const auto& output = outputs[i];
+    NGRAPH_CHECK(output->get_element_type() == result->get_element_type(),
+                 "Output ", i, " has element type ",
+                 output->get_element_type(), ", expected ",
+                 result->get_element_type());
+    const Shape& shape = output->get_shape();
+    const Shape& result_shape = result->get_shape();
+    bool batched = call_batch_size.has_value() && !result_shape.empty() &&
+                   result_shape[0] == *function_batch_size &&
+                   shape == HETensor::unpack_shape(result_shape,
+                                                   *call_batch_size);
+    NGRAPH_CHECK(batched || shape == result_shape, "Output ", i,
+                 " has shape ", shape, ", expected ", result_shape);
+  }
+}
+
+void HESealExecutable::warmup() {
+  NGRAPH_CHECK(!enable_client(), "Warmup requires the client to be disabled");
+  NGRAPH_CHECK(!m_dry_run, "Cannot warm up a function compiled for a dry run");
+  NGRAPH_HE_LOG(3) << "Warming up executable";
+
+  // Ones rather than zeros, so no kernel divides by or skips zeros
+  auto create_tensor = [this](const Node& node, bool write_ones) {
+    bool packed = HEOpAnnotations::has_he_annotation(node) &&
+                  HEOpAnnotations::he_op_annotation(node)->packed();
+    auto tensor = m_he_seal_backend.create_plain_tensor(
+        node.get_element_type(), node.get_shape(), packed);
+    if (write_ones) {
+      const element::Type& type = node.get_element_type();
+      size_t count = shape_size(node.get_shape());
+      std::vector<double> ones(count, 1);
+      std::vector<char> values(count * type.size());
+      doubles_to_strided(ones.data(), count, values.data(), type.size(), type);
+      tensor->write(values.data(), values.size());
+    }
+    return std::static_pointer_cast<runtime::Tensor>(tensor);
+  };
+  std::vector<std::shared_ptr<runtime::Tensor>> inputs;
+  for (const auto& param : get_parameters()) {
+    inputs.emplace_back(create_tensor(*param, true));
+  }
+  std::vector<std::shared_ptr<runtime::Tensor>> outputs;
+  for (const auto& result : get_results()) {
+    outputs.emplace_back(create_tensor(*result, false));
+  }
+  call(outputs, inputs);
+
+  for (auto& [node, stop_watch] : m_timer_map) {
+    stop_watch = stopwatch();
+  }
+  for (auto& [node, stats] : m_op_stats) {
+    stats = HEOpStats();
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_memory_mutex);
+    m_peak_live_ciphertext_bytes = 0;
+    m_peak_live_ciphertext_node = nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_noise_mutex);
+    m_noise_samples.clear();
+  }
+  NGRAPH_HE_LOG(3) << "Warmed up executable";
+}
+
+void HESealExecutable::set_verbose_all_ops(bool value) {
+  m_verbose_all_ops = value;
+}
+
+OP_TYPEID HESealExecutable::get_typeid(const NodeTypeInfo& type_info) {
+  {
+    // This expands the op list in op_tbl.hpp into a list of enumerations that
+    // look like this: {Abs::type_info, OP_TYPEID::Abs}, {Acos::type_info,
+    // OP_TYPEID::Acos},
+    // ...
+    static const std::map<NodeTypeInfo, OP_TYPEID> type_info_map{
+#define NGRAPH_OP(NAME, NAMESPACE) \
+  {NAMESPACE::NAME::type_info, OP_TYPEID::ID_SUFFIX(NAME)},
+#include "opset_he_seal_tbl.hpp"
+#undef NGRAPH_OP
+    };
+    OP_TYPEID rc = OP_TYPEID::UnknownOp;
+
+    auto it = type_info_map.find(type_info);
+    if (it != type_info_map.end()) {
+      rc = it->second;
+    }
+    return rc;
+  }
+}
+
+void HESealExecutable::check_client_supports_function() {
+  // Check if single parameter is from client
+  size_t from_client_count = 0;
+  for (const auto& param : get_parameters()) {
+    if (HEOpAnnotations::from_client(*param)) {
+      from_client_count++;
+      NGRAPH_HE_LOG(5) << "Parameter " << param->get_name() << " from client";
+    }
+  }
+  NGRAPH_CHECK(get_results().size() == 1,
+               "HESealExecutable only supports output size 1 (got ",
+               get_results().size(), ")");
+  NGRAPH_CHECK(from_client_count > 0, "Expected > 0 parameters from client");
+}
+
+bool HESealExecutable::server_setup() {
+  if (!m_server_setup) {
+    NGRAPH_HE_LOG(1) << "Enable client";
+
+    check_client_supports_function();
+
+    NGRAPH_HE_LOG(1) << "Starting server";
+    start_server();
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+    // With "auto", the executor starts once the first client's link is
+    // measured
+    m_mpc_protocol = m_he_seal_backend.mpc_protocol();
+    if (enable_garbled_circuits() && m_mpc_protocol != "auto") {
+      start_aby_executor();
+    }
+#endif
+    m_server_setup = true;
+  } else {
+    NGRAPH_HE_LOG(1) << "Client already setup";
+  }
+
+  if (m_session == nullptr) {
+    start_next_session();
+  }
+  return true;
+}
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+size_t HESealExecutable::num_garbled_circuit_values() const {
+  size_t num_gc_values = 0;
+  for (const auto& node : m_function->get_ordered_ops()) {
+    auto type_id = get_typeid(node->get_type_info());
+    bool relu_op = type_id == OP_TYPEID::Relu ||
+                   type_id == OP_TYPEID::BoundedRelu ||
+                   type_id == OP_TYPEID::ConvolutionBiasRelu;
+    if (relu_op && m_he_seal_backend.polynomial_activation(*node) ==
+                       PolynomialActivation::none) {
+      num_gc_values += shape_size(node->get_output_shape(0));
+    }
+  }
+  return num_gc_values;
+}
+
+void HESealExecutable::start_aby_executor() {
+  NGRAPH_HE_LOG(1) << "Starting garbled circuits with mpc protocol "
+                   << m_mpc_protocol;
+  m_aby_executor = std::make_unique<aby::ABYServerExecutor>(
+      *this, m_mpc_protocol, std::string("0.0.0.0"), 34001, 128, 64,
+      m_he_seal_backend.num_garbled_circuit_party_threads(),
+      HEThreadBudget::bound(HEThreadBudget::Subsystem::garbled_circuit,
+                            m_he_seal_backend.num_garbled_circuit_threads()));
+
+  // Connecting the parties and precomputing masks for every Relu value
+  // does not depend on the client inputs, so it overlaps with the
+  // client encrypting and uploading them
+  m_aby_executor->start_offline_phase(num_garbled_circuit_values());
+}
+
+void HESealExecutable::send_network_probe(size_t index) {
+  m_probing_network = true;
+  json js = {{"function", "Ping"}, {"index", index}};
+  if (index > 0) {
+    js["padding"] = std::string(s_probe_bytes, '0');
+  }
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+  pb_message.mutable_function()->set_function(js.dump());
+  m_probe_start = std::chrono::steady_clock::now();
+  m_session->write_message(TCPMessage(std::move(pb_message)));
+}
+
+void HESealExecutable::handle_network_probe(size_t index) {
+  double elapsed_us = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - m_probe_start)
+                          .count();
+  if (index == 0) {
+    m_probe_rtt_us = elapsed_us;
+    send_network_probe(1);
+    return;
+  }
+
+  // The padded probe crosses the link in both directions
+  double transfer_us = std::max(elapsed_us - m_probe_rtt_us, 1.0);
+  aby::NetworkProfile network{m_probe_rtt_us,
+                              2.0 * s_probe_bytes / transfer_us};
+  // The circuits compute on the lowest coefficient modulus plus a carry bit
+  size_t circuit_bitlen = m_he_seal_backend.get_encryption_parameters()
+                              .seal_encryption_parameters()
+                              .coeff_modulus()[0]
+                              .bit_count() +
+                          1;
+  m_mpc_protocol = aby::choose_mpc_protocol(
+      network, num_garbled_circuit_values(), circuit_bitlen);
+  NGRAPH_HE_LOG(1) << "Measured round-trip time " << network.rtt_us
+                   << "us and bandwidth " << network.bytes_per_us
+                   << " bytes/us to client, choosing mpc protocol "
+                   << m_mpc_protocol;
+  m_probing_network = false;
+  start_aby_executor();
+  send_inference_shape();
+}
+#endif
+
+void HESealExecutable::start_next_session() {
+  NGRAPH_HE_LOG(3) << "Server waiting until session started";
+  std::unique_lock<std::mutex> mlock(m_session_mutex);
+  m_session_cond.wait(mlock, [this]() { return this->session_started(); });
+  m_session = m_pending_sessions.front();
+  m_pending_sessions.pop_front();
+  NGRAPH_HE_LOG(1) << "Serving session (" << m_pending_sessions.size()
+                   << " sessions waiting)";
+  if (record_metrics()) {
+    record_session_metrics();
+  }
+  mlock.unlock();
+
+  reset_session_state();
+
+  std::stringstream param_stream;
+  m_he_seal_backend.get_encryption_parameters().save(param_stream);
+
+  pb::EncryptionParameters pb_params;
+  *pb_params.mutable_encryption_parameters() = param_stream.str();
+  pb_params.set_compression_mode(
+      compr_mode_to_pb(m_he_seal_backend.compr_mode()));
+  for (int step : client_compaction_steps()) {
+    pb_params.add_galois_steps(step);
+  }
+
+  pb::TCPMessage pb_message;
+  *pb_message.mutable_encryption_parameters() = pb_params;
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+
+  NGRAPH_HE_LOG(3) << "Server writing parameters message";
+  m_session->write_message(TCPMessage(std::move(pb_message)));
+}
+
+void HESealExecutable::end_session() {
+  NGRAPH_HE_LOG(1) << "Ending session";
+  m_session = nullptr;
+
+  std::lock_guard<std::mutex> guard(m_session_mutex);
+  m_open_sessions--;
+  if (record_metrics()) {
+    m_metrics.add_counter("he_sessions_total", "Sessions served", 1);
+    record_session_metrics();
+  }
+  if (!m_accepting && !m_hosted_in_registry) {
+    m_accepting = true;
+    boost::asio::post(m_io_context, [this]() { accept_connection(); });
+  }
+}
+
+void HESealExecutable::reset_session_state() {
+  m_probing_network = false;
+  m_discard_client_inputs = false;
+  m_client_key_scope.clear();
+  m_client_keys_loaded = false;
+  m_client_public_key_set = false;
+  m_client_eval_key_set = !m_context->using_keyswitching();
+  m_client_galois_keys = nullptr;
+  m_compr_mode = seal::compr_mode_type::none;
+  {
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_persistent_session = false;
+    m_session_ended = false;
+  }
+  reset_call_state();
+
+  std::lock_guard<std::mutex> guard(m_relu_mutex);
+  m_relu_rtt_ms = 0;
+  m_relu_serialize_ms = 0;
+  m_relu_min_rtt_ms = std::numeric_limits<double>::max();
+  m_recorded_bytes_sent = 0;
+  m_recorded_bytes_received = 0;
+}
+
+void HESealExecutable::reset_call_state() {
+  m_sent_inference_shape = false;
+  {
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_client_inputs_received = false;
+  }
+  // Set client inputs to dummy values
+  if (m_is_compiled) {
+    m_client_inputs.clear();
+    m_client_inputs.resize(get_parameters().size());
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_client_inputs_loaded.assign(get_parameters().size(), 0);
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_client_outputs_mutex);
+    m_client_outputs.assign(m_function->get_results().size(), nullptr);
+  }
+#ifdef NGRAPH_HE_ABY_ENABLE
+  std::lock_guard<std::mutex> guard(m_aby_computed_relus_mutex);
+  m_aby_computed_relus.clear();
+#endif
+}
+
+void HESealExecutable::accept_connection() {
+  NGRAPH_HE_LOG(1) << "Server accepting connections";
+  if (m_he_seal_backend.shm_transport()) {
+    accept_shm_connection();
+    return;
+  }
+  auto server_callback =
+      std::bind(&HESealExecutable::handle_message, this, std::placeholders::_1);
+
+  m_acceptor->async_accept(
+      [this, server_callback](boost::system::error_code ec,
+                              boost::asio::ip::tcp::socket socket) {
+        if (!ec) {
+          NGRAPH_HE_LOG(1) << "Connection accepted";
+          add_session(
+              std::make_shared<TCPSession>(std::move(socket), server_callback));
+        } else if (ec == boost::asio::error::operation_aborted) {
+          NGRAPH_HE_LOG(1) << "Server stopped accepting connections";
+        } else {
+          NGRAPH_ERR << "error accepting connection " << ec.message();
+          accept_connection();
+        }
+      });
+}
+
+void HESealExecutable::accept_shm_connection() {
+  if (m_shm_channel == nullptr) {
+    m_shm_channel = ShmChannel::create(shm_transport_name(m_port));
+  }
+  if (m_shm_channel->client_attached()) {
+    NGRAPH_HE_LOG(1) << "Client attached to shared memory";
+    auto server_callback = std::bind(&HESealExecutable::handle_message, this,
+                                     std::placeholders::_1);
+    add_session(std::make_shared<ShmSession>(
+        m_io_context, std::move(m_shm_channel), server_callback));
+    return;
+  }
+  // Polling keeps the io_context busy, like a pending accept
+  m_shm_accept_timer->expires_after(std::chrono::milliseconds(1));
+  m_shm_accept_timer->async_wait([this](boost::system::error_code ec) {
+    if (ec == boost::asio::error::operation_aborted) {
+      NGRAPH_HE_LOG(1) << "Server stopped accepting connections";
+    } else {
+      accept_shm_connection();
+    }
+  });
+}
+
+void HESealExecutable::add_session(std::shared_ptr<ServerTransport> session) {
+  if (!m_hosted_in_registry) {
+    session->start();
+    NGRAPH_HE_LOG(1) << "Session started";
+  }
+
+  bool accept_next;
+  {
+    std::lock_guard<std::mutex> guard(m_session_mutex);
+    m_pending_sessions.emplace_back(std::move(session));
+    m_open_sessions++;
+    accept_next = !m_hosted_in_registry &&
+                  m_open_sessions < m_he_seal_backend.max_clients();
+    m_accepting = accept_next;
+    if (record_metrics()) {
+      record_session_metrics();
+    }
+    m_session_cond.notify_one();
+  }
+  if (accept_next) {
+    accept_connection();
+  }
+}
+
+void HESealExecutable::record_session_metrics() {
+  size_t pending_sessions = m_pending_sessions.size();
+  m_metrics.set_gauge("he_open_sessions",
+                      "Sessions accepted and not yet ended",
+                      static_cast<double>(m_open_sessions));
+  m_metrics.set_gauge("he_pending_sessions",
+                      "Sessions accepted and awaiting service",
+                      static_cast<double>(pending_sessions));
+  m_metrics.set_gauge("he_active_sessions", "Sessions being served",
+                      static_cast<double>(m_open_sessions - pending_sessions));
+}
+
+void HESealExecutable::record_phase_time(
+    const std::string& phase, std::chrono::steady_clock::time_point start) {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  m_metrics.add_counter("he_phase_seconds_total", "Time spent in each phase",
+                        elapsed.count(), {{"phase", phase}});
+}
+
+void HESealExecutable::record_call_metrics(
+    std::chrono::steady_clock::time_point call_start) {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - call_start;
+  m_metrics.add_counter("he_requests_total", "Calls served", 1);
+  m_metrics.observe("he_request_duration_seconds",
+                    "Time from the start of a call to its results being sent",
+                    elapsed.count());
+
+  // Session counters include the traffic between calls, e.g. the inputs of
+  // the next call
+  size_t bytes_sent = m_session->bytes_written();
+  size_t bytes_received = m_session->bytes_read();
+  m_metrics.add_counter(
+      "he_sent_bytes_total", "Bytes sent to clients",
+      static_cast<double>(bytes_sent - m_recorded_bytes_sent));
+  m_metrics.add_counter(
+      "he_received_bytes_total", "Bytes received from clients",
+      static_cast<double>(bytes_received - m_recorded_bytes_received));
+  m_recorded_bytes_sent = bytes_sent;
+  m_recorded_bytes_received = bytes_received;
+}
+
+void HESealExecutable::record_op_time(
+    const std::shared_ptr<const Node>& node) {
+  double seconds =
+      static_cast<double>(m_timer_map.at(node).get_microseconds()) / 1e6;
+  m_metrics.add_counter("he_op_seconds_total",
+                        "Time spent executing each op type", seconds,
+                        {{"op", node->description()}});
+}
+
+std::string HESealExecutable::scrape_metrics() {
+  HESealBackend::PoolStatistics pools = m_he_seal_backend.pool_statistics();
+  m_metrics.set_gauge(
+      "he_seal_pool_bytes", "Bytes allocated by the SEAL memory pools",
+      static_cast<double>(pools.global_bytes + pools.thread_local_bytes));
+  size_t relu_chunks;
+  {
+    std::lock_guard<std::mutex> guard(m_relu_mutex);
+    relu_chunks = m_relu_send_times.size();
+  }
+  m_metrics.set_gauge("he_relu_pending_chunks",
+                      "ReLU chunks awaiting a client response",
+                      static_cast<double>(relu_chunks));
+  return m_metrics.to_prometheus_text();
+}
+
+void HESealExecutable::host_in_registry() {
+  NGRAPH_CHECK(!m_server_setup,
+               "Cannot host an executable whose server is set up");
+  NGRAPH_CHECK(enable_client(), "Hosted executables require the client");
+  m_hosted_in_registry = true;
+}
+
+void HESealExecutable::start_server() {
+  if (m_hosted_in_registry) {
+    NGRAPH_HE_LOG(1) << "Serving sessions routed by the model registry";
+    return;
+  }
+  if (m_he_seal_backend.shm_transport()) {
+    NGRAPH_HE_LOG(1) << "Serving clients over shared memory "
+                     << shm_transport_name(m_port);
+    m_shm_accept_timer =
+        std::make_unique<boost::asio::steady_timer>(m_io_context);
+  } else {
+    boost::asio::ip::tcp::endpoint server_endpoints(
+        boost::asio::ip::tcp::v4(), m_port);
+    m_acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(
+        m_io_context, server_endpoints);
+    boost::asio::socket_base::reuse_address option(true);
+    m_acceptor->set_option(option);
+  }
+  if (record_metrics()) {
+    m_metrics_server = std::make_unique<HEMetricsServer>(
+        m_io_context, m_he_seal_backend.metrics_address(),
+        m_he_seal_backend.metrics_port(),
+        [this]() { return scrape_metrics(); });
+  }
+
+  accept_connection();
+  // Each session orders its own handlers, so further threads handle the
+  // messages of one session while another thread reads from its socket
+  size_t num_io_threads = HEThreadBudget::bound(
+      HEThreadBudget::Subsystem::io, m_he_seal_backend.num_io_threads());
+  NGRAPH_HE_LOG(3) << "Starting " << num_io_threads << " server I/O threads";
+  m_message_handling_threads.reserve(num_io_threads);
+  for (size_t thread_idx = 0; thread_idx < num_io_threads; ++thread_idx) {
+    m_message_handling_threads.emplace_back([this]() {
+      try {
+        m_io_context.run();
+      } catch (std::exception& e) {
+        NGRAPH_CHECK(false, "Server error handling thread: ", e.what());
+      }
+    });
+  }
+}
+
+void HESealExecutable::load_public_key(const pb::TCPMessage& pb_message) {
+  NGRAPH_HE_LOG(5) << "Server loading evaluation key";
+  NGRAPH_CHECK(pb_message.has_public_key(),
+               "pb_message doesn't have public key");
+
+  const std::string& pk_str = pb_message.public_key().public_key();
+  const std::string& key_id = pb_message.public_key().key_id();
+  if (pk_str.empty()) {
+    NGRAPH_CHECK(!key_id.empty(), "Public key message has no key or key id");
+    if (hosted_in_registry() && public_key_loaded(key_id)) {
+      NGRAPH_HE_LOG(3) << "Server keeping loaded keys of client " << key_id;
+      m_client_keys_loaded = true;
+      m_client_public_key_set = true;
+      m_client_eval_key_set = true;
+      if (m_he_seal_backend.input_cache_bytes() > 0) {
+        m_client_key_scope = key_id;
+      }
+    } else if (m_he_seal_backend.load_cached_client_keys(key_id)) {
+      m_client_public_key_set = true;
+      m_client_eval_key_set = true;
+      if (m_he_seal_backend.input_cache_bytes() > 0) {
+        m_client_key_scope = key_id;
+      }
+    } else {
+      request_client_keys();
+    }
+    return;
+  }
+
+  // Seeded keys are expanded on loading
+  seal::PublicKey key;
+  std::stringstream key_stream(pk_str);
+  key.load(*m_context, key_stream);
+  std::string loaded_key_id;
+  if (hosted_in_registry() || m_he_seal_backend.input_cache_bytes() > 0) {
+    std::stringstream pk_stream;
+    key.save(pk_stream);
+    loaded_key_id = key_fingerprint(pk_stream.str());
+  }
+  if (hosted_in_registry() && public_key_loaded(loaded_key_id)) {
+    NGRAPH_HE_LOG(3) << "Server keeping loaded keys of client "
+                     << loaded_key_id;
+    m_client_keys_loaded = true;
+  } else {
+    m_he_seal_backend.set_public_key(key);
+  }
+  m_client_public_key_set = true;
+  // As the cached key ids, the scope is the fingerprint of the expanded key
+  if (m_he_seal_backend.input_cache_bytes() > 0) {
+    m_client_key_scope = loaded_key_id;
+  }
+}
+
+bool HESealExecutable::public_key_loaded(const std::string& key_id) const {
+  auto public_key = m_he_seal_backend.get_public_key();
+  if (public_key == nullptr) {
+    return false;
+  }
+  std::stringstream pk_stream;
+  public_key->save(pk_stream);
+  return key_fingerprint(pk_stream.str()) == key_id;
+}
+
+void HESealExecutable::load_eval_key(const pb::TCPMessage& pb_message) {
+  NGRAPH_HE_LOG(5) << "Server loading evaluation key";
+  NGRAPH_CHECK(pb_message.has_eval_key(), "pb_message doesn't have eval key");
+
+  // Galois keys may accompany a key id, whose relinearization keys are
+  // cached
+  if (const std::string& galois_str = pb_message.eval_key().galois_keys();
+      !galois_str.empty()) {
+    auto galois_keys = std::make_shared<seal::GaloisKeys>();
+    std::stringstream galois_stream(galois_str);
+    galois_keys->load(*m_context, galois_stream);
+    m_client_galois_keys = galois_keys;
+    NGRAPH_HE_LOG(3) << "Server loaded client Galois keys for compaction";
+  }
+  const std::string& evk_str = pb_message.eval_key().eval_key();
+  if (evk_str.empty()) {
+    return;
+  }
+  if (m_client_keys_loaded) {
+    m_client_eval_key_set = true;
+    return;
+  }
+  seal::RelinKeys keys;
+  std::stringstream key_stream(evk_str);
+  keys.load(*m_context, key_stream);
+  m_he_seal_backend.set_relin_keys(keys);
+  m_client_eval_key_set = true;
+}
+
+void HESealExecutable::request_client_keys() {
+  NGRAPH_HE_LOG(3) << "Server requesting client keys";
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+
+  json js = {{"function", "Keys"}};
+  pb::Function f;
+  f.set_function(js.dump());
+  *pb_message.mutable_function() = f;
+  m_session->write_message(TCPMessage(std::move(pb_message)));
+}
+
+void HESealExecutable::send_inference_shape() {
+  m_sent_inference_shape = true;
+  m_session->write_message(TCPMessage(inference_shape_message()));
+}
+
+void HESealExecutable::accept_pipelined_inputs(const std::string& request_id) {
+  std::string expected_id =
+      key_fingerprint(inference_shape_message().SerializeAsString());
+  bool accepted = m_client_public_key_set && m_client_eval_key_set &&
+                  !enable_garbled_circuits() && request_id == expected_id;
+  if (accepted) {
+    NGRAPH_HE_LOG(3) << "Server accepting inputs of the cached request";
+    m_sent_inference_shape = true;
+  } else {
+    NGRAPH_HE_LOG(3) << "Server discarding inputs of the cached request";
+    m_discard_client_inputs = true;
+  }
+}
+
+pb::TCPMessage HESealExecutable::inference_shape_message() const {
+  const ParameterVector& input_parameters = get_parameters();
+
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+
+  for (const auto& input_param : input_parameters) {
+    if (HEOpAnnotations::from_client(*input_param)) {
+      pb::HETensor* pb_tensor = pb_message.add_he_tensors();
+
+      std::vector<uint64_t> shape{input_param->get_shape()};
+      *pb_tensor->mutable_shape() = {shape.begin(), shape.end()};
+
+      std::string name = input_param->get_provenance_tags().empty()
+                             ? input_param->get_name()
+                             : *input_param->get_provenance_tags().begin();
+
+      NGRAPH_HE_LOG(1) << "Server setting inference tensor name " << name
+                       << " (corresponding to Parameter "
+                       << input_param->get_name() << "), with "
+                       << input_param->get_shape();
+
+      pb_tensor->set_name(name);
+
+      if (HEOpAnnotations::plaintext_packed(*input_param)) {
+        NGRAPH_HE_LOG(1) << "Setting parameter " << input_param->get_name()
+                         << " to packed";
+        pb_tensor->set_packed(true);
+      }
+    }
+  }
+
+  NGRAPH_HE_LOG(1) << "Server sending inference of "
+                   << pb_message.he_tensors_size() << " parameters";
+
+  json js = {{"function", "Parameter"},
+             {"enable_gc", bool_to_string(enable_garbled_circuits())},
+             {"num_aby_parties",
+              std::to_string(m_he_seal_backend.num_garbled_circuit_threads())},
+             {"num_aby_party_threads",
+              std::to_string(
+                  m_he_seal_backend.num_garbled_circuit_party_threads())}};
+  if (!m_epilogue.empty()) {
+    js["epilogue"] = m_epilogue;
+  }
+#ifdef NGRAPH_HE_ABY_ENABLE
+  if (enable_garbled_circuits()) {
+    js["mpc_protocol"] = m_mpc_protocol;
+  }
+#endif
+  pb::Function f;
+  f.set_function(js.dump());
+  NGRAPH_HE_LOG(3) << "js " << js.dump();
+  *pb_message.mutable_function() = f;
+  return pb_message;
+}
+
+void HESealExecutable::handle_relu_result(const TCPMessage& message) {
+  NGRAPH_HE_LOG(3) << "Server handling relu result";
+  const pb::TCPMessage& pb_message = *message.pb_message();
+
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+               "Can only handle one tensor at a time, got ",
+               pb_message.he_tensors_size());
+  const auto& pb_tensor = pb_message.he_tensors(0);
+  size_t result_count = pb_tensor.data_size();
+
+  // The mutex only guards the bookkeeping. Each response fills disjoint
+  // slots of m_relu_data, which is not resized during the stream, so the
+  // response is deserialized into its slots while the server keeps sending
+  // chunks. Clients which do not echo stream ids answer in the order of the
+  // requests
+  size_t first_unknown_idx;
+  std::optional<ReluCompaction> compaction;
+  std::vector<size_t> result_slots;
+  {
+    std::lock_guard<std::mutex> guard(m_relu_mutex);
+    first_unknown_idx = m_relu_done_count;
+    if (pb_message.stream_id() != 0) {
+      auto stream_it = m_relu_streams.find(pb_message.stream_id());
+      NGRAPH_CHECK(stream_it != m_relu_streams.end(),
+                   "Unknown relu stream id ", pb_message.stream_id());
+      first_unknown_idx = stream_it->second;
+      m_relu_streams.erase(stream_it);
+      auto compaction_it = m_relu_compactions.find(pb_message.stream_id());
+      if (compaction_it != m_relu_compactions.end()) {
+        compaction = compaction_it->second;
+        m_relu_compactions.erase(compaction_it);
+      }
+    }
+    if (compaction.has_value()) {
+      NGRAPH_CHECK(result_count == ceil_div(compaction->num_values,
+                                            compaction->compaction),
+                   "Client returned ", result_count,
+                   " packed relu results, expected ",
+                   ceil_div(compaction->num_values, compaction->compaction));
+      NGRAPH_CHECK(first_unknown_idx + compaction->num_values <=
+                       m_unknown_relu_idx.size(),
+                   "Too many relu results");
+    } else {
+      NGRAPH_CHECK(
+          first_unknown_idx + result_count <= m_unknown_relu_idx.size(),
+          "Too many relu results");
+      auto first_slot =
+          m_unknown_relu_idx.begin() +
+          static_cast<std::ptrdiff_t>(first_unknown_idx);
+      result_slots.assign(
+          first_slot, first_slot + static_cast<std::ptrdiff_t>(result_count));
+    }
+  }
+
+  auto he_tensor = HETensor::load_from_pb_tensor(
+      pb_tensor, *m_he_seal_backend.get_ckks_encoder(),
+      m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
+      *m_he_seal_backend.get_decryptor(),
+      m_he_seal_backend.get_encryption_parameters(), message.payload(),
+      message.payload_size());
+  for (size_t result_idx = 0; result_idx < result_slots.size();
+       ++result_idx) {
+    m_relu_data[result_slots[result_idx]] = he_tensor->data(result_idx);
+  }
+
+  std::lock_guard<std::mutex> guard(m_relu_mutex);
+  if (compaction.has_value()) {
+    // Packed results are unpacked by finish_relu_stream, off the I/O thread
+    for (size_t result_idx = 0; result_idx < result_count; ++result_idx) {
+      NGRAPH_CHECK(he_tensor->data(result_idx).is_ciphertext(),
+                   "Packed relu result is not a ciphertext");
+      size_t first_value = result_idx * compaction->compaction;
+      m_packed_relu_results.push_back(
+          {first_unknown_idx + first_value,
+           std::min(compaction->compaction,
+                    compaction->num_values - first_value),
+           compaction->batch_size, he_tensor->data(result_idx)});
+    }
+    result_count = compaction->num_values;
+  }
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+  if (enable_garbled_circuits() && !pb_message.has_op_request()) {
+    m_aby_executor->post_process_aby_circuit(pb_message.function().function(),
+                                             he_tensor);
+  }
+#endif
+
+  m_relu_done_count += result_count;
+
+  // Record the round-trip time of each completed chunk
+  auto now = std::chrono::steady_clock::now();
+  while (!m_relu_send_times.empty() &&
+         m_relu_send_times.front().first <= m_relu_done_count) {
+    double rtt_ms = std::chrono::duration<double, std::milli>(
+                        now - m_relu_send_times.front().second)
+                        .count();
+    m_relu_min_rtt_ms = std::min(m_relu_min_rtt_ms, rtt_ms);
+    m_relu_send_times.pop_front();
+    if (record_metrics()) {
+      m_metrics.observe("he_relu_round_trip_seconds",
+                        "Round-trip time of ReLU chunks sent to the client",
+                        rtt_ms / 1000);
+    }
+  }
+  m_relu_cond.notify_all();
+}
+
+size_t HESealExecutable::relu_window() const {
+  if (m_he_seal_backend.relu_window() != 0) {
+    return m_he_seal_backend.relu_window();
+  }
+  std::lock_guard<std::mutex> guard(m_relu_mutex);
+  if (m_relu_rtt_ms <= 0 || m_relu_serialize_ms <= 0) {
+    return s_default_relu_window;
+  }
+  // Enough chunks in flight to cover one round-trip while serializing
+  auto window = static_cast<size_t>(
+      std::ceil(m_relu_rtt_ms / m_relu_serialize_ms)) + 1;
+  return std::clamp(window, s_min_relu_window, s_max_relu_window);
+}
+
+void HESealExecutable::handle_bounded_relu_result(const TCPMessage& message) {
+  handle_relu_result(message);
+}
+
+void HESealExecutable::handle_max_pool_result(const TCPMessage& message) {
+  std::lock_guard<std::mutex> guard(m_max_pool_mutex);
+  const pb::TCPMessage& pb_message = *message.pb_message();
+
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+               "Can only handle one tensor at a time, got ",
+               pb_message.he_tensors_size());
+
+  const auto& pb_tensor = pb_message.he_tensors(0);
+  // Results without garbled circuits carry an op request instead
+  const std::string& function = pb_message.function().function();
+  bool gc_result = false;
+  if (pb_message.has_function()) {
+    json js = json::parse(function);
+    gc_result = js.find("enable_gc") != js.end() &&
+                string_to_bool(std::string(js.at("enable_gc")));
+  }
+
+  auto he_tensor = HETensor::load_from_pb_tensor(
+      pb_tensor, *m_he_seal_backend.get_ckks_encoder(),
+      m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
+      *m_he_seal_backend.get_decryptor(),
+      m_he_seal_backend.get_encryption_parameters(), message.payload(),
+      message.payload_size());
+
+  if (gc_result) {
+#ifdef NGRAPH_HE_ABY_ENABLE
+    m_aby_executor->post_process_aby_circuit(function, he_tensor);
+#endif
+  }
+  // Each request computes all of its windows at once
+  m_max_pool_data = he_tensor->data();
+  m_max_pool_done = true;
+  m_max_pool_cond.notify_all();
+}
+
+void HESealExecutable::handle_message(const TCPMessage& message) {
+  NGRAPH_HE_LOG(3) << "Server handling message";
+  std::shared_ptr<pb::TCPMessage> pb_message = message.pb_message();
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+  switch (pb_message->type()) {
+    case pb::TCPMessage_Type_RESPONSE: {
+      if (pb_message->has_encryption_parameters()) {
+        m_compr_mode = compr_mode_from_pb(
+            pb_message->encryption_parameters().compression_mode());
+        NGRAPH_HE_LOG(3) << "Client accepted compression mode "
+                         << compr_mode_to_string(m_compr_mode);
+      }
+      if (pb_message->has_public_key()) {
+        load_public_key(*pb_message);
+      }
+      if (pb_message->has_eval_key()) {
+        load_eval_key(*pb_message);
+      }
+      // Keys uploaded by a client which persists them are kept for its
+      // reconnection. The id is recomputed from the expanded key, since
+      // the uploaded key may be seeded, so a client cannot register keys
+      // under another key's fingerprint
+      if (pb_message->has_public_key() &&
+          !pb_message->public_key().public_key().empty() &&
+          !pb_message->public_key().key_id().empty() &&
+          m_client_public_key_set && m_client_eval_key_set) {
+        std::stringstream pk_stream;
+        m_he_seal_backend.get_public_key()->save(pk_stream);
+        std::string key_id = key_fingerprint(pk_stream.str());
+        if (key_id != pb_message->public_key().key_id()) {
+          NGRAPH_WARN << "Client key id does not match its public key";
+        }
+        m_he_seal_backend.cache_client_keys(key_id);
+      }
+      if (pb_message->has_encryption_parameters() &&
+          !pb_message->encryption_parameters()
+               .inference_request_id()
+               .empty()) {
+        accept_pipelined_inputs(
+            pb_message->encryption_parameters().inference_request_id());
+      }
+      if (!m_sent_inference_shape && !m_probing_network &&
+          m_client_public_key_set && m_client_eval_key_set) {
+#ifdef NGRAPH_HE_ABY_ENABLE
+        // The link is measured once the client is idle after uploading its
+        // keys, so the probes do not wait on its key generation
+        if (enable_garbled_circuits() && m_aby_executor == nullptr) {
+          send_network_probe(0);
+        } else {
+          send_inference_shape();
+        }
+#else
+        send_inference_shape();
+#endif
+      }
+
+      if (pb_message->has_op_request()) {
+        switch (pb_message->op_request().op()) {
+          case pb::OpRequest_Op_RELU:
+            handle_relu_result(message);
+            break;
+          case pb::OpRequest_Op_BOUNDED_RELU:
+            handle_bounded_relu_result(message);
+            break;
+          case pb::OpRequest_Op_MAX_POOL:
+            handle_max_pool_result(message);
+            break;
+          case pb::OpRequest_Op_REFRESH:
+          case pb::OpRequest_Op_ELEMENTWISE:
+            handle_relu_result(message);
+            break;
+          default:
+            NGRAPH_CHECK(false, "Unknown op request ",
+                         pb_message->op_request().op());
+        }
+      } else if (pb_message->has_function()) {
+        const std::string& function = pb_message->function().function();
+        json js = json::parse(function);
+
+        auto name = js.at("function");
+
+        static std::unordered_set<std::string> known_function_names{
+            "Relu",       "BoundedRelu",   "MaxPool", "DotRelu",
+            "Ping",       "PipelineReset", "Session", "EndSession",
+            "CachedInput"};
+        NGRAPH_CHECK(
+            known_function_names.find(name) != known_function_names.end(),
+            "Unknown function name ", name);
+
+        if (name == "Relu") {
+          handle_relu_result(message);
+        } else if (name == "BoundedRelu") {
+          handle_bounded_relu_result(message);
+        } else if (name == "MaxPool" || name == "DotRelu") {
+          // Both are answered by a single garbled circuit result
+          handle_max_pool_result(message);
+        } else if (name == "Ping") {
+#ifdef NGRAPH_HE_ABY_ENABLE
+          handle_network_probe(js.at("index"));
+#endif
+        } else if (name == "PipelineReset") {
+          // The inputs uploaded after the reset answer the inference request
+          NGRAPH_HE_LOG(3) << "Client uploading inputs again";
+          m_discard_client_inputs = false;
+        } else if (name == "Session") {
+          std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+          m_persistent_session = js.value("persistent", false);
+          NGRAPH_HE_LOG(3) << "Client session persistent "
+                           << m_persistent_session;
+        } else if (name == "EndSession") {
+          NGRAPH_HE_LOG(1) << "Client ended its session";
+          std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+          m_session_ended = true;
+          m_client_inputs_cond.notify_all();
+        } else if (name == "CachedInput") {
+          handle_cached_client_input(js.at("name").get<std::string>(),
+                                     js.at("handle").get<std::string>());
+        }
+      }
+      break;
+    }
+    case pb::TCPMessage_Type_REQUEST: {
+      // Only a model-parallel coordinator sends requests with a function
+      if (pb_message->has_function()) {
+        handle_stage_message(message);
+      } else if (pb_message->he_tensors_size() > 0) {
+        handle_client_ciphers(message);
+      }
+      break;
+    }
+    case pb::TCPMessage_Type_UNKNOWN:
+    default:
+      NGRAPH_CHECK(false, "Unknonwn TCPMessage type");
+  }
+#pragma clang diagnostic pop
+}
+
+void HESealExecutable::handle_stage_message(const TCPMessage& message) {
+  const pb::TCPMessage& pb_message = *message.pb_message();
+  json js = json::parse(pb_message.function().function());
+  std::string name = js.at("function");
+  NGRAPH_HE_LOG(3) << "Handling stage message " << name;
+
+  if (name == "StageTensor") {
+    NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+                 "Stage tensor message must store 1 tensor");
+    size_t slot = js.at("slot");
+    NGRAPH_CHECK(slot < m_num_tensor_slots, "Invalid stage slot ", slot);
+    std::shared_ptr<HETensor> tensor;
+    {
+      std::lock_guard<std::mutex> guard(m_stage_mutex);
+      m_stage_slots.resize(m_num_tensor_slots);
+      tensor = m_stage_slots[slot];
+    }
+    if (tensor == nullptr) {
+      tensor = HETensor::load_from_pb_tensor(
+          pb_message.he_tensors(0), *m_he_seal_backend.get_ckks_encoder(),
+          m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
+          *m_he_seal_backend.get_decryptor(),
+          m_he_seal_backend.get_encryption_parameters(), message.payload(),
+          message.payload_size(), m_he_seal_backend.trusted_ciphertexts());
+      std::lock_guard<std::mutex> guard(m_stage_mutex);
+      m_stage_slots[slot] = tensor;
+    } else {
+      HETensor::load_from_pb_tensor(
+          tensor, pb_message.he_tensors(0), m_he_seal_backend.get_context(),
+          message.payload(), message.payload_size(),
+          m_he_seal_backend.trusted_ciphertexts());
+    }
+  } else if (name == "Stage" || name == "StageEnd") {
+    // Executed by serve_stages, since handlers must not wait for writes
+    std::lock_guard<std::mutex> guard(m_stage_mutex);
+    m_stage_requests.emplace_back(pb_message.function().function());
+    m_stage_cond.notify_all();
+  } else {
+    NGRAPH_CHECK(false, "Unknown stage function name ", name);
+  }
+}
+
+void HESealExecutable::handle_client_ciphers(const TCPMessage& message) {
+  NGRAPH_HE_LOG(3) << "Handling client tensors";
+  const pb::TCPMessage& pb_message = *message.pb_message();
+
+  NGRAPH_CHECK(pb_message.he_tensors_size() > 0,
+               "Client received empty tensor message");
+  NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+               "Client only supports 1 client tensor");
+  if (m_discard_client_inputs) {
+    NGRAPH_HE_LOG(3) << "Discarding client tensor of the cached request";
+    return;
+  }
+  // TODO(fboemer): check for uniqueness of batch size if > 1 input tensor
+
+  auto& pb_tensor = pb_message.he_tensors(0);
+  ngraph::Shape shape{pb_tensor.shape().begin(), pb_tensor.shape().end()};
+
+  NGRAPH_HE_LOG(5) << "pb_tensor.packed() " << pb_tensor.packed();
+  set_batch_size(HETensor::batch_size(shape, pb_tensor.packed()));
+  NGRAPH_HE_LOG(5) << "Offset " << pb_tensor.offset();
+
+  std::optional<size_t> param_idx = find_client_parameter(pb_tensor.name());
+  NGRAPH_CHECK(param_idx, "Could not find matching parameter name ",
+               pb_tensor.name());
+
+  // Messages are handled by a single thread, which is the only writer of
+  // the client inputs and their loaded counts
+  NGRAPH_CHECK(!m_he_seal_backend.stream_client_inputs() ||
+                   pb_tensor.offset() == m_client_inputs_loaded[*param_idx],
+               "Streamed client input ", pb_tensor.name(),
+               " received out of order at offset ", pb_tensor.offset());
+  if (m_client_inputs[param_idx.value()] == nullptr) {
+    auto he_tensor = HETensor::load_from_pb_tensor(
+        pb_tensor, *m_he_seal_backend.get_ckks_encoder(),
+        m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
+        *m_he_seal_backend.get_decryptor(),
+        m_he_seal_backend.get_encryption_parameters(), message.payload(),
+        message.payload_size());
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_client_inputs[param_idx.value()] = he_tensor;
+  } else {
+    HETensor::load_from_pb_tensor(m_client_inputs[param_idx.value()], pb_tensor,
+                                  m_he_seal_backend.get_context(),
+                                  message.payload(), message.payload_size());
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_client_inputs_loaded[*param_idx] += pb_tensor.data_size();
+  }
+  if (m_he_seal_backend.stream_client_inputs()) {
+    m_client_inputs_cond.notify_all();
+  }
+
+  // Uploads with a handle are cached once complete, for later requests.
+  // Kernels may relinearize or switch the modulus of their arguments in
+  // place, so the cache stores a copy of the uploaded ciphertexts
+  if (!pb_tensor.cache_handle().empty() && !m_client_key_scope.empty() &&
+      m_he_seal_backend.input_cache_bytes() > 0 &&
+      m_client_inputs[*param_idx]->done_loading()) {
+    m_he_seal_backend.cache_client_input(
+        m_client_key_scope, pb_tensor.cache_handle(),
+        m_client_inputs[*param_idx]->deep_copy());
+  }
+  notify_if_client_inputs_loaded();
+}
+
+void HESealExecutable::handle_cached_client_input(const std::string& name,
+                                                  const std::string& handle) {
+  if (m_discard_client_inputs) {
+    return;
+  }
+  std::optional<size_t> param_idx = find_client_parameter(name);
+  NGRAPH_CHECK(param_idx, "Could not find matching parameter name ", name);
+
+  std::shared_ptr<HETensor> tensor;
+  if (!m_client_key_scope.empty() &&
+      m_he_seal_backend.input_cache_bytes() > 0) {
+    tensor = m_he_seal_backend.cached_client_input(m_client_key_scope, handle);
+  }
+  const auto& param = get_parameters()[*param_idx];
+  if (tensor == nullptr || tensor->get_shape() != param->get_shape() ||
+      tensor->get_element_type() != param->get_element_type()) {
+    NGRAPH_HE_LOG(3) << "Client input " << handle << " not cached";
+    pb::TCPMessage pb_message;
+    pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+    json js = {{"function", "CachedInputMiss"}, {"name", name}};
+    pb_message.mutable_function()->set_function(js.dump());
+    m_session->write_message(TCPMessage(std::move(pb_message)));
+    return;
+  }
+
+  NGRAPH_HE_LOG(3) << "Using cached client input " << handle;
+  set_batch_size(tensor->get_batch_size());
+  // Cached inputs are shared with other calls, and kernels may modify their
+  // arguments in place, so each call uses copies of the ciphertexts
+  tensor = tensor->deep_copy();
+  {
+    std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+    m_client_inputs[*param_idx] = tensor;
+    m_client_inputs_loaded[*param_idx] = tensor->get_batched_element_count();
+  }
+  if (m_he_seal_backend.stream_client_inputs()) {
+    m_client_inputs_cond.notify_all();
+  }
+  notify_if_client_inputs_loaded();
+}
+
+std::optional<size_t> HESealExecutable::find_client_parameter(
+    const std::string& tensor_name) const {
+  NGRAPH_HE_LOG(5) << "Calling find_client_parameter(" << tensor_name << ")";
+  const ParameterVector& input_parameters = get_parameters();
+  for (size_t param_idx = 0; param_idx < input_parameters.size();
+       ++param_idx) {
+    const auto& parameter = input_parameters[param_idx];
+
+    for (const auto& tag : parameter->get_provenance_tags()) {
+      NGRAPH_HE_LOG(5) << "Tag " << tag;
+    }
+
+    if (param_originates_from_name(*parameter, tensor_name)) {
+      NGRAPH_HE_LOG(5) << "Param " << tensor_name << " matches at index "
+                       << param_idx;
+      return param_idx;
+    }
+  }
+  NGRAPH_HE_LOG(5) << "Could not find tensor " << tensor_name;
+  return std::nullopt;
+}
+
+void HESealExecutable::notify_if_client_inputs_loaded() {
+  const ParameterVector& input_parameters = get_parameters();
+  for (size_t param_idx = 0; param_idx < input_parameters.size();
+       ++param_idx) {
+    const auto& param = input_parameters[param_idx];
+    if (HEOpAnnotations::from_client(*param)) {
+      NGRAPH_HE_LOG(5) << "From client param shape " << param->get_shape();
+      NGRAPH_HE_LOG(5) << "m_batch_size " << m_batch_size;
+
+      if (m_client_inputs[param_idx] == nullptr ||
+          !m_client_inputs[param_idx]->done_loading()) {
+        NGRAPH_HE_LOG(3) << "Not yet done loading client ciphertexts";
+        return;
+      }
+    }
+  }
+  NGRAPH_HE_LOG(3) << "Done loading client ciphertexts";
+
+  std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+  m_client_inputs_received = true;
+  NGRAPH_HE_LOG(5) << "Notifying done loading client ciphertexts";
+  m_client_inputs_cond.notify_all();
+}
+
+size_t HESealExecutable::wait_for_client_input(const HETensor& tensor,
+                                               size_t count) {
+  size_t num_elements = tensor.get_batched_element_count();
+  count = std::min(count, num_elements);
+
+  std::unique_lock<std::mutex> lock(m_client_inputs_mutex);
+  for (size_t param_idx = 0; param_idx < m_client_inputs.size();
+       ++param_idx) {
+    if (m_client_inputs[param_idx].get() == &tensor) {
+      auto loaded = [&]() {
+        return m_client_inputs_loaded[param_idx] >= count;
+      };
+      if (!loaded()) {
+        HEWorkerPool::BlockingScope blocking_scope;
+        m_client_inputs_cond.wait(lock, loaded);
+      }
+      return m_client_inputs_loaded[param_idx];
+    }
+  }
+  return num_elements;
+}
+
+std::vector<runtime::PerformanceCounter>
+HESealExecutable::get_performance_data() const {
+  std::vector<runtime::PerformanceCounter> rc;
+  for (const auto& [node, stop_watch] : m_timer_map) {
+    rc.emplace_back(node, stop_watch.get_total_microseconds(),
+                    stop_watch.get_call_count());
+  }
+  return rc;
+}
+
+std::vector<HEPerformanceCounter> HESealExecutable::get_he_performance_data()
+    const {
+  std::vector<HEPerformanceCounter> rc;
+  for (const auto& [node, stop_watch] : m_timer_map) {
+    rc.emplace_back(node, stop_watch.get_total_microseconds(),
+                    stop_watch.get_call_count(), m_op_stats.at(node));
+  }
+  return rc;
+}
+
+std::string HESealExecutable::performance_data_json() const {
+  auto peak_node = peak_live_ciphertext_node();
+  json js = json::array();
+  for (const auto& counter : get_he_performance_data()) {
+    const HEOpStats& stats = counter.stats();
+    json primitives;
+    for (size_t i = 0; i < s_num_he_primitives; ++i) {
+      primitives[he_primitive_name(static_cast<HEPrimitive>(i))] =
+          stats.primitives[i];
+    }
+    js.push_back({{"name", counter.get_node()->get_name()},
+                  {"op", counter.get_node()->description()},
+                  {"calls", counter.call_count()},
+                  {"total_us", counter.total_microseconds()},
+                  {"primitives", primitives},
+                  {"ciphertexts", stats.ciphertexts},
+                  {"bytes_sent", stats.bytes_sent},
+                  {"bytes_received", stats.bytes_received},
+                  {"client_wait_us", stats.client_wait_us},
+                  {"ciphertext_bytes", stats.ciphertext_bytes},
+                  {"pool_bytes", stats.pool_bytes},
+                  {"peak_live_bytes", stats.peak_live_bytes},
+                  {"peak", counter.get_node() == peak_node}});
+  }
+  return js.dump(2);
+}
+
+size_t HESealExecutable::peak_live_ciphertext_bytes() const {
+  std::lock_guard<std::mutex> guard(m_memory_mutex);
+  return m_peak_live_ciphertext_bytes;
+}
+
+std::shared_ptr<const Node> HESealExecutable::peak_live_ciphertext_node()
+    const {
+  std::lock_guard<std::mutex> guard(m_memory_mutex);
+  return m_peak_live_ciphertext_node;
+}
+
+void HESealExecutable::update_live_ciphertext_bytes(
+    const std::shared_ptr<const Node>& node, const NodeSlots& node_slots,
+    const std::vector<std::shared_ptr<HETensor>>& tensor_slots,
+    HEOpStats& stats) {
+  // Only this node writes these slots, so they are counted before locking
+  std::vector<std::pair<size_t, size_t>> slot_bytes;
+  auto count_slot = [&](size_t slot) {
+    const auto& tensor = tensor_slots[slot];
+    slot_bytes.emplace_back(
+        slot, tensor == nullptr ? 0 : tensor->ciphertext_byte_count());
+  };
+  for (size_t slot : node_slots.outputs) {
+    count_slot(slot);
+  }
+  for (size_t i = 0; i < node_slots.inputs.size(); ++i) {
+    if (node_slots.sole_reader[i]) {
+      count_slot(node_slots.inputs[i]);
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(m_memory_mutex);
+  for (const auto& [slot, bytes] : slot_bytes) {
+    m_live_ciphertext_bytes += bytes;
+    m_live_ciphertext_bytes -= m_slot_ciphertext_bytes[slot];
+    m_slot_ciphertext_bytes[slot] = bytes;
+  }
+  stats.peak_live_bytes = m_live_ciphertext_bytes;
+  if (m_live_ciphertext_bytes > m_peak_live_ciphertext_bytes ||
+      m_peak_live_ciphertext_node == nullptr) {
+    m_peak_live_ciphertext_bytes = m_live_ciphertext_bytes;
+    m_peak_live_ciphertext_node = node;
+  }
+}
+
+void HESealExecutable::release_slot_bytes(size_t slot) {
+  std::lock_guard<std::mutex> guard(m_memory_mutex);
+  m_live_ciphertext_bytes -= m_slot_ciphertext_bytes[slot];
+  m_slot_ciphertext_bytes[slot] = 0;
+}
+
+void HESealExecutable::set_slot_bytes(size_t slot, size_t bytes) {
+  std::lock_guard<std::mutex> guard(m_memory_mutex);
+  m_live_ciphertext_bytes -= m_slot_ciphertext_bytes[slot];
+  m_live_ciphertext_bytes += bytes;
+  m_slot_ciphertext_bytes[slot] = bytes;
+}
+
+void HESealExecutable::spill_cold_tensors(
+    size_t next_idx,
+    const std::vector<std::shared_ptr<HETensor>>& tensor_slots) {
+  size_t threshold = m_he_seal_backend.spill_threshold_bytes();
+  // Pairs of the next node reading a slot, and the slot
+  std::vector<std::pair<size_t, size_t>> candidates;
+  size_t live_bytes = 0;
+  {
+    std::lock_guard<std::mutex> guard(m_memory_mutex);
+    live_bytes = m_live_ciphertext_bytes;
+    if (live_bytes <= threshold) {
+      return;
+    }
+    for (size_t slot = 0; slot < m_num_tensor_slots; ++slot) {
+      if (!m_intermediate_slots[slot] || tensor_slots[slot] == nullptr ||
+          m_slot_ciphertext_bytes[slot] == 0) {
+        continue;
+      }
+      const auto& readers = m_slot_read_nodes[slot];
+      auto next_read =
+          std::lower_bound(readers.begin(), readers.end(), next_idx);
+      if (next_read != readers.end() && *next_read != next_idx) {
+        candidates.emplace_back(*next_read, slot);
+      }
+    }
+  }
+  std::sort(candidates.rbegin(), candidates.rend());
+
+  for (const auto& [next_read, slot] : candidates) {
+    if (live_bytes <= threshold) {
+      break;
+    }
+    if (m_spill->contains(slot)) {
+      continue;
+    }
+    const auto& tensor = tensor_slots[slot];
+    m_spill->spill(slot, tensor->data());
+    set_slot_bytes(slot, tensor->ciphertext_byte_count());
+    {
+      std::lock_guard<std::mutex> guard(m_memory_mutex);
+      live_bytes = m_live_ciphertext_bytes;
+    }
+    NGRAPH_HE_LOG(5) << "Spilled slot " << slot << ", read again by "
+                     << m_nodes[next_read]->get_name();
+  }
+}
+
+void HESealExecutable::restore_spilled_inputs(
+    size_t node_idx,
+    const std::vector<std::shared_ptr<HETensor>>& tensor_slots) {
+  for (size_t slot : m_node_slots[node_idx].inputs) {
+    if (m_spill->contains(slot)) {
+      const auto& tensor = tensor_slots[slot];
+      m_spill->restore(slot, tensor->data(), m_he_seal_backend.get_context());
+      set_slot_bytes(slot, tensor->ciphertext_byte_count());
+    }
+  }
+}
+
+std::vector<HENoiseReport> HESealExecutable::get_noise_report() const {
+  std::lock_guard<std::mutex> guard(m_noise_mutex);
+  std::vector<HENoiseReport> reports;
+  for (const auto& node : m_nodes) {
+    auto it = m_noise_samples.find(node);
+    if (it == m_noise_samples.end()) {
+      continue;
+    }
+    HENoiseReport report{node, it->second};
+    double input_precision = std::numeric_limits<double>::infinity();
+    for (const auto& arg : node->get_arguments()) {
+      if (auto arg_it = m_noise_samples.find(arg);
+          arg_it != m_noise_samples.end()) {
+        input_precision =
+            std::min(input_precision, arg_it->second.precision_bits);
+      }
+    }
+    if (std::isfinite(input_precision)) {
+      report.precision_drift_bits =
+          input_precision - report.sample.precision_bits;
+    }
+    reports.emplace_back(std::move(report));
+  }
+  return reports;
+}
+
+std::string HESealExecutable::noise_report_json() const {
+  json nodes = json::array();
+  NoiseSample total;
+  for (const auto& report : get_noise_report()) {
+    const NoiseSample& sample = report.sample;
+    total.merge(sample);
+    nodes.push_back({{"name", report.node->get_name()},
+                     {"op", report.node->description()},
+                     {"samples", sample.num_samples},
+                     {"chain_index", sample.chain_index},
+                     {"log2_scale", sample.log2_scale},
+                     {"headroom_bits", sample.headroom_bits},
+                     {"precision_bits", sample.precision_bits},
+                     {"precision_drift_bits", report.precision_drift_bits},
+                     {"warning", sample.warning()}});
+  }
+  json js = {{"nodes", nodes}};
+  if (total.num_samples > 0) {
+    js["min_chain_index"] = total.chain_index;
+    js["min_headroom_bits"] = total.headroom_bits;
+    js["min_precision_bits"] = total.precision_bits;
+  }
+  return js.dump(2);
+}
+
+void HESealExecutable::sample_noise(
+    const std::shared_ptr<const Node>& node,
+    const std::vector<std::shared_ptr<HETensor>>& outputs) {
+  NoiseSample sample;
+  for (const auto& output : outputs) {
+    const auto& data = output->data();
+    size_t stride =
+        std::max(size_t{1}, data.size() / s_noise_samples_per_tensor);
+    for (size_t i = 0; i < data.size(); i += stride) {
+      // Complex packing stores values in the imaginary parts, which the
+      // precision estimate assumes to be noise
+      if (!data[i].is_ciphertext() || data[i].complex_packing()) {
+        continue;
+      }
+      sample.merge(he::measure_noise(
+          data[i].get_ciphertext()->ciphertext(), data[i].batch_size(),
+          *m_he_seal_backend.get_context(), *m_he_seal_backend.get_decryptor(),
+          *m_he_seal_backend.get_ckks_encoder()));
+    }
+  }
+  if (sample.num_samples == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(m_noise_mutex);
+  NoiseSample& node_sample = m_noise_samples[node];
+  bool warned = node_sample.warning();
+  node_sample.merge(sample);
+  if (!warned && node_sample.warning()) {
+    NGRAPH_WARN << "Outputs of " << node->get_name() << " have "
+                << node_sample.headroom_bits << " bits of headroom and "
+                << node_sample.precision_bits << " bits of precision at chain "
+                << "index " << node_sample.chain_index;
+  }
+}
+
+void HESealExecutable::record_client_wait(
+    std::chrono::steady_clock::time_point wait_start) {
+  auto wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - wait_start)
+                     .count();
+  s_client_wait_us += static_cast<size_t>(wait_us);
+}
+
+bool HESealExecutable::call(
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs) {
+  NGRAPH_HE_LOG(3) << "HESealExecutable::call";
+  NGRAPH_CHECK(!m_dry_run, "Cannot call a function compiled for a dry run");
+  validate(outputs, server_inputs);
+  NGRAPH_HE_LOG(3) << "HESealExecutable::call validated inputs";
+  ScopedIntraOpThreads intra_op_threads(m_num_intra_op_threads);
+  auto call_start = std::chrono::steady_clock::now();
+  auto phase_start = call_start;
+
+  if (enable_client()) {
+    if (!server_setup()) {
+      return false;
+    }
+    if (record_metrics()) {
+      record_phase_time("session", phase_start);
+      phase_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  if (complex_packing()) {
+    NGRAPH_HE_LOG(1) << "Complex packing";
+  }
+
+  if (enable_client()) {
+    NGRAPH_HE_LOG(1) << "Waiting for m_client_inputs";
+
+    std::unique_lock<std::mutex> mlock(m_client_inputs_mutex);
+    // Later inferences of a persistent session are requested by their call
+    if (m_persistent_session && !m_session_ended && !m_sent_inference_shape) {
+      send_inference_shape();
+    }
+    auto inputs_ready = [&]() {
+      if (!m_he_seal_backend.stream_client_inputs()) {
+        return client_inputs_received();
+      }
+      // Start once the first chunk of each client input has been loaded,
+      // which creates the input tensor
+      const auto& parameters = get_parameters();
+      for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+        if (HEOpAnnotations::from_client(*parameters[param_idx]) &&
+            m_client_inputs[param_idx] == nullptr) {
+          return false;
+        }
+      }
+      return true;
+    };
+    while (true) {
+      m_client_inputs_cond.wait(
+          mlock, [&]() { return m_session_ended || inputs_ready(); });
+      if (!m_session_ended) {
+        break;
+      }
+      // The client ended its persistent session instead of sending inputs,
+      // so the call serves the next session
+      mlock.unlock();
+      end_session();
+      start_next_session();
+      mlock.lock();
+    }
+    NGRAPH_HE_LOG(1) << "Client inputs "
+                     << (m_he_seal_backend.stream_client_inputs() ? "started"
+                                                                  : "received");
+    if (record_metrics()) {
+      record_phase_time("client_inputs", phase_start);
+      phase_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  // convert inputs to HETensor
+  NGRAPH_HE_LOG(3) << "Converting inputs to HETensor";
+  const auto& parameters = get_parameters();
+  std::vector<std::shared_ptr<HETensor>> he_inputs;
   for (size_t input_idx = 0; input_idx < server_inputs.size(); ++input_idx) {
     auto param_shape = server_inputs[input_idx]->get_shape();
     auto& param = parameters[input_idx];
     std::shared_ptr<HETensor> he_input;
 
-    if (enable_client() && HEOpAnnotations::from_client(*param)) {
-      NGRAPH_HE_LOG(1) << "Processing parameter " << param->get_name()
-                       << "(shape {" << param_shape << "}) from client";
-      NGRAPH_CHECK(m_client_inputs.size() > input_idx,
-                   "Not enough client inputs");
-      he_input = std::static_pointer_cast<HETensor>(m_client_inputs[input_idx]);
+    if (enable_client() && HEOpAnnotations::from_client(*param)) {
+      NGRAPH_HE_LOG(1) << "Processing parameter " << param->get_name()
+                       << "(shape {" << param_shape << "}) from client";
+      NGRAPH_CHECK(m_client_inputs.size() > input_idx,
+                   "Not enough client inputs");
+      {
+        std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+        he_input = m_client_inputs[input_idx];
+      }
+
+      // Only the first element of a streamed input is known to be loaded
+      bool encrypted = m_he_seal_backend.stream_client_inputs()
+                           ? he_input->data(0).is_ciphertext()
+                           : he_input->any_encrypted_data();
+      auto current_annotation = HEOpAnnotations::he_op_annotation(*param);
+      current_annotation->set_encrypted(encrypted);
+    } else {
+      NGRAPH_HE_LOG(1) << "Processing parameter " << param->get_name()
+                       << "(shape {" << param_shape << "}) from server";
+
+      he_input = std::static_pointer_cast<HETensor>(server_inputs[input_idx]);
+      auto current_annotation = HEOpAnnotations::he_op_annotation(*param);
+
+      NGRAPH_HE_LOG(5) << "Parameter " << param->get_name()
+                       << " has annotation " << *current_annotation;
+      // Encrypted parameters passed again without being written to, e.g.
+      // encrypted model weights, are not scanned or encrypted again
+      bool reuse_encrypted = current_annotation->encrypted() &&
+                             reuse_encrypted_server_input(input_idx, he_input);
+      if (reuse_encrypted) {
+        NGRAPH_HE_LOG(3) << "Reusing encrypted parameter " << param->get_name()
+                         << " from server";
+      } else if (!he_input->any_encrypted_data()) {
+        if (current_annotation->packed()) {
+          he_input->pack();
+        } else {
+          he_input->unpack();
+        }
+      }
+
+      if (current_annotation->encrypted() && !reuse_encrypted) {
+        NGRAPH_HE_LOG(3) << "Encrypting parameter " << param->get_name()
+                         << " from server";
+#pragma omp parallel for
+        for (size_t he_type_idx = 0;
+             he_type_idx < he_input->get_batched_element_count();
+             ++he_type_idx) {
+          if (he_input->data(he_type_idx).is_plaintext()) {
+            auto cipher = HESealBackend::create_empty_ciphertext();
+            m_he_seal_backend.encrypt(
+                cipher, he_input->data(he_type_idx).get_plaintext(),
+                he_input->get_element_type(),
+                he_input->data(he_type_idx).complex_packing());
+            he_input->data(he_type_idx).set_ciphertext(cipher);
+          }
+        }
+        NGRAPH_HE_LOG(3) << "Done encrypting parameter " << param->get_name()
+                         << " from server";
+        record_encrypted_server_input(input_idx, he_input);
+      }
+    }
+    NGRAPH_CHECK(he_input != nullptr, "HE input is nullptr");
+    NGRAPH_CHECK(
+        he_input->is_packed() ==
+            HEOpAnnotations::he_op_annotation(*param)->packed(),
+        "Mismatch between tensor input and annotation (", he_input->is_packed(),
+        " != ", HEOpAnnotations::he_op_annotation(*param)->packed(), ")");
+    if (he_input->is_packed()) {
+      set_batch_size(he_input->get_batch_size());
+    }
+    he_inputs.emplace_back(he_input);
+  }
+
+  NGRAPH_HE_LOG(3) << "Updating HE op annotations";
+  update_he_op_annotations();
+  if (!m_he_seal_backend.model_parallel_stages().empty() ||
+      !m_he_seal_backend.data_parallel_workers().empty()) {
+    plan_model_parallel_stages();
+    for (auto& stage_client : m_stage_clients) {
+      stage_client->send_keys();
+    }
+  }
+
+  NGRAPH_HE_LOG(3) << "Converting outputs to HETensor";
+  std::vector<std::shared_ptr<HETensor>> he_outputs;
+  he_outputs.reserve(outputs.size());
+  for (auto& tensor : outputs) {
+    he_outputs.push_back(std::static_pointer_cast<HETensor>(tensor));
+  }
+
+  NGRAPH_HE_LOG(3) << "Mapping function parameters to HETensor";
+  NGRAPH_CHECK(he_inputs.size() >= parameters.size(),
+               "Not enough inputs in input map");
+  NGRAPH_CHECK(m_parameter_slots.size() <= he_inputs.size(),
+               "Not enough inputs for parameter outputs");
+  std::vector<std::shared_ptr<HETensor>> tensor_slots(m_num_tensor_slots);
+  for (size_t input_idx = 0; input_idx < m_parameter_slots.size();
+       ++input_idx) {
+    tensor_slots[m_parameter_slots[input_idx]] = he_inputs[input_idx];
+  }
+
+  NGRAPH_HE_LOG(3) << "Mapping function outputs to HETensor";
+  for (size_t output_count = 0; output_count < get_results().size();
+       ++output_count) {
+    std::shared_ptr<op::Result> output = get_results()[output_count];
+
+    auto& he_output = he_outputs[output_count];
+
+    if (HEOpAnnotations::has_he_annotation(*output)) {
+      auto he_op_annotation = HEOpAnnotations::he_op_annotation(*output);
+      if (!he_output->any_encrypted_data()) {
+        if (he_op_annotation->packed()) {
+          he_output->pack();
+        } else {
+          he_output->unpack();
+        }
+      }
+    }
+    tensor_slots[m_result_slots[output_count]] = he_output;
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(m_memory_mutex);
+    m_slot_ciphertext_bytes.assign(m_num_tensor_slots, 0);
+    m_live_ciphertext_bytes = 0;
+  }
+
+  size_t num_inter_op_threads =
+      std::min(m_he_seal_backend.num_inter_op_threads(), m_nodes.size());
+  // Stage segments execute in order, so model-parallel calls are serial
+  bool model_parallel = !m_stage_segments.empty();
+  if (num_inter_op_threads > 1 && !model_parallel) {
+    execute_nodes_concurrently(tensor_slots, num_inter_op_threads);
+  } else {
+    // Client nodes are executed along with later client nodes of the same
+    // coalesce key whose inputs are already computed
+    std::vector<char> executed(m_nodes.size(), 0);
+    auto inputs_computed = [&](size_t node_idx) {
+      for (size_t slot : m_node_slots[node_idx].inputs) {
+        if (tensor_slots[slot] == nullptr) {
+          return false;
+        }
+      }
+      return true;
+    };
+    auto next_node = [&](size_t node_idx) {
+      size_t next = node_idx + 1;
+      while (next < m_nodes.size() && executed[next]) {
+        ++next;
+      }
+      return next;
+    };
+    const std::string& spill_directory = m_he_seal_backend.spill_directory();
+    if (spill_directory.empty() || model_parallel) {
+      m_spill = nullptr;
+    } else if (m_spill == nullptr || m_spill->directory() != spill_directory) {
+      m_spill = std::make_unique<SealCiphertextSpill>(spill_directory);
+    }
+    size_t spilled_bytes_start =
+        m_spill != nullptr ? m_spill->total_spilled_bytes() : 0;
+    // Restores the spilled inputs of the next node while a node executes
+    std::future<void> prefetch;
+    // for each ordered op in the graph
+    for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+      const std::string& key = m_node_slots[node_idx].coalesce_key;
+      if (m_spill != nullptr && !executed[node_idx]) {
+        if (prefetch.valid()) {
+          prefetch.get();
+        }
+        restore_spilled_inputs(node_idx, tensor_slots);
+        for (size_t chained : m_node_slots[node_idx].tiled_chain) {
+          restore_spilled_inputs(chained, tensor_slots);
+        }
+        size_t next = next_node(node_idx);
+        if (next < m_nodes.size()) {
+          prefetch = std::async(std::launch::async, [this, next,
+                                                     &tensor_slots]() {
+            restore_spilled_inputs(next, tensor_slots);
+          });
+        }
+      }
+      if (executed[node_idx]) {
+        // Executed with an earlier node of its group
+      } else if (model_parallel) {
+        if (m_node_stage_segments[node_idx] != no_segment) {
+          execute_stage_segment(
+              m_stage_segments[m_node_stage_segments[node_idx]],
+              tensor_slots);
+        }
+        if (!m_remote_nodes[node_idx]) {
+          execute_node(node_idx, tensor_slots);
+        }
+      } else if (!m_node_slots[node_idx].tiled_chain.empty()) {
+        const auto& chain = m_node_slots[node_idx].tiled_chain;
+        execute_tiled_chain(chain, tensor_slots);
+        for (size_t chained : chain) {
+          executed[chained] = 1;
+        }
+      } else if (!key.empty()) {
+        std::vector<size_t> group{node_idx};
+        for (size_t later = node_idx + 1; later < m_nodes.size(); ++later) {
+          if (m_node_slots[later].coalesce_key == key && !executed[later] &&
+              inputs_computed(later)) {
+            group.emplace_back(later);
+            executed[later] = 1;
+          }
+        }
+        if (m_spill != nullptr) {
+          if (prefetch.valid()) {
+            prefetch.get();
+          }
+          for (size_t member : group) {
+            restore_spilled_inputs(member, tensor_slots);
+          }
+        }
+        execute_client_group(group, tensor_slots);
+      } else {
+        execute_node(node_idx, tensor_slots);
+      }
+
+      // delete any obsolete tensors
+      for (size_t slot : m_node_slots[node_idx].free) {
+        if (m_spill != nullptr) {
+          m_spill->discard(slot);
+        }
+        release_slot_bytes(slot);
+        tensor_slots[slot] = nullptr;
+      }
+      // Spilled while no restore runs, so no tensor is in both
+      if (m_spill != nullptr) {
+        if (prefetch.valid()) {
+          prefetch.get();
+        }
+        spill_cold_tensors(next_node(node_idx), tensor_slots);
+      }
+    }
+    if (m_spill != nullptr) {
+      NGRAPH_HE_LOG(3) << "Spilled "
+                       << m_spill->total_spilled_bytes() - spilled_bytes_start
+                       << " ciphertext bytes";
+      m_spill->clear();
+    }
+  }
+  size_t total_time = 0;
+  for (const auto& elem : m_timer_map) {
+    total_time += elem.second.get_milliseconds();
+  }
+  if (verbose_op("total")) {
+    NGRAPH_HE_LOG(3) << "\033[1;32m"
+                     << "Total time " << total_time << " (ms) \033[0m";
+  }
+
+  for (auto& stage_client : m_stage_clients) {
+    stage_client->end_call();
+  }
+
+  // Send outputs to client.
+  if (enable_client()) {
+    if (record_metrics()) {
+      record_phase_time("compute", phase_start);
+      phase_start = std::chrono::steady_clock::now();
+    }
+    wait_for_client_results();
+    if (record_metrics()) {
+      record_phase_time("client_results", phase_start);
+      record_call_metrics(call_start);
+    }
+    bool persistent_session;
+    bool session_ended;
+    {
+      std::lock_guard<std::mutex> guard(m_client_inputs_mutex);
+      persistent_session = m_persistent_session;
+      session_ended = m_session_ended;
+    }
+    // With a single client, later calls keep serving the same session. A
+    // persistent session serves later calls until the client ends it
+    if (persistent_session && !session_ended) {
+      reset_call_state();
+    } else if (persistent_session || m_he_seal_backend.max_clients() > 1 ||
+               m_hosted_in_registry) {
+      end_session();
+    }
+  }
+  return true;
+}
+
+void HESealExecutable::execute_node(
+    size_t node_idx, std::vector<std::shared_ptr<HETensor>>& tensor_slots) {
+  const auto& op = m_nodes[node_idx];
+  const NodeSlots& node_slots = m_node_slots[node_idx];
+  NGRAPH_CHECK(op->is_op(), "Not is not an op");
+  bool verbose = verbose_op(op.get());
+
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "\033[1;32m"
+                     << "[ " << op->get_name() << " ]"
+                     << "\033[0m";
+    if (op->is_constant()) {
+      NGRAPH_HE_LOG(3) << "Constant shape " << op->get_shape();
+    }
+  }
+
+  if (op->is_parameter()) {
+    if (verbose) {
+      const auto param_op = std::static_pointer_cast<const op::Parameter>(op);
+      if (HEOpAnnotations::has_he_annotation(*param_op)) {
+        std::string from_client_str =
+            HEOpAnnotations::from_client(*param_op) ? "" : " not";
+        NGRAPH_HE_LOG(3) << "Parameter shape " << param_op->get_shape()
+                         << from_client_str << " from client";
+      }
+    }
+    HEOpStats param_stats;
+    update_live_ciphertext_bytes(op, node_slots, tensor_slots, param_stats);
+    if (noise_telemetry() && tensor_slots[node_slots.outputs[0]] != nullptr) {
+      sample_noise(op, {tensor_slots[node_slots.outputs[0]]});
+    }
+    return;
+  }
+  logging::TraceSpan trace_span("op", op->get_name());
+  trace_span.add_arg("op", op->description());
+  node_slots.timer->start();
+  HEPrimitiveCounts primitives_start = HEPrimitiveCounter::counts();
+  // Client nodes run one at a time, so their traffic is not shared
+  bool count_traffic = node_slots.client && m_session != nullptr;
+  size_t bytes_sent_start = count_traffic ? m_session->bytes_written() : 0;
+  size_t bytes_received_start = count_traffic ? m_session->bytes_read() : 0;
+  size_t client_wait_start = s_client_wait_us;
+  HESealBackend::PoolStatistics pools_start =
+      m_he_seal_backend.pool_statistics();
+
+  // get op inputs from map
+  std::vector<std::shared_ptr<HETensor>> op_inputs;
+  op_inputs.reserve(node_slots.inputs.size());
+  for (size_t slot : node_slots.inputs) {
+    NGRAPH_CHECK(tensor_slots[slot] != nullptr, "Input tensor for ",
+                 op->get_name(), " not computed");
+    op_inputs.push_back(tensor_slots[slot]);
+  }
+
+  if (enable_client() && m_he_seal_backend.stream_client_inputs()) {
+    // Dot computes on the loaded prefix of its first argument, while other
+    // ops require fully loaded inputs
+    bool is_dot = node_slots.type_id == OP_TYPEID::Dot;
+    for (size_t arg_idx = is_dot ? 1 : 0; arg_idx < op_inputs.size();
+         ++arg_idx) {
+      wait_for_client_input(*op_inputs[arg_idx],
+                            op_inputs[arg_idx]->get_batched_element_count());
+    }
+  }
 
-      auto current_annotation = HEOpAnnotations::he_op_annotation(*param);
-      current_annotation->set_encrypted(he_input->any_encrypted_data());
-    } else {
-      NGRAPH_HE_LOG(1) << "Processing parameter " << param->get_name()
-                       << "(shape {" << param_shape << "}) from server";
+  if (enable_client() && op->is_output()) {
+    // Client outputs don't have decryption performed, so skip result op
+    send_client_result(m_result_indices.at(op.get()), op_inputs[0]);
+  }
 
-      he_input = std::static_pointer_cast<HETensor>(server_inputs[input_idx]);
-      auto current_annotation = HEOpAnnotations::he_op_annotation(*param);
+  // get op outputs from map or create
+  std::vector<std::shared_ptr<HETensor>> op_outputs;
+  for (size_t i = 0; i < op->get_output_size(); ++i) {
+    auto& out_slot = tensor_slots[node_slots.outputs[i]];
+    if (out_slot == nullptr) {
+      // The output tensor is not an external tensor, so reuse its buffer
+      out_slot = acquire_output_tensor(node_slots.output_layouts[i],
+                                       node_slots.output_buffers[i],
+                                       op->output(i).get_tensor().get_name());
+    }
+    op_outputs.push_back(out_slot);
+  }
 
-      NGRAPH_HE_LOG(5) << "Parameter " << param->get_name()
-                       << " has annotation " << *current_annotation;
-      if (!he_input->any_encrypted_data()) {
-        if (current_annotation->packed()) {
-          he_input->pack();
-        } else {
-          he_input->unpack();
+  if (!node_slots.mod_switch_inputs.empty()) {
+    mod_switch_inputs(node_slots, op_inputs);
+  }
+  if (!forward_input(*op, node_slots, op_outputs, op_inputs)) {
+    if (auto input_idx = in_place_input(*op, node_slots, op_outputs, op_inputs);
+        input_idx.has_value()) {
+      // The output takes the input data and the kernel overwrites it
+      auto& data = op_outputs[0]->data();
+      data.swap(op_inputs[*input_idx]->data());
+      // Ciphertexts copied by layout kernels may be shared with live tensors
+#pragma omp parallel for
+      // NOLINTNEXTLINE
+      for (size_t i = 0; i < data.size(); ++i) {
+        auto& cipher = data[i].get_ciphertext();
+        if (data[i].is_ciphertext() && cipher.use_count() > 1) {
+          data[i].replace_ciphertext(
+              std::make_shared<SealCiphertextWrapper>(*cipher));
         }
       }
+      op_inputs[*input_idx] = op_outputs[0];
+    }
+    generate_calls(node_slots.type_id, node_slots.base_type, *op, op_outputs,
+                   op_inputs);
+  }
+  if (m_he_seal_backend.huge_pages()) {
+    // The hints apply to pool memory reused by later ops, and khugepaged
+    // collapses memory faulted before the hint
+    for (const auto& output : op_outputs) {
+      output->advise_huge_pages();
+    }
+  }
+  node_slots.timer->stop();
+  if (record_metrics()) {
+    record_op_time(op);
+  }
 
-      if (current_annotation->encrypted()) {
-        NGRAPH_HE_LOG(3) << "Encrypting parameter " << param->get_name()
-                         << " from server";
-#pragma omp parallel for
-        for (size_t he_type_idx = 0;
-             he_type_idx < he_input->get_batched_element_count();
-             ++he_type_idx) {
-          if (he_input->data(he_type_idx).is_plaintext()) {
-            auto cipher = HESealBackend::create_empty_ciphertext();
-            m_he_seal_backend.encrypt(
-                cipher, he_input->data(he_type_idx).get_plaintext(),
-                he_input->get_element_type(),
-                he_input->data(he_type_idx).complex_packing());
-            he_input->data(he_type_idx).set_ciphertext(cipher);
-          }
+  HEOpStats stats;
+  HEPrimitiveCounts primitives_end = HEPrimitiveCounter::counts();
+  for (size_t i = 0; i < s_num_he_primitives; ++i) {
+    stats.primitives[i] = primitives_end[i] - primitives_start[i];
+  }
+  for (const auto& output : op_outputs) {
+    for (const auto& he_type : output->data()) {
+      stats.ciphertexts += he_type.is_ciphertext() ? 1 : 0;
+    }
+    stats.ciphertext_bytes += output->ciphertext_byte_count();
+  }
+  if (count_traffic) {
+    stats.bytes_sent = m_session->bytes_written() - bytes_sent_start;
+    stats.bytes_received = m_session->bytes_read() - bytes_received_start;
+  }
+  stats.client_wait_us = s_client_wait_us - client_wait_start;
+  HESealBackend::PoolStatistics pools_end = m_he_seal_backend.pool_statistics();
+  stats.pool_bytes = pools_end.global_bytes + pools_end.thread_local_bytes -
+                     pools_start.global_bytes - pools_start.thread_local_bytes;
+  update_live_ciphertext_bytes(op, node_slots, tensor_slots, stats);
+  *node_slots.stats += stats;
+
+  if (noise_telemetry()) {
+    sample_noise(op, op_outputs);
+  }
+
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "\033[1;31m" << op->get_name() << " took "
+                     << node_slots.timer->get_milliseconds() << "ms"
+                     << "\033[0m";
+  }
+}
+
+void HESealExecutable::execute_client_group(
+    const std::vector<size_t>& group,
+    std::vector<std::shared_ptr<HETensor>>& tensor_slots) {
+  NGRAPH_CHECK(!group.empty(), "Client group is empty");
+  if (group.size() == 1) {
+    execute_node(group[0], tensor_slots);
+    return;
+  }
+  const auto& leader = m_nodes[group[0]];
+  if (verbose_op(leader.get())) {
+    NGRAPH_HE_LOG(3) << "\033[1;32m"
+                     << "[ " << leader->get_name() << " with "
+                     << group.size() - 1 << " coalesced nodes ]"
+                     << "\033[0m";
+  }
+  logging::TraceSpan trace_span("op", leader->get_name());
+  trace_span.add_arg("op", leader->description());
+  trace_span.add_arg("coalesced", std::to_string(group.size()));
+  stopwatch& leader_timer = *m_node_slots[group[0]].timer;
+  leader_timer.start();
+  HEPrimitiveCounts primitives_start = HEPrimitiveCounter::counts();
+  bool count_traffic = m_session != nullptr;
+  size_t bytes_sent_start = count_traffic ? m_session->bytes_written() : 0;
+  size_t bytes_received_start = count_traffic ? m_session->bytes_read() : 0;
+  size_t client_wait_start = s_client_wait_us;
+
+  // The input values of the nodes are streamed as one ReLU
+  std::vector<std::shared_ptr<HETensor>> args;
+  std::vector<std::shared_ptr<HETensor>> outs;
+  std::vector<HEType> data;
+  for (size_t node_idx : group) {
+    const auto& op = m_nodes[node_idx];
+    const NodeSlots& node_slots = m_node_slots[node_idx];
+    std::vector<std::shared_ptr<HETensor>> op_inputs{
+        tensor_slots[node_slots.inputs[0]]};
+    NGRAPH_CHECK(op_inputs[0] != nullptr, "Input tensor for ", op->get_name(),
+                 " not computed");
+    if (enable_client() && m_he_seal_backend.stream_client_inputs()) {
+      wait_for_client_input(*op_inputs[0],
+                            op_inputs[0]->get_batched_element_count());
+    }
+    if (!node_slots.mod_switch_inputs.empty()) {
+      mod_switch_inputs(node_slots, op_inputs);
+    }
+    auto& out_slot = tensor_slots[node_slots.outputs[0]];
+    if (out_slot == nullptr) {
+      out_slot = acquire_output_tensor(node_slots.output_layouts[0],
+                                       node_slots.output_buffers[0],
+                                       op->output(0).get_tensor().get_name());
+    }
+    const auto& arg_data = op_inputs[0]->data();
+    data.insert(data.end(), arg_data.begin(), arg_data.end());
+    args.emplace_back(op_inputs[0]);
+    outs.emplace_back(out_slot);
+  }
+
+  auto stream = begin_relu_stream(data, args[0]->get_element_type(),
+                                  args[0]->is_packed(), *leader);
+  stream_relu_values(stream, data.size());
+  std::vector<HEType> results;
+  finish_relu_stream(stream, results);
+  size_t offset = 0;
+  for (size_t i = 0; i < group.size(); ++i) {
+    size_t count = args[i]->data().size();
+    auto& out_data = outs[i]->data();
+    auto begin = std::make_move_iterator(results.begin() + offset);
+    out_data.assign(begin, begin + count);
+    offset += count;
+  }
+  leader_timer.stop();
+  if (record_metrics()) {
+    record_op_time(leader);
+  }
+
+  HEPrimitiveCounts primitives_end = HEPrimitiveCounter::counts();
+  for (size_t i = 0; i < group.size(); ++i) {
+    const auto& op = m_nodes[group[i]];
+    HEOpStats stats;
+    if (i == 0) {
+      for (size_t j = 0; j < s_num_he_primitives; ++j) {
+        stats.primitives[j] = primitives_end[j] - primitives_start[j];
+      }
+      if (count_traffic) {
+        stats.bytes_sent = m_session->bytes_written() - bytes_sent_start;
+        stats.bytes_received = m_session->bytes_read() - bytes_received_start;
+      }
+      stats.client_wait_us = s_client_wait_us - client_wait_start;
+    }
+    for (const auto& he_type : outs[i]->data()) {
+      stats.ciphertexts += he_type.is_ciphertext() ? 1 : 0;
+    }
+    stats.ciphertext_bytes += outs[i]->ciphertext_byte_count();
+    update_live_ciphertext_bytes(op, m_node_slots[group[i]], tensor_slots,
+                                 stats);
+    *m_node_slots[group[i]].stats += stats;
+    if (noise_telemetry()) {
+      sample_noise(op, {outs[i]});
+    }
+  }
+
+  if (verbose_op(leader.get())) {
+    NGRAPH_HE_LOG(3) << "\033[1;31m" << leader->get_name() << " took "
+                     << leader_timer.get_milliseconds() << "ms"
+                     << "\033[0m";
+  }
+}
+
+void HESealExecutable::plan_tiled_chains() {
+  for (auto& node_slots : m_node_slots) {
+    node_slots.tiled_chain.clear();
+  }
+  // Lazily reduced outputs are only reduced after the whole node
+  if (m_he_seal_backend.conv_tile_rows() == 0 ||
+      m_he_seal_backend.lazy_mod()) {
+    return;
+  }
+  constexpr size_t no_node = std::numeric_limits<size_t>::max();
+  std::vector<size_t> slot_producers(m_num_tensor_slots, no_node);
+  std::vector<std::pair<size_t, size_t>> slot_readers(m_num_tensor_slots,
+                                                      {no_node, 0});
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    const NodeSlots& node_slots = m_node_slots[node_idx];
+    for (size_t slot : node_slots.outputs) {
+      slot_producers[slot] = node_idx;
+    }
+    for (size_t i = 0; i < node_slots.inputs.size(); ++i) {
+      slot_readers[node_slots.inputs[i]] = {node_idx, i};
+    }
+  }
+  auto tileable = [this](size_t node_idx) {
+    const Node& node = *m_nodes[node_idx];
+    const NodeSlots& node_slots = m_node_slots[node_idx];
+    return (node_slots.type_id == OP_TYPEID::Convolution ||
+            node_slots.type_id == OP_TYPEID::GroupConvolution) &&
+           !node_slots.client && node_slots.mod_switch_inputs.empty() &&
+           m_slot_packed_convolutions.find(&node) ==
+               m_slot_packed_convolutions.end() &&
+           node.get_output_shape(0).size() >= 3;
+  };
+
+  std::vector<char> chained(m_nodes.size(), 0);
+  size_t num_chains = 0;
+  for (size_t first = 0; first < m_nodes.size(); ++first) {
+    if (chained[first] || !tileable(first)) {
+      continue;
+    }
+    std::vector<size_t> chain{first};
+    while (true) {
+      const NodeSlots& last = m_node_slots[chain.back()];
+      size_t out_slot = last.outputs[0];
+      if (!m_intermediate_slots[out_slot] ||
+          m_slot_reader_counts[out_slot] != 1) {
+        break;
+      }
+      auto [next, input_idx] = slot_readers[out_slot];
+      if (input_idx != 0 || !tileable(next)) {
+        break;
+      }
+      // The whole chain executes at its first node
+      size_t filters_producer = slot_producers[m_node_slots[next].inputs[1]];
+      if (filters_producer != no_node && filters_producer >= first) {
+        break;
+      }
+      chain.emplace_back(next);
+    }
+    if (chain.size() < 2) {
+      continue;
+    }
+    for (size_t node_idx : chain) {
+      chained[node_idx] = 1;
+    }
+    NGRAPH_HE_LOG(3) << "Tiling " << chain.size()
+                     << " convolutions starting at "
+                     << m_nodes[first]->get_name();
+    m_node_slots[first].tiled_chain = std::move(chain);
+    ++num_chains;
+  }
+  NGRAPH_HE_LOG(3) << "Execution plan tiles " << num_chains
+                   << " convolution chains";
+}
+
+void HESealExecutable::execute_tiled_chain(
+    const std::vector<size_t>& chain,
+    std::vector<std::shared_ptr<HETensor>>& tensor_slots) {
+  const auto& leader = m_nodes[chain[0]];
+  bool verbose = verbose_op(leader.get());
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "\033[1;32m"
+                     << "[ " << leader->get_name() << " with "
+                     << chain.size() - 1 << " tiled convolutions ]"
+                     << "\033[0m";
+  }
+  logging::TraceSpan trace_span("op", leader->get_name());
+  trace_span.add_arg("op", leader->description());
+  trace_span.add_arg("tiled", std::to_string(chain.size()));
+  stopwatch& leader_timer = *m_node_slots[chain[0]].timer;
+  leader_timer.start();
+  HEPrimitiveCounts primitives_start = HEPrimitiveCounter::counts();
+
+  struct Stage {
+    std::shared_ptr<HETensor> arg;
+    std::shared_ptr<HETensor> filters;
+    std::shared_ptr<HETensor> out;
+    std::shared_ptr<const ConvolutionIndexTable> table;
+    std::shared_ptr<const WeightedSums> sums;
+    std::vector<char> computed;
+    std::vector<char> needed;
+    // Last tile reading each output of an intermediate stage
+    std::vector<size_t> last_tile;
+  };
+  std::vector<Stage> stages(chain.size());
+  bool stream_inputs =
+      enable_client() && m_he_seal_backend.stream_client_inputs();
+  for (size_t i = 0; i < chain.size(); ++i) {
+    const Node& node = *m_nodes[chain[i]];
+    const NodeSlots& node_slots = m_node_slots[chain[i]];
+    Stage& stage = stages[i];
+    stage.arg = i == 0 ? tensor_slots[node_slots.inputs[0]] : stages[i - 1].out;
+    stage.filters = tensor_slots[node_slots.inputs[1]];
+    NGRAPH_CHECK(stage.arg != nullptr && stage.filters != nullptr,
+                 "Input tensor for ", node.get_name(), " not computed");
+    if (stream_inputs) {
+      if (i == 0) {
+        wait_for_client_input(*stage.arg,
+                              stage.arg->get_batched_element_count());
+      }
+      wait_for_client_input(*stage.filters,
+                            stage.filters->get_batched_element_count());
+    }
+    // The planned buffers may still hold tensors of nodes ordered between
+    // the nodes of the chain
+    auto& out_slot = tensor_slots[node_slots.outputs[0]];
+    if (out_slot == nullptr) {
+      out_slot = acquire_output_tensor(node_slots.output_layouts[0], no_buffer,
+                                       node.output(0).get_tensor().get_name());
+    }
+    stage.out = out_slot;
+    stage.table = convolution_index_table(node, stage.arg->get_packed_shape(),
+                                          stage.filters->get_packed_shape(),
+                                          stage.out->get_packed_shape());
+    stage.sums = weighted_sums(node, *stage.filters, stage.table);
+    stage.computed.assign(stage.out->data().size(), 0);
+  }
+
+  // Tiles are rows of the first spatial axis of the last output
+  const Shape& last_shape = stages.back().out->get_packed_shape();
+  size_t num_rows = last_shape[2];
+  size_t row_size = shape_size(Shape(last_shape.begin() + 3, last_shape.end()));
+  size_t tile_rows = m_he_seal_backend.conv_tile_rows();
+  size_t num_tiles = ceil_div(num_rows, tile_rows);
+  auto mark_needed = [&](size_t tile) {
+    Stage& last = stages.back();
+    last.needed.assign(last.out->data().size(), 0);
+    for (size_t idx = 0; idx < last.needed.size(); ++idx) {
+      last.needed[idx] = (idx / row_size) % num_rows / tile_rows == tile;
+    }
+    for (size_t i = stages.size() - 1; i-- > 0;) {
+      const ConvolutionIndexTable& table = *stages[i + 1].table;
+      stages[i].needed.assign(stages[i].out->data().size(), 0);
+      for (size_t idx = 0; idx < stages[i + 1].needed.size(); ++idx) {
+        if (!stages[i + 1].needed[idx]) {
+          continue;
+        }
+        for (size_t pair = table.offsets[idx]; pair < table.offsets[idx + 1];
+             ++pair) {
+          stages[i].needed[table.input_indices[pair]] = 1;
         }
-        NGRAPH_HE_LOG(3) << "Done encrypting parameter " << param->get_name()
-                         << " from server";
       }
     }
-    NGRAPH_CHECK(he_input != nullptr, "HE input is nullptr");
-    NGRAPH_CHECK(
-        he_input->is_packed() ==
-            HEOpAnnotations::he_op_annotation(*param)->packed(),
-        "Mismatch between tensor input and annotation (", he_input->is_packed(),
-        " != ", HEOpAnnotations::he_op_annotation(*param)->packed(), ")");
-    if (he_input->is_packed()) {
-      set_batch_size(he_input->get_batch_size());
+  };
+  for (size_t tile = 0; tile < num_tiles; ++tile) {
+    mark_needed(tile);
+    for (size_t i = 0; i + 1 < stages.size(); ++i) {
+      stages[i].last_tile.resize(stages[i].needed.size(), 0);
+      for (size_t idx = 0; idx < stages[i].needed.size(); ++idx) {
+        if (stages[i].needed[idx]) {
+          stages[i].last_tile[idx] = tile;
+        }
+      }
     }
-    he_inputs.emplace_back(he_input);
   }
 
-  NGRAPH_HE_LOG(3) << "Updating HE op annotations";
-  update_he_op_annotations();
+  auto compute_range = [&](size_t i, size_t begin, size_t end) {
+    const Node& node = *m_nodes[chain[i]];
+    Stage& stage = stages[i];
+    auto& out_data = stage.out->data();
+    if (stage.sums != nullptr) {
+      convolution_seal_range(stage.arg->data(), stage.filters->data(),
+                             out_data, *stage.sums, batch_size(),
+                             m_he_seal_backend, begin, end);
+    } else {
+      convolution_seal_range(stage.arg->data(), stage.filters->data(),
+                             out_data, *stage.table,
+                             m_node_slots[chain[i]].base_type, batch_size(),
+                             m_he_seal_backend, begin, end, false);
+    }
+    if (stage.sums == nullptr || stage.sums->quantization_step == 0) {
+      std::vector<HEType> range(
+          std::make_move_iterator(out_data.begin() + begin),
+          std::make_move_iterator(out_data.begin() + end));
+      rescale_output(node, range, false);
+      std::move(range.begin(), range.end(), out_data.begin() + begin);
+    }
+  };
+  for (size_t tile = 0; tile < num_tiles; ++tile) {
+    mark_needed(tile);
+    for (size_t i = 0; i < stages.size(); ++i) {
+      Stage& stage = stages[i];
+      size_t size = stage.needed.size();
+      size_t begin = 0;
+      while (begin < size) {
+        if (!stage.needed[begin] || stage.computed[begin]) {
+          ++begin;
+          continue;
+        }
+        size_t end = begin;
+        while (end < size && stage.needed[end] && !stage.computed[end]) {
+          stage.computed[end++] = 1;
+        }
+        compute_range(i, begin, end);
+        begin = end;
+      }
+    }
+    for (size_t i = 0; i + 1 < stages.size(); ++i) {
+      auto& out_data = stages[i].out->data();
+      for (size_t idx = 0; idx < out_data.size(); ++idx) {
+        if (stages[i].last_tile[idx] == tile && out_data[idx].is_ciphertext()) {
+          out_data[idx].set_ciphertext(
+              HESealBackend::create_empty_ciphertext());
+        }
+      }
+    }
+  }
+  leader_timer.stop();
+  if (record_metrics()) {
+    record_op_time(leader);
+  }
 
-  NGRAPH_HE_LOG(3) << "Converting outputs to HETensor";
-  std::vector<std::shared_ptr<HETensor>> he_outputs;
-  he_outputs.reserve(outputs.size());
-  for (auto& tensor : outputs) {
-    he_outputs.push_back(std::static_pointer_cast<HETensor>(tensor));
+  HEPrimitiveCounts primitives_end = HEPrimitiveCounter::counts();
+  for (size_t i = 0; i < chain.size(); ++i) {
+    const auto& op = m_nodes[chain[i]];
+    HEOpStats stats;
+    if (i == 0) {
+      for (size_t j = 0; j < s_num_he_primitives; ++j) {
+        stats.primitives[j] = primitives_end[j] - primitives_start[j];
+      }
+    }
+    for (const auto& he_type : stages[i].out->data()) {
+      stats.ciphertexts += he_type.is_ciphertext() ? 1 : 0;
+    }
+    stats.ciphertext_bytes += stages[i].out->ciphertext_byte_count();
+    update_live_ciphertext_bytes(op, m_node_slots[chain[i]], tensor_slots,
+                                 stats);
+    *m_node_slots[chain[i]].stats += stats;
+  }
+  if (noise_telemetry()) {
+    sample_noise(m_nodes[chain.back()], {stages.back().out});
+  }
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "\033[1;31m" << leader->get_name() << " took "
+                     << leader_timer.get_milliseconds() << "ms"
+                     << "\033[0m";
   }
+}
 
-  NGRAPH_HE_LOG(3) << "Mapping function parameters to HETensor";
-  NGRAPH_CHECK(he_inputs.size() >= parameters.size(),
-               "Not enough inputs in input map");
-  std::unordered_map<descriptor::Tensor*, std::shared_ptr<HETensor>> tensor_map;
-  size_t input_count = 0;
-  for (const auto& param : parameters) {
-    for (size_t param_out_idx = 0; param_out_idx < param->get_output_size();
-         ++param_out_idx) {
-      descriptor::Tensor* tensor =
-          param->get_output_tensor_ptr(param_out_idx).get();
-      tensor_map.insert({tensor, he_inputs[input_count++]});
+bool HESealExecutable::forward_input(
+    const Node& op, const NodeSlots& node_slots,
+    const std::vector<std::shared_ptr<HETensor>>& out,
+    const std::vector<std::shared_ptr<HETensor>>& args) {
+  if (args.empty() || out.size() != 1 || !node_slots.sole_reader[0]) {
+    return false;
+  }
+
+  // Only ops whose output data is their input data, in the same order
+  bool identity = false;
+  switch (node_slots.type_id) {
+    case OP_TYPEID::Broadcast:
+    case OP_TYPEID::Slice:
+      identity = op.get_input_shape(0) == op.get_output_shape(0);
+      break;
+    case OP_TYPEID::Concat:
+      identity = args.size() == 1;
+      break;
+    case OP_TYPEID::Reshape: {
+      const auto& input_order =
+          static_cast<const op::Reshape&>(op).get_input_order();
+      identity = std::is_sorted(input_order.begin(), input_order.end());
+      break;
+    }
+    case OP_TYPEID::Result:
+      // m_client_outputs refers to the input tensor
+      identity = !enable_client();
+      break;
+    case OP_TYPEID::Reverse:
+      identity =
+          static_cast<const op::Reverse&>(op).get_reversed_axes().empty();
+      break;
+    default:
+      break;
+  }
+  if (!identity || args[0]->data().size() != out[0]->data().size()) {
+    return false;
+  }
+
+  // No other node reads the input, so the output takes its data. The input
+  // buffer keeps the previous output data, so it remains reusable
+  out[0]->data().swap(args[0]->data());
+  return true;
+}
+
+void HESealExecutable::mod_switch_inputs(
+    const NodeSlots& node_slots,
+    std::vector<std::shared_ptr<HETensor>>& args) const {
+  // The deepest ciphertext has the smallest chain index
+  std::shared_ptr<SealCiphertextWrapper> target;
+  size_t target_chain_index = std::numeric_limits<size_t>::max();
+  for (const auto& arg : args) {
+    for (const auto& he_type : arg->data()) {
+      if (he_type.is_ciphertext()) {
+        size_t chain_index =
+            m_he_seal_backend.get_chain_index(*he_type.get_ciphertext());
+        if (chain_index < target_chain_index) {
+          target_chain_index = chain_index;
+          target = he_type.get_ciphertext();
+        }
+      }
     }
   }
+  if (target == nullptr) {
+    return;
+  }
+  const seal::parms_id_type parms_id = target->ciphertext().parms_id();
+
+  for (size_t input_idx : node_slots.mod_switch_inputs) {
+    auto& arg = args[input_idx];
+    if (!node_slots.sole_reader[input_idx]) {
+      auto switched_arg = std::static_pointer_cast<HETensor>(
+          m_he_seal_backend.create_cipher_tensor(
+              arg->get_element_type(), arg->get_shape(), arg->is_packed(),
+              arg->get_name()));
+      switched_arg->data() = arg->data();
+      arg = switched_arg;
+    }
 
-  NGRAPH_HE_LOG(3) << "Mapping function outputs to HETensor";
-  for (size_t output_count = 0; output_count < get_results().size();
-       ++output_count) {
-    std::shared_ptr<op::Result> output = get_results()[output_count];
-    ngraph::descriptor::Tensor* tv = output->get_output_tensor_ptr(0).get();
+    std::vector<std::shared_ptr<SealCiphertextWrapper>> ciphers;
+    std::unordered_map<const SealCiphertextWrapper*, size_t> cipher_indices;
+    for (const auto& he_type : arg->data()) {
+      if (he_type.is_ciphertext() &&
+          m_he_seal_backend.get_chain_index(*he_type.get_ciphertext()) >
+              target_chain_index) {
+        if (cipher_indices.emplace(he_type.get_ciphertext().get(),
+                                   ciphers.size())
+                .second) {
+          ciphers.emplace_back(he_type.get_ciphertext());
+        }
+      }
+    }
+    NGRAPH_HE_LOG(5) << "Mod-switching " << ciphers.size()
+                     << " ciphertexts to chain index " << target_chain_index;
 
-    auto& he_output = he_outputs[output_count];
+    // Switched ciphertexts are new, since the originals may be shared with
+    // other tensors
+    std::vector<std::shared_ptr<SealCiphertextWrapper>> switched(
+        ciphers.size());
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t i = 0; i < ciphers.size(); ++i) {
+      switched[i] = HESealBackend::create_empty_ciphertext();
+      m_he_seal_backend.get_evaluator()->mod_switch_to(
+          ciphers[i]->ciphertext(), parms_id, switched[i]->ciphertext(),
+          m_he_seal_backend.pool());
+      if (within_rescale_tolerance(*switched[i], *target)) {
+        match_scale(*switched[i], *target);
+      }
+    }
 
-    if (HEOpAnnotations::has_he_annotation(*output)) {
-      auto he_op_annotation = HEOpAnnotations::he_op_annotation(*output);
-      if (!he_output->any_encrypted_data()) {
-        if (he_op_annotation->packed()) {
-          he_output->pack();
+    auto& data = arg->data();
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t i = 0; i < data.size(); ++i) {
+      if (data[i].is_ciphertext()) {
+        auto it = cipher_indices.find(data[i].get_ciphertext().get());
+        if (it != cipher_indices.end()) {
+          data[i].replace_ciphertext(switched[it->second]);
+        }
+      }
+    }
+  }
+}
+
+std::optional<size_t> HESealExecutable::in_place_input(
+    const Node& op, const NodeSlots& node_slots,
+    const std::vector<std::shared_ptr<HETensor>>& out,
+    const std::vector<std::shared_ptr<HETensor>>& args) const {
+  if (out.size() != 1) {
+    return std::nullopt;
+  }
+  switch (node_slots.type_id) {
+    case OP_TYPEID::Add:
+    case OP_TYPEID::Multiply:
+    case OP_TYPEID::Negative:
+      break;
+    case OP_TYPEID::Relu:
+      // With the client, the output is received from the client
+      if (enable_client()) {
+        return std::nullopt;
+      }
+      break;
+    default:
+      return std::nullopt;
+  }
+  for (size_t i = 0; i < args.size(); ++i) {
+    if (node_slots.sole_reader[i] &&
+        op.get_input_shape(i) == op.get_output_shape(0) &&
+        args[i]->is_packed() == out[0]->is_packed() &&
+        args[i]->data().size() == out[0]->data().size()) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+void HESealExecutable::execute_nodes_concurrently(
+    std::vector<std::shared_ptr<HETensor>>& tensor_slots, size_t num_threads) {
+  NGRAPH_HE_LOG(3) << "Executing " << m_nodes.size() << " nodes on "
+                   << num_threads << " threads";
+  const size_t num_nodes = m_nodes.size();
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<size_t> ready_nodes;
+  std::vector<size_t> remaining_dependencies(num_nodes);
+  std::vector<size_t> remaining_readers = m_slot_reader_counts;
+  size_t completed_count = 0;
+  std::exception_ptr error;
+  // Client ops are issued first, so their round-trips overlap as much
+  // server computation as possible. Under the memory node order, ready nodes
+  // are issued in that order instead
+  bool memory_order = m_he_seal_backend.memory_node_order();
+  auto push_ready = [&](size_t node_idx) {
+    if (memory_order) {
+      ready_nodes.insert(std::lower_bound(ready_nodes.begin(),
+                                          ready_nodes.end(), node_idx),
+                         node_idx);
+    } else if (m_node_slots[node_idx].client) {
+      ready_nodes.emplace_front(node_idx);
+    } else {
+      ready_nodes.emplace_back(node_idx);
+    }
+  };
+  for (size_t node_idx = 0; node_idx < num_nodes; ++node_idx) {
+    remaining_dependencies[node_idx] = m_node_slots[node_idx].num_dependencies;
+    if (remaining_dependencies[node_idx] == 0) {
+      push_ready(node_idx);
+    }
+  }
+
+  // Exclusive nodes toggle the backend lazy_mod flag, so they run alone
+  std::shared_mutex exclusive_mutex;
+  // Client nodes share the client message buffers, e.g. m_relu_data, so they
+  // run one at a time. While one waits on the client, other nodes proceed
+  std::mutex client_mutex;
+
+#ifdef _OPENMP
+  // Share the intra-op thread budget between the inter-op threads
+  size_t max_threads = std::min(static_cast<size_t>(omp_get_max_threads()),
+                                HEThreadBudget::compute_threads());
+  int intra_op_threads =
+      static_cast<int>(std::max<size_t>(1, max_threads / num_threads));
+#endif
+
+  auto worker = [&]() {
+#ifdef _OPENMP
+    omp_set_num_threads(intra_op_threads);
+#endif
+    while (true) {
+      // A worker which waited on the client resumes alongside the worker
+      // which took its place, so one of them parks
+      if (!HEWorkerPool::current()->park_if_oversubscribed()) {
+        return;
+      }
+      size_t node_idx;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait(lock, [&]() {
+          return !ready_nodes.empty() || completed_count == num_nodes ||
+                 error != nullptr;
+        });
+        if (completed_count == num_nodes || error != nullptr) {
+          return;
+        }
+        node_idx = ready_nodes.front();
+        ready_nodes.pop_front();
+      }
+
+      // Ready client nodes of the same coalesce key, including those which
+      // became ready while waiting for the client, share one request stream
+      std::vector<size_t> group{node_idx};
+      try {
+        const NodeSlots& node_slots = m_node_slots[node_idx];
+        if (!node_slots.coalesce_key.empty()) {
+          std::lock_guard<std::mutex> client_lock(client_mutex);
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto it = ready_nodes.begin(); it != ready_nodes.end();) {
+              if (m_node_slots[*it].coalesce_key == node_slots.coalesce_key) {
+                group.emplace_back(*it);
+                it = ready_nodes.erase(it);
+              } else {
+                ++it;
+              }
+            }
+          }
+          execute_client_group(group, tensor_slots);
+        } else if (node_slots.client) {
+          std::lock_guard<std::mutex> lock(client_mutex);
+          execute_node(node_idx, tensor_slots);
+        } else if (node_slots.exclusive) {
+          std::unique_lock<std::shared_mutex> lock(exclusive_mutex);
+          execute_node(node_idx, tensor_slots);
         } else {
-          he_output->unpack();
+          std::shared_lock<std::shared_mutex> lock(exclusive_mutex);
+          execute_node(node_idx, tensor_slots);
         }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        cond.notify_all();
+        return;
+      }
+
+      // Intermediate tensors are freed once their last reader completes
+      std::vector<size_t> free_slots;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t done_idx : group) {
+          const NodeSlots& node_slots = m_node_slots[done_idx];
+          for (size_t slot : node_slots.inputs) {
+            if (--remaining_readers[slot] == 0 && m_intermediate_slots[slot]) {
+              free_slots.emplace_back(slot);
+            }
+          }
+          for (size_t slot : node_slots.outputs) {
+            if (remaining_readers[slot] == 0 && m_intermediate_slots[slot]) {
+              free_slots.emplace_back(slot);
+            }
+          }
+        }
+      }
+      for (size_t slot : free_slots) {
+        release_slot_bytes(slot);
+        tensor_slots[slot] = nullptr;
       }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t done_idx : group) {
+        for (size_t dependent : m_node_slots[done_idx].dependents) {
+          if (--remaining_dependencies[dependent] == 0) {
+            push_ready(dependent);
+          }
+        }
+      }
+      completed_count += group.size();
+      cond.notify_all();
+    }
+  };
+
+  // Workers waiting on the client are replaced, so num_threads workers keep
+  // computing during client round-trips
+  HEWorkerPool pool(num_threads, worker);
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&]() {
+      return completed_count == num_nodes || error != nullptr;
+    });
+  }
+  pool.stop();
+  pool.join();
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  NGRAPH_CHECK(completed_count == num_nodes, "Only ", completed_count, " of ",
+               num_nodes, " nodes executed");
+}
+
+void HESealExecutable::send_client_result(
+    size_t result_idx, const std::shared_ptr<HETensor>& arg) {
+  NGRAPH_HE_LOG(3) << "Sending result " << result_idx << " to client";
+  // Pending factors, e.g. the folded scales of a BatchNorm, are model
+  // weights, so they are multiplied in rather than sent
+  const std::shared_ptr<HETensor> tensor =
+      with_pending_factors_applied({arg})[0];
+  std::lock_guard<std::mutex> guard(m_client_outputs_mutex);
+  NGRAPH_CHECK(result_idx < m_client_outputs.size(), "Invalid result index ",
+               result_idx);
+  m_client_outputs[result_idx] = tensor;
+
+  // The sent ciphertexts may be switched to a lower modulus, so they are
+  // written from a shallow copy of the tensor
+  auto sent = tensor;
+  if (m_he_seal_backend.client_mod_switch()) {
+    sent = std::make_shared<HETensor>(
+        tensor->get_element_type(), tensor->get_shape(), tensor->is_packed(),
+        m_he_seal_backend.complex_packing(), false, m_he_seal_backend,
+        tensor->get_name());
+    sent->data() = tensor->data();
+  }
+
+  json js = {{"function", "Result"},
+             {"index", result_idx},
+             {"count", m_client_outputs.size()}};
+  // Small results, e.g. logits, share ciphertexts. The client splits the
+  // slots of the packed ciphertexts sent as an unpacked 1D tensor
+  size_t compaction = m_he_seal_backend.result_compaction()
+                          ? client_compaction(tensor->data())
+                          : 1;
+  if (compaction > 1) {
+    std::vector<HEType> packed_data = tensor->data();
+    size_t value_batch_size = packed_data[0].batch_size();
+    compact_client_ciphers(packed_data, compaction);
+    sent = std::make_shared<HETensor>(
+        tensor->get_element_type(), Shape{packed_data.size()}, false,
+        m_he_seal_backend.complex_packing(), false, m_he_seal_backend,
+        tensor->get_name());
+    sent->data() = std::move(packed_data);
+    js["compaction"] = compaction;
+    js["batch_size"] = value_batch_size;
+    js["element_count"] = tensor->get_batched_element_count();
+    const Shape& shape = tensor->get_shape();
+    js["shape"] = std::vector<size_t>(shape.begin(), shape.end());
+    NGRAPH_HE_LOG(3) << "Compacted result " << result_idx << " into "
+                     << sent->data().size() << " ciphertexts";
+  }
+  mod_switch_client_ciphers(sent->data());
+  // Each frame is serialized once at most s_max_pending_result_frames earlier
+  // frames remain to be written, bounding the memory of the serialized result
+  sent->write_to_pb_tensor_frames(
+      s_result_frame_bytes,
+      [&](pb::HETensor&& pb_tensor, TCPMessage::Segments&& segments) {
+        pb::TCPMessage result_msg;
+        result_msg.set_type(pb::TCPMessage_Type_RESPONSE);
+        result_msg.mutable_function()->set_function(js.dump());
+        *result_msg.add_he_tensors() = std::move(pb_tensor);
+
+        auto result_shape = result_msg.he_tensors(0).shape();
+        NGRAPH_HE_LOG(3) << "Server sending result with shape "
+                         << Shape{result_shape.begin(), result_shape.end()}
+                         << " at offset " << result_msg.he_tensors(0).offset();
+        m_session->write_message(
+            TCPMessage(std::move(result_msg), std::move(segments)));
+        HEWorkerPool::BlockingScope blocking_scope;
+        m_session->wait_until_written(s_max_pending_result_frames);
+      },
+      m_compr_mode);
+}
+
+void HESealExecutable::wait_for_client_results() {
+  {
+    std::lock_guard<std::mutex> guard(m_client_outputs_mutex);
+    for (size_t result_idx = 0; result_idx < m_client_outputs.size();
+         ++result_idx) {
+      NGRAPH_CHECK(m_client_outputs[result_idx] != nullptr, "Result ",
+                   result_idx, " was not sent to the client");
+    }
+  }
+  // Wait until message is written
+  m_session->wait_until_written();
+}
+
+bool HESealExecutable::elementwise_node(size_t node_idx) const {
+  static const std::unordered_set<OP_TYPEID> s_elementwise_ops{
+      OP_TYPEID::Add,      OP_TYPEID::BoundedRelu, OP_TYPEID::Divide,
+      OP_TYPEID::Exp,      OP_TYPEID::Minimum,     OP_TYPEID::Multiply,
+      OP_TYPEID::Negate,   OP_TYPEID::Power,       OP_TYPEID::Relu,
+      OP_TYPEID::Subtract};
+  const auto& node = m_nodes[node_idx];
+  if (s_elementwise_ops.find(get_typeid(node->get_type_info())) ==
+          s_elementwise_ops.end() ||
+      node->get_output_size() != 1) {
+    return false;
+  }
+  const auto& layout = m_node_slots[node_idx].output_layouts[0];
+  for (const auto& input : node->inputs()) {
+    if (input.get_shape() != layout.shape) {
+      return false;
     }
-    tensor_map.insert({tv, he_output});
   }
+  return true;
+}
 
-  // for each ordered op in the graph
-  for (auto op : m_nodes) {
-    NGRAPH_CHECK(op->is_op(), "Not is not an op");
-    bool verbose = verbose_op(op.get());
-
-    if (verbose) {
-      NGRAPH_HE_LOG(3) << "\033[1;32m"
-                       << "[ " << op->get_name() << " ]"
-                       << "\033[0m";
-      if (op->is_constant()) {
-        NGRAPH_HE_LOG(3) << "Constant shape " << op->get_shape();
-      }
+void HESealExecutable::plan_model_parallel_stages() {
+  const auto& stage_workers = m_he_seal_backend.model_parallel_stages();
+  const auto& shard_workers = m_he_seal_backend.data_parallel_workers();
+  bool sharded = !shard_workers.empty();
+  const auto& workers = sharded ? shard_workers : stage_workers;
+  NGRAPH_CHECK(enable_client(), "Model-parallel stages require the client");
+  if (m_stage_clients.empty()) {
+    for (const auto& [hostname, port] : workers) {
+      m_stage_clients.emplace_back(
+          std::make_unique<HESealStageClient>(hostname, port,
+                                              m_he_seal_backend));
     }
+  }
 
-    if (op->is_parameter()) {
-      if (verbose) {
-        const auto param_op = std::static_pointer_cast<const op::Parameter>(op);
-        if (HEOpAnnotations::has_he_annotation(*param_op)) {
-          std::string from_client_str =
-              HEOpAnnotations::from_client(*param_op) ? "" : " not";
-          NGRAPH_HE_LOG(3) << "Parameter shape " << param_op->get_shape()
-                           << from_client_str << " from client";
-        }
+  // Parameters, Results and client nodes are executed by the coordinator,
+  // and Constants by each stage reading them
+  auto remote_candidate = [this](size_t node_idx) {
+    const auto& node = m_nodes[node_idx];
+    return !node->is_parameter() && !node->is_output() &&
+           !node->is_constant() && !m_node_slots[node_idx].client;
+  };
+  // Data-parallel workers execute the elementwise nodes as stage 1
+  std::vector<size_t> stages(m_nodes.size(), 0);
+  if (sharded) {
+    for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+      stages[node_idx] = elementwise_node(node_idx) ? 1 : 0;
+    }
+  } else {
+    HECostReport report = estimate_cost();
+    std::vector<double> costs(m_nodes.size(), 0);
+    for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+      if (remote_candidate(node_idx)) {
+        costs[node_idx] = report.nodes[node_idx].latency_us;
       }
-      continue;
     }
-    m_timer_map[op].start();
+    stages = partition_stages(costs, workers.size() + 1);
+  }
 
-    // get op inputs from map
-    std::vector<std::shared_ptr<HETensor>> op_inputs;
-    for (auto input : op->inputs()) {
-      descriptor::Tensor* tensor = &input.get_tensor();
-      op_inputs.push_back(tensor_map.at(tensor));
+  std::vector<size_t> slot_producers(m_num_tensor_slots, no_segment);
+  std::vector<std::vector<size_t>> slot_readers(m_num_tensor_slots);
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    for (size_t slot : m_node_slots[node_idx].outputs) {
+      slot_producers[slot] = node_idx;
     }
-
-    if (enable_client() && op->is_output()) {
-      // Client outputs don't have decryption performed, so skip result op
-      NGRAPH_HE_LOG(3) << "Setting client outputs";
-      m_client_outputs = op_inputs;
+    for (size_t slot : m_node_slots[node_idx].inputs) {
+      slot_readers[slot].emplace_back(node_idx);
     }
+  }
 
-    // get op outputs from map or create
-    std::vector<std::shared_ptr<HETensor>> op_outputs;
-    for (size_t i = 0; i < op->get_output_size(); ++i) {
-      auto tensor = &op->output(i).get_tensor();
-      auto it = tensor_map.find(tensor);
-      if (it == tensor_map.end()) {
-        // The output tensor is not in the tensor map so create a new tensor
-        Shape shape = op->get_output_shape(i);
-        const element::Type& element_type = op->get_output_element_type(i);
-        std::string name = op->output(i).get_tensor().get_name();
-
-        NGRAPH_HE_LOG(3) << "Get output packing / encrypted";
-
-        std::shared_ptr<HEOpAnnotations> he_op_annotation =
-            HEOpAnnotations::he_op_annotation(*static_cast<op::Op*>(op.get()));
-        bool encrypted_out = he_op_annotation->encrypted();
-        bool packed_out = he_op_annotation->packed();
-
-        NGRAPH_HE_LOG(3) << "encrypted_out " << encrypted_out;
-        NGRAPH_HE_LOG(3) << "packed_out " << packed_out;
-        if (packed_out) {
-          shape = HETensor::unpack_shape(shape, batch_size());
-        }
-        NGRAPH_HE_LOG(5) << "Creating output tensor with shape " << shape;
-
-        if (encrypted_out) {
-          auto out_tensor = std::static_pointer_cast<HETensor>(
-              m_he_seal_backend.create_cipher_tensor(element_type, shape,
-                                                     packed_out, name));
-          tensor_map.insert({tensor, out_tensor});
-        } else {
-          auto out_tensor = std::static_pointer_cast<HETensor>(
-              m_he_seal_backend.create_plain_tensor(element_type, shape,
-                                                    packed_out, name));
-          tensor_map.insert({tensor, out_tensor});
-        }
+  // Segments are maximal runs of nodes of one stage, interrupted only by
+  // Constants, so each segment depends on nodes before it
+  m_stage_segments.clear();
+  m_node_stage_segments.assign(m_nodes.size(), no_segment);
+  m_remote_nodes.assign(m_nodes.size(), 0);
+  size_t segment_idx = no_segment;
+  for (size_t node_idx = 0; node_idx < m_nodes.size(); ++node_idx) {
+    if (!remote_candidate(node_idx) || stages[node_idx] == 0) {
+      if (!m_nodes[node_idx]->is_constant()) {
+        segment_idx = no_segment;
       }
-      op_outputs.push_back(tensor_map.at(tensor));
+      continue;
     }
-
-    // get op type
-    element::Type base_type;
-    if (op->get_inputs().empty()) {
-      base_type = op->get_element_type();
-    } else {
-      base_type = op->get_inputs().at(0).get_tensor().get_element_type();
+    // Sharded segments split all their tensors at the same element indices
+    auto same_layout = [&]() {
+      const auto& first_layout =
+          m_node_slots[m_stage_segments[segment_idx].nodes[0]]
+              .output_layouts[0];
+      const auto& layout = m_node_slots[node_idx].output_layouts[0];
+      return first_layout.shape == layout.shape &&
+             first_layout.packed == layout.packed;
+    };
+    if (segment_idx == no_segment ||
+        m_stage_segments[segment_idx].stage != stages[node_idx] ||
+        (sharded && !same_layout())) {
+      segment_idx = m_stage_segments.size();
+      m_stage_segments.emplace_back();
+      m_stage_segments.back().stage = stages[node_idx];
+      m_stage_segments.back().sharded = sharded;
+      m_node_stage_segments[node_idx] = segment_idx;
     }
+    m_stage_segments[segment_idx].nodes.emplace_back(node_idx);
+    m_remote_nodes[node_idx] = 1;
+  }
 
-    generate_calls(base_type, *op.get(), op_outputs, op_inputs);
-    m_timer_map[op].stop();
-
-    // delete any obsolete tensors
-    for (const descriptor::Tensor* t : op->liveness_free_list) {
-      bool erased = false;
-      for (auto it = tensor_map.begin(); it != tensor_map.end(); ++it) {
-        const std::string& it_name = it->second->get_name();
-        if (it_name == t->get_name()) {
-          tensor_map.erase(it);
-          erased = true;
-          break;
+  for (auto& segment : m_stage_segments) {
+    std::set<size_t> nodes{segment.nodes.begin(), segment.nodes.end()};
+    for (size_t node_idx : segment.nodes) {
+      for (size_t slot : m_node_slots[node_idx].inputs) {
+        size_t producer = slot_producers[slot];
+        if (producer != no_segment && m_nodes[producer]->is_constant()) {
+          nodes.insert(producer);
         }
       }
-      if (!erased) {
-        NGRAPH_HE_LOG(5) << "Failed to erase " << t->get_name()
-                         << " from tensor map";
+    }
+    std::set<size_t> input_slots;
+    std::set<size_t> output_slots;
+    for (size_t node_idx : nodes) {
+      for (size_t slot : m_node_slots[node_idx].inputs) {
+        if (nodes.find(slot_producers[slot]) == nodes.end()) {
+          input_slots.insert(slot);
+        }
       }
     }
-    if (verbose) {
-      NGRAPH_HE_LOG(3) << "\033[1;31m" << op->get_name() << " took "
-                       << m_timer_map[op].get_milliseconds() << "ms"
-                       << "\033[0m";
+    for (size_t node_idx : segment.nodes) {
+      for (size_t slot : m_node_slots[node_idx].outputs) {
+        for (size_t reader : slot_readers[slot]) {
+          if (nodes.find(reader) == nodes.end()) {
+            output_slots.insert(slot);
+            break;
+          }
+        }
+      }
     }
+    segment.nodes.assign(nodes.begin(), nodes.end());
+    segment.input_slots.assign(input_slots.begin(), input_slots.end());
+    segment.output_slots.assign(output_slots.begin(), output_slots.end());
   }
-  size_t total_time = 0;
-  for (const auto& elem : m_timer_map) {
-    total_time += elem.second.get_milliseconds();
+  NGRAPH_HE_LOG(3) << "Split nodes into " << m_stage_segments.size()
+                   << " segments over " << workers.size() << " workers";
+}
+
+void HESealExecutable::execute_stage_segment(
+    const StageSegment& segment,
+    std::vector<std::shared_ptr<HETensor>>& tensor_slots) {
+  logging::TraceSpan trace_span("stage", std::to_string(segment.stage));
+  if (m_he_seal_backend.stream_client_inputs()) {
+    for (size_t slot : segment.input_slots) {
+      wait_for_client_input(*tensor_slots[slot],
+                            tensor_slots[slot]->get_batched_element_count());
+    }
   }
-  if (verbose_op("total")) {
-    NGRAPH_HE_LOG(3) << "\033[1;32m"
-                     << "Total time " << total_time << " (ms) \033[0m";
+  if (!segment.sharded || segment.input_slots.empty()) {
+    auto outputs = m_stage_clients[segment.stage - 1]->execute(
+        segment, tensor_slots, m_batch_size);
+    for (auto& [slot, tensor] : outputs) {
+      tensor_slots[slot] = std::move(tensor);
+    }
+    return;
   }
 
-  // Send outputs to client.
-  if (enable_client()) {
-    send_client_results();
+  // Each worker computes a contiguous range of the elements
+  size_t num_elements =
+      tensor_slots[segment.input_slots[0]]->get_batched_element_count();
+  size_t num_shards = std::min(m_stage_clients.size(), num_elements);
+  std::vector<std::pair<size_t, size_t>> ranges;
+  std::vector<
+      std::future<std::unordered_map<size_t, std::shared_ptr<HETensor>>>>
+      shard_outputs;
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    ranges.emplace_back(num_elements * shard / num_shards,
+                        num_elements * (shard + 1) / num_shards);
+    shard_outputs.emplace_back(std::async(
+        std::launch::async, [this, &segment, &tensor_slots, shard, &ranges]() {
+          return m_stage_clients[shard]->execute(segment, tensor_slots,
+                                                 m_batch_size, ranges[shard]);
+        }));
+  }
+  auto outputs = shard_outputs[0].get();
+  for (size_t shard = 1; shard < num_shards; ++shard) {
+    auto shard_output = shard_outputs[shard].get();
+    for (auto& [slot, tensor] : shard_output) {
+      for (size_t idx = ranges[shard].first; idx < ranges[shard].second;
+           ++idx) {
+        outputs[slot]->data(idx) = tensor->data(idx);
+      }
+    }
+  }
+  for (auto& [slot, tensor] : outputs) {
+    tensor_slots[slot] = std::move(tensor);
   }
-  return true;
 }
 
-void HESealExecutable::send_client_results() {
-  NGRAPH_HE_LOG(3) << "Sending results to client";
-  NGRAPH_CHECK(m_client_outputs.size() == 1,
-               "HESealExecutable only supports output size 1 (got ",
-               get_results().size(), "");
+void HESealExecutable::serve_stages() {
+  NGRAPH_CHECK(enable_client(), "Stage workers require enable_client");
+  NGRAPH_CHECK(!m_dry_run, "Cannot serve a function compiled for a dry run");
+  ScopedIntraOpThreads intra_op_threads(m_num_intra_op_threads);
+  if (!m_server_setup) {
+    NGRAPH_HE_LOG(1) << "Starting stage worker";
+    start_server();
+    m_server_setup = true;
+  }
+  if (m_session == nullptr) {
+    start_next_session();
+  }
+  update_he_op_annotations();
 
-  auto pb_tensors = m_client_outputs[0]->write_to_pb_tensors();
+  while (true) {
+    std::string request;
+    {
+      std::unique_lock<std::mutex> lock(m_stage_mutex);
+      m_stage_cond.wait(lock, [this]() { return !m_stage_requests.empty(); });
+      request = std::move(m_stage_requests.front());
+      m_stage_requests.pop_front();
+    }
+    json js = json::parse(request);
+    if (js.at("function") == "StageEnd") {
+      NGRAPH_HE_LOG(3) << "Coordinator call finished";
+      break;
+    }
+    std::vector<size_t> nodes = js.at("nodes");
+    std::vector<size_t> outputs = js.at("outputs");
+    set_batch_size(js.at("batch_size").get<size_t>());
+
+    std::vector<std::shared_ptr<HETensor>> tensor_slots;
+    {
+      std::lock_guard<std::mutex> guard(m_stage_mutex);
+      tensor_slots.swap(m_stage_slots);
+    }
+    tensor_slots.resize(m_num_tensor_slots);
+    {
+      std::lock_guard<std::mutex> guard(m_memory_mutex);
+      m_slot_ciphertext_bytes.assign(m_num_tensor_slots, 0);
+      m_live_ciphertext_bytes = 0;
+    }
 
-  for (const auto& pb_tensor : pb_tensors) {
-    pb::TCPMessage result_msg;
-    result_msg.set_type(pb::TCPMessage_Type_RESPONSE);
-    *result_msg.add_he_tensors() = pb_tensor;
+    NGRAPH_HE_LOG(3) << "Executing " << nodes.size() << " stage nodes";
+    std::unordered_set<size_t> output_slots{outputs.begin(), outputs.end()};
+    for (size_t node_idx : nodes) {
+      NGRAPH_CHECK(node_idx < m_nodes.size(), "Invalid stage node ", node_idx);
+      execute_node(node_idx, tensor_slots);
+      for (size_t slot : m_node_slots[node_idx].free) {
+        if (output_slots.find(slot) == output_slots.end()) {
+          release_slot_bytes(slot);
+          tensor_slots[slot] = nullptr;
+        }
+      }
+    }
 
-    auto result_shape = result_msg.he_tensors(0).shape();
-    NGRAPH_HE_LOG(3) << "Server sending result with shape "
-                     << Shape{result_shape.begin(), result_shape.end()};
-    m_session->write_message(TCPMessage(std::move(result_msg)));
+    for (size_t slot : outputs) {
+      NGRAPH_CHECK(slot < tensor_slots.size() && tensor_slots[slot] != nullptr,
+                   "Stage output slot ", slot, " not computed");
+      auto write_tensor = [this, slot](pb::HETensor&& pb_tensor,
+                                       TCPMessage::Segments&& segments) {
+        pb::TCPMessage pb_message;
+        pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+        json tensor_js = {{"function", "StageTensor"}, {"slot", slot}};
+        pb_message.mutable_function()->set_function(tensor_js.dump());
+        *pb_message.add_he_tensors() = std::move(pb_tensor);
+        m_session->write_message(
+            TCPMessage(std::move(pb_message), std::move(segments)));
+        m_session->wait_until_written(s_max_pending_result_frames);
+      };
+      // A data-parallel worker returns only its range of the elements
+      if (js.contains("begin")) {
+        size_t num_elements = tensor_slots[slot]->get_batched_element_count();
+        size_t end = std::min<size_t>(js.at("end"), num_elements);
+        size_t begin = std::min<size_t>(js.at("begin"), end);
+        std::vector<TCPMessage::Segments> tensor_segments;
+        auto pb_tensors = tensor_slots[slot]->write_elements_to_pb_tensors(
+            begin, end, &tensor_segments, m_he_seal_backend.compr_mode());
+        for (size_t i = 0; i < pb_tensors.size(); ++i) {
+          write_tensor(std::move(pb_tensors[i]),
+                       std::move(tensor_segments[i]));
+        }
+      } else {
+        tensor_slots[slot]->write_to_pb_tensor_frames(
+            s_result_frame_bytes, write_tensor, m_he_seal_backend.compr_mode());
+      }
+    }
+    pb::TCPMessage pb_message;
+    pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+    json done_js = {{"function", "Stage"}};
+    pb_message.mutable_function()->set_function(done_js.dump());
+    m_session->write_message(TCPMessage(std::move(pb_message)));
+    m_session->wait_until_written();
   }
-
-  // Wait until message is written
-  std::unique_lock<std::mutex> mlock(m_result_mutex);
-  std::condition_variable& writing_cond = m_session->is_writing_cond();
-  writing_cond.wait(mlock, [this] { return !m_session->is_writing(); });
 }
 
 void HESealExecutable::generate_calls(
-    const element::Type& type, const Node& node,
+    OP_TYPEID type_id, const element::Type& type, const Node& node,
     const std::vector<std::shared_ptr<HETensor>>& out,
-    const std::vector<std::shared_ptr<HETensor>>& args) {
+    const std::vector<std::shared_ptr<HETensor>>& node_args) {
   bool verbose = verbose_op(&node);
 
+  // Nodes which ignore pending factors compute on the scaled values, and
+  // write outputs without pending factors
+  bool lazy_factors = m_he_seal_backend.lazy_scalar_factors();
+  bool reads_factors =
+      lazy_factors && reads_pending_factors(type_id, node_args);
+  std::vector<std::shared_ptr<HETensor>> args = node_args;
+  if (lazy_factors && !reads_factors) {
+    args = with_pending_factors_applied(node_args);
+    for (const auto& tensor : out) {
+      for (auto& he_type : tensor->data()) {
+        he_type.pending_factor() = 1;
+      }
+    }
+  }
+
 // We want to check that every OP_TYPEID enumeration is included in the
 // list. These clang flags enable compile-time checking so that if an
 //      enumeration
@@ -933,7 +4856,7 @@ void HESealExecutable::generate_calls(
 #pragma clang diagnostic push
 #pragma clang diagnostic error "-Wswitch"
 #pragma clang diagnostic error "-Wswitch-enum"
-  switch (get_typeid(node.get_type_info())) {
+  switch (type_id) {
     case OP_TYPEID::Add: {
       // Avoid lazy mod for single add op
       if (m_he_seal_backend.lazy_mod()) {
@@ -961,12 +4884,35 @@ void HESealExecutable::generate_calls(
           avg_pool->get_window_shape(), avg_pool->get_window_movement_strides(),
           avg_pool->get_padding_below(), avg_pool->get_padding_above(),
           avg_pool->get_include_padding_in_avg_computation(),
+          out[0]->get_batch_size(), m_he_seal_backend, lazy_factors);
+
+      if (m_he_seal_backend.lazy_mod()) {
+        mod_reduce_seal(out[0]->data(), m_he_seal_backend, verbose);
+      }
+      // Deferred divisions leave nothing to rescale
+      if (!lazy_factors) {
+        rescale_output(node, out[0]->data(), verbose);
+      }
+      break;
+    }
+    case OP_TYPEID::SumPool: {
+      const auto sum_pool = static_cast<const op::SumPool*>(&node);
+      Shape op_in_shape = args[0]->get_packed_shape();
+      Shape op_out_shape = out[0]->get_packed_shape();
+
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "SumPool " << op_in_shape << " => " << op_out_shape;
+      }
+
+      sum_pool_seal(
+          args[0]->data(), out[0]->data(), op_in_shape, op_out_shape,
+          sum_pool->get_window_shape(), sum_pool->get_window_movement_strides(),
+          sum_pool->get_padding_below(), sum_pool->get_padding_above(),
           out[0]->get_batch_size(), m_he_seal_backend);
 
       if (m_he_seal_backend.lazy_mod()) {
         mod_reduce_seal(out[0]->data(), m_he_seal_backend, verbose);
       }
-      rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
       break;
     }
     case OP_TYPEID::BatchNormInference: {
@@ -984,14 +4930,19 @@ void HESealExecutable::generate_calls(
       batch_norm_inference_seal(eps, gamma->data(), beta->data(), input->data(),
                                 mean->data(), variance->data(), out[0]->data(),
                                 args[2]->get_packed_shape(), batch_size(),
-                                m_he_seal_backend);
+                                m_he_seal_backend, lazy_factors);
       break;
     }
     case OP_TYPEID::BoundedRelu: {
       const auto bounded_relu = static_cast<const op::BoundedRelu*>(&node);
       float alpha = bounded_relu->get_alpha();
       size_t output_size = args[0]->get_batched_element_count();
-      if (enable_client()) {
+      auto activation = m_he_seal_backend.polynomial_activation(node);
+      if (activation != PolynomialActivation::none) {
+        polynomial_bounded_relu_seal(
+            args[0]->data(), out[0]->data(), alpha, output_size, activation,
+            m_he_seal_backend.polynomial_activation_bound(), m_he_seal_backend);
+      } else if (enable_client()) {
         handle_server_relu_op(args[0], out[0], node);
       } else {
         NGRAPH_WARN << "Performing BoundedRelu without client is not "
@@ -1014,9 +4965,9 @@ void HESealExecutable::generate_calls(
     case OP_TYPEID::Concat: {
       const auto* concat = static_cast<const op::Concat*>(&node);
       std::vector<Shape> in_shapes;
-      std::vector<std::vector<HEType>> in_args;
+      std::vector<const std::vector<HEType>*> in_args;
       for (auto& arg : args) {
-        in_args.push_back(arg->data());
+        in_args.push_back(&arg->data());
         in_shapes.push_back(arg->get_packed_shape());
       }
       concat_seal(in_args, out[0]->data(), in_shapes,
@@ -1024,73 +4975,101 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::Constant: {
+      auto encrypted = m_encrypted_constants.find(&node);
+      if (encrypted != m_encrypted_constants.end()) {
+        // Kernels may switch the modulus of their arguments in place, so
+        // each call uses copies of the encrypted weights
+        const std::vector<HEType>& ciphers = encrypted->second;
+        std::vector<HEType>& out_data = out[0]->data();
+#pragma omp parallel for
+        for (size_t i = 0; i < ciphers.size(); ++i) {
+          out_data[i].set_ciphertext(std::make_shared<SealCiphertextWrapper>(
+              *ciphers[i].get_ciphertext()));
+          out_data[i].complex_packing() = ciphers[i].complex_packing();
+        }
+        break;
+      }
+      auto materialized = m_plaintext_constants.find(&node);
+      if (materialized != m_plaintext_constants.end()) {
+        // Kernels may overwrite their arguments in place, so each call
+        // copies the plaintexts, whose single values are stored inline
+        const std::vector<HEPlaintext>& plaintexts = materialized->second;
+        std::vector<HEType>& out_data = out[0]->data();
+        NGRAPH_CHECK(out_data.size() == plaintexts.size(),
+                     "out.size() != count for constant op");
+        parallel_for_seal(plaintexts.size(), s_min_parallel_work,
+                          [&](size_t i) {
+                            out_data[i].set_plaintext(plaintexts[i]);
+                          });
+        break;
+      }
       const auto* constant = static_cast<const op::Constant*>(&node);
       constant_seal(out[0]->data(), type, constant->get_data_ptr(),
                     m_he_seal_backend, out[0]->get_batched_element_count());
       break;
     }
-    case OP_TYPEID::Convolution: {
-      const auto* c = static_cast<const op::Convolution*>(&node);
-      const auto& window_movement_strides = c->get_window_movement_strides();
-      const auto& window_dilation_strides = c->get_window_dilation_strides();
-      const auto& padding_below = c->get_padding_below();
-      const auto& padding_above = c->get_padding_above();
-      const auto& data_dilation_strides = c->get_data_dilation_strides();
-
-      Shape in_shape0 = args[0]->get_packed_shape();
-      Shape in_shape1 = args[1]->get_packed_shape();
-
+    case OP_TYPEID::Convolution:
+    case OP_TYPEID::GroupConvolution: {
       if (verbose) {
-        NGRAPH_HE_LOG(3) << in_shape0 << " Conv " << in_shape1 << " => "
+        NGRAPH_HE_LOG(3) << args[0]->get_packed_shape() << " Conv "
+                         << args[1]->get_packed_shape() << " => "
                          << out[0]->get_packed_shape();
       }
-      convolution_seal(args[0]->data(), args[1]->data(), out[0]->data(),
-                       in_shape0, in_shape1, out[0]->get_packed_shape(),
-                       window_movement_strides, window_dilation_strides,
-                       padding_below, padding_above, data_dilation_strides, 0,
-                       1, 1, 0, 0, 1, type, batch_size(), m_he_seal_backend,
-                       verbose);
-
-      if (m_he_seal_backend.lazy_mod()) {
-        mod_reduce_seal(out[0]->data(), m_he_seal_backend, verbose);
-      }
-      rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
-
+      ConvolutionKernelArgs kernel_args{node, args, out[0], type, verbose};
+      const auto& kernel = m_convolution_kernels.select(
+          kernel_args, m_he_seal_backend.node_kernel(node));
+      NGRAPH_HE_LOG(3) << "Computing " << node.get_name() << " by the "
+                       << kernel.name << " kernel";
+      kernel.run(kernel_args);
+      break;
+    }
+    case OP_TYPEID::ConvolutionBiasRelu: {
+      handle_server_conv_bias_relu_op(args, out[0], node);
       break;
     }
     case OP_TYPEID::Divide: {
       Shape in_shape0 = args[0]->get_packed_shape();
       Shape in_shape1 = args[1]->get_packed_shape();
 
+      if (reads_factors) {
+        const auto& divisors = args[1]->data();
+        lazy_scale_seal(args[0]->data(), out[0]->data(),
+                        out[0]->get_batched_element_count(), [&](size_t i) {
+                          return 1 / divisors[i].get_plaintext()[0];
+                        });
+        break;
+      }
       divide_seal(args[0]->data(), args[1]->data(), out[0]->data(),
                   out[0]->get_batched_element_count(), type, m_he_seal_backend);
       break;
     }
     case OP_TYPEID::Dot: {
-      const auto* dot = static_cast<const op::Dot*>(&node);
-
-      Shape in_shape0 = args[0]->get_packed_shape();
-      Shape in_shape1 = args[1]->get_packed_shape();
-
-      if (verbose) {
-        NGRAPH_HE_LOG(3) << in_shape0 << " dot " << in_shape1;
-      }
-      {
-        dot_seal(args[0]->data(), args[1]->data(), out[0]->data(), in_shape0,
-                 in_shape1, out[0]->get_packed_shape(),
-                 dot->get_reduction_axes_count(), type, batch_size(),
-                 m_he_seal_backend);
+#ifdef NGRAPH_HE_ABY_ENABLE
+      if (hybrid_aby_dot(node) && args[0]->all_encrypted_data() &&
+          args[0]->get_packed_shape()[0] == 1) {
+        handle_server_aby_dot_relu_op(args[0], out[0], node);
+        break;
       }
+#endif
 
-      if (m_he_seal_backend.lazy_mod()) {
-        mod_reduce_seal(out[0]->data(), m_he_seal_backend, verbose);
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << args[0]->get_packed_shape() << " dot "
+                         << args[1]->get_packed_shape();
       }
-      rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
-
+      DotKernelArgs kernel_args{node, args, out[0], type, verbose};
+      const auto& kernel = m_dot_kernels.select(
+          kernel_args, m_he_seal_backend.node_kernel(node));
+      NGRAPH_HE_LOG(3) << "Computing " << node.get_name() << " by the "
+                       << kernel.name << " kernel";
+      kernel.run(kernel_args);
       break;
     }
     case OP_TYPEID::Exp: {
-      NGRAPH_CHECK(!enable_client(),
+      if (client_elementwise_op(node)) {
+        handle_server_relu_op(args[0], out[0], node);
+        break;
+      }
+      NGRAPH_CHECK(!enable_client() || polynomial_op_depth(node).has_value(),
                    "Exp not implemented for client-aided model ");
       NGRAPH_WARN
           << " Performing Exp without client is not privacy-preserving ";
@@ -1098,14 +5077,42 @@ void HESealExecutable::generate_calls(
                args[0]->get_batched_element_count(), m_he_seal_backend);
       break;
     }
+    case OP_TYPEID::Abs:
+    case OP_TYPEID::Acos:
+    case OP_TYPEID::Asin:
+    case OP_TYPEID::Atan:
+    case OP_TYPEID::Ceiling:
+    case OP_TYPEID::Cos:
+    case OP_TYPEID::Cosh:
+    case OP_TYPEID::Erf:
+    case OP_TYPEID::Floor:
+    case OP_TYPEID::Log:
+    case OP_TYPEID::Sigmoid:
+    case OP_TYPEID::Sign:
+    case OP_TYPEID::Sin:
+    case OP_TYPEID::Sinh:
+    case OP_TYPEID::Sqrt:
+    case OP_TYPEID::Tan:
+    case OP_TYPEID::Tanh:
+      if (!client_elementwise_op(node)) {
+        throw unsupported_op("Unsupported op '" + node.description() +
+                             "' without client");
+      }
+      handle_server_relu_op(args[0], out[0], node);
+      break;
     case OP_TYPEID::Max: {
       const auto* max = static_cast<const op::Max*>(&node);
       auto reduction_axes = max->get_reduction_axes();
       NGRAPH_CHECK(!args[0]->is_packed() ||
                        (reduction_axes.find(0) == reduction_axes.end()),
                    "Max reduction axes cannot contain 0 for packed tensors");
-      NGRAPH_CHECK(!enable_client(),
-                   "Max not implemented for client-aided model");
+      if (enable_client()) {
+        handle_server_max_op(
+            args[0], out[0], node,
+            max_seal_max_list(args[0]->get_packed_shape(),
+                              out[0]->get_packed_shape(), reduction_axes));
+        break;
+      }
       NGRAPH_WARN << "Performing Max without client is not "
                      "privacy-preserving";
 
@@ -1120,7 +5127,16 @@ void HESealExecutable::generate_calls(
     }
     case OP_TYPEID::MaxPool: {
       const auto* max_pool = static_cast<const op::MaxPool*>(&node);
-      if (enable_client()) {
+      auto activation = m_he_seal_backend.polynomial_activation(node);
+      if (activation != PolynomialActivation::none) {
+        polynomial_max_pool_seal(
+            args[0]->data(), out[0]->data(), args[0]->get_packed_shape(),
+            out[0]->get_packed_shape(), max_pool->get_window_shape(),
+            max_pool->get_window_movement_strides(),
+            max_pool->get_padding_below(), max_pool->get_padding_above(),
+            activation, m_he_seal_backend.polynomial_activation_bound(),
+            m_he_seal_backend);
+      } else if (enable_client()) {
         handle_server_max_pool_op(args[0], out[0], node);
       } else {
         NGRAPH_WARN << "Performing MaxPool without client is not "
@@ -1144,22 +5160,35 @@ void HESealExecutable::generate_calls(
       break;
     }
     case OP_TYPEID::Multiply: {
+      auto multiply = [&]() {
+        if (lazy_factors) {
+          lazy_multiply_seal(args[0]->data(), args[1]->data(), out[0]->data(),
+                             out[0]->get_batched_element_count(), type,
+                             m_he_seal_backend);
+        } else {
+          multiply_seal(args[0]->data(), args[1]->data(), out[0]->data(),
+                        out[0]->get_batched_element_count(), type,
+                        m_he_seal_backend);
+        }
+      };
       // Avoid lazy mod for single multiply op
       if (m_he_seal_backend.lazy_mod()) {
         m_he_seal_backend.lazy_mod() = false;
-        multiply_seal(args[0]->data(), args[1]->data(), out[0]->data(),
-                      out[0]->get_batched_element_count(), type,
-                      m_he_seal_backend);
+        multiply();
         m_he_seal_backend.lazy_mod() = true;
       } else {
-        multiply_seal(args[0]->data(), args[1]->data(), out[0]->data(),
-                      out[0]->get_batched_element_count(), type,
-                      m_he_seal_backend);
+        multiply();
       }
-      rescale_seal(out[0]->data(), m_he_seal_backend, verbose);
+      rescale_output(node, out[0]->data(), verbose);
       break;
     }
     case OP_TYPEID::Negative: {
+      if (lazy_factors) {
+        lazy_scale_seal(args[0]->data(), out[0]->data(),
+                        out[0]->get_batched_element_count(),
+                        [](size_t /*i*/) { return -1.0; });
+        break;
+      }
       negate_seal(args[0]->data(), out[0]->data(),
                   out[0]->get_batched_element_count(), type, m_he_seal_backend);
       break;
@@ -1185,8 +5214,41 @@ void HESealExecutable::generate_calls(
                  out[0]->data().size(), type, m_he_seal_backend);
       break;
     }
-    case OP_TYPEID::Relu: {
+    case OP_TYPEID::Refresh: {
       if (enable_client()) {
+        handle_server_refresh_op(args[0], out[0], node);
+      } else {
+        NGRAPH_WARN << "Performing Refresh without client is not privacy "
+                       "preserving ";
+        refresh_seal(args[0]->data(), out[0]->data(), args[0]->data().size(),
+                     m_he_seal_backend);
+      }
+      break;
+    }
+    case OP_TYPEID::Relu: {
+      auto activation = m_he_seal_backend.polynomial_activation(node);
+      if (activation != PolynomialActivation::none) {
+        polynomial_relu_seal(args[0]->data(), out[0]->data(),
+                             args[0]->get_batched_element_count(), activation,
+                             m_he_seal_backend.polynomial_activation_bound(),
+                             m_he_seal_backend);
+      } else if (enable_client()) {
+        if (client_fused_relu(node)) {
+          // The client request or garbled circuit of the following MaxPool
+          // computes the Relu, which saves a round-trip to the client
+          out[0]->data() = args[0]->data();
+          break;
+        }
+#ifdef NGRAPH_HE_ABY_ENABLE
+        {
+          std::lock_guard<std::mutex> guard(m_aby_computed_relus_mutex);
+          if (m_aby_computed_relus.erase(&node) > 0) {
+            // The Dot producing the argument computed the Relu
+            out[0]->data() = args[0]->data();
+            break;
+          }
+        }
+#endif
         handle_server_relu_op(args[0], out[0], node);
       } else {
         NGRAPH_WARN << "Performing Relu without client is not privacy "
@@ -1283,16 +5345,12 @@ void HESealExecutable::generate_calls(
       break;
     }
     // Unsupported ops
-    case OP_TYPEID::Abs:
-    case OP_TYPEID::Acos:
     case OP_TYPEID::All:
     case OP_TYPEID::AllReduce:
     case OP_TYPEID::And:
     case OP_TYPEID::Any:
     case OP_TYPEID::ArgMax:
     case OP_TYPEID::ArgMin:
-    case OP_TYPEID::Asin:
-    case OP_TYPEID::Atan:
     case OP_TYPEID::Atan2:
     case OP_TYPEID::AvgPoolBackprop:
     case OP_TYPEID::BatchMatMul:
@@ -1301,7 +5359,6 @@ void HESealExecutable::generate_calls(
     case OP_TYPEID::BatchNormTrainingBackprop:
     case OP_TYPEID::BroadcastDistributed:
     case OP_TYPEID::BroadcastLike:
-    case OP_TYPEID::Ceiling:
     case OP_TYPEID::Clamp:
     case OP_TYPEID::Convert:
     case OP_TYPEID::ConvolutionBackpropData:
@@ -1309,8 +5366,6 @@ void HESealExecutable::generate_calls(
     case OP_TYPEID::ConvolutionBias:
     case OP_TYPEID::ConvolutionBiasAdd:
     case OP_TYPEID::ConvolutionBiasBackpropFiltersBias:
-    case OP_TYPEID::Cos:
-    case OP_TYPEID::Cosh:
     case OP_TYPEID::CrossEntropy:
     case OP_TYPEID::CrossEntropyBackprop:
     case OP_TYPEID::CropAndResize:
@@ -1325,16 +5380,13 @@ void HESealExecutable::generate_calls(
     case OP_TYPEID::Elu:
     case OP_TYPEID::EmbeddingLookup:
     case OP_TYPEID::Equal:
-    case OP_TYPEID::Erf:
     case OP_TYPEID::FakeQuantize:
-    case OP_TYPEID::Floor:
     case OP_TYPEID::Gather:
     case OP_TYPEID::GatherND:
     case OP_TYPEID::GenerateMask:
     case OP_TYPEID::GetOutputElement:
     case OP_TYPEID::Gelu:
     case OP_TYPEID::Gemm:
-    case OP_TYPEID::GroupConvolution:
     case OP_TYPEID::GroupConvolutionBackpropData:
     case OP_TYPEID::GroupConvolutionBackpropFilters:
     case OP_TYPEID::GroupConvolutionTranspose:
@@ -1349,7 +5401,6 @@ void HESealExecutable::generate_calls(
     case OP_TYPEID::LayerNormBackprop:
     case OP_TYPEID::Less:
     case OP_TYPEID::LessEq:
-    case OP_TYPEID::Log:
     case OP_TYPEID::LRN:
     case OP_TYPEID::LSTMCell:
     case OP_TYPEID::LSTMSequence:
@@ -1394,22 +5445,15 @@ void HESealExecutable::generate_calls(
     case OP_TYPEID::Select:
     case OP_TYPEID::Selu:
     case OP_TYPEID::ShuffleChannels:
-    case OP_TYPEID::Sigmoid:
     case OP_TYPEID::SigmoidBackprop:
-    case OP_TYPEID::Sign:
-    case OP_TYPEID::Sin:
-    case OP_TYPEID::Sinh:
     case OP_TYPEID::SoftmaxCrossEntropy:
     case OP_TYPEID::SoftmaxCrossEntropyBackprop:
     case OP_TYPEID::SpaceToDepth:
     case OP_TYPEID::Split:
     case OP_TYPEID::SquaredDifference:
     case OP_TYPEID::Squeeze:
-    case OP_TYPEID::Sqrt:
     case OP_TYPEID::Stack:
     case OP_TYPEID::StopGradient:
-    case OP_TYPEID::Tan:
-    case OP_TYPEID::Tanh:
     case OP_TYPEID::TensorIterator:
     case OP_TYPEID::Tile:
     case OP_TYPEID::TopK:
@@ -1419,77 +5463,751 @@ void HESealExecutable::generate_calls(
       throw unsupported_op("Unsupported op '" + node.description() + "'");
 #pragma clang diagnostic pop
   }
-}  // namespace ngraph::runtime::he
+}  // namespace ngraph::runtime::he
+
+void HESealExecutable::relinearize_ciphers(
+    std::vector<HEType>& cipher_batch) const {
+  if (!m_he_seal_backend.lazy_relinearization()) {
+    return;
+  }
+  m_he_seal_backend.accelerator().relinearize(cipher_batch, m_he_seal_backend);
+}
+
+void HESealExecutable::mod_switch_client_ciphers(
+    std::vector<HEType>& cipher_batch) const {
+  relinearize_ciphers(cipher_batch);
+  // Garbled circuits mask ciphertexts at the lowest modulus already
+  if (!m_he_seal_backend.client_mod_switch() || enable_garbled_circuits()) {
+    return;
+  }
+  const auto& context = m_he_seal_backend.get_context();
+
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t cipher_idx = 0; cipher_idx < cipher_batch.size(); ++cipher_idx) {
+    auto& he_type = cipher_batch[cipher_idx];
+    if (!he_type.is_ciphertext()) {
+      continue;
+    }
+    const auto& cipher = he_type.get_ciphertext()->ciphertext();
+    auto parms_id =
+        m_he_seal_backend.lowest_decryptable_parms_id(cipher.scale());
+    if (context->get_context_data(parms_id)->chain_index() >=
+        context->get_context_data(cipher.parms_id())->chain_index()) {
+      continue;
+    }
+    auto switched = HESealBackend::create_empty_ciphertext();
+    m_he_seal_backend.get_evaluator()->mod_switch_to(cipher, parms_id,
+                                                     switched->ciphertext());
+    he_type.replace_ciphertext(switched);
+  }
+}
+
+std::set<int> HESealExecutable::client_compaction_steps() const {
+  bool relu_compaction =
+      m_he_seal_backend.relu_compaction() && !enable_garbled_circuits();
+  if (!(relu_compaction || m_he_seal_backend.result_compaction()) ||
+      complex_packing() || !m_context->using_keyswitching()) {
+    return {};
+  }
+  return compaction_steps(
+      batch_size(), m_he_seal_backend.get_ckks_encoder()->slot_count());
+}
+
+size_t HESealExecutable::client_compaction(
+    const std::vector<HEType>& cipher_batch) const {
+  if (m_client_galois_keys == nullptr || cipher_batch.size() < 2 ||
+      complex_packing()) {
+    return 1;
+  }
+  // The Galois keys rotate by multiples of the batch size
+  const HEType& first = cipher_batch[0];
+  if (!first.is_ciphertext() || first.batch_size() != batch_size()) {
+    return 1;
+  }
+  const seal::Ciphertext& first_cipher = first.get_ciphertext()->ciphertext();
+  for (const auto& he_type : cipher_batch) {
+    if (!he_type.is_ciphertext() || he_type.batch_size() != batch_size()) {
+      return 1;
+    }
+    const auto& cipher = he_type.get_ciphertext()->ciphertext();
+    if (cipher.parms_id() != first_cipher.parms_id() ||
+        cipher.scale() != first_cipher.scale()) {
+      return 1;
+    }
+  }
+  // Packing rescales the ciphertexts
+  const auto& context = m_he_seal_backend.get_context();
+  auto lowest_parms_id =
+      m_he_seal_backend.lowest_decryptable_parms_id(first_cipher.scale());
+  if (context->get_context_data(first_cipher.parms_id())->chain_index() <
+      context->get_context_data(lowest_parms_id)->chain_index() +
+          m_he_seal_backend.rescale_primes()) {
+    return 1;
+  }
+  return std::min(
+      cipher_batch.size(),
+      compaction_capacity(batch_size(),
+                          m_he_seal_backend.get_ckks_encoder()->slot_count()));
+}
+
+void HESealExecutable::compact_client_ciphers(
+    std::vector<HEType>& cipher_batch, size_t compaction) const {
+  relinearize_ciphers(cipher_batch);
+  size_t value_batch_size = cipher_batch[0].batch_size();
+  std::vector<HEType> packed_batch(
+      ceil_div(cipher_batch.size(), compaction),
+      HEType(HEPlaintext(), cipher_batch[0].complex_packing()));
+  // Packed ciphertexts store compaction values each, including the last
+  // one, whose unused slots are zero
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t packed_idx = 0; packed_idx < packed_batch.size(); ++packed_idx) {
+    size_t begin = packed_idx * compaction;
+    size_t end = std::min(begin + compaction, cipher_batch.size());
+    std::vector<const seal::Ciphertext*> ciphers;
+    ciphers.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      ciphers.emplace_back(&cipher_batch[i].get_ciphertext()->ciphertext());
+    }
+    auto packed = HESealBackend::create_empty_ciphertext();
+    compact_slots_seal(ciphers, value_batch_size, packed->ciphertext(),
+                       *m_client_galois_keys, m_he_seal_backend);
+    packed_batch[packed_idx] =
+        HEType(packed, cipher_batch[0].complex_packing(),
+               value_batch_size * compaction);
+  }
+  NGRAPH_HE_LOG(5) << "Compacted " << cipher_batch.size()
+                   << " client ciphertexts into " << packed_batch.size();
+  cipher_batch = std::move(packed_batch);
+}
+
+void HESealExecutable::expand_relu_results() {
+  if (m_packed_relu_results.empty()) {
+    return;
+  }
+#pragma omp parallel for
+  // NOLINTNEXTLINE
+  for (size_t result_idx = 0; result_idx < m_packed_relu_results.size();
+       ++result_idx) {
+    const PackedReluResult& result = m_packed_relu_results[result_idx];
+    std::vector<seal::Ciphertext> values;
+    expand_slots_seal(result.packed.get_ciphertext()->ciphertext(),
+                      result.batch_size, result.num_values, values,
+                      *m_client_galois_keys, m_he_seal_backend);
+    for (size_t i = 0; i < values.size(); ++i) {
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      cipher->ciphertext() = std::move(values[i]);
+      m_relu_data[m_unknown_relu_idx[result.first_unknown_idx + i]] =
+          HEType(cipher, result.packed.complex_packing(), result.batch_size);
+    }
+  }
+  m_packed_relu_results.clear();
+}
+
+void HESealExecutable::handle_server_max_pool_op(
+    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
+    const Node& node) {
+  NGRAPH_HE_LOG(3) << "Server handle_server_max_pool_op";
+
+  const auto* max_pool = static_cast<const op::MaxPool*>(&node);
+
+  Shape unpacked_arg_shape = node.get_input_shape(0);
+  Shape out_shape = HETensor::pack_shape(node.get_output_shape(0));
+
+  // TODO(fboemer): call max_pool_seal directly?
+  std::vector<std::vector<size_t>> maximize_lists = max_pool_seal_max_list(
+      unpacked_arg_shape, out_shape, max_pool->get_window_shape(),
+      max_pool->get_window_movement_strides(), max_pool->get_padding_below(),
+      max_pool->get_padding_above());
+
+  // Relu is idempotent, so the client applies it whenever the Relu may have
+  // been fused, even if the Relu was computed
+  bool relu = client_fused_relu(*node.get_argument(0));
+  handle_server_max_op(arg, out, node, maximize_lists, relu);
+}
+
+void HESealExecutable::handle_server_slot_packed_conv_op(
+    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
+    const Node& node, const std::vector<double>& filter) {
+  bool verbose = verbose_op(&node);
+  const auto* conv = static_cast<const op::Convolution*>(&node);
+  const Shape& arg_shape = arg->get_packed_shape();
+  Shape data_shape(arg_shape.begin() + 1, arg_shape.end());
+  const Shape& filter_shape = node.get_input_shape(1);
+  const Strides& strides = conv->get_window_movement_strides();
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "Packing " << data_shape << " into slots";
+  }
+
+  SealCiphertextWrapper packed;
+  pack_slots_seal(arg->data(), packed, m_he_seal_backend);
+  std::vector<SealCiphertextWrapper> channels;
+  convolution_slot_packed_seal(packed, filter, data_shape, filter_shape,
+                               strides, conv->get_window_dilation_strides(),
+                               channels, m_he_seal_backend);
+
+  // Output channels are rescaled before they are unpacked into many
+  // ciphertexts
+  std::vector<HEType> channel_data;
+  channel_data.reserve(channels.size());
+  for (auto& channel : channels) {
+    channel_data.emplace_back(
+        std::make_shared<SealCiphertextWrapper>(std::move(channel)), false, 1);
+  }
+  rescale_output(node, channel_data, verbose);
+
+  Shape out_shape = slot_packed_convolution_shape(
+      data_shape, filter_shape, strides, conv->get_window_dilation_strides());
+  std::vector<size_t> slots;
+  slots.reserve(shape_size(out_shape));
+  for (size_t row = 0; row < out_shape[0]; ++row) {
+    for (size_t col = 0; col < out_shape[1]; ++col) {
+      slots.emplace_back(
+          slot_packed_convolution_slot(row, col, data_shape, strides));
+    }
+  }
+  std::vector<HEType>& out_data = out->data();
+  NGRAPH_CHECK(out_data.size() == channel_data.size() * slots.size(),
+               "Output size ", out_data.size(), " does not match ",
+               channel_data.size(), " channels of ", slots.size(), " slots");
+  std::vector<HEType> unpacked;
+  for (size_t oc = 0; oc < channel_data.size(); ++oc) {
+    unpack_slots_seal(*channel_data[oc].get_ciphertext(), slots, unpacked,
+                      m_he_seal_backend);
+    std::move(unpacked.begin(), unpacked.end(),
+              out_data.begin() + oc * slots.size());
+  }
+}
+
+void HESealExecutable::handle_server_slot_packed_dot_op(
+    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
+    const Node& node, const std::vector<double>& matrix) {
+  bool verbose = verbose_op(&node);
+  size_t cols = arg->get_batched_element_count();
+  size_t rows = out->get_batched_element_count();
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "Packing " << cols << " elements into slots";
+  }
 
-void HESealExecutable::handle_server_max_pool_op(
-    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
-    const Node& node) {
-  NGRAPH_HE_LOG(3) << "Server handle_server_max_pool_op";
+  prefetch_dot_weights(node);
+  SealCiphertextWrapper packed;
+  pack_slots_seal(arg->data(), packed, m_he_seal_backend);
+  replicate_slots_seal(packed, diagonal_dot_period(rows, cols),
+                       m_he_seal_backend);
+  auto diagonals = encoded_dot_weights(node, matrix, rows, cols, packed);
+  auto product = HESealBackend::create_empty_ciphertext();
+  dot_diagonal_seal(packed, *diagonals, rows, cols, *product,
+                    m_he_seal_backend);
+  release_dot_weights(node);
 
-  bool verbose = verbose_op(&node);
-  const auto* max_pool = static_cast<const op::MaxPool*>(&node);
+  // The product is rescaled before it is unpacked into many ciphertexts
+  std::vector<HEType> product_data;
+  product_data.emplace_back(product, false, 1);
+  rescale_output(node, product_data, verbose);
 
-  m_max_pool_done = false;
+  std::vector<size_t> slots(rows);
+  std::iota(slots.begin(), slots.end(), 0);
+  std::vector<HEType> unpacked;
+  unpack_slots_seal(*product_data[0].get_ciphertext(), slots, unpacked,
+                    m_he_seal_backend);
+  std::vector<HEType>& out_data = out->data();
+  NGRAPH_CHECK(out_data.size() == unpacked.size(), "Output size ",
+               out_data.size(), " does not match ", unpacked.size(),
+               " slots");
+  std::move(unpacked.begin(), unpacked.end(), out_data.begin());
+}
 
-  Shape unpacked_arg_shape = node.get_input_shape(0);
-  Shape out_shape = HETensor::pack_shape(node.get_output_shape(0));
+std::shared_ptr<const EncodedDiagonals> HESealExecutable::encoded_dot_weights(
+    const Node& node, const std::vector<double>& matrix, size_t rows,
+    size_t cols, const SealCiphertextWrapper& arg) {
+  const seal::Ciphertext& cipher = arg.ciphertext();
+  bool cached = m_he_seal_backend.plaintext_cache();
+  std::future<std::shared_ptr<const EncodedDiagonals>> prefetch;
+  if (cached) {
+    std::lock_guard<std::mutex> guard(m_encoded_dot_weights_mutex);
+    m_dot_inputs[&node] = {cipher.parms_id(), cipher.scale(), rows, cols};
+    auto it = m_encoded_dot_weights.find(&node);
+    if (it != m_encoded_dot_weights.end() &&
+        it->second->parms_id == cipher.parms_id() &&
+        it->second->scale == cipher.scale()) {
+      return it->second;
+    }
+    auto pending = m_dot_weight_prefetches.find(&node);
+    if (pending != m_dot_weight_prefetches.end()) {
+      prefetch = std::move(pending->second);
+      m_dot_weight_prefetches.erase(pending);
+    }
+  }
 
-  // TODO(fboemer): call max_pool_seal directly?
-  std::vector<std::vector<size_t>> maximize_lists = max_pool_seal_max_list(
-      unpacked_arg_shape, out_shape, max_pool->get_window_shape(),
-      max_pool->get_window_movement_strides(), max_pool->get_padding_below(),
-      max_pool->get_padding_above());
+  // Encoded outside the lock, so other Dots proceed meanwhile
+  std::shared_ptr<const EncodedDiagonals> encoded;
+  if (prefetch.valid()) {
+    encoded = prefetch.get();
+    if (encoded->parms_id != cipher.parms_id() ||
+        encoded->scale != cipher.scale()) {
+      NGRAPH_HE_LOG(5) << "Prefetched weights of " << node.get_name()
+                       << " do not match the input level and scale";
+      encoded = nullptr;
+    }
+  }
+  if (encoded == nullptr) {
+    encoded = std::make_shared<const EncodedDiagonals>(
+        encode_diagonals_seal(matrix, rows, cols, cipher.parms_id(),
+                              cipher.scale(), m_he_seal_backend));
+  }
+  if (cached) {
+    NGRAPH_HE_LOG(5) << "Caching " << encoded->byte_count()
+                     << " bytes of encoded weights of " << node.get_name();
+    std::lock_guard<std::mutex> guard(m_encoded_dot_weights_mutex);
+    auto& entry = m_encoded_dot_weights[&node];
+    if (entry != nullptr) {
+      m_encoded_dot_weight_bytes -= entry->byte_count();
+    }
+    entry = encoded;
+    m_encoded_dot_weight_bytes += encoded->byte_count();
+  }
+  return encoded;
+}
+
+void HESealExecutable::prefetch_dot_weights(const Node& node) {
+  if (!m_he_seal_backend.plaintext_cache() ||
+      m_he_seal_backend.plaintext_cache_bytes() == 0) {
+    return;
+  }
+  auto node_it =
+      std::find_if(m_nodes.begin(), m_nodes.end(),
+                   [&node](const auto& other) { return other.get() == &node; });
+  if (node_it == m_nodes.end()) {
+    return;
+  }
+  auto node_idx = static_cast<size_t>(std::distance(m_nodes.begin(), node_it));
+  const Node* next = nullptr;
+  for (size_t i = 1; i < m_nodes.size() && next == nullptr; ++i) {
+    const Node* candidate = m_nodes[(node_idx + i) % m_nodes.size()].get();
+    if (m_slot_packed_dots.find(candidate) != m_slot_packed_dots.end()) {
+      next = candidate;
+    }
+  }
+  if (next == nullptr) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(m_encoded_dot_weights_mutex);
+  auto input = m_dot_inputs.find(next);
+  // Dots not computed yet have no known input level
+  if (input == m_dot_inputs.end() ||
+      m_encoded_dot_weights.find(next) != m_encoded_dot_weights.end() ||
+      m_dot_weight_prefetches.find(next) != m_dot_weight_prefetches.end()) {
+    return;
+  }
+  NGRAPH_HE_LOG(5) << "Prefetching encoded weights of " << next->get_name();
+  const std::vector<double>& matrix = m_slot_packed_dots.at(next);
+  m_dot_weight_prefetches.emplace(
+      next, std::async(std::launch::async,
+                       [this, &matrix, dot_input = input->second]() {
+                         return std::make_shared<const EncodedDiagonals>(
+                             encode_diagonals_seal(
+                                 matrix, dot_input.rows, dot_input.cols,
+                                 dot_input.parms_id, dot_input.scale,
+                                 m_he_seal_backend));
+                       }));
+}
+
+void HESealExecutable::release_dot_weights(const Node& node) {
+  size_t budget = m_he_seal_backend.plaintext_cache_bytes();
+  if (budget == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(m_encoded_dot_weights_mutex);
+  if (m_encoded_dot_weight_bytes <= budget) {
+    return;
+  }
+  // The weights are read again by the next call, later than the weights of
+  // every other Dot
+  auto it = m_encoded_dot_weights.find(&node);
+  if (it != m_encoded_dot_weights.end()) {
+    NGRAPH_HE_LOG(5) << "Evicting encoded weights of " << node.get_name();
+    m_encoded_dot_weight_bytes -= it->second->byte_count();
+    m_encoded_dot_weights.erase(it);
+  }
+}
+
+void HESealExecutable::handle_server_max_op(
+    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
+    const Node& node, const std::vector<std::vector<size_t>>& maximize_lists,
+    bool relu) {
+  bool verbose = verbose_op(&node);
+  NGRAPH_CHECK(!maximize_lists.empty(), "No windows to maximize over");
 
+  m_max_pool_done = false;
   m_max_pool_data.clear();
 
+#ifdef NGRAPH_HE_ABY_ENABLE
+  if (enable_garbled_circuits() && !arg->data().empty() &&
+      arg->all_encrypted_data()) {
+    send_gc_max_pool_request(arg, node, maximize_lists, relu);
+    HEWorkerPool::BlockingScope blocking_scope;
+    auto wait_start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+    m_max_pool_cond.wait(mlock,
+                         std::bind(&HESealExecutable::max_pool_done, this));
+    record_client_wait(wait_start);
+    m_max_pool_done = false;
+    out->data() = m_max_pool_data;
+    return;
+  }
+#endif
+  // Windows overlap, so each input is mod-switched once, before the windows
+  // share it
+  std::vector<HEType> inputs = arg->data();
+  mod_switch_client_ciphers(inputs);
+
+  // All windows are sent in one request, laid out as in garbled circuit
+  // requests: ciphertext j of window i is at index j * num_outputs + i.
+  // Smaller windows repeat their first value, which leaves the maximum
+  // unchanged
+  size_t num_outputs = maximize_lists.size();
+  size_t window_size = 0;
   for (const auto& maximize_list : maximize_lists) {
-    pb::TCPMessage pb_message;
-    pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+    NGRAPH_CHECK(!maximize_list.empty(), "Max window is empty");
+    window_size = std::max(window_size, maximize_list.size());
+  }
+  std::vector<HEType> cipher_batch;
+  cipher_batch.reserve(window_size * num_outputs);
+  for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+    for (const auto& maximize_list : maximize_lists) {
+      size_t list_idx = window_idx < maximize_list.size() ? window_idx : 0;
+      cipher_batch.emplace_back(inputs[maximize_list[list_idx]]);
+    }
+  }
+
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+  *pb_message.mutable_op_request() = node_to_pb_op_request(node);
+  pb_message.mutable_op_request()->set_chain_index(
+      client_output_chain_index(node));
+  pb_message.mutable_op_request()->set_num_outputs(num_outputs);
+  pb_message.mutable_op_request()->set_relu(relu);
+
+  HETensor max_tensor(
+      arg->get_element_type(),
+      Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
+      cipher_batch[0].plaintext_packing(), cipher_batch[0].complex_packing(),
+      true, m_he_seal_backend);
+  max_tensor.data() = std::move(cipher_batch);
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors = max_tensor.write_to_pb_tensors(&segments, m_compr_mode);
+  NGRAPH_CHECK(pb_tensors.size() == 1, "Only support ", node.description(),
+               " with 1 proto tensor");
+  *pb_message.add_he_tensors() = std::move(pb_tensors[0]);
+
+  if (verbose) {
+    NGRAPH_HE_LOG(3) << "Sending " << num_outputs << " windows of size "
+                     << window_size << " to client"
+                     << (relu ? ", fused with Relu" : "");
+  }
+  m_session->write_urgent_message(
+      TCPMessage(std::move(pb_message), std::move(segments[0])));
 
-    json js = {{"function", node.description()}};
-    pb::Function f;
-    f.set_function(js.dump());
-    *pb_message.mutable_function() = f;
+  HEWorkerPool::BlockingScope blocking_scope;
+  auto wait_start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+  m_max_pool_cond.wait(mlock,
+                       std::bind(&HESealExecutable::max_pool_done, this));
+  record_client_wait(wait_start);
 
-    std::vector<HEType> cipher_batch;
-    cipher_batch.reserve(maximize_list.size());
-    for (const size_t max_ind : maximize_list) {
-      cipher_batch.emplace_back(arg->data(max_ind));
+  // Reset for next max_pool call
+  m_max_pool_done = false;
+  NGRAPH_CHECK(m_max_pool_data.size() == num_outputs, "Client returned ",
+               m_max_pool_data.size(), " maxima of ", num_outputs,
+               " windows");
+  out->data() = m_max_pool_data;
+}
+
+void HESealExecutable::rescale_output(const Node& node,
+                                      std::vector<HEType>& data,
+                                      bool verbose) {
+  if (m_he_seal_backend.gc_relu_rescale() && enable_garbled_circuits() &&
+      node.get_users().size() == 1) {
+    const Node& user = *node.get_users()[0];
+    bool gc_relu = get_typeid(user.get_type_info()) == OP_TYPEID::Relu &&
+                   m_he_seal_backend.polynomial_activation(user) ==
+                       PolynomialActivation::none;
+#ifdef NGRAPH_HE_ABY_ENABLE
+    // The MaxPool circuit does not rescale
+    gc_relu = gc_relu && !client_fused_relu(user);
+#endif
+    if (gc_relu) {
+      if (verbose) {
+        NGRAPH_HE_LOG(3) << "Leaving rescale to garbled circuit Relu";
+      }
+      return;
+    }
+  }
+  rescale_seal(data, m_he_seal_backend, verbose);
+}
+
+bool HESealExecutable::reads_pending_factors(
+    OP_TYPEID type_id,
+    const std::vector<std::shared_ptr<HETensor>>& args) const {
+  switch (type_id) {
+    case OP_TYPEID::Broadcast:
+    case OP_TYPEID::Concat:
+    case OP_TYPEID::Multiply:
+    case OP_TYPEID::Negative:
+    case OP_TYPEID::Pad:
+    case OP_TYPEID::Reshape:
+    case OP_TYPEID::Result:
+    case OP_TYPEID::Reverse:
+    case OP_TYPEID::Slice:
+      return true;
+    case OP_TYPEID::Divide: {
+      const auto& divisors = args[1]->data();
+      return !divisors.empty() && std::all_of(divisors.begin(), divisors.end(),
+                                              is_uniform_plaintext);
+    }
+    default:
+      return false;
+  }
+}
+
+std::vector<std::shared_ptr<HETensor>>
+HESealExecutable::with_pending_factors_applied(
+    const std::vector<std::shared_ptr<HETensor>>& args) {
+  std::vector<std::shared_ptr<HETensor>> applied_args = args;
+  for (auto& arg : applied_args) {
+    if (arg == nullptr || !has_pending_factors(arg->data())) {
+      continue;
     }
+    auto applied_arg = std::static_pointer_cast<HETensor>(
+        m_he_seal_backend.create_cipher_tensor(
+            arg->get_element_type(), arg->get_shape(), arg->is_packed(),
+            arg->get_name()));
+    applied_arg->data() = arg->data();
+    apply_pending_factors(applied_arg->data(), m_he_seal_backend);
+    arg = applied_arg;
+  }
+  return applied_args;
+}
+
+size_t HESealExecutable::gc_relu_truncate_bits(
+    std::vector<HEType>& cipher_batch) {
+  if (!m_he_seal_backend.gc_relu_rescale() || cipher_batch.empty() ||
+      !cipher_batch[0].is_ciphertext()) {
+    return 0;
+  }
+  double ratio = cipher_batch[0].get_ciphertext()->scale() /
+                 m_he_seal_backend.get_scale();
+  double bits = std::round(std::log2(ratio));
+  if (bits < 1) {
+    return 0;
+  }
+  if (std::abs(ratio / std::exp2(bits) - 1) < 1e-6) {
+    return static_cast<size_t>(bits);
+  }
+  // The circuit only divides by powers of two
+  NGRAPH_HE_LOG(3) << "Rescaling Relu inputs with scale ratio " << ratio;
+  rescale_seal(cipher_batch, m_he_seal_backend, false);
+  return 0;
+}
 
-    NGRAPH_CHECK(!cipher_batch.empty(), "Maxpool cipher batch is empty");
+bool HESealExecutable::client_elementwise_op(const Node& node) const {
+  return enable_client() &&
+         client_elementwise_function(node.description()) != nullptr &&
+         !polynomial_op_depth(node).has_value();
+}
 
-    HETensor max_pool_tensor(
-        arg->get_element_type(),
-        Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
-        cipher_batch[0].plaintext_packing(), cipher_batch[0].complex_packing(),
-        true, m_he_seal_backend);
-    max_pool_tensor.data() = cipher_batch;
-    const auto& pb_tensors = max_pool_tensor.write_to_pb_tensors();
-    NGRAPH_CHECK(pb_tensors.size() == 1,
-                 "Only support MaxPool with 1 proto tensor");
-    *pb_message.add_he_tensors() = pb_tensors[0];
+bool HESealExecutable::client_fused_relu(const Node& node) const {
+  if (!enable_client() ||
+      get_typeid(node.get_type_info()) != OP_TYPEID::Relu ||
+      node.get_users().size() != 1 ||
+      m_he_seal_backend.polynomial_activation(node) !=
+          PolynomialActivation::none) {
+    return false;
+  }
+  const Node& user = *node.get_users()[0];
+  return get_typeid(user.get_type_info()) == OP_TYPEID::MaxPool &&
+         m_he_seal_backend.polynomial_activation(user) ==
+             PolynomialActivation::none;
+}
 
-    // Send list of ciphertexts to maximize over to client
-    if (verbose) {
-      NGRAPH_HE_LOG(3) << "Sending " << cipher_batch.size()
-                       << " Maxpool ciphertexts to client";
+#ifdef NGRAPH_HE_ABY_ENABLE
+void HESealExecutable::send_gc_max_pool_request(
+    const std::shared_ptr<HETensor>& arg, const Node& node,
+    const std::vector<std::vector<size_t>>& maximize_lists, bool relu) {
+  size_t num_outputs = maximize_lists.size();
+  size_t window_size = 0;
+  for (const auto& maximize_list : maximize_lists) {
+    window_size = std::max(window_size, maximize_list.size());
+  }
+  NGRAPH_HE_LOG(3) << "Server sending garbled circuit MaxPool request with "
+                   << num_outputs << " outputs of window size " << window_size
+                   << (relu ? ", fused with Relu" : "");
+
+  // Ciphertext j of output i is at index j * num_outputs + i. Smaller
+  // windows repeat their first value, which leaves the maximum unchanged.
+  // Masking modifies the ciphertexts in place, and windows may overlap, so
+  // each ciphertext is copied
+  std::vector<HEType> cipher_batch;
+  cipher_batch.reserve(window_size * num_outputs);
+  for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+    for (const auto& maximize_list : maximize_lists) {
+      NGRAPH_CHECK(!maximize_list.empty(), "MaxPool window is empty");
+      size_t list_idx = window_idx < maximize_list.size() ? window_idx : 0;
+      const HEType& he_type = arg->data(maximize_list[list_idx]);
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      cipher->ciphertext() = he_type.get_ciphertext()->ciphertext();
+      cipher_batch.emplace_back(cipher, he_type.complex_packing(),
+                                he_type.batch_size());
     }
+  }
+  mod_switch_client_ciphers(cipher_batch);
 
-    m_session->write_message(TCPMessage(std::move(pb_message)));
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+  *pb_message.mutable_function() = node_to_pb_function(
+      node,
+      {{"enable_gc", bool_to_string(true)},
+       {"num_aby_parties",
+        std::to_string(m_he_seal_backend.num_garbled_circuit_threads())},
+       {"window_size", std::to_string(window_size)},
+       {"num_outputs", std::to_string(num_outputs)},
+       {"relu", bool_to_string(relu)}});
+  std::string function_str = pb_message.function().function();
+
+  auto max_pool_tensor = std::make_shared<HETensor>(
+      arg->get_element_type(),
+      Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
+      cipher_batch[0].plaintext_packing(), cipher_batch[0].complex_packing(),
+      true, m_he_seal_backend);
+  max_pool_tensor->data() = cipher_batch;
+  m_aby_executor->prepare_aby_circuit(function_str, max_pool_tensor);
+
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors =
+      max_pool_tensor->write_to_pb_tensors(&segments, m_compr_mode);
+  NGRAPH_CHECK(pb_tensors.size() == 1,
+               "Only support MaxPool with 1 proto tensor");
+  *pb_message.add_he_tensors() = std::move(pb_tensors[0]);
+  m_session->write_urgent_message(
+      TCPMessage(std::move(pb_message), std::move(segments[0])));
+
+  m_aby_executor->run_aby_circuit(function_str, max_pool_tensor);
+}
 
-    // Acquire lock
-    std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+bool HESealExecutable::hybrid_aby_dot(const Node& node) const {
+  if (!m_he_seal_backend.hybrid_linear_layers() ||
+      !enable_garbled_circuits() ||
+      get_typeid(node.get_type_info()) != OP_TYPEID::Dot ||
+      node.get_users().size() != 1 ||
+      node.get_element_type() != element::f32) {
+    return false;
+  }
+  const auto* dot = static_cast<const op::Dot*>(&node);
+  const Node& user = *node.get_users()[0];
+  const Shape& arg_shape = node.get_input_shape(0);
+  const Shape& weight_shape = node.get_input_shape(1);
+  if (get_typeid(user.get_type_info()) != OP_TYPEID::Relu ||
+      m_he_seal_backend.polynomial_activation(user) !=
+          PolynomialActivation::none ||
+      client_fused_relu(user) || dot->get_reduction_axes_count() != 1 ||
+      arg_shape.size() != 2 || weight_shape.size() != 2 ||
+      !node.get_argument(1)->is_constant()) {
+    return false;
+  }
 
-    // Wait until max is done
-    m_max_pool_cond.wait(mlock,
-                         std::bind(&HESealExecutable::max_pool_done, this));
+  const auto& parms = m_he_seal_backend.get_encryption_parameters()
+                          .seal_encryption_parameters();
+  bool prefer_aby = aby::prefer_aby_dot_relu(
+      weight_shape[0], weight_shape[1], arg_shape[0],
+      parms.poly_modulus_degree(), parms.coeff_modulus().size());
+  NGRAPH_HE_LOG(4) << "Cost model computes " << node.get_name() << " in "
+                   << (prefer_aby ? "ABY" : "HE");
+  return prefer_aby;
+}
 
-    // Reset for next max_pool call
-    m_max_pool_done = false;
+void HESealExecutable::handle_server_aby_dot_relu_op(
+    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
+    const Node& node) {
+  auto weights =
+      std::dynamic_pointer_cast<op::Constant>(node.get_argument(1));
+  NGRAPH_CHECK(weights != nullptr, "Dot weights are not a Constant");
+  size_t input_size = weights->get_shape()[0];
+  size_t output_size = weights->get_shape()[1];
+  NGRAPH_CHECK(arg->data().size() == input_size, "Dot argument has ",
+               arg->data().size(), " elements, expected ", input_size);
+  NGRAPH_HE_LOG(3) << "Server computing " << node.get_name()
+                   << " and its Relu in ABY with " << input_size
+                   << " inputs and " << output_size << " outputs";
+
+  // Masking modifies the ciphertexts in place, so each ciphertext is copied
+  std::vector<HEType> cipher_batch;
+  cipher_batch.reserve(input_size);
+  for (const HEType& he_type : arg->data()) {
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    cipher->ciphertext() = he_type.get_ciphertext()->ciphertext();
+    cipher_batch.emplace_back(cipher, he_type.complex_packing(),
+                              he_type.batch_size());
+  }
+  size_t truncate_bits = gc_relu_truncate_bits(cipher_batch);
+  mod_switch_client_ciphers(cipher_batch);
+
+  std::vector<uint64_t> encoded_weights;
+  for (float weight : weights->get_vector<float>()) {
+    encoded_weights.emplace_back(
+        aby::encode_aby_weight(weight, s_aby_weight_bits));
   }
+
+  m_max_pool_done = false;
+  m_max_pool_data.clear();
+
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+  *pb_message.mutable_function() = node_to_pb_function(
+      node,
+      {{"function", "DotRelu"},
+       {"enable_gc", bool_to_string(true)},
+       {"num_aby_parties",
+        std::to_string(m_he_seal_backend.num_garbled_circuit_threads())},
+       {"output_size", std::to_string(output_size)},
+       {"weight_bits", std::to_string(s_aby_weight_bits)},
+       {"truncate_bits", std::to_string(truncate_bits)}});
+  std::string function_str = pb_message.function().function();
+
+  auto dot_tensor = std::make_shared<HETensor>(
+      arg->get_element_type(),
+      Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
+      cipher_batch[0].plaintext_packing(), cipher_batch[0].complex_packing(),
+      true, m_he_seal_backend);
+  dot_tensor->data() = cipher_batch;
+  m_aby_executor->prepare_aby_circuit(function_str, dot_tensor);
+
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors = dot_tensor->write_to_pb_tensors(&segments, m_compr_mode);
+  NGRAPH_CHECK(pb_tensors.size() == 1,
+               "Only support Dot with 1 proto tensor");
+  *pb_message.add_he_tensors() = std::move(pb_tensors[0]);
+  m_session->write_urgent_message(
+      TCPMessage(std::move(pb_message), std::move(segments[0])));
+
+  m_aby_executor->run_aby_dot_relu_circuit(dot_tensor->data(),
+                                           encoded_weights, output_size,
+                                           s_aby_weight_bits, truncate_bits);
+
+  HEWorkerPool::BlockingScope blocking_scope;
+  auto wait_start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> mlock(m_max_pool_mutex);
+  m_max_pool_cond.wait(mlock,
+                       std::bind(&HESealExecutable::max_pool_done, this));
+  record_client_wait(wait_start);
+  m_max_pool_done = false;
   out->data() = m_max_pool_data;
+
+  std::lock_guard<std::mutex> guard(m_aby_computed_relus_mutex);
+  m_aby_computed_relus.insert(node.get_users()[0].get());
 }
+#endif
 
 void HESealExecutable::handle_server_relu_op(
     const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
@@ -1499,121 +6217,561 @@ void HESealExecutable::handle_server_relu_op(
                                                  : "");
 
   auto type_id = get_typeid(node.get_type_info());
-  NGRAPH_CHECK(type_id == OP_TYPEID::Relu || type_id == OP_TYPEID::BoundedRelu,
-               "only support relu / bounded relu");
-
-  bool verbose = verbose_op(&node);
-  size_t element_count = arg->data().size();
+  NGRAPH_CHECK(type_id == OP_TYPEID::Relu ||
+                   type_id == OP_TYPEID::BoundedRelu ||
+                   client_elementwise_op(node),
+               "only support relu / bounded relu / elementwise ops");
 
   size_t smallest_ind =
       match_to_smallest_chain_index(arg->data(), m_he_seal_backend);
-  if (verbose) {
+  if (verbose_op(&node)) {
     NGRAPH_HE_LOG(3) << "Matched moduli to chain ind " << smallest_ind;
   }
 
-  m_relu_data.resize(element_count, HEType(HEPlaintext(), false));
-
-  // TODO(fboemer): tune
-  const size_t max_relu_message_cnt = 1000;
-
-  m_unknown_relu_idx.clear();
-  m_unknown_relu_idx.reserve(element_count);
+  auto stream = begin_relu_stream(arg->data(), arg->get_element_type(),
+                                  arg->is_packed(), node);
+  stream_relu_values(stream, arg->data().size());
+  finish_relu_stream(stream, out->data());
+}
 
-  // Process known values
-  for (size_t relu_idx = 0; relu_idx < element_count; ++relu_idx) {
-    auto& he_type = arg->data(relu_idx);
-    if (he_type.is_plaintext()) {
-      m_relu_data[relu_idx].set_plaintext(HEPlaintext());
-      if (type_id == OP_TYPEID::Relu) {
-        scalar_relu_seal(he_type.get_plaintext(),
-                         m_relu_data[relu_idx].get_plaintext());
+void HESealExecutable::handle_server_refresh_op(
+    const std::shared_ptr<HETensor>& arg, const std::shared_ptr<HETensor>& out,
+    const Node& node) {
+  NGRAPH_HE_LOG(3) << "Server handle_server_refresh_op";
+
+  // The client only learns each value up to a uniformly random mask, which
+  // is subtracted from the refreshed value
+  double mask_bound = m_he_seal_backend.refresh_mask_bound();
+  std::vector<HEType> masked = arg->data();
+  std::vector<std::optional<HEType>> masks(masked.size());
+  if (mask_bound > 0) {
+    std::random_device random_device;
+    std::mt19937_64 generator(random_device());
+    std::uniform_real_distribution<double> distribution(-mask_bound,
+                                                        mask_bound);
+    for (size_t i = 0; i < masked.size(); ++i) {
+      if (masked[i].is_ciphertext()) {
+        HEPlaintext mask(masked[i].batch_size());
+        std::generate(mask.begin(), mask.end(),
+                      [&]() { return distribution(generator); });
+        masks[i].emplace(mask, masked[i].complex_packing());
+      }
+    }
+  }
+  auto apply_masks = [&](std::vector<HEType>& data, bool subtract) {
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t i = 0; i < data.size(); ++i) {
+      if (!masks[i].has_value() || !data[i].is_ciphertext()) {
+        continue;
+      }
+      // The input ciphertexts are shared with the argument
+      HEType result(HEPlaintext(), data[i].complex_packing());
+      if (subtract) {
+        scalar_subtract_seal(data[i], *masks[i], result, m_he_seal_backend);
       } else {
-        const auto* bounded_relu = static_cast<const op::BoundedRelu*>(&node);
-        float alpha = bounded_relu->get_alpha();
-        scalar_bounded_relu_seal(he_type.get_plaintext(),
-                                 m_relu_data[relu_idx].get_plaintext(), alpha);
+        scalar_add_seal(data[i], *masks[i], result, m_he_seal_backend);
       }
-    } else {
-      m_unknown_relu_idx.emplace_back(relu_idx);
+      data[i] = std::move(result);
     }
+  };
+  apply_masks(masked, false);
+
+  auto stream = begin_relu_stream(masked, arg->get_element_type(),
+                                  arg->is_packed(), node);
+  stream_relu_values(stream, masked.size());
+  finish_relu_stream(stream, out->data());
+  apply_masks(out->data(), true);
+}
+
+std::shared_ptr<const ConvolutionIndexTable>
+HESealExecutable::convolution_index_table(const Node& node,
+                                          const Shape& data_shape,
+                                          const Shape& filters_shape,
+                                          const Shape& out_shape) {
+  std::lock_guard<std::mutex> guard(m_convolution_tables_mutex);
+  auto& table = m_convolution_tables[&node];
+  if (table != nullptr && table->arg0_shape == data_shape &&
+      table->arg1_shape == filters_shape && table->out_shape == out_shape) {
+    return table;
   }
-  auto process_unknown_relu_ciphers_batch = [&](std::vector<HEType>&
-                                                    cipher_batch) {
-    if (verbose) {
-      NGRAPH_HE_LOG(3) << "Sending relu request size " << cipher_batch.size();
+
+  auto make_table = [&](const auto& conv) {
+    return std::make_shared<const ConvolutionIndexTable>(
+        convolution_seal_index_table(
+            data_shape, filters_shape, out_shape,
+            conv.get_window_movement_strides(),
+            conv.get_window_dilation_strides(), conv.get_padding_below(),
+            conv.get_padding_above(), conv.get_data_dilation_strides(), 0, 1,
+            1, 0, 0, 1));
+  };
+  auto type_id = get_typeid(node.get_type_info());
+  if (type_id == OP_TYPEID::ConvolutionBiasRelu) {
+    table = make_table(static_cast<const op::ConvolutionBiasRelu&>(node));
+  } else if (type_id == OP_TYPEID::GroupConvolution) {
+    const auto& conv = static_cast<const op::GroupConvolution&>(node);
+    table = std::make_shared<const ConvolutionIndexTable>(
+        group_convolution_seal_index_table(
+            data_shape, filters_shape, out_shape,
+            conv.get_window_movement_strides(),
+            conv.get_window_dilation_strides(), conv.get_padding_below(),
+            conv.get_padding_above(), conv.get_data_dilation_strides(),
+            conv.get_groups()));
+  } else {
+    table = make_table(static_cast<const op::Convolution&>(node));
+  }
+  NGRAPH_HE_LOG(3) << "Computed " << table->input_indices.size()
+                   << " convolution index pairs for " << node.get_name();
+  return table;
+}
+
+bool HESealExecutable::pointwise_convolution_node(const Node& node) {
+  if (get_typeid(node.get_type_info()) != OP_TYPEID::Convolution) {
+    return false;
+  }
+  const auto& conv = static_cast<const op::Convolution&>(node);
+  return pointwise_convolution(
+      node.get_input_shape(1), conv.get_window_movement_strides(),
+      conv.get_padding_below(), conv.get_padding_above(),
+      conv.get_data_dilation_strides());
+}
+
+std::shared_ptr<const std::vector<HEType>> HESealExecutable::winograd_filters(
+    const Node& node, const HETensor& filters) {
+  if (!m_he_seal_backend.winograd_convolutions() ||
+      m_he_seal_backend.lazy_mod() ||
+      get_typeid(node.get_type_info()) != OP_TYPEID::Convolution ||
+      !node.get_input_node_ptr(1)->is_constant() || quantized_weights(node)) {
+    return nullptr;
+  }
+  const auto& conv = static_cast<const op::Convolution&>(node);
+  if (filters.get_packed_shape().size() != 4 ||
+      !winograd_convolution(filters.get_packed_shape(),
+                            conv.get_window_movement_strides(),
+                            conv.get_window_dilation_strides(),
+                            conv.get_data_dilation_strides())) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> guard(m_winograd_filters_mutex);
+  auto it = m_winograd_filters.find(&node);
+  if (it != m_winograd_filters.end()) {
+    return it->second;
+  }
+  std::shared_ptr<const std::vector<HEType>> transformed;
+  auto values =
+      winograd_filter_transform(filters.data(), filters.get_packed_shape());
+  if (values.has_value()) {
+    NGRAPH_HE_LOG(3) << "Computing " << node.get_name()
+                     << " by the Winograd transform";
+    transformed =
+        std::make_shared<const std::vector<HEType>>(std::move(*values));
+  }
+  m_winograd_filters[&node] = transformed;
+  return transformed;
+}
+
+std::shared_ptr<const WeightedSums> HESealExecutable::weighted_sums(
+    const Node& node, const HETensor& weights,
+    const std::shared_ptr<const ConvolutionIndexTable>& table) {
+  // Sums are only reused when the weights cannot change between calls
+  if (!node.get_input_node_ptr(1)->is_constant()) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> guard(m_weighted_sums_mutex);
+  auto it = m_weighted_sums.find(&node);
+  if (it != m_weighted_sums.end() && it->second.table == table) {
+    return it->second.sums;
+  }
+
+  std::optional<WeightedSums> sums;
+  if (table != nullptr) {
+    sums = convolution_seal_weighted_sums(*table, weights.data());
+  } else if (pointwise_convolution_node(node)) {
+    const Shape& data_shape = node.get_input_shape(0);
+    sums = pointwise_convolution_seal_weighted_sums(
+        weights.data(), data_shape[1],
+        shape_size(Shape(data_shape.begin() + 2, data_shape.end())));
+  } else {
+    const auto& dot = static_cast<const op::Dot&>(node);
+    sums = dot_seal_weighted_sums(weights.data(), weights.get_packed_shape(),
+                                  dot.get_reduction_axes_count());
+  }
+  if (sums.has_value() && quantized_weights(node)) {
+    NGRAPH_CHECK(quantize_weighted_sums(
+                     *sums, weights.data(),
+                     m_he_seal_backend.quantized_weight_step()),
+                 "Weights of ", node.get_name(), " are not quantized");
+    NGRAPH_HE_LOG(3) << "Multiplying by quantized weights of "
+                     << node.get_name();
+  }
+  WeightedSumsEntry entry{table, nullptr};
+  if (sums.has_value()) {
+    NGRAPH_HE_LOG(3) << "Kept " << sums->input_indices.size()
+                     << " non-zero weighted products of " << node.get_name();
+    entry.sums = std::make_shared<const WeightedSums>(std::move(*sums));
+  }
+  m_weighted_sums[&node] = entry;
+  return entry.sums;
+}
+
+void HESealExecutable::handle_server_conv_bias_relu_op(
+    const std::vector<std::shared_ptr<HETensor>>& args,
+    const std::shared_ptr<HETensor>& out, const Node& node) {
+  NGRAPH_HE_LOG(3) << "Server handle_server_conv_bias_relu_op";
+  bool verbose = verbose_op(&node);
+
+  Shape data_shape = args[0]->get_packed_shape();
+  Shape filters_shape = args[1]->get_packed_shape();
+  Shape out_shape = out->get_packed_shape();
+  size_t element_count = shape_size(out_shape);
+  NGRAPH_CHECK(args[2]->data().size() >= element_count, "Bias has ",
+               args[2]->data().size(), " elements, expected ", element_count);
+
+  // Each (batch, output channel) pair is a contiguous block of the output
+  size_t block_size = out_shape.size() > 2
+                          ? shape_size(Shape(out_shape.begin() + 2,
+                                             out_shape.end()))
+                          : 1;
+  std::vector<HEType> conv_data(element_count, HEType(HEPlaintext(), false));
+  auto activation = m_he_seal_backend.polynomial_activation(node);
+  // The garbled circuit of the ReLU rescales the result
+  bool gc_relu_rescale = enable_garbled_circuits() &&
+                         m_he_seal_backend.gc_relu_rescale() &&
+                         activation == PolynomialActivation::none;
+  auto table =
+      convolution_index_table(node, data_shape, filters_shape, out_shape);
+  auto sums = weighted_sums(node, *args[1], table);
+  auto compute_block = [&](size_t block_begin, size_t block_end) {
+    if (sums != nullptr) {
+      convolution_seal_range(args[0]->data(), args[1]->data(), conv_data,
+                             *sums, batch_size(), m_he_seal_backend,
+                             block_begin, block_end);
+    } else {
+      convolution_seal_range(args[0]->data(), args[1]->data(), conv_data,
+                             *table, out->get_element_type(), batch_size(),
+                             m_he_seal_backend, block_begin, block_end,
+                             verbose);
+    }
+
+    std::vector<HEType> block(
+        std::make_move_iterator(conv_data.begin() + block_begin),
+        std::make_move_iterator(conv_data.begin() + block_end));
+    if (m_he_seal_backend.lazy_mod()) {
+      mod_reduce_seal(block, m_he_seal_backend, verbose);
+    }
+    if (!gc_relu_rescale) {
+      rescale_seal(block, m_he_seal_backend, verbose);
+    }
+#pragma omp parallel for
+    // NOLINTNEXTLINE
+    for (size_t i = 0; i < block.size(); ++i) {
+      scalar_add_seal(block[i], args[2]->data(block_begin + i), block[i],
+                      m_he_seal_backend);
     }
+    std::move(block.begin(), block.end(), conv_data.begin() + block_begin);
+  };
+
+  if (activation != PolynomialActivation::none) {
+    compute_block(0, element_count);
+    polynomial_relu_seal(conv_data, out->data(), element_count, activation,
+                         m_he_seal_backend.polynomial_activation_bound(),
+                         m_he_seal_backend);
+    return;
+  }
 
-    pb::TCPMessage proto_msg;
-    proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+  if (!enable_client()) {
+    NGRAPH_WARN << "Performing Relu without client is not privacy preserving ";
+    compute_block(0, element_count);
+    relu_seal(conv_data, out->data(), element_count, m_he_seal_backend);
+    return;
+  }
+
+  // Blocks are sent to the client as soon as they are computed, so the
+  // client computes the ReLU of early channels while later channels are
+  // convolved
+  auto stream = begin_relu_stream(conv_data, out->get_element_type(),
+                                  out->is_packed(), node);
+  for (size_t block_begin = 0; block_begin < element_count;
+       block_begin += block_size) {
+    size_t block_end = std::min(block_begin + block_size, element_count);
+    compute_block(block_begin, block_end);
+    stream_relu_values(stream, block_end);
+  }
+  finish_relu_stream(stream, out->data());
+}
+
+void HESealExecutable::send_relu_request(const Node& node,
+                                         const element::Type& element_type,
+                                         bool packed,
+                                         std::vector<HEType>& cipher_batch,
+                                         size_t first_unknown_idx,
+                                         size_t num_values,
+                                         size_t compaction) {
+  if (verbose_op(&node)) {
+    NGRAPH_HE_LOG(3) << "Sending relu request size " << cipher_batch.size();
+  }
+
+  // The garbled circuits are configured by the function's JSON. Otherwise,
+  // the client only needs the op and the level of its outputs. Refreshes
+  // are masked by the server instead, and elementwise ops have no circuits
+  bool enable_gc = enable_garbled_circuits() &&
+                   get_typeid(node.get_type_info()) != OP_TYPEID::Refresh &&
+                   !client_elementwise_op(node);
+  pb::TCPMessage proto_msg;
+  proto_msg.set_type(pb::TCPMessage_Type_REQUEST);
+  if (enable_gc) {
     *proto_msg.mutable_function() = node_to_pb_function(
         node,
-        {{"enable_gc", bool_to_string(enable_garbled_circuits())},
+        {{"enable_gc", bool_to_string(true)},
          {"num_aby_parties",
-          std::to_string(m_he_seal_backend.num_garbled_circuit_threads())}});
-    std::string function_str = proto_msg.function().function();
+          std::to_string(m_he_seal_backend.num_garbled_circuit_threads())},
+         {"truncate_bits",
+          std::to_string(gc_relu_truncate_bits(cipher_batch))}});
+  } else {
+    *proto_msg.mutable_op_request() = node_to_pb_op_request(node);
+    proto_msg.mutable_op_request()->set_chain_index(
+        client_output_chain_index(node));
+  }
+  const std::string& function_str = proto_msg.function().function();
+
+  // The client decrypts and re-encrypts each ciphertext with its own
+  // complex packing, which is serialized per element
+  auto relu_tensor = std::make_shared<HETensor>(
+      element_type, Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
+      packed, cipher_batch[0].complex_packing(), true, m_he_seal_backend);
+  relu_tensor->data() = cipher_batch;
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+  if (enable_gc) {
+    // Masks input values
+    m_aby_executor->prepare_aby_circuit(function_str, relu_tensor);
+  }
+#endif
+
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors = relu_tensor->write_to_pb_tensors(&segments, m_compr_mode);
+  size_t unknown_idx = first_unknown_idx;
+  size_t unknown_end = first_unknown_idx + num_values;
+  for (size_t tensor_idx = 0; tensor_idx < pb_tensors.size(); ++tensor_idx) {
+    pb::TCPMessage write_msg = proto_msg;
+    size_t tensor_values =
+        std::min(pb_tensors[tensor_idx].data_size() * compaction,
+                 unknown_end - unknown_idx);
+    {
+      // Registered before sending, since the response may arrive first
+      std::lock_guard<std::mutex> guard(m_relu_mutex);
+      uint64_t stream_id = m_next_relu_stream_id++;
+      m_relu_streams.emplace(stream_id, unknown_idx);
+      if (compaction > 1) {
+        m_relu_compactions.emplace(
+            stream_id,
+            ReluCompaction{tensor_values, compaction,
+                           cipher_batch[0].batch_size() / compaction});
+      }
+      write_msg.set_stream_id(stream_id);
+    }
+    unknown_idx += tensor_values;
+    *write_msg.add_he_tensors() = std::move(pb_tensors[tensor_idx]);
+    TCPMessage relu_message(std::move(write_msg),
+                            std::move(segments[tensor_idx]));
 
-    // TODO(fboemer): set complex_packing to correct values?
-    auto relu_tensor = std::make_shared<HETensor>(
-        arg->get_element_type(),
-        Shape{cipher_batch[0].batch_size(), cipher_batch.size()},
-        arg->is_packed(), false, true, m_he_seal_backend);
-    relu_tensor->data() = cipher_batch;
+    NGRAPH_HE_LOG(5) << "Server writing relu request message";
+    m_session->write_urgent_message(std::move(relu_message));
 
 #ifdef NGRAPH_HE_ABY_ENABLE
-    if (enable_garbled_circuits()) {
-      // Masks input values
-      m_aby_executor->prepare_aby_circuit(function_str, relu_tensor);
+    if (enable_gc) {
+      m_aby_executor->run_aby_circuit(function_str, relu_tensor);
     }
 #endif
+  }
+}
+
+HESealExecutable::ReluStream HESealExecutable::begin_relu_stream(
+    const std::vector<HEType>& data, const element::Type& element_type,
+    bool packed, const Node& node) {
+  ReluStream stream;
+  stream.node = &node;
+  stream.data = &data;
+  stream.element_type = element_type;
+  stream.packed = packed;
+  stream.window = relu_window();
+
+  size_t element_count = data.size();
+  m_relu_data.resize(element_count, HEType(HEPlaintext(), false));
+  std::lock_guard<std::mutex> guard(m_relu_mutex);
+  m_unknown_relu_idx.clear();
+  m_unknown_relu_idx.reserve(element_count);
+  return stream;
+}
 
-    const auto pb_tensors = relu_tensor->write_to_pb_tensors();
-    for (const auto& pb_tensor : pb_tensors) {
-      pb::TCPMessage write_msg;
-      write_msg.set_type(pb::TCPMessage_Type_REQUEST);
-      *write_msg.mutable_function() = node_to_pb_function(
-          node,
-          {{"enable_gc", bool_to_string(enable_garbled_circuits())},
-           {"num_aby_parties",
-            std::to_string(m_he_seal_backend.num_garbled_circuit_threads())}});
+void HESealExecutable::stream_relu_values(ReluStream& stream, size_t end) {
+  const auto& data = *stream.data;
+  auto type_id = get_typeid(stream.node->get_type_info());
 
-      *write_msg.add_he_tensors() = pb_tensor;
-      TCPMessage relu_message(std::move(write_msg));
+  // Process known values
+  std::vector<size_t> unknown_relu_idx;
+  for (size_t relu_idx = stream.scanned; relu_idx < end; ++relu_idx) {
+    const auto& he_type = data[relu_idx];
+    if (he_type.is_plaintext()) {
+      m_relu_data[relu_idx].set_plaintext(HEPlaintext());
+      if (type_id == OP_TYPEID::Refresh) {
+        m_relu_data[relu_idx].set_plaintext(he_type.get_plaintext());
+      } else if (auto function =
+                     client_elementwise_function(stream.node->description());
+                 function != nullptr && type_id != OP_TYPEID::Relu) {
+        scalar_elementwise_seal(he_type.get_plaintext(),
+                                m_relu_data[relu_idx].get_plaintext(),
+                                function);
+      } else if (type_id == OP_TYPEID::BoundedRelu) {
+        const auto* bounded_relu =
+            static_cast<const op::BoundedRelu*>(stream.node);
+        float alpha = bounded_relu->get_alpha();
+        scalar_bounded_relu_seal(he_type.get_plaintext(),
+                                 m_relu_data[relu_idx].get_plaintext(), alpha);
+      } else {
+        scalar_relu_seal(he_type.get_plaintext(),
+                         m_relu_data[relu_idx].get_plaintext());
+      }
+    } else {
+      unknown_relu_idx.emplace_back(relu_idx);
+    }
+  }
+  stream.scanned = end;
+  {
+    // The result handler reads the indices of received values
+    std::lock_guard<std::mutex> guard(m_relu_mutex);
+    m_unknown_relu_idx.insert(m_unknown_relu_idx.end(),
+                              unknown_relu_idx.begin(),
+                              unknown_relu_idx.end());
+  }
 
-      NGRAPH_HE_LOG(5) << "Server writing relu request message";
-      m_session->write_message(std::move(relu_message));
+  if (stream.chunk_size == 0 && !m_unknown_relu_idx.empty()) {
+    // Chunks are sized from the serialized ciphertext size, and up to
+    // relu_window chunks await a response at once, so the next chunk is
+    // serialized while earlier chunks are on the wire or being processed by
+    // the client. Measured as sent, i.e. after any modulus switching
+    std::vector<HEType> first_cipher{data[m_unknown_relu_idx[0]]};
+    mod_switch_client_ciphers(first_cipher);
+    size_t cipher_bytes = first_cipher[0]
+                              .get_ciphertext()
+                              ->ciphertext()
+                              .save_size(seal::compr_mode_type::none);
+    size_t max_chunk_size =
+        std::max(1UL, m_he_seal_backend.relu_chunk_bytes() / cipher_bytes);
+    // At least one chunk per window slot, so the pipeline fills. Values not
+    // yet streamed may be unknown
+    size_t max_unknown_count =
+        m_unknown_relu_idx.size() + (data.size() - stream.scanned);
+    stream.chunk_size =
+        std::min(max_chunk_size, ceil_div(max_unknown_count, stream.window));
+    if (verbose_op(stream.node)) {
+      NGRAPH_HE_LOG(3) << "Relu chunk size " << stream.chunk_size
+                       << ", window " << stream.window;
+    }
+  }
 
-#ifdef NGRAPH_HE_ABY_ENABLE
-      if (enable_garbled_circuits()) {
-        m_aby_executor->run_aby_circuit(function_str, relu_tensor);
+  // Send full chunks, and the last partial chunk once all values are known
+  while (stream.chunk_size > 0 && stream.sent < m_unknown_relu_idx.size()) {
+    size_t chunk_end = stream.sent + stream.chunk_size;
+    if (chunk_end > m_unknown_relu_idx.size()) {
+      if (stream.scanned < data.size()) {
+        break;
       }
-#endif
+      chunk_end = m_unknown_relu_idx.size();
     }
-  };
+    send_relu_chunk(stream, chunk_end);
+  }
+}
 
-  // Process unknown values
-  std::vector<HEType> relu_ciphers_batch;
-  relu_ciphers_batch.reserve(max_relu_message_cnt);
+void HESealExecutable::send_relu_chunk(ReluStream& stream, size_t chunk_end) {
+  size_t chunk_start = stream.sent;
+  {
+    // Wait until a window slot is free
+    auto wait_start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> mlock(m_relu_mutex);
+    auto window_free = [&]() {
+      return chunk_start - m_relu_done_count <
+             stream.window * stream.chunk_size;
+    };
+    if (!window_free()) {
+      HEWorkerPool::BlockingScope blocking_scope;
+      m_relu_cond.wait(mlock, window_free);
+    }
+    record_client_wait(wait_start);
+  }
 
-  for (const auto& unknown_relu_idx : m_unknown_relu_idx) {
-    NGRAPH_CHECK(arg->data(unknown_relu_idx).is_ciphertext(),
+  auto serialize_start = std::chrono::steady_clock::now();
+  std::vector<HEType> relu_ciphers_batch;
+  relu_ciphers_batch.reserve(chunk_end - chunk_start);
+  for (size_t i = chunk_start; i < chunk_end; ++i) {
+    size_t unknown_relu_idx = m_unknown_relu_idx[i];
+    NGRAPH_CHECK((*stream.data)[unknown_relu_idx].is_ciphertext(),
                  "HEType should be ciphertext");
-    relu_ciphers_batch.emplace_back(arg->data(unknown_relu_idx));
-    if (relu_ciphers_batch.size() == max_relu_message_cnt) {
-      process_unknown_relu_ciphers_batch(relu_ciphers_batch);
-      relu_ciphers_batch.clear();
-    }
+    relu_ciphers_batch.emplace_back((*stream.data)[unknown_relu_idx]);
+  }
+  // The Galois keys may have been requested for results alone
+  size_t compaction =
+      m_he_seal_backend.relu_compaction() && !enable_garbled_circuits()
+          ? client_compaction(relu_ciphers_batch)
+          : 1;
+  if (compaction > 1) {
+    compact_client_ciphers(relu_ciphers_batch, compaction);
+  }
+  mod_switch_client_ciphers(relu_ciphers_batch);
+  {
+    // Registered before sending, since the response may arrive first
+    std::lock_guard<std::mutex> guard(m_relu_mutex);
+    m_relu_send_times.emplace_back(chunk_end, serialize_start);
+  }
+  send_relu_request(*stream.node, stream.element_type,
+                    stream.packed || compaction > 1, relu_ciphers_batch,
+                    chunk_start, chunk_end - chunk_start, compaction);
+  stream.sent = chunk_end;
+
+  auto sent = std::chrono::steady_clock::now();
+  double serialize_ms =
+      std::chrono::duration<double, std::milli>(sent - serialize_start)
+          .count();
+  std::lock_guard<std::mutex> guard(m_relu_mutex);
+  if (!m_relu_send_times.empty() &&
+      m_relu_send_times.back().first == chunk_end) {
+    m_relu_send_times.back().second = sent;
   }
-  if (!relu_ciphers_batch.empty()) {
-    process_unknown_relu_ciphers_batch(relu_ciphers_batch);
-    relu_ciphers_batch.clear();
+  m_relu_serialize_ms =
+      update_moving_average(m_relu_serialize_ms, serialize_ms);
+}
+
+void HESealExecutable::finish_relu_stream(ReluStream& stream,
+                                          std::vector<HEType>& out_data) {
+  if (stream.scanned < stream.data->size()) {
+    stream_relu_values(stream, stream.data->size());
   }
 
   // Wait until all batches have been processed
+  auto wait_start = std::chrono::steady_clock::now();
   std::unique_lock<std::mutex> mlock(m_relu_mutex);
-  m_relu_cond.wait(
-      mlock, [=]() { return m_relu_done_count == m_unknown_relu_idx.size(); });
+  auto all_done = [=]() {
+    return m_relu_done_count == m_unknown_relu_idx.size();
+  };
+  if (!all_done()) {
+    HEWorkerPool::BlockingScope blocking_scope;
+    m_relu_cond.wait(mlock, all_done);
+  }
+  record_client_wait(wait_start);
+  expand_relu_results();
+  m_relu_send_times.clear();
+  m_relu_streams.clear();
+  m_relu_compactions.clear();
+  // Queueing behind earlier chunks inflates the round-trip times, so the
+  // fastest chunk estimates the latency
+  if (m_relu_min_rtt_ms < std::numeric_limits<double>::max()) {
+    m_relu_rtt_ms = update_moving_average(m_relu_rtt_ms, m_relu_min_rtt_ms);
+  }
+  m_relu_min_rtt_ms = std::numeric_limits<double>::max();
   m_relu_done_count = 0;
 
-  out->data() = m_relu_data;
+  // m_relu_data is overwritten by the next ReLU, so its data is not copied
+  out_data.swap(m_relu_data);
 }
 }  // namespace ngraph::runtime::he
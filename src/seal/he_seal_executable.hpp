@@ -19,12 +19,19 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <set>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "boost/asio.hpp"
@@ -33,13 +40,25 @@
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/runtime/backend.hpp"
 #include "ngraph/util.hpp"
+#include "nlohmann/json.hpp"
+#include "seal/he_cost_model.hpp"
+#include "seal/he_performance_counter.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_kernel_registry.hpp"
+#include "seal/he_seal_metrics.hpp"
+#include "seal/he_seal_model_parallel.hpp"
+#include "seal/kernel/dot_diagonal_seal.hpp"
 #include "seal/seal.h"
+#include "seal/seal_ciphertext_spill.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_noise_telemetry.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/shm_transport.hpp"
 #include "tcp/tcp_session.hpp"
+#include "tcp/transport.hpp"
 
 #ifdef NGRAPH_HE_ABY_ENABLE
+#include "aby/aby_cost_model.hpp"
 #include "aby/aby_server_executor.hpp"
 namespace ngraph::runtime::aby {
 class ABYServerExecutor;
@@ -47,6 +66,11 @@ class ABYServerExecutor;
 #endif
 
 namespace ngraph::runtime::he {
+namespace pass {
+class HELevelAnalysis;
+}
+struct ConvolutionIndexTable;
+struct WeightedSums;
 
 /// \brief Class representing a function to execute
 class HESealExecutable : public runtime::Executable {
@@ -66,9 +90,19 @@ class HESealExecutable : public runtime::Executable {
   /// \returns True if setup was successful, false otherwise
   bool server_setup();
 
-  /// \brief Starts the server, which awaits a connection from a client
+  /// \brief Starts the server, which awaits a connection from a client.
+  /// Executables hosted in a model registry start no server of their own
   void start_server();
 
+  /// \brief Serves the sessions routed to the executable by a
+  /// HESealModelRegistry, rather than accepting connections itself. Each
+  /// call then ends its session. Must be called before server_setup
+  void host_in_registry();
+
+  /// \brief Returns whether or not the executable is hosted in a model
+  /// registry, see host_in_registry
+  bool hosted_in_registry() const { return m_hosted_in_registry; }
+
   /// \brief Returns whether or not the client is enabled
   bool enable_client() const { return m_he_seal_backend.enable_client(); }
 
@@ -81,7 +115,9 @@ class HESealExecutable : public runtime::Executable {
 
   /// \brief Calls the executable on the given input tensors.
   /// If the client is enabled, the inputs are dummy values and ignored.
-  /// Instead, the inputs will be provided by the client
+  /// Instead, the inputs will be provided by the client. Packed parameters
+  /// accept any batch size along axis 0, so one compiled executable serves
+  /// each batch size without recompiling, see validate
   /// \param[in] server_inputs Input tensor arguments to the function, provided
   /// by the backend.
   /// \param[out] outputs Output tensors storing the result of
@@ -90,24 +126,120 @@ class HESealExecutable : public runtime::Executable {
             const std::vector<std::shared_ptr<runtime::Tensor>>& server_inputs)
       override;
 
+  /// \brief Serves the requests of a model-parallel coordinator, see
+  /// HESealBackend::model_parallel_stages, until the coordinator's call has
+  /// finished. Each request executes a segment of the nodes on the tensors
+  /// sent by the coordinator, and returns the tensors read after the
+  /// segment. The executable must be compiled with the coordinator's
+  /// configuration, and the client enabled at this server's port
+  void serve_stages();
+
+  /// \brief Runs the function once on inputs of ones, encrypted as the
+  /// parameters are annotated, so the memory pools, the encodings cached at
+  /// each level and the Galois keys are populated before the first call.
+  /// Performance data and noise samples of the run are discarded
+  /// \throws CheckFailure if the client is enabled, whose inputs are not
+  /// available
+  void warmup();
+
   // TOOD
   std::vector<runtime::PerformanceCounter> get_performance_data()
       const override;
 
+  /// \brief Returns the performance counters of each node, along with its
+  /// HE primitive calls, ciphertexts produced, memory usage and client
+  /// communication. Primitives and memory pool allocations are counted
+  /// process-wide, so the counts of nodes executing concurrently, e.g. with
+  /// num_inter_op_threads > 1, include each other's calls. Bytes exchanged
+  /// with the client are counted for client nodes, e.g. Relu, which run one
+  /// at a time
+  std::vector<HEPerformanceCounter> get_he_performance_data() const;
+
+  /// \brief Returns the largest number of bytes of ciphertexts held by live
+  /// tensors after any node, over all calls. Tensors are live from their
+  /// producing node until their last reader, or throughout the call for
+  /// inputs and outputs. Ciphertexts shared between tensors, e.g. by
+  /// Broadcast, are counted once per tensor
+  size_t peak_live_ciphertext_bytes() const;
+
+  /// \brief Returns the node after which peak_live_ciphertext_bytes() was
+  /// reached, or nullptr before the first call
+  std::shared_ptr<const Node> peak_live_ciphertext_node() const;
+
+  /// \brief Returns the counters of get_he_performance_data() as a JSON
+  /// array with one object per node
+  std::string performance_data_json() const;
+
+  /// \brief Estimates the HE primitive calls, rescales, client traffic, peak
+  /// ciphertext memory and latency of a call from the shapes and HE op
+  /// annotations of the nodes, without running the function. Primitive
+  /// costs are taken from the backend's cost calibration. Client
+  /// activations are estimated as without garbled circuits, and include
+  /// the client's encryption of its responses
+  HECostReport estimate_cost() const;
+
+  /// \brief Returns the noise telemetry of each node whose outputs were
+  /// measured, in execution order. Outputs are only measured if the backend
+  /// enables noise telemetry and the client is disabled. The chain index of
+  /// the function outputs is the number of coefficient moduli which could be
+  /// removed from the encryption parameters, and the lowest headroom bounds
+  /// by how many bits the moduli could shrink
+  std::vector<HENoiseReport> get_noise_report() const;
+
+  /// \brief Returns the reports of get_noise_report() as a JSON object, with
+  /// one entry per node and the lowest chain index and headroom
+  std::string noise_report_json() const;
+
+  /// \brief Returns the operational metrics of serving clients, which are
+  /// recorded if the backend sets a metrics port, and served on that port
+  /// once the server starts. Gauges sampled at scrape time, i.e. memory pool
+  /// bytes and awaited ReLU chunks, are only current as of the last scrape
+  const HEMetrics& metrics() const { return m_metrics; }
+
+  /// \brief Returns the name and duration in milliseconds of the last run of
+  /// each compilation pass, in the order the passes first ran. Passes
+  /// updating the annotations rerun when the client's inputs are set.
+  /// Durations are also logged at verbosity 1, and recorded as the
+  /// he_compile_pass_seconds metric
+  const std::vector<std::pair<std::string, double>>& compile_pass_times()
+      const {
+    return m_compile_pass_times;
+  }
+
   // TODO(fboemer): merge _done() methods
 
   /// \brief Returns whether or not the maxpool op has completed
   bool max_pool_done() const { return m_max_pool_done; }
 
-  /// \brief Returns whether or not the session has started
-  bool session_started() const { return m_session_started; }
+  /// \brief Returns whether or not an accepted session is waiting to be
+  /// served
+  bool session_started() const { return !m_pending_sessions.empty(); }
 
   /// \brief Returns whether or not the client has provided input data to call
   /// the function
   bool client_inputs_received() const { return m_client_inputs_received; }
 
+  /// \brief Accepts a client connection. Connections are accepted until
+  /// max_clients() sessions are open
   void accept_connection();
 
+  /// \brief Creates the shared-memory segment of the server, if needed, and
+  /// polls until a client attaches to it, see HESealBackend::shm_transport
+  void accept_shm_connection();
+
+  /// \brief Starts an accepted session and queues it to be served. Sessions
+  /// routed by a model registry are started by the registry
+  /// \param[in] session Session to a client
+  void add_session(std::shared_ptr<ServerTransport> session);
+
+  /// \brief Waits for the longest-waiting session, makes it the current
+  /// session and sends it the encryption parameters
+  void start_next_session();
+
+  /// \brief Closes the current session after its results have been sent,
+  /// and resumes accepting connections if the session limit was reached
+  void end_session();
+
   /// \brief Returns whether or not encryption parameters use complex packing
   bool complex_packing() const {
     return m_he_seal_backend.get_encryption_parameters().complex_packing();
@@ -117,6 +249,15 @@ class HESealExecutable : public runtime::Executable {
 
   HESealBackend& he_seal_backend() { return m_he_seal_backend; }
 
+  /// \brief Checks the tensors of a call against the function, as
+  /// runtime::Executable::validate, except that packed parameters may have
+  /// any batch size along axis 0. All packed inputs must have the same batch
+  /// size, and outputs whose axis 0 is the function's batch size have the
+  /// batch size of the inputs instead
+  /// \throws CheckFailure if the tensors do not match the function
+  void validate(const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+                const std::vector<std::shared_ptr<runtime::Tensor>>& inputs);
+
   /// \brief Checks whether or not the client supports the function
   /// \throws ngraph_error if function is unsupported
   /// Currently, we only support functions with a single client parameter and
@@ -127,29 +268,128 @@ class HESealExecutable : public runtime::Executable {
   /// \param[in] message Message to process
   void handle_message(const TCPMessage& message);
 
+  /// \brief Processes a message of a model-parallel coordinator, which
+  /// either stores a tensor of a segment or requests its execution
+  /// \param[in] message Message to process
+  void handle_stage_message(const TCPMessage& message);
+
   /// \brief Processes a client message with ciphertexts to call the appropriate
   /// function
-  /// \param[in] pb_message Message to process
-  void handle_client_ciphers(const pb::TCPMessage& pb_message);
+  /// \param[in] message Message to process
+  void handle_client_ciphers(const TCPMessage& message);
+
+  /// \brief Uses a client input cached by an earlier inference request of a
+  /// client with the same keys. Requests the client to upload the input if
+  /// it is not cached
+  /// \param[in] name Name of the input tensor
+  /// \param[in] handle Handle of the input chosen by the client
+  void handle_cached_client_input(const std::string& name,
+                                  const std::string& handle);
+
+  /// \brief Returns the index of the parameter a client tensor is sent for,
+  /// or std::nullopt if no parameter matches
+  /// \param[in] tensor_name Tensor name to match against
+  std::optional<size_t> find_client_parameter(
+      const std::string& tensor_name) const;
 
-  /// \brief Sends results to the client
-  void send_client_results();
+  /// \brief Notifies the call waiting on the client inputs once every client
+  /// input is loaded
+  void notify_if_client_inputs_loaded();
+
+  /// \brief Blocks until a client input has loaded a number of elements.
+  /// Client inputs are loaded in order of their elements, so the loaded
+  /// elements form a prefix of the tensor
+  /// \param[in] tensor Tensor to wait for. Tensors which are not client
+  /// inputs are treated as fully loaded
+  /// \param[in] count Number of elements to wait for. Clamped to the number
+  /// of elements in the tensor
+  /// \returns Number of elements of the tensor loaded so far
+  size_t wait_for_client_input(const HETensor& tensor, size_t count);
+
+  /// \brief Sends a result to the client as soon as its Result op runs, so
+  /// the client decrypts it while later results are computed. With
+  /// client_mod_switch, the sent ciphertexts are switched to the lowest
+  /// modulus at which they decrypt correctly, while the tensor keeps its
+  /// modulus for later ops. Pending factors are multiplied into the sent
+  /// ciphertexts, see HESealBackend::lazy_scalar_factors
+  /// \param[in] result_idx Index of the Result op among the results
+  /// \param[in] arg Input tensor of the Result op
+  void send_client_result(size_t result_idx,
+                          const std::shared_ptr<HETensor>& arg);
+
+  /// \brief Waits until every result is written to the client
+  /// \throws ngraph_error if a result was not sent
+  void wait_for_client_results();
 
   /// \brief Sends function's parameter shape to the client
   void send_inference_shape();
 
-  /// \brief Loads the public key from the message
+  /// \brief Returns the request sent by send_inference_shape
+  pb::TCPMessage inference_shape_message() const;
+
+  /// \brief Accepts the inputs a client uploads right after its keys, from
+  /// the inference request it cached, if the request matches and the keys
+  /// are loaded. Otherwise, the inputs are discarded until the client resets
+  /// its upload, and the inference request is sent as usual
+  /// \param[in] request_id Fingerprint of the client's cached request
+  void accept_pipelined_inputs(const std::string& request_id);
+
+  /// \brief Loads the public key from the message. A message with only a
+  /// key id uses the keys cached for that id, or requests the client keys if
+  /// none are cached. Executables hosted in a model registry keep the
+  /// backend's keys if they are the client's, since replicas' calls may be
+  /// using them
   /// \param[in] pb_message from which to load the public key
   void load_public_key(const pb::TCPMessage& pb_message);
 
+  /// \brief Returns whether or not the backend's public key has the given
+  /// fingerprint
+  bool public_key_loaded(const std::string& key_id) const;
+
+  /// \brief Requests the client to upload its public and relinearization
+  /// keys
+  void request_client_keys();
+
   /// \brief Loads the evaluation key from the message
   /// \param[in] pb_message from which to load the evluation key
   void load_eval_key(const pb::TCPMessage& pb_message);
 
+  /// \brief Resets the state exchanged with a client, i.e. the key flags,
+  /// client inputs, compression mode and ReLU pipeline measurements, so the
+  /// compiled function may serve a new client
+  void reset_session_state();
+
+  /// \brief Resets the state of a single inference, i.e. the client inputs
+  /// and results, so a persistent session may serve its next inference with
+  /// the same keys
+  void reset_call_state();
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+  /// \brief Returns the number of values evaluated by garbled circuit Relus
+  size_t num_garbled_circuit_values() const;
+
+  /// \brief Creates the ABY server executor with m_mpc_protocol, and starts
+  /// its offline phase
+  void start_aby_executor();
+
+  /// \brief Sends a probe of the link to the client, which echoes it, for
+  /// the mpc_protocol "auto"
+  /// \param[in] index 0 for an empty probe, timing the round-trip, or 1 for
+  /// a probe padded with s_probe_bytes, timing the bandwidth
+  void send_network_probe(size_t index);
+
+  /// \brief Handles the echo of a probe. After the padded probe, chooses
+  /// m_mpc_protocol by aby::choose_mpc_protocol, starts the ABY executor and
+  /// sends the inference shape
+  /// \param[in] index Index of the echoed probe
+  void handle_network_probe(size_t index);
+#endif
+
   /// \brief Returns whether or not an Op's verbosity is on or off
   /// \param[in] op Operation to determine verbosity of
   bool verbose_op(const Node* node) {
-    if (!node->is_op()) {
+    // Avoids formatting the description of every node of every call
+    if (!node->is_op() || (!m_verbose_all_ops && m_verbose_ops.empty())) {
       return false;
     }
     return verbose_op(std::string(node->description()));
@@ -175,12 +415,232 @@ class HESealExecutable : public runtime::Executable {
   /// \brief Sets verbosity of all operations
   void set_verbose_all_ops(bool value);
 
+  /// \brief Returns the number of OpenMP threads each call uses within ops,
+  /// or 0 for the OpenMP default. Defaults to
+  /// HESealBackend::num_intra_op_threads
+  size_t num_intra_op_threads() const { return m_num_intra_op_threads; }
+
+  /// \brief Sets the number of OpenMP threads each call uses within ops
+  /// \param[in] num_threads Number of threads, or 0 for the OpenMP default
+  void set_num_intra_op_threads(size_t num_threads) {
+    m_num_intra_op_threads = num_threads;
+  }
+
   static OP_TYPEID get_typeid(const NodeTypeInfo& type_info);
 
  private:
   friend class TestHESealExecutable;
 
-  /// \brief Processes the ReLU operation using a client
+  /// \brief If the backend encrypts constants, encrypts the Constant nodes
+  /// annotated as encrypted, so the weights are encrypted once, rather than
+  /// on every call
+  /// \throws ngraph_error if the client is enabled
+  void encrypt_constants();
+
+  /// \brief Converts the values of the plaintext Constant nodes to
+  /// plaintexts once, so calls copy them rather than convert the Constant
+  /// data on every call
+  void materialize_constants();
+
+  /// \brief Starts generating the Galois keys the function needs on a
+  /// background thread, so they are ready by the first call
+  void prepare_galois_keys();
+
+  /// \brief Replaces the backend's encryption parameters by the smallest
+  /// parameters supporting the function's multiplicative depth, keeping the
+  /// configured security level, scale and packing, and logs the estimated
+  /// cost of each encrypted op under the selected parameters
+  void plan_encryption_parameters();
+
+  /// \brief Returns the bits of the prime by which a product of the node's
+  /// inputs with Constant weights is rescaled, i.e. the weight scale bits
+  /// plus the integer bits of the largest weight, or std::nullopt if the
+  /// node does not multiply ciphertexts by Constant weights
+  /// \param[in] node Node consuming one rescale
+  std::optional<int> weight_prime_bits(const Node& node) const;
+
+  /// \brief Returns the bit-width of the prime dropped by each rescale of
+  /// the function. The prime of a rescale is no wider than needed by the
+  /// nodes consuming it, see weight_prime_bits, and at most scale_bits wide
+  /// \param[in] level_analysis Analysis of the depth of each node
+  /// \param[in] scale_bits Bit-width of the scale
+  std::vector<int> level_prime_bits(
+      const pass::HELevelAnalysis& level_analysis, int scale_bits) const;
+
+  /// \brief Logs the cost estimate of the function, and checks it against
+  /// the backend's latency SLO
+  /// \throws ngraph_error if the latency SLO is set and not met
+  void check_cost_estimate() const;
+
+  /// \brief Selects the Convolutions computed on their image packed into the
+  /// slots of one ciphertext when called with batch size 1, and the Dots
+  /// computed on their vector packed likewise, by the diagonal method, see
+  /// HESealBackend::auto_packing_layout. A Convolution or Dot is selected if
+  /// its estimated cost is lower in the slot-packed layout, including the
+  /// layout conversions, and the function leaves a spare coefficient
+  /// modulus for packing its input
+  void select_packing_layouts();
+
+  /// \brief Returns the number of rescales consumed by computing an
+  /// activation node with its configured polynomial approximation, or
+  /// std::nullopt if the node is not an activation approximated by a
+  /// polynomial
+  /// \param[in] node Node of the compiled function
+  std::optional<size_t> polynomial_activation_depth(const Node& node) const;
+
+  /// \brief Returns the number of rescales consumed by computing a node with
+  /// a polynomial on the server, i.e. an approximated activation, an
+  /// approximated Exp, Softmax or Divide by a ciphertext, or Power with a
+  /// constant integer exponent, or std::nullopt otherwise
+  /// \param[in] node Node of the compiled function
+  std::optional<size_t> polynomial_op_depth(const Node& node) const;
+
+  /// \brief Returns whether or not a Dot or Convolution node multiplies by
+  /// its Constant weights as integers, and so is not rescaled, see
+  /// HESealBackend::quantized_weight_step
+  /// \param[in] node Node of the compiled function
+  bool quantized_weights(const Node& node) const;
+
+  /// \brief Returns the estimated bytes of the ciphertexts of a node output,
+  /// at the depth of the level analysis, or 0 if the output is not encrypted
+  /// \param[in] node Node of the compiled function
+  /// \param[in] output_idx Index of the output
+  /// \param[in] level_analysis Levels of the function's encrypted tensors
+  size_t estimated_ciphertext_bytes(
+      const Node& node, size_t output_idx,
+      const pass::HELevelAnalysis& level_analysis) const;
+
+  /// \brief Assigns each tensor in the function a fixed slot, and records for
+  /// each node in m_nodes the slots of its inputs, its outputs, and the
+  /// tensors freed after it executes, so call() does no tensor lookups.
+  /// Intermediate tensors are further assigned to reusable buffers: once a
+  /// tensor is freed, its buffer is handed to the next output with the same
+  /// layout, so ciphertext memory is recycled within and across calls
+  /// \param[in] level_analysis Levels of the function's encrypted tensors
+  void build_execution_plan(const pass::HELevelAnalysis& level_analysis);
+
+  /// \brief Returns the chain index at which the client re-encrypts the
+  /// outputs of a node it computes, i.e. the lowest level supporting the
+  /// rescales until the outputs reach the next client node
+  /// \param[in] node Node computed with the client
+  size_t client_output_chain_index(const Node& node) const;
+
+  /// \brief Returns whether a server input was encrypted by a previous call
+  /// and has not been written to since, so its ciphertexts can be reused
+  /// \param[in] input_idx Index of the parameter
+  /// \param[in] tensor Tensor passed for the parameter
+  bool reuse_encrypted_server_input(size_t input_idx,
+                                    const std::shared_ptr<HETensor>& tensor);
+
+  /// \brief Records a server input encrypted by the current call
+  /// \param[in] input_idx Index of the parameter
+  /// \param[in] tensor Encrypted tensor passed for the parameter
+  void record_encrypted_server_input(size_t input_idx,
+                                     const std::shared_ptr<HETensor>& tensor);
+
+  /// \brief Returns the tensor used for a node output, reusing its planned
+  /// buffer when possible
+  /// \param[in] layout Layout of the output
+  /// \param[in] buffer_idx Planned buffer, or no_buffer
+  /// \param[in] name Name of the tensor, used if a new tensor is created
+  std::shared_ptr<HETensor> acquire_output_tensor(const TensorLayout& layout,
+                                                  size_t buffer_idx,
+                                                  const std::string& name);
+
+  /// \brief Executes a single node, allocating its outputs
+  /// \param[in] node_idx Index of the node in m_nodes
+  /// \param[in,out] tensor_slots Tensors of the current call, indexed by slot
+  void execute_node(size_t node_idx,
+                    std::vector<std::shared_ptr<HETensor>>& tensor_slots);
+
+  /// \brief Executes client nodes of equal NodeSlots::coalesce_key as one
+  /// stream of ReLU requests, so nonlinearities of parallel branches share
+  /// their round-trips. The first node is charged the time, traffic and
+  /// primitives of the group
+  /// \param[in] group Indices of the nodes in m_nodes, whose inputs must be
+  /// computed
+  /// \param[in,out] tensor_slots Tensors of the current call, indexed by slot
+  void execute_client_group(
+      const std::vector<size_t>& group,
+      std::vector<std::shared_ptr<HETensor>>& tensor_slots);
+
+  /// \brief Executes a chain of convolutions, see NodeSlots::tiled_chain, in
+  /// tiles of HESealBackend::conv_tile_rows output rows. Each tile computes
+  /// the intermediate outputs it needs which earlier tiles did not, and
+  /// intermediate ciphertexts are released after their last tile. The first
+  /// node is charged the time and primitives of the chain
+  /// \param[in] chain Indices of the nodes in m_nodes
+  /// \param[in,out] tensor_slots Tensors of the current call, indexed by slot
+  void execute_tiled_chain(
+      const std::vector<size_t>& chain,
+      std::vector<std::shared_ptr<HETensor>>& tensor_slots);
+
+  /// \brief Finds the chains of convolutions executed in tiles, see
+  /// NodeSlots::tiled_chain
+  void plan_tiled_chains();
+
+  /// \brief Executes a layout-only node, e.g. an identity Reshape or a
+  /// Result, by moving its input data to its output instead of copying it.
+  /// Only applies if the node is the sole reader of an intermediate input
+  /// \param[in] op Node to execute
+  /// \param[in] node_slots Slots used by the node
+  /// \param[out] out Output tensors of the node
+  /// \param[in,out] args Input tensors of the node
+  /// \returns Whether or not the node was executed
+  bool forward_input(const Node& op, const NodeSlots& node_slots,
+                     const std::vector<std::shared_ptr<HETensor>>& out,
+                     const std::vector<std::shared_ptr<HETensor>>& args);
+
+  /// \brief Modulus-switches the inputs in node_slots.mod_switch_inputs to
+  /// the level and scale of the node's deepest ciphertext, so the kernel
+  /// needs no per-element matching. Ciphertexts shared between elements are
+  /// switched once. Inputs also read by other nodes are replaced by switched
+  /// copies, so the other nodes keep the higher level
+  /// \param[in] node_slots Slots used by the node
+  /// \param[in,out] args Input tensors of the node
+  void mod_switch_inputs(const NodeSlots& node_slots,
+                         std::vector<std::shared_ptr<HETensor>>& args) const;
+
+  /// \brief Selects an input of an elementwise node, e.g. Add, whose data is
+  /// overwritten by the output, so the kernel runs in place on the input's
+  /// ciphertexts. Only applies if the node is the sole reader of an
+  /// intermediate input of the output's shape
+  /// \param[in] op Node to execute
+  /// \param[in] node_slots Slots used by the node
+  /// \param[in] out Output tensors of the node
+  /// \param[in] args Input tensors of the node
+  /// \returns Index of the input to overwrite, if any
+  std::optional<size_t> in_place_input(
+      const Node& op, const NodeSlots& node_slots,
+      const std::vector<std::shared_ptr<HETensor>>& out,
+      const std::vector<std::shared_ptr<HETensor>>& args) const;
+
+  /// \brief Executes all nodes on a pool of threads. A node is issued once
+  /// all nodes it depends on have completed, and the OpenMP threads are
+  /// divided between the workers. Client round-trips, e.g. for ReLU, overlap
+  /// with the execution of independent nodes
+  /// \param[in,out] tensor_slots Tensors of the current call, indexed by slot
+  /// \param[in] num_threads Number of nodes executed concurrently
+  void execute_nodes_concurrently(
+      std::vector<std::shared_ptr<HETensor>>& tensor_slots,
+      size_t num_threads);
+
+  /// \brief With lazy relinearization, replaces ciphertexts of size 3 by
+  /// new relinearized ciphertexts, so other uses of the ciphertexts are
+  /// unaffected
+  /// \param[in,out] cipher_batch Values to relinearize
+  void relinearize_ciphers(std::vector<HEType>& cipher_batch) const;
+
+  /// \brief Relinearizes ciphertexts to be sent to the client, and if
+  /// enabled, switches them to the lowest level at which they decrypt
+  /// correctly. The client only decrypts these ciphertexts, so the higher
+  /// moduli are not needed. The switched ciphertexts are new, so other uses
+  /// of the ciphertexts are unaffected
+  /// \param[in,out] cipher_batch Values to send to the client
+  void mod_switch_client_ciphers(std::vector<HEType>& cipher_batch) const;
+
+  /// \brief Processes the ReLU operation, or an op of client_elementwise_op,
+  /// using a client
   /// \param[in] arg Tensor argument
   /// \param[out] out Tensor result
   /// \param[in] op Operation to perform
@@ -188,6 +648,215 @@ class HESealExecutable : public runtime::Executable {
                              const std::shared_ptr<HETensor>& out,
                              const Node& op);
 
+  /// \brief Re-encrypts the values of a Refresh op at a higher level using the
+  /// client. The values are masked, so the client only learns them up to
+  /// random offsets
+  /// \param[in] arg Tensor argument
+  /// \param[out] out Tensor result
+  /// \param[in] op Refresh operation
+  void handle_server_refresh_op(const std::shared_ptr<HETensor>& arg,
+                                const std::shared_ptr<HETensor>& out,
+                                const Node& op);
+
+  /// \brief Processes the ConvolutionBiasRelu operation. With the client
+  /// enabled, each output channel is sent for ReLU once it is computed
+  /// \param[in] args Data, filters and bias tensors
+  /// \param[out] out Tensor result
+  /// \param[in] op Operation to perform
+  void handle_server_conv_bias_relu_op(
+      const std::vector<std::shared_ptr<HETensor>>& args,
+      const std::shared_ptr<HETensor>& out, const Node& op);
+
+  /// \brief Returns the index pairs of a Convolution or ConvolutionBiasRelu
+  /// node, computing them on first use. Tables are recomputed if the packed
+  /// shapes of the node's tensors change
+  /// \param[in] node Convolution or ConvolutionBiasRelu node
+  /// \param[in] data_shape Packed shape of the data batch
+  /// \param[in] filters_shape Packed shape of the filters
+  /// \param[in] out_shape Packed shape of the output
+  std::shared_ptr<const ConvolutionIndexTable> convolution_index_table(
+      const Node& node, const Shape& data_shape, const Shape& filters_shape,
+      const Shape& out_shape);
+
+  /// \brief Returns whether or not a node is a Convolution computed by
+  /// pointwise_convolution_seal
+  /// \param[in] node Node to check
+  static bool pointwise_convolution_node(const Node& node);
+
+  /// \brief Returns the filters of a Convolution node transformed by
+  /// winograd_filter_transform, computing them on first use. Returns nullptr
+  /// unless winograd_convolutions is set and the node is a 3x3 Convolution
+  /// with unit strides whose filters are a Constant of real scalar plaintexts
+  /// \param[in] node Node to transform the filters of
+  /// \param[in] filters Tensor of the node's filters
+  std::shared_ptr<const std::vector<HEType>> winograd_filters(
+      const Node& node, const HETensor& filters);
+
+  /// \brief Arguments of the kernels computing a Convolution or
+  /// GroupConvolution node
+  struct ConvolutionKernelArgs {
+    const Node& node;
+    const std::vector<std::shared_ptr<HETensor>>& args;
+    const std::shared_ptr<HETensor>& out;
+    const element::Type& type;
+    bool verbose;
+  };
+
+  /// \brief Registers the kernels computing Convolution and GroupConvolution
+  /// nodes, of which generate_calls selects one per call, see
+  /// HESealBackend::node_kernel
+  void register_convolution_kernels();
+
+  /// \brief Arguments of the kernels computing a Dot node
+  struct DotKernelArgs {
+    const Node& node;
+    const std::vector<std::shared_ptr<HETensor>>& args;
+    const std::shared_ptr<HETensor>& out;
+    const element::Type& type;
+    bool verbose;
+  };
+
+  /// \brief Registers the kernels computing Dot nodes, of which
+  /// generate_calls selects one per call, see HESealBackend::node_kernel
+  void register_dot_kernels();
+
+  /// \brief Returns the calibrated cost of a primitive call on ciphertexts
+  /// at a depth, in microseconds
+  /// \param[in] primitive Called primitive
+  /// \param[in] depth Number of rescales of the ciphertexts
+  double primitive_cost_us(HEPrimitive primitive, size_t depth) const;
+
+  /// \brief Returns the estimated latency of a Convolution in the batch
+  /// layout, in microseconds
+  /// \param[in] node Convolution node
+  /// \param[in] outputs Number of output ciphertexts
+  /// \param[in] input_depth Depth of the input ciphertexts
+  double direct_convolution_us(const Node& node, size_t outputs,
+                               size_t input_depth) const;
+
+  /// \brief Returns the estimated latency of a Convolution of one image in
+  /// the slot-packed layout, in microseconds
+  /// \param[in] node Convolution node
+  /// \param[in] input_depth Depth of the input ciphertexts
+  double slot_packed_convolution_us(const Node& node,
+                                    size_t input_depth) const;
+
+  /// \brief Returns the estimated latency of a Dot in the batch layout, in
+  /// microseconds
+  /// \param[in] node Dot node
+  /// \param[in] input_depth Depth of the input ciphertexts
+  double direct_dot_us(const Node& node, size_t input_depth) const;
+
+  /// \brief Returns the estimated latency of a Dot of one vector in the
+  /// slot-packed layout, in microseconds
+  /// \param[in] node Dot node
+  /// \param[in] input_depth Depth of the input ciphertexts
+  double slot_packed_dot_us(const Node& node, size_t input_depth) const;
+
+  /// \brief Returns the matrix read by dot_diagonal_seal for a Dot of a
+  /// vector of batch size 1 with a Constant matrix, i.e. the transposed
+  /// weights in row-major order. Returns an empty vector if the Dot cannot
+  /// be computed in the slot-packed layout
+  /// \param[in] node Dot node
+  std::vector<double> slot_packed_dot_matrix(const Node& node) const;
+
+  /// \brief Returns the products of a Dot, Convolution or ConvolutionBiasRelu
+  /// node grouped by weight, computing them on first use. Returns nullptr
+  /// unless the weights are a Constant of real scalar plaintexts
+  /// \param[in] node Dot, Convolution or ConvolutionBiasRelu node
+  /// \param[in] weights Tensor of the node's second argument
+  /// \param[in] table Index pairs of a convolution node, or nullptr for Dot
+  /// and pointwise convolutions, see pointwise_convolution_node
+  std::shared_ptr<const WeightedSums> weighted_sums(
+      const Node& node, const HETensor& weights,
+      const std::shared_ptr<const ConvolutionIndexTable>& table);
+
+  /// \brief State of a ReLU whose input values are sent to the client in
+  /// chunks, possibly before all input values are computed
+  struct ReluStream {
+    const Node* node{nullptr};
+    const std::vector<HEType>* data{nullptr};
+    element::Type element_type;
+    bool packed{false};
+    // Number of input values processed by stream_relu_values
+    size_t scanned{0};
+    // Number of unknown input values sent to the client
+    size_t sent{0};
+    // Set once the first unknown value is processed
+    size_t chunk_size{0};
+    size_t window{1};
+  };
+
+  /// \brief Starts a ReLU of the given values, whose results are stored in
+  /// m_relu_data
+  /// \param[in] data ReLU input values, which must outlive the stream
+  /// \param[in] element_type Type of the values
+  /// \param[in] packed Whether or not the values are plaintext packed
+  /// \param[in] op ReLU operation, which determines the client function
+  ReluStream begin_relu_stream(const std::vector<HEType>& data,
+                               const element::Type& element_type,
+                               bool packed, const Node& op);
+
+  /// \brief Computes the ReLU of known values among the input values
+  /// [stream.scanned, end), which must be final, and sends the full chunks
+  /// of unknown values to the client
+  /// \param[in,out] stream ReLU stream
+  /// \param[in] end Index past the last input value to process
+  void stream_relu_values(ReluStream& stream, size_t end);
+
+  /// \brief Sends the unknown values [stream.sent, chunk_end) to the client,
+  /// once fewer than relu_window() chunks await a response
+  /// \param[in,out] stream ReLU stream
+  /// \param[in] chunk_end Index past the last unknown value to send
+  void send_relu_chunk(ReluStream& stream, size_t chunk_end);
+
+  /// \brief Sends a ReLU request for a chunk of ciphertexts
+  /// \param[in] op ReLU operation, which determines the client function
+  /// \param[in] element_type Type of the values
+  /// \param[in] packed Whether or not the values are plaintext packed
+  /// \param[in] cipher_batch Ciphertexts to send
+  /// \param[in] first_unknown_idx Index of the first ciphertext among the
+  /// unknown values of the op, where the client results are stored
+  /// \param[in] num_values Number of unknown values stored by cipher_batch
+  /// \param[in] compaction Number of values packed into each ciphertext,
+  /// see client_compaction
+  void send_relu_request(const Node& op, const element::Type& element_type,
+                         bool packed, std::vector<HEType>& cipher_batch,
+                         size_t first_unknown_idx, size_t num_values,
+                         size_t compaction = 1);
+
+  /// \brief Returns the rotation steps whose Galois keys the client uploads
+  /// to compact ReLU requests or results, or no steps if neither is
+  /// compacted
+  std::set<int> client_compaction_steps() const;
+
+  /// \brief Returns the number of ciphertexts whose batch slots are packed
+  /// into each ciphertext sent to the client, or 1 if the ciphertexts are
+  /// sent unpacked. Ciphertexts are packed if the client uploaded Galois
+  /// keys, they share their parameters and scale, and one level remains
+  /// above the lowest decryptable level
+  /// \param[in] cipher_batch Ciphertexts to send, e.g. ReLU inputs of a
+  /// chunk
+  size_t client_compaction(const std::vector<HEType>& cipher_batch) const;
+
+  /// \brief Packs each group of compaction ciphertexts into one ciphertext,
+  /// see compact_slots_seal
+  /// \param[in,out] cipher_batch Ciphertexts to pack, replaced by the
+  /// packed ciphertexts
+  /// \param[in] compaction Number of ciphertexts per packed ciphertext
+  void compact_client_ciphers(std::vector<HEType>& cipher_batch,
+                              size_t compaction) const;
+
+  /// \brief Unpacks the packed ReLU results received from the client into
+  /// m_relu_data, see expand_slots_seal
+  void expand_relu_results();
+
+  /// \brief Processes and sends any remaining values, waits for the client
+  /// results, and stores them in out_data
+  /// \param[in,out] stream ReLU stream
+  /// \param[out] out_data Result values
+  void finish_relu_stream(ReluStream& stream, std::vector<HEType>& out_data);
+
   /// \brief Processes the MaxPool operation using a client
   /// \param[in] arg Tensor argument
   /// \param[out] out Tensor result
@@ -196,53 +865,549 @@ class HESealExecutable : public runtime::Executable {
                                  const std::shared_ptr<HETensor>& out,
                                  const Node& op);
 
-  /// \brief Processes a client message with ciphertexts after a ReLU function
-  /// \param[in] pb_message Message to process
-  void handle_relu_result(const pb::TCPMessage& pb_message);
+  /// \brief Computes the maximum of windows of a tensor using a client, in
+  /// one round-trip per call, by garbled circuit if enabled
+  /// \param[in] arg Tensor argument
+  /// \param[out] out Tensor result, storing the maximum of each window
+  /// \param[in] node MaxPool or Max node
+  /// \param[in] maximize_lists Indices of arg to maximize for each output
+  /// \param[in] relu Whether to apply ReLU to each maximum. Requires
+  /// garbled circuits
+  void handle_server_max_op(
+      const std::shared_ptr<HETensor>& arg,
+      const std::shared_ptr<HETensor>& out, const Node& node,
+      const std::vector<std::vector<size_t>>& maximize_lists,
+      bool relu = false);
+
+  /// \brief Processes a Convolution of an encrypted image of batch size 1 in
+  /// the slot-packed layout. The image is packed into the slots of one
+  /// ciphertext, convolved by rotations, and unpacked into the batch layout
+  /// \param[in] arg Data batch
+  /// \param[out] out Tensor result
+  /// \param[in] node Convolution node
+  /// \param[in] filter Filter values in row-major order
+  void handle_server_slot_packed_conv_op(const std::shared_ptr<HETensor>& arg,
+                                         const std::shared_ptr<HETensor>& out,
+                                         const Node& node,
+                                         const std::vector<double>& filter);
+
+  /// \brief Processes a Dot of an encrypted vector of batch size 1 in the
+  /// slot-packed layout. The vector is packed into the slots of one
+  /// ciphertext and replicated, multiplied by dot_diagonal_seal, and
+  /// unpacked into the batch layout
+  /// \param[in] arg Vector of shape {1, cols}
+  /// \param[out] out Tensor result
+  /// \param[in] node Dot node
+  /// \param[in] matrix Matrix of shape {rows, cols}, see
+  /// slot_packed_dot_matrix
+  void handle_server_slot_packed_dot_op(const std::shared_ptr<HETensor>& arg,
+                                        const std::shared_ptr<HETensor>& out,
+                                        const Node& node,
+                                        const std::vector<double>& matrix);
+
+  /// \brief Returns the diagonals of a slot-packed Dot's matrix, encoded at
+  /// the level and scale of its packed input. With the plaintext cache, see
+  /// HESealBackend::plaintext_cache, the encodings are kept for later calls
+  /// \param[in] node Dot node
+  /// \param[in] matrix Matrix of shape {rows, cols}, see
+  /// slot_packed_dot_matrix
+  /// \param[in] rows Number of rows of matrix
+  /// \param[in] cols Number of columns of matrix
+  /// \param[in] arg Packed and replicated input of the Dot
+  std::shared_ptr<const EncodedDiagonals> encoded_dot_weights(
+      const Node& node, const std::vector<double>& matrix, size_t rows,
+      size_t cols, const SealCiphertextWrapper& arg);
+
+  /// \brief With a bounded plaintext cache, see
+  /// HESealBackend::plaintext_cache_bytes, starts encoding the weights of
+  /// the slot-packed Dot computed after the given Dot on a background
+  /// thread, if they were evicted. The last Dot prefetches the first for
+  /// the next call
+  /// \param[in] node Slot-packed Dot node about to be computed
+  void prefetch_dot_weights(const Node& node);
+
+  /// \brief Evicts the encoded weights of a computed slot-packed Dot if the
+  /// plaintext cache exceeds its budget
+  /// \param[in] node Slot-packed Dot node
+  void release_dot_weights(const Node& node);
+
+  /// \brief Rescales the result of a node, unless the garbled circuit of the
+  /// Relu using the result rescales it, see HESealBackend::gc_relu_rescale
+  /// \param[in] node Node computing data
+  /// \param[in,out] data Result to rescale
+  /// \param[in] verbose Whether to log rescaling
+  void rescale_output(const Node& node, std::vector<HEType>& data,
+                      bool verbose);
+
+  /// \brief Returns whether or not a node computes with the pending factors
+  /// of its arguments, see HESealBackend::lazy_scalar_factors. Layout ops
+  /// copy them, Multiply folds them into its plaintexts, and Negative and
+  /// Divide by scalar plaintexts scale them
+  /// \param[in] type_id Type of the node
+  /// \param[in] args Inputs of the node
+  bool reads_pending_factors(
+      OP_TYPEID type_id,
+      const std::vector<std::shared_ptr<HETensor>>& args) const;
+
+  /// \brief Returns the inputs of a node, with the pending factors of their
+  /// ciphertexts multiplied in. Inputs with pending factors are replaced by
+  /// copies, since other nodes may read them concurrently
+  /// \param[in] args Inputs of the node
+  std::vector<std::shared_ptr<HETensor>> with_pending_factors_applied(
+      const std::vector<std::shared_ptr<HETensor>>& args);
+
+  /// \brief Returns the number of bits by which the garbled circuit of a
+  /// Relu divides its result, such that the result is at the encoding scale.
+  /// Rescales the ciphertexts if their scale is not a power-of-two multiple
+  /// of the encoding scale
+  /// \param[in,out] cipher_batch Relu arguments
+  size_t gc_relu_truncate_bits(std::vector<HEType>& cipher_batch);
+
+  /// \brief Returns whether a Relu is computed by the client request, or the
+  /// garbled circuit, of the MaxPool using its result. Since Relu commutes
+  /// with Max, the client applies the Relu to each maximum, which saves the
+  /// Relu's round-trip
+  /// \param[in] node Node to check
+  bool client_fused_relu(const Node& node) const;
+
+  /// \brief Returns whether or not the client computes a unary elementwise
+  /// op, e.g. Sigmoid, on its decrypted values, see
+  /// client_elementwise_function. Such ops are streamed to the client in
+  /// chunks like ReLU, unless approximated by a polynomial
+  /// \param[in] node Node to check
+  bool client_elementwise_op(const Node& node) const;
+
+#ifdef NGRAPH_HE_ABY_ENABLE
+  /// \brief Sends all MaxPool windows to the client as a single garbled
+  /// circuit request, and runs the server's side of the circuit
+  /// \param[in] arg Tensor argument, with encrypted data
+  /// \param[in] node MaxPool node
+  /// \param[in] maximize_lists Indices of arg to maximize for each output
+  /// \param[in] relu Whether to apply ReLU to each maximum
+  void send_gc_max_pool_request(
+      const std::shared_ptr<HETensor>& arg, const Node& node,
+      const std::vector<std::vector<size_t>>& maximize_lists, bool relu);
+
+  /// \brief Returns whether a Dot and the Relu using its result are computed
+  /// in ABY arithmetic sharing, if the Dot argument is encrypted and packed.
+  /// See HESealBackend::hybrid_linear_layers
+  /// \param[in] node Node to check
+  bool hybrid_aby_dot(const Node& node) const;
+
+  /// \brief Computes a Dot and the Relu using its result with the client in
+  /// ABY arithmetic sharing
+  /// \param[in] arg Dot argument, with encrypted data
+  /// \param[out] out Dot output, which stores the Relu result
+  /// \param[in] node Dot node
+  void handle_server_aby_dot_relu_op(const std::shared_ptr<HETensor>& arg,
+                                     const std::shared_ptr<HETensor>& out,
+                                     const Node& node);
+#endif
+
+  /// \brief Returns the maximum number of ReLU request chunks awaiting a
+  /// client response. Unless set by the backend, this is tuned from the
+  /// measured round-trip and serialization times of previous chunks
+  size_t relu_window() const;
+
+  /// \brief Processes a client message with ciphertexts after a ReLU
+  /// function. The ciphertexts are deserialized into their slots of
+  /// m_relu_data without holding m_relu_mutex
+  /// \param[in] message Message to process
+  void handle_relu_result(const TCPMessage& message);
 
   /// \brief Processes a client message with ciphertextss after a BoundedReLU
   /// function
-  /// \param[in] pb_message Message to process
-  void handle_bounded_relu_result(const pb::TCPMessage& pb_message);
+  /// \param[in] message Message to process
+  void handle_bounded_relu_result(const TCPMessage& message);
 
   /// \brief Processes a client message with ciphertextss after a MaxPool
   /// function
-  /// \param[in] pb_message Message to process
-  void handle_max_pool_result(const pb::TCPMessage& pb_message);
+  /// \param[in] message Message to process
+  void handle_max_pool_result(const TCPMessage& message);
 
   HESealBackend& m_he_seal_backend;
   bool m_is_compiled{false};
+  // Whether or not the function was only planned, see
+  // HESealBackend::dry_run
+  bool m_dry_run{false};
   bool m_verbose_all_ops{false};
   std::shared_ptr<Function> m_function;
 
   bool m_sent_inference_shape{false};
+  // Ops the client computes on the result, see split_epilogue
+  nlohmann::json m_epilogue = nlohmann::json::array();
+  // Filters of the Convolutions computed in the slot-packed layout, see
+  // select_packing_layouts
+  std::unordered_map<const Node*, std::vector<double>>
+      m_slot_packed_convolutions;
+  // Matrices of the Dots computed in the slot-packed layout, see
+  // select_packing_layouts
+  std::unordered_map<const Node*, std::vector<double>> m_slot_packed_dots;
+  // Encoded diagonals of the slot-packed Dot matrices, see
+  // encoded_dot_weights
+  std::unordered_map<const Node*, std::shared_ptr<const EncodedDiagonals>>
+      m_encoded_dot_weights;
+  size_t m_encoded_dot_weight_bytes{0};
+  // Level, scale and shape of the last input of each slot-packed Dot, at
+  // which its evicted weights are prefetched
+  struct DotInput {
+    seal::parms_id_type parms_id;
+    double scale;
+    size_t rows;
+    size_t cols;
+  };
+  std::unordered_map<const Node*, DotInput> m_dot_inputs;
+  // Weights being encoded on a background thread, see prefetch_dot_weights
+  std::unordered_map<const Node*,
+                     std::future<std::shared_ptr<const EncodedDiagonals>>>
+      m_dot_weight_prefetches;
+  std::mutex m_encoded_dot_weights_mutex;
   bool m_client_public_key_set{false};
   bool m_client_eval_key_set{false};
+  // Galois keys uploaded by the client for client_compaction_steps, or
+  // nullptr
+  std::shared_ptr<seal::GaloisKeys> m_client_galois_keys;
+  // Whether or not the link to the client is being measured, which delays
+  // the inference shape
+  bool m_probing_network{false};
+  // Whether or not client inputs are discarded, since they were uploaded
+  // from a cached inference request which was not accepted
+  bool m_discard_client_inputs{false};
+  // Fingerprint of the client's public key, which scopes its cached inputs.
+  // Only set if client inputs are cached
+  std::string m_client_key_scope;
+  // Whether or not the session's keys were already the backend's, so its
+  // uploaded relinearization keys are not loaded
+  bool m_client_keys_loaded{false};
+  // Ciphertext compression mode accepted by the client
+  seal::compr_mode_type m_compr_mode{seal::compr_mode_type::none};
 
   bool m_server_setup{false};
+  bool m_hosted_in_registry{false};
   size_t m_batch_size;
   size_t m_port;  // Which port the server is hosted at
+  size_t m_num_intra_op_threads{0};
 
 // ABY-related members
 #ifdef NGRAPH_HE_ABY_ENABLE
   std::unique_ptr<aby::ABYServerExecutor> m_aby_executor;
+  // Sharing of m_aby_executor, or "auto" until the first client's link is
+  // measured
+  std::string m_mpc_protocol;
+  std::chrono::steady_clock::time_point m_probe_start;
+  double m_probe_rtt_us{0};
+  inline static const size_t s_probe_bytes{1U << 18U};
+  // Number of fractional bits of Dot weights in arithmetic sharing
+  inline static const size_t s_aby_weight_bits{16};
+  // Relus computed along with their argument, guarded by
+  // m_aby_computed_relus_mutex
+  std::unordered_set<const Node*> m_aby_computed_relus;
+  std::mutex m_aby_computed_relus_mutex;
 #endif
 
   std::unordered_map<std::shared_ptr<const Node>, stopwatch> m_timer_map;
+  std::unordered_map<std::shared_ptr<const Node>, HEOpStats> m_op_stats;
+  // Time the calling thread spent awaiting client responses, in
+  // microseconds. Each node awaits its responses on its executing thread
+  inline static thread_local size_t s_client_wait_us{0};
+
+  /// \brief Adds the time elapsed since wait_start to s_client_wait_us
+  static void record_client_wait(
+      std::chrono::steady_clock::time_point wait_start);
+
+  /// \brief Returns whether operational metrics are recorded, see metrics()
+  bool record_metrics() const { return m_he_seal_backend.metrics_port() != 0; }
+
+  /// \brief Runs a compilation pass, and records its duration, see
+  /// compile_pass_times
+  /// \param[in] name Name of the pass
+  /// \param[in] pass Runs the pass
+  void run_compile_pass(const std::string& name,
+                        const std::function<void()>& pass);
+
+  /// \brief Samples the gauges read at scrape time and returns the metrics
+  /// in the Prometheus text format
+  std::string scrape_metrics();
+
+  /// \brief Records the session gauges. Must hold m_session_mutex
+  void record_session_metrics();
+
+  /// \brief Adds the time elapsed since a start time to the time of a phase
+  /// of calls
+  /// \param[in] phase Label of the phase
+  /// \param[in] start Start time of the phase
+  void record_phase_time(const std::string& phase,
+                         std::chrono::steady_clock::time_point start);
+
+  /// \brief Records the latency of a call and the session traffic since the
+  /// previous call
+  /// \param[in] call_start Start time of the call
+  void record_call_metrics(std::chrono::steady_clock::time_point call_start);
+
+  /// \brief Adds the last execution time of a node to the time of its op
+  /// type
+  void record_op_time(const std::shared_ptr<const Node>& node);
+
+  // Session traffic already added to the metrics
+  size_t m_recorded_bytes_sent{0};
+  size_t m_recorded_bytes_received{0};
+
+  /// \brief Returns whether or not node outputs are measured for noise
+  /// telemetry
+  bool noise_telemetry() const {
+    return m_he_seal_backend.noise_telemetry() && !enable_client();
+  }
+
+  /// \brief Measures a sample of the ciphertexts of a node's outputs, and
+  /// warns once the node's headroom or precision drops below the warning
+  /// thresholds
+  /// \param[in] node Node producing the outputs
+  /// \param[in] outputs Outputs of the node
+  void sample_noise(const std::shared_ptr<const Node>& node,
+                    const std::vector<std::shared_ptr<HETensor>>& outputs);
+
+  // Number of ciphertexts of each tensor measured for noise telemetry
+  inline static const size_t s_noise_samples_per_tensor{4};
+  // Noise telemetry of each node, over all calls
+  std::unordered_map<std::shared_ptr<const Node>, NoiseSample> m_noise_samples;
+  mutable std::mutex m_noise_mutex;
+  // Encrypted weights of Constant nodes, see encrypt_constants
+  std::unordered_map<const Node*, std::vector<HEType>> m_encrypted_constants;
+  // Plaintext values of Constant nodes, see materialize_constants
+  std::unordered_map<const Node*, std::vector<HEPlaintext>>
+      m_plaintext_constants;
+  // Index pairs of convolutions, see convolution_index_table
+  std::unordered_map<const Node*, std::shared_ptr<const ConvolutionIndexTable>>
+      m_convolution_tables;
+  std::mutex m_convolution_tables_mutex;
+  // Products grouped by weight, see weighted_sums. The index table a
+  // convolution's sums were computed from is kept to detect shape changes
+  struct WeightedSumsEntry {
+    std::shared_ptr<const ConvolutionIndexTable> table;
+    std::shared_ptr<const WeightedSums> sums;
+  };
+  std::unordered_map<const Node*, WeightedSumsEntry> m_weighted_sums;
+  // Transformed filters of Winograd convolutions, see winograd_filters.
+  // nullptr if the node is computed directly
+  std::unordered_map<const Node*, std::shared_ptr<const std::vector<HEType>>>
+      m_winograd_filters;
+  HEKernelRegistry<ConvolutionKernelArgs> m_convolution_kernels;
+  HEKernelRegistry<DotKernelArgs> m_dot_kernels;
+  std::mutex m_winograd_filters_mutex;
+  std::mutex m_weighted_sums_mutex;
   std::vector<std::shared_ptr<Node>> m_nodes;
 
+  /// \brief Layout of an intermediate tensor. Tensors with equal layouts may
+  /// share a buffer when their lifetimes do not overlap
+  struct TensorLayout {
+    element::Type element_type;
+    Shape shape;
+    bool packed;
+    bool encrypted;
+
+    bool operator==(const TensorLayout& other) const {
+      return element_type == other.element_type && shape == other.shape &&
+             packed == other.packed && encrypted == other.encrypted;
+    }
+  };
+
+  /// \brief Indicates a tensor which is not stored in a reusable buffer
+  static constexpr size_t no_buffer = std::numeric_limits<size_t>::max();
+
+  /// \brief Tensor slots used by a node in m_nodes
+  struct NodeSlots {
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+    std::vector<size_t> free;
+    /// \brief Buffer index of each output, or no_buffer
+    std::vector<size_t> output_buffers;
+    /// \brief Layout of each output allocated in call()
+    std::vector<TensorLayout> output_layouts;
+    /// \brief Nodes which depend on this node
+    std::vector<size_t> dependents;
+    size_t num_dependencies{0};
+    /// \brief Whether or not the node must not run concurrently
+    bool exclusive{false};
+    /// \brief Whether or not the node is computed with the client. Client
+    /// nodes run one at a time, concurrently with the other nodes
+    bool client{false};
+    /// \brief Whether or not each input is an intermediate tensor read only
+    /// by this node, whose data the node may therefore take
+    std::vector<char> sole_reader;
+    /// \brief Inputs modulus-switched to the level of the deepest input
+    /// before the node executes
+    std::vector<size_t> mod_switch_inputs;
+    /// \brief If not empty, ready client nodes with the same key are
+    /// computed in one request stream, see execute_client_group
+    std::string coalesce_key;
+    /// \brief Type of the node, resolved once so call() does not look it up
+    OP_TYPEID type_id{OP_TYPEID::UnknownOp};
+    /// \brief Element type the kernel computes in, i.e. the type of the
+    /// first input, or of the output for nodes without inputs
+    element::Type base_type;
+    /// \brief Timer of the node in m_timer_map
+    stopwatch* timer{nullptr};
+    /// \brief Counters of the node in m_op_stats
+    HEOpStats* stats{nullptr};
+    /// \brief If not empty, the convolutions starting with this node, each
+    /// reading the output of the previous one, which is read by no other
+    /// node, see execute_tiled_chain
+    std::vector<size_t> tiled_chain;
+  };
+  /// \brief Slots used by each node, indexed as m_nodes
+  std::vector<NodeSlots> m_node_slots;
+  /// \brief Rescales applied to the outputs of each client node before they
+  /// reach the next client node or a Result
+  std::unordered_map<const Node*, size_t> m_client_output_depths;
+  /// \brief Slots of the parameter output tensors, in parameter order
+  std::vector<size_t> m_parameter_slots;
+  /// \brief Slots of the result output tensors, in result order
+  std::vector<size_t> m_result_slots;
+  size_t m_num_tensor_slots{0};
+  /// \brief Number of node inputs reading each slot
+  std::vector<size_t> m_slot_reader_counts;
+  /// \brief Whether or not each slot holds an intermediate tensor
+  std::vector<char> m_intermediate_slots;
+  /// \brief Nodes reading each slot, in execution order
+  std::vector<std::vector<size_t>> m_slot_read_nodes;
+
+  /// \brief Splits the nodes of the execution plan into segments executed
+  /// by the model-parallel stage workers or data-parallel workers, and
+  /// connects to the workers on first use, see
+  /// HESealBackend::model_parallel_stages and data_parallel_workers
+  void plan_model_parallel_stages();
+
+  /// \brief Returns whether or not a node is elementwise, i.e. element i of
+  /// its output only depends on element i of its inputs, which have the
+  /// output's shape
+  /// \param[in] node_idx Index of the node in m_nodes
+  bool elementwise_node(size_t node_idx) const;
+
+  /// \brief Executes a segment on its stage worker, or a sharded segment on
+  /// all data-parallel workers, and stores the tensors they return
+  /// \param[in] segment Segment to execute
+  /// \param[in,out] tensor_slots Tensors of the call
+  void execute_stage_segment(
+      const StageSegment& segment,
+      std::vector<std::shared_ptr<HETensor>>& tensor_slots);
+
+  /// \brief Indicates a node which starts no stage segment
+  static constexpr size_t no_segment = std::numeric_limits<size_t>::max();
+
+  // Connections to the stage workers, in stage order
+  std::vector<std::unique_ptr<HESealStageClient>> m_stage_clients;
+  std::vector<StageSegment> m_stage_segments;
+  // Segment starting at each node, or no_segment, indexed as m_nodes
+  std::vector<size_t> m_node_stage_segments;
+  // Whether or not each node is executed by a stage worker
+  std::vector<char> m_remote_nodes;
+  // Tensors sent by the coordinator to a stage worker, and the requests
+  // awaiting execution, guarded by m_stage_mutex
+  std::vector<std::shared_ptr<HETensor>> m_stage_slots;
+  std::deque<std::string> m_stage_requests;
+  std::mutex m_stage_mutex;
+  std::condition_variable m_stage_cond;
+
+  /// \brief Recounts the ciphertext bytes of the slots a node may have
+  /// changed, i.e. its outputs and the inputs whose data it may take, and
+  /// records the live ciphertext bytes after the node
+  /// \param[in] node Node which executed
+  /// \param[in] node_slots Slots of the node
+  /// \param[in] tensor_slots Tensors of the call
+  /// \param[out] stats Counters of the node to record the live bytes in
+  void update_live_ciphertext_bytes(
+      const std::shared_ptr<const Node>& node, const NodeSlots& node_slots,
+      const std::vector<std::shared_ptr<HETensor>>& tensor_slots,
+      HEOpStats& stats);
+
+  /// \brief Removes the ciphertext bytes of a freed slot from the live bytes
+  void release_slot_bytes(size_t slot);
+
+  /// \brief Sets the ciphertext bytes of a slot whose tensor was spilled or
+  /// restored, see SealCiphertextSpill
+  /// \param[in] slot Slot of the tensor
+  /// \param[in] bytes Ciphertext bytes the tensor now holds in memory
+  void set_slot_bytes(size_t slot, size_t bytes);
+
+  /// \brief Spills intermediate tensors, read again latest first, until the
+  /// live ciphertext bytes are at most HESealBackend::spill_threshold_bytes.
+  /// Tensors read by the next node are kept
+  /// \param[in] next_idx Index in m_nodes of the next node to execute
+  /// \param[in] tensor_slots Tensors of the current call
+  void spill_cold_tensors(
+      size_t next_idx,
+      const std::vector<std::shared_ptr<HETensor>>& tensor_slots);
+
+  /// \brief Restores the spilled inputs of a node
+  /// \param[in] node_idx Index of the node in m_nodes
+  /// \param[in] tensor_slots Tensors of the current call
+  void restore_spilled_inputs(
+      size_t node_idx,
+      const std::vector<std::shared_ptr<HETensor>>& tensor_slots);
+
+  // Disk tier of the sequential executor, keyed by slot, or nullptr if
+  // tensors are not spilled, see HESealBackend::spill_directory
+  std::unique_ptr<SealCiphertextSpill> m_spill;
+
+  // Ciphertext bytes of each slot in the current call, their sum, and the
+  // largest sum over all calls, guarded by m_memory_mutex
+  std::vector<size_t> m_slot_ciphertext_bytes;
+  size_t m_live_ciphertext_bytes{0};
+  size_t m_peak_live_ciphertext_bytes{0};
+  std::shared_ptr<const Node> m_peak_live_ciphertext_node;
+  mutable std::mutex m_memory_mutex;
+
+  /// \brief Intermediate tensors kept alive across calls, indexed by the
+  /// buffer indices in m_node_slots. Empty until first use
+  std::vector<std::pair<TensorLayout, std::shared_ptr<HETensor>>>
+      m_tensor_buffers;
+
   std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+  // Segment awaiting a client, and the timer polling it, if clients
+  // connect over shared memory
+  std::unique_ptr<ShmChannel> m_shm_channel;
+  std::unique_ptr<boost::asio::steady_timer> m_shm_accept_timer;
 
-  // Must be shared, since TCPSession uses enable_shared_from_this()
-  std::shared_ptr<TCPSession> m_session;
-  std::thread m_message_handling_thread;
+  // Must be shared, since sessions use enable_shared_from_this()
+  std::shared_ptr<ServerTransport> m_session;
+  // Sessions accepted, but not yet served, in order of arrival
+  std::deque<std::shared_ptr<ServerTransport>> m_pending_sessions;
+  // Number of sessions accepted and not yet ended, including m_session
+  size_t m_open_sessions{0};
+  bool m_accepting{false};
+  std::vector<std::thread> m_message_handling_threads;
   boost::asio::io_context m_io_context;
+  // Declared after m_io_context, so it is destroyed first
+  std::unique_ptr<HEMetricsServer> m_metrics_server;
+  HEMetrics m_metrics;
+  // Name and duration in milliseconds of each compilation pass
+  std::vector<std::pair<std::string, double>> m_compile_pass_times;
+
+  // Server inputs encrypted by a previous call, by parameter index. The
+  // ciphertexts are reused while the same tensor is passed without being
+  // written to
+  struct EncryptedServerInput {
+    std::weak_ptr<HETensor> tensor;
+    size_t write_count{0};
+  };
+  std::vector<EncryptedServerInput> m_encrypted_server_inputs;
+  std::mutex m_encrypted_server_inputs_mutex;
 
   // (Encrypted) inputs to compiled function
   std::vector<std::shared_ptr<HETensor>> m_client_inputs;
-  // (Encrypted) outputs of compiled function
+  // Number of elements loaded into each client input, guarded by
+  // m_client_inputs_mutex
+  std::vector<size_t> m_client_inputs_loaded;
+  // (Encrypted) outputs of compiled function, by result index. Kept until the
+  // call ends, so their buffers are not overwritten while being written
   std::vector<std::shared_ptr<HETensor>> m_client_outputs;
+  // Serializes the results sent by concurrently executed Result ops
+  std::mutex m_client_outputs_mutex;
+  // Index of each Result op among the function's results
+  std::unordered_map<const Node*, size_t> m_result_indices;
 
+  // Outputs of the current relu stream. Sized before the first request, so
+  // result handlers write their disjoint slots without locking
   std::vector<HEType> m_relu_data;
   std::vector<HEType> m_max_pool_data;
 
@@ -251,32 +1416,77 @@ class HESealExecutable : public runtime::Executable {
   std::shared_ptr<seal::SEALContext> m_context;
 
   // To trigger when relu is done
-  std::mutex m_relu_mutex;
+  mutable std::mutex m_relu_mutex;
   std::condition_variable m_relu_cond;
   size_t m_relu_done_count{0};
+  // Reserved for all values of the stream, so it is not reallocated
   std::vector<size_t> m_unknown_relu_idx;
+  // Index among the unknown values of the first result of each relu request
+  // awaiting a response, by the stream id of the request
+  std::unordered_map<uint64_t, size_t> m_relu_streams;
+  uint64_t m_next_relu_stream_id{1};
+  // Relu requests packing several values into each ciphertext, see
+  // relu_compaction
+  struct ReluCompaction {
+    // Number of unknown values of the request
+    size_t num_values{0};
+    // Number of values per ciphertext, and slots per value
+    size_t compaction{1};
+    size_t batch_size{1};
+  };
+  std::unordered_map<uint64_t, ReluCompaction> m_relu_compactions;
+  // Packed results of compacted relu requests, unpacked once all results are
+  // received
+  struct PackedReluResult {
+    size_t first_unknown_idx{0};
+    size_t num_values{0};
+    size_t batch_size{1};
+    HEType packed{HEPlaintext(), false};
+  };
+  std::vector<PackedReluResult> m_packed_relu_results;
+  // (number of unknown relus sent including the chunk, send time) of the
+  // chunks awaiting a response
+  std::deque<std::pair<size_t, std::chrono::steady_clock::time_point>>
+      m_relu_send_times;
+  // Moving averages used to tune the relu window
+  double m_relu_rtt_ms{0};
+  double m_relu_serialize_ms{0};
+  double m_relu_min_rtt_ms{std::numeric_limits<double>::max()};
+  inline static const size_t s_default_relu_window{4};
+  inline static const size_t s_min_relu_window{2};
+  inline static const size_t s_max_relu_window{64};
+  // Target size in bytes of each result message, and maximum number of
+  // result messages queued at once
+  inline static const size_t s_result_frame_bytes{1UL << 22U};
+  inline static const size_t s_max_pending_result_frames{4};
 
   // To trigger when max_pool is done
   std::mutex m_max_pool_mutex;
   std::condition_variable m_max_pool_cond;
   bool m_max_pool_done{false};
 
-  // To trigger when result message has been written
-  std::mutex m_result_mutex;
-  std::condition_variable m_result_cond;
-
-  // To trigger when session has started
+  // To trigger when a session is accepted
   std::mutex m_session_mutex;
   std::condition_variable m_session_cond;
-  bool m_session_started{false};
 
   // To trigger when client inputs have been received
   std::mutex m_client_inputs_mutex;
   std::condition_variable m_client_inputs_cond;
   bool m_client_inputs_received{false};
+  // Whether or not the client keeps the session open across calls, and
+  // whether or not it ended the session since
+  bool m_persistent_session{false};
+  bool m_session_ended{false};
 
-  void generate_calls(const element::Type& type, const Node& op,
+  /// \brief Computes a node with the kernel of its type
+  /// \param[in] type_id Type of the node
+  /// \param[in] type Element type the kernel computes in
+  /// \param[in] op Node to compute
+  /// \param[in,out] out Outputs of the node
+  /// \param[in] node_args Inputs of the node
+  void generate_calls(OP_TYPEID type_id, const element::Type& type,
+                      const Node& op,
                       const std::vector<std::shared_ptr<HETensor>>& out,
-                      const std::vector<std::shared_ptr<HETensor>>& args);
+                      const std::vector<std::shared_ptr<HETensor>>& node_args);
 };
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,109 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Implementations of an op, of which the applicable one of lowest
+/// estimated cost is selected for each node. Ties are broken in order of
+/// registration
+/// \tparam Args Arguments of the op's kernels, e.g. the node and its tensors
+template <typename Args>
+class HEKernelRegistry {
+ public:
+  /// \brief Implementation of an op
+  struct Kernel {
+    /// \brief Name of the kernel, e.g. "winograd", by which a node's
+    /// configuration selects the kernel
+    std::string name;
+    /// \brief Returns whether or not the kernel computes the arguments
+    std::function<bool(const Args&)> applicable;
+    /// \brief Returns the estimated latency of the kernel on the arguments,
+    /// in microseconds. Only called if the kernel is applicable
+    std::function<double(const Args&)> cost_us;
+    /// \brief Computes the op on the arguments
+    std::function<void(const Args&)> run;
+  };
+
+  /// \brief Registers a kernel
+  /// \throws ngraph_error if a kernel of the same name is registered
+  void add(Kernel kernel) {
+    NGRAPH_CHECK(find(kernel.name) == nullptr, "Kernel ", kernel.name,
+                 " is already registered");
+    m_kernels.emplace_back(std::move(kernel));
+  }
+
+  /// \brief Selects the kernel computing the arguments
+  /// \param[in] args Arguments of the kernel
+  /// \param[in] name Name of the kernel to select, or empty to select the
+  /// applicable kernel of lowest estimated cost
+  /// \throws ngraph_error if the named kernel is not registered or not
+  /// applicable, or no kernel is applicable
+  const Kernel& select(const Args& args, const std::string& name = "") const {
+    if (!name.empty()) {
+      const Kernel* kernel = find(name);
+      NGRAPH_CHECK(kernel != nullptr, "No kernel ", name, " is registered");
+      NGRAPH_CHECK(kernel->applicable(args), "Kernel ", name,
+                   " is not applicable");
+      return *kernel;
+    }
+    const Kernel* selected = nullptr;
+    double selected_cost = 0;
+    for (const auto& kernel : m_kernels) {
+      if (!kernel.applicable(args)) {
+        continue;
+      }
+      double cost = kernel.cost_us(args);
+      if (selected == nullptr || cost < selected_cost) {
+        selected = &kernel;
+        selected_cost = cost;
+      }
+    }
+    NGRAPH_CHECK(selected != nullptr, "No kernel is applicable");
+    return *selected;
+  }
+
+  /// \brief Returns the names of the kernels, in order of registration
+  std::vector<std::string> names() const {
+    std::vector<std::string> kernel_names;
+    kernel_names.reserve(m_kernels.size());
+    for (const auto& kernel : m_kernels) {
+      kernel_names.emplace_back(kernel.name);
+    }
+    return kernel_names;
+  }
+
+ private:
+  const Kernel* find(const std::string& name) const {
+    auto it = std::find_if(
+        m_kernels.begin(), m_kernels.end(),
+        [&name](const Kernel& kernel) { return kernel.name == name; });
+    return it == m_kernels.end() ? nullptr : &*it;
+  }
+
+  std::vector<Kernel> m_kernels;
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,122 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_mapped_input.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+
+namespace ngraph::runtime::he {
+
+HESealMappedInput::HESealMappedInput(const std::string& filename,
+                                     std::string config,
+                                     const element::Type& element_type,
+                                     size_t offset, size_t num_elements) {
+  NGRAPH_CHECK(element_type == element::f32 || element_type == element::f64 ||
+                   element_type == element::i64,
+               "Mapped inputs of type ", element_type, " not supported");
+  size_t element_size = element_type.size();
+  NGRAPH_CHECK(offset % element_size == 0, "Offset ", offset,
+               " is not a multiple of the element size ", element_size);
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw ngraph_error("Failed to open input file " + filename);
+  }
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) != 0) {
+    ::close(fd);
+    throw ngraph_error("Failed to stat input file " + filename);
+  }
+  auto file_bytes = static_cast<size_t>(file_stat.st_size);
+  if (offset > file_bytes) {
+    ::close(fd);
+    throw ngraph_error("Offset beyond the end of input file " + filename);
+  }
+  if (num_elements == 0) {
+    num_elements = (file_bytes - offset) / element_size;
+  }
+  size_t num_bytes = num_elements * element_size;
+  if (num_bytes > file_bytes - offset) {
+    ::close(fd);
+    throw ngraph_error("Input file " + filename + " holds fewer than " +
+                       std::to_string(num_elements) + " elements");
+  }
+
+  m_view.config = std::move(config);
+  m_view.element_type = element_type;
+  m_view.num_elements = num_elements;
+  if (num_bytes == 0) {
+    ::close(fd);
+    return;
+  }
+
+  // mmap offsets are multiples of the page size
+  auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t page_offset = offset - offset % page_size;
+  m_mapped_bytes = num_bytes + offset - page_offset;
+  void* addr = ::mmap(nullptr, m_mapped_bytes, PROT_READ, MAP_PRIVATE, fd,
+                      static_cast<off_t>(page_offset));
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    m_mapped_bytes = 0;
+    throw ngraph_error("Failed to map input file " + filename);
+  }
+  m_addr = addr;
+  // Chunks are encrypted in order, so pages are read ahead, and may be
+  // reclaimed soon after they are read
+  ::madvise(m_addr, m_mapped_bytes, MADV_SEQUENTIAL);
+  m_view.data = static_cast<const std::byte*>(m_addr) + (offset - page_offset);
+  NGRAPH_HE_LOG(3) << "Mapped " << num_elements << " input elements from "
+                   << filename;
+}
+
+HESealMappedInput::~HESealMappedInput() { unmap(); }
+
+HESealMappedInput::HESealMappedInput(HESealMappedInput&& other) noexcept
+    : m_addr(std::exchange(other.m_addr, nullptr)),
+      m_mapped_bytes(std::exchange(other.m_mapped_bytes, 0)),
+      m_view(std::exchange(other.m_view, HEInputView{})) {}
+
+HESealMappedInput& HESealMappedInput::operator=(
+    HESealMappedInput&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    m_addr = std::exchange(other.m_addr, nullptr);
+    m_mapped_bytes = std::exchange(other.m_mapped_bytes, 0);
+    m_view = std::exchange(other.m_view, HEInputView{});
+  }
+  return *this;
+}
+
+void HESealMappedInput::unmap() {
+  if (m_addr != nullptr) {
+    ::munmap(m_addr, m_mapped_bytes);
+    m_addr = nullptr;
+    m_mapped_bytes = 0;
+  }
+}
+
+}  // namespace ngraph::runtime::he
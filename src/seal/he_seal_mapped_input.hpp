@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_client.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Memory-maps a region of a file as a client input, e.g. a batch of
+/// preprocessed images. The client encrypts and uploads the input in chunks
+/// read from the mapping, see HESealClient::upload_input, so the input is
+/// never copied in memory, and its pages may be reclaimed once sent
+class HESealMappedInput {
+ public:
+  /// \brief Maps the elements of a file region
+  /// \param[in] filename File storing the elements in row-major order,
+  /// including the batch axis, with native byte order
+  /// \param[in] config Configuration of the input, see HEInputView::config
+  /// \param[in] element_type Type of the elements, f32, f64 or i64
+  /// \param[in] offset Offset of the first element in bytes, a multiple of
+  /// the element size
+  /// \param[in] num_elements Number of elements to map, or 0 to map the
+  /// elements up to the end of the file
+  /// \throws ngraph_error if the file cannot be mapped
+  HESealMappedInput(const std::string& filename, std::string config,
+                    const element::Type& element_type, size_t offset = 0,
+                    size_t num_elements = 0);
+
+  ~HESealMappedInput();
+
+  HESealMappedInput(const HESealMappedInput&) = delete;
+  HESealMappedInput& operator=(const HESealMappedInput&) = delete;
+  HESealMappedInput(HESealMappedInput&& other) noexcept;
+  HESealMappedInput& operator=(HESealMappedInput&& other) noexcept;
+
+  /// \brief Returns a view of the mapped elements, valid for the lifetime of
+  /// the mapping
+  const HEInputView& view() const { return m_view; }
+
+ private:
+  void unmap();
+
+  // Page-aligned start and size of the mapping, which starts up to a page
+  // before the first element
+  void* m_addr{nullptr};
+  size_t m_mapped_bytes{0};
+  HEInputView m_view;
+};
+
+}  // namespace ngraph::runtime::he
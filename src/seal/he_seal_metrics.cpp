@@ -0,0 +1,296 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+// 15 significant digits print integral byte counts exactly and bucket
+// bounds without rounding artifacts
+std::string format_value(double value) {
+  std::ostringstream ss;
+  ss.precision(15);
+  ss << value;
+  return ss.str();
+}
+
+std::string escape_label_value(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string format_labels(const HEMetrics::Labels& labels) {
+  std::string formatted;
+  for (const auto& [name, value] : labels) {
+    if (!formatted.empty()) {
+      formatted += ',';
+    }
+    formatted += name + "=\"" + escape_label_value(value) + "\"";
+  }
+  return formatted;
+}
+
+// Returns the label set of a sample with an additional label
+std::string braced_labels(const std::string& labels,
+                          const std::string& extra = "") {
+  std::string all = labels;
+  if (!extra.empty()) {
+    all += (all.empty() ? "" : ",") + extra;
+  }
+  return all.empty() ? "" : "{" + all + "}";
+}
+
+// Scrape requests are a request line and a few headers, so longer headers
+// are rejected rather than buffered
+constexpr size_t s_max_request_bytes = 8192;
+
+/// \brief Answers one HTTP request of a connection
+class MetricsConnection
+    : public std::enable_shared_from_this<MetricsConnection> {
+ public:
+  MetricsConnection(boost::asio::ip::tcp::socket socket,
+                    std::function<std::string()> render)
+      : m_socket(std::move(socket)),
+        m_deadline(m_socket.get_executor()),
+        m_render(std::move(render)),
+        m_request(s_max_request_bytes) {}
+
+  /// \brief Reads the request, and closes the connection once the timeout
+  /// has passed
+  void start(std::chrono::milliseconds timeout) {
+    auto self = shared_from_this();
+    m_deadline.expires_after(timeout);
+    m_deadline.async_wait([this, self](boost::system::error_code ec) {
+      if (ec != boost::asio::error::operation_aborted) {
+        NGRAPH_HE_LOG(3) << "Metrics connection timed out";
+        close();
+      }
+    });
+    boost::asio::async_read_until(
+        m_socket, m_request, "\r\n\r\n",
+        [this, self](boost::system::error_code ec, size_t /* length */) {
+          if (!ec) {
+            respond();
+          } else if (ec == boost::asio::error::not_found) {
+            write_response("431 Request Header Fields Too Large", "");
+          } else {
+            if (ec != boost::asio::error::operation_aborted &&
+                ec != boost::asio::error::eof) {
+              NGRAPH_HE_LOG(3)
+                  << "Error reading metrics request " << ec.message();
+            }
+            close();
+          }
+        });
+  }
+
+ private:
+  void respond() {
+    std::istream request_stream(&m_request);
+    std::string method;
+    std::string target;
+    request_stream >> method >> target;
+
+    if (method != "GET") {
+      write_response("405 Method Not Allowed", "");
+    } else if (target != "/metrics") {
+      write_response("404 Not Found", "");
+    } else {
+      write_response("200 OK", m_render());
+    }
+  }
+
+  void write_response(const std::string& status, const std::string& body) {
+    m_response = "HTTP/1.1 " + status +
+                 "\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                 "Content-Length: " +
+                 std::to_string(body.size()) +
+                 "\r\nConnection: close\r\n\r\n" + body;
+
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        m_socket, boost::asio::buffer(m_response),
+        [this, self](boost::system::error_code /* ec */,
+                     size_t /* length */) { close(); });
+  }
+
+  // Closing the socket aborts a pending read or write, and cancelling the
+  // deadline releases the io_context
+  void close() {
+    boost::system::error_code ignored;
+    m_deadline.cancel();
+    m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+    m_socket.close(ignored);
+  }
+
+  boost::asio::ip::tcp::socket m_socket;
+  boost::asio::steady_timer m_deadline;
+  std::function<std::string()> m_render;
+  boost::asio::streambuf m_request;
+  std::string m_response;
+};
+}  // namespace
+
+HEMetrics::Sample& HEMetrics::sample(const std::string& name,
+                                     const std::string& help, MetricType type,
+                                     const Labels& labels) {
+  auto [family_it, inserted] = m_families.try_emplace(name);
+  Family& family = family_it->second;
+  if (inserted) {
+    family.type = type;
+    family.help = help;
+  }
+  NGRAPH_CHECK(family.type == type, "Metric ", name,
+               " already registered with another type");
+  return family.samples[format_labels(labels)];
+}
+
+void HEMetrics::add_counter(const std::string& name, const std::string& help,
+                            double value, const Labels& labels) {
+  NGRAPH_CHECK(value >= 0, "Counter ", name, " cannot decrease");
+  std::lock_guard<std::mutex> guard(m_mutex);
+  sample(name, help, MetricType::counter, labels).value += value;
+}
+
+void HEMetrics::set_gauge(const std::string& name, const std::string& help,
+                          double value, const Labels& labels) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  sample(name, help, MetricType::gauge, labels).value = value;
+}
+
+void HEMetrics::observe(const std::string& name, const std::string& help,
+                        double value, const std::vector<double>& bounds,
+                        const Labels& labels) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  Sample& histogram = sample(name, help, MetricType::histogram, labels);
+  if (histogram.bucket_counts.empty()) {
+    NGRAPH_CHECK(std::is_sorted(bounds.begin(), bounds.end()),
+                 "Bucket bounds of ", name, " must be increasing");
+    histogram.bounds = bounds;
+    histogram.bucket_counts.assign(bounds.size(), 0);
+  }
+  // Buckets count observations up to their inclusive bound, and are made
+  // cumulative when rendered
+  auto bucket = std::lower_bound(histogram.bounds.begin(),
+                                 histogram.bounds.end(), value);
+  if (bucket != histogram.bounds.end()) {
+    histogram.bucket_counts[bucket - histogram.bounds.begin()]++;
+  }
+  histogram.sum += value;
+  histogram.count++;
+}
+
+std::string HEMetrics::to_prometheus_text() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  std::ostringstream ss;
+  for (const auto& [name, family] : m_families) {
+    static const char* type_names[] = {"counter", "gauge", "histogram"};
+    ss << "# HELP " << name << " " << family.help << "\n";
+    ss << "# TYPE " << name << " "
+       << type_names[static_cast<size_t>(family.type)] << "\n";
+    for (const auto& [labels, sample] : family.samples) {
+      if (family.type != MetricType::histogram) {
+        ss << name << braced_labels(labels) << " " << format_value(sample.value)
+           << "\n";
+        continue;
+      }
+      size_t cumulative_count = 0;
+      for (size_t i = 0; i < sample.bounds.size(); ++i) {
+        cumulative_count += sample.bucket_counts[i];
+        ss << name << "_bucket"
+           << braced_labels(labels,
+                            "le=\"" + format_value(sample.bounds[i]) + "\"")
+           << " " << cumulative_count << "\n";
+      }
+      ss << name << "_bucket" << braced_labels(labels, "le=\"+Inf\"") << " "
+         << sample.count << "\n";
+      ss << name << "_sum" << braced_labels(labels) << " "
+         << format_value(sample.sum) << "\n";
+      ss << name << "_count" << braced_labels(labels) << " " << sample.count
+         << "\n";
+    }
+  }
+  return ss.str();
+}
+
+HEMetricsServer::HEMetricsServer(boost::asio::io_context& io_context,
+                                 const std::string& address, size_t port,
+                                 std::function<std::string()> render,
+                                 std::chrono::milliseconds request_timeout)
+    : m_acceptor(io_context),
+      m_render(std::move(render)),
+      m_request_timeout(request_timeout) {
+  boost::system::error_code ec;
+  auto ip_address = boost::asio::ip::make_address(address, ec);
+  NGRAPH_CHECK(!ec, "Invalid metrics address ", address, ": ", ec.message());
+  boost::asio::ip::tcp::endpoint endpoint(ip_address, port);
+  m_acceptor.open(endpoint.protocol());
+  m_acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+  m_acceptor.bind(endpoint);
+  m_acceptor.listen();
+  NGRAPH_HE_LOG(1) << "Serving metrics on " << address << ":" << this->port();
+  accept();
+}
+
+void HEMetricsServer::close() {
+  boost::system::error_code ec;
+  m_acceptor.close(ec);
+  if (ec) {
+    NGRAPH_ERR << "Error closing metrics acceptor " << ec.message();
+  }
+}
+
+void HEMetricsServer::accept() {
+  m_acceptor.async_accept([this](boost::system::error_code ec,
+                                 boost::asio::ip::tcp::socket socket) {
+    if (ec == boost::asio::error::operation_aborted) {
+      NGRAPH_HE_LOG(1) << "Metrics server stopped accepting connections";
+      return;
+    }
+    if (!ec) {
+      std::make_shared<MetricsConnection>(std::move(socket), m_render)
+          ->start(m_request_timeout);
+    } else {
+      NGRAPH_ERR << "Error accepting metrics connection " << ec.message();
+    }
+    accept();
+  });
+}
+
+}  // namespace ngraph::runtime::he
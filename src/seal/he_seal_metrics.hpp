@@ -0,0 +1,135 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/asio.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Upper bounds of the default latency histogram buckets, in seconds
+inline const std::vector<double> s_default_latency_buckets{
+    0.001, 0.005, 0.01, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30, 60, 120};
+
+/// \brief Registry of counters, gauges and histograms of a serving process,
+/// rendered in the Prometheus text exposition format. All methods are
+/// thread-safe.
+class HEMetrics {
+ public:
+  /// \brief Label names and values of a metric
+  using Labels = std::vector<std::pair<std::string, std::string>>;
+
+  /// \brief Adds to a counter, creating it at 0 if needed
+  /// \param[in] name Name of the metric
+  /// \param[in] help Description of the metric
+  /// \param[in] value Non-negative amount to add
+  /// \param[in] labels Labels of the counter
+  void add_counter(const std::string& name, const std::string& help,
+                   double value, const Labels& labels = {});
+
+  /// \brief Sets a gauge
+  /// \param[in] name Name of the metric
+  /// \param[in] help Description of the metric
+  /// \param[in] value Value of the gauge
+  /// \param[in] labels Labels of the gauge
+  void set_gauge(const std::string& name, const std::string& help,
+                 double value, const Labels& labels = {});
+
+  /// \brief Records an observation in a histogram
+  /// \param[in] name Name of the metric
+  /// \param[in] help Description of the metric
+  /// \param[in] value Observed value
+  /// \param[in] bounds Increasing upper bounds of the buckets, used when the
+  /// histogram is created
+  /// \param[in] labels Labels of the histogram
+  void observe(const std::string& name, const std::string& help,
+               double value,
+               const std::vector<double>& bounds = s_default_latency_buckets,
+               const Labels& labels = {});
+
+  /// \brief Returns the metrics in the Prometheus text exposition format
+  std::string to_prometheus_text() const;
+
+ private:
+  enum class MetricType { counter, gauge, histogram };
+
+  struct Sample {
+    double value{0};
+    std::vector<double> bounds;
+    std::vector<size_t> bucket_counts;
+    double sum{0};
+    size_t count{0};
+  };
+
+  struct Family {
+    MetricType type;
+    std::string help;
+    // Samples by their formatted labels
+    std::map<std::string, Sample> samples;
+  };
+
+  Sample& sample(const std::string& name, const std::string& help,
+                 MetricType type, const Labels& labels);
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, Family> m_families;
+};
+
+/// \brief HTTP endpoint answering "GET /metrics" with the Prometheus text of
+/// a metrics callback. Connections are handled on the given io_context, one
+/// request per connection. Requests with headers over 8 KiB are rejected,
+/// and connections are closed once the request timeout has passed, so
+/// scrapers cannot hold memory or connections of the io_context
+class HEMetricsServer {
+ public:
+  /// \brief Starts accepting scrapes
+  /// \param[in] io_context Runs the connection handlers
+  /// \param[in] address IP address to listen on, e.g. "127.0.0.1"
+  /// \param[in] port Port to listen on
+  /// \param[in] render Returns the metrics text of a scrape
+  /// \param[in] request_timeout Time after which an accepted connection is
+  /// closed, whether or not it was answered
+  /// \throws ngraph_error if the address is invalid
+  HEMetricsServer(
+      boost::asio::io_context& io_context, const std::string& address,
+      size_t port, std::function<std::string()> render,
+      std::chrono::milliseconds request_timeout = std::chrono::seconds(10));
+
+  /// \brief Stops accepting scrapes, so the io_context may run out of work.
+  /// Must be called from a handler of the io_context
+  void close();
+
+  /// \brief Returns the port the server listens on
+  size_t port() const { return m_acceptor.local_endpoint().port(); }
+
+ private:
+  void accept();
+
+  boost::asio::ip::tcp::acceptor m_acceptor;
+  std::function<std::string()> m_render;
+  std::chrono::milliseconds m_request_timeout;
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,238 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_model_parallel.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "nlohmann/json.hpp"
+#include "seal/he_seal_backend.hpp"
+
+using json = nlohmann::json;
+
+namespace ngraph::runtime::he {
+
+std::vector<size_t> partition_stages(const std::vector<double>& costs,
+                                     size_t num_stages) {
+  NGRAPH_CHECK(num_stages > 0, "Cannot partition nodes into 0 stages");
+  double total_cost = std::accumulate(costs.begin(), costs.end(), 0.0);
+  std::vector<size_t> stages(costs.size(), 0);
+  if (total_cost <= 0) {
+    return stages;
+  }
+
+  // Each node belongs to the stage containing the midpoint of its cost
+  double cumulative_cost = 0;
+  size_t stage = 0;
+  for (size_t node_idx = 0; node_idx < costs.size(); ++node_idx) {
+    if (costs[node_idx] > 0) {
+      double midpoint = cumulative_cost + costs[node_idx] / 2;
+      auto midpoint_stage = static_cast<size_t>(
+          midpoint * static_cast<double>(num_stages) / total_cost);
+      stage = std::max(stage, std::min(midpoint_stage, num_stages - 1));
+      cumulative_cost += costs[node_idx];
+    }
+    stages[node_idx] = stage;
+  }
+  return stages;
+}
+
+HESealStageClient::HESealStageClient(const std::string& hostname, size_t port,
+                                     HESealBackend& he_seal_backend)
+    : m_he_seal_backend(he_seal_backend) {
+  boost::asio::ip::tcp::resolver resolver(m_io_context);
+  auto endpoints = resolver.resolve(hostname, std::to_string(port));
+  m_tcp_client = std::make_unique<TCPClient>(
+      m_io_context, endpoints,
+      [this](const TCPMessage& message) { handle_message(message); });
+  m_io_thread = std::thread([this]() {
+    try {
+      m_io_context.run();
+    } catch (std::exception& e) {
+      NGRAPH_ERR << "Stage client error handling thread: " << e.what();
+    }
+  });
+  NGRAPH_HE_LOG(1) << "Connecting to stage worker at " << hostname << ":"
+                   << port;
+}
+
+HESealStageClient::~HESealStageClient() {
+  try {
+    m_tcp_client->close();
+  } catch (std::exception& e) {
+    NGRAPH_ERR << "Exception closing stage client " << e.what();
+  }
+  if (m_io_thread.joinable()) {
+    m_io_thread.join();
+  }
+}
+
+void HESealStageClient::write_message(TCPMessage&& message) {
+  boost::asio::post(m_io_context, [this, message = std::move(message)]() {
+    m_tcp_client->write_message(TCPMessage(message));
+  });
+}
+
+void HESealStageClient::send_keys() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this]() { return m_connected; });
+  }
+  NGRAPH_CHECK(m_he_seal_backend.get_public_key() != nullptr,
+               "Coordinator has no public key to send to stage worker");
+
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_RESPONSE);
+  std::stringstream pk_stream;
+  m_he_seal_backend.get_public_key()->save(pk_stream);
+  pb_message.mutable_public_key()->set_public_key(pk_stream.str());
+  if (m_he_seal_backend.get_relin_keys() != nullptr) {
+    std::stringstream evk_stream;
+    m_he_seal_backend.get_relin_keys()->save(evk_stream);
+    pb_message.mutable_eval_key()->set_eval_key(evk_stream.str());
+  }
+  NGRAPH_HE_LOG(3) << "Sending client keys to stage worker";
+  write_message(TCPMessage(std::move(pb_message)));
+}
+
+std::unordered_map<size_t, std::shared_ptr<HETensor>>
+HESealStageClient::execute(
+    const StageSegment& segment,
+    const std::vector<std::shared_ptr<HETensor>>& tensor_slots,
+    size_t batch_size, std::optional<std::pair<size_t, size_t>> elements) {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_segment_done = false;
+    m_outputs.clear();
+  }
+
+  for (size_t slot : segment.input_slots) {
+    NGRAPH_CHECK(tensor_slots[slot] != nullptr, "Stage input slot ", slot,
+                 " not computed");
+    auto write_tensor = [this, slot](pb::HETensor&& pb_tensor,
+                                     TCPMessage::Segments&& segments) {
+      pb::TCPMessage pb_message;
+      pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+      json js = {{"function", "StageTensor"}, {"slot", slot}};
+      pb_message.mutable_function()->set_function(js.dump());
+      *pb_message.add_he_tensors() = std::move(pb_tensor);
+      write_message(TCPMessage(std::move(pb_message), std::move(segments)));
+    };
+    if (elements.has_value()) {
+      std::vector<TCPMessage::Segments> tensor_segments;
+      auto pb_tensors = tensor_slots[slot]->write_elements_to_pb_tensors(
+          elements->first, elements->second, &tensor_segments,
+          m_he_seal_backend.compr_mode());
+      for (size_t i = 0; i < pb_tensors.size(); ++i) {
+        write_tensor(std::move(pb_tensors[i]), std::move(tensor_segments[i]));
+      }
+    } else {
+      tensor_slots[slot]->write_to_pb_tensor_frames(
+          s_frame_bytes, write_tensor, m_he_seal_backend.compr_mode());
+    }
+  }
+
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+  json js = {{"function", "Stage"},
+             {"nodes", segment.nodes},
+             {"outputs", segment.output_slots},
+             {"batch_size", batch_size}};
+  if (elements.has_value()) {
+    js["begin"] = elements->first;
+    js["end"] = elements->second;
+  }
+  pb_message.mutable_function()->set_function(js.dump());
+  NGRAPH_HE_LOG(3) << "Sending " << segment.nodes.size()
+                   << " nodes to stage worker " << segment.stage;
+  write_message(TCPMessage(std::move(pb_message)));
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cond.wait(lock, [this]() { return m_segment_done; });
+  for (size_t slot : segment.output_slots) {
+    NGRAPH_CHECK(m_outputs.find(slot) != m_outputs.end(),
+                 "Stage worker did not return slot ", slot);
+  }
+  return std::move(m_outputs);
+}
+
+void HESealStageClient::end_call() {
+  pb::TCPMessage pb_message;
+  pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+  json js = {{"function", "StageEnd"}};
+  pb_message.mutable_function()->set_function(js.dump());
+  write_message(TCPMessage(std::move(pb_message)));
+}
+
+void HESealStageClient::handle_message(const TCPMessage& message) {
+  const pb::TCPMessage& pb_message = *message.pb_message();
+  if (pb_message.has_encryption_parameters()) {
+    NGRAPH_HE_LOG(3) << "Stage worker connected";
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_connected = true;
+    m_cond.notify_all();
+    return;
+  }
+  // Other requests of the worker, e.g. for the inference shape, are meant
+  // for clients
+  if (pb_message.type() != pb::TCPMessage_Type_RESPONSE ||
+      !pb_message.has_function()) {
+    return;
+  }
+
+  json js = json::parse(pb_message.function().function());
+  std::string name = js.at("function");
+  if (name == "StageTensor") {
+    NGRAPH_CHECK(pb_message.he_tensors_size() == 1,
+                 "Stage tensor message must store 1 tensor");
+    size_t slot = js.at("slot");
+    std::shared_ptr<HETensor> tensor;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      tensor = m_outputs[slot];
+    }
+    if (tensor == nullptr) {
+      tensor = HETensor::load_from_pb_tensor(
+          pb_message.he_tensors(0), *m_he_seal_backend.get_ckks_encoder(),
+          m_he_seal_backend.get_context(), *m_he_seal_backend.get_encryptor(),
+          *m_he_seal_backend.get_decryptor(),
+          m_he_seal_backend.get_encryption_parameters(), message.payload(),
+          message.payload_size(), m_he_seal_backend.trusted_ciphertexts());
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_outputs[slot] = tensor;
+    } else {
+      HETensor::load_from_pb_tensor(
+          tensor, pb_message.he_tensors(0), m_he_seal_backend.get_context(),
+          message.payload(), message.payload_size(),
+          m_he_seal_backend.trusted_ciphertexts());
+    }
+  } else if (name == "Stage") {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_segment_done = true;
+    m_cond.notify_all();
+  } else {
+    NGRAPH_CHECK(false, "Unknown stage worker function ", name);
+  }
+}
+
+}  // namespace ngraph::runtime::he
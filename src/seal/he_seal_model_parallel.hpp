@@ -0,0 +1,130 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "he_tensor.hpp"
+#include "tcp/tcp_client.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+class HESealBackend;
+
+/// \brief Splits a sequence of nodes into contiguous stages of similar
+/// total cost
+/// \param[in] costs Cost of each node, in execution order. Nodes of cost 0
+/// are assigned to the stage of the preceding node
+/// \param[in] num_stages Number of stages, at least 1
+/// \returns Stage of each node, which is non-decreasing and below num_stages
+std::vector<size_t> partition_stages(const std::vector<double>& costs,
+                                     size_t num_stages);
+
+/// \brief Nodes executed by a model-parallel stage worker in one round trip
+struct StageSegment {
+  /// \brief Stage of the segment, at least 1. Stage s is executed by the
+  /// (s - 1)-th stage worker, unless the segment is sharded
+  size_t stage{0};
+  /// \brief Indices of the nodes to execute, in execution order. Includes
+  /// the Constants the nodes read, which each worker computes itself
+  std::vector<size_t> nodes;
+  /// \brief Slots sent to the worker before executing the nodes
+  std::vector<size_t> input_slots;
+  /// \brief Slots computed by the nodes and read after the segment
+  std::vector<size_t> output_slots;
+  /// \brief Whether or not the nodes are elementwise on tensors of equal
+  /// shape, so each data-parallel worker executes them on a range of the
+  /// elements
+  bool sharded{false};
+};
+
+/// \brief Connection of a model-parallel coordinator to one stage worker,
+/// i.e. a server executing its stage of the same function, see
+/// HESealExecutable::serve_stages
+class HESealStageClient {
+ public:
+  /// \brief Connects to a stage worker. Messages are handled on a thread of
+  /// the stage client
+  /// \param[in] hostname Hostname of the stage worker
+  /// \param[in] port Port of the stage worker
+  /// \param[in] he_seal_backend Backend of the coordinator, whose client
+  /// keys are sent to the worker
+  HESealStageClient(const std::string& hostname, size_t port,
+                    HESealBackend& he_seal_backend);
+
+  /// \brief Closes the connection
+  ~HESealStageClient();
+
+  HESealStageClient(const HESealStageClient&) = delete;
+  HESealStageClient& operator=(const HESealStageClient&) = delete;
+
+  /// \brief Sends the public and relinearization keys of the coordinator's
+  /// client, once the worker has sent its encryption parameters
+  void send_keys();
+
+  /// \brief Executes a segment on the worker
+  /// \param[in] segment Segment to execute
+  /// \param[in] tensor_slots Tensors of the call, which store the inputs of
+  /// the segment
+  /// \param[in] batch_size Batch size of the call
+  /// \param[in] elements If set, the range of elements of a sharded segment
+  /// to execute. Only these elements of the inputs are sent and of the
+  /// outputs returned
+  /// \returns Tensor of each output slot of the segment
+  std::unordered_map<size_t, std::shared_ptr<HETensor>> execute(
+      const StageSegment& segment,
+      const std::vector<std::shared_ptr<HETensor>>& tensor_slots,
+      size_t batch_size,
+      std::optional<std::pair<size_t, size_t>> elements = std::nullopt);
+
+  /// \brief Notifies the worker that the call has finished, so its
+  /// serve_stages returns
+  void end_call();
+
+ private:
+  void handle_message(const TCPMessage& message);
+
+  /// \brief Writes a message from the thread handling messages, since the
+  /// TCP client is not thread-safe
+  void write_message(TCPMessage&& message);
+
+  HESealBackend& m_he_seal_backend;
+  boost::asio::io_context m_io_context;
+  std::unique_ptr<TCPClient> m_tcp_client;
+  std::thread m_io_thread;
+
+  // Guards the members below, which are written by the message handler
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_connected{false};
+  bool m_segment_done{false};
+  std::unordered_map<size_t, std::shared_ptr<HETensor>> m_outputs;
+
+  // Target size in bytes of each tensor message
+  inline static const size_t s_frame_bytes{1UL << 22U};
+};
+
+}  // namespace ngraph::runtime::he
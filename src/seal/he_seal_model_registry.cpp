@@ -0,0 +1,315 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_model_registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "nlohmann/json.hpp"
+#include "protos/message.pb.h"
+#include "seal/he_seal_thread_budget.hpp"
+#include "tcp/tcp_session.hpp"
+
+using json = nlohmann::json;
+
+namespace ngraph::runtime::he {
+
+struct HESealModelRegistry::Route {
+  // The session's handler owns the route, so the route does not own the
+  // session
+  std::weak_ptr<ServerTransport> session;
+  // Set once the session is routed, read by later messages
+  std::atomic<HESealExecutable*> executable{nullptr};
+  std::atomic<bool> rejected{false};
+};
+
+HESealModelRegistry::HESealModelRegistry(HESealBackend& he_seal_backend)
+    : m_he_seal_backend(he_seal_backend) {
+  NGRAPH_CHECK(m_he_seal_backend.enable_client(),
+               "Model registry requires the client to be enabled");
+  NGRAPH_CHECK(!m_he_seal_backend.shm_transport(),
+               "Model registry does not support the shared memory transport");
+}
+
+HESealModelRegistry::~HESealModelRegistry() {
+  m_io_context.stop();
+  for (auto& thread : m_io_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  if (m_acceptor != nullptr) {
+    try {
+      m_acceptor->close();
+    } catch (std::exception& e) {
+      NGRAPH_ERR << "Exception closing model registry acceptor " << e.what();
+    }
+  }
+}
+
+void HESealModelRegistry::add_model(
+    const std::string& name,
+    const std::shared_ptr<HESealExecutable>& executable) {
+  NGRAPH_CHECK(executable != nullptr, "Cannot host a null executable");
+  NGRAPH_CHECK(&executable->he_seal_backend() == &m_he_seal_backend,
+               "Model ", name, " was compiled by another backend");
+  std::lock_guard<std::mutex> guard(m_mutex);
+  NGRAPH_CHECK(m_models.find(name) == m_models.end(), "Model ", name,
+               " is already hosted");
+  executable->host_in_registry();
+  Model model;
+  model.replicas.emplace_back(executable);
+  model.num_sessions.emplace_back(0);
+  model.calling.emplace_back(false);
+  m_models.emplace(name, std::move(model));
+  NGRAPH_HE_LOG(1) << "Hosting model " << name;
+}
+
+void HESealModelRegistry::add_replica(
+    const std::string& name,
+    const std::shared_ptr<HESealExecutable>& executable) {
+  NGRAPH_CHECK(executable != nullptr, "Cannot host a null executable");
+  NGRAPH_CHECK(&executable->he_seal_backend() == &m_he_seal_backend,
+               "Replica of model ", name, " was compiled by another backend");
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto it = m_models.find(name);
+  NGRAPH_CHECK(it != m_models.end(), "No model ", name, " is hosted");
+  Model& model = it->second;
+  NGRAPH_CHECK(std::find(model.replicas.begin(), model.replicas.end(),
+                         executable) == model.replicas.end(),
+               "Executable already hosts model ", name);
+
+  const auto& parameters = model.replicas.front()->get_parameters();
+  const auto& replica_parameters = executable->get_parameters();
+  NGRAPH_CHECK(replica_parameters.size() == parameters.size(),
+               "Replica of model ", name, " has ", replica_parameters.size(),
+               " parameters, expected ", parameters.size());
+  for (size_t param_idx = 0; param_idx < parameters.size(); ++param_idx) {
+    NGRAPH_CHECK(replica_parameters[param_idx]->get_shape() ==
+                         parameters[param_idx]->get_shape() &&
+                     replica_parameters[param_idx]->get_element_type() ==
+                         parameters[param_idx]->get_element_type(),
+                 "Parameter ", param_idx, " of replica of model ", name,
+                 " differs from the model's");
+  }
+
+  executable->host_in_registry();
+  model.replicas.emplace_back(executable);
+  model.num_sessions.emplace_back(0);
+  model.calling.emplace_back(false);
+  NGRAPH_HE_LOG(1) << "Hosting replica " << model.replicas.size() - 1
+                   << " of model " << name;
+}
+
+std::shared_ptr<HESealExecutable> HESealModelRegistry::model(
+    const std::string& name) const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto it = m_models.find(name);
+  NGRAPH_CHECK(it != m_models.end(), "No model ", name, " is hosted");
+  return it->second.replicas.front();
+}
+
+std::vector<std::string> HESealModelRegistry::model_names() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  std::vector<std::string> names;
+  names.reserve(m_models.size());
+  for (const auto& [name, model] : m_models) {
+    names.emplace_back(name);
+  }
+  return names;
+}
+
+void HESealModelRegistry::start() {
+  NGRAPH_CHECK(m_acceptor == nullptr, "Model registry already started");
+  boost::asio::ip::tcp::endpoint server_endpoints(boost::asio::ip::tcp::v4(),
+                                                  m_he_seal_backend.port());
+  m_acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(
+      m_io_context, server_endpoints);
+  boost::asio::socket_base::reuse_address option(true);
+  m_acceptor->set_option(option);
+  accept_connection();
+
+  size_t num_io_threads = HEThreadBudget::bound(
+      HEThreadBudget::Subsystem::io, m_he_seal_backend.num_io_threads());
+  NGRAPH_HE_LOG(1) << "Model registry serving " << m_models.size()
+                   << " models on port " << m_he_seal_backend.port()
+                   << " with " << num_io_threads << " I/O threads";
+  for (size_t thread_idx = 0; thread_idx < num_io_threads; ++thread_idx) {
+    m_io_threads.emplace_back([this]() {
+      try {
+        m_io_context.run();
+      } catch (std::exception& e) {
+        NGRAPH_ERR << "Model registry I/O thread: " << e.what();
+      }
+    });
+  }
+}
+
+void HESealModelRegistry::accept_connection() {
+  m_acceptor->async_accept([this](boost::system::error_code ec,
+                                  boost::asio::ip::tcp::socket socket) {
+    if (ec == boost::asio::error::operation_aborted) {
+      NGRAPH_HE_LOG(1) << "Model registry stopped accepting connections";
+      return;
+    }
+    if (ec) {
+      NGRAPH_ERR << "error accepting connection " << ec.message();
+    } else {
+      auto route = std::make_shared<Route>();
+      auto session = std::make_shared<TCPSession>(
+          std::move(socket), [this, route](const TCPMessage& message) {
+            HESealExecutable* executable = route->executable.load();
+            if (executable != nullptr) {
+              executable->handle_message(message);
+            } else if (!route->rejected) {
+              route_session(route, message);
+            }
+          });
+      route->session = session;
+      session->start();
+
+      pb::TCPMessage pb_message;
+      pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+      json js = {{"function", "Model"}};
+      pb_message.mutable_function()->set_function(js.dump());
+      session->write_message(TCPMessage(std::move(pb_message)));
+    }
+    accept_connection();
+  });
+}
+
+void HESealModelRegistry::route_session(const std::shared_ptr<Route>& route,
+                                        const TCPMessage& message) {
+  const pb::TCPMessage& pb_message = *message.pb_message();
+  std::string name;
+  bool named = false;
+  if (pb_message.type() == pb::TCPMessage_Type_RESPONSE &&
+      pb_message.has_function()) {
+    json js = json::parse(pb_message.function().function(), nullptr, false);
+    if (!js.is_discarded() && js.value("function", "") == "Model") {
+      name = js.value("model", "");
+      named = true;
+    }
+  }
+
+  auto session = route->session.lock();
+  std::shared_ptr<HESealExecutable> executable;
+  size_t replica_idx = 0;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_models.find(name);
+    // A client naming no model runs the only hosted model
+    if (it == m_models.end() && name.empty() && m_models.size() == 1) {
+      it = m_models.begin();
+    }
+    if (named && it != m_models.end() && session != nullptr) {
+      name = it->first;
+      Model& model = it->second;
+      replica_idx = static_cast<size_t>(
+          std::min_element(model.num_sessions.begin(),
+                           model.num_sessions.end()) -
+          model.num_sessions.begin());
+      model.num_sessions[replica_idx]++;
+      executable = model.replicas[replica_idx];
+    } else {
+      m_num_rejected_sessions++;
+    }
+  }
+  if (executable == nullptr) {
+    NGRAPH_WARN << "Ignoring session requesting unknown model " << name;
+    route->rejected = true;
+    return;
+  }
+
+  NGRAPH_HE_LOG(1) << "Routing session to replica " << replica_idx
+                   << " of model " << name;
+  route->executable = executable.get();
+  executable->add_session(std::move(session));
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_models.at(name).routed_replicas.emplace_back(replica_idx);
+    m_routed_models.emplace_back(name);
+  }
+  m_session_cond.notify_all();
+  m_call_cond.notify_all();
+}
+
+std::string HESealModelRegistry::wait_for_session() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_session_cond.wait(lock, [this]() { return !m_routed_models.empty(); });
+  std::string name = std::move(m_routed_models.front());
+  m_routed_models.pop_front();
+  return name;
+}
+
+bool HESealModelRegistry::call(
+    const std::string& name,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+    const std::vector<std::shared_ptr<runtime::Tensor>>& inputs) {
+  std::shared_ptr<HESealExecutable> executable;
+  size_t replica_idx = 0;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_models.find(name);
+    NGRAPH_CHECK(it != m_models.end(), "No model ", name, " is hosted");
+    Model& model = it->second;
+    m_call_cond.wait(lock, [&]() {
+      return !model.routed_replicas.empty() &&
+             !model.calling[model.routed_replicas.front()] &&
+             (m_num_calls == 0 || m_calling_model == name);
+    });
+    replica_idx = model.routed_replicas.front();
+    model.routed_replicas.pop_front();
+    model.calling[replica_idx] = true;
+    executable = model.replicas[replica_idx];
+    m_calling_model = name;
+    m_num_calls++;
+  }
+  NGRAPH_HE_LOG(1) << "Serving replica " << replica_idx << " of model "
+                   << name;
+
+  auto end_call = [&]() {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      Model& model = m_models.at(name);
+      model.calling[replica_idx] = false;
+      model.num_sessions[replica_idx]--;
+      m_num_calls--;
+    }
+    m_call_cond.notify_all();
+  };
+  bool success = false;
+  try {
+    success = executable->call(outputs, inputs);
+  } catch (...) {
+    end_call();
+    throw;
+  }
+  end_call();
+  return success;
+}
+
+size_t HESealModelRegistry::num_rejected_sessions() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_num_rejected_sessions;
+}
+
+}  // namespace ngraph::runtime::he
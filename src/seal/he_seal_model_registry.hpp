@@ -0,0 +1,158 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "ngraph/runtime/tensor.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_executable.hpp"
+#include "tcp/tcp_message.hpp"
+#include "tcp/transport.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Serves several executables compiled by one backend on the
+/// backend's port, so the models share the backend's SEAL context, memory
+/// pools and client key cache rather than each running in its own process.
+/// On connecting, each client is asked for the model it runs, see
+/// HESealClient::send_model_name, and its session is queued to that model.
+/// The models share the backend's client keys, so their calls are served
+/// one at a time:
+///
+///     registry.start();
+///     while (true) {
+///       std::string name = registry.wait_for_session();
+///       registry.call(name, outputs.at(name), inputs.at(name));
+///     }
+///
+/// A model hosting replicas, see add_replica, pipelines its requests: while
+/// one replica's call waits on a client round-trip, e.g. for a ReLU, a call
+/// of another replica computes. The loop above then runs on one thread per
+/// replica, each with its own server tensors
+class HESealModelRegistry {
+ public:
+  /// \brief Constructs an empty registry
+  /// \param[in] he_seal_backend Backend compiling the hosted models
+  explicit HESealModelRegistry(HESealBackend& he_seal_backend);
+
+  /// \brief Stops accepting connections and joins the I/O threads
+  ~HESealModelRegistry();
+
+  HESealModelRegistry(const HESealModelRegistry&) = delete;
+  HESealModelRegistry& operator=(const HESealModelRegistry&) = delete;
+
+  /// \brief Hosts an executable under a name
+  /// \param[in] name Name requested by clients of the model
+  /// \param[in] executable Executable compiled by the registry's backend
+  /// \throws ngraph_error if the name is taken, the executable was compiled
+  /// by another backend, or its server is already set up
+  void add_model(const std::string& name,
+                 const std::shared_ptr<HESealExecutable>& executable);
+
+  /// \brief Hosts another executable of a model, whose sessions are routed
+  /// to the replica with the fewest sessions not yet served. Calls of a
+  /// model's replicas may overlap, although calls of different models do
+  /// not. Since the backend holds one set of client keys, the sessions of a
+  /// replicated model must share their keys, e.g. with a client key file
+  /// \param[in] name Name of a hosted model
+  /// \param[in] executable Executable compiled by the registry's backend
+  /// from a copy of the model's function, as compiling rewrites the function
+  /// \throws ngraph_error if no model has the name, the executable's
+  /// parameters differ from the model's, or add_model would throw
+  void add_replica(const std::string& name,
+                   const std::shared_ptr<HESealExecutable>& executable);
+
+  /// \brief Returns the executable hosted under a name, or its first replica
+  /// \throws ngraph_error if no model has the name
+  std::shared_ptr<HESealExecutable> model(const std::string& name) const;
+
+  /// \brief Returns the names of the hosted models, in sorted order
+  std::vector<std::string> model_names() const;
+
+  /// \brief Starts accepting connections on the backend's port
+  void start();
+
+  /// \brief Blocks until a session is routed to a model, and returns the
+  /// model's name. Sessions are returned in the order they were routed
+  std::string wait_for_session();
+
+  /// \brief Serves the longest-waiting session of a model with one call,
+  /// after any other model's call, and the previous call of the session's
+  /// replica, have returned
+  /// \param[in] name Name of the model
+  /// \param[in] outputs Server outputs of the call
+  /// \param[in] inputs Server inputs of the call
+  /// \returns Whether or not the call succeeded
+  bool call(const std::string& name,
+            const std::vector<std::shared_ptr<runtime::Tensor>>& outputs,
+            const std::vector<std::shared_ptr<runtime::Tensor>>& inputs);
+
+  /// \brief Returns the number of sessions whose requested model is not
+  /// hosted
+  size_t num_rejected_sessions() const;
+
+ private:
+  /// \brief Routes the messages of a session to the requested model
+  struct Route;
+
+  /// \brief Replicas of a hosted model
+  struct Model {
+    std::vector<std::shared_ptr<HESealExecutable>> replicas;
+    // Sessions routed to each replica and not yet served, including the
+    // session of a running call
+    std::vector<size_t> num_sessions;
+    std::vector<bool> calling;
+    // Replicas of the routed sessions not yet served, in order of routing
+    std::deque<size_t> routed_replicas;
+  };
+
+  void accept_connection();
+
+  /// \brief Handles a message of a session not yet routed to a model
+  void route_session(const std::shared_ptr<Route>& route,
+                     const TCPMessage& message);
+
+  HESealBackend& m_he_seal_backend;
+  // Declared first, so sessions and the acceptor are destroyed before it
+  boost::asio::io_context m_io_context;
+  std::unique_ptr<boost::asio::ip::tcp::acceptor> m_acceptor;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_session_cond;
+  std::map<std::string, Model> m_models;
+  // Models of the routed sessions not yet returned by wait_for_session, in
+  // order of routing
+  std::deque<std::string> m_routed_models;
+  size_t m_num_rejected_sessions{0};
+  // Calls only overlap with calls of the same model, since models share the
+  // backend's client keys
+  std::condition_variable m_call_cond;
+  std::string m_calling_model;
+  size_t m_num_calls{0};
+  std::vector<std::thread> m_io_threads;
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_replay_client.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/log.hpp"
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Returns a description of the kind of a message, i.e. its type and
+/// request, which matches between a capture and its replay
+std::string message_kind(const pb::TCPMessage& message) {
+  std::string kind = std::to_string(message.type());
+  if (message.has_encryption_parameters()) {
+    kind += " encryption parameters";
+  }
+  if (message.has_op_request()) {
+    kind += " op " + std::to_string(message.op_request().op());
+  }
+  if (message.has_function()) {
+    json js = json::parse(message.function().function());
+    kind += " " + js.value("function", std::string());
+  }
+  return kind;
+}
+}  // namespace
+
+HESealReplayClient::HESealReplayClient(const std::string& hostname,
+                                       size_t port, Capture capture,
+                                       double speed)
+    : m_capture(std::move(capture)), m_speed(speed), m_timer(m_io_context) {
+  NGRAPH_CHECK(m_capture != nullptr, "Replay client capture is null");
+  NGRAPH_CHECK(m_speed >= 0, "Replay speed ", m_speed, " is negative");
+  for (const auto& captured : *m_capture) {
+    if (!captured.sent) {
+      m_received.emplace_back(&captured);
+    }
+  }
+  m_answers.resize(m_received.size());
+  for (const auto& captured : *m_capture) {
+    if (captured.sent) {
+      NGRAPH_CHECK(captured.trigger < m_answers.size(),
+                   "Captured message answers unknown message ",
+                   captured.trigger);
+      m_answers[captured.trigger].emplace_back(&captured);
+    }
+  }
+  NGRAPH_HE_LOG(1) << "Replaying " << m_capture->size() << " messages to "
+                   << hostname << ":" << port;
+
+  boost::asio::ip::tcp::resolver resolver(m_io_context);
+  auto endpoints = resolver.resolve(hostname, std::to_string(port));
+  m_tcp_client = std::make_unique<TCPClient>(
+      m_io_context, endpoints,
+      [this](const TCPMessage& message) { handle_message(message); });
+  m_io_context.run();
+}
+
+void HESealReplayClient::handle_message(const TCPMessage& message) {
+  size_t index = m_num_received++;
+  if (index >= m_received.size()) {
+    NGRAPH_WARN << "Replay client received message " << index
+                << " beyond the capture";
+    ++m_num_mismatched;
+    return;
+  }
+  const CapturedMessage& captured = *m_received[index];
+  std::string kind = message_kind(*message.pb_message());
+  if (kind != message_kind(*captured.message.pb_message())) {
+    NGRAPH_WARN << "Replay client received message " << index << " of kind "
+                << kind << ", captured "
+                << message_kind(*captured.message.pb_message());
+    ++m_num_mismatched;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  for (const CapturedMessage* answer : m_answers[index]) {
+    auto due = now;
+    if (m_speed > 0) {
+      due += std::chrono::microseconds(static_cast<size_t>(
+          static_cast<double>(answer->time_us - captured.time_us) / m_speed));
+    }
+    // Messages are written in the captured order
+    if (!m_pending.empty()) {
+      due = std::max(due, m_pending.back().first);
+    }
+    // Copies the protobuf body, whose serialization is not thread-safe, so
+    // several replay clients may share the capture
+    TCPMessage::Segments segments = answer->message.segments();
+    m_pending.emplace_back(
+        due, TCPMessage(pb::TCPMessage(*answer->message.pb_message()),
+                        std::move(segments)));
+  }
+  if (!m_timer_armed) {
+    write_pending();
+  }
+}
+
+void HESealReplayClient::write_pending() {
+  if (m_pending.empty()) {
+    if (m_num_received >= m_received.size()) {
+      NGRAPH_HE_LOG(1) << "Replay client done";
+      m_tcp_client->close();
+    }
+    return;
+  }
+  m_timer_armed = true;
+  m_timer.expires_at(m_pending.front().first);
+  m_timer.async_wait([this](const boost::system::error_code& error) {
+    m_timer_armed = false;
+    if (error) {
+      return;
+    }
+    m_tcp_client->write_message(std::move(m_pending.front().second));
+    m_pending.pop_front();
+    write_pending();
+  });
+}
+
+}  // namespace ngraph::runtime::he
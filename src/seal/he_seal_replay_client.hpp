@@ -0,0 +1,88 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "tcp/tcp_capture.hpp"
+#include "tcp/tcp_client.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Synthetic client replaying a session captured by an HESealClient
+/// with the NGRAPH_HE_CLIENT_CAPTURE_FILE environment variable set. Each
+/// message from the server is answered by the messages the captured client
+/// sent in answer to the same message, e.g. its keys, inputs and activation
+/// responses. The replay client holds no keys, so the server's results are
+/// meaningless, but the server computes as in the captured session. This
+/// suits benchmarking the server without the noise of a live client, and
+/// load tests with many synthetic clients sharing one capture
+class HESealReplayClient {
+ public:
+  /// \brief Shared, read-only capture
+  using Capture = std::shared_ptr<const std::vector<CapturedMessage>>;
+
+  /// \brief Connects to a server and replays a capture, returning once the
+  /// server sent all captured messages or closed the connection
+  /// \param[in] hostname Hostname of the server
+  /// \param[in] port Port of the server
+  /// \param[in] capture Captured session, see load_capture
+  /// \param[in] speed Speed of the replay relative to the captured session,
+  /// which delays each message by the time the captured client took to send
+  /// it. 0 sends messages without delay
+  HESealReplayClient(const std::string& hostname, size_t port,
+                     Capture capture, double speed = 0);
+
+  /// \brief Returns the number of messages received from the server
+  size_t num_received() const { return m_num_received; }
+
+  /// \brief Returns the number of messages received from the server whose
+  /// kind differs from the captured message, e.g. if the server
+  /// configuration changed since the capture
+  size_t num_mismatched() const { return m_num_mismatched; }
+
+ private:
+  void handle_message(const TCPMessage& message);
+
+  /// \brief Waits for the first pending message to be due and writes it
+  void write_pending();
+
+  Capture m_capture;
+  double m_speed;
+  // Captured messages from the server, by index
+  std::vector<const CapturedMessage*> m_received;
+  // Captured answers to each received message
+  std::vector<std::vector<const CapturedMessage*>> m_answers;
+
+  boost::asio::io_context m_io_context;
+  std::unique_ptr<TCPClient> m_tcp_client;
+  boost::asio::steady_timer m_timer;
+  bool m_timer_armed{false};
+  // Messages to write and the times they are due, in order
+  std::deque<std::pair<std::chrono::steady_clock::time_point, TCPMessage>>
+      m_pending;
+  size_t m_num_received{0};
+  size_t m_num_mismatched{0};
+};
+}  // namespace ngraph::runtime::he
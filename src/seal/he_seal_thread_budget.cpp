@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_thread_budget.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "he_util.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/util.hpp"
+
+namespace ngraph::runtime::he {
+
+void HEThreadBudget::configure(size_t num_threads, size_t gc_quota,
+                               size_t io_quota) {
+  if (num_threads == 0) {
+    s_num_threads = 0;
+    return;
+  }
+  if (gc_quota == 0) {
+    gc_quota = std::max<size_t>(1, num_threads / 2);
+  }
+  if (io_quota == 0) {
+    io_quota = 1;
+  }
+  NGRAPH_CHECK(io_quota < num_threads, "Thread budget of ", num_threads,
+               " leaves no threads for ops beside ", io_quota,
+               " I/O threads");
+  s_gc_quota = std::min(gc_quota, num_threads - io_quota);
+  s_io_quota = io_quota;
+  s_num_threads = num_threads;
+}
+
+void HEThreadBudget::configure(const std::string& setting) {
+  std::vector<std::string> settings = split(to_lower(setting), ',');
+  NGRAPH_CHECK(!settings.empty(), "Empty thread budget");
+  size_t num_threads = std::max(0, flag_to_int(settings[0], 0));
+  size_t gc_quota = 0;
+  size_t io_quota = 0;
+  for (size_t i = 1; i < settings.size(); ++i) {
+    std::vector<std::string> quota = split(settings[i], ':');
+    NGRAPH_CHECK(quota.size() == 2, "Thread quota ", settings[i],
+                 " should be of form subsystem:n");
+    size_t num_quota_threads = std::max(0, flag_to_int(quota[1], 0));
+    if (quota[0] == "gc") {
+      gc_quota = num_quota_threads;
+    } else if (quota[0] == "io") {
+      io_quota = num_quota_threads;
+    } else {
+      NGRAPH_CHECK(false, "Unknown thread quota subsystem ", quota[0]);
+    }
+  }
+  configure(num_threads, gc_quota, io_quota);
+}
+
+size_t HEThreadBudget::quota(Subsystem subsystem) {
+  if (s_num_threads == 0) {
+    return std::numeric_limits<size_t>::max();
+  }
+  return subsystem == Subsystem::garbled_circuit ? s_gc_quota.load()
+                                                 : s_io_quota.load();
+}
+
+size_t HEThreadBudget::bound(Subsystem subsystem, size_t requested) {
+  return std::max<size_t>(1, std::min(requested, quota(subsystem)));
+}
+
+size_t HEThreadBudget::compute_threads() {
+  size_t num_threads = s_num_threads;
+  if (num_threads == 0) {
+    return std::numeric_limits<size_t>::max();
+  }
+  size_t reserved = s_io_quota + s_gc_reserved;
+  return reserved < num_threads ? num_threads - reserved : 1;
+}
+
+HEThreadBudget::Reservation::Reservation(size_t requested)
+    : m_num_threads(std::max<size_t>(1, requested)) {
+  if (s_num_threads == 0) {
+    return;
+  }
+  // Concurrent reservations share the quota, each keeping its calling thread
+  size_t reserved = s_gc_reserved.load();
+  size_t num_threads;
+  do {
+    size_t available = reserved < s_gc_quota ? s_gc_quota - reserved : 0;
+    num_threads = std::max<size_t>(1, std::min(m_num_threads, available));
+  } while (!s_gc_reserved.compare_exchange_weak(reserved,
+                                                reserved + num_threads));
+  m_num_threads = num_threads;
+  m_reserved = true;
+}
+
+HEThreadBudget::Reservation::~Reservation() {
+  if (m_reserved) {
+    s_gc_reserved -= m_num_threads;
+  }
+}
+
+}  // namespace ngraph::runtime::he
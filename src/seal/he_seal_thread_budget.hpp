@@ -0,0 +1,95 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace ngraph::runtime::he {
+
+/// \brief Process-wide number of threads shared by the kernels, the garbled
+/// circuit parties and the server's network I/O. Each subsystem other than
+/// the kernels has a quota, and the kernels run on the threads which are
+/// not reserved by the other subsystems, so garbled circuits overlapping
+/// with homomorphic ops do not oversubscribe the cores. Without a budget,
+/// every subsystem uses the threads it requests
+class HEThreadBudget {
+ public:
+  /// \brief Subsystems drawing threads from the budget
+  enum class Subsystem { garbled_circuit, io };
+
+  /// \brief Sets the budget
+  /// \param[in] num_threads Total number of threads, or 0 for no budget
+  /// \param[in] gc_quota Maximum number of garbled circuit party threads
+  /// running at once, or 0 for half the budget
+  /// \param[in] io_quota Number of network I/O threads, or 0 for 1
+  static void configure(size_t num_threads, size_t gc_quota = 0,
+                        size_t io_quota = 0);
+
+  /// \brief Parses a budget of form "n" or "n,gc:g,io:i" and sets it, see
+  /// configure
+  /// \param[in] setting Budget setting
+  static void configure(const std::string& setting);
+
+  /// \brief Returns the total number of threads, or 0 if there is no budget
+  static size_t num_threads() { return s_num_threads; }
+
+  /// \brief Returns the quota of a subsystem, or the maximum size_t value if
+  /// there is no budget
+  static size_t quota(Subsystem subsystem);
+
+  /// \brief Returns the number of threads a subsystem may start, i.e. the
+  /// number requested, bounded by its quota. Is at least 1
+  /// \param[in] subsystem Subsystem starting the threads
+  /// \param[in] requested Number of threads requested
+  static size_t bound(Subsystem subsystem, size_t requested);
+
+  /// \brief Returns the number of threads available to a kernel loop, i.e.
+  /// the budget less the I/O quota and the garbled circuit threads
+  /// currently reserved. Is at least 1, or the maximum size_t value if there
+  /// is no budget
+  static size_t compute_threads();
+
+  /// \brief Reserves garbled circuit threads during its lifetime, which the
+  /// kernels then leave unused. Reserves fewer threads than requested if the
+  /// quota is exhausted, but always at least one, i.e. the calling thread
+  class Reservation {
+   public:
+    /// \param[in] requested Number of threads requested
+    explicit Reservation(size_t requested);
+    ~Reservation();
+
+    Reservation(const Reservation&) = delete;
+    Reservation& operator=(const Reservation&) = delete;
+
+    /// \brief Returns the number of threads reserved
+    size_t num_threads() const { return m_num_threads; }
+
+   private:
+    size_t m_num_threads;
+    bool m_reserved{false};
+  };
+
+ private:
+  inline static std::atomic<size_t> s_num_threads{0};
+  inline static std::atomic<size_t> s_gc_quota{0};
+  inline static std::atomic<size_t> s_io_quota{0};
+  inline static std::atomic<size_t> s_gc_reserved{0};
+};
+
+}  // namespace ngraph::runtime::he
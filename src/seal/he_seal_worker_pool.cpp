@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/he_seal_worker_pool.hpp"
+
+#include <utility>
+
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+HEWorkerPool::HEWorkerPool(size_t num_threads, std::function<void()> worker)
+    : m_num_threads(num_threads), m_worker(std::move(worker)) {
+  NGRAPH_CHECK(num_threads > 0, "Worker pool needs at least one thread");
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    start_worker();
+  }
+}
+
+HEWorkerPool::~HEWorkerPool() {
+  stop();
+  join();
+}
+
+void HEWorkerPool::start_worker() {
+  m_running++;
+  m_threads.emplace_back([this]() {
+    s_current = this;
+    m_worker();
+    s_current = nullptr;
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_running--;
+    m_cond.notify_all();
+  });
+}
+
+bool HEWorkerPool::park_if_oversubscribed() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!m_stopping && m_running > m_num_threads) {
+    m_running--;
+    m_parked++;
+    m_cond.wait(lock,
+                [this]() { return m_stopping || m_running < m_num_threads; });
+    m_parked--;
+    m_running++;
+  }
+  return !m_stopping;
+}
+
+void HEWorkerPool::stop() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_stopping = true;
+  m_cond.notify_all();
+}
+
+void HEWorkerPool::join() {
+  // Workers may be added while earlier workers are joined
+  for (size_t thread_idx = 0;; ++thread_idx) {
+    std::thread thread;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (thread_idx >= m_threads.size()) {
+        return;
+      }
+      thread = std::move(m_threads[thread_idx]);
+    }
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+size_t HEWorkerPool::num_threads_started() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_threads.size();
+}
+
+void HEWorkerPool::block() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_running--;
+  if (m_stopping || m_running >= m_num_threads) {
+    return;
+  }
+  if (m_parked > 0) {
+    m_cond.notify_all();
+  } else {
+    start_worker();
+  }
+}
+
+void HEWorkerPool::unblock() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_running++;
+}
+
+}  // namespace ngraph::runtime::he
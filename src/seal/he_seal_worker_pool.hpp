@@ -0,0 +1,110 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ngraph::runtime::he {
+
+/// \brief Threads running a worker function, of which a fixed number run at
+/// once. A worker about to wait on the network, e.g. for a client
+/// round-trip, suspends itself with a BlockingScope, which hands its place
+/// to a parked worker, or to a new worker if none is parked. Once it
+/// resumes, the next worker reaching park_if_oversubscribed() parks, so
+/// waiting workers do not reduce the number of threads computing, and at
+/// most one thread per concurrent wait is added
+class HEWorkerPool {
+ public:
+  /// \brief Starts the workers
+  /// \param[in] num_threads Number of workers running at once
+  /// \param[in] worker Function run by each worker thread. Should return
+  /// once park_if_oversubscribed() returns false
+  HEWorkerPool(size_t num_threads, std::function<void()> worker);
+
+  /// \brief Stops and joins the workers
+  ~HEWorkerPool();
+
+  HEWorkerPool(const HEWorkerPool&) = delete;
+  HEWorkerPool& operator=(const HEWorkerPool&) = delete;
+
+  /// \brief Returns the pool of the calling worker thread, or nullptr if not
+  /// called from a worker
+  static HEWorkerPool* current() { return s_current; }
+
+  /// \brief Parks the calling worker while more than num_threads workers
+  /// run, e.g. after a waiting worker resumed
+  /// \returns False if the pool is stopping
+  bool park_if_oversubscribed();
+
+  /// \brief Wakes parked workers, which then return, and stops adding
+  /// workers. Running workers are not interrupted
+  void stop();
+
+  /// \brief Waits until all workers, including added ones, have returned
+  void join();
+
+  /// \brief Returns the number of threads started so far
+  size_t num_threads_started() const;
+
+  /// \brief Marks the calling worker as waiting during its lifetime. Does
+  /// nothing outside a worker
+  class BlockingScope {
+   public:
+    BlockingScope() : m_pool(current()) {
+      if (m_pool != nullptr) {
+        m_pool->block();
+      }
+    }
+    ~BlockingScope() {
+      if (m_pool != nullptr) {
+        m_pool->unblock();
+      }
+    }
+    BlockingScope(const BlockingScope&) = delete;
+    BlockingScope& operator=(const BlockingScope&) = delete;
+
+   private:
+    HEWorkerPool* m_pool;
+  };
+
+ private:
+  /// \brief Starts a worker. Must hold m_mutex
+  void start_worker();
+
+  void block();
+  void unblock();
+
+  size_t m_num_threads;
+  std::function<void()> m_worker;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::vector<std::thread> m_threads;
+  // Workers neither parked, waiting in a BlockingScope, nor returned
+  size_t m_running{0};
+  size_t m_parked{0};
+  bool m_stopping{false};
+
+  inline static thread_local HEWorkerPool* s_current{nullptr};
+};
+
+}  // namespace ngraph::runtime::he
@@ -17,9 +17,12 @@
 #include "seal/kernel/add_seal.hpp"
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
@@ -117,29 +120,20 @@ void scalar_add_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
 
 void scalar_add_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
                      HEPlaintext& out) {
-  HEPlaintext out_vals;
-  if (arg0.size() == 1) {
-    out_vals.resize(arg1.size());
-    std::transform(arg1.begin(), arg1.end(), out_vals.begin(),
-                   [&](auto x) { return x + arg0[0]; });
-  } else if (arg1.size() == 1) {
-    out_vals.resize(arg0.size());
-    std::transform(arg0.begin(), arg0.end(), out_vals.begin(),
-                   [&](auto x) { return x + arg1[0]; });
-  } else {
-    size_t min_size = std::min(arg0.size(), arg1.size());
-    out_vals.resize(min_size);
-    for (size_t i = 0; i < min_size; ++i) {
-      out_vals[i] = arg0[i] + arg1[i];
-    }
-  }
-  out = std::move(out_vals);
+  plaintext_binary_op_seal(arg0, arg1, out,
+                           [](double x, double y) { return x + y; });
 }
 
 void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
                      HESealBackend& he_seal_backend) {
   NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                "Complex packing types don't match");
+  if (aliases_plaintext_arg(arg0, arg1, out)) {
+    HEType sum(HEPlaintext(), arg0.complex_packing());
+    scalar_add_seal(arg0, arg1, sum, he_seal_backend);
+    out = std::move(sum);
+    return;
+  }
   out.complex_packing() = arg0.complex_packing();
 
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
@@ -147,7 +141,8 @@ void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
     scalar_add_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
-                    out.get_ciphertext(), he_seal_backend);
+                    out.get_ciphertext(), he_seal_backend,
+                    he_seal_backend.pool());
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
@@ -182,10 +177,47 @@ void add_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
-    scalar_add_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  // Homogeneous operands skip the per-element dispatch on the operand types
+  parallel_for_kinds_seal(
+      arg0, arg1, out, count, [&](size_t i, auto kind0, auto kind1) {
+        using Kind0 = decltype(kind0);
+        using Kind1 = decltype(kind1);
+        if constexpr (std::is_same_v<Kind0, MixedKind> ||
+                      std::is_same_v<Kind1, MixedKind>) {
+          scalar_add_seal(arg0[i], arg1[i], out[i], he_seal_backend);
+        } else {
+          NGRAPH_CHECK(arg0[i].complex_packing() == arg1[i].complex_packing(),
+                       "Complex packing types don't match");
+          bool complex_packing = arg0[i].complex_packing();
+          if constexpr (std::is_same_v<Kind0, PlaintextKind> &&
+                        std::is_same_v<Kind1, PlaintextKind>) {
+            if (!out[i].is_plaintext()) {
+              out[i].set_plaintext(HEPlaintext());
+            }
+            scalar_add_seal(arg0[i].get_plaintext(), arg1[i].get_plaintext(),
+                            out[i].get_plaintext());
+          } else {
+            if (!out[i].is_ciphertext()) {
+              out[i].set_ciphertext(HESealBackend::create_empty_ciphertext());
+            }
+            if constexpr (std::is_same_v<Kind1, PlaintextKind>) {
+              scalar_add_seal(*arg0[i].get_ciphertext(),
+                              arg1[i].get_plaintext(), out[i].get_ciphertext(),
+                              complex_packing, he_seal_backend);
+            } else if constexpr (std::is_same_v<Kind0, PlaintextKind>) {
+              scalar_add_seal(*arg1[i].get_ciphertext(),
+                              arg0[i].get_plaintext(), out[i].get_ciphertext(),
+                              complex_packing, he_seal_backend);
+            } else {
+              scalar_add_seal(*arg0[i].get_ciphertext(),
+                              *arg1[i].get_ciphertext(),
+                              out[i].get_ciphertext(), he_seal_backend,
+                              he_seal_backend.pool());
+            }
+          }
+          out[i].complex_packing() = complex_packing;
+        }
+      });
 }
 
 }  // namespace ngraph::runtime::he
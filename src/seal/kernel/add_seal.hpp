@@ -75,7 +75,8 @@ void scalar_add_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
 /// \brief Adds two ciphertext/plaintext elements
 /// \param[in] arg0 Cipher or plaintext data to add
 /// \param[in] arg1 Cipher or plaintext data to add
-/// \param[in] out Stores the ciphertext or plaintext sum
+/// \param[in] out Stores the ciphertext or plaintext sum. May be arg0 or
+/// arg1, in which case the operation is performed in place
 /// \param[in] he_seal_backend Backend used to perform addition
 void scalar_add_seal(HEType& arg0, HEType& arg1, HEType& out,
                      HESealBackend& he_seal_backend);
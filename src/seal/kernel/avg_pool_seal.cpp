@@ -0,0 +1,99 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/avg_pool_seal.hpp"
+
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "ngraph/shape_util.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/max_pool_seal.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Sums each window, then multiplies window i by 1 / divisors[i], if
+/// divisors is not empty. With defer_division, encrypted sums store the
+/// inverse as their pending factor instead
+void pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+               const std::vector<std::vector<size_t>>& window_lists,
+               const std::vector<size_t>& divisors, size_t batch_size,
+               HESealBackend& he_seal_backend, bool defer_division = false) {
+  NGRAPH_CHECK(out.size() >= window_lists.size(), "Output size ", out.size(),
+               " is smaller than number of windows ", window_lists.size());
+  bool complex_packing = !arg.empty() ? arg[0].complex_packing() : false;
+
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < window_lists.size(); ++out_idx) {
+    // TODO(fboemer): batch size number of zeros?
+    HEType sum(HEPlaintext(batch_size, 0), complex_packing);
+    for (size_t in_idx : window_lists[out_idx]) {
+      scalar_add_seal(sum, arg[in_idx], sum, he_seal_backend);
+    }
+    if (!divisors.empty() && defer_division && sum.is_ciphertext()) {
+      sum.pending_factor() = 1. / static_cast<double>(divisors[out_idx]);
+    } else if (!divisors.empty()) {
+      HEType inv_n_elements(
+          HEPlaintext(std::initializer_list<double>{
+              1. / static_cast<double>(divisors[out_idx])}),
+          complex_packing);
+      scalar_multiply_seal(sum, inv_n_elements, sum, he_seal_backend);
+    }
+    out[out_idx] = std::move(sum);
+  }
+}
+}  // namespace
+
+void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+                   const Shape& arg_shape, const Shape& out_shape,
+                   const Shape& window_shape,
+                   const Strides& window_movement_strides,
+                   const Shape& padding_below, const Shape& padding_above,
+                   bool include_padding_in_avg_computation, size_t batch_size,
+                   HESealBackend& he_seal_backend, bool defer_division) {
+  auto window_lists = max_pool_seal_max_list(arg_shape, out_shape,
+                                             window_shape,
+                                             window_movement_strides,
+                                             padding_below, padding_above);
+
+  std::vector<size_t> divisors(window_lists.size(), shape_size(window_shape));
+  if (!include_padding_in_avg_computation) {
+    for (size_t out_idx = 0; out_idx < window_lists.size(); ++out_idx) {
+      divisors[out_idx] = window_lists[out_idx].size();
+      NGRAPH_CHECK(divisors[out_idx] != 0,
+                   "AvgPool num_elements must be non-zero");
+    }
+  }
+  pool_seal(arg, out, window_lists, divisors, batch_size, he_seal_backend,
+            defer_division);
+}
+
+void sum_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+                   const Shape& arg_shape, const Shape& out_shape,
+                   const Shape& window_shape,
+                   const Strides& window_movement_strides,
+                   const Shape& padding_below, const Shape& padding_above,
+                   size_t batch_size, HESealBackend& he_seal_backend) {
+  auto window_lists = max_pool_seal_max_list(arg_shape, out_shape,
+                                             window_shape,
+                                             window_movement_strides,
+                                             padding_below, padding_above);
+  pool_seal(arg, out, window_lists, {}, batch_size, he_seal_backend);
+}
+
+}  // namespace ngraph::runtime::he
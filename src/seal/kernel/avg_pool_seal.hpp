@@ -16,150 +16,47 @@
 
 #pragma once
 
-#include <memory>
 #include <vector>
 
 #include "he_type.hpp"
-#include "ngraph/coordinate_transform.hpp"
-#include "ngraph/shape_util.hpp"
-#include "ngraph/type/element_type.hpp"
+#include "ngraph/shape.hpp"
+#include "ngraph/strides.hpp"
 #include "seal/he_seal_backend.hpp"
-#include "seal/kernel/add_seal.hpp"
-#include "seal/kernel/multiply_seal.hpp"
 
 namespace ngraph::runtime::he {
-inline void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
-                          const Shape& arg_shape, const Shape& out_shape,
-                          const Shape& window_shape,
-                          const Strides& window_movement_strides,
-                          const Shape& padding_below,
-                          const Shape& padding_above,
-                          bool include_padding_in_avg_computation,
-                          size_t batch_size, HESealBackend& he_seal_backend) {
-  // TODO(fboemer): enable padding in avg pool computation
-  NGRAPH_CHECK(!include_padding_in_avg_computation,
-               "AvgPool doesn't support padding in computation");
-  // At the outermost level we will walk over every output coordinate O.
-  CoordinateTransform output_transform(out_shape);
-
-  for (const Coordinate& out_coord : output_transform) {
-    size_t out_coord_idx = output_transform.index(out_coord);
-
-    // Our output coordinate O will have the form:
-    //
-    //   (N,chan,i_1,...,i_n)
-
-    size_t batch_index = out_coord[0];
-    size_t channel = out_coord[1];
-
-    // For the input data we need to iterate the coordinate:
-    //
-    //   I:
-    //
-    // over the range (noninclusive on the right):
-    //
-    //   (N,chan,s_1*i_1,s_2*i_2,...,s_n*i_n) ->
-    //
-    //     (N+1,chan+1,s_1*i_1 + window_shape_1,...,s_n*i_n + window_shape_n)
-    //
-    // with unit stride.
-    //
-    // We iterate this over the *padded* data, so below we will need to check
-    // for coordinates that fall in the padding area.
-
-    size_t n_spatial_dimensions = arg_shape.size() - 2;
-
-    Coordinate input_batch_transform_start(2 + n_spatial_dimensions);
-    Coordinate input_batch_transform_end(2 + n_spatial_dimensions);
-    Strides input_batch_transform_source_strides(2 + n_spatial_dimensions, 1);
-    AxisVector input_batch_transform_source_axis_order(2 +
-                                                       n_spatial_dimensions);
-    CoordinateDiff input_batch_transform_padding_below(2 +
-                                                       n_spatial_dimensions);
-    CoordinateDiff input_batch_transform_padding_above(2 +
-                                                       n_spatial_dimensions);
-
-    input_batch_transform_start[0] = batch_index;
-    input_batch_transform_end[0] = batch_index + 1;
-    input_batch_transform_start[1] = channel;
-    input_batch_transform_end[1] = channel + 1;
-    input_batch_transform_padding_below[0] = 0;
-    input_batch_transform_padding_below[1] = 0;
-    input_batch_transform_padding_above[0] = 0;
-    input_batch_transform_padding_above[1] = 0;
-
-    for (size_t i = 2; i < n_spatial_dimensions + 2; i++) {
-      size_t window_shape_this_dim = window_shape[i - 2];
-      size_t movement_stride = window_movement_strides[i - 2];
-
-      input_batch_transform_start[i] = movement_stride * out_coord[i];
-      input_batch_transform_end[i] =
-          input_batch_transform_start[i] + window_shape_this_dim;
-      input_batch_transform_padding_below[i] = padding_below[i - 2];
-      input_batch_transform_padding_above[i] = padding_above[i - 2];
-    }
-
-    for (size_t i = 0; i < arg_shape.size(); i++) {
-      input_batch_transform_source_axis_order[i] = i;
-    }
-
-    CoordinateTransform input_batch_transform(
-        arg_shape, input_batch_transform_start, input_batch_transform_end,
-        input_batch_transform_source_strides,
-        input_batch_transform_source_axis_order,
-        input_batch_transform_padding_below,
-        input_batch_transform_padding_above);
-
-    // As we go, we compute the sum value:
-    //
-    //   output[O] := output[O] + arg[I]
-    //
-    // and the number of elements:
-    //
-    //   n_elements := n_elements + 1
-
-    // T result = 0;
-
-    // TODO(fboemer): better type which matches arguments?
-    auto sum = HEType(HEPlaintext(), false);
-    bool first_add = true;
-
-    size_t n_elements = 0;
-
-    for (const Coordinate& input_batch_coord : input_batch_transform) {
-      bool in_bounds =
-          input_batch_transform.has_source_coordinate(input_batch_coord);
-
-      if (in_bounds /* || include_padding_in_avg_computation */) {
-        // T v = in_bounds ?: 0;
-        // result += v;
-
-        if (first_add) {
-          sum = arg[input_batch_transform.index(input_batch_coord)];
-          // TODO(fboemer): batch size number of zeros?
-          HEPlaintext zero(std::initializer_list<double>{0});
-          out[out_coord_idx].set_plaintext(zero);
-          first_add = false;
-        } else {
-          scalar_add_seal(sum,
-                          arg[input_batch_transform.index(input_batch_coord)],
-                          sum, he_seal_backend);
-        }
-        n_elements++;
-      }
-    }
-
-    NGRAPH_CHECK(n_elements != 0, "AvgPool num_elements must be non-zero");
-    NGRAPH_CHECK(!first_add, "AvgPool must have > 1 elements to add");
-
-    // TODO(fboemer): batch size number of zeros?
-    auto inv_n_elements =
-        HEType(HEPlaintext(std::initializer_list<double>{1.f / n_elements}),
-               sum.complex_packing());
-
-    scalar_multiply_seal(sum, inv_n_elements, sum, he_seal_backend);
-    out[out_coord_idx] = sum;
-  }
-}
+/// \brief Averages each pooling window. Windows are computed in parallel
+/// from precomputed lists of input indices
+/// \param[in] arg Input data batch of shape (N, C, d_1, ..., d_n)
+/// \param[out] out Stores the averages
+/// \param[in] arg_shape Shape of the input
+/// \param[in] out_shape Shape of the output
+/// \param[in] window_shape Window shape
+/// \param[in] window_movement_strides Window movement strides
+/// \param[in] padding_below Padding below the input
+/// \param[in] padding_above Padding above the input
+/// \param[in] include_padding_in_avg_computation Whether or not padding
+/// counts towards the size of a window. Otherwise, each window is divided by
+/// its number of inputs
+/// \param[in] batch_size Number of values packed in each element
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+/// \param[in] defer_division Whether or not the division of encrypted window
+/// sums is left as their pending factor, see HEType::pending_factor
+void avg_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+                   const Shape& arg_shape, const Shape& out_shape,
+                   const Shape& window_shape,
+                   const Strides& window_movement_strides,
+                   const Shape& padding_below, const Shape& padding_above,
+                   bool include_padding_in_avg_computation, size_t batch_size,
+                   HESealBackend& he_seal_backend,
+                   bool defer_division = false);
+
+/// \brief Sums each pooling window, as avg_pool_seal without the division.
+/// Padding contributes zeros
+void sum_pool_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+                   const Shape& arg_shape, const Shape& out_shape,
+                   const Shape& window_shape,
+                   const Strides& window_movement_strides,
+                   const Shape& padding_below, const Shape& padding_above,
+                   size_t batch_size, HESealBackend& he_seal_backend);
 
 }  // namespace ngraph::runtime::he
@@ -29,12 +29,16 @@
 #include "seal/kernel/subtract_seal.hpp"
 
 namespace ngraph::runtime::he {
+/// \brief Computes scale * input + bias per channel. With defer_scale,
+/// encrypted inputs are computed as input + bias / scale, with the scale
+/// left as their pending factor, which saves a multiplication and a level,
+/// see HEType::pending_factor
 inline void batch_norm_inference_seal(
     double eps, std::vector<HEType>& gamma, std::vector<HEType>& beta,
     std::vector<HEType>& input, std::vector<HEType>& mean,
     std::vector<HEType>& variance, std::vector<HEType>& normed_input,
     const Shape& input_shape, const size_t batch_size,
-    HESealBackend& he_seal_backend) {
+    HESealBackend& he_seal_backend, bool defer_scale = false) {
   CoordinateTransform input_transform(input_shape);
 
   // Store input coordinates for parallelization
@@ -81,6 +85,14 @@ inline void batch_norm_inference_seal(
         channel_beta_vals[0] - (channel_gamma_vals[0] * channel_mean_vals[0]) /
                                    std::sqrt(channel_var_vals[0] + eps);
 
+    if (defer_scale && scale != 0 && input[input_index].is_ciphertext()) {
+      HEType he_shift(HEPlaintext(batch_size, bias / scale), false);
+      scalar_add_seal(input[input_index], he_shift, normed_input[input_index],
+                      he_seal_backend);
+      normed_input[input_index].pending_factor() = scale;
+      continue;
+    }
+
     HEPlaintext scale_vec(batch_size, scale);
     HEPlaintext bias_vec(batch_size, bias);
 
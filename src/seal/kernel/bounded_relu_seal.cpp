@@ -22,6 +22,8 @@
 
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
@@ -29,11 +31,9 @@ namespace ngraph::runtime::he {
 
 void scalar_bounded_relu_seal(const HEPlaintext& arg, HEPlaintext& out,
                               float alpha) {
-  out.resize(arg.size());
-  auto bounded_relu = [alpha](double f) {
+  plaintext_unary_op_seal(arg, out, [alpha](double f) {
     return f > alpha ? alpha : (f > 0) ? f : 0.f;
-  };
-  std::transform(arg.begin(), arg.end(), out.begin(), bounded_relu);
+  });
 }
 
 void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
@@ -67,10 +67,9 @@ void scalar_bounded_relu_seal(const HEType& arg, HEType& out, float alpha,
 void bounded_relu_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
                        float alpha, size_t count,
                        const HESealBackend& he_seal_backend) {
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
     scalar_bounded_relu_seal(arg[i], out[i], alpha, he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::runtime::he
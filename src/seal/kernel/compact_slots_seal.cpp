@@ -0,0 +1,138 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/compact_slots_seal.hpp"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/seal.h"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+size_t compaction_capacity(size_t batch_size, size_t slot_count) {
+  NGRAPH_CHECK(batch_size > 0, "Cannot compact empty ciphertexts");
+  size_t capacity = 1;
+  while (2 * capacity * batch_size <= slot_count) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
+std::set<int> compaction_steps(size_t batch_size, size_t slot_count) {
+  std::set<int> steps;
+  size_t capacity = compaction_capacity(batch_size, slot_count);
+  for (size_t power = 1; power < capacity; power *= 2) {
+    auto step = static_cast<int>(power * batch_size);
+    steps.insert(step);
+    steps.insert(-step);
+  }
+  return steps;
+}
+
+void compact_slots_seal(const std::vector<const seal::Ciphertext*>& ciphers,
+                        size_t batch_size, seal::Ciphertext& out,
+                        const seal::GaloisKeys& galois_keys,
+                        HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(!ciphers.empty(), "No ciphertexts to compact");
+  auto& encoder = *he_seal_backend.get_ckks_encoder();
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  const auto& context = *he_seal_backend.get_context();
+  const auto pool = he_seal_backend.pool();
+  NGRAPH_CHECK(ciphers.size() <=
+                   compaction_capacity(batch_size, encoder.slot_count()),
+               "Cannot compact ", ciphers.size(), " ciphertexts of ",
+               batch_size, " slots");
+
+  const seal::parms_id_type& parms_id = ciphers[0]->parms_id();
+  auto context_data = context.get_context_data(parms_id);
+  NGRAPH_CHECK(context_data != nullptr && context_data->chain_index() >=
+                                             he_seal_backend.rescale_primes(),
+               "Cannot compact ciphertexts at the lowest level");
+
+  // The mask is encoded at the scale of the primes dropped by the rescale,
+  // so the packed ciphertext keeps the scale of the inputs
+  std::vector<double> mask_values(encoder.slot_count(), 0);
+  std::fill_n(mask_values.begin(), batch_size, 1.0);
+  seal::Plaintext mask;
+  HEPrimitiveCounter::increment(HEPrimitive::encode);
+  encoder.encode(
+      mask_values, parms_id,
+      rescale_divisor(*context_data, he_seal_backend.rescale_primes()), mask,
+      pool);
+
+  std::vector<seal::Ciphertext> layer(ciphers.size());
+  for (size_t i = 0; i < ciphers.size(); ++i) {
+    NGRAPH_CHECK(ciphers[i]->parms_id() == parms_id,
+                 "Compacted ciphertexts must have the same parameters");
+    HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+    evaluator.multiply_plain(*ciphers[i], mask, layer[i], pool);
+    HEPrimitiveCounter::increment(HEPrimitive::rescale);
+    rescale_inplace(layer[i], evaluator, he_seal_backend.rescale_primes(),
+                    pool);
+  }
+
+  // Merging packings of 2^j ciphertexts shifts the second by 2^j blocks
+  for (size_t step = batch_size; layer.size() > 1; step *= 2) {
+    std::vector<seal::Ciphertext> merged((layer.size() + 1) / 2);
+    for (size_t i = 0; i < merged.size(); ++i) {
+      merged[i] = std::move(layer[2 * i]);
+      if (2 * i + 1 < layer.size()) {
+        HEPrimitiveCounter::increment(HEPrimitive::rotate);
+        evaluator.rotate_vector_inplace(layer[2 * i + 1],
+                                        -static_cast<int>(step), galois_keys,
+                                        pool);
+        evaluator.add_inplace(merged[i], layer[2 * i + 1]);
+      }
+    }
+    layer = std::move(merged);
+  }
+  out = std::move(layer[0]);
+}
+
+void expand_slots_seal(const seal::Ciphertext& packed, size_t batch_size,
+                       size_t count, std::vector<seal::Ciphertext>& out,
+                       const seal::GaloisKeys& galois_keys,
+                       HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(count > 0, "No ciphertexts to expand");
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  const auto pool = he_seal_backend.pool();
+
+  size_t top = 1;
+  while (2 * top < count) {
+    top *= 2;
+  }
+  out.resize(count);
+  out[0] = packed;
+  // Offsets below 2 * power are reached once the bits of power are set
+  for (size_t power = top; power > 0; power /= 2) {
+    for (size_t offset = 0; offset < count; offset += 2 * power) {
+      if (offset + power < count) {
+        HEPrimitiveCounter::increment(HEPrimitive::rotate);
+        evaluator.rotate_vector(out[offset],
+                                static_cast<int>(power * batch_size),
+                                galois_keys, out[offset + power], pool);
+      }
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
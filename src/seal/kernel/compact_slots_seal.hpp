@@ -0,0 +1,74 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Returns the number of ciphertexts compact_slots_seal packs into
+/// one ciphertext, i.e. the largest power of two k with
+/// k * batch_size <= slot_count
+/// \param[in] batch_size Number of used slots of each ciphertext
+/// \param[in] slot_count Number of slots of a ciphertext
+size_t compaction_capacity(size_t batch_size, size_t slot_count);
+
+/// \brief Returns the rotation steps used by compact_slots_seal and
+/// expand_slots_seal, i.e. +/- batch_size * 2^j for
+/// 2^j < compaction_capacity(batch_size, slot_count)
+/// \param[in] batch_size Number of used slots of each ciphertext
+/// \param[in] slot_count Number of slots of a ciphertext
+std::set<int> compaction_steps(size_t batch_size, size_t slot_count);
+
+/// \brief Packs slots [0, batch_size) of ciphertext i into slots
+/// [i * batch_size, (i + 1) * batch_size) of one ciphertext. The other slots
+/// of the inputs are zeroed by a mask, whose product is rescaled, so the
+/// output is one level below the inputs, with their scale. Pairs of partial
+/// packings are merged by doubling rotations, so ciphers.size() - 1
+/// rotations are used
+/// \param[in] ciphers Ciphertexts to pack, at most compaction_capacity, with
+/// the same parameters and scale, above the lowest level
+/// \param[in] batch_size Number of used slots of each ciphertext
+/// \param[out] out Packed ciphertext
+/// \param[in] galois_keys Galois keys of the compaction_steps
+/// \param[in] he_seal_backend Backend used for the mask and rotations
+void compact_slots_seal(const std::vector<const seal::Ciphertext*>& ciphers,
+                        size_t batch_size, seal::Ciphertext& out,
+                        const seal::GaloisKeys& galois_keys,
+                        HESealBackend& he_seal_backend);
+
+/// \brief Unpacks a ciphertext packed as by compact_slots_seal. Slots
+/// [0, batch_size) of out[i] store slots [i * batch_size,
+/// (i + 1) * batch_size) of packed, and the other slots store garbage.
+/// Offset i is reached by rotating along its binary digits, so count - 1
+/// rotations are used. The outputs have the level and scale of packed
+/// \param[in] packed Packed ciphertext
+/// \param[in] batch_size Number of used slots of each ciphertext
+/// \param[in] count Number of ciphertexts to unpack
+/// \param[out] out Unpacked ciphertexts
+/// \param[in] galois_keys Galois keys of the compaction_steps
+/// \param[in] he_seal_backend Backend used for the rotations
+void expand_slots_seal(const seal::Ciphertext& packed, size_t batch_size,
+                       size_t count, std::vector<seal::Ciphertext>& out,
+                       const seal::GaloisKeys& galois_keys,
+                       HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
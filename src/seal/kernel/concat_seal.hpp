@@ -23,7 +23,13 @@
 #include "ngraph/shape_util.hpp"
 
 namespace ngraph::runtime::he {
-inline void concat_seal(const std::vector<std::vector<HEType>>& args,
+/// \brief Concatenates tensors along an axis
+/// \param[in] args Data of the tensors to concatenate, which is not copied
+/// \param[out] out Stores the concatenated tensor
+/// \param[in] in_shapes Shapes of the tensors to concatenate
+/// \param[in] out_shape Shape of the concatenated tensor
+/// \param[in] concatenation_axis Axis along which to concatenate
+inline void concat_seal(const std::vector<const std::vector<HEType>*>& args,
                         std::vector<HEType>& out,
                         const std::vector<Shape>& in_shapes,
                         const Shape& out_shape, size_t concatenation_axis) {
@@ -66,7 +72,7 @@ inline void concat_seal(const std::vector<std::vector<HEType>>& args,
           output_chunk_transform.index(*output_chunk_it);
       ++output_chunk_it;
 
-      out[output_chunk_index] = args[i][input_index];
+      out[output_chunk_index] = (*args[i])[input_index];
     }
 
     concatenation_pos += in_shapes[i][concatenation_axis];
@@ -16,10 +16,15 @@
 
 #include "seal/kernel/convolution_seal.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "he_util.hpp"
 #include "logging/ngraph_he_log.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 
 namespace ngraph::runtime::he {
 
@@ -34,9 +39,54 @@ void convolution_seal(
     size_t batch_axis_result, size_t output_channel_axis_result,
     const element::Type& element_type, size_t batch_size,
     HESealBackend& he_seal_backend, bool verbose) {
-  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
-               "Unsupported type ", element_type);
+  convolution_seal_range(
+      arg0, arg1, out, arg0_shape, arg1_shape, out_shape,
+      window_movement_strides, window_dilation_strides, padding_below,
+      padding_above, data_dilation_strides, batch_axis_data,
+      input_channel_axis_data, input_channel_axis_filters,
+      output_channel_axis_filters, batch_axis_result,
+      output_channel_axis_result, element_type, batch_size, he_seal_backend, 0,
+      shape_size(out_shape), verbose);
+}
 
+namespace {
+/// \brief Stores the taps of each output in compressed sparse row form
+ConvolutionIndexTable make_index_table(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const std::vector<std::vector<std::pair<uint32_t, uint32_t>>>& taps) {
+  size_t out_size = taps.size();
+  ConvolutionIndexTable table;
+  table.arg0_shape = arg0_shape;
+  table.arg1_shape = arg1_shape;
+  table.out_shape = out_shape;
+  table.offsets.resize(out_size + 1, 0);
+  for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+    table.offsets[out_idx + 1] = table.offsets[out_idx] + taps[out_idx].size();
+  }
+  table.input_indices.resize(table.offsets.back());
+  table.filter_indices.resize(table.offsets.back());
+
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+    size_t offset = table.offsets[out_idx];
+    for (const auto& [input_idx, filter_idx] : taps[out_idx]) {
+      table.input_indices[offset] = input_idx;
+      table.filter_indices[offset] = filter_idx;
+      ++offset;
+    }
+  }
+  return table;
+}
+}  // namespace
+
+ConvolutionIndexTable convolution_seal_index_table(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result) {
   // Comments throughout assume without loss of generality that:
   //
   // * batch axes for both input data and output data are 0
@@ -44,24 +94,23 @@ void convolution_seal(
   // * output channel axes for filters is 0
   // * output channel axis for output data is 1
   // * rotate_filter is false
+  NGRAPH_CHECK(shape_size(arg0_shape) <= UINT32_MAX &&
+                   shape_size(arg1_shape) <= UINT32_MAX,
+               "Convolution arguments are too large to index");
 
-  // At the outermost level we will walk over every output coordinate O.
-  CoordinateTransform output_transform(out_shape);
-
-  // Store output coordinates for parallelization
-  std::vector<Coordinate> out_coords;
-  for (const Coordinate& out_coord : output_transform) {
-    out_coords.emplace_back(out_coord);
-  }
-  size_t out_transform_size = out_coords.size();
-  if (verbose) {
-    NGRAPH_HE_LOG(5) << "Convolution output size " << out_transform_size;
-  }
+  size_t out_size = shape_size(out_shape);
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> taps(out_size);
 
+  // At the outermost level we will walk over every output coordinate O
 #pragma omp parallel for
-  for (size_t out_coord_idx = 0; out_coord_idx < out_transform_size;
-       ++out_coord_idx) {
-    const Coordinate& out_coord = out_coords[out_coord_idx];
+  for (size_t out_coord_idx = 0; out_coord_idx < out_size; ++out_coord_idx) {
+    // Row-major coordinate of the output index
+    Coordinate out_coord(out_shape.size());
+    size_t remaining_idx = out_coord_idx;
+    for (size_t axis = out_shape.size(); axis-- > 0;) {
+      out_coord[axis] = remaining_idx % out_shape[axis];
+      remaining_idx /= out_shape[axis];
+    }
 
     // for (Coordinate out_coord : output_transform)
     //{
@@ -166,56 +215,353 @@ void convolution_seal(
     CoordinateTransform filter_transform(arg1_shape, filter_transform_start,
                                          filter_transform_end);
 
-    // As we go, we sum up:
+    // As we go, we record the pairs (I, F) summed as:
     //
     //   output[O] += arg0[I] * arg1[F].
 
-    // T result = 0;
-
     CoordinateTransform::Iterator input_it = input_batch_transform.begin();
     CoordinateTransform::Iterator filter_it = filter_transform.begin();
     CoordinateTransform::Iterator input_end = input_batch_transform.end();
     CoordinateTransform::Iterator filter_end = filter_transform.end();
 
-    // TODO(fboemer): better type which matches complex packing?
-    auto sum = HEType(HEPlaintext(batch_size), false);
-    bool first_add = true;
-
+    auto& out_taps = taps[out_coord_idx];
     while (input_it != input_end && filter_it != filter_end) {
       const Coordinate& input_batch_coord = *input_it;
-      Coordinate filter_coord = *filter_it;
+      const Coordinate& filter_coord = *filter_it;
 
       if (input_batch_transform.has_source_coordinate(input_batch_coord)) {
-        auto mult_arg0 = arg0[input_batch_transform.index(input_batch_coord)];
-        auto mult_arg1 = arg1[filter_transform.index(filter_coord)];
-
-        // TODO(fboemer): better type which matches arguments?
-        auto prod = HEType(HEPlaintext(batch_size), false);
-
-        scalar_multiply_seal(mult_arg0, mult_arg1, prod, he_seal_backend);
-        if (first_add) {
-          sum = prod;
-          first_add = false;
-        } else {
-          scalar_add_seal(prod, sum, sum, he_seal_backend);
-        }
+        out_taps.emplace_back(
+            static_cast<uint32_t>(
+                input_batch_transform.index(input_batch_coord)),
+            static_cast<uint32_t>(filter_transform.index(filter_coord)));
       }
       ++input_it;
       ++filter_it;
     }
-    if (first_add) {
-      HEPlaintext zero(batch_size, 0);
-      out[out_coord_idx].set_plaintext(zero);
-    } else {
+  }
+
+  return make_index_table(arg0_shape, arg1_shape, out_shape, taps);
+}
+
+ConvolutionIndexTable group_convolution_seal_index_table(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t groups) {
+  NGRAPH_CHECK(shape_size(arg0_shape) <= UINT32_MAX &&
+                   shape_size(arg1_shape) <= UINT32_MAX,
+               "Convolution arguments are too large to index");
+  NGRAPH_CHECK(arg0_shape.size() >= 3 && out_shape.size() == arg0_shape.size(),
+               "Grouped convolution data ", arg0_shape, " and output ",
+               out_shape, " must have equal rank of at least 3");
+  size_t n_spatial_dimensions = arg0_shape.size() - 2;
+  NGRAPH_CHECK(arg1_shape.size() >= n_spatial_dimensions + 2,
+               "Grouped convolution filters ", arg1_shape,
+               " have too few axes");
+  NGRAPH_CHECK(window_movement_strides.size() == n_spatial_dimensions &&
+                   window_dilation_strides.size() == n_spatial_dimensions &&
+                   padding_below.size() == n_spatial_dimensions &&
+                   padding_above.size() == n_spatial_dimensions &&
+                   data_dilation_strides.size() == n_spatial_dimensions,
+               "Grouped convolution attributes must have ",
+               n_spatial_dimensions, " spatial axes");
+  size_t in_channels = arg0_shape[1];
+  size_t out_channels = out_shape[1];
+  NGRAPH_CHECK(groups > 0 && in_channels % groups == 0 &&
+                   out_channels % groups == 0,
+               "Channels ", in_channels, " and ", out_channels,
+               " are not divisible into ", groups, " groups");
+  size_t group_in_channels = in_channels / groups;
+  size_t group_out_channels = out_channels / groups;
+  Shape window_shape(arg1_shape.end() - n_spatial_dimensions,
+                     arg1_shape.end());
+  size_t window_size = shape_size(window_shape);
+  NGRAPH_CHECK(shape_size(arg1_shape) ==
+                   out_channels * group_in_channels * window_size,
+               "Grouped convolution filters ", arg1_shape,
+               " do not match the data ", arg0_shape, " and output ",
+               out_shape);
+  Shape in_spatial(arg0_shape.begin() + 2, arg0_shape.end());
+  Shape out_spatial(out_shape.begin() + 2, out_shape.end());
+  size_t in_spatial_size = shape_size(in_spatial);
+  size_t out_spatial_size = shape_size(out_spatial);
+
+  size_t out_size = shape_size(out_shape);
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> taps(out_size);
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < out_size; ++out_idx) {
+    size_t spatial_idx = out_idx % out_spatial_size;
+    size_t out_channel = out_idx / out_spatial_size % out_channels;
+    size_t batch = out_idx / out_spatial_size / out_channels;
+    size_t first_in_channel =
+        out_channel / group_out_channels * group_in_channels;
+
+    Coordinate out_coord(n_spatial_dimensions);
+    for (size_t axis = n_spatial_dimensions; axis-- > 0;) {
+      out_coord[axis] = spatial_idx % out_spatial[axis];
+      spatial_idx /= out_spatial[axis];
+    }
+    // Input spatial index of each window position, or in_spatial_size if
+    // the position is in the padding or the dilation gaps
+    std::vector<size_t> window_inputs(window_size);
+    for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+      size_t remaining = window_idx;
+      size_t in_spatial_idx = 0;
+      size_t in_stride = 1;
+      bool in_data = true;
+      for (size_t axis = n_spatial_dimensions; axis-- > 0;) {
+        size_t window_pos = remaining % window_shape[axis];
+        remaining /= window_shape[axis];
+        auto pos = static_cast<std::ptrdiff_t>(
+                       window_movement_strides[axis] * out_coord[axis] +
+                       window_dilation_strides[axis] * window_pos) -
+                   padding_below[axis];
+        auto dilation =
+            static_cast<std::ptrdiff_t>(data_dilation_strides[axis]);
+        if (pos < 0 || pos % dilation != 0 ||
+            static_cast<size_t>(pos / dilation) >= in_spatial[axis]) {
+          in_data = false;
+          break;
+        }
+        in_spatial_idx += static_cast<size_t>(pos / dilation) * in_stride;
+        in_stride *= in_spatial[axis];
+      }
+      window_inputs[window_idx] = in_data ? in_spatial_idx : in_spatial_size;
+    }
+
+    auto& out_taps = taps[out_idx];
+    for (size_t c = 0; c < group_in_channels; ++c) {
+      size_t in_base =
+          (batch * in_channels + first_in_channel + c) * in_spatial_size;
+      size_t filter_base =
+          (out_channel * group_in_channels + c) * window_size;
+      for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+        if (window_inputs[window_idx] != in_spatial_size) {
+          out_taps.emplace_back(
+              static_cast<uint32_t>(in_base + window_inputs[window_idx]),
+              static_cast<uint32_t>(filter_base + window_idx));
+        }
+      }
+    }
+  }
+  return make_index_table(arg0_shape, arg1_shape, out_shape, taps);
+}
+
+void convolution_seal_range(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result,
+    const element::Type& element_type, size_t batch_size,
+    HESealBackend& he_seal_backend, size_t out_begin, size_t out_end,
+    bool verbose) {
+  auto table = convolution_seal_index_table(
+      arg0_shape, arg1_shape, out_shape, window_movement_strides,
+      window_dilation_strides, padding_below, padding_above,
+      data_dilation_strides, batch_axis_data, input_channel_axis_data,
+      input_channel_axis_filters, output_channel_axis_filters,
+      batch_axis_result, output_channel_axis_result);
+  convolution_seal_range(arg0, arg1, out, table, element_type, batch_size,
+                         he_seal_backend, out_begin, out_end, verbose);
+}
+
+void convolution_seal_range(const std::vector<HEType>& arg0,
+                            const std::vector<HEType>& arg1,
+                            std::vector<HEType>& out,
+                            const ConvolutionIndexTable& table,
+                            const element::Type& element_type,
+                            size_t batch_size, HESealBackend& he_seal_backend,
+                            size_t out_begin, size_t out_end, bool verbose) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+  NGRAPH_CHECK(out_begin <= out_end && out_end + 1 <= table.offsets.size(),
+               "Invalid convolution output range [", out_begin, ", ", out_end,
+               ")");
+  if (verbose) {
+    NGRAPH_HE_LOG(5) << "Convolution output size " << out_end - out_begin;
+  }
+
+#pragma omp parallel if (!limb_parallel_elements(out_end - out_begin))
+  {
+    // Reused across the outputs of a thread, since finalize resets it
+    MultiplyAccumulator accumulator(batch_size, he_seal_backend);
+#pragma omp for
+    for (size_t out_coord_idx = out_begin; out_coord_idx < out_end;
+         ++out_coord_idx) {
+      for (size_t tap = table.offsets[out_coord_idx];
+           tap < table.offsets[out_coord_idx + 1]; ++tap) {
+        accumulator.accumulate(arg0[table.input_indices[tap]],
+                               arg1[table.filter_indices[tap]]);
+      }
       // Write the sum back.
-      out[out_coord_idx] = sum;
+      accumulator.finalize(out[out_coord_idx]);
+
+      static const size_t conv_verbosity_idx = 1000;
+      if (verbose && out_coord_idx % conv_verbosity_idx == 0) {
+        NGRAPH_HE_LOG(3) << "Finished out coord " << out_coord_idx;
+      }
     }
+  }
+}
+
+std::optional<WeightedSums> convolution_seal_weighted_sums(
+    const ConvolutionIndexTable& table, const std::vector<HEType>& arg1) {
+  return make_weighted_sums(arg1, table.offsets, table.input_indices,
+                            table.filter_indices);
+}
 
-    static const size_t conv_verbosity_idx = 1000;
-    if (verbose && out_coord_idx % conv_verbosity_idx == 0) {
-      NGRAPH_HE_LOG(3) << "Finished out coord " << out_coord_idx;
+void convolution_seal_range(const std::vector<HEType>& arg0,
+                            const std::vector<HEType>& arg1,
+                            std::vector<HEType>& out, const WeightedSums& sums,
+                            size_t batch_size, HESealBackend& he_seal_backend,
+                            size_t out_begin, size_t out_end) {
+  NGRAPH_CHECK(out_begin <= out_end && 3 * out_end + 1 <= sums.offsets.size(),
+               "Invalid convolution output range [", out_begin, ", ", out_end,
+               ")");
+#pragma omp parallel if (!limb_parallel_elements(out_end - out_begin))
+  {
+    MultiplyAccumulator accumulator(batch_size, he_seal_backend);
+#pragma omp for
+    for (size_t out_idx = out_begin; out_idx < out_end; ++out_idx) {
+      weighted_sum_seal(arg0, arg1, sums, out_idx, 0, out[out_idx],
+                        batch_size, he_seal_backend, accumulator);
     }
   }
 }
 
+bool pointwise_convolution(const Shape& filters_shape,
+                           const Strides& window_movement_strides,
+                           const CoordinateDiff& padding_below,
+                           const CoordinateDiff& padding_above,
+                           const Strides& data_dilation_strides) {
+  auto is_one = [](size_t value) { return value == 1; };
+  auto is_zero = [](std::ptrdiff_t value) { return value == 0; };
+  return filters_shape.size() >= 3 &&
+         std::all_of(filters_shape.begin() + 2, filters_shape.end(), is_one) &&
+         std::all_of(window_movement_strides.begin(),
+                     window_movement_strides.end(), is_one) &&
+         std::all_of(padding_below.begin(), padding_below.end(), is_zero) &&
+         std::all_of(padding_above.begin(), padding_above.end(), is_zero) &&
+         std::all_of(data_dilation_strides.begin(),
+                     data_dilation_strides.end(), is_one);
+}
+
+std::optional<WeightedSums> pointwise_convolution_seal_weighted_sums(
+    const std::vector<HEType>& arg1, size_t in_channels, size_t spatial_size) {
+  NGRAPH_CHECK(in_channels > 0 && arg1.size() % in_channels == 0,
+               "Filters have ", arg1.size(), " elements, not a multiple of ",
+               in_channels, " input channels");
+  if (arg1.size() > UINT32_MAX || in_channels * spatial_size > UINT32_MAX) {
+    return std::nullopt;
+  }
+  size_t out_channels = arg1.size() / in_channels;
+  std::vector<size_t> offsets(out_channels + 1);
+  std::vector<uint32_t> input_indices(arg1.size());
+  std::vector<uint32_t> weight_indices(arg1.size());
+  for (size_t out_channel = 0; out_channel < out_channels; ++out_channel) {
+    offsets[out_channel + 1] = offsets[out_channel] + in_channels;
+    for (size_t c = 0; c < in_channels; ++c) {
+      size_t term = out_channel * in_channels + c;
+      input_indices[term] = static_cast<uint32_t>(c * spatial_size);
+      weight_indices[term] = static_cast<uint32_t>(term);
+    }
+  }
+  return make_weighted_sums(arg1, offsets, input_indices, weight_indices);
+}
+
+namespace {
+// Spatial positions and output channels per block of a pointwise
+// convolution. A block reads in_channels * s_pointwise_positions inputs
+constexpr size_t s_pointwise_positions = 8;
+constexpr size_t s_pointwise_channels = 16;
+
+/// \brief Calls compute(out_idx, out_channel, input_offset) for each output
+/// in [out_begin, out_end), in blocks of spatial positions and output
+/// channels, where input_offset is the index of channel 0 of the output's
+/// batch and spatial position
+template <typename Compute>
+void for_each_pointwise_block(const Shape& arg0_shape, size_t out_channels,
+                              size_t out_begin, size_t out_end,
+                              const Compute& compute) {
+  size_t in_channels = arg0_shape[1];
+  size_t spatial_size =
+      shape_size(Shape(arg0_shape.begin() + 2, arg0_shape.end()));
+  size_t position_blocks = ceil_div(spatial_size, s_pointwise_positions);
+  size_t channel_blocks = ceil_div(out_channels, s_pointwise_channels);
+  size_t num_blocks = arg0_shape[0] * position_blocks * channel_blocks;
+
+#pragma omp parallel for schedule(dynamic)
+  for (size_t block = 0; block < num_blocks; ++block) {
+    size_t channel_block = block % channel_blocks;
+    size_t position_block = block / channel_blocks % position_blocks;
+    size_t batch = block / channel_blocks / position_blocks;
+    size_t position_end = std::min(
+        spatial_size, (position_block + 1) * s_pointwise_positions);
+    size_t channel_end = std::min(
+        out_channels, (channel_block + 1) * s_pointwise_channels);
+    for (size_t position = position_block * s_pointwise_positions;
+         position < position_end; ++position) {
+      size_t input_offset = batch * in_channels * spatial_size + position;
+      for (size_t out_channel = channel_block * s_pointwise_channels;
+           out_channel < channel_end; ++out_channel) {
+        size_t out_idx =
+            (batch * out_channels + out_channel) * spatial_size + position;
+        if (out_idx >= out_begin && out_idx < out_end) {
+          compute(out_idx, out_channel, input_offset);
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+void pointwise_convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, size_t out_channels,
+    const element::Type& element_type, size_t batch_size,
+    HESealBackend& he_seal_backend, size_t out_begin, size_t out_end) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+  size_t in_channels = arg0_shape[1];
+  size_t spatial_size =
+      shape_size(Shape(arg0_shape.begin() + 2, arg0_shape.end()));
+  NGRAPH_CHECK(arg1.size() == out_channels * in_channels, "Filters have ",
+               arg1.size(), " elements, expected ", out_channels * in_channels);
+  NGRAPH_CHECK(out_begin <= out_end && out_end <= out.size(),
+               "Invalid convolution output range [", out_begin, ", ", out_end,
+               ")");
+  for_each_pointwise_block(
+      arg0_shape, out_channels, out_begin, out_end,
+      [&](size_t out_idx, size_t out_channel, size_t input_offset) {
+        MultiplyAccumulator accumulator(batch_size, he_seal_backend);
+        for (size_t c = 0; c < in_channels; ++c) {
+          accumulator.accumulate(arg0[input_offset + c * spatial_size],
+                                 arg1[out_channel * in_channels + c]);
+        }
+        accumulator.finalize(out[out_idx]);
+      });
+}
+
+void pointwise_convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const WeightedSums& channel_sums,
+    const Shape& arg0_shape, size_t batch_size, HESealBackend& he_seal_backend,
+    size_t out_begin, size_t out_end) {
+  size_t out_channels = (channel_sums.offsets.size() - 1) / 3;
+  NGRAPH_CHECK(out_begin <= out_end && out_end <= out.size(),
+               "Invalid convolution output range [", out_begin, ", ", out_end,
+               ")");
+  for_each_pointwise_block(
+      arg0_shape, out_channels, out_begin, out_end,
+      [&](size_t out_idx, size_t out_channel, size_t input_offset) {
+        weighted_sum_seal(arg0, arg1, channel_sums, out_channel, input_offset,
+                          out[out_idx], batch_size, he_seal_backend);
+      });
+}
+
 }  // namespace ngraph::runtime::he
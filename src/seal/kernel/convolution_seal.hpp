@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "logging/ngraph_he_log.hpp"
@@ -24,11 +26,59 @@
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
 #include "seal/kernel/multiply_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 
 namespace ngraph::runtime::he {
 
+/// \brief Input and filter index pairs summed by each convolution output, in
+/// compressed sparse row form. Taps in the padding or the data dilation gaps
+/// are left out
+struct ConvolutionIndexTable {
+  Shape arg0_shape;
+  Shape arg1_shape;
+  Shape out_shape;
+  /// \brief Pairs of output i are in [offsets[i], offsets[i + 1])
+  std::vector<size_t> offsets;
+  std::vector<uint32_t> input_indices;
+  std::vector<uint32_t> filter_indices;
+};
+
+/// \brief Computes the index pairs of each convolution output. Arguments are
+/// as in convolution_seal
+ConvolutionIndexTable convolution_seal_index_table(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result);
+
+/// \brief Computes the index pairs of each output of a grouped convolution,
+/// whose output channels only read the input channels of their group. The
+/// taps are computed directly from the window of each output, so depthwise
+/// convolutions, with one input channel per group, visit no other channels.
+/// Data and output have layout (N, C, spatial...)
+/// \param[in] arg0_shape Shape of the data batch
+/// \param[in] arg1_shape Shape of the filters, either (C_out, C_in / groups,
+/// spatial...) or (groups, C_out / groups, C_in / groups, spatial...), which
+/// have the same row-major layout
+/// \param[in] out_shape Shape of the output
+/// \param[in] window_movement_strides Strides of the window
+/// \param[in] window_dilation_strides Dilation of the window
+/// \param[in] padding_below Padding below the data
+/// \param[in] padding_above Padding above the data
+/// \param[in] data_dilation_strides Dilation of the data
+/// \param[in] groups Number of channel groups
+ConvolutionIndexTable group_convolution_seal_index_table(
+    const Shape& arg0_shape, const Shape& arg1_shape, const Shape& out_shape,
+    const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t groups);
+
 void convolution_seal(
     const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
     std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
@@ -41,4 +91,135 @@ void convolution_seal(
     const element::Type& element_type, size_t batch_size,
     HESealBackend& he_seal_backend, bool verbose = true);
 
+/// \brief Computes the convolution outputs with row-major index in
+/// [out_begin, out_end), leaving other outputs unchanged. Arguments are as
+/// in convolution_seal
+/// \param[in] out_begin Index of the first output to compute
+/// \param[in] out_end Index past the last output to compute
+void convolution_seal_range(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, const Shape& arg1_shape,
+    const Shape& out_shape, const Strides& window_movement_strides,
+    const Strides& window_dilation_strides, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, const Strides& data_dilation_strides,
+    size_t batch_axis_data, size_t input_channel_axis_data,
+    size_t input_channel_axis_filters, size_t output_channel_axis_filters,
+    size_t batch_axis_result, size_t output_channel_axis_result,
+    const element::Type& element_type, size_t batch_size,
+    HESealBackend& he_seal_backend, size_t out_begin, size_t out_end,
+    bool verbose = true);
+
+/// \brief Computes the convolution outputs with row-major index in
+/// [out_begin, out_end) from precomputed index pairs
+/// \param[in] arg0 Data batch
+/// \param[in] arg1 Filters
+/// \param[out] out Convolution output
+/// \param[in] table Index pairs of the convolution, see
+/// convolution_seal_index_table
+/// \param[in] element_type Data type of the elements
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+/// \param[in] out_begin Index of the first output to compute
+/// \param[in] out_end Index past the last output to compute
+/// \param[in] verbose Whether or not to log progress
+void convolution_seal_range(const std::vector<HEType>& arg0,
+                            const std::vector<HEType>& arg1,
+                            std::vector<HEType>& out,
+                            const ConvolutionIndexTable& table,
+                            const element::Type& element_type,
+                            size_t batch_size, HESealBackend& he_seal_backend,
+                            size_t out_begin, size_t out_end,
+                            bool verbose = true);
+
+/// \brief Groups the products of each convolution output by filter weight,
+/// see make_weighted_sums
+/// \param[in] table Index pairs of the convolution
+/// \param[in] arg1 Filters
+/// \returns The grouped sums, or std::nullopt if the filters are not made of
+/// real scalar plaintexts
+std::optional<WeightedSums> convolution_seal_weighted_sums(
+    const ConvolutionIndexTable& table, const std::vector<HEType>& arg1);
+
+/// \brief Computes the convolution outputs with row-major index in
+/// [out_begin, out_end) from their products grouped by filter weight. Zero
+/// weights are skipped
+/// \param[in] arg0 Data batch
+/// \param[in] arg1 Filters
+/// \param[out] out Convolution output
+/// \param[in] sums Products of each output, see
+/// convolution_seal_weighted_sums
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+/// \param[in] out_begin Index of the first output to compute
+/// \param[in] out_end Index past the last output to compute
+void convolution_seal_range(const std::vector<HEType>& arg0,
+                            const std::vector<HEType>& arg1,
+                            std::vector<HEType>& out, const WeightedSums& sums,
+                            size_t batch_size, HESealBackend& he_seal_backend,
+                            size_t out_begin, size_t out_end);
+
+/// \brief Returns whether or not a convolution is pointwise, i.e. has 1x1
+/// filters, unit strides, no padding and no data dilation, so output (n, j, p)
+/// is the product of row j of the filters with channels (n, :, p) of the data
+/// \param[in] filters_shape Shape of the filters
+/// \param[in] window_movement_strides Strides of the window
+/// \param[in] padding_below Padding below the data
+/// \param[in] padding_above Padding above the data
+/// \param[in] data_dilation_strides Dilation of the data
+bool pointwise_convolution(const Shape& filters_shape,
+                           const Strides& window_movement_strides,
+                           const CoordinateDiff& padding_below,
+                           const CoordinateDiff& padding_above,
+                           const Strides& data_dilation_strides);
+
+/// \brief Groups the products of each output channel of a pointwise
+/// convolution by weight, see make_weighted_sums. Input indices are relative
+/// to channel 0 of the output's batch and spatial position
+/// \param[in] arg1 Filters, of shape (out_channels, in_channels, 1, ...)
+/// \param[in] in_channels Number of input channels
+/// \param[in] spatial_size Number of spatial positions of the data
+/// \returns Sum j of the products of output channel j, or std::nullopt if
+/// the filters are not made of real scalar plaintexts
+std::optional<WeightedSums> pointwise_convolution_seal_weighted_sums(
+    const std::vector<HEType>& arg1, size_t in_channels, size_t spatial_size);
+
+/// \brief Computes the outputs with row-major index in [out_begin, out_end)
+/// of a pointwise convolution as a matrix product of the filters with the
+/// channels at each spatial position. Outputs are computed in blocks of
+/// spatial positions and output channels, so each input is reused by the
+/// output channels of its block while it is still in cache
+/// \param[in] arg0 Data batch
+/// \param[in] arg1 Filters, of shape (out_channels, in_channels, 1, ...)
+/// \param[out] out Convolution output
+/// \param[in] arg0_shape Shape of the data batch
+/// \param[in] out_channels Number of output channels
+/// \param[in] element_type Data type of the elements
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+/// \param[in] out_begin Index of the first output to compute
+/// \param[in] out_end Index past the last output to compute
+void pointwise_convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const Shape& arg0_shape, size_t out_channels,
+    const element::Type& element_type, size_t batch_size,
+    HESealBackend& he_seal_backend, size_t out_begin, size_t out_end);
+
+/// \brief Computes the same outputs as pointwise_convolution_seal from the
+/// products grouped by filter weight. Zero weights are skipped
+/// \param[in] arg0 Data batch
+/// \param[in] arg1 Filters
+/// \param[out] out Convolution output
+/// \param[in] channel_sums Products of each output channel, see
+/// pointwise_convolution_seal_weighted_sums
+/// \param[in] arg0_shape Shape of the data batch
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+/// \param[in] out_begin Index of the first output to compute
+/// \param[in] out_end Index past the last output to compute
+void pointwise_convolution_seal(
+    const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+    std::vector<HEType>& out, const WeightedSums& channel_sums,
+    const Shape& arg0_shape, size_t batch_size, HESealBackend& he_seal_backend,
+    size_t out_begin, size_t out_end);
+
 }  // namespace ngraph::runtime::he
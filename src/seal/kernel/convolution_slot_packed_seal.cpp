@@ -0,0 +1,158 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "seal/kernel/convolution_slot_packed_seal.hpp"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/seal.h"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+size_t slot_packed_convolution_slot(size_t out_row, size_t out_col,
+                                    const Shape& data_shape,
+                                    const Strides& window_movement_strides) {
+  return out_row * window_movement_strides[0] * data_shape[2] +
+         out_col * window_movement_strides[1];
+}
+
+Shape slot_packed_convolution_shape(const Shape& data_shape,
+                                    const Shape& filter_shape,
+                                    const Strides& window_movement_strides,
+                                    const Strides& window_dilation_strides) {
+  NGRAPH_CHECK(data_shape.size() == 3, "Data shape must be {C, H, W}");
+  NGRAPH_CHECK(filter_shape.size() == 4,
+               "Filter shape must be {OC, C, KH, KW}");
+  NGRAPH_CHECK(window_movement_strides.size() == 2,
+               "Window movement strides must be 2-dimensional");
+  NGRAPH_CHECK(window_dilation_strides.size() == 2,
+               "Window dilation strides must be 2-dimensional");
+  NGRAPH_CHECK(data_shape[0] == filter_shape[1], "Data channels ",
+               data_shape[0], " do not match filter channels ",
+               filter_shape[1]);
+
+  Shape out_shape(2);
+  for (size_t axis = 0; axis < 2; ++axis) {
+    size_t window =
+        (filter_shape[axis + 2] - 1) * window_dilation_strides[axis] + 1;
+    NGRAPH_CHECK(window <= data_shape[axis + 1], "Filter window ", window,
+                 " exceeds data size ", data_shape[axis + 1]);
+    out_shape[axis] =
+        (data_shape[axis + 1] - window) / window_movement_strides[axis] + 1;
+  }
+  return out_shape;
+}
+
+void convolution_slot_packed_seal(const SealCiphertextWrapper& arg0,
+                                  const std::vector<double>& filter,
+                                  const Shape& data_shape,
+                                  const Shape& filter_shape,
+                                  const Strides& window_movement_strides,
+                                  const Strides& window_dilation_strides,
+                                  std::vector<SealCiphertextWrapper>& out,
+                                  HESealBackend& he_seal_backend) {
+  // Validates the shapes
+  slot_packed_convolution_shape(data_shape, filter_shape,
+                                window_movement_strides,
+                                window_dilation_strides);
+  NGRAPH_CHECK(filter.size() == shape_size(filter_shape), "Filter size ",
+               filter.size(), " does not match filter shape ", filter_shape);
+  NGRAPH_CHECK(!he_seal_backend.complex_packing(),
+               "Slot-packed convolution does not support complex packing");
+  NGRAPH_CHECK(shape_size(data_shape) <=
+                   he_seal_backend.get_ckks_encoder()->slot_count(),
+               "Data shape ", data_shape,
+               " does not fit in a single ciphertext");
+  NGRAPH_CHECK(he_seal_backend.get_chain_index(arg0) > 0,
+               "Multiplicative depth exceeded for arg0");
+
+  const size_t out_channels = filter_shape[0];
+  const size_t in_channels = filter_shape[1];
+  const size_t filter_rows = filter_shape[2];
+  const size_t filter_cols = filter_shape[3];
+  const size_t taps = in_channels * filter_rows * filter_cols;
+  const size_t image_size = data_shape[1] * data_shape[2];
+
+  auto& evaluator = *he_seal_backend.get_evaluator();
+
+  // Each filter tap (c, kh, kw) reads the input at a fixed slot offset from
+  // the output slot, so a single rotation per tap is shared by all output
+  // channels. Taps which are zero for every output channel are skipped.
+  std::vector<char> tap_used(taps, 0);
+  for (size_t oc = 0; oc < out_channels; ++oc) {
+    bool channel_used = false;
+    for (size_t tap = 0; tap < taps; ++tap) {
+      if (filter[oc * taps + tap] != 0.) {
+        tap_used[tap] = 1;
+        channel_used = true;
+      }
+    }
+    NGRAPH_CHECK(channel_used, "Output channel ", oc,
+                 " has an all-zero filter");
+  }
+
+  auto tap_offset = [&](size_t tap) {
+    size_t channel = tap / (filter_rows * filter_cols);
+    size_t row = (tap / filter_cols) % filter_rows;
+    size_t col = tap % filter_cols;
+    return channel * image_size +
+           row * window_dilation_strides[0] * data_shape[2] +
+           col * window_dilation_strides[1];
+  };
+
+  // The taps rotate the same ciphertext, so they share one decomposition
+  std::vector<int> used_offsets;
+  for (size_t tap = 0; tap < taps; ++tap) {
+    if (tap_used[tap] != 0) {
+      used_offsets.emplace_back(static_cast<int>(tap_offset(tap)));
+    }
+  }
+  std::vector<seal::Ciphertext> used_rotations;
+  he_seal_backend.rotate_hoisted(arg0.ciphertext(), used_offsets,
+                                 used_rotations);
+  std::vector<seal::Ciphertext> rotations(taps);
+  for (size_t tap = 0, used_idx = 0; tap < taps; ++tap) {
+    if (tap_used[tap] != 0) {
+      rotations[tap] = std::move(used_rotations[used_idx++]);
+    }
+  }
+
+  out.resize(out_channels);
+#pragma omp parallel for
+  for (size_t oc = 0; oc < out_channels; ++oc) {
+    bool first_add = true;
+    seal::Ciphertext prod;
+    for (size_t tap = 0; tap < taps; ++tap) {
+      double weight = filter[oc * taps + tap];
+      if (weight == 0.) {
+        continue;
+      }
+      if (first_add) {
+        multiply_plain(rotations[tap], weight, out[oc].ciphertext(),
+                       he_seal_backend);
+        first_add = false;
+      } else {
+        multiply_plain(rotations[tap], weight, prod, he_seal_backend);
+        evaluator.add_inplace(out[oc].ciphertext(), prod);
+      }
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,74 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <vector>
+
+#include "ngraph/shape.hpp"
+#include "ngraph/strides.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Returns the slot storing output coordinate (out_row, out_col) of a
+/// slot-packed convolution
+/// \param[in] out_row Row of the output coordinate
+/// \param[in] out_col Column of the output coordinate
+/// \param[in] data_shape Shape {C, H, W} of the input image
+/// \param[in] window_movement_strides Strides {stride_h, stride_w}
+size_t slot_packed_convolution_slot(size_t out_row, size_t out_col,
+                                    const Shape& data_shape,
+                                    const Strides& window_movement_strides);
+
+/// \brief Returns the output spatial shape {OH, OW} of a slot-packed
+/// convolution without padding
+/// \param[in] data_shape Shape {C, H, W} of the input image
+/// \param[in] filter_shape Shape {OC, C, KH, KW} of the filter
+/// \param[in] window_movement_strides Strides {stride_h, stride_w}
+/// \param[in] window_dilation_strides Dilations {dilation_h, dilation_w}
+Shape slot_packed_convolution_shape(const Shape& data_shape,
+                                    const Shape& filter_shape,
+                                    const Strides& window_movement_strides,
+                                    const Strides& window_dilation_strides);
+
+/// \brief Convolves a single image packed into the slots of one ciphertext
+/// with a plaintext filter, by rotating the image once per filter tap and
+/// accumulating scalar multiples of the rotations. Slot c*H*W + h*W + w of
+/// the input stores pixel (c, h, w). One ciphertext is produced per output
+/// channel, storing output (oh, ow) at the slot given by
+/// slot_packed_convolution_slot. Other slots store garbage. The outputs are
+/// not rescaled.
+/// \param[in] arg0 Ciphertext storing the input image
+/// \param[in] filter Plaintext filter values in row-major {OC, C, KH, KW}
+/// order
+/// \param[in] data_shape Shape {C, H, W} of the input image
+/// \param[in] filter_shape Shape {OC, C, KH, KW} of the filter
+/// \param[in] window_movement_strides Strides {stride_h, stride_w}
+/// \param[in] window_dilation_strides Dilations {dilation_h, dilation_w}
+/// \param[out] out Ciphertexts storing the result, one per output channel
+/// \param[in] he_seal_backend Backend used for rotations and multiplication
+void convolution_slot_packed_seal(const SealCiphertextWrapper& arg0,
+                                  const std::vector<double>& filter,
+                                  const Shape& data_shape,
+                                  const Shape& filter_shape,
+                                  const Strides& window_movement_strides,
+                                  const Strides& window_dilation_strides,
+                                  std::vector<SealCiphertextWrapper>& out,
+                                  HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,260 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/convolution_winograd_seal.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "he_util.hpp"
+#include "ngraph/check.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+// F(2x2, 3x3) transforms: inputs are transformed by B^T d B, filters by
+// G g G^T, and products by A^T m A
+constexpr int s_input_transform[4][4] = {
+    {1, 0, -1, 0}, {0, 1, 1, 0}, {0, -1, 1, 0}, {0, 1, 0, -1}};
+constexpr double s_filter_transform[4][3] = {
+    {1, 0, 0}, {0.5, 0.5, 0.5}, {0.5, -0.5, 0.5}, {0, 0, 1}};
+constexpr int s_output_transform[2][4] = {{1, 1, 1, 0}, {0, 1, -1, -1}};
+
+/// \brief Adds sign * term to sum, which is empty while nullptr
+void add_signed(std::shared_ptr<SealCiphertextWrapper>& sum,
+                const seal::Ciphertext& term, int sign,
+                seal::Evaluator& evaluator) {
+  if (sum == nullptr) {
+    sum = HESealBackend::create_empty_ciphertext();
+    sum->ciphertext() = term;
+    if (sign < 0) {
+      evaluator.negate_inplace(sum->ciphertext());
+    }
+  } else if (sign > 0) {
+    evaluator.add_inplace(sum->ciphertext(), term);
+  } else {
+    evaluator.sub_inplace(sum->ciphertext(), term);
+  }
+}
+}  // namespace
+
+bool winograd_convolution(const Shape& filters_shape,
+                          const Strides& window_movement_strides,
+                          const Strides& window_dilation_strides,
+                          const Strides& data_dilation_strides) {
+  auto is_one = [](size_t value) { return value == 1; };
+  return filters_shape.size() == 4 && filters_shape[2] == 3 &&
+         filters_shape[3] == 3 &&
+         std::all_of(window_movement_strides.begin(),
+                     window_movement_strides.end(), is_one) &&
+         std::all_of(window_dilation_strides.begin(),
+                     window_dilation_strides.end(), is_one) &&
+         std::all_of(data_dilation_strides.begin(),
+                     data_dilation_strides.end(), is_one);
+}
+
+bool winograd_convolution_data(const std::vector<HEType>& arg0) {
+  if (arg0.empty() || !arg0[0].is_ciphertext()) {
+    return false;
+  }
+  const seal::Ciphertext& first = arg0[0].get_ciphertext()->ciphertext();
+  return std::all_of(arg0.begin(), arg0.end(), [&](const HEType& he_type) {
+    if (he_type.is_plaintext() || he_type.complex_packing()) {
+      return false;
+    }
+    const seal::Ciphertext& cipher = he_type.get_ciphertext()->ciphertext();
+    return cipher.size() == 2 && cipher.parms_id() == first.parms_id() &&
+           cipher.scale() == first.scale();
+  });
+}
+
+std::optional<std::vector<HEType>> winograd_filter_transform(
+    const std::vector<HEType>& arg1, const Shape& filters_shape) {
+  NGRAPH_CHECK(filters_shape.size() == 4 && filters_shape[2] == 3 &&
+                   filters_shape[3] == 3,
+               "Winograd filters ", filters_shape, " are not 3x3");
+  NGRAPH_CHECK(arg1.size() == shape_size(filters_shape), "Filters have ",
+               arg1.size(), " elements, expected ", shape_size(filters_shape));
+  size_t num_filters = filters_shape[0] * filters_shape[1];
+  std::vector<HEType> transformed;
+  transformed.reserve(num_filters * 16);
+  for (size_t filter = 0; filter < num_filters; ++filter) {
+    double g[3][3];
+    for (size_t k = 0; k < 3; ++k) {
+      for (size_t l = 0; l < 3; ++l) {
+        const HEType& weight = arg1[(filter * 3 + k) * 3 + l];
+        if (!weight.is_plaintext() || weight.complex_packing() ||
+            weight.get_plaintext().size() != 1) {
+          return std::nullopt;
+        }
+        g[k][l] = weight.get_plaintext()[0];
+      }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      for (size_t j = 0; j < 4; ++j) {
+        double value = 0;
+        for (size_t k = 0; k < 3; ++k) {
+          for (size_t l = 0; l < 3; ++l) {
+            value += s_filter_transform[i][k] * g[k][l] *
+                     s_filter_transform[j][l];
+          }
+        }
+        transformed.emplace_back(HEPlaintext({value}), false);
+      }
+    }
+  }
+  return transformed;
+}
+
+void convolution_winograd_seal(const std::vector<HEType>& arg0,
+                               const std::vector<HEType>& transformed_filters,
+                               std::vector<HEType>& out,
+                               const Shape& arg0_shape, const Shape& out_shape,
+                               const CoordinateDiff& padding_below,
+                               size_t batch_size,
+                               HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(arg0_shape.size() == 4 && out_shape.size() == 4 &&
+                   padding_below.size() == 2,
+               "Winograd convolution needs two spatial axes");
+  size_t batch = arg0_shape[0];
+  size_t in_channels = arg0_shape[1];
+  size_t in_height = arg0_shape[2];
+  size_t in_width = arg0_shape[3];
+  size_t out_channels = out_shape[1];
+  size_t out_height = out_shape[2];
+  size_t out_width = out_shape[3];
+  NGRAPH_CHECK(arg0.size() == shape_size(arg0_shape), "Data has ",
+               arg0.size(), " elements, expected ", shape_size(arg0_shape));
+  NGRAPH_CHECK(out.size() == shape_size(out_shape), "Output has ",
+               out.size(), " elements, expected ", shape_size(out_shape));
+  NGRAPH_CHECK(transformed_filters.size() == out_channels * in_channels * 16,
+               "Transformed filters have ", transformed_filters.size(),
+               " elements, expected ", out_channels * in_channels * 16);
+  auto& evaluator = *he_seal_backend.get_evaluator();
+
+  size_t tiles_width = ceil_div(out_width, 2);
+  size_t num_tiles = ceil_div(out_height, 2) * tiles_width;
+
+  // Transformed input tiles, indexed by batch, input channel, tile and tile
+  // element. Elements whose terms are all in the padding are nullptr
+  std::vector<std::shared_ptr<SealCiphertextWrapper>> transformed(
+      batch * in_channels * num_tiles * 16);
+#pragma omp parallel for
+  for (size_t idx = 0; idx < batch * in_channels * num_tiles; ++idx) {
+    size_t tile = idx % num_tiles;
+    size_t channel = idx / num_tiles;
+    auto first_row = static_cast<std::ptrdiff_t>(2 * (tile / tiles_width)) -
+                     padding_below[0];
+    auto first_col = static_cast<std::ptrdiff_t>(2 * (tile % tiles_width)) -
+                     padding_below[1];
+    const seal::Ciphertext* data[4][4];
+    for (size_t k = 0; k < 4; ++k) {
+      for (size_t l = 0; l < 4; ++l) {
+        auto row = first_row + static_cast<std::ptrdiff_t>(k);
+        auto col = first_col + static_cast<std::ptrdiff_t>(l);
+        bool in_data = row >= 0 && col >= 0 &&
+                       static_cast<size_t>(row) < in_height &&
+                       static_cast<size_t>(col) < in_width;
+        data[k][l] =
+            in_data ? &arg0[(channel * in_height + static_cast<size_t>(row)) *
+                                in_width +
+                            static_cast<size_t>(col)]
+                           .get_ciphertext()
+                           ->ciphertext()
+                    : nullptr;
+      }
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      for (size_t j = 0; j < 4; ++j) {
+        auto& element = transformed[idx * 16 + i * 4 + j];
+        for (size_t k = 0; k < 4; ++k) {
+          for (size_t l = 0; l < 4; ++l) {
+            int sign = s_input_transform[i][k] * s_input_transform[j][l];
+            if (sign != 0 && data[k][l] != nullptr) {
+              add_signed(element, *data[k][l], sign, evaluator);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Each output tile sums the products over the input channels, and
+  // transforms them back
+#pragma omp parallel for
+  for (size_t idx = 0; idx < batch * out_channels * num_tiles; ++idx) {
+    size_t tile = idx % num_tiles;
+    size_t out_channel = idx / num_tiles % out_channels;
+    size_t batch_idx = idx / num_tiles / out_channels;
+
+    std::vector<HEType> products;
+    products.reserve(16);
+    for (size_t element = 0; element < 16; ++element) {
+      MultiplyAccumulator accumulator(batch_size, he_seal_backend);
+      for (size_t in_channel = 0; in_channel < in_channels; ++in_channel) {
+        const auto& input =
+            transformed[((batch_idx * in_channels + in_channel) * num_tiles +
+                         tile) *
+                            16 +
+                        element];
+        if (input != nullptr) {
+          accumulator.accumulate(
+              HEType(input, false, batch_size),
+              transformed_filters[(out_channel * in_channels + in_channel) *
+                                      16 +
+                                  element]);
+        }
+      }
+      products.emplace_back(HEPlaintext(), false);
+      accumulator.finalize(products.back());
+    }
+
+    size_t first_row = 2 * (tile / tiles_width);
+    size_t first_col = 2 * (tile % tiles_width);
+    for (size_t r = 0; r < 2 && first_row + r < out_height; ++r) {
+      for (size_t c = 0; c < 2 && first_col + c < out_width; ++c) {
+        // Plaintext products are zero, since the inputs are ciphertexts
+        std::shared_ptr<SealCiphertextWrapper> sum;
+        for (size_t i = 0; i < 4; ++i) {
+          for (size_t j = 0; j < 4; ++j) {
+            int sign = s_output_transform[r][i] * s_output_transform[c][j];
+            const HEType& product = products[i * 4 + j];
+            if (sign != 0 && product.is_ciphertext()) {
+              add_signed(sum, product.get_ciphertext()->ciphertext(), sign,
+                         evaluator);
+            }
+          }
+        }
+        HEType& dst =
+            out[((batch_idx * out_channels + out_channel) * out_height +
+                 first_row + r) *
+                    out_width +
+                first_col + c];
+        if (sum == nullptr) {
+          MultiplyAccumulator(batch_size, he_seal_backend).finalize(dst);
+        } else {
+          dst = HEType(sum, false, batch_size);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
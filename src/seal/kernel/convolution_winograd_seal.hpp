@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "he_type.hpp"
+#include "ngraph/coordinate_diff.hpp"
+#include "ngraph/shape.hpp"
+#include "ngraph/strides.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Returns whether or not a convolution can be computed with the
+/// Winograd transform F(2x2, 3x3), i.e. has two spatial axes, 3x3 filters,
+/// unit strides and no window or data dilation
+/// \param[in] filters_shape Shape of the filters
+/// \param[in] window_movement_strides Strides of the window
+/// \param[in] window_dilation_strides Dilation of the window
+/// \param[in] data_dilation_strides Dilation of the data
+bool winograd_convolution(const Shape& filters_shape,
+                          const Strides& window_movement_strides,
+                          const Strides& window_dilation_strides,
+                          const Strides& data_dilation_strides);
+
+/// \brief Returns whether or not data can be transformed by
+/// convolution_winograd_seal, i.e. is made of ciphertexts without complex
+/// packing at the same level and scale, which are added without matching
+/// \param[in] arg0 Data batch
+bool winograd_convolution_data(const std::vector<HEType>& arg0);
+
+/// \brief Transforms each 3x3 filter g to the 4x4 filter G g G^T of
+/// F(2x2, 3x3). Since the filters are plaintexts, this runs once per
+/// Constant, and its additions cost no ciphertext operations
+/// \param[in] arg1 Filters, of shape (C_out, C_in, 3, 3)
+/// \param[in] filters_shape Shape of the filters
+/// \returns Transformed filters, of shape (C_out, C_in, 4, 4), or
+/// std::nullopt if the filters are not made of real scalar plaintexts
+std::optional<std::vector<HEType>> winograd_filter_transform(
+    const std::vector<HEType>& arg1, const Shape& filters_shape);
+
+/// \brief Computes a 3x3 convolution with unit strides by the Winograd
+/// transform F(2x2, 3x3). Each 4x4 input tile is transformed to B^T d B,
+/// multiplied elementwise by the transformed filters and summed over the
+/// input channels, and transformed back to a 2x2 output tile by A^T m A.
+/// B and A only have entries 0 and +-1, so the transforms are ciphertext
+/// additions, and each output tile costs 16 rather than 36 products per
+/// pair of channels. All products are at the same scale, so the output is
+/// rescaled like a direct convolution. The input transform sums up to 4
+/// ciphertexts before each product, and the output transform sums up to 9
+/// products, so the output noise grows by a few bits over the direct kernel
+/// \param[in] arg0 Data batch, of shape (N, C_in, H, W), see
+/// winograd_convolution_data
+/// \param[in] transformed_filters Filters, see winograd_filter_transform
+/// \param[out] out Convolution output, of shape (N, C_out, H_out, W_out)
+/// \param[in] arg0_shape Shape of the data batch
+/// \param[in] out_shape Shape of the output
+/// \param[in] padding_below Padding below the data. The padding above is
+/// implied by the output shape
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+void convolution_winograd_seal(const std::vector<HEType>& arg0,
+                               const std::vector<HEType>& transformed_filters,
+                               std::vector<HEType>& out,
+                               const Shape& arg0_shape, const Shape& out_shape,
+                               const CoordinateDiff& padding_below,
+                               size_t batch_size,
+                               HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
@@ -19,11 +19,16 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "ngraph/type/element_type.hpp"
+#include "seal/he_primitive_counter.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
@@ -31,13 +36,52 @@ namespace ngraph::runtime::he {
 
 void scalar_divide_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
                         HEPlaintext& out) {
-  out.resize(arg0.size());
-  std::transform(arg0.begin(), arg0.end(), arg1.begin(), out.begin(),
-                 std::divides<>());
+  plaintext_binary_op_seal(arg0, arg1, out, std::divides<>());
+}
+
+std::vector<double> reciprocal_polynomial(double lower, double upper,
+                                          size_t degree) {
+  if (degree == 0) {
+    return {};
+  }
+  return chebyshev_coefficients([](double x) { return 1 / x; }, degree, lower,
+                                upper);
 }
 
 void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
+                        const std::vector<double>& reciprocal_coeffs,
                         HESealBackend& he_seal_backend) {
+  if (!arg1.is_ciphertext() || reciprocal_coeffs.empty()) {
+    scalar_divide_seal(arg0, arg1, out, he_seal_backend);
+    return;
+  }
+  HEType reciprocal(HEPlaintext(), arg1.complex_packing());
+  scalar_polynomial_seal(arg1, reciprocal_coeffs, reciprocal,
+                         he_seal_backend);
+  HEType product(HEPlaintext(), arg1.complex_packing());
+  scalar_multiply_seal(arg0, reciprocal, product, he_seal_backend);
+
+  // Only the complex-packed ciphertext multiplication rescales
+  bool rescaled = arg0.is_ciphertext() && reciprocal.is_ciphertext() &&
+                  arg0.complex_packing();
+  if (product.is_ciphertext() && !rescaled) {
+    HEPrimitiveCounter::increment(HEPrimitive::rescale);
+    rescale_inplace(product.get_ciphertext()->ciphertext(),
+                    *he_seal_backend.get_evaluator(),
+                    he_seal_backend.rescale_primes(), he_seal_backend.pool());
+  }
+  out = std::move(product);
+}
+
+void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
+                        HESealBackend& he_seal_backend) {
+  if (arg1.is_ciphertext() && he_seal_backend.polynomial_degree() > 0) {
+    const auto& range = he_seal_backend.polynomial_divisor_range();
+    std::vector<double> reciprocal_coeffs = reciprocal_polynomial(
+        range.first, range.second, he_seal_backend.polynomial_degree());
+    scalar_divide_seal(arg0, arg1, out, reciprocal_coeffs, he_seal_backend);
+    return;
+  }
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                  "Complex packing types don't match");
@@ -45,7 +89,6 @@ void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
                    "is not privacy-preserving ";
 
     // TODO(fboemer): enable with client?
-    // TODO(fboemer): complex packing?
     HEPlaintext plain_arg0;
     HEPlaintext plain_arg1;
     he_seal_backend.decrypt(plain_arg0, *arg0.get_ciphertext(),
@@ -71,13 +114,13 @@ void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
                    "is not privacy-preserving ";
 
     // TODO(fboemer): enable with client?
-    // TODO(fboemer): complex packing?
     HEPlaintext plain_arg1;
     he_seal_backend.decrypt(plain_arg1, *arg1.get_ciphertext(),
                             arg1.batch_size(), arg1.complex_packing());
     scalar_divide_seal(arg0.get_plaintext(), plain_arg1, plain_arg1);
     he_seal_backend.encrypt(out.get_ciphertext(), plain_arg1, element::f32,
-                            arg0.complex_packing());
+                            arg1.complex_packing());
+    out.complex_packing() = arg1.complex_packing();
 
   } else if (arg0.is_plaintext() && arg1.is_plaintext()) {
     out.set_plaintext(arg0.get_plaintext());
@@ -93,10 +136,13 @@ void divide_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
                "Unsupported type ", element_type);
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
-    scalar_divide_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  const auto& range = he_seal_backend.polynomial_divisor_range();
+  std::vector<double> reciprocal_coeffs = reciprocal_polynomial(
+      range.first, range.second, he_seal_backend.polynomial_degree());
+  parallel_for_seal(count, {&arg0, &arg1}, [&](size_t i) {
+    scalar_divide_seal(arg0[i], arg1[i], out[i], reciprocal_coeffs,
+                       he_seal_backend);
+  });
 }
 
 }  // namespace ngraph::runtime::he
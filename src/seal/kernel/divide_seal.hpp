@@ -33,6 +33,27 @@ void scalar_divide_seal(const HEType& arg0, const HEType& arg1, HEType& out,
                         seal::CKKSEncoder& ckks_encoder,
                         seal::Encryptor& encryptor, seal::Decryptor& decryptor);
 
+/// \brief Returns the coefficients of the polynomial with which reciprocals
+/// of ciphertexts are approximated, or an empty vector if ciphertext divisors
+/// are decrypted
+/// \param[in] lower Lower bound of the divisors
+/// \param[in] upper Upper bound of the divisors
+/// \param[in] degree Degree of the approximation. 0 decrypts the divisors
+std::vector<double> reciprocal_polynomial(double lower, double upper,
+                                          size_t degree);
+
+/// \brief Divides two cipher or plaintext elements. Ciphertext divisors are
+/// inverted by the polynomial reciprocal_coeffs when it is non-empty, and the
+/// product with the inverse is rescaled
+/// \param[in] arg0 Cipher or plaintext dividend
+/// \param[in] arg1 Cipher or plaintext divisor
+/// \param[out] out Stores the quotient. May be arg0 or arg1
+/// \param[in] reciprocal_coeffs Coefficients from reciprocal_polynomial
+/// \param[in] he_seal_backend Backend used to perform the division
+void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
+                        const std::vector<double>& reciprocal_coeffs,
+                        HESealBackend& he_seal_backend);
+
 void scalar_divide_seal(HEType& arg0, HEType& arg1, HEType& out,
                         HESealBackend& he_seal_backend);
 
@@ -0,0 +1,219 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "seal/kernel/dot_diagonal_seal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Returns the number of baby steps of the baby-step giant-step
+/// product, such that diagonal i = giant * baby_steps + baby
+size_t diagonal_baby_steps(size_t period) {
+  return static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(period))));
+}
+}  // namespace
+
+size_t diagonal_dot_period(size_t rows, size_t cols) {
+  size_t period = 1;
+  while (period < std::max(rows, cols)) {
+    period <<= 1U;
+  }
+  return period;
+}
+
+std::vector<double> replicate_for_diagonal_dot(const std::vector<double>& input,
+                                               size_t period,
+                                               size_t slot_count) {
+  NGRAPH_CHECK(input.size() <= period, "Input size ", input.size(),
+               " exceeds period ", period);
+  NGRAPH_CHECK(slot_count % period == 0, "Period ", period,
+               " does not divide slot count ", slot_count);
+  std::vector<double> replicated(slot_count, 0);
+  for (size_t slot = 0; slot < slot_count; ++slot) {
+    size_t idx = slot % period;
+    if (idx < input.size()) {
+      replicated[slot] = input[idx];
+    }
+  }
+  return replicated;
+}
+
+size_t EncodedDiagonals::byte_count() const {
+  size_t bytes = 0;
+  for (const auto& diagonal : diagonals) {
+    bytes += diagonal.coeff_count() * sizeof(std::uint64_t);
+  }
+  return bytes;
+}
+
+EncodedDiagonals encode_diagonals_seal(const std::vector<double>& matrix,
+                                       size_t rows, size_t cols,
+                                       seal::parms_id_type parms_id,
+                                       double scale,
+                                       HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(matrix.size() == rows * cols, "Matrix size ", matrix.size(),
+               " does not match shape (", rows, ", ", cols, ")");
+  NGRAPH_CHECK(!he_seal_backend.complex_packing(),
+               "Diagonal dot does not support complex packing");
+
+  auto& encoder = *he_seal_backend.get_ckks_encoder();
+  const size_t slot_count = encoder.slot_count();
+  const size_t period = diagonal_dot_period(rows, cols);
+  NGRAPH_CHECK(slot_count % period == 0, "Period ", period,
+               " does not divide slot count ", slot_count);
+  const size_t baby_steps = diagonal_baby_steps(period);
+
+  // Diagonal i stores matrix[j][(j + i) % period] in row j, with zero padding
+  auto diagonal_entry = [&](size_t diag_idx, size_t row) {
+    size_t col = (row + diag_idx) % period;
+    return (row < rows && col < cols) ? matrix[row * cols + col] : 0.;
+  };
+
+  EncodedDiagonals encoded;
+  encoded.parms_id = parms_id;
+  encoded.scale = scale;
+  encoded.diagonals.resize(period);
+#pragma omp parallel for
+  for (size_t diag_idx = 0; diag_idx < period; ++diag_idx) {
+    bool nonzero = false;
+    for (size_t row = 0; row < rows && !nonzero; ++row) {
+      nonzero = diagonal_entry(diag_idx, row) != 0.;
+    }
+    if (!nonzero) {
+      continue;
+    }
+    // Pre-rotate the diagonal by -offset, so the giant-step rotation can be
+    // applied once to the sum
+    const size_t offset = diag_idx / baby_steps * baby_steps;
+    std::vector<double> rotated_diagonal(slot_count);
+    for (size_t slot = 0; slot < slot_count; ++slot) {
+      size_t row = (slot % period + period - offset % period) % period;
+      rotated_diagonal[slot] = diagonal_entry(diag_idx, row);
+    }
+    HEPrimitiveCounter::increment(HEPrimitive::encode);
+    encoder.encode(rotated_diagonal, parms_id, scale,
+                   encoded.diagonals[diag_idx]);
+  }
+  NGRAPH_CHECK(encoded.byte_count() > 0,
+               "Diagonal dot does not support all-zero matrices");
+  return encoded;
+}
+
+void dot_diagonal_seal(const SealCiphertextWrapper& arg0,
+                       const EncodedDiagonals& diagonals, size_t rows,
+                       size_t cols, SealCiphertextWrapper& out,
+                       HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(he_seal_backend.get_chain_index(arg0) > 0,
+               "Multiplicative depth exceeded for arg0");
+  NGRAPH_CHECK(diagonals.parms_id == arg0.ciphertext().parms_id() &&
+                   diagonals.scale == arg0.ciphertext().scale(),
+               "Diagonals are not encoded at the level and scale of arg0");
+
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  const size_t period = diagonal_dot_period(rows, cols);
+  NGRAPH_CHECK(diagonals.diagonals.size() == period, "Number of diagonals ",
+               diagonals.diagonals.size(), " does not match period ", period);
+
+  // Baby-step giant-step: diagonal i = giant * baby_steps + baby
+  const size_t baby_steps = diagonal_baby_steps(period);
+  const size_t giant_steps = (period + baby_steps - 1) / baby_steps;
+
+  // Generate the keys once, outside the parallel regions
+  std::set<int> steps;
+  for (size_t baby = 1; baby < baby_steps; ++baby) {
+    steps.insert(static_cast<int>(baby));
+  }
+  for (size_t giant = 1; giant < giant_steps; ++giant) {
+    steps.insert(static_cast<int>(giant * baby_steps));
+  }
+  const auto galois_keys =
+      steps.empty() ? nullptr : he_seal_backend.get_galois_keys(steps);
+
+  // The baby steps rotate the same ciphertext, so they share one
+  // decomposition
+  std::vector<int> baby_offsets(baby_steps);
+  std::iota(baby_offsets.begin(), baby_offsets.end(), 0);
+  std::vector<seal::Ciphertext> baby_rotations;
+  he_seal_backend.rotate_hoisted(arg0.ciphertext(), baby_offsets,
+                                 baby_rotations);
+
+  std::vector<seal::Ciphertext> giant_sums(giant_steps);
+  // Not std::vector<bool>, which is unsafe to write from multiple threads
+  std::vector<char> giant_used(giant_steps, 0);
+#pragma omp parallel for
+  for (size_t giant = 0; giant < giant_steps; ++giant) {
+    const size_t offset = giant * baby_steps;
+    seal::Ciphertext prod;
+    for (size_t baby = 0; baby < baby_steps; ++baby) {
+      size_t diag_idx = offset + baby;
+      if (diag_idx >= period ||
+          diagonals.diagonals[diag_idx].coeff_count() == 0) {
+        continue;
+      }
+      HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+      evaluator.multiply_plain(baby_rotations[baby],
+                               diagonals.diagonals[diag_idx], prod);
+      if (giant_used[giant]) {
+        evaluator.add_inplace(giant_sums[giant], prod);
+      } else {
+        giant_sums[giant] = prod;
+        giant_used[giant] = 1;
+      }
+    }
+    if (giant_used[giant] && offset != 0) {
+      HEPrimitiveCounter::increment(HEPrimitive::rotate);
+      evaluator.rotate_vector_inplace(giant_sums[giant],
+                                      static_cast<int>(offset), *galois_keys);
+    }
+  }
+
+  bool first_add = true;
+  for (size_t giant = 0; giant < giant_steps; ++giant) {
+    if (!giant_used[giant]) {
+      continue;
+    }
+    if (first_add) {
+      out.ciphertext() = giant_sums[giant];
+      first_add = false;
+    } else {
+      evaluator.add_inplace(out.ciphertext(), giant_sums[giant]);
+    }
+  }
+}
+
+void dot_diagonal_seal(const SealCiphertextWrapper& arg0,
+                       const std::vector<double>& matrix, size_t rows,
+                       size_t cols, SealCiphertextWrapper& out,
+                       HESealBackend& he_seal_backend) {
+  const seal::Ciphertext& cipher = arg0.ciphertext();
+  dot_diagonal_seal(arg0,
+                    encode_diagonals_seal(matrix, rows, cols, cipher.parms_id(),
+                                          cipher.scale(), he_seal_backend),
+                    rows, cols, out, he_seal_backend);
+}
+
+}  // namespace ngraph::runtime::he
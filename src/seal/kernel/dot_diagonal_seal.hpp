@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <vector>
+
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Returns the period with which the input vector of a diagonal
+/// matrix-vector product must be replicated across the slots, i.e. the
+/// smallest power of two no less than max(rows, cols)
+/// \param[in] rows Number of rows of the plaintext matrix
+/// \param[in] cols Number of columns of the plaintext matrix
+size_t diagonal_dot_period(size_t rows, size_t cols);
+
+/// \brief Replicates a vector across all slots with the given period, so that
+/// slot s stores input[s % period], or zero if s % period >= input.size()
+/// \param[in] input Vector to replicate
+/// \param[in] period Replication period, as given by diagonal_dot_period
+/// \param[in] slot_count Number of slots in a ciphertext
+std::vector<double> replicate_for_diagonal_dot(const std::vector<double>& input,
+                                               size_t period,
+                                               size_t slot_count);
+
+/// \brief Diagonals of a plaintext matrix, encoded for dot_diagonal_seal at
+/// the level and scale of its input ciphertext
+struct EncodedDiagonals {
+  seal::parms_id_type parms_id{};
+  double scale{0};
+  /// \brief Encoded diagonal per diagonal index, pre-rotated for the giant
+  /// steps. Diagonals of zeros are empty
+  std::vector<seal::Plaintext> diagonals;
+
+  /// \brief Returns the number of bytes of the encoded diagonals
+  size_t byte_count() const;
+};
+
+/// \brief Encodes the diagonals of a plaintext matrix for dot_diagonal_seal,
+/// so the encodings can be reused by products with several ciphertexts at
+/// the same level and scale
+/// \param[in] matrix Plaintext matrix in row-major order
+/// \param[in] rows Number of rows of matrix
+/// \param[in] cols Number of columns of matrix
+/// \param[in] parms_id Parameters of the input ciphertexts
+/// \param[in] scale Scale of the input ciphertexts
+/// \param[in] he_seal_backend Backend used for encoding
+/// \throws ngraph_error if the matrix is all zeros
+EncodedDiagonals encode_diagonals_seal(const std::vector<double>& matrix,
+                                       size_t rows, size_t cols,
+                                       seal::parms_id_type parms_id,
+                                       double scale,
+                                       HESealBackend& he_seal_backend);
+
+/// \brief Computes the product of a plaintext matrix with an encrypted vector
+/// packed into the slots of a single ciphertext, using the diagonal method
+/// of Halevi and Shoup with baby-step giant-step rotations.
+/// Slot j of the output, for j < rows, stores sum_k matrix[j][k] * input[k].
+/// The output is not rescaled.
+/// \param[in] arg0 Ciphertext storing the input vector, replicated as given
+/// by replicate_for_diagonal_dot, e.g. by replicate_slots_seal
+/// \param[in] diagonals Diagonals of the matrix, encoded by
+/// encode_diagonals_seal at the parameters and scale of arg0
+/// \param[in] rows Number of rows of the matrix
+/// \param[in] cols Number of columns of the matrix
+/// \param[out] out Ciphertext storing the result
+/// \param[in] he_seal_backend Backend used for rotations and multiplication
+void dot_diagonal_seal(const SealCiphertextWrapper& arg0,
+                       const EncodedDiagonals& diagonals, size_t rows,
+                       size_t cols, SealCiphertextWrapper& out,
+                       HESealBackend& he_seal_backend);
+
+/// \brief Computes the product of a plaintext matrix with an encrypted
+/// vector as above, encoding the diagonals of the matrix first
+/// \param[in] arg0 Ciphertext storing the input vector, replicated as given
+/// by replicate_for_diagonal_dot, e.g. by replicate_slots_seal
+/// \param[in] matrix Plaintext matrix in row-major order
+/// \param[in] rows Number of rows of matrix
+/// \param[in] cols Number of columns of matrix
+/// \param[out] out Ciphertext storing the result
+/// \param[in] he_seal_backend Backend used for rotations and multiplication
+void dot_diagonal_seal(const SealCiphertextWrapper& arg0,
+                       const std::vector<double>& matrix, size_t rows,
+                       size_t cols, SealCiphertextWrapper& out,
+                       HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
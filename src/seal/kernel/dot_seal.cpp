@@ -18,12 +18,22 @@
 
 #include <algorithm>
 #include <chrono>
+#include <functional>
 #include <utility>
+#include <vector>
 
-#include "seal/kernel/add_seal.hpp"
-#include "seal/kernel/multiply_seal.hpp"
+#include "he_util.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 
 namespace ngraph::runtime::he {
+namespace {
+// Columns and reduced elements per block of a Dot. The elements of arg0 in a
+// block are read once for all s_dot_block_columns columns
+constexpr size_t s_dot_block_columns = 16;
+constexpr size_t s_dot_block_depth = 8;
+}  // namespace
+
 void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
               std::vector<HEType>& out, const Shape& arg0_shape,
               const Shape& arg1_shape, const Shape& out_shape,
@@ -31,120 +41,188 @@ void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
               size_t batch_size, HESealBackend& he_seal_backend) {
   NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
                "Unsupported type ", element_type);
-  // Get the sizes of the dot axes. It's easiest to pull them from arg1
-  // because they're right up front.
-  Shape dot_axis_sizes(reduction_axes_count);
-  std::copy(arg1_shape.begin(), arg1_shape.begin() + reduction_axes_count,
-            dot_axis_sizes.begin());
-
-  CoordinateTransform arg0_transform(arg0_shape);
-  CoordinateTransform arg1_transform(arg1_shape);
-  CoordinateTransform output_transform(out_shape);
-
-  // Create coordinate transforms for arg0 and arg1 that throw away the dotted
-  // axes.
-  size_t arg0_projected_rank = arg0_shape.size() - reduction_axes_count;
-  size_t arg1_projected_rank = arg1_shape.size() - reduction_axes_count;
-
-  Shape arg0_projected_shape(arg0_projected_rank);
-  std::copy(arg0_shape.begin(), arg0_shape.begin() + arg0_projected_rank,
-            arg0_projected_shape.begin());
-
-  Shape arg1_projected_shape(arg1_projected_rank);
-  std::copy(arg1_shape.begin() + reduction_axes_count, arg1_shape.end(),
-            arg1_projected_shape.begin());
-
-  CoordinateTransform arg0_projected_transform(arg0_projected_shape);
-  CoordinateTransform arg1_projected_transform(arg1_projected_shape);
-
-  // Create a coordinate transform that allows us to iterate over all possible
-  // values
-  // for the dotted axes.
-  CoordinateTransform dot_axes_transform(dot_axis_sizes);
-
-  // Get arg0_projected_size and arg1_projected_size for parallelization
-  // and pre-compute coordinates
-  std::vector<Coordinate> arg0_projected_coords;
-  for (const Coordinate& coord : arg0_projected_transform) {
-    arg0_projected_coords.emplace_back(coord);
+
+  // The reduced axes are the trailing axes of arg0 and the leading axes of
+  // arg1, so in row-major order arg0[i, k] is arg0[i * dot_size + k],
+  // arg1[k, j] is arg1[k * num_columns + j], and out[i, j] is
+  // out[i * num_columns + j]
+  size_t dot_size =
+      shape_size(Shape(arg1_shape.begin(),
+                       arg1_shape.begin() + reduction_axes_count));
+  size_t num_columns =
+      shape_size(Shape(arg1_shape.begin() + reduction_axes_count,
+                       arg1_shape.end()));
+  size_t num_rows = shape_size(
+      Shape(arg0_shape.begin(), arg0_shape.end() - reduction_axes_count));
+  NGRAPH_CHECK(arg0.size() == num_rows * dot_size, "arg0 has ", arg0.size(),
+               " elements, expected ", num_rows * dot_size);
+  NGRAPH_CHECK(arg1.size() == dot_size * num_columns, "arg1 has ",
+               arg1.size(), " elements, expected ", dot_size * num_columns);
+  NGRAPH_CHECK(out.size() == shape_size(out_shape) &&
+                   out.size() == num_rows * num_columns,
+               "Output has ", out.size(), " elements, expected ",
+               num_rows * num_columns);
+
+  // Each block accumulates the outputs of a row and block of columns, one
+  // block of reduced elements at a time, so each element of arg0 is reused
+  // across the columns while it is cache-resident
+  size_t column_blocks = ceil_div(num_columns, s_dot_block_columns);
+  size_t num_blocks = num_rows * column_blocks;
+
+#pragma omp parallel if (!limb_parallel_elements(num_blocks))
+  {
+    // Reused across the blocks of a thread, since finalize resets them
+    std::vector<MultiplyAccumulator> accumulators;
+    accumulators.reserve(s_dot_block_columns);
+    for (size_t col = 0; col < s_dot_block_columns; ++col) {
+      accumulators.emplace_back(batch_size, he_seal_backend);
+    }
+#pragma omp for schedule(dynamic)
+    for (size_t block = 0; block < num_blocks; ++block) {
+      size_t row = block / column_blocks;
+      size_t column_begin = block % column_blocks * s_dot_block_columns;
+      size_t column_end =
+          std::min(num_columns, column_begin + s_dot_block_columns);
+
+      for (size_t depth_begin = 0; depth_begin < dot_size;
+           depth_begin += s_dot_block_depth) {
+        size_t depth_end =
+            std::min(dot_size, depth_begin + s_dot_block_depth);
+        for (size_t col = column_begin; col < column_end; ++col) {
+          auto& accumulator = accumulators[col - column_begin];
+          for (size_t k = depth_begin; k < depth_end; ++k) {
+            accumulator.accumulate(arg0[row * dot_size + k],
+                                   arg1[k * num_columns + col]);
+          }
+        }
+      }
+      for (size_t col = column_begin; col < column_end; ++col) {
+        accumulators[col - column_begin].finalize(
+            out[row * num_columns + col]);
+      }
+    }
   }
+}
 
-  std::vector<Coordinate> arg1_projected_coords;
-  for (const Coordinate& coord : arg1_projected_transform) {
-    arg1_projected_coords.emplace_back(coord);
+std::optional<WeightedSums> dot_seal_weighted_sums(
+    const std::vector<HEType>& arg1, const Shape& arg1_shape,
+    size_t reduction_axes_count) {
+  // arg1[k, j] is arg1[k * num_columns + j] in row-major order
+  size_t dot_size =
+      shape_size(Shape(arg1_shape.begin(),
+                       arg1_shape.begin() + reduction_axes_count));
+  size_t num_columns = shape_size(
+      Shape(arg1_shape.begin() + reduction_axes_count, arg1_shape.end()));
+  NGRAPH_CHECK(arg1.size() == dot_size * num_columns, "arg1 has ",
+               arg1.size(), " elements, expected ", dot_size * num_columns);
+  if (arg1.size() > UINT32_MAX) {
+    return std::nullopt;
   }
 
-  size_t arg0_projected_size = arg0_projected_coords.size();
-  size_t arg1_projected_size = arg1_projected_coords.size();
-  size_t global_projected_size = arg0_projected_size * arg1_projected_size;
+  std::vector<size_t> offsets(num_columns + 1);
+  std::vector<uint32_t> input_indices(arg1.size());
+  std::vector<uint32_t> weight_indices(arg1.size());
+  for (size_t col = 0; col < num_columns; ++col) {
+    offsets[col + 1] = offsets[col] + dot_size;
+    for (size_t k = 0; k < dot_size; ++k) {
+      input_indices[col * dot_size + k] = static_cast<uint32_t>(k);
+      weight_indices[col * dot_size + k] =
+          static_cast<uint32_t>(k * num_columns + col);
+    }
+  }
+  return make_weighted_sums(arg1, offsets, input_indices, weight_indices);
+}
+
+void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+              std::vector<HEType>& out, const WeightedSums& column_sums,
+              size_t dot_size, size_t batch_size,
+              HESealBackend& he_seal_backend) {
+  size_t num_columns = (column_sums.offsets.size() - 1) / 3;
+  NGRAPH_CHECK(num_columns > 0 && out.size() % num_columns == 0,
+               "Output size ", out.size(), " is not a multiple of ",
+               num_columns);
+  NGRAPH_CHECK(arg0.size() == out.size() / num_columns * dot_size,
+               "arg0 has ", arg0.size(), " elements, expected ",
+               out.size() / num_columns * dot_size);
+
+#pragma omp parallel if (!limb_parallel_elements(out.size()))
+  {
+    MultiplyAccumulator accumulator(batch_size, he_seal_backend);
+#pragma omp for
+    for (size_t out_idx = 0; out_idx < out.size(); ++out_idx) {
+      size_t row = out_idx / num_columns;
+      size_t col = out_idx % num_columns;
+      weighted_sum_seal(arg0, arg1, column_sums, col, row * dot_size,
+                        out[out_idx], batch_size, he_seal_backend,
+                        accumulator);
+    }
+  }
+}
+
+void dot_seal_streamed(const std::vector<HEType>& arg0,
+                       const std::vector<HEType>& arg1,
+                       std::vector<HEType>& out, const Shape& arg0_shape,
+                       const Shape& arg1_shape, size_t reduction_axes_count,
+                       const element::Type& element_type, size_t batch_size,
+                       HESealBackend& he_seal_backend,
+                       const std::function<size_t(size_t)>& wait_for_arg0) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+  NGRAPH_CHECK(arg0.size() == shape_size(arg0_shape), "arg0 has ",
+               arg0.size(), " elements, expected ", shape_size(arg0_shape));
+
+  // The reduced axes are the trailing axes of arg0 and the leading axes of
+  // arg1, so in row-major order arg0[i, k] is arg0[i * dot_size + k],
+  // arg1[k, j] is arg1[k * arg1_projected_size + j], and out[i, j] is
+  // out[i * arg1_projected_size + j]
+  size_t dot_size =
+      shape_size(Shape(arg1_shape.begin(),
+                       arg1_shape.begin() + reduction_axes_count));
+  size_t arg1_projected_size =
+      shape_size(Shape(arg1_shape.begin() + reduction_axes_count,
+                       arg1_shape.end()));
+  NGRAPH_CHECK(out.size() % std::max<size_t>(arg1_projected_size, 1) == 0,
+               "Output size ", out.size(), " is not a multiple of ",
+               arg1_projected_size);
+
+  std::vector<MultiplyAccumulator> accumulators;
+  accumulators.reserve(out.size());
+  for (size_t out_idx = 0; out_idx < out.size(); ++out_idx) {
+    accumulators.emplace_back(batch_size, he_seal_backend);
+  }
+
+  size_t num_processed = 0;
+  while (num_processed < arg0.size()) {
+    size_t num_loaded = wait_for_arg0(num_processed + 1);
+    NGRAPH_CHECK(num_loaded > num_processed && num_loaded <= arg0.size(),
+                 "Invalid number of loaded elements ", num_loaded);
+
+    // Accumulate the products of the newly loaded elements [num_processed,
+    // num_loaded) into the outputs of the rows they belong to
+    size_t first_row = num_processed / dot_size;
+    size_t end_row = (num_loaded - 1) / dot_size + 1;
+    size_t num_outputs = (end_row - first_row) * arg1_projected_size;
 
 #pragma omp parallel for
-  for (size_t global_projected_idx = 0;
-       global_projected_idx < global_projected_size; ++global_projected_idx) {
-    // Compute outer and inner index
-    size_t arg0_projected_idx = global_projected_idx / arg1_projected_size;
-    size_t arg1_projected_idx = global_projected_idx % arg1_projected_size;
-
-    const Coordinate& arg0_projected_coord =
-        arg0_projected_coords[arg0_projected_idx];
-    const Coordinate& arg1_projected_coord =
-        arg1_projected_coords[arg1_projected_idx];
-
-    // The output coordinate is just the concatenation of the projected
-    // coordinates.
-    Coordinate out_coord(arg0_projected_coord.size() +
-                         arg1_projected_coord.size());
-
-    auto out_coord_it =
-        std::copy(arg0_projected_coord.begin(), arg0_projected_coord.end(),
-                  out_coord.begin());
-    std::copy(arg1_projected_coord.begin(), arg1_projected_coord.end(),
-              out_coord_it);
-
-    size_t out_index = output_transform.index(out_coord);
-
-    // Walk along the dotted axes.
-    Coordinate arg0_coord(arg0_shape.size());
-    Coordinate arg1_coord(arg1_shape.size());
-    auto arg0_it = std::copy(arg0_projected_coord.begin(),
-                             arg0_projected_coord.end(), arg0_coord.begin());
-
-    auto sum = HEType(HEPlaintext(batch_size), false);
-    bool first_add = true;
-
-    for (const Coordinate& dot_axis_positions : dot_axes_transform) {
-      // In order to find the points to multiply together, we need to inject
-      // our current positions along the dotted axes back into the projected
-      // arg0 and arg1 coordinates.
-      std::copy(dot_axis_positions.begin(), dot_axis_positions.end(), arg0_it);
-
-      auto arg1_it = std::copy(dot_axis_positions.begin(),
-                               dot_axis_positions.end(), arg1_coord.begin());
-      std::copy(arg1_projected_coord.begin(), arg1_projected_coord.end(),
-                arg1_it);
-
-      // Multiply and add to the summands.
-      auto mult_arg0 = arg0[arg0_transform.index(arg0_coord)];
-      auto mult_arg1 = arg1[arg1_transform.index(arg1_coord)];
-
-      auto prod = HEType(HEPlaintext(batch_size), false);
-
-      if (first_add) {
-        scalar_multiply_seal(mult_arg0, mult_arg1, prod, he_seal_backend);
-        sum = prod;
-        first_add = false;
-      } else {
-        scalar_multiply_seal(mult_arg0, mult_arg1, prod, he_seal_backend);
-        scalar_add_seal(prod, sum, sum, he_seal_backend);
+    for (size_t idx = 0; idx < num_outputs; ++idx) {
+      size_t row = first_row + idx / arg1_projected_size;
+      size_t col = idx % arg1_projected_size;
+      size_t row_begin = row * dot_size;
+      size_t dot_begin = std::max(num_processed, row_begin) - row_begin;
+      size_t dot_end = std::min(num_loaded, row_begin + dot_size) - row_begin;
+
+      auto& accumulator = accumulators[row * arg1_projected_size + col];
+      for (size_t dot_idx = dot_begin; dot_idx < dot_end; ++dot_idx) {
+        accumulator.accumulate(arg0[row_begin + dot_idx],
+                               arg1[dot_idx * arg1_projected_size + col]);
       }
     }
-    // Write the sum back.
-    if (first_add) {
-      HEPlaintext zero(batch_size, 0);
-      out[out_index].set_plaintext(std::move(zero));
-    } else {
-      out[out_index] = sum;
-    }
+    num_processed = num_loaded;
+  }
+
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < out.size(); ++out_idx) {
+    accumulators[out_idx].finalize(out[out_idx]);
   }
 }
 
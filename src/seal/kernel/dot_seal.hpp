@@ -16,18 +16,85 @@
 
 #pragma once
 
+#include <functional>
+#include <optional>
 #include <vector>
 
 #include "he_plaintext.hpp"
 #include "he_type.hpp"
 #include "ngraph/coordinate_transform.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
 
 namespace ngraph::runtime::he {
+/// \brief Computes the Dot product of arg0 and arg1. Outputs are computed in
+/// blocks of columns of a row of arg0, each accumulating one block of reduced
+/// elements at a time, so each element of arg0 is read once per block of
+/// columns rather than once per output
+/// \param[in] arg0 First argument
+/// \param[in] arg1 Second argument
+/// \param[out] out Output, of shape the concatenation of the non-reduced
+/// axes of arg0_shape and arg1_shape
+/// \param[in] arg0_shape Shape of arg0
+/// \param[in] arg1_shape Shape of arg1
+/// \param[in] out_shape Shape of out
+/// \param[in] reduction_axes_count Number of reduced axes
+/// \param[in] element_type Type of the elements
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the multiplications
 void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
               std::vector<HEType>& out, const Shape& arg0_shape,
               const Shape& arg1_shape, const Shape& out_shape,
               size_t reduction_axes_count, const element::Type& element_type,
               size_t batch_size, HESealBackend& he_seal_backend);
 
+/// \brief Groups the products of each column of arg1 by weight, see
+/// make_weighted_sums
+/// \param[in] arg1 Second argument of the Dot
+/// \param[in] arg1_shape Shape of arg1
+/// \param[in] reduction_axes_count Number of reduced axes
+/// \returns Sum j of the products of column j of arg1 with a row of arg0, or
+/// std::nullopt if arg1 is not made of real scalar plaintexts
+std::optional<WeightedSums> dot_seal_weighted_sums(
+    const std::vector<HEType>& arg1, const Shape& arg1_shape,
+    size_t reduction_axes_count);
+
+/// \brief Computes the same product as dot_seal, with the columns of arg1
+/// grouped by weight. Zero weights are skipped
+/// \param[in] arg0 First argument
+/// \param[in] arg1 Second argument
+/// \param[out] out Output, with one element per row of arg0 and column of
+/// arg1
+/// \param[in] column_sums Columns of arg1, see dot_seal_weighted_sums
+/// \param[in] dot_size Number of elements in each row of arg0
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the multiplications
+void dot_seal(const std::vector<HEType>& arg0, const std::vector<HEType>& arg1,
+              std::vector<HEType>& out, const WeightedSums& column_sums,
+              size_t dot_size, size_t batch_size,
+              HESealBackend& he_seal_backend);
+
+/// \brief Computes the same product as dot_seal, while arg0 is still being
+/// loaded. Each output accumulates its partial sum over the prefix of arg0 as
+/// it arrives, and is finalized once arg0 is complete
+/// \param[in] arg0 First argument, loaded in order of its elements
+/// \param[in] arg1 Second argument, which must be fully loaded
+/// \param[out] out Output, of shape the concatenation of the non-reduced
+/// axes of arg0_shape and arg1_shape
+/// \param[in] arg0_shape Shape of arg0
+/// \param[in] arg1_shape Shape of arg1
+/// \param[in] reduction_axes_count Number of reduced axes
+/// \param[in] element_type Type of the elements
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the multiplications
+/// \param[in] wait_for_arg0 Blocks until at least the given number of
+/// elements of arg0 are loaded, and returns the number of loaded elements
+void dot_seal_streamed(const std::vector<HEType>& arg0,
+                       const std::vector<HEType>& arg1,
+                       std::vector<HEType>& out, const Shape& arg0_shape,
+                       const Shape& arg1_shape, size_t reduction_axes_count,
+                       const element::Type& element_type, size_t batch_size,
+                       HESealBackend& he_seal_backend,
+                       const std::function<size_t(size_t)>& wait_for_arg0);
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,64 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/elementwise_seal.hpp"
+
+#include <memory>
+#include <utility>
+
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+void scalar_elementwise_seal(const HEPlaintext& arg, HEPlaintext& out,
+                             ElementwiseFunction function) {
+  plaintext_unary_op_seal(arg, out, function);
+}
+
+void scalar_elementwise_seal(const HEType& arg, HEType& out,
+                             ElementwiseFunction function,
+                             const seal::parms_id_type& parms_id, double scale,
+                             seal::CKKSEncoder& ckks_encoder,
+                             seal::Encryptor& encryptor,
+                             seal::Decryptor& decryptor,
+                             std::shared_ptr<seal::SEALContext> context,
+                             HECodecScratch& scratch) {
+  if (arg.is_plaintext()) {
+    out.set_plaintext(arg.get_plaintext());
+    scalar_elementwise_seal(arg.get_plaintext(), out.get_plaintext(),
+                            function);
+    return;
+  }
+  HEPlaintext plain(arg.batch_size());
+  decrypt_strided(plain.data(), sizeof(double), plain.size(), element::f64,
+                  *arg.get_ciphertext(), arg.complex_packing(), decryptor,
+                  ckks_encoder, std::move(context), scratch);
+  scalar_elementwise_seal(plain, plain, function);
+
+  auto& cipher = out.get_ciphertext();
+  if (cipher == nullptr || cipher.use_count() != 1) {
+    cipher = HESealBackend::create_empty_ciphertext();
+  }
+  encrypt_strided(cipher->ciphertext(), plain.data(), sizeof(double),
+                  plain.size(), element::f64, parms_id, scale, ckks_encoder,
+                  encryptor, arg.complex_packing(), scratch);
+  out.set_ciphertext(cipher);
+}
+
+}  // namespace ngraph::runtime::he
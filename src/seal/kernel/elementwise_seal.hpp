@@ -0,0 +1,56 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+
+#include "he_type.hpp"
+#include "he_util.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Applies an elementwise function to each value of a plaintext
+/// \param[in] arg Input value
+/// \param[out] out Output value. May alias arg
+/// \param[in] function Function to apply, see client_elementwise_function
+void scalar_elementwise_seal(const HEPlaintext& arg, HEPlaintext& out,
+                             ElementwiseFunction function);
+
+/// \brief Applies an elementwise function to each value of a ciphertext by
+/// decrypting it, decrypting and encrypting through the thread's scratch
+/// buffers. Plaintexts are computed directly
+/// \param[in] arg Input value
+/// \param[out] out Output value. Its ciphertext storage is reused
+/// \param[in] function Function to apply, see client_elementwise_function
+/// \param[in] parms_id Seal parameter id to encrypt the output at
+/// \param[in] scale Scale to encrypt the output at
+/// \param[in] ckks_encoder Used for encoding
+/// \param[in] encryptor Used for encrypting
+/// \param[in] decryptor Used for decrypting
+/// \param[in] context Used for decrypting
+/// \param[in,out] scratch Buffers of the calling thread
+void scalar_elementwise_seal(const HEType& arg, HEType& out,
+                             ElementwiseFunction function,
+                             const seal::parms_id_type& parms_id, double scale,
+                             seal::CKKSEncoder& ckks_encoder,
+                             seal::Encryptor& encryptor,
+                             seal::Decryptor& decryptor,
+                             std::shared_ptr<seal::SEALContext> context,
+                             HECodecScratch& scratch);
+
+}  // namespace ngraph::runtime::he
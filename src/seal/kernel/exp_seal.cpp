@@ -17,22 +17,23 @@
 #include "seal/kernel/exp_seal.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
 
 void scalar_exp_seal(const HEPlaintext& arg, HEPlaintext& out) {
-  HEPlaintext out_vals(arg.size());
-  auto exp = [](double d) { return std::exp(d); };
-  std::transform(arg.begin(), arg.end(), out_vals.begin(), exp);
-  out = std::move(out_vals);
+  plaintext_unary_op_seal(arg, out, [](double d) { return std::exp(d); });
 }
 
 void scalar_exp_seal(const HEType& arg, HEType& out,
@@ -53,8 +54,23 @@ void scalar_exp_seal(const HEType& arg, HEType& out,
   }
 }
 
+std::vector<double> exp_polynomial(const HESealBackend& he_seal_backend) {
+  size_t degree = he_seal_backend.polynomial_degree();
+  if (degree == 0) {
+    return {};
+  }
+  double bound = he_seal_backend.polynomial_activation_bound();
+  return chebyshev_coefficients([](double x) { return std::exp(x); }, degree,
+                                -bound, bound);
+}
+
 void scalar_exp_seal(const HEType& arg, HEType& out,
-                     const HESealBackend& he_seal_backend) {
+                     const std::vector<double>& exp_coeffs,
+                     HESealBackend& he_seal_backend) {
+  if (arg.is_ciphertext() && !exp_coeffs.empty()) {
+    scalar_polynomial_seal(arg, exp_coeffs, out, he_seal_backend);
+    return;
+  }
   scalar_exp_seal(
       arg, out, he_seal_backend.get_context()->first_parms_id(),
       he_seal_backend.get_scale(), *he_seal_backend.get_ckks_encoder(),
@@ -62,12 +78,17 @@ void scalar_exp_seal(const HEType& arg, HEType& out,
       he_seal_backend.get_context());
 }
 
+void scalar_exp_seal(const HEType& arg, HEType& out,
+                     HESealBackend& he_seal_backend) {
+  scalar_exp_seal(arg, out, exp_polynomial(he_seal_backend), he_seal_backend);
+}
+
 void exp_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
-              size_t count, const HESealBackend& he_seal_backend) {
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
-    scalar_exp_seal(arg[i], out[i], he_seal_backend);
-  }
+              size_t count, HESealBackend& he_seal_backend) {
+  std::vector<double> exp_coeffs = exp_polynomial(he_seal_backend);
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
+    scalar_exp_seal(arg[i], out[i], exp_coeffs, he_seal_backend);
+  });
 }
 
 }  // namespace ngraph::runtime::he
@@ -34,10 +34,26 @@ void scalar_exp_seal(const HEType& arg, HEType& out,
                      seal::Encryptor& encryptor, seal::Decryptor& decryptor,
                      std::shared_ptr<seal::SEALContext> context);
 
+/// \brief Returns the coefficients of the polynomial with which the
+/// exponential of ciphertexts is approximated, or an empty vector if
+/// ciphertexts are exponentiated by decryption
+/// \param[in] he_seal_backend Backend whose polynomial degree and activation
+/// bound configure the approximation
+std::vector<double> exp_polynomial(const HESealBackend& he_seal_backend);
+
+/// \brief Computes the exponential of a cipher or plaintext element
+/// \param[in] arg Cipher or plaintext data to exponentiate
+/// \param[out] out Stores the exponential. May be arg
+/// \param[in] exp_coeffs Coefficients from exp_polynomial
+/// \param[in] he_seal_backend Backend used to perform the exponentiation
 void scalar_exp_seal(const HEType& arg, HEType& out,
-                     const HESealBackend& he_seal_backend);
+                     const std::vector<double>& exp_coeffs,
+                     HESealBackend& he_seal_backend);
+
+void scalar_exp_seal(const HEType& arg, HEType& out,
+                     HESealBackend& he_seal_backend);
 
 void exp_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
-              size_t count, const HESealBackend& he_seal_backend);
+              size_t count, HESealBackend& he_seal_backend);
 
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,154 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/integer_seal.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include "ngraph/check.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+double integer_op(IntegerOp op, double x, double y) {
+  switch (op) {
+    case IntegerOp::add:
+      return x + y;
+    case IntegerOp::subtract:
+      return x - y;
+    case IntegerOp::multiply:
+      return x * y;
+  }
+  return 0;
+}
+
+bool is_zero(const HEPlaintext& plain) {
+  return std::all_of(plain.begin(), plain.end(),
+                     [](double value) { return value == 0.0; });
+}
+
+/// \brief Computes op on a ciphertext and an encoded plaintext. The
+/// plaintext is the first operand if plain_first
+HEType integer_cipher_plain(const HEType& cipher, const HEPlaintext& plain,
+                            bool plain_first, IntegerOp op,
+                            const HESealBackend& he_seal_backend) {
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  // Multiplying by an encoding of zero yields a transparent ciphertext
+  if (op == IntegerOp::multiply && is_zero(plain)) {
+    return HEType(HEPlaintext({0.0}), false);
+  }
+  seal::Plaintext encoded;
+  encode_integers(encoded, plain, *he_seal_backend.get_batch_encoder(),
+                  he_seal_backend.get_encryption_parameters().plain_modulus());
+  const seal::Ciphertext& encrypted = cipher.get_ciphertext()->ciphertext();
+  auto out = HESealBackend::create_empty_ciphertext();
+  switch (op) {
+    case IntegerOp::add:
+      evaluator.add_plain(encrypted, encoded, out->ciphertext());
+      break;
+    case IntegerOp::subtract:
+      evaluator.sub_plain(encrypted, encoded, out->ciphertext());
+      if (plain_first) {
+        evaluator.negate_inplace(out->ciphertext());
+      }
+      break;
+    case IntegerOp::multiply:
+      evaluator.multiply_plain(encrypted, encoded, out->ciphertext());
+      break;
+  }
+  return HEType(out, false, cipher.batch_size());
+}
+}  // namespace
+
+void integer_binary_seal(const std::vector<HEType>& arg0,
+                         const std::vector<HEType>& arg1,
+                         std::vector<HEType>& out, size_t count, IntegerOp op,
+                         const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(he_seal_backend.integer_scheme(),
+               "Integer kernels require BFV encryption parameters");
+  NGRAPH_CHECK(count <= arg0.size() && count <= arg1.size() &&
+                   count <= out.size(),
+               "Count ", count, " is too large for arguments");
+
+  // Each result is computed before out[i], which may alias an operand, is
+  // assigned
+  parallel_for_seal(count, {&arg0, &arg1}, [&](size_t i) {
+    const HEType& x = arg0[i];
+    const HEType& y = arg1[i];
+
+    if (x.is_plaintext() && y.is_plaintext()) {
+      HEPlaintext values;
+      plaintext_binary_op_seal(
+          x.get_plaintext(), y.get_plaintext(), values,
+          [op](double a, double b) { return integer_op(op, a, b); });
+      out[i] = HEType(values, false);
+    } else if (x.is_ciphertext() && y.is_plaintext()) {
+      out[i] = integer_cipher_plain(x, y.get_plaintext(), false, op,
+                                    he_seal_backend);
+    } else if (x.is_plaintext() && y.is_ciphertext()) {
+      out[i] = integer_cipher_plain(y, x.get_plaintext(), true, op,
+                                    he_seal_backend);
+    } else {
+      auto& evaluator = *he_seal_backend.get_evaluator();
+      const auto& cipher0 = x.get_ciphertext()->ciphertext();
+      const auto& cipher1 = y.get_ciphertext()->ciphertext();
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      switch (op) {
+        case IntegerOp::add:
+          evaluator.add(cipher0, cipher1, cipher->ciphertext());
+          break;
+        case IntegerOp::subtract:
+          evaluator.sub(cipher0, cipher1, cipher->ciphertext());
+          break;
+        case IntegerOp::multiply:
+          evaluator.multiply(cipher0, cipher1, cipher->ciphertext());
+          evaluator.relinearize_inplace(cipher->ciphertext(),
+                                        *he_seal_backend.get_relin_keys());
+          break;
+      }
+      out[i] = HEType(cipher, false, std::max(x.batch_size(), y.batch_size()));
+    }
+  });
+}
+
+void integer_negate_seal(const std::vector<HEType>& arg,
+                         std::vector<HEType>& out, size_t count,
+                         const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(he_seal_backend.integer_scheme(),
+               "Integer kernels require BFV encryption parameters");
+  NGRAPH_CHECK(count <= arg.size() && count <= out.size(), "Count ", count,
+               " is too large for arguments");
+
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
+    if (arg[i].is_plaintext()) {
+      HEPlaintext values;
+      plaintext_unary_op_seal(arg[i].get_plaintext(), values,
+                              [](double x) { return -x; });
+      out[i] = HEType(values, false);
+    } else {
+      auto cipher = HESealBackend::create_empty_ciphertext();
+      he_seal_backend.get_evaluator()->negate(
+          arg[i].get_ciphertext()->ciphertext(), cipher->ciphertext());
+      out[i] = HEType(cipher, false, arg[i].batch_size());
+    }
+  });
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,54 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Integer operations computed by the BFV kernels
+enum class IntegerOp { add, subtract, multiply };
+
+/// \brief Computes an elementwise binary operation on BFV encryptions or
+/// plaintexts of integers. Since BFV encodes integers at scale 1, no rescale
+/// follows multiplications, which are only relinearized. Results are exact
+/// while their magnitude stays below half the plain modulus
+/// \param[in] arg0 First operands
+/// \param[in] arg1 Second operands
+/// \param[out] out Stores the results. May alias arg0 or arg1
+/// \param[in] count Number of elements to compute
+/// \param[in] op Operation to compute
+/// \param[in] he_seal_backend Backend with BFV encryption parameters
+/// \throws ngraph_error if the backend does not use BFV
+void integer_binary_seal(const std::vector<HEType>& arg0,
+                         const std::vector<HEType>& arg1,
+                         std::vector<HEType>& out, size_t count, IntegerOp op,
+                         const HESealBackend& he_seal_backend);
+
+/// \brief Negates BFV encryptions or plaintexts of integers elementwise
+/// \param[in] arg Operands
+/// \param[out] out Stores the results. May alias arg
+/// \param[in] count Number of elements to compute
+/// \param[in] he_seal_backend Backend with BFV encryption parameters
+/// \throws ngraph_error if the backend does not use BFV
+void integer_negate_seal(const std::vector<HEType>& arg,
+                         std::vector<HEType>& out, size_t count,
+                         const HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
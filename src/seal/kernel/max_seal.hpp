@@ -30,13 +30,36 @@
 
 namespace ngraph::runtime::he {
 
+/// \brief Returns list where L[i] is the list of input indices to maximize
+/// over for output i of a Max reduction
+/// \param[in] in_shape Shape of the input
+/// \param[in] out_shape Shape of the output
+/// \param[in] reduction_axes Axes to maximize over
+inline std::vector<std::vector<size_t>> max_seal_max_list(
+    const Shape& in_shape, const Shape& out_shape,
+    const AxisSet& reduction_axes) {
+  std::vector<std::vector<size_t>> maximize_list(shape_size(out_shape));
+
+  CoordinateTransform output_transform(out_shape);
+  CoordinateTransform input_transform(in_shape);
+  for (const Coordinate& input_coord : input_transform) {
+    Coordinate output_coord = reduce(input_coord, reduction_axes);
+    maximize_list[output_transform.index(output_coord)].emplace_back(
+        input_transform.index(input_coord));
+  }
+  return maximize_list;
+}
+
+/// \brief Computes a Max reduction by decrypting the arguments, and
+/// encrypts each maximum, or its ReLU if relu is set
 inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
                      const Shape& in_shape, const Shape& out_shape,
                      const AxisSet& reduction_axes, size_t batch_size,
                      const seal::parms_id_type& parms_id, double scale,
                      seal::CKKSEncoder& ckks_encoder,
                      seal::Encryptor& encryptor, seal::Decryptor& decryptor,
-                     std::shared_ptr<seal::SEALContext> context) {
+                     std::shared_ptr<seal::SEALContext> context,
+                     bool relu = false) {
   std::vector<HEPlaintext> out_plain(
       out.size(),
       HEPlaintext(batch_size, -std::numeric_limits<double>::infinity()));
@@ -44,22 +67,33 @@ inline void max_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
   CoordinateTransform output_transform(out_shape);
   CoordinateTransform input_transform(in_shape);
 
+  // Decryptions reuse one plaintext, and plaintext arguments are read in
+  // place
+  HEPlaintext decrypted;
   for (const Coordinate& input_coord : input_transform) {
     Coordinate output_coord = reduce(input_coord, reduction_axes);
     size_t out_idx = output_transform.index(output_coord);
 
     const HEType& max_cmp = arg[input_transform.index(input_coord)];
-    HEPlaintext max_cmp_plain;
+    const HEPlaintext* max_cmp_plain = &decrypted;
     if (max_cmp.is_plaintext()) {
-      max_cmp_plain = max_cmp.get_plaintext();
+      max_cmp_plain = &max_cmp.get_plaintext();
     } else {
-      decrypt(max_cmp_plain, *max_cmp.get_ciphertext(),
-              max_cmp.complex_packing(), decryptor, ckks_encoder, context,
-              batch_size);
-      max_cmp_plain.resize(batch_size);
+      decrypt(decrypted, *max_cmp.get_ciphertext(), max_cmp.complex_packing(),
+              decryptor, ckks_encoder, context, batch_size);
+      decrypted.resize(batch_size);
+    }
+    auto& out_values = out_plain[out_idx];
+    for (size_t i = 0; i < max_cmp_plain->size(); ++i) {
+      out_values[i] = std::max(out_values[i], (*max_cmp_plain)[i]);
     }
-    for (size_t i = 0; i < max_cmp_plain.size(); ++i) {
-      out_plain[out_idx][i] = std::max(out_plain[out_idx][i], max_cmp_plain[i]);
+  }
+
+  if (relu) {
+    for (auto& plain : out_plain) {
+      for (auto& value : plain) {
+        value = std::max(value, 0.0);
+      }
     }
   }
 
@@ -22,6 +22,8 @@
 
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
@@ -29,23 +31,8 @@ namespace ngraph::runtime::he {
 
 void scalar_minimum_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
                          HEPlaintext& out) {
-  HEPlaintext out_vals;
-  if (arg0.size() == 1) {
-    out_vals.resize(arg1.size());
-    std::transform(arg1.begin(), arg1.end(), out_vals.begin(),
-                   [&](auto x) { return std::min(x, arg0[0]); });
-  } else if (arg1.size() == 1) {
-    out_vals.resize(arg0.size());
-    std::transform(arg0.begin(), arg0.end(), out_vals.begin(),
-                   [&](auto x) { return std::min(x, arg1[0]); });
-  } else {
-    size_t min_size = std::min(arg0.size(), arg1.size());
-    out_vals.resize(min_size);
-    for (size_t i = 0; i < min_size; ++i) {
-      out_vals[i] = std::min(arg0[i], arg1[i]);
-    }
-  }
-  out = std::move(out_vals);
+  plaintext_binary_op_seal(arg0, arg1, out,
+                           [](double x, double y) { return std::min(x, y); });
 }
 
 void scalar_minimum_seal(const HEType& arg0, const HEType& arg1, HEType& out,
@@ -80,9 +67,9 @@ void scalar_minimum_seal(const HEType& arg0, const HEType& arg1, HEType& out,
 void minimum_seal(const std::vector<HEType>& arg0,
                   const std::vector<HEType>& arg1, std::vector<HEType>& out,
                   size_t count, HESealBackend& he_seal_backend) {
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for_seal(count, {&arg0, &arg1}, [&](size_t i) {
     scalar_minimum_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::runtime::he
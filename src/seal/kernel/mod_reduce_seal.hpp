@@ -20,6 +20,7 @@
 
 #include "he_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 
@@ -33,10 +34,9 @@ inline void mod_reduce_seal(std::vector<HEType>& arg,
   }
   auto t0 = std::chrono::system_clock::now();
 
-#pragma omp parallel for
-  for (size_t he_idx = 0; he_idx < arg.size(); ++he_idx) {
+  parallel_for_seal(arg.size(), {&arg}, [&](size_t he_idx) {
     if (!arg[he_idx].is_ciphertext()) {
-      continue;
+      return;
     }
 
     seal::Ciphertext& encrypted = arg[he_idx].get_ciphertext()->ciphertext();
@@ -67,7 +67,7 @@ inline void mod_reduce_seal(std::vector<HEType>& arg,
         }
       }
     }
-  }
+  });
   auto t1 = std::chrono::system_clock::now();
   NGRAPH_HE_LOG(3)
       << "lazy mod-reduce took "
@@ -0,0 +1,470 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/seal_util.hpp"
+#include "seal/util/uintarithsmallmod.h"
+
+namespace ngraph::runtime::he {
+
+void scalar_multiply_accumulate_seal(const HEType& arg0, const HEType& arg1,
+                                     HEType& sum, HEType& prod,
+                                     bool& first_add, size_t batch_size,
+                                     HESealBackend& he_seal_backend) {
+  const HEType* cipher_arg = nullptr;
+  const HEType* plain_arg = nullptr;
+  if (arg0.is_ciphertext() && arg1.is_plaintext()) {
+    cipher_arg = &arg0;
+    plain_arg = &arg1;
+  } else if (arg0.is_plaintext() && arg1.is_ciphertext()) {
+    cipher_arg = &arg1;
+    plain_arg = &arg0;
+  }
+
+  bool fused = cipher_arg != nullptr && !cipher_arg->complex_packing() &&
+               plain_arg->get_plaintext().size() == 1 &&
+               !he_seal_backend.lazy_mod();
+  if (fused) {
+    const seal::Ciphertext& cipher =
+        cipher_arg->get_ciphertext()->ciphertext();
+    double value = plain_arg->get_plaintext()[0];
+
+    // Matches the zero-skipping of scalar_multiply_seal
+    if (std::abs(value) < 1e-5f) {
+      if (first_add) {
+        sum = HEType(HEPlaintext(batch_size, 0), cipher_arg->complex_packing());
+        first_add = false;
+      }
+      return;
+    }
+    if (first_add || sum.is_plaintext()) {
+      HEPlaintext partial_sum;
+      if (!first_add &&
+          std::any_of(sum.get_plaintext().begin(), sum.get_plaintext().end(),
+                      [](double f) { return f != 0.0; })) {
+        partial_sum = sum.get_plaintext();
+      }
+      sum.set_ciphertext(HESealBackend::create_empty_ciphertext());
+      sum.complex_packing() = cipher_arg->complex_packing();
+      multiply_plain(cipher, value, sum.get_ciphertext()->ciphertext(),
+                     he_seal_backend);
+      if (!partial_sum.empty()) {
+        scalar_add_seal(*sum.get_ciphertext(), partial_sum,
+                        sum.get_ciphertext(), sum.complex_packing(),
+                        he_seal_backend);
+      }
+      first_add = false;
+      return;
+    }
+    seal::Ciphertext& acc = sum.get_ciphertext()->ciphertext();
+    double prod_scale =
+        cipher.scale() *
+        he_seal_backend.multiplicand_scale(cipher.parms_id(), cipher.scale());
+    if (acc.parms_id() == cipher.parms_id() && acc.size() == cipher.size() &&
+        prod_scale / acc.scale() <= 1.05 && acc.scale() / prod_scale <= 1.05) {
+      multiply_plain_accumulate(cipher, value, acc, he_seal_backend);
+      return;
+    }
+  }
+
+  // Generic path. The multiply arguments may be modulus-switched in place,
+  // as with scalar_multiply_seal
+  HEType mult_arg0 = arg0;
+  HEType mult_arg1 = arg1;
+  scalar_multiply_seal(mult_arg0, mult_arg1, prod, he_seal_backend);
+  if (first_add) {
+    // The previous sum becomes the scratch product, so neither allocates
+    std::swap(sum, prod);
+    first_add = false;
+  } else {
+    scalar_add_seal(prod, sum, sum, he_seal_backend);
+  }
+}
+
+MultiplyAccumulator::MultiplyAccumulator(size_t batch_size,
+                                         HESealBackend& he_seal_backend)
+    : m_batch_size(batch_size),
+      m_he_seal_backend(he_seal_backend),
+      m_sum(HEPlaintext(), false),
+      m_prod(HEPlaintext(), false),
+      m_lazy(he_seal_backend.lazy_mod()) {}
+
+void MultiplyAccumulator::accumulate(const HEType& arg0, const HEType& arg1) {
+  const HEType* cipher_arg = nullptr;
+  const HEType* plain_arg = nullptr;
+  if (arg0.is_ciphertext() && arg1.is_plaintext()) {
+    cipher_arg = &arg0;
+    plain_arg = &arg1;
+  } else if (arg0.is_plaintext() && arg1.is_ciphertext()) {
+    cipher_arg = &arg1;
+    plain_arg = &arg0;
+  }
+
+  if (!m_lazy || cipher_arg == nullptr || cipher_arg->complex_packing() ||
+      plain_arg->get_plaintext().size() != 1) {
+    scalar_multiply_accumulate_seal(arg0, arg1, m_sum, m_prod, m_first_add,
+                                    m_batch_size, m_he_seal_backend);
+    return;
+  }
+
+  const seal::Ciphertext& cipher = cipher_arg->get_ciphertext()->ciphertext();
+  double value = plain_arg->get_plaintext()[0];
+  if (std::abs(value) < 1e-5f) {
+    return;
+  }
+
+  auto context = m_he_seal_backend.get_context();
+  auto& context_data = *context->get_context_data(cipher.parms_id());
+  auto& coeff_modulus = context_data.parms().coeff_modulus();
+  size_t coeff_count = context_data.parms().poly_modulus_degree();
+  size_t coeff_mod_count = coeff_modulus.size();
+  double value_scale =
+      m_he_seal_backend.multiplicand_scale(cipher.parms_id(), cipher.scale());
+  double prod_scale = cipher.scale() * value_scale;
+
+  if (m_lazy_terms > 0 &&
+      (m_lazy_parms_id != cipher.parms_id() || m_lazy_size != cipher.size() ||
+       m_lazy_scale != prod_scale || m_lazy_terms == m_lazy_max_terms)) {
+    flush_lazy();
+  }
+  if (m_lazy_terms == 0) {
+    m_lazy_parms_id = cipher.parms_id();
+    m_lazy_size = cipher.size();
+    m_lazy_scale = prod_scale;
+    m_lazy_sum.assign(m_lazy_size * coeff_mod_count * coeff_count, 0);
+
+    // Each product is below 2^(2 * max_bits), so the 128-bit limbs are safe
+    // for 2^(128 - 2 * max_bits) products
+    int max_bits = 0;
+    for (const auto& modulus : coeff_modulus) {
+      max_bits = std::max(max_bits, modulus.bit_count());
+    }
+    int headroom_bits = std::min(128 - 2 * max_bits, 63);
+    m_lazy_max_terms = headroom_bits > 0 ? (1UL << headroom_bits) : 1;
+  }
+
+  encode(value, element::f32, value_scale, cipher.parms_id(), m_encoding,
+         m_he_seal_backend);
+
+  parallel_for_limbs_seal(
+      m_lazy_size, coeff_mod_count, coeff_count,
+      [&](size_t i, size_t j, size_t begin, size_t end) {
+        size_t offset = (i * coeff_mod_count + j) * coeff_count;
+        unsigned __int128* acc = m_lazy_sum.data() + offset;
+        const std::uint64_t* src = cipher.data() + offset;
+        const auto scalar = static_cast<unsigned __int128>(m_encoding[j]);
+#pragma omp simd
+        for (size_t k = begin; k < end; ++k) {
+          acc[k] += src[k] * scalar;
+        }
+      });
+  ++m_lazy_terms;
+}
+
+void MultiplyAccumulator::flush_lazy() {
+  if (m_lazy_terms == 0) {
+    return;
+  }
+  auto context = m_he_seal_backend.get_context();
+  auto& context_data = *context->get_context_data(m_lazy_parms_id);
+  auto& coeff_modulus = context_data.parms().coeff_modulus();
+  size_t coeff_count = context_data.parms().poly_modulus_degree();
+  size_t coeff_mod_count = coeff_modulus.size();
+
+  auto reduced = HESealBackend::create_empty_ciphertext();
+  seal::Ciphertext& cipher = reduced->ciphertext();
+  cipher.resize(*context, m_lazy_parms_id, m_lazy_size);
+  cipher.is_ntt_form() = true;
+  cipher.scale() = m_lazy_scale;
+
+  parallel_for_limbs_seal(
+      m_lazy_size, coeff_mod_count, coeff_count,
+      [&](size_t i, size_t j, size_t begin, size_t end) {
+        size_t offset = (i * coeff_mod_count + j) * coeff_count;
+        const unsigned __int128* acc = m_lazy_sum.data() + offset;
+        std::uint64_t* dest = cipher.data() + offset;
+        for (size_t k = begin; k < end; ++k) {
+          std::uint64_t limbs[2]{static_cast<std::uint64_t>(acc[k]),
+                                 static_cast<std::uint64_t>(acc[k] >> 64U)};
+          dest[k] = seal::util::barrett_reduce_128(limbs, coeff_modulus[j]);
+        }
+      });
+  m_lazy_terms = 0;
+
+  HEType partial(reduced, false, m_batch_size);
+  if (m_first_add) {
+    m_sum = std::move(partial);
+    m_first_add = false;
+  } else {
+    scalar_add_seal(partial, m_sum, m_sum, m_he_seal_backend);
+  }
+}
+
+void MultiplyAccumulator::finalize(HEType& out) {
+  flush_lazy();
+  if (m_first_add) {
+    out.set_plaintext(HEPlaintext(m_batch_size, 0));
+  } else {
+    out = std::move(m_sum);
+  }
+  reset();
+}
+
+void MultiplyAccumulator::reset() {
+  m_lazy_terms = 0;
+  m_first_add = true;
+  // A moved-from sum holds no ciphertext, and is overwritten by the next sum
+  m_sum.set_plaintext(HEPlaintext());
+}
+
+namespace {
+/// \brief Weights this close to zero are skipped, as in scalar_multiply_seal
+bool is_zero_weight(double value) { return std::abs(value) < 1e-5f; }
+}  // namespace
+
+std::optional<WeightedSums> make_weighted_sums(
+    const std::vector<HEType>& arg1, const std::vector<size_t>& offsets,
+    const std::vector<uint32_t>& input_indices,
+    const std::vector<uint32_t>& weight_indices) {
+  NGRAPH_CHECK(!offsets.empty() && input_indices.size() == offsets.back() &&
+                   weight_indices.size() == offsets.back(),
+               "Invalid terms of weighted sums");
+
+  // Group 0 holds weights 1, group 1 weights -1 and group 2 other weights
+  auto group = [&arg1](uint32_t weight_idx) -> std::optional<size_t> {
+    double value = arg1[weight_idx].get_plaintext()[0];
+    if (is_zero_weight(value)) {
+      return std::nullopt;
+    }
+    if (value == 1.0) {
+      return 0;
+    }
+    return value == -1.0 ? 1 : 2;
+  };
+
+  for (uint32_t weight_idx : weight_indices) {
+    NGRAPH_CHECK(weight_idx < arg1.size(), "Weight index ", weight_idx,
+                 " out of range");
+    const HEType& weight = arg1[weight_idx];
+    if (!weight.is_plaintext() || weight.complex_packing() ||
+        weight.get_plaintext().size() != 1) {
+      return std::nullopt;
+    }
+  }
+
+  size_t num_sums = offsets.size() - 1;
+  WeightedSums sums;
+  sums.offsets.resize(3 * num_sums + 1, 0);
+  for (size_t sum_idx = 0; sum_idx < num_sums; ++sum_idx) {
+    for (size_t term = offsets[sum_idx]; term < offsets[sum_idx + 1];
+         ++term) {
+      if (auto g = group(weight_indices[term]); g.has_value()) {
+        sums.offsets[3 * sum_idx + *g + 1]++;
+      }
+    }
+  }
+  for (size_t i = 1; i < sums.offsets.size(); ++i) {
+    sums.offsets[i] += sums.offsets[i - 1];
+  }
+
+  sums.input_indices.resize(sums.offsets.back());
+  sums.weight_indices.resize(sums.offsets.back());
+  std::vector<size_t> next(sums.offsets.begin(), sums.offsets.end() - 1);
+  for (size_t sum_idx = 0; sum_idx < num_sums; ++sum_idx) {
+    for (size_t term = offsets[sum_idx]; term < offsets[sum_idx + 1];
+         ++term) {
+      if (auto g = group(weight_indices[term]); g.has_value()) {
+        size_t dst = next[3 * sum_idx + *g]++;
+        sums.input_indices[dst] = input_indices[term];
+        sums.weight_indices[dst] = weight_indices[term];
+      }
+    }
+  }
+  return sums;
+}
+
+bool quantize_weighted_sums(WeightedSums& sums,
+                            const std::vector<HEType>& arg1, double step) {
+  std::vector<int64_t> integer_weights(sums.weight_indices.size());
+  for (size_t term = 0; term < sums.weight_indices.size(); ++term) {
+    double value = arg1[sums.weight_indices[term]].get_plaintext()[0];
+    auto weight = quantize_weight(value, step);
+    if (!weight.has_value()) {
+      return false;
+    }
+    integer_weights[term] = *weight;
+  }
+  sums.integer_weights = std::move(integer_weights);
+  sums.quantization_step = step;
+  return true;
+}
+
+namespace {
+/// \brief Computes a quantized weighted sum. Ciphertext terms are multiplied
+/// by their integer weights at the scale of the inputs, which must match
+void quantized_weighted_sum_seal(const std::vector<HEType>& arg0,
+                                 const std::vector<HEType>& arg1,
+                                 const WeightedSums& sums, size_t sum_idx,
+                                 size_t input_offset, HEType& out,
+                                 size_t batch_size,
+                                 HESealBackend& he_seal_backend) {
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  std::shared_ptr<SealCiphertextWrapper> cipher_sum;
+  bool complex_packing = false;
+  std::optional<HEPlaintext> plain_sum;
+  seal::Ciphertext product;
+
+  for (size_t term = sums.offsets[3 * sum_idx];
+       term < sums.offsets[3 * sum_idx + 3]; ++term) {
+    const HEType& input = arg0[input_offset + sums.input_indices[term]];
+    if (input.is_plaintext()) {
+      HEPlaintext plain_product;
+      scalar_multiply_seal(input.get_plaintext(),
+                           arg1[sums.weight_indices[term]].get_plaintext(),
+                           plain_product);
+      if (plain_sum.has_value()) {
+        scalar_add_seal(*plain_sum, plain_product, *plain_sum);
+      } else {
+        plain_sum = std::move(plain_product);
+      }
+      continue;
+    }
+
+    // Weights 1 and -1 are added and subtracted without a product
+    int64_t weight = sums.integer_weights[term];
+    const seal::Ciphertext* addend = &input.get_ciphertext()->ciphertext();
+    if (weight != 1 && weight != -1) {
+      product = *addend;
+      multiply_plain_integer_inplace(product, weight, he_seal_backend);
+      addend = &product;
+    }
+    bool negate = weight == -1;
+    if (cipher_sum == nullptr) {
+      cipher_sum = HESealBackend::create_empty_ciphertext();
+      cipher_sum->ciphertext() = *addend;
+      if (negate) {
+        evaluator.negate_inplace(cipher_sum->ciphertext());
+      }
+      complex_packing = input.complex_packing();
+      continue;
+    }
+    NGRAPH_CHECK(cipher_sum->ciphertext().parms_id() == addend->parms_id() &&
+                     cipher_sum->scale() == addend->scale() &&
+                     complex_packing == input.complex_packing(),
+                 "Terms of quantized sums must match in level, scale and "
+                 "packing");
+    if (negate) {
+      evaluator.sub_inplace(cipher_sum->ciphertext(), *addend);
+    } else {
+      evaluator.add_inplace(cipher_sum->ciphertext(), *addend);
+    }
+  }
+
+  if (cipher_sum == nullptr) {
+    out.set_plaintext(plain_sum.value_or(HEPlaintext(batch_size, 0)));
+    return;
+  }
+  // Dividing the scale by the step decodes integer weight k as k * step
+  cipher_sum->ciphertext().scale() /= sums.quantization_step;
+  out = HEType(cipher_sum, complex_packing, batch_size);
+  if (plain_sum.has_value()) {
+    HEType plain(*plain_sum, complex_packing);
+    scalar_add_seal(out, plain, out, he_seal_backend);
+  }
+}
+}  // namespace
+
+void weighted_sum_seal(const std::vector<HEType>& arg0,
+                       const std::vector<HEType>& arg1,
+                       const WeightedSums& sums, size_t sum_idx,
+                       size_t input_offset, HEType& out, size_t batch_size,
+                       HESealBackend& he_seal_backend) {
+  MultiplyAccumulator accumulator(batch_size, he_seal_backend);
+  weighted_sum_seal(arg0, arg1, sums, sum_idx, input_offset, out, batch_size,
+                    he_seal_backend, accumulator);
+}
+
+void weighted_sum_seal(const std::vector<HEType>& arg0,
+                       const std::vector<HEType>& arg1,
+                       const WeightedSums& sums, size_t sum_idx,
+                       size_t input_offset, HEType& out, size_t batch_size,
+                       HESealBackend& he_seal_backend,
+                       MultiplyAccumulator& accumulator) {
+  if (sums.quantization_step > 0) {
+    quantized_weighted_sum_seal(arg0, arg1, sums, sum_idx, input_offset, out,
+                                batch_size, he_seal_backend);
+    return;
+  }
+  const size_t* offsets = &sums.offsets[3 * sum_idx];
+
+  size_t other_begin = offsets[0];
+  if (!he_seal_backend.lazy_mod()) {
+    // Lazy modular reduction leaves no room for unreduced additions
+    auto& evaluator = *he_seal_backend.get_evaluator();
+    std::shared_ptr<SealCiphertextWrapper> signed_sum;
+    for (size_t term = offsets[0]; term < offsets[2]; ++term) {
+      const HEType& input = arg0[input_offset + sums.input_indices[term]];
+      bool negate = term >= offsets[1];
+      if (!input.is_ciphertext() || input.complex_packing()) {
+        accumulator.accumulate(input, arg1[sums.weight_indices[term]]);
+        continue;
+      }
+      const seal::Ciphertext& cipher = input.get_ciphertext()->ciphertext();
+      if (signed_sum == nullptr) {
+        signed_sum = HESealBackend::create_empty_ciphertext();
+        signed_sum->ciphertext() = cipher;
+        if (negate) {
+          evaluator.negate_inplace(signed_sum->ciphertext());
+        }
+      } else if (signed_sum->ciphertext().parms_id() == cipher.parms_id() &&
+                 signed_sum->scale() == cipher.scale()) {
+        if (negate) {
+          evaluator.sub_inplace(signed_sum->ciphertext(), cipher);
+        } else {
+          evaluator.add_inplace(signed_sum->ciphertext(), cipher);
+        }
+      } else {
+        accumulator.accumulate(input, arg1[sums.weight_indices[term]]);
+      }
+    }
+    if (signed_sum != nullptr) {
+      static const HEType one(HEPlaintext(std::initializer_list<double>{1}),
+                              false);
+      accumulator.accumulate(HEType(signed_sum, false, batch_size), one);
+    }
+    other_begin = offsets[2];
+  }
+
+  for (size_t term = other_begin; term < offsets[3]; ++term) {
+    accumulator.accumulate(arg0[input_offset + sums.input_indices[term]],
+                           arg1[sums.weight_indices[term]]);
+  }
+  accumulator.finalize(out);
+}
+
+}  // namespace ngraph::runtime::he
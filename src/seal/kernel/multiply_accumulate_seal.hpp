@@ -0,0 +1,172 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Accumulates the product of two elements into a running sum, i.e.
+/// sum += arg0 * arg1. Products of a ciphertext with a scalar plaintext are
+/// reduced directly into the sum whenever the sum has the same level and
+/// scale, avoiding a temporary ciphertext and the scale matching done by
+/// scalar_add_seal. Other products fall back to scalar_multiply_seal and
+/// scalar_add_seal, using prod as a scratch buffer. No rescaling is performed,
+/// so a single rescale may be done once the reduction completes.
+/// \param[in] arg0 Cipher or plaintext multiplicand
+/// \param[in] arg1 Cipher or plaintext multiplicand
+/// \param[in,out] sum Running sum. Ignored on input if first_add is true
+/// \param[in,out] prod Scratch element reused across calls. Must not alias
+/// sum or any tensor element
+/// \param[in,out] first_add Whether or not sum is still empty. Set to false
+/// once a non-zero product has been accumulated
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform multiplication and
+/// addition
+void scalar_multiply_accumulate_seal(const HEType& arg0, const HEType& arg1,
+                                     HEType& sum, HEType& prod,
+                                     bool& first_add, size_t batch_size,
+                                     HESealBackend& he_seal_backend);
+
+/// \brief Accumulates a sum of products, as computed by each output of Dot
+/// and Convolution. If the backend uses lazy modular reduction, products of a
+/// ciphertext with a scalar plaintext are accumulated unreduced in 128-bit
+/// limbs, and Barrett-reduced once when the reduction window completes, or
+/// the limbs would overflow. Otherwise, this is equivalent to calling
+/// scalar_multiply_accumulate_seal for each product.
+class MultiplyAccumulator {
+ public:
+  /// \brief Constructs an empty accumulator
+  /// \param[in] batch_size Batch size of the accumulated elements
+  /// \param[in] he_seal_backend Backend used to perform multiplication and
+  /// addition
+  MultiplyAccumulator(size_t batch_size, HESealBackend& he_seal_backend);
+
+  /// \brief Accumulates arg0 * arg1
+  /// \param[in] arg0 Cipher or plaintext multiplicand
+  /// \param[in] arg1 Cipher or plaintext multiplicand
+  void accumulate(const HEType& arg0, const HEType& arg1);
+
+  /// \brief Writes the accumulated sum, or a plaintext zero if no non-zero
+  /// product was accumulated, and resets the accumulator
+  /// \param[out] out Destination of the sum
+  void finalize(HEType& out);
+
+  /// \brief Discards the accumulated products. The scratch storage is kept,
+  /// so kernels reuse one accumulator per thread across their outputs
+  void reset();
+
+ private:
+  /// \brief Reduces the unreduced limbs and adds them to m_sum
+  void flush_lazy();
+
+  size_t m_batch_size;
+  HESealBackend& m_he_seal_backend;
+  HEType m_sum;
+  HEType m_prod;
+  bool m_first_add{true};
+
+  bool m_lazy;
+  // One unreduced 128-bit value per coefficient of each polynomial
+  std::vector<unsigned __int128> m_lazy_sum;
+  seal::parms_id_type m_lazy_parms_id{seal::parms_id_zero};
+  size_t m_lazy_size{0};
+  double m_lazy_scale{0};
+  size_t m_lazy_terms{0};
+  size_t m_lazy_max_terms{0};
+  // CRT form of the current scalar plaintext
+  std::vector<std::uint64_t> m_encoding;
+};
+
+/// \brief Sums of products arg0[i] * arg1[j] whose multiplicands arg1[j] are
+/// known real scalar plaintexts, as computed by each output of Dot and
+/// Convolution with Constant weights. Terms with zero weights are dropped,
+/// and the terms of each sum are grouped by weight 1, weight -1 and other
+/// weights
+struct WeightedSums {
+  /// \brief Terms of sum i with weight 1, weight -1 and other weights have
+  /// index in [offsets[3 * i], offsets[3 * i + 1]),
+  /// [offsets[3 * i + 1], offsets[3 * i + 2]) and
+  /// [offsets[3 * i + 2], offsets[3 * i + 3]) respectively
+  std::vector<size_t> offsets;
+  std::vector<uint32_t> input_indices;
+  std::vector<uint32_t> weight_indices;
+  /// \brief If quantization_step is positive, the weight of term t is
+  /// integer_weights[t] times quantization_step, see quantize_weighted_sums
+  std::vector<int64_t> integer_weights;
+  double quantization_step{0};
+};
+
+/// \brief Groups the terms of sums of products by weight
+/// \param[in] arg1 Weights
+/// \param[in] offsets Terms of sum i have index in [offsets[i], offsets[i + 1])
+/// \param[in] input_indices Index into arg0 of each term
+/// \param[in] weight_indices Index into arg1 of each term
+/// \returns The grouped sums, or std::nullopt if a weight is not a real
+/// scalar plaintext
+std::optional<WeightedSums> make_weighted_sums(
+    const std::vector<HEType>& arg1, const std::vector<size_t>& offsets,
+    const std::vector<uint32_t>& input_indices,
+    const std::vector<uint32_t>& weight_indices);
+
+/// \brief Expresses every weight of the sums as an integer multiple of a
+/// quantization step, if each weight is one, see quantize_weight
+/// \param[in,out] sums Grouped sums
+/// \param[in] arg1 Weights the sums were grouped from
+/// \param[in] step Quantization step
+/// \returns Whether or not the weights were quantized
+bool quantize_weighted_sums(WeightedSums& sums,
+                            const std::vector<HEType>& arg1, double step);
+
+/// \brief Computes one of the weighted sums. If the sums are quantized,
+/// ciphertexts are multiplied by their integer weights and the scale of the
+/// sum is divided by the quantization step, so the sum needs no rescale.
+/// Otherwise, unless the backend uses lazy modular reduction, ciphertexts
+/// with weight 1 and -1 are added and subtracted, and their total is
+/// multiplied by one plaintext once. Other terms are accumulated by a
+/// MultiplyAccumulator
+/// \param[in] arg0 Cipher or plaintext multiplicands
+/// \param[in] arg1 Weights the sums were grouped from
+/// \param[in] sums Grouped sums
+/// \param[in] sum_idx Index of the sum to compute
+/// \param[in] input_offset Offset added to the arg0 index of each term
+/// \param[out] out Destination of the sum
+/// \param[in] batch_size Batch size of the elements
+/// \param[in] he_seal_backend Backend used to perform the arithmetic
+void weighted_sum_seal(const std::vector<HEType>& arg0,
+                       const std::vector<HEType>& arg1,
+                       const WeightedSums& sums, size_t sum_idx,
+                       size_t input_offset, HEType& out, size_t batch_size,
+                       HESealBackend& he_seal_backend);
+
+/// \brief Computes one of a set of grouped weighted sums, as above, using
+/// the scratch storage of an accumulator
+/// \param[in,out] accumulator Empty accumulator of the batch size, which is
+/// empty again on return
+void weighted_sum_seal(const std::vector<HEType>& arg0,
+                       const std::vector<HEType>& arg1,
+                       const WeightedSums& sums, size_t sum_idx,
+                       size_t input_offset, HEType& out, size_t batch_size,
+                       HESealBackend& he_seal_backend,
+                       MultiplyAccumulator& accumulator);
+
+}  // namespace ngraph::runtime::he
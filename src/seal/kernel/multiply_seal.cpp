@@ -17,10 +17,14 @@
 #include "seal/kernel/multiply_seal.hpp"
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 
+#include "seal/he_primitive_counter.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/negate_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
@@ -30,6 +34,10 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
                           std::shared_ptr<SealCiphertextWrapper>& out,
                           bool complex_packing, HESealBackend& he_seal_backend,
                           const seal::MemoryPoolHandle& pool) {
+  // Products of deferred products would grow further, and complex
+  // conjugation requires size 2
+  relinearize_inplace(arg0, he_seal_backend, pool);
+  relinearize_inplace(arg1, he_seal_backend, pool);
   match_modulus_and_scale_inplace(arg0, arg1, he_seal_backend, pool);
   size_t chain_ind0 = he_seal_backend.get_chain_index(arg0);
   size_t chain_ind1 = he_seal_backend.get_chain_index(arg1);
@@ -47,10 +55,18 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
     seal::Ciphertext c0_conj;
     seal::Ciphertext c1_conj;
 
-    he_seal_backend.get_evaluator()->complex_conjugate(
-        c0, *he_seal_backend.get_galois_keys(), c0_conj);
-    he_seal_backend.get_evaluator()->complex_conjugate(
-        c1, *he_seal_backend.get_galois_keys(), c1_conj);
+    HEPrimitiveCounter::increment(HEPrimitive::rotate, 2);
+    HEPrimitiveCounter::increment(HEPrimitive::multiply, 2);
+    HEPrimitiveCounter::increment(HEPrimitive::relinearize, 2);
+    HEPrimitiveCounter::increment(HEPrimitive::encode, 2);
+    HEPrimitiveCounter::increment(HEPrimitive::multiply_plain, 2);
+    HEPrimitiveCounter::increment(HEPrimitive::rescale);
+
+    const auto galois_keys = he_seal_backend.get_galois_keys({0});
+    he_seal_backend.get_evaluator()->complex_conjugate(c0, *galois_keys,
+                                                       c0_conj);
+    he_seal_backend.get_evaluator()->complex_conjugate(c1, *galois_keys,
+                                                       c1_conj);
 
     seal::Ciphertext c0_re;
     seal::Ciphertext c0_im;
@@ -97,9 +113,10 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
     he_seal_backend.get_evaluator()->multiply_plain_inplace(prod_re, fudge_re);
     he_seal_backend.get_evaluator()->add(prod_re, prod_im, out->ciphertext());
 
-    he_seal_backend.get_evaluator()->rescale_to_next_inplace(out->ciphertext(),
-                                                             pool);
+    rescale_inplace(out->ciphertext(), *he_seal_backend.get_evaluator(),
+                    he_seal_backend.rescale_primes(), pool);
   } else {
+    HEPrimitiveCounter::increment(HEPrimitive::multiply);
     if (&arg0.ciphertext() == &arg1.ciphertext()) {
       he_seal_backend.get_evaluator()->square(arg0.ciphertext(),
                                               out->ciphertext(), pool);
@@ -108,8 +125,11 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0,
           arg0.ciphertext(), arg1.ciphertext(), out->ciphertext(), pool);
     }
 
-    he_seal_backend.get_evaluator()->relinearize_inplace(
-        out->ciphertext(), *(he_seal_backend.get_relin_keys()), pool);
+    if (!he_seal_backend.lazy_relinearization()) {
+      HEPrimitiveCounter::increment(HEPrimitive::relinearize);
+      he_seal_backend.get_evaluator()->relinearize_inplace(
+          out->ciphertext(), *(he_seal_backend.get_relin_keys()), pool);
+    }
   }
 }
 
@@ -154,7 +174,9 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
   // Never complex-pack for multiplication
   auto p = SealPlaintextWrapper(false);
   encode(p, arg1, *he_seal_backend.get_ckks_encoder(),
-         arg0.ciphertext().parms_id(), element::f32, arg0.ciphertext().scale(),
+         arg0.ciphertext().parms_id(), element::f32,
+         he_seal_backend.multiplicand_scale(arg0.ciphertext().parms_id(),
+                                            arg0.ciphertext().scale()),
          false);
 
   size_t chain_ind0 = he_seal_backend.get_chain_index(arg0);
@@ -166,6 +188,7 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
   NGRAPH_CHECK(chain_ind1 > 0, "Multiplicative depth exceeded for arg1");
 
   try {
+    HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
     he_seal_backend.get_evaluator()->multiply_plain(
         arg0.ciphertext(), p.plaintext(), out.get_ciphertext()->ciphertext(),
         pool);
@@ -177,29 +200,91 @@ void scalar_multiply_seal(SealCiphertextWrapper& arg0, const HEPlaintext& arg1,
   }
 }
 
+void scalar_multiply_complex_seal(SealCiphertextWrapper& arg0,
+                                  const HEPlaintext& arg1, HEType& out,
+                                  HESealBackend& he_seal_backend,
+                                  const seal::MemoryPoolHandle& pool) {
+  if (arg1.size() == 1) {
+    scalar_multiply_seal(arg0, arg1, out, he_seal_backend, pool);
+    return;
+  }
+
+  // Slot j stores c_j = x_{2j} + i x_{2j+1}, which is multiplied component-
+  // wise by y_{2j} and y_{2j+1}. With real u_j = (y_{2j} + y_{2j+1}) / 2 and
+  // v_j = (y_{2j} - y_{2j+1}) / 2, c_j u_j + c_j* v_j is the product
+  size_t slot_values = (arg1.size() + 1) / 2;
+  HEPlaintext sum_half(slot_values, 0);
+  HEPlaintext diff_half(slot_values, 0);
+  for (size_t i = 0; i < slot_values; ++i) {
+    double real = arg1[2 * i];
+    double imag = (2 * i + 1 < arg1.size()) ? arg1[2 * i + 1] : 0;
+    sum_half[i] = (real + imag) / 2;
+    diff_half[i] = (real - imag) / 2;
+  }
+  auto is_zero = [](double f) { return std::abs(f) < 1e-5f; };
+  bool zero_sum = std::all_of(sum_half.begin(), sum_half.end(), is_zero);
+  bool zero_diff = std::all_of(diff_half.begin(), diff_half.end(), is_zero);
+  if (zero_sum && zero_diff) {
+    out.set_plaintext(HEPlaintext(arg1.size(), 0));
+    return;
+  }
+
+  NGRAPH_CHECK(he_seal_backend.get_chain_index(arg0) > 0,
+               "Multiplicative depth exceeded for arg0");
+  if (!zero_diff) {
+    relinearize_inplace(arg0, he_seal_backend, pool);
+  }
+  if (!out.is_ciphertext()) {
+    out.set_ciphertext(HESealBackend::create_empty_ciphertext());
+  }
+  seal::Ciphertext& product = out.get_ciphertext()->ciphertext();
+  auto evaluator = he_seal_backend.get_evaluator();
+  auto encode_half = [&](const HEPlaintext& values) {
+    auto plain = SealPlaintextWrapper(false);
+    encode(plain, values, *he_seal_backend.get_ckks_encoder(),
+           arg0.ciphertext().parms_id(), element::f32,
+           he_seal_backend.multiplicand_scale(arg0.ciphertext().parms_id(),
+                                              arg0.ciphertext().scale()),
+           false);
+    return plain;
+  };
+
+  seal::Ciphertext conj_product;
+  if (!zero_diff) {
+    HEPrimitiveCounter::increment(HEPrimitive::rotate);
+    HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+    const auto galois_keys = he_seal_backend.get_galois_keys({0});
+    evaluator->complex_conjugate(arg0.ciphertext(), *galois_keys,
+                                 conj_product, pool);
+    evaluator->multiply_plain_inplace(conj_product,
+                                      encode_half(diff_half).plaintext(), pool);
+  }
+  if (zero_sum) {
+    product = std::move(conj_product);
+    return;
+  }
+  HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+  evaluator->multiply_plain(arg0.ciphertext(),
+                            encode_half(sum_half).plaintext(), product, pool);
+  if (!zero_diff) {
+    evaluator->add_inplace(product, conj_product);
+  }
+}
+
 void scalar_multiply_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
                           HEPlaintext& out) {
-  HEPlaintext out_vals;
-  if (arg0.size() == 1) {
-    out_vals.resize(arg1.size());
-    std::transform(arg1.begin(), arg1.end(), out_vals.begin(),
-                   [&](auto x) { return x * arg0[0]; });
-  } else if (arg1.size() == 1) {
-    out_vals.resize(arg0.size());
-    std::transform(arg0.begin(), arg0.end(), out_vals.begin(),
-                   [&](auto x) { return x * arg1[0]; });
-  } else {
-    size_t min_size = std::min(arg0.size(), arg1.size());
-    out_vals.resize(min_size);
-    for (size_t i = 0; i < min_size; ++i) {
-      out_vals[i] = arg0[i] * arg1[i];
-    }
-  }
-  out = std::move(out_vals);
+  plaintext_binary_op_seal(arg0, arg1, out,
+                           [](double x, double y) { return x * y; });
 }
 
 void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
                           HESealBackend& he_seal_backend) {
+  if (aliases_plaintext_arg(arg0, arg1, out)) {
+    HEType product(HEPlaintext(), out.complex_packing());
+    scalar_multiply_seal(arg0, arg1, product, he_seal_backend);
+    out = std::move(product);
+    return;
+  }
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                  "Complex packing types don't match");
@@ -208,19 +293,33 @@ void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
     }
     scalar_multiply_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
                          out.get_ciphertext(), arg0.complex_packing(),
-                         he_seal_backend);
+                         he_seal_backend, he_seal_backend.pool());
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
-    scalar_multiply_seal(*arg0.get_ciphertext(), arg1.get_plaintext(), out,
-                         he_seal_backend);
+    if (arg0.complex_packing()) {
+      scalar_multiply_complex_seal(*arg0.get_ciphertext(), arg1.get_plaintext(),
+                                   out, he_seal_backend,
+                                   he_seal_backend.pool());
+    } else {
+      scalar_multiply_seal(*arg0.get_ciphertext(), arg1.get_plaintext(), out,
+                           he_seal_backend, he_seal_backend.pool());
+    }
   } else if (arg0.is_plaintext() && arg1.is_ciphertext()) {
     if (!out.is_ciphertext()) {
       out.set_ciphertext(HESealBackend::create_empty_ciphertext());
     }
-    scalar_multiply_seal(*arg1.get_ciphertext(), arg0.get_plaintext(), out,
-                         he_seal_backend);
+    if (arg1.complex_packing()) {
+      scalar_multiply_complex_seal(*arg1.get_ciphertext(), arg0.get_plaintext(),
+                                   out, he_seal_backend,
+                                   he_seal_backend.pool());
+    } else {
+      scalar_multiply_seal(*arg1.get_ciphertext(), arg0.get_plaintext(), out,
+                           he_seal_backend, he_seal_backend.pool());
+    }
+    out.complex_packing() = arg1.complex_packing();
+    return;
   } else if (arg0.is_plaintext() && arg1.is_plaintext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                  "Complex packing types don't match");
@@ -244,10 +343,58 @@ void multiply_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
-    scalar_multiply_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  // Homogeneous operands skip the per-element dispatch on the operand types
+  parallel_for_kinds_seal(
+      arg0, arg1, out, count, [&](size_t i, auto kind0, auto kind1) {
+        using Kind0 = decltype(kind0);
+        using Kind1 = decltype(kind1);
+        if constexpr (std::is_same_v<Kind0, MixedKind> ||
+                      std::is_same_v<Kind1, MixedKind>) {
+          scalar_multiply_seal(arg0[i], arg1[i], out[i], he_seal_backend);
+        } else if constexpr (std::is_same_v<Kind0, PlaintextKind> &&
+                             std::is_same_v<Kind1, PlaintextKind>) {
+          NGRAPH_CHECK(arg0[i].complex_packing() == arg1[i].complex_packing(),
+                       "Complex packing types don't match");
+          if (!out[i].is_plaintext()) {
+            out[i].set_plaintext(HEPlaintext());
+          }
+          scalar_multiply_seal(arg0[i].get_plaintext(),
+                               arg1[i].get_plaintext(), out[i].get_plaintext());
+          out[i].complex_packing() = arg0[i].complex_packing();
+        } else if constexpr (std::is_same_v<Kind0, CiphertextKind> &&
+                             std::is_same_v<Kind1, CiphertextKind>) {
+          NGRAPH_CHECK(arg0[i].complex_packing() == arg1[i].complex_packing(),
+                       "Complex packing types don't match");
+          if (!out[i].is_ciphertext()) {
+            out[i].set_ciphertext(HESealBackend::create_empty_ciphertext());
+          }
+          scalar_multiply_seal(*arg0[i].get_ciphertext(),
+                               *arg1[i].get_ciphertext(),
+                               out[i].get_ciphertext(),
+                               arg0[i].complex_packing(), he_seal_backend,
+                               he_seal_backend.pool());
+          out[i].complex_packing() = arg0[i].complex_packing();
+        } else {
+          HEType& cipher =
+              std::is_same_v<Kind0, CiphertextKind> ? arg0[i] : arg1[i];
+          const HEPlaintext& plain =
+              std::is_same_v<Kind0, CiphertextKind> ? arg1[i].get_plaintext()
+                                                    : arg0[i].get_plaintext();
+          bool complex_packing = cipher.complex_packing();
+          if (!out[i].is_ciphertext()) {
+            out[i].set_ciphertext(HESealBackend::create_empty_ciphertext());
+          }
+          if (complex_packing) {
+            scalar_multiply_complex_seal(*cipher.get_ciphertext(), plain,
+                                         out[i], he_seal_backend,
+                                         he_seal_backend.pool());
+          } else {
+            scalar_multiply_seal(*cipher.get_ciphertext(), plain, out[i],
+                                 he_seal_backend, he_seal_backend.pool());
+          }
+          out[i].complex_packing() = complex_packing;
+        }
+      });
 }
 
 }  // namespace ngraph::runtime::he
@@ -27,9 +27,12 @@
 #include "seal/seal_ciphertext_wrapper.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Multiplies two ciphertexts
-/// \param[in,out] arg0 Ciphertext argument to multiply. May be rescaled
-/// \param[in,out] arg1 Ciphertext argument to multiply. May be rescaled
+/// \brief Multiplies two ciphertexts. With lazy relinearization, the product
+/// of real-packed ciphertexts is not relinearized
+/// \param[in,out] arg0 Ciphertext argument to multiply. May be rescaled or
+/// relinearized
+/// \param[in,out] arg1 Ciphertext argument to multiply. May be rescaled or
+/// relinearized
 /// \param[out] out Stores the encrypted sum
 /// \param[in] complex_packing Whether or not the ciphertext should be
 /// multiplied using complex packing
@@ -52,6 +55,20 @@ void scalar_multiply_seal(
     HESealBackend& he_seal_backend,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
 
+/// \brief Multiplies a complex-packed ciphertext with a plaintext, where the
+/// real and imaginary part of each slot are multiplied by consecutive
+/// plaintext values. Uses complex conjugation unless the plaintext values
+/// of each slot match
+/// \param[in,out] arg0 Complex-packed ciphertext argument to multiply
+/// \param[in] arg1 Plaintext argument to multiply
+/// \param[out] out Stores the encrypted product
+/// \param[in] he_seal_backend Backend used to perform multiplication
+/// \param[in] pool Memory pool used for new memory allocation
+void scalar_multiply_complex_seal(
+    SealCiphertextWrapper& arg0, const HEPlaintext& arg1, HEType& out,
+    HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
 /// \brief Multiplies two plaintexts
 /// \param[in] arg0 Plaintext argument to multiply
 /// \param[in] arg1 Plaintext argument to multiply
@@ -62,7 +79,8 @@ void scalar_multiply_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
 /// \brief Multiplies two ciphertext/plaintext elements
 /// \param[in] arg0 Cipher or plaintext data to multiply
 /// \param[in] arg1 Cipher or plaintext data to multiply
-/// \param[in] out Stores the ciphertext or plaintext product
+/// \param[in] out Stores the ciphertext or plaintext product. May be arg0 or
+/// arg1, in which case the operation is performed in place
 /// \param[in] he_seal_backend Backend used to perform multiplication
 void scalar_multiply_seal(HEType& arg0, HEType& arg1, HEType& out,
                           HESealBackend& he_seal_backend);
@@ -20,6 +20,8 @@
 #include <functional>
 #include <utility>
 
+#include "seal/kernel/plaintext_op_seal.hpp"
+
 namespace ngraph::runtime::he {
 
 void scalar_negate_seal(const SealCiphertextWrapper& arg,
@@ -29,9 +31,7 @@ void scalar_negate_seal(const SealCiphertextWrapper& arg,
 }
 
 void scalar_negate_seal(const HEPlaintext& arg, HEPlaintext& out) {
-  HEPlaintext out_vals(arg.size());
-  std::transform(arg.begin(), arg.end(), out_vals.begin(), std::negate<>());
-  out = std::move(out_vals);
+  plaintext_unary_op_seal(arg, out, std::negate<>());
 }
 
 }  // namespace ngraph::runtime::he
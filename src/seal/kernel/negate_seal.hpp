@@ -21,6 +21,7 @@
 
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 
 namespace ngraph::runtime::he {
@@ -61,10 +62,9 @@ inline void negate_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
   NGRAPH_CHECK(count <= out.size(), "Count ", count,
                " is too large for out, with size ", out.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
     scalar_negate_seal(arg[i], out[i], element_type, he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/parallel_for_seal.hpp"
+
+#include <atomic>
+
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::atomic<bool> s_numa_aware{false};
+}  // namespace
+
+void set_numa_aware_parallelism(bool numa_aware) { s_numa_aware = numa_aware; }
+
+bool numa_aware_parallelism() { return s_numa_aware; }
+
+size_t elementwise_cost(const HEType& element) {
+  if (element.is_ciphertext()) {
+    const seal::Ciphertext& cipher = element.get_ciphertext()->ciphertext();
+    return std::max<size_t>(cipher.size() * cipher.poly_modulus_degree() *
+                                cipher.coeff_modulus_size(),
+                            1);
+  }
+  return std::max<size_t>(element.get_plaintext().size(), 1);
+}
+
+size_t elementwise_grain_size(
+    std::initializer_list<const std::vector<HEType>*> args) {
+  size_t cost = 1;
+  for (const auto* arg : args) {
+    if (arg != nullptr && !arg->empty()) {
+      cost = std::max(cost, elementwise_cost(arg->front()));
+    }
+  }
+  return (s_min_parallel_work + cost - 1) / cost;
+}
+
+HETypeKind he_type_kind(const std::vector<HEType>& data, size_t count) {
+  count = std::min(count, data.size());
+  if (count == 0) {
+    return HETypeKind::plaintext;
+  }
+  bool cipher = data[0].is_ciphertext();
+  for (size_t i = 1; i < count; ++i) {
+    if (data[i].is_ciphertext() != cipher) {
+      return HETypeKind::mixed;
+    }
+  }
+  return cipher ? HETypeKind::ciphertext : HETypeKind::plaintext;
+}
+
+}  // namespace ngraph::runtime::he
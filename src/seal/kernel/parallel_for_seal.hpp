@@ -0,0 +1,287 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "he_type.hpp"
+#include "seal/he_seal_thread_budget.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Coefficient operations a thread of an elementwise loop must be
+/// given to outweigh its startup cost
+constexpr size_t s_min_parallel_work = 1UL << 16U;
+
+/// \brief Returns the cost of an elementwise op on an element, in
+/// coefficient operations. A ciphertext costs one pass over the coefficients
+/// of each of its polynomials at its level, a plaintext one operation per
+/// value
+/// \param[in] element Cipher or plaintext operand
+size_t elementwise_cost(const HEType& element);
+
+/// \brief Returns the minimum number of elements each thread of an
+/// elementwise loop over ops on the given operands processes, such that each
+/// thread does at least s_min_parallel_work coefficient operations. The
+/// first element of each operand is taken to be representative
+/// \param[in] args Operands of the loop, which may be empty
+size_t elementwise_grain_size(
+    std::initializer_list<const std::vector<HEType>*> args);
+
+/// \brief Sets whether or not parallel_for_seal binds its threads to
+/// OpenMP places spread across the machine, e.g. sockets with
+/// OMP_PLACES=sockets. Since indices are statically partitioned, index i of
+/// equally sized tensors is then processed on the same socket by every
+/// loop, so ciphertexts first touched by a loop are local to later loops.
+/// Applies to the whole process
+/// \param[in] numa_aware Whether or not to bind threads
+void set_numa_aware_parallelism(bool numa_aware);
+
+/// \brief Returns whether or not parallel_for_seal binds its threads, see
+/// set_numa_aware_parallelism
+bool numa_aware_parallelism();
+
+/// \brief Calls func(i) for each i in [0, count), split across OpenMP
+/// threads which each process at least grain_size indices. With fewer than
+/// two such chunks, the loop runs on the calling thread. The number of
+/// threads is bounded by omp_get_max_threads, see
+/// HESealBackend::num_intra_op_threads, and by the threads of the thread
+/// budget which garbled circuits leave, see HEThreadBudget::compute_threads.
+/// Each thread processes a contiguous range of indices
+/// \param[in] count Number of indices
+/// \param[in] grain_size Minimum number of indices per thread
+/// \param[in] func Function called with each index. Must be safe to call
+/// concurrently for distinct indices
+template <typename Func>
+void parallel_for_seal(size_t count, size_t grain_size, Func&& func) {
+  size_t num_threads = 1;
+#ifdef _OPENMP
+  num_threads = std::min({static_cast<size_t>(omp_get_max_threads()),
+                          count / std::max<size_t>(grain_size, 1),
+                          HEThreadBudget::compute_threads()});
+#endif
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      func(i);
+    }
+    return;
+  }
+  if (numa_aware_parallelism()) {
+#pragma omp parallel for num_threads(num_threads) schedule(static) \
+    proc_bind(spread)
+    for (size_t i = 0; i < count; ++i) {  // NOLINT
+      func(i);
+    }
+    return;
+  }
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (size_t i = 0; i < count; ++i) {  // NOLINT
+    func(i);
+  }
+}
+
+/// \brief Calls func(i) for each i in [0, count), with the grain size of an
+/// elementwise loop over the given operands
+/// \param[in] count Number of indices
+/// \param[in] args Operands of the loop, see elementwise_grain_size
+/// \param[in] func Function called with each index
+template <typename Func>
+void parallel_for_seal(size_t count,
+                       std::initializer_list<const std::vector<HEType>*> args,
+                       Func&& func) {
+  parallel_for_seal(count, elementwise_grain_size(args),
+                    std::forward<Func>(func));
+}
+
+/// \brief Calls func(poly, limb, begin, end) for each RNS limb of num_polys
+/// polynomials, i.e. each of their coeff_mod_count residue polynomials, over
+/// the coefficient range [begin, end). Outside of parallel regions, the
+/// limbs, and if there are fewer limbs than threads equal coefficient ranges
+/// of the limbs, are split across the threads, so ops on a few large
+/// ciphertexts still use every thread. Threads are bounded as in
+/// parallel_for_seal, and each does at least s_min_parallel_work
+/// coefficient operations. Within parallel regions, e.g. an elementwise loop
+/// over many elements, the limbs are processed on the calling thread
+/// \param[in] num_polys Number of polynomials
+/// \param[in] coeff_mod_count Number of RNS limbs of each polynomial
+/// \param[in] coeff_count Number of coefficients of each limb
+/// \param[in] func Function called with each polynomial, limb and
+/// coefficient range. Must be safe to call concurrently for distinct ranges
+template <typename Func>
+void parallel_for_limbs_seal(size_t num_polys, size_t coeff_mod_count,
+                             size_t coeff_count, Func&& func) {
+  size_t num_limbs = num_polys * coeff_mod_count;
+  size_t num_threads = 1;
+#ifdef _OPENMP
+  if (!omp_in_parallel()) {
+    num_threads = std::min({static_cast<size_t>(omp_get_max_threads()),
+                            num_limbs * coeff_count / s_min_parallel_work,
+                            HEThreadBudget::compute_threads()});
+  }
+#endif
+  if (num_threads <= 1) {
+    for (size_t limb = 0; limb < num_limbs; ++limb) {
+      func(limb / coeff_mod_count, limb % coeff_mod_count, 0, coeff_count);
+    }
+    return;
+  }
+  size_t ranges_per_limb = (num_threads + num_limbs - 1) / num_limbs;
+  size_t range_size = (coeff_count + ranges_per_limb - 1) / ranges_per_limb;
+  size_t num_ranges = num_limbs * ranges_per_limb;
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+  for (size_t range = 0; range < num_ranges; ++range) {  // NOLINT
+    size_t limb = range / ranges_per_limb;
+    size_t begin = range % ranges_per_limb * range_size;
+    size_t end = std::min(coeff_count, begin + range_size);
+    if (begin < end) {
+      func(limb / coeff_mod_count, limb % coeff_mod_count, begin, end);
+    }
+  }
+}
+
+/// \brief Returns whether or not a loop over count elements, whose ops split
+/// their ciphertexts with parallel_for_limbs_seal, should process the
+/// elements one at a time on the calling thread, so each op runs on every
+/// thread. This is the case outside of parallel regions if the elements
+/// would occupy at most half of the threads, e.g. the few outputs of a final
+/// dense layer
+/// \param[in] count Number of elements
+inline bool limb_parallel_elements(size_t count) {
+#ifdef _OPENMP
+  if (count == 0 || omp_in_parallel()) {
+    return false;
+  }
+  size_t num_threads = std::min(static_cast<size_t>(omp_get_max_threads()),
+                                HEThreadBudget::compute_threads());
+  return 2 * count <= num_threads;
+#else
+  (void)count;
+  return false;
+#endif
+}
+
+/// \brief Whether the elements of an operand are all plaintexts, all
+/// ciphertexts, or both
+enum class HETypeKind { plaintext, ciphertext, mixed };
+
+/// \brief Returns the kind of the first count elements of an operand. An
+/// empty range is taken to be plaintext
+/// \param[in] data Operand
+/// \param[in] count Number of elements
+HETypeKind he_type_kind(const std::vector<HEType>& data, size_t count);
+
+/// \brief Tags with which parallel_for_kinds_seal passes the kind of each
+/// operand as a type, see HETypeKind
+struct PlaintextKind {};
+struct CiphertextKind {};
+struct MixedKind {};
+
+/// \brief Calls func(i, kind0, kind1) for each i in [0, count), like
+/// parallel_for_seal over both operands. The kinds are determined once for
+/// the loop, so func selects its per-element code at compile time, e.g.
+/// with if constexpr. kind0 and kind1 are PlaintextKind or CiphertextKind
+/// if every element of arg0 and arg1, respectively, is of that kind. Both
+/// are MixedKind if either operand is mixed, or if out aliases a plaintext
+/// operand of an op with a ciphertext result. Ops of ciphertexts with scalar
+/// plaintexts run on the calling thread if limb_parallel_elements holds
+/// \param[in] arg0 First operand
+/// \param[in] arg1 Second operand
+/// \param[in] out Output of the op
+/// \param[in] count Number of indices
+/// \param[in] func Function called with each index and the operand kinds
+template <typename Func>
+void parallel_for_kinds_seal(const std::vector<HEType>& arg0,
+                             const std::vector<HEType>& arg1,
+                             const std::vector<HEType>& out, size_t count,
+                             Func&& func) {
+  HETypeKind kind0 = he_type_kind(arg0, count);
+  HETypeKind kind1 = he_type_kind(arg1, count);
+  bool plain0 = kind0 == HETypeKind::plaintext;
+  bool plain1 = kind1 == HETypeKind::plaintext;
+  bool aliased = (&out == &arg0 && plain0 && !plain1) ||
+                 (&out == &arg1 && plain1 && !plain0);
+  // Ops of a ciphertext and a scalar split the limbs of the ciphertext, see
+  // parallel_for_limbs_seal
+  auto is_scalar = [](const std::vector<HEType>& arg) {
+    return !arg.empty() && arg[0].get_plaintext().is_uniform();
+  };
+  bool scalar_plain =
+      (plain0 && is_scalar(arg0)) || (plain1 && is_scalar(arg1));
+  bool limb_parallel =
+      plain0 != plain1 && scalar_plain && limb_parallel_elements(count);
+  auto run = [&](auto tag0, auto tag1) {
+    if (limb_parallel) {
+      for (size_t i = 0; i < count; ++i) {
+        func(i, tag0, tag1);
+      }
+      return;
+    }
+    parallel_for_seal(count, {&arg0, &arg1},
+                      [&](size_t i) { func(i, tag0, tag1); });
+  };
+  if (aliased || kind0 == HETypeKind::mixed || kind1 == HETypeKind::mixed) {
+    run(MixedKind{}, MixedKind{});
+  } else if (plain0 && plain1) {
+    run(PlaintextKind{}, PlaintextKind{});
+  } else if (plain0) {
+    run(PlaintextKind{}, CiphertextKind{});
+  } else if (plain1) {
+    run(CiphertextKind{}, PlaintextKind{});
+  } else {
+    run(CiphertextKind{}, CiphertextKind{});
+  }
+}
+
+/// \brief Sets the number of OpenMP threads of the calling thread, and
+/// restores the previous number once destroyed
+class ScopedIntraOpThreads {
+ public:
+  /// \param[in] num_threads Number of threads, or 0 to keep the current
+  /// number
+  explicit ScopedIntraOpThreads(size_t num_threads) {
+#ifdef _OPENMP
+    m_previous_threads = omp_get_max_threads();
+    if (num_threads > 0) {
+      omp_set_num_threads(static_cast<int>(num_threads));
+    }
+#else
+    (void)num_threads;
+#endif
+  }
+
+  ~ScopedIntraOpThreads() {
+#ifdef _OPENMP
+    omp_set_num_threads(m_previous_threads);
+#endif
+  }
+
+  ScopedIntraOpThreads(const ScopedIntraOpThreads&) = delete;
+  ScopedIntraOpThreads& operator=(const ScopedIntraOpThreads&) = delete;
+
+ private:
+  int m_previous_threads{1};
+};
+
+}  // namespace ngraph::runtime::he
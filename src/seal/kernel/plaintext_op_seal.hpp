@@ -0,0 +1,88 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "he_plaintext.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Applies a function to each batch value of a plaintext
+/// \param[in] arg Plaintext argument
+/// \param[out] out Stores the result. May alias arg
+/// \param[in] op Function of a double
+template <typename Op>
+inline void plaintext_unary_op_seal(const HEPlaintext& arg, HEPlaintext& out,
+                                    Op op) {
+  out.resize(arg.size());
+  const double* src = arg.data();
+  double* dst = out.data();
+  size_t count = out.size();
+#pragma omp simd
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = op(src[i]);
+  }
+}
+
+/// \brief Applies a function to each pair of batch values of two plaintexts.
+/// A uniform plaintext is broadcast across the batch of the other argument,
+/// otherwise the result has the size of the smaller argument
+/// \param[in] arg0 First plaintext argument
+/// \param[in] arg1 Second plaintext argument
+/// \param[out] out Stores the result. May alias arg0 or arg1
+/// \param[in] op Function of two doubles
+template <typename Op>
+inline void plaintext_binary_op_seal(const HEPlaintext& arg0,
+                                     const HEPlaintext& arg1,
+                                     HEPlaintext& out, Op op) {
+  // The broadcast value is read before out, which may alias it, is resized
+  if (arg0.is_uniform()) {
+    double value = arg0[0];
+    out.resize(arg1.size());
+    const double* src = arg1.data();
+    double* dst = out.data();
+    size_t count = out.size();
+#pragma omp simd
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = op(value, src[i]);
+    }
+  } else if (arg1.is_uniform()) {
+    double value = arg1[0];
+    out.resize(arg0.size());
+    const double* src = arg0.data();
+    double* dst = out.data();
+    size_t count = out.size();
+#pragma omp simd
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = op(src[i], value);
+    }
+  } else {
+    // Shrinking out keeps its storage, so aliased arguments stay valid
+    out.resize(std::min(arg0.size(), arg1.size()));
+    const double* src0 = arg0.data();
+    const double* src1 = arg1.data();
+    double* dst = out.data();
+    size_t count = out.size();
+#pragma omp simd
+    for (size_t i = 0; i < count; ++i) {
+      dst[i] = op(src0[i], src1[i]);
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
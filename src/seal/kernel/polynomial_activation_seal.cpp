@@ -0,0 +1,266 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/polynomial_activation_seal.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/bounded_relu_seal.hpp"
+#include "seal/kernel/max_pool_seal.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
+#include "seal/kernel/relu_seal.hpp"
+#include "seal/kernel/subtract_seal.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Number of compositions of (3x - x^3) / 2 approximating the sign
+constexpr size_t sign_compositions = 2;
+
+/// \brief Returns the coefficients of the quadratic approximation of ReLU on
+/// [-bound, bound]: ReLU(x) = B * ReLU(x / B) ~= B * (a0 + t / 2 + a2 * t^2)
+/// for t = x / B
+std::vector<double> relu_quadratic(PolynomialActivation activation,
+                                   double bound) {
+  // |t| ~= 3 / 16 + 15 / 16 * t^2 in least squares, 1 / 8 + t^2 in minimax
+  double a0 = activation == PolynomialActivation::square ? 3. / 32 : 1. / 16;
+  double a2 = activation == PolynomialActivation::square ? 15. / 32 : 1. / 2;
+  return {bound * a0, 0.5, a2 / bound};
+}
+
+/// \brief Returns the polynomials whose composition approximates
+/// (1 + sign(x)) / 2 on [-bound, bound]
+std::vector<std::vector<double>> step_polynomials(double bound) {
+  std::vector<std::vector<double>> polynomials{
+      {0, 1.5 / bound, 0, -0.5 / (bound * bound * bound)}};
+  for (size_t i = 1; i < sign_compositions; ++i) {
+    polynomials.push_back({0, 1.5, 0, -0.5});
+  }
+  auto& last = polynomials.back();
+  for (auto& coeff : last) {
+    coeff /= 2;
+  }
+  last[0] += 0.5;
+  return polynomials;
+}
+
+/// \brief Returns a copy of arg which does not share its ciphertext
+HEType copy_he_type(const HEType& arg) {
+  if (arg.is_plaintext()) {
+    return arg;
+  }
+  return HEType(std::make_shared<SealCiphertextWrapper>(*arg.get_ciphertext()),
+                arg.complex_packing(), arg.batch_size());
+}
+
+/// \brief Returns an empty output for a binary operation on arg0 and arg1
+HEType empty_result(const HEType& arg0, const HEType& arg1) {
+  if (arg0.is_plaintext() && arg1.is_plaintext()) {
+    return HEType(HEPlaintext(), arg0.complex_packing());
+  }
+  return HEType(HESealBackend::create_empty_ciphertext(),
+                arg0.complex_packing(),
+                std::max(arg0.batch_size(), arg1.batch_size()));
+}
+
+/// \brief Returns arg0 - arg1, leaving the arguments unchanged
+HEType subtract(const HEType& arg0, const HEType& arg1,
+                HESealBackend& he_seal_backend) {
+  HEType arg0_copy = copy_he_type(arg0);
+  HEType arg1_copy = copy_he_type(arg1);
+  HEType out = empty_result(arg0, arg1);
+  scalar_subtract_seal(arg0_copy, arg1_copy, out, he_seal_backend);
+  return out;
+}
+
+/// \brief Returns arg0 + arg1, leaving the arguments unchanged
+HEType add(const HEType& arg0, const HEType& arg1,
+           HESealBackend& he_seal_backend) {
+  HEType arg0_copy = copy_he_type(arg0);
+  HEType arg1_copy = copy_he_type(arg1);
+  HEType out = empty_result(arg0, arg1);
+  scalar_add_seal(arg0_copy, arg1_copy, out, he_seal_backend);
+  return out;
+}
+
+/// \brief Returns max(arg0, arg1) = arg1 + ReLU(arg0 - arg1)
+HEType polynomial_max(const HEType& arg0, const HEType& arg1,
+                      PolynomialActivation activation, double bound,
+                      HESealBackend& he_seal_backend) {
+  HEType diff = subtract(arg0, arg1, he_seal_backend);
+  scalar_polynomial_relu_seal(diff, diff, activation, 2 * bound,
+                              he_seal_backend);
+  return add(arg1, diff, he_seal_backend);
+}
+}  // namespace
+
+size_t polynomial_relu_depth(PolynomialActivation activation) {
+  switch (activation) {
+    case PolynomialActivation::none:
+      return 0;
+    case PolynomialActivation::square:
+    case PolynomialActivation::minimax:
+      return polynomial_depth(relu_quadratic(activation, 1));
+    case PolynomialActivation::sign: {
+      // Multiplication of x by the step
+      size_t depth = 1;
+      for (const auto& polynomial : step_polynomials(1)) {
+        depth += polynomial_depth(polynomial);
+      }
+      return depth;
+    }
+  }
+  return 0;
+}
+
+size_t polynomial_max_pool_depth(const Shape& window_shape,
+                                 PolynomialActivation activation) {
+  size_t rounds = 0;
+  for (size_t window_size = shape_size(window_shape); window_size > 1;
+       window_size = (window_size + 1) / 2) {
+    ++rounds;
+  }
+  return rounds * polynomial_relu_depth(activation);
+}
+
+void scalar_polynomial_relu_seal(const HEType& arg, HEType& out,
+                                 PolynomialActivation activation, double bound,
+                                 HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(activation != PolynomialActivation::none,
+               "No polynomial activation specified");
+  NGRAPH_CHECK(bound > 0, "Polynomial activation bound ", bound,
+               " must be positive");
+  if (arg.is_plaintext()) {
+    HEPlaintext relu;
+    scalar_relu_seal(arg.get_plaintext(), relu);
+    out = HEType(relu, arg.complex_packing());
+    return;
+  }
+
+  if (activation != PolynomialActivation::sign) {
+    scalar_polynomial_seal(arg, relu_quadratic(activation, bound), out,
+                           he_seal_backend);
+    return;
+  }
+
+  HEType step = arg;
+  for (const auto& polynomial : step_polynomials(bound)) {
+    scalar_polynomial_seal(step, polynomial, step, he_seal_backend);
+  }
+  NGRAPH_CHECK(step.is_ciphertext(), "Step approximation is constant");
+
+  auto arg_copy =
+      std::make_shared<SealCiphertextWrapper>(*arg.get_ciphertext());
+  auto pool = he_seal_backend.pool();
+  auto product = HESealBackend::create_empty_ciphertext(pool);
+  scalar_multiply_seal(*arg_copy, *step.get_ciphertext(), product,
+                       arg.complex_packing(), he_seal_backend, pool);
+  // Complex packing multiplication rescales
+  if (!arg.complex_packing()) {
+    HEPrimitiveCounter::increment(HEPrimitive::rescale);
+    rescale_inplace(product->ciphertext(), *he_seal_backend.get_evaluator(),
+                    he_seal_backend.rescale_primes(), pool);
+  }
+  out = HEType(product, arg.complex_packing(), arg.batch_size());
+}
+
+void polynomial_relu_seal(const std::vector<HEType>& arg,
+                          std::vector<HEType>& out, size_t count,
+                          PolynomialActivation activation, double bound,
+                          HESealBackend& he_seal_backend) {
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
+    scalar_polynomial_relu_seal(arg[i], out[i], activation, bound,
+                                he_seal_backend);
+  });
+}
+
+void polynomial_bounded_relu_seal(const std::vector<HEType>& arg,
+                                  std::vector<HEType>& out, float alpha,
+                                  size_t count,
+                                  PolynomialActivation activation,
+                                  double bound,
+                                  HESealBackend& he_seal_backend) {
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
+    if (arg[i].is_plaintext()) {
+      HEPlaintext bounded_relu;
+      scalar_bounded_relu_seal(arg[i].get_plaintext(), bounded_relu, alpha);
+      out[i] = HEType(bounded_relu, arg[i].complex_packing());
+      return;
+    }
+    HEType lower(HEPlaintext(), arg[i].complex_packing());
+    scalar_polynomial_relu_seal(arg[i], lower, activation, bound,
+                                he_seal_backend);
+
+    // x - alpha lies in [-(B + alpha), B + alpha]
+    HEType shifted = subtract(
+        arg[i], HEType(HEPlaintext{alpha}, arg[i].complex_packing()),
+        he_seal_backend);
+    scalar_polynomial_relu_seal(shifted, shifted, activation, bound + alpha,
+                                he_seal_backend);
+    out[i] = subtract(lower, shifted, he_seal_backend);
+  });
+}
+
+void polynomial_max_pool_seal(
+    const std::vector<HEType>& arg, std::vector<HEType>& out,
+    const Shape& arg_shape, const Shape& out_shape, const Shape& window_shape,
+    const Strides& window_movement_strides, const Shape& padding_below,
+    const Shape& padding_above, PolynomialActivation activation, double bound,
+    HESealBackend& he_seal_backend) {
+  auto max_lists = max_pool_seal_max_list(arg_shape, out_shape, window_shape,
+                                          window_movement_strides,
+                                          padding_below, padding_above);
+
+#pragma omp parallel for
+  for (size_t out_idx = 0; out_idx < max_lists.size(); ++out_idx) {
+    const auto& max_list = max_lists[out_idx];
+    NGRAPH_CHECK(!max_list.empty(), "MaxPool window is empty");
+    std::vector<HEType> values;
+    values.reserve(max_list.size());
+    for (size_t arg_idx : max_list) {
+      values.emplace_back(arg[arg_idx]);
+    }
+
+    // Balanced tree of pairwise maxima
+    while (values.size() > 1) {
+      std::vector<HEType> maxima;
+      maxima.reserve((values.size() + 1) / 2);
+      for (size_t i = 0; i + 1 < values.size(); i += 2) {
+        maxima.emplace_back(polynomial_max(values[i], values[i + 1],
+                                           activation, bound,
+                                           he_seal_backend));
+      }
+      if (values.size() % 2 == 1) {
+        maxima.emplace_back(values.back());
+      }
+      values = std::move(maxima);
+    }
+    out[out_idx] = values[0];
+  }
+}
+
+}  // namespace ngraph::runtime::he
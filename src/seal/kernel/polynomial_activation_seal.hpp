@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "he_type.hpp"
+#include "ngraph/shape.hpp"
+#include "ngraph/strides.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/polynomial_activation.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Returns the number of rescales consumed by computing a ReLU with a
+/// polynomial approximation
+/// \param[in] activation Polynomial approximation
+size_t polynomial_relu_depth(PolynomialActivation activation);
+
+/// \brief Returns the number of rescales consumed by computing a MaxPool with
+/// a polynomial approximation, which reduces each window by a tree of
+/// pairwise maxima max(a, b) = b + ReLU(a - b)
+/// \param[in] window_shape Shape of the pooling window
+/// \param[in] activation Polynomial approximation
+size_t polynomial_max_pool_depth(const Shape& window_shape,
+                                 PolynomialActivation activation);
+
+/// \brief Computes the ReLU of a cipher or plaintext element. Ciphertexts are
+/// evaluated with a polynomial approximation, plaintexts exactly
+/// \param[in] arg Cipher or plaintext data
+/// \param[out] out Stores the result. May be arg
+/// \param[in] activation Polynomial approximation. Must not be none
+/// \param[in] bound Bound B such that the approximation is accurate for all
+/// values in [-B, B]
+/// \param[in] he_seal_backend Backend used to evaluate the approximation
+void scalar_polynomial_relu_seal(const HEType& arg, HEType& out,
+                                 PolynomialActivation activation, double bound,
+                                 HESealBackend& he_seal_backend);
+
+/// \brief Computes the ReLU of a vector of cipher or plaintext elements with
+/// a polynomial approximation
+/// \param[in] arg Cipher or plaintext data
+/// \param[out] out Stores the result
+/// \param[in] count Number of elements
+/// \param[in] activation Polynomial approximation. Must not be none
+/// \param[in] bound Bound on the absolute value of the elements
+/// \param[in] he_seal_backend Backend used to evaluate the approximation
+void polynomial_relu_seal(const std::vector<HEType>& arg,
+                          std::vector<HEType>& out, size_t count,
+                          PolynomialActivation activation, double bound,
+                          HESealBackend& he_seal_backend);
+
+/// \brief Computes the bounded ReLU min(max(x, 0), alpha) of a vector of
+/// cipher or plaintext elements as ReLU(x) - ReLU(x - alpha), with a
+/// polynomial approximation of the ReLU
+/// \param[in] arg Cipher or plaintext data
+/// \param[out] out Stores the result
+/// \param[in] alpha Upper bound of the bounded ReLU
+/// \param[in] count Number of elements
+/// \param[in] activation Polynomial approximation. Must not be none
+/// \param[in] bound Bound on the absolute value of the elements
+/// \param[in] he_seal_backend Backend used to evaluate the approximation
+void polynomial_bounded_relu_seal(const std::vector<HEType>& arg,
+                                  std::vector<HEType>& out, float alpha,
+                                  size_t count,
+                                  PolynomialActivation activation,
+                                  double bound,
+                                  HESealBackend& he_seal_backend);
+
+/// \brief Computes a MaxPool of cipher or plaintext elements with a
+/// polynomial approximation of the pairwise maxima
+/// \param[in] arg Cipher or plaintext data
+/// \param[out] out Stores the result
+/// \param[in] arg_shape Shape of the input
+/// \param[in] out_shape Shape of the output
+/// \param[in] window_shape Shape of the pooling window
+/// \param[in] window_movement_strides Strides of the pooling window
+/// \param[in] padding_below Padding below the input
+/// \param[in] padding_above Padding above the input
+/// \param[in] activation Polynomial approximation. Must not be none
+/// \param[in] bound Bound on the absolute value of the elements
+/// \param[in] he_seal_backend Backend used to evaluate the approximation
+void polynomial_max_pool_seal(
+    const std::vector<HEType>& arg, std::vector<HEType>& out,
+    const Shape& arg_shape, const Shape& out_shape, const Shape& window_shape,
+    const Strides& window_movement_strides, const Shape& padding_below,
+    const Shape& padding_above, PolynomialActivation activation, double bound,
+    HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
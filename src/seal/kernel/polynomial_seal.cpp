@@ -0,0 +1,383 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/polynomial_seal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/add_seal.hpp"
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+bool is_zero(double coeff) { return std::abs(coeff) < 1e-12; }
+
+size_t ceil_log2(size_t n) {
+  size_t log = 0;
+  while ((size_t{1} << log) < n) {
+    ++log;
+  }
+  return log;
+}
+
+/// \brief Returns the end of the coefficients [begin, end) without trailing
+/// zero coefficients, keeping at least the constant coefficient
+size_t trimmed_end(const std::vector<double>& coeffs, size_t begin,
+                   size_t end) {
+  while (end > begin + 1 && is_zero(coeffs[end - 1])) {
+    --end;
+  }
+  return end;
+}
+
+/// \brief Returns n if the polynomial is the monomial x^n for n >= 1, which
+/// is evaluated without multiplying by its coefficient, or std::nullopt
+/// otherwise
+std::optional<size_t> monomial_degree(const std::vector<double>& coeffs) {
+  size_t degree = trimmed_end(coeffs, 0, coeffs.size()) - 1;
+  if (degree == 0 || coeffs[degree] != 1) {
+    return std::nullopt;
+  }
+  for (size_t i = 0; i < degree; ++i) {
+    if (!is_zero(coeffs[i])) {
+      return std::nullopt;
+    }
+  }
+  return degree;
+}
+
+/// \brief Returns the baby step, i.e. the smallest power of two k with
+/// k^2 >= degree + 1
+size_t baby_step(size_t degree) {
+  size_t baby = 1;
+  while (baby * baby < degree + 1) {
+    baby *= 2;
+  }
+  return baby;
+}
+
+/// \brief Returns the largest giant step baby * 2^j not exceeding the degree
+size_t giant_step(size_t baby, size_t degree) {
+  size_t giant = baby;
+  while (2 * giant <= degree) {
+    giant *= 2;
+  }
+  return giant;
+}
+
+/// \brief Returns the depth of the coefficients [begin, end), or
+/// std::nullopt if the polynomial is constant
+std::optional<size_t> chunk_depth(const std::vector<double>& coeffs,
+                                  size_t begin, size_t end, size_t baby) {
+  end = trimmed_end(coeffs, begin, end);
+  size_t degree = end - begin - 1;
+  if (degree == 0) {
+    return std::nullopt;
+  }
+  if (degree < baby) {
+    // Highest power and its coefficient multiplication
+    return ceil_log2(degree) + 1;
+  }
+  size_t giant = giant_step(baby, degree);
+  auto quotient = chunk_depth(coeffs, begin + giant, end, baby);
+  auto remainder = chunk_depth(coeffs, begin, begin + giant, baby);
+  size_t product = std::max(quotient.value_or(0), ceil_log2(giant)) + 1;
+  return std::max(product, remainder.value_or(0));
+}
+
+/// \brief Evaluates polynomials on a single ciphertext, caching the powers
+/// of the ciphertext
+class PolynomialEvaluator {
+ public:
+  PolynomialEvaluator(const SealCiphertextWrapper& arg, bool complex_packing,
+                      HESealBackend& he_seal_backend)
+      : m_complex_packing(complex_packing),
+        m_he_seal_backend(he_seal_backend),
+        m_pool(he_seal_backend.pool()) {
+    m_powers[1] = std::make_shared<SealCiphertextWrapper>(arg);
+  }
+
+  /// \brief Evaluates the coefficients [begin, end)
+  /// \param[out] constant Stores the value of the polynomial if it is
+  /// constant
+  /// \returns The evaluated polynomial, or nullptr if the polynomial is
+  /// constant
+  std::shared_ptr<SealCiphertextWrapper> evaluate(
+      const std::vector<double>& coeffs, size_t begin, size_t end, size_t baby,
+      double& constant) {
+    end = trimmed_end(coeffs, begin, end);
+    size_t degree = end - begin - 1;
+    if (degree < baby) {
+      // The scaled powers are summed before rescaling, so the linear
+      // combination is rescaled once
+      std::shared_ptr<SealCiphertextWrapper> sum;
+      for (size_t i = 1; i <= degree; ++i) {
+        if (!is_zero(coeffs[begin + i])) {
+          accumulate(sum, multiply_plain_unscaled(power(i), coeffs[begin + i]));
+        }
+      }
+      if (sum != nullptr) {
+        rescale(*sum);
+      }
+      return add_constant(sum, coeffs[begin], constant);
+    }
+
+    // p(x) = q(x) * x^giant + r(x)
+    size_t giant = giant_step(baby, degree);
+    double quotient_constant = 0;
+    auto quotient =
+        evaluate(coeffs, begin + giant, end, baby, quotient_constant);
+    std::shared_ptr<SealCiphertextWrapper> product;
+    if (quotient != nullptr) {
+      product = multiply(*quotient, power(giant));
+    } else {
+      product = multiply_plain_unscaled(power(giant), quotient_constant);
+      rescale(*product);
+    }
+
+    double remainder_constant = 0;
+    auto remainder =
+        evaluate(coeffs, begin, begin + giant, baby, remainder_constant);
+    if (remainder) {
+      accumulate(product, remainder);
+      return product;
+    }
+    return add_constant(product, remainder_constant, constant);
+  }
+
+  /// \brief Returns x^n, computing it as x^h * x^(n-h) for the largest power
+  /// of two h < n, so x^n has depth ceil(log2(n))
+  const SealCiphertextWrapper& power(size_t n) {
+    auto it = m_powers.find(n);
+    if (it != m_powers.end()) {
+      return *it->second;
+    }
+    size_t high = size_t{1} << (ceil_log2(n) - 1);
+    auto product = multiply(power(high), power(n - high));
+    m_powers[n] = product;
+    return *product;
+  }
+
+ private:
+
+  std::shared_ptr<SealCiphertextWrapper> multiply(
+      const SealCiphertextWrapper& arg0, const SealCiphertextWrapper& arg1) {
+    // Matching the operands modulus-switches them, so copy the cached powers
+    auto arg0_copy = std::make_shared<SealCiphertextWrapper>(arg0);
+    auto arg1_copy = (&arg0 == &arg1)
+                         ? arg0_copy
+                         : std::make_shared<SealCiphertextWrapper>(arg1);
+    auto out = HESealBackend::create_empty_ciphertext(m_pool);
+    scalar_multiply_seal(*arg0_copy, *arg1_copy, out, m_complex_packing,
+                         m_he_seal_backend, m_pool);
+    // Complex packing multiplication rescales
+    if (!m_complex_packing) {
+      rescale(*out);
+    }
+    return out;
+  }
+
+  /// \brief Returns arg * value, which must be rescaled
+  std::shared_ptr<SealCiphertextWrapper> multiply_plain_unscaled(
+      const SealCiphertextWrapper& arg, double value) {
+    NGRAPH_CHECK(m_he_seal_backend.get_chain_index(arg) > 0,
+                 "Multiplicative depth exceeded evaluating polynomial");
+    auto out = HESealBackend::create_empty_ciphertext(m_pool);
+    multiply_plain(arg.ciphertext(), value, out->ciphertext(),
+                   m_he_seal_backend, m_pool);
+    return out;
+  }
+
+  void rescale(SealCiphertextWrapper& arg) {
+    HEPrimitiveCounter::increment(HEPrimitive::rescale);
+    rescale_inplace(arg.ciphertext(), *m_he_seal_backend.get_evaluator(),
+                    m_he_seal_backend.rescale_primes(), m_pool);
+  }
+
+  void accumulate(std::shared_ptr<SealCiphertextWrapper>& sum,
+                  std::shared_ptr<SealCiphertextWrapper> term) {
+    if (sum == nullptr) {
+      sum = std::move(term);
+      return;
+    }
+    match_modulus_and_scale_inplace(*sum, *term, m_he_seal_backend, m_pool);
+    // Terms at the same level may be rescaled by different primes
+    match_scale(*term, *sum);
+    m_he_seal_backend.get_evaluator()->add_inplace(sum->ciphertext(),
+                                                   term->ciphertext());
+  }
+
+  std::shared_ptr<SealCiphertextWrapper> add_constant(
+      std::shared_ptr<SealCiphertextWrapper> sum, double value,
+      double& constant) {
+    if (sum == nullptr) {
+      constant = value;
+      return nullptr;
+    }
+    if (is_zero(value)) {
+      return sum;
+    }
+    auto out = HESealBackend::create_empty_ciphertext(m_pool);
+    scalar_add_seal(*sum, HEPlaintext{value}, out, m_complex_packing,
+                    m_he_seal_backend);
+    return out;
+  }
+
+  bool m_complex_packing;
+  HESealBackend& m_he_seal_backend;
+  seal::MemoryPoolHandle m_pool;
+  std::map<size_t, std::shared_ptr<SealCiphertextWrapper>> m_powers;
+};
+}  // namespace
+
+std::vector<double> chebyshev_coefficients(
+    const std::function<double(double)>& function, size_t degree,
+    double lower, double upper) {
+  NGRAPH_CHECK(lower < upper, "Invalid interval [", lower, ", ", upper, "]");
+  const double pi = std::acos(-1.0);
+  size_t node_count = degree + 1;
+  double mid = (upper + lower) / 2;
+  double half_width = (upper - lower) / 2;
+
+  // Chebyshev series coefficients c_j with f(x) ~= sum_j c_j T_j(t), for
+  // t = (x - mid) / half_width in [-1, 1]
+  std::vector<double> series(node_count, 0);
+  for (size_t k = 0; k < node_count; ++k) {
+    double angle = pi * (static_cast<double>(k) + 0.5) /
+                   static_cast<double>(node_count);
+    double value = function(mid + half_width * std::cos(angle));
+    for (size_t j = 0; j < node_count; ++j) {
+      series[j] += 2 * value * std::cos(static_cast<double>(j) * angle) /
+                   static_cast<double>(node_count);
+    }
+  }
+  series[0] /= 2;
+
+  // Monomial coefficients in t, using T_{j+1} = 2t T_j - T_{j-1}
+  std::vector<double> t_coeffs(node_count, 0);
+  std::vector<double> prev_chebyshev{1};
+  std::vector<double> chebyshev{0, 1};
+  t_coeffs[0] = series[0];
+  for (size_t j = 1; j < node_count; ++j) {
+    for (size_t i = 0; i < chebyshev.size(); ++i) {
+      t_coeffs[i] += series[j] * chebyshev[i];
+    }
+    std::vector<double> next_chebyshev(chebyshev.size() + 1, 0);
+    for (size_t i = 0; i < chebyshev.size(); ++i) {
+      next_chebyshev[i + 1] += 2 * chebyshev[i];
+    }
+    for (size_t i = 0; i < prev_chebyshev.size(); ++i) {
+      next_chebyshev[i] -= prev_chebyshev[i];
+    }
+    prev_chebyshev = std::move(chebyshev);
+    chebyshev = std::move(next_chebyshev);
+  }
+
+  // Substitute t = (x - mid) / half_width, expanding each power of t by the
+  // binomial theorem
+  std::vector<double> coeffs(node_count, 0);
+  for (size_t i = 0; i < node_count; ++i) {
+    double binomial = 1;
+    for (size_t m = 0; m <= i; ++m) {
+      if (m > 0) {
+        binomial = binomial * static_cast<double>(i - m + 1) /
+                   static_cast<double>(m);
+      }
+      coeffs[m] += t_coeffs[i] * binomial *
+                   std::pow(-mid, static_cast<double>(i - m)) /
+                   std::pow(half_width, static_cast<double>(i));
+    }
+  }
+  return coeffs;
+}
+
+size_t polynomial_depth(const std::vector<double>& coeffs) {
+  NGRAPH_CHECK(!coeffs.empty(), "Polynomial has no coefficients");
+  if (auto monomial = monomial_degree(coeffs)) {
+    return ceil_log2(*monomial);
+  }
+  size_t degree = trimmed_end(coeffs, 0, coeffs.size()) - 1;
+  return chunk_depth(coeffs, 0, coeffs.size(), baby_step(degree)).value_or(0);
+}
+
+void scalar_polynomial_seal(const HEPlaintext& arg,
+                            const std::vector<double>& coeffs,
+                            HEPlaintext& out) {
+  HEPlaintext out_vals(arg.size());
+  std::transform(arg.begin(), arg.end(), out_vals.begin(), [&](double x) {
+    double result = 0;
+    for (auto it = coeffs.rbegin(); it != coeffs.rend(); ++it) {
+      result = result * x + *it;
+    }
+    return result;
+  });
+  out = std::move(out_vals);
+}
+
+void scalar_polynomial_seal(const HEType& arg,
+                            const std::vector<double>& coeffs, HEType& out,
+                            HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(!coeffs.empty(), "Polynomial has no coefficients");
+  if (arg.is_plaintext()) {
+    HEPlaintext result;
+    scalar_polynomial_seal(arg.get_plaintext(), coeffs, result);
+    out = HEType(result, arg.complex_packing());
+    return;
+  }
+
+  PolynomialEvaluator evaluator(*arg.get_ciphertext(), arg.complex_packing(),
+                                he_seal_backend);
+  if (auto monomial = monomial_degree(coeffs)) {
+    out = HEType(std::make_shared<SealCiphertextWrapper>(
+                     evaluator.power(*monomial)),
+                 arg.complex_packing(), arg.batch_size());
+    return;
+  }
+
+  size_t degree = trimmed_end(coeffs, 0, coeffs.size()) - 1;
+  double constant = 0;
+  auto result = evaluator.evaluate(coeffs, 0, coeffs.size(),
+                                   baby_step(degree), constant);
+  if (result == nullptr) {
+    out = HEType(HEPlaintext({constant}), arg.complex_packing());
+  } else {
+    out = HEType(result, arg.complex_packing(), arg.batch_size());
+  }
+}
+
+void polynomial_seal(const std::vector<HEType>& arg,
+                     const std::vector<double>& coeffs,
+                     std::vector<HEType>& out, size_t count,
+                     HESealBackend& he_seal_backend) {
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
+    scalar_polynomial_seal(arg[i], coeffs, out[i], he_seal_backend);
+  });
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,90 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "he_plaintext.hpp"
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Returns the coefficients of the Chebyshev interpolant of a function
+/// on an interval, i.e. the polynomial interpolating the function at the
+/// Chebyshev nodes of the interval, which is close to the minimax
+/// approximation
+/// \param[in] function Function to approximate
+/// \param[in] degree Degree of the interpolant
+/// \param[in] lower Lower bound of the interval
+/// \param[in] upper Upper bound of the interval
+/// \returns Coefficients of the interpolant, in increasing order of degree
+/// \throws ngraph_error if the interval is empty
+std::vector<double> chebyshev_coefficients(
+    const std::function<double(double)>& function, size_t degree,
+    double lower, double upper);
+
+/// \brief Returns the number of rescales consumed by evaluating a polynomial
+/// on a ciphertext with scalar_polynomial_seal
+/// \param[in] coeffs Coefficients of the polynomial, in increasing order of
+/// degree
+size_t polynomial_depth(const std::vector<double>& coeffs);
+
+/// \brief Evaluates a polynomial on each value of a plaintext
+/// \param[in] arg Plaintext to evaluate the polynomial on
+/// \param[in] coeffs Coefficients of the polynomial, in increasing order of
+/// degree
+/// \param[out] out Stores the evaluated polynomial
+void scalar_polynomial_seal(const HEPlaintext& arg,
+                            const std::vector<double>& coeffs,
+                            HEPlaintext& out);
+
+/// \brief Evaluates a polynomial on a cipher or plaintext element. Ciphertexts
+/// are evaluated with the Paterson-Stockmeyer scheme: the polynomial is split
+/// along powers x^(k * 2^j) of a power-of-two baby step k, whose quotients
+/// and remainders are evaluated recursively, and the baby steps are linear
+/// combinations of the powers x, ..., x^(k-1) computed by a balanced power
+/// tree, which are cached. This uses the minimal depth
+/// ceil(log2(degree + 1)) for the degrees used by the polynomial activations,
+/// and O(sqrt(degree)) ciphertext multiplications, each relinearized and
+/// rescaled. Each linear combination is rescaled once, after summing its
+/// scaled powers. The monomial x^n is the cached power itself, with depth
+/// ceil(log2(n))
+/// \param[in] arg Cipher or plaintext data to evaluate the polynomial on
+/// \param[in] coeffs Coefficients of the polynomial, in increasing order of
+/// degree
+/// \param[out] out Stores the evaluated polynomial. May be arg
+/// \param[in] he_seal_backend Backend used to perform the evaluation
+/// \throws ngraph_error if the ciphertext has too few levels left
+void scalar_polynomial_seal(const HEType& arg,
+                            const std::vector<double>& coeffs, HEType& out,
+                            HESealBackend& he_seal_backend);
+
+/// \brief Evaluates a polynomial on a vector of cipher or plaintext elements
+/// \param[in] arg Cipher or plaintext data to evaluate the polynomial on
+/// \param[in] coeffs Coefficients of the polynomial, in increasing order of
+/// degree
+/// \param[out] out Stores the evaluated polynomial
+/// \param[in] count Number of elements to evaluate
+/// \param[in] he_seal_backend Backend used to perform the evaluation
+void polynomial_seal(const std::vector<HEType>& arg,
+                     const std::vector<double>& coeffs,
+                     std::vector<HEType>& out, size_t count,
+                     HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
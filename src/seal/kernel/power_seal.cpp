@@ -17,12 +17,17 @@
 #include "seal/kernel/power_seal.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
@@ -30,33 +35,27 @@ namespace ngraph::runtime::he {
 
 void scalar_power_seal(const HEPlaintext& arg0, const HEPlaintext& arg1,
                        HEPlaintext& out) {
-  HEPlaintext out_vals;
-  if (arg0.size() == 1) {
-    std::transform(
-        arg1.begin(), arg1.end(),
-        std::back_inserter(out_vals), [&](auto y) -> auto {
-          return std::pow(arg0[0], y);
-        });
-  } else if (arg1.size() == 1) {
-    std::transform(
-        arg0.begin(), arg0.end(),
-        std::back_inserter(out_vals), [&](auto x) -> auto {
-          return std::pow(x, arg1[0]);
-        });
-  } else {
-    size_t min_size = std::min(arg0.size(), arg1.size());
-    out_vals.resize(min_size);
-    for (size_t i = 0; i < min_size; ++i) {
-      out_vals[i] = std::pow(arg0[i], arg1[i]);
-    }
+  plaintext_binary_op_seal(arg0, arg1, out,
+                           [](double x, double y) { return std::pow(x, y); });
+}
+
+std::optional<size_t> integer_exponent(const HEPlaintext& exponent) {
+  if (exponent.empty()) {
+    return std::nullopt;
+  }
+  double value = exponent[0];
+  bool uniform = std::all_of(exponent.begin(), exponent.end(),
+                             [&](double y) { return y == value; });
+  if (!uniform || value < 0 || value > max_integer_exponent ||
+      std::floor(value) != value) {
+    return std::nullopt;
   }
-  out = std::move(out_vals);
+  return static_cast<size_t>(value);
 }
 
 void scalar_power_seal(HEType& arg0, HEType& arg1, HEType& out,
                        HESealBackend& he_seal_backend) {
   // TODO(fboemer): enable with client?
-  // TODO(fboemer): complex packing?
 
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
     NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
@@ -75,6 +74,13 @@ void scalar_power_seal(HEType& arg0, HEType& arg1, HEType& out,
                             arg0.complex_packing());
 
   } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
+    if (auto exponent = integer_exponent(arg1.get_plaintext())) {
+      // x^n is evaluated exactly as the monomial x^n
+      std::vector<double> monomial(*exponent + 1, 0);
+      monomial.back() = 1;
+      scalar_polynomial_seal(arg0, monomial, out, he_seal_backend);
+      return;
+    }
     HEPlaintext plain_arg0;
     he_seal_backend.decrypt(plain_arg0, *arg0.get_ciphertext(),
                             arg0.batch_size(), arg0.complex_packing());
@@ -88,7 +94,8 @@ void scalar_power_seal(HEType& arg0, HEType& arg1, HEType& out,
                             arg1.batch_size(), arg1.complex_packing());
     scalar_power_seal(arg0.get_plaintext(), plain_arg1, plain_arg1);
     he_seal_backend.encrypt(out.get_ciphertext(), plain_arg1, element::f32,
-                            arg0.complex_packing());
+                            arg1.complex_packing());
+    out.complex_packing() = arg1.complex_packing();
 
   } else if (arg0.is_plaintext() && arg1.is_plaintext()) {
     out.set_plaintext(arg0.get_plaintext());
@@ -104,10 +111,9 @@ void power_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
                "Unsupported type ", element_type);
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for_seal(count, {&arg0, &arg1}, [&](size_t i) {
     scalar_power_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::runtime::he
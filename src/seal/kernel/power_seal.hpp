@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "he_type.hpp"
@@ -33,6 +34,16 @@ void scalar_power_seal(const HEType& arg0, const HEType& arg1, HEType& out,
                        seal::CKKSEncoder& ckks_encoder,
                        seal::Encryptor& encryptor, seal::Decryptor& decryptor);
 
+/// \brief Largest exponent of a ciphertext evaluated by multiplication
+inline constexpr size_t max_integer_exponent = 64;
+
+/// \brief Returns n if each value of the exponent is the same integer
+/// 0 <= n <= max_integer_exponent, or std::nullopt otherwise. Ciphertexts
+/// raised to such exponents are computed by multiplication, with depth
+/// ceil(log2(n)), rather than by decryption
+/// \param[in] exponent Plaintext exponent
+std::optional<size_t> integer_exponent(const HEPlaintext& exponent);
+
 void scalar_power_seal(HEType& arg0, HEType& arg1, HEType& out,
                        HESealBackend& he_seal_backend);
 
@@ -0,0 +1,74 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/refresh_seal.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+void scalar_refresh_seal(const HEType& arg, HEType& out,
+                         const seal::parms_id_type& parms_id, double scale,
+                         seal::CKKSEncoder& ckks_encoder,
+                         seal::Encryptor& encryptor,
+                         seal::Decryptor& decryptor,
+                         std::shared_ptr<seal::SEALContext> context,
+                         HECodecScratch& scratch) {
+  if (arg.is_plaintext()) {
+    out.set_plaintext(arg.get_plaintext());
+    return;
+  }
+  // Holds a single value without allocating for unbatched ciphertexts
+  HEPlaintext plain(arg.batch_size());
+  decrypt_strided(plain.data(), sizeof(double), plain.size(), element::f64,
+                  *arg.get_ciphertext(), arg.complex_packing(), decryptor,
+                  ckks_encoder, context, scratch);
+
+  bool complex_packing = arg.complex_packing();
+  auto& cipher = out.get_ciphertext();
+  if (cipher == nullptr || cipher.use_count() != 1) {
+    cipher = HESealBackend::create_empty_ciphertext();
+  }
+  encrypt_strided(cipher->ciphertext(), plain.data(), sizeof(double),
+                  plain.size(), element::f64, parms_id, scale, ckks_encoder,
+                  encryptor, complex_packing, scratch);
+  out.set_ciphertext(cipher);
+}
+
+void refresh_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                  size_t count, const HESealBackend& he_seal_backend) {
+#pragma omp parallel
+  {
+    HECodecScratch scratch;
+#pragma omp for
+    for (size_t i = 0; i < count; ++i) {
+      scalar_refresh_seal(arg[i], out[i],
+                          he_seal_backend.get_context()->first_parms_id(),
+                          he_seal_backend.get_scale(),
+                          *he_seal_backend.get_ckks_encoder(),
+                          *he_seal_backend.get_encryptor(),
+                          *he_seal_backend.get_decryptor(),
+                          he_seal_backend.get_context(), scratch);
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
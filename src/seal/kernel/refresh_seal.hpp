@@ -0,0 +1,57 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Re-encrypts a ciphertext at a given level by decrypting it,
+/// decrypting and encrypting through the thread's scratch buffers.
+/// Plaintexts are copied
+/// \param[in] arg Input value
+/// \param[out] out Output value. Its ciphertext storage is reused
+/// \param[in] parms_id Seal parameter id to encrypt the output at
+/// \param[in] scale Scale to encrypt the output at
+/// \param[in] ckks_encoder Used for encoding
+/// \param[in] encryptor Used for encrypting
+/// \param[in] decryptor Used for decrypting
+/// \param[in] context Used for decrypting
+/// \param[in,out] scratch Buffers of the calling thread
+void scalar_refresh_seal(const HEType& arg, HEType& out,
+                         const seal::parms_id_type& parms_id, double scale,
+                         seal::CKKSEncoder& ckks_encoder,
+                         seal::Encryptor& encryptor,
+                         seal::Decryptor& decryptor,
+                         std::shared_ptr<seal::SEALContext> context,
+                         HECodecScratch& scratch);
+
+/// \brief Re-encrypts ciphertexts at the first level with the backend's
+/// keys, i.e. refreshes without the client
+/// \param[in] arg Input values
+/// \param[out] out Output values
+/// \param[in] count Number of values to refresh
+/// \param[in] he_seal_backend Backend holding the secret key
+void refresh_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                  size_t count, const HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
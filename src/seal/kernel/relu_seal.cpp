@@ -18,19 +18,19 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
 namespace ngraph::runtime::he {
 
 void scalar_relu_seal(const HEPlaintext& arg, HEPlaintext& out) {
-  out.resize(arg.size());
-  auto relu = [](double d) { return d > 0 ? d : 0.; };
-  std::transform(arg.begin(), arg.end(), out.begin(), relu);
+  plaintext_unary_op_seal(arg, out, [](double d) { return d > 0 ? d : 0.; });
 }
 
 void scalar_relu_seal(const HEType& arg, HEType& out,
@@ -38,17 +38,37 @@ void scalar_relu_seal(const HEType& arg, HEType& out,
                       seal::CKKSEncoder& ckks_encoder,
                       seal::Encryptor& encryptor, seal::Decryptor& decryptor,
                       std::shared_ptr<seal::SEALContext> context) {
+  HECodecScratch scratch;
+  scalar_relu_seal(arg, out, parms_id, scale, ckks_encoder, encryptor,
+                   decryptor, std::move(context), scratch);
+}
+
+void scalar_relu_seal(const HEType& arg, HEType& out,
+                      const seal::parms_id_type& parms_id, double scale,
+                      seal::CKKSEncoder& ckks_encoder,
+                      seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+                      std::shared_ptr<seal::SEALContext> context,
+                      HECodecScratch& scratch) {
   if (arg.is_plaintext()) {
     out.set_plaintext(arg.get_plaintext());
     scalar_relu_seal(arg.get_plaintext(), out.get_plaintext());
   } else {
-    HEPlaintext plain;
-    decrypt(plain, *arg.get_ciphertext(), arg.complex_packing(), decryptor,
-            ckks_encoder, context, arg.batch_size());
+    // Holds a single value without allocating for unbatched ciphertexts
+    HEPlaintext plain(arg.batch_size());
+    decrypt_strided(plain.data(), sizeof(double), plain.size(), element::f64,
+                    *arg.get_ciphertext(), arg.complex_packing(), decryptor,
+                    ckks_encoder, context, scratch);
     scalar_relu_seal(plain, plain);
-    encrypt(out.get_ciphertext(), plain, parms_id, element::f32, scale,
-            ckks_encoder, encryptor, arg.complex_packing());
-    out.set_ciphertext(out.get_ciphertext());
+
+    bool complex_packing = arg.complex_packing();
+    auto& cipher = out.get_ciphertext();
+    if (cipher == nullptr || cipher.use_count() != 1) {
+      cipher = HESealBackend::create_empty_ciphertext();
+    }
+    encrypt_strided(cipher->ciphertext(), plain.data(), sizeof(double),
+                    plain.size(), element::f64, parms_id, scale, ckks_encoder,
+                    encryptor, complex_packing, scratch);
+    out.set_ciphertext(cipher);
   }
 }
 
@@ -63,9 +83,19 @@ void scalar_relu_seal(const HEType& arg, HEType& out,
 
 void relu_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
                size_t count, const HESealBackend& he_seal_backend) {
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
-    scalar_relu_seal(arg[i], out[i], he_seal_backend);
+#pragma omp parallel
+  {
+    HECodecScratch scratch;
+#pragma omp for
+    for (size_t i = 0; i < count; ++i) {
+      scalar_relu_seal(arg[i], out[i],
+                       he_seal_backend.get_context()->first_parms_id(),
+                       he_seal_backend.get_scale(),
+                       *he_seal_backend.get_ckks_encoder(),
+                       *he_seal_backend.get_encryptor(),
+                       *he_seal_backend.get_decryptor(),
+                       he_seal_backend.get_context(), scratch);
+    }
   }
 }
 
@@ -34,6 +34,24 @@ void scalar_relu_seal(const HEType& arg, HEType& out,
                       seal::Encryptor& encryptor, seal::Decryptor& decryptor,
                       std::shared_ptr<seal::SEALContext> context);
 
+/// \brief Computes relu of a ciphertext by decrypting it, decrypting and
+/// encrypting through the thread's scratch buffers
+/// \param[in] arg Input value
+/// \param[out] out Output value. Its ciphertext storage is reused
+/// \param[in] parms_id Seal parameter id to encrypt the output at
+/// \param[in] scale Scale to encrypt the output at
+/// \param[in] ckks_encoder Used for encoding
+/// \param[in] encryptor Used for encrypting
+/// \param[in] decryptor Used for decrypting
+/// \param[in] context Used for decrypting
+/// \param[in,out] scratch Buffers of the calling thread
+void scalar_relu_seal(const HEType& arg, HEType& out,
+                      const seal::parms_id_type& parms_id, double scale,
+                      seal::CKKSEncoder& ckks_encoder,
+                      seal::Encryptor& encryptor, seal::Decryptor& decryptor,
+                      std::shared_ptr<seal::SEALContext> context,
+                      HECodecScratch& scratch);
+
 void scalar_relu_seal(const HEType& arg, HEType& out,
                       const HESealBackend& he_seal_backend);
 
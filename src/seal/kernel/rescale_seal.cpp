@@ -20,6 +20,7 @@
 #include <memory>
 #include <vector>
 
+
 namespace ngraph::runtime::he {
 
 void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
@@ -32,15 +33,17 @@ void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
   auto t1 = Clock::now();
   size_t new_chain_index = std::numeric_limits<size_t>::max();
 
+  // Each rescale drops a pair of primes when a logical scale spans two
+  size_t rescale_primes = he_seal_backend.rescale_primes();
   bool all_plaintexts = true;
   for (auto& he_type : arg) {
     if (he_type.is_ciphertext()) {
       size_t curr_chain_index =
           he_seal_backend.get_chain_index(*he_type.get_ciphertext());
-      if (curr_chain_index == 0) {
+      if (curr_chain_index <= rescale_primes) {
         new_chain_index = 0;
       } else {
-        new_chain_index = curr_chain_index - 1;
+        new_chain_index = curr_chain_index - rescale_primes;
       }
       all_plaintexts = false;
       break;
@@ -66,14 +69,7 @@ void rescale_seal(std::vector<HEType>& arg, HESealBackend& he_seal_backend,
     NGRAPH_HE_LOG(3) << "New chain index " << new_chain_index;
   }
 
-#pragma omp parallel for
-  for (size_t i = 0; i < arg.size(); ++i) {  // NOLINT
-    auto cipher = arg[i];
-    if (arg[i].is_ciphertext()) {
-      he_seal_backend.get_evaluator()->rescale_to_next_inplace(
-          arg[i].get_ciphertext()->ciphertext());
-    }
-  }
+  he_seal_backend.accelerator().rescale_to_next_inplace(arg, he_seal_backend);
   if (verbose) {
     auto t2 = Clock::now();
     NGRAPH_HE_LOG(3) << "Rescale_xxx took "
@@ -22,6 +22,7 @@
 #include "he_plaintext.hpp"
 #include "ngraph/check.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_util.hpp"
 
@@ -35,6 +36,7 @@ inline void scalar_result_seal(const HEType& arg, HEType& out,
     out = HEType(arg);
   } else if (arg.is_ciphertext() && out.is_plaintext()) {
     out.set_ciphertext(arg.get_ciphertext());
+    out.pending_factor() = arg.pending_factor();
   } else if (arg.is_plaintext() && out.is_ciphertext()) {
     out.set_plaintext(arg.get_plaintext());
   } else if (arg.is_plaintext() && out.is_plaintext()) {
@@ -50,10 +52,9 @@ inline void result_seal(const std::vector<HEType>& arg,
   NGRAPH_CHECK(out.size() >= count, "Result out size ", out.size(),
                " smaller than count ", count);
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
+  parallel_for_seal(count, {&arg}, [&](size_t i) {
     scalar_result_seal(arg[i], out[i], he_seal_backend);
-  }
+  });
 }
 
 }  // namespace ngraph::runtime::he
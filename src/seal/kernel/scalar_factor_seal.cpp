@@ -0,0 +1,149 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/scalar_factor_seal.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "seal/kernel/multiply_seal.hpp"
+#include "seal/kernel/negate_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/kernel/rescale_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Multiplies the values of a plaintext by a factor
+void scale_plaintext(HEPlaintext& plain, double factor) {
+  for (auto& value : plain) {
+    value *= factor;
+  }
+}
+}  // namespace
+
+bool has_pending_factors(const std::vector<HEType>& values) {
+  return std::any_of(values.begin(), values.end(), [](const HEType& value) {
+    return value.is_ciphertext() && value.pending_factor() != 1;
+  });
+}
+
+bool is_uniform_plaintext(const HEType& value) {
+  if (!value.is_plaintext() || value.get_plaintext().empty()) {
+    return false;
+  }
+  const HEPlaintext& plain = value.get_plaintext();
+  return plain[0] != 0 &&
+         std::all_of(plain.begin(), plain.end(),
+                     [&](double x) { return x == plain[0]; });
+}
+
+void apply_pending_factors(std::vector<HEType>& values,
+                           HESealBackend& he_seal_backend) {
+  std::vector<size_t> scaled;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i].is_ciphertext() && values[i].pending_factor() != 1) {
+      scaled.emplace_back(i);
+    }
+  }
+
+  std::vector<HEType> products(scaled.size(), HEType(HEPlaintext(), false));
+  std::vector<char> negated(scaled.size(), 0);
+  parallel_for_seal(scaled.size(), {&values}, [&](size_t j) {
+    HEType& value = values[scaled[j]];
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    if (value.pending_factor() == -1) {
+      scalar_negate_seal(*value.get_ciphertext(), cipher, he_seal_backend);
+      negated[j] = 1;
+    } else {
+      multiply_plain(value.get_ciphertext()->ciphertext(),
+                     value.pending_factor(), cipher->ciphertext(),
+                     he_seal_backend, he_seal_backend.pool());
+    }
+    products[j] =
+        HEType(cipher, value.complex_packing(), value.batch_size());
+  });
+
+  // Only the multiplied ciphertexts are rescaled
+  std::vector<HEType> rescaled;
+  for (size_t j = 0; j < scaled.size(); ++j) {
+    if (negated[j] == 0) {
+      rescaled.emplace_back(products[j]);
+    }
+  }
+  rescale_seal(rescaled, he_seal_backend);
+  for (size_t j = 0; j < scaled.size(); ++j) {
+    values[scaled[j]] = std::move(products[j]);
+  }
+}
+
+void lazy_scale_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                     size_t count,
+                     const std::function<double(size_t)>& factor) {
+  NGRAPH_CHECK(count <= arg.size(), "Count ", count,
+               " is too large for arg, with size ", arg.size());
+  NGRAPH_CHECK(count <= out.size(), "Count ", count,
+               " is too large for out, with size ", out.size());
+  for (size_t i = 0; i < count; ++i) {
+    double scale = factor(i);
+    if (arg[i].is_ciphertext()) {
+      double pending_factor = arg[i].pending_factor() * scale;
+      out[i] = arg[i];
+      out[i].pending_factor() = pending_factor;
+    } else {
+      HEPlaintext plain = arg[i].get_plaintext();
+      scale_plaintext(plain, scale);
+      out[i] = HEType(plain, arg[i].complex_packing());
+    }
+  }
+}
+
+void lazy_multiply_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
+                        std::vector<HEType>& out, size_t count,
+                        const element::Type& element_type,
+                        HESealBackend& he_seal_backend) {
+  if (!has_pending_factors(arg0) && !has_pending_factors(arg1)) {
+    multiply_seal(arg0, arg1, out, count, element_type, he_seal_backend);
+    // The products may be written into outputs with stale factors
+    for (size_t i = 0; i < count; ++i) {
+      out[i].pending_factor() = 1;
+    }
+    return;
+  }
+
+  // The factors are folded into copies, so Constant data is unchanged
+  std::vector<HEType> folded0(arg0.begin(), arg0.begin() + count);
+  std::vector<HEType> folded1(arg1.begin(), arg1.begin() + count);
+  std::vector<double> out_factors(count, 1);
+  for (size_t i = 0; i < count; ++i) {
+    HEType& value0 = folded0[i];
+    HEType& value1 = folded1[i];
+    if (value0.is_ciphertext() && value1.is_ciphertext()) {
+      out_factors[i] = value0.pending_factor() * value1.pending_factor();
+    } else if (value0.is_ciphertext()) {
+      scale_plaintext(value1.get_plaintext(), value0.pending_factor());
+    } else if (value1.is_ciphertext()) {
+      scale_plaintext(value0.get_plaintext(), value1.pending_factor());
+    }
+  }
+  multiply_seal(folded0, folded1, out, count, element_type, he_seal_backend);
+  for (size_t i = 0; i < count; ++i) {
+    out[i].pending_factor() = out[i].is_ciphertext() ? out_factors[i] : 1;
+  }
+}
+
+}  // namespace ngraph::runtime::he
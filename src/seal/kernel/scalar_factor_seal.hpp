@@ -0,0 +1,72 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "he_type.hpp"
+#include "ngraph/type/element_type.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Returns whether or not any of the values is a ciphertext with a
+/// pending factor, see HEType::pending_factor
+/// \param[in] values Values to check
+bool has_pending_factors(const std::vector<HEType>& values);
+
+/// \brief Returns whether or not a value is a plaintext storing the same
+/// non-zero value in each batch slot, whose reciprocal may be deferred as a
+/// pending factor
+/// \param[in] value Value to check
+bool is_uniform_plaintext(const HEType& value);
+
+/// \brief Multiplies the pending factor of each ciphertext into the
+/// ciphertext. Factors of -1 negate, other factors consume a level. The
+/// ciphertexts are replaced rather than modified, since other values may
+/// share them
+/// \param[in,out] values Values whose factors to apply
+/// \param[in] he_seal_backend Backend used to perform the multiplications
+void apply_pending_factors(std::vector<HEType>& values,
+                           HESealBackend& he_seal_backend);
+
+/// \brief Computes out[i] = factor(i) * arg[i]. Ciphertexts share the
+/// ciphertext of the argument, with their pending factor scaled instead, so
+/// no pass over the ciphertext data is made. Plaintexts are multiplied
+/// \param[in] arg Values to scale
+/// \param[out] out Stores the scaled values. May be arg
+/// \param[in] count Number of values to scale
+/// \param[in] factor Returns the factor of value i
+void lazy_scale_seal(const std::vector<HEType>& arg, std::vector<HEType>& out,
+                     size_t count, const std::function<double(size_t)>& factor);
+
+/// \brief Multiplies two vectors element-wise, as multiply_seal, with the
+/// pending factor of a ciphertext multiplied by a plaintext folded into the
+/// plaintext. Products of ciphertexts keep the product of their factors
+/// \param[in] arg0 Cipher or plaintext data to multiply
+/// \param[in] arg1 Cipher or plaintext data to multiply
+/// \param[out] out Stores the ciphertext or plaintext product
+/// \param[in] count Number of elements to multiply
+/// \param[in] element_type datatype of the data to multiply
+/// \param[in] he_seal_backend Backend used to perform multiplication
+void lazy_multiply_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
+                        std::vector<HEType>& out, size_t count,
+                        const element::Type& element_type,
+                        HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,143 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/slot_layout_seal.hpp"
+
+#include <limits>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/he_primitive_counter.hpp"
+#include "seal/seal.h"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+void pack_slots_seal(const std::vector<HEType>& arg,
+                     SealCiphertextWrapper& out,
+                     HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(!arg.empty(), "Cannot pack zero elements");
+  NGRAPH_CHECK(!he_seal_backend.complex_packing(),
+               "Slot packing does not support complex packing");
+  const size_t slot_count = he_seal_backend.get_ckks_encoder()->slot_count();
+  NGRAPH_CHECK(arg.size() <= slot_count, "Cannot pack ", arg.size(),
+               " elements into ", slot_count, " slots");
+
+  size_t chain_index = std::numeric_limits<size_t>::max();
+  size_t smallest_idx = 0;
+  for (size_t i = 0; i < arg.size(); ++i) {
+    NGRAPH_CHECK(arg[i].is_ciphertext(), "Cannot pack plaintext element ", i);
+    NGRAPH_CHECK(arg[i].batch_size() == 1, "Cannot pack element ", i,
+                 " of batch size ", arg[i].batch_size());
+    size_t curr_chain_index =
+        he_seal_backend.get_chain_index(*arg[i].get_ciphertext());
+    if (curr_chain_index < chain_index) {
+      chain_index = curr_chain_index;
+      smallest_idx = i;
+    }
+  }
+  NGRAPH_CHECK(chain_index > 0, "Multiplicative depth exceeded for packing");
+
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  auto& encoder = *he_seal_backend.get_ckks_encoder();
+  const SealCiphertextWrapper& smallest = *arg[smallest_idx].get_ciphertext();
+
+  std::vector<seal::Ciphertext> products(arg.size());
+#pragma omp parallel for
+  for (size_t i = 0; i < arg.size(); ++i) {
+    // Elements at higher levels are matched to the smallest on a copy, so
+    // the inputs are left unchanged
+    const SealCiphertextWrapper* element = arg[i].get_ciphertext().get();
+    SealCiphertextWrapper matched;
+    if (he_seal_backend.get_chain_index(*element) != chain_index) {
+      SealCiphertextWrapper matched_smallest(smallest);
+      matched = *element;
+      match_modulus_and_scale_inplace(matched_smallest, matched,
+                                      he_seal_backend);
+      element = &matched;
+    }
+
+    std::vector<double> mask(slot_count, 0);
+    mask[i] = 1;
+    seal::Plaintext plain;
+    HEPrimitiveCounter::increment(HEPrimitive::encode);
+    HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+    encoder.encode(mask, element->ciphertext().parms_id(),
+                   element->ciphertext().scale(), plain);
+    evaluator.multiply_plain(element->ciphertext(), plain, products[i]);
+  }
+  evaluator.add_many(products, out.ciphertext());
+  HEPrimitiveCounter::increment(HEPrimitive::rescale);
+  rescale_inplace(out.ciphertext(), evaluator,
+                  he_seal_backend.rescale_primes());
+  out.complex_packing() = false;
+}
+
+void replicate_slots_seal(SealCiphertextWrapper& arg, size_t period,
+                          HESealBackend& he_seal_backend) {
+  const size_t slot_count = he_seal_backend.get_ckks_encoder()->slot_count();
+  NGRAPH_CHECK(period > 0 && slot_count % period == 0, "Period ", period,
+               " does not divide slot count ", slot_count);
+  std::set<int> steps;
+  for (size_t step = period; step < slot_count; step *= 2) {
+    steps.insert(static_cast<int>(step));
+  }
+  if (steps.empty()) {
+    return;
+  }
+  const auto galois_keys = he_seal_backend.get_galois_keys(steps);
+
+  // Each rotate-and-add doubles the number of copies, which are cyclic, so
+  // rotating left places the copies at the multiples of period
+  auto& evaluator = *he_seal_backend.get_evaluator();
+  seal::Ciphertext rotated;
+  for (int step : steps) {
+    HEPrimitiveCounter::increment(HEPrimitive::rotate);
+    evaluator.rotate_vector(arg.ciphertext(), step, *galois_keys, rotated);
+    evaluator.add_inplace(arg.ciphertext(), rotated);
+  }
+}
+
+void unpack_slots_seal(const SealCiphertextWrapper& arg,
+                       const std::vector<size_t>& slots,
+                       std::vector<HEType>& out,
+                       HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(!he_seal_backend.complex_packing(),
+               "Slot unpacking does not support complex packing");
+  const size_t slot_count = he_seal_backend.get_ckks_encoder()->slot_count();
+  std::vector<int> steps(slots.size());
+  for (size_t i = 0; i < slots.size(); ++i) {
+    NGRAPH_CHECK(slots[i] < slot_count, "Slot ", slots[i],
+                 " exceeds slot count ", slot_count);
+    steps[i] = static_cast<int>(slots[i]);
+  }
+
+  // All values are rotated out of the same ciphertext, so the rotations
+  // share one decomposition
+  std::vector<seal::Ciphertext> rotations;
+  he_seal_backend.rotate_hoisted(arg.ciphertext(), steps, rotations);
+  out.clear();
+  out.reserve(slots.size());
+  for (auto& rotation : rotations) {
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    cipher->ciphertext() = std::move(rotation);
+    out.emplace_back(cipher, false, 1);
+  }
+}
+
+}  // namespace ngraph::runtime::he
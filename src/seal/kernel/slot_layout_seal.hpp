@@ -0,0 +1,67 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+/// \brief Packs the elements of a tensor of batch size 1 into the slots of a
+/// single ciphertext, such that slot i stores element i, as read by the
+/// slot-packed kernels. A ciphertext of batch size 1 stores its value in
+/// every slot, so each element is masked to its slot before the elements are
+/// summed. The result is rescaled, so packing consumes one coefficient
+/// modulus.
+/// \param[in] arg Ciphertexts of the tensor, in row-major order
+/// \param[out] out Ciphertext storing the packed tensor
+/// \param[in] he_seal_backend Backend used for encoding and multiplication
+/// \throws ngraph_error if an element is a plaintext, or the elements do not
+/// fit in the slots
+void pack_slots_seal(const std::vector<HEType>& arg,
+                     SealCiphertextWrapper& out,
+                     HESealBackend& he_seal_backend);
+
+/// \brief Replicates the first period slots of a ciphertext across all
+/// slots by rotate-and-add, so that slot s stores slot s % period, as read
+/// by dot_diagonal_seal. The other slots must store zero, as after
+/// pack_slots_seal. Uses log2(slot count / period) rotations, and no
+/// coefficient modulus
+/// \param[in,out] arg Ciphertext storing the values
+/// \param[in] period Replication period, a power of two dividing the slot
+/// count
+/// \param[in] he_seal_backend Backend used for rotations
+void replicate_slots_seal(SealCiphertextWrapper& arg, size_t period,
+                          HESealBackend& he_seal_backend);
+
+/// \brief Unpacks values stored in slots of a single ciphertext into
+/// ciphertexts of batch size 1, by rotating each slot to slot 0. The other
+/// slots of the outputs store garbage, so the outputs must not be packed
+/// again.
+/// \param[in] arg Ciphertext storing the values
+/// \param[in] slots Slot of each value
+/// \param[out] out Ciphertexts storing the values, one per slot
+/// \param[in] he_seal_backend Backend used for rotations
+void unpack_slots_seal(const SealCiphertextWrapper& arg,
+                       const std::vector<size_t>& slots,
+                       std::vector<HEType>& out,
+                       HESealBackend& he_seal_backend);
+
+}  // namespace ngraph::runtime::he
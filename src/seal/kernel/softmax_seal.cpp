@@ -17,6 +17,7 @@
 #include "seal/kernel/softmax_seal.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -44,6 +45,38 @@ void softmax_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
   auto temp_elements = shape_size(temp_shape);
   NGRAPH_CHECK(!arg.empty(), "arg empty in softmax");
 
+  bool any_ciphertext = std::any_of(arg.begin(), arg.end(),
+                                    [](auto& x) { return x.is_ciphertext(); });
+  if (any_ciphertext && he_seal_backend.polynomial_degree() > 0) {
+    // Without decrypting the maximum, the inputs are assumed to lie in
+    // [-B, B], so each sum of exponentials of n inputs lies in
+    // [n * exp(-B), n * exp(B)]
+    double bound = he_seal_backend.polynomial_activation_bound();
+    auto reduced_elements =
+        static_cast<double>(shape_size(shape) / temp_elements);
+    std::vector<double> reciprocal_coeffs = reciprocal_polynomial(
+        reduced_elements * std::exp(-bound), reduced_elements * std::exp(bound),
+        he_seal_backend.polynomial_degree());
+
+    exp_seal(arg, out, arg.size(), he_seal_backend);
+    auto temp_ptr = std::vector<HEType>(
+        temp_elements,
+        HEType(HEPlaintext(arg[0].batch_size()), arg[0].complex_packing()));
+    sum_seal(out, temp_ptr, shape, temp_shape, axes, element_type,
+             he_seal_backend);
+
+    CoordinateTransform transform(shape);
+    CoordinateTransform temp_transform(temp_shape);
+    for (const Coordinate& coord : transform) {
+      Coordinate temp_coord = reduce(coord, axes);
+      scalar_divide_seal(out[transform.index(coord)],
+                         temp_ptr[temp_transform.index(temp_coord)],
+                         out[transform.index(coord)], reciprocal_coeffs,
+                         he_seal_backend);
+    }
+    return;
+  }
+
   // Avoid extra decryption by setting output of max to plaintext
   // TODO(fboemer): avoid extra decryptions in subtract, exp, sum, divide ops
   // below
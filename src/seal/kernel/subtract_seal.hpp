@@ -17,12 +17,14 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "he_type.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "seal/kernel/negate_seal.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 
@@ -78,22 +80,37 @@ inline void scalar_subtract_seal(HEType& arg0, HEType& arg1, HEType& out,
                                  HESealBackend& he_seal_backend) {
   NGRAPH_CHECK(arg0.complex_packing() == arg1.complex_packing(),
                "Complex packing types don't match");
+  if (aliases_plaintext_arg(arg0, arg1, out)) {
+    HEType difference(HEPlaintext(), arg0.complex_packing());
+    scalar_subtract_seal(arg0, arg1, difference, he_seal_backend);
+    out = std::move(difference);
+    return;
+  }
   out.complex_packing() = arg0.complex_packing();
 
+  if (arg0.is_plaintext() && arg1.is_plaintext()) {
+    if (!out.is_plaintext()) {
+      out.set_plaintext(HEPlaintext());
+    }
+    scalar_subtract_seal(arg0.get_plaintext(), arg1.get_plaintext(),
+                         out.get_plaintext());
+    return;
+  }
+  if (!out.is_ciphertext()) {
+    out.set_ciphertext(HESealBackend::create_empty_ciphertext());
+  }
   if (arg0.is_ciphertext() && arg1.is_ciphertext()) {
     scalar_subtract_seal(*arg0.get_ciphertext(), *arg1.get_ciphertext(),
-                         out.get_ciphertext(), he_seal_backend);
-  } else if (arg0.is_ciphertext() && arg1.is_plaintext()) {
+                         out.get_ciphertext(), he_seal_backend,
+                         he_seal_backend.pool());
+  } else if (arg0.is_ciphertext()) {
     scalar_subtract_seal(*arg0.get_ciphertext(), arg1.get_plaintext(),
                          out.get_ciphertext(), arg0.complex_packing(),
                          he_seal_backend);
-  } else if (arg0.is_plaintext() && arg1.is_ciphertext()) {
+  } else {
     scalar_subtract_seal(arg0.get_plaintext(), *arg1.get_ciphertext(),
                          out.get_ciphertext(), arg0.complex_packing(),
                          he_seal_backend);
-  } else if (arg0.is_plaintext() && arg1.is_plaintext()) {
-    scalar_subtract_seal(arg0.get_plaintext(), arg1.get_plaintext(),
-                         out.get_plaintext());
   }
 }
 
@@ -115,10 +132,50 @@ inline void subtract_seal(std::vector<HEType>& arg0, std::vector<HEType>& arg1,
   NGRAPH_CHECK(count <= arg1.size(), "Count ", count,
                " is too large for arg1, with size ", arg1.size());
 
-#pragma omp parallel for
-  for (size_t i = 0; i < count; ++i) {
-    scalar_subtract_seal(arg0[i], arg1[i], out[i], he_seal_backend);
-  }
+  // Homogeneous operands skip the per-element dispatch on the operand types
+  parallel_for_kinds_seal(
+      arg0, arg1, out, count, [&](size_t i, auto kind0, auto kind1) {
+        using Kind0 = decltype(kind0);
+        using Kind1 = decltype(kind1);
+        if constexpr (std::is_same_v<Kind0, MixedKind> ||
+                      std::is_same_v<Kind1, MixedKind>) {
+          scalar_subtract_seal(arg0[i], arg1[i], out[i], he_seal_backend);
+        } else {
+          NGRAPH_CHECK(arg0[i].complex_packing() == arg1[i].complex_packing(),
+                       "Complex packing types don't match");
+          bool complex_packing = arg0[i].complex_packing();
+          if constexpr (std::is_same_v<Kind0, PlaintextKind> &&
+                        std::is_same_v<Kind1, PlaintextKind>) {
+            if (!out[i].is_plaintext()) {
+              out[i].set_plaintext(HEPlaintext());
+            }
+            scalar_subtract_seal(arg0[i].get_plaintext(),
+                                 arg1[i].get_plaintext(),
+                                 out[i].get_plaintext());
+          } else {
+            if (!out[i].is_ciphertext()) {
+              out[i].set_ciphertext(HESealBackend::create_empty_ciphertext());
+            }
+            if constexpr (std::is_same_v<Kind1, PlaintextKind>) {
+              scalar_subtract_seal(*arg0[i].get_ciphertext(),
+                                   arg1[i].get_plaintext(),
+                                   out[i].get_ciphertext(), complex_packing,
+                                   he_seal_backend);
+            } else if constexpr (std::is_same_v<Kind0, PlaintextKind>) {
+              scalar_subtract_seal(arg0[i].get_plaintext(),
+                                   *arg1[i].get_ciphertext(),
+                                   out[i].get_ciphertext(), complex_packing,
+                                   he_seal_backend);
+            } else {
+              scalar_subtract_seal(*arg0[i].get_ciphertext(),
+                                   *arg1[i].get_ciphertext(),
+                                   out[i].get_ciphertext(), he_seal_backend,
+                                   he_seal_backend.pool());
+            }
+          }
+          out[i].complex_packing() = complex_packing;
+        }
+      });
 }
 
 }  // namespace ngraph::runtime::he
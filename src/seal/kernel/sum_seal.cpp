@@ -0,0 +1,116 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/kernel/sum_seal.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "ngraph/coordinate_transform.hpp"
+#include "seal/kernel/add_seal.hpp"
+
+namespace ngraph::runtime::he {
+
+void sum_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+              const Shape& in_shape, const Shape& out_shape,
+              const AxisSet& reduction_axes, const element::Type& element_type,
+              HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
+               "Unsupported type ", element_type);
+  CoordinateTransform output_transform(out_shape);
+  CoordinateTransform input_transform(in_shape);
+
+  bool complex_packing = !arg.empty() ? arg[0].complex_packing() : false;
+  // TODO(fboemer): batch size
+  size_t batch_size = !arg.empty() ? arg[0].batch_size() : 1;
+  size_t num_outputs = shape_size(out_shape);
+
+  // Input indices of each output, in increasing order
+  std::vector<size_t> offsets(num_outputs + 1, 0);
+  std::vector<size_t> output_of(shape_size(in_shape));
+  for (const Coordinate& input_coord : input_transform) {
+    size_t out_idx =
+        output_transform.index(reduce(input_coord, reduction_axes));
+    output_of[input_transform.index(input_coord)] = out_idx;
+    offsets[out_idx + 1]++;
+  }
+  size_t max_inputs = 0;
+  for (size_t out_idx = 0; out_idx < num_outputs; ++out_idx) {
+    max_inputs = std::max(max_inputs, offsets[out_idx + 1]);
+    offsets[out_idx + 1] += offsets[out_idx];
+  }
+  std::vector<size_t> inputs(output_of.size());
+  {
+    std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+    for (size_t in_idx = 0; in_idx < output_of.size(); ++in_idx) {
+      inputs[next[output_of[in_idx]]++] = in_idx;
+    }
+  }
+
+  // Split each output into enough chunks to occupy all threads
+  size_t max_threads = 1;
+#ifdef _OPENMP
+  max_threads = static_cast<size_t>(omp_get_max_threads());
+#endif
+  size_t num_chunks = 1;
+  if (num_outputs > 0) {
+    num_chunks = (max_threads + num_outputs - 1) / num_outputs;
+  }
+  num_chunks = std::max(size_t{1}, std::min(num_chunks, max_inputs));
+
+  std::vector<HEType> partials(
+      num_outputs * num_chunks,
+      HEType(HEPlaintext(batch_size, 0), complex_packing));
+
+#pragma omp parallel for
+  for (size_t partial_idx = 0; partial_idx < partials.size(); ++partial_idx) {
+    size_t out_idx = partial_idx / num_chunks;
+    size_t chunk = partial_idx % num_chunks;
+    size_t begin = offsets[out_idx];
+    size_t count = offsets[out_idx + 1] - begin;
+    size_t chunk_begin = begin + chunk * count / num_chunks;
+    size_t chunk_end = begin + (chunk + 1) * count / num_chunks;
+
+    auto& partial = partials[partial_idx];
+    for (size_t i = chunk_begin; i < chunk_end; ++i) {
+      scalar_add_seal(arg[inputs[i]], partial, partial, he_seal_backend);
+    }
+  }
+
+  // Combine the partial sums of each output pairwise
+  for (size_t stride = 1; stride < num_chunks; stride *= 2) {
+#pragma omp parallel for
+    for (size_t partial_idx = 0; partial_idx < partials.size();
+         ++partial_idx) {
+      size_t chunk = partial_idx % num_chunks;
+      if (chunk % (2 * stride) == 0 && chunk + stride < num_chunks) {
+        scalar_add_seal(partials[partial_idx + stride], partials[partial_idx],
+                        partials[partial_idx], he_seal_backend);
+      }
+    }
+  }
+
+  for (size_t out_idx = 0; out_idx < num_outputs; ++out_idx) {
+    out[out_idx] = std::move(partials[out_idx * num_chunks]);
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -19,40 +19,26 @@
 #include <vector>
 
 #include "he_type.hpp"
-#include "ngraph/coordinate_transform.hpp"
+#include "ngraph/axis_set.hpp"
+#include "ngraph/shape.hpp"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
-#include "seal/kernel/add_seal.hpp"
 
 namespace ngraph::runtime::he {
-inline void sum_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
-                     const Shape& in_shape, const Shape& out_shape,
-                     const AxisSet& reduction_axes,
-                     const element::Type& element_type,
-                     HESealBackend& he_seal_backend) {
-  NGRAPH_CHECK(he_seal_backend.is_supported_type(element_type),
-               "Unsupported type ", element_type);
-  CoordinateTransform output_transform(out_shape);
-
-  bool complex_packing = !arg.empty() ? arg[0].complex_packing() : false;
-  size_t batch_size = !arg.empty() ? arg[0].batch_size() : 1;
-
-  for (const Coordinate& output_coord : output_transform) {
-    // TODO(fboemer): batch size
-    const auto out_coord_idx = output_transform.index(output_coord);
-    out[out_coord_idx] = HEType(HEPlaintext(batch_size, 0), complex_packing);
-  }
-
-  CoordinateTransform input_transform(in_shape);
-
-  for (const Coordinate& input_coord : input_transform) {
-    Coordinate output_coord = reduce(input_coord, reduction_axes);
-
-    auto& input = arg[input_transform.index(input_coord)];
-    auto& output = out[output_transform.index(output_coord)];
-
-    scalar_add_seal(input, output, output, he_seal_backend);
-  }
-}
+/// \brief Sums the input over the reduction axes. Each output is split into
+/// chunks of its inputs, which are summed in parallel into partial sums and
+/// then combined pairwise. The order of additions depends only on the shapes
+/// and the maximum number of threads
+/// \param[in] arg Input values
+/// \param[out] out Stores the sums
+/// \param[in] in_shape Shape of the input
+/// \param[in] out_shape Shape of the output
+/// \param[in] reduction_axes Axes to sum over
+/// \param[in] element_type Data type of the values
+/// \param[in] he_seal_backend Backend used to perform the additions
+void sum_seal(std::vector<HEType>& arg, std::vector<HEType>& out,
+              const Shape& in_shape, const Shape& out_shape,
+              const AxisSet& reduction_axes, const element::Type& element_type,
+              HESealBackend& he_seal_backend);
 
 }  // namespace ngraph::runtime::he
@@ -17,6 +17,9 @@
 #define ID_SUFFIX(NAME) NAME
 #include "ngraph/opsets/opset0_tbl.hpp"
 NGRAPH_OP(BoundedRelu, op)
+NGRAPH_OP(ConvolutionBiasRelu, op)
+NGRAPH_OP(Refresh, op)
+NGRAPH_OP(SumPool, op)
 #undef ID_SUFFIX
 
 #define ID_SUFFIX(NAME) NAME##_v1
@@ -0,0 +1,56 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/polynomial_activation.hpp"
+
+#include <string>
+
+#include "ngraph/check.hpp"
+#include "ngraph/util.hpp"
+
+namespace ngraph::runtime::he {
+
+PolynomialActivation polynomial_activation_from_string(
+    const std::string& name) {
+  std::string lower_name = ngraph::to_lower(name);
+  if (lower_name == "square") {
+    return PolynomialActivation::square;
+  }
+  if (lower_name == "minimax") {
+    return PolynomialActivation::minimax;
+  }
+  if (lower_name == "sign") {
+    return PolynomialActivation::sign;
+  }
+  NGRAPH_CHECK(lower_name == "none", "Unknown polynomial activation ", name);
+  return PolynomialActivation::none;
+}
+
+std::string polynomial_activation_to_string(PolynomialActivation activation) {
+  switch (activation) {
+    case PolynomialActivation::none:
+      return "none";
+    case PolynomialActivation::square:
+      return "square";
+    case PolynomialActivation::minimax:
+      return "minimax";
+    case PolynomialActivation::sign:
+      return "sign";
+  }
+  return "none";
+}
+
+}  // namespace ngraph::runtime::he
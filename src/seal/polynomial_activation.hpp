@@ -0,0 +1,51 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <string>
+
+namespace ngraph::runtime::he {
+/// \brief Polynomial approximation with which the server computes ReLU-like
+/// activations on ciphertexts, instead of sending them to the client. Each
+/// approximation is accurate for inputs within a configured bound B
+enum class PolynomialActivation {
+  /// The activation is not approximated
+  none,
+  /// Least-squares quadratic approximation of ReLU on [-B, B]
+  square,
+  /// Minimax approximation of ReLU on [-B, B] of degree 3. Since ReLU(x) -
+  /// x / 2 is even, its cubic coefficient vanishes, so it is evaluated as a
+  /// quadratic with maximum error B / 16
+  minimax,
+  /// x * (1 + sign(x)) / 2, where the sign is approximated by composing
+  /// (3x - x^3) / 2 on [-1, 1]. More accurate away from zero, but consumes
+  /// more levels
+  sign
+};
+
+/// \brief Parses a polynomial activation
+/// \param[in] name One of "none", "square", "minimax", or "sign",
+/// case-insensitive
+/// \throws ngraph_error if the name is unknown
+PolynomialActivation polynomial_activation_from_string(
+    const std::string& name);
+
+/// \brief Returns the name of a polynomial activation
+/// \param[in] activation Polynomial activation
+std::string polynomial_activation_to_string(PolynomialActivation activation);
+
+}  // namespace ngraph::runtime::he
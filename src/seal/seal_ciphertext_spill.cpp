@@ -0,0 +1,241 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_ciphertext_spill.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/except.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Writes size bytes to a file descriptor, retrying partial writes
+/// \returns Whether or not all bytes were written
+bool write_all(int fd, const std::byte* data, size_t size) {
+  while (size > 0) {
+    ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+}  // namespace
+
+SealCiphertextSpill::SealCiphertextSpill(std::string directory)
+    : m_directory(std::move(directory)) {
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+  if (error) {
+    throw ngraph_error("Failed to create spill directory " + m_directory +
+                       ": " + error.message());
+  }
+}
+
+SealCiphertextSpill::~SealCiphertextSpill() {
+  try {
+    clear();
+  } catch (std::exception& e) {
+    NGRAPH_ERR << "Exception removing spill files " << e.what();
+  }
+}
+
+size_t SealCiphertextSpill::spill(size_t key, std::vector<HEType>& data) {
+  SpillFile file;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    NGRAPH_CHECK(m_files.find(key) == m_files.end(), "Tensor ", key,
+                 " is already spilled");
+  }
+
+  // The file is created exclusively and readable by the owner alone, so no
+  // existing file or symlink of another user is written to. Names taken,
+  // e.g. by files of an earlier process with the same pid, are skipped
+  int fd = -1;
+  for (size_t attempt = 0; fd < 0 && attempt < s_max_create_attempts;
+       ++attempt) {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      file.filename = m_directory + "/ngraph_he_spill_" +
+                      std::to_string(::getpid()) + "_" +
+                      std::to_string(m_next_file++) + ".bin";
+    }
+    fd = ::open(file.filename.c_str(),
+                O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0 && errno != EEXIST) {
+      break;
+    }
+  }
+  if (fd < 0) {
+    throw ngraph_error("Failed to create spill file " + file.filename + ": " +
+                       std::strerror(errno));
+  }
+
+  // Written without the lock, so other tensors are restored meanwhile
+  file.offsets.emplace_back(0);
+  bool written = true;
+  std::vector<std::byte> buffer;
+  for (size_t i = 0; i < data.size() && written; ++i) {
+    if (data[i].is_plaintext() || data[i].get_ciphertext()->is_seeded()) {
+      continue;
+    }
+    const seal::Ciphertext& cipher = data[i].get_ciphertext()->ciphertext();
+    if (cipher.size() == 0) {
+      continue;
+    }
+    buffer.resize(ciphertext_size(cipher));
+    size_t size = save(cipher, buffer.data());
+    written = write_all(fd, buffer.data(), size);
+    file.indices.emplace_back(i);
+    file.offsets.emplace_back(file.offsets.back() + size);
+  }
+  if (::close(fd) != 0) {
+    written = false;
+  }
+  if (!written) {
+    std::filesystem::remove(file.filename);
+    throw ngraph_error("Failed to write spill file " + file.filename);
+  }
+  for (size_t i : file.indices) {
+    data[i].replace_ciphertext(HESealBackend::create_empty_ciphertext());
+  }
+
+  size_t bytes = file.offsets.back();
+  NGRAPH_HE_LOG(5) << "Spilled " << file.indices.size() << " ciphertexts ("
+                   << bytes << " bytes) to " << file.filename;
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_spilled_bytes += bytes;
+  m_total_spilled_bytes += bytes;
+  m_files.emplace(key, std::move(file));
+  return bytes;
+}
+
+void SealCiphertextSpill::restore(
+    size_t key, std::vector<HEType>& data,
+    const std::shared_ptr<seal::SEALContext>& context) {
+  SpillFile file;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_files.find(key);
+    NGRAPH_CHECK(it != m_files.end(), "Tensor ", key, " is not spilled");
+    file = std::move(it->second);
+    m_files.erase(it);
+    m_spilled_bytes -= file.offsets.back();
+  }
+
+  size_t num_bytes = file.offsets.back();
+  if (num_bytes > 0) {
+    int fd = ::open(file.filename.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+      throw ngraph_error("Failed to open spill file " + file.filename);
+    }
+    // Mapping beyond the end of a truncated file would fault on access
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 ||
+        static_cast<size_t>(file_stat.st_size) < num_bytes) {
+      ::close(fd);
+      throw ngraph_error("Spill file " + file.filename + " was truncated");
+    }
+    void* addr = ::mmap(nullptr, num_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+      throw ngraph_error("Failed to map spill file " + file.filename);
+    }
+    std::unique_ptr<void, std::function<void(void*)>> mapping(
+        addr, [num_bytes](void* ptr) { ::munmap(ptr, num_bytes); });
+    // Pages are read ahead, since every ciphertext is loaded in order
+    ::madvise(addr, num_bytes, MADV_SEQUENTIAL);
+
+    const auto* src = static_cast<const std::byte*>(addr);
+    for (size_t i = 0; i < file.indices.size(); ++i) {
+      NGRAPH_CHECK(file.indices[i] < data.size(), "Spilled index ",
+                   file.indices[i], " out of bounds");
+      HEType& he_type = data[file.indices[i]];
+      NGRAPH_CHECK(he_type.is_ciphertext(), "Spilled value ", file.indices[i],
+                   " was overwritten by a plaintext");
+      // The file may have been modified on disk, so the data are validated
+      load(he_type.get_ciphertext()->ciphertext(), context,
+           src + file.offsets[i], file.offsets[i + 1] - file.offsets[i]);
+    }
+  }
+  std::filesystem::remove(file.filename);
+  NGRAPH_HE_LOG(5) << "Restored " << file.indices.size()
+                   << " ciphertexts from " << file.filename;
+}
+
+bool SealCiphertextSpill::contains(size_t key) const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_files.find(key) != m_files.end();
+}
+
+void SealCiphertextSpill::discard(size_t key) {
+  std::string filename;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_files.find(key);
+    if (it == m_files.end()) {
+      return;
+    }
+    filename = it->second.filename;
+    m_spilled_bytes -= it->second.offsets.back();
+    m_files.erase(it);
+  }
+  std::filesystem::remove(filename);
+}
+
+void SealCiphertextSpill::clear() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  for (const auto& [key, file] : m_files) {
+    std::error_code error;
+    std::filesystem::remove(file.filename, error);
+  }
+  m_files.clear();
+  m_spilled_bytes = 0;
+}
+
+size_t SealCiphertextSpill::spilled_bytes() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_spilled_bytes;
+}
+
+size_t SealCiphertextSpill::total_spilled_bytes() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_total_spilled_bytes;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,113 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "he_type.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Disk tier for the ciphertexts of tensors which are not read again
+/// soon. The ciphertexts of a spilled tensor are written in SEAL's binary
+/// form to one file per tensor, and replaced by empty ciphertexts. Restoring
+/// memory-maps the file, loads the ciphertexts back, and removes the file.
+/// Files are created exclusively with owner-only permissions, and the
+/// restored ciphertexts are validated, since the directory may be shared.
+/// All methods are thread-safe, so a tensor may be restored while another is
+/// spilled
+class SealCiphertextSpill {
+ public:
+  /// \brief Constructs an empty spill tier
+  /// \param[in] directory Directory storing the spill files, e.g. on a local
+  /// NVMe drive. Created if it does not exist
+  /// \throws ngraph_error if the directory cannot be created
+  explicit SealCiphertextSpill(std::string directory);
+
+  /// \brief Removes the remaining spill files
+  ~SealCiphertextSpill();
+
+  SealCiphertextSpill(const SealCiphertextSpill&) = delete;
+  SealCiphertextSpill& operator=(const SealCiphertextSpill&) = delete;
+
+  /// \brief Writes the ciphertexts of a tensor to a file and releases them.
+  /// Plaintexts and seeded ciphertexts stay in memory
+  /// \param[in] key Identifies the tensor, e.g. its slot. Must not be
+  /// spilled already
+  /// \param[in,out] data Values of the tensor
+  /// \returns The number of bytes written
+  /// \throws ngraph_error if the file cannot be written
+  size_t spill(size_t key, std::vector<HEType>& data);
+
+  /// \brief Loads the ciphertexts of a spilled tensor back, and removes its
+  /// file
+  /// \param[in] key Identifies the tensor
+  /// \param[in,out] data Values of the tensor, as left by spill
+  /// \param[in] context SEAL context the ciphertexts were created with
+  /// \throws ngraph_error if the tensor is not spilled, or its file cannot
+  /// be read
+  void restore(size_t key, std::vector<HEType>& data,
+               const std::shared_ptr<seal::SEALContext>& context);
+
+  /// \brief Returns whether or not a tensor is spilled
+  /// \param[in] key Identifies the tensor
+  bool contains(size_t key) const;
+
+  /// \brief Removes the file of a spilled tensor which is not read again
+  /// \param[in] key Identifies the tensor. Ignored if not spilled
+  void discard(size_t key);
+
+  /// \brief Removes the files of all spilled tensors
+  void clear();
+
+  /// \brief Returns the number of bytes currently stored on disk
+  size_t spilled_bytes() const;
+
+  /// \brief Returns the total number of bytes written since construction
+  size_t total_spilled_bytes() const;
+
+  /// \brief Returns the directory storing the spill files
+  const std::string& directory() const { return m_directory; }
+
+ private:
+  /// \brief Spill file of a tensor
+  struct SpillFile {
+    std::string filename;
+    /// \brief Indices of the spilled values in the tensor data
+    std::vector<size_t> indices;
+    /// \brief Ciphertext i occupies [offsets[i], offsets[i + 1]) of the file
+    std::vector<size_t> offsets;
+  };
+
+  std::string m_directory;
+  mutable std::mutex m_mutex;
+  std::unordered_map<size_t, SpillFile> m_files;
+  size_t m_next_file{0};
+  size_t m_spilled_bytes{0};
+  size_t m_total_spilled_bytes{0};
+
+  // Number of file names tried before spilling fails
+  inline static const size_t s_max_create_attempts{64};
+};
+
+}  // namespace ngraph::runtime::he
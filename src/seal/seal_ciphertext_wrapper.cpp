@@ -16,43 +16,197 @@
 
 #include "seal/seal_ciphertext_wrapper.hpp"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
+#include "ngraph/util.hpp"
 #include "protos/message.pb.h"
 #include "seal/seal.h"
 
 namespace ngraph::runtime::he {
 
+seal::compr_mode_type compr_mode_from_string(const std::string& name) {
+  std::string lower_name = ngraph::to_lower(name);
+
+  seal::compr_mode_type compr_mode = seal::compr_mode_type::none;
+  if (lower_name == "zlib") {
+#ifdef SEAL_USE_ZLIB
+    compr_mode = seal::compr_mode_type::zlib;
+#else
+    NGRAPH_CHECK(false, "SEAL was built without zlib support");
+#endif
+  } else if (lower_name == "zstd") {
+#ifdef SEAL_USE_ZSTD
+    compr_mode = seal::compr_mode_type::zstd;
+#else
+    NGRAPH_CHECK(false, "SEAL was built without zstd support");
+#endif
+  } else {
+    NGRAPH_CHECK(lower_name == "none", "Unknown compression mode ", name);
+  }
+  return compr_mode;
+}
+
+std::string compr_mode_to_string(seal::compr_mode_type compr_mode) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+  switch (compr_mode) {
+#ifdef SEAL_USE_ZLIB
+    case seal::compr_mode_type::zlib:
+      return "zlib";
+#endif
+#ifdef SEAL_USE_ZSTD
+    case seal::compr_mode_type::zstd:
+      return "zstd";
+#endif
+    case seal::compr_mode_type::none:
+    default:
+      return "none";
+  }
+#pragma clang diagnostic pop
+}
+
+pb::EncryptionParameters::CompressionMode compr_mode_to_pb(
+    seal::compr_mode_type compr_mode) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+  switch (compr_mode) {
+#ifdef SEAL_USE_ZLIB
+    case seal::compr_mode_type::zlib:
+      return pb::EncryptionParameters_CompressionMode_ZLIB;
+#endif
+#ifdef SEAL_USE_ZSTD
+    case seal::compr_mode_type::zstd:
+      return pb::EncryptionParameters_CompressionMode_ZSTD;
+#endif
+    case seal::compr_mode_type::none:
+    default:
+      return pb::EncryptionParameters_CompressionMode_NONE;
+  }
+#pragma clang diagnostic pop
+}
+
+seal::compr_mode_type compr_mode_from_pb(
+    pb::EncryptionParameters::CompressionMode compr_mode) {
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wswitch-enum"
+  switch (compr_mode) {
+#ifdef SEAL_USE_ZLIB
+    case pb::EncryptionParameters_CompressionMode_ZLIB:
+      return seal::compr_mode_type::zlib;
+#endif
+#ifdef SEAL_USE_ZSTD
+    case pb::EncryptionParameters_CompressionMode_ZSTD:
+      return seal::compr_mode_type::zstd;
+#endif
+    case pb::EncryptionParameters_CompressionMode_NONE:
+    default:
+      return seal::compr_mode_type::none;
+  }
+#pragma clang diagnostic pop
+}
+
 SealCiphertextWrapper::SealCiphertextWrapper() = default;
 
-void SealCiphertextWrapper::save(pb::HEType& he_type) const {
-  size_t cipher_size = ciphertext_size(m_ciphertext);
+void SealCiphertextWrapper::save(pb::HEType& he_type,
+                                 seal::compr_mode_type compr_mode) const {
+  if (is_seeded()) {
+    he_type.set_ciphertext(m_seeded_data);
+    return;
+  }
+
+  size_t cipher_size = ciphertext_size(m_ciphertext, compr_mode);
   std::string cipher_str;
   cipher_str.resize(cipher_size);
 
   size_t save_size = ngraph::runtime::he::save(
-      m_ciphertext, reinterpret_cast<std::byte*>(cipher_str.data()));
+      m_ciphertext, reinterpret_cast<std::byte*>(cipher_str.data()),
+      compr_mode);
 
-  NGRAPH_CHECK(save_size == cipher_size, "Save size != cipher size");
+  // With compression, cipher_size is only an upper bound
+  NGRAPH_CHECK(save_size <= cipher_size, "Save size > cipher size");
+  cipher_str.resize(save_size);
 
   he_type.set_ciphertext(std::move(cipher_str));
 }
 
+void SealCiphertextWrapper::save(pb::HEType& he_type,
+                                 TCPMessage::Segment& segment) const {
+  auto* header = he_type.mutable_ciphertext_header();
+  const auto& parms_id = m_ciphertext.parms_id();
+  *header->mutable_parms_id() = {parms_id.begin(), parms_id.end()};
+  header->set_size(m_ciphertext.size());
+  header->set_poly_modulus_degree(m_ciphertext.poly_modulus_degree());
+  header->set_coeff_modulus_size(m_ciphertext.coeff_modulus_size());
+  header->set_is_ntt_form(m_ciphertext.is_ntt_form());
+  header->set_scale(m_ciphertext.scale());
+  header->set_payload_offset(0);
+
+  segment.data = m_ciphertext.data();
+  segment.size = m_ciphertext.size() * m_ciphertext.poly_modulus_degree() *
+                 m_ciphertext.coeff_modulus_size() * sizeof(std::uint64_t);
+}
+
 void SealCiphertextWrapper::load(SealCiphertextWrapper& dst,
                                  const pb::HEType& pb_he_type,
-                                 std::shared_ptr<seal::SEALContext> context) {
+                                 std::shared_ptr<seal::SEALContext> context,
+                                 const char* payload, size_t payload_size,
+                                 bool trusted) {
   NGRAPH_CHECK(!pb_he_type.is_plaintext(),
                "Cannot load ciphertext from plaintext HEType");
 
+  if (pb_he_type.has_ciphertext_header()) {
+    const auto& header = pb_he_type.ciphertext_header();
+    seal::parms_id_type parms_id;
+    NGRAPH_CHECK(static_cast<size_t>(header.parms_id_size()) ==
+                     parms_id.size(),
+                 "Invalid ciphertext parms_id size ", header.parms_id_size());
+    std::copy(header.parms_id().begin(), header.parms_id().end(),
+              parms_id.begin());
+
+    // The header is checked against the parameters and the payload before
+    // allocating, so malformed messages do not allocate large ciphertexts
+    auto context_data = context->get_context_data(parms_id);
+    NGRAPH_CHECK(context_data != nullptr,
+                 "Ciphertext parms_id is not valid for encryption parameters");
+    const auto& parms = context_data->parms();
+    size_t poly_modulus_degree = parms.poly_modulus_degree();
+    size_t coeff_modulus_size = parms.coeff_modulus().size();
+    NGRAPH_CHECK(header.size() >= SEAL_CIPHERTEXT_SIZE_MIN &&
+                     header.size() <= SEAL_CIPHERTEXT_SIZE_MAX,
+                 "Invalid ciphertext size ", header.size());
+    NGRAPH_CHECK(poly_modulus_degree == header.poly_modulus_degree() &&
+                     coeff_modulus_size == header.coeff_modulus_size(),
+                 "Ciphertext header does not match encryption parameters");
+
+    size_t data_size = header.size() * poly_modulus_degree *
+                       coeff_modulus_size * sizeof(std::uint64_t);
+    NGRAPH_CHECK(payload != nullptr &&
+                     header.payload_offset() <= payload_size &&
+                     data_size <= payload_size - header.payload_offset(),
+                 "Ciphertext data exceeds message payload");
+    seal::Ciphertext& cipher = dst.ciphertext();
+    cipher.resize(*context, parms_id, header.size());
+    std::memcpy(cipher.data(), payload + header.payload_offset(), data_size);
+    cipher.is_ntt_form() = header.is_ntt_form();
+    cipher.scale() = header.scale();
+    NGRAPH_CHECK(trusted || seal::is_valid_for(cipher, *context),
+                 "Loaded ciphertext is not valid for encryption parameters");
+    return;
+  }
+
   const std::string& cipher_str = pb_he_type.ciphertext();
   ngraph::runtime::he::load(
       dst.ciphertext(), std::move(context),
-      reinterpret_cast<const std::byte*>(cipher_str.data()), cipher_str.size());
+      reinterpret_cast<const std::byte*>(cipher_str.data()), cipher_str.size(),
+      trusted);
 }
 
 }  // namespace ngraph::runtime::he
@@ -18,39 +18,78 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
 #include "protos/message.pb.h"
 #include "seal/seal.h"
+#include "tcp/tcp_message.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Returns the size in bytes required to serialize a ciphertext
+/// \brief Returns the size in bytes required to serialize a ciphertext. If
+/// compression is used, this is an upper bound on the serialized size
 /// \param[in] cipher Ciphertext to measure size of
-inline size_t ciphertext_size(const seal::Ciphertext& cipher) {
-  return cipher.save_size(seal::compr_mode_type::none);
+/// \param[in] compr_mode Compression mode to serialize with
+inline size_t ciphertext_size(
+    const seal::Ciphertext& cipher,
+    seal::compr_mode_type compr_mode = seal::compr_mode_type::none) {
+  return cipher.save_size(compr_mode);
 }
 
 /// \brief Serializes the ciphertext and writes to a destination
 /// \param[in] cipher Ciphertext to write
-/// \param[out] destination Where to save ciphertext to
+/// \param[out] destination Where to save ciphertext to. Must store at least
+/// ciphertext_size(cipher, compr_mode) bytes
+/// \param[in] compr_mode Compression mode to serialize with
 /// \returns The size in bytes of the saved ciphertext
-inline std::size_t save(const seal::Ciphertext& cipher,
-                        std::byte* destination) {
-  return cipher.save(destination, ciphertext_size(cipher),
-                     seal::compr_mode_type::none);
+inline std::size_t save(
+    const seal::Ciphertext& cipher, std::byte* destination,
+    seal::compr_mode_type compr_mode = seal::compr_mode_type::none) {
+  return cipher.save(destination, ciphertext_size(cipher, compr_mode),
+                     compr_mode);
 }
 
+/// \brief Parses a compression mode
+/// \param[in] name One of "none", "zlib", or "zstd", case-insensitive
+/// \throws ngraph_error if the name is unknown, or SEAL was built without
+/// support for the compression mode
+seal::compr_mode_type compr_mode_from_string(const std::string& name);
+
+/// \brief Returns the name of a compression mode
+/// \param[in] compr_mode Compression mode
+std::string compr_mode_to_string(seal::compr_mode_type compr_mode);
+
+/// \brief Converts a compression mode to its protobuf representation
+/// \param[in] compr_mode Compression mode to convert
+pb::EncryptionParameters::CompressionMode compr_mode_to_pb(
+    seal::compr_mode_type compr_mode);
+
+/// \brief Converts a protobuf compression mode to a SEAL compression mode.
+/// Modes which this build of SEAL does not support are converted to
+/// seal::compr_mode_type::none, so a proposed mode is only accepted if it is
+/// supported locally
+/// \param[in] compr_mode Compression mode to convert
+seal::compr_mode_type compr_mode_from_pb(
+    pb::EncryptionParameters::CompressionMode compr_mode);
+
 /// \brief Loads a serialized ciphertext
 /// \param[out] cipher De-serialized ciphertext
 /// \param[in] context Encryption context to verify ciphertext validity against
 /// \param[in] src Pointer to data to load from
 /// \param[in] size Number of bytes available in the memory location
+/// \param[in] trusted Whether or not the ciphertext was produced by a
+/// trusted party, in which case it is loaded without validating its data
 inline void load(seal::Ciphertext& cipher,
                  std::shared_ptr<seal::SEALContext> context,
-                 const std::byte* src, const std::size_t size) {
-  cipher.load(std::move(*context), src, size);
+                 const std::byte* src, const std::size_t size,
+                 bool trusted = false) {
+  if (trusted) {
+    cipher.unsafe_load(*context, src, size);
+  } else {
+    cipher.load(std::move(*context), src, size);
+  }
 }
 
 /// \brief Class representing a lightweight wrapper around a SEAL ciphertext.
@@ -59,6 +98,11 @@ class SealCiphertextWrapper {
   /// \brief Create an empty ciphertext
   SealCiphertextWrapper();
 
+  /// \brief Create an empty ciphertext whose data is allocated from a pool
+  /// \param[in] pool Memory pool storing the ciphertext data
+  explicit SealCiphertextWrapper(const seal::MemoryPoolHandle& pool)
+      : m_ciphertext(pool) {}
+
   /// \brief Returns the ciphertext
   seal::Ciphertext& ciphertext() { return m_ciphertext; }
 
@@ -71,19 +115,56 @@ class SealCiphertextWrapper {
   /// \brief Returns scale of the ciphertext
   double scale() const { return m_ciphertext.scale(); }
 
+  /// \brief Returns whether or not the ciphertext has size at most 2. Larger
+  /// ciphertexts are products whose relinearization was deferred, see
+  /// relinearize_inplace
+  bool is_relinearized() const { return m_ciphertext.size() <= 2; }
+
+  /// \brief Stores a serialized seeded ciphertext, which is written instead
+  /// of the ciphertext by save. Seeded ciphertexts are created by secret-key
+  /// encryption on the client, and are only expanded when loaded, so the
+  /// wrapped ciphertext remains empty
+  /// \param[in] seeded_data Serialized seeded ciphertext
+  void set_seeded_data(std::string seeded_data) {
+    m_seeded_data = std::move(seeded_data);
+  }
+
+  /// \brief Returns whether or not the wrapper stores a seeded ciphertext
+  bool is_seeded() const { return !m_seeded_data.empty(); }
+
   /// \brief Writes the ciphertext to a protobuf object
   /// \param[out] he_type Protobuf object to write ciphertext to
-  void save(pb::HEType& he_type) const;
+  /// \param[in] compr_mode Compression mode to serialize with. Ignored for
+  /// seeded ciphertexts, which are compressed when created
+  void save(
+      pb::HEType& he_type,
+      seal::compr_mode_type compr_mode = seal::compr_mode_type::none) const;
+
+  /// \brief Writes the ciphertext metadata to a protobuf object, and points
+  /// a payload segment at the ciphertext data, which is not copied
+  /// \param[out] he_type Protobuf object to write ciphertext metadata to
+  /// \param[out] segment Payload segment storing the ciphertext data. The
+  /// payload offset in the metadata is left at 0 for the caller to set
+  void save(pb::HEType& he_type, TCPMessage::Segment& segment) const;
 
   /// \brief Loads a ciphertext from a protobuf object
   /// \param[out] dst Destination to load ciphertext to
   /// \param[in] pb_he_type Protobuf object to load object from
   /// \param[in] context SEAL context to validate loaded ciphertext against
+  /// \param[in] payload Payload of the message storing pb_he_type. Used if
+  /// the ciphertext data is stored as a payload segment
+  /// \param[in] payload_size Size in bytes of the payload
+  /// \param[in] trusted Whether or not the ciphertext was produced by a
+  /// trusted party, in which case its data is not validated against the
+  /// context. Its metadata and size are still checked
   static void load(SealCiphertextWrapper& dst, const pb::HEType& pb_he_type,
-                   std::shared_ptr<seal::SEALContext> context);
+                   std::shared_ptr<seal::SEALContext> context,
+                   const char* payload = nullptr, size_t payload_size = 0,
+                   bool trusted = false);
 
  private:
   seal::Ciphertext m_ciphertext;
+  std::string m_seeded_data;
 };
 
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,85 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_context_cache.hpp"
+
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+struct CachedContext {
+  std::shared_ptr<seal::SEALContext> context;
+  std::shared_ptr<seal::Evaluator> evaluator;
+};
+
+std::mutex s_contexts_mutex;
+std::unordered_map<std::string, CachedContext> s_contexts;
+
+/// \brief Returns the cached context of the given encryption parameters,
+/// creating it if needed. Contexts are created under the lock, so
+/// concurrent callers do not precompute the same tables twice
+CachedContext cached_context(const HESealEncryptionParameters& parms) {
+  std::stringstream key_stream;
+  parms.seal_encryption_parameters().save(key_stream,
+                                          seal::compr_mode_type::none);
+  key_stream << parms.security_level();
+  std::string key = key_stream.str();
+
+  std::lock_guard<std::mutex> guard(s_contexts_mutex);
+  auto it = s_contexts.find(key);
+  if (it == s_contexts.end()) {
+    CachedContext cached;
+    cached.context = std::make_shared<seal::SEALContext>(
+        parms.seal_encryption_parameters(), true,
+        seal_security_level(parms.security_level()));
+    cached.evaluator = std::make_shared<seal::Evaluator>(*cached.context);
+    it = s_contexts.emplace(std::move(key), std::move(cached)).first;
+    NGRAPH_HE_LOG(3) << "Created SEAL context for poly modulus degree "
+                     << parms.poly_modulus_degree();
+  }
+  return it->second;
+}
+}  // namespace
+
+std::shared_ptr<seal::SEALContext> SealContextCache::get_context(
+    const HESealEncryptionParameters& parms) {
+  return cached_context(parms).context;
+}
+
+std::shared_ptr<seal::Evaluator> SealContextCache::get_evaluator(
+    const HESealEncryptionParameters& parms) {
+  return cached_context(parms).evaluator;
+}
+
+size_t SealContextCache::size() {
+  std::lock_guard<std::mutex> guard(s_contexts_mutex);
+  return s_contexts.size();
+}
+
+void SealContextCache::clear() {
+  std::lock_guard<std::mutex> guard(s_contexts_mutex);
+  s_contexts.clear();
+}
+
+}  // namespace ngraph::runtime::he
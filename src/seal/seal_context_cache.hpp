@@ -0,0 +1,55 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Process-wide cache of SEAL contexts and evaluators, keyed by the
+/// SEAL encryption parameters and security level. Creating a context
+/// precomputes the NTT tables of each coefficient modulus, so backends and
+/// clients with the same parameters share one context instead. Keys and
+/// encoders are not shared, since they are registered or generated per
+/// owner. All methods are thread-safe.
+class SealContextCache {
+ public:
+  /// \brief Returns the context of the given encryption parameters, which
+  /// is created on first use
+  /// \param[in] parms Encryption parameters. The scale and packing do not
+  /// affect the context
+  static std::shared_ptr<seal::SEALContext> get_context(
+      const HESealEncryptionParameters& parms);
+
+  /// \brief Returns an evaluator of the context of the given encryption
+  /// parameters, which is created on first use
+  /// \param[in] parms Encryption parameters
+  static std::shared_ptr<seal::Evaluator> get_evaluator(
+      const HESealEncryptionParameters& parms);
+
+  /// \brief Returns the number of cached contexts
+  static size_t size();
+
+  /// \brief Releases the cached contexts. Owners of a context keep it
+  static void clear();
+};
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,68 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_huge_pages.hpp"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace ngraph::runtime::he {
+
+bool transparent_huge_pages_available() {
+  std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string modes;
+  std::getline(file, modes);
+  // The active mode is bracketed, e.g. "always [madvise] never"
+  return modes.find("[always]") != std::string::npos ||
+         modes.find("[madvise]") != std::string::npos;
+}
+
+void advise_huge_pages(std::vector<std::pair<uintptr_t, size_t>>& ranges) {
+  std::sort(ranges.begin(), ranges.end());
+  size_t num_merged = 0;
+  for (auto [begin, byte_count] : ranges) {
+    if (byte_count == 0) {
+      continue;
+    }
+    if (num_merged > 0) {
+      auto& last = ranges[num_merged - 1];
+      uintptr_t last_end = last.first + last.second;
+      if (begin < last_end + s_huge_page_bytes) {
+        last.second = std::max(last_end, begin + byte_count) - last.first;
+        continue;
+      }
+    }
+    ranges[num_merged++] = {begin, byte_count};
+  }
+  ranges.resize(num_merged);
+
+  for (const auto& [begin, byte_count] : ranges) {
+    uintptr_t page_begin =
+        (begin + s_huge_page_bytes - 1) / s_huge_page_bytes * s_huge_page_bytes;
+    uintptr_t page_end =
+        (begin + byte_count) / s_huge_page_bytes * s_huge_page_bytes;
+    if (page_begin < page_end) {
+      // Fails on ranges spanning unmapped memory, which keeps regular pages
+      ::madvise(reinterpret_cast<void*>(page_begin), page_end - page_begin,
+                MADV_HUGEPAGE);
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
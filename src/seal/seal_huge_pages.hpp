@@ -0,0 +1,42 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ngraph::runtime::he {
+
+/// \brief Size of the transparent huge pages memory is advised for
+inline constexpr size_t s_huge_page_bytes = 2U << 20U;
+
+/// \brief Returns whether or not the kernel backs advised memory by
+/// transparent huge pages, i.e. transparent huge pages are enabled in the
+/// "always" or "madvise" mode
+bool transparent_huge_pages_available();
+
+/// \brief Advises the kernel to back memory ranges by transparent huge pages.
+/// Ranges less than a huge page apart are merged, and only the huge pages
+/// within the merged ranges are advised. Memory the kernel cannot back by
+/// huge pages keeps regular pages
+/// \param[in,out] ranges Start address and byte count of each range. Sorted
+/// and merged in place
+void advise_huge_pages(std::vector<std::pair<uintptr_t, size_t>>& ranges);
+
+}  // namespace ngraph::runtime::he
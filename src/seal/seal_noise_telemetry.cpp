@@ -0,0 +1,69 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_noise_telemetry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+NoiseSample measure_noise(const seal::Ciphertext& cipher, size_t batch_size,
+                          const seal::SEALContext& context,
+                          seal::Decryptor& decryptor,
+                          seal::CKKSEncoder& ckks_encoder) {
+  auto context_data = context.get_context_data(cipher.parms_id());
+  NGRAPH_CHECK(context_data != nullptr,
+               "Ciphertext is not valid for the context");
+
+  seal::Plaintext plain;
+  decryptor.decrypt(cipher, plain);
+  std::vector<std::complex<double>> slots;
+  ckks_encoder.decode(plain, slots);
+
+  double max_value = 0;
+  double max_noise = 0;
+  for (size_t i = 0; i < slots.size(); ++i) {
+    if (i < batch_size) {
+      max_value = std::max(max_value, std::abs(slots[i].real()));
+    }
+    max_noise = std::max(max_noise, std::abs(slots[i].imag()));
+  }
+
+  double log2_modulus = 0;
+  for (const auto& modulus : context_data->parms().coeff_modulus()) {
+    log2_modulus += std::log2(static_cast<double>(modulus.value()));
+  }
+
+  // Values are centered, so one bit of the modulus holds the sign. Noise
+  // below the smallest double is clamped rather than reported as infinite
+  constexpr double min_magnitude = 1e-300;
+  NoiseSample sample;
+  sample.num_samples = 1;
+  sample.chain_index = context_data->chain_index();
+  sample.log2_scale = std::log2(cipher.scale());
+  sample.headroom_bits = log2_modulus - sample.log2_scale -
+                         std::log2(std::max(max_value, min_magnitude)) - 1;
+  sample.precision_bits = -std::log2(std::max(max_noise, min_magnitude));
+  return sample;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+#include "ngraph/node.hpp"
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Headroom below which a node's outputs are reported as about to
+/// wrap around the coefficient modulus, in bits
+constexpr double s_noise_warning_headroom_bits = 2.0;
+
+/// \brief Precision below which a node's outputs are reported as imprecise,
+/// in bits
+constexpr double s_noise_warning_precision_bits = 8.0;
+
+/// \brief Worst-case chain index, scale, headroom and precision measured from
+/// decrypted ciphertexts
+struct NoiseSample {
+  /// \brief Number of ciphertexts measured
+  size_t num_samples{0};
+  /// \brief Lowest chain index, i.e. number of rescales remaining
+  size_t chain_index{std::numeric_limits<size_t>::max()};
+  /// \brief Largest scale, as log2
+  double log2_scale{0};
+  /// \brief Lowest number of bits by which the coefficient modulus exceeds
+  /// the scaled values, i.e. doublings of the values before they wrap around
+  double headroom_bits{std::numeric_limits<double>::infinity()};
+  /// \brief Lowest absolute precision of the values, in bits. Estimated from
+  /// the imaginary parts of the decoded slots, which only hold noise for the
+  /// real-valued encodings used without complex packing
+  double precision_bits{std::numeric_limits<double>::infinity()};
+
+  /// \brief Returns whether the headroom or precision is below the warning
+  /// thresholds
+  bool warning() const {
+    return num_samples > 0 &&
+           (headroom_bits < s_noise_warning_headroom_bits ||
+            precision_bits < s_noise_warning_precision_bits);
+  }
+
+  /// \brief Merges another sample, keeping the worst case of each field
+  NoiseSample& merge(const NoiseSample& other) {
+    num_samples += other.num_samples;
+    chain_index = std::min(chain_index, other.chain_index);
+    log2_scale = std::max(log2_scale, other.log2_scale);
+    headroom_bits = std::min(headroom_bits, other.headroom_bits);
+    precision_bits = std::min(precision_bits, other.precision_bits);
+    return *this;
+  }
+};
+
+/// \brief Noise telemetry of a node
+struct HENoiseReport {
+  std::shared_ptr<const Node> node;
+  /// \brief Measurements of the node outputs, over all calls
+  NoiseSample sample;
+  /// \brief Precision lost by the node, i.e. the lowest precision of its
+  /// measured arguments minus the precision of its outputs, in bits. 0 if no
+  /// argument was measured
+  double precision_drift_bits{0};
+};
+
+/// \brief Decrypts a ciphertext to measure its noise
+/// \param[in] cipher Ciphertext to measure, encrypted without complex packing
+/// \param[in] batch_size Number of slots holding values
+/// \param[in] context Context of the ciphertext
+/// \param[in] decryptor Decryptor holding the secret key of the ciphertext
+/// \param[in] ckks_encoder Used for decoding
+/// \returns Measurement of the single ciphertext
+NoiseSample measure_noise(const seal::Ciphertext& cipher, size_t batch_size,
+                          const seal::SEALContext& context,
+                          seal::Decryptor& decryptor,
+                          seal::CKKSEncoder& ckks_encoder);
+
+}  // namespace ngraph::runtime::he
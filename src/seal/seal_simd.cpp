@@ -0,0 +1,260 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#include "seal/seal_simd.hpp"
+
+#include <cstdlib>
+#include <string>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "ngraph/except.hpp"
+#include "ngraph/util.hpp"
+
+#if defined(NGRAPH_HE_SIMD_ENABLE) && defined(__x86_64__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define NGRAPH_HE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace ngraph::runtime::he {
+
+namespace {
+
+// Shoup's reduction: with scalar_shoup = floor(scalar * 2^32 / q), the
+// quotient estimate (x * scalar_shoup) >> 32 is off by at most one, so the
+// remainder lies in [0, 2q) and needs one conditional subtraction. Every
+// multiply is 32x32 -> 64 bits, which maps onto (v)pmuludq.
+inline std::uint64_t shoup_precompute(std::uint64_t scalar, std::uint64_t q) {
+  return (scalar << 32U) / q;
+}
+
+void multiply_poly_scalar_scalar(const std::uint64_t* poly, size_t coeff_count,
+                                 std::uint64_t scalar,
+                                 std::uint64_t scalar_shoup, std::uint64_t q,
+                                 std::uint64_t* result) {
+  for (size_t i = 0; i < coeff_count; ++i) {
+    std::uint64_t x = poly[i];
+    std::uint64_t qhat = (x * scalar_shoup) >> 32U;
+    std::uint64_t r = x * scalar - qhat * q;
+    result[i] = r - (q & static_cast<std::uint64_t>(
+                             -static_cast<std::int64_t>(r >= q)));
+  }
+}
+
+void add_poly_scalar_scalar(const std::uint64_t* poly, size_t coeff_count,
+                            std::uint64_t scalar, std::uint64_t q,
+                            std::uint64_t* result) {
+  for (size_t i = 0; i < coeff_count; ++i) {
+    std::uint64_t sum = poly[i] + scalar;
+    result[i] = sum - (q & static_cast<std::uint64_t>(
+                               -static_cast<std::int64_t>(sum >= q)));
+  }
+}
+
+#ifdef NGRAPH_HE_X86_SIMD
+__attribute__((target("avx2"))) void multiply_poly_scalar_avx2(
+    const std::uint64_t* poly, size_t coeff_count, std::uint64_t scalar,
+    std::uint64_t scalar_shoup, std::uint64_t q, std::uint64_t* result) {
+  const __m256i v_scalar = _mm256_set1_epi64x(static_cast<int64_t>(scalar));
+  const __m256i v_shoup =
+      _mm256_set1_epi64x(static_cast<int64_t>(scalar_shoup));
+  const __m256i v_q = _mm256_set1_epi64x(static_cast<int64_t>(q));
+  const __m256i v_q_minus_1 = _mm256_set1_epi64x(static_cast<int64_t>(q - 1));
+
+  size_t i = 0;
+  for (; i + 4 <= coeff_count; i += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(poly + i));
+    __m256i prod = _mm256_mul_epu32(x, v_scalar);
+    __m256i qhat = _mm256_srli_epi64(_mm256_mul_epu32(x, v_shoup), 32);
+    __m256i r = _mm256_sub_epi64(prod, _mm256_mul_epu32(qhat, v_q));
+    // r < 2^32, so the signed comparison is exact
+    __m256i mask = _mm256_cmpgt_epi64(r, v_q_minus_1);
+    r = _mm256_sub_epi64(r, _mm256_and_si256(mask, v_q));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), r);
+  }
+  multiply_poly_scalar_scalar(poly + i, coeff_count - i, scalar, scalar_shoup,
+                              q, result + i);
+}
+
+__attribute__((target("avx512f"))) void multiply_poly_scalar_avx512(
+    const std::uint64_t* poly, size_t coeff_count, std::uint64_t scalar,
+    std::uint64_t scalar_shoup, std::uint64_t q, std::uint64_t* result) {
+  const __m512i v_scalar = _mm512_set1_epi64(static_cast<int64_t>(scalar));
+  const __m512i v_shoup = _mm512_set1_epi64(static_cast<int64_t>(scalar_shoup));
+  const __m512i v_q = _mm512_set1_epi64(static_cast<int64_t>(q));
+
+  size_t i = 0;
+  for (; i + 8 <= coeff_count; i += 8) {
+    __m512i x = _mm512_loadu_si512(poly + i);
+    __m512i prod = _mm512_mul_epu32(x, v_scalar);
+    __m512i qhat = _mm512_srli_epi64(_mm512_mul_epu32(x, v_shoup), 32);
+    __m512i r = _mm512_sub_epi64(prod, _mm512_mul_epu32(qhat, v_q));
+    __mmask8 mask = _mm512_cmpge_epu64_mask(r, v_q);
+    r = _mm512_mask_sub_epi64(r, mask, r, v_q);
+    _mm512_storeu_si512(result + i, r);
+  }
+  multiply_poly_scalar_scalar(poly + i, coeff_count - i, scalar, scalar_shoup,
+                              q, result + i);
+}
+
+__attribute__((target("avx2"))) void add_poly_scalar_avx2(
+    const std::uint64_t* poly, size_t coeff_count, std::uint64_t scalar,
+    std::uint64_t q, std::uint64_t* result) {
+  const __m256i v_scalar = _mm256_set1_epi64x(static_cast<int64_t>(scalar));
+  const __m256i v_q = _mm256_set1_epi64x(static_cast<int64_t>(q));
+  const __m256i v_q_minus_1 = _mm256_set1_epi64x(static_cast<int64_t>(q - 1));
+
+  size_t i = 0;
+  for (; i + 4 <= coeff_count; i += 4) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(poly + i));
+    __m256i sum = _mm256_add_epi64(x, v_scalar);
+    // sum < 2q < 2^63, so the signed comparison is exact
+    __m256i mask = _mm256_cmpgt_epi64(sum, v_q_minus_1);
+    sum = _mm256_sub_epi64(sum, _mm256_and_si256(mask, v_q));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), sum);
+  }
+  add_poly_scalar_scalar(poly + i, coeff_count - i, scalar, q, result + i);
+}
+
+__attribute__((target("avx512f"))) void add_poly_scalar_avx512(
+    const std::uint64_t* poly, size_t coeff_count, std::uint64_t scalar,
+    std::uint64_t q, std::uint64_t* result) {
+  const __m512i v_scalar = _mm512_set1_epi64(static_cast<int64_t>(scalar));
+  const __m512i v_q = _mm512_set1_epi64(static_cast<int64_t>(q));
+
+  size_t i = 0;
+  for (; i + 8 <= coeff_count; i += 8) {
+    __m512i x = _mm512_loadu_si512(poly + i);
+    __m512i sum = _mm512_add_epi64(x, v_scalar);
+    __mmask8 mask = _mm512_cmpge_epu64_mask(sum, v_q);
+    sum = _mm512_mask_sub_epi64(sum, mask, sum, v_q);
+    _mm512_storeu_si512(result + i, sum);
+  }
+  add_poly_scalar_scalar(poly + i, coeff_count - i, scalar, q, result + i);
+}
+#endif
+
+SimdLevel parse_simd_level(const char* flag, SimdLevel default_level) {
+  if (flag == nullptr) {
+    return default_level;
+  }
+  std::string level = to_lower(std::string(flag));
+  if (level == "scalar") {
+    return SimdLevel::Scalar;
+  }
+  if (level == "avx2") {
+    return SimdLevel::AVX2;
+  }
+  if (level == "avx512") {
+    return SimdLevel::AVX512;
+  }
+  throw ngraph_error("Unknown NGRAPH_HE_SIMD value " + std::string(flag));
+}
+
+}  // namespace
+
+SimdLevel cpu_simd_level() {
+#ifdef NGRAPH_HE_X86_SIMD
+  if (__builtin_cpu_supports("avx512f")) {
+    return SimdLevel::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::AVX2;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+SimdLevel simd_level() {
+  static const SimdLevel level = [] {
+    SimdLevel cpu_level = cpu_simd_level();
+    SimdLevel requested =
+        parse_simd_level(std::getenv("NGRAPH_HE_SIMD"), cpu_level);
+    if (static_cast<int>(requested) > static_cast<int>(cpu_level)) {
+      NGRAPH_WARN << "Requested SIMD level " << simd_level_name(requested)
+                  << " is not supported; using "
+                  << simd_level_name(cpu_level);
+      requested = cpu_level;
+    }
+    NGRAPH_HE_LOG(3) << "Using SIMD level " << simd_level_name(requested);
+    return requested;
+  }();
+  return level;
+}
+
+std::string simd_level_name(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::Scalar:
+      return "scalar";
+    case SimdLevel::AVX2:
+      return "avx2";
+    case SimdLevel::AVX512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+void multiply_poly_scalar_coeffmod_simd(const std::uint64_t* poly,
+                                        size_t coeff_count,
+                                        std::uint64_t scalar,
+                                        const seal::Modulus& modulus,
+                                        std::uint64_t* result,
+                                        SimdLevel level) {
+  const std::uint64_t q = modulus.value();
+  NGRAPH_CHECK(q < (1UL << 31U), "Modulus ", q, " too large for Shoup kernel");
+  NGRAPH_CHECK(scalar < q, "Scalar ", scalar, " not reduced modulo ", q);
+  const std::uint64_t scalar_shoup = shoup_precompute(scalar, q);
+
+  switch (level) {
+#ifdef NGRAPH_HE_X86_SIMD
+    case SimdLevel::AVX512:
+      multiply_poly_scalar_avx512(poly, coeff_count, scalar, scalar_shoup, q,
+                                  result);
+      return;
+    case SimdLevel::AVX2:
+      multiply_poly_scalar_avx2(poly, coeff_count, scalar, scalar_shoup, q,
+                                result);
+      return;
+#endif
+    default:
+      multiply_poly_scalar_scalar(poly, coeff_count, scalar, scalar_shoup, q,
+                                  result);
+  }
+}
+
+void add_poly_scalar_coeffmod_simd(const std::uint64_t* poly,
+                                   size_t coeff_count, std::uint64_t scalar,
+                                   const seal::Modulus& modulus,
+                                   std::uint64_t* result, SimdLevel level) {
+  const std::uint64_t q = modulus.value();
+  NGRAPH_CHECK(q < (1UL << 63U), "Modulus ", q, " too large");
+  NGRAPH_CHECK(scalar < q, "Scalar ", scalar, " not reduced modulo ", q);
+
+  switch (level) {
+#ifdef NGRAPH_HE_X86_SIMD
+    case SimdLevel::AVX512:
+      add_poly_scalar_avx512(poly, coeff_count, scalar, q, result);
+      return;
+    case SimdLevel::AVX2:
+      add_poly_scalar_avx2(poly, coeff_count, scalar, q, result);
+      return;
+#endif
+    default:
+      add_poly_scalar_scalar(poly, coeff_count, scalar, q, result);
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,72 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Instruction set used by the vectorized polynomial kernels
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+/// \brief Returns the instruction set used by the vectorized kernels. This is
+/// the widest instruction set supported by the CPU, unless overridden by the
+/// NGRAPH_HE_SIMD environment variable, which may be set to "scalar", "avx2",
+/// or "avx512". The value is detected once
+SimdLevel simd_level();
+
+/// \brief Returns a human-readable name of a SIMD level
+std::string simd_level_name(SimdLevel level);
+
+/// \brief Returns the widest instruction set supported by the CPU, ignoring
+/// NGRAPH_HE_SIMD
+SimdLevel cpu_simd_level();
+
+/// \brief Multiplies each coefficient of a polynomial by a scalar, modulo
+/// modulus, using Shoup's precomputed-quotient reduction. Requires modulus,
+/// scalar, and each coefficient to be < 2^31
+/// \param[in] poly Polynomial to be multiplied
+/// \param[in] coeff_count Number of terms in the polynomial
+/// \param[in] scalar Value with which to multiply
+/// \param[in] modulus Modulus with which to reduce each product
+/// \param[out] result Stores the result. May alias poly
+/// \param[in] level Instruction set to use
+void multiply_poly_scalar_coeffmod_simd(const std::uint64_t* poly,
+                                        size_t coeff_count,
+                                        std::uint64_t scalar,
+                                        const seal::Modulus& modulus,
+                                        std::uint64_t* result,
+                                        SimdLevel level = simd_level());
+
+/// \brief Adds a scalar to each coefficient of a polynomial, modulo modulus.
+/// Requires modulus < 2^63, and scalar and each coefficient to be < modulus
+/// \param[in] poly Polynomial to be added to
+/// \param[in] coeff_count Number of terms in the polynomial
+/// \param[in] scalar Value to add
+/// \param[in] modulus Modulus with which to reduce each sum
+/// \param[out] result Stores the result. May alias poly
+/// \param[in] level Instruction set to use
+void add_poly_scalar_coeffmod_simd(const std::uint64_t* poly,
+                                   size_t coeff_count, std::uint64_t scalar,
+                                   const seal::Modulus& modulus,
+                                   std::uint64_t* result,
+                                   SimdLevel level = simd_level());
+
+}  // namespace ngraph::runtime::he
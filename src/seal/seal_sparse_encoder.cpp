@@ -0,0 +1,246 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_sparse_encoder.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+#include "seal/util/ntt.h"
+#include "seal/util/rns.h"
+#include "seal/util/uintarithsmallmod.h"
+#include "seal/util/uintcore.h"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::shared_mutex s_encoders_mutex;
+std::unordered_map<const seal::CKKSEncoder*, SealSparseEncoder*> s_encoders;
+// Lets encoding skip the lookup while no sparse encoder exists
+std::atomic<size_t> s_num_encoders{0};
+
+/// \brief Returns the exponents 3^j mod (4 sparse_slots) of the roots of
+/// unity at which slot j of the subring is evaluated
+std::vector<size_t> slot_exponents(size_t sparse_slots) {
+  std::vector<size_t> exponents(sparse_slots);
+  size_t order = 4 * sparse_slots;
+  size_t exponent = 1;
+  for (size_t j = 0; j < sparse_slots; ++j) {
+    exponents[j] = exponent;
+    exponent = (3 * exponent) % order;
+  }
+  return exponents;
+}
+}  // namespace
+
+SealSparseEncoder::SealSparseEncoder(
+    std::shared_ptr<seal::SEALContext> context,
+    std::shared_ptr<seal::CKKSEncoder> ckks_encoder)
+    : m_context(std::move(context)), m_ckks_encoder(std::move(ckks_encoder)) {
+  NGRAPH_CHECK(m_ckks_encoder != nullptr,
+               "Sparse encoder requires a CKKS encoder");
+  size_t slot_count = m_ckks_encoder->slot_count();
+  // Slot j stores value j mod n only for n >= 2, since 3 = -1 mod 4
+  m_max_sparse_slots = 2;
+  while (4 * m_max_sparse_slots * m_max_sparse_slots <= slot_count) {
+    m_max_sparse_slots *= 2;
+  }
+  size_t order = 4 * m_max_sparse_slots;
+  const double two_pi = 2 * std::acos(-1.0);
+  m_roots.resize(order);
+  for (size_t t = 0; t < order; ++t) {
+    m_roots[t] = std::polar(1.0, two_pi * static_cast<double>(t) /
+                                     static_cast<double>(order));
+  }
+  {
+    std::unique_lock<std::shared_mutex> lock(s_encoders_mutex);
+    NGRAPH_CHECK(s_encoders.emplace(m_ckks_encoder.get(), this).second,
+                 "CKKS encoder already has a sparse encoder");
+    ++s_num_encoders;
+  }
+  NGRAPH_HE_LOG(3) << "Created sparse encoder of up to " << m_max_sparse_slots
+                   << " slots";
+}
+
+SealSparseEncoder::~SealSparseEncoder() {
+  std::unique_lock<std::shared_mutex> lock(s_encoders_mutex);
+  s_encoders.erase(m_ckks_encoder.get());
+  --s_num_encoders;
+}
+
+size_t SealSparseEncoder::sparse_slot_count(size_t num_values) const {
+  size_t sparse_slots = 2;
+  while (sparse_slots < num_values) {
+    sparse_slots *= 2;
+  }
+  if (sparse_slots > m_max_sparse_slots ||
+      2 * sparse_slots > m_ckks_encoder->slot_count()) {
+    return 0;
+  }
+  return sparse_slots;
+}
+
+void SealSparseEncoder::encode(const std::vector<std::complex<double>>& values,
+                               size_t sparse_slots,
+                               seal::parms_id_type parms_id, double scale,
+                               seal::Plaintext& destination) const {
+  NGRAPH_CHECK(values.size() <= sparse_slots, "Cannot encode ", values.size(),
+               " values into ", sparse_slots, " sparse slots");
+  auto context_data = m_context->get_context_data(parms_id);
+  NGRAPH_CHECK(context_data != nullptr,
+               "parms_id is not valid for encryption parameters");
+  const auto& parms = context_data->parms();
+  const auto& coeff_modulus = parms.coeff_modulus();
+  size_t coeff_mod_count = coeff_modulus.size();
+  size_t coeff_count = parms.poly_modulus_degree();
+  NGRAPH_CHECK(scale > 0 && std::log2(scale) + 1 <
+                                context_data->total_coeff_modulus_bit_count(),
+               "Scale ", scale, " out of bounds");
+
+  // Coefficient k of the subring polynomial is Re(sum_j z_j w^(-e_j k)) / n,
+  // for w the primitive (4n)-th root of unity and e_j the slot exponents
+  size_t num_coeffs = 2 * sparse_slots;
+  std::vector<size_t> exponents = slot_exponents(sparse_slots);
+  std::vector<int64_t> coeffs(num_coeffs);
+  const double max_coeff = std::ldexp(1.0, 62);
+  for (size_t k = 0; k < num_coeffs; ++k) {
+    double coeff = 0;
+    for (size_t j = 0; j < values.size(); ++j) {
+      coeff += (values[j] * std::conj(root(sparse_slots, exponents[j] * k)))
+                   .real();
+    }
+    coeff = std::round(coeff * scale / static_cast<double>(sparse_slots));
+    if (std::fabs(coeff) >= max_coeff) {
+      // Encodes the replicated values with the full encoder instead
+      NGRAPH_HE_LOG(5) << "Sparse coefficient too large, using full encoder";
+      std::vector<std::complex<double>> replicated(
+          m_ckks_encoder->slot_count());
+      for (size_t slot = 0; slot < replicated.size(); ++slot) {
+        size_t j = slot % sparse_slots;
+        replicated[slot] = j < values.size() ? values[j] : 0;
+      }
+      m_ckks_encoder->encode(replicated, parms_id, scale, destination);
+      return;
+    }
+    coeffs[k] = static_cast<int64_t>(coeff);
+  }
+
+  // Coefficient k of the subring is coefficient k N / (2n) of the ring
+  size_t coeff_stride = coeff_count / num_coeffs;
+  destination.parms_id() = seal::parms_id_zero;
+  destination.resize(coeff_count * coeff_mod_count);
+  std::fill_n(destination.data(), coeff_count * coeff_mod_count, 0);
+  const seal::util::NTTTables* ntt_tables = context_data->small_ntt_tables();
+  for (size_t i = 0; i < coeff_mod_count; ++i) {
+    uint64_t* component = destination.data() + i * coeff_count;
+    for (size_t k = 0; k < num_coeffs; ++k) {
+      auto magnitude = static_cast<uint64_t>(std::llabs(coeffs[k]));
+      uint64_t reduced =
+          seal::util::barrett_reduce_64(magnitude, coeff_modulus[i]);
+      component[k * coeff_stride] =
+          coeffs[k] < 0 ? seal::util::negate_uint_mod(reduced, coeff_modulus[i])
+                        : reduced;
+    }
+    seal::util::ntt_negacyclic_harvey(seal::util::CoeffIter(component),
+                                      ntt_tables[i]);
+  }
+  destination.parms_id() = parms_id;
+  destination.scale() = scale;
+}
+
+void SealSparseEncoder::decode(
+    const seal::Plaintext& plain, size_t sparse_slots,
+    std::vector<std::complex<double>>& destination) const {
+  NGRAPH_CHECK(plain.is_ntt_form(), "Plaintext is not in NTT form");
+  auto context_data = m_context->get_context_data(plain.parms_id());
+  NGRAPH_CHECK(context_data != nullptr,
+               "Plaintext is not valid for encryption parameters");
+  const auto& parms = context_data->parms();
+  size_t coeff_mod_count = parms.coeff_modulus().size();
+  size_t coeff_count = parms.poly_modulus_degree();
+  size_t num_coeffs = 2 * sparse_slots;
+  size_t coeff_stride = coeff_count / num_coeffs;
+
+  // Only the subring coefficients are composed from their RNS components
+  std::vector<uint64_t> components(
+      plain.data(), plain.data() + coeff_count * coeff_mod_count);
+  const seal::util::NTTTables* ntt_tables = context_data->small_ntt_tables();
+  for (size_t i = 0; i < coeff_mod_count; ++i) {
+    seal::util::inverse_ntt_negacyclic_harvey(
+        seal::util::CoeffIter(components.data() + i * coeff_count),
+        ntt_tables[i]);
+  }
+
+  const uint64_t* upper_half_threshold = context_data->upper_half_threshold();
+  const uint64_t* total_modulus = context_data->total_coeff_modulus();
+  const double two_pow_64 = std::ldexp(1.0, 64);
+  const double inv_scale = 1.0 / plain.scale();
+  auto pool = seal::MemoryManager::GetPool();
+  std::vector<uint64_t> coeff(coeff_mod_count);
+  std::vector<double> coeffs(num_coeffs);
+  for (size_t k = 0; k < num_coeffs; ++k) {
+    for (size_t i = 0; i < coeff_mod_count; ++i) {
+      coeff[i] = components[i * coeff_count + k * coeff_stride];
+    }
+    context_data->rns_tool()->base_q()->compose(coeff.data(), pool);
+
+    // Values at least half the modulus are negative
+    double value = 0;
+    double word_scale = inv_scale;
+    if (seal::util::is_greater_than_or_equal_uint(
+            coeff.data(), upper_half_threshold, coeff_mod_count)) {
+      for (size_t i = 0; i < coeff_mod_count; ++i, word_scale *= two_pow_64) {
+        if (coeff[i] > total_modulus[i]) {
+          value += static_cast<double>(coeff[i] - total_modulus[i]) *
+                   word_scale;
+        } else {
+          value -= static_cast<double>(total_modulus[i] - coeff[i]) *
+                   word_scale;
+        }
+      }
+    } else {
+      for (size_t i = 0; i < coeff_mod_count; ++i, word_scale *= two_pow_64) {
+        value += static_cast<double>(coeff[i]) * word_scale;
+      }
+    }
+    coeffs[k] = value;
+  }
+
+  std::vector<size_t> exponents = slot_exponents(sparse_slots);
+  destination.assign(sparse_slots, 0);
+  for (size_t j = 0; j < sparse_slots; ++j) {
+    for (size_t k = 0; k < num_coeffs; ++k) {
+      destination[j] += coeffs[k] * root(sparse_slots, exponents[j] * k);
+    }
+  }
+}
+
+const SealSparseEncoder* SealSparseEncoder::find(
+    const seal::CKKSEncoder& ckks_encoder) {
+  if (s_num_encoders == 0) {
+    return nullptr;
+  }
+  std::shared_lock<std::shared_mutex> lock(s_encoders_mutex);
+  auto it = s_encoders.find(&ckks_encoder);
+  return it == s_encoders.end() ? nullptr : it->second;
+}
+
+}  // namespace ngraph::runtime::he
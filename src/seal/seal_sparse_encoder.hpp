@@ -0,0 +1,97 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief CKKS encoder of few values into the subring of polynomials in
+/// X^(N / (2n)), for N the polynomial modulus degree and n a power of two
+/// at least the number of values. Slot j of such a polynomial stores value
+/// j mod n, i.e. the values are replicated every n slots, so the full
+/// CKKSEncoder decodes them as usual. Encoding and decoding transform the 2n
+/// coefficients of the subring instead of all N coefficients; decoding
+/// averages each value over its replicas. While an encoder exists,
+/// encrypt_strided(), encode(), decrypt_strided() and decode() use it for
+/// its CKKSEncoder. All methods are thread-safe.
+class SealSparseEncoder {
+ public:
+  /// \brief Creates a sparse encoder
+  /// \param[in] context Context of the CKKS encoder
+  /// \param[in] ckks_encoder CKKS encoder whose encodings are replaced. Each
+  /// sparse encoder must have a distinct CKKS encoder
+  SealSparseEncoder(std::shared_ptr<seal::SEALContext> context,
+                    std::shared_ptr<seal::CKKSEncoder> ckks_encoder);
+
+  ~SealSparseEncoder();
+
+  SealSparseEncoder(const SealSparseEncoder&) = delete;
+  SealSparseEncoder& operator=(const SealSparseEncoder&) = delete;
+
+  /// \brief Returns the number of slots n of the subring storing a number of
+  /// values, or 0 if the full encoding is cheaper. Since the subring
+  /// transforms take O(n^2) operations, n is at most the square root of the
+  /// slot count
+  /// \param[in] num_values Number of complex slot values, at least 1
+  size_t sparse_slot_count(size_t num_values) const;
+
+  /// \brief Encodes values into the subring with sparse_slot_count slots
+  /// \param[in] values Values to encode, at most sparse_slots
+  /// \param[in] sparse_slots Number of slots of the subring, as returned by
+  /// sparse_slot_count
+  /// \param[in] parms_id Seal parameter id to use in encoding
+  /// \param[in] scale Scale at which to encode the values
+  /// \param[out] destination Encoded values, in NTT form
+  void encode(const std::vector<std::complex<double>>& values,
+              size_t sparse_slots, seal::parms_id_type parms_id, double scale,
+              seal::Plaintext& destination) const;
+
+  /// \brief Decodes values replicated every sparse_slots slots
+  /// \param[in] plain Plaintext to decode, in NTT form
+  /// \param[in] sparse_slots Number of slots of the subring, as returned by
+  /// sparse_slot_count
+  /// \param[out] destination Stores the sparse_slots decoded values
+  void decode(const seal::Plaintext& plain, size_t sparse_slots,
+              std::vector<std::complex<double>>& destination) const;
+
+  /// \brief Returns the sparse encoder of a CKKS encoder, or nullptr if it
+  /// has none
+  /// \param[in] ckks_encoder CKKS encoder
+  static const SealSparseEncoder* find(const seal::CKKSEncoder& ckks_encoder);
+
+ private:
+  /// \brief Returns the primitive (4 sparse_slots)-th root of unity raised
+  /// to the power exponent
+  std::complex<double> root(size_t sparse_slots, size_t exponent) const {
+    size_t order = 4 * sparse_slots;
+    return m_roots[(exponent % order) * (m_roots.size() / order)];
+  }
+
+  std::shared_ptr<seal::SEALContext> m_context;
+  std::shared_ptr<seal::CKKSEncoder> m_ckks_encoder;
+  size_t m_max_sparse_slots;
+  // Powers of the primitive (4 m_max_sparse_slots)-th root of unity
+  std::vector<std::complex<double>> m_roots;
+};
+
+}  // namespace ngraph::runtime::he
@@ -18,22 +18,48 @@
 
 #include "seal/seal_util.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
 #include <limits>
+#include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #ifdef NGRAPH_HE_ABY_ENABLE
 #include "aby/aby_util.hpp"
 #endif
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/runtime/tensor.hpp"
+#include "seal/he_primitive_counter.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
 #include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_simd.hpp"
+#include "seal/seal_sparse_encoder.hpp"
+#include "seal/seal_zero_pool.hpp"
+#include "seal/util/galois.h"
+#include "seal/util/hash.h"
+#include "seal/util/ntt.h"
 #include "seal/util/polyarithsmallmod.h"
 #include "seal/util/uintarith.h"
+#include "seal/util/uintarithsmallmod.h"
 
 namespace ngraph::runtime::he {
 
+namespace {
+/// \brief Returns a buffer of the calling thread for the CRT form of one
+/// scalar. encode() resizes it, so kernels which encode a scalar per term do
+/// not allocate once the buffer has grown to the modulus count
+std::vector<std::uint64_t>& scalar_encoding_scratch() {
+  thread_local std::vector<std::uint64_t> scratch;
+  return scratch;
+}
+}  // namespace
+
 seal::sec_level_type seal_security_level(size_t bits) {
   if (bits == 0) {
     NGRAPH_WARN
@@ -52,6 +78,25 @@ seal::sec_level_type seal_security_level(size_t bits) {
   throw ngraph_error("Invalid security level " + std::to_string(bits));
 }
 
+std::string key_fingerprint(const std::string& serialized_key) {
+  // Pad to whole words; the length is hashed too, so padding is unambiguous
+  std::vector<std::uint64_t> words(
+      1 + (serialized_key.size() + sizeof(std::uint64_t) - 1) /
+              sizeof(std::uint64_t),
+      0);
+  words[0] = serialized_key.size();
+  std::memcpy(words.data() + 1, serialized_key.data(), serialized_key.size());
+
+  seal::util::HashFunction::hash_block_type hash;
+  seal::util::HashFunction::hash(words.data(), words.size(), hash);
+
+  std::stringstream ss;
+  for (std::uint64_t word : hash) {
+    ss << std::hex << std::setw(16) << std::setfill('0') << word;
+  }
+  return ss.str();
+}
+
 void match_modulus_and_scale_inplace(SealCiphertextWrapper& arg0,
                                      SealCiphertextWrapper& arg1,
                                      const HESealBackend& he_seal_backend,
@@ -82,11 +127,46 @@ void match_modulus_and_scale_inplace(SealCiphertextWrapper& arg0,
   match_scale(arg0, arg1);
 }
 
+double rescale_divisor(const seal::SEALContext::ContextData& context_data,
+                       size_t rescale_primes) {
+  const auto& coeff_modulus = context_data.parms().coeff_modulus();
+  double divisor = 1;
+  for (size_t i = 0; i < std::min(rescale_primes, coeff_modulus.size());
+       ++i) {
+    divisor *= static_cast<double>(
+        coeff_modulus[coeff_modulus.size() - 1 - i].value());
+  }
+  return divisor;
+}
+
+void rescale_inplace(seal::Ciphertext& encrypted, seal::Evaluator& evaluator,
+                     size_t rescale_primes,
+                     const seal::MemoryPoolHandle& pool) {
+  for (size_t i = 0; i < rescale_primes; ++i) {
+    evaluator.rescale_to_next_inplace(encrypted, pool);
+  }
+}
+
+void relinearize_inplace(SealCiphertextWrapper& arg,
+                         const HESealBackend& he_seal_backend,
+                         const seal::MemoryPoolHandle& pool) {
+  if (arg.is_relinearized()) {
+    return;
+  }
+  HEPrimitiveCounter::increment(HEPrimitive::relinearize);
+  he_seal_backend.get_evaluator()->relinearize_inplace(
+      arg.ciphertext(), *he_seal_backend.get_relin_keys(), pool);
+}
+
 void add_poly_scalar_coeffmod(seal::util::ConstCoeffIter poly, size_t coeff_count,
                                      std::uint64_t scalar,
                                      const seal::Modulus& modulus,
                                      seal::util::CoeffIter result) {  
-  
+  if (simd_level() != SimdLevel::Scalar && coeff_count > 0) {
+    add_poly_scalar_coeffmod_simd(&*poly, coeff_count, scalar, modulus,
+                                  &*result);
+    return;
+  }
   seal::util::add_poly_scalar_coeffmod(poly, coeff_count, scalar, modulus, result);
 }
 
@@ -118,7 +198,7 @@ void add_plain_inplace(seal::Ciphertext& encrypted, double value,
   NGRAPH_CHECK(encrypted.data() != nullptr, "Encrypted data == nullptr");
 
   // Encode
-  std::vector<std::uint64_t> values(coeff_mod_count, 0);
+  auto& values = scalar_encoding_scratch();
   /*seal::Plaintext plaintext_vals(coeff_count);*/
   double scale = encrypted.scale();
   encode(value, element::f32, scale, encrypted.parms_id(), values,
@@ -131,12 +211,14 @@ void add_plain_inplace(seal::Ciphertext& encrypted, double value,
   seal::util::ConstRNSIter plain_iter(plaintext_vals.data(), coeff_count);
   seal::util::add_poly_coeffmod(encrypted_iter, plain_iter, coeff_modulus_size, coeff_modulus, encrypted_iter);*/
 
-  for (size_t j = 0; j < coeff_mod_count; j++) {
-    // Add poly scalar instead of poly poly (Old version)
-    add_poly_scalar_coeffmod(encrypted.data() + (j * coeff_count), coeff_count,
-                             values[j], coeff_modulus[j],
-                             encrypted.data() + (j * coeff_count));
-  }
+  // Add poly scalar instead of poly poly (Old version)
+  parallel_for_limbs_seal(
+      1, coeff_mod_count, coeff_count,
+      [&](size_t /* poly */, size_t j, size_t begin, size_t end) {
+        std::uint64_t* limb = encrypted.data() + j * coeff_count + begin;
+        add_poly_scalar_coeffmod(limb, end - begin, values[j],
+                                 coeff_modulus[j], limb);
+      });
   
 
 #ifndef SEAL_ALLOW_TRANSPARENT_CIPHERTEXT
@@ -153,6 +235,7 @@ void multiply_plain_lazy_mod(const seal::Ciphertext& encrypted, double value,
                              const HESealBackend& he_seal_backend,
                              seal::MemoryPoolHandle pool) {
   // destination = encrypted;
+  HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
   auto context = he_seal_backend.get_context();
 
   // Extract encryption parameters.
@@ -168,25 +251,25 @@ void multiply_plain_lazy_mod(const seal::Ciphertext& encrypted, double value,
   destination.resize(encrypted.size());
   destination.is_ntt_form() = encrypted.is_ntt_form();
 
-  std::vector<std::uint64_t> plaintext_vals(coeff_mod_count, 0);
-  double scale = encrypted.scale();
-  double new_scale = scale * scale;
+  auto& plaintext_vals = scalar_encoding_scratch();
+  double scale =
+      he_seal_backend.multiplicand_scale(encrypted.parms_id(),
+                                         encrypted.scale());
+  double new_scale = encrypted.scale() * scale;
   encode(value, element::f32, scale, encrypted.parms_id(), plaintext_vals,
          he_seal_backend);
-  std::uint64_t* src = const_cast<std::uint64_t*>(encrypted.data());
-  std::uint64_t* dest = destination.data();
-
-  for (size_t i = 0; i < encrypted_ntt_size; i++) {
-    for (size_t j = 0; j < coeff_mod_count; j++) {
-      std::uint64_t scalar = plaintext_vals[j];
+  parallel_for_limbs_seal(
+      encrypted_ntt_size, coeff_mod_count, coeff_count,
+      [&](size_t i, size_t j, size_t begin, size_t end) {
+        const std::uint64_t* src =
+            encrypted.data(i) + j * coeff_count + begin;
+        std::uint64_t* dest = destination.data(i) + j * coeff_count + begin;
+        std::uint64_t scalar = plaintext_vals[j];
 #pragma omp simd //Lazy mod?
-      for (size_t k = 0; k < coeff_count; k++) {
-        *dest = *src * scalar;
-        ++src;
-        ++dest;
-      }
-    }
-  }
+        for (size_t k = 0; k < end - begin; k++) {
+          dest[k] = src[k] * scalar;
+        }
+      });
   // Set the scale
   destination.scale() = new_scale;//That easy?
 }
@@ -207,6 +290,7 @@ void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
   if (!pool) {
     throw ngraph_error("pool is uninitialized");
   }
+  HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
 
   // Extract encryption parameters.
   auto& context_data = *context->get_context_data(encrypted.parms_id());
@@ -221,14 +305,16 @@ void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
                                            coeff_mod_count),
                "invalid parameters");
 
-  std::vector<std::uint64_t> plaintext_vals(coeff_mod_count, 0);
-  double scale = encrypted.scale();
+  auto& plaintext_vals = scalar_encoding_scratch();
+  double scale =
+      he_seal_backend.multiplicand_scale(encrypted.parms_id(),
+                                         encrypted.scale());
   encode(value, element::f32, scale, encrypted.parms_id(), plaintext_vals,
          he_seal_backend);
   /*seal::Plaintext plaintext_vals(coeff_count);
   seal::CKKSEncoder encoder(*he_seal_backend.get_context());
   encoder.encode(value, scale, plaintext_vals);*/
-  double new_scale = scale * scale;
+  double new_scale = encrypted.scale() * scale;
 
   // Check that scale is positive and not too large
   if (new_scale <= 0 || (static_cast<int>(log2(new_scale)) >=
@@ -239,22 +325,19 @@ void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
                << context_data.total_coeff_modulus_bit_count();
     throw ngraph_error("scale out of bounds");
   }
-  for (size_t i = 0; i < encrypted_ntt_size; i++) {
-    for (size_t j = 0; j < coeff_mod_count; j++) {
-      // Multiply by scalar instead of doing dyadic product
-      if (coeff_modulus[j].value() < (1UL << 31U)) {
-        multiply_poly_scalar_coeffmod64(encrypted.data(i) + (j * coeff_count),
-                                        coeff_count, plaintext_vals[j],
-                                        coeff_modulus[j],
-                                        encrypted.data(i) + (j * coeff_count));
-      } else {
-        seal::util::multiply_poly_scalar_coeffmod(
-            encrypted.data(i) + (j * coeff_count), coeff_count,
-            plaintext_vals[j], coeff_modulus[j],
-            encrypted.data(i) + (j * coeff_count));
-      }
-    }
-  }
+  parallel_for_limbs_seal(
+      encrypted_ntt_size, coeff_mod_count, coeff_count,
+      [&](size_t i, size_t j, size_t begin, size_t end) {
+        std::uint64_t* limb = encrypted.data(i) + j * coeff_count + begin;
+        // Multiply by scalar instead of doing dyadic product
+        if (coeff_modulus[j].value() < (1UL << 31U)) {
+          multiply_poly_scalar_coeffmod64(limb, end - begin, plaintext_vals[j],
+                                          coeff_modulus[j], limb);
+        } else {
+          seal::util::multiply_poly_scalar_coeffmod(
+              limb, end - begin, plaintext_vals[j], coeff_modulus[j], limb);
+        }
+      });
   
   //TODO: might be revised later.
 
@@ -267,6 +350,117 @@ void multiply_plain_inplace(seal::Ciphertext& encrypted, double value,
   encrypted.scale() = new_scale;
 }
 
+void multiply_plain_accumulate(const seal::Ciphertext& encrypted, double value,
+                               seal::Ciphertext& accumulator,
+                               const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(encrypted.is_ntt_form() && accumulator.is_ntt_form(),
+               "Ciphertexts must be in NTT form");
+  NGRAPH_CHECK(encrypted.parms_id() == accumulator.parms_id(),
+               "Accumulator parms_id does not match");
+  NGRAPH_CHECK(encrypted.size() == accumulator.size(), "Accumulator size ",
+               accumulator.size(), " does not match ciphertext size ",
+               encrypted.size());
+  HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+
+  auto context = he_seal_backend.get_context();
+  auto& context_data = *context->get_context_data(encrypted.parms_id());
+  auto& coeff_modulus = context_data.parms().coeff_modulus();
+  size_t coeff_count = context_data.parms().poly_modulus_degree();
+  size_t coeff_mod_count = coeff_modulus.size();
+
+  double scale =
+      he_seal_backend.multiplicand_scale(encrypted.parms_id(),
+                                         encrypted.scale());
+  double new_scale = encrypted.scale() * scale;
+  NGRAPH_CHECK(new_scale / accumulator.scale() <= 1.05 &&
+                   accumulator.scale() / new_scale <= 1.05,
+               "Product scale ", new_scale,
+               " does not match accumulator scale ", accumulator.scale());
+
+  auto& plaintext_vals = scalar_encoding_scratch();
+  encode(value, element::f32, scale, encrypted.parms_id(), plaintext_vals,
+         he_seal_backend);
+
+  parallel_for_limbs_seal(
+      encrypted.size(), coeff_mod_count, coeff_count,
+      [&](size_t i, size_t j, size_t begin, size_t end) {
+        const seal::Modulus& modulus = coeff_modulus[j];
+        const uint64_t modulus_value = modulus.value();
+        const uint64_t scalar = plaintext_vals[j];
+        const uint64_t* src = encrypted.data(i) + j * coeff_count;
+        uint64_t* acc = accumulator.data(i) + j * coeff_count;
+
+        if (modulus_value < (1UL << 31U)) {
+          // Product fits in 64 bits, so use Barrett base 2^64 reduction
+          const uint64_t const_ratio_1 = modulus.const_ratio()[1];
+          for (size_t k = begin; k < end; ++k) {
+            uint64_t z = src[k] * scalar;
+            // NOLINTNEXTLINE(runtime/int)
+            unsigned long long carry;
+            seal::util::multiply_uint64_hw64(z, const_ratio_1, &carry);
+            carry = z - carry * modulus_value;
+            uint64_t prod =
+                carry - (modulus_value &
+                         static_cast<uint64_t>(
+                             -static_cast<int64_t>(carry >= modulus_value)));
+            uint64_t sum = acc[k] + prod;
+            acc[k] = sum - (modulus_value &
+                            static_cast<uint64_t>(
+                                -static_cast<int64_t>(sum >= modulus_value)));
+          }
+        } else {
+          for (size_t k = begin; k < end; ++k) {
+            acc[k] = seal::util::add_uint_mod(
+                acc[k], seal::util::multiply_uint_mod(src[k], scalar, modulus),
+                modulus);
+          }
+        }
+      });
+}
+
+std::optional<int64_t> quantize_weight(double value, double step) {
+  NGRAPH_CHECK(step > 0, "Quantization step ", step, " must be positive");
+  double ratio = value / step;
+  double rounded = std::round(ratio);
+  if (std::abs(ratio - rounded) > 1e-3 ||
+      std::abs(rounded) > static_cast<double>(s_max_quantized_weight)) {
+    return std::nullopt;
+  }
+  return static_cast<int64_t>(rounded);
+}
+
+void multiply_plain_integer_inplace(seal::Ciphertext& encrypted,
+                                    int64_t value,
+                                    const HESealBackend& he_seal_backend) {
+  NGRAPH_CHECK(encrypted.is_ntt_form(), "encrypted is not NTT form");
+  HEPrimitiveCounter::increment(HEPrimitive::multiply_plain);
+
+  auto context = he_seal_backend.get_context();
+  auto& context_data = *context->get_context_data(encrypted.parms_id());
+  auto& coeff_modulus = context_data.parms().coeff_modulus();
+  size_t coeff_count = context_data.parms().poly_modulus_degree();
+  size_t coeff_mod_count = coeff_modulus.size();
+
+  auto magnitude = static_cast<uint64_t>(value < 0 ? -value : value);
+  parallel_for_limbs_seal(
+      encrypted.size(), coeff_mod_count, coeff_count,
+      [&](size_t i, size_t j, size_t begin, size_t end) {
+        const seal::Modulus& modulus = coeff_modulus[j];
+        uint64_t scalar = magnitude % modulus.value();
+        if (value < 0) {
+          scalar = seal::util::negate_uint_mod(scalar, modulus);
+        }
+        uint64_t* poly = encrypted.data(i) + j * coeff_count + begin;
+        if (modulus.value() < (1UL << 31U)) {
+          multiply_poly_scalar_coeffmod64(poly, end - begin, scalar, modulus,
+                                          poly);
+        } else {
+          seal::util::multiply_poly_scalar_coeffmod(poly, end - begin, scalar,
+                                                    modulus, poly);
+        }
+      });
+}
+
 //Temporarily ignore this
 void multiply_poly_scalar_coeffmod64(const uint64_t* poly, size_t coeff_count,
                                      uint64_t scalar,
@@ -280,6 +474,11 @@ void multiply_poly_scalar_coeffmod64(const uint64_t* poly, size_t coeff_count,
     get<1>(I) = multiply_uint_mod(x, scalar, modulus);
   });
 #endif*/
+  if (simd_level() != SimdLevel::Scalar) {
+    multiply_poly_scalar_coeffmod_simd(poly, coeff_count, scalar, modulus,
+                                       result);
+    return;
+  }
   const uint64_t modulus_value = modulus.value();
   const uint64_t const_ratio_1 = modulus.const_ratio()[1];
 
@@ -303,6 +502,16 @@ void multiply_poly_scalar_coeffmod64(const uint64_t* poly, size_t coeff_count,
   }
 }
 
+seal::parms_id_type parms_id_at_chain_index(
+    const std::shared_ptr<seal::SEALContext>& context, size_t chain_index) {
+  auto context_data = context->first_context_data();
+  while (context_data->chain_index() > chain_index &&
+         context_data->next_context_data() != nullptr) {
+    context_data = context_data->next_context_data();
+  }
+  return context_data->parms_id();
+}
+
 size_t match_to_smallest_chain_index(std::vector<HEType>& he_types,
                                      const HESealBackend& he_seal_backend) {
   size_t num_elements = he_types.size();
@@ -515,10 +724,88 @@ void encode(double value, const element::Type& element_type, double scale,
   }
 }
 
+namespace {
+/// \brief Encodes values with the sparse encoder of a CKKS encoder, if it
+/// has one and the values fit its subring, see SealSparseEncoder
+/// \param[in] values Values to encode. A single value is left to the
+/// encoding of a constant, which fills every slot
+/// \param[in] num_values Number of values
+/// \param[in] complex_packing Whether or not pairs of values are packed
+/// into complex slots
+/// \param[in] ckks_encoder CKKS encoder whose sparse encoder is used
+/// \param[in] parms_id Seal parameter id to use in encoding
+/// \param[in] scale Scale at which to encode the values
+/// \param[out] destination Encoded values
+/// \param[in,out] slots Buffer of the slot values
+/// \returns True if the values were encoded
+bool sparse_encode(const double* values, size_t num_values,
+                   bool complex_packing, const seal::CKKSEncoder& ckks_encoder,
+                   seal::parms_id_type parms_id, double scale,
+                   seal::Plaintext& destination,
+                   std::vector<std::complex<double>>& slots) {
+  const SealSparseEncoder* sparse_encoder =
+      SealSparseEncoder::find(ckks_encoder);
+  if (sparse_encoder == nullptr || num_values <= 1) {
+    return false;
+  }
+  size_t num_slots = complex_packing ? (num_values + 1) / 2 : num_values;
+  size_t sparse_slots = sparse_encoder->sparse_slot_count(num_slots);
+  if (sparse_slots == 0) {
+    return false;
+  }
+  slots.resize(num_slots);
+  for (size_t i = 0; i < num_slots; ++i) {
+    if (complex_packing) {
+      slots[i] = {values[2 * i],
+                  2 * i + 1 < num_values ? values[2 * i + 1] : 0};
+    } else {
+      slots[i] = {values[i], 0};
+    }
+  }
+  sparse_encoder->encode(slots, sparse_slots, parms_id, scale, destination);
+  return true;
+}
+
+/// \brief Decodes values encoded by sparse_encode
+/// \param[in] plain Plaintext to decode
+/// \param[in] num_values Number of values to decode
+/// \param[in] complex_packing Whether or not pairs of values are packed
+/// into complex slots
+/// \param[in] ckks_encoder CKKS encoder whose sparse encoder is used
+/// \param[out] values Stores the decoded values
+/// \param[in,out] slots Buffer of the slot values
+/// \returns True if sparse_encode would have encoded the values, in which
+/// case they were decoded
+bool sparse_decode(const seal::Plaintext& plain, size_t num_values,
+                   bool complex_packing, const seal::CKKSEncoder& ckks_encoder,
+                   std::vector<double>& values,
+                   std::vector<std::complex<double>>& slots) {
+  const SealSparseEncoder* sparse_encoder =
+      SealSparseEncoder::find(ckks_encoder);
+  if (sparse_encoder == nullptr || num_values <= 1) {
+    return false;
+  }
+  size_t num_slots = complex_packing ? (num_values + 1) / 2 : num_values;
+  size_t sparse_slots = sparse_encoder->sparse_slot_count(num_slots);
+  if (sparse_slots == 0) {
+    return false;
+  }
+  sparse_encoder->decode(plain, sparse_slots, slots);
+  values.resize(num_values);
+  for (size_t i = 0; i < num_values; ++i) {
+    values[i] = !complex_packing ? slots[i].real()
+                : i % 2 == 0     ? slots[i / 2].real()
+                                 : slots[i / 2].imag();
+  }
+  return true;
+}
+}  // namespace
+
 void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
             seal::CKKSEncoder& ckks_encoder, seal::parms_id_type parms_id,
             const element::Type& element_type, double scale,
             bool complex_packing) {
+  HEPrimitiveCounter::increment(HEPrimitive::encode);
   const size_t slot_count = ckks_encoder.slot_count();
 
   switch (element_type.get_type_enum()) {
@@ -526,6 +813,12 @@ void encode(SealPlaintextWrapper& destination, const HEPlaintext& plaintext,
     case element::Type_t::i64:
     case element::Type_t::f32:
     case element::Type_t::f64: {
+      std::vector<std::complex<double>> slots;
+      if (sparse_encode(plaintext.data(), plaintext.size(), complex_packing,
+                        ckks_encoder, parms_id, scale,
+                        destination.plaintext(), slots)) {
+        break;
+      }
       if (complex_packing) {
         std::vector<std::complex<double>> complex_vals;
         if (plaintext.size() == 1) {
@@ -580,13 +873,94 @@ void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
 
   encode(plaintext, input, ckks_encoder, parms_id, element_type, scale,
          complex_packing);
-  encryptor.encrypt(plaintext.plaintext(), output->ciphertext());
+  HEPrimitiveCounter::increment(HEPrimitive::encrypt);
+  if (!SealZeroPool::encrypt(encryptor, plaintext.plaintext(),
+                             output->ciphertext())) {
+    encryptor.encrypt(plaintext.plaintext(), output->ciphertext());
+  }
+}
+
+void encrypt_strided(seal::Ciphertext& destination, const void* source,
+                     size_t stride, size_t num_values,
+                     const element::Type& element_type,
+                     seal::parms_id_type parms_id, double scale,
+                     seal::CKKSEncoder& ckks_encoder,
+                     const seal::Encryptor& encryptor, bool complex_packing,
+                     HECodecScratch& scratch) {
+  NGRAPH_CHECK(element_type == element::i32 || element_type == element::i64 ||
+                   element_type == element::f32 ||
+                   element_type == element::f64,
+               "Unsupported type ", element_type);
+  const size_t slot_count = ckks_encoder.slot_count();
+  NGRAPH_CHECK(num_values <= (complex_packing ? 2 : 1) * slot_count,
+               "Cannot encode ", num_values, " elements, maximum size is ",
+               slot_count);
+  scratch.values.resize(num_values);
+  strided_to_doubles(source, stride, num_values, element_type,
+                     scratch.values.data());
+  const auto& values = scratch.values;
+
+  HEPrimitiveCounter::increment(HEPrimitive::encode);
+  if (sparse_encode(values.data(), num_values, complex_packing, ckks_encoder,
+                    parms_id, scale, scratch.plaintext,
+                    scratch.complex_values)) {
+    // Encoded into the subring of the sparse encoder
+  } else if (complex_packing) {
+    size_t num_slots = (num_values + 1) / 2;
+    if (num_values == 1) {
+      scratch.complex_values.assign(slot_count, {values[0], values[0]});
+    } else {
+      scratch.complex_values.resize(num_slots);
+      for (size_t i = 0; i < num_slots; ++i) {
+        scratch.complex_values[i] = {
+            values[2 * i], 2 * i + 1 < num_values ? values[2 * i + 1] : 0};
+      }
+    }
+    ckks_encoder.encode(scratch.complex_values, parms_id, scale,
+                        scratch.plaintext);
+  } else if (num_values == 1) {
+    ckks_encoder.encode(values[0], parms_id, scale, scratch.plaintext);
+  } else {
+    ckks_encoder.encode(values, parms_id, scale, scratch.plaintext);
+  }
+
+  HEPrimitiveCounter::increment(HEPrimitive::encrypt);
+  if (!SealZeroPool::encrypt(encryptor, scratch.plaintext, destination)) {
+    encryptor.encrypt(scratch.plaintext, destination);
+  }
+}
+
+void encrypt_seeded(std::shared_ptr<SealCiphertextWrapper>& output,
+                    const HEPlaintext& input, seal::parms_id_type parms_id,
+                    const element::Type& element_type, double scale,
+                    seal::CKKSEncoder& ckks_encoder,
+                    const seal::Encryptor& encryptor, bool complex_packing,
+                    seal::compr_mode_type compr_mode) {
+  auto plaintext = SealPlaintextWrapper(complex_packing);
+
+  encode(plaintext, input, ckks_encoder, parms_id, element_type, scale,
+         complex_packing);
+  HEPrimitiveCounter::increment(HEPrimitive::encrypt);
+  auto seeded_cipher = encryptor.encrypt_symmetric(plaintext.plaintext());
+
+  std::string seeded_str;
+  seeded_str.resize(seeded_cipher.save_size(compr_mode));
+  size_t save_size = seeded_cipher.save(
+      reinterpret_cast<std::byte*>(seeded_str.data()), seeded_str.size(),
+      compr_mode);
+  seeded_str.resize(save_size);
+  output->set_seeded_data(std::move(seeded_str));
 }
 
 void decode(HEPlaintext& output, const SealPlaintextWrapper& input,
             seal::CKKSEncoder& ckks_encoder, size_t batch_size,
             double mod_interval) {
-  if (input.complex_packing()) {
+  std::vector<double> sparse_vals;
+  std::vector<std::complex<double>> sparse_slots;
+  if (sparse_decode(input.plaintext(), batch_size, input.complex_packing(),
+                    ckks_encoder, sparse_vals, sparse_slots)) {
+    output.assign(sparse_vals.begin(), sparse_vals.end());
+  } else if (input.complex_packing()) {
     std::vector<std::complex<double>> complex_vals;
     ckks_encoder.decode(input.plaintext(), complex_vals);
     complex_vals.resize(2 * batch_size);
@@ -614,15 +988,54 @@ void decrypt(HEPlaintext& output, const SealCiphertextWrapper& input,
              std::shared_ptr<seal::SEALContext> context, size_t batch_size) {
   auto plaintext_wrapper = SealPlaintextWrapper(complex_packing);
   decryptor.decrypt(input.ciphertext(), plaintext_wrapper.plaintext());
+  decode(output, plaintext_wrapper, ckks_encoder, batch_size,
+         decryption_mod_interval(input.ciphertext(), context));
+}
 
+void encode_integers(seal::Plaintext& destination,
+                     const HEPlaintext& plaintext,
+                     seal::BatchEncoder& batch_encoder,
+                     std::uint64_t plain_modulus) {
+  NGRAPH_CHECK(!plaintext.empty(), "Cannot encode empty plaintext");
+  size_t slot_count = batch_encoder.slot_count();
+  NGRAPH_CHECK(plaintext.size() <= slot_count, "Cannot encode ",
+               plaintext.size(), " values in ", slot_count, " slots");
+  auto max_magnitude = static_cast<double>(plain_modulus / 2);
+
+  std::vector<std::int64_t> values(plaintext.size() == 1 ? slot_count
+                                                         : plaintext.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    double value = plaintext.size() == 1 ? plaintext[0] : plaintext[i];
+    NGRAPH_CHECK(std::abs(value) < max_magnitude, "Value ", value,
+                 " exceeds plain modulus ", plain_modulus);
+    values[i] = std::llround(value);
+  }
+  batch_encoder.encode(values, destination);
+}
+
+void decode_integers(HEPlaintext& output, const seal::Plaintext& input,
+                     seal::BatchEncoder& batch_encoder, size_t batch_size) {
+  std::vector<std::int64_t> values;
+  batch_encoder.decode(input, values);
+  NGRAPH_CHECK(batch_size <= values.size(), "Cannot decode ", batch_size,
+               " values from ", values.size(), " slots");
+  output.resize(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    output[i] = static_cast<double>(values[i]);
+  }
+}
+
+double decryption_mod_interval(
+    const seal::Ciphertext& encrypted,
+    const std::shared_ptr<seal::SEALContext>& context) {
   // No modulus reduction
   double q_over_scale{std::numeric_limits<double>::max()};
   if (context) {
     const auto& encryption_params =
-        context->get_context_data(input.ciphertext().parms_id())->parms();
+        context->get_context_data(encrypted.parms_id())->parms();
     const auto& coeff_moduli = encryption_params.coeff_modulus();
 
-    q_over_scale = 1.0 / input.ciphertext().scale();
+    q_over_scale = 1.0 / encrypted.scale();
     NGRAPH_CHECK(!coeff_moduli.empty(),
                  "Empty coeff moduli in decrypting ciphertext");
 
@@ -630,7 +1043,217 @@ void decrypt(HEPlaintext& output, const SealCiphertextWrapper& input,
       q_over_scale *= coeff_mod.value();
     }
   }
-  decode(output, plaintext_wrapper, ckks_encoder, batch_size, q_over_scale);
+  return q_over_scale;
+}
+
+void decrypt_strided(void* destination, size_t stride, size_t num_values,
+                     const element::Type& element_type,
+                     const SealCiphertextWrapper& input, bool complex_packing,
+                     seal::Decryptor& decryptor,
+                     seal::CKKSEncoder& ckks_encoder,
+                     const std::shared_ptr<seal::SEALContext>& context,
+                     HECodecScratch& scratch, double factor) {
+  decryptor.decrypt(input.ciphertext(), scratch.plaintext);
+  bool sparse = sparse_decode(scratch.plaintext, num_values, complex_packing,
+                              ckks_encoder, scratch.values,
+                              scratch.complex_values);
+  if (sparse) {
+    // Decoded from the subring of the sparse encoder
+  } else if (complex_packing) {
+    ckks_encoder.decode(scratch.plaintext, scratch.complex_values);
+    NGRAPH_CHECK(num_values <= 2 * scratch.complex_values.size(),
+                 "Cannot decode ", num_values, " values");
+  } else {
+    ckks_encoder.decode(scratch.plaintext, scratch.values);
+    NGRAPH_CHECK(num_values <= scratch.values.size(), "Cannot decode ",
+                 num_values, " values");
+  }
+
+  if (complex_packing && !sparse) {
+    // Unpacks the complex slots into the otherwise unused real buffer
+    scratch.values.resize(num_values);
+    for (size_t i = 0; i < num_values; ++i) {
+      scratch.values[i] = i % 2 == 0 ? scratch.complex_values[i / 2].real()
+                                     : scratch.complex_values[i / 2].imag();
+    }
+  }
+#ifdef NGRAPH_HE_ABY_ENABLE
+  double mod_interval = decryption_mod_interval(input.ciphertext(), context);
+  for (size_t i = 0; i < num_values; ++i) {
+    scratch.values[i] =
+        runtime::aby::mod_reduce_zero_centered(scratch.values[i], mod_interval);
+  }
+#endif
+  if (factor != 1) {
+    for (size_t i = 0; i < num_values; ++i) {
+      scratch.values[i] *= factor;
+    }
+  }
+  doubles_to_strided(scratch.values.data(), num_values, destination, stride,
+                     element_type);
+}
+
+HoistedRotator::HoistedRotator(const seal::Ciphertext& encrypted,
+                               std::shared_ptr<seal::SEALContext> context)
+    : m_encrypted(encrypted), m_context(std::move(context)) {
+  NGRAPH_CHECK(m_context->using_keyswitching(),
+               "Rotations require key switching");
+  NGRAPH_CHECK(encrypted.size() == 2, "Cannot rotate ciphertext of size ",
+               encrypted.size());
+  NGRAPH_CHECK(encrypted.is_ntt_form(), "Ciphertext is not in NTT form");
+  auto context_data = m_context->get_context_data(encrypted.parms_id());
+  NGRAPH_CHECK(context_data != nullptr,
+               "Ciphertext is not valid for the context");
+
+  const auto& key_context_data = *m_context->key_context_data();
+  const auto& key_modulus = key_context_data.parms().coeff_modulus();
+  const seal::util::NTTTables* ntt_tables =
+      key_context_data.small_ntt_tables();
+  m_coeff_count = context_data->parms().poly_modulus_degree();
+  m_decomp_modulus_size = context_data->parms().coeff_modulus().size();
+  const size_t rns_modulus_size = m_decomp_modulus_size + 1;
+  const seal::Modulus& special_prime = key_modulus.back();
+
+  m_special_prime_inverses.resize(m_decomp_modulus_size);
+  for (size_t i = 0; i < m_decomp_modulus_size; ++i) {
+    NGRAPH_CHECK(seal::util::try_invert_uint_mod(
+                     seal::util::barrett_reduce_64(special_prime.value(),
+                                                   key_modulus[i]),
+                     key_modulus[i], m_special_prime_inverses[i]),
+                 "Special prime is not invertible");
+  }
+
+  m_digits.resize(m_decomp_modulus_size * rns_modulus_size * m_coeff_count);
+  std::vector<uint64_t> digit(m_coeff_count);
+  for (size_t j = 0; j < m_decomp_modulus_size; ++j) {
+    const uint64_t* component = encrypted.data(1) + j * m_coeff_count;
+    std::copy(component, component + m_coeff_count, digit.begin());
+    seal::util::inverse_ntt_negacyclic_harvey(
+        seal::util::CoeffIter(digit.data()), ntt_tables[j]);
+
+    for (size_t i = 0; i < rns_modulus_size; ++i) {
+      uint64_t* reduced =
+          &m_digits[(j * rns_modulus_size + i) * m_coeff_count];
+      if (i == j) {
+        std::copy(component, component + m_coeff_count, reduced);
+        continue;
+      }
+      size_t key_index =
+          (i == m_decomp_modulus_size) ? key_modulus.size() - 1 : i;
+      for (size_t k = 0; k < m_coeff_count; ++k) {
+        reduced[k] =
+            seal::util::barrett_reduce_64(digit[k], key_modulus[key_index]);
+      }
+      seal::util::ntt_negacyclic_harvey(seal::util::CoeffIter(reduced),
+                                        ntt_tables[key_index]);
+    }
+  }
+}
+
+void HoistedRotator::rotate(int step, const seal::GaloisKeys& galois_keys,
+                            seal::Ciphertext& destination) const {
+  if (step == 0) {
+    destination = m_encrypted;
+    return;
+  }
+  HEPrimitiveCounter::increment(HEPrimitive::rotate);
+  const auto& key_context_data = *m_context->key_context_data();
+  const auto& galois_tool = *key_context_data.galois_tool();
+  const auto& key_modulus = key_context_data.parms().coeff_modulus();
+  const seal::util::NTTTables* ntt_tables =
+      key_context_data.small_ntt_tables();
+  const size_t key_modulus_size = key_modulus.size();
+  const size_t rns_modulus_size = m_decomp_modulus_size + 1;
+
+  uint32_t galois_elt = galois_tool.get_elt_from_step(step);
+  NGRAPH_CHECK(galois_keys.has_key(galois_elt), "Galois keys for step ",
+               step, " not found");
+  const auto& key_vector =
+      galois_keys.data()[seal::GaloisKeys::get_index(galois_elt)];
+  NGRAPH_CHECK(key_vector.size() >= m_decomp_modulus_size,
+               "Invalid Galois keys for step ", step);
+
+  // Inner products of the permuted digits with the key, for each key
+  // component k and modulus i, at offset (k * rns_modulus_size + i) *
+  // m_coeff_count
+  std::vector<uint64_t> products(2 * rns_modulus_size * m_coeff_count, 0);
+  std::vector<uint64_t> permuted(m_coeff_count);
+  for (size_t j = 0; j < m_decomp_modulus_size; ++j) {
+    const seal::Ciphertext& key = key_vector[j].data();
+    for (size_t i = 0; i < rns_modulus_size; ++i) {
+      size_t key_index =
+          (i == m_decomp_modulus_size) ? key_modulus_size - 1 : i;
+      const seal::Modulus& modulus = key_modulus[key_index];
+      galois_tool.apply_galois_ntt(
+          seal::util::ConstCoeffIter(
+              &m_digits[(j * rns_modulus_size + i) * m_coeff_count]),
+          galois_elt, seal::util::CoeffIter(permuted.data()));
+      for (size_t k = 0; k < 2; ++k) {
+        const uint64_t* key_poly = key.data(k) + key_index * m_coeff_count;
+        uint64_t* product =
+            &products[(k * rns_modulus_size + i) * m_coeff_count];
+        for (size_t l = 0; l < m_coeff_count; ++l) {
+          product[l] = seal::util::add_uint_mod(
+              product[l],
+              seal::util::multiply_uint_mod(permuted[l], key_poly[l], modulus),
+              modulus);
+        }
+      }
+    }
+  }
+
+  // The rotation of the first component is kept, and the rotation of the
+  // second component is replaced by its key-switched products
+  destination = m_encrypted;
+  for (size_t i = 0; i < m_decomp_modulus_size; ++i) {
+    galois_tool.apply_galois_ntt(
+        seal::util::ConstCoeffIter(m_encrypted.data(0) + i * m_coeff_count),
+        galois_elt,
+        seal::util::CoeffIter(destination.data(0) + i * m_coeff_count));
+  }
+  std::fill(destination.data(1),
+            destination.data(1) + m_decomp_modulus_size * m_coeff_count, 0);
+
+  // Divide the products by the special prime p with rounding, i.e. add
+  // (x - ((x + p / 2) mod p - p / 2)) / p
+  const seal::Modulus& special_prime = key_modulus.back();
+  uint64_t half_prime = special_prime.value() >> 1;
+  std::vector<uint64_t> last(m_coeff_count);
+  std::vector<uint64_t> reduced(m_coeff_count);
+  for (size_t k = 0; k < 2; ++k) {
+    const uint64_t* last_ntt =
+        &products[(k * rns_modulus_size + m_decomp_modulus_size) *
+                  m_coeff_count];
+    std::copy(last_ntt, last_ntt + m_coeff_count, last.begin());
+    seal::util::inverse_ntt_negacyclic_harvey(
+        seal::util::CoeffIter(last.data()), ntt_tables[key_modulus_size - 1]);
+    for (auto& coeff : last) {
+      coeff = seal::util::barrett_reduce_64(coeff + half_prime, special_prime);
+    }
+
+    for (size_t i = 0; i < m_decomp_modulus_size; ++i) {
+      const seal::Modulus& modulus = key_modulus[i];
+      uint64_t half_prime_mod = seal::util::barrett_reduce_64(half_prime,
+                                                              modulus);
+      for (size_t l = 0; l < m_coeff_count; ++l) {
+        reduced[l] = seal::util::sub_uint_mod(
+            seal::util::barrett_reduce_64(last[l], modulus), half_prime_mod,
+            modulus);
+      }
+      seal::util::ntt_negacyclic_harvey(seal::util::CoeffIter(reduced.data()),
+                                        ntt_tables[i]);
+
+      const uint64_t* product =
+          &products[(k * rns_modulus_size + i) * m_coeff_count];
+      uint64_t* result = destination.data(k) + i * m_coeff_count;
+      for (size_t l = 0; l < m_coeff_count; ++l) {
+        uint64_t quotient = seal::util::multiply_uint_mod(
+            seal::util::sub_uint_mod(product[l], reduced[l], modulus),
+            m_special_prime_inverses[i], modulus);
+        result[l] = seal::util::add_uint_mod(result[l], quotient, modulus);
+      }
+    }
+  }
 }
 
 }  // namespace ngraph::runtime::he
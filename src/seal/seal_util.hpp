@@ -19,6 +19,7 @@
 #include <cmath>
 #include <complex>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -38,6 +39,18 @@ class HESealBackend;
 /// \throws ngraph_error if security level is invalid number of bits
 seal::sec_level_type seal_security_level(size_t bits);
 
+/// \brief Returns a fingerprint identifying a serialized key, as a hex
+/// string of its BLAKE2b hash
+/// \param[in] serialized_key Bytes of the saved key
+std::string key_fingerprint(const std::string& serialized_key);
+
+/// \brief Returns the parms_id at a chain index of the modulus chain
+/// \param[in] context Context whose modulus chain is used
+/// \param[in] chain_index Chain index. Indices above the first parameters'
+/// chain index select the first parameters
+seal::parms_id_type parms_id_at_chain_index(
+    const std::shared_ptr<seal::SEALContext>& context, size_t chain_index);
+
 /// \brief Returns the smallest chain index of a vector of HE data
 /// \param[in] he_types Vector of HE data
 /// \param[in] he_seal_backend Backend whose context is used to determine the
@@ -88,6 +101,34 @@ void match_modulus_and_scale_inplace(
     const HESealBackend& he_seal_backend,
     const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
 
+/// \brief Returns the factor by which a rescale divides the scale of a
+/// ciphertext at the given parameters, i.e. the product of the dropped primes
+/// \param[in] context_data Context data of the ciphertext's parameters
+/// \param[in] rescale_primes Number of primes dropped by each rescale
+double rescale_divisor(const seal::SEALContext::ContextData& context_data,
+                       size_t rescale_primes);
+
+/// \brief Rescales a ciphertext by dropping rescale_primes primes from its
+/// coefficient modulus, i.e. dividing it by one logical scale
+/// \param[in,out] encrypted Ciphertext to rescale
+/// \param[in] evaluator Evaluator used for rescaling
+/// \param[in] rescale_primes Number of primes to drop
+/// \param[in] pool Memory pool used for rescaling
+void rescale_inplace(
+    seal::Ciphertext& encrypted, seal::Evaluator& evaluator,
+    size_t rescale_primes,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
+/// \brief Relinearizes a ciphertext to size 2, if it is larger. With lazy
+/// relinearization, ciphertext-ciphertext products stay at size 3 until an
+/// operation requiring size 2 calls this
+/// \param[in,out] arg Ciphertext to relinearize
+/// \param[in] he_seal_backend Backend storing the relinearization keys
+/// \param[in] pool Memory pool used for relinearization
+void relinearize_inplace(
+    SealCiphertextWrapper& arg, const HESealBackend& he_seal_backend,
+    const seal::MemoryPoolHandle& pool = seal::MemoryManager::GetPool());
+
 /// \brief Adds a ciphertext with a scalar in every slot
 /// \param[in,out] encrypted Ciphertext to add to.
 /// \param[in] value Value which is added to the ciphertext
@@ -111,7 +152,7 @@ inline void add_plain(const seal::Ciphertext& encrypted, double value,
 
 /// \brief Multiples each element in a polynomial with a scalar modulo
 /// modulus_value. Assumes the scalar, poly, and modulus value are all < 30
-/// bits
+/// bits. Uses the AVX2 / AVX-512 kernels from seal_simd.hpp when available
 /// \param[in] poly Polynomial to be multiplied
 /// \param[in] coeff_count Number of terms in the polynomial
 /// \param[in] scalar Value with which to multiply
@@ -199,7 +240,41 @@ void multiply_plain_lazy_mod(
     seal::Ciphertext& destination, const HESealBackend& he_seal_backend,
     seal::MemoryPoolHandle pool = seal::MemoryManager::GetPool());
 
-void mult_kernel(std::uint64_t* poly, uint64_t i, uint64_t scalar);
+/// \brief Computes accumulator += encrypted * value, with value encoded in
+/// every slot at the scale of encrypted. The product is reduced directly into
+/// the accumulator, so no temporary ciphertext is allocated
+/// \param[in] encrypted Ciphertext to multiply
+/// \param[in] value Value to multiply the ciphertext by
+/// \param[in,out] accumulator Ciphertext to accumulate the product into. Must
+/// have the same parms_id and size as encrypted, and a scale within rescale
+/// tolerance of the product scale
+/// \param[in] he_seal_backend Backend whose context is used for encoding
+/// \throws ngraph_error if the accumulator does not match the product
+void multiply_plain_accumulate(const seal::Ciphertext& encrypted, double value,
+                               seal::Ciphertext& accumulator,
+                               const HESealBackend& he_seal_backend);
+
+/// \brief Largest magnitude of an integer weight, see quantize_weight. The
+/// noise of a product grows with the magnitude of the integer
+constexpr int64_t s_max_quantized_weight = 1 << 16;
+
+/// \brief Returns value / step, if it is an integer of magnitude at most
+/// s_max_quantized_weight, up to a tolerance of 1e-3
+/// \param[in] value Weight to quantize
+/// \param[in] step Positive quantization step
+std::optional<int64_t> quantize_weight(double value, double step);
+
+/// \brief Multiplies a ciphertext with an integer in every slot. Each RNS
+/// limb is multiplied by the integer modulo its prime, so unlike
+/// multiply_plain_inplace, the scale is unchanged and the product needs no
+/// rescale
+/// \param[in,out] encrypted Ciphertext to multiply, in NTT form
+/// \param[in] value Integer multiplied with the ciphertext
+/// \param[in] he_seal_backend Backend whose context is used for
+/// multiplication
+void multiply_plain_integer_inplace(seal::Ciphertext& encrypted,
+                                    int64_t value,
+                                    const HESealBackend& he_seal_backend);
 
 /// \brief Optimized encoding of single value into vector of coefficients
 /// \param[in] value Value to be encoded
@@ -245,6 +320,93 @@ void encrypt(std::shared_ptr<SealCiphertextWrapper>& output,
              seal::CKKSEncoder& ckks_encoder, const seal::Encryptor& encryptor,
              bool complex_packing);
 
+/// \brief Buffers reused by encrypt_strided and decrypt_strided across calls
+/// on one thread
+struct HECodecScratch {
+  std::vector<double> values;
+  std::vector<std::complex<double>> complex_values;
+  seal::Plaintext plaintext;
+};
+
+/// \brief Encrypts values read directly from a strided buffer, as encrypt of
+/// an HEPlaintext of those values, without allocating intermediate buffers
+/// once the scratch buffers are sized
+/// \param[in,out] destination Encrypted values. Its storage is reused
+/// \param[in] source First value, of type element_type
+/// \param[in] stride Number of bytes between consecutive values
+/// \param[in] num_values Number of values. A single value is encoded in every
+/// slot
+/// \param[in] element_type Datatype of the values
+/// \param[in] parms_id Seal parameter id to use in encoding
+/// \param[in] scale Scale at which to encode the values
+/// \param[in] ckks_encoder Used for encoding
+/// \param[in] encryptor Used for encrypting
+/// \param[in] complex_packing Whether or not to use complex packing during
+/// encoding
+/// \param[in,out] scratch Buffers of the calling thread
+void encrypt_strided(seal::Ciphertext& destination, const void* source,
+                     size_t stride, size_t num_values,
+                     const element::Type& element_type,
+                     seal::parms_id_type parms_id, double scale,
+                     seal::CKKSEncoder& ckks_encoder,
+                     const seal::Encryptor& encryptor, bool complex_packing,
+                     HECodecScratch& scratch);
+
+/// \brief Encrypt plaintext using secret-key encryption, storing the
+/// serialized ciphertext in seeded form. The second polynomial of a seeded
+/// ciphertext is replaced by the seed used to generate it, roughly halving its
+/// serialized size. The seed is expanded when the ciphertext is loaded
+/// \param[out] output Encrypted value. Only the serialized ciphertext is set
+/// \param[in] input Plaintext to encode
+/// \param[in] parms_id Seal parameter id to use in encoding
+/// \param[in] element_type Datatype used for encoding
+/// \param[in] scale Scale at which to encode value
+/// \param[in] ckks_encoder Used for encoding
+/// \param[in] encryptor Used for encrypting. Must have a secret key set
+/// \param[in] complex_packing Whether or not to use complex packing during
+/// encoding
+/// \param[in] compr_mode Compression mode to serialize with
+void encrypt_seeded(std::shared_ptr<SealCiphertextWrapper>& output,
+                    const HEPlaintext& input, seal::parms_id_type parms_id,
+                    const element::Type& element_type, double scale,
+                    seal::CKKSEncoder& ckks_encoder,
+                    const seal::Encryptor& encryptor, bool complex_packing,
+                    seal::compr_mode_type compr_mode);
+
+/// \brief Returns the interval to which decrypted values are reduced when
+/// NGRAPH_HE_ABY_ENABLE is set, i.e. the coefficient modulus of the
+/// ciphertext over its scale
+/// \param[in] encrypted Ciphertext to decrypt
+/// \param[in] context If nullptr, values are not reduced
+double decryption_mod_interval(
+    const seal::Ciphertext& encrypted,
+    const std::shared_ptr<seal::SEALContext>& context);
+
+/// \brief Decrypts a ciphertext and writes its values directly to a strided
+/// buffer in the given element type, as decrypt followed by
+/// HEPlaintext::write, without allocating intermediate buffers once the
+/// scratch buffers are sized
+/// \param[out] destination First value, of type element_type
+/// \param[in] stride Number of bytes between consecutive values
+/// \param[in] num_values Number of values to write
+/// \param[in] element_type Datatype of the values
+/// \param[in] input Ciphertext to decrypt
+/// \param[in] complex_packing Whether or not the ciphertext uses complex
+/// packing
+/// \param[in] decryptor Used for decryption
+/// \param[in] ckks_encoder Used for decoding
+/// \param[in] context Used for modulus reduction, see decryption_mod_interval
+/// \param[in,out] scratch Buffers of the calling thread
+/// \param[in] factor Multiplied into the decrypted values, see
+/// HEType::pending_factor
+void decrypt_strided(void* destination, size_t stride, size_t num_values,
+                     const element::Type& element_type,
+                     const SealCiphertextWrapper& input, bool complex_packing,
+                     seal::Decryptor& decryptor,
+                     seal::CKKSEncoder& ckks_encoder,
+                     const std::shared_ptr<seal::SEALContext>& context,
+                     HECodecScratch& scratch, double factor = 1);
+
 /// \brief Decode SEAL plaintext into plaintext values
 /// \param[out] output Decoded values
 /// \param[in] input Plaintext to decode
@@ -271,4 +433,68 @@ void decrypt(HEPlaintext& output, const SealCiphertextWrapper& input,
              seal::CKKSEncoder& ckks_encoder,
              std::shared_ptr<seal::SEALContext> context, size_t batch_size);
 
+/// \brief Encodes integer values into the slots of a BFV plaintext. Values
+/// are rounded to the nearest integer. A single value is encoded in every
+/// slot
+/// \param[out] destination Encoded values
+/// \param[in] plaintext Input values to encode
+/// \param[in] batch_encoder Used for encoding
+/// \param[in] plain_modulus Plaintext modulus of the BFV parameters
+/// \throws ngraph_error if a value is not in (-plain_modulus/2,
+/// plain_modulus/2)
+void encode_integers(seal::Plaintext& destination,
+                     const HEPlaintext& plaintext,
+                     seal::BatchEncoder& batch_encoder,
+                     std::uint64_t plain_modulus);
+
+/// \brief Decodes the first batch_size slots of a BFV plaintext, as integers
+/// centered around 0
+/// \param[out] output Decoded values
+/// \param[in] input Plaintext to decode
+/// \param[in] batch_encoder Used for decoding
+/// \param[in] batch_size Number of output values
+void decode_integers(HEPlaintext& output, const seal::Plaintext& input,
+                     seal::BatchEncoder& batch_encoder, size_t batch_size);
+
+/// \brief Rotates a single ciphertext by many steps, sharing the key-switching
+/// decomposition across the rotations. Each rotation applies the Galois
+/// automorphism to the ciphertext, and key-switches the rotated second
+/// component from its RNS digits. Since the automorphism permutes the NTT
+/// coefficients of each digit, the digits and their NTTs with respect to
+/// every key modulus are computed once, at construction, and each rotation
+/// only permutes them and multiplies them with the Galois key. This saves
+/// most of the NTTs of independent rotate_vector calls
+class HoistedRotator {
+ public:
+  /// \brief Decomposes a ciphertext for rotation
+  /// \param[in] encrypted Ciphertext of size 2 in NTT form to rotate
+  /// \param[in] context Context of the ciphertext, which must use key
+  /// switching
+  /// \throws ngraph_error if the ciphertext cannot be rotated
+  HoistedRotator(const seal::Ciphertext& encrypted,
+                 std::shared_ptr<seal::SEALContext> context);
+
+  /// \brief Rotates the ciphertext as seal::Evaluator::rotate_vector. Thread-
+  /// safe
+  /// \param[in] step Number of slots to rotate left by. Step 0 copies the
+  /// ciphertext
+  /// \param[in] galois_keys Galois keys including the step
+  /// \param[out] destination Stores the rotated ciphertext
+  /// \throws ngraph_error if the Galois keys do not include the step
+  void rotate(int step, const seal::GaloisKeys& galois_keys,
+              seal::Ciphertext& destination) const;
+
+ private:
+  seal::Ciphertext m_encrypted;
+  std::shared_ptr<seal::SEALContext> m_context;
+  size_t m_coeff_count{0};
+  size_t m_decomp_modulus_size{0};
+  // Digit j of the second component, reduced modulo key modulus i in NTT
+  // form, at offset (j * (m_decomp_modulus_size + 1) + i) * m_coeff_count.
+  // Index m_decomp_modulus_size denotes the special prime
+  std::vector<uint64_t> m_digits;
+  // Inverse of the special prime modulo each ciphertext modulus
+  std::vector<uint64_t> m_special_prime_inverses;
+};
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,144 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "seal/seal_zero_pool.hpp"
+
+#include <atomic>
+#include <shared_mutex>
+#include <utility>
+
+#include "logging/ngraph_he_log.hpp"
+#include "ngraph/check.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+std::shared_mutex s_pools_mutex;
+std::unordered_map<const seal::Encryptor*, SealZeroPool*> s_pools;
+// Lets encryption skip the lookup while no pool exists
+std::atomic<size_t> s_num_pools{0};
+}  // namespace
+
+SealZeroPool::SealZeroPool(std::shared_ptr<seal::SEALContext> context,
+                           std::shared_ptr<seal::Encryptor> encryptor,
+                           size_t capacity)
+    : m_context(std::move(context)),
+      m_encryptor(std::move(encryptor)),
+      m_evaluator(*m_context),
+      m_capacity(capacity) {
+  NGRAPH_CHECK(m_encryptor != nullptr, "Zero pool requires an encryptor");
+  {
+    std::unique_lock<std::shared_mutex> lock(s_pools_mutex);
+    NGRAPH_CHECK(s_pools.emplace(m_encryptor.get(), this).second,
+                 "Encryptor already has a zero pool");
+    ++s_num_pools;
+  }
+  m_thread = std::thread([this]() { run(); });
+  NGRAPH_HE_LOG(3) << "Created zero pool with capacity " << m_capacity;
+}
+
+SealZeroPool::~SealZeroPool() {
+  {
+    std::unique_lock<std::shared_mutex> lock(s_pools_mutex);
+    s_pools.erase(m_encryptor.get());
+    --s_num_pools;
+  }
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+bool SealZeroPool::encrypt(const seal::Plaintext& plain,
+                           seal::Ciphertext& destination) {
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto& zeros = m_zeros[plain.parms_id()];
+    if (zeros.empty()) {
+      m_cond.notify_all();
+      return false;
+    }
+    destination = std::move(zeros.front());
+    zeros.pop_front();
+  }
+  m_cond.notify_all();
+  destination.scale() = plain.scale();
+  m_evaluator.add_plain_inplace(destination, plain);
+  return true;
+}
+
+void SealZeroPool::fill(const seal::parms_id_type& parms_id) {
+  while (size(parms_id) < m_capacity) {
+    seal::Ciphertext zero;
+    m_encryptor->encrypt_zero(parms_id, zero);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_zeros[parms_id].emplace_back(std::move(zero));
+  }
+}
+
+size_t SealZeroPool::size(const seal::parms_id_type& parms_id) const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto it = m_zeros.find(parms_id);
+  return it == m_zeros.end() ? 0 : it->second.size();
+}
+
+bool SealZeroPool::encrypt(const seal::Encryptor& encryptor,
+                           const seal::Plaintext& plain,
+                           seal::Ciphertext& destination) {
+  if (s_num_pools == 0) {
+    return false;
+  }
+  std::shared_lock<std::shared_mutex> lock(s_pools_mutex);
+  auto it = s_pools.find(&encryptor);
+  return it != s_pools.end() && it->second->encrypt(plain, destination);
+}
+
+void SealZeroPool::run() {
+  while (true) {
+    seal::parms_id_type parms_id;
+    {
+      // Refills the emptiest level first
+      std::unique_lock<std::mutex> lock(m_mutex);
+      auto emptiest = m_zeros.end();
+      m_cond.wait(lock, [&]() {
+        emptiest = m_zeros.end();
+        for (auto it = m_zeros.begin(); it != m_zeros.end(); ++it) {
+          if (it->second.size() < m_capacity &&
+              (emptiest == m_zeros.end() ||
+               it->second.size() < emptiest->second.size())) {
+            emptiest = it;
+          }
+        }
+        return m_stop || emptiest != m_zeros.end();
+      });
+      if (m_stop) {
+        return;
+      }
+      parms_id = emptiest->first;
+    }
+
+    seal::Ciphertext zero;
+    m_encryptor->encrypt_zero(parms_id, zero);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_zeros[parms_id].emplace_back(std::move(zero));
+  }
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,99 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "seal/seal.h"
+
+namespace ngraph::runtime::he {
+
+/// \brief Pool of fresh encryptions of zero under one encryptor, filled by a
+/// background thread. A plaintext is then encrypted by adding it to a
+/// pooled encryption of zero, which moves the sampling and NTTs of
+/// public-key encryption off the critical path. Encryptions of zero are kept
+/// at each parms_id plaintexts were encrypted at, so levels are added on
+/// first use. While a pool exists, encrypt() and encrypt_strided() use it
+/// for its encryptor. All methods are thread-safe.
+class SealZeroPool {
+ public:
+  /// \brief Creates a pool and starts filling it
+  /// \param[in] context Context of the encryptor
+  /// \param[in] encryptor Public-key encryptor. Each pool must have a
+  /// distinct encryptor
+  /// \param[in] capacity Number of encryptions of zero kept at each level
+  SealZeroPool(std::shared_ptr<seal::SEALContext> context,
+               std::shared_ptr<seal::Encryptor> encryptor, size_t capacity);
+
+  /// \brief Stops filling the pool
+  ~SealZeroPool();
+
+  SealZeroPool(const SealZeroPool&) = delete;
+  SealZeroPool& operator=(const SealZeroPool&) = delete;
+
+  /// \brief Encrypts a plaintext using a pooled encryption of zero at the
+  /// plaintext's parms_id
+  /// \param[in] plain Plaintext to encrypt
+  /// \param[out] destination Stores the encryption on success
+  /// \returns True if a pooled encryption of zero was used. Otherwise, the
+  /// plaintext's parms_id is added to the levels kept by the pool
+  bool encrypt(const seal::Plaintext& plain, seal::Ciphertext& destination);
+
+  /// \brief Fills the pool at a parms_id, and keeps it filled there
+  /// \param[in] parms_id Seal parameter id to fill
+  void fill(const seal::parms_id_type& parms_id);
+
+  /// \brief Returns the number of pooled encryptions of zero at a parms_id
+  /// \param[in] parms_id Seal parameter id
+  size_t size(const seal::parms_id_type& parms_id) const;
+
+  /// \brief Returns the number of encryptions of zero kept at each level
+  size_t capacity() const { return m_capacity; }
+
+  /// \brief Encrypts a plaintext with the pool of an encryptor, if any
+  /// \param[in] encryptor Encryptor whose pool is used
+  /// \param[in] plain Plaintext to encrypt
+  /// \param[out] destination Stores the encryption on success
+  /// \returns True if a pool of the encryptor encrypted the plaintext
+  static bool encrypt(const seal::Encryptor& encryptor,
+                      const seal::Plaintext& plain,
+                      seal::Ciphertext& destination);
+
+ private:
+  /// \brief Encrypts zeros until the pool is stopped
+  void run();
+
+  std::shared_ptr<seal::SEALContext> m_context;
+  std::shared_ptr<seal::Encryptor> m_encryptor;
+  seal::Evaluator m_evaluator;
+  size_t m_capacity;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stop{false};
+  std::unordered_map<seal::parms_id_type, std::deque<seal::Ciphertext>>
+      m_zeros;
+  std::thread m_thread;
+};
+
+}  // namespace ngraph::runtime::he
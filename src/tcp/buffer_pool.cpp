@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/buffer_pool.hpp"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ngraph::runtime::he {
+
+std::shared_ptr<BufferPool::data_buffer> BufferPool::acquire(size_t size) {
+  std::unique_ptr<data_buffer> buffer;
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    // Prefer the smallest buffer which fits, else grow the largest buffer
+    auto best = m_buffers.end();
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it) {
+      size_t capacity = (*it)->capacity();
+      if (best == m_buffers.end()) {
+        best = it;
+        continue;
+      }
+      size_t best_capacity = (*best)->capacity();
+      bool fits = capacity >= size;
+      bool best_fits = best_capacity >= size;
+      if ((fits && (!best_fits || capacity < best_capacity)) ||
+          (!fits && !best_fits && capacity > best_capacity)) {
+        best = it;
+      }
+    }
+    if (best != m_buffers.end()) {
+      buffer = std::move(*best);
+      m_buffers.erase(best);
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = std::make_unique<data_buffer>();
+  }
+  buffer->resize(size);
+
+  std::weak_ptr<BufferPool> weak_pool = weak_from_this();
+  return std::shared_ptr<data_buffer>(
+      buffer.release(), [weak_pool](data_buffer* released) {
+        std::unique_ptr<data_buffer> owned(released);
+        if (auto pool = weak_pool.lock()) {
+          pool->release(std::move(owned));
+        }
+      });
+}
+
+size_t BufferPool::num_idle_buffers() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_buffers.size();
+}
+
+void BufferPool::release(std::unique_ptr<data_buffer> buffer) {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (m_buffers.size() < m_max_buffers) {
+    m_buffers.emplace_back(std::move(buffer));
+  }
+}
+
+}  // namespace ngraph::runtime::he
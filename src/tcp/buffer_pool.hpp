@@ -0,0 +1,59 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Thread-safe pool of byte buffers which retain their capacity across
+/// messages, so receiving messages of similar sizes reuses memory which is
+/// already allocated and paged in, rather than allocating fresh buffers for
+/// every message
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+ public:
+  using data_buffer = TCPMessage::data_buffer;
+
+  /// \brief Constructs an empty pool. Must be owned by a std::shared_ptr
+  /// \param[in] max_buffers Maximum number of idle buffers retained
+  explicit BufferPool(size_t max_buffers = s_default_max_buffers)
+      : m_max_buffers(max_buffers) {}
+
+  /// \brief Returns a buffer of the given size. The idle buffer with the
+  /// smallest sufficient capacity is reused if one exists. Once the last
+  /// reference to the buffer is released, the buffer returns to the pool, if
+  /// the pool is still alive and not full
+  /// \param[in] size Size in bytes of the buffer
+  std::shared_ptr<data_buffer> acquire(size_t size);
+
+  /// \brief Returns the number of idle buffers in the pool
+  size_t num_idle_buffers() const;
+
+ private:
+  /// \brief Returns a buffer to the pool, or frees it if the pool is full
+  void release(std::unique_ptr<data_buffer> buffer);
+
+  inline static const size_t s_default_max_buffers{8};
+
+  size_t m_max_buffers;
+  mutable std::mutex m_mutex;
+  std::vector<std::unique_ptr<data_buffer>> m_buffers;
+};
+}  // namespace ngraph::runtime::he
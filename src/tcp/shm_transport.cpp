@@ -0,0 +1,475 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/shm_transport.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "boost/asio.hpp"
+#include "logging/ngraph_he_log.hpp"
+#include "logging/ngraph_he_trace.hpp"
+#include "ngraph/check.hpp"
+#include "tcp/buffer_pool.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+namespace {
+// Identifies an initialized segment
+const uint64_t s_shm_magic{0x6e67726170684845ULL};
+
+/// \brief Spins briefly on an empty or full ring, then sleeps
+class Backoff {
+ public:
+  void wait() {
+    if (++m_spins < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+  }
+  void reset() { m_spins = 0; }
+
+ private:
+  size_t m_spins{0};
+};
+
+size_t message_bytes(const TCPMessage& message) {
+  size_t bytes = message.segments_size();
+  if (message.pb_message() != nullptr) {
+    bytes += message.pb_message()->ByteSizeLong();
+  }
+  return bytes;
+}
+}  // namespace
+
+std::string shm_transport_name(size_t port) {
+  return "/ngraph_he_" + std::to_string(port);
+}
+
+// The write and read positions count all bytes passed through the ring, and
+// are kept on separate cache lines, since each is written by one end only
+struct ShmChannel::Ring {
+  alignas(64) std::atomic<size_t> head{0};
+  alignas(64) std::atomic<size_t> tail{0};
+};
+
+struct ShmChannel::Header {
+  std::atomic<uint64_t> magic{0};
+  size_t ring_bytes{0};
+  std::atomic<uint32_t> client_attached{0};
+  std::atomic<uint32_t> closed{0};
+  Ring to_client;
+  Ring to_server;
+};
+
+std::unique_ptr<ShmChannel> ShmChannel::create(const std::string& name,
+                                               size_t ring_bytes) {
+  NGRAPH_CHECK(ring_bytes > 0, "Shared-memory ring must not be empty");
+  static_assert(std::atomic<size_t>::is_always_lock_free,
+                "Shared-memory rings require lock-free atomics");
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  NGRAPH_CHECK(fd >= 0, "Cannot create shared memory ", name, ": ",
+               std::strerror(errno));
+  size_t size = sizeof(Header) + 2 * ring_bytes;
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    int err = errno;
+    ::close(fd);
+    shm_unlink(name.c_str());
+    NGRAPH_CHECK(false, "Cannot size shared memory ", name, ": ",
+                 std::strerror(err));
+  }
+  void* memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int err = errno;
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    NGRAPH_CHECK(false, "Cannot map shared memory ", name, ": ",
+                 std::strerror(err));
+  }
+  auto* header = new (memory) Header();
+  header->ring_bytes = ring_bytes;
+  header->magic.store(s_shm_magic, std::memory_order_release);
+  return std::unique_ptr<ShmChannel>(
+      new ShmChannel(name, true, memory, size));
+}
+
+std::unique_ptr<ShmChannel> ShmChannel::attach(const std::string& name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat stat_buf {};
+  if (fstat(fd, &stat_buf) != 0 ||
+      static_cast<size_t>(stat_buf.st_size) < sizeof(Header)) {
+    ::close(fd);
+    return nullptr;
+  }
+  auto size = static_cast<size_t>(stat_buf.st_size);
+  void* memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (memory == MAP_FAILED) {
+    return nullptr;
+  }
+  auto* header = static_cast<Header*>(memory);
+  uint32_t detached = 0;
+  if (header->magic.load(std::memory_order_acquire) != s_shm_magic ||
+      size != sizeof(Header) + 2 * header->ring_bytes ||
+      !header->client_attached.compare_exchange_strong(detached, 1)) {
+    munmap(memory, size);
+    return nullptr;
+  }
+  return std::unique_ptr<ShmChannel>(
+      new ShmChannel(name, false, memory, size));
+}
+
+ShmChannel::ShmChannel(std::string name, bool server, void* memory,
+                       size_t size)
+    : m_name(std::move(name)),
+      m_server(server),
+      m_memory(memory),
+      m_size(size) {
+  char* to_client_data = static_cast<char*>(memory) + sizeof(Header);
+  char* to_server_data = to_client_data + header().ring_bytes;
+  m_write_ring = server ? &header().to_client : &header().to_server;
+  m_read_ring = server ? &header().to_server : &header().to_client;
+  m_write_data = server ? to_client_data : to_server_data;
+  m_read_data = server ? to_server_data : to_client_data;
+}
+
+ShmChannel::~ShmChannel() {
+  close();
+  if (m_server && !m_unlinked) {
+    shm_unlink(m_name.c_str());
+  }
+  munmap(m_memory, m_size);
+}
+
+bool ShmChannel::client_attached() {
+  if (header().client_attached.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  if (m_server && !m_unlinked) {
+    shm_unlink(m_name.c_str());
+    m_unlinked = true;
+  }
+  return true;
+}
+
+bool ShmChannel::write(const void* data, size_t size) {
+  const auto* bytes = static_cast<const char*>(data);
+  size_t capacity = header().ring_bytes;
+  size_t head = m_write_ring->head.load(std::memory_order_relaxed);
+  Backoff backoff;
+  while (size > 0) {
+    if (header().closed.load(std::memory_order_acquire) != 0) {
+      return false;
+    }
+    size_t tail = m_write_ring->tail.load(std::memory_order_acquire);
+    size_t free_bytes = capacity - (head - tail);
+    if (free_bytes == 0) {
+      backoff.wait();
+      continue;
+    }
+    size_t offset = head % capacity;
+    size_t chunk = std::min(size, std::min(free_bytes, capacity - offset));
+    std::memcpy(m_write_data + offset, bytes, chunk);
+    head += chunk;
+    m_write_ring->head.store(head, std::memory_order_release);
+    bytes += chunk;
+    size -= chunk;
+    backoff.reset();
+  }
+  return true;
+}
+
+bool ShmChannel::read(void* data, size_t size) {
+  auto* bytes = static_cast<char*>(data);
+  size_t capacity = header().ring_bytes;
+  size_t tail = m_read_ring->tail.load(std::memory_order_relaxed);
+  Backoff backoff;
+  while (size > 0) {
+    size_t head = m_read_ring->head.load(std::memory_order_acquire);
+    if (head == tail) {
+      // Bytes written before the channel was closed are still read
+      if (header().closed.load(std::memory_order_acquire) != 0 &&
+          m_read_ring->head.load(std::memory_order_acquire) == tail) {
+        return false;
+      }
+      backoff.wait();
+      continue;
+    }
+    size_t offset = tail % capacity;
+    size_t chunk = std::min(size, std::min(head - tail, capacity - offset));
+    std::memcpy(bytes, m_read_data + offset, chunk);
+    tail += chunk;
+    m_read_ring->tail.store(tail, std::memory_order_release);
+    bytes += chunk;
+    size -= chunk;
+    backoff.reset();
+  }
+  return true;
+}
+
+void ShmChannel::close() {
+  header().closed.store(1, std::memory_order_release);
+}
+
+ShmConnection::ShmConnection(std::unique_ptr<ShmChannel> channel,
+                             MessageHandler message_handler,
+                             std::function<void()> on_closed)
+    : m_channel(std::move(channel)),
+      m_message_callback(std::move(message_handler)),
+      m_on_closed(std::move(on_closed)),
+      m_buffer_pool(std::make_shared<BufferPool>()) {
+  NGRAPH_CHECK(m_channel != nullptr, "Shared-memory channel is null");
+  m_reader = std::thread([this]() { run_reader(); });
+  m_writer = std::thread([this]() { run_writer(); });
+}
+
+ShmConnection::~ShmConnection() {
+  m_channel->close();
+  close();
+  if (m_reader.joinable()) {
+    m_reader.join();
+  }
+}
+
+void ShmConnection::write_message(TCPMessage&& message,
+                                  size_t max_pending_bytes) {
+  size_t bytes = message_bytes(message);
+  {
+    std::unique_lock<std::mutex> lock(m_write_mtx);
+    if (max_pending_bytes > 0) {
+      m_write_cond.wait(lock, [this, bytes, max_pending_bytes]() {
+        return m_closing || m_pending_bytes == 0 ||
+               m_pending_bytes + bytes <= max_pending_bytes;
+      });
+    }
+    if (m_closing) {
+      NGRAPH_HE_LOG(1) << "Dropping message written to closed channel";
+      return;
+    }
+    m_message_queue.emplace_back(std::move(message));
+    m_pending_bytes += bytes;
+    m_num_pending_writes++;
+  }
+  m_write_cond.notify_all();
+}
+
+void ShmConnection::close() {
+  {
+    std::lock_guard<std::mutex> lock(m_write_mtx);
+    m_closing = true;
+  }
+  m_write_cond.notify_all();
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+  m_channel->close();
+}
+
+size_t ShmConnection::num_pending_writes() const {
+  std::lock_guard<std::mutex> lock(m_write_mtx);
+  return m_num_pending_writes;
+}
+
+void ShmConnection::wait_until_written(size_t max_pending) {
+  std::unique_lock<std::mutex> lock(m_write_mtx);
+  m_write_cond.wait(lock, [this, max_pending]() {
+    return m_num_pending_writes <= max_pending;
+  });
+}
+
+void ShmConnection::run_reader() {
+  const size_t header_length = TCPMessage::header_length;
+  TCPMessage::data_buffer header(header_length);
+  while (m_channel->read(header.data(), header_length)) {
+    size_t body_length = TCPMessage::decode_header(header);
+    size_t payload_length = TCPMessage::decode_payload_size(header);
+    auto body = m_buffer_pool->acquire(header_length + body_length);
+    std::copy(header.begin(), header.end(), body->begin());
+    auto payload = m_buffer_pool->acquire(payload_length);
+    if (!m_channel->read(body->data() + header_length, body_length) ||
+        !m_channel->read(payload->data(), payload_length)) {
+      break;
+    }
+    m_bytes_read.fetch_add(header_length + body_length + payload_length,
+                           std::memory_order_relaxed);
+    // Handlers only read received messages, so they are parsed into an arena
+    TCPMessage message;
+    message.unpack(*body, true);
+    if (!payload->empty()) {
+      message.set_payload(payload);
+    }
+    m_message_callback(std::move(message));
+  }
+  NGRAPH_HE_LOG(3) << "Shared-memory channel closed";
+  m_on_closed();
+}
+
+void ShmConnection::run_writer() {
+  TCPMessage::data_buffer write_buffer;
+  std::unique_lock<std::mutex> lock(m_write_mtx);
+  while (true) {
+    m_write_cond.wait(
+        lock, [this]() { return m_closing || !m_message_queue.empty(); });
+    if (m_message_queue.empty()) {
+      break;
+    }
+    TCPMessage message = std::move(m_message_queue.front());
+    m_message_queue.pop_front();
+    lock.unlock();
+
+    size_t bytes = message_bytes(message);
+    message.pack(write_buffer);
+    auto write_start = logging::Tracer::Clock::now();
+    bool written = m_channel->write(write_buffer.data(), write_buffer.size());
+    for (const auto& segment : message.segments()) {
+      written = written && m_channel->write(segment.data, segment.size);
+    }
+    if (written) {
+      size_t length = write_buffer.size() + message.segments_size();
+      m_bytes_written.fetch_add(length, std::memory_order_relaxed);
+      auto& tracer = logging::Tracer::instance();
+      if (tracer.enabled()) {
+        tracer.record("shm", "send message", write_start,
+                      logging::Tracer::Clock::now(),
+                      {{"bytes", std::to_string(length)}});
+      }
+    } else {
+      NGRAPH_HE_LOG(1) << "Shared-memory channel closed while writing";
+    }
+
+    lock.lock();
+    m_pending_bytes -= bytes;
+    m_num_pending_writes--;
+    m_write_cond.notify_all();
+  }
+}
+
+ShmSession::ShmSession(
+    boost::asio::io_context& io_context, std::unique_ptr<ShmChannel> channel,
+    const std::function<void(const TCPMessage&)>& message_handler)
+    : m_channel(std::move(channel)),
+      m_handler_strand(io_context.get_executor()),
+      m_work_guard(
+          std::make_unique<work_guard_type>(io_context.get_executor())),
+      m_message_callback(message_handler) {}
+
+void ShmSession::start() {
+  // The reading thread holds no reference to the session, so the session is
+  // never destroyed on it. Messages handled after the session is destroyed
+  // are dropped
+  std::weak_ptr<ShmSession> weak_self = weak_from_this();
+  auto handle_message = [this, weak_self](TCPMessage&& message) {
+    auto shared_message = std::make_shared<TCPMessage>(std::move(message));
+    boost::asio::post(m_handler_strand, [weak_self, shared_message]() {
+      if (auto self = weak_self.lock()) {
+        logging::TraceSpan trace_span("shm", "handle message");
+        self->m_message_callback(*shared_message);
+      }
+    });
+  };
+  auto on_closed = [this]() { m_work_guard->reset(); };
+  m_connection = std::make_unique<ShmConnection>(std::move(m_channel),
+                                                 handle_message, on_closed);
+}
+
+void ShmSession::write_message(TCPMessage&& message) {
+  NGRAPH_CHECK(m_connection != nullptr, "Shared-memory session not started");
+  // Handlers must not wait for writes queued behind them
+  size_t max_pending_bytes = m_handler_strand.running_in_this_thread()
+                                 ? 0
+                                 : m_max_pending_bytes.load();
+  m_connection->write_message(std::move(message), max_pending_bytes);
+}
+
+bool ShmSession::is_writing() const {
+  return m_connection != nullptr && m_connection->num_pending_writes() > 0;
+}
+
+void ShmSession::wait_until_written(size_t max_pending) {
+  if (m_connection != nullptr) {
+    m_connection->wait_until_written(max_pending);
+  }
+}
+
+size_t ShmSession::bytes_written() const {
+  return m_connection == nullptr ? 0 : m_connection->bytes_written();
+}
+
+size_t ShmSession::bytes_read() const {
+  return m_connection == nullptr ? 0 : m_connection->bytes_read();
+}
+
+ShmClient::ShmClient(
+    boost::asio::io_context& io_context, const std::string& name,
+    const std::function<void(const TCPMessage&)>& message_handler)
+    : m_io_context(io_context),
+      m_work_guard(
+          std::make_unique<work_guard_type>(io_context.get_executor())),
+      m_message_callback(message_handler) {
+  NGRAPH_HE_LOG(1) << "Trying to attach to shared memory " << name;
+  auto channel = ShmChannel::attach(name);
+  for (size_t delay_ms = 10; channel == nullptr;
+       delay_ms = std::min(delay_ms * 2, size_t(1000))) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    channel = ShmChannel::attach(name);
+  }
+  NGRAPH_HE_LOG(1) << "Attached to server";
+
+  // Messages are handled on the thread running the io_context, in order of
+  // receipt
+  auto handle_message = [this](TCPMessage&& message) {
+    auto shared_message = std::make_shared<TCPMessage>(std::move(message));
+    boost::asio::post(m_io_context, [this, shared_message]() {
+      m_message_callback(*shared_message);
+    });
+  };
+  auto on_closed = [this]() {
+    boost::asio::post(m_io_context, [this]() { m_work_guard->reset(); });
+  };
+  m_connection = std::make_unique<ShmConnection>(std::move(channel),
+                                                 handle_message, on_closed);
+}
+
+void ShmClient::close() {
+  NGRAPH_HE_LOG(1) << "Closing shared-memory channel";
+  m_connection->close();
+  m_work_guard->reset();
+}
+
+void ShmClient::write_message(TCPMessage&& message) {
+  m_connection->write_message(std::move(message));
+}
+
+}  // namespace ngraph::runtime::he
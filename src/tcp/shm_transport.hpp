@@ -0,0 +1,257 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "boost/asio.hpp"
+#include "tcp/buffer_pool.hpp"
+#include "tcp/tcp_message.hpp"
+#include "tcp/transport.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Returns the name of the shared-memory segment of a server
+/// listening on a port
+/// \param[in] port Port of the server
+std::string shm_transport_name(size_t port);
+
+/// \brief POSIX shared-memory segment holding two single-producer,
+/// single-consumer byte rings, one in each direction between a server and
+/// the one client attached to it. Messages are written in the TCP wire
+/// format, with payload segments copied straight from their memory into the
+/// ring, so a co-located client and server bypass the socket and kernel
+/// copies. Blocked reads and writes poll the ring with a backoff
+class ShmChannel {
+ public:
+  /// \brief Creates a segment, replacing any stale segment of the same name
+  /// \param[in] name Name of the segment, starting with '/'
+  /// \param[in] ring_bytes Capacity in bytes of each ring
+  /// \throws ngraph_error if the segment cannot be created
+  static std::unique_ptr<ShmChannel> create(
+      const std::string& name, size_t ring_bytes = s_default_ring_bytes);
+
+  /// \brief Attaches a client to a segment
+  /// \param[in] name Name of the segment
+  /// \returns The channel, or nullptr if no segment of the name is ready or
+  /// another client is attached to it
+  static std::unique_ptr<ShmChannel> attach(const std::string& name);
+
+  ~ShmChannel();
+
+  ShmChannel(const ShmChannel&) = delete;
+  ShmChannel& operator=(const ShmChannel&) = delete;
+
+  /// \brief Returns whether or not a client is attached. Once a client is
+  /// attached, the server unlinks the name, so the next client attaches to
+  /// the next segment of the name
+  bool client_attached();
+
+  /// \brief Writes bytes to the ring towards the peer, blocking while the
+  /// ring is full
+  /// \returns false if either end has closed the channel
+  bool write(const void* data, size_t size);
+
+  /// \brief Reads bytes from the ring from the peer, blocking until they
+  /// are written
+  /// \returns false if the channel was closed before all bytes were read.
+  /// Bytes written before the peer closed the channel are still read
+  bool read(void* data, size_t size);
+
+  /// \brief Closes this end of the channel, after which reads and writes of
+  /// both ends return false
+  void close();
+
+ private:
+  struct Ring;
+  struct Header;
+
+  ShmChannel(std::string name, bool server, void* memory, size_t size);
+
+  Header& header() const { return *static_cast<Header*>(m_memory); }
+
+  std::string m_name;
+  bool m_server;
+  bool m_unlinked{false};
+  void* m_memory;
+  size_t m_size;
+  Ring* m_write_ring;
+  Ring* m_read_ring;
+  char* m_write_data;
+  char* m_read_data;
+
+  inline static const size_t s_default_ring_bytes{1UL << 26U};
+};
+
+/// \brief Writes messages to a shared-memory channel on a thread of its own,
+/// and reads messages from it on another. Shared by the server and client
+/// ends
+class ShmConnection {
+ public:
+  using MessageHandler = std::function<void(TCPMessage&&)>;
+
+  /// \brief Starts the reading and writing threads
+  /// \param[in] channel Channel to exchange messages over
+  /// \param[in] message_handler Called on the reading thread with each
+  /// received message
+  /// \param[in] on_closed Called on the reading thread once the peer has
+  /// closed the channel
+  ShmConnection(std::unique_ptr<ShmChannel> channel,
+                MessageHandler message_handler,
+                std::function<void()> on_closed);
+
+  /// \brief Closes the channel, dropping the queued messages, and joins the
+  /// threads
+  ~ShmConnection();
+
+  ShmConnection(const ShmConnection&) = delete;
+  ShmConnection& operator=(const ShmConnection&) = delete;
+
+  /// \brief Adds a message to the message-writing queue
+  /// \param[in,out] message Message to write
+  /// \param[in] max_pending_bytes If non-zero, blocks while the queued
+  /// messages hold more than max_pending_bytes
+  void write_message(TCPMessage&& message, size_t max_pending_bytes = 0);
+
+  /// \brief Writes the queued messages, then closes the channel
+  void close();
+
+  /// \brief Returns the number of messages queued to be written
+  size_t num_pending_writes() const;
+
+  /// \brief Blocks until at most max_pending queued messages remain to be
+  /// written
+  void wait_until_written(size_t max_pending);
+
+  size_t bytes_written() const {
+    return m_bytes_written.load(std::memory_order_relaxed);
+  }
+
+  size_t bytes_read() const {
+    return m_bytes_read.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void run_reader();
+  void run_writer();
+
+  std::unique_ptr<ShmChannel> m_channel;
+  MessageHandler m_message_callback;
+  std::function<void()> m_on_closed;
+  std::shared_ptr<BufferPool> m_buffer_pool;
+
+  // Guards the members below, on which the writing thread waits
+  mutable std::mutex m_write_mtx;
+  std::condition_variable m_write_cond;
+  std::deque<TCPMessage> m_message_queue;
+  size_t m_pending_bytes{0};
+  // Number of messages queued or being written
+  size_t m_num_pending_writes{0};
+  bool m_closing{false};
+
+  std::atomic<size_t> m_bytes_written{0};
+  std::atomic<size_t> m_bytes_read{0};
+  std::thread m_reader;
+  std::thread m_writer;
+};
+
+/// \brief Server end of a shared-memory connection. Received messages are
+/// handled in order of receipt on a strand of the io_context, which the
+/// session keeps busy until the client closes the channel
+class ShmSession : public ServerTransport,
+                   public std::enable_shared_from_this<ShmSession> {
+ public:
+  /// \brief Constructs a session over a channel a client is attached to
+  ShmSession(boost::asio::io_context& io_context,
+             std::unique_ptr<ShmChannel> channel,
+             const std::function<void(const TCPMessage&)>& message_handler);
+
+  /// \brief Start the session. Must be owned by a std::shared_ptr
+  void start() override;
+
+  /// \brief Adds a message to the message-writing queue. May be called from
+  /// any thread. Blocks while the queued messages hold more than
+  /// max_pending_bytes, unless called from a message handler of the session
+  void write_message(TCPMessage&& message) override;
+
+  /// \brief Sets the number of bytes of queued messages above which
+  /// write_message blocks. 0 disables the bound
+  void set_max_pending_bytes(size_t max_pending_bytes) {
+    m_max_pending_bytes = max_pending_bytes;
+  }
+
+  bool is_writing() const override;
+
+  void wait_until_written(size_t max_pending = 0) override;
+
+  size_t bytes_written() const override;
+
+  size_t bytes_read() const override;
+
+ private:
+  using strand_type =
+      boost::asio::strand<boost::asio::io_context::executor_type>;
+  using work_guard_type =
+      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+  std::unique_ptr<ShmChannel> m_channel;
+  strand_type m_handler_strand;
+  std::unique_ptr<work_guard_type> m_work_guard;
+  std::function<void(const TCPMessage&)> m_message_callback;
+  std::atomic<size_t> m_max_pending_bytes{s_default_max_pending_bytes};
+  std::unique_ptr<ShmConnection> m_connection;
+
+  inline static const size_t s_default_max_pending_bytes{1UL << 26U};
+};
+
+/// \brief Client end of a shared-memory connection. Messages are written and
+/// handled on the thread running the io_context, which the client keeps
+/// busy until it is closed
+class ShmClient : public ClientTransport {
+ public:
+  /// \brief Attaches to the segment of a server, retrying until the server
+  /// has created it
+  /// \param[in] io_context Boost context on which messages are handled
+  /// \param[in] name Name of the segment, see shm_transport_name
+  /// \param[in] message_handler Function to handle responses from the server
+  ShmClient(boost::asio::io_context& io_context, const std::string& name,
+            const std::function<void(const TCPMessage&)>& message_handler);
+
+  /// \brief Closes the channel
+  void close() override;
+
+  /// \brief Asynchronously writes the message
+  /// \param[in,out] message Message to write
+  void write_message(TCPMessage&& message) override;
+
+ private:
+  using work_guard_type =
+      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+  boost::asio::io_context& m_io_context;
+  std::unique_ptr<work_guard_type> m_work_guard;
+  std::function<void(const TCPMessage&)> m_message_callback;
+  std::unique_ptr<ShmConnection> m_connection;
+};
+}  // namespace ngraph::runtime::he
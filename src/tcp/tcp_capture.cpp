@@ -0,0 +1,145 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include "tcp/tcp_capture.hpp"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ngraph/check.hpp"
+#include "protos/message.pb.h"
+
+namespace ngraph::runtime::he {
+
+namespace {
+void write_size(std::ofstream& stream, size_t value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(size_t));
+}
+
+bool read_size(std::ifstream& stream, size_t& value) {
+  return static_cast<bool>(
+      stream.read(reinterpret_cast<char*>(&value), sizeof(size_t)));
+}
+}  // namespace
+
+TCPCaptureWriter::TCPCaptureWriter(const std::string& path)
+    : m_stream(path, std::ios::binary | std::ios::trunc),
+      m_start(std::chrono::steady_clock::now()) {
+  NGRAPH_CHECK(m_stream.is_open(), "Cannot open capture file ", path);
+}
+
+size_t TCPCaptureWriter::record_received(const TCPMessage& message) {
+  // The replay client only checks the kind of the server's messages, so the
+  // tensors of received messages are not stored
+  pb::TCPMessage body;
+  if (const auto& pb_message = message.pb_message(); pb_message != nullptr) {
+    body.set_type(pb_message->type());
+    if (pb_message->has_function()) {
+      *body.mutable_function() = pb_message->function();
+    }
+    if (pb_message->has_op_request()) {
+      *body.mutable_op_request() = pb_message->op_request();
+    }
+    if (pb_message->has_encryption_parameters()) {
+      *body.mutable_encryption_parameters() =
+          pb_message->encryption_parameters();
+    }
+  }
+  std::lock_guard<std::mutex> guard(m_mutex);
+  write_record(false, m_num_received, body, {}, nullptr, 0);
+  return m_num_received++;
+}
+
+void TCPCaptureWriter::record_sent(const TCPMessage& message, size_t trigger) {
+  NGRAPH_CHECK(message.pb_message() != nullptr,
+               "Cannot capture empty message");
+  std::lock_guard<std::mutex> guard(m_mutex);
+  write_record(true, trigger, *message.pb_message(), message.segments(),
+               message.payload(), message.payload_size());
+}
+
+void TCPCaptureWriter::write_record(bool sent, size_t trigger,
+                                    const pb::TCPMessage& body,
+                                    const TCPMessage::Segments& segments,
+                                    const char* payload, size_t payload_size) {
+  auto time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - m_start)
+                     .count();
+  std::string body_str = body.SerializeAsString();
+  size_t total_payload_size = payload_size;
+  for (const auto& segment : segments) {
+    total_payload_size += segment.size;
+  }
+
+  write_size(m_stream, sent ? 1 : 0);
+  write_size(m_stream, trigger);
+  write_size(m_stream, static_cast<size_t>(time_us));
+  write_size(m_stream, body_str.size());
+  write_size(m_stream, total_payload_size);
+  m_stream.write(body_str.data(), body_str.size());
+  for (const auto& segment : segments) {
+    m_stream.write(static_cast<const char*>(segment.data), segment.size);
+  }
+  if (payload != nullptr) {
+    m_stream.write(payload, payload_size);
+  }
+  NGRAPH_CHECK(m_stream.good(), "Error writing capture file");
+}
+
+std::vector<CapturedMessage> load_capture(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  NGRAPH_CHECK(stream.is_open(), "Cannot open capture file ", path);
+
+  std::vector<CapturedMessage> messages;
+  while (true) {
+    size_t sent = 0;
+    if (!read_size(stream, sent)) {
+      break;
+    }
+    CapturedMessage captured;
+    captured.sent = sent != 0;
+    size_t body_size = 0;
+    size_t payload_size = 0;
+    NGRAPH_CHECK(read_size(stream, captured.trigger) &&
+                     read_size(stream, captured.time_us) &&
+                     read_size(stream, body_size) &&
+                     read_size(stream, payload_size),
+                 "Truncated record header in capture file ", path);
+
+    TCPMessage::data_buffer buffer(TCPMessage::header_length + body_size);
+    TCPMessage::encode_header(buffer, body_size, payload_size);
+    auto payload = std::make_shared<TCPMessage::data_buffer>(payload_size);
+    NGRAPH_CHECK(stream.read(&buffer[TCPMessage::header_length], body_size) &&
+                     stream.read(payload->data(), payload_size),
+                 "Truncated record in capture file ", path);
+
+    NGRAPH_CHECK(captured.message.unpack(buffer),
+                 "Malformed message in capture file ", path);
+    if (payload_size > 0) {
+      // Sent messages are replayed from their payload as a single segment
+      TCPMessage::Segments segments{{payload->data(), payload_size, payload}};
+      captured.message =
+          TCPMessage(pb::TCPMessage(*captured.message.pb_message()),
+                     std::move(segments));
+    }
+    messages.emplace_back(std::move(captured));
+  }
+  return messages;
+}
+
+}  // namespace ngraph::runtime::he
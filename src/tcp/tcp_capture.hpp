@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Message of a captured session, see TCPCaptureWriter
+struct CapturedMessage {
+  /// \brief Whether the client sent or received the message
+  bool sent{false};
+  /// \brief Index among the received messages of the message the client
+  /// handled when it sent this message, or of this message if received
+  size_t trigger{0};
+  /// \brief Microseconds since the start of the capture
+  size_t time_us{0};
+  /// \brief The message. Sent messages store their payload as a single
+  /// segment. Received messages keep only their type, function, op request
+  /// and encryption parameters
+  TCPMessage message;
+};
+
+/// \brief Records the messages a client exchanges with a server to a file,
+/// for replay by HESealReplayClient. Each record stores the direction,
+/// trigger index and time of a message, followed by the message in its wire
+/// format. All methods are thread-safe
+class TCPCaptureWriter {
+ public:
+  /// \brief Opens the capture file, truncating it
+  /// \param[in] path Path of the capture file
+  /// \throws ngraph_error if the file cannot be opened
+  explicit TCPCaptureWriter(const std::string& path);
+
+  /// \brief Records a message read from the server
+  /// \param[in] message Received message
+  /// \returns Index of the message among the received messages
+  size_t record_received(const TCPMessage& message);
+
+  /// \brief Records a message written to the server
+  /// \param[in] message Message to write
+  /// \param[in] trigger Index of the received message this message answers
+  void record_sent(const TCPMessage& message, size_t trigger);
+
+ private:
+  void write_record(bool sent, size_t trigger, const pb::TCPMessage& body,
+                    const TCPMessage::Segments& segments, const char* payload,
+                    size_t payload_size);
+
+  std::mutex m_mutex;
+  std::ofstream m_stream;
+  std::chrono::steady_clock::time_point m_start;
+  size_t m_num_received{0};
+};
+
+/// \brief Loads a capture written by TCPCaptureWriter
+/// \param[in] path Path of the capture file
+/// \returns The captured messages, in order of capture
+/// \throws ngraph_error if the file cannot be read or is malformed
+std::vector<CapturedMessage> load_capture(const std::string& path);
+}  // namespace ngraph::runtime::he
@@ -17,15 +17,18 @@
 #include "tcp/tcp_client.hpp"
 
 #include <chrono>
+#include <array>
 #include <deque>
 #include <memory>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
 #include "ngraph/check.hpp"
+#include "tcp/buffer_pool.hpp"
 #include "tcp/tcp_message.hpp"
 
 namespace ngraph::runtime::he {
@@ -38,12 +41,22 @@ TCPClient::TCPClient(
     const std::function<void(const TCPMessage&)>& message_handler)
     : m_io_context(io_context),
       m_socket(io_context),
+      m_buffer_pool(std::make_shared<BufferPool>()),
       m_message_callback(std::bind(message_handler, std::placeholders::_1)) {
   do_connect(endpoints);
 }
 
-/// \brief Closes the socket
 void TCPClient::close() {
+  // E.g. the message ending a persistent session is written before closing
+  boost::asio::post(m_io_context, [this]() {
+    m_close_when_written = true;
+    if (m_message_queue.empty()) {
+      do_close();
+    }
+  });
+}
+
+void TCPClient::do_close() {
   NGRAPH_HE_LOG(1) << "Closing socket";
   m_socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both);
   boost::asio::post(m_io_context, [this]() { m_socket.close(); });
@@ -96,20 +109,31 @@ void TCPClient::do_read_header() {
                      "Client error reading message header: ", ec.message());
         if (!ec) {
           size_t msg_len = TCPMessage::decode_header(m_read_buffer);
-          do_read_body(msg_len);
+          size_t payload_len = TCPMessage::decode_payload_size(m_read_buffer);
+          do_read_body(msg_len, payload_len);
         }
       });
 }
 
-void TCPClient::do_read_body(size_t body_length) {
+void TCPClient::do_read_body(size_t body_length, size_t payload_length) {
   m_read_buffer.resize(header_length + body_length);
+  // The payload is read into its own pooled buffer, which the message keeps
+  // until the next message is unpacked, so ciphertexts are loaded directly
+  // from the received bytes
+  auto payload = m_buffer_pool->acquire(payload_length);
+  std::array<boost::asio::mutable_buffer, 2> buffers{
+      boost::asio::buffer(&m_read_buffer[header_length], body_length),
+      boost::asio::buffer(payload->data(), payload_length)};
   boost::asio::async_read(
-      m_socket, boost::asio::buffer(&m_read_buffer[header_length], body_length),
-      [this](boost::system::error_code ec, std::size_t /* length */) {
+      m_socket, buffers,
+      [this, payload](boost::system::error_code ec, std::size_t /* length */) {
         NGRAPH_CHECK(!ec || ec.message() == s_expected_teardown_message,
                      "Client error reading message body: ", ec.message());
         if (!ec) {
           m_read_message.unpack(m_read_buffer);
+          if (!payload->empty()) {
+            m_read_message.set_payload(payload);
+          }
           m_message_callback(m_read_message);
           do_read_header();
         }
@@ -120,15 +144,18 @@ void TCPClient::do_write() {
   auto message = m_message_queue.front();
   message.pack(m_write_buffer);
   NGRAPH_HE_LOG(4) << "Client writing message size " << m_write_buffer.size()
+                   << " bytes, payload size " << message.segments_size()
                    << " bytes";
 
   boost::asio::async_write(
-      m_socket, boost::asio::buffer(m_write_buffer),
+      m_socket, write_buffers(message),
       [this](boost::system::error_code ec, std::size_t /* length */) {
         if (!ec) {
           m_message_queue.pop_front();
           if (!m_message_queue.empty()) {
             do_write();
+          } else if (m_close_when_written) {
+            do_close();
           }
         } else {
           NGRAPH_ERR << "Client error writing message: " << ec.message();
@@ -136,4 +163,15 @@ void TCPClient::do_write() {
       });
 }
 
+std::vector<boost::asio::const_buffer> TCPClient::write_buffers(
+    const TCPMessage& message) const {
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(1 + message.segments().size());
+  buffers.emplace_back(boost::asio::buffer(m_write_buffer));
+  for (const auto& segment : message.segments()) {
+    buffers.emplace_back(segment.data, segment.size);
+  }
+  return buffers;
+}
+
 }  // namespace ngraph::runtime::he
@@ -19,14 +19,17 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
+#include "tcp/buffer_pool.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/transport.hpp"
 
 namespace ngraph::runtime::he {
 /// \brief Class representing a Client over a TCP connection
-class TCPClient {
+class TCPClient : public ClientTransport {
  public:
   using data_buffer = TCPMessage::data_buffer;
   size_t header_length = TCPMessage::header_length;
@@ -39,12 +42,12 @@ class TCPClient {
             const boost::asio::ip::tcp::resolver::results_type& endpoints,
             const std::function<void(const TCPMessage&)>& message_handler);
 
-  /// \brief Closes the socket
-  void close();
+  /// \brief Closes the socket once the queued messages are written
+  void close() override;
 
   /// \brief Asynchronously writes the message
   /// \param[in,out] message Message to write
-  void write_message(TCPMessage&& message);
+  void write_message(TCPMessage&& message) override;
 
  private:
   void do_connect(const boost::asio::ip::tcp::resolver::results_type& endpoints,
@@ -52,17 +55,28 @@ class TCPClient {
 
   void do_read_header();
 
-  void do_read_body(size_t body_length);
+  void do_read_body(size_t body_length, size_t payload_length = 0);
 
   void do_write();
 
+  /// \brief Shuts down and closes the socket
+  void do_close();
+
+  /// \brief Returns the buffers to write for a message: the packed header
+  /// and body in m_write_buffer, followed by the payload segments
+  std::vector<boost::asio::const_buffer> write_buffers(
+      const TCPMessage& message) const;
+
   boost::asio::io_context& m_io_context;
   boost::asio::ip::tcp::socket m_socket;
+  std::shared_ptr<BufferPool> m_buffer_pool;
 
   data_buffer m_read_buffer;
   data_buffer m_write_buffer;
   TCPMessage m_read_message;
   std::deque<TCPMessage> m_message_queue;
+  // Whether or not the socket is closed once m_message_queue is written
+  bool m_close_when_written{false};
 
   static const char* s_expected_teardown_message;
 
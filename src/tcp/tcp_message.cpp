@@ -16,11 +16,13 @@
 
 #include "tcp/tcp_message.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "google/protobuf/arena.h"
 #include "ngraph/check.hpp"
 #include "ngraph/log.hpp"
 #include "ngraph/util.hpp"
@@ -33,13 +35,34 @@ TCPMessage::TCPMessage() = default;
 TCPMessage::TCPMessage(pb::TCPMessage&& pb_message)
     : m_pb_message(std::make_shared<pb::TCPMessage>(std::move(pb_message))) {}
 
+TCPMessage::TCPMessage(pb::TCPMessage&& pb_message,
+                       TCPMessage::Segments&& segments)
+    : m_pb_message(std::make_shared<pb::TCPMessage>(std::move(pb_message))),
+      m_segments(std::move(segments)) {}
+
 std::shared_ptr<pb::TCPMessage> TCPMessage::pb_message() const {
   return m_pb_message;
 }
 
-void TCPMessage::encode_header(TCPMessage::data_buffer& buffer, size_t size) {
+TCPMessage TCPMessage::detach() const {
+  TCPMessage message(pb::TCPMessage(*m_pb_message));
+  message.m_payload = m_payload;
+  return message;
+}
+
+size_t TCPMessage::segments_size() const {
+  size_t size = 0;
+  for (const auto& segment : m_segments) {
+    size += segment.size;
+  }
+  return size;
+}
+
+void TCPMessage::encode_header(TCPMessage::data_buffer& buffer, size_t size,
+                               size_t payload_size) {
   NGRAPH_CHECK(buffer.size() >= TCPMessage::header_length, "Buffer too small");
-  std::memcpy(&buffer[0], &size, TCPMessage::header_length);
+  std::memcpy(&buffer[0], &size, sizeof(size_t));
+  std::memcpy(&buffer[sizeof(size_t)], &payload_size, sizeof(size_t));
 }
 
 size_t TCPMessage::decode_header(const TCPMessage::data_buffer& buffer) {
@@ -47,23 +70,47 @@ size_t TCPMessage::decode_header(const TCPMessage::data_buffer& buffer) {
     return 0;
   }
   size_t body_length = 0;
-  std::memcpy(&body_length, &buffer[0], TCPMessage::header_length);
+  std::memcpy(&body_length, &buffer[0], sizeof(size_t));
   return body_length;
 }
 
+size_t TCPMessage::decode_payload_size(const TCPMessage::data_buffer& buffer) {
+  if (buffer.size() < TCPMessage::header_length) {
+    return 0;
+  }
+  size_t payload_length = 0;
+  std::memcpy(&payload_length, &buffer[sizeof(size_t)], sizeof(size_t));
+  return payload_length;
+}
+
 bool TCPMessage::pack(TCPMessage::data_buffer& buffer) {
   NGRAPH_CHECK(m_pb_message != nullptr, "Can't pack empty proto message");
   size_t msg_size = m_pb_message->ByteSize();
   buffer.resize(TCPMessage::header_length + msg_size);
-  encode_header(buffer, msg_size);
+  encode_header(buffer, msg_size, segments_size());
   return m_pb_message->SerializeToArray(&buffer[TCPMessage::header_length],
                                         msg_size);
 }
 
-bool TCPMessage::unpack(const TCPMessage::data_buffer& buffer) {
-  if (!m_pb_message) {
+bool TCPMessage::unpack(const TCPMessage::data_buffer& buffer,
+                        bool use_arena) {
+  if (use_arena) {
+    // Parsed messages take roughly the size of their serialized body. The
+    // message aliases the arena, which is freed with the last reference
+    size_t body_size = buffer.size() - TCPMessage::header_length;
+    google::protobuf::ArenaOptions options;
+    options.start_block_size = std::max(options.start_block_size,
+                                        body_size + body_size / 2);
+    options.max_block_size =
+        std::max(options.max_block_size, options.start_block_size);
+    auto arena = std::make_shared<google::protobuf::Arena>(options);
+    m_pb_message = std::shared_ptr<pb::TCPMessage>(
+        arena,
+        google::protobuf::Arena::CreateMessage<pb::TCPMessage>(arena.get()));
+  } else if (!m_pb_message || m_pb_message->GetArena() != nullptr) {
     m_pb_message = std::make_shared<pb::TCPMessage>();
   }
+  m_payload = nullptr;
   return m_pb_message->ParseFromArray(
       &buffer[TCPMessage::header_length],
       buffer.size() - TCPMessage::header_length);
@@ -22,12 +22,25 @@
 #include "protos/message.pb.h"
 
 namespace ngraph::runtime::he {
-/// \brief Represents a message. A wrapper around pb::TCPMessage
+/// \brief Represents a message. A wrapper around pb::TCPMessage, optionally
+/// followed by a raw payload. The wire format is
+/// [body size][payload size][protobuf body][payload segments...]
+/// Payload segments are written directly from their memory, e.g. ciphertext
+/// data, without being copied into the protobuf body
 class TCPMessage {
  public:
-  enum { header_length = sizeof(size_t) };
+  enum { header_length = 2 * sizeof(size_t) };
   using data_buffer = std::vector<char>;
 
+  /// \brief Contiguous memory written to the payload of a message
+  struct Segment {
+    const void* data{nullptr};
+    size_t size{0};
+    /// \brief Keeps the memory alive until the message is written
+    std::shared_ptr<const void> owner;
+  };
+  using Segments = std::vector<Segment>;
+
   /// \brief Creates empty message
   TCPMessage();
 
@@ -37,32 +50,82 @@ class TCPMessage {
   /// \param[in,out] pb_message Protobuf message to populate TCPMessage
   explicit TCPMessage(pb::TCPMessage&& pb_message);
 
+  /// \brief Creates message from given protobuf message and payload
+  /// \param[in,out] pb_message Protobuf message to populate TCPMessage
+  /// \param[in,out] segments Payload written after the protobuf message
+  TCPMessage(pb::TCPMessage&& pb_message, Segments&& segments);
+
   /// \brief Returns pointer to udnerlying protobuf message
   std::shared_ptr<pb::TCPMessage> pb_message() const;
 
-  /// \brief Stores a size in the buffer header
-  /// \param[in,out] buffer Buffer to write size to
-  /// \param[in] size Size to write into buffer
-  static void encode_header(data_buffer& buffer, size_t size);
+  /// \brief Returns a message with a copy of the protobuf message, sharing
+  /// the payload. Received messages reuse their protobuf message for the
+  /// next message, so messages handled after the read callback returns must
+  /// be detached
+  TCPMessage detach() const;
+
+  /// \brief Returns the payload segments of a message to be written
+  const Segments& segments() const { return m_segments; }
+
+  /// \brief Returns the total size in bytes of the payload segments
+  size_t segments_size() const;
+
+  /// \brief Returns the payload of a received message, or nullptr if there
+  /// is no payload
+  const char* payload() const {
+    return m_payload == nullptr ? nullptr : m_payload->data();
+  }
+
+  /// \brief Returns the size in bytes of the payload of a received message
+  size_t payload_size() const {
+    return m_payload == nullptr ? 0 : m_payload->size();
+  }
+
+  /// \brief Sets the payload of a received message
+  /// \param[in] payload Buffer storing the payload
+  void set_payload(std::shared_ptr<data_buffer> payload) {
+    m_payload = std::move(payload);
+  }
+
+  /// \brief Stores the body and payload sizes in the buffer header
+  /// \param[in,out] buffer Buffer to write sizes to
+  /// \param[in] size Size of the protobuf body to write into buffer
+  /// \param[in] payload_size Size of the payload to write into buffer
+  static void encode_header(data_buffer& buffer, size_t size,
+                            size_t payload_size = 0);
 
   /// \brief Given a buffer storing a message with the length in the first
-  /// header_length bytes, returns the size of the stored buffer
+  /// header_length bytes, returns the size of the stored protobuf body
   /// \param[in] buffer Buffer storing a message
   /// \returns size of message stored in buffer
   static size_t decode_header(const data_buffer& buffer);
 
-  /// \brief Writes the message to a buffer
+  /// \brief Given a buffer storing a message header, returns the size of the
+  /// payload following the protobuf body
+  /// \param[in] buffer Buffer storing a message
+  /// \returns size of payload following the message body
+  static size_t decode_payload_size(const data_buffer& buffer);
+
+  /// \brief Writes the header and protobuf body of the message to a buffer.
+  /// The payload segments are not copied, and must be written after buffer
   /// \param[in,out] buffer Buffer to write the message to
   /// \throws ngraph_error if message is empty
   /// \returns Whether or not the operation was successful
   bool pack(data_buffer& buffer);
 
   /// \brief Writes a given buffer to the message
-  /// \param[in] buffer Buffer to read the message from
+  /// \param[in] buffer Buffer to read the header and protobuf body from
+  /// \param[in] use_arena Whether or not to parse the protobuf body into an
+  /// arena sized to the body, which replaces one allocation per submessage
+  /// with a few large blocks. Fields of an arena message are copied rather
+  /// than swapped when moved into a message outside the arena, so this suits
+  /// messages which are only read
   /// \returns Whether or not the operation was successful
-  bool unpack(const data_buffer& buffer);
+  bool unpack(const data_buffer& buffer, bool use_arena = false);
 
  private:
   std::shared_ptr<pb::TCPMessage> m_pb_message;
+  Segments m_segments;
+  std::shared_ptr<data_buffer> m_payload;
 };
 }  // namespace ngraph::runtime::he
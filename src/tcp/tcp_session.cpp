@@ -16,15 +16,21 @@
 
 #include "tcp/tcp_session.hpp"
 
+#include <algorithm>
+#include <array>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
+#include "logging/ngraph_he_trace.hpp"
 #include "ngraph/check.hpp"
+#include "tcp/buffer_pool.hpp"
 #include "tcp/tcp_message.hpp"
 
 namespace ngraph::runtime::he {
@@ -32,8 +38,16 @@ TCPSession::TCPSession(
     boost::asio::ip::tcp::socket socket,
     const std::function<void(const TCPMessage&)>& message_handler)
     : m_socket(std::move(socket)),
+      m_socket_strand(m_socket.get_executor()),
+      m_handler_strand(m_socket.get_executor()),
+      m_buffer_pool(std::make_shared<BufferPool>()),
       m_message_callback(std::bind(message_handler, std::placeholders::_1)) {}
 
+void TCPSession::start() {
+  auto self(shared_from_this());
+  boost::asio::post(m_socket_strand, [this, self]() { do_read_header(); });
+}
+
 void TCPSession::do_read_header() {
   if (m_read_buffer.size() < header_length) {
     m_read_buffer.resize(header_length);
@@ -41,63 +55,175 @@ void TCPSession::do_read_header() {
   auto self(shared_from_this());
   boost::asio::async_read(
       m_socket, boost::asio::buffer(&m_read_buffer[0], header_length),
-      [this, self](boost::system::error_code ec, std::size_t /* length */) {
-        NGRAPH_CHECK(
-            !ec || ec.message() == TCPSession::s_expected_teardown_message,
-            "Server error reading message header: ", ec.message());
-        if (!ec) {
-          size_t msg_len = TCPMessage::decode_header(m_read_buffer);
-          do_read_body(msg_len);
-        }
-      });
+      boost::asio::bind_executor(
+          m_socket_strand, [this, self](boost::system::error_code ec,
+                                        std::size_t /* length */) {
+            NGRAPH_CHECK(
+                !ec || ec.message() == TCPSession::s_expected_teardown_message,
+                "Server error reading message header: ", ec.message());
+            if (!ec) {
+              // The message is traced from the receipt of its header
+              m_read_start = logging::Tracer::Clock::now();
+              size_t msg_len = TCPMessage::decode_header(m_read_buffer);
+              size_t payload_len =
+                  TCPMessage::decode_payload_size(m_read_buffer);
+              do_read_body(msg_len, payload_len);
+            }
+          }));
 }
 
-void TCPSession::do_read_body(size_t body_length) {
-  m_read_buffer.resize(header_length + body_length);
+void TCPSession::do_read_body(size_t body_length, size_t payload_length) {
+  // The body and payload are read into pooled buffers, which return to the
+  // pool once the message has been handled. The payload is kept by the
+  // message, so ciphertexts are loaded directly from the received bytes
+  auto body = m_buffer_pool->acquire(header_length + body_length);
+  std::copy(m_read_buffer.begin(), m_read_buffer.begin() + header_length,
+            body->begin());
+  auto payload = m_buffer_pool->acquire(payload_length);
+  std::array<boost::asio::mutable_buffer, 2> buffers{
+      boost::asio::buffer(body->data() + header_length, body_length),
+      boost::asio::buffer(payload->data(), payload_length)};
 
   auto self(shared_from_this());
   boost::asio::async_read(
-      m_socket, boost::asio::buffer(&m_read_buffer[header_length], body_length),
-      [this, self](boost::system::error_code ec, std::size_t /* length */) {
-        NGRAPH_CHECK(
-            !ec || ec.message() == TCPSession::s_expected_teardown_message,
-            "Server error reading message body: ", ec.message());
-        if (!ec) {
-          m_read_message.unpack(m_read_buffer);
-          m_message_callback(m_read_message);
-          do_read_header();
-        }
-      });
+      m_socket, buffers,
+      boost::asio::bind_executor(
+          m_socket_strand,
+          [this, self, body, payload](boost::system::error_code ec,
+                                      std::size_t length) {
+            NGRAPH_CHECK(
+                !ec || ec.message() == TCPSession::s_expected_teardown_message,
+                "Server error reading message body: ", ec.message());
+            if (!ec) {
+              m_bytes_read.fetch_add(header_length + length,
+                                     std::memory_order_relaxed);
+              auto& tracer = logging::Tracer::instance();
+              if (tracer.enabled()) {
+                tracer.record(
+                    "tcp", "receive message", m_read_start,
+                    logging::Tracer::Clock::now(),
+                    {{"bytes", std::to_string(header_length + length)}});
+              }
+              // Parse and handle the message on the handler strand, while
+              // the next message is read into another buffer. Handlers only
+              // read received messages, so they are parsed into an arena
+              boost::asio::post(m_handler_strand, [this, self, body,
+                                                   payload]() {
+                TCPMessage message;
+                message.unpack(*body, true);
+                if (!payload->empty()) {
+                  message.set_payload(payload);
+                }
+                logging::TraceSpan trace_span("tcp", "handle message");
+                m_message_callback(message);
+              });
+              do_read_header();
+            }
+          }));
 }
 
 void TCPSession::write_message(TCPMessage&& message) {
-  bool write_in_progress = is_writing();
-  m_message_queue.emplace_back(std::move(message));
-  if (!write_in_progress) {
-    do_write();
+  queue_message(std::move(message), false);
+}
+
+void TCPSession::write_urgent_message(TCPMessage&& message) {
+  queue_message(std::move(message), true);
+}
+
+void TCPSession::queue_message(TCPMessage&& message, bool urgent) {
+  size_t message_bytes = message.segments_size();
+  if (message.pb_message() != nullptr) {
+    message_bytes += message.pb_message()->ByteSizeLong();
+  }
+  // Handlers of the session must not wait for the writes on its strands, and
+  // urgent messages must not wait for bulk messages
+  bool may_block = !urgent && !m_socket_strand.running_in_this_thread() &&
+                   !m_handler_strand.running_in_this_thread();
+  {
+    std::unique_lock<std::mutex> lock(m_write_mtx);
+    if (may_block && m_max_pending_bytes > 0) {
+      m_is_writing.wait(lock, [this, message_bytes]() {
+        return m_pending_bytes == 0 ||
+               m_pending_bytes + message_bytes <= m_max_pending_bytes;
+      });
+    }
+    m_num_pending_writes++;
+    m_pending_bytes += message_bytes;
   }
+  auto self(shared_from_this());
+  auto queued_message = std::make_shared<TCPMessage>(std::move(message));
+  boost::asio::post(m_socket_strand, [this, self, queued_message,
+                                      message_bytes, urgent]() {
+    auto& queue = urgent ? m_urgent_queue : m_message_queue;
+    queue.push_back({std::move(*queued_message), message_bytes});
+    if (m_write_queue == nullptr) {
+      do_write();
+    }
+  });
 }
 
-void TCPSession::do_write() {
+bool TCPSession::is_writing() const {
   std::lock_guard<std::mutex> lock(m_write_mtx);
-  m_is_writing.notify_all();
+  return m_num_pending_writes > 0;
+}
+
+void TCPSession::wait_until_written(size_t max_pending) {
+  std::unique_lock<std::mutex> lock(m_write_mtx);
+  m_is_writing.wait(lock, [this, max_pending]() {
+    return m_num_pending_writes <= max_pending;
+  });
+}
+
+void TCPSession::do_write() {
   auto self(shared_from_this());
-  auto message = m_message_queue.front();
+  // The message stays at the front of its queue until it is written, which
+  // keeps its payload segments alive
+  m_write_queue = m_urgent_queue.empty() ? &m_message_queue : &m_urgent_queue;
+  auto& message = m_write_queue->front().message;
   message.pack(m_write_buffer);
   NGRAPH_HE_LOG(4) << "Server writing message size " << m_write_buffer.size()
+                   << " bytes, payload size " << message.segments_size()
                    << " bytes";
+  auto write_start = logging::Tracer::Clock::now();
 
   boost::asio::async_write(
-      m_socket, boost::asio::buffer(m_write_buffer),
-      [this, self](boost::system::error_code ec, std::size_t /* length */) {
-        NGRAPH_CHECK(!ec, "Server error writing message: ", ec.message());
-        m_message_queue.pop_front();
-        if (!m_message_queue.empty()) {
-          do_write();
-        } else {
-          m_is_writing.notify_all();
-        }
-      });
+      m_socket, write_buffers(message),
+      boost::asio::bind_executor(
+          m_socket_strand, [this, self, write_start](
+                               boost::system::error_code ec,
+                               std::size_t length) {
+            NGRAPH_CHECK(!ec, "Server error writing message: ", ec.message());
+            m_bytes_written.fetch_add(length, std::memory_order_relaxed);
+            auto& tracer = logging::Tracer::instance();
+            if (tracer.enabled()) {
+              tracer.record("tcp", "send message", write_start,
+                            logging::Tracer::Clock::now(),
+                            {{"bytes", std::to_string(length)}});
+            }
+            size_t message_bytes = m_write_queue->front().bytes;
+            m_write_queue->pop_front();
+            m_write_queue = nullptr;
+            {
+              std::lock_guard<std::mutex> lock(m_write_mtx);
+              m_num_pending_writes--;
+              m_pending_bytes -= message_bytes;
+            }
+            m_is_writing.notify_all();
+            if (!m_urgent_queue.empty() || !m_message_queue.empty()) {
+              do_write();
+            }
+          }));
+}
+
+std::vector<boost::asio::const_buffer> TCPSession::write_buffers(
+    const TCPMessage& message) const {
+  std::vector<boost::asio::const_buffer> buffers;
+  buffers.reserve(1 + message.segments().size());
+  buffers.emplace_back(boost::asio::buffer(m_write_buffer));
+  for (const auto& segment : message.segments()) {
+    buffers.emplace_back(segment.data, segment.size);
+  }
+  return buffers;
 }
 
 }  // namespace ngraph::runtime::he
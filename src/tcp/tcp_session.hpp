@@ -16,19 +16,29 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "boost/asio.hpp"
 #include "logging/ngraph_he_log.hpp"
+#include "logging/ngraph_he_trace.hpp"
+#include "tcp/buffer_pool.hpp"
 #include "tcp/tcp_message.hpp"
+#include "tcp/transport.hpp"
 
 namespace ngraph::runtime::he {
-/// \brief Class representing a session over TCP
-class TCPSession : public std::enable_shared_from_this<TCPSession> {
+/// \brief Class representing a session over TCP. Socket operations run on
+/// one strand, and received messages are parsed and handled in order of
+/// receipt on another, so the next message is read while the current message
+/// is handled. The io_context may therefore be run by several threads
+class TCPSession : public ServerTransport,
+                   public std::enable_shared_from_this<TCPSession> {
   using data_buffer = TCPMessage::data_buffer;
   size_t header_length = TCPMessage::header_length;
 
@@ -38,40 +48,114 @@ class TCPSession : public std::enable_shared_from_this<TCPSession> {
              const std::function<void(const TCPMessage&)>& message_handler);
 
   /// \brief Start the session
-  void start() { do_read_header(); }
+  void start() override;
 
   /// \brief Reads a header
   void do_read_header();
 
-  /// \brief Reads message body of specified length
-  /// \param[in] body_length Number of bytes to read
-  void do_read_body(size_t body_length);
+  /// \brief Reads message body and payload of specified lengths
+  /// \param[in] body_length Number of protobuf body bytes to read
+  /// \param[in] payload_length Number of payload bytes to read
+  void do_read_body(size_t body_length, size_t payload_length = 0);
 
-  /// \brief Adds a message to the message-writing queue
+  /// \brief Adds a message to the message-writing queue. May be called from
+  /// any thread. Blocks while the queued messages hold more than
+  /// max_pending_bytes, unless called from a handler of the session, which
+  /// the socket writes would wait for
   /// \param[in,out] message Message to write
-  void write_message(TCPMessage&& message);
+  void write_message(TCPMessage&& message) override;
+
+  /// \brief Adds a message to the queue of urgent messages, which are
+  /// written ahead of the messages queued by write_message once the message
+  /// being written completes. Bulk transfers split into several messages,
+  /// e.g. result frames, are thereby interleaved with urgent messages. Does
+  /// not block on max_pending_bytes, so callers bound their urgent messages
+  /// \param[in,out] message Message to write
+  void write_urgent_message(TCPMessage&& message) override;
+
+  /// \brief Sets the number of bytes of queued messages above which
+  /// write_message blocks. A larger message is queued once the queue is
+  /// empty. 0 disables the bound
+  /// \param[in] max_pending_bytes Bound on the bytes of queued messages
+  void set_max_pending_bytes(size_t max_pending_bytes) {
+    std::lock_guard<std::mutex> lock(m_write_mtx);
+    m_max_pending_bytes = max_pending_bytes;
+  }
+
+  /// \brief Returns the number of bytes of queued messages
+  size_t pending_bytes() const {
+    std::lock_guard<std::mutex> lock(m_write_mtx);
+    return m_pending_bytes;
+  }
 
   /// \brief Returns whether or not a message is queued to be written
-  bool is_writing() const { return !m_message_queue.empty(); }
+  bool is_writing() const override;
+
+  /// \brief Blocks until at most max_pending queued messages remain to be
+  /// written
+  /// \param[in] max_pending Number of messages which may remain queued
+  void wait_until_written(size_t max_pending = 0) override;
+
+  /// \brief Returns the number of bytes written to the socket so far
+  size_t bytes_written() const override {
+    return m_bytes_written.load(std::memory_order_relaxed);
+  }
 
-  /// \brief Returns a condition variable notified when the session is done
-  /// writing a message
-  std::condition_variable& is_writing_cond() { return m_is_writing; }
+  /// \brief Returns the number of bytes read from the socket so far
+  size_t bytes_read() const override {
+    return m_bytes_read.load(std::memory_order_relaxed);
+  }
 
  private:
+  /// \brief Adds a message to the message-writing queues, see write_message
+  /// \param[in,out] message Message to write
+  /// \param[in] urgent Whether or not the message is queued as urgent
+  void queue_message(TCPMessage&& message, bool urgent);
+
+  /// \brief Writes the message at the front of the urgent queue, or else of
+  /// the bulk queue. Must run on m_socket_strand
   void do_write();
 
+  /// \brief Returns the buffers to write for a message: the packed header
+  /// and body in m_write_buffer, followed by the payload segments
+  std::vector<boost::asio::const_buffer> write_buffers(
+      const TCPMessage& message) const;
+
  private:
-  std::deque<TCPMessage> m_message_queue;
-  TCPMessage m_read_message;
+  using strand_type =
+      boost::asio::strand<boost::asio::io_context::executor_type>;
+
+  struct QueuedMessage {
+    TCPMessage message;
+    size_t bytes;  // Bytes counted by queue_message
+  };
+  // Urgent and bulk messages, and the queue whose front message is being
+  // written, or nullptr. Accessed only on m_socket_strand
+  std::deque<QueuedMessage> m_urgent_queue;
+  std::deque<QueuedMessage> m_message_queue;
+  std::deque<QueuedMessage>* m_write_queue{nullptr};
 
   data_buffer m_read_buffer;
   data_buffer m_write_buffer;
   boost::asio::ip::tcp::socket m_socket;
+  strand_type m_socket_strand;
+  strand_type m_handler_strand;
+  std::shared_ptr<BufferPool> m_buffer_pool;
   std::condition_variable m_is_writing;
-  std::mutex m_write_mtx;
+  mutable std::mutex m_write_mtx;
+  // Number and bytes of messages passed to write_message and not yet
+  // written, and the bound on the bytes, guarded by m_write_mtx
+  size_t m_num_pending_writes{0};
+  size_t m_pending_bytes{0};
+  size_t m_max_pending_bytes{s_default_max_pending_bytes};
+  std::atomic<size_t> m_bytes_written{0};
+  std::atomic<size_t> m_bytes_read{0};
+  // Receipt of the header of the message being read, accessed only on
+  // m_socket_strand
+  logging::Tracer::Clock::time_point m_read_start{};
 
   inline static std::string s_expected_teardown_message{"End of file"};
+  inline static const size_t s_default_max_pending_bytes{1UL << 26U};
 
   std::function<void(const TCPMessage&)> m_message_callback;
 };
@@ -0,0 +1,78 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+/// \brief Server end of a connection to a client, over which messages are
+/// exchanged, e.g. a TCPSession. Received messages are passed to the message
+/// handler of the transport in order of receipt
+class ServerTransport {
+ public:
+  virtual ~ServerTransport() = default;
+
+  /// \brief Starts reading messages
+  virtual void start() = 0;
+
+  /// \brief Adds a message to the message-writing queue. May be called from
+  /// any thread
+  /// \param[in,out] message Message to write
+  virtual void write_message(TCPMessage&& message) = 0;
+
+  /// \brief Adds a latency-critical message, e.g. a request the server waits
+  /// on, to the message-writing queue. Transports may write it ahead of
+  /// messages queued by write_message. Urgent messages are written in order
+  /// of their calls
+  /// \param[in,out] message Message to write
+  virtual void write_urgent_message(TCPMessage&& message) {
+    write_message(std::move(message));
+  }
+
+  /// \brief Returns whether or not a message is queued to be written
+  virtual bool is_writing() const = 0;
+
+  /// \brief Blocks until at most max_pending queued messages remain to be
+  /// written
+  /// \param[in] max_pending Number of messages which may remain queued
+  virtual void wait_until_written(size_t max_pending = 0) = 0;
+
+  /// \brief Returns the number of bytes written so far
+  virtual size_t bytes_written() const = 0;
+
+  /// \brief Returns the number of bytes read so far
+  virtual size_t bytes_read() const = 0;
+};
+
+/// \brief Client end of a connection to a server, e.g. a TCPClient. Messages
+/// are written and handled on the thread running the client's io_context
+class ClientTransport {
+ public:
+  virtual ~ClientTransport() = default;
+
+  /// \brief Asynchronously writes the message
+  /// \param[in,out] message Message to write
+  virtual void write_message(TCPMessage&& message) = 0;
+
+  /// \brief Closes the connection, after which the io_context runs out of
+  /// work of the transport
+  virtual void close() = 0;
+};
+}  // namespace ngraph::runtime::he
@@ -18,7 +18,9 @@
 
 #include "ENCRYPTO_utils/crypto/crypto.h"
 #include "ENCRYPTO_utils/parse_options.h"
+#include "aby/aby_cost_model.hpp"
 #include "aby/aby_util.hpp"
+#include "aby/kernel/dot_relu_aby.hpp"
 #include "aby/kernel/relu_aby.hpp"
 #include "abycore/aby/abyparty.h"
 #include "abycore/circuit/booleancircuits.h"
@@ -87,6 +89,60 @@ TEST(aby, split_vector) {
     EXPECT_EQ(splits[3].first, 8);
     EXPECT_EQ(splits[3].second, 10);
   }
+  {
+    // Only two splits have at least 4 elements
+    auto splits = split_vector(10, 4, 4);
+    EXPECT_EQ(splits.size(), 4);
+    EXPECT_EQ(splits[0].first, 0);
+    EXPECT_EQ(splits[0].second, 5);
+    EXPECT_EQ(splits[1].first, 5);
+    EXPECT_EQ(splits[1].second, 10);
+    EXPECT_EQ(splits[2].first, splits[2].second);
+    EXPECT_EQ(splits[3].first, splits[3].second);
+  }
+  {
+    auto splits = split_vector(3, 2, 4);
+    EXPECT_EQ(splits.size(), 2);
+    EXPECT_EQ(splits[0].first, 0);
+    EXPECT_EQ(splits[0].second, 3);
+    EXPECT_EQ(splits[1].first, splits[1].second);
+  }
+}
+
+TEST(aby, encode_aby_weight) {
+  EXPECT_EQ(encode_aby_weight(1.0, 4), 16);
+  EXPECT_EQ(encode_aby_weight(0.5, 4), 8);
+  EXPECT_EQ(encode_aby_weight(0, 4), 0);
+  // Negative weights are in two's complement
+  EXPECT_EQ(encode_aby_weight(-1.0, 4), static_cast<uint64_t>(-16));
+  EXPECT_EQ(static_cast<int64_t>(encode_aby_weight(-0.25, 16)), -16384);
+}
+
+TEST(aby, dot_relu_cost) {
+  // Small layers avoid the cost of HE scalar products
+  EXPECT_TRUE(prefer_aby_dot_relu(2, 3, 1, 2048, 5));
+  EXPECT_TRUE(prefer_aby_dot_relu(10, 10, 1, 8192, 3));
+
+  // Large batches amortize the HE scalar products over many values
+  EXPECT_FALSE(prefer_aby_dot_relu(784, 100, 4096, 8192, 3));
+
+  auto cost = dot_relu_cost(10, 10, 1, 8192, 3);
+  EXPECT_GT(cost.he, 0);
+  EXPECT_GT(cost.aby, 0);
+}
+
+TEST(aby, choose_mpc_protocol) {
+  // A datacenter link, with 100us round-trips at 8Gbps, favors GMW
+  NetworkProfile datacenter{100, 1000};
+  EXPECT_STREQ(choose_mpc_protocol(datacenter, 10000, 64), "gmw");
+
+  // A WAN link, with 50ms round-trips at 100Mbps, favors Yao
+  NetworkProfile wan{50000, 12.5};
+  EXPECT_STREQ(choose_mpc_protocol(wan, 10000, 64), "yao");
+
+  // GMW's rounds grow with the circuit depth, Yao's are constant
+  EXPECT_GT(relu_circuit_cost(true, wan, 1, 64),
+            relu_circuit_cost(false, wan, 1, 64));
 }
 
 }  // namespace ngraph::runtime::aby
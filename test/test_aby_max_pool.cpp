@@ -0,0 +1,135 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "aby/aby_util.hpp"
+#include "aby/kernel/max_pool_aby.hpp"
+#include "abycore/aby/abyparty.h"
+#include "abycore/circuit/booleancircuits.h"
+#include "abycore/circuit/share.h"
+#include "abycore/sharing/sharing.h"
+#include "gtest/gtest.h"
+
+namespace ngraph::runtime::aby {
+
+auto test_max_pool_circuit = [](size_t num_outputs, size_t window_size,
+                                size_t coeff_modulus, bool relu) {
+  e_sharing sharing = S_BOOL;
+  uint32_t bitlen = 64;
+  size_t num_vals = num_outputs * window_size;
+
+  std::vector<uint64_t> xs(num_vals);
+  std::vector<uint64_t> xc(num_vals);
+  std::vector<uint64_t> r(num_outputs);
+  std::vector<uint64_t> exp_output(num_outputs);
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint64_t> dis(0, coeff_modulus - 1);
+  auto to_signed = [&](uint64_t x) {
+    return x > coeff_modulus / 2
+               ? static_cast<int64_t>(x) - static_cast<int64_t>(coeff_modulus)
+               : static_cast<int64_t>(x);
+  };
+  for (size_t out_idx = 0; out_idx < num_outputs; ++out_idx) {
+    r[out_idx] = dis(gen);
+    int64_t max_val = std::numeric_limits<int64_t>::min();
+    for (size_t window_idx = 0; window_idx < window_size; ++window_idx) {
+      size_t idx = window_idx * num_outputs + out_idx;
+      uint64_t x = dis(gen);
+      xc[idx] = dis(gen);
+      xs[idx] = (x + coeff_modulus - xc[idx]) % coeff_modulus;
+      max_val = std::max(max_val, to_signed(x));
+    }
+    if (relu) {
+      max_val = std::max(max_val, 0L);
+    }
+    auto max_int = static_cast<uint64_t>(
+        max_val < 0 ? max_val + static_cast<int64_t>(coeff_modulus)
+                    : max_val);
+    exp_output[out_idx] = (max_int + r[out_idx]) % coeff_modulus;
+  }
+
+  std::vector<uint64_t> zeros(num_vals, 0);
+  std::vector<uint64_t> output_zeros(num_outputs, 0);
+
+  auto server_fun = [&]() {
+    auto server = std::make_unique<ABYParty>(
+        SERVER, "0.0.0.0", 30001, get_sec_lvl(128), 64, 1, MT_OT, 100000);
+    BooleanCircuit& circ = dynamic_cast<BooleanCircuit&>(
+        *server->GetSharings()[sharing]->GetCircuitBuildRoutine());
+
+    max_pool_aby(circ, num_outputs, window_size, xs, zeros, r, bitlen,
+                 coeff_modulus, relu);
+    server->ExecCircuit();
+    server->Reset();
+  };
+
+  auto client_fun = [&]() {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    auto client = std::make_unique<ABYParty>(
+        CLIENT, "localhost", 30001, get_sec_lvl(128), 64, 1, MT_OT, 100000);
+    BooleanCircuit& circ = dynamic_cast<BooleanCircuit&>(
+        *client->GetSharings()[sharing]->GetCircuitBuildRoutine());
+
+    share* max_out = max_pool_aby(circ, num_outputs, window_size, zeros, xc,
+                                  output_zeros, bitlen, coeff_modulus, relu);
+    client->ExecCircuit();
+
+    uint32_t out_bitlen;
+    uint32_t out_num_vals;
+    uint64_t* out_vals;
+    max_out->get_clear_value_vec(&out_vals, &out_bitlen, &out_num_vals);
+    EXPECT_EQ(out_num_vals, num_outputs);
+    for (size_t i = 0; i < out_num_vals; ++i) {
+      EXPECT_EQ(out_vals[i], exp_output[i]);
+    }
+    client->Reset();
+  };
+
+  std::thread server_thread(server_fun);
+  client_fun();
+  server_thread.join();
+};
+
+TEST(aby, max_pool_circuit_10_4_q9) {
+  test_max_pool_circuit(10, 4, 9, false);
+}
+
+TEST(aby, max_pool_circuit_10_4_q9_relu) {
+  test_max_pool_circuit(10, 4, 9, true);
+}
+
+TEST(aby, max_pool_circuit_100_3_q_large_relu) {
+  test_max_pool_circuit(100, 3, 18014398509404161, true);
+}
+
+TEST(aby, max_pool_aby_input_index) {
+  // 2 batch entries, 3 outputs with windows of size 2
+  EXPECT_EQ(max_pool_aby_input_index(0, 0, 3, 2), 0);
+  EXPECT_EQ(max_pool_aby_input_index(1, 0, 3, 2), 3);
+  EXPECT_EQ(max_pool_aby_input_index(1, 2, 3, 2), 5);
+  EXPECT_EQ(max_pool_aby_input_index(0, 3, 3, 2), 6);
+  EXPECT_EQ(max_pool_aby_input_index(1, 5, 3, 2), 11);
+}
+
+}  // namespace ngraph::runtime::aby
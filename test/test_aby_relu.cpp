@@ -14,6 +14,8 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
+#include <optional>
 #include <random>
 
 #include "ENCRYPTO_utils/crypto/crypto.h"
@@ -28,9 +30,12 @@
 
 namespace ngraph::runtime::aby {
 
-auto test_relu_circuit = [](size_t num_vals, size_t coeff_modulus) {
+auto test_relu_circuit = [](size_t num_vals, size_t coeff_modulus,
+                            size_t truncate_bits = 0,
+                            CircuitVariant variant = CircuitVariant::size,
+                            uint32_t bitlen = 64,
+                            std::optional<uint64_t> bound = std::nullopt) {
   e_sharing sharing = S_BOOL;
-  uint32_t bitlen = 64;
 
   std::vector<uint64_t> zeros(num_vals, 0);
 
@@ -53,7 +58,13 @@ auto test_relu_circuit = [](size_t num_vals, size_t coeff_modulus) {
     // Relu circuit expects transformation (-q/2, q/2) => (0,q) by adding q to
     // values < 0
     bigger_than_zero[i] = (x[i] % coeff_modulus) <= (coeff_modulus / 2);
-    exp_output[i] = bigger_than_zero[i] ? (x[i] + r[i]) % coeff_modulus : r[i];
+    uint64_t relu = x[i] % coeff_modulus;
+    if (bound.has_value()) {
+      relu = std::min(relu, *bound);
+    }
+    exp_output[i] = bigger_than_zero[i]
+                        ? ((relu >> truncate_bits) + r[i]) % coeff_modulus
+                        : r[i];
 
     EXPECT_EQ((xs[i] + xc[i]) % coeff_modulus, x[i] % coeff_modulus);
   }
@@ -69,7 +80,8 @@ auto test_relu_circuit = [](size_t num_vals, size_t coeff_modulus) {
 
     std::this_thread::sleep_for(std::chrono::seconds(1));
 
-    relu_aby(circ, num_vals, xs, zeros, r, bitlen, coeff_modulus);
+    bounded_relu_aby(circ, num_vals, xs, zeros, r, bitlen, coeff_modulus,
+                     bound, truncate_bits, variant);
     server->ExecCircuit();
     server->Reset();
   };
@@ -85,7 +97,8 @@ auto test_relu_circuit = [](size_t num_vals, size_t coeff_modulus) {
         *sharings[sharing]->GetCircuitBuildRoutine());
 
     share* relu_out =
-        relu_aby(circ, num_vals, zeros, xc, zeros, bitlen, coeff_modulus);
+        bounded_relu_aby(circ, num_vals, zeros, xc, zeros, bitlen,
+                         coeff_modulus, bound, truncate_bits, variant);
 
     client->ExecCircuit();
 
@@ -128,4 +141,36 @@ TEST(aby, relu_circuit_100_q_large) {
   test_relu_circuit(100, 18014398509404161);
 }
 
+TEST(aby, relu_circuit_100_q_large_truncate) {
+  test_relu_circuit(100, 18014398509404161, 3);
+}
+
+TEST(aby, relu_circuit_100_q9_narrow) {
+  // 9 has 4 bits, plus a carry bit
+  test_relu_circuit(100, 9, 0, CircuitVariant::size, 5);
+}
+
+TEST(aby, relu_circuit_100_q_large_truncate_narrow) {
+  // 18014398509404161 has 54 bits, plus a carry bit
+  test_relu_circuit(100, 18014398509404161, 3, CircuitVariant::size, 55);
+  test_relu_circuit(100, 18014398509404161, 3, CircuitVariant::depth, 55);
+}
+
+TEST(aby, relu_circuit_100_q9_depth) {
+  test_relu_circuit(100, 9, 0, CircuitVariant::depth);
+}
+
+TEST(aby, relu_circuit_100_q_large_truncate_depth) {
+  test_relu_circuit(100, 18014398509404161, 3, CircuitVariant::depth);
+}
+
+TEST(aby, bounded_relu_circuit_100_q_large) {
+  test_relu_circuit(100, 18014398509404161, 0, CircuitVariant::size, 64, 50);
+  test_relu_circuit(100, 18014398509404161, 0, CircuitVariant::depth, 64, 50);
+}
+
+TEST(aby, bounded_relu_circuit_100_q_large_truncate) {
+  test_relu_circuit(100, 18014398509404161, 3, CircuitVariant::size, 64, 50);
+}
+
 }  // namespace ngraph::runtime::aby
@@ -518,4 +518,39 @@ NGRAPH_TEST(${BACKEND_NAME},
       true, false, false);
 }
 
+
+NGRAPH_TEST(${BACKEND_NAME}, avg_pool_1d_padded) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<he::HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 1, 3};
+  for (bool include_padding : std::vector<bool>{false, true}) {
+    for (bool arg1_encrypted : std::vector<bool>{false, true}) {
+      auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+      auto t = std::make_shared<op::AvgPool>(a, Shape{2}, Strides{1},
+                                             Shape{1}, Shape{1},
+                                             include_padding);
+      auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+      const auto& arg1_config =
+          test::config_from_flags(false, arg1_encrypted, false);
+      std::string error_str;
+      he_backend->set_config({{a->get_name(), arg1_config}}, error_str);
+
+      auto t_a =
+          test::tensor_from_flags(*he_backend, shape_a, arg1_encrypted, false);
+      auto t_result = test::tensor_from_flags(*he_backend, t->get_shape(),
+                                              arg1_encrypted, false);
+      copy_data(t_a, std::vector<float>{1, 2, 3});
+
+      auto handle = backend->compile(f);
+      handle->call_with_validate({t_result}, {t_a});
+      std::vector<float> output =
+          include_padding ? std::vector<float>{0.5, 1.5, 2.5, 1.5}
+                          : std::vector<float>{1, 1.5, 2.5, 3};
+      EXPECT_TRUE(
+          test::all_close(read_vector<float>(t_result), output, 1e-3f));
+    }
+  }
+}
 }  // namespace ngraph::runtime::he
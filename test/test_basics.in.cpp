@@ -66,6 +66,29 @@ NGRAPH_TEST(${BACKEND_NAME}, create_plain_tensor) {
   he_backend->create_plain_tensor(element::f32, shape);
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, client_keys) {
+  auto client_backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_client_backend = static_cast<HESealBackend*>(client_backend.get());
+  auto server_backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_server_backend = static_cast<HESealBackend*>(server_backend.get());
+
+  // The server encrypts under the keys set by the client instead of
+  // generating its own
+  he_server_backend->set_public_key(*he_client_backend->get_public_key());
+  he_server_backend->set_relin_keys(*he_client_backend->get_relin_keys());
+  EXPECT_NE(he_server_backend->get_relin_keys(), nullptr);
+
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  HEPlaintext input({1, 2, 3});
+  he_server_backend->encrypt(cipher, input, element::f32, false);
+  HEPlaintext output;
+  he_client_backend->decrypt(output, *cipher, input.size(), false);
+  ASSERT_EQ(output.size(), input.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    EXPECT_NEAR(output[i], input[i], 1e-3);
+  }
+}
+
 NGRAPH_TEST(${BACKEND_NAME}, validate_call_input_count) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
 
@@ -0,0 +1,76 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "tcp/buffer_pool.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(buffer_pool, reuse) {
+  auto pool = std::make_shared<BufferPool>(2);
+
+  const char* data = nullptr;
+  {
+    auto buffer = pool->acquire(1000);
+    EXPECT_EQ(buffer->size(), 1000);
+    data = buffer->data();
+    EXPECT_EQ(pool->num_idle_buffers(), 0);
+  }
+  EXPECT_EQ(pool->num_idle_buffers(), 1);
+
+  // A smaller request reuses the released buffer, keeping its capacity
+  auto buffer = pool->acquire(10);
+  EXPECT_EQ(buffer->size(), 10);
+  EXPECT_GE(buffer->capacity(), 1000);
+  EXPECT_EQ(buffer->data(), data);
+  EXPECT_EQ(pool->num_idle_buffers(), 0);
+}
+
+TEST(buffer_pool, best_fit) {
+  auto pool = std::make_shared<BufferPool>(4);
+  {
+    auto small = pool->acquire(10);
+    auto large = pool->acquire(1000);
+  }
+  EXPECT_EQ(pool->num_idle_buffers(), 2);
+
+  auto fit = pool->acquire(100);
+  EXPECT_GE(fit->capacity(), 1000);
+  auto small = pool->acquire(5);
+  EXPECT_LT(small->capacity(), 1000);
+}
+
+TEST(buffer_pool, max_buffers) {
+  auto pool = std::make_shared<BufferPool>(1);
+  {
+    auto buffer0 = pool->acquire(10);
+    auto buffer1 = pool->acquire(10);
+  }
+  EXPECT_EQ(pool->num_idle_buffers(), 1);
+}
+
+TEST(buffer_pool, outlives_pool) {
+  auto pool = std::make_shared<BufferPool>();
+  auto buffer = pool->acquire(10);
+  pool = nullptr;
+  // Releasing the buffer after the pool is destroyed frees it
+  buffer = nullptr;
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/compact_slots_seal.hpp"
+#include "seal/seal.h"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+seal::Ciphertext encrypt_slots(HESealBackend& he_backend,
+                               const std::vector<double>& values) {
+  seal::Plaintext plain;
+  he_backend.get_ckks_encoder()->encode(values, he_backend.get_scale(), plain);
+  seal::Ciphertext cipher;
+  he_backend.get_encryptor()->encrypt(plain, cipher);
+  return cipher;
+}
+
+std::vector<double> decrypt_slots(HESealBackend& he_backend,
+                                  const seal::Ciphertext& cipher) {
+  seal::Plaintext plain;
+  he_backend.get_decryptor()->decrypt(cipher, plain);
+  std::vector<double> values;
+  he_backend.get_ckks_encoder()->decode(plain, values);
+  return values;
+}
+}  // namespace
+
+TEST(compact_slots_seal, capacity_and_steps) {
+  EXPECT_EQ(compaction_capacity(64, 4096), 64U);
+  EXPECT_EQ(compaction_capacity(3, 16), 4U);
+  EXPECT_EQ(compaction_capacity(9, 16), 1U);
+  EXPECT_EQ(compaction_steps(9, 16), std::set<int>{});
+  EXPECT_EQ(compaction_steps(3, 16), (std::set<int>{-6, -3, 3, 6}));
+}
+
+TEST(compact_slots_seal, compact_and_expand) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t slot_count = he_backend->get_ckks_encoder()->slot_count();
+  size_t batch_size = 3;
+  auto galois_keys =
+      he_backend->get_galois_keys(compaction_steps(batch_size, slot_count));
+
+  // Slots past the batch store other values, which the mask removes
+  size_t count = 5;
+  std::vector<seal::Ciphertext> ciphers;
+  std::vector<std::vector<double>> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i].resize(slot_count);
+    for (size_t slot = 0; slot < slot_count; ++slot) {
+      values[i][slot] = 0.1 * static_cast<double>(i + 1) +
+                        0.01 * static_cast<double>(slot % 5);
+    }
+    ciphers.emplace_back(encrypt_slots(*he_backend, values[i]));
+  }
+  std::vector<const seal::Ciphertext*> cipher_ptrs;
+  for (const auto& cipher : ciphers) {
+    cipher_ptrs.emplace_back(&cipher);
+  }
+
+  seal::Ciphertext packed;
+  compact_slots_seal(cipher_ptrs, batch_size, packed, *galois_keys,
+                     *he_backend);
+  auto context = he_backend->get_context();
+  EXPECT_EQ(context->get_context_data(packed.parms_id())->chain_index() + 1,
+            context->get_context_data(ciphers[0].parms_id())->chain_index());
+  EXPECT_DOUBLE_EQ(packed.scale(), ciphers[0].scale());
+
+  auto packed_values = decrypt_slots(*he_backend, packed);
+  for (size_t slot = 0; slot < slot_count; ++slot) {
+    size_t i = slot / batch_size;
+    double expected = i < count ? values[i][slot % batch_size] : 0;
+    EXPECT_NEAR(packed_values[slot], expected, 1e-3) << "slot " << slot;
+  }
+
+  std::vector<seal::Ciphertext> expanded;
+  expand_slots_seal(packed, batch_size, count, expanded, *galois_keys,
+                    *he_backend);
+  ASSERT_EQ(expanded.size(), count);
+  for (size_t i = 0; i < count; ++i) {
+    auto expanded_values = decrypt_slots(*he_backend, expanded[i]);
+    for (size_t slot = 0; slot < batch_size; ++slot) {
+      EXPECT_NEAR(expanded_values[slot], values[i][slot], 1e-3)
+          << "value " << i << ", slot " << slot;
+    }
+  }
+}
+
+}  // namespace ngraph::runtime::he
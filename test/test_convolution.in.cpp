@@ -17,6 +17,8 @@
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/convolution_seal.hpp"
+#include "seal/kernel/convolution_winograd_seal.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -893,4 +895,386 @@ NGRAPH_TEST(${BACKEND_NAME},
       true, true, false, false);
 }
 
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_auto_packing_layout) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 2, 5, 5};
+  Shape shape_b{3, 2, 3, 3};
+  std::vector<float> input_a(shape_size(shape_a));
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 7);
+  }
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = static_cast<float>(i % 5) - 2;
+  }
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b, input_b);
+  auto t = std::make_shared<op::Convolution>(a, b, Strides{2, 1});
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::vector<float> expected(shape_size(t->get_shape()), 0);
+  const Shape& out_shape = t->get_shape();
+  for (size_t oc = 0; oc < out_shape[1]; ++oc) {
+    for (size_t oh = 0; oh < out_shape[2]; ++oh) {
+      for (size_t ow = 0; ow < out_shape[3]; ++ow) {
+        float sum = 0;
+        for (size_t c = 0; c < shape_b[1]; ++c) {
+          for (size_t kh = 0; kh < shape_b[2]; ++kh) {
+            for (size_t kw = 0; kw < shape_b[3]; ++kw) {
+              size_t h = 2 * oh + kh;
+              size_t w = ow + kw;
+              sum += input_b[((oc * shape_b[1] + c) * shape_b[2] + kh) *
+                                 shape_b[3] +
+                             kw] *
+                     input_a[(c * shape_a[2] + h) * shape_a[3] + w];
+            }
+          }
+        }
+        expected[(oc * out_shape[2] + oh) * out_shape[3] + ow] = sum;
+      }
+    }
+  }
+
+  std::string error_str;
+  EXPECT_ANY_THROW(
+      he_backend->set_config({{"packing_layout", "channel"}}, error_str));
+  he_backend->set_config(
+      {{"packing_layout", "auto"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  EXPECT_TRUE(he_backend->auto_packing_layout());
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+  copy_data(t_a, input_a);
+
+  // Either layout computes the same result
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_tiled_chain) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 2, 7, 6};
+  Shape shape_b{3, 2, 3, 3};
+  Shape shape_c{2, 3, 3, 3};
+  std::vector<float> input_a(shape_size(shape_a));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 7);
+  }
+  auto make_filters = [](const Shape& shape) {
+    std::vector<float> filters(shape_size(shape));
+    for (size_t i = 0; i < filters.size(); ++i) {
+      filters[i] = 0.5f * static_cast<float>(i % 5) - 1;
+    }
+    return op::Constant::create(element::f32, shape, filters);
+  };
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto conv1 = std::make_shared<op::Convolution>(
+      a, make_filters(shape_b), Strides{1, 1}, Strides{1, 1},
+      CoordinateDiff{1, 1}, CoordinateDiff{1, 1});
+  auto conv2 = std::make_shared<op::Convolution>(conv1, make_filters(shape_c));
+  auto f = std::make_shared<Function>(conv2, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  copy_data(t_a, input_a);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, conv2->get_shape(), true, false);
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  auto expected = read_vector<float>(t_result);
+
+  // Tiles of 2 rows compute shared intermediate rows once
+  he_backend->set_config(
+      {{"conv_tile_rows", "2"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  EXPECT_EQ(he_backend->conv_tile_rows(), 2U);
+  auto tiled_result =
+      test::tensor_from_flags(*he_backend, conv2->get_shape(), true, false);
+  auto tiled_handle = backend->compile(f);
+  tiled_handle->call_with_validate({tiled_result}, {t_a});
+  EXPECT_TRUE(
+      test::all_close(read_vector<float>(tiled_result), expected, 1e-2f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_index_table) {
+  // Taps in the padding are left out
+  auto table = convolution_seal_index_table(
+      Shape{1, 1, 3}, Shape{1, 1, 2}, Shape{1, 1, 4}, Strides{1}, Strides{1},
+      CoordinateDiff{1}, CoordinateDiff{1}, Strides{1}, 0, 1, 1, 0, 0, 1);
+  EXPECT_EQ(table.offsets, (std::vector<size_t>{0, 1, 3, 5, 6}));
+  EXPECT_EQ(table.input_indices, (std::vector<uint32_t>{0, 0, 1, 1, 2, 2}));
+  EXPECT_EQ(table.filter_indices, (std::vector<uint32_t>{1, 0, 1, 0, 1, 0}));
+}
+NGRAPH_TEST(${BACKEND_NAME}, group_convolution_index_table) {
+  // A single group matches the generic convolution
+  Shape data_shape{2, 3, 5, 4};
+  Shape filters_shape{2, 3, 3, 2};
+  Shape out_shape{2, 2, 3, 4};
+  Strides strides{2, 1};
+  Strides dilations{1, 2};
+  CoordinateDiff padding_below{1, 1};
+  CoordinateDiff padding_above{1, 1};
+  Strides data_dilations{1, 1};
+  auto expected = convolution_seal_index_table(
+      data_shape, filters_shape, out_shape, strides, dilations, padding_below,
+      padding_above, data_dilations, 0, 1, 1, 0, 0, 1);
+  auto table = group_convolution_seal_index_table(
+      data_shape, filters_shape, out_shape, strides, dilations, padding_below,
+      padding_above, data_dilations, 1);
+  EXPECT_EQ(table.offsets, expected.offsets);
+  EXPECT_EQ(table.input_indices, expected.input_indices);
+  EXPECT_EQ(table.filter_indices, expected.filter_indices);
+
+  // Depthwise outputs only read their own channel
+  auto depthwise = group_convolution_seal_index_table(
+      Shape{1, 2, 3}, Shape{2, 1, 2}, Shape{1, 2, 2}, Strides{1}, Strides{1},
+      CoordinateDiff{0}, CoordinateDiff{0}, Strides{1}, 2);
+  EXPECT_EQ(depthwise.offsets, (std::vector<size_t>{0, 2, 4, 6, 8}));
+  EXPECT_EQ(depthwise.input_indices,
+            (std::vector<uint32_t>{0, 1, 1, 2, 3, 4, 4, 5}));
+  EXPECT_EQ(depthwise.filter_indices,
+            (std::vector<uint32_t>{0, 1, 0, 1, 2, 3, 2, 3}));
+  EXPECT_ANY_THROW(group_convolution_seal_index_table(
+      Shape{1, 2, 3}, Shape{2, 1, 2}, Shape{1, 2, 2}, Strides{1}, Strides{1},
+      CoordinateDiff{0}, CoordinateDiff{0}, Strides{1}, 3));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, group_convolution_2d_depthwise) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 3, 4, 4};
+  Shape shape_b{3, 1, 3, 3};
+  std::vector<float> input_a(shape_size(shape_a));
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 9);
+  }
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.5f * static_cast<float>(i % 4) - 1;
+  }
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b, input_b);
+  auto t = std::make_shared<op::GroupConvolution>(
+      a, b, Strides{1, 1}, Strides{1, 1}, CoordinateDiff{1, 1},
+      CoordinateDiff{1, 1}, Strides{1, 1}, 3);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  const Shape& out_shape = t->get_shape();
+  std::vector<float> expected(shape_size(out_shape), 0);
+  for (size_t c = 0; c < out_shape[1]; ++c) {
+    for (size_t oh = 0; oh < out_shape[2]; ++oh) {
+      for (size_t ow = 0; ow < out_shape[3]; ++ow) {
+        float sum = 0;
+        for (size_t kh = 0; kh < 3; ++kh) {
+          for (size_t kw = 0; kw < 3; ++kw) {
+            auto h = static_cast<std::ptrdiff_t>(oh + kh) - 1;
+            auto w = static_cast<std::ptrdiff_t>(ow + kw) - 1;
+            if (h < 0 || w < 0 || h >= 4 || w >= 4) {
+              continue;
+            }
+            sum += input_b[(c * 3 + kh) * 3 + kw] *
+                   input_a[(c * 4 + static_cast<size_t>(h)) * 4 +
+                           static_cast<size_t>(w)];
+          }
+        }
+        expected[(c * out_shape[2] + oh) * out_shape[3] + ow] = sum;
+      }
+    }
+  }
+
+  std::string error_str;
+  he_backend->set_config(
+      {{a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, out_shape, true, false);
+  copy_data(t_a, input_a);
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+}
+NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_pointwise) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  EXPECT_TRUE(pointwise_convolution(Shape{4, 3, 1, 1}, Strides{1, 1},
+                                    CoordinateDiff{0, 0}, CoordinateDiff{0, 0},
+                                    Strides{1, 1}));
+  EXPECT_FALSE(pointwise_convolution(Shape{4, 3, 1, 1}, Strides{2, 1},
+                                     CoordinateDiff{0, 0},
+                                     CoordinateDiff{0, 0}, Strides{1, 1}));
+  EXPECT_FALSE(pointwise_convolution(Shape{4, 3, 3, 1}, Strides{1, 1},
+                                     CoordinateDiff{0, 0},
+                                     CoordinateDiff{0, 0}, Strides{1, 1}));
+
+  // More positions and output channels than fit in one block
+  Shape shape_a{2, 3, 3, 4};
+  Shape shape_b{20, 3, 1, 1};
+  std::vector<float> input_a(shape_size(shape_a));
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 11);
+  }
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.5f * static_cast<float>(i % 5) - 1;
+  }
+  Shape out_shape{2, 20, 3, 4};
+  size_t spatial_size = 12;
+  std::vector<float> expected(shape_size(out_shape), 0);
+  for (size_t n = 0; n < 2; ++n) {
+    for (size_t oc = 0; oc < 20; ++oc) {
+      for (size_t p = 0; p < spatial_size; ++p) {
+        float sum = 0;
+        for (size_t c = 0; c < 3; ++c) {
+          sum += input_b[oc * 3 + c] * input_a[(n * 3 + c) * spatial_size + p];
+        }
+        expected[(n * 20 + oc) * spatial_size + p] = sum;
+      }
+    }
+  }
+
+  // Constant filters are grouped by weight, parameter filters are not
+  for (bool constant_filters : {true, false}) {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+    std::shared_ptr<Node> b;
+    ParameterVector parameters{a};
+    if (constant_filters) {
+      b = op::Constant::create(element::f32, shape_b, input_b);
+    } else {
+      auto filters = std::make_shared<op::Parameter>(element::f32, shape_b);
+      parameters.emplace_back(filters);
+      b = filters;
+    }
+    auto t = std::make_shared<op::Convolution>(a, b);
+    auto f = std::make_shared<Function>(t, parameters);
+    std::string error_str;
+    he_backend->set_config(
+        {{a->get_name(), test::config_from_flags(false, true, false)}},
+        error_str);
+
+    auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+    auto t_b = test::tensor_from_flags(*he_backend, shape_b, false, false);
+    auto t_result =
+        test::tensor_from_flags(*he_backend, out_shape, true, false);
+    copy_data(t_a, input_a);
+    copy_data(t_b, input_b);
+    auto handle = backend->compile(f);
+    if (constant_filters) {
+      handle->call_with_validate({t_result}, {t_a});
+    } else {
+      handle->call_with_validate({t_result}, {t_a, t_b});
+    }
+    EXPECT_TRUE(
+        test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+  }
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, convolution_2d_winograd) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  EXPECT_TRUE(winograd_convolution(Shape{3, 2, 3, 3}, Strides{1, 1},
+                                   Strides{1, 1}, Strides{1, 1}));
+  EXPECT_FALSE(winograd_convolution(Shape{3, 2, 3, 3}, Strides{2, 2},
+                                    Strides{1, 1}, Strides{1, 1}));
+  EXPECT_FALSE(winograd_convolution(Shape{3, 2, 5, 5}, Strides{1, 1},
+                                    Strides{1, 1}, Strides{1, 1}));
+
+  // Padded, with an odd output size to clip the border tiles
+  Shape shape_a{1, 2, 5, 5};
+  Shape shape_b{3, 2, 3, 3};
+  Shape out_shape{1, 3, 5, 5};
+  std::vector<float> input_a(shape_size(shape_a));
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 7);
+  }
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.25f * static_cast<float>(i % 9) - 1;
+  }
+  std::vector<float> expected(shape_size(out_shape), 0);
+  for (size_t oc = 0; oc < 3; ++oc) {
+    for (size_t row = 0; row < 5; ++row) {
+      for (size_t col = 0; col < 5; ++col) {
+        float sum = 0;
+        for (size_t c = 0; c < 2; ++c) {
+          for (size_t k = 0; k < 3; ++k) {
+            for (size_t l = 0; l < 3; ++l) {
+              size_t in_row = row + k;
+              size_t in_col = col + l;
+              if (in_row < 1 || in_col < 1 || in_row > 5 || in_col > 5) {
+                continue;
+              }
+              sum += input_b[((oc * 2 + c) * 3 + k) * 3 + l] *
+                     input_a[(c * 5 + in_row - 1) * 5 + in_col - 1];
+            }
+          }
+        }
+        expected[(oc * 5 + row) * 5 + col] = sum;
+      }
+    }
+  }
+
+  auto transformed = winograd_filter_transform(
+      std::vector<HEType>(shape_size(shape_b),
+                          HEType(HEPlaintext({1.0}), false)),
+      shape_b);
+  ASSERT_TRUE(transformed.has_value());
+  EXPECT_EQ(transformed->size(), 3 * 2 * 16);
+  // G g G^T of an all-ones filter has corner 1 and center 9 / 4
+  EXPECT_NEAR((*transformed)[0].get_plaintext()[0], 1, 1e-9);
+  EXPECT_NEAR((*transformed)[5].get_plaintext()[0], 2.25, 1e-9);
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b, input_b);
+  auto t = std::make_shared<op::Convolution>(
+      a, b, Strides{1, 1}, Strides{1, 1}, CoordinateDiff{1, 1},
+      CoordinateDiff{1, 1});
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+  std::string error_str;
+  he_backend->set_config(
+      {{"winograd_convolutions", "true"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, out_shape, true, false);
+  copy_data(t_a, input_a);
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+
+  // The configured kernel of a node replaces the cheaper Winograd kernel
+  auto a_direct = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto t_direct = std::make_shared<op::Convolution>(
+      a_direct, b, Strides{1, 1}, Strides{1, 1}, CoordinateDiff{1, 1},
+      CoordinateDiff{1, 1});
+  auto f_direct =
+      std::make_shared<Function>(t_direct, ParameterVector{a_direct});
+  he_backend->set_config(
+      {{"winograd_convolutions", "true"},
+       {a_direct->get_name(), test::config_from_flags(false, true, false)},
+       {t_direct->get_name(), "kernel_direct"}},
+      error_str);
+  auto t_direct_result =
+      test::tensor_from_flags(*he_backend, out_shape, true, false);
+  auto handle_direct = backend->compile(f_direct);
+  handle_direct->call_with_validate({t_direct_result}, {t_a});
+  EXPECT_TRUE(
+      test::all_close(read_vector<float>(t_direct_result), expected, 1e-2f));
+}
 }  // namespace ngraph::runtime::he
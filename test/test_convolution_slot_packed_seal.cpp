@@ -0,0 +1,113 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/convolution_slot_packed_seal.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(convolution_slot_packed_seal, shape) {
+  EXPECT_EQ(slot_packed_convolution_shape(Shape{1, 5, 5}, Shape{2, 1, 3, 3},
+                                          Strides{1, 1}, Strides{1, 1}),
+            (Shape{3, 3}));
+  EXPECT_EQ(slot_packed_convolution_shape(Shape{1, 5, 5}, Shape{2, 1, 2, 2},
+                                          Strides{2, 2}, Strides{1, 1}),
+            (Shape{2, 2}));
+  EXPECT_EQ(slot_packed_convolution_shape(Shape{1, 5, 5}, Shape{2, 1, 2, 2},
+                                          Strides{1, 1}, Strides{2, 2}),
+            (Shape{3, 3}));
+  EXPECT_ANY_THROW({
+    slot_packed_convolution_shape(Shape{2, 5, 5}, Shape{2, 1, 2, 2},
+                                  Strides{1, 1}, Strides{1, 1});
+  });
+}
+
+TEST(convolution_slot_packed_seal, convolution) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  auto test_conv = [&](const Shape& data_shape, const Shape& filter_shape,
+                       const Strides& strides, const Strides& dilations) {
+    std::vector<double> data(shape_size(data_shape));
+    std::vector<double> filter(shape_size(filter_shape));
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = 0.1 * static_cast<double>(i % 11);
+    }
+    for (size_t i = 0; i < filter.size(); ++i) {
+      filter[i] = static_cast<double>(i % 5) - 2;
+    }
+
+    auto& encoder = *he_backend->get_ckks_encoder();
+    seal::Plaintext plain;
+    encoder.encode(data, he_backend->get_scale(), plain);
+    SealCiphertextWrapper cipher;
+    he_backend->get_encryptor()->encrypt(plain, cipher.ciphertext());
+
+    std::vector<SealCiphertextWrapper> result;
+    convolution_slot_packed_seal(cipher, filter, data_shape, filter_shape,
+                                 strides, dilations, result, *he_backend);
+    ASSERT_EQ(result.size(), filter_shape[0]);
+
+    Shape out_shape = slot_packed_convolution_shape(data_shape, filter_shape,
+                                                    strides, dilations);
+    size_t rows = data_shape[1];
+    size_t cols = data_shape[2];
+    for (size_t oc = 0; oc < filter_shape[0]; ++oc) {
+      seal::Plaintext decrypted;
+      he_backend->get_decryptor()->decrypt(result[oc].ciphertext(), decrypted);
+      std::vector<double> output;
+      encoder.decode(decrypted, output);
+
+      for (size_t oh = 0; oh < out_shape[0]; ++oh) {
+        for (size_t ow = 0; ow < out_shape[1]; ++ow) {
+          double expected = 0;
+          for (size_t c = 0; c < filter_shape[1]; ++c) {
+            for (size_t kh = 0; kh < filter_shape[2]; ++kh) {
+              for (size_t kw = 0; kw < filter_shape[3]; ++kw) {
+                size_t h = oh * strides[0] + kh * dilations[0];
+                size_t w = ow * strides[1] + kw * dilations[1];
+                size_t filter_idx =
+                    ((oc * filter_shape[1] + c) * filter_shape[2] + kh) *
+                        filter_shape[3] +
+                    kw;
+                expected +=
+                    filter[filter_idx] * data[(c * rows + h) * cols + w];
+              }
+            }
+          }
+          size_t slot =
+              slot_packed_convolution_slot(oh, ow, data_shape, strides);
+          EXPECT_NEAR(output[slot], expected, 1e-2);
+        }
+      }
+    }
+  };
+
+  test_conv(Shape{1, 4, 4}, Shape{1, 1, 2, 2}, Strides{1, 1}, Strides{1, 1});
+  test_conv(Shape{2, 5, 5}, Shape{3, 2, 3, 3}, Strides{1, 1}, Strides{1, 1});
+  test_conv(Shape{2, 6, 6}, Shape{2, 2, 2, 2}, Strides{2, 2}, Strides{1, 1});
+  test_conv(Shape{1, 6, 6}, Shape{2, 1, 2, 2}, Strides{1, 1}, Strides{2, 2});
+}
+
+}  // namespace ngraph::runtime::he
@@ -16,6 +16,7 @@
 
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
+#include "seal/he_primitive_counter.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
@@ -307,4 +308,335 @@ NGRAPH_TEST(${BACKEND_NAME},
            true, false, false);
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, dot_lazy_mod) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  std::string param_str = R"(
+    {
+        "scheme_name" : "HE_SEAL",
+        "poly_modulus_degree" : 8192,
+        "security_level" : 0,
+        "coeff_modulus" : [24, 22, 22, 22, 22, 22, 30],
+        "scale" : 4194304
+    })";
+  std::string error_str;
+  he_backend->set_config({{"encryption_parameters", param_str}}, error_str);
+  he_backend->lazy_mod() = true;
+
+  size_t dim1 = 4;
+  size_t dim2 = 64;
+  Shape shape_a{dim1, dim2};
+  Shape shape_b{dim2};
+  auto a = op::Constant::create(element::f32, shape_a,
+                                std::vector<float>(dim1 * dim2, 0.25));
+  auto b = std::make_shared<op::Parameter>(element::f32, shape_b);
+  auto t = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{b});
+
+  he_backend->set_config(
+      {{b->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+
+  auto t_b = test::tensor_from_flags(*he_backend, shape_b, true, false);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+
+  std::vector<float> input_b(dim2);
+  for (size_t i = 0; i < dim2; ++i) {
+    input_b[i] = static_cast<float>(i) / dim2;
+  }
+  copy_data(t_b, input_b);
+
+  // 0.25 * sum_i (i / 64) = 0.25 * 63 / 2
+  std::vector<float> exp_output(dim1, 7.875);
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_output, 1e-2f));
+  he_backend->lazy_mod() = false;
+}
+
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_sparse_constant_weights) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Zero, one, minus one and other weights
+  Shape shape_a{2, 4};
+  Shape shape_b{4, 3};
+  std::vector<float> weights{1,  0, -1,   //
+                             0,  1, 0.5,  //
+                             -1, 0, 0,    //
+                             1,  -1, 2};
+  for (bool arg1_encrypted : std::vector<bool>{false, true}) {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+    auto b = op::Constant::create(element::f32, shape_b, weights);
+    auto t = std::make_shared<op::Dot>(a, b);
+    auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+    std::string error_str;
+    he_backend->set_config(
+        {{a->get_name(),
+          test::config_from_flags(false, arg1_encrypted, false)}},
+        error_str);
+
+    auto t_a =
+        test::tensor_from_flags(*he_backend, shape_a, arg1_encrypted, false);
+    auto t_result = test::tensor_from_flags(*he_backend, t->get_shape(),
+                                            arg1_encrypted, false);
+    copy_data(t_a, std::vector<float>{1, 2, 3, 4, -1, 0.5, 2, -3});
+
+    auto handle = backend->compile(f);
+    handle->call_with_validate({t_result}, {t_a});
+    EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                                std::vector<float>{2, -2, 8, -6, 3.5, -4.75},
+                                1e-2f));
+  }
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_quantized_weights) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Integer multiples of the step, including zero and plus or minus one
+  Shape shape_a{2, 4};
+  Shape shape_b{4, 3};
+  std::vector<float> weights{0.25, 0,     -0.75,  //
+                             0,    0.5,   0.25,   //
+                             -0.5, 0,     0,      //
+                             0.25, -0.25, 1};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b, weights);
+  auto t = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"quantized_weight_step", "0.25"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4, -1, 0.5, 2, -3});
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{-0.25, 0, 3.75, -2, 1,
+                                                 -2.125},
+                              1e-2f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_blocked) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // More columns and reduced elements than fit in one block
+  Shape shape_a{3, 20};
+  Shape shape_b{20, 18};
+  std::vector<float> input_a(shape_size(shape_a));
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 7);
+  }
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.25f * static_cast<float>(i % 5) - 0.5f;
+  }
+  std::vector<float> expected(3 * 18, 0);
+  for (size_t row = 0; row < 3; ++row) {
+    for (size_t col = 0; col < 18; ++col) {
+      for (size_t k = 0; k < 20; ++k) {
+        expected[row * 18 + col] +=
+            input_a[row * 20 + k] * input_b[k * 18 + col];
+      }
+    }
+  }
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape_b);
+  auto t = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape_b, false, false);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+  copy_data(t_a, input_a);
+  copy_data(t_b, input_b);
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_auto_packing_layout) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 12};
+  Shape shape_b{12, 5};
+  std::vector<float> input_a(shape_size(shape_a));
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    input_a[i] = 0.1f * static_cast<float>(i % 7);
+  }
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.25f * static_cast<float>(i % 5) - 0.5f;
+  }
+  std::vector<float> expected(shape_b[1], 0);
+  for (size_t col = 0; col < shape_b[1]; ++col) {
+    for (size_t k = 0; k < shape_b[0]; ++k) {
+      expected[col] += input_a[k] * input_b[k * shape_b[1] + col];
+    }
+  }
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b, input_b);
+  auto t = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"packing_layout", "auto"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  EXPECT_TRUE(he_backend->auto_packing_layout());
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result =
+      test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+  copy_data(t_a, input_a);
+
+  // Either layout computes the same result
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_slot_packed_plaintext_cache) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 6};
+  Shape shape_b{6, 3};
+  std::vector<float> input_a{0.5, -1, 1.5, -2, 2.5, -3};
+  std::vector<float> input_b(shape_size(shape_b));
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.25f * static_cast<float>(i % 5) - 0.5f;
+  }
+  std::vector<float> expected(shape_b[1], 0);
+  for (size_t col = 0; col < shape_b[1]; ++col) {
+    for (size_t k = 0; k < shape_b[0]; ++k) {
+      expected[col] += input_a[k] * input_b[k * shape_b[1] + col];
+    }
+  }
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b, input_b);
+  auto t = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  // Returns the number of encodings of each of two calls, which compute
+  // the same result
+  auto encodings = [&](bool plaintext_cache) {
+    std::string error_str;
+    he_backend->set_config(
+        {{"packing_layout", "auto"},
+         {"enable_plaintext_cache", plaintext_cache ? "true" : "false"},
+         {t->get_name(), "kernel_slot_packed"},
+         {a->get_name(), test::config_from_flags(false, true, false)}},
+        error_str);
+    EXPECT_EQ(he_backend->plaintext_cache(), plaintext_cache);
+
+    auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+    auto t_result =
+        test::tensor_from_flags(*he_backend, t->get_shape(), true, false);
+    copy_data(t_a, input_a);
+
+    auto handle = backend->compile(f);
+    std::vector<size_t> counts;
+    for (size_t call = 0; call < 2; ++call) {
+      size_t before = HEPrimitiveCounter::counts()[static_cast<size_t>(
+          HEPrimitive::encode)];
+      handle->call_with_validate({t_result}, {t_a});
+      counts.emplace_back(HEPrimitiveCounter::counts()[static_cast<size_t>(
+                              HEPrimitive::encode)] -
+                          before);
+      EXPECT_TRUE(
+          test::all_close(read_vector<float>(t_result), expected, 1e-2f));
+    }
+    return counts;
+  };
+
+  // In the slot-packed layout, the second call reuses the encoded
+  // diagonals, but not the masks which pack the input
+  auto cached = encodings(true);
+  EXPECT_LE(cached[1], cached[0]);
+  auto uncached = encodings(false);
+  EXPECT_EQ(uncached[1], uncached[0]);
+  EXPECT_EQ(uncached[0], cached[0]);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, dot_slot_packed_bounded_plaintext_cache) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{1, 6};
+  Shape shape_b{6, 3};
+  std::vector<float> input_a{0.5, -1, 1.5, -2, 2.5, -3};
+  std::vector<float> input_b(shape_size(shape_b));
+  std::vector<float> input_c(shape_size(shape_b));
+  for (size_t i = 0; i < input_b.size(); ++i) {
+    input_b[i] = 0.25f * static_cast<float>(i % 5) - 0.5f;
+    input_c[i] = 0.5f - 0.125f * static_cast<float>(i % 7);
+  }
+  auto product = [&](const std::vector<float>& matrix) {
+    std::vector<float> expected(shape_b[1], 0);
+    for (size_t col = 0; col < shape_b[1]; ++col) {
+      for (size_t k = 0; k < shape_b[0]; ++k) {
+        expected[col] += input_a[k] * matrix[k * shape_b[1] + col];
+      }
+    }
+    return expected;
+  };
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto t0 = std::make_shared<op::Dot>(
+      a, op::Constant::create(element::f32, shape_b, input_b));
+  auto t1 = std::make_shared<op::Dot>(
+      a, op::Constant::create(element::f32, shape_b, input_c));
+  auto f = std::make_shared<Function>(NodeVector{t0, t1}, ParameterVector{a});
+
+  // Over the budget, each call evicts the encoded weights after each Dot,
+  // and prefetches them again before the other Dot
+  std::string error_str;
+  he_backend->set_config(
+      {{"packing_layout", "auto"},
+       {"plaintext_cache_mb", "1"},
+       {t0->get_name(), "kernel_slot_packed"},
+       {t1->get_name(), "kernel_slot_packed"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+  EXPECT_EQ(he_backend->plaintext_cache_bytes(), 1U << 20U);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, true, false);
+  auto t_result0 =
+      test::tensor_from_flags(*he_backend, t0->get_shape(), true, false);
+  auto t_result1 =
+      test::tensor_from_flags(*he_backend, t1->get_shape(), true, false);
+  copy_data(t_a, input_a);
+
+  auto handle = backend->compile(f);
+  for (size_t call = 0; call < 3; ++call) {
+    handle->call_with_validate({t_result0, t_result1}, {t_a});
+    EXPECT_TRUE(test::all_close(read_vector<float>(t_result0),
+                                product(input_b), 1e-2f));
+    EXPECT_TRUE(test::all_close(read_vector<float>(t_result1),
+                                product(input_c), 1e-2f));
+  }
+}
+
 }  // namespace ngraph::runtime::he
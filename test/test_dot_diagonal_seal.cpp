@@ -0,0 +1,163 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/dot_diagonal_seal.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(dot_diagonal_seal, period) {
+  EXPECT_EQ(diagonal_dot_period(1, 1), 1);
+  EXPECT_EQ(diagonal_dot_period(3, 4), 4);
+  EXPECT_EQ(diagonal_dot_period(5, 2), 8);
+  EXPECT_EQ(diagonal_dot_period(16, 16), 16);
+}
+
+TEST(dot_diagonal_seal, replicate) {
+  auto replicated = replicate_for_diagonal_dot({1, 2, 3}, 4, 8);
+  EXPECT_EQ(replicated, (std::vector<double>{1, 2, 3, 0, 1, 2, 3, 0}));
+
+  EXPECT_ANY_THROW({ replicate_for_diagonal_dot({1, 2, 3}, 2, 8); });
+  EXPECT_ANY_THROW({ replicate_for_diagonal_dot({1, 2, 3}, 3, 8); });
+}
+
+TEST(dot_diagonal_seal, matrix_vector) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  auto test_dot = [&](size_t rows, size_t cols) {
+    std::vector<double> matrix(rows * cols);
+    std::vector<double> input(cols);
+    for (size_t i = 0; i < matrix.size(); ++i) {
+      matrix[i] = static_cast<double>(i % 7) - 3;
+    }
+    for (size_t i = 0; i < cols; ++i) {
+      input[i] = 0.5 * static_cast<double>(i + 1);
+    }
+
+    auto& encoder = *he_backend->get_ckks_encoder();
+    size_t period = diagonal_dot_period(rows, cols);
+    auto replicated =
+        replicate_for_diagonal_dot(input, period, encoder.slot_count());
+
+    seal::Plaintext plain;
+    encoder.encode(replicated, he_backend->get_scale(), plain);
+    SealCiphertextWrapper cipher;
+    he_backend->get_encryptor()->encrypt(plain, cipher.ciphertext());
+
+    SealCiphertextWrapper result;
+    dot_diagonal_seal(cipher, matrix, rows, cols, result, *he_backend);
+
+    seal::Plaintext decrypted;
+    he_backend->get_decryptor()->decrypt(result.ciphertext(), decrypted);
+    std::vector<double> output;
+    encoder.decode(decrypted, output);
+
+    for (size_t row = 0; row < rows; ++row) {
+      double expected = 0;
+      for (size_t col = 0; col < cols; ++col) {
+        expected += matrix[row * cols + col] * input[col];
+      }
+      EXPECT_NEAR(output[row], expected, 1e-2);
+    }
+  };
+
+  test_dot(1, 1);
+  test_dot(3, 4);
+  test_dot(4, 3);
+  test_dot(10, 10);
+}
+
+TEST(dot_diagonal_seal, encoded_diagonals) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto& encoder = *he_backend->get_ckks_encoder();
+
+  size_t rows = 3;
+  size_t cols = 5;
+  std::vector<double> matrix(rows * cols, 0);
+  // Only diagonals 0 and 2 are nonzero
+  for (size_t row = 0; row < rows; ++row) {
+    matrix[row * cols + row] = static_cast<double>(row + 1);
+    matrix[row * cols + row + 2] = -1;
+  }
+  size_t period = diagonal_dot_period(rows, cols);
+
+  auto encrypt = [&](const std::vector<double>& input) {
+    auto replicated =
+        replicate_for_diagonal_dot(input, period, encoder.slot_count());
+    seal::Plaintext plain;
+    encoder.encode(replicated, he_backend->get_scale(), plain);
+    SealCiphertextWrapper cipher;
+    he_backend->get_encryptor()->encrypt(plain, cipher.ciphertext());
+    return cipher;
+  };
+  std::vector<std::vector<double>> inputs{{1, 2, 3, 4, 5},
+                                          {-0.5, 0.25, 1, -2, 3}};
+  SealCiphertextWrapper cipher = encrypt(inputs[0]);
+
+  EncodedDiagonals encoded = encode_diagonals_seal(
+      matrix, rows, cols, cipher.ciphertext().parms_id(),
+      cipher.ciphertext().scale(), *he_backend);
+  ASSERT_EQ(encoded.diagonals.size(), period);
+  for (size_t diag_idx = 0; diag_idx < period; ++diag_idx) {
+    EXPECT_EQ(encoded.diagonals[diag_idx].coeff_count() == 0,
+              diag_idx != 0 && diag_idx != 2);
+  }
+  EXPECT_GT(encoded.byte_count(), 0U);
+
+  // The encodings are reused for every input at the same level and scale
+  for (const auto& input : inputs) {
+    SealCiphertextWrapper result;
+    dot_diagonal_seal(encrypt(input), encoded, rows, cols, result,
+                      *he_backend);
+
+    seal::Plaintext decrypted;
+    he_backend->get_decryptor()->decrypt(result.ciphertext(), decrypted);
+    std::vector<double> output;
+    encoder.decode(decrypted, output);
+    for (size_t row = 0; row < rows; ++row) {
+      double expected = 0;
+      for (size_t col = 0; col < cols; ++col) {
+        expected += matrix[row * cols + col] * input[col];
+      }
+      EXPECT_NEAR(output[row], expected, 1e-2);
+    }
+  }
+
+  // Encodings at another scale are rejected
+  EncodedDiagonals rescaled = encode_diagonals_seal(
+      matrix, rows, cols, cipher.ciphertext().parms_id(),
+      2 * cipher.ciphertext().scale(), *he_backend);
+  SealCiphertextWrapper result;
+  EXPECT_ANY_THROW(
+      dot_diagonal_seal(cipher, rescaled, rows, cols, result, *he_backend));
+  EXPECT_ANY_THROW(encode_diagonals_seal(std::vector<double>(rows * cols, 0),
+                                         rows, cols,
+                                         cipher.ciphertext().parms_id(),
+                                         cipher.ciphertext().scale(),
+                                         *he_backend));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,156 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "op/bounded_relu.hpp"
+#include "pass/elide_redundant_relus.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "test_util.hpp"
+#include "util/all_close.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+size_t count_relus(const Function& f) {
+  size_t count = 0;
+  for (const auto& node : f.get_ordered_ops()) {
+    if (std::dynamic_pointer_cast<op::Relu>(node) != nullptr ||
+        std::dynamic_pointer_cast<op::BoundedRelu>(node) != nullptr) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+pass::ElideRedundantRelus::InputRange unit_range() {
+  return [](const op::Parameter&) {
+    return std::optional<pass::ElideRedundantRelus::Range>{{0.0, 1.0}};
+  };
+}
+}  // namespace
+
+TEST(elide_redundant_relus, non_negative_dot) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{1, 3});
+  auto w = op::Constant::create(element::f32, Shape{3, 2},
+                                {0.5, 1, 0.25, 2, 1, 0});
+  auto b = op::Constant::create(element::f32, Shape{1, 2}, {0.1, 0.2});
+  auto dot = std::make_shared<op::Add>(std::make_shared<op::Dot>(a, w), b);
+  auto relu = std::make_shared<op::Relu>(dot);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  EXPECT_TRUE(pass::ElideRedundantRelus(unit_range()).run_on_function(f));
+  EXPECT_EQ(count_relus(*f), 0U);
+  EXPECT_EQ(f->get_results()[0]->input_value(0).get_node_shared_ptr(), dot);
+}
+
+TEST(elide_redundant_relus, non_positive_relu_is_zero) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{2});
+  auto neg = std::make_shared<op::Negate>(a);
+  auto f = std::make_shared<Function>(std::make_shared<op::Relu>(neg),
+                                      ParameterVector{a});
+
+  EXPECT_TRUE(pass::ElideRedundantRelus(unit_range()).run_on_function(f));
+  EXPECT_EQ(count_relus(*f), 0U);
+  auto zeros = std::dynamic_pointer_cast<op::Constant>(
+      f->get_results()[0]->input_value(0).get_node_shared_ptr());
+  ASSERT_TRUE(zeros != nullptr);
+  EXPECT_EQ(zeros->get_vector<float>(), (std::vector<float>{0, 0}));
+}
+
+TEST(elide_redundant_relus, bounded_relu_becomes_relu) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{2});
+  auto shift = op::Constant::create(element::f32, Shape{2}, {0.5, 0.5});
+  auto sub = std::make_shared<op::Subtract>(a, shift);
+  auto f = std::make_shared<Function>(
+      std::make_shared<op::BoundedRelu>(sub, 6.0f), ParameterVector{a});
+
+  EXPECT_TRUE(pass::ElideRedundantRelus(unit_range()).run_on_function(f));
+  auto relu = std::dynamic_pointer_cast<op::Relu>(
+      f->get_results()[0]->input_value(0).get_node_shared_ptr());
+  ASSERT_TRUE(relu != nullptr);
+  EXPECT_EQ(relu->input_value(0).get_node_shared_ptr(), sub);
+}
+
+TEST(elide_redundant_relus, unbounded_input_kept) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{2});
+  auto f = std::make_shared<Function>(std::make_shared<op::Relu>(a),
+                                      ParameterVector{a});
+
+  EXPECT_FALSE(pass::ElideRedundantRelus(nullptr).run_on_function(f));
+  EXPECT_EQ(count_relus(*f), 1U);
+
+  // A range straddling zero determines nothing
+  auto straddling = [](const op::Parameter&) {
+    return std::optional<pass::ElideRedundantRelus::Range>{{-1.0, 1.0}};
+  };
+  EXPECT_FALSE(pass::ElideRedundantRelus(straddling).run_on_function(f));
+  EXPECT_EQ(count_relus(*f), 1U);
+}
+
+TEST(elide_redundant_relus, convolution_config) {
+  Shape shape{1, 1, 3, 3};
+  auto make_function = [&shape](bool relu) {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    a->add_provenance_tag("pixels");
+    auto filter = op::Constant::create(element::f32, Shape{2, 1, 2, 2},
+                                       {1, 2, 0, 1, 0.5, 0.5, 0.5, 0.5});
+    std::shared_ptr<Node> out = std::make_shared<op::Convolution>(
+        a, filter, Strides{1, 1}, Strides{1, 1}, CoordinateDiff{1, 1},
+        CoordinateDiff{0, 0});
+    if (relu) {
+      out = std::make_shared<op::Relu>(out);
+    }
+    return std::make_shared<Function>(out, ParameterVector{a});
+  };
+  auto he_f = make_function(true);
+  auto int_f = make_function(false);
+  std::vector<float> input_vals{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9};
+
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::string error;
+  EXPECT_TRUE(
+      he_backend->set_config({{"pixels", "encrypt,range:0:1"}}, error));
+  auto range = he_backend->input_range(*he_f->get_parameters()[0]);
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(*range, (std::pair<double, double>{0, 1}));
+
+  auto he_handle = he_backend->compile(he_f);
+  auto he_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto he_result =
+      he_backend->create_cipher_tensor(element::f32, he_f->get_output_shape(0));
+  copy_data(he_a, input_vals);
+  he_handle->call_with_validate({he_result}, {he_a});
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(int_f);
+  auto int_a = int_backend->create_tensor(element::f32, shape);
+  auto int_result =
+      int_backend->create_tensor(element::f32, int_f->get_output_shape(0));
+  copy_data(int_a, input_vals);
+  int_handle->call_with_validate({int_result}, {int_a});
+
+  EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                              read_vector<float>(int_result), 1e-3f));
+}
+
+}  // namespace ngraph::runtime::he
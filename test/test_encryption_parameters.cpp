@@ -116,6 +116,33 @@ TEST(encryption_parameters, from_string) {
   EXPECT_EQ(he_parms.complex_packing(), true);
 }
 
+TEST(encryption_parameters, from_string_bfv) {
+  std::string param_str = R"(
+    {
+        "scheme_name" : "HE_SEAL",
+        "scheme" : "BFV",
+        "poly_modulus_degree" : 4096,
+        "security_level" : 128,
+        "coeff_modulus" : [36, 36, 37],
+        "plain_modulus_bits" : 20
+    })";
+  auto he_parms = HESealEncryptionParameters::parse_config_or_use_default(
+      param_str.c_str());
+
+  EXPECT_TRUE(he_parms.integer_scheme());
+  EXPECT_EQ(he_parms.poly_modulus_degree(), 4096);
+  EXPECT_EQ(he_parms.security_level(), 128);
+  EXPECT_EQ(he_parms.scale(), 1.0);
+  EXPECT_EQ(he_parms.complex_packing(), false);
+  EXPECT_EQ(he_parms.plain_modulus() % (2 * 4096), 1);
+
+  auto missing_plain_modulus = param_str;
+  missing_plain_modulus.replace(missing_plain_modulus.find("plain_modulus"),
+                                13, "unused");
+  EXPECT_ANY_THROW(HESealEncryptionParameters::parse_config_or_use_default(
+      missing_plain_modulus.c_str()));
+}
+
 TEST(encryption_parameters, from_string_invalid) {
   std::string param_str = R"(
     {
@@ -190,4 +217,122 @@ TEST(encryption_parameters, choose_scale) {
   test_choose_scale(std::vector<int>{54, 54, 54});
 }
 
+TEST(encryption_parameters, select_for_depth) {
+  // 30 + 30 bits exceed the 54 bits of poly_modulus_degree 2048
+  auto parms =
+      HESealEncryptionParameters::select_for_depth(0, 1, 128, 24, false);
+  EXPECT_EQ(parms.poly_modulus_degree(), 4096);
+  EXPECT_EQ(parms.seal_encryption_parameters().coeff_modulus().size(), 2);
+  EXPECT_EQ(parms.scale(), 16777216.0);
+  EXPECT_EQ(parms.security_level(), 128);
+  EXPECT_EQ(parms.complex_packing(), false);
+
+  // Deeper chains require larger degrees
+  parms = HESealEncryptionParameters::select_for_depth(6, 1, 128, 24, false);
+  EXPECT_EQ(parms.poly_modulus_degree(), 8192);
+  EXPECT_EQ(parms.seal_encryption_parameters().coeff_modulus().size(), 8);
+
+  // Packed batches require enough slots
+  parms = HESealEncryptionParameters::select_for_depth(0, 4096, 128, 24, false);
+  EXPECT_EQ(parms.poly_modulus_degree(), 8192);
+  parms = HESealEncryptionParameters::select_for_depth(0, 4096, 128, 24, true);
+  EXPECT_EQ(parms.poly_modulus_degree(), 4096);
+
+  // No supported degree holds the chain
+  EXPECT_ANY_THROW(
+      HESealEncryptionParameters::select_for_depth(30, 1, 128, 40, false));
+}
+
+TEST(encryption_parameters, select_for_prime_bits) {
+  // 34 + 28 + 28 + 34 bits exceed the 109 bits of poly_modulus_degree 4096
+  auto parms = HESealEncryptionParameters::select_for_prime_bits(
+      std::vector<int>{28, 28}, 1, 128, 28, false);
+  EXPECT_EQ(parms.poly_modulus_degree(), 8192);
+
+  // Narrower primes fit a smaller degree. The first rescale drops the prime
+  // before the special prime
+  parms = HESealEncryptionParameters::select_for_prime_bits(
+      std::vector<int>{20, 28}, 1, 128, 28, false);
+  EXPECT_EQ(parms.poly_modulus_degree(), 8192);
+  parms = HESealEncryptionParameters::select_for_prime_bits(
+      std::vector<int>{20, 20}, 1, 128, 28, false);
+  EXPECT_EQ(parms.poly_modulus_degree(), 4096);
+  const auto& coeff_modulus =
+      parms.seal_encryption_parameters().coeff_modulus();
+  ASSERT_EQ(coeff_modulus.size(), 4);
+  EXPECT_EQ(coeff_modulus[0].bit_count(), 34);
+  EXPECT_EQ(coeff_modulus[1].bit_count(), 20);
+  EXPECT_EQ(coeff_modulus[2].bit_count(), 20);
+  EXPECT_EQ(parms.scale(), 268435456.0);
+
+  parms = HESealEncryptionParameters::select_for_prime_bits(
+      std::vector<int>{20, 24}, 1, 0, 28, false);
+  EXPECT_EQ(parms.seal_encryption_parameters().coeff_modulus()[1].bit_count(),
+            24);
+  EXPECT_EQ(parms.seal_encryption_parameters().coeff_modulus()[2].bit_count(),
+            20);
+
+  EXPECT_ANY_THROW(HESealEncryptionParameters::select_for_prime_bits(
+      std::vector<int>{0}, 1, 128, 28, false));
+}
+
+TEST(encryption_parameters, rescale_primes) {
+  std::string param_str = R"(
+    {
+        "scheme_name" : "HE_SEAL",
+        "poly_modulus_degree" : 4096,
+        "security_level" : 0,
+        "coeff_modulus" : [30, 22, 22, 22, 22, 30],
+        "rescale_primes" : 2
+    })";
+  auto he_parms = HESealEncryptionParameters::parse_config_or_use_default(
+      param_str.c_str());
+  EXPECT_EQ(he_parms.rescale_primes(), 2);
+
+  // The scale is the product of the prime pair dropped by the first rescale
+  const auto& coeff_modulus =
+      he_parms.seal_encryption_parameters().coeff_modulus();
+  EXPECT_EQ(he_parms.scale(),
+            static_cast<double>(coeff_modulus[3].value()) *
+                static_cast<double>(coeff_modulus[4].value()));
+
+  std::stringstream ss;
+  he_parms.save(ss);
+  auto loaded_parms = HESealEncryptionParameters::load(ss);
+  EXPECT_EQ(loaded_parms.rescale_primes(), 2);
+  EXPECT_TRUE(loaded_parms == he_parms);
+
+  EXPECT_ANY_THROW(he_parms.set_rescale_primes(3));
+
+  auto context = std::make_shared<seal::SEALContext>(
+      he_parms.seal_encryption_parameters());
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::Decryptor decryptor(*context, keygen.secret_key());
+  seal::Evaluator evaluator(*context);
+  seal::CKKSEncoder encoder(*context);
+
+  // A product at twice the scale returns to the scale after one rescale
+  seal::Plaintext plain;
+  encoder.encode(std::vector<double>{1.5, -2.25}, he_parms.scale(), plain);
+  seal::Ciphertext cipher;
+  encryptor.encrypt(plain, cipher);
+  evaluator.multiply_plain_inplace(cipher, plain);
+
+  auto context_data = context->get_context_data(cipher.parms_id());
+  EXPECT_EQ(rescale_divisor(*context_data, 2), he_parms.scale());
+  rescale_inplace(cipher, evaluator, 2);
+  EXPECT_EQ(context->get_context_data(cipher.parms_id())->chain_index(),
+            context_data->chain_index() - 2);
+  EXPECT_DOUBLE_EQ(cipher.scale(), he_parms.scale());
+
+  std::vector<double> output;
+  decryptor.decrypt(cipher, plain);
+  encoder.decode(plain, output);
+  EXPECT_NEAR(output[0], 2.25, 1e-3);
+  EXPECT_NEAR(output[1], 5.0625, 1e-3);
+}
+
 }  // namespace ngraph::runtime::he
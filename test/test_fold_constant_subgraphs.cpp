@@ -0,0 +1,81 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "pass/fold_constant_subgraphs.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "test_util.hpp"
+#include "util/all_close.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(fold_constant_subgraphs, dot_of_constants) {
+  Shape shape{2, 2};
+  auto make_function = [&shape]() {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    auto w = op::Constant::create<float>(element::f32, shape, {1, 2, 3, 4});
+    auto v = op::Constant::create<float>(element::f32, shape, {1, 0, 0, 2});
+    auto weights = std::make_shared<op::Dot>(w, v);
+    auto t = std::make_shared<op::Dot>(a, weights);
+    return std::make_shared<Function>(t, ParameterVector{a});
+  };
+
+  auto f = make_function();
+  pass::FoldConstantSubgraphs fold_pass;
+  EXPECT_TRUE(fold_pass.run_on_function(f));
+  EXPECT_EQ(1, count_ops_of_type<op::Dot>(f));
+  EXPECT_EQ(1, count_ops_of_type<op::Constant>(f));
+
+  // Nothing else to fold
+  EXPECT_FALSE(fold_pass.run_on_function(f));
+
+  // Weights are [[1, 4], [3, 8]]
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto he_f = make_function();
+  auto a = he_f->get_parameters()[0];
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "false"}, {a->get_name(), "encrypt"}}, error_str);
+  auto handle = backend->compile(he_f);
+  EXPECT_EQ(1, count_ops_of_type<op::Dot>(he_f));
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{7, 20, 15, 44}, 1e-3f));
+}
+
+TEST(fold_constant_subgraphs, parameter_subgraph) {
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create<float>(element::f32, shape, {1, 2, 3, 4});
+  auto t = std::make_shared<op::Dot>(a, w);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  pass::FoldConstantSubgraphs fold_pass;
+  EXPECT_FALSE(fold_pass.run_on_function(f));
+  EXPECT_EQ(1, count_ops_of_type<op::Dot>(f));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,156 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "pass/fold_layout_ops.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "test_util.hpp"
+#include "util/all_close.hpp"
+#include "util/random.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+// Checks the function computes the same values on encrypted inputs after
+// the pass as the reference function on INTERPRETER
+static void check_layout_folding(
+    const std::function<std::shared_ptr<Function>()>& make_function,
+    const std::function<std::shared_ptr<Function>()>& make_reference) {
+  auto he_f = make_function();
+  auto int_f = make_reference();
+  const Shape& shape = he_f->get_parameters()[0]->get_shape();
+  std::vector<float> input_vals(shape_size(shape));
+  ngraph::test::Uniform<float> rng(-10.0f, 10.0f);
+  rng.initialize(input_vals);
+
+  auto he_backend_orig = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(he_backend_orig.get());
+  auto he_handle = he_backend->compile(he_f);
+  auto out_shape = he_f->get_output_shape(0);
+  auto he_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto he_result = he_backend->create_cipher_tensor(element::f32, out_shape);
+  copy_data(he_a, input_vals);
+  he_handle->call_with_validate({he_result}, {he_a});
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(int_f);
+  auto int_a = int_backend->create_tensor(element::f32, shape);
+  auto int_result = int_backend->create_tensor(element::f32, out_shape);
+  copy_data(int_a, input_vals);
+  int_handle->call_with_validate({int_result}, {int_a});
+
+  EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                              read_vector<float>(int_result), 1e-3f));
+}
+
+TEST(fold_layout_ops, transpose) {
+  Shape shape{1, 2, 3, 4};
+  auto make_transpose = [&shape]() {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    auto order = op::Constant::create(element::i64, Shape{4}, {0, 2, 3, 1});
+    auto t = std::make_shared<op::Transpose>(a, order);
+    return std::make_shared<Function>(t, ParameterVector{a});
+  };
+  auto make_reshape = [&shape]() {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    auto t = std::make_shared<op::Reshape>(a, AxisVector{0, 2, 3, 1},
+                                           Shape{1, 3, 4, 2});
+    return std::make_shared<Function>(t, ParameterVector{a});
+  };
+
+  auto f = make_transpose();
+  pass::FoldLayoutOps fold_pass;
+  EXPECT_TRUE(fold_pass.run_on_function(f));
+  EXPECT_EQ(0, count_ops_of_type<op::Transpose>(f));
+  EXPECT_EQ(1, count_ops_of_type<op::Reshape>(f));
+
+  check_layout_folding(make_transpose, make_reshape);
+}
+
+TEST(fold_layout_ops, reshape_chain) {
+  Shape shape{2, 3, 4};
+  auto make_function = [&shape]() {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    auto t = std::make_shared<op::Reshape>(a, AxisVector{2, 0, 1},
+                                           Shape{4, 2, 3});
+    auto r = std::make_shared<op::Reshape>(t, AxisVector{0, 1, 2},
+                                           Shape{8, 3});
+    auto s = std::make_shared<op::Reshape>(r, AxisVector{0, 1}, Shape{8, 3});
+    return std::make_shared<Function>(s, ParameterVector{a});
+  };
+
+  auto f = make_function();
+  pass::FoldLayoutOps fold_pass;
+  EXPECT_TRUE(fold_pass.run_on_function(f));
+  EXPECT_EQ(1, count_ops_of_type<op::Reshape>(f));
+
+  // Nothing else to fold
+  EXPECT_FALSE(fold_pass.run_on_function(f));
+
+  check_layout_folding(make_function, make_function);
+}
+
+TEST(fold_layout_ops, broadcast_chain) {
+  Shape shape{3};
+  auto make_function = [&shape]() {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    auto b = std::make_shared<op::Broadcast>(a, Shape{2, 3}, AxisSet{0});
+    auto c = std::make_shared<op::Broadcast>(b, Shape{2, 4, 3}, AxisSet{1});
+    return std::make_shared<Function>(c, ParameterVector{a});
+  };
+
+  auto f = make_function();
+  pass::FoldLayoutOps fold_pass;
+  EXPECT_TRUE(fold_pass.run_on_function(f));
+  EXPECT_EQ(1, count_ops_of_type<op::Broadcast>(f));
+
+  check_layout_folding(make_function, make_function);
+}
+
+TEST(fold_layout_ops, dot_of_nhwc_input) {
+  Shape shape{2, 2, 3, 2};
+  auto make_function = [&shape]() {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    // NHWC to NCHW, flattened into the rows of a matrix
+    auto t = std::make_shared<op::Reshape>(a, AxisVector{0, 3, 1, 2},
+                                           Shape{2, 12});
+    std::vector<float> weight_vals(12 * 3);
+    for (size_t i = 0; i < weight_vals.size(); ++i) {
+      weight_vals[i] = 0.25f * static_cast<float>(i % 7) - 0.75f;
+    }
+    auto w = op::Constant::create(element::f32, Shape{12, 3}, weight_vals);
+    auto d = std::make_shared<op::Dot>(t, w);
+    return std::make_shared<Function>(d, ParameterVector{a});
+  };
+
+  auto f = make_function();
+  pass::FoldLayoutOps fold_pass;
+  EXPECT_TRUE(fold_pass.run_on_function(f));
+  for (const auto& node : f->get_ops()) {
+    if (auto reshape = std::dynamic_pointer_cast<op::Reshape>(node)) {
+      EXPECT_EQ(reshape->get_input_order(), (AxisVector{0, 1, 2, 3}));
+    }
+  }
+
+  check_layout_folding(make_function, make_function);
+}
+
+}  // namespace ngraph::runtime::he
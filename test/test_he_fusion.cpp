@@ -14,9 +14,17 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
 #include "ngraph/ngraph.hpp"
 #include "ngraph/pass/constant_folding.hpp"
+#include "ngraph/pass/manager.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/convolution_bias_relu.hpp"
+#include "op/sum_pool.hpp"
 #include "pass/he_fusion.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "test_util.hpp"
@@ -114,4 +122,283 @@ TEST(he_fusion, bounded_relu_no_fusion) {
     check_no_fusion(f);
   }
 }
+
+static void check_batch_norm_folding(
+    const std::function<std::shared_ptr<Node>(const std::shared_ptr<Node>&)>&
+        make_linear_op,
+    const Shape& input_shape) {
+  auto make_function = [&]() {
+    auto input = std::make_shared<op::Parameter>(element::f32, input_shape);
+    auto linear_op = make_linear_op(input);
+    Shape channel_shape{linear_op->get_shape()[1]};
+    size_t num_channels = channel_shape[0];
+    std::vector<float> gamma_vals(num_channels);
+    std::vector<float> beta_vals(num_channels);
+    std::vector<float> mean_vals(num_channels);
+    std::vector<float> var_vals(num_channels);
+    for (size_t i = 0; i < num_channels; ++i) {
+      gamma_vals[i] = 0.5f + static_cast<float>(i);
+      beta_vals[i] = 1.5f - static_cast<float>(i);
+      mean_vals[i] = 0.25f * static_cast<float>(i);
+      var_vals[i] = 0.1f + static_cast<float>(i);
+    }
+    auto gamma = op::Constant::create(element::f32, channel_shape, gamma_vals);
+    auto beta = op::Constant::create(element::f32, channel_shape, beta_vals);
+    auto mean = op::Constant::create(element::f32, channel_shape, mean_vals);
+    auto var = op::Constant::create(element::f32, channel_shape, var_vals);
+    auto bn = std::make_shared<op::BatchNormInference>(linear_op, gamma, beta,
+                                                       mean, var, 0.001);
+    return std::make_shared<Function>(bn, ParameterVector{input});
+  };
+
+  auto orig_f = make_function();
+  auto opt_f = make_function();
+  ngraph::pass::Manager pass_manager;
+  pass_manager.register_pass<pass::HEFusion>();
+  pass_manager.run_passes(opt_f);
+  EXPECT_EQ(0, count_ops_of_type<op::BatchNormInference>(opt_f));
+
+  std::vector<float> input_vals(shape_size(input_shape));
+  ngraph::test::Uniform<float> rng(-10.0f, 10.0f);
+  rng.initialize(input_vals);
+
+  auto backend = runtime::Backend::create("INTERPRETER");
+  auto t_input = backend->create_tensor(element::f32, input_shape);
+  copy_data(t_input, input_vals);
+  auto out_shape = orig_f->get_output_shape(0);
+  auto t_orig_result = backend->create_tensor(element::f32, out_shape);
+  auto t_opt_result = backend->create_tensor(element::f32, out_shape);
+  backend->compile(orig_f)->call_with_validate({t_orig_result}, {t_input});
+  backend->compile(opt_f)->call_with_validate({t_opt_result}, {t_input});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_orig_result),
+                              read_vector<float>(t_opt_result), 1e-3f));
+}
+
+TEST(he_fusion, dot_batch_norm_fusion) {
+  check_batch_norm_folding(
+      [](const std::shared_ptr<Node>& input) {
+        std::vector<float> weight_vals{1.25f, 2.25f, -5.25f, 6.25f,
+                                       -1.25f, 0.5f, 3.25f, -4.25f};
+        auto weights =
+            op::Constant::create(element::f32, Shape{4, 2}, weight_vals);
+        return std::make_shared<op::Dot>(input, weights);
+      },
+      Shape{3, 4});
+}
+
+TEST(he_fusion, conv_batch_norm_fusion) {
+  check_batch_norm_folding(
+      [](const std::shared_ptr<Node>& input) {
+        std::vector<float> filter_vals{1.25f, 2.25f, -5.25f,
+                                       6.25f, -1.25f, 0.5f};
+        auto filters =
+            op::Constant::create(element::f32, Shape{3, 2, 1}, filter_vals);
+        return std::make_shared<op::Convolution>(input, filters, Strides{1},
+                                                 Strides{1});
+      },
+      Shape{1, 2, 5});
+}
+
+TEST(he_fusion, conv_bias_relu_fusion) {
+  Shape shape{2, 2, 4, 4};
+  auto make_function = [&shape]() {
+    auto input = std::make_shared<op::Parameter>(element::f32, shape);
+    std::vector<float> filter_vals{1.25f, 2.25f,  -5.25f, 6.25f,
+                                   -1.25f, 0.5f, 3.25f,  -4.25f};
+    auto filters =
+        op::Constant::create(element::f32, Shape{2, 2, 1, 2}, filter_vals);
+    auto conv = std::make_shared<op::Convolution>(input, filters,
+                                                  Strides{1, 1}, Strides{1, 1});
+    auto bias = std::make_shared<op::Broadcast>(
+        op::Constant::create(element::f32, Shape{2}, {1.5f, -0.5f}),
+        conv->get_shape(), AxisSet{0, 2, 3});
+    auto add = std::make_shared<op::Add>(bias, conv);
+    auto relu = std::make_shared<op::Relu>(add);
+    return std::make_shared<Function>(relu, ParameterVector{input});
+  };
+
+  auto he_f = make_function();
+  auto int_f = make_function();
+  std::vector<float> input_vals(shape_size(shape));
+  ngraph::test::Uniform<float> rng(-10.0f, 10.0f);
+  rng.initialize(input_vals);
+
+  auto he_backend_orig = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(he_backend_orig.get());
+  auto he_handle = he_backend->compile(he_f);
+  EXPECT_EQ(1, count_ops_of_type<op::ConvolutionBiasRelu>(he_f));
+  EXPECT_EQ(0, count_ops_of_type<op::Relu>(he_f));
+
+  auto out_shape = he_f->get_output_shape(0);
+  auto he_a = he_backend->create_plain_tensor(element::f32, shape);
+  auto he_result = he_backend->create_plain_tensor(element::f32, out_shape);
+  copy_data(he_a, input_vals);
+  he_handle->call_with_validate({he_result}, {he_a});
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(int_f);
+  auto int_a = int_backend->create_tensor(element::f32, shape);
+  auto int_result = int_backend->create_tensor(element::f32, out_shape);
+  copy_data(int_a, input_vals);
+  int_handle->call_with_validate({int_result}, {int_a});
+
+  EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                              read_vector<float>(int_result), 1e-3f));
+}
+
+TEST(he_fusion, batch_norm_no_fusion) {
+  // Weights are not constant
+  Shape shape{2, 2};
+  auto input = std::make_shared<op::Parameter>(element::f32, shape);
+  auto weights = std::make_shared<op::Parameter>(element::f32, shape);
+  auto dot = std::make_shared<op::Dot>(input, weights);
+  auto norm = op::Constant::create<float>(element::f32, Shape{2}, {1, 2});
+  auto bn = std::make_shared<op::BatchNormInference>(dot, norm, norm, norm,
+                                                     norm, 0.001);
+  auto f = std::make_shared<Function>(bn, ParameterVector{input, weights});
+
+  ngraph::pass::Manager pass_manager;
+  pass_manager.register_pass<pass::HEFusion>();
+  pass_manager.run_passes(f);
+  EXPECT_EQ(1, count_ops_of_type<op::BatchNormInference>(f));
+}
+
+
+static void check_avg_pool_folding(
+    const std::function<std::shared_ptr<Node>(const std::shared_ptr<Node>&)>&
+        make_linear_op,
+    const Shape& input_shape, const Shape& padding,
+    bool include_padding_in_avg_computation, size_t expected_sum_pools) {
+  auto make_function = [&]() {
+    auto input = std::make_shared<op::Parameter>(element::f32, input_shape);
+    auto avg_pool = std::make_shared<op::AvgPool>(
+        input, Shape{2, 2}, Strides{2, 2}, padding, padding,
+        include_padding_in_avg_computation);
+    return std::make_shared<Function>(make_linear_op(avg_pool),
+                                      ParameterVector{input});
+  };
+
+  auto he_f = make_function();
+  auto int_f = make_function();
+  std::vector<float> input_vals(shape_size(input_shape));
+  ngraph::test::Uniform<float> rng(-10.0f, 10.0f);
+  rng.initialize(input_vals);
+
+  auto he_backend_orig = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(he_backend_orig.get());
+  auto he_handle = he_backend->compile(he_f);
+  EXPECT_EQ(expected_sum_pools, count_ops_of_type<op::SumPool>(he_f));
+
+  auto out_shape = he_f->get_output_shape(0);
+  auto he_a = he_backend->create_plain_tensor(element::f32, input_shape);
+  auto he_result = he_backend->create_plain_tensor(element::f32, out_shape);
+  copy_data(he_a, input_vals);
+  he_handle->call_with_validate({he_result}, {he_a});
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(int_f);
+  auto int_a = int_backend->create_tensor(element::f32, input_shape);
+  auto int_result = int_backend->create_tensor(element::f32, out_shape);
+  copy_data(int_a, input_vals);
+  int_handle->call_with_validate({int_result}, {int_a});
+
+  EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                              read_vector<float>(int_result), 1e-3f));
+}
+
+TEST(he_fusion, conv_avg_pool_fusion) {
+  auto make_conv = [](const std::shared_ptr<Node>& input) {
+    std::vector<float> filter_vals{1.25f, 2.25f,  -5.25f, 6.25f,
+                                   -1.25f, 0.5f, 3.25f,  -4.25f};
+    auto filters =
+        op::Constant::create(element::f32, Shape{2, 2, 1, 2}, filter_vals);
+    return std::make_shared<op::Convolution>(input, filters, Strides{1, 1},
+                                             Strides{1, 1});
+  };
+  check_avg_pool_folding(make_conv, Shape{1, 2, 4, 4}, Shape{0, 0}, false, 1);
+  check_avg_pool_folding(make_conv, Shape{1, 2, 4, 4}, Shape{1, 1}, true, 1);
+  // Windows overlapping the padding have fewer elements
+  check_avg_pool_folding(make_conv, Shape{1, 2, 4, 4}, Shape{1, 1}, false, 0);
+}
+
+TEST(he_fusion, dot_avg_pool_fusion) {
+  auto make_dot = [](const std::shared_ptr<Node>& input) {
+    auto reshape = std::make_shared<op::Reshape>(input, AxisVector{0, 1, 2, 3},
+                                                 Shape{2, 8});
+    std::vector<float> weight_vals(8 * 3);
+    for (size_t i = 0; i < weight_vals.size(); ++i) {
+      weight_vals[i] = 0.25f * static_cast<float>(i % 5) - 0.5f;
+    }
+    auto weights =
+        op::Constant::create(element::f32, Shape{8, 3}, weight_vals);
+    return std::make_shared<op::Dot>(reshape, weights);
+  };
+  check_avg_pool_folding(make_dot, Shape{2, 2, 4, 4}, Shape{0, 0}, false, 1);
+}
+
+static void check_pad_folding(
+    const std::function<std::shared_ptr<Node>(const std::shared_ptr<Node>&)>&
+        make_consumer,
+    const Shape& input_shape, const CoordinateDiff& padding_below,
+    const CoordinateDiff& padding_above, size_t expected_pads) {
+  auto make_function = [&]() {
+    auto input = std::make_shared<op::Parameter>(element::f32, input_shape);
+    auto zero = op::Constant::create(element::f32, Shape{}, {0});
+    auto pad =
+        std::make_shared<op::Pad>(input, zero, padding_below, padding_above);
+    return std::make_shared<Function>(make_consumer(pad),
+                                      ParameterVector{input});
+  };
+
+  auto he_f = make_function();
+  auto int_f = make_function();
+  std::vector<float> input_vals(shape_size(input_shape));
+  ngraph::test::Uniform<float> rng(-10.0f, 10.0f);
+  rng.initialize(input_vals);
+
+  auto he_backend_orig = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(he_backend_orig.get());
+  auto he_handle = he_backend->compile(he_f);
+  EXPECT_EQ(expected_pads, count_ops_of_type<op::Pad>(he_f));
+
+  auto out_shape = he_f->get_output_shape(0);
+  auto he_a = he_backend->create_cipher_tensor(element::f32, input_shape);
+  auto he_result = he_backend->create_cipher_tensor(element::f32, out_shape);
+  copy_data(he_a, input_vals);
+  he_handle->call_with_validate({he_result}, {he_a});
+
+  auto int_backend = runtime::Backend::create("INTERPRETER");
+  auto int_handle = int_backend->compile(int_f);
+  auto int_a = int_backend->create_tensor(element::f32, input_shape);
+  auto int_result = int_backend->create_tensor(element::f32, out_shape);
+  copy_data(int_a, input_vals);
+  int_handle->call_with_validate({int_result}, {int_a});
+
+  EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                              read_vector<float>(int_result), 1e-3f));
+}
+
+TEST(he_fusion, pad_conv_fusion) {
+  auto make_conv = [](const std::shared_ptr<Node>& input) {
+    std::vector<float> filter_vals{1.25f, 2.25f,  -5.25f, 6.25f,
+                                   -1.25f, 0.5f, 3.25f,  -4.25f};
+    auto filters =
+        op::Constant::create(element::f32, Shape{2, 2, 1, 2}, filter_vals);
+    return std::make_shared<op::Convolution>(input, filters, Strides{2, 2},
+                                             Strides{1, 1});
+  };
+  check_pad_folding(make_conv, Shape{1, 2, 4, 4}, CoordinateDiff{0, 0, 0, 1},
+                    CoordinateDiff{0, 0, 1, 1}, 0);
+  // Pads of the channel axis are kept
+  check_pad_folding(make_conv, Shape{1, 1, 4, 4}, CoordinateDiff{0, 1, 0, 1},
+                    CoordinateDiff{0, 0, 1, 1}, 1);
+}
+
+TEST(he_fusion, pad_avg_pool_fusion) {
+  auto make_avg_pool = [](const std::shared_ptr<Node>& input) {
+    return std::make_shared<op::AvgPool>(input, Shape{2, 2}, Strides{2, 2});
+  };
+  check_pad_folding(make_avg_pool, Shape{1, 2, 3, 3},
+                    CoordinateDiff{0, 0, 1, 0}, CoordinateDiff{0, 0, 0, 1}, 0);
+}
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,115 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "he_op_annotations.hpp"
+#include "ngraph/ngraph.hpp"
+#include "pass/he_level_analysis.hpp"
+#include "pass/propagate_he_annotations.hpp"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_level_analysis, depths) {
+  Shape shape{2, 2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto c = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, b);
+  auto sum = std::make_shared<op::Add>(prod, a);
+  auto relu = std::make_shared<op::Relu>(sum);
+  auto plain_sum = std::make_shared<op::Add>(c, c);
+  auto t = std::make_shared<op::Add>(relu, plain_sum);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b, c});
+
+  a->set_op_annotations(test::annotation_from_flags(false, true, false));
+  b->set_op_annotations(test::annotation_from_flags(false, true, false));
+  c->set_op_annotations(test::annotation_from_flags(false, false, false));
+  pass::PropagateHEAnnotations().run_on_function(f);
+
+  pass::HELevelAnalysis level_analysis(false);
+  EXPECT_FALSE(level_analysis.run_on_function(f));
+
+  EXPECT_EQ(level_analysis.depth(*a), 0U);
+  EXPECT_EQ(level_analysis.depth(*prod), 1U);
+  EXPECT_EQ(level_analysis.depth(*sum), 1U);
+  EXPECT_EQ(level_analysis.depth(*relu), 0U);
+  EXPECT_EQ(level_analysis.depth(*t), 0U);
+  EXPECT_FALSE(level_analysis.depth(*c).has_value());
+  EXPECT_FALSE(level_analysis.depth(*plain_sum).has_value());
+
+  // Only the shallower input of sum is switched
+  EXPECT_EQ(level_analysis.mod_switch_inputs(*sum), std::vector<size_t>{1});
+  EXPECT_TRUE(level_analysis.mod_switch_inputs(*prod).empty());
+  EXPECT_TRUE(level_analysis.mod_switch_inputs(*t).empty());
+}
+
+TEST(he_level_analysis, polynomial_depths) {
+  Shape shape{2, 2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, a);
+  auto relu = std::make_shared<op::Relu>(prod);
+  auto t = std::make_shared<op::Add>(relu, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  a->set_op_annotations(test::annotation_from_flags(false, true, false));
+  pass::PropagateHEAnnotations().run_on_function(f);
+
+  // The approximated Relu consumes levels instead of being re-encrypted
+  pass::HELevelAnalysis level_analysis(
+      true, [&](const Node& node) -> std::optional<size_t> {
+        if (&node == relu.get()) {
+          return 2;
+        }
+        return std::nullopt;
+      });
+  level_analysis.run_on_function(f);
+
+  EXPECT_EQ(level_analysis.depth(*prod), 1U);
+  EXPECT_EQ(level_analysis.depth(*relu), 3U);
+  EXPECT_EQ(level_analysis.depth(*t), 3U);
+  EXPECT_EQ(level_analysis.max_depth(), 3U);
+  EXPECT_EQ(level_analysis.mod_switch_inputs(*t), std::vector<size_t>{1});
+}
+
+TEST(he_level_analysis, skips_rescale) {
+  Shape shape{2, 2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, a);
+  auto t = std::make_shared<op::Multiply>(prod, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  a->set_op_annotations(test::annotation_from_flags(false, true, false));
+  pass::PropagateHEAnnotations().run_on_function(f);
+
+  pass::HELevelAnalysis level_analysis(
+      false, nullptr, [&](const Node& node) { return &node == prod.get(); });
+  level_analysis.run_on_function(f);
+
+  EXPECT_EQ(level_analysis.depth(*prod), 0U);
+  EXPECT_EQ(level_analysis.depth(*t), 1U);
+  EXPECT_EQ(level_analysis.max_depth(), 1U);
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,63 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <list>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "pass/he_liveness.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_liveness, free_and_new_lists) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{2});
+  auto b = std::make_shared<op::Parameter>(element::f32, Shape{2});
+  // The Add reads the Negate twice, and the Multiply is unused
+  auto neg = std::make_shared<op::Negative>(a);
+  auto add = std::make_shared<op::Add>(neg, neg);
+  auto unused = std::make_shared<op::Multiply>(a, b);
+  auto t = std::make_shared<op::Subtract>(add, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+  auto result = f->get_results()[0];
+
+  std::list<std::shared_ptr<Node>> ops{a, b, neg, add, unused, t, result};
+  pass::HELiveness::run_on_ordered_ops(*f, ops);
+
+  auto tensor = [](const std::shared_ptr<Node>& node) {
+    return &node->output(0).get_tensor();
+  };
+  EXPECT_EQ(neg->liveness_new_list.count(tensor(neg)), 1U);
+  EXPECT_EQ(add->liveness_free_list.size(), 1U);
+  EXPECT_EQ(add->liveness_free_list.count(tensor(neg)), 1U);
+  EXPECT_EQ(add->liveness_new_list.count(tensor(add)), 1U);
+
+  // Tensors are freed by their last reader, and unread tensors by their
+  // writer
+  EXPECT_EQ(unused->liveness_free_list.count(tensor(a)), 1U);
+  EXPECT_EQ(unused->liveness_free_list.count(tensor(unused)), 1U);
+  EXPECT_EQ(unused->liveness_new_list.count(tensor(unused)), 1U);
+  EXPECT_EQ(t->liveness_free_list.count(tensor(add)), 1U);
+  EXPECT_EQ(t->liveness_free_list.count(tensor(b)), 1U);
+
+  // The Result frees its input, but never its output
+  EXPECT_EQ(t->liveness_new_list.count(tensor(t)), 1U);
+  EXPECT_EQ(result->liveness_free_list.count(tensor(t)), 1U);
+  EXPECT_EQ(result->liveness_free_list.count(tensor(result)), 0U);
+  EXPECT_TRUE(result->liveness_new_list.empty());
+}
+
+}  // namespace ngraph::runtime::he
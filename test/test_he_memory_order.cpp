@@ -0,0 +1,63 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "pass/he_liveness.hpp"
+#include "pass/he_memory_order.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+size_t element_count(const Node& node, size_t output_idx) {
+  return shape_size(node.get_output_shape(output_idx));
+}
+}  // namespace
+
+TEST(he_memory_order, reduces_peak) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{});
+  auto wide_1 = std::make_shared<op::Broadcast>(a, Shape{100}, AxisSet{0});
+  auto wide_2 = std::make_shared<op::Broadcast>(a, Shape{100}, AxisSet{0});
+  auto sum_1 = std::make_shared<op::Sum>(wide_1, AxisSet{0});
+  auto sum_2 = std::make_shared<op::Sum>(wide_2, AxisSet{0});
+  auto t = std::make_shared<op::Add>(sum_1, sum_2);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  // Both broadcasts are live at once
+  std::list<std::shared_ptr<Node>> ops{a,     wide_1, wide_2, sum_1,
+                                       sum_2, t,      f->get_results()[0]};
+  EXPECT_EQ(pass::peak_live_bytes(ops, element_count), 201U);
+
+  auto order = pass::memory_minimizing_order(ops, element_count);
+  std::list<std::shared_ptr<Node>> expected{
+      a, wide_1, sum_1, wide_2, sum_2, t, f->get_results()[0]};
+  EXPECT_EQ(order, expected);
+  EXPECT_EQ(pass::peak_live_bytes(order, element_count), 102U);
+
+  // The order is kept if it cannot be improved
+  EXPECT_EQ(pass::memory_minimizing_order(order, element_count), order);
+
+  pass::HELiveness::run_on_ordered_ops(*f, order);
+  EXPECT_EQ(sum_1->liveness_free_list.count(&wide_1->output(0).get_tensor()),
+            1U);
+  EXPECT_EQ(wide_2->liveness_free_list.count(&a->output(0).get_tensor()), 1U);
+}
+
+}  // namespace ngraph::runtime::he
@@ -20,6 +20,8 @@
 #include "gtest/gtest.h"
 #include "ngraph/type/element_type.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/kernel/divide_seal.hpp"
+#include "seal/kernel/plaintext_op_seal.hpp"
 #include "test_util.hpp"
 
 namespace ngraph::runtime::he {
@@ -90,6 +92,51 @@ TEST(he_plaintext, as_double_vec) {
   EXPECT_TRUE(test::all_close(data, plain.as_double_vec()));
 }
 
+TEST(he_plaintext, compact) {
+  HEPlaintext plain{2, 2, 2};
+  EXPECT_FALSE(plain.is_uniform());
+  plain.compact();
+  EXPECT_TRUE(plain.is_uniform());
+  EXPECT_EQ(plain.size(), 1);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(plain.batch_value(i), 2);
+  }
+
+  HEPlaintext distinct{1, 2};
+  distinct.compact();
+  EXPECT_EQ(distinct.size(), 2);
+  EXPECT_EQ(distinct.batch_value(1), 2);
+  EXPECT_EQ(distinct.batch_value(2), 0);
+
+  HEPlaintext empty;
+  empty.compact();
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.batch_value(0), 0);
+}
+
+TEST(he_plaintext, plaintext_op) {
+  auto sub = [](double x, double y) { return x - y; };
+  HEPlaintext out;
+  plaintext_binary_op_seal(HEPlaintext{10}, HEPlaintext{1, 2, 3}, out, sub);
+  EXPECT_EQ(out, (HEPlaintext{9, 8, 7}));
+  plaintext_binary_op_seal(HEPlaintext{1, 2, 3}, HEPlaintext{10}, out, sub);
+  EXPECT_EQ(out, (HEPlaintext{-9, -8, -7}));
+  plaintext_binary_op_seal(HEPlaintext{1, 2, 3}, HEPlaintext{3, 2}, out, sub);
+  EXPECT_EQ(out, (HEPlaintext{-2, 0}));
+
+  // Outputs may alias a broadcast argument
+  HEPlaintext uniform{10};
+  plaintext_binary_op_seal(uniform, HEPlaintext{1, 2}, uniform, sub);
+  EXPECT_EQ(uniform, (HEPlaintext{9, 8}));
+  HEPlaintext values{1, 2, 3};
+  plaintext_unary_op_seal(values, values, [](double x) { return 2 * x; });
+  EXPECT_EQ(values, (HEPlaintext{2, 4, 6}));
+
+  // Division broadcasts a uniform divisor
+  scalar_divide_seal(HEPlaintext{2, 4}, HEPlaintext{2}, out);
+  EXPECT_EQ(out, (HEPlaintext{1, 2}));
+}
+
 TEST(he_plaintext, ostream) {
   std::stringstream ss;
   HEPlaintext plain{1, 2, 3};
@@ -0,0 +1,101 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/file_util.hpp"
+#include "seal/he_seal_autotuner.hpp"
+#include "seal/he_seal_backend.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+HETuningProfile host_profile(const HESealEncryptionParameters& parms) {
+  HETuningProfile profile;
+  profile.hardware_threads = hardware_threads();
+  profile.poly_modulus_degree = parms.poly_modulus_degree();
+  for (const auto& modulus :
+       parms.seal_encryption_parameters().coeff_modulus()) {
+    profile.coeff_modulus_bits.emplace_back(modulus.bit_count());
+  }
+  return profile;
+}
+}  // namespace
+
+TEST(he_seal_autotuner, save_load) {
+  HESealBackend he_backend;
+  auto profile = host_profile(he_backend.get_encryption_parameters());
+  profile.config = {{"lazy_mod", "true"}, {"relu_chunk_bytes", "4096"}};
+  EXPECT_TRUE(profile.matches(he_backend.get_encryption_parameters()));
+
+  std::string filename = file_util::tmp_filename();
+  profile.save(filename);
+  auto loaded = HETuningProfile::load(filename);
+  EXPECT_EQ(loaded.config, profile.config);
+  EXPECT_EQ(loaded.hardware_threads, profile.hardware_threads);
+  EXPECT_EQ(loaded.poly_modulus_degree, profile.poly_modulus_degree);
+  EXPECT_EQ(loaded.coeff_modulus_bits, profile.coeff_modulus_bits);
+  EXPECT_TRUE(loaded.matches(he_backend.get_encryption_parameters()));
+
+  loaded.hardware_threads += 1;
+  EXPECT_FALSE(loaded.matches(he_backend.get_encryption_parameters()));
+  loaded = profile;
+  loaded.coeff_modulus_bits.emplace_back(30);
+  EXPECT_FALSE(loaded.matches(he_backend.get_encryption_parameters()));
+
+  {
+    std::ofstream file(filename, std::ios::trunc);
+    file << "{\"hardware_threads\": 1}";
+  }
+  EXPECT_ANY_THROW(HETuningProfile::load(filename));
+  file_util::remove_file(filename);
+  EXPECT_ANY_THROW(HETuningProfile::load(filename));
+}
+
+TEST(he_seal_autotuner, set_config_tuning_profile) {
+  HESealBackend he_backend;
+  auto profile = host_profile(he_backend.get_encryption_parameters());
+  profile.config = {{"lazy_mod", "true"},
+                    {"relu_chunk_bytes", "4096"},
+                    {"num_intra_op_threads", "1"}};
+  std::string filename = file_util::tmp_filename();
+  profile.save(filename);
+
+  std::string error;
+  EXPECT_TRUE(he_backend.set_config(
+      {{"tuning_profile", filename}, {"relu_chunk_bytes", "8192"}}, error));
+  EXPECT_EQ(he_backend.tuning_profile(), filename);
+  EXPECT_TRUE(he_backend.lazy_mod());
+  // Explicit settings take precedence over the profile's
+  EXPECT_EQ(he_backend.relu_chunk_bytes(), 8192);
+
+  // A matching profile is applied without autotuning
+  EXPECT_TRUE(he_backend.set_config(
+      {{"tuning_profile", filename}, {"autotune", "true"},
+       {"lazy_mod", "false"}}, error));
+  EXPECT_FALSE(he_backend.lazy_mod());
+  EXPECT_EQ(he_backend.relu_chunk_bytes(), 4096);
+
+  file_util::remove_file(filename);
+  EXPECT_ANY_THROW(
+      he_backend.set_config({{"tuning_profile", filename}}, error));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,197 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_batcher.hpp"
+#include "seal/he_seal_executable.hpp"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_seal_batcher, add_packed) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t max_batch_size = 4;
+  Shape shape{max_batch_size, 2};
+  Shape request_shape{1, 2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {a->get_name(), "encrypt,packed"},
+                          {b->get_name(), "packed"}},
+                         error_str);
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  HESealBatcher batcher(*he_backend, he_handle, std::chrono::seconds(10));
+  EXPECT_EQ(batcher.max_batch_size(), max_batch_size);
+
+  // A full batch is executed without waiting for the window
+  {
+    std::vector<std::shared_ptr<runtime::Tensor>> inputs_a;
+    std::vector<std::shared_ptr<runtime::Tensor>> inputs_b;
+    std::vector<std::shared_ptr<runtime::Tensor>> outputs;
+    std::vector<std::future<void>> futures;
+    for (size_t i = 0; i < max_batch_size; ++i) {
+      inputs_a.emplace_back(
+          he_backend->create_plain_tensor(element::f32, request_shape));
+      inputs_b.emplace_back(
+          he_backend->create_plain_tensor(element::f32, request_shape));
+      outputs.emplace_back(
+          he_backend->create_plain_tensor(element::f32, request_shape));
+      auto value = static_cast<float>(i);
+      copy_data(inputs_a.back(), std::vector<float>{value, -value});
+      copy_data(inputs_b.back(), std::vector<float>{1, 2});
+      futures.emplace_back(batcher.submit(
+          {outputs.back()}, {inputs_a.back(), inputs_b.back()}));
+    }
+    for (size_t i = 0; i < max_batch_size; ++i) {
+      futures[i].get();
+      auto value = static_cast<float>(i);
+      EXPECT_TRUE(test::all_close(read_vector<float>(outputs[i]),
+                                  std::vector<float>{value + 1, 2 - value},
+                                  1e-3f));
+    }
+    EXPECT_EQ(batcher.num_calls(), 1);
+  }
+
+  // Shape mismatch
+  {
+    auto t_wrong = he_backend->create_plain_tensor(element::f32, shape);
+    EXPECT_ANY_THROW(batcher.submit({t_wrong}, {t_wrong, t_wrong}));
+  }
+}
+
+TEST(he_seal_batcher, partial_batch) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{8, 3};
+  Shape request_shape{1, 3};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "false"}, {a->get_name(), "packed"}}, error_str);
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  HESealBatcher batcher(*he_backend, he_handle, std::chrono::milliseconds(1));
+
+  auto t_a = he_backend->create_plain_tensor(element::f32, request_shape);
+  auto t_result = he_backend->create_plain_tensor(element::f32, request_shape);
+  copy_data(t_a, std::vector<float>{1, -2, 3});
+
+  batcher.submit({t_result}, {t_a}).get();
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, 4, 9}, 1e-3f));
+  EXPECT_EQ(batcher.num_calls(), 1);
+}
+
+TEST(he_seal_batcher, reject) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  Shape request_shape{1, 3};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "false"}, {a->get_name(), "encrypt,packed"}},
+      error_str);
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  HESealBatcher batcher(*he_backend, he_handle, std::chrono::milliseconds(200),
+                        1);
+  EXPECT_GT(batcher.estimated_call_latency().count(), 0);
+
+  auto t_a = he_backend->create_plain_tensor(element::f32, request_shape);
+  copy_data(t_a, std::vector<float>{1, -2, 3});
+  auto t_result = he_backend->create_plain_tensor(element::f32, request_shape);
+  auto t_rejected =
+      he_backend->create_plain_tensor(element::f32, request_shape);
+
+  // The queue holds one request while the window is open
+  auto queued = batcher.submit({t_result}, {t_a});
+  auto full = batcher.submit({t_rejected}, {t_a});
+  EXPECT_THROW(full.get(), HERequestRejected);
+
+  // Completing by a past deadline is impossible
+  HESealBatcher::RequestOptions late_options;
+  late_options.deadline =
+      std::chrono::steady_clock::now() - std::chrono::seconds(1);
+  queued.get();
+  auto late = batcher.submit({t_rejected}, {t_a}, late_options);
+  EXPECT_THROW(late.get(), HERequestRejected);
+
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, 4, 9}, 1e-3f));
+  EXPECT_EQ(batcher.num_calls(), 1);
+  EXPECT_EQ(batcher.num_rejected(), 2);
+}
+
+TEST(he_seal_batcher, admission_controller) {
+  HEAdmissionController admission(2, 100);
+  admission.acquire(60);
+  EXPECT_EQ(admission.executing_calls(), 1);
+  EXPECT_EQ(admission.reserved_bytes(), 60);
+
+  // The bytes of a second call exceed the bound
+  auto second = std::async(std::launch::async, [&]() {
+    admission.acquire(50);
+  });
+  EXPECT_EQ(second.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  admission.release(60);
+  second.get();
+  EXPECT_EQ(admission.reserved_bytes(), 50);
+
+  // A call above the bound executes alone
+  auto large = std::async(std::launch::async, [&]() {
+    admission.acquire(200);
+  });
+  EXPECT_EQ(large.wait_for(std::chrono::milliseconds(50)),
+            std::future_status::timeout);
+  admission.release(50);
+  large.get();
+  EXPECT_EQ(admission.executing_calls(), 1);
+  admission.release(200);
+  EXPECT_EQ(admission.executing_calls(), 0);
+}
+
+}  // namespace ngraph::runtime::he
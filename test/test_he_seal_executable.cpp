@@ -14,10 +14,14 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
+#include <optional>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 #include "gtest/gtest.h"
+#include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_executable.hpp"
 #include "seal/seal.h"
@@ -33,7 +37,9 @@ class TestHESealExecutable {
   void generate_calls(const element::Type& type, const Node& node,
                       const std::vector<std::shared_ptr<HETensor>>& out,
                       const std::vector<std::shared_ptr<HETensor>>& args) {
-    he_seal_executable->generate_calls(type, node, out, args);
+    he_seal_executable->generate_calls(
+        HESealExecutable::get_typeid(node.get_type_info()), type, node, out,
+        args);
   }
 };
 
@@ -118,6 +124,51 @@ TEST(he_seal_executable, plaintext_with_encrypted_annotation) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-3f));
 }
 
+TEST(he_seal_executable, reuse_encrypted_server_input) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "false"},
+       {a->get_name(), test::config_from_flags(false, true, false)}},
+      error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, false, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, false, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{0, -1, 2, -3});
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  auto he_a = std::static_pointer_cast<HETensor>(t_a);
+
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  ASSERT_TRUE(he_a->data(0).is_ciphertext());
+  auto cipher = he_a->data(0).get_ciphertext();
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, 1, 5, 1}, 1e-3f));
+
+  // The encrypted input is reused by the next call
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_EQ(he_a->data(0).get_ciphertext(), cipher);
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, 1, 5, 1}, 1e-3f));
+
+  // Writing to the input encrypts it again
+  copy_data(t_a, std::vector<float>{2, 3, 4, 5});
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{2, 2, 6, 2}, 1e-3f));
+}
+
 TEST(he_seal_executable, performance_data) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -180,6 +231,204 @@ TEST(he_seal_executable, performance_data) {
   }
 }
 
+TEST(he_seal_executable, compile_pass_times) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  std::vector<std::string> pass_names;
+  for (const auto& [name, ms] : he_handle->compile_pass_times()) {
+    EXPECT_GE(ms, 0);
+    pass_names.emplace_back(name);
+  }
+  // Each pass is listed once, in the order the passes ran
+  auto position = [&pass_names](const std::string& name) {
+    EXPECT_EQ(std::count(pass_names.begin(), pass_names.end(), name), 1)
+        << name;
+    return std::find(pass_names.begin(), pass_names.end(), name) -
+           pass_names.begin();
+  };
+  EXPECT_LT(position("ConstantFolding"), position("HEFusion"));
+  EXPECT_LT(position("HEFusion"), position("HELiveness"));
+  EXPECT_LT(position("SupportedOps"), position("PropagateHEAnnotations"));
+  EXPECT_LT(position("HELevelAnalysis"), position("ExecutionPlan"));
+}
+
+TEST(he_seal_executable, he_performance_data) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {a->get_name(), "encrypt,packed"},
+                          {b->get_name(), "packed"}},
+                         error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, false, true);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, false, true);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, true);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{2, 3, 4, 5});
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  he_handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{2, 6, 12, 20}, 1e-3f));
+
+  // Each of the two packed ciphertexts is multiplied by an encoded
+  // plaintext
+  bool found_multiply = false;
+  for (const auto& perf_counter : he_handle->get_he_performance_data()) {
+    if (perf_counter.get_node()->get_name() != t->get_name()) {
+      continue;
+    }
+    found_multiply = true;
+    EXPECT_EQ(perf_counter.call_count(), 1);
+    EXPECT_EQ(perf_counter.primitive_count(HEPrimitive::multiply_plain), 2);
+    EXPECT_EQ(perf_counter.primitive_count(HEPrimitive::encode), 2);
+    EXPECT_EQ(perf_counter.primitive_count(HEPrimitive::multiply), 0);
+    EXPECT_EQ(perf_counter.ciphertext_count(), 2);
+    EXPECT_EQ(perf_counter.bytes_sent(), 0);
+    EXPECT_EQ(perf_counter.client_wait_microseconds(), 0);
+    // The output ciphertexts are live along with the encrypted input
+    EXPECT_GT(perf_counter.ciphertext_bytes(), 0);
+    EXPECT_GE(perf_counter.peak_live_ciphertext_bytes(),
+              2 * perf_counter.ciphertext_bytes());
+    EXPECT_LE(perf_counter.peak_live_ciphertext_bytes(),
+              he_handle->peak_live_ciphertext_bytes());
+  }
+  EXPECT_TRUE(found_multiply);
+  EXPECT_NE(he_handle->peak_live_ciphertext_node(), nullptr);
+
+  std::string js = he_handle->performance_data_json();
+  EXPECT_NE(js.find(t->get_name()), std::string::npos);
+  EXPECT_NE(js.find("\"multiply_plain\": 2"), std::string::npos);
+  EXPECT_NE(js.find("\"peak_live_bytes\""), std::string::npos);
+}
+
+TEST(he_seal_executable, noise_report) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"noise_telemetry", "true"},
+                          {a->get_name(), "encrypt,packed"}},
+                         error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, false, true);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, true);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  he_handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, 4, 9, 16}, 1e-3f));
+
+  std::optional<HENoiseReport> param_report;
+  std::optional<HENoiseReport> multiply_report;
+  for (const auto& report : he_handle->get_noise_report()) {
+    if (report.node->get_name() == a->get_name()) {
+      param_report = report;
+    } else if (report.node->get_name() == t->get_name()) {
+      multiply_report = report;
+    }
+  }
+  ASSERT_TRUE(param_report.has_value());
+  ASSERT_TRUE(multiply_report.has_value());
+
+  // Each of the two packed ciphertexts is measured
+  EXPECT_EQ(multiply_report->sample.num_samples, 2);
+  EXPECT_LE(multiply_report->sample.chain_index,
+            param_report->sample.chain_index);
+  EXPECT_GT(multiply_report->sample.headroom_bits, 0);
+  EXPECT_GT(multiply_report->sample.precision_bits,
+            s_noise_warning_precision_bits);
+  EXPECT_FALSE(multiply_report->sample.warning());
+  EXPECT_DOUBLE_EQ(multiply_report->precision_drift_bits,
+                   param_report->sample.precision_bits -
+                       multiply_report->sample.precision_bits);
+
+  std::string js = he_handle->noise_report_json();
+  EXPECT_NE(js.find(t->get_name()), std::string::npos);
+  EXPECT_NE(js.find("\"min_chain_index\""), std::string::npos);
+}
+
+TEST(he_seal_executable, estimate_cost) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Constant>(element::f32, shape,
+                                          std::vector<float>{1, 2, 3, 4});
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"dry_run", "true"},
+                          {a->get_name(), "encrypt,packed"}},
+                         error_str);
+
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  HECostReport report = he_handle->estimate_cost();
+
+  std::optional<HENodeCost> multiply_cost;
+  for (const auto& cost : report.nodes) {
+    if (cost.node->get_name() == t->get_name()) {
+      multiply_cost = cost;
+    }
+  }
+  ASSERT_TRUE(multiply_cost.has_value());
+  EXPECT_EQ(multiply_cost->ciphertexts, size_t{2});
+  EXPECT_EQ(multiply_cost->primitives[static_cast<size_t>(
+                HEPrimitive::multiply_plain)],
+            size_t{2});
+  EXPECT_EQ(
+      multiply_cost->primitives[static_cast<size_t>(HEPrimitive::multiply)],
+      size_t{0});
+  EXPECT_TRUE(report.depth_supported());
+  EXPECT_GT(report.peak_live_bytes, size_t{0});
+  EXPECT_GT(report.latency_us, 0);
+  EXPECT_NE(report.to_json().find(t->get_name()), std::string::npos);
+
+  // Dry runs are not executable
+  auto t_a = test::tensor_from_flags(*he_backend, shape, false, true);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, true);
+  EXPECT_ANY_THROW(he_handle->call_with_validate({t_result}, {t_a}));
+
+  // An unreachable latency objective fails compilation
+  he_backend->set_config({{"enable_client", "false"},
+                          {"dry_run", "false"},
+                          {"latency_slo_ms", "1e-9"},
+                          {a->get_name(), "encrypt,packed"}},
+                         error_str);
+  EXPECT_ANY_THROW(he_backend->compile(f));
+}
+
 TEST(he_seal_executable, verbose_op) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -268,4 +517,481 @@ TEST(he_seal_executable, provenance_tag) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-3f));
 }
 
+TEST(he_seal_executable, prepare_galois_keys) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  he_backend->update_encryption_parameters(
+      HESealEncryptionParameters::default_complex_packing_parms());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  // Starts generating the conjugation key
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  auto galois_tool =
+      he_backend->get_context()->key_context_data()->galois_tool();
+  uint32_t conjugation_elt = galois_tool->get_elt_from_step(0);
+  uint32_t rotation_elt = galois_tool->get_elt_from_step(1);
+
+  auto galois_keys = he_backend->get_galois_keys({0});
+  EXPECT_TRUE(galois_keys->has_key(conjugation_elt));
+  EXPECT_FALSE(galois_keys->has_key(rotation_elt));
+
+  // Missing steps are added to the existing ones
+  galois_keys = he_backend->get_galois_keys({1});
+  EXPECT_TRUE(galois_keys->has_key(conjugation_elt));
+  EXPECT_TRUE(galois_keys->has_key(rotation_elt));
+  EXPECT_EQ(he_backend->get_galois_keys({0, 1}), galois_keys);
+}
+
+TEST(he_seal_executable, forward_layout_ops) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto sum = std::make_shared<op::Add>(a, b);
+  // Identity layouts take the data of their sole input
+  auto reshape =
+      std::make_shared<op::Reshape>(sum, AxisVector{0, 1}, Shape{3, 2});
+  auto reverse = std::make_shared<op::Reverse>(reshape, AxisSet{});
+  // Permutations still copy
+  auto transpose =
+      std::make_shared<op::Reshape>(reverse, AxisVector{1, 0}, Shape{2, 3});
+  auto f = std::make_shared<Function>(transpose, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_b = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  auto handle = backend->compile(f);
+
+  // Buffers swapped with their inputs remain usable in later calls
+  for (float offset : {0.0f, 10.0f}) {
+    copy_data(t_a, std::vector<float>{1, 2, 3, 4, 5, 6});
+    copy_data(t_b, std::vector<float>(6, offset));
+    handle->call_with_validate({t_result}, {t_a, t_b});
+    EXPECT_TRUE(test::all_close(
+        read_vector<float>(t_result),
+        std::vector<float>{1 + offset, 3 + offset, 5 + offset, 2 + offset,
+                           4 + offset, 6 + offset},
+        1e-3f));
+  }
+}
+
+TEST(he_seal_executable, in_place_elementwise) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto c = std::make_shared<op::Parameter>(element::f32, shape);
+  // Overwrites the plaintext negation with a ciphertext sum
+  auto neg_c = std::make_shared<op::Negative>(c);
+  auto sum = std::make_shared<op::Add>(neg_c, a);
+  // The transpose shares ciphertexts with sum, which stays live
+  auto transpose = std::make_shared<op::Reshape>(sum, AxisVector{1, 0}, shape);
+  auto prod = std::make_shared<op::Multiply>(transpose, b);
+  auto t = std::make_shared<op::Add>(prod, sum);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b, c});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_b = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_c = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  auto handle = backend->compile(f);
+
+  for (float scale : {1.0f, 2.0f}) {
+    copy_data(t_a, std::vector<float>{scale, 2 * scale, 3 * scale, 4 * scale});
+    copy_data(t_b, std::vector<float>{1, 2, 3, 4});
+    copy_data(t_c, std::vector<float>{1, 1, 1, 1});
+    handle->call_with_validate({t_result}, {t_a, t_b, t_c});
+
+    // sum = a - 1, result = transpose(sum) * b + sum
+    std::vector<float> sum_values{scale - 1, 2 * scale - 1, 3 * scale - 1,
+                                  4 * scale - 1};
+    std::vector<float> expected{
+        sum_values[0] * 1 + sum_values[0], sum_values[2] * 2 + sum_values[1],
+        sum_values[1] * 3 + sum_values[2], sum_values[3] * 4 + sum_values[3]};
+    EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-3f));
+  }
+}
+
+TEST(he_seal_executable, mod_switch_shallow_inputs) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, b);
+  auto sum = std::make_shared<op::Add>(prod, a);
+  auto t = std::make_shared<op::Add>(sum, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+
+  auto t_a = std::static_pointer_cast<HETensor>(
+      he_backend->create_cipher_tensor(element::f32, shape));
+  auto t_b = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{2, 2, 2, 2});
+  size_t chain_index =
+      he_backend->get_chain_index(*t_a->data(0).get_ciphertext());
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{4, 8, 12, 16}, 1e-3f));
+
+  // The parameter is read by other nodes, so it keeps its level
+  for (const auto& he_type : t_a->data()) {
+    EXPECT_EQ(he_backend->get_chain_index(*he_type.get_ciphertext()),
+              chain_index);
+  }
+}
+
+TEST(he_seal_executable, auto_encryption_parameters) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, b);
+  auto t = std::make_shared<op::Multiply>(prod, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  // Oversized parameters
+  std::string param_str = R"(
+    {
+        "scheme_name" : "HE_SEAL",
+        "poly_modulus_degree" : 16384,
+        "security_level" : 128,
+        "coeff_modulus" : [30, 24, 24, 24, 24, 24, 24, 24, 30],
+        "scale" : 16777216,
+        "complex_packing" : false
+    })";
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"encryption_parameters", param_str},
+                          {"auto_encryption_parameters", "true"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+  EXPECT_TRUE(he_backend->auto_encryption_parameters());
+
+  // Depth 2 requires 30 + 24 + 24 + 30 bits
+  auto handle = backend->compile(f);
+  const auto& parms = he_backend->get_encryption_parameters();
+  EXPECT_EQ(parms.poly_modulus_degree(), 4096U);
+  EXPECT_EQ(parms.seal_encryption_parameters().coeff_modulus().size(), 4U);
+  EXPECT_EQ(parms.security_level(), 128U);
+  EXPECT_EQ(parms.scale(), 16777216.0);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_b = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  copy_data(t_b, std::vector<float>{2, 2, 2, 2});
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{4, 8, 12, 16}, 1e-2f));
+}
+
+TEST(he_seal_executable, weight_scale_bits) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape,
+                                std::vector<float>{0.5, -1, 0.25, 2});
+  auto dot = std::make_shared<op::Dot>(a, w);
+  auto t = std::make_shared<op::Multiply>(dot, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  EXPECT_ANY_THROW(
+      he_backend->set_config({{"weight_scale_bits", "61"}}, error_str));
+  he_backend->set_config({{"enable_client", "false"},
+                          {"auto_encryption_parameters", "true"},
+                          {"weight_scale_bits", "12"},
+                          {a->get_name(), "encrypt"}},
+                         error_str);
+  EXPECT_EQ(he_backend->weight_scale_bits(), 12);
+
+  // The Dot is rescaled by a prime of the minimum 20 bits, and the
+  // ciphertext product by a prime of the 24-bit scale
+  auto handle = backend->compile(f);
+  const auto& coeff_modulus = he_backend->get_encryption_parameters()
+                                  .seal_encryption_parameters()
+                                  .coeff_modulus();
+  ASSERT_EQ(coeff_modulus.size(), 4U);
+  EXPECT_EQ(coeff_modulus[1].bit_count(), 24);
+  EXPECT_EQ(coeff_modulus[2].bit_count(), 20);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  handle->call_with_validate({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, 6, 7.5, 20}, 1e-2f));
+}
+
+TEST(he_seal_executable, thread_local_pools) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  EXPECT_EQ(he_backend->pool(), seal::MemoryManager::GetPool());
+
+  Shape shape{4, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"thread_local_pools", "true"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+  EXPECT_TRUE(he_backend->thread_local_pools());
+
+  // Each thread reuses its own pool
+  auto main_pool = he_backend->pool();
+  EXPECT_EQ(he_backend->pool(), main_pool);
+  EXPECT_NE(main_pool, seal::MemoryManager::GetPool());
+  std::thread([&]() { EXPECT_NE(he_backend->pool(), main_pool); }).join();
+  EXPECT_EQ(he_backend->pool_statistics().thread_local_pools, 2U);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_b = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  std::vector<float> input_a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+  std::vector<float> input_b{2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2};
+  copy_data(t_a, input_a);
+  copy_data(t_b, input_b);
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(
+      read_vector<float>(t_result),
+      std::vector<float>{2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24}, 1e-3f));
+
+  auto stats = he_backend->pool_statistics();
+  EXPECT_GE(stats.thread_local_pools, 2U);
+  EXPECT_GT(stats.thread_local_bytes, 0U);
+}
+
+TEST(he_seal_executable, encrypt_constants) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape_a{2, 3};
+  Shape shape_w{3, 2};
+  Shape shape_r{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto w = op::Constant::create(element::f32, shape_w, {1, 2, 3, 4, 5, 6});
+  auto t = std::make_shared<op::Dot>(a, w);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"encrypt_constants", "true"},
+                          {a->get_name(), "packed"}},
+                         error_str);
+  EXPECT_TRUE(he_backend->encrypt_constants());
+
+  auto handle = backend->compile(f);
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*w)->encrypted());
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*t)->encrypted());
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape_a, false, true);
+  auto t_result = test::tensor_from_flags(*he_backend, shape_r, true, true);
+  copy_data(t_a, std::vector<float>{1, 0, -1, 2, 1, 0});
+
+  // The encrypted weights are reused by each call
+  for (size_t call = 0; call < 2; ++call) {
+    handle->call_with_validate({t_result}, {t_a});
+    EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                                std::vector<float>{-4, -4, 5, 8}, 1e-2f));
+  }
+}
+
+TEST(he_seal_executable, materialize_constants) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto c = op::Constant::create(element::f32, shape, {1, 2, 3, 4});
+  // The sum may overwrite the Constant's data in place
+  auto t = std::make_shared<op::Add>(c, a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"}}, error_str);
+  auto handle = backend->compile(f);
+
+  auto t_a = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_plain_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, 1, 1, 1});
+
+  // Each call reads the materialized values of the Constant
+  for (size_t call = 0; call < 2; ++call) {
+    handle->call_with_validate({t_result}, {t_a});
+    EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                                std::vector<float>{2, 3, 4, 5}, 1e-3f));
+  }
+}
+
+TEST(he_seal_executable, variable_batch_size) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {a->get_name(), "encrypt,packed"},
+                          {b->get_name(), "packed"}},
+                         error_str);
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The same executable serves each batch size
+  for (size_t batch_size : {4, 1, 3}) {
+    Shape batch_shape{batch_size, 2};
+    auto t_a = test::tensor_from_flags(*he_backend, batch_shape, false, true);
+    auto t_b = test::tensor_from_flags(*he_backend, batch_shape, false, true);
+    auto t_result =
+        test::tensor_from_flags(*he_backend, batch_shape, true, true);
+    std::vector<float> input_a(2 * batch_size);
+    std::vector<float> input_b(2 * batch_size);
+    std::vector<float> expected(2 * batch_size);
+    for (size_t i = 0; i < input_a.size(); ++i) {
+      input_a[i] = static_cast<float>(i);
+      input_b[i] = 2;
+      expected[i] = 2 * input_a[i];
+    }
+    copy_data(t_a, input_a);
+    copy_data(t_b, input_b);
+    he_handle->call({t_result}, {t_a, t_b});
+    EXPECT_EQ(he_handle->batch_size(), batch_size);
+    EXPECT_TRUE(
+        test::all_close(read_vector<float>(t_result), expected, 1e-3f));
+  }
+
+  // Packed inputs and outputs must share the batch size
+  auto t_1 = test::tensor_from_flags(*he_backend, Shape{1, 2}, false, true);
+  auto t_2 = test::tensor_from_flags(*he_backend, Shape{2, 2}, false, true);
+  auto t_3 = test::tensor_from_flags(*he_backend, Shape{2, 3}, false, true);
+  EXPECT_THROW(he_handle->call({t_2}, {t_1, t_2}), CheckFailure);
+  EXPECT_THROW(he_handle->call({t_1}, {t_2, t_2}), CheckFailure);
+  EXPECT_THROW(he_handle->call({t_3}, {t_3, t_3}), CheckFailure);
+}
+
+TEST(he_seal_executable, executable_cache) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto make_function = [&](float weight) {
+    auto a = std::make_shared<op::Parameter>(element::f32, shape);
+    a->add_provenance_tag("a");
+    auto c = op::Constant::create(element::f32, shape, {weight, 1, 2, 3});
+    auto t = std::make_shared<op::Multiply>(a, c);
+    return std::make_shared<Function>(t, ParameterVector{a});
+  };
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"executable_cache", "true"},
+                          {"a", "encrypt"}},
+                         error_str);
+
+  auto f = make_function(4);
+  auto handle = backend->compile(f);
+  EXPECT_EQ(backend->compile(f), handle);
+  // Functions of the same structure share the executable
+  EXPECT_EQ(backend->compile(make_function(4)), handle);
+  EXPECT_NE(backend->compile(make_function(5)), handle);
+  EXPECT_EQ(he_backend->num_cached_executables(), 2);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, false, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3, 4});
+  handle->call({t_result}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{4, 2, 6, 12}, 1e-3f));
+
+  // A new configuration compiles anew
+  he_backend->set_config({{"a", "packed"}}, error_str);
+  EXPECT_EQ(he_backend->num_cached_executables(), 0);
+  EXPECT_NE(backend->compile(make_function(4)), handle);
+}
+
+TEST(he_seal_executable, warmup) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Divide>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "false"},
+                          {"warmup", "true"},
+                          {a->get_name(), "encrypt,packed"},
+                          {b->get_name(), "packed"}},
+                         error_str);
+  auto he_handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The warmup run is not reported
+  for (const auto& perf_counter : he_handle->get_he_performance_data()) {
+    EXPECT_EQ(perf_counter.call_count(), 0);
+  }
+  EXPECT_EQ(he_handle->peak_live_ciphertext_bytes(), 0);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, false, true);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, false, true);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, true);
+  copy_data(t_a, std::vector<float>{2, 4, 6, 8});
+  copy_data(t_b, std::vector<float>{1, 2, 3, 4});
+  he_handle->call({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{2, 2, 2, 2}, 1e-3f));
+}
+
 }  // namespace ngraph::runtime::he
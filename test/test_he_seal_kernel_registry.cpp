@@ -0,0 +1,86 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_kernel_registry.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+// Arguments of the test kernels, which record the kernel run
+struct Args {
+  size_t size;
+  std::string* ran;
+};
+
+HEKernelRegistry<Args>::Kernel make_kernel(const std::string& name,
+                                           size_t min_size, double cost_us) {
+  return HEKernelRegistry<Args>::Kernel{
+      name, [min_size](const Args& args) { return args.size >= min_size; },
+      [cost_us](const Args& args) {
+        return cost_us * static_cast<double>(args.size);
+      },
+      [name](const Args& args) { *args.ran = name; }};
+}
+}  // namespace
+
+TEST(he_seal_kernel_registry, selects_cheapest_applicable) {
+  HEKernelRegistry<Args> registry;
+  registry.add(make_kernel("generic", 0, 3));
+  registry.add(make_kernel("fast", 4, 1));
+  registry.add(make_kernel("tied", 4, 1));
+  EXPECT_ANY_THROW(registry.add(make_kernel("fast", 0, 0)));
+  EXPECT_EQ(registry.names(),
+            (std::vector<std::string>{"generic", "fast", "tied"}));
+
+  std::string ran;
+  Args small{2, &ran};
+  registry.select(small).run(small);
+  EXPECT_EQ(ran, "generic");
+
+  // Ties are broken in order of registration
+  Args large{8, &ran};
+  registry.select(large).run(large);
+  EXPECT_EQ(ran, "fast");
+}
+
+TEST(he_seal_kernel_registry, selects_named_kernel) {
+  HEKernelRegistry<Args> registry;
+  registry.add(make_kernel("generic", 0, 3));
+  registry.add(make_kernel("fast", 4, 1));
+
+  std::string ran;
+  Args large{8, &ran};
+  EXPECT_EQ(registry.select(large, "generic").name, "generic");
+  EXPECT_ANY_THROW(registry.select(large, "missing"));
+
+  Args small{2, &ran};
+  EXPECT_ANY_THROW(registry.select(small, "fast"));
+}
+
+TEST(he_seal_kernel_registry, throws_if_none_applicable) {
+  HEKernelRegistry<Args> registry;
+  std::string ran;
+  Args args{2, &ran};
+  EXPECT_ANY_THROW(registry.select(args));
+  registry.add(make_kernel("fast", 4, 1));
+  EXPECT_ANY_THROW(registry.select(args));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,88 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_mapped_input.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+void write_file(const std::string& filename, const std::vector<float>& values) {
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  stream.write(reinterpret_cast<const char*>(values.data()),
+               static_cast<std::streamsize>(values.size() * sizeof(float)));
+}
+}  // namespace
+
+TEST(he_seal_mapped_input, maps_file_region) {
+  std::string filename = "he_seal_mapped_input_test.bin";
+  std::vector<float> values(10000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i) / 4;
+  }
+  write_file(filename, values);
+
+  {
+    HESealMappedInput input(filename, "encrypt", element::f32);
+    const HEInputView& view = input.view();
+    EXPECT_EQ(view.config, "encrypt");
+    EXPECT_EQ(view.element_type, element::f32);
+    ASSERT_EQ(view.num_elements, values.size());
+    const auto* data = static_cast<const float*>(view.data);
+    EXPECT_EQ(std::vector<float>(data, data + values.size()), values);
+  }
+
+  // The region starts within a page
+  size_t first = 1500;
+  size_t count = 3000;
+  HESealMappedInput input(filename, "plain", element::f32,
+                          first * sizeof(float), count);
+  ASSERT_EQ(input.view().num_elements, count);
+  const auto* data = static_cast<const float*>(input.view().data);
+  EXPECT_EQ(std::vector<float>(data, data + count),
+            std::vector<float>(values.begin() + first,
+                               values.begin() + first + count));
+
+  HESealMappedInput moved(std::move(input));
+  EXPECT_EQ(moved.view().data, data);
+  EXPECT_EQ(input.view().data, nullptr);
+  std::remove(filename.c_str());
+}
+
+TEST(he_seal_mapped_input, invalid_region) {
+  std::string filename = "he_seal_mapped_input_invalid_test.bin";
+  write_file(filename, std::vector<float>(16, 1));
+
+  EXPECT_ANY_THROW(
+      HESealMappedInput("no_such_input_file.bin", "encrypt", element::f32));
+  EXPECT_ANY_THROW(HESealMappedInput(filename, "encrypt", element::f32, 2));
+  EXPECT_ANY_THROW(
+      HESealMappedInput(filename, "encrypt", element::f32, 0, 17));
+  EXPECT_ANY_THROW(HESealMappedInput(filename, "encrypt", element::i32));
+  EXPECT_EQ(
+      HESealMappedInput(filename, "encrypt", element::f64).view().num_elements,
+      8U);
+  std::remove(filename.c_str());
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,139 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "boost/asio.hpp"
+#include "gtest/gtest.h"
+#include "seal/he_seal_metrics.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+bool contains(const std::string& text, const std::string& line) {
+  return text.find(line + "\n") != std::string::npos;
+}
+}  // namespace
+
+TEST(he_seal_metrics, counter_gauge) {
+  HEMetrics metrics;
+  metrics.add_counter("he_sent_bytes_total", "Bytes sent", 1000);
+  metrics.add_counter("he_sent_bytes_total", "Bytes sent", 24);
+  metrics.set_gauge("he_pending_sessions", "Pending", 3);
+  metrics.set_gauge("he_pending_sessions", "Pending", 2);
+  metrics.add_counter("he_op_seconds_total", "Op time", 0.5,
+                      {{"op", "Convolution"}});
+  metrics.add_counter("he_op_seconds_total", "Op time", 0.25,
+                      {{"op", "Dot\"1\""}});
+
+  std::string text = metrics.to_prometheus_text();
+  EXPECT_TRUE(contains(text, "# HELP he_sent_bytes_total Bytes sent"));
+  EXPECT_TRUE(contains(text, "# TYPE he_sent_bytes_total counter"));
+  EXPECT_TRUE(contains(text, "he_sent_bytes_total 1024"));
+  EXPECT_TRUE(contains(text, "# TYPE he_pending_sessions gauge"));
+  EXPECT_TRUE(contains(text, "he_pending_sessions 2"));
+  EXPECT_TRUE(contains(text, "he_op_seconds_total{op=\"Convolution\"} 0.5"));
+  EXPECT_TRUE(contains(text, "he_op_seconds_total{op=\"Dot\\\"1\\\"\"} 0.25"));
+
+  EXPECT_ANY_THROW(metrics.add_counter("he_sent_bytes_total", "", -1));
+  EXPECT_ANY_THROW(metrics.set_gauge("he_sent_bytes_total", "", 1));
+}
+
+TEST(he_seal_metrics, histogram) {
+  HEMetrics metrics;
+  std::vector<double> bounds{0.1, 1};
+  metrics.observe("he_request_duration_seconds", "Latency", 0.05, bounds);
+  metrics.observe("he_request_duration_seconds", "Latency", 0.1, bounds);
+  metrics.observe("he_request_duration_seconds", "Latency", 0.5, bounds);
+  metrics.observe("he_request_duration_seconds", "Latency", 2, bounds);
+
+  std::string text = metrics.to_prometheus_text();
+  EXPECT_TRUE(contains(text, "# TYPE he_request_duration_seconds histogram"));
+  EXPECT_TRUE(
+      contains(text, "he_request_duration_seconds_bucket{le=\"0.1\"} 2"));
+  EXPECT_TRUE(contains(text, "he_request_duration_seconds_bucket{le=\"1\"} 3"));
+  EXPECT_TRUE(
+      contains(text, "he_request_duration_seconds_bucket{le=\"+Inf\"} 4"));
+  EXPECT_TRUE(contains(text, "he_request_duration_seconds_sum 2.65"));
+  EXPECT_TRUE(contains(text, "he_request_duration_seconds_count 4"));
+}
+
+TEST(he_seal_metrics, server) {
+  HEMetrics metrics;
+  metrics.set_gauge("he_active_sessions", "Active", 1);
+
+  boost::asio::io_context io_context;
+  HEMetricsServer server(
+      io_context, "127.0.0.1", 0,
+      [&]() { return metrics.to_prometheus_text(); },
+      std::chrono::milliseconds(500));
+  std::thread io_thread([&]() { io_context.run(); });
+
+  auto get = [&](const std::string& target) {
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::address_v4::loopback(), server.port()));
+    std::string request = "GET " + target + " HTTP/1.1\r\n\r\n";
+    boost::asio::write(socket, boost::asio::buffer(request));
+    boost::asio::streambuf response;
+    boost::system::error_code ec;
+    boost::asio::read(socket, response, ec);
+    EXPECT_EQ(ec, boost::asio::error::eof);
+    return std::string(boost::asio::buffers_begin(response.data()),
+                       boost::asio::buffers_end(response.data()));
+  };
+
+  std::string response = get("/metrics");
+  EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0);
+  EXPECT_TRUE(contains(response, "he_active_sessions 1"));
+  EXPECT_EQ(get("/").rfind("HTTP/1.1 404 Not Found\r\n", 0), 0);
+
+  // Returns the error ending the response to an incomplete request
+  auto send_partial = [&](const std::string& request) {
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect(boost::asio::ip::tcp::endpoint(
+        boost::asio::ip::address_v4::loopback(), server.port()));
+    boost::asio::write(socket, boost::asio::buffer(request));
+    boost::asio::streambuf response;
+    boost::system::error_code ec;
+    boost::asio::read(socket, response, ec);
+    return ec;
+  };
+  // Headers beyond the request limit are rejected rather than buffered. The
+  // unread request bytes may reset the connection
+  auto ec = send_partial("GET /metrics HTTP/1.1\r\nX-Padding: " +
+                         std::string(16384, 'x'));
+  EXPECT_TRUE(ec == boost::asio::error::eof ||
+              ec == boost::asio::error::connection_reset);
+  // Connections which never complete their request are closed by the
+  // timeout
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(send_partial("GET /metrics HTTP/1.1\r\n"),
+            boost::asio::error::eof);
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(400));
+  EXPECT_EQ(get("/metrics").rfind("HTTP/1.1 200 OK\r\n", 0), 0);
+
+  boost::asio::post(io_context, [&]() { server.close(); });
+  io_thread.join();
+
+  EXPECT_ANY_THROW(HEMetricsServer(io_context, "not an address", 0,
+                                   []() { return std::string(); }));
+}
+
+}  // namespace ngraph::runtime::he
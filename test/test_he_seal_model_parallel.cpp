@@ -0,0 +1,43 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_model_parallel.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_seal_model_parallel, partition_stages) {
+  EXPECT_EQ(partition_stages({1, 1, 1, 1}, 2),
+            (std::vector<size_t>{0, 0, 1, 1}));
+  EXPECT_EQ(partition_stages({1, 1, 1, 1}, 1),
+            (std::vector<size_t>{0, 0, 0, 0}));
+
+  // A costly node fills its stage, and free nodes follow their predecessor
+  EXPECT_EQ(partition_stages({6, 0, 1, 1, 0}, 2),
+            (std::vector<size_t>{0, 0, 1, 1, 1}));
+  EXPECT_EQ(partition_stages({1, 4, 1, 0, 4}, 3),
+            (std::vector<size_t>{0, 0, 1, 1, 2}));
+
+  // With more stages than nodes, some stages remain empty
+  EXPECT_EQ(partition_stages({1, 1}, 8), (std::vector<size_t>{2, 6}));
+  EXPECT_EQ(partition_stages({0, 0}, 2), (std::vector<size_t>{0, 0}));
+  EXPECT_EQ(partition_stages({}, 2), (std::vector<size_t>{}));
+  EXPECT_ANY_THROW(partition_stages({1}, 0));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,71 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <limits>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_thread_budget.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_seal_thread_budget, unbounded) {
+  HEThreadBudget::configure(0);
+  EXPECT_EQ(HEThreadBudget::compute_threads(),
+            std::numeric_limits<size_t>::max());
+  EXPECT_EQ(HEThreadBudget::bound(HEThreadBudget::Subsystem::io, 4), 4);
+  HEThreadBudget::Reservation reservation(8);
+  EXPECT_EQ(reservation.num_threads(), 8);
+}
+
+TEST(he_seal_thread_budget, gc_reservations_reduce_compute_threads) {
+  HEThreadBudget::configure("8,gc:4,io:2");
+  EXPECT_EQ(HEThreadBudget::bound(HEThreadBudget::Subsystem::io, 4), 2);
+  EXPECT_EQ(
+      HEThreadBudget::bound(HEThreadBudget::Subsystem::garbled_circuit, 6),
+      4);
+  EXPECT_EQ(HEThreadBudget::compute_threads(), 6);
+  {
+    HEThreadBudget::Reservation first(3);
+    EXPECT_EQ(first.num_threads(), 3);
+    EXPECT_EQ(HEThreadBudget::compute_threads(), 3);
+
+    // The quota is exhausted, but the calling thread still runs
+    HEThreadBudget::Reservation second(3);
+    EXPECT_EQ(second.num_threads(), 1);
+    HEThreadBudget::Reservation third(3);
+    EXPECT_EQ(third.num_threads(), 1);
+    EXPECT_EQ(HEThreadBudget::compute_threads(), 1);
+  }
+  EXPECT_EQ(HEThreadBudget::compute_threads(), 6);
+  HEThreadBudget::configure(0);
+}
+
+TEST(he_seal_thread_budget, default_quotas) {
+  HEThreadBudget::configure("8");
+  EXPECT_EQ(HEThreadBudget::quota(HEThreadBudget::Subsystem::garbled_circuit),
+            4);
+  EXPECT_EQ(HEThreadBudget::quota(HEThreadBudget::Subsystem::io), 1);
+  EXPECT_EQ(HEThreadBudget::compute_threads(), 7);
+  HEThreadBudget::configure(0);
+}
+
+TEST(he_seal_thread_budget, bad_setting) {
+  EXPECT_ANY_THROW(HEThreadBudget::configure("2,io:2"));
+  EXPECT_ANY_THROW(HEThreadBudget::configure("8,cpu:2"));
+  HEThreadBudget::configure(0);
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,104 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_worker_pool.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(he_seal_worker_pool, replaces_blocked_worker) {
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool released = false;
+  size_t num_calls = 0;
+
+  // With one thread, the first worker waits on the second, which only runs
+  // because the first worker's place is handed over
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (num_calls++ == 0) {
+      HEWorkerPool::BlockingScope blocking_scope;
+      cond.wait(lock, [&]() { return released; });
+    } else {
+      released = true;
+      cond.notify_all();
+    }
+  };
+  HEWorkerPool pool(1, worker);
+  pool.join();
+  EXPECT_TRUE(released);
+  EXPECT_EQ(pool.num_threads_started(), 2);
+}
+
+TEST(he_seal_worker_pool, park_oversubscribed) {
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t num_calls = 0;
+  bool resumed = false;
+  std::atomic<size_t> num_parked_returns{0};
+
+  auto worker = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (num_calls++ == 0) {
+      {
+        HEWorkerPool::BlockingScope blocking_scope;
+        cond.wait(lock, [&]() { return num_calls == 2; });
+      }
+      // Both workers run, so the replacement parks
+      resumed = true;
+      cond.notify_all();
+      return;
+    }
+    cond.notify_all();
+    cond.wait(lock, [&]() { return resumed; });
+    lock.unlock();
+    // Parks until the pool stops, or the resumed worker returns
+    if (HEWorkerPool::current()->park_if_oversubscribed()) {
+      num_parked_returns++;
+    }
+  };
+  HEWorkerPool pool(1, worker);
+  pool.join();
+  EXPECT_EQ(pool.num_threads_started(), 2);
+  EXPECT_EQ(num_parked_returns, 1);
+}
+
+TEST(he_seal_worker_pool, outside_worker) {
+  EXPECT_EQ(HEWorkerPool::current(), nullptr);
+  // Does nothing outside a worker
+  HEWorkerPool::BlockingScope blocking_scope;
+
+  std::atomic<bool> stopped{false};
+  HEWorkerPool pool(2, [&]() {
+    EXPECT_NE(HEWorkerPool::current(), nullptr);
+    while (HEWorkerPool::current()->park_if_oversubscribed()) {
+      if (stopped) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+  });
+  stopped = true;
+  pool.stop();
+  pool.join();
+  EXPECT_EQ(pool.num_threads_started(), 2);
+}
+
+}  // namespace ngraph::runtime::he
@@ -15,6 +15,8 @@
 //*****************************************************************************
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "he_tensor.hpp"
@@ -54,6 +56,34 @@ TEST(he_tensor, empty_cipher_tensor) {
   }
 }
 
+TEST(he_tensor, uninitialized_tensor) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  auto t_plain =
+      std::static_pointer_cast<HETensor>(he_backend->create_plain_tensor(
+          ngraph::element::f32, Shape{2, 3}, false, "plain", false));
+  EXPECT_EQ(t_plain->data().size(), 6);
+  for (const auto& elem : t_plain->data()) {
+    EXPECT_TRUE(elem.is_plaintext());
+    EXPECT_TRUE(elem.get_plaintext().empty());
+  }
+
+  // Each ciphertext is allocated separately, so kernels write them in place
+  auto t_cipher =
+      std::static_pointer_cast<HETensor>(he_backend->create_cipher_tensor(
+          ngraph::element::f32, Shape{2, 3}, false, "cipher", false));
+  EXPECT_EQ(t_cipher->data().size(), 6);
+  for (const auto& elem : t_cipher->data()) {
+    EXPECT_TRUE(elem.is_ciphertext());
+    EXPECT_EQ(elem.get_ciphertext().use_count(), 1);
+  }
+
+  std::vector<float> values{1, 2, 3, 4, 5, 6};
+  copy_data(t_cipher, values);
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_cipher), values, 1e-3f));
+}
+
 TEST(he_tensor, pack_non_zero_axis) {
   EXPECT_ANY_THROW(HETensor::pack_shape(Shape{2, 1}, 1));
   EXPECT_ANY_THROW(HETensor::unpack_shape(Shape{1, 1}, 2, 1));
@@ -117,6 +147,36 @@ TEST(he_tensor, unpack) {
   EXPECT_EQ(plain.data(3).get_plaintext()[0], 3);
 }
 
+TEST(he_tensor, pack_unpack_blocks) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Spans several pack blocks, the last of them partial
+  Shape shape{3, 150};
+  HETensor plain(element::f32, shape, false, false, false, *he_backend);
+  for (size_t i = 0; i < shape_size(shape); ++i) {
+    plain.data(i).set_plaintext(HEPlaintext({static_cast<double>(i)}));
+  }
+  plain.pack();
+
+  EXPECT_EQ(plain.data().size(), 150);
+  for (size_t i = 0; i < 150; ++i) {
+    const auto& packed = plain.data(i).get_plaintext();
+    ASSERT_EQ(packed.size(), 3);
+    EXPECT_EQ(plain.data(i).batch_size(), 3);
+    for (size_t batch_idx = 0; batch_idx < 3; ++batch_idx) {
+      EXPECT_EQ(packed[batch_idx], batch_idx * 150 + i);
+    }
+  }
+
+  plain.unpack();
+  EXPECT_EQ(plain.data().size(), shape_size(shape));
+  for (size_t i = 0; i < shape_size(shape); ++i) {
+    EXPECT_EQ(plain.data(i).get_plaintext().size(), 1);
+    EXPECT_EQ(plain.data(i).get_plaintext()[0], i);
+  }
+}
+
 TEST(he_tensor, save) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -237,6 +297,133 @@ TEST(he_tensor, load_from_context) {
                               read_vector<float>(saved_he_tensor)));
 }
 
+TEST(he_tensor, save_load_seeded) {
+  auto parms = HESealEncryptionParameters::default_real_packing_parms();
+  auto context =
+      std::make_shared<seal::SEALContext>(parms.seal_encryption_parameters());
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::Encryptor secret_key_encryptor(*context, keygen.secret_key());
+  seal::Decryptor decryptor(*context, keygen.secret_key());
+  seal::CKKSEncoder ckks_encoder(*context);
+
+  Shape shape{2};
+  std::vector<double> tensor_data({5, 6});
+  HETensor public_key_tensor(element::f64, shape, false, false, true,
+                             ckks_encoder, context, encryptor, decryptor, parms,
+                             "tensor_name");
+  public_key_tensor.write(tensor_data.data(),
+                          tensor_data.size() * sizeof(double));
+  HETensor seeded_tensor(element::f64, shape, false, false, true, ckks_encoder,
+                         context, encryptor, decryptor, parms, "tensor_name");
+  seeded_tensor.write_seeded(tensor_data.data(),
+                             tensor_data.size() * sizeof(double),
+                             secret_key_encryptor);
+  EXPECT_TRUE(seeded_tensor.data(0).get_ciphertext()->is_seeded());
+
+  auto public_key_pb_tensors = public_key_tensor.write_to_pb_tensors();
+  std::vector<TCPMessage::Segments> segments;
+  auto pb_tensors = seeded_tensor.write_to_pb_tensors(&segments);
+  ASSERT_EQ(pb_tensors.size(), 1);
+  ASSERT_EQ(segments.size(), 1);
+  EXPECT_TRUE(segments[0].empty());
+  EXPECT_LT(pb_tensors[0].ByteSize(), public_key_pb_tensors[0].ByteSize());
+
+  auto loaded_he_tensor = HETensor::load_from_pb_tensors(
+      pb_tensors, ckks_encoder, context, encryptor, decryptor, parms);
+  EXPECT_FALSE(loaded_he_tensor->data(0).get_ciphertext()->is_seeded());
+
+  std::vector<double> loaded_data(tensor_data.size());
+  loaded_he_tensor->read(loaded_data.data(),
+                         loaded_data.size() * sizeof(double));
+  EXPECT_TRUE(test::all_close(loaded_data, tensor_data, 1e-3, 1e-3));
+}
+
+TEST(he_tensor, write_elements_chunked) {
+  auto parms = HESealEncryptionParameters::default_real_packing_parms();
+  auto context =
+      std::make_shared<seal::SEALContext>(parms.seal_encryption_parameters());
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::Decryptor decryptor(*context, keygen.secret_key());
+  seal::CKKSEncoder ckks_encoder(*context);
+
+  Shape shape{5};
+  std::vector<double> tensor_data({1, -2, 3, -4, 5});
+  size_t num_bytes = tensor_data.size() * sizeof(double);
+  HETensor saved_tensor(element::f64, shape, false, false, true, ckks_encoder,
+                        context, encryptor, decryptor, parms, "tensor_name");
+  auto loaded_tensor = std::make_shared<HETensor>(
+      element::f64, shape, false, false, true, ckks_encoder, context,
+      encryptor, decryptor, parms, "tensor_name");
+
+  EXPECT_ANY_THROW(saved_tensor.write_elements(tensor_data.data(), num_bytes,
+                                               3, 6));
+  EXPECT_ANY_THROW(saved_tensor.write_elements_to_pb_tensors(4, 2));
+
+  // Chunks are written and loaded out of order
+  std::vector<std::pair<size_t, size_t>> chunks{{3, 5}, {0, 1}, {1, 3}};
+  for (const auto& [begin, end] : chunks) {
+    saved_tensor.write_elements(tensor_data.data(), num_bytes, begin, end);
+    auto pb_tensors = saved_tensor.write_elements_to_pb_tensors(begin, end);
+    ASSERT_EQ(pb_tensors.size(), 1);
+    EXPECT_EQ(pb_tensors[0].offset(), begin);
+    EXPECT_EQ(pb_tensors[0].data_size(), end - begin);
+    EXPECT_FALSE(loaded_tensor->done_loading());
+    HETensor::load_from_pb_tensor(loaded_tensor, pb_tensors[0], context);
+  }
+  EXPECT_TRUE(loaded_tensor->done_loading());
+
+  std::vector<double> loaded_data(tensor_data.size());
+  loaded_tensor->read(loaded_data.data(), num_bytes);
+  EXPECT_TRUE(test::all_close(loaded_data, tensor_data, 1e-3, 1e-3));
+}
+
+TEST(he_tensor, write_to_pb_tensor_frames) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto parms = HESealEncryptionParameters::default_real_packing_parms();
+  he_backend->update_encryption_parameters(parms);
+
+  Shape shape{5};
+  auto tensor = std::static_pointer_cast<HETensor>(
+      he_backend->create_cipher_tensor(element::f32, shape, false,
+                                       "tensor_name"));
+  std::vector<float> tensor_data({1, -2, 3, -4, 5});
+  copy_data(tensor, tensor_data);
+
+  auto loaded_tensor =
+      std::static_pointer_cast<HETensor>(he_backend->create_cipher_tensor(
+          element::f32, shape, false, "tensor_name"));
+
+  // A frame size below a single ciphertext still writes one per frame
+  size_t num_frames = 0;
+  tensor->write_to_pb_tensor_frames(
+      1, [&](pb::HETensor&& pb_tensor, TCPMessage::Segments&& segments) {
+        EXPECT_EQ(pb_tensor.offset(), num_frames);
+        EXPECT_EQ(pb_tensor.data_size(), 1);
+        EXPECT_EQ(segments.size(), 1);
+        // Payload offsets are relative to the frame's concatenated segments
+        std::vector<char> payload;
+        for (const auto& segment : segments) {
+          const auto* data = static_cast<const char*>(segment.data);
+          payload.insert(payload.end(), data, data + segment.size);
+        }
+        HETensor::load_from_pb_tensor(loaded_tensor, pb_tensor,
+                                      he_backend->get_context(),
+                                      payload.data(), payload.size());
+        num_frames++;
+      });
+  EXPECT_EQ(num_frames, shape_size(shape));
+  EXPECT_TRUE(loaded_tensor->done_loading());
+  EXPECT_TRUE(test::all_close(read_vector<float>(loaded_tensor), tensor_data,
+                              1e-3f));
+}
+
 TEST(he_tensor, io_bounds) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -256,6 +443,63 @@ TEST(he_tensor, io_bounds) {
   EXPECT_ANY_THROW(t_a->write(dummy, element_type.size() * 100));
 }
 
+TEST(he_tensor, read_as_type) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Batched cipher and plain tensors of shape {2, 3}
+  Shape shape{2, 3};
+  std::vector<float> values{1.2, -2, 3, 4, 5.7, -6};
+  for (bool encrypted : {false, true}) {
+    auto tensor = std::static_pointer_cast<HETensor>(
+        encrypted ? he_backend->create_packed_cipher_tensor(element::f32, shape)
+                  : he_backend->create_packed_plain_tensor(element::f32,
+                                                           shape));
+    copy_data(tensor, values);
+
+    std::vector<double> doubles(values.size());
+    tensor->read(doubles.data(), doubles.size() * sizeof(double),
+                 element::f64);
+    EXPECT_TRUE(test::all_close(
+        doubles, std::vector<double>{values.begin(), values.end()}, 1e-3));
+
+    std::vector<int64_t> ints(values.size());
+    tensor->read(ints.data(), ints.size() * sizeof(int64_t), element::i64);
+    EXPECT_EQ(ints, (std::vector<int64_t>{1, -2, 3, 4, 6, -6}));
+
+    // Too many bytes of the requested type
+    EXPECT_ANY_THROW(tensor->read(doubles.data(),
+                                  2 * doubles.size() * sizeof(double),
+                                  element::f64));
+  }
+}
+
+TEST(he_tensor, uniform_plaintext) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Batch values of the first element are equal
+  Shape shape{3, 2};
+  std::vector<float> values{1, 2, 1, 3, 1, 4};
+  auto tensor = std::static_pointer_cast<HETensor>(
+      he_backend->create_packed_plain_tensor(element::f32, shape));
+  for (const auto& elem : tensor->data()) {
+    EXPECT_TRUE(elem.get_plaintext().is_uniform());
+  }
+  copy_data(tensor, values);
+  EXPECT_TRUE(tensor->data(0).get_plaintext().is_uniform());
+  EXPECT_EQ(tensor->data(1).get_plaintext().size(), 3);
+
+  std::vector<float> read_values(values.size());
+  tensor->read(read_values.data(), read_values.size() * sizeof(float));
+  EXPECT_EQ(read_values, values);
+
+  tensor->unpack();
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(tensor->data(2 * i).get_plaintext()[0], 1);
+  }
+}
+
 TEST(he_tensor, zero) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -270,4 +514,32 @@ TEST(he_tensor, zero) {
 
   EXPECT_EQ(t_zero->get_batched_element_count(), 0);
 }
+
+TEST(he_tensor, deep_copy) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  auto t_a =
+      std::static_pointer_cast<HETensor>(he_backend->create_cipher_tensor(
+          element::f32, Shape{2, 3}, false));
+  std::vector<float> values{1, -2, 3, -4, 5, -6};
+  copy_data(t_a, values);
+
+  auto t_copy = t_a->deep_copy();
+  EXPECT_EQ(t_copy->get_shape(), t_a->get_shape());
+  EXPECT_TRUE(t_copy->done_loading());
+  // Switching the modulus of the copy leaves the original unchanged
+  size_t chain_index =
+      he_backend->get_chain_index(*t_a->data()[0].get_ciphertext());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NE(t_copy->data()[i].get_ciphertext(),
+              t_a->data()[i].get_ciphertext());
+    he_backend->mod_switch_to_lowest(*t_copy->data()[i].get_ciphertext());
+  }
+  EXPECT_EQ(he_backend->get_chain_index(*t_a->data()[0].get_ciphertext()),
+            chain_index);
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_a), values, 1e-3f));
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_copy), values, 1e-3f));
+}
+
 }  // namespace ngraph::runtime::he
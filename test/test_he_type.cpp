@@ -14,13 +14,16 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
 #include "gtest/gtest.h"
 #include "he_plaintext.hpp"
 #include "he_type.hpp"
 #include "ngraph/ngraph.hpp"
 #include "seal/he_seal_backend.hpp"
+#include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "test_util.hpp"
 #include "util/test_tools.hpp"
@@ -148,4 +151,88 @@ TEST(he_type, save_load) {
   }
 }
 
+TEST(he_type, trusted_load) {
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {30, 30, 30}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::CKKSEncoder encoder(*context);
+
+  seal::Plaintext plain;
+  encoder.encode(1.0, 1 << 25, plain);
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encryptor.encrypt(plain, cipher->ciphertext());
+  HEType he_type(cipher, false, 1);
+
+  pb::HEType pb_type;
+  TCPMessage::Segment segment;
+  he_type.save(pb_type, &segment);
+  std::string payload(static_cast<const char*>(segment.data), segment.size);
+
+  auto loaded =
+      HEType::load(pb_type, context, payload.data(), payload.size(), true);
+  EXPECT_TRUE(loaded.is_ciphertext());
+  EXPECT_EQ(loaded.get_ciphertext()->ciphertext().parms_id(),
+            context->first_parms_id());
+
+  // A coefficient outside its modulus is only detected by validation
+  auto* coeffs = reinterpret_cast<std::uint64_t*>(payload.data());
+  coeffs[0] = ~std::uint64_t{0};
+  EXPECT_ANY_THROW(
+      HEType::load(pb_type, context, payload.data(), payload.size()));
+  EXPECT_NO_THROW(
+      HEType::load(pb_type, context, payload.data(), payload.size(), true));
+}
+
+TEST(he_type, load_invalid_header) {
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {30, 30, 30}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::CKKSEncoder encoder(*context);
+
+  seal::Plaintext plain;
+  encoder.encode(1.0, 1 << 25, plain);
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encryptor.encrypt(plain, cipher->ciphertext());
+  HEType he_type(cipher, false, 1);
+
+  pb::HEType pb_type;
+  TCPMessage::Segment segment;
+  he_type.save(pb_type, &segment);
+  std::string payload(static_cast<const char*>(segment.data), segment.size);
+  EXPECT_NO_THROW(
+      HEType::load(pb_type, context, payload.data(), payload.size()));
+
+  // Headers are rejected before allocating the ciphertext
+  pb::HEType large_type = pb_type;
+  large_type.mutable_ciphertext_header()->set_size(1UL << 40U);
+  EXPECT_ANY_THROW(
+      HEType::load(large_type, context, payload.data(), payload.size()));
+
+  pb::HEType short_type = pb_type;
+  short_type.mutable_ciphertext_header()->set_size(3);
+  EXPECT_ANY_THROW(
+      HEType::load(short_type, context, payload.data(), payload.size()));
+
+  pb::HEType offset_type = pb_type;
+  offset_type.mutable_ciphertext_header()->set_payload_offset(~0UL);
+  EXPECT_ANY_THROW(
+      HEType::load(offset_type, context, payload.data(), payload.size()));
+}
+
 }  // namespace ngraph::runtime::he
@@ -20,7 +20,10 @@
 
 #include "gtest/gtest.h"
 #include "he_util.hpp"
+#include "ngraph/ngraph.hpp"
 #include "ngraph/type/element_type.hpp"
+#include "op/bounded_relu.hpp"
+#include "op/refresh.hpp"
 #include "test_util.hpp"
 #include "util/test_tools.hpp"
 
@@ -108,6 +111,54 @@ TEST(he_util, type_to_double) {
   EXPECT_ANY_THROW(type_to_double(nullptr, element::i8));
 }
 
+TEST(he_util, double_to_type) {
+  auto test_double_to_type = [](auto x, double value) {
+    double_to_type(value, &x, element::from<decltype(x)>());
+    EXPECT_EQ(x, static_cast<decltype(x)>(value));
+  };
+
+  test_double_to_type(double{0}, 10.7);
+  test_double_to_type(float{0}, 10.3);
+  test_double_to_type(int32_t{0}, 10);
+  test_double_to_type(int64_t{0}, -10);
+
+  // Integral types are rounded
+  int64_t rounded = 0;
+  double_to_type(10.7, &rounded, element::i64);
+  EXPECT_EQ(rounded, 11);
+
+  // Unsupported type
+  EXPECT_ANY_THROW(double_to_type(1, nullptr, element::i8));
+}
+
+TEST(he_util, strided_conversion) {
+  // Contiguous and strided values, as in batches of a packed tensor
+  std::vector<int32_t> values{1, -2, 3, -4, 5, -6};
+  std::vector<double> doubles(3);
+  strided_to_doubles(values.data(), sizeof(int32_t), 3, element::i32,
+                     doubles.data());
+  EXPECT_EQ(doubles, (std::vector<double>{1, -2, 3}));
+  strided_to_doubles(values.data() + 1, 2 * sizeof(int32_t), 3, element::i32,
+                     doubles.data());
+  EXPECT_EQ(doubles, (std::vector<double>{-2, -4, -6}));
+
+  // Integral types are rounded
+  std::vector<double> source{1.4, 2.6, -3.7};
+  std::vector<int64_t> ints(6, 0);
+  doubles_to_strided(source.data(), 3, ints.data(), 2 * sizeof(int64_t),
+                     element::i64);
+  EXPECT_EQ(ints, (std::vector<int64_t>{1, 0, 3, 0, -4, 0}));
+  std::vector<float> floats(3);
+  doubles_to_strided(source.data(), 3, floats.data(), sizeof(float),
+                     element::f32);
+  EXPECT_EQ(floats, (std::vector<float>{1.4F, 2.6F, -3.7F}));
+
+  // Unsupported type
+  EXPECT_ANY_THROW(
+      strided_to_doubles(nullptr, 1, 0, element::i8, doubles.data()));
+  EXPECT_ANY_THROW(doubles_to_strided(nullptr, 0, nullptr, 1, element::u8));
+}
+
 TEST(he_util, param_originates_from_name) {
   op::Parameter param{element::f32, Shape{}};
 
@@ -132,4 +183,36 @@ TEST(he_util, type_to_pb_type) {
     EXPECT_EQ(pb_type_to_type(type_to_pb_type(type)), type);
   }
 }
+
+TEST(he_util, node_to_pb_op_request) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{2});
+  auto relu = std::make_shared<op::Relu>(a);
+  auto bounded_relu = std::make_shared<op::BoundedRelu>(a, 6.0f);
+  auto refresh = std::make_shared<op::Refresh>(a);
+  auto add = std::make_shared<op::Add>(a, a);
+
+  EXPECT_EQ(node_to_pb_op_request(*relu).op(), pb::OpRequest_Op_RELU);
+  EXPECT_EQ(node_to_pb_op_request(*refresh).op(), pb::OpRequest_Op_REFRESH);
+  auto op_request = node_to_pb_op_request(*bounded_relu);
+  EXPECT_EQ(op_request.op(), pb::OpRequest_Op_BOUNDED_RELU);
+  EXPECT_DOUBLE_EQ(op_request.bound(), 6.0);
+  EXPECT_ANY_THROW(node_to_pb_op_request(*add));
+
+  auto sigmoid = std::make_shared<op::Sigmoid>(a);
+  op_request = node_to_pb_op_request(*sigmoid);
+  EXPECT_EQ(op_request.op(), pb::OpRequest_Op_ELEMENTWISE);
+  EXPECT_EQ(op_request.function(), "Sigmoid");
+}
+
+TEST(he_util, client_elementwise_function) {
+  auto sigmoid = client_elementwise_function("Sigmoid");
+  ASSERT_NE(sigmoid, nullptr);
+  EXPECT_DOUBLE_EQ(sigmoid(0), 0.5);
+  auto sign = client_elementwise_function("Sign");
+  ASSERT_NE(sign, nullptr);
+  EXPECT_DOUBLE_EQ(sign(-3), -1);
+  EXPECT_DOUBLE_EQ(sign(0), 0);
+  EXPECT_EQ(client_elementwise_function("Relu"), nullptr);
+  EXPECT_EQ(client_elementwise_function("Add"), nullptr);
+}
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,125 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "he_op_annotations.hpp"
+#include "ngraph/ngraph.hpp"
+#include "op/refresh.hpp"
+#include "pass/he_level_analysis.hpp"
+#include "pass/insert_refresh.hpp"
+#include "pass/propagate_he_annotations.hpp"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+size_t count_refreshes(const Function& f) {
+  size_t count = 0;
+  for (const auto& node : f.get_ordered_ops()) {
+    if (std::dynamic_pointer_cast<op::Refresh>(node) != nullptr) {
+      ++count;
+    }
+  }
+  return count;
+}
+}  // namespace
+
+TEST(insert_refresh, linear_stack) {
+  Shape shape{2, 2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto c = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod1 = std::make_shared<op::Multiply>(a, c);
+  auto prod2 = std::make_shared<op::Multiply>(prod1, c);
+  auto prod3 = std::make_shared<op::Multiply>(prod2, c);
+  auto sum = std::make_shared<op::Add>(prod3, a);
+  auto f = std::make_shared<Function>(sum, ParameterVector{a, c});
+
+  a->set_op_annotations(test::annotation_from_flags(false, true, false));
+  c->set_op_annotations(test::annotation_from_flags(false, false, false));
+  pass::PropagateHEAnnotations().run_on_function(f);
+
+  // Depth 1 is within the chain, so prod1 is kept
+  EXPECT_TRUE(pass::InsertRefresh(1).run_on_function(f));
+  EXPECT_EQ(count_refreshes(*f), 2U);
+  EXPECT_EQ(prod1->input_value(0).get_node_shared_ptr(), a);
+
+  auto refresh1 = prod2->input_value(0).get_node_shared_ptr();
+  ASSERT_TRUE(std::dynamic_pointer_cast<op::Refresh>(refresh1) != nullptr);
+  EXPECT_EQ(refresh1->input_value(0).get_node_shared_ptr(), prod1);
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*refresh1)->encrypted());
+  EXPECT_FALSE(HEOpAnnotations::from_client(*refresh1));
+
+  pass::HELevelAnalysis level_analysis(true);
+  level_analysis.run_on_function(f);
+  EXPECT_EQ(level_analysis.max_depth(), 1U);
+  EXPECT_EQ(level_analysis.depth(*prod3), 1U);
+
+  // The refreshed function fits, so it is unchanged
+  EXPECT_FALSE(pass::InsertRefresh(1).run_on_function(f));
+  EXPECT_EQ(count_refreshes(*f), 2U);
+}
+
+TEST(insert_refresh, shared_refresh) {
+  Shape shape{2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto c = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, c);
+  auto left = std::make_shared<op::Multiply>(prod, c);
+  auto right = std::make_shared<op::Multiply>(prod, a);
+  auto sum = std::make_shared<op::Add>(left, right);
+  auto f = std::make_shared<Function>(sum, ParameterVector{a, c});
+
+  a->set_op_annotations(test::annotation_from_flags(false, true, false));
+  c->set_op_annotations(test::annotation_from_flags(false, false, false));
+  pass::PropagateHEAnnotations().run_on_function(f);
+
+  EXPECT_TRUE(pass::InsertRefresh(1).run_on_function(f));
+  EXPECT_EQ(count_refreshes(*f), 1U);
+  EXPECT_EQ(left->input_value(0).get_node_shared_ptr(),
+            right->input_value(0).get_node_shared_ptr());
+  // The fresh input of right needs no refresh
+  EXPECT_EQ(right->input_value(1).get_node_shared_ptr(), a);
+}
+
+TEST(insert_refresh, too_deep) {
+  Shape shape{2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto prod = std::make_shared<op::Multiply>(a, a);
+  auto relu = std::make_shared<op::Relu>(prod);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  a->set_op_annotations(test::annotation_from_flags(false, true, false));
+  pass::PropagateHEAnnotations().run_on_function(f);
+
+  // A polynomial deeper than the chain cannot be refreshed
+  pass::InsertRefresh insert_refresh(
+      2, [&](const Node& node) -> std::optional<size_t> {
+        if (&node == relu.get()) {
+          return 3;
+        }
+        return std::nullopt;
+      });
+  EXPECT_ANY_THROW(insert_refresh.run_on_function(f));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,134 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "he_plaintext.hpp"
+#include "he_type.hpp"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/kernel/integer_seal.hpp"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+HESealEncryptionParameters integer_test_parms() {
+  return HESealEncryptionParameters::integer_parms(4096, {36, 36, 37}, 20, 0);
+}
+
+HEType encrypt_integers(const HESealBackend& he_backend,
+                        const HEPlaintext& values) {
+  std::shared_ptr<SealCiphertextWrapper> cipher;
+  he_backend.encrypt(cipher, values, element::i64, false);
+  return HEType(cipher, false, values.size());
+}
+
+HEPlaintext decrypt_integers(const HESealBackend& he_backend,
+                             const HEType& he_type) {
+  if (he_type.is_plaintext()) {
+    return he_type.get_plaintext();
+  }
+  HEPlaintext values;
+  he_backend.decrypt(values, *he_type.get_ciphertext(), he_type.batch_size(),
+                     false);
+  return values;
+}
+}  // namespace
+
+TEST(integer_seal, parms) {
+  auto parms = integer_test_parms();
+  EXPECT_TRUE(parms.integer_scheme());
+  EXPECT_EQ(parms.scheme(), seal::scheme_type::bfv);
+  EXPECT_EQ(parms.scale(), 1.0);
+  EXPECT_GT(parms.plain_modulus(), 1U << 19U);
+  EXPECT_LT(parms.plain_modulus(), 1U << 20U);
+
+  std::stringstream stream;
+  parms.save(stream);
+  EXPECT_EQ(HESealEncryptionParameters::load(stream), parms);
+
+  EXPECT_FALSE(HESealEncryptionParameters().integer_scheme());
+  EXPECT_EQ(HESealEncryptionParameters().plain_modulus(), 0);
+}
+
+TEST(integer_seal, encrypt_decrypt) {
+  HESealBackend he_backend(integer_test_parms());
+  ASSERT_TRUE(he_backend.integer_scheme());
+  ASSERT_NE(he_backend.get_batch_encoder(), nullptr);
+  EXPECT_ANY_THROW(he_backend.get_ckks_encoder());
+
+  HEPlaintext values{-3, 0, 7, 12345};
+  auto cipher = encrypt_integers(he_backend, values);
+  EXPECT_EQ(decrypt_integers(he_backend, cipher), values);
+
+  // Values must fit in the plain modulus
+  std::shared_ptr<SealCiphertextWrapper> out;
+  EXPECT_ANY_THROW(he_backend.encrypt(out, HEPlaintext{1e9}, element::i64,
+                                      false));
+}
+
+TEST(integer_seal, binary_ops) {
+  HESealBackend he_backend(integer_test_parms());
+  HEPlaintext x{-3, 4, 10};
+  HEPlaintext y{5, -2, 6};
+
+  auto check_op = [&](IntegerOp op, const HEPlaintext& expected) {
+    std::vector<HEType> cipher_args{encrypt_integers(he_backend, x),
+                                    encrypt_integers(he_backend, y)};
+    std::vector<HEType> plain_args{HEType(x, false), HEType(y, false)};
+
+    // Cipher-cipher, cipher-plain, plain-cipher and plain-plain
+    for (const auto& arg0 : {cipher_args[0], plain_args[0]}) {
+      for (const auto& arg1 : {cipher_args[1], plain_args[1]}) {
+        std::vector<HEType> out(1, HEType(HEPlaintext(), false));
+        integer_binary_seal({arg0}, {arg1}, out, 1, op, he_backend);
+        EXPECT_EQ(decrypt_integers(he_backend, out[0]), expected);
+      }
+    }
+  };
+  check_op(IntegerOp::add, HEPlaintext{2, 2, 16});
+  check_op(IntegerOp::subtract, HEPlaintext{-8, 6, 4});
+  check_op(IntegerOp::multiply, HEPlaintext{-15, -8, 60});
+
+  std::vector<HEType> arg{encrypt_integers(he_backend, x)};
+  integer_negate_seal(arg, arg, 1, he_backend);
+  EXPECT_EQ(decrypt_integers(he_backend, arg[0]), (HEPlaintext{3, -4, -10}));
+}
+
+TEST(integer_seal, multiply_by_zero) {
+  HESealBackend he_backend(integer_test_parms());
+  std::vector<HEType> arg0{encrypt_integers(he_backend, HEPlaintext{1, 2})};
+  std::vector<HEType> arg1{HEType(HEPlaintext{0}, false)};
+  integer_binary_seal(arg0, arg1, arg0, 1, IntegerOp::multiply, he_backend);
+  ASSERT_TRUE(arg0[0].is_plaintext());
+  EXPECT_EQ(arg0[0].get_plaintext(), HEPlaintext{0});
+}
+
+TEST(integer_seal, compile_requires_ckks) {
+  HESealBackend he_backend(integer_test_parms());
+  Shape shape{2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto f = std::make_shared<Function>(a, ParameterVector{a});
+  EXPECT_ANY_THROW(he_backend.compile(f));
+}
+
+}  // namespace ngraph::runtime::he
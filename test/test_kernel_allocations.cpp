@@ -0,0 +1,152 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/dot_seal.hpp"
+#include "seal/kernel/multiply_accumulate_seal.hpp"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "seal/seal_util.hpp"
+#include "test_util.hpp"
+
+namespace {
+// Counts the heap allocations of this test binary, which is built apart
+// from unit-test, see test/CMakeLists.txt
+std::atomic<size_t> s_allocations{0};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  s_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t /* size */) noexcept {
+  std::free(ptr);
+}
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Returns the number of heap allocations made by a function
+template <typename F>
+size_t count_allocations(F&& f) {
+  size_t begin = s_allocations.load();
+  f();
+  return s_allocations.load() - begin;
+}
+
+// Allocations allowed per kernel output in steady state, i.e. the output
+// ciphertext, and allocations allowed per call, e.g. by the memory pool
+constexpr size_t s_output_budget = 4;
+constexpr size_t s_call_budget = 32;
+
+std::vector<HEType> encrypt_values(const std::vector<double>& values,
+                                   HESealBackend& he_backend) {
+  std::vector<HEType> ciphers;
+  for (double value : values) {
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    encrypt(cipher, HEPlaintext{value},
+            he_backend.get_context()->first_parms_id(), element::f32,
+            he_backend.get_scale(), *he_backend.get_ckks_encoder(),
+            *he_backend.get_encryptor(), false);
+    ciphers.emplace_back(cipher, false, 1);
+  }
+  return ciphers;
+}
+}  // namespace
+
+TEST(kernel_allocations, dot_steady_state) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Enough terms that any allocation per term exceeds the budget
+  size_t dot_size = 64;
+  size_t num_columns = 4;
+  std::vector<double> inputs(dot_size);
+  std::vector<HEType> weights;
+  for (size_t k = 0; k < dot_size; ++k) {
+    inputs[k] = 0.01 * static_cast<double>(k);
+    for (size_t col = 0; col < num_columns; ++col) {
+      weights.emplace_back(HEPlaintext{static_cast<double>(col + 1)}, false);
+    }
+  }
+  auto arg0 = encrypt_values(inputs, *he_backend);
+  std::vector<HEType> out(num_columns, HEType(HEPlaintext(), false));
+
+  auto dot = [&]() {
+    dot_seal(arg0, weights, out, Shape{1, dot_size},
+             Shape{dot_size, num_columns}, Shape{1, num_columns}, 1,
+             element::f32, 1, *he_backend);
+  };
+  // The first call grows the memory pools and scratch buffers
+  dot();
+  size_t allocations = count_allocations(dot);
+  EXPECT_LE(allocations, s_output_budget * num_columns + s_call_budget);
+
+  double input_sum = 0;
+  for (double input : inputs) {
+    input_sum += input;
+  }
+  for (size_t col = 0; col < num_columns; ++col) {
+    ASSERT_TRUE(out[col].is_ciphertext());
+    HEPlaintext result;
+    decrypt(result, *out[col].get_ciphertext(), false,
+            *he_backend->get_decryptor(), *he_backend->get_ckks_encoder(),
+            he_backend->get_context(), 1);
+    EXPECT_NEAR(result[0], input_sum * static_cast<double>(col + 1), 1e-2);
+  }
+}
+
+TEST(kernel_allocations, multiply_accumulator_reuse) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t num_terms = 32;
+  auto arg0 = encrypt_values(std::vector<double>(num_terms, 0.5), *he_backend);
+  std::vector<HEType> weights(num_terms, HEType(HEPlaintext{2.0}, false));
+  MultiplyAccumulator accumulator(1, *he_backend);
+  HEType out(HEPlaintext(), false);
+
+  auto sum = [&]() {
+    for (size_t term = 0; term < num_terms; ++term) {
+      accumulator.accumulate(arg0[term], weights[term]);
+    }
+    accumulator.finalize(out);
+  };
+  sum();
+  EXPECT_LE(count_allocations(sum), s_output_budget + s_call_budget);
+
+  // finalize resets the accumulator for the next sum
+  sum();
+  HEPlaintext result;
+  decrypt(result, *out.get_ciphertext(), false, *he_backend->get_decryptor(),
+          *he_backend->get_ckks_encoder(), he_backend->get_context(), 1);
+  EXPECT_NEAR(result[0], static_cast<double>(num_terms), 1e-2);
+}
+
+}  // namespace ngraph::runtime::he
@@ -384,4 +384,50 @@ NGRAPH_TEST(${BACKEND_NAME}, add_layer_plain_plain) {
       1e-1f));
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, inter_op_parallel_branches) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto c = std::make_shared<op::Parameter>(element::f32, shape);
+  auto f = std::make_shared<Function>((a * b) + (a * c) - (-c),
+                                      ParameterVector{a, b, c});
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_b = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_c = he_backend->create_cipher_tensor(element::f32, shape);
+  auto result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  auto cipher_annotation =
+      HEOpAnnotations::server_ciphertext_unpacked_annotation();
+  const auto& cipher_config = test::config_from_annotation(*cipher_annotation);
+
+  std::string error_str;
+  he_backend->set_config({{"num_inter_op_threads", "4"},
+                          {a->get_name(), cipher_config},
+                          {b->get_name(), cipher_config},
+                          {c->get_name(), cipher_config}},
+                         error_str);
+  EXPECT_EQ(he_backend->num_inter_op_threads(), 4);
+
+  copy_data(t_a,
+            ngraph::test::NDArray<float, 2>({{1, 2}, {3, 4}}).get_vector());
+  copy_data(t_b,
+            ngraph::test::NDArray<float, 2>({{5, 6}, {7, 8}}).get_vector());
+  copy_data(t_c,
+            ngraph::test::NDArray<float, 2>({{9, 10}, {11, 12}}).get_vector());
+
+  auto handle = backend->compile(f);
+  // Second call reuses the intermediate buffers of the first
+  for (size_t i = 0; i < 2; ++i) {
+    handle->call_with_validate({result}, {t_a, t_b, t_c});
+    EXPECT_TRUE(test::all_close(
+        read_vector<float>(result),
+        (ngraph::test::NDArray<float, 2>({{23, 42}, {65, 92}})).get_vector(),
+        1e-1f));
+  }
+}
+
 }  // namespace ngraph::runtime::he
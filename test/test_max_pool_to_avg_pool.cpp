@@ -0,0 +1,96 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "pass/max_pool_to_avg_pool.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "test_util.hpp"
+#include "util/all_close.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(max_pool_to_avg_pool, selected_nodes) {
+  auto a = std::make_shared<op::Parameter>(element::f32, Shape{1, 1, 4, 4});
+  auto pool0 = std::make_shared<op::MaxPool>(a, Shape{2, 2}, Strides{2, 2});
+  auto pool1 = std::make_shared<op::MaxPool>(a, Shape{3, 3}, Strides{1, 1},
+                                             Shape{1, 1}, Shape{1, 1});
+  auto f = std::make_shared<Function>(NodeVector{pool0, pool1},
+                                      ParameterVector{a});
+
+  std::string pool1_name = pool1->get_name();
+  EXPECT_TRUE(
+      pass::MaxPoolToAvgPool([&pool1_name](const Node& node) {
+        return node.get_name() == pool1_name;
+      }).run_on_function(f));
+
+  EXPECT_EQ(f->get_results()[0]->input_value(0).get_node_shared_ptr(), pool0);
+  auto avg_pool = std::dynamic_pointer_cast<op::AvgPool>(
+      f->get_results()[1]->input_value(0).get_node_shared_ptr());
+  ASSERT_TRUE(avg_pool != nullptr);
+  EXPECT_EQ(avg_pool->get_window_shape(), (Shape{3, 3}));
+  EXPECT_EQ(avg_pool->get_padding_below(), (Shape{1, 1}));
+  EXPECT_FALSE(avg_pool->get_include_padding_in_avg_computation());
+
+  EXPECT_FALSE(pass::MaxPoolToAvgPool([](const Node&) {
+                 return false;
+               }).run_on_function(f));
+}
+
+TEST(max_pool_to_avg_pool, backend_config) {
+  Shape shape{1, 1, 4, 4};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto max_pool =
+      std::make_shared<op::MaxPool>(a, Shape{2, 2}, Strides{2, 2});
+  auto f = std::make_shared<Function>(max_pool, ParameterVector{a});
+
+  auto he_backend_orig = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(he_backend_orig.get());
+  std::string error_str;
+  he_backend->set_config(
+      {{"avg_pool_max_pools", "true"}, {a->get_name(), "encrypt"}},
+      error_str);
+  EXPECT_TRUE(he_backend->avg_pool_max_pool(*max_pool));
+
+  std::vector<float> input_vals(shape_size(shape));
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<float>(i);
+  }
+  auto he_handle = he_backend->compile(f);
+  auto he_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto he_result =
+      he_backend->create_cipher_tensor(element::f32, Shape{1, 1, 2, 2});
+  copy_data(he_a, input_vals);
+  he_handle->call_with_validate({he_result}, {he_a});
+
+  // The averages of the 2x2 windows
+  EXPECT_TRUE(test::all_close(read_vector<float>(he_result),
+                              std::vector<float>{2.5, 4.5, 10.5, 12.5},
+                              1e-3f));
+
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto kept = std::make_shared<op::MaxPool>(b, Shape{2, 2}, Strides{2, 2});
+  he_backend->set_config({{kept->get_name(), "max_pool"}}, error_str);
+  EXPECT_FALSE(he_backend->avg_pool_max_pool(*kept));
+  EXPECT_TRUE(he_backend->avg_pool_max_pool(*max_pool));
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,111 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "pass/merge_functions.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "test_util.hpp"
+#include "util/all_close.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Returns a function computing head(backbone(a)), with a backbone
+/// constructed anew, but with equal weights, for each function
+std::shared_ptr<Function> make_head(
+    const Shape& shape,
+    const std::function<std::shared_ptr<Node>(const Output<Node>&)>& head) {
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape, {1, 2, 3, 4});
+  auto b = op::Constant::create(element::f32, shape, {0.5, 0.5, 0.5, 0.5});
+  auto backbone =
+      std::make_shared<op::Add>(std::make_shared<op::Multiply>(a, w), b);
+  return std::make_shared<Function>(head(backbone), ParameterVector{a});
+}
+}  // namespace
+
+TEST(merge_functions, shares_backbone) {
+  Shape shape{1, 4};
+  auto f1 = make_head(shape, [&](const Output<Node>& x) {
+    return std::make_shared<op::Multiply>(
+        x, op::Constant::create(element::f32, shape, {2, 2, 2, 2}));
+  });
+  auto f2 = make_head(shape, [&](const Output<Node>& x) {
+    return std::make_shared<op::Add>(
+        x, op::Constant::create(element::f32, shape, {1, 1, 1, 1}));
+  });
+  size_t f1_ops = f1->get_ops().size();
+
+  auto merged = pass::merge_functions({f1, f2});
+  EXPECT_EQ(merged->get_results().size(), 2);
+  EXPECT_EQ(merged->get_parameters(), f1->get_parameters());
+  // The second function only adds its head's Constant, Add and Result
+  EXPECT_EQ(merged->get_ops().size(), f1_ops + 3);
+}
+
+TEST(merge_functions, different_weights_not_shared) {
+  Shape shape{1, 4};
+  auto identity = [](const Output<Node>& x) {
+    return std::make_shared<op::Negative>(x);
+  };
+  auto f1 = make_head(shape, identity);
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape, {4, 3, 2, 1});
+  auto f2 = std::make_shared<Function>(
+      std::make_shared<op::Negative>(std::make_shared<op::Multiply>(a, w)),
+      ParameterVector{a});
+  size_t f1_ops = f1->get_ops().size();
+
+  auto merged = pass::merge_functions({f1, f2});
+  // Only the parameter is shared
+  EXPECT_EQ(merged->get_ops().size(), f1_ops + 4);
+}
+
+TEST(merge_functions, compile_shared) {
+  Shape shape{1, 4};
+  auto f1 = make_head(shape, [&](const Output<Node>& x) {
+    return std::make_shared<op::Multiply>(
+        x, op::Constant::create(element::f32, shape, {2, 2, 2, 2}));
+  });
+  auto f2 = make_head(shape, [&](const Output<Node>& x) {
+    return std::make_shared<op::Add>(
+        x, op::Constant::create(element::f32, shape, {1, 1, 1, 1}));
+  });
+
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto handle = he_backend->compile_shared({f1, f2});
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result1 = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_result2 = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, -1, 0.5, 2});
+  handle->call_with_validate({t_result1, t_result2}, {t_a});
+
+  // backbone(a) = {1.5, -1.5, 2, 8.5}
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result1),
+                              std::vector<float>{3, -3, 4, 17}, 1e-3f));
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result2),
+                              std::vector<float>{2.5, -0.5, 3, 9.5}, 1e-3f));
+}
+
+}  // namespace ngraph::runtime::he
@@ -73,17 +73,7 @@ auto mult_test = [](const Shape& shape, const bool arg1_encrypted,
       input_b.emplace_back(1 - i);
     }
 
-    if (packed && complex_packing && arg1_encrypted && !arg2_encrypted) {
-      exp_result.emplace_back(
-          input_a.back() *
-          input_b[i % shape_size(HETensor::pack_shape(shape))]);
-    } else if (packed && complex_packing && !arg1_encrypted && arg2_encrypted) {
-      exp_result.emplace_back(
-          input_a[i % shape_size(HETensor::pack_shape(shape))] *
-          input_b.back());
-    } else {
-      exp_result.emplace_back(input_a.back() * input_b.back());
-    }
+    exp_result.emplace_back(input_a.back() * input_b.back());
   }
   copy_data(t_a, input_a);
   copy_data(t_b, input_b);
@@ -157,6 +147,14 @@ NGRAPH_TEST(${BACKEND_NAME}, mult_2_3_cipher_cipher_complex_packed) {
   mult_test(Shape{2, 3}, true, true, true, true);
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, mult_5_3_cipher_plain_complex_packed) {
+  mult_test(Shape{5, 3}, true, false, true, true);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, mult_5_3_plain_cipher_complex_packed) {
+  mult_test(Shape{5, 3}, false, true, true, true);
+}
+
 NGRAPH_TEST(${BACKEND_NAME}, mult_end_of_depth) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -255,6 +253,40 @@ NGRAPH_TEST(${BACKEND_NAME}, mult_zero) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-3f));
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, mult_lazy_relinearization) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 2};
+
+  // The sum of products is relinearized once, by the final product
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto sum = std::make_shared<op::Add>(std::make_shared<op::Multiply>(a, b),
+                                       std::make_shared<op::Multiply>(a, a));
+  auto t = std::make_shared<op::Multiply>(sum, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"lazy_relinearization", "true"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+  EXPECT_TRUE(he_backend->lazy_relinearization());
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+
+  copy_data(t_a, std::vector<float>{1, 2, -3, 0.5});
+  copy_data(t_b, std::vector<float>{2, -1, 1, 4});
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{6, -2, 6, 9}, 1e-2f));
+}
+
 NGRAPH_TEST(${BACKEND_NAME}, mult_wrong_output_type) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
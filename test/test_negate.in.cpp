@@ -102,4 +102,80 @@ NGRAPH_TEST(${BACKEND_NAME}, negate_2_3_cipher_complex_packed) {
   negate_test(Shape{2, 3}, true, true, true);
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, negate_lazy_scalar_factors) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto two = op::Constant::create(element::f32, shape,
+                                  std::vector<float>(shape_size(shape), 2));
+  auto three = op::Constant::create(element::f32, shape,
+                                    std::vector<float>(shape_size(shape), 3));
+  // The Result decrypts the pending factor of the Divide, the Multiply folds
+  // it into its plaintext, and Add applies the factor of the Negative
+  auto halved = std::make_shared<op::Divide>(std::make_shared<op::Negative>(a),
+                                             two);
+  auto sum = std::make_shared<op::Add>(
+      std::make_shared<op::Multiply>(halved, three),
+      std::make_shared<op::Negative>(a));
+  auto f = std::make_shared<Function>(NodeVector{halved, sum},
+                                      ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{a->get_name(), "encrypt"}, {"lazy_scalar_factors", "true"}},
+      error_str);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_halved = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_sum = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, -2, 3, -4, 5, -6});
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_halved, t_sum}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_halved),
+                              std::vector<float>{-0.5, 1, -1.5, 2, -2.5, 3},
+                              1e-3f));
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_sum),
+                              std::vector<float>{-2.5, 5, -7.5, 10, -12.5, 15},
+                              1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, negate_lazy_scalar_factors_in_place) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape,
+                                std::vector<float>{1, 2, 3, 4, 5, 6});
+  // The Negative shares the ciphertexts of a, which the Add reads later, so
+  // the Multiply copies them before overwriting its input in place
+  auto product =
+      std::make_shared<op::Multiply>(std::make_shared<op::Negative>(a), w);
+  auto sum = std::make_shared<op::Add>(product, a);
+  auto f = std::make_shared<Function>(NodeVector{product, sum},
+                                      ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{a->get_name(), "encrypt"}, {"lazy_scalar_factors", "true"}},
+      error_str);
+
+  auto t_a = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_product = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_sum = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_a, std::vector<float>{1, -2, 3, -4, 5, -6});
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_product, t_sum}, {t_a});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_product),
+                              std::vector<float>{-1, 4, -9, 16, -25, 36},
+                              1e-3f));
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_sum),
+                              std::vector<float>{0, 2, -6, 12, -20, 30},
+                              1e-3f));
+}
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,79 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "logging/ngraph_he_trace.hpp"
+#include "nlohmann/json.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(ngraph_he_trace, disabled_span) {
+  auto& tracer = logging::Tracer::instance();
+  bool enabled = tracer.enabled();
+  tracer.set_enabled(false);
+  tracer.clear();
+  { logging::TraceSpan span("op", "Dummy"); }
+
+  auto js = nlohmann::json::parse(tracer.to_json());
+  for (const auto& event : js.at("traceEvents")) {
+    EXPECT_NE(event.at("ph"), "X");
+  }
+  tracer.set_enabled(enabled);
+}
+
+TEST(ngraph_he_trace, spans) {
+  auto& tracer = logging::Tracer::instance();
+  bool enabled = tracer.enabled();
+  tracer.set_enabled(true);
+  tracer.clear();
+  {
+    logging::TraceSpan span("op", "Add_0");
+    span.add_arg("op", "Add");
+  }
+  std::thread([]() { logging::TraceSpan span("tcp", "send message"); })
+      .join();
+  tracer.set_enabled(enabled);
+
+  auto js = nlohmann::json::parse(tracer.to_json());
+  size_t num_spans = 0;
+  uint64_t op_tid = 0;
+  uint64_t tcp_tid = 0;
+  for (const auto& event : js.at("traceEvents")) {
+    if (event.at("ph") != "X") {
+      continue;
+    }
+    num_spans++;
+    EXPECT_GE(event.at("dur").get<double>(), 0);
+    if (event.at("name") == "Add_0") {
+      EXPECT_EQ(event.at("cat"), "op");
+      EXPECT_EQ(event.at("args").at("op"), "Add");
+      op_tid = event.at("tid");
+    } else if (event.at("name") == "send message") {
+      EXPECT_EQ(event.at("cat"), "tcp");
+      tcp_tid = event.at("tid");
+    }
+  }
+  EXPECT_EQ(num_spans, size_t{2});
+  EXPECT_NE(op_tid, uint64_t{0});
+  EXPECT_NE(tcp_tid, uint64_t{0});
+  EXPECT_NE(op_tid, tcp_tid);
+  tracer.clear();
+}
+
+}  // namespace ngraph::runtime::he
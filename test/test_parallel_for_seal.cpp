@@ -0,0 +1,246 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/parallel_for_seal.hpp"
+#include "seal/seal_util.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(parallel_for_seal, visits_each_index) {
+  for (size_t grain_size : {0, 1, 7, 1000}) {
+    std::vector<std::atomic<size_t>> visits(100);
+    parallel_for_seal(visits.size(), grain_size,
+                      [&](size_t i) { visits[i]++; });
+    for (const auto& count : visits) {
+      EXPECT_EQ(count.load(), 1U);
+    }
+  }
+  parallel_for_seal(0, 1, [](size_t) { FAIL(); });
+}
+
+TEST(parallel_for_seal, grain_size) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  std::vector<HEType> plain(4, HEType(HEPlaintext{1, 2}, false));
+  EXPECT_EQ(elementwise_cost(plain[0]), 2U);
+  EXPECT_EQ(elementwise_grain_size({&plain}), s_min_parallel_work / 2);
+  EXPECT_EQ(elementwise_grain_size({}), s_min_parallel_work);
+
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encrypt(cipher, HEPlaintext{1, 2},
+          he_backend->get_context()->first_parms_id(), element::f32,
+          he_backend->get_scale(), *he_backend->get_ckks_encoder(),
+          *he_backend->get_encryptor(), false);
+  std::vector<HEType> ciphers(4, HEType(cipher, false, 2));
+  const auto& parms = he_backend->get_encryption_parameters()
+                          .seal_encryption_parameters();
+  size_t cipher_cost = 2 * parms.poly_modulus_degree() *
+                       cipher->ciphertext().coeff_modulus_size();
+  EXPECT_EQ(elementwise_cost(ciphers[0]), cipher_cost);
+
+  // Ciphertext operands dominate the cost
+  size_t grain_size = elementwise_grain_size({&plain, &ciphers});
+  EXPECT_EQ(grain_size, (s_min_parallel_work + cipher_cost - 1) / cipher_cost);
+  EXPECT_LT(grain_size, elementwise_grain_size({&plain}));
+}
+
+TEST(parallel_for_seal, kinds) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encrypt(cipher, HEPlaintext{1}, he_backend->get_context()->first_parms_id(),
+          element::f32, he_backend->get_scale(),
+          *he_backend->get_ckks_encoder(), *he_backend->get_encryptor(),
+          false);
+  std::vector<HEType> plain(3, HEType(HEPlaintext{1}, false));
+  std::vector<HEType> ciphers(3, HEType(cipher, false, 1));
+  std::vector<HEType> mixed{plain[0], ciphers[0], plain[0]};
+  std::vector<HEType> out(3, HEType(HEPlaintext(), false));
+
+  EXPECT_EQ(he_type_kind(plain, 3), HETypeKind::plaintext);
+  EXPECT_EQ(he_type_kind(ciphers, 3), HETypeKind::ciphertext);
+  EXPECT_EQ(he_type_kind(mixed, 3), HETypeKind::mixed);
+  EXPECT_EQ(he_type_kind(mixed, 1), HETypeKind::plaintext);
+  EXPECT_EQ(he_type_kind(mixed, 0), HETypeKind::plaintext);
+
+  // Returns the kinds passed for each index, as a pair of HETypeKinds
+  auto kinds = [](std::vector<HEType>& arg0, std::vector<HEType>& arg1,
+                  const std::vector<HEType>& result) {
+    auto to_kind = [](auto tag) {
+      using Tag = decltype(tag);
+      if constexpr (std::is_same_v<Tag, PlaintextKind>) {
+        return HETypeKind::plaintext;
+      } else if constexpr (std::is_same_v<Tag, CiphertextKind>) {
+        return HETypeKind::ciphertext;
+      } else {
+        return HETypeKind::mixed;
+      }
+    };
+    std::vector<std::pair<HETypeKind, HETypeKind>> visits(arg0.size());
+    parallel_for_kinds_seal(arg0, arg1, result, arg0.size(),
+                            [&](size_t i, auto kind0, auto kind1) {
+                              visits[i] = {to_kind(kind0), to_kind(kind1)};
+                            });
+    for (const auto& visit : visits) {
+      EXPECT_EQ(visit, visits[0]);
+    }
+    return visits[0];
+  };
+  using Kinds = std::pair<HETypeKind, HETypeKind>;
+  EXPECT_EQ(kinds(plain, plain, out),
+            Kinds(HETypeKind::plaintext, HETypeKind::plaintext));
+  EXPECT_EQ(kinds(plain, ciphers, out),
+            Kinds(HETypeKind::plaintext, HETypeKind::ciphertext));
+  EXPECT_EQ(kinds(ciphers, plain, out),
+            Kinds(HETypeKind::ciphertext, HETypeKind::plaintext));
+  EXPECT_EQ(kinds(ciphers, ciphers, out),
+            Kinds(HETypeKind::ciphertext, HETypeKind::ciphertext));
+  EXPECT_EQ(kinds(mixed, ciphers, out),
+            Kinds(HETypeKind::mixed, HETypeKind::mixed));
+
+  // A ciphertext result may not be written into a plaintext operand
+  EXPECT_EQ(kinds(plain, ciphers, plain),
+            Kinds(HETypeKind::mixed, HETypeKind::mixed));
+  EXPECT_EQ(kinds(ciphers, plain, ciphers),
+            Kinds(HETypeKind::ciphertext, HETypeKind::plaintext));
+  EXPECT_EQ(kinds(plain, plain, plain),
+            Kinds(HETypeKind::plaintext, HETypeKind::plaintext));
+}
+
+TEST(parallel_for_seal, numa_aware) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::string error_str;
+  ASSERT_TRUE(he_backend->set_config({{"numa_aware", "True"}}, error_str));
+  EXPECT_TRUE(he_backend->numa_aware());
+  EXPECT_TRUE(he_backend->thread_local_pools());
+  EXPECT_TRUE(numa_aware_parallelism());
+
+  // Each thread processes a contiguous range of indices
+  std::vector<int> thread_ids(1000, -1);
+  parallel_for_seal(thread_ids.size(), 1, [&](size_t i) {
+#ifdef _OPENMP
+    thread_ids[i] = omp_get_thread_num();
+#else
+    thread_ids[i] = 0;
+#endif
+  });
+  for (size_t i = 1; i < thread_ids.size(); ++i) {
+    EXPECT_LE(thread_ids[i - 1], thread_ids[i]);
+  }
+  EXPECT_EQ(thread_ids[0], 0);
+
+  ASSERT_TRUE(he_backend->set_config({{"numa_aware", "False"}}, error_str));
+  EXPECT_FALSE(numa_aware_parallelism());
+}
+
+TEST(parallel_for_seal, limbs_visit_each_coefficient) {
+  // Few large limbs are split into coefficient ranges, small ones are not
+  for (size_t coeff_count : {16UL, 1UL << 16U}) {
+    size_t num_polys = 2;
+    size_t coeff_mod_count = 3;
+    std::vector<std::atomic<size_t>> visits(num_polys * coeff_mod_count *
+                                            coeff_count);
+    parallel_for_limbs_seal(
+        num_polys, coeff_mod_count, coeff_count,
+        [&](size_t poly, size_t limb, size_t begin, size_t end) {
+          EXPECT_LT(poly, num_polys);
+          EXPECT_LT(limb, coeff_mod_count);
+          EXPECT_LE(end, coeff_count);
+          for (size_t k = begin; k < end; ++k) {
+            visits[(poly * coeff_mod_count + limb) * coeff_count + k]++;
+          }
+        });
+    for (const auto& visit : visits) {
+      EXPECT_EQ(visit, 1);
+    }
+  }
+}
+
+TEST(parallel_for_seal, multiply_plain_limb_parallel) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  // Splitting the limbs computes the same products as the element loop
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encrypt(cipher, HEPlaintext{1.5}, he_backend->get_context()->first_parms_id(),
+          element::f32, he_backend->get_scale(),
+          *he_backend->get_ckks_encoder(), *he_backend->get_encryptor(),
+          false);
+  seal::Ciphertext split = cipher->ciphertext();
+  seal::Ciphertext sequential = cipher->ciphertext();
+  multiply_plain_inplace(split, 3.0, *he_backend);
+#pragma omp parallel num_threads(2)
+  {
+#pragma omp single
+    multiply_plain_inplace(sequential, 3.0, *he_backend);
+  }
+  ASSERT_EQ(split.size(), sequential.size());
+  size_t count = split.size() * split.poly_modulus_degree() *
+                 split.coeff_modulus_size();
+  EXPECT_TRUE(std::equal(split.data(), split.data() + count,
+                         sequential.data()));
+}
+
+#ifdef _OPENMP
+TEST(parallel_for_seal, limb_parallel_elements) {
+  ScopedIntraOpThreads threads(8);
+  EXPECT_FALSE(limb_parallel_elements(0));
+  EXPECT_TRUE(limb_parallel_elements(1));
+  EXPECT_TRUE(limb_parallel_elements(4));
+  EXPECT_FALSE(limb_parallel_elements(5));
+  // Elements of a parallel loop are already split across threads
+  bool nested = true;
+#pragma omp parallel num_threads(2)
+  {
+#pragma omp single
+    nested = limb_parallel_elements(1);
+  }
+  EXPECT_FALSE(nested);
+}
+
+TEST(parallel_for_seal, scoped_intra_op_threads) {
+  int default_threads = omp_get_max_threads();
+  {
+    ScopedIntraOpThreads threads(1);
+    EXPECT_EQ(omp_get_max_threads(), 1);
+  }
+  EXPECT_EQ(omp_get_max_threads(), default_threads);
+  {
+    ScopedIntraOpThreads threads(0);
+    EXPECT_EQ(omp_get_max_threads(), default_threads);
+  }
+}
+#endif
+
+}  // namespace ngraph::runtime::he
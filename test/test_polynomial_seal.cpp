@@ -0,0 +1,295 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "op/bounded_relu.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/polynomial_activation_seal.hpp"
+#include "seal/kernel/polynomial_seal.hpp"
+#include "seal/kernel/power_seal.hpp"
+#include "seal/polynomial_activation.hpp"
+#include "test_util.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+namespace {
+/// \brief Compiles and calls a function of one encrypted parameter, and
+/// checks the result is within tolerance of the expected result
+void check_activation(HESealBackend& he_backend,
+                      const std::shared_ptr<Function>& f,
+                      const std::vector<float>& input,
+                      const std::vector<float>& expected, float tolerance) {
+  const auto& param = f->get_parameters()[0];
+  auto t_a = test::tensor_from_flags(he_backend, param->get_shape(), true,
+                                     false);
+  auto t_result =
+      test::tensor_from_flags(he_backend, f->get_output_shape(0), true, false);
+  copy_data(t_a, input);
+
+  auto handle = he_backend.compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  auto result = read_vector<float>(t_result);
+  ASSERT_EQ(result.size(), expected.size());
+  for (size_t i = 0; i < result.size(); ++i) {
+    EXPECT_NEAR(result[i], expected[i], tolerance) << "at index " << i;
+  }
+}
+}  // namespace
+
+TEST(polynomial_seal, depth) {
+  EXPECT_EQ(polynomial_depth({3}), 0U);
+  EXPECT_EQ(polynomial_depth({1, 2}), 1U);
+  EXPECT_EQ(polynomial_depth({1, 2, 3}), 2U);
+  EXPECT_EQ(polynomial_depth({1, 2, 3, 4}), 2U);
+  EXPECT_EQ(polynomial_depth({1, 0, 0, 0, 5}), 3U);
+  EXPECT_EQ(polynomial_depth({1, 2, 3, 4, 5, 6, 7, 8}), 3U);
+  // Trailing zero coefficients are ignored
+  EXPECT_EQ(polynomial_depth({1, 2, 0, 0}), 1U);
+}
+
+TEST(polynomial_seal, evaluate) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  HEPlaintext values{-0.9, -0.3, 0.2, 0.8};
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  he_backend->encrypt(cipher, values, element::f32, false);
+  HEType arg(cipher, false, values.size());
+
+  for (const auto& coeffs : std::vector<std::vector<double>>{
+           {0.5, -1}, {0.25, 0, 2}, {0.5, -1, 0.25, 2, 0, -0.5}}) {
+    HEPlaintext expected;
+    scalar_polynomial_seal(values, coeffs, expected);
+
+    HEType out(HEPlaintext(), false);
+    scalar_polynomial_seal(arg, coeffs, out, *he_backend);
+    ASSERT_TRUE(out.is_ciphertext());
+    HEPlaintext result;
+    he_backend->decrypt(result, *out.get_ciphertext(), values.size(), false);
+    for (size_t i = 0; i < values.size(); ++i) {
+      EXPECT_NEAR(result[i], expected[i], 1e-3);
+    }
+  }
+
+  // Constant polynomials are plaintexts
+  HEType out(HEPlaintext(), false);
+  scalar_polynomial_seal(arg, {2, 0}, out, *he_backend);
+  ASSERT_TRUE(out.is_plaintext());
+  EXPECT_EQ(out.get_plaintext(), HEPlaintext(values.size(), 2));
+}
+
+TEST(polynomial_seal, activation_names) {
+  EXPECT_EQ(polynomial_activation_from_string("Minimax"),
+            PolynomialActivation::minimax);
+  EXPECT_EQ(polynomial_activation_to_string(PolynomialActivation::sign),
+            "sign");
+  EXPECT_ANY_THROW(polynomial_activation_from_string("cubic"));
+}
+
+TEST(polynomial_seal, activation_depth) {
+  EXPECT_EQ(polynomial_relu_depth(PolynomialActivation::none), 0U);
+  EXPECT_EQ(polynomial_relu_depth(PolynomialActivation::square), 2U);
+  EXPECT_EQ(polynomial_relu_depth(PolynomialActivation::minimax), 2U);
+  EXPECT_EQ(polynomial_relu_depth(PolynomialActivation::sign), 5U);
+  auto square = PolynomialActivation::square;
+  EXPECT_EQ(polynomial_max_pool_depth(Shape{1, 1}, square), 0U);
+  EXPECT_EQ(polynomial_max_pool_depth(Shape{2, 2}, square), 4U);
+  EXPECT_EQ(polynomial_max_pool_depth(Shape{3}, square), 4U);
+}
+
+TEST(polynomial_seal, relu) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Relu>(a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"polynomial_activation", "minimax"},
+                          {"polynomial_activation_bound", "4"},
+                          {a->get_name(), "encrypt"}},
+                         error_str);
+
+  // The minimax error is bound / 16
+  check_activation(*he_backend, f, {-4, -2, -0.5, 0.5, 2, 4},
+                   {0, 0, 0, 0.5, 2, 4}, 0.26f);
+}
+
+TEST(polynomial_seal, relu_sign) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  he_backend->update_encryption_parameters(HESealEncryptionParameters(
+      "HE_SEAL", 1024, std::vector<int>(8, 30), 0, 1 << 30, false));
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Relu>(a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{t->get_name(), "polynomial_sign"}, {a->get_name(), "encrypt"}},
+      error_str);
+
+  check_activation(*he_backend, f, {-1, -0.5, -0.1, 0.1, 0.5, 1},
+                   {0, 0, 0, 0.1, 0.5, 1}, 0.05f);
+}
+
+TEST(polynomial_seal, bounded_relu_per_node) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::BoundedRelu>(a, 0.5f);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{t->get_name(), "polynomial_minimax"}, {a->get_name(), "encrypt"}},
+      error_str);
+
+  // Error of at most (1 + (1 + alpha)) / 16
+  check_activation(*he_backend, f, {-1, -0.5, 0, 0.25, 0.75, 1},
+                   {0, 0, 0, 0.25, 0.5, 0.5}, 0.16f);
+}
+
+TEST(polynomial_seal, max_pool) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{1, 1, 1, 4};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::MaxPool>(a, Shape{1, 2}, Strides{1, 2});
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"polynomial_activation", "minimax"}, {a->get_name(), "encrypt"}},
+      error_str);
+
+  // The pairwise difference is bounded by 2, so the error is 2 / 16
+  check_activation(*he_backend, f, {-0.5, 0.75, 0.25, -1}, {0.75, 0.25},
+                   0.13f);
+}
+
+TEST(polynomial_seal, chebyshev_coefficients) {
+  // Polynomials of at most the degree are interpolated exactly
+  auto square = chebyshev_coefficients([](double x) { return x * x; }, 2, 0,
+                                       2);
+  ASSERT_EQ(square.size(), 3U);
+  EXPECT_NEAR(square[0], 0, 1e-9);
+  EXPECT_NEAR(square[1], 0, 1e-9);
+  EXPECT_NEAR(square[2], 1, 1e-9);
+
+  auto exp = chebyshev_coefficients([](double x) { return std::exp(x); }, 5,
+                                    -1, 1);
+  HEPlaintext values{-1, -0.5, 0, 0.3, 1};
+  HEPlaintext result;
+  scalar_polynomial_seal(values, exp, result);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(result[i], std::exp(values[i]), 1e-4);
+  }
+
+  EXPECT_ANY_THROW(
+      chebyshev_coefficients([](double x) { return x; }, 2, 1, 1));
+  // The monomial x^n is the power itself
+  EXPECT_EQ(polynomial_depth({0, 0, 0, 1}), 2U);
+  EXPECT_EQ(polynomial_depth({0, 0, 0, 0, 1}), 2U);
+}
+
+TEST(polynomial_seal, exp) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Exp>(a);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"polynomial_degree", "3"},
+                          {"polynomial_activation_bound", "1"},
+                          {a->get_name(), "encrypt"}},
+                         error_str);
+  check_activation(*he_backend, f, {-1, -0.25, 0.5, 1},
+                   {std::exp(-1.0f), std::exp(-0.25f), std::exp(0.5f),
+                    std::exp(1.0f)},
+                   0.01f);
+}
+
+TEST(polynomial_seal, power) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = op::Constant::create(element::f32, shape, {3, 3, 3, 3});
+  auto t = std::make_shared<op::Power>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{a->get_name(), "encrypt"}}, error_str);
+  check_activation(*he_backend, f, {-1, -0.5, 0.5, 2}, {-1, -0.125, 0.125, 8},
+                   1e-3f);
+
+  EXPECT_EQ(integer_exponent(HEPlaintext{2, 2}), 2U);
+  EXPECT_FALSE(integer_exponent(HEPlaintext{2, 3}).has_value());
+  EXPECT_FALSE(integer_exponent(HEPlaintext{0.5}).has_value());
+  EXPECT_FALSE(integer_exponent(HEPlaintext{-1}).has_value());
+}
+
+TEST(polynomial_seal, divide) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{4};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Divide>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{"polynomial_degree", "3"},
+                          {"polynomial_divisor_range", "1,2"},
+                          {a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"}},
+                         error_str);
+  EXPECT_ANY_THROW(he_backend->set_config(
+      {{"polynomial_divisor_range", "2,1"}}, error_str));
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, -2, 3, 0.5});
+  copy_data(t_b, std::vector<float>{1, 1.25, 1.5, 2});
+
+  auto handle = he_backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{1, -1.6f, 2, 0.25f}, 0.02f));
+}
+
+}  // namespace ngraph::runtime::he
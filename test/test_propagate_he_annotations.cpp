@@ -101,4 +101,27 @@ TEST(propagate_he_annotations, pack) {
   EXPECT_TRUE(t_annotation->packed());
 }
 
+TEST(propagate_he_annotations, encrypt_constants) {
+  Shape shape{2, 2};
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape, {1, 2, 3, 4});
+  auto e = op::Constant::create(element::f32, shape, {2, 2, 2, 2});
+  auto prod = std::make_shared<op::Multiply>(a, w);
+  auto t = std::make_shared<op::Power>(prod, e);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  a->set_op_annotations(test::annotation_from_flags(false, false, true));
+
+  pass::PropagateHEAnnotations(true).run_on_function(f);
+
+  // Exponents stay plaintext
+  EXPECT_FALSE(HEOpAnnotations::he_op_annotation(*a)->encrypted());
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*w)->encrypted());
+  EXPECT_FALSE(HEOpAnnotations::he_op_annotation(*e)->encrypted());
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*prod)->encrypted());
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*prod)->packed());
+  EXPECT_TRUE(HEOpAnnotations::he_op_annotation(*t)->encrypted());
+}
+
 }  // namespace ngraph::runtime::he
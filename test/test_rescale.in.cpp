@@ -14,8 +14,12 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <atomic>
+#include <memory>
+
 #include "he_op_annotations.hpp"
 #include "ngraph/ngraph.hpp"
+#include "seal/he_seal_accelerator.hpp"
 #include "seal/he_seal_backend.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
@@ -83,4 +87,55 @@ NGRAPH_TEST(${BACKEND_NAME}, skip_rescale_lowest) {
   EXPECT_TRUE(test::all_close(read_vector<float>(t_result), exp_result, 1e-1f));
 }
 
+namespace {
+std::atomic<size_t> s_accelerated_rescales{0};
+
+class CountingAccelerator : public HESealAccelerator {
+ public:
+  std::string name() const override { return "counting"; }
+
+  void rescale_to_next_inplace(std::vector<HEType>& arg,
+                               HESealBackend& he_seal_backend) override {
+    s_accelerated_rescales += arg.size();
+    HESealAccelerator::rescale_to_next_inplace(arg, he_seal_backend);
+  }
+};
+}  // namespace
+
+NGRAPH_TEST(${BACKEND_NAME}, rescale_accelerator) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  register_accelerator("counting", []() {
+    return std::make_shared<CountingAccelerator>();
+  });
+  EXPECT_ANY_THROW(create_accelerator("unregistered"));
+
+  Shape shape{3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Multiply>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config({{a->get_name(), "encrypt"},
+                          {b->get_name(), "encrypt"},
+                          {"accelerator", "counting"}},
+                         error_str);
+  EXPECT_EQ(he_backend->accelerator().name(), "counting");
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  copy_data(t_a, std::vector<float>{1, 2, 3});
+  copy_data(t_b, std::vector<float>{5, 6, 7});
+
+  s_accelerated_rescales = 0;
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  EXPECT_GT(s_accelerated_rescales, 0);
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result),
+                              std::vector<float>{5, 12, 21}, 1e-1f));
+}
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,171 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/seal_ciphertext_spill.hpp"
+#include "test_util.hpp"
+#include "util/all_close.hpp"
+#include "util/test_tools.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(seal_ciphertext_spill, spill_and_restore) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::string directory = "seal_ciphertext_spill_test";
+  std::filesystem::remove_all(directory);
+
+  std::vector<HEPlaintext> values{{1.5, -2.5}, {0.25, 3}};
+  std::vector<HEType> data;
+  for (const auto& value : values) {
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    he_backend->encrypt(cipher, value, element::f32, false);
+    data.emplace_back(cipher, false, value.size());
+  }
+  // Plaintexts stay in memory
+  data.emplace_back(HEPlaintext{7}, false);
+
+  {
+    SealCiphertextSpill spill(directory);
+    size_t bytes = spill.spill(0, data);
+    EXPECT_GT(bytes, 0U);
+    EXPECT_EQ(spill.spilled_bytes(), bytes);
+    EXPECT_TRUE(spill.contains(0));
+    EXPECT_ANY_THROW(spill.spill(0, data));
+    // Spill files are readable by their owner alone
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+      EXPECT_EQ(entry.status().permissions(),
+                std::filesystem::perms::owner_read |
+                    std::filesystem::perms::owner_write);
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(data[i].get_ciphertext()->ciphertext().size(), 0U);
+    }
+
+    spill.restore(0, data, he_backend->get_context());
+    EXPECT_FALSE(spill.contains(0));
+    EXPECT_EQ(spill.spilled_bytes(), 0U);
+    EXPECT_EQ(spill.total_spilled_bytes(), bytes);
+    EXPECT_ANY_THROW(spill.restore(0, data, he_backend->get_context()));
+    for (size_t i = 0; i < values.size(); ++i) {
+      HEPlaintext result;
+      he_backend->decrypt(result, *data[i].get_ciphertext(), values[i].size(),
+                          false);
+      for (size_t j = 0; j < values[i].size(); ++j) {
+        EXPECT_NEAR(result[j], values[i][j], 1e-3);
+      }
+    }
+    EXPECT_EQ(data.back().get_plaintext()[0], 7);
+
+    // Discarded and remaining files are removed
+    spill.spill(1, data);
+    spill.discard(1);
+    EXPECT_FALSE(spill.contains(1));
+    spill.spill(2, data);
+  }
+  EXPECT_TRUE(std::filesystem::is_empty(directory));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(seal_ciphertext_spill, call_with_spilled_tensors) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::string directory = "seal_ciphertext_spill_call";
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  // a + b is read again after the other intermediates, so it is spilled
+  auto sum = std::make_shared<op::Add>(a, b);
+  auto product = std::make_shared<op::Multiply>(a, b);
+  auto difference = std::make_shared<op::Subtract>(product, a);
+  auto t = std::make_shared<op::Add>(difference, sum);
+  auto f = std::make_shared<Function>(t, ParameterVector{a, b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"spill_directory", directory}, {"spill_threshold_mb", "0"}},
+      error_str);
+  EXPECT_EQ(he_backend->spill_directory(), directory);
+  EXPECT_EQ(he_backend->spill_threshold_bytes(), 0U);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_b = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  std::vector<float> input_a{1, 2, 3, 4, 5, 6};
+  std::vector<float> input_b{0.5, -1, 1.5, -2, 2.5, -3};
+  copy_data(t_a, input_a);
+  copy_data(t_b, input_b);
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a, t_b});
+  std::vector<float> expected;
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    expected.emplace_back(input_a[i] * input_b[i] - input_a[i] + input_a[i] +
+                          input_b[i]);
+  }
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-3f));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(seal_ciphertext_spill, call_with_spilled_lazy_scalar_factors) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::string directory = "seal_ciphertext_spill_lazy";
+
+  Shape shape{2, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape,
+                                std::vector<float>{1, 2, 3, 4, 5, 6});
+  // The Negative is only a pending factor. It is read again after the other
+  // intermediates, so it is spilled, and the Add mod-switches it to the level
+  // of the product
+  auto negation = std::make_shared<op::Negative>(a);
+  auto product = std::make_shared<op::Multiply>(a, w);
+  auto difference = std::make_shared<op::Subtract>(product, a);
+  auto t = std::make_shared<op::Add>(difference, negation);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"spill_directory", directory},
+                          {"spill_threshold_mb", "0"},
+                          {"lazy_scalar_factors", "true"}},
+                         error_str);
+
+  auto t_a = test::tensor_from_flags(*he_backend, shape, true, false);
+  auto t_result = test::tensor_from_flags(*he_backend, shape, true, false);
+  std::vector<float> input_a{1, -2, 3, -4, 5, -6};
+  copy_data(t_a, input_a);
+
+  auto handle = backend->compile(f);
+  handle->call_with_validate({t_result}, {t_a});
+  std::vector<float> expected;
+  for (size_t i = 0; i < input_a.size(); ++i) {
+    expected.emplace_back(input_a[i] * static_cast<float>(i + 1) -
+                          2 * input_a[i]);
+  }
+  EXPECT_TRUE(test::all_close(read_vector<float>(t_result), expected, 1e-3f));
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,55 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "seal/he_seal_backend.hpp"
+#include "seal/he_seal_encryption_parameters.hpp"
+#include "seal/seal_context_cache.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(seal_context_cache, shared) {
+  auto parms = HESealEncryptionParameters::default_real_packing_parms();
+  auto context = SealContextCache::get_context(parms);
+  EXPECT_EQ(SealContextCache::get_context(parms), context);
+  EXPECT_EQ(SealContextCache::get_evaluator(parms),
+            SealContextCache::get_evaluator(parms));
+
+  // The scale and packing do not affect the context
+  auto complex_parms = parms;
+  complex_parms.complex_packing() = true;
+  complex_parms.set_scale(parms.scale() / 2);
+  EXPECT_EQ(SealContextCache::get_context(complex_parms), context);
+
+  auto other_parms = HESealEncryptionParameters(
+      "HE_SEAL", 2048, {54}, 0, 1 << 20, false);
+  EXPECT_NE(SealContextCache::get_context(other_parms), context);
+
+  // Backends with the same parameters share the context, but not the keys
+  HESealBackend backend0(parms);
+  HESealBackend backend1(parms);
+  EXPECT_EQ(backend0.get_context(), backend1.get_context());
+  EXPECT_NE(backend0.get_public_key(), backend1.get_public_key());
+
+  SealContextCache::clear();
+  EXPECT_EQ(SealContextCache::size(), 0);
+  EXPECT_NE(SealContextCache::get_context(parms), context);
+  EXPECT_EQ(backend0.get_context(), context);
+}
+
+}  // namespace ngraph::runtime::he
@@ -0,0 +1,58 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <sys/mman.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "seal/seal_huge_pages.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(seal_huge_pages, merges_ranges) {
+  std::vector<std::pair<uintptr_t, size_t>> ranges{
+      {10 * s_huge_page_bytes, 4096},
+      {0, 0},
+      {10 * s_huge_page_bytes + 8192, 4096},
+      {20 * s_huge_page_bytes, s_huge_page_bytes},
+      {10 * s_huge_page_bytes + 4096, 4096}};
+  // Only the last merged range spans a huge page, which may be unmapped
+  advise_huge_pages(ranges);
+
+  std::vector<std::pair<uintptr_t, size_t>> expected{
+      {10 * s_huge_page_bytes, 3 * 4096},
+      {20 * s_huge_page_bytes, s_huge_page_bytes}};
+  EXPECT_EQ(ranges, expected);
+}
+
+TEST(seal_huge_pages, advises_mapping) {
+  size_t byte_count = 4 * s_huge_page_bytes;
+  void* addr = ::mmap(nullptr, byte_count, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  ASSERT_NE(addr, MAP_FAILED);
+
+  std::vector<std::pair<uintptr_t, size_t>> ranges{
+      {reinterpret_cast<uintptr_t>(addr), byte_count}};
+  advise_huge_pages(ranges);
+  static_cast<char*>(addr)[byte_count - 1] = 1;
+  EXPECT_EQ(static_cast<char*>(addr)[byte_count - 1], 1);
+  ::munmap(addr, byte_count);
+}
+
+}  // namespace ngraph::runtime::he
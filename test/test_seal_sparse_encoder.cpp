@@ -0,0 +1,105 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "seal/seal.h"
+#include "seal/seal_sparse_encoder.hpp"
+#include "seal/seal_util.hpp"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(seal_sparse_encoder, encode) {
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {30, 30, 30}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::Decryptor decryptor(*context, keygen.secret_key());
+  auto ckks_encoder = std::make_shared<seal::CKKSEncoder>(*context);
+  auto parms_id = context->first_parms_id();
+  double scale = 1 << 25;
+
+  std::vector<double> input{1, -2, 3};
+  HECodecScratch scratch;
+  {
+    SealSparseEncoder sparse_encoder(context, ckks_encoder);
+    EXPECT_EQ(SealSparseEncoder::find(*ckks_encoder), &sparse_encoder);
+
+    // At most sqrt(2048) slots
+    EXPECT_EQ(sparse_encoder.sparse_slot_count(1), 2);
+    EXPECT_EQ(sparse_encoder.sparse_slot_count(3), 4);
+    EXPECT_EQ(sparse_encoder.sparse_slot_count(32), 32);
+    EXPECT_EQ(sparse_encoder.sparse_slot_count(33), 0);
+
+    std::vector<std::complex<double>> values{{1, 0.5}, {-2, 0}, {3, -1}};
+    seal::Plaintext plain;
+    sparse_encoder.encode(values, 4, parms_id, scale, plain);
+    EXPECT_EQ(plain.parms_id(), parms_id);
+    EXPECT_EQ(plain.scale(), scale);
+
+    seal::Ciphertext cipher;
+    seal::Plaintext decrypted;
+    encryptor.encrypt(plain, cipher);
+    decryptor.decrypt(cipher, decrypted);
+
+    std::vector<std::complex<double>> output;
+    sparse_encoder.decode(decrypted, 4, output);
+    ASSERT_EQ(output.size(), 4);
+    for (size_t i = 0; i < output.size(); ++i) {
+      std::complex<double> expected = i < values.size() ? values[i] : 0.0;
+      EXPECT_NEAR(output[i].real(), expected.real(), 1e-3);
+      EXPECT_NEAR(output[i].imag(), expected.imag(), 1e-3);
+    }
+
+    // The full encoder decodes the values replicated every 4 slots
+    std::vector<std::complex<double>> slots;
+    ckks_encoder->decode(decrypted, slots);
+    ASSERT_EQ(slots.size(), ckks_encoder->slot_count());
+    for (size_t i = 0; i < slots.size(); ++i) {
+      EXPECT_NEAR(slots[i].real(), output[i % 4].real(), 1e-3);
+      EXPECT_NEAR(slots[i].imag(), output[i % 4].imag(), 1e-3);
+    }
+
+    // Strided encryption uses the sparse encoder
+    SealCiphertextWrapper wrapper;
+    encrypt_strided(wrapper.ciphertext(), input.data(), sizeof(double),
+                    input.size(), element::f64, parms_id, scale,
+                    *ckks_encoder, encryptor, false, scratch);
+    std::vector<double> strided(input.size());
+    decrypt_strided(strided.data(), sizeof(double), strided.size(),
+                    element::f64, wrapper, false, decryptor, *ckks_encoder,
+                    context, scratch);
+    EXPECT_TRUE(test::all_close(strided, input, 1e-3));
+
+    decryptor.decrypt(wrapper.ciphertext(), decrypted);
+    ckks_encoder->decode(decrypted, slots);
+    EXPECT_NEAR(slots[5].real(), input[1], 1e-3);
+  }
+  EXPECT_EQ(SealSparseEncoder::find(*ckks_encoder), nullptr);
+}
+
+}  // namespace ngraph::runtime::he
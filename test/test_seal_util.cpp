@@ -26,7 +26,9 @@
 #include "seal/seal.h"
 #include "seal/seal_ciphertext_wrapper.hpp"
 #include "seal/seal_plaintext_wrapper.hpp"
+#include "seal/seal_simd.hpp"
 #include "seal/seal_util.hpp"
+#include "seal/util/uintarithsmallmod.h"
 #include "test_util.hpp"
 #include "util/test_tools.hpp"
 
@@ -41,6 +43,30 @@ TEST(seal_util, seal_security_level) {
   EXPECT_ANY_THROW({ seal_security_level(42); });
 }
 
+TEST(seal_util, key_fingerprint) {
+  EXPECT_EQ(key_fingerprint("key"), key_fingerprint("key"));
+  EXPECT_NE(key_fingerprint("key"), key_fingerprint("yek"));
+  // Trailing zero bytes are not hidden by padding
+  EXPECT_NE(key_fingerprint(""), key_fingerprint(std::string(1, '\0')));
+  EXPECT_EQ(key_fingerprint("").size(), 64U);
+}
+
+TEST(seal_util, parms_id_at_chain_index) {
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 8192;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {60, 40, 40, 60}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  EXPECT_EQ(parms_id_at_chain_index(context, 2), context->first_parms_id());
+  EXPECT_EQ(parms_id_at_chain_index(context, 5), context->first_parms_id());
+  EXPECT_EQ(parms_id_at_chain_index(context, 0), context->last_parms_id());
+  EXPECT_EQ(context->get_context_data(parms_id_at_chain_index(context, 1))
+                ->chain_index(),
+            1);
+}
+
 TEST(seal_util, save) {
   seal::EncryptionParameters parms(seal::scheme_type::ckks);
   size_t poly_modulus_degree = 8192;
@@ -317,6 +343,117 @@ TEST(seal_util, multiply_plain_inplace_large_coeff) {
   multiply_plain_inplace(cipher1->ciphertext(), 1.23, *he_backend);
 }
 
+TEST(seal_util, multiply_plain_accumulate) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  bool complex_packing = false;
+  auto context = he_backend->get_context();
+
+  auto cipher1 = HESealBackend::create_empty_ciphertext();
+  auto cipher2 = HESealBackend::create_empty_ciphertext();
+  encrypt(cipher1, HEPlaintext{1, 2, 3}, context->first_parms_id(),
+          element::f32, he_backend->get_scale(),
+          *he_backend->get_ckks_encoder(), *he_backend->get_encryptor(),
+          complex_packing);
+  encrypt(cipher2, HEPlaintext{4, 5, 6}, context->first_parms_id(),
+          element::f32, he_backend->get_scale(),
+          *he_backend->get_ckks_encoder(), *he_backend->get_encryptor(),
+          complex_packing);
+
+  seal::Ciphertext acc;
+  multiply_plain(cipher1->ciphertext(), 1.5, acc, *he_backend);
+  multiply_plain_accumulate(cipher2->ciphertext(), -0.5, acc, *he_backend);
+
+  SealCiphertextWrapper result;
+  result.ciphertext() = acc;
+  HEPlaintext output;
+  he_backend->decrypt(output, result, 3, complex_packing);
+  EXPECT_TRUE(test::all_close(output.as_double_vec(),
+                              std::vector<double>{-0.5, 0.5, 1.5}, 1e-3));
+
+  // Accumulator at a different level
+  seal::Ciphertext lower = cipher2->ciphertext();
+  he_backend->get_evaluator()->mod_switch_to_next_inplace(lower);
+  EXPECT_ANY_THROW(
+      { multiply_plain_accumulate(lower, 2.0, acc, *he_backend); });
+
+  // Accumulator at a different scale
+  EXPECT_ANY_THROW({
+    multiply_plain_accumulate(cipher2->ciphertext(), 2.0,
+                              cipher1->ciphertext(), *he_backend);
+  });
+}
+
+TEST(seal_util, quantize_weight) {
+  EXPECT_EQ(quantize_weight(0.75, 0.25), 3);
+  EXPECT_EQ(quantize_weight(-0.5, 0.25), -2);
+  EXPECT_EQ(quantize_weight(0, 0.25), 0);
+  EXPECT_FALSE(quantize_weight(0.3, 0.25).has_value());
+  EXPECT_FALSE(
+      quantize_weight(2.0 * s_max_quantized_weight, 1.0).has_value());
+  EXPECT_ANY_THROW({ quantize_weight(1.0, 0); });
+}
+
+TEST(seal_util, multiply_plain_integer_inplace) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  bool complex_packing = false;
+  auto context = he_backend->get_context();
+
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encrypt(cipher, HEPlaintext{1, 2, -3}, context->first_parms_id(),
+          element::f32, he_backend->get_scale(),
+          *he_backend->get_ckks_encoder(), *he_backend->get_encryptor(),
+          complex_packing);
+  double scale = cipher->ciphertext().scale();
+
+  multiply_plain_integer_inplace(cipher->ciphertext(), -5, *he_backend);
+  EXPECT_EQ(cipher->ciphertext().scale(), scale);
+  EXPECT_EQ(cipher->ciphertext().parms_id(), context->first_parms_id());
+
+  HEPlaintext output;
+  he_backend->decrypt(output, *cipher, 3, complex_packing);
+  EXPECT_TRUE(test::all_close(output.as_double_vec(),
+                              std::vector<double>{-5, -10, 15}, 1e-3));
+}
+
+TEST(seal_util, encrypt_strided) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto context = he_backend->get_context();
+
+  // Every other value of the buffer
+  std::vector<float> values{1, -1, 2, -1, 3, -1};
+  HECodecScratch scratch;
+  for (bool complex_packing : {false, true}) {
+    SealCiphertextWrapper cipher;
+    encrypt_strided(cipher.ciphertext(), values.data(), 2 * sizeof(float), 3,
+                    element::f32, context->first_parms_id(),
+                    he_backend->get_scale(), *he_backend->get_ckks_encoder(),
+                    *he_backend->get_encryptor(), complex_packing, scratch);
+    HEPlaintext output;
+    he_backend->decrypt(output, cipher, 3, complex_packing);
+    EXPECT_TRUE(test::all_close(output.as_double_vec(),
+                                std::vector<double>{1, 2, 3}, 1e-3));
+
+    // A single value is encoded in every slot
+    encrypt_strided(cipher.ciphertext(), values.data() + 2, sizeof(float), 1,
+                    element::f32, context->first_parms_id(),
+                    he_backend->get_scale(), *he_backend->get_ckks_encoder(),
+                    *he_backend->get_encryptor(), complex_packing, scratch);
+    he_backend->decrypt(output, cipher, 3, complex_packing);
+    EXPECT_TRUE(test::all_close(output.as_double_vec(),
+                                std::vector<double>{2, 2, 2}, 1e-3));
+  }
+
+  SealCiphertextWrapper cipher;
+  EXPECT_ANY_THROW(encrypt_strided(
+      cipher.ciphertext(), values.data(), sizeof(float), 1, element::boolean,
+      context->first_parms_id(), he_backend->get_scale(),
+      *he_backend->get_ckks_encoder(), *he_backend->get_encryptor(), false,
+      scratch));
+}
+
 TEST(seal_util, match_to_smallest_chain_index) {
   auto backend = runtime::Backend::create("HE_SEAL");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -508,4 +645,83 @@ TEST(seal_util, encode_plaintext_wrapper_wrong_element_type) {
                           false));
 }
 
+TEST(seal_util, simd_poly_scalar_coeffmod) {
+  const seal::Modulus modulus((1UL << 30U) - 35);
+  const uint64_t q = modulus.value();
+  // Odd length exercises the scalar tail of the vector loops
+  const size_t coeff_count = 37;
+  std::vector<uint64_t> poly(coeff_count);
+  for (size_t i = 0; i < coeff_count; ++i) {
+    poly[i] = (i * 0x9e3779b9UL + (i == 0 ? q - 1 : 0)) % q;
+  }
+  const uint64_t scalar = q - 2;
+
+  std::vector<uint64_t> exp_mult(coeff_count);
+  std::vector<uint64_t> exp_add(coeff_count);
+  for (size_t i = 0; i < coeff_count; ++i) {
+    exp_mult[i] = seal::util::multiply_uint_mod(poly[i], scalar, modulus);
+    exp_add[i] = (poly[i] + scalar) % q;
+  }
+
+  for (SimdLevel level :
+       {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+    if (static_cast<int>(level) > static_cast<int>(cpu_simd_level())) {
+      continue;
+    }
+    std::vector<uint64_t> result(coeff_count);
+    multiply_poly_scalar_coeffmod_simd(poly.data(), coeff_count, scalar,
+                                       modulus, result.data(), level);
+    EXPECT_EQ(result, exp_mult) << simd_level_name(level);
+
+    result = poly;
+    add_poly_scalar_coeffmod_simd(result.data(), coeff_count, scalar, modulus,
+                                  result.data(), level);
+    EXPECT_EQ(result, exp_add) << simd_level_name(level);
+  }
+}
+
+TEST(seal_util, hoisted_rotation) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto& encoder = *he_backend->get_ckks_encoder();
+  size_t slot_count = encoder.slot_count();
+
+  std::vector<double> values(slot_count);
+  for (size_t i = 0; i < slot_count; ++i) {
+    values[i] = 0.01 * static_cast<double>(i % 37);
+  }
+  seal::Plaintext plain;
+  encoder.encode(values, he_backend->get_scale(), plain);
+  seal::Ciphertext cipher;
+  he_backend->get_encryptor()->encrypt(plain, cipher);
+
+  auto check_rotations = [&](const seal::Ciphertext& encrypted) {
+    std::vector<int> steps{0, 1, 3, 16, -2};
+    std::vector<seal::Ciphertext> rotations;
+    he_backend->rotate_hoisted(encrypted, steps, rotations);
+    ASSERT_EQ(rotations.size(), steps.size());
+    for (size_t i = 0; i < steps.size(); ++i) {
+      EXPECT_EQ(rotations[i].parms_id(), encrypted.parms_id());
+      he_backend->get_decryptor()->decrypt(rotations[i], plain);
+      std::vector<double> output;
+      encoder.decode(plain, output);
+      for (size_t slot = 0; slot < slot_count; ++slot) {
+        auto source = static_cast<size_t>(
+            (static_cast<int>(slot) + steps[i] + static_cast<int>(slot_count)) %
+            static_cast<int>(slot_count));
+        EXPECT_NEAR(output[slot], values[source], 1e-3)
+            << "step " << steps[i] << ", slot " << slot;
+      }
+    }
+  };
+  check_rotations(cipher);
+
+  // Ciphertexts below the first level have fewer RNS digits
+  he_backend->get_evaluator()->mod_switch_to_next_inplace(cipher);
+  check_rotations(cipher);
+
+  he_backend->get_evaluator()->square_inplace(cipher);
+  EXPECT_ANY_THROW(HoistedRotator(cipher, he_backend->get_context()));
+}
+
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,72 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "seal/seal.h"
+#include "seal/seal_zero_pool.hpp"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(seal_zero_pool, encrypt) {
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {30, 30, 30}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  auto encryptor = std::make_shared<seal::Encryptor>(*context, public_key);
+  seal::Decryptor decryptor(*context, keygen.secret_key());
+  seal::CKKSEncoder encoder(*context);
+
+  std::vector<double> input{1, 2, 3};
+  seal::Plaintext plain;
+  seal::Plaintext decrypted;
+  seal::Ciphertext cipher;
+  std::vector<double> output;
+
+  {
+    // Without a pool, the encryptor encrypts
+    EXPECT_FALSE(SealZeroPool::encrypt(*encryptor, plain, cipher));
+
+    SealZeroPool pool(context, encryptor, 4);
+    auto parms_id = context->first_parms_id();
+    encoder.encode(input, parms_id, 1 << 25, plain);
+
+    // Levels are added on first use
+    EXPECT_FALSE(SealZeroPool::encrypt(*encryptor, plain, cipher));
+    pool.fill(parms_id);
+    EXPECT_GE(pool.size(parms_id), pool.capacity());
+
+    EXPECT_TRUE(SealZeroPool::encrypt(*encryptor, plain, cipher));
+    EXPECT_EQ(cipher.parms_id(), parms_id);
+    EXPECT_EQ(cipher.scale(), plain.scale());
+    decryptor.decrypt(cipher, decrypted);
+    encoder.decode(decrypted, output);
+    output.resize(input.size());
+    EXPECT_TRUE(test::all_close(output, input, 1e-3));
+  }
+  EXPECT_FALSE(SealZeroPool::encrypt(*encryptor, plain, cipher));
+}
+
+}  // namespace ngraph::runtime::he
@@ -14,18 +14,28 @@
 // limitations under the License.
 //*****************************************************************************
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include "ngraph/ngraph.hpp"
 #include "ngraph/op/util/op_annotations.hpp"
 #include "op/bounded_relu.hpp"
+#include "op/convolution_bias_relu.hpp"
+#include "protos/message.pb.h"
 #include "seal/he_seal_backend.hpp"
 #include "seal/he_seal_client.hpp"
 #include "seal/he_seal_executable.hpp"
+#include "seal/he_seal_model_registry.hpp"
+#include "seal/he_seal_replay_client.hpp"
 #include "test_util.hpp"
 #include "util/all_close.hpp"
 #include "util/ndarray.hpp"
@@ -321,6 +331,195 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3) {
       test::all_close(results, std::vector<float>{1.1, 2.2, 3.3}, 1e-3f));
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, server_client_lazy_scalar_factors) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = op::Constant::create(element::f32, shape, {4, 4, 4});
+  auto t = std::make_shared<op::Negative>(std::make_shared<op::Divide>(a, b));
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"lazy_scalar_factors", "true"},
+                          {a->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, 2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The pending factor -1/4 is multiplied in before the result is sent
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(
+      test::all_close(results, std::vector<float>{-0.25, -0.5, -0.75}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_multiple_results) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto sum = std::make_shared<op::Add>(a, b);
+  auto twice = std::make_shared<op::Add>(b, b);
+  auto f = std::make_shared<Function>(NodeVector{sum, twice},
+                                      ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"client_mod_switch", "true"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_sum = he_backend->create_cipher_tensor(element::f32, shape);
+  auto t_twice = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  std::vector<float> sum_results;
+  std::vector<float> twice_results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, 2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    // Each result is available once it is sent
+    const auto& twice_ref = he_client.get_results_ref(1);
+    twice_results = std::vector<float>(twice_ref.begin(), twice_ref.end());
+    const auto& sum_ref = he_client.get_results_ref(0);
+    sum_results = std::vector<float>(sum_ref.begin(), sum_ref.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_sum, t_twice}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(
+      test::all_close(sum_results, std::vector<float>{1.1, 2.2, 3.3}, 1e-3f));
+  EXPECT_TRUE(
+      test::all_close(twice_results, std::vector<float>{2, 4, 6}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_input_view) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 2;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape,
+                                {0.1, 0.2, 0.3, 0.4, 0.5, 0.6});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {b->get_name(), "client_input,encrypt,packed"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    // Encrypted in place from the float buffer
+    std::vector<float> inputs{1, 2, 3, 4, 5, 6};
+    auto he_client = HESealClient(
+        "localhost", 34000, batch_size,
+        HEInputViewMap{{b->get_name(), HEInputView{"encrypt", element::f32,
+                                                   inputs.data(),
+                                                   inputs.size()}}});
+
+    const auto& double_results = he_client.get_results_ref();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(
+      results, std::vector<float>{1.1, 2.2, 3.3, 4.4, 5.5, 6.6}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_dot_stream_client_inputs) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape_a{batch_size, 4};
+  Shape shape_b{4, 2};
+  Shape shape_r{batch_size, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, shape_b,
+                                {1, 2, 3, 4, 5, 6, 7, 8});
+  auto t = std::make_shared<op::Dot>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"stream_client_inputs", "true"},
+                          {a->get_name(), "client_input,encrypt"}},
+                         error_str);
+  EXPECT_TRUE(he_backend->stream_client_inputs());
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape_a);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape_r);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99, 99});
+
+  // The client sends the first element of the input in its own chunk, so
+  // the Dot starts on a partially loaded input
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, 2, 3, 4};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{50, 60}, 1e-3f));
+}
+
 NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
@@ -368,15 +567,15 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu) {
   EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_double) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_stats) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
 
   size_t batch_size = 1;
 
   Shape shape{batch_size, 3};
-  auto a = op::Constant::create(element::f64, shape, {0.1, 0.2, 0.3});
-  auto b = std::make_shared<op::Parameter>(element::f64, shape);
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
   auto t = std::make_shared<op::Add>(a, b);
   auto relu = std::make_shared<op::Relu>(t);
   auto f = std::make_shared<Function>(relu, ParameterVector{b});
@@ -386,76 +585,75 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_double) {
       {{"enable_client", "true"}, {b->get_name(), "client_input,encrypt"}},
       error_str);
 
-  // Server inputs which are not used
-  auto t_dummy = he_backend->create_plain_tensor(element::f64, shape);
-  auto t_result = he_backend->create_cipher_tensor(element::f64, shape);
-
-  // Used for dummy server inputs
-  double dummy_float = 99;
-  copy_data(t_dummy,
-            std::vector<double>{dummy_float, dummy_float, dummy_float});
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
 
-  std::vector<double> results;
+  std::map<std::string, HEClientPhaseStats> phases;
+  size_t bytes_sent = 0;
+  size_t bytes_received = 0;
   auto client_thread = std::thread([&]() {
-    std::vector<double> inputs{-1, -0.2, 3};
+    std::vector<float> inputs{-1, -0.2, 3};
     auto he_client =
         HESealClient("localhost", 34000, batch_size,
-                     HETensorConfigMap<double>{
+                     HETensorConfigMap<float>{
                          {b->get_name(), make_pair("encrypt", inputs)}});
-
-    auto double_results = he_client.get_results();
-    results = std::vector<double>(double_results.begin(), double_results.end());
+    he_client.get_results();
+    phases = he_client.stats().phases();
+    bytes_sent = he_client.stats().bytes_sent();
+    bytes_received = he_client.stats().bytes_received();
   });
 
   auto handle =
       std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
-
   handle->call_with_validate({t_result}, {t_dummy});
-
   client_thread.join();
-  EXPECT_TRUE(test::all_close(results, std::vector<double>{0, 0, 3.3}, 1e-3));
+
+  for (const std::string& phase :
+       {"keygen", "key_upload", "input_encrypt", "relu_load", "relu",
+        "relu_write", "result_decrypt"}) {
+    ASSERT_TRUE(phases.find(phase) != phases.end()) << phase;
+    EXPECT_GE(phases.at(phase).calls, 1) << phase;
+    EXPECT_GT(phases.at(phase).seconds, 0) << phase;
+  }
+  EXPECT_GT(bytes_sent, 0);
+  EXPECT_GT(bytes_received, 0);
 }
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_int64_t) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_io_threads) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
 
   size_t batch_size = 1;
 
   Shape shape{batch_size, 3};
-  auto a = op::Constant::create(element::i64, shape, {1, 2, 3});
-  auto b = std::make_shared<op::Parameter>(element::i64, shape);
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
   auto t = std::make_shared<op::Add>(a, b);
   auto relu = std::make_shared<op::Relu>(t);
   auto f = std::make_shared<Function>(relu, ParameterVector{b});
 
   std::string error_str;
-  he_backend->set_config(
-      {{"enable_client", "true"}, {b->get_name(), "client_input,encrypt"}},
-      error_str);
-
-  // Server inputs which are not used
-  auto t_dummy = he_backend->create_plain_tensor(element::i64, shape);
-  auto t_result = he_backend->create_cipher_tensor(element::i64, shape);
+  he_backend->set_config({{"enable_client", "true"},
+                          {"num_io_threads", "4"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+  EXPECT_EQ(he_backend->num_io_threads(), 4);
 
-  // Used for dummy server inputs
-  double dummy_float = 99;
-  copy_data(t_dummy,
-            std::vector<double>{dummy_float, dummy_float, dummy_float});
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
 
-  std::vector<int64_t> results;
+  std::vector<float> results;
   auto client_thread = std::thread([&]() {
-    std::vector<int64_t> inputs{-1, 0, 3};
+    std::vector<float> inputs{-1, -0.2, 3};
     auto he_client =
         HESealClient("localhost", 34000, batch_size,
-                     HETensorConfigMap<int64_t>{
+                     HETensorConfigMap<float>{
                          {b->get_name(), make_pair("encrypt", inputs)}});
 
     auto double_results = he_client.get_results();
-    results.resize(double_results.size());
-    for (size_t i = 0; i < results.size(); ++i) {
-      results[i] = round(double_results[i]);
-    }
+    results = std::vector<float>(double_results.begin(), double_results.end());
   });
 
   auto handle =
@@ -464,33 +662,35 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_int64_t) {
   handle->call_with_validate({t_result}, {t_dummy});
 
   client_thread.join();
-  EXPECT_TRUE(test::all_close(results, std::vector<int64_t>{0, 2, 6}, 0L));
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_bounded_relu) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_overlap) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
 
   size_t batch_size = 1;
 
   Shape shape{batch_size, 3};
-  Shape result_shape{batch_size, 5};
-  auto a = std::make_shared<op::Parameter>(element::f32, shape);
-  auto b = op::Constant::create(element::f32, Shape{}, std::vector<float>({0}));
-  CoordinateDiff padding_below{0, 1};
-  CoordinateDiff padding_above{0, 1};
-  auto c = std::make_shared<op::Pad>(a, b, padding_below, padding_above);
-  auto relu = std::make_shared<op::BoundedRelu>(c, 6.0f);
-  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  // The multiply is independent of the relu, so it runs during the relu
+  // round-trip
+  auto relu = std::make_shared<op::Relu>(t);
+  auto prod = std::make_shared<op::Multiply>(t, a);
+  auto sum = std::make_shared<op::Add>(relu, prod);
+  auto f = std::make_shared<Function>(sum, ParameterVector{b});
 
   std::string error_str;
-  he_backend->set_config(
-      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
-      error_str);
+  he_backend->set_config({{"enable_client", "true"},
+                          {"num_inter_op_threads", "2"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
 
   // Server inputs which are not used
   auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
-  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
 
   // Used for dummy server inputs
   float dummy_float = 99;
@@ -498,11 +698,11 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_bounded_relu) {
 
   std::vector<float> results;
   auto client_thread = std::thread([&]() {
-    std::vector<float> inputs{-1, 3, 7};
+    std::vector<float> inputs{-1, -0.2, 3};
     auto he_client =
         HESealClient("localhost", 34000, batch_size,
                      HETensorConfigMap<float>{
-                         {a->get_name(), make_pair("encrypt", inputs)}});
+                         {b->get_name(), make_pair("encrypt", inputs)}});
 
     auto double_results = he_client.get_results();
     results = std::vector<float>(double_results.begin(), double_results.end());
@@ -515,33 +715,36 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_bounded_relu) {
 
   client_thread.join();
   EXPECT_TRUE(
-      test::all_close(results, std::vector<float>{0, 0, 3, 6, 0}, 1e-3f));
+      test::all_close(results, std::vector<float>{-0.09, 0, 4.29}, 1e-3f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_relu) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_parallel_branches) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
 
   size_t batch_size = 1;
 
   Shape shape{batch_size, 3};
-  Shape result_shape{batch_size, 5};
-  auto a = std::make_shared<op::Parameter>(element::f32, shape);
-  auto b = op::Constant::create(element::f32, Shape{}, std::vector<float>({0}));
-  CoordinateDiff padding_below{0, 1};
-  CoordinateDiff padding_above{0, 1};
-  auto c = std::make_shared<op::Pad>(a, b, padding_below, padding_above);
-  auto relu = std::make_shared<op::Relu>(c);
-  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  // The relus of both branches send the same request, so relus ready
+  // together share their round-trips
+  auto relu_sum = std::make_shared<op::Relu>(std::make_shared<op::Add>(a, b));
+  auto relu_prod =
+      std::make_shared<op::Relu>(std::make_shared<op::Multiply>(b, a));
+  auto sum = std::make_shared<op::Add>(relu_sum, relu_prod);
+  auto f = std::make_shared<Function>(sum, ParameterVector{b});
 
   std::string error_str;
-  he_backend->set_config(
-      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
-      error_str);
+  he_backend->set_config({{"enable_client", "true"},
+                          {"num_inter_op_threads", "2"},
+                          {"coalesce_client_ops", "true"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
 
   // Server inputs which are not used
   auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
-  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
 
   // Used for dummy server inputs
   float dummy_float = 99;
@@ -553,7 +756,7 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_relu) {
     auto he_client =
         HESealClient("localhost", 34000, batch_size,
                      HETensorConfigMap<float>{
-                         {a->get_name(), make_pair("encrypt", inputs)}});
+                         {b->get_name(), make_pair("encrypt", inputs)}});
 
     auto double_results = he_client.get_results();
     results = std::vector<float>(double_results.begin(), double_results.end());
@@ -565,78 +768,44 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_relu) {
   handle->call_with_validate({t_result}, {t_dummy});
 
   client_thread.join();
-  EXPECT_TRUE(
-      test::all_close(results, std::vector<float>{0, 0, 0, 3, 0}, 1e-3f));
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 4.2}, 1e-3f));
 }
 
-auto server_client_relu_packed_test = [](size_t element_count,
-                                         size_t batch_size,
-                                         bool complex_packing, bool bounded,
-                                         double bound_value = 0.) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_epilogue) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
 
-  if (complex_packing) {
-    he_backend->update_encryption_parameters(
-        HESealEncryptionParameters::default_complex_packing_parms());
-  }
+  size_t batch_size = 1;
 
-  Shape shape{batch_size, element_count};
-  auto a = std::make_shared<op::Parameter>(element::f32, shape);
-  std::shared_ptr<Function> f;
-  if (bounded) {
-    auto bounded_relu_op = std::make_shared<op::BoundedRelu>(a, bound_value);
-    f = std::make_shared<Function>(bounded_relu_op, ParameterVector{a});
-  } else {
-    auto relu_op = std::make_shared<op::Relu>(a);
-    f = std::make_shared<Function>(relu_op, ParameterVector{a});
-  }
-
-  bool packed = batch_size > 1;
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  // The client computes the relu and softmax after decrypting the sum
+  auto relu = std::make_shared<op::Relu>(std::make_shared<op::Add>(a, b));
+  auto softmax = std::make_shared<op::Softmax>(relu, AxisSet{1});
+  auto f = std::make_shared<Function>(softmax, ParameterVector{b});
 
-  std::string tensor_config{"client_input,encrypt"};
-  if (packed) {
-    tensor_config.append(",packed");
-  }
   std::string error_str;
-  he_backend->set_config(
-      {{"enable_client", "true"}, {a->get_name(), tensor_config}}, error_str);
-
-  auto relu = [](double d) { return d > 0 ? d : 0.; };
-  auto bounded_relu = [bound_value](double d) {
-    return d > bound_value ? bound_value : (d > 0) ? d : 0.;
-  };
+  he_backend->set_config({{"enable_client", "true"},
+                          {"client_epilogue", "true"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
 
   // Server inputs which are not used
-  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
-  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
 
   // Used for dummy server inputs
   float dummy_float = 99;
-  copy_data(t_dummy, std::vector<float>(shape_size(shape), dummy_float));
-
-  std::vector<float> inputs(shape_size(shape));
-  std::vector<float> exp_results(shape_size(shape));
-  for (size_t i = 0; i < shape_size(shape); ++i) {
-    inputs[i] =
-        static_cast<float>(i) - static_cast<float>(shape_size(shape)) / 2.0;
-    if (inputs[i] > 1000) {
-      inputs[i] = fmod(inputs[i], 1000);
-    }
-
-    if (bounded) {
-      exp_results[i] = bounded_relu(inputs[i]);
-    } else {
-      exp_results[i] = relu(inputs[i]);
-    }
-  }
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
 
   std::vector<float> results;
   auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
     auto he_client =
         HESealClient("localhost", 34000, batch_size,
                      HETensorConfigMap<float>{
-                         {a->get_name(), make_pair("encrypt", inputs)}});
+                         {b->get_name(), make_pair("encrypt", inputs)}});
 
     auto double_results = he_client.get_results();
     results = std::vector<float>(double_results.begin(), double_results.end());
@@ -648,179 +817,1181 @@ auto server_client_relu_packed_test = [](size_t element_count,
   handle->call_with_validate({t_result}, {t_dummy});
 
   client_thread.join();
-  EXPECT_TRUE(test::all_close(results, exp_results));
-};
-
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_1_complex) {
-  server_client_relu_packed_test(10, 1, true, false);
+  EXPECT_TRUE(test::all_close(
+      results, std::vector<float>{0.034349, 0.034349, 0.931302}, 1e-3f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_1) {
-  server_client_relu_packed_test(10, 1, false, false);
-}
+NGRAPH_TEST(${BACKEND_NAME}, server_client_conv_bias_relu) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_2_complex) {
-  server_client_relu_packed_test(10, 2, true, false);
-}
+  size_t batch_size = 1;
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_2) {
-  server_client_relu_packed_test(10, 2, false, false);
-}
+  Shape shape{batch_size, 1, 3, 3};
+  Shape out_shape{batch_size, 2, 2, 2};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto filters = op::Constant::create(element::f32, Shape{2, 1, 2, 2},
+                                      {1, 0, 0, 1, 0, 1, -1, 0});
+  auto conv = std::make_shared<op::Convolution>(a, filters, Strides{1, 1},
+                                                Strides{1, 1});
+  auto bias = std::make_shared<op::Broadcast>(
+      op::Constant::create(element::f32, Shape{2}, {1, -1}), out_shape,
+      AxisSet{0, 2, 3});
+  auto relu = std::make_shared<op::Relu>(std::make_shared<op::Add>(conv, bias));
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_3_complex) {
-  server_client_relu_packed_test(10, 3, true, false);
-}
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
+      error_str);
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_3) {
-  server_client_relu_packed_test(10, 3, false, false);
-}
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, out_shape);
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_all_slots_complex) {
-  auto backend = runtime::Backend::create("${BACKEND_NAME}");
-  auto he_backend = static_cast<HESealBackend*>(backend.get());
-  size_t slot_count = he_backend->get_ckks_encoder()->slot_count() * 2;
-  server_client_relu_packed_test(10, slot_count, true, false);
-}
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, -2, 3, -4, 5, -6, 7, -8, 9};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_all_slots) {
-  auto backend = runtime::Backend::create("${BACKEND_NAME}");
-  auto he_backend = static_cast<HESealBackend*>(backend.get());
-  size_t slot_count = he_backend->get_ckks_encoder()->slot_count();
-  server_client_relu_packed_test(10, slot_count, false, false);
-}
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_1_complex) {
-  server_client_relu_packed_test(10, 1, true, true, 1.0);
-}
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  EXPECT_EQ(1, count_ops_of_type<op::ConvolutionBiasRelu>(f));
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_1) {
-  server_client_relu_packed_test(10, 1, false, true, 2.0);
-}
+  handle->call_with_validate({t_result}, {t_dummy});
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_2_complex) {
-  server_client_relu_packed_test(10, 2, true, true, 3.0);
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(
+      results, std::vector<float>{7, 0, 0, 15, 1, 0, 0, 1}, 1e-3f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_2) {
-  server_client_relu_packed_test(10, 2, false, true, 4.0);
-}
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_mod_switch) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_3_complex) {
-  server_client_relu_packed_test(10, 3, true, true, 5.0);
-}
+  size_t batch_size = 1;
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_3) {
-  server_client_relu_packed_test(10, 3, false, true, 6.0);
-}
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  // The relu result is fresh from the client, so it can be computed on
+  auto prod = std::make_shared<op::Multiply>(relu, a);
+  auto f = std::make_shared<Function>(prod, ParameterVector{b});
 
-NGRAPH_TEST(${BACKEND_NAME},
-            server_client_bounded_relu_packed_all_slots_complex) {
-  auto backend = runtime::Backend::create("${BACKEND_NAME}");
-  auto he_backend = static_cast<HESealBackend*>(backend.get());
-  size_t slot_count = he_backend->get_ckks_encoder()->slot_count() * 2;
-  server_client_relu_packed_test(10, slot_count, true, true, 7.0);
-}
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"client_mod_switch", "true"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+  EXPECT_TRUE(he_backend->client_mod_switch());
+
+  auto first_parms_id = he_backend->get_context()->first_parms_id();
+  auto lowest_parms_id = he_backend->lowest_decryptable_parms_id(
+      he_backend->get_encryption_parameters().scale());
+  EXPECT_LE(he_backend->get_context()
+                ->get_context_data(lowest_parms_id)
+                ->chain_index(),
+            he_backend->get_context()
+                ->get_context_data(first_parms_id)
+                ->chain_index());
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_all_slots) {
-  auto backend = runtime::Backend::create("${BACKEND_NAME}");
-  auto he_backend = static_cast<HESealBackend*>(backend.get());
-  size_t slot_count = he_backend->get_ckks_encoder()->slot_count();
-  server_client_relu_packed_test(10, slot_count, false, true, 8.0);
-}
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_845) {
-  server_client_relu_packed_test(845, 1, true, false);
-}
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_1000) {
-  server_client_relu_packed_test(1000, 1, true, false);
-}
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_50000) {
-  server_client_relu_packed_test(50000, 1, true, false);
-}
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_845) {
-  server_client_relu_packed_test(845, 1, true, true, 6.0);
-}
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_1000) {
-  server_client_relu_packed_test(1000, 1, true, true, 6.0);
-}
+  handle->call_with_validate({t_result}, {t_dummy});
 
-NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_50000) {
-  server_client_relu_packed_test(50000, 1, true, true, 6.0);
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 0.99}, 1e-3f));
 }
 
-auto server_client_maxpool_test = [](const Shape& shape,
-                                     const Shape& window_shape,
-                                     const std::vector<float>& input,
-                                     const std::vector<float>& output,
-                                     const bool arg1_encrypted,
-                                     const bool complex_packing,
-                                     const bool packed) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_two_clients) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
 
-  if (complex_packing) {
-    he_backend->update_encryption_parameters(
-        HESealEncryptionParameters::default_complex_packing_parms());
-  }
+  size_t batch_size = 1;
 
-  auto a = std::make_shared<op::Parameter>(element::f32, shape);
-  auto t = std::make_shared<op::MaxPool>(a, window_shape);
-  auto f = std::make_shared<Function>(t, ParameterVector{a});
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
 
-  std::string tensor_config{"client_input,encrypt"};
-  if (packed) {
-    tensor_config.append(",packed");
-  }
   std::string error_str;
-  he_backend->set_config(
-      {{"enable_client", "true"}, {a->get_name(), tensor_config}}, error_str);
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+  EXPECT_EQ(he_backend->max_clients(), 2U);
 
   // Server inputs which are not used
-  auto t_dummy =
-      test::tensor_from_flags(*he_backend, shape, arg1_encrypted, packed);
-  auto t_result = test::tensor_from_flags(*he_backend, t->get_shape(),
-                                          arg1_encrypted, packed);
-  size_t batch_size =
-      std::static_pointer_cast<HETensor>(t_dummy)->get_batch_size();
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
 
   // Used for dummy server inputs
   float dummy_float = 99;
-  copy_data(t_dummy, std::vector<float>(shape_size(shape), dummy_float));
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
 
-  std::vector<float> results;
-  auto client_thread = std::thread([&]() {
-    auto he_client = HESealClient(
-        "localhost", 34000, batch_size,
-        HETensorConfigMap<float>{{a->get_name(), make_pair("encrypt", input)}});
+  auto run_client = [&](const std::vector<float>& inputs,
+                        std::vector<float>& results) {
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
 
     auto double_results = he_client.get_results();
     results = std::vector<float>(double_results.begin(), double_results.end());
-  });
+  };
+
+  std::vector<float> results_0;
+  std::vector<float> results_1;
+  auto client_thread_0 = std::thread(
+      [&]() { run_client(std::vector<float>{1, -2, 3}, results_0); });
+  auto client_thread_1 = std::thread(
+      [&]() { run_client(std::vector<float>{-1, 2, -3}, results_1); });
 
   auto handle =
       std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
 
+  // Each call serves one client
+  handle->call_with_validate({t_result}, {t_dummy});
   handle->call_with_validate({t_result}, {t_dummy});
 
-  client_thread.join();
-  EXPECT_TRUE(test::all_close(results, output));
-};
-
-NGRAPH_TEST(${BACKEND_NAME},
-            server_client_max_pool_1d_1channel_1image_encrypted_real_unpacked) {
-  server_client_maxpool_test(
-      Shape{1, 1, 14}, Shape{3},
-      std::vector<float>{0, 1, 0, 2, 1, 0, 3, 2, 0, 0, 2, 0, 0, 0},
-      std::vector<float>{1, 2, 2, 2, 3, 3, 3, 2, 2, 2, 2, 0}, true, false,
-      false);
+  client_thread_0.join();
+  client_thread_1.join();
+  EXPECT_TRUE(
+      test::all_close(results_0, std::vector<float>{1.1, 0, 3.3}, 1e-3f));
+  EXPECT_TRUE(test::all_close(results_1, std::vector<float>{0, 2.2, 0}, 1e-3f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME},
-            server_client_max_pool_1d_1channel_2image_encrypted_real_packed) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_cached_keys) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  std::string key_file = "server_client_cached_keys.bin";
+  std::remove(key_file.c_str());
+  setenv("NGRAPH_HE_CLIENT_KEY_FILE", key_file.c_str(), 1);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The first client generates and uploads its keys; the second loads them
+  // from the key file and only sends their fingerprint
+  for (size_t client_idx = 0; client_idx < 2; ++client_idx) {
+    std::vector<float> results;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{-1, -0.2, 3};
+      auto he_client =
+          HESealClient("localhost", 34000, batch_size,
+                       HETensorConfigMap<float>{
+                           {b->get_name(), make_pair("encrypt", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+  }
+  unsetenv("NGRAPH_HE_CLIENT_KEY_FILE");
+  std::remove(key_file.c_str());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_pipelined_session) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "3"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  std::string key_file = "server_client_pipelined_keys.bin";
+  std::string session_file = "server_client_pipelined_session.bin";
+  std::remove(key_file.c_str());
+  std::remove(session_file.c_str());
+  setenv("NGRAPH_HE_CLIENT_KEY_FILE", key_file.c_str(), 1);
+  setenv("NGRAPH_HE_CLIENT_SESSION_FILE", session_file.c_str(), 1);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The first client caches the session, the second uploads its inputs
+  // right after its keys, and the third's stale request is rejected, so it
+  // uploads its inputs again
+  for (size_t client_idx = 0; client_idx < 3; ++client_idx) {
+    if (client_idx == 2) {
+      pb::TCPMessage request;
+      {
+        std::ifstream stream(session_file, std::ios::binary);
+        ASSERT_TRUE(request.ParseFromIstream(&stream));
+      }
+      request.mutable_function()->set_function(
+          R"({"function": "Parameter", "stale": "true"})");
+      std::ofstream stream(session_file, std::ios::binary | std::ios::trunc);
+      ASSERT_TRUE(request.SerializeToOstream(&stream));
+    }
+
+    std::vector<float> results;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{-1, -0.2, 3};
+      auto he_client =
+          HESealClient("localhost", 34000, batch_size,
+                       HETensorConfigMap<float>{
+                           {b->get_name(), make_pair("encrypt", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+  }
+  unsetenv("NGRAPH_HE_CLIENT_KEY_FILE");
+  unsetenv("NGRAPH_HE_CLIENT_SESSION_FILE");
+  std::remove(key_file.c_str());
+  std::remove(session_file.c_str());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_pipelined_keygen) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  // Without a key file, the second client generates its keys while its
+  // inputs are encrypted
+  std::string session_file = "server_client_pipelined_keygen_session.bin";
+  std::remove(session_file.c_str());
+  setenv("NGRAPH_HE_CLIENT_SESSION_FILE", session_file.c_str(), 1);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  for (size_t client_idx = 0; client_idx < 2; ++client_idx) {
+    std::vector<float> results;
+    std::map<std::string, HEClientPhaseStats> phases;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{-1, -0.2, 3};
+      auto he_client =
+          HESealClient("localhost", 34000, batch_size,
+                       HETensorConfigMap<float>{
+                           {b->get_name(), make_pair("encrypt", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+      phases = he_client.stats().phases();
+    });
+
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+    for (const std::string& phase : {"keygen", "key_upload", "input_encrypt"}) {
+      ASSERT_TRUE(phases.find(phase) != phases.end()) << phase;
+      EXPECT_GE(phases.at(phase).calls, 1) << phase;
+    }
+  }
+  unsetenv("NGRAPH_HE_CLIENT_SESSION_FILE");
+  std::remove(session_file.c_str());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_compaction) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 2;
+
+  Shape shape{batch_size, 6};
+  auto a = op::Constant::create(element::f32, shape,
+                                std::vector<float>(shape_size(shape), 0.5));
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"relu_compaction", "true"},
+                          {b->get_name(), "client_input,encrypt,packed"}},
+                         error_str);
+
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+
+  // The six ciphertexts of two slots each are sent packed into one
+  std::vector<float> inputs{-3, -2, -1, 0, 1, 2, 3, 4, 5, -4, -5, -6};
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+
+  std::vector<float> expected;
+  for (float input : inputs) {
+    expected.emplace_back(std::max(input + 0.5F, 0.0F));
+  }
+  EXPECT_TRUE(test::all_close(results, expected, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_result_compaction) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 2;
+
+  Shape shape{batch_size, 5};
+  auto a = op::Constant::create(element::f32, shape,
+                                std::vector<float>(shape_size(shape), 0.5));
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto f = std::make_shared<Function>(t, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"result_compaction", "true"},
+                          {b->get_name(), "client_input,encrypt,packed"}},
+                         error_str);
+
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+
+  // The five result ciphertexts of two slots each are sent packed into one
+  std::vector<float> inputs{-3, -2, -1, 0, 1, 2, 3, 4, 5, -4};
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+
+  std::vector<float> expected;
+  for (float input : inputs) {
+    expected.emplace_back(input + 0.5F);
+  }
+  EXPECT_TRUE(test::all_close(results, expected, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_sigmoid_tanh) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto sigmoid = std::make_shared<op::Sigmoid>(t);
+  auto tanh = std::make_shared<op::Tanh>(sigmoid);
+  auto f = std::make_shared<Function>(tanh, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {b->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  std::vector<float> inputs{-1, -0.2, 3};
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  // Each activation is computed by the client in one round-trip
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+
+  std::vector<float> expected;
+  std::vector<float> constants{0.1, 0.2, 0.3};
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    expected.emplace_back(
+        std::tanh(1 / (1 + std::exp(-(inputs[i] + constants[i])))));
+  }
+  EXPECT_TRUE(test::all_close(results, expected, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_capture_replay) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  std::string capture_file = "server_client_capture_replay.bin";
+  std::remove(capture_file.c_str());
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The first session is captured
+  std::vector<float> results;
+  setenv("NGRAPH_HE_CLIENT_CAPTURE_FILE", capture_file.c_str(), 1);
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  unsetenv("NGRAPH_HE_CLIENT_CAPTURE_FILE");
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+
+  auto capture = std::make_shared<const std::vector<CapturedMessage>>(
+      load_capture(capture_file));
+  size_t num_captured_received =
+      std::count_if(capture->begin(), capture->end(),
+                    [](const CapturedMessage& m) { return !m.sent; });
+  EXPECT_GT(num_captured_received, 0);
+  EXPECT_LT(num_captured_received, capture->size());
+
+  // The second session is replayed, answering the server as captured
+  size_t num_received = 0;
+  size_t num_mismatched = 0;
+  auto replay_thread = std::thread([&]() {
+    HESealReplayClient replay_client("localhost", 34000, capture, 2.0);
+    num_received = replay_client.num_received();
+    num_mismatched = replay_client.num_mismatched();
+  });
+  handle->call_with_validate({t_result}, {t_dummy});
+  replay_thread.join();
+  EXPECT_EQ(num_received, num_captured_received);
+  EXPECT_EQ(num_mismatched, 0);
+  std::remove(capture_file.c_str());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_model_registry) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b_add = std::make_shared<op::Parameter>(element::f32, shape);
+  auto f_add = std::make_shared<Function>(std::make_shared<op::Add>(a, b_add),
+                                          ParameterVector{b_add});
+  auto b_neg = std::make_shared<op::Parameter>(element::f32, shape);
+  auto f_neg = std::make_shared<Function>(std::make_shared<op::Negative>(b_neg),
+                                          ParameterVector{b_neg});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {b_add->get_name(), "client_input,encrypt"},
+                          {b_neg->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  HESealModelRegistry registry(*he_backend);
+  registry.add_model("add", std::static_pointer_cast<HESealExecutable>(
+                                he_backend->compile(f_add)));
+  registry.add_model("negate", std::static_pointer_cast<HESealExecutable>(
+                                   he_backend->compile(f_neg)));
+  EXPECT_ANY_THROW(registry.add_model("add", registry.model("negate")));
+  EXPECT_EQ(registry.model_names(),
+            (std::vector<std::string>{"add", "negate"}));
+  registry.start();
+
+  std::vector<std::pair<std::string, std::string>> requests{
+      {"negate", b_neg->get_name()}, {"add", b_add->get_name()}};
+  std::vector<std::vector<float>> expected{{-1, -2, -3}, {1.1, 2.2, 3.3}};
+  for (size_t client_idx = 0; client_idx < requests.size(); ++client_idx) {
+    const auto& [model_name, input_name] = requests[client_idx];
+    setenv("NGRAPH_HE_CLIENT_MODEL", model_name.c_str(), 1);
+    std::vector<float> results;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{1, 2, 3};
+      auto he_client = HESealClient(
+          "localhost", 34000, batch_size,
+          HETensorConfigMap<float>{{input_name, make_pair("encrypt", inputs)}});
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+    });
+
+    EXPECT_EQ(registry.wait_for_session(), model_name);
+    EXPECT_TRUE(registry.call(model_name, {t_result}, {t_dummy}));
+    client_thread.join();
+    EXPECT_TRUE(test::all_close(results, expected[client_idx], 1e-3f));
+  }
+  unsetenv("NGRAPH_HE_CLIENT_MODEL");
+  EXPECT_EQ(registry.num_rejected_sessions(), 0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_model_registry_replicas) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+  Shape shape{batch_size, 3};
+  std::string input_tag{"input_tag"};
+
+  // Compiling rewrites the function, so each replica compiles its own
+  auto make_function = [&]() {
+    auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+    auto b = std::make_shared<op::Parameter>(element::f32, shape);
+    b->add_provenance_tag(input_tag);
+    auto relu = std::make_shared<op::Relu>(std::make_shared<op::Add>(a, b));
+    return std::make_shared<Function>(relu, ParameterVector{b});
+  };
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {input_tag, "client_input,encrypt"}},
+                         error_str);
+
+  // The replicas' sessions share the keys of the key file
+  std::string key_file = "server_client_model_registry_replicas.bin";
+  std::remove(key_file.c_str());
+  setenv("NGRAPH_HE_CLIENT_KEY_FILE", key_file.c_str(), 1);
+
+  HESealModelRegistry registry(*he_backend);
+  registry.add_model("relu", std::static_pointer_cast<HESealExecutable>(
+                                 he_backend->compile(make_function())));
+  registry.add_replica("relu", std::static_pointer_cast<HESealExecutable>(
+                                   he_backend->compile(make_function())));
+  EXPECT_ANY_THROW(registry.add_replica("relu", registry.model("relu")));
+  EXPECT_ANY_THROW(registry.add_replica(
+      "missing", std::static_pointer_cast<HESealExecutable>(
+                     he_backend->compile(make_function()))));
+  registry.start();
+
+  auto run_client = [&](float offset, std::vector<float>& results) {
+    std::vector<float> inputs{-1 + offset, -0.2f + offset, 3 + offset};
+    auto he_client = HESealClient(
+        "localhost", 34000, batch_size,
+        HETensorConfigMap<float>{{input_tag, make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  };
+  auto serve = [&]() {
+    auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+    auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+    copy_data(t_dummy, std::vector<float>{99, 99, 99});
+    EXPECT_EQ(registry.wait_for_session(), "relu");
+    EXPECT_TRUE(registry.call("relu", {t_result}, {t_dummy}));
+  };
+
+  // The first client uploads its keys, which the concurrent clients reuse
+  std::vector<float> first_results;
+  auto first_client = std::thread([&]() { run_client(0, first_results); });
+  serve();
+  first_client.join();
+  EXPECT_TRUE(
+      test::all_close(first_results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+
+  std::vector<std::vector<float>> results(2);
+  std::vector<std::thread> threads;
+  for (size_t client_idx = 0; client_idx < results.size(); ++client_idx) {
+    threads.emplace_back([&, client_idx]() {
+      run_client(static_cast<float>(client_idx + 1), results[client_idx]);
+    });
+    threads.emplace_back(serve);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(
+      test::all_close(results[0], std::vector<float>{0.1, 1.0, 4.3}, 1e-3f));
+  EXPECT_TRUE(
+      test::all_close(results[1], std::vector<float>{1.1, 2.0, 5.3}, 1e-3f));
+  unsetenv("NGRAPH_HE_CLIENT_KEY_FILE");
+  std::remove(key_file.c_str());
+  EXPECT_EQ(registry.num_rejected_sessions(), 0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_double) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f64, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f64, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {b->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f64, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f64, shape);
+
+  // Used for dummy server inputs
+  double dummy_float = 99;
+  copy_data(t_dummy,
+            std::vector<double>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<double> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<double> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<double>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<double>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<double>{0, 0, 3.3}, 1e-3));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_add_3_relu_int64_t) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::i64, shape, {1, 2, 3});
+  auto b = std::make_shared<op::Parameter>(element::i64, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {b->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::i64, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::i64, shape);
+
+  // Used for dummy server inputs
+  double dummy_float = 99;
+  copy_data(t_dummy,
+            std::vector<double>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<int64_t> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<int64_t> inputs{-1, 0, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<int64_t>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results.resize(double_results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      results[i] = round(double_results[i]);
+    }
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<int64_t>{0, 2, 6}, 0L));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_bounded_relu) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  Shape result_shape{batch_size, 5};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = op::Constant::create(element::f32, Shape{}, std::vector<float>({0}));
+  CoordinateDiff padding_below{0, 1};
+  CoordinateDiff padding_above{0, 1};
+  auto c = std::make_shared<op::Pad>(a, b, padding_below, padding_above);
+  auto relu = std::make_shared<op::BoundedRelu>(c, 6.0f);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, 3, 7};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(
+      test::all_close(results, std::vector<float>{0, 0, 3, 6, 0}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_pad_relu) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  Shape result_shape{batch_size, 5};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto b = op::Constant::create(element::f32, Shape{}, std::vector<float>({0}));
+  CoordinateDiff padding_below{0, 1};
+  CoordinateDiff padding_above{0, 1};
+  auto c = std::make_shared<op::Pad>(a, b, padding_below, padding_above);
+  auto relu = std::make_shared<op::Relu>(c);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>{dummy_float, dummy_float, dummy_float});
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(
+      test::all_close(results, std::vector<float>{0, 0, 0, 3, 0}, 1e-3f));
+}
+
+auto server_client_relu_packed_test = [](size_t element_count,
+                                         size_t batch_size,
+                                         bool complex_packing, bool bounded,
+                                         double bound_value = 0.) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  if (complex_packing) {
+    he_backend->update_encryption_parameters(
+        HESealEncryptionParameters::default_complex_packing_parms());
+  }
+
+  Shape shape{batch_size, element_count};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  std::shared_ptr<Function> f;
+  if (bounded) {
+    auto bounded_relu_op = std::make_shared<op::BoundedRelu>(a, bound_value);
+    f = std::make_shared<Function>(bounded_relu_op, ParameterVector{a});
+  } else {
+    auto relu_op = std::make_shared<op::Relu>(a);
+    f = std::make_shared<Function>(relu_op, ParameterVector{a});
+  }
+
+  bool packed = batch_size > 1;
+
+  std::string tensor_config{"client_input,encrypt"};
+  if (packed) {
+    tensor_config.append(",packed");
+  }
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), tensor_config}}, error_str);
+
+  auto relu = [](double d) { return d > 0 ? d : 0.; };
+  auto bounded_relu = [bound_value](double d) {
+    return d > bound_value ? bound_value : (d > 0) ? d : 0.;
+  };
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_packed_cipher_tensor(element::f32, shape);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>(shape_size(shape), dummy_float));
+
+  std::vector<float> inputs(shape_size(shape));
+  std::vector<float> exp_results(shape_size(shape));
+  for (size_t i = 0; i < shape_size(shape); ++i) {
+    inputs[i] =
+        static_cast<float>(i) - static_cast<float>(shape_size(shape)) / 2.0;
+    if (inputs[i] > 1000) {
+      inputs[i] = fmod(inputs[i], 1000);
+    }
+
+    if (bounded) {
+      exp_results[i] = bounded_relu(inputs[i]);
+    } else {
+      exp_results[i] = relu(inputs[i]);
+    }
+  }
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, exp_results));
+};
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_1_complex) {
+  server_client_relu_packed_test(10, 1, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_1) {
+  server_client_relu_packed_test(10, 1, false, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_2_complex) {
+  server_client_relu_packed_test(10, 2, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_2) {
+  server_client_relu_packed_test(10, 2, false, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_3_complex) {
+  server_client_relu_packed_test(10, 3, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_3) {
+  server_client_relu_packed_test(10, 3, false, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_all_slots_complex) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t slot_count = he_backend->get_ckks_encoder()->slot_count() * 2;
+  server_client_relu_packed_test(10, slot_count, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_all_slots) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t slot_count = he_backend->get_ckks_encoder()->slot_count();
+  server_client_relu_packed_test(10, slot_count, false, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_1_complex) {
+  server_client_relu_packed_test(10, 1, true, true, 1.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_1) {
+  server_client_relu_packed_test(10, 1, false, true, 2.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_2_complex) {
+  server_client_relu_packed_test(10, 2, true, true, 3.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_2) {
+  server_client_relu_packed_test(10, 2, false, true, 4.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_3_complex) {
+  server_client_relu_packed_test(10, 3, true, true, 5.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_3) {
+  server_client_relu_packed_test(10, 3, false, true, 6.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME},
+            server_client_bounded_relu_packed_all_slots_complex) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t slot_count = he_backend->get_ckks_encoder()->slot_count() * 2;
+  server_client_relu_packed_test(10, slot_count, true, true, 7.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_all_slots) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t slot_count = he_backend->get_ckks_encoder()->slot_count();
+  server_client_relu_packed_test(10, slot_count, false, true, 8.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_845) {
+  server_client_relu_packed_test(845, 1, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_1000) {
+  server_client_relu_packed_test(1000, 1, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_packed_50000) {
+  server_client_relu_packed_test(50000, 1, true, false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_845) {
+  server_client_relu_packed_test(845, 1, true, true, 6.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_1000) {
+  server_client_relu_packed_test(1000, 1, true, true, 6.0);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_bounded_relu_packed_50000) {
+  server_client_relu_packed_test(50000, 1, true, true, 6.0);
+}
+
+auto server_client_maxpool_test = [](const Shape& shape,
+                                     const Shape& window_shape,
+                                     const std::vector<float>& input,
+                                     const std::vector<float>& output,
+                                     const bool arg1_encrypted,
+                                     const bool complex_packing,
+                                     const bool packed) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  if (complex_packing) {
+    he_backend->update_encryption_parameters(
+        HESealEncryptionParameters::default_complex_packing_parms());
+  }
+
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::MaxPool>(a, window_shape);
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string tensor_config{"client_input,encrypt"};
+  if (packed) {
+    tensor_config.append(",packed");
+  }
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), tensor_config}}, error_str);
+
+  // Server inputs which are not used
+  auto t_dummy =
+      test::tensor_from_flags(*he_backend, shape, arg1_encrypted, packed);
+  auto t_result = test::tensor_from_flags(*he_backend, t->get_shape(),
+                                          arg1_encrypted, packed);
+  size_t batch_size =
+      std::static_pointer_cast<HETensor>(t_dummy)->get_batch_size();
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>(shape_size(shape), dummy_float));
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    auto he_client = HESealClient(
+        "localhost", 34000, batch_size,
+        HETensorConfigMap<float>{{a->get_name(), make_pair("encrypt", input)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, output));
+};
+
+NGRAPH_TEST(${BACKEND_NAME},
+            server_client_max_pool_1d_1channel_1image_encrypted_real_unpacked) {
+  server_client_maxpool_test(
+      Shape{1, 1, 14}, Shape{3},
+      std::vector<float>{0, 1, 0, 2, 1, 0, 3, 2, 0, 0, 2, 0, 0, 0},
+      std::vector<float>{1, 2, 2, 2, 3, 3, 3, 2, 2, 2, 2, 0}, true, false,
+      false);
+}
+
+NGRAPH_TEST(${BACKEND_NAME},
+            server_client_max_pool_1d_1channel_2image_encrypted_real_packed) {
   server_client_maxpool_test(
       Shape{2, 1, 14}, Shape{3},
       ngraph::test::NDArray<float, 3>(
@@ -851,84 +2022,383 @@ NGRAPH_TEST(${BACKEND_NAME},
       true, false, true);
 }
 
-NGRAPH_TEST(${BACKEND_NAME},
-            server_client_max_pool_2d_2channel_2image_encrypted_real_packed) {
-  server_client_maxpool_test(
-      Shape{2, 2, 5, 5}, Shape{2, 3},
-      ngraph::test::NDArray<float, 4>({{{{0, 1, 0, 2, 1},  // img 0 chan 0
-                                         {0, 3, 2, 0, 0},
-                                         {2, 0, 0, 0, 1},
-                                         {2, 0, 1, 1, 2},
-                                         {0, 2, 1, 0, 0}},
-                                        {{0, 0, 0, 2, 0},  // img 0 chan 1
-                                         {0, 2, 3, 0, 1},
-                                         {2, 0, 1, 0, 2},
-                                         {3, 1, 0, 0, 0},
-                                         {2, 0, 0, 0, 0}}},
-                                       {{{0, 2, 1, 1, 0},  // img 1 chan 0
-                                         {0, 0, 2, 0, 1},
-                                         {0, 0, 1, 2, 3},
-                                         {2, 0, 0, 3, 0},
-                                         {0, 0, 0, 0, 0}},
-                                        {{2, 1, 0, 0, 1},  // img 1 chan 1
-                                         {0, 2, 0, 0, 0},
-                                         {1, 1, 2, 0, 2},
-                                         {1, 1, 1, 0, 1},
-                                         {1, 0, 0, 0, 2}}}})
-          .get_vector(),
-      ngraph::test::NDArray<float, 4>({{{{3, 3, 2},  // img 0 chan 0
-                                         {3, 3, 2},
-                                         {2, 1, 2},
-                                         {2, 2, 2}},
-                                        {{3, 3, 3},  // img 0 chan 1
-                                         {3, 3, 3},
-                                         {3, 1, 2},
-                                         {3, 1, 0}}},
-                                       {{{2, 2, 2},  // img 1 chan 0
-                                         {2, 2, 3},
-                                         {2, 3, 3},
-                                         {2, 3, 3}},
-                                        {{2, 2, 1},  // img 1 chan 1
-                                         {2, 2, 2},
-                                         {2, 2, 2},
-                                         {1, 1, 2}}}})
-          .get_vector(),
-      true, false, true);
+NGRAPH_TEST(${BACKEND_NAME},
+            server_client_max_pool_2d_2channel_2image_encrypted_real_packed) {
+  server_client_maxpool_test(
+      Shape{2, 2, 5, 5}, Shape{2, 3},
+      ngraph::test::NDArray<float, 4>({{{{0, 1, 0, 2, 1},  // img 0 chan 0
+                                         {0, 3, 2, 0, 0},
+                                         {2, 0, 0, 0, 1},
+                                         {2, 0, 1, 1, 2},
+                                         {0, 2, 1, 0, 0}},
+                                        {{0, 0, 0, 2, 0},  // img 0 chan 1
+                                         {0, 2, 3, 0, 1},
+                                         {2, 0, 1, 0, 2},
+                                         {3, 1, 0, 0, 0},
+                                         {2, 0, 0, 0, 0}}},
+                                       {{{0, 2, 1, 1, 0},  // img 1 chan 0
+                                         {0, 0, 2, 0, 1},
+                                         {0, 0, 1, 2, 3},
+                                         {2, 0, 0, 3, 0},
+                                         {0, 0, 0, 0, 0}},
+                                        {{2, 1, 0, 0, 1},  // img 1 chan 1
+                                         {0, 2, 0, 0, 0},
+                                         {1, 1, 2, 0, 2},
+                                         {1, 1, 1, 0, 1},
+                                         {1, 0, 0, 0, 2}}}})
+          .get_vector(),
+      ngraph::test::NDArray<float, 4>({{{{3, 3, 2},  // img 0 chan 0
+                                         {3, 3, 2},
+                                         {2, 1, 2},
+                                         {2, 2, 2}},
+                                        {{3, 3, 3},  // img 0 chan 1
+                                         {3, 3, 3},
+                                         {3, 1, 2},
+                                         {3, 1, 0}}},
+                                       {{{2, 2, 2},  // img 1 chan 0
+                                         {2, 2, 3},
+                                         {2, 3, 3},
+                                         {2, 3, 3}},
+                                        {{2, 2, 1},  // img 1 chan 1
+                                         {2, 2, 2},
+                                         {2, 2, 2},
+                                         {1, 1, 2}}}})
+          .get_vector(),
+      true, false, true);
+}
+
+NGRAPH_TEST(${BACKEND_NAME},
+            server_client_pad_max_pool_1d_1channel_1image_plain) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t batch_size = 1;
+
+  Shape shape_a{1, 1, 12};
+  Shape window_shape{3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
+  auto b = op::Constant::create(element::f32, Shape{}, std::vector<float>({0}));
+  CoordinateDiff padding_below{0, 0, 1};
+  CoordinateDiff padding_above{0, 0, 1};
+  auto c = std::make_shared<op::Pad>(a, b, padding_below, padding_above);
+  Shape shape_r{1, 1, 12};
+  auto f = std::make_shared<Function>(
+      std::make_shared<op::MaxPool>(c, window_shape), ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape_a);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape_r);
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>(shape_size(shape_a), dummy_float));
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -1, 2, 1, 0, 3, 2, 0, 0, 2, 0, 0};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(
+      results,
+      ngraph::test::NDArray<float, 3>({{{0, 2, 2, 2, 3, 3, 3, 2, 2, 2, 2, 0}}})
+          .get_vector(),
+      1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_max_encrypted_packed) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  size_t batch_size = 2;
+
+  Shape shape{batch_size, 3};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Max>(a, AxisSet{1});
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {a->get_name(), "client_input,encrypt,packed"}},
+                         error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_packed_plain_tensor(element::f32, shape);
+  auto t_result =
+      he_backend->create_packed_cipher_tensor(element::f32, t->get_shape());
+
+  // Used for dummy server inputs
+  float dummy_float = 99;
+  copy_data(t_dummy, std::vector<float>(shape_size(shape), dummy_float));
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, 5, 2, -1, 0, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{5, 3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_model_parallel_stages) {
+  size_t batch_size = 1;
+  Shape shape{batch_size, 3};
+  // Each server compiles its own copy of the same function
+  auto make_function = [&](std::shared_ptr<op::Parameter>& x) {
+    x = std::make_shared<op::Parameter>(element::f32, shape);
+    auto a = op::Constant::create(element::f32, shape, {2, 3, 4});
+    auto b = op::Constant::create(element::f32, shape, {1, 1, 1});
+    std::shared_ptr<Node> t = std::make_shared<op::Multiply>(x, a);
+    t = std::make_shared<op::Add>(t, b);
+    t = std::make_shared<op::Multiply>(t, t);
+    t = std::make_shared<op::Add>(t, b);
+    return std::make_shared<Function>(t, ParameterVector{x});
+  };
+
+  auto worker_backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto worker_he_backend = static_cast<HESealBackend*>(worker_backend.get());
+  std::shared_ptr<op::Parameter> worker_x;
+  auto worker_f = make_function(worker_x);
+  std::string error_str;
+  worker_he_backend->set_config(
+      {{"enable_client", "true"},
+       {"port", "35101"},
+       {worker_x->get_name(), "client_input,encrypt"}},
+      error_str);
+  auto worker_handle = std::static_pointer_cast<HESealExecutable>(
+      worker_he_backend->compile(worker_f));
+  auto worker_thread = std::thread([&]() { worker_handle->serve_stages(); });
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::shared_ptr<op::Parameter> x;
+  auto f = make_function(x);
+  he_backend->set_config({{"enable_client", "true"},
+                          {"model_parallel_stages", "localhost:35101"},
+                          {x->get_name(), "client_input,encrypt"}},
+                         error_str);
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, 2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {x->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  worker_thread.join();
+  EXPECT_TRUE(
+      test::all_close(results, std::vector<float>{10, 50, 170}, 1e-1f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_data_parallel_workers) {
+  size_t batch_size = 1;
+  Shape shape{batch_size, 4};
+  // Each server compiles its own copy of the same function
+  auto make_function = [&](std::shared_ptr<op::Parameter>& x) {
+    x = std::make_shared<op::Parameter>(element::f32, shape);
+    auto a = op::Constant::create(element::f32, shape, {2, 3, 4, 5});
+    auto b = op::Constant::create(element::f32, shape, {1, 1, 1, 1});
+    std::shared_ptr<Node> t = std::make_shared<op::Multiply>(x, a);
+    t = std::make_shared<op::Add>(t, b);
+    t = std::make_shared<op::Multiply>(t, t);
+    return std::make_shared<Function>(t, ParameterVector{x});
+  };
+
+  std::string error_str;
+  std::vector<std::shared_ptr<runtime::Backend>> worker_backends;
+  std::vector<std::shared_ptr<HESealExecutable>> worker_handles;
+  std::vector<std::thread> worker_threads;
+  for (const std::string port : {"35102", "35103"}) {
+    worker_backends.emplace_back(runtime::Backend::create("${BACKEND_NAME}"));
+    auto worker_he_backend =
+        static_cast<HESealBackend*>(worker_backends.back().get());
+    std::shared_ptr<op::Parameter> worker_x;
+    auto worker_f = make_function(worker_x);
+    worker_he_backend->set_config(
+        {{"enable_client", "true"},
+         {"port", port},
+         {worker_x->get_name(), "client_input,encrypt"}},
+        error_str);
+    worker_handles.emplace_back(std::static_pointer_cast<HESealExecutable>(
+        worker_he_backend->compile(worker_f)));
+    auto worker_handle = worker_handles.back();
+    worker_threads.emplace_back(
+        [worker_handle]() { worker_handle->serve_stages(); });
+  }
+
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  std::shared_ptr<op::Parameter> x;
+  auto f = make_function(x);
+  he_backend->set_config(
+      {{"enable_client", "true"},
+       {"data_parallel_workers", "localhost:35102,localhost:35103"},
+       {x->get_name(), "client_input,encrypt"}},
+      error_str);
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{1, 2, 3, 4};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {x->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  for (auto& worker_thread : worker_threads) {
+    worker_thread.join();
+  }
+  EXPECT_TRUE(
+      test::all_close(results, std::vector<float>{9, 49, 169, 441}, 1e-1f));
 }
 
-NGRAPH_TEST(${BACKEND_NAME},
-            server_client_pad_max_pool_1d_1channel_1image_plain) {
+NGRAPH_TEST(${BACKEND_NAME}, server_client_persistent_session) {
   auto backend = runtime::Backend::create("${BACKEND_NAME}");
   auto he_backend = static_cast<HESealBackend*>(backend.get());
+
   size_t batch_size = 1;
 
-  Shape shape_a{1, 1, 12};
-  Shape window_shape{3};
-  auto a = std::make_shared<op::Parameter>(element::f32, shape_a);
-  auto b = op::Constant::create(element::f32, Shape{}, std::vector<float>({0}));
-  CoordinateDiff padding_below{0, 0, 1};
-  CoordinateDiff padding_above{0, 0, 1};
-  auto c = std::make_shared<op::Pad>(a, b, padding_below, padding_above);
-  Shape shape_r{1, 1, 12};
-  auto f = std::make_shared<Function>(
-      std::make_shared<op::MaxPool>(c, window_shape), ParameterVector{a});
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
 
   std::string error_str;
-  he_backend->set_config(
-      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
-      error_str);
+  he_backend->set_config({{"enable_client", "true"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
 
-  // Server inputs which are not used
-  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape_a);
-  auto t_result = he_backend->create_cipher_tensor(element::f32, shape_r);
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
 
-  // Used for dummy server inputs
-  float dummy_float = 99;
-  copy_data(t_dummy, std::vector<float>(shape_size(shape_a), dummy_float));
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
 
+  // One persistent client serves two calls with the same keys
+  setenv("NGRAPH_HE_CLIENT_PERSISTENT", "1", 1);
+  std::vector<float> results;
+  std::vector<float> next_results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+
+    std::vector<float> next_inputs{1, 2, -3};
+    HEInputView view{"encrypt", element::f32, next_inputs.data(),
+                     next_inputs.size()};
+    double_results = he_client.infer({{b->get_name(), view}});
+    next_results =
+        std::vector<float>(double_results.begin(), double_results.end());
+    he_client.close_connection();
+  });
+
+  handle->call_with_validate({t_result}, {t_dummy});
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  unsetenv("NGRAPH_HE_CLIENT_PERSISTENT");
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+  EXPECT_TRUE(
+      test::all_close(next_results, std::vector<float>{1.1, 2.2, 0}, 1e-3f));
+
+  // Once the client ends its session, the next call serves a new client
+  client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_streams_out_of_order) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 8};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto relu = std::make_shared<op::Relu>(a);
+  auto f = std::make_shared<Function>(relu, ParameterVector{a});
+
+  // One ciphertext per relu request, all in flight at once, so the client
+  // workers answer them in any order
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"relu_chunk_bytes", "1"},
+                          {"relu_window", "8"},
+                          {a->get_name(), "client_input,encrypt"}},
+                         error_str);
+  setenv("NGRAPH_HE_CLIENT_WORKERS", "4", 1);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>(8, 99));
+
+  std::vector<float> inputs{-4, 3, -2, 1, 0.5, -0.5, 7, -7};
   std::vector<float> results;
   auto client_thread = std::thread([&]() {
-    std::vector<float> inputs{-1, -1, 2, 1, 0, 3, 2, 0, 0, 2, 0, 0};
     auto he_client =
         HESealClient("localhost", 34000, batch_size,
                      HETensorConfigMap<float>{
@@ -940,15 +2410,248 @@ NGRAPH_TEST(${BACKEND_NAME},
 
   auto handle =
       std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
-
   handle->call_with_validate({t_result}, {t_dummy});
 
   client_thread.join();
+  unsetenv("NGRAPH_HE_CLIENT_WORKERS");
   EXPECT_TRUE(test::all_close(
-      results,
-      ngraph::test::NDArray<float, 3>({{{0, 2, 2, 2, 3, 3, 3, 2, 2, 2, 2, 0}}})
-          .get_vector(),
-      1e-3f));
+      results, std::vector<float>{0, 3, 0, 1, 0.5, 0, 7, 0}, 1e-3f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_cached_input) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto a = op::Constant::create(element::f32, shape, {0.1, 0.2, 0.3});
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto t = std::make_shared<op::Add>(a, b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {"input_cache_mb", "64"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  // Cached inputs are scoped by the client keys, so both clients share them
+  std::string key_file = "server_client_cached_input.bin";
+  std::remove(key_file.c_str());
+  setenv("NGRAPH_HE_CLIENT_KEY_FILE", key_file.c_str(), 1);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The first client uploads its input after a cache miss; the second
+  // refers to the cached input without encrypting it
+  for (size_t client_idx = 0; client_idx < 2; ++client_idx) {
+    std::vector<float> results;
+    size_t encrypt_phases = 0;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{-1, -0.2, 3};
+      auto he_client = HESealClient(
+          "localhost", 34000, batch_size,
+          HETensorConfigMap<float>{
+              {b->get_name(), make_pair("encrypt,cached", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+      encrypt_phases = he_client.stats().phases().count("input_encrypt");
+    });
+
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-3f));
+    EXPECT_EQ(encrypt_phases, client_idx == 0 ? 1 : 0);
+  }
+  unsetenv("NGRAPH_HE_CLIENT_KEY_FILE");
+  std::remove(key_file.c_str());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_cached_input_modified_by_kernels) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 3};
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto w = op::Constant::create(element::f32, shape, {2, 3, 4});
+  // The Add switches the modulus of b to that of the rescaled product, and
+  // the Relu sends the sum to the client
+  auto t = std::make_shared<op::Add>(std::make_shared<op::Multiply>(b, w), b);
+  auto relu = std::make_shared<op::Relu>(t);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config({{"enable_client", "true"},
+                          {"max_clients", "2"},
+                          {"input_cache_mb", "64"},
+                          {b->get_name(), "client_input,encrypt"}},
+                         error_str);
+
+  std::string key_file = "server_client_cached_input_modified.bin";
+  std::remove(key_file.c_str());
+  setenv("NGRAPH_HE_CLIENT_KEY_FILE", key_file.c_str(), 1);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, shape);
+  copy_data(t_dummy, std::vector<float>{99, 99, 99});
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  // The second call computes on the cached input again, which the first
+  // call must have left at its uploaded level
+  for (size_t client_idx = 0; client_idx < 2; ++client_idx) {
+    std::vector<float> results;
+    size_t encrypt_phases = 0;
+    auto client_thread = std::thread([&]() {
+      std::vector<float> inputs{-1, 0.5, 2};
+      auto he_client = HESealClient(
+          "localhost", 34000, batch_size,
+          HETensorConfigMap<float>{
+              {b->get_name(), make_pair("encrypt,cached", inputs)}});
+
+      auto double_results = he_client.get_results();
+      results =
+          std::vector<float>(double_results.begin(), double_results.end());
+      encrypt_phases = he_client.stats().phases().count("input_encrypt");
+    });
+
+    handle->call_with_validate({t_result}, {t_dummy});
+
+    client_thread.join();
+    EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 2, 10}, 1e-3f));
+    EXPECT_EQ(encrypt_phases, client_idx == 0 ? 1 : 0);
+  }
+  unsetenv("NGRAPH_HE_CLIENT_KEY_FILE");
+  std::remove(key_file.c_str());
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_relu_max_pool_one_request) {
+  auto backend = runtime::Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  Shape shape{1, 1, 6};
+  auto a = std::make_shared<op::Parameter>(element::f32, shape);
+  auto relu = std::make_shared<op::Relu>(a);
+  auto t = std::make_shared<op::MaxPool>(relu, Shape{2}, Strides{2});
+  auto f = std::make_shared<Function>(t, ParameterVector{a});
+
+  std::string error_str;
+  he_backend->set_config(
+      {{"enable_client", "true"}, {a->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result =
+      he_backend->create_cipher_tensor(element::f32, t->get_shape());
+  copy_data(t_dummy, std::vector<float>(shape_size(shape), 99));
+
+  std::vector<float> results;
+  std::map<std::string, HEClientPhaseStats> phases;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -2, 3, -1, 0.5, 2};
+    auto he_client =
+        HESealClient("localhost", 34000, 1,
+                     HETensorConfigMap<float>{
+                         {a->get_name(), make_pair("encrypt", inputs)}});
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+    phases = he_client.stats().phases();
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+  handle->call_with_validate({t_result}, {t_dummy});
+  client_thread.join();
+
+  // The MaxPool request applies the Relu, so the client never computes a
+  // separate Relu
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 3, 2}));
+  EXPECT_EQ(phases.count("relu"), 0);
+  EXPECT_EQ(phases.count("max_pool"), 1);
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, client_offline_relu_request) {
+  // Stores the messages of the client, which is not connected to a server
+  class MessageSink : public ClientTransport {
+   public:
+    explicit MessageSink(std::vector<TCPMessage>& messages)
+        : m_messages(messages) {}
+    void write_message(TCPMessage&& message) override {
+      m_messages.emplace_back(std::move(message));
+    }
+    void close() override {}
+
+   private:
+    std::vector<TCPMessage>& m_messages;
+  };
+
+  std::vector<double> inputs{-1, 2, -3, 0.5};
+  std::vector<TCPMessage> messages;
+  HESealClient client(
+      HESealEncryptionParameters::default_real_packing_parms(), 1,
+      HEInputViewMap{{"x", HEInputView{"encrypt", element::f64, inputs.data(),
+                                       inputs.size()}}},
+      std::make_unique<MessageSink>(messages));
+
+  HETensor tensor(element::f64, Shape{1, inputs.size()}, false,
+                  client.complex_packing(), true, *client.get_ckks_encoder(),
+                  client.get_context(), *client.get_encryptor(),
+                  *client.get_decryptor(), client.encryption_paramters(), "x");
+  tensor.write(inputs.data(), inputs.size() * sizeof(double));
+
+  pb::TCPMessage pb_request;
+  pb_request.set_type(pb::TCPMessage_Type_REQUEST);
+  pb_request.mutable_op_request()->set_op(pb::OpRequest_Op_RELU);
+  pb_request.mutable_op_request()->set_chain_index(
+      client.get_context()->first_context_data()->chain_index());
+  *pb_request.add_he_tensors() = tensor.write_to_pb_tensors()[0];
+  TCPMessage response =
+      client.handle_relu_request(TCPMessage(std::move(pb_request)));
+
+  // Responses are returned to the caller, not written
+  EXPECT_TRUE(messages.empty());
+  std::vector<char> payload;
+  for (const auto& segment : response.segments()) {
+    const auto* data = static_cast<const char*>(segment.data);
+    payload.insert(payload.end(), data, data + segment.size);
+  }
+  auto result = HETensor::load_from_pb_tensor(
+      response.pb_message()->he_tensors(0), *client.get_ckks_encoder(),
+      client.get_context(), *client.get_encryptor(), *client.get_decryptor(),
+      client.encryption_paramters(), payload.data(), payload.size());
+  std::vector<double> results(inputs.size());
+  result->read(results.data(), results.size() * sizeof(double),
+               element::f64);
+  EXPECT_TRUE(test::all_close(results, std::vector<double>{0, 2, 0, 0.5},
+                              1e-3, 1e-3));
+  EXPECT_EQ(client.stats().phases().count("relu"), 1);
+
+  // Inputs requested by an inference request are written to the transport
+  pb::TCPMessage pb_inference;
+  pb_inference.set_type(pb::TCPMessage_Type_REQUEST);
+  pb_inference.mutable_function()->set_function(
+      R"({"function": "Parameter"})");
+  pb::HETensor* pb_tensor = pb_inference.add_he_tensors();
+  pb_tensor->set_name("x");
+  pb_tensor->add_shape(1);
+  pb_tensor->add_shape(inputs.size());
+  client.handle_inference_request(pb_inference);
+  EXPECT_FALSE(messages.empty());
+  EXPECT_EQ(client.stats().messages_sent(), messages.size());
 }
 
 }  // namespace ngraph::runtime::he
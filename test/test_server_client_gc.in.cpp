@@ -164,6 +164,107 @@ NGRAPH_TEST(${BACKEND_NAME}, server_client_gc_add_3_relu) {
   EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 0, 3.3}, 1e-1f));
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, server_client_gc_relu_max_pool) {
+  auto backend = Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 1, 4};
+  Shape result_shape{batch_size, 1, 3};
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto relu = std::make_shared<op::Relu>(b);
+  auto max_pool = std::make_shared<op::MaxPool>(relu, Shape{2});
+  auto f = std::make_shared<Function>(max_pool, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config(
+      std::map<std::string, std::string>{
+          {"enable_client", "true"},
+          {"enable_gc", "true"},
+          {"encryption_parameters", gc_param_real_str},
+          {"mask_gc_inputs", "true"},
+          {"mask_gc_outputs", "true"},
+          {b->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{-1, -0.2, 3, -4};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{0, 3, 3}, 1e-1f));
+}
+
+NGRAPH_TEST(${BACKEND_NAME}, server_client_gc_hybrid_dot_relu) {
+  auto backend = Backend::create("${BACKEND_NAME}");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+
+  size_t batch_size = 1;
+
+  Shape shape{batch_size, 2};
+  Shape result_shape{batch_size, 3};
+  auto b = std::make_shared<op::Parameter>(element::f32, shape);
+  auto weights = op::Constant::create(element::f32, Shape{2, 3},
+                                      {1, -1, 2, 0.5, 1, -3});
+  auto dot = std::make_shared<op::Dot>(b, weights);
+  auto relu = std::make_shared<op::Relu>(dot);
+  auto f = std::make_shared<Function>(relu, ParameterVector{b});
+
+  std::string error_str;
+  he_backend->set_config(
+      std::map<std::string, std::string>{
+          {"enable_client", "true"},
+          {"enable_gc", "true"},
+          {"hybrid_linear_layers", "true"},
+          {"encryption_parameters", gc_param_real_str},
+          {"mask_gc_inputs", "true"},
+          {"mask_gc_outputs", "true"},
+          {b->get_name(), "client_input,encrypt"}},
+      error_str);
+
+  // Server inputs which are not used
+  auto t_dummy = he_backend->create_plain_tensor(element::f32, shape);
+  auto t_result = he_backend->create_cipher_tensor(element::f32, result_shape);
+
+  std::vector<float> results;
+  auto client_thread = std::thread([&]() {
+    std::vector<float> inputs{2, -1};
+    auto he_client =
+        HESealClient("localhost", 34000, batch_size,
+                     HETensorConfigMap<float>{
+                         {b->get_name(), make_pair("encrypt", inputs)}});
+
+    auto double_results = he_client.get_results();
+    results = std::vector<float>(double_results.begin(), double_results.end());
+  });
+
+  auto handle =
+      std::static_pointer_cast<HESealExecutable>(he_backend->compile(f));
+
+  handle->call_with_validate({t_result}, {t_dummy});
+
+  client_thread.join();
+  EXPECT_TRUE(test::all_close(results, std::vector<float>{1.5, 0, 7}, 1e-1f));
+}
+
 auto server_client_gc_relu_packed_test = [](size_t element_count,
                                             size_t batch_size,
                                             bool complex_packing,
@@ -0,0 +1,130 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/asio.hpp"
+#include "gtest/gtest.h"
+#include "protos/message.pb.h"
+#include "tcp/shm_transport.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(shm_transport, single_client) {
+  std::string name = shm_transport_name(34100);
+  auto server = ShmChannel::create(name, 64);
+  EXPECT_FALSE(server->client_attached());
+
+  auto client = ShmChannel::attach(name);
+  ASSERT_NE(client, nullptr);
+  EXPECT_TRUE(server->client_attached());
+  EXPECT_EQ(ShmChannel::attach(name), nullptr);
+}
+
+TEST(shm_transport, ring_wraps_around) {
+  std::string name = shm_transport_name(34101);
+  auto server = ShmChannel::create(name, 64);
+  auto client = ShmChannel::attach(name);
+  ASSERT_NE(client, nullptr);
+
+  std::vector<char> sent(1000);
+  std::iota(sent.begin(), sent.end(), 0);
+  std::thread writer([&]() { EXPECT_TRUE(server->write(sent.data(), 1000)); });
+  std::vector<char> received(1000);
+  EXPECT_TRUE(client->read(received.data(), 1000));
+  writer.join();
+  EXPECT_EQ(sent, received);
+
+  // Bytes written before the channel is closed are still read
+  char value = 7;
+  EXPECT_TRUE(client->write(&value, 1));
+  client->close();
+  EXPECT_FALSE(client->write(&value, 1));
+  char read_value = 0;
+  EXPECT_TRUE(server->read(&read_value, 1));
+  EXPECT_EQ(read_value, value);
+  EXPECT_FALSE(server->read(&read_value, 1));
+}
+
+TEST(shm_transport, session_and_client) {
+  std::string name = shm_transport_name(34102);
+  size_t message_count{100};
+  std::vector<double> payload(1000);
+  std::iota(payload.begin(), payload.end(), 0);
+
+  boost::asio::io_context server_context;
+  size_t server_received{0};
+  std::shared_ptr<ShmSession> session;
+  auto server_callback = [&](const TCPMessage& message) {
+    ASSERT_EQ(message.payload_size(), payload.size() * sizeof(double));
+    const auto* values = reinterpret_cast<const double*>(message.payload());
+    EXPECT_TRUE(std::equal(payload.begin(), payload.end(), values));
+    server_received++;
+  };
+  auto channel = ShmChannel::create(name);
+
+  std::thread client_thread([&]() {
+    boost::asio::io_context client_context;
+    size_t client_received{0};
+    std::unique_ptr<ShmClient> client;
+    // Echoes each message with its payload, and closes after the last
+    auto client_callback = [&](const TCPMessage& message) {
+      auto echoed = std::make_shared<std::vector<char>>(
+          message.payload(), message.payload() + message.payload_size());
+      TCPMessage::Segments segments{{echoed->data(), echoed->size(), echoed}};
+      client->write_message(
+          TCPMessage(pb::TCPMessage(*message.pb_message()),
+                     std::move(segments)));
+      if (++client_received == message_count) {
+        client->close();
+      }
+    };
+    client =
+        std::make_unique<ShmClient>(client_context, name, client_callback);
+    client_context.run();
+  });
+
+  while (!channel->client_attached()) {
+    std::this_thread::yield();
+  }
+  session = std::make_shared<ShmSession>(server_context, std::move(channel),
+                                         server_callback);
+  session->start();
+  for (size_t i = 0; i < message_count; ++i) {
+    pb::TCPMessage pb_message;
+    pb_message.set_type(pb::TCPMessage_Type_REQUEST);
+    TCPMessage::Segments segments{
+        {payload.data(), payload.size() * sizeof(double), nullptr}};
+    session->write_message(
+        TCPMessage(std::move(pb_message), std::move(segments)));
+  }
+  session->wait_until_written();
+  // Runs until the client closes the channel
+  server_context.run();
+  client_thread.join();
+
+  EXPECT_EQ(server_received, message_count);
+  EXPECT_GT(session->bytes_written(), 0U);
+  EXPECT_EQ(session->bytes_written(), session->bytes_read());
+}
+
+}  // namespace ngraph::runtime::he
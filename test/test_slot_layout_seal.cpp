@@ -0,0 +1,103 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ngraph/ngraph.hpp"
+#include "seal/he_seal_backend.hpp"
+#include "seal/kernel/slot_layout_seal.hpp"
+#include "seal/seal.h"
+#include "seal/seal_ciphertext_wrapper.hpp"
+#include "test_util.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(slot_layout_seal, pack_unpack) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto& encoder = *he_backend->get_ckks_encoder();
+
+  std::vector<double> values{0.5, -1, 2, 0, 1.5, -0.25, 3};
+  std::vector<HEType> elements;
+  for (double value : values) {
+    seal::Plaintext plain;
+    encoder.encode(value, he_backend->get_scale(), plain);
+    auto cipher = HESealBackend::create_empty_ciphertext();
+    he_backend->get_encryptor()->encrypt(plain, cipher->ciphertext());
+    elements.emplace_back(cipher, false, 1);
+  }
+
+  SealCiphertextWrapper packed;
+  pack_slots_seal(elements, packed, *he_backend);
+  EXPECT_EQ(he_backend->get_chain_index(packed) + 1,
+            he_backend->get_chain_index(*elements[0].get_ciphertext()));
+  seal::Plaintext decrypted;
+  he_backend->get_decryptor()->decrypt(packed.ciphertext(), decrypted);
+  std::vector<double> slots;
+  encoder.decode(decrypted, slots);
+  for (size_t i = 0; i < slots.size(); ++i) {
+    EXPECT_NEAR(slots[i], i < values.size() ? values[i] : 0, 1e-3);
+  }
+
+  std::vector<size_t> unpack_slots{6, 0, 3, 3};
+  std::vector<HEType> unpacked;
+  unpack_slots_seal(packed, unpack_slots, unpacked, *he_backend);
+  ASSERT_EQ(unpacked.size(), unpack_slots.size());
+  for (size_t i = 0; i < unpacked.size(); ++i) {
+    ASSERT_TRUE(unpacked[i].is_ciphertext());
+    he_backend->get_decryptor()->decrypt(
+        unpacked[i].get_ciphertext()->ciphertext(), decrypted);
+    encoder.decode(decrypted, slots);
+    EXPECT_NEAR(slots[0], values[unpack_slots[i]], 1e-3);
+  }
+
+  // Plaintext elements are not packed
+  elements.emplace_back(HEPlaintext{1.}, false);
+  EXPECT_ANY_THROW(pack_slots_seal(elements, packed, *he_backend));
+}
+
+TEST(slot_layout_seal, replicate) {
+  auto backend = runtime::Backend::create("HE_SEAL");
+  auto he_backend = static_cast<HESealBackend*>(backend.get());
+  auto& encoder = *he_backend->get_ckks_encoder();
+  const size_t slot_count = encoder.slot_count();
+
+  std::vector<double> values{0.5, -1, 2};
+  std::vector<double> padded(slot_count, 0);
+  std::copy(values.begin(), values.end(), padded.begin());
+  seal::Plaintext plain;
+  encoder.encode(padded, he_backend->get_scale(), plain);
+  SealCiphertextWrapper cipher;
+  he_backend->get_encryptor()->encrypt(plain, cipher.ciphertext());
+
+  size_t period = 4;
+  replicate_slots_seal(cipher, period, *he_backend);
+  seal::Plaintext decrypted;
+  he_backend->get_decryptor()->decrypt(cipher.ciphertext(), decrypted);
+  std::vector<double> slots;
+  encoder.decode(decrypted, slots);
+  for (size_t i = 0; i < slots.size(); ++i) {
+    size_t idx = i % period;
+    EXPECT_NEAR(slots[i], idx < values.size() ? values[idx] : 0, 1e-3);
+  }
+
+  EXPECT_ANY_THROW(replicate_slots_seal(cipher, 3, *he_backend));
+}
+
+}  // namespace ngraph::runtime::he
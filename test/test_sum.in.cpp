@@ -174,4 +174,21 @@ NGRAPH_TEST(${BACKEND_NAME}, sum_matrix_to_scalar_zero_by_zero) {
   }
 }
 
+NGRAPH_TEST(${BACKEND_NAME}, sum_long_rows) {
+  // Enough inputs per output to be split into several partial sums
+  std::vector<float> input(3 * 37);
+  std::vector<float> output(3, 0);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>(i % 7) - 3;
+    output[i / 37] += input[i];
+  }
+  for (bool arg1_encrypted : std::vector<bool>{false, true}) {
+    for (bool complex_packing : std::vector<bool>{false, true}) {
+      for (bool packing : std::vector<bool>{false}) {
+        sum_test(Shape{3, 37}, AxisSet{1}, input, output, arg1_encrypted,
+                 complex_packing, packing);
+      }
+    }
+  }
+}
 }  // namespace ngraph::runtime::he
@@ -0,0 +1,107 @@
+//*****************************************************************************
+// Copyright 2018-2020 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//*****************************************************************************
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "protos/message.pb.h"
+#include "tcp/tcp_capture.hpp"
+#include "tcp/tcp_message.hpp"
+
+namespace ngraph::runtime::he {
+
+TEST(tcp_capture, write_load) {
+  std::string filename = "tcp_capture_write_load.bin";
+  std::remove(filename.c_str());
+
+  auto payload = std::make_shared<std::vector<char>>(100, 'x');
+  {
+    TCPCaptureWriter writer(filename);
+
+    // Received messages keep their function, but not their tensors
+    pb::TCPMessage request;
+    request.set_type(pb::TCPMessage_Type_REQUEST);
+    request.mutable_function()->set_function(R"({"function":"Relu"})");
+    request.add_he_tensors()->set_name("relu_input");
+    EXPECT_EQ(writer.record_received(TCPMessage(std::move(request))), 0);
+
+    pb::TCPMessage response;
+    response.set_type(pb::TCPMessage_Type_RESPONSE);
+    response.add_he_tensors()->set_name("relu_output");
+    TCPMessage::Segments segments{
+        {payload->data(), 60, payload},
+        {payload->data() + 60, 40, payload}};
+    writer.record_sent(TCPMessage(std::move(response), std::move(segments)),
+                       0);
+
+    pb::TCPMessage result;
+    result.set_type(pb::TCPMessage_Type_RESPONSE);
+    EXPECT_EQ(writer.record_received(TCPMessage(std::move(result))), 1);
+  }
+
+  auto messages = load_capture(filename);
+  ASSERT_EQ(messages.size(), 3);
+
+  EXPECT_FALSE(messages[0].sent);
+  EXPECT_EQ(messages[0].trigger, 0);
+  EXPECT_EQ(messages[0].message.pb_message()->function().function(),
+            R"({"function":"Relu"})");
+  EXPECT_EQ(messages[0].message.pb_message()->he_tensors_size(), 0);
+
+  EXPECT_TRUE(messages[1].sent);
+  EXPECT_EQ(messages[1].trigger, 0);
+  EXPECT_GE(messages[1].time_us, messages[0].time_us);
+  ASSERT_EQ(messages[1].message.pb_message()->he_tensors_size(), 1);
+  EXPECT_EQ(messages[1].message.pb_message()->he_tensors(0).name(),
+            "relu_output");
+  ASSERT_EQ(messages[1].message.segments_size(), 100);
+  const auto& segment = messages[1].message.segments()[0];
+  EXPECT_EQ(std::memcmp(segment.data, payload->data(), 100), 0);
+
+  EXPECT_FALSE(messages[2].sent);
+  EXPECT_EQ(messages[2].trigger, 1);
+  std::remove(filename.c_str());
+}
+
+TEST(tcp_capture, load_truncated) {
+  std::string filename = "tcp_capture_load_truncated.bin";
+  {
+    TCPCaptureWriter writer(filename);
+    pb::TCPMessage result;
+    result.set_type(pb::TCPMessage_Type_RESPONSE);
+    writer.record_received(TCPMessage(std::move(result)));
+  }
+  // Drops the last byte of the record
+  {
+    std::ifstream in(filename, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+    contents.pop_back();
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out << contents;
+  }
+  EXPECT_ANY_THROW(load_capture(filename));
+  EXPECT_ANY_THROW(load_capture("tcp_capture_missing.bin"));
+  std::remove(filename.c_str());
+}
+
+}  // namespace ngraph::runtime::he
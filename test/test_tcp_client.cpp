@@ -44,7 +44,8 @@ auto dummy_tcp_message = []() {
 
 class MockServer {
  public:
-  MockServer(size_t port, size_t message_cnt) {
+  MockServer(size_t port, size_t message_cnt, size_t max_pending_bytes = 0,
+             bool urgent = false) {
     boost::asio::ip::tcp::resolver resolver(m_io_context);
     boost::asio::ip::tcp::endpoint server_endpoints(boost::asio::ip::tcp::v4(),
                                                     port);
@@ -84,9 +85,16 @@ class MockServer {
     std::unique_lock<std::mutex> mlock(m_session_mutex);
     NGRAPH_HE_LOG(3) << "waiting thread got mutex";
     m_session_cond.wait(mlock, [this]() { return m_session_started; });
+    if (max_pending_bytes > 0) {
+      m_session->set_max_pending_bytes(max_pending_bytes);
+    }
 
     for (size_t i = 0; i < message_cnt; ++i) {
-      m_session->write_message(dummy_tcp_message());
+      if (urgent && i % 2 == 1) {
+        m_session->write_urgent_message(dummy_tcp_message());
+      } else {
+        m_session->write_message(dummy_tcp_message());
+      }
     }
   }
 
@@ -183,4 +191,32 @@ TEST(tcp_client, non_empty_message_queue) {
   client_thread.join();
 }
 
+TEST(tcp_client, bounded_message_queue) {
+  size_t port{34000};
+  std::string hostname{"localhost"};
+
+  size_t message_count{100};
+
+  auto client_thread = std::thread(
+      [&]() { auto client = MockClient(hostname, port, message_count); });
+
+  // Each message waits for the previous one to be written
+  auto server = MockServer(port, message_count, 1);
+  client_thread.join();
+}
+
+TEST(tcp_client, urgent_message_queue) {
+  size_t port{34000};
+  std::string hostname{"localhost"};
+
+  size_t message_count{100};
+
+  auto client_thread = std::thread(
+      [&]() { auto client = MockClient(hostname, port, message_count); });
+
+  // Urgent messages skip the bounded queue of the other messages
+  auto server = MockServer(port, message_count, 1, true);
+  client_thread.join();
+}
+
 }  // namespace ngraph::runtime::he
@@ -17,9 +17,14 @@
 #include <google/protobuf/util/message_differencer.h>
 
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "he_type.hpp"
 #include "protos/message.pb.h"
 #include "seal/he_seal_backend.hpp"
 #include "seal/seal.h"
@@ -54,6 +59,12 @@ TEST(tcp_message, encode_decode) {
   TCPMessage::encode_header(buffer, encode_size);
   size_t decoded_size = TCPMessage::decode_header(buffer);
   EXPECT_EQ(decoded_size, encode_size);
+  EXPECT_EQ(TCPMessage::decode_payload_size(buffer), 0);
+
+  size_t encode_payload_size = 123;
+  TCPMessage::encode_header(buffer, encode_size, encode_payload_size);
+  EXPECT_EQ(TCPMessage::decode_header(buffer), encode_size);
+  EXPECT_EQ(TCPMessage::decode_payload_size(buffer), encode_payload_size);
 }
 
 TEST(tcp_message, pack_unpack) {
@@ -77,4 +88,161 @@ TEST(tcp_message, pack_unpack) {
       *message1.pb_message(), *message2.pb_message()));
 }
 
+TEST(tcp_message, pack_unpack_arena) {
+  pb::TCPMessage pb_msg;
+  pb_msg.mutable_function()->set_function("123");
+  pb_msg.add_he_tensors()->set_name("tensor");
+  TCPMessage message1(std::move(pb_msg));
+
+  TCPMessage::data_buffer buffer;
+  message1.pack(buffer);
+
+  TCPMessage message2;
+  EXPECT_TRUE(message2.unpack(buffer, true));
+  EXPECT_NE(message2.pb_message()->GetArena(), nullptr);
+  EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(
+      *message1.pb_message(), *message2.pb_message()));
+
+  // The arena outlives the message while its proto is referenced
+  auto pb_message = message2.pb_message();
+  message2 = TCPMessage();
+  EXPECT_EQ(pb_message->he_tensors(0).name(), "tensor");
+
+  // Unpacking without an arena replaces the arena message
+  EXPECT_TRUE(message2.unpack(buffer));
+  EXPECT_EQ(message2.pb_message()->GetArena(), nullptr);
+}
+
+TEST(tcp_message, detach) {
+  pb::TCPMessage pb_msg;
+  pb_msg.mutable_function()->set_function("first");
+  TCPMessage::data_buffer buffer;
+  TCPMessage(std::move(pb_msg)).pack(buffer);
+
+  TCPMessage received;
+  received.unpack(buffer);
+  received.set_payload(std::make_shared<TCPMessage::data_buffer>(4));
+  auto detached = received.detach();
+  EXPECT_NE(detached.pb_message(), received.pb_message());
+  EXPECT_EQ(detached.payload(), received.payload());
+
+  // Unpacking the next message leaves the detached message unchanged
+  pb::TCPMessage next_msg;
+  next_msg.mutable_function()->set_function("second");
+  TCPMessage(std::move(next_msg)).pack(buffer);
+  received.unpack(buffer);
+  EXPECT_EQ(received.pb_message()->function().function(), "second");
+  EXPECT_EQ(detached.pb_message()->function().function(), "first");
+  EXPECT_EQ(detached.payload_size(), 4);
+}
+
+TEST(tcp_message, pack_unpack_payload) {
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {30, 30, 30}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::CKKSEncoder encoder(*context);
+
+  seal::Plaintext plain;
+  encoder.encode(std::vector<double>{1, 2, 3}, std::pow(2.0, 25), plain);
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encryptor.encrypt(plain, cipher->ciphertext());
+
+  HEType he_type(cipher, false, 3);
+  pb::TCPMessage pb_msg;
+  TCPMessage::Segments segments(1);
+  he_type.save(*pb_msg.add_he_tensors()->add_data(), &segments[0]);
+  EXPECT_EQ(segments[0].data, cipher->ciphertext().data());
+  EXPECT_EQ(segments[0].owner, cipher);
+
+  TCPMessage message1(std::move(pb_msg), std::move(segments));
+  EXPECT_EQ(message1.pb_message()->he_tensors(0).data(0).ciphertext().size(),
+            0);
+
+  TCPMessage::data_buffer buffer;
+  message1.pack(buffer);
+  EXPECT_EQ(TCPMessage::decode_payload_size(buffer),
+            message1.segments_size());
+
+  auto payload =
+      std::make_shared<TCPMessage::data_buffer>(message1.segments_size());
+  std::memcpy(payload->data(), message1.segments()[0].data,
+              message1.segments()[0].size);
+
+  TCPMessage message2;
+  message2.unpack(buffer);
+  message2.set_payload(payload);
+  EXPECT_EQ(message2.payload_size(), message1.segments_size());
+
+  auto loaded = HEType::load(message2.pb_message()->he_tensors(0).data(0),
+                             context, message2.payload(),
+                             message2.payload_size());
+  const auto& loaded_cipher = loaded.get_ciphertext()->ciphertext();
+  EXPECT_EQ(loaded_cipher.parms_id(), cipher->ciphertext().parms_id());
+  EXPECT_EQ(loaded_cipher.scale(), cipher->ciphertext().scale());
+  EXPECT_EQ(std::memcmp(loaded_cipher.data(), cipher->ciphertext().data(),
+                        message1.segments_size()),
+            0);
+}
+
+TEST(tcp_message, compression_mode) {
+  EXPECT_EQ(compr_mode_from_string("None"), seal::compr_mode_type::none);
+  EXPECT_ANY_THROW(compr_mode_from_string("lzma"));
+  EXPECT_EQ(compr_mode_from_pb(compr_mode_to_pb(seal::compr_mode_type::none)),
+            seal::compr_mode_type::none);
+
+  seal::EncryptionParameters parms(seal::scheme_type::ckks);
+  size_t poly_modulus_degree = 4096;
+  parms.set_poly_modulus_degree(poly_modulus_degree);
+  parms.set_coeff_modulus(
+      seal::CoeffModulus::Create(poly_modulus_degree, {30, 30, 30}));
+  auto context = std::make_shared<seal::SEALContext>(parms);
+
+  seal::KeyGenerator keygen(*context);
+  seal::PublicKey public_key;
+  keygen.create_public_key(public_key);
+  seal::Encryptor encryptor(*context, public_key);
+  seal::CKKSEncoder encoder(*context);
+
+  seal::Plaintext plain;
+  encoder.encode(std::vector<double>{1, 2, 3}, std::pow(2.0, 25), plain);
+  auto cipher = HESealBackend::create_empty_ciphertext();
+  encryptor.encrypt(plain, cipher->ciphertext());
+  HEType he_type(cipher, false, 3);
+
+  for (const auto& name : {"none", "zlib", "zstd"}) {
+    auto compr_mode = seal::compr_mode_type::none;
+    try {
+      compr_mode = compr_mode_from_string(name);
+    } catch (const ngraph_error&) {
+      // SEAL built without support for this mode
+      continue;
+    }
+    EXPECT_EQ(compr_mode_to_string(compr_mode), name);
+    EXPECT_EQ(compr_mode_from_pb(compr_mode_to_pb(compr_mode)), compr_mode);
+
+    pb::HEType pb_type;
+    he_type.save(pb_type, nullptr, compr_mode);
+    EXPECT_LE(pb_type.ciphertext().size(),
+              ciphertext_size(cipher->ciphertext()));
+
+    auto loaded = HEType::load(pb_type, context);
+    const auto& loaded_cipher = loaded.get_ciphertext()->ciphertext();
+    EXPECT_EQ(loaded_cipher.parms_id(), cipher->ciphertext().parms_id());
+    EXPECT_EQ(std::memcmp(loaded_cipher.data(), cipher->ciphertext().data(),
+                          cipher->ciphertext().size() *
+                              cipher->ciphertext().poly_modulus_degree() *
+                              cipher->ciphertext().coeff_modulus_size() *
+                              sizeof(std::uint64_t)),
+              0);
+  }
+}
+
 }  // namespace ngraph::runtime::he